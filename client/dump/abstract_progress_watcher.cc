@@ -90,6 +90,7 @@ void Abstract_progress_watcher::object_processing_ended(
       dynamic_cast<Table_rows_dump_task *>(
           finished_process_data->get_process_task_object());
   if (processed_table_task != nullptr &&
+      processed_table_task->get_chunk_index() == 0 &&
       finished_process_data->had_chain_created()) {
     m_progress.m_table_count++;
     this->progress_changed();
@@ -0,0 +1,135 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License, version 2.0, for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+
+#include "client/dump/compression_zstd_writer.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+using namespace Mysql::Tools::Dump;
+
+void Compression_zstd_writer::submit_pending(
+    std::unique_lock<std::mutex> &lock) {
+  // Limit memory used by blocks waiting for compression or output.
+  m_block_written.wait(lock, [this] {
+    return m_next_sequence - m_next_to_write < 2 * (uint64)m_threads;
+  });
+  Block block;
+  block.m_sequence = m_next_sequence++;
+  block.m_data.swap(m_pending);
+  m_queue.push_back(std::move(block));
+  m_block_queued.notify_one();
+}
+
+void Compression_zstd_writer::worker() {
+  ZSTD_CCtx *context = ZSTD_createCCtx();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_block_queued.wait(lock,
+                        [this] { return !m_queue.empty() || m_stopping; });
+    if (m_queue.empty()) break;
+    Block block = std::move(m_queue.front());
+    m_queue.pop_front();
+    lock.unlock();
+
+    std::string compressed;
+    compressed.resize(ZSTD_compressBound(block.m_data.size()));
+    size_t zstd_result = ZSTD_compressCCtx(
+        context, &compressed[0], compressed.size(), block.m_data.data(),
+        block.m_data.size(), m_compression_level);
+
+    lock.lock();
+    if (context == nullptr || ZSTD_isError(zstd_result)) {
+      this->pass_message(Mysql::Tools::Base::Message_data(
+          0, "ZSTD compression failed",
+          Mysql::Tools::Base::Message_type_error));
+      compressed.clear();
+    } else {
+      compressed.resize(zstd_result);
+    }
+    m_completed[block.m_sequence].swap(compressed);
+    this->write_completed(lock);
+  }
+  lock.unlock();
+  ZSTD_freeCCtx(context);
+}
+
+void Compression_zstd_writer::write_completed(
+    std::unique_lock<std::mutex> &lock) {
+  // Only one thread writes, the others leave their blocks to it.
+  if (m_writing) return;
+  m_writing = true;
+  for (std::map<uint64, std::string>::iterator it =
+           m_completed.find(m_next_to_write);
+       it != m_completed.end(); it = m_completed.find(m_next_to_write)) {
+    std::string compressed;
+    compressed.swap(it->second);
+    m_completed.erase(it);
+
+    lock.unlock();
+    if (!compressed.empty()) this->append_output(compressed);
+    lock.lock();
+
+    m_next_to_write++;
+    m_block_written.notify_all();
+  }
+  m_writing = false;
+}
+
+void Compression_zstd_writer::append(const std::string &data_to_append) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_pending.append(data_to_append);
+  if (m_pending.size() >= block_size) this->submit_pending(lock);
+}
+
+Compression_zstd_writer::~Compression_zstd_writer() {
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_pending.empty()) this->submit_pending(lock);
+    m_stopping = true;
+    m_block_queued.notify_all();
+  }
+  for (std::thread &worker : m_workers) worker.join();
+}
+
+Compression_zstd_writer::Compression_zstd_writer(
+    std::function<bool(const Mysql::Tools::Base::Message_data &)>
+        *message_handler,
+    Simple_id_generator *object_id_generator, uint threads,
+    int compression_level)
+    : Abstract_output_writer_wrapper(message_handler, object_id_generator),
+      m_threads(std::max(threads, 1U)),
+      m_compression_level(compression_level),
+      m_next_sequence(0),
+      m_next_to_write(0),
+      m_writing(false),
+      m_stopping(false) {}
+
+bool Compression_zstd_writer::init() {
+  for (uint i = 0; i < m_threads; i++)
+    m_workers.emplace_back(&Compression_zstd_writer::worker, this);
+  return false;
+}
@@ -0,0 +1,123 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License, version 2.0, for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+
+#ifndef COMPRESSION_ZSTD_WRITER_INCLUDED
+#define COMPRESSION_ZSTD_WRITER_INCLUDED
+
+#include <zstd.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "client/dump/abstract_output_writer_wrapper.h"
+#include "client/dump/i_output_writer.h"
+#include "my_inttypes.h"
+
+namespace Mysql {
+namespace Tools {
+namespace Dump {
+
+/**
+  Wrapper to another Output Writer, compresses formatted data stream with
+  ZSTD. Data is cut into blocks that are compressed into independent frames
+  by a pool of threads and passed on in order, the output is a valid zstd
+  stream of concatenated frames.
+ */
+class Compression_zstd_writer : public I_output_writer,
+                                public Abstract_output_writer_wrapper {
+ public:
+  Compression_zstd_writer(
+      std::function<bool(const Mysql::Tools::Base::Message_data &)>
+          *message_handler,
+      Simple_id_generator *object_id_generator, uint threads,
+      int compression_level);
+
+  ~Compression_zstd_writer() override;
+
+  bool init() override;
+  void append(const std::string &data_to_append) override;
+
+  // Fix "inherits ... via dominance" warnings
+  void register_progress_watcher(
+      I_progress_watcher *new_progress_watcher) override {
+    Abstract_chain_element::register_progress_watcher(new_progress_watcher);
+  }
+
+  // Fix "inherits ... via dominance" warnings
+  uint64 get_id() const override { return Abstract_chain_element::get_id(); }
+
+ protected:
+  // Fix "inherits ... via dominance" warnings
+  void item_completion_in_child_callback(
+      Item_processing_data *item_processed) override {
+    Abstract_chain_element::item_completion_in_child_callback(item_processed);
+  }
+
+ private:
+  /** Size of blocks compressed into separate frames. */
+  static const size_t block_size = 4 * 1024 * 1024;
+
+  struct Block {
+    uint64 m_sequence;
+    std::string m_data;
+  };
+
+  /** Queues the pending data as a block, waiting if too many are queued. */
+  void submit_pending(std::unique_lock<std::mutex> &lock);
+
+  /** Compresses blocks until the writer stops. */
+  void worker();
+
+  /** Passes on compressed blocks that are next in order. */
+  void write_completed(std::unique_lock<std::mutex> &lock);
+
+  uint m_threads;
+  int m_compression_level;
+  std::vector<std::thread> m_workers;
+
+  std::mutex m_mutex;
+  /** Signaled when a block is queued or the writer stops. */
+  std::condition_variable m_block_queued;
+  /** Signaled when a block was written. */
+  std::condition_variable m_block_written;
+  std::string m_pending;
+  std::deque<Block> m_queue;
+  std::map<uint64, std::string> m_completed;
+  uint64 m_next_sequence;
+  uint64 m_next_to_write;
+  bool m_writing;
+  bool m_stopping;
+};
+
+}  // namespace Dump
+}  // namespace Tools
+}  // namespace Mysql
+
+#endif
@@ -283,22 +283,26 @@ void Mysql_crawler::enumerate_tables(const Database &db) {
 
     Table_definition_dump_task *ddl_task =
         new Table_definition_dump_task(table);
-    Table_rows_dump_task *rows_task = new Table_rows_dump_task(table);
+    std::vector<Abstract_dump_task *> rows_tasks =
+        this->create_table_rows_tasks(runner, table);
     Table_deferred_indexes_dump_task *indexes_task =
         new Table_deferred_indexes_dump_task(table);
 
     ddl_task->add_dependency(m_current_database_start_dump_task);
-    rows_task->add_dependency(ddl_task);
-    indexes_task->add_dependency(rows_task);
+    for (Abstract_dump_task *rows_task : rows_tasks) {
+      rows_task->add_dependency(ddl_task);
+      indexes_task->add_dependency(rows_task);
+    }
     m_current_database_end_dump_task->add_dependency(indexes_task);
     m_tables_definition_ready_dump_task->add_dependency(ddl_task);
 
     this->process_dump_task(ddl_task);
-    this->process_dump_task(rows_task);
+    for (Abstract_dump_task *rows_task : rows_tasks)
+      this->process_dump_task(rows_task);
 
-    this->enumerate_table_triggers(*table, rows_task);
+    this->enumerate_table_triggers(*table, rows_tasks);
 
-    this->enumerate_column_statistics(*table, rows_task);
+    this->enumerate_column_statistics(*table, rows_tasks);
 
     this->process_dump_task(indexes_task);
   }
@@ -500,8 +504,109 @@ void Mysql_crawler::enumerate_users() {
   delete runner;
 }
 
-void Mysql_crawler::enumerate_table_triggers(const Table &table,
-                                             Abstract_dump_task *dependency) {
+std::vector<Abstract_dump_task *> Mysql_crawler::create_table_rows_tasks(
+    Mysql::Tools::Base::Mysql_query_runner *runner, Table *table) {
+  std::vector<Abstract_dump_task *> tasks;
+  uint64 chunk_rows = m_mysqldump_tool_cmaker_options->m_chunk_rows;
+
+  if (chunk_rows == 0 || table->get_row_count() <= chunk_rows ||
+      m_mysqldump_tool_cmaker_options->m_skip_rows_data) {
+    tasks.push_back(new Table_rows_dump_task(table));
+    return tasks;
+  }
+
+  /* Only tables with a single column integer primary key are split. */
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row *> key_columns;
+  runner->run_query_store(
+      "SELECT `COLUMN_NAME` FROM " +
+          this->get_quoted_object_full_name("INFORMATION_SCHEMA",
+                                            "KEY_COLUMN_USAGE") +
+          " WHERE TABLE_SCHEMA = '" +
+          runner->escape_string(table->get_schema()) +
+          "' AND TABLE_NAME = '" + runner->escape_string(table->get_name()) +
+          "' AND CONSTRAINT_NAME = 'PRIMARY'",
+      &key_columns);
+
+  std::string key_column;
+  if (key_columns.size() == 1) key_column = (*key_columns[0])[0];
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&key_columns);
+
+  bool is_integer = false;
+  bool is_unsigned = false;
+  for (const Field &field : table->get_fields()) {
+    if (field.get_name() != key_column) continue;
+    const std::string &type = field.get_type_string();
+    is_integer = type.compare(0, 7, "tinyint") == 0 ||
+                 type.compare(0, 8, "smallint") == 0 ||
+                 type.compare(0, 9, "mediumint") == 0 ||
+                 type.compare(0, 3, "int") == 0 ||
+                 type.compare(0, 6, "bigint") == 0;
+    is_unsigned = type.find("unsigned") != std::string::npos;
+  }
+
+  std::vector<const Mysql::Tools::Base::Mysql_query_runner::Row *> bounds;
+  if (is_integer) {
+    std::string quoted_key = this->quote_name(key_column);
+    runner->run_query_store("SELECT MIN(" + quoted_key + "), MAX(" +
+                                quoted_key + ") FROM " +
+                                this->get_quoted_object_full_name(table),
+                            &bounds);
+  }
+
+  if (bounds.size() != 1 || bounds[0]->is_value_null(0) ||
+      bounds[0]->is_value_null(1)) {
+    Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&bounds);
+    tasks.push_back(new Table_rows_dump_task(table));
+    return tasks;
+  }
+
+  /*
+    Compute range bounds in unsigned arithmetic, which also works for
+    signed values in two's complement.
+  */
+  uint64 min_value, max_value;
+  if (is_unsigned) {
+    min_value = strtoull((*bounds[0])[0].c_str(), nullptr, 10);
+    max_value = strtoull((*bounds[0])[1].c_str(), nullptr, 10);
+  } else {
+    min_value = (uint64)strtoll((*bounds[0])[0].c_str(), nullptr, 10);
+    max_value = (uint64)strtoll((*bounds[0])[1].c_str(), nullptr, 10);
+  }
+  Mysql::Tools::Base::Mysql_query_runner::cleanup_result(&bounds);
+
+  uint64 span = max_value - min_value;
+  uint64 chunks = (table->get_row_count() + chunk_rows - 1) / chunk_rows;
+  if (chunks > span) chunks = span;
+  if (chunks < 2) {
+    tasks.push_back(new Table_rows_dump_task(table));
+    return tasks;
+  }
+  uint64 step = span / chunks;
+
+  /*
+    The first and the last chunk are open ended, so that rows out of the
+    bounds read above are dumped too.
+  */
+  std::string quoted_key = this->quote_name(key_column);
+  std::string lower;
+  for (uint64 chunk = 0; chunk < chunks; ++chunk) {
+    std::string condition;
+    if (!lower.empty()) condition = quoted_key + " >= " + lower;
+    if (chunk + 1 < chunks) {
+      uint64 bound = min_value + step * (chunk + 1);
+      std::string upper = is_unsigned ? std::to_string(bound)
+                                      : std::to_string((int64)bound);
+      if (!condition.empty()) condition += " AND ";
+      condition += quoted_key + " < " + upper;
+      lower = upper;
+    }
+    tasks.push_back(new Table_rows_dump_task(table, condition, chunk));
+  }
+  return tasks;
+}
+
+void Mysql_crawler::enumerate_table_triggers(
+    const Table &table, const std::vector<Abstract_dump_task *> &dependencies) {
   // Triggers were supported since 5.0.9
   if (this->get_server_version() < 50009) return;
 
@@ -532,7 +637,8 @@ void Mysql_crawler::enumerate_table_triggers(const Table &table,
             "\n//\n" + "DELIMITER ;\n",
         &table);
 
-    trigger->add_dependency(dependency);
+    for (Abstract_dump_task *dependency : dependencies)
+      trigger->add_dependency(dependency);
     m_current_database_end_dump_task->add_dependency(trigger);
 
     this->process_dump_task(trigger);
@@ -542,7 +648,7 @@ void Mysql_crawler::enumerate_table_triggers(const Table &table,
 }
 
 void Mysql_crawler::enumerate_column_statistics(
-    const Table &table, Abstract_dump_task *dependency) {
+    const Table &table, const std::vector<Abstract_dump_task *> &dependencies) {
   // Column statistics were supported since 8.0.2
   if (this->get_server_version() < 80002) return;
 
@@ -583,7 +689,8 @@ void Mysql_crawler::enumerate_column_statistics(
     Column_statistic *column_statistic = new Column_statistic(
         this->generate_new_object_id(), table.get_schema(), definition, &table);
 
-    column_statistic->add_dependency(dependency);
+    for (Abstract_dump_task *dependency : dependencies)
+      column_statistic->add_dependency(dependency);
     m_current_database_end_dump_task->add_dependency(column_statistic);
 
     this->process_dump_task(column_statistic);
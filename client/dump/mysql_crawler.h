@@ -26,9 +26,11 @@
 #define MYSQL_CRAWLER_INCLUDED
 
 #include <functional>
+#include <vector>
 
 #include "client/base/abstract_program.h"
 #include "client/base/message_data.h"
+#include "client/base/mysql_query_runner.h"
 #include "client/dump/abstract_crawler.h"
 #include "client/dump/abstract_dump_task.h"
 #include "client/dump/abstract_mysql_chain_element_extension.h"
@@ -90,11 +92,18 @@ class Mysql_crawler : public Abstract_crawler,
 
   void enumerate_tables(const Database &db);
 
-  void enumerate_table_triggers(const Table &table,
-                                Abstract_dump_task *dependency);
+  /**
+    Creates tasks dumping rows of table, one for each chunk if table is
+    split into primary key ranges, see --chunk-rows.
+   */
+  std::vector<Abstract_dump_task *> create_table_rows_tasks(
+      Mysql::Tools::Base::Mysql_query_runner *runner, Table *table);
+
+  void enumerate_table_triggers(
+      const Table &table, const std::vector<Abstract_dump_task *> &dependencies);
 
-  void enumerate_column_statistics(const Table &table,
-                                   Abstract_dump_task *dependency);
+  void enumerate_column_statistics(
+      const Table &table, const std::vector<Abstract_dump_task *> &dependencies);
 
   void enumerate_views(const Database &db);
 
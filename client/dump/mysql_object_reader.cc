@@ -128,8 +128,13 @@ void Mysql_object_reader::read_table_rows_task(
   Rows_fetching_context *row_fetching_context = new Rows_fetching_context(
       this, item_to_process, has_generated_columns, has_invisible_columns);
 
-  runner->run_query("SELECT " + column_names + "  FROM " +
-                        this->get_quoted_object_full_name(table),
+  std::string query =
+      "SELECT " + column_names + "  FROM " +
+      this->get_quoted_object_full_name(table);
+  if (!table_rows_dump_task->get_condition().empty())
+    query += " WHERE " + table_rows_dump_task->get_condition();
+
+  runner->run_query(query,
                     new std::function<int64(
                         const Mysql::Tools::Base::Mysql_query_runner::Row &)>(
                         std::bind(&Rows_fetching_context::result_callback,
@@ -287,10 +287,24 @@ void Mysqldump_tool_chain_maker_options::create_options() {
       "Direct all output generated for all objects to a given file.");
   this->create_new_option(
       &m_compress_output_algorithm, "compress-output",
-      "Compresses all output files with LZ4 or ZLIB compression algorithm.");
+      "Compresses all output files with LZ4, ZLIB or ZSTD compression "
+      "algorithm.");
+  this->create_new_option(
+          &m_compress_output_threads, "compress-output-threads",
+          "Number of threads compressing output with ZSTD. Output is "
+          "compressed in blocks of 4 MB.")
+      ->set_minimum_value(1)
+      ->set_value(4);
   this->create_new_option(&m_skip_rows_data, "skip-dump-rows",
                           "Skip dumping rows of all tables to output.")
       ->set_short_character('d');
+  this->create_new_option(
+          &m_chunk_rows, "chunk-rows",
+          "Split tables with an integer primary key and more than N rows "
+          "into primary key ranges of about N rows, which are dumped in "
+          "parallel by the threads of the table's queue. 0 dumps each table "
+          "with a single query.")
+      ->set_value(0);
 }
 
 Mysqldump_tool_chain_maker_options::~Mysqldump_tool_chain_maker_options() {
@@ -67,7 +67,9 @@ class Mysqldump_tool_chain_maker_options
   uint32 m_default_parallelism;
   Mysql::Nullable<std::string> m_result_file;
   Mysql::Nullable<std::string> m_compress_output_algorithm;
+  uint32 m_compress_output_threads;
   bool m_skip_rows_data;
+  uint64 m_chunk_rows;
 
  private:
   void parallel_schemas_callback(char *);
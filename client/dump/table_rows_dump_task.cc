@@ -27,4 +27,17 @@
 using namespace Mysql::Tools::Dump;
 
 Table_rows_dump_task::Table_rows_dump_task(Table *related_table)
-    : Abstract_table_dump_task(related_table) {}
+    : Abstract_table_dump_task(related_table), m_chunk_index(0) {}
+
+Table_rows_dump_task::Table_rows_dump_task(Table *related_table,
+                                           const std::string &condition,
+                                           uint64 chunk_index)
+    : Abstract_table_dump_task(related_table),
+      m_condition(condition),
+      m_chunk_index(chunk_index) {}
+
+const std::string &Table_rows_dump_task::get_condition() const {
+  return m_condition;
+}
+
+uint64 Table_rows_dump_task::get_chunk_index() const { return m_chunk_index; }
@@ -25,18 +25,42 @@
 #ifndef TABLE_ROWS_DUMP_TASK_INCLUDED
 #define TABLE_ROWS_DUMP_TASK_INCLUDED
 
+#include <string>
+
 #include "client/dump/abstract_table_dump_task.h"
+#include "my_inttypes.h"
 
 namespace Mysql {
 namespace Tools {
 namespace Dump {
 
 /**
-  Represents task for extracting rows of single DB table.
+  Represents task for extracting rows of single DB table, or of one chunk
+  of its rows.
  */
 class Table_rows_dump_task : public Abstract_table_dump_task {
  public:
   Table_rows_dump_task(Table *related_table);
+  /**
+    Creates task for rows of one chunk of table, selected by given
+    condition. Chunks of a table are dumped in parallel.
+   */
+  Table_rows_dump_task(Table *related_table, const std::string &condition,
+                       uint64 chunk_index);
+
+  /**
+    Returns condition selecting rows of this chunk, empty for whole table.
+   */
+  const std::string &get_condition() const;
+
+  /**
+    Returns index of chunk, 0 for whole table.
+   */
+  uint64 get_chunk_index() const;
+
+ private:
+  std::string m_condition;
+  uint64 m_chunk_index;
 };
 
 }  // namespace Dump
@@ -43,7 +43,11 @@
 #include <time.h>
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "caching_sha2_passwordopt-vars.h"
 #include "client/client_priv.h"
@@ -769,6 +773,7 @@ static uint opt_zstd_compress_level = default_zstd_compression_level;
 static char *opt_compress_algorithm = nullptr;
 
 static bool opt_print_table_metadata;
+static bool opt_flashback = false;
 
 /**
   Exit status for functions in this file.
@@ -1330,6 +1335,202 @@ void end_binlog(PRINT_EVENT_INFO *print_event_info) {
   in_transaction = false;
 }
 
+/**
+  Collects, for --flashback, the events that undo the row events read and
+  prints them once all the logs are read: the transactions last to first,
+  each as the table maps it used followed by its undo row events last to
+  first. Statements logged as statements cannot be undone; they are left
+  out with a warning.
+*/
+class Flashback {
+ public:
+  /**
+    Take in an event read. Nothing is kept from it after it returns.
+
+    @param ev       The event.
+    @param pos      Its position, for messages.
+    @param skipped  The event is filtered out by --include-gtids or
+                    --exclude-gtids; it only ends the transaction.
+
+    @retval true Error, it has been reported.
+  */
+  bool add_event(Log_event *ev, my_off_t pos, bool skipped);
+
+  /**
+    Print the collected transactions to result_file.
+
+    @retval true Error, it has been reported.
+  */
+  bool print(PRINT_EVENT_INFO *print_event_info);
+
+ private:
+  /** The table map event of a table and what it maps. */
+  struct Table {
+    std::string event;
+    std::unique_ptr<table_def> def;
+  };
+
+  void end_transaction();
+
+  /* Of the transaction being read, by table id */
+  std::map<ulonglong, Table> m_tables;
+  std::set<ulonglong> m_ignored_tables;
+  std::vector<std::string> m_rows;
+
+  /* Table maps followed by undo row events, of each transaction read */
+  std::vector<std::vector<std::string>> m_transactions;
+};
+
+static Flashback flashback;
+
+/* The event as it was read, without its checksum. */
+static std::string event_without_checksum(const Log_event *ev) {
+  size_t event_len = uint4korr(ev->temp_buf + EVENT_LEN_OFFSET);
+  if (ev->common_footer->checksum_alg == binary_log::BINLOG_CHECKSUM_ALG_CRC32)
+    event_len -= BINLOG_CHECKSUM_LEN;
+  return std::string(ev->temp_buf, event_len);
+}
+
+bool Flashback::add_event(Log_event *ev, my_off_t pos, bool skipped) {
+  char ll_buff[21];
+  Log_event_type ev_type = ev->get_type_code();
+
+  if (ev->ends_group()) {
+    end_transaction();
+    return false;
+  }
+  if (skipped) return false;
+
+  switch (ev_type) {
+    case binary_log::QUERY_EVENT: {
+      Query_log_event *qle = down_cast<Query_log_event *>(ev);
+      if (qle->is_trans_keyword()) break;
+      if (!shall_skip_database(qle->db))
+        warning(
+            "--flashback does not undo the statement at position %s; only "
+            "row events are undone.",
+            llstr(pos, ll_buff));
+      /* It commits what came before */
+      end_transaction();
+      break;
+    }
+    case binary_log::TABLE_MAP_EVENT: {
+      Table_map_log_event *map = down_cast<Table_map_log_event *>(ev);
+      const ulonglong table_id = map->get_table_id().id();
+      if (shall_skip_database(map->get_db_name())) {
+        m_ignored_tables.insert(table_id);
+        break;
+      }
+      Table &table = m_tables[table_id];
+      if (table.def == nullptr) {
+        table.event = event_without_checksum(ev);
+        table.def.reset(map->create_table_def());
+      }
+      break;
+    }
+    case binary_log::WRITE_ROWS_EVENT:
+    case binary_log::UPDATE_ROWS_EVENT:
+    case binary_log::DELETE_ROWS_EVENT:
+    case binary_log::WRITE_ROWS_EVENT_V1:
+    case binary_log::UPDATE_ROWS_EVENT_V1:
+    case binary_log::DELETE_ROWS_EVENT_V1:
+    case binary_log::PARTIAL_UPDATE_ROWS_EVENT: {
+      Rows_log_event *rows = down_cast<Rows_log_event *>(ev);
+      const ulonglong table_id = rows->get_table_id().id();
+      if (m_ignored_tables.count(table_id) != 0) break;
+      auto table = m_tables.find(table_id);
+      if (table == m_tables.end() || table->second.def == nullptr) {
+        error("--flashback found the %s event at position %s without its "
+              "table map.",
+              ev->get_type_str(), llstr(pos, ll_buff));
+        return true;
+      }
+      std::string undo;
+      if (rows->get_flashback_event(table->second.def.get(), &undo)) {
+        error("--flashback cannot undo the %s event at position %s; it needs "
+              "row events of version 2 with full row images "
+              "(binlog_row_image=FULL, binlog_row_value_options='').",
+              ev->get_type_str(), llstr(pos, ll_buff));
+        return true;
+      }
+      m_rows.push_back(std::move(undo));
+      break;
+    }
+    default:
+      break;
+  }
+  return false;
+}
+
+void Flashback::end_transaction() {
+  if (!m_rows.empty()) {
+    std::vector<std::string> events;
+    for (auto &table : m_tables)
+      events.push_back(std::move(table.second.event));
+    events.insert(events.end(), std::make_move_iterator(m_rows.rbegin()),
+                  std::make_move_iterator(m_rows.rend()));
+    m_transactions.push_back(std::move(events));
+  }
+  m_tables.clear();
+  m_ignored_tables.clear();
+  m_rows.clear();
+}
+
+bool Flashback::print(PRINT_EVENT_INFO *print_event_info) {
+  /* A transaction the logs end in the middle of is not undone */
+  m_tables.clear();
+  m_ignored_tables.clear();
+  m_rows.clear();
+
+  const bool has_crc = glob_description_event.footer()->checksum_alg ==
+                       binary_log::BINLOG_CHECKSUM_ALG_CRC32;
+  for (auto trx = m_transactions.rbegin(); trx != m_transactions.rend();
+       ++trx) {
+    fprintf(result_file, "BEGIN%s\n", print_event_info->delimiter);
+    for (size_t i = 0; i < trx->size(); i++) {
+      const std::string &event = (*trx)[i];
+      size_t event_len = event.size();
+      auto buffer = (uchar *)my_malloc(PSI_NOT_INSTRUMENTED,
+                                       event_len + BINLOG_CHECKSUM_LEN,
+                                       MYF(MY_WME));
+      if (buffer == nullptr) return true;
+      memcpy(buffer, event.data(), event_len);
+
+      /* The last event ends the statement */
+      if (i + 1 == trx->size()) {
+        uchar *flags_ptr = buffer + LOG_EVENT_HEADER_LEN + ROWS_FLAGS_OFFSET;
+        int2store(flags_ptr, uint2korr(flags_ptr) | Rows_log_event::STMT_END_F);
+      }
+      if (has_crc) {
+        int4store(buffer + EVENT_LEN_OFFSET, event_len + BINLOG_CHECKSUM_LEN);
+        int4store(buffer + event_len, checksum_crc32(0, buffer, event_len));
+        event_len += BINLOG_CHECKSUM_LEN;
+      }
+
+      Log_event *ev = nullptr;
+      if (binlog_event_deserialize(buffer, event_len, &glob_description_event,
+                                   true, &ev)) {
+        my_free(buffer);
+        error("--flashback could not read back an event it made.");
+        return true;
+      }
+      ev->register_temp_buf((char *)buffer);
+      ev->print(result_file, print_event_info);
+      delete ev;
+    }
+    if (copy_event_cache_to_file_and_reinit(&print_event_info->head_cache,
+                                            result_file, false) ||
+        copy_event_cache_to_file_and_reinit(&print_event_info->body_cache,
+                                            result_file, false) ||
+        copy_event_cache_to_file_and_reinit(&print_event_info->footer_cache,
+                                            result_file, false))
+      return true;
+    fprintf(result_file, "COMMIT%s\n", print_event_info->delimiter);
+  }
+  m_transactions.clear();
+  return false;
+}
+
 /**
   Print the given event, and either delete it or delegate the deletion
   to someone else.
@@ -1404,6 +1605,13 @@ static Exit_status process_event(PRINT_EVENT_INFO *print_event_info,
       retval = OK_STOP;
       goto end;
     }
+    if (opt_flashback && ev_type != binary_log::FORMAT_DESCRIPTION_EVENT &&
+        ev_type != binary_log::TRANSACTION_PAYLOAD_EVENT) {
+      /* Nothing is printed before all the logs are read */
+      if (flashback.add_event(ev, pos, shall_skip_gtids(ev))) goto err;
+      goto end;
+    }
+
     if (!short_form)
       my_b_printf(&print_event_info->head_cache, "# at %s\n",
                   llstr(pos, ll_buff));
@@ -2037,6 +2245,13 @@ static struct my_option my_long_options[] = {
      "Print metadata stored in Table_map_log_event", &opt_print_table_metadata,
      &opt_print_table_metadata, nullptr, GET_BOOL, NO_ARG, 0, 0, 0, nullptr, 0,
      nullptr},
+    {"flashback", OPT_MYSQLBINLOG_FLASHBACK,
+     "Print row events that undo the ones read: inserts become deletes, "
+     "deletes inserts and updates get their images swapped, in the reverse "
+     "order, last transaction first. Needs binlog_row_image=FULL. "
+     "Statements logged as statements are not undone.",
+     &opt_flashback, &opt_flashback, nullptr, GET_BOOL, NO_ARG, 0, 0, 0,
+     nullptr, 0, nullptr},
     {"compress", 'C', "Use compression in server/client protocol.",
      &opt_compress, &opt_compress, nullptr, GET_BOOL, NO_ARG, 0, 0, 0, nullptr,
      0, nullptr},
@@ -2424,6 +2639,9 @@ static Exit_status dump_multiple_logs(int argc, char **argv) {
     start_position = BIN_LOG_HEADER_SIZE;
   }
 
+  if (opt_flashback && rc != ERROR_STOP && flashback.print(&print_event_info))
+    rc = ERROR_STOP;
+
   if (!buff_ev->empty())
     warning(
         "The range of printed events ends with an Intvar_event, "
@@ -3094,6 +3312,15 @@ static int args_post_process(void) {
     return ERROR_STOP;
   }
 
+  if (opt_flashback &&
+      (raw_mode || short_form ||
+       opt_base64_output_mode == BASE64_OUTPUT_NEVER)) {
+    error(
+        "The --flashback option cannot be used with --raw, --short-form or "
+        "--base64-output=never.");
+    return ERROR_STOP;
+  }
+
   if (raw_mode) {
     if (one_database)
       warning("The --database option is ignored with --raw mode");
@@ -27,10 +27,14 @@
 **			    into a table(s).
 */
 
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/types.h>
 #include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include "client/client_priv.h"
 #include "compression.h"
@@ -41,6 +45,7 @@
 #include "my_io.h"
 #include "my_macros.h"
 #include "my_systime.h"
+#include "my_thread_local.h"
 #include "mysql/service_mysql_alloc.h"
 #include "mysql_version.h"
 #include "print_version.h"
@@ -67,6 +72,8 @@ static bool verbose = false, lock_tables = false, ignore_errors = false,
             tty_password = false;
 static bool debug_info_flag = false, debug_check_flag = false;
 static uint opt_use_threads = 0, opt_local_file = 0, my_end_arg = 0;
+static uint opt_split_threads = 0;
+static ulonglong opt_split_chunk_size = 0;
 static char *opt_password = nullptr, *current_user = nullptr,
             *current_host = nullptr, *current_db = nullptr,
             *fields_terminated = nullptr, *lines_terminated = nullptr,
@@ -216,6 +223,17 @@ static struct my_option my_long_options[] = {
     {"socket", 'S', "The socket file to use for connection.",
      &opt_mysql_unix_port, &opt_mysql_unix_port, nullptr, GET_STR, REQUIRED_ARG,
      0, 0, 0, nullptr, 0, nullptr},
+    {"split-chunk-size", 0,
+     "With --split-threads, cut each file into chunks of about this many "
+     "bytes. Every chunk is loaded and committed by its own LOAD DATA "
+     "statement. 0 means one chunk per thread.",
+     &opt_split_chunk_size, &opt_split_chunk_size, nullptr, GET_ULL,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"split-threads", 0,
+     "Split every file at line boundaries and load the pieces in parallel "
+     "over this many connections. Requires --local.",
+     &opt_split_threads, &opt_split_threads, nullptr, GET_UINT, REQUIRED_ARG,
+     0, 0, 0, nullptr, 0, nullptr},
 #include "caching_sha2_passwordopt-longopts.h"
 #include "sslopt-longopts.h"
 
@@ -337,6 +355,18 @@ static int get_options(int *argc, char ***argv) {
         "You can't use --ignore (-i) and --replace (-r) at the same time.\n");
     return (1);
   }
+  if (opt_split_threads) {
+    if (!opt_local_file) {
+      fprintf(stderr, "You can't use --split-threads without --local.\n");
+      return (1);
+    }
+    if (lock_tables || opt_use_threads) {
+      fprintf(stderr,
+              "You can't use --split-threads with --lock-tables or "
+              "--use-threads.\n");
+      return (1);
+    }
+  }
   if (*argc < 2) {
     usage();
     return 1;
@@ -347,37 +377,21 @@ static int get_options(int *argc, char ***argv) {
   return (0);
 }
 
-static int write_to_table(char *filename, MYSQL *mysql) {
-  char tablename[FN_REFLEN], hard_path[FN_REFLEN],
-      escaped_name[FN_REFLEN * 2 + 1], sql_statement[FN_REFLEN * 16 + 256],
-      *end, *pos;
-  DBUG_TRACE;
-  DBUG_PRINT("enter", ("filename: %s", filename));
+/**
+  Build the LOAD DATA statement for one file (or one piece of it).
 
-  fn_format(tablename, filename, "", "", 1 | 2); /* removes path & ext. */
-  if (!opt_local_file)
-    my_stpcpy(hard_path, filename);
-  else
-    my_load_path(hard_path, filename, nullptr); /* filename includes the path */
+  @param mysql          connection, used for escaping the file name
+  @param sql_statement  output buffer of at least FN_REFLEN * 16 + 256 bytes
+  @param hard_path      file name as sent to the server
+  @param tablename      target table
+  @param ignore_lines   number of lines to skip, or -1 for none
+*/
+static void build_load_statement(MYSQL *mysql, char *sql_statement,
+                                 const char *hard_path, const char *tablename,
+                                 longlong ignore_lines) {
+  char escaped_name[FN_REFLEN * 2 + 1], *end;
+  const char *pos;
 
-  if (opt_delete) {
-    if (verbose)
-      fprintf(stdout, "Deleting the old data from table %s\n", tablename);
-    snprintf(sql_statement, FN_REFLEN * 16 + 256, "DELETE FROM %s", tablename);
-    if (mysql_query(mysql, sql_statement))
-      return db_error_with_table(mysql, tablename);
-  }
-  to_unix_path(hard_path);
-  if (verbose) {
-    if (opt_local_file)
-      fprintf(stdout, "Loading data from LOCAL file: %s into %s\n", hard_path,
-              tablename);
-    else
-      fprintf(stdout, "Loading data from SERVER file: %s into %s\n", hard_path,
-              tablename);
-  }
-  if (opt_local_file)
-    mysql_options(mysql, MYSQL_OPT_LOAD_DATA_LOCAL_DIR, filename);
   mysql_real_escape_string_quote(mysql, escaped_name, hard_path,
                                  (unsigned long)strlen(hard_path), '\'');
   sprintf(sql_statement, "LOAD DATA %s %s INFILE '%s'",
@@ -401,13 +415,47 @@ static int write_to_table(char *filename, MYSQL *mysql) {
   end = add_load_option(end, opt_enclosed, " OPTIONALLY ENCLOSED BY");
   end = add_load_option(end, escaped, " ESCAPED BY");
   end = add_load_option(end, lines_terminated, " LINES TERMINATED BY");
-  if (opt_ignore_lines >= 0)
+  if (ignore_lines >= 0)
     end = my_stpcpy(
-        longlong10_to_str(opt_ignore_lines, my_stpcpy(end, " IGNORE "), 10),
+        longlong10_to_str(ignore_lines, my_stpcpy(end, " IGNORE "), 10),
         " LINES");
   if (opt_columns)
     end = my_stpcpy(my_stpcpy(my_stpcpy(end, " ("), opt_columns), ")");
   *end = '\0';
+}
+
+static int write_to_table(char *filename, MYSQL *mysql) {
+  char tablename[FN_REFLEN], hard_path[FN_REFLEN],
+      sql_statement[FN_REFLEN * 16 + 256];
+  DBUG_TRACE;
+  DBUG_PRINT("enter", ("filename: %s", filename));
+
+  fn_format(tablename, filename, "", "", 1 | 2); /* removes path & ext. */
+  if (!opt_local_file)
+    my_stpcpy(hard_path, filename);
+  else
+    my_load_path(hard_path, filename, nullptr); /* filename includes the path */
+
+  if (opt_delete) {
+    if (verbose)
+      fprintf(stdout, "Deleting the old data from table %s\n", tablename);
+    snprintf(sql_statement, FN_REFLEN * 16 + 256, "DELETE FROM %s", tablename);
+    if (mysql_query(mysql, sql_statement))
+      return db_error_with_table(mysql, tablename);
+  }
+  to_unix_path(hard_path);
+  if (verbose) {
+    if (opt_local_file)
+      fprintf(stdout, "Loading data from LOCAL file: %s into %s\n", hard_path,
+              tablename);
+    else
+      fprintf(stdout, "Loading data from SERVER file: %s into %s\n", hard_path,
+              tablename);
+  }
+  if (opt_local_file)
+    mysql_options(mysql, MYSQL_OPT_LOAD_DATA_LOCAL_DIR, filename);
+  build_load_statement(mysql, sql_statement, hard_path, tablename,
+                       opt_ignore_lines);
 
   if (mysql_query(mysql, sql_statement))
     return db_error_with_table(mysql, tablename);
@@ -440,7 +488,7 @@ static int lock_table(MYSQL *mysql, int tablecount, char **raw_tablename) {
 static MYSQL *db_connect(char *host, char *database, char *user, char *passwd) {
   MYSQL *mysql;
   if (verbose) fprintf(stdout, "Connecting to %s\n", host ? host : "localhost");
-  if (opt_use_threads && !lock_tables) {
+  if ((opt_use_threads || opt_split_threads) && !lock_tables) {
     native_mutex_lock(&init_mutex);
     if (!(mysql = mysql_init(nullptr))) {
       native_mutex_unlock(&init_mutex);
@@ -612,6 +660,493 @@ error:
 }
 }  // extern "C"
 
+/*
+** Single-file parallel load (--split-threads).
+**
+** The file is cut into byte ranges that end on a line terminator which is
+** neither escaped nor inside an enclosed field. Every range is sent as its
+** own LOAD DATA LOCAL statement through a local infile handler that reads
+** only that range, so each piece commits on its own and the pieces are
+** spread over --split-threads connections.
+*/
+
+/** Size of the window used when scanning for chunk boundaries. */
+static const size_t SPLIT_SCAN_BUFFER = 1024 * 1024;
+
+/**
+  Turn the value of a --fields-... / --lines-... option into the bytes the
+  server will use, the same way the SQL parser reads the string literal or
+  hex constant that add_load_option() generates.
+*/
+static int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return 0;
+}
+
+static std::string decode_load_option(const char *object, const char *def) {
+  std::string out;
+  if (object == nullptr) return def;
+  if (object[0] == '0' && (object[1] == 'x' || object[1] == 'X')) {
+    const char *hex = object + 2;
+    size_t len = strlen(hex);
+    if (len % 2) out.push_back(static_cast<char>(hex_digit(*hex++)));
+    for (; *hex && hex[1]; hex += 2)
+      out.push_back(static_cast<char>(hex_digit(hex[0]) << 4 | hex_digit(hex[1])));
+    return out;
+  }
+  for (const char *pos = object; *pos; pos++) {
+    if (*pos != '\\' || pos[1] == '\0') {
+      out.push_back(*pos);
+      continue;
+    }
+    switch (*++pos) {
+      case '0':
+        out.push_back('\0');
+        break;
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'Z':
+        out.push_back('\032');
+        break;
+      default:
+        out.push_back(*pos);
+    }
+  }
+  return out;
+}
+
+/** Forward-only buffered reader used by the boundary scan. */
+class Split_scanner {
+ public:
+  Split_scanner(File fd, my_off_t offset, my_off_t file_size)
+      : m_fd(fd), m_offset(offset), m_file_size(file_size) {}
+
+  /** Make sure at least @c need bytes are buffered, unless at end of file. */
+  bool fill(size_t need) {
+    if (m_buffer.size() - m_pos >= need) return false;
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + m_pos);
+    m_offset += m_pos;
+    m_pos = 0;
+    my_off_t read_from = m_offset + m_buffer.size();
+    size_t want = static_cast<size_t>(std::min<my_off_t>(
+        SPLIT_SCAN_BUFFER, m_file_size - std::min(read_from, m_file_size)));
+    if (want == 0) return false;
+    size_t old_size = m_buffer.size();
+    m_buffer.resize(old_size + want);
+    if (my_pread(m_fd, &m_buffer[old_size], want, read_from, MYF(MY_NABP))) {
+      m_buffer.resize(old_size);
+      return true;
+    }
+    return false;
+  }
+
+  bool at_end() const { return m_pos >= m_buffer.size(); }
+  uchar peek(size_t ahead = 0) const {
+    return m_pos + ahead < m_buffer.size() ? m_buffer[m_pos + ahead] : 0;
+  }
+  bool match(const std::string &str) const {
+    return !str.empty() && m_buffer.size() - m_pos >= str.size() &&
+           memcmp(&m_buffer[m_pos], str.data(), str.size()) == 0;
+  }
+  void advance(size_t count) {
+    m_pos = std::min(m_pos + count, m_buffer.size());
+  }
+  my_off_t tell() const { return m_offset + m_pos; }
+
+ private:
+  File m_fd;
+  my_off_t m_offset;
+  my_off_t m_file_size;
+  std::vector<uchar> m_buffer;
+  size_t m_pos{0};
+};
+
+/**
+  Find the end of the first record that ends at or after each target offset.
+
+  Without an enclosing character the scan starts at each target and only
+  has to look back for escape characters in front of a line terminator.
+  With one, quoting state depends on everything before, so the file is
+  scanned once from the start; the scan is a plain byte loop and is still
+  far cheaper than loading the rows.
+
+  @return true on read error
+*/
+static bool find_split_points(File fd, my_off_t file_size,
+                              const std::vector<my_off_t> &targets,
+                              std::vector<my_off_t> *points) {
+  const std::string field_term = decode_load_option(fields_terminated, "\t");
+  const std::string line_term = decode_load_option(lines_terminated, "\n");
+  const std::string escape = decode_load_option(escaped, "\\");
+  const std::string enclosure =
+      decode_load_option(enclosed ? enclosed : opt_enclosed, "");
+  const int esc = escape.empty() ? -1 : static_cast<uchar>(escape[0]);
+  const size_t lookahead = std::max(field_term.size(), line_term.size()) + 1;
+
+  if (enclosure.empty()) {
+    my_off_t last = 0;
+    for (my_off_t target : targets) {
+      if (target <= last) continue;
+      /* Back up so that a terminator ending exactly at target is found. */
+      my_off_t start = std::max(last, target - std::min<my_off_t>(
+                                                  target, line_term.size()));
+      /* Count the escape characters right before the scan start. */
+      uint escapes = 0;
+      if (esc >= 0) {
+        uchar back[256];
+        my_off_t from = start > sizeof(back) ? start - sizeof(back) : 0;
+        size_t len = static_cast<size_t>(start - from);
+        if (my_pread(fd, back, len, from, MYF(MY_NABP))) return true;
+        while (escapes < len && back[len - 1 - escapes] == esc) escapes++;
+      }
+      Split_scanner scan(fd, start, file_size);
+      for (;;) {
+        if (scan.fill(lookahead)) return true;
+        if (scan.at_end()) return false; /* no more boundaries */
+        if (escapes % 2 == 0 && scan.match(line_term)) {
+          scan.advance(line_term.size());
+          break;
+        }
+        escapes = (esc >= 0 && scan.peek() == esc) ? escapes + 1 : 0;
+        scan.advance(1);
+      }
+      last = scan.tell();
+      if (last < file_size) points->push_back(last);
+    }
+    return false;
+  }
+
+  const uchar enc = static_cast<uchar>(enclosure[0]);
+  Split_scanner scan(fd, 0, file_size);
+  size_t next = 0;
+  bool field_start = true, in_quote = false;
+  while (next < targets.size()) {
+    if (scan.fill(lookahead)) return true;
+    if (scan.at_end()) break;
+    uchar c = scan.peek();
+    if (in_quote) {
+      if (c == enc) {
+        if (scan.peek(1) == enc) {
+          scan.advance(2); /* doubled enclosure is a literal */
+          continue;
+        }
+        scan.advance(1);
+        if (scan.fill(lookahead)) return true;
+        if (scan.at_end() || scan.match(field_term) || scan.match(line_term))
+          in_quote = false;
+      } else
+        scan.advance(esc >= 0 && c == esc ? 2 : 1);
+      continue;
+    }
+    if (field_start && c == enc) {
+      in_quote = true;
+      field_start = false;
+      scan.advance(1);
+      continue;
+    }
+    field_start = false;
+    if (esc >= 0 && c == esc) {
+      scan.advance(2);
+    } else if (scan.match(line_term)) {
+      scan.advance(line_term.size());
+      field_start = true;
+      my_off_t pos = scan.tell();
+      if (pos >= targets[next] && pos < file_size) {
+        points->push_back(pos);
+        while (next < targets.size() && targets[next] <= pos) next++;
+      }
+    } else if (scan.match(field_term)) {
+      scan.advance(field_term.size());
+      field_start = true;
+    } else
+      scan.advance(1);
+  }
+  return false;
+}
+
+struct Split_chunk {
+  uint index;
+  my_off_t start;
+  my_off_t end;
+};
+
+/** State shared by the connections loading one file. */
+struct Split_load {
+  char filename[FN_REFLEN];
+  char tablename[FN_REFLEN];
+  char hard_path[FN_REFLEN];
+  my_off_t file_size{0};
+  std::vector<Split_chunk> chunks;
+  /* Protected by counter_mutex. */
+  size_t next_chunk{0};
+  uint chunks_done{0};
+  my_off_t bytes_done{0};
+  bool aborted{false};
+};
+
+/** Per-connection state, also the userdata of the local infile handler. */
+struct Split_worker {
+  Split_load *load;
+  const Split_chunk *chunk{nullptr};
+};
+
+struct Split_infile {
+  File fd;
+  my_off_t pos;
+  my_off_t end;
+  int error_num;
+  char error_msg[LOCAL_INFILE_ERROR_LEN];
+};
+
+static int split_infile_init(void **ptr, const char *, void *userdata) {
+  Split_worker *worker = static_cast<Split_worker *>(userdata);
+  Split_infile *data;
+  if (!(*ptr = data = static_cast<Split_infile *>(my_malloc(
+            PSI_NOT_INSTRUMENTED, sizeof(Split_infile), MYF(0)))))
+    return 1;
+  data->error_num = 0;
+  data->error_msg[0] = '\0';
+  data->pos = worker->chunk->start;
+  data->end = worker->chunk->end;
+  if ((data->fd = my_open(worker->load->filename, O_RDONLY, MYF(0))) < 0) {
+    data->error_num = my_errno();
+    snprintf(data->error_msg, sizeof(data->error_msg),
+             "Can't open file '%s' (errno: %d)", worker->load->filename,
+             data->error_num);
+    return 1;
+  }
+  return 0;
+}
+
+static int split_infile_read(void *ptr, char *buf, uint buf_len) {
+  Split_infile *data = static_cast<Split_infile *>(ptr);
+  size_t count =
+      static_cast<size_t>(std::min<my_off_t>(buf_len, data->end - data->pos));
+  if (count == 0) return 0;
+  if (my_pread(data->fd, pointer_cast<uchar *>(buf), count, data->pos,
+               MYF(MY_NABP))) {
+    data->error_num = my_errno();
+    snprintf(data->error_msg, sizeof(data->error_msg),
+             "Error reading file at offset %llu (errno: %d)",
+             static_cast<ulonglong>(data->pos), data->error_num);
+    return -1;
+  }
+  data->pos += count;
+  return static_cast<int>(count);
+}
+
+static void split_infile_end(void *ptr) {
+  Split_infile *data = static_cast<Split_infile *>(ptr);
+  if (data) {
+    if (data->fd >= 0) my_close(data->fd, MYF(0));
+    my_free(data);
+  }
+}
+
+static int split_infile_error(void *ptr, char *error_msg, uint error_msg_len) {
+  Split_infile *data = static_cast<Split_infile *>(ptr);
+  if (data) {
+    strmake(error_msg, data->error_msg, error_msg_len);
+    return data->error_num;
+  }
+  strmake(error_msg, "Out of memory", error_msg_len);
+  return CR_OUT_OF_MEMORY;
+}
+
+extern "C" {
+static void *split_worker_thread(void *arg) {
+  Split_load *load = static_cast<Split_load *>(arg);
+  Split_worker worker{load};
+  char sql_statement[FN_REFLEN * 16 + 256];
+  int error;
+  MYSQL *mysql = nullptr;
+
+  if (mysql_thread_init()) goto error;
+  if (!(mysql =
+            db_connect(current_host, current_db, current_user, opt_password))) {
+    native_mutex_lock(&counter_mutex);
+    if (exitcode == 0) exitcode = 1;
+    load->aborted = true;
+    native_mutex_unlock(&counter_mutex);
+    goto error;
+  }
+  if (mysql_query(mysql, "/*!40101 set @@character_set_database=binary */;") &&
+      (error = db_error(mysql))) {
+    native_mutex_lock(&counter_mutex);
+    if (exitcode == 0) exitcode = error;
+    load->aborted = true;
+    native_mutex_unlock(&counter_mutex);
+    goto error;
+  }
+  mysql_options(mysql, MYSQL_OPT_LOAD_DATA_LOCAL_DIR, load->filename);
+  mysql_set_local_infile_handler(mysql, split_infile_init, split_infile_read,
+                                 split_infile_end, split_infile_error, &worker);
+
+  for (;;) {
+    native_mutex_lock(&counter_mutex);
+    if (load->aborted || load->next_chunk == load->chunks.size()) {
+      native_mutex_unlock(&counter_mutex);
+      break;
+    }
+    worker.chunk = &load->chunks[load->next_chunk++];
+    native_mutex_unlock(&counter_mutex);
+
+    /* Header lines to skip only exist in the first piece. */
+    build_load_statement(mysql, sql_statement, load->hard_path,
+                         load->tablename,
+                         worker.chunk->index == 0 ? opt_ignore_lines : -1);
+    if (mysql_query(mysql, sql_statement)) {
+      my_printf_error(0,
+                      "Error: %d, %s, when loading bytes %llu-%llu of %s "
+                      "into table: %s",
+                      MYF(0), mysql_errno(mysql), mysql_error(mysql),
+                      static_cast<ulonglong>(worker.chunk->start),
+                      static_cast<ulonglong>(worker.chunk->end),
+                      load->filename, load->tablename);
+      error = safe_exit(1);
+      native_mutex_lock(&counter_mutex);
+      if (error) {
+        if (exitcode == 0) exitcode = error;
+        load->aborted = true;
+      }
+      native_mutex_unlock(&counter_mutex);
+      continue;
+    }
+
+    native_mutex_lock(&counter_mutex);
+    load->chunks_done++;
+    load->bytes_done += worker.chunk->end - worker.chunk->start;
+    if (!silent) {
+      fprintf(stdout,
+              "%s.%s: chunk %u of %u (bytes %llu-%llu) %s; "
+              "%llu of %llu bytes loaded (%.1f%%)\n",
+              current_db, load->tablename, worker.chunk->index + 1,
+              static_cast<uint>(load->chunks.size()),
+              static_cast<ulonglong>(worker.chunk->start),
+              static_cast<ulonglong>(worker.chunk->end),
+              mysql_info(mysql) ? mysql_info(mysql) : "",
+              static_cast<ulonglong>(load->bytes_done),
+              static_cast<ulonglong>(load->file_size),
+              load->file_size
+                  ? 100.0 * load->bytes_done / load->file_size
+                  : 100.0);
+      fflush(stdout);
+    }
+    native_mutex_unlock(&counter_mutex);
+  }
+
+error:
+  if (mysql) db_disconnect(current_host, mysql);
+  mysql_thread_end();
+  my_thread_exit(nullptr);
+  return nullptr;
+}
+}  // extern "C"
+
+/**
+  Load one file over --split-threads connections.
+
+  @param filename  file to load; its base name is the table name
+  @param mysql     control connection, used for --delete
+*/
+static int split_load_file(char *filename, MYSQL *mysql) {
+  Split_load load;
+  char sql_statement[FN_REFLEN * 16 + 256];
+  File fd;
+  DBUG_TRACE;
+
+  fn_format(load.tablename, filename, "", "", 1 | 2);
+  my_load_path(load.hard_path, filename, nullptr);
+  strmake(load.filename, load.hard_path, sizeof(load.filename) - 1);
+  to_unix_path(load.hard_path);
+
+  if (opt_delete) {
+    if (verbose)
+      fprintf(stdout, "Deleting the old data from table %s\n", load.tablename);
+    snprintf(sql_statement, sizeof(sql_statement), "DELETE FROM %s",
+             load.tablename);
+    if (mysql_query(mysql, sql_statement))
+      return db_error_with_table(mysql, load.tablename);
+  }
+
+  if ((fd = my_open(load.filename, O_RDONLY, MYF(MY_WME))) < 0)
+    return safe_exit(1);
+  load.file_size = my_seek(fd, 0L, MY_SEEK_END, MYF(0));
+
+  uint chunk_count = opt_split_threads;
+  if (opt_split_chunk_size)
+    chunk_count = static_cast<uint>(std::max<my_off_t>(
+        1, (load.file_size + opt_split_chunk_size - 1) / opt_split_chunk_size));
+  std::vector<my_off_t> targets, points;
+  for (uint i = 1; i < chunk_count; i++)
+    targets.push_back(load.file_size / chunk_count * i);
+  bool scan_error = find_split_points(fd, load.file_size, targets, &points);
+  my_close(fd, MYF(0));
+  if (scan_error) {
+    my_printf_error(0, "Error: could not read %s to find split points",
+                    MYF(0), load.filename);
+    return safe_exit(1);
+  }
+
+  my_off_t start = 0;
+  points.push_back(load.file_size);
+  for (my_off_t end : points) {
+    if (end <= start) continue;
+    load.chunks.push_back(
+        {static_cast<uint>(load.chunks.size()), start, end});
+    start = end;
+  }
+  if (load.chunks.empty()) load.chunks.push_back({0, 0, 0});
+
+  uint thread_count =
+      std::min<uint>(opt_split_threads, static_cast<uint>(load.chunks.size()));
+  if (verbose)
+    fprintf(stdout,
+            "Loading data from LOCAL file: %s into %s in %u chunks over %u "
+            "connections\n",
+            load.hard_path, load.tablename,
+            static_cast<uint>(load.chunks.size()), thread_count);
+
+  std::vector<my_thread_handle> threads(thread_count);
+  my_thread_attr_t attr;
+  my_thread_attr_init(&attr);
+  my_thread_attr_setdetachstate(&attr, MY_THREAD_CREATE_JOINABLE);
+  uint started = 0;
+  for (uint i = 0; i < thread_count; i++) {
+    if (my_thread_create(&threads[started], &attr, split_worker_thread,
+                         &load) != 0) {
+      fprintf(stderr, "%s: Could not create thread\n", my_progname);
+      continue;
+    }
+    started++;
+  }
+  my_thread_attr_destroy(&attr);
+  for (uint i = 0; i < started; i++) {
+    if (my_thread_join(&threads[i], nullptr))
+      fprintf(stderr, "%s: Could not join worker thread.\n", my_progname);
+  }
+
+  if (load.chunks_done != load.chunks.size()) {
+    my_printf_error(0, "Error: %u of %u chunks of %s were not loaded", MYF(0),
+                    static_cast<uint>(load.chunks.size()) - load.chunks_done,
+                    static_cast<uint>(load.chunks.size()), load.filename);
+    return safe_exit(1);
+  }
+  return 0;
+}
+
 int main(int argc, char **argv) {
   int error = 0;
   MY_INIT(argv[0]);
@@ -625,7 +1160,23 @@ int main(int argc, char **argv) {
     return (1);
   }
 
-  if (opt_use_threads && !lock_tables) {
+  if (opt_split_threads) {
+    native_mutex_init(&init_mutex, nullptr);
+    native_mutex_init(&counter_mutex, nullptr);
+
+    if (!(mysql = db_connect(current_host, current_db, current_user,
+                             opt_password))) {
+      exitcode = 1;
+    } else {
+      for (; *argv != nullptr; argv++)
+        if ((error = split_load_file(*argv, mysql))) {
+          if (exitcode == 0) exitcode = error;
+          break;
+        }
+    }
+    native_mutex_destroy(&init_mutex);
+    native_mutex_destroy(&counter_mutex);
+  } else if (opt_use_threads && !lock_tables) {
     char **save_argv;
     uint worker_thread_count = 0, table_count = 0, i = 0;
     my_thread_handle *worker_threads; /* Thread descriptor */
@@ -0,0 +1,769 @@
+/*
+   Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/*
+  mysqlreplay - capture a statement workload and replay it.
+
+  Capture reads either a general query log file or, by polling,
+  performance_schema.events_statements_history_long, and writes the
+  statements with their session, start time, original latency and digest
+  into a compact binary file:
+
+    mysqlreplay --capture-general-log=/var/lib/mysql/host.log --output=w.rpl
+    mysqlreplay --capture-performance-schema --duration=300 --output=w.rpl
+
+  Replay runs the file against a server. Every captured session gets its own
+  connection and its statements run in their original order; statements
+  start at their original offsets from the start of the capture, divided by
+  --speed (0 runs as fast as possible). At the end a report compares the
+  original and the replayed latency of every digest:
+
+    mysqlreplay --replay=w.rpl --speed=2 --threads=64
+
+  The file format is described in replay_capture.h.
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "client/client_priv.h"
+#include "client/replay_capture.h"
+#include "compression.h"
+#include "my_alloc.h"
+#include "my_dbug.h"
+#include "my_default.h"
+#include "my_inttypes.h"
+#include "my_io.h"
+#include "my_macros.h"
+#include "mysql/service_mysql_alloc.h"
+#include "print_version.h"
+#include "typelib.h"
+#include "welcome_copyright_notice.h" /* ORACLE_WELCOME_COPYRIGHT_NOTICE */
+
+static bool debug_info_flag = false, debug_check_flag = false;
+static bool tty_password = false, opt_compress = false, verbose = false;
+static uint my_end_arg = 0;
+static char *opt_password = nullptr, *current_user = nullptr,
+            *current_host = nullptr, *current_db = nullptr;
+static const char *default_charset = MYSQL_AUTODETECT_CHARSET_NAME;
+static uint opt_enable_cleartext_plugin = 0;
+static bool using_opt_enable_cleartext_plugin = false;
+static uint opt_mysql_port = 0, opt_protocol = 0;
+static char *opt_bind_addr = nullptr;
+static char *opt_mysql_unix_port = nullptr;
+static char *opt_plugin_dir = nullptr, *opt_default_auth = nullptr;
+static uint opt_zstd_compress_level = default_zstd_compression_level;
+static char *opt_compress_algorithm = nullptr;
+
+static char *opt_capture_general_log = nullptr;
+static bool opt_capture_performance_schema = false;
+static uint opt_duration = 60;
+static uint opt_poll_interval = 1;
+static char *opt_output = nullptr;
+static char *opt_replay = nullptr;
+static double opt_speed = 1.0;
+static uint opt_threads = 64;
+static uint opt_top = 20;
+
+#include "caching_sha2_passwordopt-vars.h"
+#include "sslopt-vars.h"
+
+#if defined(_WIN32)
+static char *shared_memory_base_name = 0;
+#endif
+
+static struct my_option my_long_options[] = {
+    {"bind-address", 0, "IP address to bind to.", (uchar **)&opt_bind_addr,
+     (uchar **)&opt_bind_addr, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr,
+     0, nullptr},
+    {"capture-general-log", 0,
+     "Capture the statements of this general query log file.",
+     &opt_capture_general_log, &opt_capture_general_log, nullptr, GET_STR,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"capture-performance-schema", 0,
+     "Capture statements by polling "
+     "performance_schema.events_statements_history_long for --duration "
+     "seconds.",
+     &opt_capture_performance_schema, &opt_capture_performance_schema, nullptr,
+     GET_BOOL, NO_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"character-sets-dir", OPT_CHARSETS_DIR,
+     "Directory for character set files.", &charsets_dir, &charsets_dir,
+     nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"compress", 'C', "Use compression in server/client protocol.",
+     &opt_compress, &opt_compress, nullptr, GET_BOOL, NO_ARG, 0, 0, 0, nullptr,
+     0, nullptr},
+    {"database", 'D',
+     "Schema replayed sessions start in, unless the capture says otherwise.",
+     &current_db, &current_db, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0,
+     nullptr, 0, nullptr},
+#ifdef NDEBUG
+    {"debug", '#', "This is a non-debug version. Catch this and exit.", 0, 0, 0,
+     GET_DISABLED, OPT_ARG, 0, 0, 0, 0, 0, 0},
+    {"debug-check", OPT_DEBUG_CHECK,
+     "This is a non-debug version. Catch this and exit.", 0, 0, 0, GET_DISABLED,
+     NO_ARG, 0, 0, 0, 0, 0, 0},
+    {"debug-info", OPT_DEBUG_INFO,
+     "This is a non-debug version. Catch this and exit.", 0, 0, 0, GET_DISABLED,
+     NO_ARG, 0, 0, 0, 0, 0, 0},
+#else
+    {"debug", '#', "Output debug log. Often this is 'd:t:o,filename'.", nullptr,
+     nullptr, nullptr, GET_STR, OPT_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"debug-check", OPT_DEBUG_CHECK,
+     "Check memory and open file usage at exit.", &debug_check_flag,
+     &debug_check_flag, nullptr, GET_BOOL, NO_ARG, 0, 0, 0, nullptr, 0,
+     nullptr},
+    {"debug-info", OPT_DEBUG_INFO, "Print some debug info at exit.",
+     &debug_info_flag, &debug_info_flag, nullptr, GET_BOOL, NO_ARG, 0, 0, 0,
+     nullptr, 0, nullptr},
+#endif
+    {"default-character-set", OPT_DEFAULT_CHARSET,
+     "Set the default character set.", &default_charset, &default_charset,
+     nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"default_auth", OPT_DEFAULT_AUTH,
+     "Default authentication client-side plugin to use.", &opt_default_auth,
+     &opt_default_auth, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0,
+     nullptr},
+    {"duration", 0,
+     "Seconds to poll performance_schema for with "
+     "--capture-performance-schema.",
+     &opt_duration, &opt_duration, nullptr, GET_UINT, REQUIRED_ARG, 60, 1, 0,
+     nullptr, 0, nullptr},
+    {"enable_cleartext_plugin", OPT_ENABLE_CLEARTEXT_PLUGIN,
+     "Enable/disable the clear text authentication plugin.",
+     &opt_enable_cleartext_plugin, &opt_enable_cleartext_plugin, nullptr,
+     GET_BOOL, OPT_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"help", '?', "Displays this help and exits.", nullptr, nullptr, nullptr,
+     GET_NO_ARG, NO_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"host", 'h', "Connect to host.", &current_host, &current_host, nullptr,
+     GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"output", 'o', "File the capture is written to.", &opt_output,
+     &opt_output, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0,
+     nullptr},
+    {"password", 'p',
+     "Password to use when connecting to server. If password is not given it's "
+     "asked from the tty.",
+     nullptr, nullptr, nullptr, GET_PASSWORD, OPT_ARG, 0, 0, 0, nullptr, 0,
+     nullptr},
+#ifdef _WIN32
+    {"pipe", 'W', "Use named pipes to connect to server.", 0, 0, 0, GET_NO_ARG,
+     NO_ARG, 0, 0, 0, 0, 0, 0},
+#endif
+    {"plugin_dir", OPT_PLUGIN_DIR, "Directory for client-side plugins.",
+     &opt_plugin_dir, &opt_plugin_dir, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0,
+     nullptr, 0, nullptr},
+    {"poll-interval", 0,
+     "Seconds between two reads of events_statements_history_long. Keep it "
+     "short enough that the table does not wrap in between.",
+     &opt_poll_interval, &opt_poll_interval, nullptr, GET_UINT, REQUIRED_ARG,
+     1, 1, 0, nullptr, 0, nullptr},
+    {"port", 'P',
+     "Port number to use for connection or 0 for default to, in "
+     "order of preference, my.cnf, $MYSQL_TCP_PORT, "
+#if MYSQL_PORT_DEFAULT == 0
+     "/etc/services, "
+#endif
+     "built-in default (" STRINGIFY_ARG(MYSQL_PORT) ").",
+     &opt_mysql_port, &opt_mysql_port, nullptr, GET_UINT, REQUIRED_ARG, 0, 0, 0,
+     nullptr, 0, nullptr},
+    {"protocol", OPT_MYSQL_PROTOCOL,
+     "The protocol to use for connection (tcp, socket, pipe, memory).", nullptr,
+     nullptr, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"replay", 'r', "Replay this capture file.", &opt_replay, &opt_replay,
+     nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+#if defined(_WIN32)
+    {"shared-memory-base-name", OPT_SHARED_MEMORY_BASE_NAME,
+     "Base name of shared memory.", &shared_memory_base_name,
+     &shared_memory_base_name, 0, GET_STR_ALLOC, REQUIRED_ARG, 0, 0, 0, 0, 0,
+     0},
+#endif
+    {"socket", 'S', "The socket file to use for connection.",
+     &opt_mysql_unix_port, &opt_mysql_unix_port, nullptr, GET_STR, REQUIRED_ARG,
+     0, 0, 0, nullptr, 0, nullptr},
+    {"speed", 0,
+     "Replay speed relative to the capture: 2 replays twice as fast, 0.5 at "
+     "half speed, 0 as fast as possible. Per-session order is kept always.",
+     &opt_speed, &opt_speed, nullptr, GET_DOUBLE, REQUIRED_ARG, 1, 0, 0,
+     nullptr, 0, nullptr},
+#include "caching_sha2_passwordopt-longopts.h"
+#include "sslopt-longopts.h"
+
+    {"threads", 't',
+     "Maximum number of replay threads. Sessions beyond this share threads.",
+     &opt_threads, &opt_threads, nullptr, GET_UINT, REQUIRED_ARG, 64, 1, 0,
+     nullptr, 0, nullptr},
+    {"top", 0, "Number of digests in the replay report.", &opt_top, &opt_top,
+     nullptr, GET_UINT, REQUIRED_ARG, 20, 1, 0, nullptr, 0, nullptr},
+    {"user", 'u', "User for login if not current user.", &current_user,
+     &current_user, nullptr, GET_STR, REQUIRED_ARG, 0, 0, 0, nullptr, 0,
+     nullptr},
+    {"verbose", 'v', "Print info about the various stages.", &verbose, &verbose,
+     nullptr, GET_BOOL, NO_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"version", 'V', "Output version information and exit.", nullptr, nullptr,
+     nullptr, GET_NO_ARG, NO_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"compression-algorithms", 0,
+     "Use compression algorithm in server/client protocol. Valid values "
+     "are any combination of 'zstd','zlib','uncompressed'.",
+     &opt_compress_algorithm, &opt_compress_algorithm, nullptr, GET_STR,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"zstd-compression-level", 0,
+     "Use this compression level in the client/server protocol, in case "
+     "--compression-algorithms=zstd. Valid range is between 1 and 22, "
+     "inclusive. Default is 3.",
+     &opt_zstd_compress_level, &opt_zstd_compress_level, nullptr, GET_UINT,
+     REQUIRED_ARG, 3, 1, 22, nullptr, 0, nullptr},
+    {nullptr, 0, nullptr, nullptr, nullptr, nullptr, GET_NO_ARG, NO_ARG, 0, 0,
+     0, nullptr, 0, nullptr}};
+
+static const char *load_default_groups[] = {"mysqlreplay", "client", nullptr};
+
+static void usage(void) {
+  print_version();
+  puts(ORACLE_WELCOME_COPYRIGHT_NOTICE("2021"));
+  puts(
+      "Captures a statement workload from a general query log or from\n"
+      "performance_schema into a file, and replays such a file against a\n"
+      "server with the original timing, reporting latency per digest.\n");
+  printf(
+      "Usage: %s [OPTIONS] --capture-general-log=FILE --output=FILE\n"
+      "       %s [OPTIONS] --capture-performance-schema --output=FILE\n"
+      "       %s [OPTIONS] --replay=FILE\n",
+      my_progname, my_progname, my_progname);
+  print_defaults("my", load_default_groups);
+  my_print_help(my_long_options);
+  my_print_variables(my_long_options);
+}
+
+extern "C" {
+static bool get_one_option(int optid, const struct my_option *opt,
+                           char *argument) {
+  switch (optid) {
+    case 'p':
+      if (argument == disabled_my_option) {
+        // Don't require password
+        static char empty_password[] = {'\0'};
+        assert(empty_password[0] ==
+               '\0');  // Check that it has not been overwritten
+        argument = empty_password;
+      }
+      if (argument) {
+        char *start = argument;
+        my_free(opt_password);
+        opt_password = my_strdup(PSI_NOT_INSTRUMENTED, argument, MYF(MY_FAE));
+        while (*argument) *argument++ = 'x'; /* Destroy argument */
+        if (*start) start[1] = 0;            /* Cut length of argument */
+        tty_password = false;
+      } else
+        tty_password = true;
+      break;
+#ifdef _WIN32
+    case 'W':
+      opt_protocol = MYSQL_PROTOCOL_PIPE;
+      break;
+#endif
+    case OPT_ENABLE_CLEARTEXT_PLUGIN:
+      using_opt_enable_cleartext_plugin = true;
+      break;
+    case OPT_MYSQL_PROTOCOL:
+      opt_protocol =
+          find_type_or_exit(argument, &sql_protocol_typelib, opt->name);
+      break;
+    case '#':
+      DBUG_PUSH(argument ? argument : "d:t:o");
+      debug_check_flag = true;
+      break;
+#include "sslopt-case.h"
+
+    case 'V':
+      print_version();
+      exit(0);
+    case 'I':
+    case '?':
+      usage();
+      exit(0);
+  }
+  return false;
+}
+}  // extern "C"
+
+static int get_options(int *argc, char ***argv) {
+  int ho_error;
+
+  if ((ho_error = handle_options(argc, argv, my_long_options, get_one_option)))
+    exit(ho_error);
+  if (debug_info_flag) my_end_arg = MY_CHECK_ERROR | MY_GIVE_INFO;
+  if (debug_check_flag) my_end_arg = MY_CHECK_ERROR;
+
+  int modes = (opt_capture_general_log != nullptr) +
+              opt_capture_performance_schema + (opt_replay != nullptr);
+  if (modes != 1) {
+    fprintf(stderr,
+            "%s: Give exactly one of --capture-general-log, "
+            "--capture-performance-schema and --replay.\n",
+            my_progname);
+    return 1;
+  }
+  if (!opt_replay && !opt_output) {
+    fprintf(stderr, "%s: Capturing needs --output.\n", my_progname);
+    return 1;
+  }
+  if (*argc > 0) {
+    usage();
+    return 1;
+  }
+  if (tty_password) opt_password = get_tty_password(NullS);
+  return 0;
+}
+
+static MYSQL *db_connect(const char *database) {
+  MYSQL *mysql;
+  if (!(mysql = mysql_init(nullptr))) return nullptr;
+  if (opt_compress) mysql_options(mysql, MYSQL_OPT_COMPRESS, NullS);
+  if (opt_compress_algorithm)
+    mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS,
+                  opt_compress_algorithm);
+  mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL,
+                &opt_zstd_compress_level);
+  if (SSL_SET_OPTIONS(mysql)) {
+    fprintf(stderr, "%s", SSL_SET_OPTIONS_ERROR);
+    mysql_close(mysql);
+    return nullptr;
+  }
+  if (opt_protocol)
+    mysql_options(mysql, MYSQL_OPT_PROTOCOL, (char *)&opt_protocol);
+  if (opt_bind_addr) mysql_options(mysql, MYSQL_OPT_BIND, opt_bind_addr);
+#if defined(_WIN32)
+  if (shared_memory_base_name)
+    mysql_options(mysql, MYSQL_SHARED_MEMORY_BASE_NAME,
+                  shared_memory_base_name);
+#endif
+  if (opt_plugin_dir && *opt_plugin_dir)
+    mysql_options(mysql, MYSQL_PLUGIN_DIR, opt_plugin_dir);
+  if (opt_default_auth && *opt_default_auth)
+    mysql_options(mysql, MYSQL_DEFAULT_AUTH, opt_default_auth);
+  if (using_opt_enable_cleartext_plugin)
+    mysql_options(mysql, MYSQL_ENABLE_CLEARTEXT_PLUGIN,
+                  (char *)&opt_enable_cleartext_plugin);
+  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, default_charset);
+  mysql_options(mysql, MYSQL_OPT_CONNECT_ATTR_RESET, nullptr);
+  mysql_options4(mysql, MYSQL_OPT_CONNECT_ATTR_ADD, "program_name",
+                 "mysqlreplay");
+  set_server_public_key(mysql);
+  set_get_server_public_key_option(mysql);
+  if (!mysql_real_connect(mysql, current_host, current_user, opt_password,
+                          database, opt_mysql_port, opt_mysql_unix_port,
+                          CLIENT_MULTI_STATEMENTS | CLIENT_MULTI_RESULTS)) {
+    fprintf(stderr, "%s: Error when connecting to server: %d %s\n",
+            my_progname, mysql_errno(mysql), mysql_error(mysql));
+    mysql_close(mysql);
+    return nullptr;
+  }
+  mysql->reconnect = false;
+  return mysql;
+}
+
+/*
+** Capture file
+*/
+
+/** Writes capture records to a file. */
+class Capture_writer : public Capture_encoder {
+ public:
+  bool open(const char *path) {
+    if (!(m_file = my_fopen(path, O_WRONLY | MY_FOPEN_BINARY, MYF(MY_WME))))
+      return true;
+    return fwrite(REPLAY_MAGIC, sizeof(REPLAY_MAGIC), 1, m_file) != 1;
+  }
+
+  bool close() {
+    bool error = flush();
+    if (m_file && my_fclose(m_file, MYF(MY_WME))) error = true;
+    m_file = nullptr;
+    return error;
+  }
+
+  /** Write the records out once enough of them are buffered. */
+  bool flush_if_full() { return m_buffer.size() > 1024 * 1024 && flush(); }
+
+ private:
+  bool flush() {
+    if (m_buffer.empty()) return false;
+    bool error = fwrite(m_buffer.data(), m_buffer.size(), 1, m_file) != 1;
+    m_buffer.clear();
+    if (error)
+      fprintf(stderr, "%s: Could not write to %s\n", my_progname, opt_output);
+    return error;
+  }
+
+  FILE *m_file{nullptr};
+};
+
+static int capture_general_log(Capture_writer *writer) {
+  FILE *file;
+  if (!(file = my_fopen(opt_capture_general_log, O_RDONLY, MYF(MY_WME))))
+    return 1;
+
+  General_log_parser parser(writer);
+  std::string line;
+  char buffer[64 * 1024];
+  bool error = false;
+  while (!error && fgets(buffer, sizeof(buffer), file)) {
+    line.append(buffer);
+    if (line.back() != '\n' && !feof(file)) continue; /* long line */
+    if (line.back() == '\n') line.pop_back();
+    parser.add_line(line);
+    error = writer->flush_if_full();
+    line.clear();
+  }
+  if (!error) {
+    parser.finish();
+    error = writer->flush_if_full();
+  }
+  my_fclose(file, MYF(0));
+  return error ? 1 : 0;
+}
+
+static int capture_performance_schema(Capture_writer *writer) {
+  MYSQL *mysql = db_connect(nullptr);
+  if (!mysql) return 1;
+
+  /*
+    Completed top-level statements of all other sessions. TIMER_END is the
+    watermark between polls, so a statement is captured once, when it
+    finishes, even if it started before the previous poll.
+  */
+  ulonglong watermark = 0;
+  int error = 0;
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(opt_duration);
+  for (bool last = false; !last && !error;) {
+    last = std::chrono::steady_clock::now() >= deadline;
+    char query[1024];
+    snprintf(query, sizeof(query),
+             "SELECT THREAD_ID, TIMER_START, TIMER_END, TIMER_WAIT, "
+             "CURRENT_SCHEMA, DIGEST_TEXT, SQL_TEXT "
+             "FROM performance_schema.events_statements_history_long "
+             "WHERE SQL_TEXT IS NOT NULL AND NESTING_EVENT_ID IS NULL "
+             "AND THREAD_ID <> PS_CURRENT_THREAD_ID() AND TIMER_END > %llu "
+             "ORDER BY TIMER_START",
+             watermark);
+    MYSQL_RES *result;
+    if (mysql_query(mysql, query) || !(result = mysql_use_result(mysql))) {
+      fprintf(stderr, "%s: Error: %d %s\n", my_progname, mysql_errno(mysql),
+              mysql_error(mysql));
+      error = 1;
+      break;
+    }
+    ulonglong rows = 0;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+      unsigned long *lengths = mysql_fetch_lengths(result);
+      ulonglong session = strtoull(row[0], nullptr, 10);
+      /* Timers are in picoseconds */
+      longlong start_us =
+          static_cast<longlong>(strtoull(row[1], nullptr, 10) / 1000000);
+      ulonglong end = strtoull(row[2], nullptr, 10);
+      longlong latency_us =
+          static_cast<longlong>(strtoull(row[3], nullptr, 10) / 1000000);
+      watermark = std::max(watermark, end);
+      if (row[4])
+        writer->set_schema(session, start_us, std::string(row[4], lengths[4]));
+      writer->add_query(
+          session, start_us, latency_us,
+          row[5] ? std::string(row[5], lengths[5]) : std::string(),
+          std::string(row[6], lengths[6]));
+      if (writer->flush_if_full()) error = 1;
+      rows++;
+    }
+    if (mysql_errno(mysql)) {
+      fprintf(stderr, "%s: Error: %d %s\n", my_progname, mysql_errno(mysql),
+              mysql_error(mysql));
+      error = 1;
+    }
+    mysql_free_result(result);
+    if (verbose)
+      fprintf(stdout, "Captured %llu statements in this poll\n", rows);
+    if (!last)
+      std::this_thread::sleep_for(std::chrono::seconds(opt_poll_interval));
+  }
+  mysql_close(mysql);
+  return error;
+}
+
+/*
+** Replay
+*/
+
+static bool read_capture(const char *path, std::vector<Replay_event> *events,
+                         std::vector<std::string> *digests) {
+  FILE *file;
+  if (!(file = my_fopen(path, O_RDONLY | MY_FOPEN_BINARY, MYF(MY_WME))))
+    return true;
+  std::string data;
+  char buffer[64 * 1024];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    data.append(buffer, count);
+  my_fclose(file, MYF(0));
+
+  size_t error_offset;
+  if (parse_capture(data, events, digests, &error_offset)) {
+    if (error_offset == 0)
+      fprintf(stderr, "%s: %s is not a capture file\n", my_progname, path);
+    else
+      fprintf(stderr, "%s: %s is corrupt at offset %llu\n", my_progname, path,
+              static_cast<ulonglong>(error_offset));
+    return true;
+  }
+  return false;
+}
+
+struct Digest_stats {
+  ulonglong count{0};
+  ulonglong errors{0};
+  ulonglong original_count{0};
+  double original_us{0};
+  double replay_us{0};
+  std::vector<uint> replay_latencies;
+
+  void merge(const Digest_stats &other) {
+    count += other.count;
+    errors += other.errors;
+    original_count += other.original_count;
+    original_us += other.original_us;
+    replay_us += other.replay_us;
+    replay_latencies.insert(replay_latencies.end(),
+                            other.replay_latencies.begin(),
+                            other.replay_latencies.end());
+  }
+};
+
+/** The sessions one replay thread runs, and what it measured. */
+struct Replay_worker {
+  std::vector<const Replay_event *> events;
+  std::unordered_map<uint, Digest_stats> stats;
+  longlong max_lag_us{0};
+  bool failed{false};
+};
+
+static void run_replay_worker(Replay_worker *worker, longlong origin_us,
+                              std::chrono::steady_clock::time_point start) {
+  std::map<ulonglong, MYSQL *> sessions;
+  if (mysql_thread_init()) {
+    worker->failed = true;
+    return;
+  }
+
+  for (const Replay_event *event : worker->events) {
+    if (opt_speed > 0) {
+      auto due = start + std::chrono::microseconds(replay_offset_us(
+                             event->time_us, origin_us, opt_speed));
+      std::this_thread::sleep_until(due);
+      longlong lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                         std::chrono::steady_clock::now() - due)
+                         .count();
+      worker->max_lag_us = std::max(worker->max_lag_us, lag);
+    }
+
+    MYSQL *&mysql = sessions[event->session];
+    if (!mysql && !(mysql = db_connect(current_db))) {
+      worker->failed = true;
+      break;
+    }
+    if (event->schema_change) {
+      if (mysql_select_db(mysql, event->text.c_str()) && verbose)
+        fprintf(stderr, "%s: Could not use schema %s: %s\n", my_progname,
+                event->text.c_str(), mysql_error(mysql));
+      continue;
+    }
+
+    Digest_stats &stats = worker->stats[event->digest];
+    auto begin = std::chrono::steady_clock::now();
+    bool error = mysql_real_query(mysql, event->text.data(),
+                                  static_cast<ulong>(event->text.size()));
+    if (!error) {
+      /* Read every result set, as the original client had to */
+      int status;
+      do {
+        MYSQL_RES *result = mysql_store_result(mysql);
+        if (result) mysql_free_result(result);
+        if ((status = mysql_next_result(mysql)) > 0) error = true;
+      } while (status == 0);
+    }
+    longlong elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - begin)
+                           .count();
+    stats.count++;
+    if (error) {
+      stats.errors++;
+      if (verbose)
+        fprintf(stderr, "%s: Error %d %s in: %.200s\n", my_progname,
+                mysql_errno(mysql), mysql_error(mysql), event->text.c_str());
+    }
+    stats.replay_us += elapsed;
+    stats.replay_latencies.push_back(static_cast<uint>(
+        std::min<longlong>(elapsed, std::numeric_limits<uint>::max())));
+    if (event->latency_us >= 0) {
+      stats.original_count++;
+      stats.original_us += event->latency_us;
+    }
+  }
+
+  for (auto &session : sessions)
+    if (session.second) mysql_close(session.second);
+  mysql_thread_end();
+}
+
+static int replay(const char *path) {
+  std::vector<Replay_event> events;
+  std::vector<std::string> digests;
+  if (read_capture(path, &events, &digests)) return 1;
+  if (events.empty()) {
+    fprintf(stdout, "%s contains no statements\n", path);
+    return 0;
+  }
+
+  std::vector<std::vector<const Replay_event *>> thread_events;
+  const size_t sessions =
+      assign_replay_threads(events, opt_threads, &thread_events);
+  std::vector<Replay_worker> workers(thread_events.size());
+  for (size_t i = 0; i < workers.size(); i++)
+    workers[i].events = std::move(thread_events[i]);
+
+  if (verbose)
+    fprintf(stdout,
+            "Replaying %llu events of %llu sessions on %llu threads\n",
+            static_cast<ulonglong>(events.size()),
+            static_cast<ulonglong>(sessions),
+            static_cast<ulonglong>(workers.size()));
+
+  const longlong origin_us = events.front().time_us;
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (Replay_worker &worker : workers)
+    threads.emplace_back(run_replay_worker, &worker, origin_us, start);
+  for (std::thread &thread : threads) thread.join();
+  const double wall_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+
+  std::unordered_map<uint, Digest_stats> totals;
+  longlong max_lag_us = 0;
+  bool failed = false;
+  for (Replay_worker &worker : workers) {
+    for (auto &entry : worker.stats) totals[entry.first].merge(entry.second);
+    max_lag_us = std::max(max_lag_us, worker.max_lag_us);
+    failed |= worker.failed;
+  }
+
+  std::vector<std::pair<uint, Digest_stats *>> sorted;
+  ulonglong statements = 0, errors = 0;
+  for (auto &entry : totals) {
+    sorted.emplace_back(entry.first, &entry.second);
+    statements += entry.second.count;
+    errors += entry.second.errors;
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<uint, Digest_stats *> &a,
+               const std::pair<uint, Digest_stats *> &b) {
+              return a.second->replay_us > b.second->replay_us;
+            });
+
+  const double span_s =
+      (events.back().time_us - events.front().time_us) / 1000000.0;
+  printf("Replayed %llu statements (%llu errors) in %.3f s; captured span "
+         "%.3f s; largest delay behind schedule %.3f ms\n\n",
+         statements, errors, wall_s, span_s, max_lag_us / 1000.0);
+  printf("%10s %8s %12s %12s %9s %12s  %s\n", "count", "errors", "orig avg ms",
+         "avg ms", "delta", "p99 ms", "digest");
+  uint shown = 0;
+  for (auto &entry : sorted) {
+    if (shown++ == opt_top) break;
+    Digest_stats &stats = *entry.second;
+    std::vector<uint> &latencies = stats.replay_latencies;
+    size_t rank = latencies.size() * 99 / 100;
+    std::nth_element(latencies.begin(), latencies.begin() + rank,
+                     latencies.end());
+    double avg_ms = stats.replay_us / stats.count / 1000.0;
+    char original[32] = "-", delta[32] = "-";
+    if (stats.original_count) {
+      double original_ms = stats.original_us / stats.original_count / 1000.0;
+      snprintf(original, sizeof(original), "%.3f", original_ms);
+      if (original_ms > 0)
+        snprintf(delta, sizeof(delta), "%+.1f%%",
+                 (avg_ms / original_ms - 1) * 100);
+    }
+    printf("%10llu %8llu %12s %12.3f %9s %12.3f  %.100s\n", stats.count,
+           stats.errors, original, avg_ms, delta, latencies[rank] / 1000.0,
+           digests[entry.first].c_str());
+  }
+  return failed ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+  int error = 0;
+  MY_INIT(argv[0]);
+  my_getopt_use_args_separator = true;
+  MEM_ROOT alloc{PSI_NOT_INSTRUMENTED, 512};
+  if (load_defaults("my", load_default_groups, &argc, &argv, &alloc)) return 1;
+  my_getopt_use_args_separator = false;
+
+  if (get_options(&argc, &argv)) {
+    my_end(0);
+    return 1;
+  }
+
+  if (opt_replay) {
+    error = replay(opt_replay);
+  } else {
+    Capture_writer writer;
+    if (writer.open(opt_output))
+      error = 1;
+    else
+      error = opt_capture_general_log ? capture_general_log(&writer)
+                                      : capture_performance_schema(&writer);
+    if (writer.close()) error = 1;
+    if (!error)
+      fprintf(stdout, "Captured %llu statements with %llu digests into %s\n",
+              writer.statements(), static_cast<ulonglong>(writer.digests()),
+              opt_output);
+  }
+
+  my_free(opt_password);
+#if defined(_WIN32)
+  my_free(shared_memory_base_name);
+#endif
+  mysql_server_end();
+  my_end(my_end_arg);
+  return error;
+}
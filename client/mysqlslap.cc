@@ -106,6 +106,11 @@ TODO:
 #endif
 #include <stdio.h>
 #include <time.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
 
 #include "client/client_priv.h"
 #include "compression.h"
@@ -173,6 +178,10 @@ static unsigned long connect_flags =
 static int verbose;
 static uint commit_rate;
 static uint detach_rate;
+static ulong opt_rate = 0;
+static uint opt_report_interval = 0;
+static uint opt_inception_batch = 0;
+static char *opt_inception_options = nullptr;
 const char *num_int_cols_opt;
 const char *num_char_cols_opt;
 
@@ -257,6 +266,103 @@ struct conclusions {
   unsigned long long min_rows;
 };
 
+/**
+  Log-linear latency histogram in the style of HdrHistogram.
+
+  Values are microseconds. Below 128 every value has its own bucket; above
+  that each power of two is split into 64 buckets, so any recorded value is
+  reported with less than 1.6% error. Counters are atomic so that all
+  client threads can record into the same histogram without a lock.
+*/
+class Latency_histogram {
+ public:
+  static constexpr uint SUB_BUCKETS = 128;
+  static constexpr uint HALF_BUCKETS = SUB_BUCKETS / 2;
+  /* Values are capped at 2^40 microseconds (about 12 days). */
+  static constexpr uint MAX_SHIFT = 40 - 6;
+  static constexpr uint BUCKETS = SUB_BUCKETS + MAX_SHIFT * HALF_BUCKETS;
+
+  Latency_histogram() { reset(); }
+
+  void record(ulonglong value) {
+    m_counts[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    ulonglong max = m_max.load(std::memory_order_relaxed);
+    while (value > max &&
+           !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  void reset() {
+    for (auto &count : m_counts) count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+  }
+
+  /** Add all counts to @c to and clear this histogram. */
+  void drain_into(Latency_histogram *to) {
+    for (uint i = 0; i < BUCKETS; i++)
+      to->m_counts[i].fetch_add(
+          m_counts[i].exchange(0, std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    ulonglong max = m_max.exchange(0, std::memory_order_relaxed);
+    if (max > to->m_max.load(std::memory_order_relaxed))
+      to->m_max.store(max, std::memory_order_relaxed);
+  }
+
+  ulonglong count() const {
+    ulonglong total = 0;
+    for (const auto &c : m_counts) total += c.load(std::memory_order_relaxed);
+    return total;
+  }
+
+  ulonglong max() const { return m_max.load(std::memory_order_relaxed); }
+
+  /** Smallest recorded value that at least @c fraction of values are below. */
+  ulonglong percentile(double fraction) const {
+    ulonglong total = count();
+    if (total == 0) return 0;
+    ulonglong rank = static_cast<ulonglong>(fraction * total);
+    if (rank < total && rank < fraction * total) rank++;
+    if (rank == 0) rank = 1;
+    ulonglong seen = 0;
+    for (uint i = 0; i < BUCKETS; i++) {
+      seen += m_counts[i].load(std::memory_order_relaxed);
+      if (seen >= rank) return std::min(highest_value(i), max());
+    }
+    return max();
+  }
+
+ private:
+  static uint bucket(ulonglong value) {
+    if (value < SUB_BUCKETS) return static_cast<uint>(value);
+    uint msb = 7;
+    while (value >> (msb + 1)) msb++;
+    uint shift = msb - 6;
+    if (shift > MAX_SHIFT) return BUCKETS - 1;
+    return SUB_BUCKETS + (shift - 1) * HALF_BUCKETS +
+           static_cast<uint>(value >> shift) - HALF_BUCKETS;
+  }
+
+  static ulonglong highest_value(uint index) {
+    if (index < SUB_BUCKETS) return index;
+    uint shift = (index - SUB_BUCKETS) / HALF_BUCKETS + 1;
+    ulonglong top = (index - SUB_BUCKETS) % HALF_BUCKETS + HALF_BUCKETS;
+    return ((top + 1) << shift) - 1;
+  }
+
+  std::atomic<ulonglong> m_counts[BUCKETS];
+  std::atomic<ulonglong> m_max;
+};
+
+/* Latency of every query, of the current --report-interval and per query */
+static Latency_histogram total_latency;
+static Latency_histogram interval_latency;
+static std::unique_ptr<Latency_histogram[]> query_latency;
+static uint query_latency_count = 0;
+
+/* Arrival schedule for --rate */
+static std::chrono::steady_clock::time_point rate_start;
+static std::atomic<ulonglong> rate_next_slot{0};
+
 static option_string *engine_options = nullptr;
 static statement *pre_statements = nullptr;
 static statement *post_statements = nullptr;
@@ -289,6 +395,8 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr);
 static int run_statements(MYSQL *mysql, statement *stmt);
 int slap_connect(MYSQL *mysql);
 static int run_query(MYSQL *mysql, const char *query, size_t len);
+static statement *build_inception_batches(statement *stmts, uint batch_size);
+static void print_latency_line(const char *prefix, const Latency_histogram &h);
 
 static const char ALPHANUMERICS[] =
     "0123456789ABCDEFGHIJKLMNOPQRSTWXYZabcdefghijklmnopqrstuvwxyz";
@@ -459,6 +567,13 @@ void concurrency_loop(MYSQL *mysql, uint current, option_string *eptr) {
 
   memset(&conclusion, 0, sizeof(conclusions));
 
+  /* Latency is collected over all iterations of this concurrency level */
+  total_latency.reset();
+  query_latency_count = 0;
+  for (statement *ptr = query_statements; ptr && ptr->length; ptr = ptr->next)
+    query_latency_count++;
+  query_latency.reset(new Latency_histogram[query_latency_count]);
+
   if (auto_actual_queries)
     client_limit = auto_actual_queries;
   else if (num_of_query)
@@ -629,6 +744,17 @@ static struct my_option my_long_options[] = {
      nullptr, 0, nullptr},
     {"host", 'h', "Connect to host.", &host, &host, nullptr, GET_STR,
      REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"inception-batch", 0,
+     "Group this many consecutive --query statements into one inception "
+     "batch (magic_start, statements, magic_commit) sent in a single round "
+     "trip. Requires --inception-options.",
+     &opt_inception_batch, &opt_inception_batch, nullptr, GET_UINT,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
+    {"inception-options", 0,
+     "Options of the inception_magic_start comment used by --inception-batch, "
+     "e.g. '--user=u;--password=p;--host=h;--port=3306;--enable-check=1'.",
+     &opt_inception_options, &opt_inception_options, nullptr, GET_STR,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
     {"iterations", 'i', "Number of times to run the tests.", &iterations,
      &iterations, nullptr, GET_UINT, REQUIRED_ARG, 1, 1, UINT_MAX, nullptr, 0,
      nullptr},
@@ -691,6 +817,18 @@ static struct my_option my_long_options[] = {
     {"query", 'q', "Query to run or file containing query to run.",
      &user_supplied_query, &user_supplied_query, nullptr, GET_STR, REQUIRED_ARG,
      0, 0, 0, nullptr, 0, nullptr},
+    {"rate", 0,
+     "Open-loop mode: start queries on a fixed schedule of this many per "
+     "second over all clients, whether or not earlier queries have "
+     "finished. Latency is measured from the scheduled start, so time spent "
+     "waiting for a free client is included. 0 runs closed-loop.",
+     &opt_rate, &opt_rate, nullptr, GET_ULONG, REQUIRED_ARG, 0, 0, 0, nullptr,
+     0, nullptr},
+    {"report-interval", 0,
+     "Print queries per second and latency percentiles every this many "
+     "seconds while the test runs. 0 disables.",
+     &opt_report_interval, &opt_report_interval, nullptr, GET_UINT,
+     REQUIRED_ARG, 0, 0, 0, nullptr, 0, nullptr},
 #if defined(_WIN32)
     {"shared-memory-base-name", OPT_SHARED_MEMORY_BASE_NAME,
      "Base name of shared memory.", &shared_memory_base_name,
@@ -1353,6 +1491,22 @@ static int get_options(int *argc, char ***argv) {
     }
   }
 
+  if (opt_inception_batch) {
+    if (!opt_inception_options || !query_statements) {
+      fprintf(stderr,
+              "%s: --inception-batch needs --inception-options and --query\n",
+              my_progname);
+      exit(1);
+    }
+    statement *batches =
+        build_inception_batches(query_statements, opt_inception_batch);
+    statement_cleanup(query_statements);
+    query_statements = batches;
+    for (actual_queries = 0; batches && batches->length;
+         batches = batches->next)
+      actual_queries++;
+  }
+
   if (user_supplied_pre_statements &&
       my_stat(user_supplied_pre_statements, &sbuf, MYF(0))) {
     File data_file;
@@ -1652,6 +1806,10 @@ static int run_scheduler(stats *sptr, statement *stmts, uint concur,
   native_mutex_unlock(&counter_mutex);
   my_thread_attr_destroy(&attr);
 
+  interval_latency.reset();
+  rate_next_slot = 0;
+  rate_start = std::chrono::steady_clock::now();
+
   native_mutex_lock(&sleeper_mutex);
   master_wakeup = 0;
   native_mutex_unlock(&sleeper_mutex);
@@ -1660,14 +1818,42 @@ static int run_scheduler(stats *sptr, statement *stmts, uint concur,
   gettimeofday(&start_time, nullptr);
 
   /*
-    We loop until we know that all children have cleaned up.
+    We loop until we know that all children have cleaned up, printing the
+    progress of every --report-interval on the way.
   */
+  const std::chrono::seconds interval(opt_report_interval);
+  auto next_report = rate_start + interval;
   native_mutex_lock(&counter_mutex);
   while (thread_counter) {
     struct timespec abstime;
 
-    set_timespec(&abstime, 3);
+    if (opt_report_interval) {
+      auto wait = next_report - std::chrono::steady_clock::now();
+      set_timespec_nsec(
+          &abstime,
+          std::max<long long>(
+              0, std::chrono::duration_cast<std::chrono::nanoseconds>(wait)
+                     .count()));
+    } else
+      set_timespec(&abstime, 3);
     native_cond_timedwait(&count_threshold, &counter_mutex, &abstime);
+
+    if (opt_report_interval &&
+        std::chrono::steady_clock::now() >= next_report) {
+      static Latency_histogram snapshot;
+      char prefix[128];
+      snapshot.reset();
+      interval_latency.drain_into(&snapshot);
+      ulonglong done = snapshot.count();
+      snprintf(prefix, sizeof(prefix), "[%5llds] queries: %llu, qps: %.1f, ",
+               static_cast<long long>(
+                   std::chrono::duration_cast<std::chrono::seconds>(
+                       next_report - rate_start)
+                       .count()),
+               done, static_cast<double>(done) / opt_report_interval);
+      if (!opt_silent) print_latency_line(prefix, snapshot);
+      next_report += interval;
+    }
   }
   native_mutex_unlock(&counter_mutex);
 
@@ -1743,6 +1929,19 @@ extern "C" void *run_task(void *p) {
         if (slap_connect(mysql)) goto end;
       }
 
+      /*
+        In open-loop mode every query has a slot in a fixed schedule and its
+        latency counts from that slot, not from when a client got to it.
+      */
+      std::chrono::steady_clock::time_point query_start;
+      if (opt_rate) {
+        ulonglong slot = rate_next_slot.fetch_add(1);
+        query_start = rate_start + std::chrono::nanoseconds(
+                                       slot * 1000000000ULL / opt_rate);
+        std::this_thread::sleep_until(query_start);
+      } else
+        query_start = std::chrono::steady_clock::now();
+
       /*
         We have to execute differently based on query type. This should become a
         function.
@@ -1798,6 +1997,18 @@ extern "C" void *run_task(void *p) {
       } while (mysql_next_result(mysql) == 0);
       queries++;
 
+      {
+        ulonglong latency = static_cast<ulonglong>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - query_start)
+                .count());
+        total_latency.record(latency);
+        interval_latency.record(latency);
+        /* detach_counter is also the position of ptr in the list */
+        if (detach_counter < query_latency_count)
+          query_latency[detach_counter].record(latency);
+      }
+
       if (commit_rate && (++commit_counter == commit_rate)) {
         commit_counter = 0;
         run_query(mysql, "COMMIT", strlen("COMMIT"));
@@ -1980,9 +2191,64 @@ void print_conclusions(conclusions *con) {
          con->max_timing / 1000, con->max_timing % 1000);
   printf("\tNumber of clients running queries: %d\n", con->users);
   printf("\tAverage number of queries per client: %llu\n", con->avg_rows);
+  if (opt_rate && con->avg_timing)
+    printf("\tTarget rate: %lu queries per second, achieved: %.1f\n", opt_rate,
+           total_latency.count() * 1000.0 / (con->avg_timing * iterations));
+  if (total_latency.count()) print_latency_line("\tLatency: ", total_latency);
+  if (verbose >= 1 && query_latency_count > 1) {
+    for (uint i = 0; i < query_latency_count; i++) {
+      char prefix[64];
+      if (!query_latency[i].count()) continue;
+      snprintf(prefix, sizeof(prefix), "\t  query %u: ", i + 1);
+      print_latency_line(prefix, query_latency[i]);
+    }
+  }
   printf("\n");
 }
 
+static void print_latency_line(const char *prefix, const Latency_histogram &h) {
+  printf("%sp50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, max %.3f ms\n", prefix,
+         h.percentile(0.5) / 1000.0, h.percentile(0.99) / 1000.0,
+         h.percentile(0.999) / 1000.0, h.max() / 1000.0);
+  fflush(stdout);
+}
+
+/**
+  Regroup a list of statements into inception batches.
+
+  Every batch is one multi-statement query: the inception_magic_start
+  comment built from --inception-options, up to @c batch_size statements
+  and the inception_magic_commit comment, so that one round trip audits
+  (or executes) a whole batch.
+*/
+static statement *build_inception_batches(statement *stmts, uint batch_size) {
+  statement *head = nullptr, **next = &head;
+  std::string options(opt_inception_options);
+  while (!options.empty() && (options.back() == ';' || isspace(options.back())))
+    options.pop_back();
+
+  for (statement *ptr = stmts; ptr && ptr->length;) {
+    std::string batch = "/*" + options + ";inception_magic_start;*/\n";
+    for (uint n = 0; n < batch_size && ptr && ptr->length;
+         n++, ptr = ptr->next) {
+      batch.append(ptr->string, ptr->length);
+      if (ptr->string[ptr->length - 1] != ';') batch.push_back(';');
+      batch.push_back('\n');
+    }
+    batch.append("/*inception_magic_commit;*/");
+
+    statement *tmp =
+        (statement *)my_malloc(PSI_NOT_INSTRUMENTED, sizeof(statement),
+                               MYF(MY_ZEROFILL | MY_FAE | MY_WME));
+    tmp->string = my_strndup(PSI_NOT_INSTRUMENTED, batch.data(), batch.size(),
+                             MYF(MY_FAE));
+    tmp->length = batch.size();
+    *next = tmp;
+    next = &tmp->next;
+  }
+  return head;
+}
+
 void print_conclusions_csv(conclusions *con) {
   char buffer[HUGE_STRING_LENGTH];
   const char *ptr = auto_generate_sql_type ? auto_generate_sql_type : "query";
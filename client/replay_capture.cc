@@ -0,0 +1,296 @@
+/*
+   Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "client/replay_capture.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "template_utils.h"
+
+const char REPLAY_MAGIC[8] = {'M', 'Y', 'R', 'P', 'L', '\x01', '\n', '\0'};
+
+void put_varint(std::string *out, ulonglong value) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+ulonglong zigzag(longlong value) {
+  return (static_cast<ulonglong>(value) << 1) ^
+         static_cast<ulonglong>(value >> 63);
+}
+
+longlong unzigzag(ulonglong value) {
+  return static_cast<longlong>(value >> 1) ^ -static_cast<longlong>(value & 1);
+}
+
+std::string fingerprint(const std::string &query) {
+  std::string out;
+  bool blank = false;
+  for (size_t i = 0; i < query.size() && out.size() < 1024; i++) {
+    char c = query[i];
+    if (isspace(static_cast<uchar>(c))) {
+      blank = !out.empty();
+      continue;
+    }
+    if (blank) out.push_back(' ');
+    blank = false;
+    if (c == '\'' || c == '"') {
+      /* A doubled quote continues the literal */
+      for (i++; i < query.size(); i++) {
+        if (query[i] == '\\')
+          i++;
+        else if (query[i] == c) {
+          if (i + 1 < query.size() && query[i + 1] == c)
+            i++;
+          else
+            break;
+        }
+      }
+      out.push_back('?');
+      continue;
+    }
+    if (isdigit(static_cast<uchar>(c)) &&
+        (out.empty() || !(isalnum(static_cast<uchar>(out.back())) ||
+                          out.back() == '_' || out.back() == '$'))) {
+      while (i + 1 < query.size() &&
+             (isalnum(static_cast<uchar>(query[i + 1])) || query[i + 1] == '.'))
+        i++;
+      out.push_back('?');
+      continue;
+    }
+    out.push_back(c);
+  }
+  return out;
+}
+
+void Capture_encoder::add_query(ulonglong session, longlong start_us,
+                                longlong latency_us, const std::string &digest,
+                                const std::string &query) {
+  uint digest_id = digest_index(digest.empty() ? fingerprint(query) : digest);
+  m_buffer.push_back('Q');
+  put_varint(&m_buffer, session);
+  put_time(start_us);
+  put_varint(&m_buffer, latency_us < 0 ? 0 : latency_us + 1);
+  put_varint(&m_buffer, digest_id);
+  put_varint(&m_buffer, query.size());
+  m_buffer.append(query);
+  m_statements++;
+}
+
+void Capture_encoder::set_schema(ulonglong session, longlong start_us,
+                                 const std::string &schema) {
+  auto it = m_schemas.find(session);
+  if (it != m_schemas.end() && it->second == schema) return;
+  m_schemas[session] = schema;
+  m_buffer.push_back('S');
+  put_varint(&m_buffer, session);
+  put_time(start_us);
+  put_varint(&m_buffer, schema.size());
+  m_buffer.append(schema);
+}
+
+uint Capture_encoder::digest_index(const std::string &digest) {
+  auto it = m_digests.find(digest);
+  if (it != m_digests.end()) return it->second;
+  uint id = static_cast<uint>(m_digests.size());
+  m_digests.emplace(digest, id);
+  m_buffer.push_back('D');
+  put_varint(&m_buffer, digest.size());
+  m_buffer.append(digest);
+  return id;
+}
+
+void Capture_encoder::put_time(longlong start_us) {
+  put_varint(&m_buffer, zigzag(start_us - m_last_time));
+  m_last_time = start_us;
+}
+
+size_t parse_log_time(const char *line, longlong *us) {
+  int year, month, day, hour, minute, second, consumed = 0;
+  if (sscanf(line, "%4d-%2d-%2dT%2d:%2d:%2d%n", &year, &month, &day, &hour,
+             &minute, &second, &consumed) != 6 ||
+      consumed != 19)
+    return 0;
+  const char *pos = line + consumed;
+  longlong fraction = 0;
+  int digits = 0;
+  if (*pos == '.')
+    for (pos++; isdigit(static_cast<uchar>(*pos)); pos++, digits++)
+      if (digits < 6) fraction = fraction * 10 + (*pos - '0');
+  for (; digits < 6; digits++) fraction *= 10;
+  while (*pos && *pos != '\t' && *pos != ' ') pos++;
+
+  /* Days from civil, proleptic Gregorian calendar. */
+  year -= month <= 2;
+  const longlong era = (year >= 0 ? year : year - 399) / 400;
+  const longlong yoe = year - era * 400;
+  const longlong doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  const longlong doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  const longlong days = era * 146097 + doe - 719468;
+  *us = ((days * 24 + hour) * 60 + minute) * 60 + second;
+  *us = *us * 1000000 + fraction;
+  return pos - line;
+}
+
+void General_log_parser::add_line(const std::string &line) {
+  longlong start_us;
+  size_t time_len = parse_log_time(line.c_str(), &start_us);
+  if (time_len && line[time_len] == '\t') {
+    /* "<time>\t<id> <command>\t<argument>" */
+    flush();
+    const char *pos = line.c_str() + time_len + 1;
+    char *end;
+    ulonglong session = strtoull(pos, &end, 10);
+    const char *tab = *end == ' ' ? strchr(end + 1, '\t') : nullptr;
+    if (tab) {
+      m_entry.valid = true;
+      m_entry.session = session;
+      m_entry.start_us = start_us;
+      m_entry.command.assign(end + 1, tab - end - 1);
+      m_entry.argument.assign(tab + 1);
+    }
+  } else if (m_entry.valid) {
+    /* Continuation of a multi-line statement */
+    m_entry.argument.push_back('\n');
+    m_entry.argument.append(line);
+  }
+}
+
+void General_log_parser::flush() {
+  if (!m_entry.valid) return;
+  m_entry.valid = false;
+  if (m_entry.command == "Query" || m_entry.command == "Execute") {
+    m_encoder->add_query(m_entry.session, m_entry.start_us, -1, "",
+                         m_entry.argument);
+  } else if (m_entry.command == "Init DB") {
+    m_encoder->set_schema(m_entry.session, m_entry.start_us, m_entry.argument);
+  } else if (m_entry.command == "Connect") {
+    /* "user@host on schema using TCP/IP" */
+    size_t on = m_entry.argument.find(" on ");
+    size_t using_pos = m_entry.argument.rfind(" using ");
+    if (on != std::string::npos && using_pos != std::string::npos &&
+        using_pos > on + 4)
+      m_encoder->set_schema(
+          m_entry.session, m_entry.start_us,
+          m_entry.argument.substr(on + 4, using_pos - on - 4));
+  }
+}
+
+bool get_varint(const uchar **pos, const uchar *end, ulonglong *value) {
+  *value = 0;
+  for (uint shift = 0; *pos < end && shift < 64; shift += 7) {
+    uchar byte = *(*pos)++;
+    *value |= static_cast<ulonglong>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return false;
+  }
+  return true;
+}
+
+bool get_bytes(const uchar **pos, const uchar *end, std::string *out) {
+  ulonglong length;
+  if (get_varint(pos, end, &length) ||
+      length > static_cast<ulonglong>(end - *pos))
+    return true;
+  out->assign(pointer_cast<const char *>(*pos), length);
+  *pos += length;
+  return false;
+}
+
+bool parse_capture(const std::string &data, std::vector<Replay_event> *events,
+                   std::vector<std::string> *digests, size_t *error_offset) {
+  if (data.size() < sizeof(REPLAY_MAGIC) ||
+      memcmp(data.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC))) {
+    *error_offset = 0;
+    return true;
+  }
+  const uchar *begin = pointer_cast<const uchar *>(data.data());
+  const uchar *pos = begin + sizeof(REPLAY_MAGIC);
+  const uchar *end = begin + data.size();
+  longlong time_us = 0;
+  while (pos < end) {
+    uchar tag = *pos++;
+    ulonglong session, delta, latency, digest;
+    Replay_event event;
+    bool error = false;
+    switch (tag) {
+      case 'D':
+        digests->emplace_back();
+        error = get_bytes(&pos, end, &digests->back());
+        break;
+      case 'Q':
+      case 'S':
+        error = get_varint(&pos, end, &session) ||
+                get_varint(&pos, end, &delta);
+        if (!error && tag == 'Q')
+          error = get_varint(&pos, end, &latency) ||
+                  get_varint(&pos, end, &digest) || digest >= digests->size();
+        if (!error) error = get_bytes(&pos, end, &event.text);
+        if (error) break;
+        time_us += unzigzag(delta);
+        event.session = session;
+        event.time_us = time_us;
+        event.schema_change = tag == 'S';
+        event.latency_us = tag == 'Q' ? static_cast<longlong>(latency) - 1 : -1;
+        event.digest = tag == 'Q' ? static_cast<uint>(digest) : 0;
+        events->push_back(std::move(event));
+        break;
+      default:
+        error = true;
+    }
+    if (error) {
+      *error_offset = pos - begin;
+      return true;
+    }
+  }
+  std::stable_sort(events->begin(), events->end(),
+                   [](const Replay_event &a, const Replay_event &b) {
+                     return a.time_us < b.time_us;
+                   });
+  return false;
+}
+
+size_t assign_replay_threads(
+    const std::vector<Replay_event> &events, uint max_threads,
+    std::vector<std::vector<const Replay_event *>> *threads) {
+  std::unordered_map<ulonglong, size_t> session_thread;
+  for (const Replay_event &event : events)
+    if (session_thread.find(event.session) == session_thread.end())
+      session_thread.emplace(event.session, session_thread.size());
+  size_t thread_count = std::min<size_t>(max_threads, session_thread.size());
+  threads->assign(thread_count, {});
+  for (const Replay_event &event : events)
+    (*threads)[session_thread[event.session] % thread_count].push_back(&event);
+  return session_thread.size();
+}
+
+longlong replay_offset_us(longlong time_us, longlong origin_us, double speed) {
+  return static_cast<longlong>((time_us - origin_us) / speed);
+}
@@ -0,0 +1,189 @@
+#ifndef REPLAY_CAPTURE_INCLUDED
+#define REPLAY_CAPTURE_INCLUDED
+
+/*
+   Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+/*
+  The capture file format of mysqlreplay and the parsing and scheduling
+  logic that does not need a server connection.
+
+  File format: the 8 byte magic "MYRPL\x01\n\0" followed by records, each
+  starting with a tag byte. Integers are LEB128 varints; times are deltas in
+  microseconds from the previous record, zigzag encoded because polling
+  performance_schema may return statements slightly out of start order.
+
+    'D' len text                              digest text, ids count from 0
+    'Q' session delta latency+1 digest len text   a statement (latency 0 is
+                                              unknown, e.g. from a general
+                                              log)
+    'S' session delta len schema              the session changed schema
+*/
+
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "my_inttypes.h"
+
+extern const char REPLAY_MAGIC[8];
+
+void put_varint(std::string *out, ulonglong value);
+ulonglong zigzag(longlong value);
+longlong unzigzag(ulonglong value);
+
+/**
+  Normalize a statement into a digest-like key for captures that carry no
+  digest: literals become '?', runs of white space become one blank.
+*/
+std::string fingerprint(const std::string &query);
+
+/** Builds capture records; statements must come roughly in start order. */
+class Capture_encoder {
+ public:
+  /**
+    Add one statement.
+
+    @param session     session (thread) id
+    @param start_us    start time in microseconds, any fixed origin
+    @param latency_us  original execution time, or -1 if unknown
+    @param digest      digest text, or empty to compute a fingerprint
+    @param query       statement text
+  */
+  void add_query(ulonglong session, longlong start_us, longlong latency_us,
+                 const std::string &digest, const std::string &query);
+
+  /** Record that @c session now uses @c schema, if it changed. */
+  void set_schema(ulonglong session, longlong start_us,
+                  const std::string &schema);
+
+  ulonglong statements() const { return m_statements; }
+  size_t digests() const { return m_digests.size(); }
+
+ protected:
+  /** Records not written out yet, without the magic. */
+  std::string m_buffer;
+
+ private:
+  uint digest_index(const std::string &digest);
+  void put_time(longlong start_us);
+
+  longlong m_last_time{0};
+  ulonglong m_statements{0};
+  std::unordered_map<std::string, uint> m_digests;
+  std::unordered_map<ulonglong, std::string> m_schemas;
+};
+
+/**
+  Parse the ISO 8601 timestamp at the start of a general log line
+  ("2021-05-01T10:00:00.123456Z" or with a +hh:mm offset) into microseconds
+  since the epoch. The offset is ignored: one log uses only one.
+
+  @return length of the timestamp, or 0 if the line does not start with one
+*/
+size_t parse_log_time(const char *line, longlong *us);
+
+/** One pending general log entry; queries may span several lines. */
+struct Log_entry {
+  bool valid{false};
+  ulonglong session{0};
+  longlong start_us{0};
+  std::string command;
+  std::string argument;
+};
+
+/**
+  Turns the lines of a general query log into capture records: queries,
+  and the schema changes of "Init DB" and "Connect" entries.
+*/
+class General_log_parser {
+ public:
+  explicit General_log_parser(Capture_encoder *encoder)
+      : m_encoder(encoder) {}
+
+  /** Add one line of the log, without its line break. */
+  void add_line(const std::string &line);
+
+  /** Add the entry still pending at the end of the log. */
+  void finish() { flush(); }
+
+ private:
+  void flush();
+
+  Capture_encoder *m_encoder;
+  Log_entry m_entry;
+};
+
+struct Replay_event {
+  ulonglong session;
+  longlong time_us;
+  longlong latency_us; /* -1 if unknown */
+  uint digest;
+  bool schema_change;
+  std::string text;
+};
+
+bool get_varint(const uchar **pos, const uchar *end, ulonglong *value);
+bool get_bytes(const uchar **pos, const uchar *end, std::string *out);
+
+/**
+  Decode a capture file into events in start order.
+
+  @param data        the whole file
+  @param[out] events
+  @param[out] digests
+  @param[out] error_offset  where the file is corrupt, 0 if the magic is
+                            missing
+
+  @retval true if the file is not a valid capture
+*/
+bool parse_capture(const std::string &data, std::vector<Replay_event> *events,
+                   std::vector<std::string> *digests, size_t *error_offset);
+
+/**
+  Spread the sessions of a capture over replay threads, round robin in order
+  of first appearance, so that a session's statements run on one thread in
+  their original order.
+
+  @param events        events in start order
+  @param max_threads   --threads
+  @param[out] threads  events of each thread, in start order
+
+  @return number of sessions
+*/
+size_t assign_replay_threads(
+    const std::vector<Replay_event> &events, uint max_threads,
+    std::vector<std::vector<const Replay_event *>> *threads);
+
+/**
+  When an event is due, in microseconds after the start of the replay.
+
+  @param time_us    start of the event in the capture
+  @param origin_us  start of the first event in the capture
+  @param speed      --speed, greater than 0
+*/
+longlong replay_offset_us(longlong time_us, longlong origin_us, double speed);
+
+#endif  // REPLAY_CAPTURE_INCLUDED
@@ -0,0 +1,85 @@
+/**
+ * @file inception_rule_example.cc
+ * @brief An inception audit rule component.
+ *
+ *   INSTALL COMPONENT 'file://component_inception_rule_example';
+ *
+ * adds two rules to every inception session:
+ *   - no_tmp_table: CREATE TABLE of a name starting with "tmp" is an error;
+ *   - truncate_large_table: TRUNCATE of a table the target estimates at
+ *     more than 1000000 rows is a warning.
+ */
+
+#include <mysql/components/component_implementation.h>
+#include <mysql/components/service_implementation.h>
+#include <mysql/components/services/inception_audit_rule.h>
+#include <stdio.h>
+#include <strings.h>
+
+#include "my_sqlcommand.h"
+
+REQUIRES_SERVICE_PLACEHOLDER(inception_audit_rule);
+REQUIRES_SERVICE_PLACEHOLDER(inception_rule_statement);
+
+BEGIN_COMPONENT_PROVIDES(inception_rule_example)
+END_COMPONENT_PROVIDES();
+
+BEGIN_COMPONENT_REQUIRES(inception_rule_example)
+REQUIRES_SERVICE(inception_audit_rule),
+    REQUIRES_SERVICE(inception_rule_statement), END_COMPONENT_REQUIRES();
+
+static const long long LARGE_TABLE_ROWS = 1000000;
+
+static void no_tmp_table(inception_rule_statement stmt, void *) {
+  const char *db, *table;
+  if (mysql_service_inception_rule_statement->get_table(stmt, 0, &db, &table))
+    return;
+  if (strncasecmp(table, "tmp", 3) == 0)
+    mysql_service_inception_rule_statement->report(
+        stmt, INCEPTION_RULE_ERROR,
+        "Table name must not start with 'tmp'; use a temporary table.");
+}
+
+static void truncate_large_table(inception_rule_statement stmt, void *) {
+  const char *db, *table;
+  long long rows;
+  if (mysql_service_inception_rule_statement->get_table(stmt, 0, &db, &table) ||
+      mysql_service_inception_rule_statement->get_table_rows(stmt, db, table,
+                                                            &rows) ||
+      rows <= LARGE_TABLE_ROWS)
+    return;
+  char msg[512];
+  snprintf(msg, sizeof(msg),
+           "Table '%s.%s' has about %lld rows; TRUNCATE cannot be rolled back.",
+           db, table, rows);
+  mysql_service_inception_rule_statement->report(stmt, INCEPTION_RULE_WARNING,
+                                                 msg);
+}
+
+static mysql_service_status_t deinit() {
+  mysql_service_inception_audit_rule->unregister_rule("no_tmp_table");
+  mysql_service_inception_audit_rule->unregister_rule("truncate_large_table");
+  return 0;
+}
+
+static mysql_service_status_t init() {
+  if (mysql_service_inception_audit_rule->register_rule(
+          "no_tmp_table", SQLCOM_CREATE_TABLE, no_tmp_table, nullptr) ||
+      mysql_service_inception_audit_rule->register_rule(
+          "truncate_large_table", SQLCOM_TRUNCATE, truncate_large_table,
+          nullptr)) {
+    fprintf(stderr, "Can't register the inception_rule_example rules\n");
+    deinit();
+    return 1;
+  }
+  return 0;
+}
+
+BEGIN_COMPONENT_METADATA(inception_rule_example)
+METADATA("mysql.license", "GPL"), END_COMPONENT_METADATA();
+
+DECLARE_COMPONENT(inception_rule_example, "mysql:inception_rule_example")
+init, deinit END_DECLARE_COMPONENT();
+
+DECLARE_LIBRARY_COMPONENTS &COMPONENT_REF(inception_rule_example)
+    END_DECLARE_LIBRARY_COMPONENTS
@@ -46,10 +46,17 @@ error log and as JSON\"", "time" : "1970-01-01T00:00:00.000000Z", "thread" : 0,
 // define to support reading log files (from previous runs)
 #define WITH_LOG_PARSER
 
+#include <mysql/components/services/component_status_var_service.h>
+#include <mysql/components/services/component_sys_var_service.h>
 #include <mysql/components/services/log_builtins.h>
 #include <mysql/components/services/log_shared.h>
 #include <mysql/components/services/log_sink_perfschema.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include "log_service_imp.h"
 #include "my_compiler.h"
 
@@ -61,6 +68,9 @@ error log and as JSON\"", "time" : "1970-01-01T00:00:00.000000Z", "thread" : 0,
 REQUIRES_SERVICE_PLACEHOLDER(log_builtins);
 REQUIRES_SERVICE_PLACEHOLDER(log_builtins_string);
 REQUIRES_SERVICE_PLACEHOLDER(log_sink_perfschema);
+REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_register);
+REQUIRES_SERVICE_PLACEHOLDER(component_sys_variable_unregister);
+REQUIRES_SERVICE_PLACEHOLDER(status_variable_registration);
 
 SERVICE_TYPE(log_builtins) *log_bi = nullptr;
 SERVICE_TYPE(log_builtins_string) *log_bs = nullptr;
@@ -94,6 +104,368 @@ struct my_state {
   char *ext;        ///< file extension of a given error stream
 };
 
+/*
+  Asynchronous mode (log_sink_json.async)
+
+  By default, each event is formatted and written (and flushed) in the
+  thread that raised it.  In asynchronous mode, the formatted record is
+  instead put on a bounded lock-free queue, and a writer thread writes
+  the records in batches, so that threads hitting errors during e.g. an
+  error storm do not wait for the log file.  If the queue is full, the
+  record is dropped and counted (log_sink_json.async_dropped); the
+  writer then logs how many records were lost.
+
+  Independently of that, log_sink_json.rate_limit_interval suppresses
+  records repeating the message of an earlier record within the given
+  number of seconds.  The next record of that message that is written
+  carries the number of suppressed records as "repeated".
+*/
+
+#define MY_NAME "log_sink_json"
+#define OPT_ASYNC "async"
+#define OPT_QUEUE_SIZE "async_queue_size"
+#define OPT_RATE_LIMIT "rate_limit_interval"
+
+static bool log_json_async = false;            ///< sysvar: async mode
+static uint log_json_queue_size = 4096;        ///< sysvar: queue slots
+static uint log_json_rate_limit_interval = 0;  ///< sysvar: in seconds
+
+BOOL_CHECK_ARG(async) values_async;             ///< default for sysvar
+INTEGRAL_CHECK_ARG(uint) values_queue_size,    ///< limits for sysvar
+    values_rate_interval;                        ///< limits for sysvar
+
+static std::atomic<ulonglong> log_json_dropped{0};  ///< queue was full
+static std::atomic<ulonglong> log_json_limited{0};  ///< rate limited
+
+static int show_async_dropped(MYSQL_THD, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  *reinterpret_cast<ulonglong *>(buff) = log_json_dropped.load();
+  return 0;
+}
+
+static int show_rate_limited(MYSQL_THD, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  *reinterpret_cast<ulonglong *>(buff) = log_json_limited.load();
+  return 0;
+}
+
+static SHOW_VAR show_var_json[] = {
+    {MY_NAME ".async_dropped", (char *)&show_async_dropped, SHOW_FUNC,
+     SHOW_SCOPE_GLOBAL},
+    {MY_NAME ".rate_limited", (char *)&show_rate_limited, SHOW_FUNC,
+     SHOW_SCOPE_GLOBAL},
+    {nullptr, nullptr, SHOW_UNDEF, SHOW_SCOPE_UNDEF}  // null terminator
+};
+
+/**
+  Bounded multi-producer queue of formatted records. Producers claim a
+  slot with a CAS on the enqueue position and publish it through the
+  slot's sequence number, so they never block each other or the writer.
+*/
+class Json_log_queue {
+ public:
+  /** A queued record */
+  struct Slot {
+    std::atomic<size_t> seq;  ///< publication state of the slot
+    my_state *instance;       ///< stream to write to
+    char *line;               ///< record, allocated with log_bs->malloc()
+    size_t length;            ///< length of the record
+  };
+
+  /**
+    Allocate the slots.
+    @param size  capacity, rounded up to a power of two
+    @retval false success
+    @retval true  out of memory
+  */
+  bool init(size_t size) {
+    size_t capacity = 1;
+    while (capacity < size) capacity <<= 1;
+
+    m_slots = static_cast<Slot *>(log_bs->malloc(capacity * sizeof(Slot)));
+    if (m_slots == nullptr) return true;
+
+    for (size_t i = 0; i < capacity; i++) {
+      new (&m_slots[i].seq) std::atomic<size_t>(i);
+      m_slots[i].line = nullptr;
+    }
+
+    m_mask = capacity - 1;
+    m_enqueue_pos.store(0);
+    m_dequeue_pos = 0;
+    return false;
+  }
+
+  /** Free the slots. The queue must have been drained. */
+  void deinit() {
+    if (m_slots != nullptr) log_bs->free(m_slots);
+    m_slots = nullptr;
+  }
+
+  bool inited() const { return m_slots != nullptr; }
+
+  /**
+    Queue a copy of a record.
+    @retval false success
+    @retval true  the queue is full, or out of memory
+  */
+  bool push(my_state *instance, const char *line, size_t length) {
+    size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    for (;;) {
+      slot = &m_slots[pos & m_mask];
+      const size_t seq = slot->seq.load(std::memory_order_acquire);
+      const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+      if (diff == 0) {
+        if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed))
+          break;
+      } else if (diff < 0) {
+        return true;  // full
+      } else {
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->instance = instance;
+    slot->length = length;
+    slot->line = static_cast<char *>(log_bs->malloc(length));
+    if (slot->line != nullptr) memcpy(slot->line, line, length);
+
+    // publish even on allocation failure; the reader skips the slot
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    return slot->line == nullptr;
+  }
+
+  /**
+    Take the oldest record. Only called with the writer mutex held.
+    @return the slot, or nullptr if the queue is empty. The caller must
+            call release() when done with it.
+  */
+  Slot *front() {
+    Slot *slot = &m_slots[m_dequeue_pos & m_mask];
+    const size_t seq = slot->seq.load(std::memory_order_acquire);
+
+    return (seq == m_dequeue_pos + 1) ? slot : nullptr;
+  }
+
+  /** Hand the slot returned by front() back to the producers. */
+  void release(Slot *slot) {
+    if (slot->line != nullptr) log_bs->free(slot->line);
+    slot->line = nullptr;
+    slot->seq.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+    m_dequeue_pos++;
+  }
+
+  /** @return true if there is no published record */
+  bool empty() {
+    std::lock_guard<std::mutex> guard(writer_mutex);
+    return front() == nullptr;
+  }
+
+  /** Serializes the consumers, and flush()/close() against them. */
+  std::mutex writer_mutex;
+
+ private:
+  Slot *m_slots{nullptr};               ///< ring of records
+  size_t m_mask{0};                     ///< capacity - 1
+  std::atomic<size_t> m_enqueue_pos{0};  ///< next slot for producers
+  size_t m_dequeue_pos{0};               ///< next slot for the writer
+};
+
+static Json_log_queue log_json_queue;
+
+/// Writer thread, and what it waits on
+static std::thread log_json_writer;
+static std::mutex log_json_writer_wait_mutex;
+static std::condition_variable log_json_writer_wait;
+static bool log_json_writer_stop = false;
+
+/// Upper bound for the records the writer joins into one write
+static const size_t LOG_JSON_BATCH_SIZE = 64 * 1024;
+
+/**
+  Write all queued records. Consecutive records of the same stream are
+  joined into a single write. Caller must hold the writer mutex.
+*/
+static void log_json_drain_locked() {
+  static char batch[LOG_JSON_BATCH_SIZE];
+  size_t batch_len = 0;
+  my_state *batch_instance = nullptr;
+  Json_log_queue::Slot *slot;
+
+  auto write_batch = [&]() {
+    if (batch_len > 0)
+      log_bi->write_errstream(batch_instance->errstream, batch, batch_len);
+    batch_len = 0;
+  };
+
+  while ((slot = log_json_queue.front()) != nullptr) {
+    if (slot->line != nullptr) {
+      if (slot->instance != batch_instance ||
+          batch_len + 1 + slot->length > sizeof(batch)) {
+        write_batch();
+        batch_instance = slot->instance;
+      }
+
+      if (slot->length > sizeof(batch)) {
+        log_bi->write_errstream(slot->instance->errstream, slot->line,
+                                slot->length);
+      } else {
+        // write_errstream() terminates each write with a newline
+        if (batch_len > 0) batch[batch_len++] = '\n';
+        memcpy(&batch[batch_len], slot->line, slot->length);
+        batch_len += slot->length;
+      }
+    }
+    log_json_queue.release(slot);
+  }
+
+  write_batch();
+
+  // Tell the reader of the log that records are missing.
+  static ulonglong reported_dropped = 0;
+  const ulonglong dropped = log_json_dropped.load();
+
+  if ((dropped != reported_dropped) && (batch_instance != nullptr)) {
+    char notice[128];
+    const size_t len = log_bs->substitute(
+        notice, sizeof(notice),
+        (pretty != JSON_NOSPACE)
+            ? "{ \"msg\" : \"log_sink_json: %llu events dropped\" }"
+            : "{\"msg\":\"log_sink_json: %llu events dropped\"}",
+        dropped - reported_dropped);
+    log_bi->write_errstream(batch_instance->errstream, notice, len);
+    reported_dropped = dropped;
+  }
+}
+
+/** Write all queued records. */
+static void log_json_drain() {
+  if (!log_json_queue.inited()) return;
+
+  std::lock_guard<std::mutex> guard(log_json_queue.writer_mutex);
+  log_json_drain_locked();
+}
+
+/** Body of the writer thread */
+static void log_json_writer_run() {
+  std::unique_lock<std::mutex> lock(log_json_writer_wait_mutex);
+
+  while (!log_json_writer_stop) {
+    lock.unlock();
+    log_json_drain();
+    lock.lock();
+
+    // Producers notify without the mutex, so don't wait for too long.
+    log_json_writer_wait.wait_for(lock, std::chrono::milliseconds(100), [] {
+      return log_json_writer_stop || !log_json_queue.empty();
+    });
+  }
+}
+
+/** Start the writer thread if it is not running. */
+static void log_json_writer_start() {
+  if (log_json_writer.joinable() || !log_json_queue.inited()) return;
+
+  log_json_writer_stop = false;
+  log_json_writer = std::thread(log_json_writer_run);
+}
+
+/** Stop the writer thread, and write what it left in the queue. */
+static void log_json_writer_stop_and_drain() {
+  if (log_json_writer.joinable()) {
+    {
+      std::lock_guard<std::mutex> guard(log_json_writer_wait_mutex);
+      log_json_writer_stop = true;
+    }
+    log_json_writer_wait.notify_one();
+    log_json_writer.join();
+  }
+  log_json_drain();
+}
+
+/**
+  Write a formatted record, or queue it for the writer thread.
+
+  @param mi      the stream to write to
+  @param buff    the record
+  @param length  length of the record
+*/
+static void log_json_write(my_state *mi, const char *buff, size_t length) {
+  if (log_json_async && log_json_writer.joinable()) {
+    if (log_json_queue.push(mi, buff, length))
+      log_json_dropped++;
+    else
+      log_json_writer_wait.notify_one();
+    return;
+  }
+
+  log_bi->write_errstream(mi->errstream, buff, length);
+}
+
+/// Number of messages tracked by the rate limiter
+static const size_t LOG_JSON_RATE_SLOTS = 256;
+
+/// Recent message per hash bucket, for the rate limiter
+struct Json_rate_slot {
+  std::atomic<ulonglong> hash{0};     ///< hash of error code and message
+  std::atomic<longlong> since{0};     ///< start of the interval, seconds
+  std::atomic<ulonglong> repeated{0};  ///< records suppressed in it
+};
+
+static Json_rate_slot log_json_rate_slots[LOG_JSON_RATE_SLOTS];
+
+/**
+  Rate-limit identical messages. The check is approximate: concurrent
+  events may both pass, and a message is forgotten when another one
+  hashes to the same bucket.
+
+  @param hash      hash of the error code and message of the record
+  @param repeated  set to the number of records suppressed since the
+                   last record of this message was written
+
+  @retval true   suppress the record
+  @retval false  write the record
+*/
+static bool log_json_rate_limited(ulonglong hash, ulonglong *repeated) {
+  const longlong now = std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+  Json_rate_slot &slot = log_json_rate_slots[hash % LOG_JSON_RATE_SLOTS];
+
+  *repeated = 0;
+
+  if (slot.hash.load() == hash &&
+      now - slot.since.load() < (longlong)log_json_rate_limit_interval) {
+    slot.repeated++;
+    log_json_limited++;
+    return true;
+  }
+
+  if (slot.hash.exchange(hash) == hash)
+    *repeated = slot.repeated.exchange(0);
+  else
+    slot.repeated.store(0);
+  slot.since.store(now);
+
+  return false;
+}
+
+/** FNV-1a, to identify repeated messages */
+static ulonglong log_json_hash(ulonglong hash, const char *s, size_t len) {
+  while (len-- > 0) {
+    hash ^= (unsigned char)*(s++);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
 #ifdef WITH_LOG_PARSER
 
 #define MY_RAPID_INT(key, val, dflt)                         \
@@ -192,6 +564,9 @@ DEFINE_METHOD(int, log_service_imp::run, (void *instance, log_line *ll)) {
   log_item_type_mask out_types = 0;
   log_item_iter *it;
   log_item *li;
+  ulonglong msg_hash = 14695981039346656037ULL;  // FNV-1a offset basis
+  bool msg_seen = false;  // record has a message to rate-limit by
+  bool suppress = false;  // rate-limited: don't write record to the log
 #ifdef WITH_PFS_SUPPORT
   log_item *output_buffer = log_bi->line_get_output_buffer(ll);
 
@@ -241,6 +616,14 @@ DEFINE_METHOD(int, log_service_imp::run, (void *instance, log_line *ll)) {
 
       if (item_type == LOG_ITEM_LOG_PRIO) {
         level = static_cast<enum loglevel>(li->data.data_integer);
+      } else if (item_type == LOG_ITEM_SQL_ERRCODE) {
+        msg_hash = log_json_hash(msg_hash, (const char *)&li->data.data_integer,
+                                 sizeof(li->data.data_integer));
+      } else if ((item_type == LOG_ITEM_LOG_MESSAGE) &&
+                 (li->data.data_string.str != nullptr)) {
+        msg_hash = log_json_hash(msg_hash, li->data.data_string.str,
+                                 li->data.data_string.length);
+        msg_seen = true;
       }
 
       switch (li->item_class) {
@@ -358,6 +741,28 @@ DEFINE_METHOD(int, log_service_imp::run, (void *instance, log_line *ll)) {
           goto fail; /* purecov: inspected */
       }
 
+      /*
+        Suppress repeats of a message within log_sink_json.rate_limit_interval
+        seconds. The next record of it that we write says how many of them
+        we suppressed.
+      */
+      if (msg_seen && (log_json_rate_limit_interval > 0)) {
+        ulonglong repeated;
+
+        suppress = log_json_rate_limited(msg_hash, &repeated);
+
+        if (repeated > 0) {
+          len = log_bs->substitute(out_writepos, out_left, "%s\"%s\"%s%llu",
+                                   comma, "repeated", separator, repeated);
+          if (len < out_left) {
+            out_fields++;
+            out_left -= len;
+            out_writepos += len;
+          } else                  // count didn't fit
+            *out_writepos = '\0'; /* purecov: inspected */
+        }
+      }
+
       len = log_bs->substitute(out_writepos, out_left,
                                (pretty != JSON_NOSPACE) ? " }" : "}");
       if (len >= out_left)  // no soft-fail for "cannot write needed terminator"
@@ -375,9 +780,10 @@ DEFINE_METHOD(int, log_service_imp::run, (void *instance, log_line *ll)) {
       }
 #endif
 
-      // write the record to the stream / log-file
-      log_bi->write_errstream(((my_state *)instance)->errstream, out_buff,
-                              (size_t)out_size - out_left);
+      // write the record to the stream / log-file (or queue it for that)
+      if (!suppress)
+        log_json_write((my_state *)instance, out_buff,
+                       (size_t)out_size - out_left);
     }
   }
 
@@ -529,6 +935,9 @@ DEFINE_METHOD(log_service_error, log_service_imp::close, (void **instance)) {
 
   opened--;
 
+  // write what's queued for this (or any other) stream while it's open
+  log_json_drain();
+
   rr = log_bi->close_errstream(&mi->errstream);
 
   if (mi->ext != nullptr) log_bs->free(mi->ext);
@@ -558,6 +967,11 @@ DEFINE_METHOD(log_service_error, log_service_imp::flush, (void **instance)) {
   if ((mi = *((my_state **)instance)) == nullptr)
     return LOG_SERVICE_INVALID_ARGUMENT; /* purecov: inspected */
 
+  // FLUSH ERROR LOGS should find the queued records in the old file
+  std::lock_guard<std::mutex> guard(log_json_queue.writer_mutex);
+
+  if (log_json_queue.inited()) log_json_drain_locked();
+
   log_bi->close_errstream(&mi->errstream);
 
   return log_bi->open_errstream(mi->ext, &mi->errstream);
@@ -591,11 +1005,110 @@ mysql_service_status_t log_service_exit() {
   if (inited) {
     inited = false;
 
+    mysql_service_status_variable_registration->unregister_variable(
+        (SHOW_VAR *)&show_var_json);
+    mysql_service_component_sys_variable_unregister->unregister_variable(
+        MY_NAME, OPT_RATE_LIMIT);
+    mysql_service_component_sys_variable_unregister->unregister_variable(
+        MY_NAME, OPT_QUEUE_SIZE);
+    mysql_service_component_sys_variable_unregister->unregister_variable(
+        MY_NAME, OPT_ASYNC);
+
+    log_json_async = false;
+    log_json_writer_stop_and_drain();
+    log_json_queue.deinit();
+
     return false;
   }
   return true;
 }
 
+/**
+  Update function for system variable log_sink_json.async:
+  start the writer thread, or stop it and write what it left queued.
+
+  @param thd      session
+  @param self     the system variable
+  @param var_ptr  where the system variable's value lives
+  @param save     the new value
+*/
+static void sysvar_update_async(MYSQL_THD thd MY_ATTRIBUTE((unused)),
+                                SYS_VAR *self MY_ATTRIBUTE((unused)),
+                                void *var_ptr, const void *save) {
+  const bool async = *static_cast<const bool *>(save);
+
+  if (async) {
+    log_json_writer_start();
+    *static_cast<bool *>(var_ptr) = async;
+  } else {
+    *static_cast<bool *>(var_ptr) = async;
+    log_json_writer_stop_and_drain();
+  }
+}
+
+/**
+  Register the component's system and status variables.
+
+  @retval false  success
+  @retval true   failure
+*/
+static bool log_json_register_variables() {
+  values_async.def_val = false;
+
+  values_queue_size.def_val = 4096;
+  values_queue_size.min_val = 64;
+  values_queue_size.max_val = 1024 * 1024;
+  values_queue_size.blk_sz = 0;
+
+  values_rate_interval.def_val = 0;
+  values_rate_interval.min_val = 0;
+  values_rate_interval.max_val = 3600;
+  values_rate_interval.blk_sz = 0;
+
+  if (mysql_service_component_sys_variable_register->register_variable(
+          MY_NAME, OPT_QUEUE_SIZE,
+          PLUGIN_VAR_INT | PLUGIN_VAR_UNSIGNED | PLUGIN_VAR_RQCMDARG |
+              PLUGIN_VAR_READONLY,
+          "Number of records log_sink_json.async can queue before it "
+          "starts dropping them.",
+          nullptr, nullptr, (void *)&values_queue_size,
+          (void *)&log_json_queue_size))
+    return true;
+
+  if (mysql_service_component_sys_variable_register->register_variable(
+          MY_NAME, OPT_RATE_LIMIT,
+          PLUGIN_VAR_INT | PLUGIN_VAR_UNSIGNED | PLUGIN_VAR_RQCMDARG,
+          "Suppress records repeating a message logged within this many "
+          "seconds. 0 disables rate-limiting.",
+          nullptr, nullptr, (void *)&values_rate_interval,
+          (void *)&log_json_rate_limit_interval))
+    goto fail_queue_size;
+
+  if (mysql_service_component_sys_variable_register->register_variable(
+          MY_NAME, OPT_ASYNC, PLUGIN_VAR_BOOL | PLUGIN_VAR_RQCMDARG,
+          "Write records to the JSON error log from a background thread.",
+          nullptr, sysvar_update_async, (void *)&values_async,
+          (void *)&log_json_async))
+    goto fail_rate_limit;
+
+  if (mysql_service_status_variable_registration->register_variable(
+          (SHOW_VAR *)&show_var_json))
+    goto fail_async;
+
+  return false;
+
+fail_async:
+  mysql_service_component_sys_variable_unregister->unregister_variable(
+      MY_NAME, OPT_ASYNC);
+fail_rate_limit:
+  mysql_service_component_sys_variable_unregister->unregister_variable(
+      MY_NAME, OPT_RATE_LIMIT);
+fail_queue_size:
+  mysql_service_component_sys_variable_unregister->unregister_variable(
+      MY_NAME, OPT_QUEUE_SIZE);
+  return true;
+}
+
 /**
   Initialization entry method for Component used when loading the Component.
 
@@ -615,6 +1128,21 @@ mysql_service_status_t log_service_init() {
   log_ps = mysql_service_log_sink_perfschema;
 #endif
 
+  if (log_json_register_variables()) {
+    inited = false;
+    return true;
+  }
+
+  // The queue size is read-only, so we can size the queue once.
+  if (log_json_queue.init(log_json_queue_size)) {
+    log_json_async = false;
+    log_bi->message(LOG_TYPE_ERROR, LOG_ITEM_LOG_PRIO,
+                    (longlong)WARNING_LEVEL, LOG_ITEM_LOG_MESSAGE,
+                    MY_NAME ": could not allocate queue; "
+                    "asynchronous mode is unavailable.");
+  } else if (log_json_async)  // set from the command-line or persisted
+    log_json_writer_start();
+
   return false;
 }
 
@@ -636,7 +1164,10 @@ PROVIDES_SERVICE(log_sink_json, log_service), END_COMPONENT_PROVIDES();
 /* component requires: log-builtins */
 BEGIN_COMPONENT_REQUIRES(log_sink_json)
 REQUIRES_SERVICE(log_builtins), REQUIRES_SERVICE(log_builtins_string),
-    REQUIRES_SERVICE(log_sink_perfschema), END_COMPONENT_REQUIRES();
+    REQUIRES_SERVICE(log_sink_perfschema),
+    REQUIRES_SERVICE(component_sys_variable_register),
+    REQUIRES_SERVICE(component_sys_variable_unregister),
+    REQUIRES_SERVICE(status_variable_registration), END_COMPONENT_REQUIRES();
 
 /* component description */
 BEGIN_COMPONENT_METADATA(log_sink_json)
@@ -352,4 +352,7 @@
 /* ARM crc32 support */
 #cmakedefine HAVE_ARMV8_CRC32_INTRINSIC @HAVE_ARMV8_CRC32_INTRINSIC@
 
+/* x86 carry-less multiplication, for crc32 */
+#cmakedefine HAVE_CLMUL_CRC32_INTRINSIC @HAVE_CLMUL_CRC32_INTRINSIC@
+
 #endif
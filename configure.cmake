@@ -743,3 +743,23 @@ IF(LINUX)
     ENDIF() # arm_acle.h
   ENDIF() # aarch64
 ENDIF() # linux
+
+# Check for carry-less multiplication intrinsics on x86, used to compute
+# the crc32 of zlib (binlog event checksums) by folding
+IF(CMAKE_SYSTEM_PROCESSOR MATCHES "x86_64|amd64|AMD64" AND NOT WIN32)
+  CHECK_CXX_SOURCE_COMPILES(
+  "
+  #include <cpuid.h>
+  #include <smmintrin.h>
+  #include <wmmintrin.h>
+  __attribute__((target(\"pclmul,sse4.1\")))
+  int fold(__m128i x) {
+    return _mm_extract_epi32(_mm_clmulepi64_si128(x, x, 0x00), 1);
+  }
+  int main() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return 0;
+    return (ecx & bit_PCLMUL) ? fold(_mm_setzero_si128()) : 0;
+  }"
+  HAVE_CLMUL_CRC32_INTRINSIC)
+ENDIF()
@@ -32,6 +32,7 @@
 
 #include <string.h>
 
+#include <atomic>
 #include <memory>
 #include <new>
 #include <type_traits>
@@ -79,6 +80,7 @@ struct MEM_ROOT {
  private:
   struct Block {
     Block *prev{nullptr}; /** Previous block; used for freeing. */
+    size_t length{0};     /** Usable bytes, not including this header. */
   };
 
  public:
@@ -102,7 +104,8 @@ struct MEM_ROOT {
         m_allocated_size(other.m_allocated_size),
         m_error_for_capacity_exceeded(other.m_error_for_capacity_exceeded),
         m_error_handler(other.m_error_handler),
-        m_psi_key(other.m_psi_key) {
+        m_psi_key(other.m_psi_key),
+        m_use_block_cache(other.m_use_block_cache) {
     other.m_current_block = nullptr;
     other.m_allocated_size = 0;
     other.m_block_size = m_orig_block_size;
@@ -209,6 +212,9 @@ struct MEM_ROOT {
    * made immediately available for calls to Alloc() without having to go to the
    * OS for new memory. This can yield performance gains if you use the same
    * MEM_ROOT many times. Also, the block size is not reset.
+   *
+   * The block kept is the largest one; usually that is the last one, but
+   * allocations larger than the block size get blocks of their own.
    */
   void ClearForReuse();
 
@@ -280,6 +286,21 @@ struct MEM_ROOT {
     m_block_size = m_orig_block_size = block_size;
   }
 
+  /**
+   * Take blocks from, and give freed blocks back to, the process-wide block
+   * cache (see mem_root_block_cache_size). Blocks are then rounded up to
+   * powers of two, so that MEM_ROOTs with a similar allocation pattern, such
+   * as the ones of consecutive statements, can reuse each other's blocks
+   * without going through malloc and free.
+   *
+   * Cached blocks keep the PSI key they were allocated with, so only enable
+   * this for MEM_ROOTs of the same key. Blocks are not rounded up beyond the
+   * maximum capacity, and the cache is not used under Valgrind/ASan.
+   */
+  void set_use_block_cache(bool use_block_cache) {
+    m_use_block_cache = use_block_cache;
+  }
+
   /**
    * @name Raw interface
    * Peek(), ForceNewBlock() and RawCommit() together define an
@@ -352,8 +373,23 @@ struct MEM_ROOT {
   /** Allocate memory that doesn't fit into the current free block. */
   void *AllocSlow(size_t length);
 
-  /** Free all blocks in a linked list, starting at the given block. */
-  static void FreeBlocks(Block *start);
+  /**
+    Free all blocks in a linked list, starting at the given block, or give
+    them to the block cache if use_block_cache.
+  */
+  static void FreeBlocks(Block *start, bool use_block_cache);
+
+  /** Take a block of 2^shift bytes, header included, from the block cache. */
+  static Block *TakeCachedBlock(unsigned shift);
+
+  /** Give a block to the block cache. @retval false if it was not taken. */
+  static bool CacheBlock(Block *block);
+
+ public:
+  /** Free all blocks in the block cache. */
+  static void FreeCachedBlocks();
+
+ private:
 
   /** The current block we are giving out memory from. nullptr if none. */
   Block *m_current_block = nullptr;
@@ -389,8 +425,24 @@ struct MEM_ROOT {
   void (*m_error_handler)(void) = nullptr;
 
   PSI_memory_key m_psi_key = 0;
+
+  /** Whether to use the block cache, see set_use_block_cache(). */
+  bool m_use_block_cache = false;
 };
 
+/**
+  Upper bound, in bytes, of the memory held by the process-wide cache of
+  freed MEM_ROOT blocks. 0 disables the cache.
+*/
+extern ulong mem_root_block_cache_size;
+
+/** Blocks taken from the MEM_ROOT block cache instead of malloc. */
+extern std::atomic<ulonglong> mem_root_block_cache_hits;
+/** Blocks allocated by cache-enabled MEM_ROOTs that were not in the cache. */
+extern std::atomic<ulonglong> mem_root_block_cache_misses;
+/** Bytes currently held by the MEM_ROOT block cache. */
+extern std::atomic<size_t> mem_root_block_cache_bytes;
+
 // Legacy C thunks. Do not use in new code.
 static inline void init_alloc_root(PSI_memory_key key, MEM_ROOT *root,
                                    size_t block_size, size_t) {
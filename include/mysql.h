@@ -481,6 +481,12 @@ enum net_async_status STDCALL mysql_next_result_nonblocking(MYSQL *mysql);
 enum net_async_status STDCALL mysql_select_db_nonblocking(MYSQL *mysql,
                                                           const char *db,
                                                           bool *error);
+int STDCALL mysql_pipeline_send_query(MYSQL *mysql, const char *query,
+                                      unsigned long length);
+bool STDCALL mysql_pipeline_read_result(MYSQL *mysql);
+enum net_async_status STDCALL
+mysql_pipeline_read_result_nonblocking(MYSQL *mysql);
+unsigned int STDCALL mysql_pipeline_pending(MYSQL *mysql);
 void STDCALL mysql_get_character_set_info(MYSQL *mysql,
                                           MY_CHARSET_INFO *charset);
 
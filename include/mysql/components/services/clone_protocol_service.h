@@ -62,6 +62,11 @@ struct mysql_clone_ssl_context {
   /** Enable network compression. */
   bool m_enable_compression;
   NET_SERVER *m_server_extn;
+
+  /** Network compression algorithm: "zlib" or "zstd". nullptr for zlib. */
+  const char *m_compression_algorithm;
+  /** Compression level for zstd algorithm. */
+  unsigned int m_zstd_compression_level;
 };
 
 /** Vector of sting Values */
@@ -232,6 +237,14 @@ DECLARE_METHOD(int, mysql_clone_send_response,
 DECLARE_METHOD(int, mysql_clone_send_error,
                (THD * thd, unsigned char err_cmd, bool is_fatal));
 
+/**
+  Get current load on server
+  @param[in,out] thd              server session THD
+  @param[out]    threads_running  number of threads executing statements
+*/
+DECLARE_METHOD(void, mysql_clone_get_server_load,
+               (THD * thd, uint32_t *threads_running));
+
 END_SERVICE_DEFINITION(clone_protocol)
 
 #endif /* MYSQL_CLONE_PROTOCOL_SERVICE */
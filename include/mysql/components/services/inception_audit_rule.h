@@ -0,0 +1,137 @@
+/**
+ * @file include/mysql/components/services/inception_audit_rule.h
+ * @brief Services through which a component adds inception audit rules.
+ *
+ * A component acquires "inception_audit_rule.mysql_server" in its init
+ * and registers one callback per enum_sql_command it audits; the engine
+ * calls, for each statement, only the rules of its command, after the
+ * built-in ones. The component unregisters its rules in its deinit, which
+ * waits for calls in progress.
+ *
+ * The callback receives an inception_rule_statement: a read-only view of
+ * the statement, valid only during the call, that
+ * "inception_rule_statement.mysql_server" reads. Metadata lookups are
+ * answered like those of the built-in rules: from the metadata cache of
+ * the session's target, or from its shadow catalog with --schema-file.
+ *
+ * @code
+ *   static void lower_case_table(inception_rule_statement stmt, void *) {
+ *     const char *db, *table;
+ *     if (!rule_statement->get_table(stmt, 0, &db, &table) &&
+ *         has_upper_case(table))
+ *       rule_statement->report(stmt, INCEPTION_RULE_ERROR,
+ *                              "Table name must be lower case.");
+ *   }
+ *   audit_rule->register_rule("lower_case_table", SQLCOM_CREATE_TABLE,
+ *                             lower_case_table, nullptr);
+ * @endcode
+ */
+
+#ifndef INCEPTION_AUDIT_RULE_H
+#define INCEPTION_AUDIT_RULE_H
+
+#include <mysql/components/service.h>
+#include <stddef.h>
+
+/** The statement a rule is called for; see inception_rule_statement. */
+DEFINE_SERVICE_HANDLE(inception_rule_statement);
+
+/** An audit rule: inspects stmt and reports what it finds. */
+typedef void (*inception_rule_fn)(inception_rule_statement stmt, void *arg);
+
+/** Levels of inception_rule_statement::report(). */
+enum inception_rule_level {
+  INCEPTION_RULE_WARNING = 1, /* does not block EXECUTE */
+  INCEPTION_RULE_ERROR = 2    /* blocks EXECUTE of the batch */
+};
+
+BEGIN_SERVICE_DEFINITION(inception_audit_rule)
+/**
+  Register fn for the statements of sql_command (an enum_sql_command).
+  A rule audits several commands by registering once for each.
+
+  @param name        rule name; with sql_command, unique
+  @param sql_command the enum_sql_command value the rule audits
+  @param fn          the rule, called on the session's thread
+  @param arg         passed to fn as is
+  @retval false success
+  @retval true  invalid command or (name, sql_command) already registered
+*/
+DECLARE_BOOL_METHOD(register_rule, (const char *name, int sql_command,
+                                    inception_rule_fn fn, void *arg));
+
+/**
+  Remove every registration of name, after the calls in progress return.
+  Not to be called from a rule.
+
+  @retval false success
+  @retval true  no rule of that name
+*/
+DECLARE_BOOL_METHOD(unregister_rule, (const char *name));
+END_SERVICE_DEFINITION(inception_audit_rule)
+
+BEGIN_SERVICE_DEFINITION(inception_rule_statement)
+/** The enum_sql_command of the statement. */
+DECLARE_BOOL_METHOD(get_command,
+                    (inception_rule_statement stmt, int *sql_command));
+
+/** The statement text, without the inception comment. */
+DECLARE_BOOL_METHOD(get_sql, (inception_rule_statement stmt, const char **sql,
+                              size_t *length));
+
+/**
+  The index-th table the statement references, in the parser's order;
+  db is the default database when the statement names none.
+
+  @retval true past the last table
+*/
+DECLARE_BOOL_METHOD(get_table, (inception_rule_statement stmt,
+                                unsigned int index, const char **db,
+                                const char **table));
+
+/**
+  The parsed statement, a const LEX *, for rules built against the
+  server tree. Read it only; it is not a stable interface.
+*/
+DECLARE_BOOL_METHOD(get_lex, (inception_rule_statement stmt, const void **lex));
+
+/**
+  Whether db.table exists on the target (or in the shadow catalog), or
+  was created by an earlier statement of the batch.
+
+  @retval true the metadata could not be read
+*/
+DECLARE_BOOL_METHOD(table_exists, (inception_rule_statement stmt,
+                                   const char *db, const char *table,
+                                   bool *exists));
+
+/**
+  The row estimate of db.table, -1 if unknown.
+
+  @retval true the table does not exist or its metadata could not be read
+*/
+DECLARE_BOOL_METHOD(get_table_rows, (inception_rule_statement stmt,
+                                     const char *db, const char *table,
+                                     long long *rows));
+
+/**
+  The lower-case data type of column in db.table, e.g. "varchar".
+
+  @retval true no such column, or the metadata could not be read
+*/
+DECLARE_BOOL_METHOD(get_column_type, (inception_rule_statement stmt,
+                                      const char *db, const char *table,
+                                      const char *column,
+                                      const char **data_type));
+
+/**
+  Add message to the statement's err_message at level (see
+  inception_rule_level).
+
+  @retval true invalid level
+*/
+DECLARE_BOOL_METHOD(report, (inception_rule_statement stmt, int level,
+                             const char *message));
+END_SERVICE_DEFINITION(inception_rule_statement)
+
+#endif /* INCEPTION_AUDIT_RULE_H */
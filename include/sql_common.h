@@ -107,6 +107,8 @@ struct MYSQL_EXTENSION {
     char **names;
     MYSQL_BIND *bind;
   } bind_info;
+  /* Number of pipelined queries whose result was not read yet */
+  uint pipeline_pending;
 };
 
 /* "Constructor/destructor" for MYSQL extension structure. */
@@ -123,6 +125,11 @@ void mysql_extension_bind_free(MYSQL_EXTENSION *ext);
                            ? (H)->extension \
                            : ((H)->extension = mysql_extension_init(H))))
 
+/* True if pipelined queries are waiting for their results to be read */
+#define PIPELINE_PENDING(M) \
+  ((M)->extension != NULL &&  \
+   ((MYSQL_EXTENSION *)(M)->extension)->pipeline_pending > 0)
+
 #define ASYNC_DATA(M) \
   (NULL != (M) ? (MYSQL_EXTENSION_PTR(M)->mysql_async_context) : NULL)
 #ifdef MYSQL_SERVER
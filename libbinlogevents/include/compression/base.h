@@ -155,6 +155,15 @@ class Compressor : public Base_compressor_decompressor {
   */
   virtual void set_compression_level(unsigned int compression_level) = 0;
 
+  /**
+    Sets the number of threads that compress parts of the data in
+    parallel with the thread calling compress(), 0 for none. Like the
+    compression level, it is only effective from the next open() on.
+
+    @param workers the number of threads.
+  */
+  virtual void set_workers(unsigned int workers) = 0;
+
   /**
     This member function SHALL compress the data provided with the given
     length. Note that the buffer to store the compressed data must have
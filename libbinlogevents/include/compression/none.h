@@ -42,6 +42,11 @@ class None_comp : public Compressor {
    */
   void set_compression_level(unsigned int compression_level) override;
 
+  /**
+    No op member function.
+   */
+  void set_workers(unsigned int workers) override;
+
   /**
     Shall get the compressor type code.
 
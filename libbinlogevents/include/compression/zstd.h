@@ -47,6 +47,11 @@ class Zstd_comp : public Compressor {
    */
   const static unsigned int DEFAULT_COMPRESSION_LEVEL = 3;
 
+  /**
+    The size of the parts compressed in parallel when there are workers.
+   */
+  const static std::size_t PARALLEL_JOB_SIZE = 1024 * 1024;
+
  protected:
   /**
     The ZSTD compression stream context.
@@ -70,6 +75,11 @@ class Zstd_comp : public Compressor {
    */
   unsigned int m_compression_level_next{DEFAULT_COMPRESSION_LEVEL};
 
+  /**
+    The number of worker threads to use from the next open() on.
+   */
+  unsigned int m_workers{0};
+
  public:
   Zstd_comp();
   ~Zstd_comp() override;
@@ -78,6 +88,13 @@ class Zstd_comp : public Compressor {
    */
   void set_compression_level(unsigned int compression_level) override;
 
+  /**
+    Shall set the number of worker threads of the stream. They are only
+    used if the library was built with ZSTD_MULTITHREAD; otherwise the
+    calling thread compresses everything.
+   */
+  void set_workers(unsigned int workers) override;
+
   /**
     Shall get the compressor type code.
 
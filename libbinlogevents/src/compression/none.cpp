@@ -35,6 +35,8 @@ namespace compression {
 
 void None_comp::set_compression_level(unsigned int) {} /* purecov: inspected */
 
+void None_comp::set_workers(unsigned int) {} /* purecov: inspected */
+
 type None_comp::compression_type_code() {
   return NONE; /* purecov: inspected */
 }
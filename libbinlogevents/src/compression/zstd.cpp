@@ -60,6 +60,8 @@ void Zstd_comp::set_compression_level(unsigned int clevel) {
   }
 }
 
+void Zstd_comp::set_workers(unsigned int workers) { m_workers = workers; }
+
 Zstd_comp::~Zstd_comp() {
   if (m_ctx != nullptr) {
     ZSTD_freeCStream(m_ctx);
@@ -95,6 +97,17 @@ bool Zstd_comp::open() {
     if (ZSTD_isError(ret)) goto err;
     m_compression_level_current = m_compression_level_next;
   }
+
+  /*
+    The workers still produce a single frame, so the payload reads back
+    as before. A library without ZSTD_MULTITHREAD refuses any, and the
+    stream then compresses in this thread.
+  */
+  if (m_workers > 0 && !ZSTD_isError(ZSTD_CCtx_setParameter(
+                           m_ctx, ZSTD_c_nbWorkers, m_workers)))
+    ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_jobSize, PARALLEL_JOB_SIZE);
+  else
+    ZSTD_CCtx_setParameter(m_ctx, ZSTD_c_nbWorkers, 0);
 #else
   ret = ZSTD_initCStream(m_ctx, m_compression_level_next);
   if (ZSTD_isError(ret)) goto err;
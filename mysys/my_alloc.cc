@@ -35,6 +35,8 @@
 #include <string.h>
 #include <sys/types.h>
 
+#include <mutex>
+
 #include "my_alloc.h"
 #include "my_compiler.h"
 #include "my_dbug.h"
@@ -53,6 +55,99 @@
 #define MEM_ROOT_SINGLE_CHUNKS 0
 #endif
 
+ulong mem_root_block_cache_size = 8 * 1024 * 1024;
+std::atomic<ulonglong> mem_root_block_cache_hits{0};
+std::atomic<ulonglong> mem_root_block_cache_misses{0};
+std::atomic<size_t> mem_root_block_cache_bytes{0};
+
+namespace {
+
+// The block cache has one free list per power of two from 4 kB to 1 MB;
+// smaller blocks are cheap to malloc, larger ones are rare.
+constexpr unsigned kMinCachedBlockShift = 12;
+constexpr unsigned kMaxCachedBlockShift = 20;
+
+struct Block_cache_list {
+  std::mutex mutex;
+  void *head = nullptr;
+};
+
+Block_cache_list
+    block_cache[kMaxCachedBlockShift - kMinCachedBlockShift + 1];
+
+/**
+  The size class for a block of the given total size: the smallest shift
+  with (1 << shift) >= total_size, or 0 if the block is not cacheable
+  because it is smaller than 4 kB or larger than 1 MB.
+*/
+unsigned block_cache_shift(size_t total_size) {
+  if (total_size < (size_t{1} << kMinCachedBlockShift) ||
+      total_size > (size_t{1} << kMaxCachedBlockShift))
+    return 0;
+  unsigned shift = kMinCachedBlockShift;
+  while ((size_t{1} << shift) < total_size) ++shift;
+  return shift;
+}
+
+}  // namespace
+
+MEM_ROOT::Block *MEM_ROOT::TakeCachedBlock(unsigned shift) {
+  Block_cache_list &list = block_cache[shift - kMinCachedBlockShift];
+  Block *block;
+  {
+    std::lock_guard<std::mutex> guard(list.mutex);
+    block = static_cast<Block *>(list.head);
+    if (block != nullptr) list.head = block->prev;
+  }
+  if (block == nullptr) {
+    ++mem_root_block_cache_misses;
+    return nullptr;
+  }
+  mem_root_block_cache_bytes -= size_t{1} << shift;
+  ++mem_root_block_cache_hits;
+  my_claim(block, true);
+  return block;
+}
+
+bool MEM_ROOT::CacheBlock(Block *block) {
+  const size_t total_size = block->length + ALIGN_SIZE(sizeof(Block));
+  const unsigned shift = block_cache_shift(total_size);
+  // Only blocks allocated for the cache have an exact class size.
+  if (shift == 0 || (size_t{1} << shift) != total_size) return false;
+  // Reserve room for the block, so that concurrent frees cannot together
+  // push the cache past its bound.
+  size_t cached = mem_root_block_cache_bytes.load();
+  do {
+    if (cached + total_size > mem_root_block_cache_size) return false;
+  } while (!mem_root_block_cache_bytes.compare_exchange_weak(
+      cached, cached + total_size));
+
+  my_claim(block, false);
+  Block_cache_list &list = block_cache[shift - kMinCachedBlockShift];
+  std::lock_guard<std::mutex> guard(list.mutex);
+  block->prev = static_cast<Block *>(list.head);
+  list.head = block;
+  return true;
+}
+
+void MEM_ROOT::FreeCachedBlocks() {
+  for (Block_cache_list &list : block_cache) {
+    Block *start;
+    {
+      std::lock_guard<std::mutex> guard(list.mutex);
+      start = static_cast<Block *>(list.head);
+      list.head = nullptr;
+    }
+    for (Block *block = start; block != nullptr;) {
+      Block *prev = block->prev;
+      mem_root_block_cache_bytes -=
+          block->length + ALIGN_SIZE(sizeof(Block));
+      my_free(block);
+      block = prev;
+    }
+  }
+}
+
 std::pair<MEM_ROOT::Block *, size_t> MEM_ROOT::AllocBlock(
     size_t wanted_length, size_t minimum_length) {
   DBUG_TRACE;
@@ -83,13 +178,32 @@ std::pair<MEM_ROOT::Block *, size_t> MEM_ROOT::AllocBlock(
     }
   }
 
-  Block *new_block = static_cast<Block *>(
-      my_malloc(m_psi_key, length + ALIGN_SIZE(sizeof(Block)),
-                MYF(MY_WME | ME_FATALERROR)));
+  size_t total_size = length + ALIGN_SIZE(sizeof(Block));
+  Block *new_block = nullptr;
+  if (m_use_block_cache && !MEM_ROOT_SINGLE_CHUNKS &&
+      mem_root_block_cache_size != 0) {
+    const unsigned shift = block_cache_shift(total_size);
+    const size_t class_length =
+        (size_t{1} << shift) - ALIGN_SIZE(sizeof(Block));
+    // Round up to the size class, unless that exceeds the capacity;
+    // the caller gets the extra space.
+    if (shift != 0 && (m_max_capacity == 0 ||
+                       m_allocated_size + class_length <= m_max_capacity)) {
+      total_size = size_t{1} << shift;
+      length = class_length;
+      new_block = TakeCachedBlock(shift);
+    }
+  }
+
   if (new_block == nullptr) {
-    if (m_error_handler) (m_error_handler)();
-    return {nullptr, 0};
+    new_block = static_cast<Block *>(
+        my_malloc(m_psi_key, total_size, MYF(MY_WME | ME_FATALERROR)));
+    if (new_block == nullptr) {
+      if (m_error_handler) (m_error_handler)();
+      return {nullptr, 0};
+    }
   }
+  new_block->length = length;
 
   m_allocated_size += length;
 
@@ -170,6 +284,7 @@ void MEM_ROOT::Clear() {
   if (m_current_block == nullptr) return;
 
   Block *start = m_current_block;
+  const bool use_block_cache = m_use_block_cache;
 
   m_current_block = nullptr;
   m_block_size = m_orig_block_size;
@@ -177,7 +292,7 @@ void MEM_ROOT::Clear() {
   m_current_free_end = &s_dummy_target;
   m_allocated_size = 0;
 
-  FreeBlocks(start);
+  FreeBlocks(start, use_block_cache);
 }
 
 void MEM_ROOT::ClearForReuse() {
@@ -191,22 +306,34 @@ void MEM_ROOT::ClearForReuse() {
   // Already cleared, or memset() to zero, so just ignore.
   if (m_current_block == nullptr) return;
 
-  // Keep the last block, which is usually the biggest one.
-  m_current_free_start = pointer_cast<char *>(m_current_block) +
-                         ALIGN_SIZE(sizeof(*m_current_block));
-  Block *start = m_current_block->prev;
-  m_current_block->prev = nullptr;
-  m_allocated_size = m_current_free_end - m_current_free_start;
+  // Keep the biggest block. That is usually the last one, but blocks for
+  // allocations larger than the block size are inserted behind it.
+  Block **keep_link = &m_current_block;
+  for (Block **link = &m_current_block->prev; *link != nullptr;
+       link = &(*link)->prev) {
+    if ((*link)->length > (*keep_link)->length) keep_link = link;
+  }
+  Block *keep = *keep_link;
+  *keep_link = keep->prev;
+  Block *start = m_current_block;
+  const bool use_block_cache = m_use_block_cache;
+
+  keep->prev = nullptr;
+  m_current_block = keep;
+  m_current_free_start =
+      pointer_cast<char *>(keep) + ALIGN_SIZE(sizeof(*keep));
+  m_current_free_end = m_current_free_start + keep->length;
+  m_allocated_size = keep->length;
 
-  FreeBlocks(start);
+  FreeBlocks(start, use_block_cache);
 }
 
-void MEM_ROOT::FreeBlocks(Block *start) {
+void MEM_ROOT::FreeBlocks(Block *start, bool use_block_cache) {
   // The MEM_ROOT might be allocated on itself, so make sure we don't
   // touch it after we've started freeing.
   for (Block *block = start; block != nullptr;) {
     Block *prev = block->prev;
-    my_free(block);
+    if (!use_block_cache || !CacheBlock(block)) my_free(block);
     block = prev;
   }
 }
@@ -45,6 +45,7 @@
 
 #include "m_ctype.h"
 #include "m_string.h"
+#include "my_alloc.h"
 #include "my_compiler.h"
 #include "my_dbug.h"
 #include "my_inttypes.h"
@@ -199,6 +200,7 @@ void my_end(int infoflag) {
   my_error_unregister_all();
   charset_uninit();
   my_once_free();
+  MEM_ROOT::FreeCachedBlocks();
 
   if ((infoflag & MY_GIVE_INFO) || (info_file != stderr)) {
 #ifdef HAVE_GETRUSAGE
@@ -87,6 +87,25 @@ extern uint clone_max_io_bandwidth;
 /** Clone system variable: If network compression is enabled */
 extern bool clone_enable_compression;
 
+/** Network compression algorithm */
+enum Clone_Compression_Algorithm { CLONE_COMPRESS_ZLIB, CLONE_COMPRESS_ZSTD };
+
+/** Clone system variable: Network compression algorithm */
+extern ulong clone_compression_algorithm;
+
+/** Clone system variable: zstd compression level */
+extern uint clone_zstd_compression_level;
+
+/** Clone system variable: Maximum concurrent streams served by donor */
+extern uint clone_donor_max_streams;
+
+/** Clone system variable: Donor Threads_running to start throttling */
+extern uint clone_donor_throttle_threads_running;
+
+/** Clone system variable: Donor disk read latency in microseconds to start
+throttling */
+extern uint clone_donor_throttle_disk_latency;
+
 /** Clone system variable: SSL private key */
 extern char *clone_client_ssl_private_key;
 
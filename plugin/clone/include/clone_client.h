@@ -302,6 +302,7 @@ struct Client_Share {
         m_data_dir(dir),
         m_ssl_mode(mode),
         m_max_concurrency(clone_max_concurrency),
+        m_donor_max_streams(0),
         m_protocol_version(CLONE_PROTOCOL_VERSION) {
     m_storage_vec.reserve(MAX_CLONE_STORAGE_ENGINE);
     m_threads.resize(m_max_concurrency);
@@ -330,6 +331,10 @@ struct Client_Share {
   /** Maximum number of concurrent threads for current operation. */
   const uint32_t m_max_concurrency;
 
+  /** Maximum number of concurrent streams allowed by donor. Zero if donor
+  has no limit. */
+  uint32_t m_donor_max_streams;
+
   /** Negotiated protocol version */
   uint32_t m_protocol_version;
 
@@ -407,6 +412,10 @@ class Client {
   /** @return maximum concurrency for current clone operation. */
   uint32_t get_max_concurrency() const {
     assert(m_share->m_max_concurrency > 0);
+    auto donor_limit = m_share->m_donor_max_streams;
+    if (donor_limit > 0 && donor_limit < m_share->m_max_concurrency) {
+      return (donor_limit);
+    }
     return (m_share->m_max_concurrency);
   }
 
@@ -33,6 +33,8 @@ Clone Plugin: Server interface
 #include "plugin/clone/include/clone_hton.h"
 #include "plugin/clone/include/clone_os.h"
 
+#include <chrono>
+
 /* Namespace for all clone data types */
 namespace myclone {
 /** For Remote Clone, "Clone Server" is created at donor. It retrieves data
@@ -93,6 +95,12 @@ class Server {
   @return error code */
   int clone();
 
+  /** Slow down data transfer while donor is loaded. Load is checked at
+  intervals and the sleep time adapts to it.
+  @param[in]	read_time_us	time taken by clone to read the data from
+                                disk in microseconds, zero if not read */
+  void throttle(uint64_t read_time_us);
+
   /** Send descriptor data to remote client
   @param[in,out]	hton		SE handlerton
   @param[in]	secure		validate secure connection
@@ -234,6 +242,15 @@ class Server {
 
   /** DDL timeout from client */
   uint32_t m_client_ddl_timeout;
+
+  /** Last time the load was checked for throttling */
+  std::chrono::steady_clock::time_point m_throttle_check;
+
+  /** Current throttle sleep time in milliseconds */
+  uint64_t m_throttle_ms;
+
+  /** Moving average of disk read latency in microseconds */
+  uint64_t m_read_latency_us;
 };
 
 /** Clone server interface to handle callback from Storage Engine */
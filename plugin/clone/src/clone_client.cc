@@ -674,6 +674,11 @@ uint32_t Client::limit_buffer(uint32_t buffer_size) {
 }
 
 uint32_t Client::limit_workers(uint32_t num_workers) {
+  /* Adjust to the number of streams allowed by donor. */
+  if (num_workers + 1 > get_max_concurrency()) {
+    num_workers = get_max_concurrency() - 1;
+  }
+
   /* Adjust if network bandwidth is limited. Currently 64 M
   minimum per task is ensured before spawning task. */
   if (clone_max_network_bandwidth > 0) {
@@ -889,6 +894,9 @@ int Client::connect_remote(bool is_restart, bool use_aux) {
   ssl_context.m_enable_compression = clone_enable_compression;
   ssl_context.m_server_extn =
       ssl_context.m_enable_compression ? &m_conn_server_extn : nullptr;
+  ssl_context.m_compression_algorithm =
+      (clone_compression_algorithm == CLONE_COMPRESS_ZSTD) ? "zstd" : nullptr;
+  ssl_context.m_zstd_compression_level = clone_zstd_compression_level;
   ssl_context.m_ssl_mode = m_share->m_ssl_mode;
 
   /* Get Clone SSL configuration parameter value safely. */
@@ -1173,6 +1181,16 @@ void Client::use_other_configs() {
       } catch (const std::exception &e) {
         assert(false);
       }
+      continue;
+    }
+    res = config_name.compare("clone_donor_max_streams");
+    if (res == 0) {
+      try {
+        m_share->m_donor_max_streams =
+            static_cast<uint32_t>(std::stoul(key_val.second));
+      } catch (const std::exception &e) {
+        assert(false);
+      }
     }
   }
 }
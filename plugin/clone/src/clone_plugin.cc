@@ -29,6 +29,9 @@ Clone Plugin: Plugin interface
 #include <mysql/plugin.h>
 #include <mysql/plugin_clone.h>
 
+#include "my_sys.h"
+#include "mysqld_error.h"
+
 #include "plugin/clone/include/clone_client.h"
 #include "plugin/clone/include/clone_local.h"
 #include "plugin/clone/include/clone_server.h"
@@ -64,6 +67,24 @@ uint clone_max_io_bandwidth;
 /** Clone system variable: If network compression is enabled */
 bool clone_enable_compression;
 
+/** Clone system variable: Network compression algorithm */
+ulong clone_compression_algorithm;
+
+/** Clone system variable: zstd compression level */
+uint clone_zstd_compression_level;
+
+/** Clone system variable: Maximum concurrent streams served by donor */
+uint clone_donor_max_streams;
+
+/** Clone system variable: Donor Threads_running to start throttling */
+uint clone_donor_throttle_threads_running;
+
+/** Clone system variable: Donor disk read latency to start throttling */
+uint clone_donor_throttle_disk_latency;
+
+/** Clone system variable: If existing cloned directory is refreshed */
+static bool clone_incremental;
+
 /** Clone system variable: valid list of donor addresses. */
 static char *clone_valid_donor_list;
 
@@ -430,6 +451,12 @@ static int plugin_clone_deinit(
 @param[in]	data_dir	cloned data directory
 @return error code */
 static int plugin_clone_local(THD *thd, const char *data_dir) {
+  /* Incremental clone is supported only from remote donor. */
+  if (my_access(data_dir, F_OK) == 0) {
+    my_error(ER_DB_CREATE_EXISTS, MYF(0), data_dir);
+    return (ER_DB_CREATE_EXISTS);
+  }
+
   myclone::Client_Share client_share(nullptr, 0, nullptr, nullptr, data_dir, 0);
 
   myclone::Server server(thd, MYSQL_INVALID_SOCKET);
@@ -465,6 +492,13 @@ static int plugin_clone_remote_client(THD *thd, const char *remote_host,
     return (error);
   }
 
+  /* Existing directory from earlier clone is refreshed only if configured. */
+  if (data_dir != nullptr && !clone_incremental &&
+      my_access(data_dir, F_OK) == 0) {
+    my_error(ER_DB_CREATE_EXISTS, MYF(0), data_dir);
+    return (ER_DB_CREATE_EXISTS);
+  }
+
   myclone::Client_Share client_share(remote_host, remote_port, remote_user,
                                      remote_passwd, data_dir, ssl_mode);
 
@@ -557,6 +591,74 @@ static MYSQL_SYSVAR_BOOL(enable_compression, clone_enable_compression,
                          "If compression is done at network", nullptr, nullptr,
                          false); /* Disable compression by default */
 
+/** Network compression algorithm names. */
+static const char *clone_compression_names[] = {"zlib", "zstd", NullS};
+
+static TYPELIB clone_compression_typelib = {
+    array_elements(clone_compression_names) - 1, "clone_compression_typelib",
+    clone_compression_names, nullptr};
+
+/** Algorithm used when data is compressed in network layer. Each clone task
+compresses data on its own connection. */
+static MYSQL_SYSVAR_ENUM(compression_algorithm, clone_compression_algorithm,
+                         PLUGIN_VAR_RQCMDARG,
+                         "Network compression algorithm used when"
+                         " clone_enable_compression is ON: zlib or zstd",
+                         nullptr, nullptr, CLONE_COMPRESS_ZLIB,
+                         &clone_compression_typelib);
+
+/** Compression level when zstd is used for network compression. */
+static MYSQL_SYSVAR_UINT(zstd_compression_level, clone_zstd_compression_level,
+                         PLUGIN_VAR_RQCMDARG,
+                         "Compression level for zstd network compression",
+                         nullptr, nullptr, 3, /* Default =  3 */
+                         1,                   /* Minimum =  1 */
+                         22,                  /* Maximum = 22 */
+                         1);                  /* Step    =  1 */
+
+/** Maximum number of concurrent streams a recipient may open to this donor
+for one clone operation. Sent to recipient which limits its tasks. */
+static MYSQL_SYSVAR_UINT(donor_max_streams, clone_donor_max_streams,
+                         PLUGIN_VAR_RQCMDARG,
+                         "Maximum concurrent data streams served by donor"
+                         " for a clone operation. 0 means no limit",
+                         nullptr, nullptr, 0, /* Default =   0 no limit */
+                         0,                   /* Minimum =   0 */
+                         128,                 /* Maximum = 128 */
+                         1);                  /* Step    =   1 */
+
+/** Donor slows down data transfer while the number of running threads is
+above the limit. */
+static MYSQL_SYSVAR_UINT(donor_throttle_threads_running,
+                         clone_donor_throttle_threads_running,
+                         PLUGIN_VAR_RQCMDARG,
+                         "Threads_running in donor above which clone data"
+                         " transfer is throttled. 0 disables",
+                         nullptr, nullptr, 0, /* Default =   0 disabled */
+                         0,                   /* Minimum =   0 */
+                         100000,              /* Maximum = 100000 */
+                         1);                  /* Step    =   1 */
+
+/** Donor slows down data transfer while average disk read latency is above
+the limit. */
+static MYSQL_SYSVAR_UINT(donor_throttle_disk_latency,
+                         clone_donor_throttle_disk_latency,
+                         PLUGIN_VAR_RQCMDARG,
+                         "Average disk read latency in microseconds in donor"
+                         " above which clone data transfer is throttled."
+                         " 0 disables",
+                         nullptr, nullptr, 0, /* Default =   0 disabled */
+                         0,                   /* Minimum =   0 */
+                         10000000,            /* Maximum =  10 sec */
+                         1);                  /* Step    =   1 us */
+
+/** If data directory from earlier clone is refreshed by copying only the
+pages modified since then. Needs page tracking enabled in donor. */
+static MYSQL_SYSVAR_BOOL(incremental, clone_incremental, PLUGIN_VAR_NOCMDARG,
+                         "If existing cloned data directory is updated"
+                         " incrementally",
+                         nullptr, nullptr, false); /* Disabled by default */
+
 /** List of valid donor addresses allowed to clone from. */
 static MYSQL_SYSVAR_STR(valid_donor_list, clone_valid_donor_list,
                         PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_MEMALLOC,
@@ -604,6 +706,12 @@ static SYS_VAR *clone_system_variables[] = {
     MYSQL_SYSVAR(max_network_bandwidth),
     MYSQL_SYSVAR(max_data_bandwidth),
     MYSQL_SYSVAR(enable_compression),
+    MYSQL_SYSVAR(compression_algorithm),
+    MYSQL_SYSVAR(zstd_compression_level),
+    MYSQL_SYSVAR(donor_max_streams),
+    MYSQL_SYSVAR(donor_throttle_threads_running),
+    MYSQL_SYSVAR(donor_throttle_disk_latency),
+    MYSQL_SYSVAR(incremental),
     MYSQL_SYSVAR(autotune_concurrency),
     MYSQL_SYSVAR(valid_donor_list),
     MYSQL_SYSVAR(ssl_key),
@@ -31,6 +31,9 @@ Clone Plugin: Server implementation
 
 #include "my_byteorder.h"
 
+#include <algorithm>
+#include <thread>
+
 /* Namespace for all clone data types */
 namespace myclone {
 
@@ -45,7 +48,8 @@ Key_Values Server::s_configs = {{"version", ""},
 
 /** All other configuration required by recipient. */
 Key_Values Server::s_other_configs = {
-    {"clone_donor_timeout_after_network_failure", ""}};
+    {"clone_donor_timeout_after_network_failure", ""},
+    {"clone_donor_max_streams", ""}};
 
 Server::Server(THD *thd, MYSQL_SOCKET socket)
     : m_server_thd(thd),
@@ -54,7 +58,10 @@ Server::Server(THD *thd, MYSQL_SOCKET socket)
       m_pfs_initialized(false),
       m_acquired_backup_lock(false),
       m_protocol_version(CLONE_PROTOCOL_VERSION),
-      m_client_ddl_timeout() {
+      m_client_ddl_timeout(),
+      m_throttle_check(),
+      m_throttle_ms(),
+      m_read_latency_us() {
   m_ext_link.set_socket(socket);
   m_storage_vec.reserve(MAX_CLONE_STORAGE_ENGINE);
 
@@ -615,6 +622,56 @@ int Server::send_descriptor(handlerton *hton, bool secure, uint loc_index,
   return (err);
 }
 
+void Server::throttle(uint64_t read_time_us) {
+  /* Give 1/8th weight to the latest sample. */
+  if (read_time_us > 0) {
+    m_read_latency_us = (m_read_latency_us * 7 + read_time_us) / 8;
+  }
+
+  auto max_threads = clone_donor_throttle_threads_running;
+  auto max_latency = clone_donor_throttle_disk_latency;
+
+  /* Zero implies no throttling. */
+  if (max_threads == 0 && max_latency == 0) {
+    m_throttle_ms = 0;
+    return;
+  }
+
+  /* Check only at specific intervals. */
+  auto cur_time = std::chrono::steady_clock::now();
+  if (cur_time - m_throttle_check < std::chrono::milliseconds(100)) {
+    return;
+  }
+  m_throttle_check = cur_time;
+
+  bool overloaded = false;
+
+  if (max_threads > 0) {
+    uint32_t threads_running = 0;
+    mysql_service_clone_protocol->mysql_clone_get_server_load(
+        get_thd(), &threads_running);
+    overloaded = (threads_running > max_threads);
+  }
+
+  if (max_latency > 0 && m_read_latency_us > max_latency) {
+    overloaded = true;
+  }
+
+  /* Back off exponentially while loaded and recover gradually after. Don't
+  sleep for more than 1 second so that we don't get into network timeout and
+  can respond to abort request. */
+  if (overloaded) {
+    m_throttle_ms = (m_throttle_ms == 0) ? 10 : m_throttle_ms * 2;
+    m_throttle_ms = std::min<uint64_t>(m_throttle_ms, 1000);
+  } else {
+    m_throttle_ms /= 2;
+  }
+
+  if (m_throttle_ms > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(m_throttle_ms));
+  }
+}
+
 int Server_Cbk::send_descriptor() {
   auto server = get_clone_server();
 
@@ -652,12 +709,20 @@ int Server_Cbk::file_cbk(Ha_clone_file from_file, uint len) {
 
   *buf_ptr = static_cast<uchar>(COM_RES_DATA);
 
+  auto read_start = std::chrono::steady_clock::now();
+
   auto err =
       clone_os_copy_file_to_buf(from_file, data_ptr, len, get_source_name());
   if (err != 0) {
     return (err);
   }
 
+  auto read_time = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - read_start);
+
+  /* Slow down if donor is loaded. */
+  server->throttle(std::max<uint64_t>(read_time.count(), 1));
+
   /* Step 1: Send Descriptor */
   err = send_descriptor();
 
@@ -680,6 +745,9 @@ int Server_Cbk::buffer_cbk(uchar *from_buffer, uint buf_len) {
     return (ER_QUERY_INTERRUPTED);
   }
 
+  /* Slow down if donor is loaded. */
+  server->throttle(0);
+
   uchar *buf_ptr = nullptr;
   uint total_len = 0;
 
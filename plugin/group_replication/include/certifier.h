@@ -25,6 +25,7 @@
 
 #include <assert.h>
 #include <mysql/group_replication_priv.h>
+#include <atomic>
 #include <list>
 #include <map>
 #include <string>
@@ -43,8 +44,9 @@
 /**
   This class extends Gtid_set to include a reference counter.
 
-  It is for Certifier only, so it is single-threaded and no locks
-  are needed since Certifier already ensures sequential use.
+  It is for Certifier only, which ensures sequential use, except
+  that the garbage collection of the certification info shards runs
+  in parallel, hence the atomic reference counter.
 
   It is to be used to share by multiple entries in the
   certification info and released when the last reference to it
@@ -81,7 +83,7 @@ class Gtid_set_ref : public Gtid_set {
   }
 
  private:
-  size_t reference_counter;
+  std::atomic<size_t> reference_counter;
   int64 parallel_applier_sequence_number;
 };
 
@@ -540,10 +542,22 @@ class Certifier : public Certifier_interface {
   */
   Gtid last_conflict_free_transaction;
 
+  /**
+    Number of shards of the certification database. An item is kept
+    on the shard given by the hash of its key.
+  */
+  static const size_t CERTIFICATION_INFO_SHARDS = 8;
+
+  /**
+    Certification database size from which the garbage collection
+    scans the shards on parallel threads.
+  */
+  static const size_t GARBAGE_COLLECT_PARALLEL_MIN_SIZE = 65536;
+
   /**
     Certification database.
   */
-  Certification_info certification_info;
+  Certification_info certification_info[CERTIFICATION_INFO_SHARDS];
   Sid_map *certification_info_sid_map;
 
   ulonglong positive_cert;
@@ -708,6 +722,39 @@ class Certifier : public Certifier_interface {
    */
   void garbage_collect();
 
+  /**
+    Removes from one shard of the certification database the items
+    whose snapshot version is contained in the stable set.
+    Called with stable_gtid_set_lock held, possibly on several
+    threads at a time, one per shard.
+
+    @param shard  the shard to collect
+   */
+  void garbage_collect_shard(size_t shard);
+
+  /** Arguments of a thread collecting one shard. */
+  struct Garbage_collect_shard_args {
+    Certifier *certifier;
+    size_t shard;
+  };
+
+  /**
+    Entry point of a thread started by garbage_collect().
+
+    @param arg  the Garbage_collect_shard_args of the thread
+   */
+  static void *launch_garbage_collect_shard(void *arg);
+
+  /**
+    Returns the certification database shard that keeps an item.
+
+    @param item  the write set item
+   */
+  Certification_info &get_certification_info_shard(const std::string &item) {
+    return certification_info[std::hash<std::string>()(item) %
+                              CERTIFICATION_INFO_SHARDS];
+  }
+
   /**
     Clear incoming queue.
   */
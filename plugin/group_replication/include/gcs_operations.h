@@ -310,6 +310,16 @@ class Gcs_operations {
   */
   enum enum_gcs_error set_xcom_cache_size(uint64_t new_size);
 
+  /**
+    Retrieves one of the statistics of the communication engine.
+
+    @param statistic The Gcs_statistics_interface getter of the statistic.
+
+    @return the statistic, 0 if the engine is not initialized
+  */
+  unsigned long long get_statistic(
+      unsigned long long (Gcs_statistics_interface::*statistic)());
+
   /**
    * @return the communication engine being used
    */
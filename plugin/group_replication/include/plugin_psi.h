@@ -163,6 +163,7 @@ extern PSI_cond_key key_GR_COND_applier_module_run,
 extern PSI_thread_key key_GR_THD_applier_module_receiver,
     key_GR_THD_autorejoin,
     key_GR_THD_cert_broadcast,
+    key_GR_THD_cert_garbage_collect,
     key_GR_THD_clone_thd,
     key_GR_THD_delayed_init,
     key_GR_THD_group_action_coordinator,
@@ -134,6 +134,7 @@ struct plugin_options_variables {
   char *force_members_var;
   bool bootstrap_group_var;
   ulong poll_spin_loops_var;
+  ulong communication_batch_wait_var;
 
 #define DEFAULT_MEMBER_EXPEL_TIMEOUT 5
 #define MAX_MEMBER_EXPEL_TIMEOUT 3600
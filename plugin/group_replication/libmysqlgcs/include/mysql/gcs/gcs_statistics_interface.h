@@ -76,6 +76,33 @@ class Gcs_statistics_interface {
 
   virtual long get_last_message_timestamp() = 0;
 
+  /**
+    @return the number of consensus proposals this member made
+  */
+  virtual unsigned long long get_proposals() = 0;
+
+  /**
+    @return the number of messages batched into those proposals
+  */
+  virtual unsigned long long get_proposed_messages() = 0;
+
+  /**
+    @return the number of times a proposal waited for more messages to
+            batch
+  */
+  virtual unsigned long long get_proposal_batch_waits() = 0;
+
+  /**
+    @return the total time, in microseconds, from proposing to learning
+            the outcome of those proposals
+  */
+  virtual unsigned long long get_proposal_time() = 0;
+
+  /**
+    @return the most proposals this member had in flight at once
+  */
+  virtual unsigned long long get_max_proposals_in_flight() = 0;
+
   virtual ~Gcs_statistics_interface() {}
 };
 
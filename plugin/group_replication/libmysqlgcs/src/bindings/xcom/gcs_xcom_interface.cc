@@ -455,6 +455,8 @@ enum_gcs_error Gcs_xcom_interface::configure(
       validated_params.get_parameter("bootstrap_group");
   const std::string *poll_spin_loops_str =
       validated_params.get_parameter("poll_spin_loops");
+  const std::string *batch_wait_str =
+      validated_params.get_parameter("batch_wait");
   const std::string *join_attempts_str =
       validated_params.get_parameter("join_attempts");
   const std::string *join_sleep_time_str =
@@ -535,6 +537,13 @@ enum_gcs_error Gcs_xcom_interface::configure(
     reconfigured |= true;
   }
 
+  if (batch_wait_str != nullptr && batch_wait_str->size() > 0) {
+    m_gcs_xcom_app_cfg.set_batch_wait(
+        (unsigned int)atoi(batch_wait_str->c_str()));
+
+    reconfigured |= true;
+  }
+
   xcom_control->set_join_behavior(
       static_cast<unsigned int>(atoi(join_attempts_str->c_str())),
       static_cast<unsigned int>(atoi(join_sleep_time_str->c_str())));
@@ -848,6 +857,8 @@ bool Gcs_xcom_interface::initialize_xcom(
       interface_params.get_parameter("bootstrap_group");
   const std::string *poll_spin_loops_str =
       interface_params.get_parameter("poll_spin_loops");
+  const std::string *batch_wait_str =
+      interface_params.get_parameter("batch_wait");
   const std::string *ip_allowlist_str =
       interface_params.get_parameter("ip_allowlist");
   const std::string *xcom_cache_size_str =
@@ -875,6 +886,12 @@ bool Gcs_xcom_interface::initialize_xcom(
         (unsigned int)atoi(poll_spin_loops_str->c_str()));
   }
 
+  // configure the batching wait of proposals
+  if (batch_wait_str != nullptr) {
+    m_gcs_xcom_app_cfg.set_batch_wait(
+        (unsigned int)atoi(batch_wait_str->c_str()));
+  }
+
   // configure cache size
   if (xcom_cache_size_str != nullptr) {
     m_gcs_xcom_app_cfg.set_xcom_cache_size(
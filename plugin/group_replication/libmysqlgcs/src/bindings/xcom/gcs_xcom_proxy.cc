@@ -547,6 +547,10 @@ void Gcs_xcom_app_cfg::set_xcom_cache_size(uint64_t size) {
   if (the_app_xcom_cfg) the_app_xcom_cfg->m_cache_limit = size;
 }
 
+void Gcs_xcom_app_cfg::set_batch_wait(unsigned int usec) {
+  if (the_app_xcom_cfg) the_app_xcom_cfg->m_batch_wait_usec = usec;
+}
+
 bool Gcs_xcom_app_cfg::set_identity(node_address *identity) {
   bool constexpr kError = true;
   bool constexpr kSuccess = false;
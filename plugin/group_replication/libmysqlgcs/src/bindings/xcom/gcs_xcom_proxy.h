@@ -1022,6 +1022,13 @@ class Gcs_xcom_app_cfg {
    */
   void set_xcom_cache_size(uint64_t size);
 
+  /**
+    Configures how long a proposal may wait for more messages to batch
+    while earlier proposals are in flight.
+    @param usec the longest wait, in microseconds, 0 for none.
+   */
+  void set_batch_wait(unsigned int usec);
+
   /**
    Configures XCom with its unique instance identifier, i.e. its (address,
    incarnation) pair.
@@ -21,6 +21,7 @@
    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 
 #include "plugin/group_replication/libmysqlgcs/src/bindings/xcom/gcs_xcom_statistics_interface.h"
+#include "plugin/group_replication/libmysqlgcs/src/bindings/xcom/xcom/xcom_statistics.h"
 
 /* purecov: begin deadcode */
 using std::max;
@@ -64,6 +65,29 @@ long Gcs_xcom_statistics::get_last_message_timestamp() {
 }
 /* purecov: end*/
 
+/*
+  The proposer counters are kept by XCom itself, which is not aware of
+  groups, and updated on the XCom thread. They are read here without
+  synchronization, like the XCom message counters.
+*/
+unsigned long long Gcs_xcom_statistics::get_proposals() { return proposals; }
+
+unsigned long long Gcs_xcom_statistics::get_proposed_messages() {
+  return proposed_app_data;
+}
+
+unsigned long long Gcs_xcom_statistics::get_proposal_batch_waits() {
+  return proposal_batch_waits;
+}
+
+unsigned long long Gcs_xcom_statistics::get_proposal_time() {
+  return proposal_usec;
+}
+
+unsigned long long Gcs_xcom_statistics::get_max_proposals_in_flight() {
+  return max_proposals_in_flight;
+}
+
 void Gcs_xcom_statistics::update_message_sent(
     unsigned long long message_length) {
   total_messages_sent++;
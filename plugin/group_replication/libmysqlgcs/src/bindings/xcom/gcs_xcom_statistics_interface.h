@@ -93,6 +93,16 @@ class Gcs_xcom_statistics : public Gcs_statistics_interface,
 
   long get_last_message_timestamp() override;
 
+  unsigned long long get_proposals() override;
+
+  unsigned long long get_proposed_messages() override;
+
+  unsigned long long get_proposal_batch_waits() override;
+
+  unsigned long long get_proposal_time() override;
+
+  unsigned long long get_max_proposals_in_flight() override;
+
   // Implementation of Gcs_xcom_statistics_updater
   void update_message_sent(unsigned long long message_length) override;
 
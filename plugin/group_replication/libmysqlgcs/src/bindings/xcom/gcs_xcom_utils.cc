@@ -325,6 +325,8 @@ bool is_parameters_syntax_correct(
       interface_params.get_parameter("bootstrap_group");
   const std::string *poll_spin_loops_str =
       interface_params.get_parameter("poll_spin_loops");
+  const std::string *batch_wait_str =
+      interface_params.get_parameter("batch_wait");
   const std::string *compression_threshold_str =
       interface_params.get_parameter("compression_threshold");
   const std::string *compression_str =
@@ -486,6 +488,15 @@ bool is_parameters_syntax_correct(
     goto end;
   }
 
+  // batch wait
+  if (batch_wait_str &&
+      (batch_wait_str->size() == 0 || !is_number(*batch_wait_str))) {
+    MYSQL_GCS_LOG_ERROR("The batch_wait parameter (" << *batch_wait_str
+                                                     << ") is not valid.")
+    error = GCS_NOK;
+    goto end;
+  }
+
   // validate compression
   if (compression_str != nullptr) {
     std::string &flag = const_cast<std::string &>(*compression_str);
@@ -1830,6 +1830,8 @@ static int proposer_task(task_arg arg) {
   site_def const *site;
   size_t size;
   size_t nr_batched_app_data;
+  double batch_deadline;
+  int batch_closed;
   END_ENV;
 
   TASK_BEGIN
@@ -1845,6 +1847,8 @@ static int proposer_task(task_arg arg) {
   ep->site = 0;
   ep->size = 0;
   ep->nr_batched_app_data = 0;
+  ep->batch_deadline = 0.0;
+  ep->batch_closed = 0;
 
   IFDBG(D_NONE, FN; NDBG(ep->self, d); NDBG(task_now(), f));
 
@@ -1853,6 +1857,8 @@ static int proposer_task(task_arg arg) {
     assert(!ep->client_msg);
     CHANNEL_GET(&prop_input_queue, &ep->client_msg, msg_link);
     prop_started++;
+    if ((uint64_t)(prop_started - prop_finished) > max_proposals_in_flight)
+      max_proposals_in_flight = (uint64_t)(prop_started - prop_finished);
     IFDBG(D_NONE, FN; PTREXP(ep->client_msg->p->a); STRLIT("extracted ");
           SYCEXP(ep->client_msg->p->a->app_key));
 
@@ -1863,10 +1869,15 @@ static int proposer_task(task_arg arg) {
      * We limit the number of elements because the XDR deserialization
      * implementation is recursive, and batching too many app_datas will cause a
      * call stack overflow. */
+    ep->nr_batched_app_data = 1;
     if (!is_config(ep->client_msg->p->a->body.c_t) &&
         !is_view(ep->client_msg->p->a->body.c_t)) {
       ep->size = app_data_size(ep->client_msg->p->a);
-      ep->nr_batched_app_data = 1;
+      ep->batch_deadline =
+          task_now() +
+          (the_app_xcom_cfg ? the_app_xcom_cfg->m_batch_wait_usec : 0) / 1.0e6;
+      ep->batch_closed = 0;
+    batch_more:
       while (AUTOBATCH && ep->size <= MAX_BATCH_SIZE &&
              ep->nr_batched_app_data <= MAX_BATCH_APP_DATA &&
              !link_empty(&prop_input_queue
@@ -1883,6 +1894,7 @@ static int proposer_task(task_arg arg) {
             ep->nr_batched_app_data > MAX_BATCH_APP_DATA ||
             ep->size > MAX_BATCH_SIZE) {
           channel_put_front(&prop_input_queue, &tmp->l);
+          ep->batch_closed = 1;
           break;
         }
         ADD_T_EV(seconds(), __FILE__, __LINE__, "batching");
@@ -1897,6 +1909,17 @@ static int proposer_task(task_arg arg) {
         IFDBG(D_NONE, FN; PTREXP(ep->client_msg->p->a); STRLIT("extracted ");
               SYCEXP(ep->client_msg->p->a->app_key));
       }
+      /* While earlier proposals are still in flight, this one would mostly
+       * wait behind them in the pipeline anyway, so wait for more messages
+       * to batch, up to the configured latency ceiling. An idle pipeline
+       * proposes at once. */
+      if (AUTOBATCH && !ep->batch_closed && prop_started - prop_finished > 1 &&
+          task_now() < ep->batch_deadline) {
+        proposal_batch_waits++;
+        TIMED_TASK_WAIT(&prop_input_queue.queue,
+                        ep->batch_deadline - task_now());
+        GOTO(batch_more);
+      }
     }
 
     ep->start_propose = task_now();
@@ -2090,6 +2113,9 @@ static int proposer_task(task_arg arg) {
     double used = now - ep->start_propose;
     add_to_filter(used);
     prop_finished++;
+    proposals++;
+    proposed_app_data += ep->nr_batched_app_data;
+    proposal_usec += (uint64_t)(used * 1.0e6);
     IFDBG(D_NONE, FN; STRLIT("completed ep->msgno "); SYCEXP(ep->msgno);
           NDBG(used, f); NDBG(median_time(), f);
           STRLIT("seconds since last push "); NDBG(now - ep->start_push, f););
@@ -38,6 +38,7 @@ void init_cfg_app_xcom() {
 
   the_app_xcom_cfg->m_poll_spin_loops = 0;
   the_app_xcom_cfg->m_cache_limit = DEFAULT_CACHE_LIMIT;
+  the_app_xcom_cfg->m_batch_wait_usec = 0;
   the_app_xcom_cfg->identity = NULL;
 }
 
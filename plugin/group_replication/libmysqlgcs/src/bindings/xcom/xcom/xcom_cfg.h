@@ -39,6 +39,13 @@ typedef struct cfg_app_xcom {
   */
   uint64_t m_cache_limit;
 
+  /*
+   How long, in microseconds, a proposer may wait for more messages to
+   batch into its proposal while earlier proposals are still in flight.
+   0 proposes whatever is queued at once.
+  */
+  unsigned int m_batch_wait_usec;
+
   /*
    The (address, incarnation) pair that uniquely identifies this XCom instance.
   */
@@ -49,6 +49,12 @@ uint64_t receive_count[LAST_OP];
 uint64_t send_bytes[LAST_OP];
 uint64_t receive_bytes[LAST_OP];
 
+uint64_t proposals;
+uint64_t proposed_app_data;
+uint64_t proposal_batch_waits;
+uint64_t proposal_usec;
+uint64_t max_proposals_in_flight;
+
 static double median_filter[M_F_SZ];
 static int filter_index = 0;
 
@@ -33,6 +33,15 @@ extern uint64_t receive_count[LAST_OP];
 extern uint64_t send_bytes[LAST_OP];
 extern uint64_t receive_bytes[LAST_OP];
 
+/* Proposals of this node, the messages batched in them, the times a
+   proposer waited for more messages, the time from proposal to learn,
+   and the most proposals that were in flight at once */
+extern uint64_t proposals;
+extern uint64_t proposed_app_data;
+extern uint64_t proposal_batch_waits;
+extern uint64_t proposal_usec;
+extern uint64_t max_proposals_in_flight;
+
 double median_time();
 void add_to_filter(double t);
 void median_filter_init();
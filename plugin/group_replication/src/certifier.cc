@@ -512,13 +512,15 @@ void Certifier::add_to_group_gtid_executed_internal(rpl_sidno sidno,
 }
 
 void Certifier::clear_certification_info() {
-  for (Certification_info::iterator it = certification_info.begin();
-       it != certification_info.end(); ++it) {
-    // We can only delete the last reference.
-    if (it->second->unlink() == 0) delete it->second;
-  }
+  for (Certification_info &shard : certification_info) {
+    for (Certification_info::iterator it = shard.begin(); it != shard.end();
+         ++it) {
+      // We can only delete the last reference.
+      if (it->second->unlink() == 0) delete it->second;
+    }
 
-  certification_info.clear();
+    shard.clear();
+  }
 }
 
 void Certifier::clear_incoming() {
@@ -1018,12 +1020,13 @@ bool Certifier::add_item(const char *item, Gtid_set_ref *snapshot_version,
   mysql_mutex_assert_owner(&LOCK_certification_info);
   bool error = true;
   std::string key(item);
-  Certification_info::iterator it = certification_info.find(key);
+  Certification_info &shard = get_certification_info_shard(key);
+  Certification_info::iterator it = shard.find(key);
   snapshot_version->link();
 
-  if (it == certification_info.end()) {
+  if (it == shard.end()) {
     std::pair<Certification_info::iterator, bool> ret =
-        certification_info.insert(
+        shard.insert(
             std::pair<std::string, Gtid_set_ref *>(key, snapshot_version));
     error = !ret.second;
   } else {
@@ -1048,10 +1051,11 @@ Gtid_set *Certifier::get_certified_write_set_snapshot_version(
 
   Certification_info::iterator it;
   std::string item_str(item);
+  Certification_info &shard = get_certification_info_shard(item_str);
 
-  it = certification_info.find(item_str);
+  it = shard.find(item_str);
 
-  if (it == certification_info.end())
+  if (it == shard.end())
     return nullptr;
   else
     return it->second;
@@ -1131,15 +1135,33 @@ void Certifier::garbage_collect() {
     precedes them), then "t" is stable and can be removed from
     the certification info.
   */
-  Certification_info::iterator it = certification_info.begin();
   stable_gtid_set_lock->wrlock();
-  while (it != certification_info.end()) {
-    if (it->second->is_subset_not_equals(stable_gtid_set)) {
-      if (it->second->unlink() == 0) delete it->second;
-      certification_info.erase(it++);
-    } else
-      ++it;
+  /*
+    A large certification database is scanned on one thread per shard,
+    this thread taking the first shard. The shards share nothing but
+    the snapshot versions, which are only read and whose reference
+    counters are atomic.
+  */
+  size_t started = 0;
+  my_thread_handle shard_threads[CERTIFICATION_INFO_SHARDS];
+  Garbage_collect_shard_args shard_args[CERTIFICATION_INFO_SHARDS];
+  if (get_certification_info_size() >= GARBAGE_COLLECT_PARALLEL_MIN_SIZE) {
+    for (size_t shard = 1; shard < CERTIFICATION_INFO_SHARDS; shard++) {
+      shard_args[started] = {this, shard};
+      // No attributes, the threads must be joinable.
+      if (mysql_thread_create(key_GR_THD_cert_garbage_collect,
+                              &shard_threads[started], nullptr,
+                              launch_garbage_collect_shard,
+                              &shard_args[started]))
+        break; /* purecov: inspected */
+      started++;
+    }
   }
+  for (size_t shard = started + 1; shard < CERTIFICATION_INFO_SHARDS; shard++)
+    garbage_collect_shard(shard);
+  garbage_collect_shard(0);
+  for (size_t i = 0; i < started; i++)
+    my_thread_join(&shard_threads[i], nullptr);
   stable_gtid_set_lock->unlock();
 
   /*
@@ -1181,6 +1203,27 @@ void Certifier::garbage_collect() {
   }
 }
 
+void Certifier::garbage_collect_shard(size_t shard) {
+  Certification_info &items = certification_info[shard];
+  Certification_info::iterator it = items.begin();
+  while (it != items.end()) {
+    if (it->second->is_subset_not_equals(stable_gtid_set)) {
+      if (it->second->unlink() == 0) delete it->second;
+      items.erase(it++);
+    } else
+      ++it;
+  }
+}
+
+void *Certifier::launch_garbage_collect_shard(void *arg) {
+  Garbage_collect_shard_args *args =
+      static_cast<Garbage_collect_shard_args *>(arg);
+  my_thread_init();
+  args->certifier->garbage_collect_shard(args->shard);
+  my_thread_end();
+  return nullptr;
+}
+
 int Certifier::handle_certifier_data(
     const uchar *data, ulong len, const Gcs_member_identifier &gcs_member_id) {
   DBUG_TRACE;
@@ -1382,18 +1425,20 @@ void Certifier::get_certification_info(
   DBUG_TRACE;
   mysql_mutex_lock(&LOCK_certification_info);
 
-  for (Certification_info::iterator it = certification_info.begin();
-       it != certification_info.end(); ++it) {
-    std::string key = it->first;
-    assert(key.compare(GTID_EXTRACTED_NAME) != 0);
+  for (Certification_info &shard : certification_info) {
+    for (Certification_info::iterator it = shard.begin(); it != shard.end();
+         ++it) {
+      std::string key = it->first;
+      assert(key.compare(GTID_EXTRACTED_NAME) != 0);
 
-    size_t len = it->second->get_encoded_length();
-    uchar *buf = (uchar *)my_malloc(PSI_NOT_INSTRUMENTED, len, MYF(0));
-    it->second->encode(buf);
-    std::string value(reinterpret_cast<const char *>(buf), len);
-    my_free(buf);
+      size_t len = it->second->get_encoded_length();
+      uchar *buf = (uchar *)my_malloc(PSI_NOT_INSTRUMENTED, len, MYF(0));
+      it->second->encode(buf);
+      std::string value(reinterpret_cast<const char *>(buf), len);
+      my_free(buf);
 
-    (*cert_info).insert(std::pair<std::string, std::string>(key, value));
+      (*cert_info).insert(std::pair<std::string, std::string>(key, value));
+    }
   }
 
   // Add the group_gtid_executed to certification info sent to joiners.
@@ -1476,7 +1521,7 @@ int Certifier::set_certification_info(
       return 1;                                     /* purecov: inspected */
     }
     value->link();
-    certification_info.insert(
+    get_certification_info_shard(key).insert(
         std::pair<std::string, Gtid_set_ref *>(key, value));
   }
 
@@ -1548,7 +1593,10 @@ ulonglong Certifier::get_positive_certified() { return positive_cert; }
 ulonglong Certifier::get_negative_certified() { return negative_cert; }
 
 ulonglong Certifier::get_certification_info_size() {
-  return certification_info.size();
+  ulonglong size = 0;
+  for (const Certification_info &shard : certification_info)
+    size += shard.size();
+  return size;
 }
 
 void Certifier::get_last_conflict_free_transaction(std::string *value) {
@@ -623,6 +623,22 @@ end:
   return gcs_communication;
 }
 
+unsigned long long Gcs_operations::get_statistic(
+    unsigned long long (Gcs_statistics_interface::*statistic)()) {
+  DBUG_TRACE;
+  unsigned long long result = 0;
+  gcs_operations_lock->rdlock();
+  if (gcs_interface != nullptr && gcs_interface->is_initialized()) {
+    std::string const group_name(get_group_name_var());
+    Gcs_group_identifier const group_id(group_name);
+    Gcs_statistics_interface *gcs_statistics =
+        gcs_interface->get_statistics(group_id);
+    if (gcs_statistics != nullptr) result = (gcs_statistics->*statistic)();
+  }
+  gcs_operations_lock->unlock();
+  return result;
+}
+
 Gcs_protocol_version Gcs_operations::get_protocol_version() {
   DBUG_TRACE;
   Gcs_protocol_version protocol = Gcs_protocol_version::UNKNOWN;
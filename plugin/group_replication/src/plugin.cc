@@ -2073,6 +2073,10 @@ int build_gcs_parameters(Gcs_interface_parameters &gcs_module_parameters) {
   poll_spin_loops_stream_buffer << ov.poll_spin_loops_var;
   gcs_module_parameters.add_parameter("poll_spin_loops",
                                       poll_spin_loops_stream_buffer.str());
+  std::stringstream batch_wait_stream_buffer;
+  batch_wait_stream_buffer << ov.communication_batch_wait_var;
+  gcs_module_parameters.add_parameter("batch_wait",
+                                      batch_wait_stream_buffer.str());
   std::stringstream member_expel_timeout_stream_buffer;
   member_expel_timeout_stream_buffer << ov.member_expel_timeout_var;
   gcs_module_parameters.add_parameter("member_expel_timeout",
@@ -3871,6 +3875,22 @@ static MYSQL_SYSVAR_ULONG(
     0        /* block */
 );
 
+static MYSQL_SYSVAR_ULONG(
+    communication_batch_wait,                              /* name */
+    ov.communication_batch_wait_var,                       /* var */
+    PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_PERSIST_AS_READ_ONLY, /* optional var */
+    "The longest time, in microseconds, that the communication engine "
+    "waits for more messages to batch into a consensus proposal while "
+    "earlier proposals are in progress. 0 proposes the messages queued "
+    "at once.",
+    nullptr, /* check func. */
+    nullptr, /* update func. */
+    0,       /* default */
+    0,       /* min */
+    100000,  /* max */
+    0        /* block */
+);
+
 static MYSQL_SYSVAR_ULONG(
     member_expel_timeout,                                  /* name */
     ov.member_expel_timeout_var,                           /* var */
@@ -4601,6 +4621,7 @@ static SYS_VAR *group_replication_system_vars[] = {
     MYSQL_SYSVAR(force_members),
     MYSQL_SYSVAR(bootstrap_group),
     MYSQL_SYSVAR(poll_spin_loops),
+    MYSQL_SYSVAR(communication_batch_wait),
     MYSQL_SYSVAR(recovery_retry_count),
     MYSQL_SYSVAR(recovery_use_ssl),
     MYSQL_SYSVAR(recovery_ssl_ca),
@@ -4672,9 +4693,39 @@ static int show_primary_member(MYSQL_THD, SHOW_VAR *var, char *buff) {
   return 0;
 }
 
+template <unsigned long long (Gcs_statistics_interface::*statistic)()>
+static int show_communication_statistic(MYSQL_THD, SHOW_VAR *var,
+                                        char *buff) {
+  unsigned long long *value = reinterpret_cast<unsigned long long *>(buff);
+  *value = gcs_module != nullptr ? gcs_module->get_statistic(statistic) : 0;
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  return 0;
+}
+
 static SHOW_VAR group_replication_status_vars[] = {
     {"group_replication_primary_member", (char *)&show_primary_member,
      SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"group_replication_communication_proposals",
+     (char *)&show_communication_statistic<
+         &Gcs_statistics_interface::get_proposals>,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"group_replication_communication_proposed_messages",
+     (char *)&show_communication_statistic<
+         &Gcs_statistics_interface::get_proposed_messages>,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"group_replication_communication_proposal_batch_waits",
+     (char *)&show_communication_statistic<
+         &Gcs_statistics_interface::get_proposal_batch_waits>,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"group_replication_communication_proposal_time",
+     (char *)&show_communication_statistic<
+         &Gcs_statistics_interface::get_proposal_time>,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"group_replication_communication_max_proposals_in_flight",
+     (char *)&show_communication_statistic<
+         &Gcs_statistics_interface::get_max_proposals_in_flight>,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
     {nullptr, nullptr, SHOW_LONG, SHOW_SCOPE_GLOBAL},
 };
 
@@ -116,6 +116,7 @@ PSI_cond_key key_GR_COND_applier_module_run,
 PSI_thread_key key_GR_THD_applier_module_receiver,
     key_GR_THD_autorejoin,
     key_GR_THD_cert_broadcast,
+    key_GR_THD_cert_garbage_collect,
     key_GR_THD_clone_thd,
     key_GR_THD_delayed_init,
     key_GR_THD_group_action_coordinator,
@@ -419,6 +420,8 @@ static PSI_thread_info all_group_replication_psi_thread_keys[] = {
      PSI_FLAG_SINGLETON | PSI_FLAG_THREAD_SYSTEM, 0, PSI_DOCUMENT_ME},
     {&key_GR_THD_cert_broadcast, "THD_certifier_broadcast",
      PSI_FLAG_SINGLETON | PSI_FLAG_THREAD_SYSTEM, 0, PSI_DOCUMENT_ME},
+    {&key_GR_THD_cert_garbage_collect, "THD_certifier_garbage_collect",
+     PSI_FLAG_THREAD_SYSTEM, 0, PSI_DOCUMENT_ME},
     {&key_GR_THD_clone_thd, "THD_clone_process",
      PSI_FLAG_SINGLETON | PSI_FLAG_THREAD_SYSTEM, 0, PSI_DOCUMENT_ME},
     {&key_GR_THD_delayed_init, "THD_delayed_initialization",
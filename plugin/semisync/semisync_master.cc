@@ -337,6 +337,22 @@ int ReplSemiSyncMaster::reportReplyPacket(uint32 server_id, const uchar *packet,
                                           ulong packet_len) {
   const char *kWho = "ReplSemiSyncMaster::reportReplyPacket";
   int result = -1;
+  AckInfo ackinfo;
+
+  function_enter(kWho);
+
+  if (readReplyPacket(server_id, packet, packet_len, &ackinfo)) goto l_end;
+
+  handleAck(server_id, ackinfo.binlog_name, ackinfo.binlog_pos);
+
+l_end:
+  return function_exit(kWho, result);
+}
+
+int ReplSemiSyncMaster::readReplyPacket(uint32 server_id, const uchar *packet,
+                                        ulong packet_len, AckInfo *ackinfo) {
+  const char *kWho = "ReplSemiSyncMaster::readReplyPacket";
+  int result = -1;
   char log_file_name[FN_REFLEN + 1];
   my_off_t log_file_pos;
   ulong log_file_len = 0;
@@ -368,12 +384,39 @@ int ReplSemiSyncMaster::reportReplyPacket(uint32 server_id, const uchar *packet,
     LogErr(INFORMATION_LEVEL, ER_SEMISYNC_SERVER_REPLY, kWho, log_file_name,
            (ulong)log_file_pos, server_id);
 
-  handleAck(server_id, log_file_name, log_file_pos);
+  ackinfo->set(server_id, log_file_name, log_file_pos);
+  result = 0;
 
 l_end:
   return function_exit(kWho, result);
 }
 
+void ReplSemiSyncMaster::handleAcks(const AckInfo *acks, size_t count) {
+  AckInfo reply;
+  bool have_reply = false;
+
+  if (count == 0) return;
+
+  lock();
+  for (size_t i = 0; i < count; i++) {
+    const AckInfo *ackinfo = &acks[i];
+
+    if (rpl_semi_sync_master_wait_for_slave_count > 1)
+      ackinfo = ack_container_.insert(acks[i]);
+
+    /* Only the greatest position needs to be reported, it covers the rest. */
+    if (ackinfo != nullptr &&
+        (!have_reply ||
+         reply.less_than(ackinfo->binlog_name, ackinfo->binlog_pos))) {
+      reply = *ackinfo;
+      have_reply = true;
+    }
+  }
+
+  if (have_reply) reportReplyBinlog(reply.binlog_name, reply.binlog_pos);
+  unlock();
+}
+
 /*******************************************************************************
  *
  * <ReplSemiSyncMaster> class: the basic code layer for sync-replication master.
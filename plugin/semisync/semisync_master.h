@@ -685,6 +685,14 @@ class ReplSemiSyncMaster : public ReplSemiSyncBase {
   int reportReplyPacket(uint32 server_id, const uchar *packet,
                         ulong packet_len);
 
+  /* It parses a reply packet into an ack, without handling it.
+   *
+   * Return:
+   *  0: success;  non-zero: the packet is malformed
+   */
+  int readReplyPacket(uint32 server_id, const uchar *packet, ulong packet_len,
+                      AckInfo *ackinfo);
+
   /* In semi-sync replication, reports up to which binlog position we have
    * received replies from the slave indicating that it already get the events
    * or that was skipped in the master.
@@ -828,6 +836,17 @@ class ReplSemiSyncMaster : public ReplSemiSyncBase {
     }
     unlock();
   }
+
+  /*
+    Handle the acks the ack thread received in one poll cycle, at most one
+    per slave. LOCK_binlog_ is taken once for all of them, and the waiting
+    transactions covered by the greatest fully acknowledged position are
+    woken up in one pass.
+
+    @param[in] acks  the acks
+    @param[in] count number of acks
+  */
+  void handleAcks(const AckInfo *acks, size_t count);
 };
 
 /* System and status variables for the master component */
@@ -231,6 +231,21 @@ inline void Ack_receiver::wait_for_slave_connection() {
   mysql_cond_wait(&m_cond, &m_mutex);
 }
 
+/*
+  Add an ack to the acks of the current poll cycle. An ack supersedes an
+  earlier one of the same slave, so only the greatest one is kept.
+*/
+static void add_ack(std::vector<AckInfo> *acks, const AckInfo &ackinfo) {
+  for (AckInfo &ack : *acks) {
+    if (ack.is_server(ackinfo.server_id)) {
+      if (ack.less_than(ackinfo.binlog_name, ackinfo.binlog_pos))
+        ack.update(ackinfo.binlog_name, ackinfo.binlog_pos);
+      return;
+    }
+  }
+  acks->push_back(ackinfo);
+}
+
 /* Auxilary function to initialize a NET object with given net buffer. */
 static void init_net(NET *net, unsigned char *buff, unsigned int buff_len) {
   memset(net, 0, sizeof(NET));
@@ -245,6 +260,8 @@ void Ack_receiver::run() {
   unsigned char net_buff[REPLY_MESSAGE_MAX_LENGTH];
   uint i;
   Socket_listener listener;
+  /* The latest ack of each slave received in the current poll cycle */
+  std::vector<AckInfo> acks;
 
   LogErr(INFORMATION_LEVEL, ER_SEMISYNC_STARTING_ACK_RECEIVER_THD);
 
@@ -291,6 +308,7 @@ void Ack_receiver::run() {
     }
 
     set_stage_info(stage_reading_semi_sync_ack);
+    acks.clear();
     i = 0;
     while (i < listener.number_of_slave_sockets() && m_status == ST_UP) {
       if (listener.is_socket_active(i)) {
@@ -312,15 +330,21 @@ void Ack_receiver::run() {
           net_clear(&net, false);
 
           len = my_net_read(&net);
-          if (likely(len != packet_error))
-            repl_semisync->reportReplyPacket(slave_obj.server_id, net.read_pos,
-                                             len);
-          else if (net.last_errno == ER_NET_READ_ERROR)
+          if (likely(len != packet_error)) {
+            AckInfo ackinfo;
+
+            if (!repl_semisync->readReplyPacket(slave_obj.server_id,
+                                                net.read_pos, len, &ackinfo))
+              add_ack(&acks, ackinfo);
+          } else if (net.last_errno == ER_NET_READ_ERROR)
             listener.clear_socket_info(i);
         } while (net.vio->has_data(net.vio) && m_status == ST_UP);
       }
       i++;
     }
+
+    /* Handle all acks of this cycle under one LOCK_binlog_ acquisition. */
+    repl_semisync->handleAcks(acks.data(), acks.size());
   }
 end:
   LogErr(INFORMATION_LEVEL, ER_SEMISYNC_STOPPING_ACK_RECEIVER_THREAD);
@@ -27,13 +27,17 @@
 
 #include "my_byteorder.h"
 #include "my_dbug.h"
+#include "my_systime.h"
 #include "mysql.h"
+#include "violite.h"
 #include "sql/current_thd.h"
 #include "sql/debug_sync.h"
 
 bool rpl_semi_sync_slave_enabled;
 char rpl_semi_sync_slave_status = 0;
 unsigned long rpl_semi_sync_slave_trace_level;
+unsigned long rpl_semi_sync_slave_ack_coalesce_usec = 0;
+unsigned long long rpl_semi_sync_slave_coalesced_acks = 0;
 
 int ReplSemiSyncSlave::initObject() {
   int result = 0;
@@ -87,6 +91,7 @@ int ReplSemiSyncSlave::slaveStart(Binlog_relay_IO_param *param) {
          (unsigned long)param->master_log_pos);
 
   if (semi_sync && !rpl_semi_sync_slave_status) rpl_semi_sync_slave_status = 1;
+  reply_deferred_since_ = 0;
   return 0;
 }
 
@@ -139,3 +144,31 @@ int ReplSemiSyncSlave::slaveReply(MYSQL *mysql, const char *binlog_filename,
 
   return function_exit(kWho, reply_res);
 }
+
+int ReplSemiSyncSlave::slaveQueuedEvent(MYSQL *mysql, bool need_reply,
+                                        const char *binlog_filename,
+                                        my_off_t binlog_filepos) {
+  if (!need_reply && reply_deferred_since_ == 0) return 0;
+
+  if (rpl_semi_sync_slave_ack_coalesce_usec > 0) {
+    ulonglong now = my_micro_time();
+    Vio *vio = mysql->net.vio;
+
+    if (reply_deferred_since_ == 0) reply_deferred_since_ = now;
+
+    /*
+      More events are already on their way: the reply to a later one
+      will acknowledge this one too, so don't make the master's ack
+      thread handle both, unless we have held back replies for too long.
+    */
+    if (now - reply_deferred_since_ < rpl_semi_sync_slave_ack_coalesce_usec &&
+        vio != nullptr &&
+        (vio->has_data(vio) || vio_io_wait(vio, VIO_IO_EVENT_READ, 0) > 0)) {
+      if (need_reply) rpl_semi_sync_slave_coalesced_acks++;
+      return 0;
+    }
+  }
+
+  reply_deferred_since_ = 0;
+  return slaveReply(mysql, binlog_filename, binlog_filepos);
+}
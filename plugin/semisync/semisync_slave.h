@@ -77,6 +77,25 @@ class ReplSemiSyncSlave : public ReplSemiSyncBase {
   int slaveReply(MYSQL *mysql, const char *binlog_filename,
                  my_off_t binlog_filepos);
 
+  /* Called after each event is queued. Replies to the master if the event
+   * asked for a reply, or if an earlier one did and its reply was deferred.
+   *
+   * With rpl_semi_sync_slave_ack_coalesce_usec > 0, the reply is deferred
+   * while the master has already sent more events, for at most that long:
+   * the reply to the last of them then acknowledges all of them at once.
+   *
+   * Input:
+   *  mysql            - (IN)  the mysql network connection
+   *  need_reply       - (IN)  whether the master is waiting for the reply
+   *  binlog_filename  - (IN)  the queued event's binlog file name
+   *  binlog_filepos   - (IN)  the queued event's end position
+   *
+   * Return:
+   *  0: success;  non-zero: error
+   */
+  int slaveQueuedEvent(MYSQL *mysql, bool need_reply,
+                       const char *binlog_filename, my_off_t binlog_filepos);
+
   int slaveStart(Binlog_relay_IO_param *param);
   int slaveStop(Binlog_relay_IO_param *param);
 
@@ -85,11 +104,15 @@ class ReplSemiSyncSlave : public ReplSemiSyncBase {
   bool init_done_ = false;
   bool slave_enabled_ = false;  /* semi-sycn is enabled on the slave */
   MYSQL *mysql_reply = nullptr; /* connection to send reply */
+  /* when the oldest deferred reply was due, 0 if none is pending */
+  ulonglong reply_deferred_since_ = 0;
 };
 
 /* System and status variables for the slave component */
 extern bool rpl_semi_sync_slave_enabled;
 extern unsigned long rpl_semi_sync_slave_trace_level;
+extern unsigned long rpl_semi_sync_slave_ack_coalesce_usec;
+extern unsigned long long rpl_semi_sync_slave_coalesced_acks;
 extern char rpl_semi_sync_slave_status;
 
 #endif /* SEMISYNC_SLAVE_H */
@@ -126,14 +126,15 @@ static int repl_semi_slave_read_event(Binlog_relay_IO_param *,
 
 static int repl_semi_slave_queue_event(Binlog_relay_IO_param *param,
                                        const char *, unsigned long, uint32) {
-  if (rpl_semi_sync_slave_status && semi_sync_need_reply) {
+  if (rpl_semi_sync_slave_status) {
     /*
       We deliberately ignore the error in slaveReply, such error
       should not cause the slave IO thread to stop, and the error
       messages are already reported.
     */
-    (void)repl_semisync->slaveReply(param->mysql, param->master_log_name,
-                                    param->master_log_pos);
+    (void)repl_semisync->slaveQueuedEvent(param->mysql, semi_sync_need_reply,
+                                          param->master_log_name,
+                                          param->master_log_pos);
   }
   return 0;
 }
@@ -177,9 +178,21 @@ static MYSQL_SYSVAR_ULONG(trace_level, rpl_semi_sync_slave_trace_level,
                           &fix_rpl_semi_sync_trace_level,  // update
                           32, 0, ~0UL, 1);
 
+static MYSQL_SYSVAR_ULONG(
+    ack_coalesce_usec, rpl_semi_sync_slave_ack_coalesce_usec,
+    PLUGIN_VAR_OPCMDARG,
+    "Defer the reply to a transaction for up to this many microseconds "
+    "while the master has already sent further events, so that one reply "
+    "acknowledges several transactions. 0 (the default) replies to every "
+    "transaction at once.",
+    nullptr,  // check
+    nullptr,  // update
+    0, 0, 1000000, 1);
+
 static SYS_VAR *semi_sync_slave_system_vars[] = {
     MYSQL_SYSVAR(enabled),
     MYSQL_SYSVAR(trace_level),
+    MYSQL_SYSVAR(ack_coalesce_usec),
     nullptr,
 };
 
@@ -187,6 +200,9 @@ static SYS_VAR *semi_sync_slave_system_vars[] = {
 static SHOW_VAR semi_sync_slave_status_vars[] = {
     {"Rpl_semi_sync_slave_status", (char *)&rpl_semi_sync_slave_status,
      SHOW_BOOL, SHOW_SCOPE_GLOBAL},
+    {"Rpl_semi_sync_slave_coalesced_acks",
+     (char *)&rpl_semi_sync_slave_coalesced_acks, SHOW_LONGLONG,
+     SHOW_SCOPE_GLOBAL},
     {nullptr, nullptr, SHOW_BOOL, SHOW_SCOPE_GLOBAL},
 };
 
@@ -36,6 +36,8 @@
 #include "plugin/x/src/interface/server.h"
 #include "plugin/x/src/ngs/protocol/protocol_protobuf.h"
 #include "plugin/x/src/notices.h"
+#include "plugin/x/src/prepare_param_handler.h"
+#include "plugin/x/src/prepared_statement_builder.h"
 #include "plugin/x/src/session.h"
 #include "plugin/x/src/sql_data_result.h"
 #include "plugin/x/src/update_statement_builder.h"
@@ -94,8 +96,176 @@ inline bool check_message(const std::string &msg, const char *pattern,
 }  // namespace
 
 // -- Insert
+template <>
+ngs::Error_code Crud_command_handler::error_handling(
+    const ngs::Error_code &error, const Mysqlx::Crud::Insert &msg) const;
+
+namespace {
+/** Values that bind to a statement parameter the way they would be
+    written into the SQL text */
+inline bool is_bindable_literal(const Mysqlx::Expr::Expr &expr) {
+  if (expr.type() != Mysqlx::Expr::Expr::LITERAL) return false;
+
+  switch (expr.literal().type()) {
+    case Mysqlx::Datatypes::Scalar::V_SINT:
+    case Mysqlx::Datatypes::Scalar::V_UINT:
+    case Mysqlx::Datatypes::Scalar::V_NULL:
+    case Mysqlx::Datatypes::Scalar::V_DOUBLE:
+    case Mysqlx::Datatypes::Scalar::V_FLOAT:
+    case Mysqlx::Datatypes::Scalar::V_BOOL:
+    case Mysqlx::Datatypes::Scalar::V_STRING:
+      return true;
+
+    case Mysqlx::Datatypes::Scalar::V_OCTETS:
+      return expr.literal().v_octets().content_type() ==
+             Expression_generator::CT_PLAIN;
+  }
+  return false;
+}
+}  // namespace
+
+/**
+  Inserts into tables whose rows consist of literals only are executed as
+  server-side prepared statements, so that bulk loads sending many such
+  messages don't have the server parse the same INSERT over and over.
+  The statement is prepared once per "shape": target table, columns and
+  number of rows and fields. This function returns the key of the shape,
+  or false if the message doesn't qualify.
+*/
+bool Crud_command_handler::get_prepared_insert_key(
+    const Mysqlx::Crud::Insert &msg, std::string *key) const {
+  if (!is_table_data_model(msg) || msg.upsert() || msg.args_size() != 0 ||
+      msg.row_size() == 0)
+    return false;
+
+  const int fields = msg.row(0).field_size();
+  if (fields == 0 ||
+      (msg.projection_size() != 0 && msg.projection_size() != fields))
+    return false;
+
+  for (const auto &row : msg.row()) {
+    if (row.field_size() != fields) return false;
+    for (const auto &field : row.field())
+      if (!is_bindable_literal(field)) return false;
+  }
+
+  key->assign(msg.collection().schema()).append(1, '\0');
+  key->append(msg.collection().name()).append(1, '\0');
+  for (const auto &column : msg.projection()) {
+    if (column.document_path_size() != 0) return false;
+    key->append(column.name()).append(1, '\0');
+  }
+  key->append(std::to_string(msg.row_size()))
+      .append(1, 'x')
+      .append(std::to_string(fields));
+  return true;
+}
+
+bool Crud_command_handler::prepare_insert(const Mysqlx::Crud::Insert &msg,
+                                          uint32_t *stmt_id) {
+  // Same statement with a placeholder for each field
+  Mysqlx::Crud::Insert stmt;
+  uint32_t position = 0;
+
+  *stmt.mutable_collection() = msg.collection();
+  stmt.set_data_model(msg.data_model());
+  *stmt.mutable_projection() = msg.projection();
+  for (const auto &row : msg.row()) {
+    auto *stmt_row = stmt.add_row();
+    for (int i = 0; i < row.field_size(); ++i) {
+      auto *field = stmt_row->add_field();
+      field->set_type(Mysqlx::Expr::Expr::PLACEHOLDER);
+      field->set_position(position++);
+    }
+  }
+
+  Prepared_statement_builder::Placeholder_list placeholders;
+  if (Prepared_statement_builder(&m_qb, &placeholders).build(stmt))
+    return false;
+
+  log_debug("CRUD prepared insert: %s", m_qb.get().c_str());
+
+  Prepare_resultset rset;
+  if (m_session->data_context().prepare_prep_stmt(m_qb.get().data(),
+                                                  m_qb.get().length(), &rset))
+    return false;  // e.g. max_prepared_stmt_count reached
+
+  *stmt_id = rset.get_stmt_id();
+  return true;
+}
+
+/**
+  Execute the insert through a statement prepared for its shape.
+
+  @retval false  the message doesn't qualify, or no statement could be
+                 prepared; execute it as SQL text
+  @retval true   executed; `error` holds the result
+*/
+bool Crud_command_handler::execute_prepared_insert(
+    const Mysqlx::Crud::Insert &msg, ngs::Error_code *error) {
+  std::string key;
+  if (!get_prepared_insert_key(msg, &key)) return false;
+
+  auto it = m_prepared_inserts.find(key);
+  if (it == m_prepared_inserts.end()) {
+    if (m_prepared_inserts.size() >= k_max_prepared_inserts) {
+      Empty_resultset rset;
+      for (const auto &stmt : m_prepared_inserts)
+        m_session->data_context().deallocate_prep_stmt(stmt.second, &rset);
+      m_prepared_inserts.clear();
+    }
+
+    uint32_t stmt_id;
+    if (!prepare_insert(msg, &stmt_id)) return false;
+    it = m_prepared_inserts.emplace(key, stmt_id).first;
+  }
+
+  m_session->update_status(&ngs::Common_status_variables::m_crud_insert);
+
+  Prepare_param_handler::Arg_list args;
+  for (const auto &row : msg.row()) {
+    for (const auto &field : row.field()) {
+      auto *arg = args.Add();
+      arg->set_type(Mysqlx::Datatypes::Any::SCALAR);
+      *arg->mutable_scalar() = field.literal();
+    }
+  }
+
+  Prepared_statement_builder::Placeholder_list placeholders;
+  for (int i = 0; i < args.size(); ++i) placeholders.emplace_back(i);
+
+  Prepare_param_handler param_handler(placeholders);
+  *error = param_handler.prepare_parameters(args);
+  if (*error) return true;
+
+  Empty_resultset rset;
+  *error = m_session->data_context().execute_prep_stmt(
+      it->second, false, param_handler.get_params().data(),
+      param_handler.get_params().size(), &rset);
+  if (*error) {
+    *error = error_handling(*error, msg);
+    return true;
+  }
+
+  const auto &info = rset.get_info();
+  notice_handling_common(info);
+  m_session->proto().send_notice_rows_affected(info.affected_rows);
+  if (info.last_insert_id > 0)
+    m_session->proto().send_notice_last_insert_id(info.last_insert_id);
+
+  // Clients loading data pipeline their inserts; reply to them together.
+  auto *flusher = m_session->proto().get_flusher();
+  flusher->set_defer_execute_ok(true);
+  m_session->proto().send_exec_ok();
+  flusher->set_defer_execute_ok(false);
+  return true;
+}
+
 ngs::Error_code Crud_command_handler::execute_crud_insert(
     const Mysqlx::Crud::Insert &msg) {
+  ngs::Error_code prepared_error;
+  if (execute_prepared_insert(msg, &prepared_error)) return prepared_error;
+
   auto &id_agg = m_session->get_document_id_aggregator();
   iface::Document_id_aggregator::Retention_guard g(&id_agg);
   ngs::Error_code error = id_agg.configue(&m_session->data_context());
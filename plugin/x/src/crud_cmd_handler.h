@@ -25,6 +25,9 @@
 #ifndef PLUGIN_X_SRC_CRUD_CMD_HANDLER_H_
 #define PLUGIN_X_SRC_CRUD_CMD_HANDLER_H_
 
+#include <map>
+#include <string>
+
 #include "plugin/x/src/interface/resultset.h"
 #include "plugin/x/src/interface/sql_session.h"
 #include "plugin/x/src/ngs/error_code.h"
@@ -49,6 +52,12 @@ class Crud_command_handler {
   ngs::Error_code execute_modify_view(const Mysqlx::Crud::ModifyView &msg);
   ngs::Error_code execute_drop_view(const Mysqlx::Crud::DropView &msg);
 
+  /**
+    Forget the statements prepared for inserts, after the session was
+    reset and the server deallocated them.
+   */
+  void reset_prepared_inserts() { m_prepared_inserts.clear(); }
+
  private:
   using Status_variable =
       ngs::Common_status_variables::Variable ngs::Common_status_variables::*;
@@ -70,8 +79,20 @@ class Crud_command_handler {
 
   void notice_handling_common(const iface::Resultset::Info &info) const;
 
+  bool get_prepared_insert_key(const Mysqlx::Crud::Insert &msg,
+                               std::string *key) const;
+  bool prepare_insert(const Mysqlx::Crud::Insert &msg, uint32_t *stmt_id);
+  bool execute_prepared_insert(const Mysqlx::Crud::Insert &msg,
+                               ngs::Error_code *error);
+
+  /** Number of insert shapes kept prepared per session */
+  static const std::size_t k_max_prepared_inserts = 16;
+
   iface::Session *m_session;
   Query_string_builder m_qb;
+  /** Server statement ids of inserts prepared by shape, see
+      get_prepared_insert_key() */
+  std::map<std::string, uint32_t> m_prepared_inserts;
 };
 
 }  // namespace xpl
@@ -63,6 +63,14 @@ class Protocol_flusher {
    */
   virtual bool is_going_to_flush() = 0;
 
+  /**
+    Keep StmtExecuteOk messages in the buffer while the client has
+    already sent further messages, so that the replies to a pipeline
+    of statements are written together. The reply to the last of them
+    is flushed as usual.
+   */
+  virtual void set_defer_execute_ok(const bool defer) = 0;
+
   /**
     Write timeout to be used at flush execution
    */
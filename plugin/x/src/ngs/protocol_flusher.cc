@@ -93,7 +93,9 @@ void Protocol_flusher::trigger_on_message(const uint8_t type) {
        (type == Mysqlx::ServerMessages::RESULTSET_FETCH_DONE) ||
        (type == Mysqlx::ServerMessages::RESULTSET_FETCH_DONE_MORE_OUT_PARAMS) ||
        (type == Mysqlx::ServerMessages::RESULTSET_FETCH_DONE_MORE_RESULTSETS) ||
-       (type == Mysqlx::ServerMessages::RESULTSET_FETCH_SUSPENDED));
+       (type == Mysqlx::ServerMessages::RESULTSET_FETCH_SUSPENDED) ||
+       (type == Mysqlx::ServerMessages::SQL_STMT_EXECUTE_OK &&
+        m_defer_execute_ok && has_pending_input()));
 
   // Let check if flusher holds `k_number_of_pages_that_trigger_flush` pages.
   //
@@ -108,6 +110,14 @@ void Protocol_flusher::trigger_on_message(const uint8_t type) {
   m_flush = !can_buffer || buffer_too_big;
 }
 
+bool Protocol_flusher::has_pending_input() {
+  ::Vio *vio = m_socket->get_vio();
+
+  if (nullptr == vio) return false;
+
+  return vio->has_data(vio) || vio_io_wait(vio, VIO_IO_EVENT_READ, 0) > 0;
+}
+
 Result Protocol_flusher::try_flush() {
   if (m_io_error) return Result::k_error;
 
@@ -81,6 +81,10 @@ class Protocol_flusher : public xpl::iface::Protocol_flusher {
 
   bool is_going_to_flush() override { return m_flush; }
 
+  void set_defer_execute_ok(const bool defer) override {
+    m_defer_execute_ok = defer;
+  }
+
   void set_write_timeout(const uint32_t timeout) override {
     m_write_timeout = timeout;
   }
@@ -89,6 +93,7 @@ class Protocol_flusher : public xpl::iface::Protocol_flusher {
 
  private:
   bool flush();
+  bool has_pending_input();
 
   protocol::Encoding_buffer *m_buffer;
   protocol::XMessage_encoder *m_encoder;
@@ -98,6 +103,7 @@ class Protocol_flusher : public xpl::iface::Protocol_flusher {
   std::shared_ptr<xpl::iface::Vio> m_socket;
   bool m_flush = false;
   bool m_io_error = false;
+  bool m_defer_execute_ok = false;
   Error_handler m_on_error;
 };
 
@@ -527,6 +527,10 @@ bool Protocol_flusher_compression::is_going_to_flush() {
   return m_flusher->is_going_to_flush();
 }
 
+void Protocol_flusher_compression::set_defer_execute_ok(const bool defer) {
+  m_flusher->set_defer_execute_ok(defer);
+}
+
 void Protocol_flusher_compression::set_write_timeout(const uint32_t timeout) {
   m_flusher->set_write_timeout(timeout);
 }
@@ -74,6 +74,7 @@ class Protocol_flusher_compression : public xpl::iface::Protocol_flusher {
   Result try_flush() override;
 
   bool is_going_to_flush() override;
+  void set_defer_execute_ok(const bool defer) override;
 
   void set_write_timeout(const uint32_t timeout) override;
 
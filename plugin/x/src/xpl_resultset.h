@@ -59,6 +59,29 @@ class Process_resultset : public iface::Resultset {
   Callback_command_delegate m_callback_delegate;
 };
 
+/** Takes the server's statement id from the result of COM_STMT_PREPARE */
+class Prepare_resultset : public Process_resultset {
+ public:
+  Prepare_resultset() = default;
+  uint32_t get_stmt_id() const { return m_stmt_id; }
+
+ protected:
+  Row *start_row() override {
+    m_row.clear();
+    return &m_row;
+  }
+
+  bool end_row(Row *row) override {
+    if (row->fields.empty()) return false;
+    m_stmt_id = row->fields[0]->value.v_long;
+    return true;
+  }
+
+ private:
+  Row m_row;
+  uint32_t m_stmt_id{0};
+};
+
 class Empty_resultset : public iface::Resultset {
  public:
   Empty_resultset() : m_callback_delegate() {}
@@ -466,6 +466,8 @@ ClusterMetadata::ReplicaSetsByName GRClusterMetadata::fetch_instances(
     log_warning("No replicasets defined for cluster '%s'",
                 cluster_name.c_str());
 
+  metadata_topology_ = replicasets;
+
   // now connect to each replicaset and query it for the list and status of its
   // members. (more precisely, foreach replicaset: search and connect to a
   // member which is part of quorum to retrieve this data)
@@ -477,6 +479,18 @@ ClusterMetadata::ReplicaSetsByName GRClusterMetadata::fetch_instances(
   return replicasets;
 }
 
+ClusterMetadata::ReplicaSetsByName
+GRClusterMetadata::fetch_instances_status() {
+  ReplicaSetsByName replicasets(metadata_topology_);
+
+  for (auto &&rs : replicasets) {
+    update_replicaset_status(
+        rs.first, rs.second);  // throws metadata_cache::metadata_error
+  }
+
+  return replicasets;
+}
+
 // throws metadata_cache::metadata_error
 ClusterMetadata::ReplicaSetsByName
 GRMetadataBackendV1::fetch_instances_from_metadata_server(
@@ -92,6 +92,19 @@ class METADATA_API GRClusterMetadata : public ClusterMetadata {
     throw std::logic_error("Call to unexpected fetch_instances overload");
   }
 
+  /** @brief Returns replicasets with the status refreshed from GR
+   *
+   * Reuses the topology that the last fetch_instances() read from the
+   * metadata and only queries the GR performance_schema tables for the
+   * current state of its members. Used when a GR notification signals a
+   * membership change that does not affect the configured topology.
+   *
+   * @return Map of replicaset ID, server list pairs, empty if there is no
+   * topology from a previous fetch_instances() call.
+   * @throws metadata_cache::metadata_error
+   */
+  ReplicaSetsByName fetch_instances_status() override;
+
   /** @brief Initializes the notifications listener thread (if a given cluster
    * type supports it)
    *
@@ -164,6 +177,9 @@ class METADATA_API GRClusterMetadata : public ClusterMetadata {
 
   std::unique_ptr<GRNotificationListener> gr_notifications_listener_;
 
+  // topology read from the metadata by the last fetch_instances() call
+  ReplicaSetsByName metadata_topology_;
+
 #ifdef FRIEND_TEST
   FRIEND_TEST(MetadataTest, FetchInstancesFromMetadataServer);
   FRIEND_TEST(MetadataTest,
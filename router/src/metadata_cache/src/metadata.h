@@ -61,6 +61,11 @@ class METADATA_API MetaData {
       const std::string &cluster_type_specific_id,
       std::size_t &instance_id) = 0;
 
+  // refresh only the live status of the instances returned by the last
+  // fetch_instances() call, without querying the metadata again. Returns an
+  // empty map if the cluster type does not support it.
+  virtual ReplicaSetsByName fetch_instances_status() { return {}; }
+
   virtual bool update_router_version(
       const metadata_cache::ManagedInstance &rw_instance,
       const unsigned router_id) = 0;
@@ -120,6 +120,7 @@ void MetadataCache::refresh_thread() {
       log_info("Failed refreshing metadata: %s", e.what());
       on_refresh_failed(true);
     }
+    gr_status_refresh_only_ = false;
 
     if (refresh_ok) {
       if (!ready_announced_) {
@@ -184,8 +185,10 @@ void MetadataCache::refresh_thread() {
         // were outside of the wait_for
         if (terminated_) return;
         if (refresh_requested_) {
-          auth_cache_force_update = true;
+          if (!gr_status_refresh_requested_) auth_cache_force_update = true;
+          gr_status_refresh_only_ = gr_status_refresh_requested_;
           refresh_requested_ = false;
+          gr_status_refresh_requested_ = false;
           break;  // go to the refresh() in the outer loop
         }
 
@@ -207,8 +210,10 @@ void MetadataCache::refresh_thread() {
         }
         if (terminated_) return;
         if (refresh_requested_) {
-          auth_cache_force_update = true;
+          if (!gr_status_refresh_requested_) auth_cache_force_update = true;
+          gr_status_refresh_only_ = gr_status_refresh_requested_;
           refresh_requested_ = false;
+          gr_status_refresh_requested_ = false;
           break;  // go to the refresh() in the outer loop
         }
       }
@@ -415,7 +420,7 @@ void MetadataCache::on_instances_changed(const bool md_servers_reachable,
 
   if (use_cluster_notifications_) {
     meta_data_->setup_notifications_listener(
-        instances, [this]() { on_refresh_requested(); });
+        instances, [this]() { on_gr_notification(); });
   }
 }
 
@@ -442,6 +447,17 @@ void MetadataCache::on_refresh_requested() {
   {
     std::unique_lock<std::mutex> lock(refresh_wait_mtx_);
     refresh_requested_ = true;
+    gr_status_refresh_requested_ = false;
+  }
+  refresh_wait_.notify_one();
+}
+
+void MetadataCache::on_gr_notification() {
+  {
+    std::unique_lock<std::mutex> lock(refresh_wait_mtx_);
+    // a full refresh that is already pending covers the GR status as well
+    if (!refresh_requested_) gr_status_refresh_requested_ = true;
+    refresh_requested_ = true;
   }
   refresh_wait_.notify_one();
 }
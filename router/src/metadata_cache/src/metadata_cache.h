@@ -265,6 +265,10 @@ class METADATA_API MetadataCache
   // Called each time we were requested to refresh the metadata
   void on_refresh_requested();
 
+  // Called each time a GR notification was received; unless a full refresh
+  // is already pending only the GR status of the known members is refreshed
+  void on_gr_notification();
+
   // Called each time the metadata refresh completed execution
   void on_refresh_completed();
 
@@ -344,6 +348,13 @@ class METADATA_API MetadataCache
 
   bool refresh_requested_{false};
 
+  // set when the pending refresh was triggered by GR notifications only
+  bool gr_status_refresh_requested_{false};
+
+  // true while refresh() runs on behalf of a GR notification: the topology
+  // stored in the metadata has not changed, only the members' GR state
+  bool gr_status_refresh_only_{false};
+
   bool use_cluster_notifications_;
 
   std::condition_variable refresh_wait_;
@@ -526,9 +526,20 @@ bool GRMetadataCache::fetch_metadata_from_connected_instance(
     const metadata_cache::ManagedInstance &instance, bool &changed) {
   try {
     changed = false;
+    // A GR notification only tells us that the state of the group changed,
+    // the topology stored in the metadata stays the same. Skip querying the
+    // metadata in that case and only refresh the members' status; the TTL
+    // driven refresh reconciles the topology.
+    MetaData::ReplicaSetsByName replicaset_data_temp;
+    if (gr_status_refresh_only_) {
+      replicaset_data_temp = meta_data_->fetch_instances_status();
+    }
+
     // Fetch the metadata and store it in a temporary variable.
-    auto replicaset_data_temp =
-        meta_data_->fetch_instances(cluster_name_, cluster_type_specific_id_);
+    if (replicaset_data_temp.empty()) {
+      replicaset_data_temp =
+          meta_data_->fetch_instances(cluster_name_, cluster_type_specific_id_);
+    }
 
     // this node no longer contains metadata for our cluster, check the next
     // node (if available)
@@ -158,6 +158,17 @@ bool MySQLServerMockSessionClassic::process_statements() {
           classic_protocol::message::client::Quit>::cmd_byte():
         log_info("received QUIT command from the client");
         return true;
+      case classic_protocol::Codec<
+          classic_protocol::message::client::InitSchema>::cmd_byte():
+      case classic_protocol::Codec<
+          classic_protocol::message::client::ResetConnection>::cmd_byte():
+      case classic_protocol::Codec<
+          classic_protocol::message::client::Ping>::cmd_byte():
+        // pooled clients switch schema, reset and ping their connections;
+        // accept them as a server would.
+        std::this_thread::sleep_for(json_reader_->get_default_exec_time());
+        protocol_->send_ok();
+        break;
       default:
         log_info("received unsupported command from the client: %d", cmd);
         std::this_thread::sleep_for(json_reader_->get_default_exec_time());
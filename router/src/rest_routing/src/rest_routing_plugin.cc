@@ -184,6 +184,9 @@ static const std::array<JsonPointer::Token, 2> routes_status_def_tokens{
 static const std::array<JsonPointer::Token, 2> routes_health_def_tokens{
     {STR("definitions"), STR("RouteHealth")}};
 
+static const std::array<JsonPointer::Token, 2> routes_latency_def_tokens{
+    {STR("definitions"), STR("RouteLatency")}};
+
 static const std::array<JsonPointer::Token, 2> routes_status_path_tokens{
     {STR("paths"), STR("/routes/{routeName}/status")}};
 
@@ -270,6 +273,39 @@ static void spec_adder(RestApiComponent::JsonDocument &spec_doc) {
   std::string routes_health_def_ptr_str =
       json_pointer_stringfy(routes_health_def_ptr);
 
+  // /definitions/RouteLatency
+  const RestApiComponent::JsonPointer routes_latency_def_ptr(
+      routes_latency_def_tokens.data(), routes_latency_def_tokens.size());
+
+  routes_latency_def_ptr.Set(
+      spec_doc,
+      JsonValue(rapidjson::kObjectType)
+          .AddMember("type", "object", allocator)
+          .AddMember(
+              "properties",
+              JsonValue(rapidjson::kObjectType)
+                  .AddMember("count",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("p50",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("p90",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("p99",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator),
+              allocator),
+      allocator);
+
+  std::string routes_latency_def_ptr_str =
+      json_pointer_stringfy(routes_latency_def_ptr);
+
   // /definitions/RoutesStatus
   const RestApiComponent::JsonPointer routes_status_def_ptr(
       routes_status_def_tokens.data(), routes_status_def_tokens.size());
@@ -292,6 +328,42 @@ static void spec_adder(RestApiComponent::JsonDocument &spec_doc) {
                   .AddMember("blockedHosts",
                              JsonValue(rapidjson::kObjectType)
                                  .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("statements",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("replicaEligibleStatements",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("bytesToServer",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("bytesFromServer",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember("type", "integer", allocator),
+                             allocator)
+                  .AddMember("connectLatency",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember(
+                                     "$ref",
+                                     JsonValue(
+                                         routes_latency_def_ptr_str.data(),
+                                         routes_latency_def_ptr_str.size(),
+                                         allocator),
+                                     allocator),
+                             allocator)
+                  .AddMember("firstByteLatency",
+                             JsonValue(rapidjson::kObjectType)
+                                 .AddMember(
+                                     "$ref",
+                                     JsonValue(
+                                         routes_latency_def_ptr_str.data(),
+                                         routes_latency_def_ptr_str.size(),
+                                         allocator),
+                                     allocator),
                              allocator),
               allocator),
       allocator);
@@ -40,6 +40,22 @@
 
 constexpr const char RestRoutingStatus::path_regex[];
 
+/**
+ * latency summary as JSON object, latencies in microseconds.
+ */
+static rapidjson::Value latency_summary_to_json(
+    const MySQLRoutingAPI::LatencySummary &summary,
+    rapidjson::Document::AllocatorType &allocator) {
+  rapidjson::Value o(rapidjson::kObjectType);
+
+  o.AddMember<uint64_t>("count", summary.count, allocator)
+      .AddMember<uint64_t>("p50", summary.p50.count(), allocator)
+      .AddMember<uint64_t>("p90", summary.p90.count(), allocator)
+      .AddMember<uint64_t>("p99", summary.p99.count(), allocator);
+
+  return o;
+}
+
 bool RestRoutingStatus::on_handle_request(
     HttpRequest &req, const std::string & /* base_path */,
     const std::vector<std::string> &path_matches) {
@@ -73,7 +89,22 @@ bool RestRoutingStatus::on_handle_request(
                    allocator)
         .AddMember("totalConnections", inst.get_total_connections(), allocator)
         .AddMember<uint64_t>("blockedHosts",
-                             inst.get_blocked_client_hosts().size(), allocator);
+                             inst.get_blocked_client_hosts().size(), allocator)
+        .AddMember<uint64_t>("statements", inst.get_statements(), allocator)
+        .AddMember<uint64_t>("replicaEligibleStatements",
+                             inst.get_replica_eligible_statements(), allocator)
+        .AddMember<uint64_t>("bytesToServer", inst.get_bytes_to_server(),
+                             allocator)
+        .AddMember<uint64_t>("bytesFromServer", inst.get_bytes_from_server(),
+                             allocator)
+        .AddMember("connectLatency",
+                   latency_summary_to_json(inst.get_connect_latency(),
+                                           allocator),
+                   allocator)
+        .AddMember("firstByteLatency",
+                   latency_summary_to_json(inst.get_first_byte_latency(),
+                                           allocator),
+                   allocator);
   }
   send_json_document(req, HttpStatusCode::Ok, json_doc);
 
@@ -25,7 +25,9 @@
 #ifndef MYSQLROUTER_DESTINATION_INCLUDED
 #define MYSQLROUTER_DESTINATION_INCLUDED
 
+#include <chrono>        // steady_clock
 #include <cstddef>       // uint16_t
+#include <functional>    // function
 #include <list>          // list
 #include <memory>        // unique_ptr
 #include <string>        // string
@@ -78,6 +80,21 @@ class Destination {
    */
   virtual void connect_status(std::error_code /* ec */) {}
 
+  /**
+   * a connection to the destination got established.
+   *
+   * called by MySQLRouting after connect() succeeded.
+   *
+   * @param connect_duration time it took to connect()
+   *
+   * @returns callback that is called when the connection is closed, or an
+   * empty function.
+   */
+  virtual std::function<void()> connected(
+      std::chrono::steady_clock::duration /* connect_duration */) {
+    return {};
+  }
+
  private:
   const std::string id_;
   const std::string hostname_;
@@ -41,6 +41,9 @@ extern const int kDefaultWaitTimeout;
 /** @brief Max number of active routes for this routing instance */
 extern const int kDefaultMaxConnections;
 
+/** @brief Max number of clients waiting for a free route (0 disables) */
+extern const int kDefaultMaxQueuedConnections;
+
 /** @brief Timeout connecting to destination (in seconds)
  *
  * Constant defining how long we wait to establish connection with the server
@@ -101,6 +104,8 @@ enum class RoutingStrategy {
   kNextAvailable = 2,
   kRoundRobin = 3,
   kRoundRobinWithFallback = 4,
+  kLeastConnections = 5,
+  kEwmaLatency = 6,
 };
 
 /** @brief Get comma separated list of all access mode names
@@ -88,6 +88,27 @@ class ROUTING_EXPORT MySQLRoutingAPI {
   int get_active_connections() const;
   int get_total_connections() const;
 
+  // statements seen with classify_statements=1
+  uint64_t get_statements() const;
+  uint64_t get_replica_eligible_statements() const;
+
+  // bytes forwarded between clients and destinations
+  uint64_t get_bytes_to_server() const;
+  uint64_t get_bytes_from_server() const;
+
+  struct LatencySummary {
+    uint64_t count;
+
+    std::chrono::microseconds p50;
+    std::chrono::microseconds p90;
+    std::chrono::microseconds p99;
+  };
+
+  // time to connect to a destination
+  LatencySummary get_connect_latency() const;
+  // time from connecting to a destination until its first bytes arrived
+  LatencySummary get_first_byte_latency() const;
+
   std::vector<mysql_harness::TCPAddress> get_destinations() const;
 
   bool is_accepting_connections() const;
@@ -254,6 +254,19 @@ class Channel {
    */
   bool is_tls() const { return is_tls_; }
 
+  /**
+   * mark that a TLS application-data record was received on the channel.
+   *
+   * Once it is seen, the TLS handshake of a passthrough connection is
+   * finished and the channel carries opaque data only.
+   */
+  void tls_app_data_seen(bool v) { tls_app_data_seen_ = v; }
+
+  /**
+   * check if a TLS application-data record was received on the channel.
+   */
+  bool tls_app_data_seen() const { return tls_app_data_seen_; }
+
   /**
    * get access to the raw SSL handle.
    *
@@ -274,6 +287,7 @@ class Channel {
   std::vector<uint8_t> send_buffer_;
 
   bool is_tls_{false};
+  bool tls_app_data_seen_{false};
 
   class Deleter_SSL {
    public:
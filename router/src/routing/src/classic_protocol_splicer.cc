@@ -24,6 +24,10 @@
 
 #include "classic_protocol_splicer.h"
 
+#include <algorithm>     // transform
+#include <cctype>        // toupper
+#include <cstring>       // strlen
+#include <string>
 #include <system_error>  // error_code
 
 #include <openssl/ssl.h>  // SSL_get_version
@@ -955,6 +959,11 @@ BasicSplicer::State ClassicProtocolSplicer::splice_int(
         return State::FINISH;
       }
 
+      if (static_cast<TlsContentType>(tls_content_type) ==
+          TlsContentType::kApplication) {
+        src_channel->tls_app_data_seen(true);
+      }
+
       // if TlsAlert in handshake, the connection goes back to plain
       if (static_cast<TlsContentType>(tls_content_type) ==
               TlsContentType::kAlert &&
@@ -995,6 +1004,11 @@ BasicSplicer::State ClassicProtocolSplicer::splice_int(
         return state();
       }
 
+      if (on_statement_) {
+        track_statement(plain, header_size, payload_size,
+                        src_channel == client_channel());
+      }
+
       src_protocol->seq_id(seq_id);
 
       // if one side starts a new command, reset the sequence-id for the other
@@ -1064,6 +1078,108 @@ BasicSplicer::State ClassicProtocolSplicer::splice_int(
   return state();
 }
 
+bool ClassicProtocolSplicer::is_read_only_statement(const std::string &stmt) {
+  std::string upper(stmt);
+  std::transform(upper.begin(), upper.end(), upper.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+
+  // skip leading whitespace and comments.
+  size_t pos = 0;
+  while (pos < upper.size()) {
+    if (std::isspace(static_cast<unsigned char>(upper[pos]))) {
+      ++pos;
+    } else if (upper.compare(pos, 3, "/*!") == 0 ||
+               upper.compare(pos, 3, "/*+") == 0) {
+      // executable comments and hints may contain anything.
+      return false;
+    } else if (upper.compare(pos, 2, "/*") == 0) {
+      const auto end = upper.find("*/", pos + 2);
+      if (end == std::string::npos) return false;
+      pos = end + 2;
+    } else if (upper[pos] == '#' || upper.compare(pos, 3, "-- ") == 0) {
+      const auto end = upper.find('\n', pos);
+      if (end == std::string::npos) return false;
+      pos = end + 1;
+    } else {
+      break;
+    }
+  }
+
+  const auto starts_with = [&upper, pos](const char *keyword) {
+    const size_t len = strlen(keyword);
+    return upper.compare(pos, len, keyword) == 0 &&
+           (pos + len == upper.size() ||
+            !std::isalnum(static_cast<unsigned char>(upper[pos + len])));
+  };
+
+  if (starts_with("SHOW") || starts_with("DESC") || starts_with("DESCRIBE") ||
+      starts_with("EXPLAIN")) {
+    return true;
+  }
+
+  if (!starts_with("SELECT")) return false;
+
+  for (const char *needle :
+       {" FOR UPDATE", " FOR SHARE", " LOCK IN SHARE MODE", " INTO ", "@",
+        "GET_LOCK", "RELEASE_LOCK", "IS_USED_LOCK", "IS_FREE_LOCK",
+        "LAST_INSERT_ID", "FOUND_ROWS", "ROW_COUNT", "NEXTVAL", "SLEEP"}) {
+    if (upper.find(needle, pos) != std::string::npos) return false;
+  }
+
+  return true;
+}
+
+void ClassicProtocolSplicer::track_statement(const std::vector<uint8_t> &frame,
+                                             size_t header_size,
+                                             size_t payload_size,
+                                             bool from_client) {
+  if (payload_size == 0) return;
+
+  const uint8_t *payload = frame.data() + header_size;
+  const uint8_t seq_id = frame[3];
+
+  if (from_client) {
+    // a new command starts with seq-id 0.
+    if (seq_id != 0) return;
+
+    waiting_query_response_ =
+        payload[0] ==
+        classic_protocol::Codec<classic_protocol::message::client::Query>::
+            cmd_byte();
+    if (!waiting_query_response_) return;
+
+    const std::string stmt(payload + 1, payload + payload_size);
+
+    on_statement_(autocommit_idle_ && is_read_only_statement(stmt));
+
+    return;
+  }
+
+  // the first frame of the response to a COM_QUERY is either an OK, an Error,
+  // a LOCAL INFILE request or the start of a resultset. Only the OK carries
+  // the status-flags.
+  if (!waiting_query_response_ || seq_id != 1) return;
+  waiting_query_response_ = false;
+
+  if (payload[0] !=
+      classic_protocol::Codec<classic_protocol::message::server::Ok>::
+          cmd_byte()) {
+    return;
+  }
+
+  const auto decode_res =
+      classic_protocol::decode<classic_protocol::message::server::Ok>(
+          net::buffer(payload, payload_size),
+          client_protocol()->shared_capabilities());
+  if (!decode_res) return;
+
+  const auto status_flags = decode_res->second.status_flags();
+
+  autocommit_idle_ =
+      (status_flags & classic_protocol::status::autocommit).any() &&
+      (status_flags & classic_protocol::status::in_transaction).none();
+}
+
 stdx::expected<size_t, std::error_code>
 ClassicProtocolSplicer::on_block_client_host(std::vector<uint8_t> &buf) {
   // the client didn't send a Greeting before closing the connection.
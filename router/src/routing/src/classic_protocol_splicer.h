@@ -92,12 +92,50 @@ class ClassicProtocolSplicer : public BasicSplicer {
     return server_protocol_.get();
   }
 
+  /**
+   * callback for each COM_QUERY the client sends.
+   *
+   * @param replica_eligible true if the statement only reads and the session
+   * is in autocommit mode outside of a transaction.
+   */
+  using statement_callback_type = std::function<void(bool replica_eligible)>;
+
+  /**
+   * inspect statements and transaction state of the connection.
+   *
+   * Only possible if the router sees the plaintext of the connection, which
+   * excludes PASSTHROUGH.
+   */
+  void on_statement(statement_callback_type cb) {
+    on_statement_ = std::move(cb);
+  }
+
+  /**
+   * check if a statement only reads data and doesn't depend on session state.
+   *
+   * SELECT, SHOW, DESCRIBE and EXPLAIN are read-only unless they lock rows,
+   * write INTO something or touch user-variables or locks.
+   */
+  static bool is_read_only_statement(const std::string &stmt);
+
  private:
+  void track_statement(const std::vector<uint8_t> &frame, size_t header_size,
+                       size_t payload_size, bool from_client);
+
   State splice_int(Channel *src_channel, ClassicProtocolState *src_protocol,
                    Channel *dst_channel, ClassicProtocolState *dst_protocol);
 
   std::unique_ptr<ClassicProtocolState> client_protocol_;
   std::unique_ptr<ClassicProtocolState> server_protocol_;
+
+  statement_callback_type on_statement_;
+
+  // a COM_QUERY was sent and the first frame of its response is expected.
+  bool waiting_query_response_{false};
+
+  // session is in autocommit mode and no transaction is open, as reported by
+  // the last OK packet.
+  bool autocommit_idle_{true};
 };
 
 #endif
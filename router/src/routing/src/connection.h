@@ -112,14 +112,26 @@ class MySQLRoutingConnectionBase {
       stats.last_sent_to_server = now;
       stats.bytes_down += bytes;
     });
+    context_.transfered_to_server(bytes);
   }
 
   void transfered_to_client(size_t bytes) {
     const auto now = clock_type::now();
-    stats_([bytes, now](Stats &stats) {
+    const auto first_byte_latency = stats_([bytes, now](Stats &stats) {
+      const bool is_first =
+          stats.last_received_from_server == time_point_type{} &&
+          stats.connected_to_server != time_point_type{};
+
       stats.last_received_from_server = now;
       stats.bytes_up += bytes;
+
+      return is_first ? now - stats.connected_to_server
+                      : clock_type::duration::max();
     });
+    if (first_byte_latency != clock_type::duration::max()) {
+      context_.first_byte_latency().add(first_byte_latency);
+    }
+    context_.transfered_to_client(bytes);
   }
 
   void disassociate() { remove_callback_(this); }
@@ -166,6 +178,7 @@ class MySQLRoutingConnection : public MySQLRoutingConnectionBase {
    * @param remove_callback called when thread finishes its execution to
    * remove associated MySQLRoutingConnection from container. It must be
    * called at the very end of thread execution
+   * @param on_close called when the connection is destroyed
    */
   MySQLRoutingConnection(
       MySQLRoutingContext &context, std::string destination_id,
@@ -173,13 +186,19 @@ class MySQLRoutingConnection : public MySQLRoutingConnectionBase {
       typename ClientProtocol::endpoint client_endpoint,
       typename ServerProtocol::socket server_socket,
       typename ServerProtocol::endpoint server_endpoint,
-      std::function<void(MySQLRoutingConnectionBase *)> remove_callback)
+      std::function<void(MySQLRoutingConnectionBase *)> remove_callback,
+      std::function<void()> on_close = {})
       : MySQLRoutingConnectionBase{context, remove_callback},
         destination_id_{std::move(destination_id)},
         client_socket_{std::move(client_socket)},
         client_endpoint_{std::move(client_endpoint)},
         server_socket_{std::move(server_socket)},
-        server_endpoint_{std::move(server_endpoint)} {}
+        server_endpoint_{std::move(server_endpoint)},
+        on_close_{std::move(on_close)} {}
+
+  ~MySQLRoutingConnection() override {
+    if (on_close_) on_close_();
+  }
 
   std::string get_destination_id() const override { return destination_id_; }
 
@@ -242,6 +261,8 @@ class MySQLRoutingConnection : public MySQLRoutingConnectionBase {
 
   typename server_protocol_type::socket server_socket_;
   typename server_protocol_type::endpoint server_endpoint_;
+
+  std::function<void()> on_close_;
 };
 
 #endif /* ROUTING_CONNECTION_INCLUDED */
@@ -152,6 +152,45 @@ void MySQLRoutingContext::increase_info_active_routes() {
 
 void MySQLRoutingContext::decrease_info_active_routes() {
   --info_active_routes_;
+
+  // the route we just released is handed to the longest waiting client
+  start_queued_connection();
+}
+
+bool MySQLRoutingContext::start_queued_connection() {
+  std::function<void()> next;
+  {
+    std::lock_guard<std::mutex> lk(mutex_queued_connections_);
+    if (queued_connections_.empty()) return false;
+
+    next = std::move(queued_connections_.front());
+    queued_connections_.pop_front();
+  }
+
+  next();
+  return true;
+}
+
+bool MySQLRoutingContext::queue_connection(std::function<void()> start) {
+  std::lock_guard<std::mutex> lk(mutex_queued_connections_);
+  if (queued_connections_.size() >= max_queued_connections_) return false;
+
+  queued_connections_.push_back(std::move(start));
+  return true;
+}
+
+bool MySQLRoutingContext::has_queued_connections() const {
+  std::lock_guard<std::mutex> lk(mutex_queued_connections_);
+  return !queued_connections_.empty();
+}
+
+void MySQLRoutingContext::clear_queued_connections() {
+  std::deque<std::function<void()>> dropped;
+  {
+    std::lock_guard<std::mutex> lk(mutex_queued_connections_);
+    dropped.swap(queued_connections_);
+  }
+  // the sockets owned by the dropped closures are closed outside the lock
 }
 
 void MySQLRoutingContext::increase_info_handled_routes() {
@@ -28,6 +28,8 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -35,6 +37,7 @@
 #include <vector>
 
 #include "destination_ssl_context.h"
+#include "latency_histogram.h"
 #include "mysql/harness/filesystem.h"  // Path
 #include "mysql/harness/net_ts/internet.h"
 #include "mysql/harness/tls_context.h"
@@ -120,6 +123,69 @@ class MySQLRoutingContext {
   void decrease_info_active_routes();
   void increase_info_handled_routes();
 
+  /** @brief Parks a client that arrived while max_connections was reached
+   *
+   * The client is started once an active route finishes. Queued clients are
+   * started in the order they arrived.
+   *
+   * @param start function that starts routing the parked client
+   * @return false if the queue is full (or disabled) and the client has to be
+   * rejected
+   */
+  bool queue_connection(std::function<void()> start);
+
+  /** @brief Starts the longest waiting client, if any
+   *
+   * @return true if a queued client was started
+   */
+  bool start_queued_connection();
+
+  /** @brief Returns true if clients are waiting for a free route */
+  bool has_queued_connections() const;
+
+  /** @brief Drops all waiting clients, closing their sockets */
+  void clear_queued_connections();
+
+  void set_max_queued_connections(size_t max_queued) {
+    max_queued_connections_ = max_queued;
+  }
+  size_t get_max_queued_connections() const { return max_queued_connections_; }
+
+  /** @brief Counts a statement seen by the classic protocol splicer
+   *
+   * @param replica_eligible true if the statement only reads and runs outside
+   * of a transaction
+   */
+  void statement_classified(bool replica_eligible) {
+    ++info_statements_;
+    if (replica_eligible) ++info_replica_eligible_statements_;
+  }
+
+  void set_classify_statements(bool v) { classify_statements_ = v; }
+  bool get_classify_statements() const { return classify_statements_; }
+
+  uint64_t get_statements() const { return info_statements_; }
+  uint64_t get_replica_eligible_statements() const {
+    return info_replica_eligible_statements_;
+  }
+
+  /** @brief Time it took to connect to a destination */
+  LatencyHistogram &connect_latency() { return connect_latency_; }
+  const LatencyHistogram &connect_latency() const { return connect_latency_; }
+
+  /** @brief Time from connecting to a destination until its first bytes were
+   * forwarded to the client */
+  LatencyHistogram &first_byte_latency() { return first_byte_latency_; }
+  const LatencyHistogram &first_byte_latency() const {
+    return first_byte_latency_;
+  }
+
+  void transfered_to_server(size_t bytes) { info_bytes_to_server_ += bytes; }
+  void transfered_to_client(size_t bytes) { info_bytes_from_server_ += bytes; }
+
+  uint64_t get_bytes_to_server() const { return info_bytes_to_server_; }
+  uint64_t get_bytes_from_server() const { return info_bytes_from_server_; }
+
   uint16_t get_active_routes() { return info_active_routes_; }
   uint64_t get_handled_routes() { return info_handled_routes_; }
   uint64_t get_max_connect_errors() { return max_connect_errors_; }
@@ -209,6 +275,14 @@ class MySQLRoutingContext {
   SslMode server_ssl_mode_{SslMode::kPreferred};
   DestinationTlsContext *destination_tls_context_{};
 
+  /** @brief Clients waiting for an active route to finish */
+  std::deque<std::function<void()>> queued_connections_;
+  mutable std::mutex mutex_queued_connections_;
+  size_t max_queued_connections_{0};
+
+  /** @brief Whether the classic protocol splicer classifies statements */
+  bool classify_statements_{false};
+
  public:
   /** @brief Connection error counters for IPv4 hosts */
   std::map<net::ip::address_v4, size_t> conn_error_counters_v4_;
@@ -223,5 +297,16 @@ class MySQLRoutingContext {
   std::atomic<uint16_t> info_active_routes_{0};
   /** @brief Number of handled routes, not used at the moment */
   std::atomic<uint64_t> info_handled_routes_{0};
+  /** @brief Number of classified statements */
+  std::atomic<uint64_t> info_statements_{0};
+  /** @brief Number of statements that a replica could have executed */
+  std::atomic<uint64_t> info_replica_eligible_statements_{0};
+  /** @brief Bytes forwarded from clients to destinations */
+  std::atomic<uint64_t> info_bytes_to_server_{0};
+  /** @brief Bytes forwarded from destinations to clients */
+  std::atomic<uint64_t> info_bytes_from_server_{0};
+
+  LatencyHistogram connect_latency_;
+  LatencyHistogram first_byte_latency_;
 };
 #endif /* ROUTING_CONTEXT_INCLUDED */
@@ -0,0 +1,152 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "dest_least_loaded.h"
+
+#include <algorithm>  // stable_sort
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class LoadTrackingDestination : public Destination {
+ public:
+  LoadTrackingDestination(std::string id, std::string host, uint16_t port,
+                          DestLeastLoaded *balancer, size_t ndx,
+                          std::shared_ptr<DestLeastLoaded::Load> load)
+      : Destination(std::move(id), std::move(host), port),
+        balancer_{balancer},
+        ndx_{ndx},
+        load_{std::move(load)} {}
+
+  void connect_status(std::error_code ec) override {
+    if (ec != std::error_code()) {
+      balancer_->add_to_quarantine(ndx_);
+    }
+  }
+
+  bool good() const override { return !balancer_->is_quarantined(ndx_); }
+
+  std::function<void()> connected(
+      std::chrono::steady_clock::duration connect_duration) override {
+    DestLeastLoaded::add_connect_latency(
+        *load_, std::chrono::duration_cast<std::chrono::microseconds>(
+                    connect_duration));
+
+    ++load_->active;
+
+    // the load outlives the balancer if connections are still open when
+    // the route is stopped.
+    return [load = load_]() { --load->active; };
+  }
+
+ private:
+  DestLeastLoaded *balancer_;
+  size_t ndx_;
+  std::shared_ptr<DestLeastLoaded::Load> load_;
+};
+
+void DestLeastLoaded::add_connect_latency(Load &load,
+                                          std::chrono::microseconds latency) {
+  const uint64_t sample = std::max<int64_t>(latency.count(), 1);
+  const uint64_t avg = load.connect_latency_us.load(std::memory_order_relaxed);
+
+  // concurrent updates may lose a sample, which is fine for an average.
+  load.connect_latency_us.store(
+      avg == 0 ? sample
+               : (avg * (100 - kEwmaWeightPercent) +
+                  sample * kEwmaWeightPercent) /
+                     100,
+      std::memory_order_relaxed);
+}
+
+std::shared_ptr<DestLeastLoaded::Load> DestLeastLoaded::load(
+    const std::string &id) {
+  std::lock_guard<std::mutex> lk(mutex_update_);
+
+  auto &load = loads_[id];
+  if (!load) load = std::make_shared<Load>();
+
+  return load;
+}
+
+uint64_t DestLeastLoaded::score(const Load &load) const {
+  const uint64_t active = load.active.load(std::memory_order_relaxed);
+
+  if (strategy_ == routing::RoutingStrategy::kEwmaLatency) {
+    // unmeasured destinations score 0 and get probed first.
+    return load.connect_latency_us.load(std::memory_order_relaxed) *
+           (active + 1);
+  }
+
+  return active;
+}
+
+Destinations DestLeastLoaded::destinations() {
+  struct Candidate {
+    size_t ndx;
+    uint64_t score;
+    std::shared_ptr<Load> load;
+  };
+
+  Destinations dests;
+
+  std::lock_guard<std::mutex> lk(mutex_update_);
+
+  const auto sz = destinations_.size();
+  if (sz == 0) return dests;
+
+  std::vector<Candidate> candidates;
+  candidates.reserve(sz);
+
+  // start at a rotating position to spread connections over destinations
+  // with the same score.
+  for (size_t i = 0; i < sz; ++i) {
+    const size_t ndx = (start_pos_ + i) % sz;
+    const auto &dest = destinations_[ndx];
+
+    auto &load = loads_[dest.str()];
+    if (!load) load = std::make_shared<Load>();
+
+    candidates.push_back({ndx, score(*load), load});
+  }
+
+  if (++start_pos_ >= sz) start_pos_ = 0;
+
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate &a, const Candidate &b) {
+                     return a.score < b.score;
+                   });
+
+  for (auto &candidate : candidates) {
+    const auto &dest = destinations_[candidate.ndx];
+
+    dests.push_back(std::make_unique<LoadTrackingDestination>(
+        dest.str(), dest.address(), dest.port(), this, candidate.ndx,
+        std::move(candidate.load)));
+  }
+
+  return dests;
+}
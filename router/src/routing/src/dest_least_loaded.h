@@ -0,0 +1,116 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#ifndef ROUTING_DEST_LEAST_LOADED_INCLUDED
+#define ROUTING_DEST_LEAST_LOADED_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "dest_round_robin.h"
+#include "mysqlrouter/routing.h"
+
+class LoadTrackingDestination;
+
+/**
+ * route to the destination with the least load.
+ *
+ * Destinations are ordered by:
+ *
+ * least-connections
+ * :  the number of connections currently routed to the destination.
+ *
+ * ewma-latency
+ * :  the moving average of the time it took to connect to the destination,
+ *    weighted by the number of connections currently routed to it.
+ *
+ * Destinations with the same load are taken in round-robin order. Failing
+ * destinations are quarantined like with round-robin.
+ */
+class DestLeastLoaded : public DestRoundRobin {
+ public:
+  /**
+   * load of a destination.
+   *
+   * shared with the connections routed to the destination, which release
+   * it when they close.
+   */
+  struct Load {
+    /** connections currently routed to the destination. */
+    std::atomic<uint32_t> active{0};
+
+    /** moving average of the connect time in microseconds; 0 if unknown. */
+    std::atomic<uint64_t> connect_latency_us{0};
+  };
+
+  /**
+   * @param io_ctx context for io operations
+   * @param strategy kLeastConnections or kEwmaLatency
+   * @param protocol Protocol for the destination
+   * @param thread_stack_size memory in kilobytes allocated for thread's stack
+   */
+  DestLeastLoaded(
+      net::io_context &io_ctx, routing::RoutingStrategy strategy,
+      Protocol::Type protocol = Protocol::get_default(),
+      size_t thread_stack_size = mysql_harness::kDefaultStackSizeInKiloBytes)
+      : DestRoundRobin(io_ctx, protocol, thread_stack_size),
+        strategy_{strategy} {}
+
+  Destinations destinations() override;
+
+  /**
+   * load of a destination.
+   *
+   * @param id id of the destination as returned by Destination::id()
+   */
+  std::shared_ptr<Load> load(const std::string &id);
+
+  /**
+   * weight of the connect time of a new connection in the moving average.
+   */
+  static constexpr uint64_t kEwmaWeightPercent = 30;
+
+  /**
+   * fold a connect time into the moving average of a destination.
+   */
+  static void add_connect_latency(Load &load,
+                                  std::chrono::microseconds latency);
+
+  friend LoadTrackingDestination;
+
+ private:
+  uint64_t score(const Load &load) const;
+
+  const routing::RoutingStrategy strategy_;
+
+  // MUST take the RouteDestination Mutex
+  std::map<std::string, std::shared_ptr<Load>> loads_;
+};
+
+#endif  // ROUTING_DEST_LEAST_LOADED_INCLUDED
@@ -568,6 +568,8 @@ Destinations DestMetadataCacheGroup::balance(
       break;
     }
     case routing::RoutingStrategy::kNextAvailable:
+    case routing::RoutingStrategy::kLeastConnections:
+    case routing::RoutingStrategy::kEwmaLatency:
     case routing::RoutingStrategy::kUndefined:
       assert(0);
       break;
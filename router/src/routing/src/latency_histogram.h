@@ -0,0 +1,133 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef ROUTING_LATENCY_HISTOGRAM_INCLUDED
+#define ROUTING_LATENCY_HISTOGRAM_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * fixed-memory histogram of latencies.
+ *
+ * Values are counted in microseconds in logarithmic buckets: each power of
+ * two is split into kSubBuckets linear buckets, which bounds the relative
+ * error of a reported percentile to 1/kSubBuckets. Values beyond
+ * 2^kMaxExponent us end up in the last bucket.
+ *
+ * add() only does relaxed atomic increments and can be called from any
+ * thread without further locking.
+ */
+class LatencyHistogram {
+ public:
+  using duration = std::chrono::microseconds;
+
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr size_t kMaxExponent = 32;
+  static constexpr size_t kBuckets =
+      kSubBuckets + (kMaxExponent - kSubBucketBits) * kSubBuckets;
+
+  template <class Rep, class Period>
+  void add(std::chrono::duration<Rep, Period> d) {
+    const auto us = std::chrono::duration_cast<duration>(d).count();
+
+    buckets_[bucket_index(us < 0 ? 0 : static_cast<uint64_t>(us))].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  /**
+   * number of values added.
+   */
+  uint64_t count() const {
+    uint64_t total{0};
+    for (const auto &bucket : buckets_) {
+      total += bucket.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  /**
+   * upper bound of the bucket that contains the p-th percentile.
+   *
+   * @param p percentile in the range [0, 100]
+   *
+   * @returns 0 if no values were added.
+   */
+  duration percentile(double p) const {
+    std::array<uint64_t, kBuckets> snapshot;
+    uint64_t total{0};
+    for (size_t ndx = 0; ndx < kBuckets; ++ndx) {
+      snapshot[ndx] = buckets_[ndx].load(std::memory_order_relaxed);
+      total += snapshot[ndx];
+    }
+
+    if (total == 0) return duration{0};
+
+    auto rank = static_cast<uint64_t>(p / 100 * total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t seen{0};
+    for (size_t ndx = 0; ndx < kBuckets; ++ndx) {
+      seen += snapshot[ndx];
+      if (seen >= rank) return duration(bucket_upper_bound(ndx));
+    }
+
+    return duration(bucket_upper_bound(kBuckets - 1));
+  }
+
+  static constexpr size_t bucket_index(uint64_t v) {
+    if (v < kSubBuckets) return v;
+
+    size_t exponent = kSubBucketBits;
+    while (exponent < 63 && (v >> (exponent + 1)) != 0) ++exponent;
+
+    if (exponent >= kMaxExponent) return kBuckets - 1;
+
+    const size_t sub_bucket =
+        (v >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+
+    return kSubBuckets + (exponent - kSubBucketBits) * kSubBuckets +
+           sub_bucket;
+  }
+
+  static constexpr uint64_t bucket_upper_bound(size_t ndx) {
+    if (ndx < kSubBuckets) return ndx;
+
+    const size_t exponent = (ndx - kSubBuckets) / kSubBuckets + kSubBucketBits;
+    const size_t sub_bucket = (ndx - kSubBuckets) % kSubBuckets;
+    const size_t shift = exponent - kSubBucketBits;
+
+    return ((kSubBuckets + sub_bucket) << shift) + ((uint64_t{1} << shift) - 1);
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+};
+
+#endif  // ROUTING_LATENCY_HISTOGRAM_INCLUDED
@@ -40,6 +40,7 @@
 #include "common.h"  // rename_thread
 #include "connection.h"
 #include "dest_first_available.h"
+#include "dest_least_loaded.h"
 #include "dest_metadata_cache.h"
 #include "dest_next_available.h"
 #include "dest_round_robin.h"
@@ -503,6 +504,7 @@ class Connector : public ConnectorBase {
                 mysqlrouter::to_string(endpoint.endpoint()).c_str());
     }
     server_endpoint_ = endpoint.endpoint();
+    connect_started_ = std::chrono::steady_clock::now();
 
     const int socket_flags {
 #if defined(SOCK_NONBLOCK)
@@ -634,11 +636,18 @@ class Connector : public ConnectorBase {
     client_sock_container_.run([this]() {
       const auto &destination = *destinations_it_;
 
+      const auto connect_latency =
+          std::chrono::steady_clock::now() - connect_started_;
+      r_->get_context().connect_latency().add(connect_latency);
+
+      auto on_close = destination->connected(connect_latency);
+
       r_->create_connection<client_protocol_type, server_protocol_type>(
           destination->id(),  //
           client_sock_container_.release_unlocked(client_sock_),
           client_endpoint_,  //
-          server_sock_container_.release(server_sock_), server_endpoint_);
+          server_sock_container_.release(server_sock_), server_endpoint_,
+          std::move(on_close));
     });
 
     return State::DONE;
@@ -769,6 +778,9 @@ class Connector : public ConnectorBase {
   net::ip::tcp::resolver::results_type endpoints_;
   net::ip::tcp::resolver::results_type::iterator endpoints_it_;
 
+  // start of the connect() to the current endpoint.
+  std::chrono::steady_clock::time_point connect_started_;
+
   std::error_code last_ec_;
 };
 
@@ -962,9 +974,7 @@ class Acceptor {
 
             // log_info("%s", msg.c_str());
             sock.close();
-          } else if (r_->get_context().info_active_routes_.load(
-                         std::memory_order_relaxed) >=
-                     r_->get_max_connections()) {
+          } else if (!start_or_queue(sock, client_endpoint)) {
             std::vector<uint8_t> error_frame;
             const auto encode_res = encode_initial_error_packet(
                 r_->get_context().get_protocol(), error_frame, 1040,
@@ -991,11 +1001,6 @@ class Acceptor {
                         r_->get_context().get_name().c_str(),
                         r_->get_context().info_active_routes_.load(),
                         r_->get_max_connections());
-          } else {
-            Connector<client_protocol_type>(
-                r_, std::move(sock), client_endpoint, client_sock_container_,
-                server_sock_container_)
-                .async_run();
           }
         } else if (sock_res.error() ==
                    make_error_condition(std::errc::operation_would_block)) {
@@ -1025,6 +1030,79 @@ class Acceptor {
   }
 
  private:
+  void start(socket_type sock,
+             const typename client_protocol_type::endpoint &client_endpoint) {
+    Connector<client_protocol_type>(r_, std::move(sock), client_endpoint,
+                                    client_sock_container_,
+                                    server_sock_container_)
+        .async_run();
+  }
+
+  /**
+   * start routing an accepted client, or park it until a route is free.
+   *
+   * If max_connections is reached the client is put into the routing's
+   * connection-queue and started once an active route finishes. If clients
+   * are already queued, the new client waits behind them.
+   *
+   * @returns false if the client can neither be started nor queued; in that
+   * case sock is left untouched and the caller has to reject the client.
+   */
+  bool start_or_queue(
+      socket_type &sock,
+      const typename client_protocol_type::endpoint &client_endpoint) {
+    auto &ctx = r_->get_context();
+
+    const bool at_limit =
+        ctx.info_active_routes_.load(std::memory_order_relaxed) >=
+        r_->get_max_connections();
+
+    if (!at_limit && !ctx.has_queued_connections()) {
+      start(std::move(sock), client_endpoint);
+      return true;
+    }
+
+    if (ctx.get_max_queued_connections() == 0) {
+      if (at_limit) return false;
+
+      start(std::move(sock), client_endpoint);
+      return true;
+    }
+
+    const auto native_handle = sock.native_handle();
+    auto pending = std::make_shared<socket_type>(std::move(sock));
+
+    const bool queued = ctx.queue_connection(
+        [r = r_, pending, client_endpoint,
+         &client_sock_container = client_sock_container_,
+         &server_sock_container = server_sock_container_]() {
+          Connector<client_protocol_type>(r, std::move(*pending),
+                                          client_endpoint,
+                                          client_sock_container,
+                                          server_sock_container)
+              .async_run();
+        });
+
+    if (!queued) {
+      sock = std::move(*pending);
+
+      if (at_limit) return false;
+
+      // the queue is full, but a route is free: don't let this client wait.
+      start(std::move(sock), client_endpoint);
+      return true;
+    }
+
+    log_debug("[%s] fd=%d queued, waiting for a free route (%d max=%d)",
+              ctx.get_name().c_str(), native_handle,
+              ctx.info_active_routes_.load(), r_->get_max_connections());
+
+    // a route is free: hand it to the longest waiting client.
+    if (!at_limit) ctx.start_queued_connection();
+
+    return true;
+  }
+
   MySQLRouting *r_;
   const mysql_harness::PluginFuncEnv *env_;
 
@@ -1056,6 +1134,9 @@ class Acceptor {
 };
 
 void MySQLRouting::disconnect_all() {
+  // drop clients still waiting for a free route.
+  context_.clear_queued_connections();
+
   // close client<->server connections.
   connection_container_.disconnect_all();
 }
@@ -1260,7 +1341,8 @@ void MySQLRouting::create_connection(
     typename ClientProtocol::socket client_socket,
     const typename ClientProtocol::endpoint &client_endpoint,
     typename ServerProtocol::socket server_socket,
-    const typename ServerProtocol::endpoint &server_endpoint) {
+    const typename ServerProtocol::endpoint &server_endpoint,
+    std::function<void()> on_close) {
   auto remove_callback = [this](MySQLRoutingConnectionBase *connection) {
     connection_container_.remove_connection(connection);
   };
@@ -1268,7 +1350,8 @@ void MySQLRouting::create_connection(
   auto new_connection =
       std::make_unique<MySQLRoutingConnection<ClientProtocol, ServerProtocol>>(
           context_, destination_name, std::move(client_socket), client_endpoint,
-          std::move(server_socket), server_endpoint, remove_callback);
+          std::move(server_socket), server_endpoint, remove_callback,
+          std::move(on_close));
 
   auto *new_conn_ptr = new_connection.get();
 
@@ -1486,6 +1569,10 @@ std::unique_ptr<RouteDestination> create_standalone_destination(
     case RoutingStrategy::kRoundRobin:
       return std::make_unique<DestRoundRobin>(io_ctx, protocol,
                                               thread_stack_size);
+    case RoutingStrategy::kLeastConnections:
+    case RoutingStrategy::kEwmaLatency:
+      return std::make_unique<DestLeastLoaded>(io_ctx, strategy, protocol,
+                                               thread_stack_size);
     case RoutingStrategy::kUndefined:
     case RoutingStrategy::kRoundRobinWithFallback:;  // unsupported, fall
                                                      // through
@@ -351,7 +351,8 @@ class MySQLRouting {
       typename ClientProtocol::socket client_socket,
       const typename ClientProtocol::endpoint &client_endpoint,
       typename ServerProtocol::socket server_socket,
-      const typename ServerProtocol::endpoint &server_endpoint);
+      const typename ServerProtocol::endpoint &server_endpoint,
+      std::function<void()> on_close = {});
 
   routing::RoutingStrategy get_routing_strategy() const;
 
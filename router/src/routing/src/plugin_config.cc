@@ -166,7 +166,10 @@ static routing::RoutingStrategy get_option_routing_strategy(
   auto result = routing::get_routing_strategy(value);
   if (result == routing::RoutingStrategy::kUndefined ||
       ((result == routing::RoutingStrategy::kRoundRobinWithFallback) &&
-       !is_metadata_cache)) {
+       !is_metadata_cache) ||
+      ((result == routing::RoutingStrategy::kLeastConnections ||
+        result == routing::RoutingStrategy::kEwmaLatency) &&
+       is_metadata_cache)) {
     const std::string valid =
         routing::get_routing_strategy_names(is_metadata_cache);
     throw std::invalid_argument(get_log_prefix(section, option) +
@@ -489,6 +492,12 @@ RoutingPluginConfig::RoutingPluginConfig(
               "max_connections"_sv,
               std::to_string(routing::kDefaultMaxConnections)),
           1)),
+      max_queued_connections(get_uint_option<uint16_t>(
+          section,
+          mysql_harness::ConfigOption(
+              "max_queued_connections"_sv,
+              std::to_string(routing::kDefaultMaxQueuedConnections)),
+          0)),
       max_connect_errors(get_uint_option<uint32_t>(
           section,
           mysql_harness::ConfigOption(
@@ -515,6 +524,10 @@ RoutingPluginConfig::RoutingPluginConfig(
               "thread_stack_size"_sv,
               std::to_string(mysql_harness::kDefaultStackSizeInKiloBytes)),
           1, 65535)),
+      classify_statements(get_uint_option<uint8_t>(
+          section,
+          mysql_harness::ConfigOption("classify_statements"_sv, "0"_sv), 0,
+          1)),
       source_ssl_mode{get_option_ssl_mode(
           section, mysql_harness::ConfigOption("client_ssl_mode"_sv, ""_sv),
           {SslMode::kDisabled, SslMode::kPreferred, SslMode::kRequired,
@@ -63,11 +63,14 @@ class ROUTING_EXPORT RoutingPluginConfig {
   routing::RoutingStrategy
       routing_strategy;       //!< routing strategy (next-avail, ...)
   const int max_connections;  //!< max connections allowed
+  const unsigned int
+      max_queued_connections;  //!< clients waiting for a free connection
   const unsigned long long max_connect_errors;  //!< max connect errors
   const unsigned int
       client_connect_timeout;            //!< client connect timeout in seconds
   const unsigned int net_buffer_length;  //!< Size of buffer to receive packets
   const unsigned int thread_stack_size;  //!< thread stack size in kilobytes
+  const bool classify_statements;  //!< count statements a replica could run
 
   SslMode source_ssl_mode;  //!< SslMode of the client side connection.
   const std::string source_ssl_cert;       //!< Cert file
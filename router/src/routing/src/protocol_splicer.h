@@ -32,6 +32,11 @@
 #include <system_error>
 #include <vector>
 
+#if defined(__linux__)
+#include <fcntl.h>   // splice
+#include <unistd.h>  // pipe2
+#endif
+
 #include "basic_protocol_splicer.h"
 #include "channel.h"
 #include "classic_protocol_splicer.h"
@@ -107,8 +112,8 @@ template <class ClientProtocol, class ServerProtocol>
 std::unique_ptr<BasicSplicer> make_splicer(
     MySQLRoutingConnection<ClientProtocol, ServerProtocol> *conn) {
   switch (conn->context().get_protocol()) {
-    case BaseProtocol::Type::kClassicProtocol:
-      return std::make_unique<ClassicProtocolSplicer>(
+    case BaseProtocol::Type::kClassicProtocol: {
+      auto splicer = std::make_unique<ClassicProtocolSplicer>(
           conn->context().source_ssl_mode(), conn->context().dest_ssl_mode(),
           [conn]() { return conn->context().source_ssl_ctx()->get(); },
           [conn]() -> SSL_CTX * {
@@ -122,6 +127,18 @@ std::unique_ptr<BasicSplicer> make_splicer(
           },
           initial_connection_attributes<ClientProtocol>(
               conn->client_endpoint()));
+
+      if (conn->context().get_classify_statements() &&
+          conn->context().source_ssl_mode() != SslMode::kPassthrough) {
+        auto &ctx = conn->context();
+
+        splicer->on_statement([&ctx](bool replica_eligible) {
+          ctx.statement_classified(replica_eligible);
+        });
+      }
+
+      return splicer;
+    }
     case BaseProtocol::Type::kXProtocol:
       return std::make_unique<XProtocolSplicer>(
           conn->context().source_ssl_mode(), conn->context().dest_ssl_mode(),
@@ -163,6 +180,11 @@ class Splicer : public std::enable_shared_from_this<
       std::terminate();
     }
 
+#if defined(__linux__)
+    to_server_pipe_.close();
+    to_client_pipe_.close();
+#endif
+
     conn_->disassociate();
   }
 
@@ -479,6 +501,19 @@ class Splicer : public std::enable_shared_from_this<
         return;
       }
 
+#if defined(__linux__)
+      // once the TLS handshake of a passthrough connection is done, the data
+      // isn't inspected anymore and can bypass the userspace buffers.
+      if (!zero_copy_active<FromDirection::CLIENT>() &&
+          zero_copy_possible<FromDirection::CLIENT>()) {
+        start_zero_copy<FromDirection::CLIENT>();
+      }
+      if (!zero_copy_active<FromDirection::SERVER>() &&
+          zero_copy_possible<FromDirection::SERVER>()) {
+        start_zero_copy<FromDirection::SERVER>();
+      }
+#endif
+
       // want_read() -> recv() -> would_block -> async_wait ->
       //   transfer() -> run()
       //
@@ -489,13 +524,15 @@ class Splicer : public std::enable_shared_from_this<
 
         bool some_recv_finished{false};
         if (splicer_->client_channel()->want_recv() &&
-            !splicer_->client_waiting_recv()) {
+            !splicer_->client_waiting_recv() &&
+            !zero_copy_active<FromDirection::CLIENT>()) {
           const bool finished = recv_client_channel();
           some_recv_finished |= finished;
         }
 
         if (splicer_->server_channel()->want_recv() &&
-            !splicer_->server_waiting_recv()) {
+            !splicer_->server_waiting_recv() &&
+            !zero_copy_active<FromDirection::SERVER>()) {
           const bool finished = recv_server_channel();
           some_recv_finished |= finished;
         }
@@ -595,6 +632,204 @@ class Splicer : public std::enable_shared_from_this<
                   this->shared_from_this(), std::placeholders::_1));
   }
 
+  /**
+   * check if a direction is forwarded with splice().
+   */
+  template <FromDirection direction>
+  bool zero_copy_active() const {
+#if defined(__linux__)
+    return direction == FromDirection::CLIENT ? to_server_pipe_.is_open()
+                                              : to_client_pipe_.is_open();
+#else
+    return false;
+#endif
+  }
+
+#if defined(__linux__)
+  /**
+   * check if a direction can switch from the splicer to splice().
+   *
+   * - the connection is a TLS passthrough connection,
+   * - the TLS handshake is finished,
+   * - nothing is buffered for the direction and
+   * - no async operation is pending for the direction.
+   */
+  template <FromDirection direction>
+  bool zero_copy_possible() const {
+    if (splicer_->state() != State::SPLICE) return false;
+    if (splicer_->source_ssl_mode() != SslMode::kPassthrough) return false;
+
+    const bool from_client = direction == FromDirection::CLIENT;
+
+    const Channel *src_channel =
+        from_client ? splicer_->client_channel() : splicer_->server_channel();
+    const Channel *dst_channel =
+        from_client ? splicer_->server_channel() : splicer_->client_channel();
+
+    const bool is_waiting =
+        from_client ? (splicer_->client_waiting_recv() ||
+                       splicer_->server_waiting_send())
+                    : (splicer_->server_waiting_recv() ||
+                       splicer_->client_waiting_send());
+
+    return !is_waiting && src_channel->is_tls() && dst_channel->is_tls() &&
+           src_channel->tls_app_data_seen() &&
+           src_channel->recv_buffer().empty() &&
+           src_channel->recv_plain_buffer().empty() &&
+           dst_channel->send_buffer().empty();
+  }
+
+  /**
+   * forward a direction from socket to socket through a pipe with splice().
+   *
+   * If the pipe can't be created, the direction stays with the splicer.
+   */
+  template <FromDirection direction>
+  void start_zero_copy() {
+    auto &pipe = direction == FromDirection::CLIENT ? to_server_pipe_
+                                                    : to_client_pipe_;
+
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+      log_debug("[%s] pipe2() failed: %s", conn_->context().get_name().c_str(),
+                std::error_code(errno, std::generic_category())
+                    .message()
+                    .c_str());
+      return;
+    }
+
+    pipe.rd = fds[0];
+    pipe.wr = fds[1];
+
+    log_debug("[%s] fd=%d -- %d: forwarding %s with splice()",
+              conn_->context().get_name().c_str(),
+              conn_->client_socket().native_handle(),
+              conn_->server_socket().native_handle(),
+              direction == FromDirection::CLIENT ? "c->s" : "c<-s");
+
+    async_wait_zero_copy<direction>(net::socket_base::wait_read);
+  }
+
+  template <FromDirection direction>
+  void async_wait_zero_copy(net::socket_base::wait_type wt) {
+    // wait for the source to become readable, or the destination to become
+    // writable.
+    const bool on_client = (direction == FromDirection::CLIENT) ==
+                           (wt == net::socket_base::wait_read);
+
+    auto handler = std::bind(
+        &Splicer<ClientProtocol, ServerProtocol>::template zero_copy_ready<
+            direction>,
+        this->shared_from_this(), std::placeholders::_1);
+
+    if (on_client) {
+      conn_->client_socket().async_wait(wt, std::move(handler));
+    } else {
+      conn_->server_socket().async_wait(wt, std::move(handler));
+    }
+  }
+
+  template <FromDirection direction>
+  void zero_copy_ready(const std::error_code ec) {
+    if (ec == std::errc::operation_canceled) {
+      if (splicer_->state() != State::DONE) splicer_->state(finish());
+      return;
+    }
+
+    if (splicer_->state() == State::DONE) return;
+
+    zero_copy_transfer<direction>();
+  }
+
+  /**
+   * move data from the source socket into the pipe and from the pipe to the
+   * destination socket until one of them would block.
+   */
+  template <FromDirection direction>
+  void zero_copy_transfer() {
+    const bool from_client = direction == FromDirection::CLIENT;
+    const char *from = from_client ? "client" : "server";
+    const char *to = from_client ? "server" : "client";
+
+    auto &pipe = from_client ? to_server_pipe_ : to_client_pipe_;
+    const int src_fd = from_client ? conn_->client_socket().native_handle()
+                                   : conn_->server_socket().native_handle();
+    const int dst_fd = from_client ? conn_->server_socket().native_handle()
+                                   : conn_->client_socket().native_handle();
+
+    while (true) {
+      if (pipe.pending > 0) {
+        const auto written = ::splice(pipe.rd, nullptr, dst_fd, nullptr,
+                                      pipe.pending,
+                                      SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+        if (written < 0) {
+          const std::error_code ec(errno, std::generic_category());
+
+          if (ec == std::errc::interrupted) continue;
+
+          if (ec == std::errc::operation_would_block ||
+              ec == std::errc::resource_unavailable_try_again) {
+            async_wait_zero_copy<direction>(net::socket_base::wait_write);
+            return;
+          }
+
+          if (ec != std::errc::broken_pipe &&
+              ec != std::errc::connection_reset) {
+            log_warning("%s::splice() failed: %s (%s:%d). Aborting connection.",
+                        to, ec.message().c_str(), ec.category().name(),
+                        ec.value());
+          }
+
+          splicer_->state(finish());
+          return;
+        }
+
+        pipe.pending -= written;
+
+        if (from_client) {
+          conn_->transfered_to_server(written);
+        } else {
+          conn_->transfered_to_client(written);
+        }
+
+        continue;
+      }
+
+      const auto received = ::splice(src_fd, nullptr, pipe.wr, nullptr,
+                                     max_read_size_,
+                                     SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (received == 0) {
+        // eof
+        splicer_->state(finish());
+        return;
+      }
+
+      if (received < 0) {
+        const std::error_code ec(errno, std::generic_category());
+
+        if (ec == std::errc::interrupted) continue;
+
+        if (ec == std::errc::operation_would_block ||
+            ec == std::errc::resource_unavailable_try_again) {
+          async_wait_zero_copy<direction>(net::socket_base::wait_read);
+          return;
+        }
+
+        if (ec != std::errc::connection_reset &&
+            ec != std::errc::connection_aborted) {
+          log_info("%s::splice() failed: %s (%s:%d)", from,
+                   ec.message().c_str(), ec.category().name(), ec.value());
+        }
+
+        splicer_->state(finish());
+        return;
+      }
+
+      pipe.pending += received;
+    }
+  }
+#endif
+
   void async_run() {
     conn_->connected();
 
@@ -670,6 +905,30 @@ class Splicer : public std::enable_shared_from_this<
 
   size_t max_read_size_;
 
+#if defined(__linux__)
+  /**
+   * pipe between two sockets of a direction that is forwarded with splice().
+   */
+  struct ZeroCopyPipe {
+    int rd{-1};
+    int wr{-1};
+
+    /** bytes in the pipe that are not written to the destination yet. */
+    size_t pending{0};
+
+    bool is_open() const { return rd != -1; }
+
+    void close() {
+      if (rd != -1) ::close(rd);
+      if (wr != -1) ::close(wr);
+      rd = wr = -1;
+    }
+  };
+
+  ZeroCopyPipe to_server_pipe_;
+  ZeroCopyPipe to_client_pipe_;
+#endif
+
   net::steady_timer client_read_timer_{
       conn_->client_socket().get_executor().context()};
   net::steady_timer server_read_timer_{
@@ -50,6 +50,7 @@ namespace routing {
 
 const int kDefaultWaitTimeout = 0;  // 0 = no timeout used
 const int kDefaultMaxConnections = 512;
+const int kDefaultMaxQueuedConnections = 0;
 const std::chrono::seconds kDefaultDestinationConnectionTimeout{1};
 const std::string kDefaultBindAddress = "127.0.0.1";
 const unsigned int kDefaultNetBufferLength =
@@ -89,12 +90,14 @@ std::string get_access_mode_name(AccessMode access_mode) noexcept {
 }
 
 // keep in-sync with enum RoutingStrategy
-static const std::array<const char *, 5> kRoutingStrategyNames{{
+static const std::array<const char *, 7> kRoutingStrategyNames{{
     nullptr,
     "first-available",
     "next-available",
     "round-robin",
     "round-robin-with-fallback",
+    "least-connections",
+    "ewma-latency",
 }};
 
 RoutingStrategy get_routing_strategy(const std::string &value) {
@@ -106,13 +109,16 @@ RoutingStrategy get_routing_strategy(const std::string &value) {
 
 std::string get_routing_strategy_names(bool metadata_cache) {
   // round-robin-with-fallback is not supported for static routing
-  const std::array<const char *, 3> kRoutingStrategyNamesStatic{{
+  const std::array<const char *, 5> kRoutingStrategyNamesStatic{{
       "first-available",
       "next-available",
       "round-robin",
+      "least-connections",
+      "ewma-latency",
   }};
 
-  // next-available is not supported for metadata-cache routing
+  // next-available, least-connections and ewma-latency are not supported for
+  // metadata-cache routing
   const std::array<const char *, 3> kRoutingStrategyNamesMetadataCache{{
       "first-available",
       "round-robin",
@@ -52,6 +52,37 @@ int MySQLRoutingAPI::get_active_connections() const {
   return r_->get_context().get_active_routes();
 }
 
+uint64_t MySQLRoutingAPI::get_statements() const {
+  return r_->get_context().get_statements();
+}
+
+uint64_t MySQLRoutingAPI::get_replica_eligible_statements() const {
+  return r_->get_context().get_replica_eligible_statements();
+}
+
+uint64_t MySQLRoutingAPI::get_bytes_to_server() const {
+  return r_->get_context().get_bytes_to_server();
+}
+
+uint64_t MySQLRoutingAPI::get_bytes_from_server() const {
+  return r_->get_context().get_bytes_from_server();
+}
+
+static MySQLRoutingAPI::LatencySummary latency_summary(
+    const LatencyHistogram &histogram) {
+  return {histogram.count(), histogram.percentile(50),
+          histogram.percentile(90), histogram.percentile(99)};
+}
+
+MySQLRoutingAPI::LatencySummary MySQLRoutingAPI::get_connect_latency() const {
+  return latency_summary(r_->get_context().connect_latency());
+}
+
+MySQLRoutingAPI::LatencySummary MySQLRoutingAPI::get_first_byte_latency()
+    const {
+  return latency_summary(r_->get_context().first_byte_latency());
+}
+
 std::string MySQLRoutingAPI::get_bind_address() const {
   return r_->get_context().get_bind_address().address();
 }
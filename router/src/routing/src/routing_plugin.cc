@@ -414,6 +414,9 @@ static void start(mysql_harness::PluginFuncEnv *env) {
         config.dest_ssl_mode,
         config.dest_ssl_mode != SslMode::kDisabled ? &dest_tls_ctx : nullptr);
 
+    r->get_context().set_max_queued_connections(config.max_queued_connections);
+    r->get_context().set_classify_statements(config.classify_statements);
+
     try {
       // don't allow rootless URIs as we did already in the
       // get_option_destinations()
@@ -569,6 +569,11 @@ BasicSplicer::State XProtocolSplicer::xproto_splice_int(
         return State::FINISH;
       }
 
+      if (static_cast<TlsContentType>(tls_content_type) ==
+          TlsContentType::kApplication) {
+        src_channel->tls_app_data_seen(true);
+      }
+
       // if TlsAlert in handshake, the connection goes back to plain
       if (static_cast<TlsContentType>(tls_content_type) ==
               TlsContentType::kAlert &&
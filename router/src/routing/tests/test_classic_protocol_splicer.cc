@@ -921,6 +921,39 @@ TEST(ClassicProtocolSplicerTest, splice_passthrough_tls) {
   EXPECT_EQ(splicer.server_channel()->send_buffer().size(), 7);
 }
 
+TEST(ClassicProtocolSplicerTest, is_read_only_statement) {
+  for (const char *stmt : {
+           "SELECT 1",
+           "select * from t1 where id = 1",
+           "  /* comment */ SELECT 1",
+           "-- comment\nSELECT 1",
+           "SHOW TABLES",
+           "DESC t1",
+           "EXPLAIN SELECT 1",
+       }) {
+    SCOPED_TRACE(stmt);
+    EXPECT_TRUE(ClassicProtocolSplicer::is_read_only_statement(stmt));
+  }
+
+  for (const char *stmt : {
+           "",
+           "INSERT INTO t1 VALUES (1)",
+           "SELECT * FROM t1 FOR UPDATE",
+           "SELECT * FROM t1 LOCK IN SHARE MODE",
+           "SELECT 1 INTO @a",
+           "SELECT @a",
+           "SELECT GET_LOCK('a', 1)",
+           "SELECT LAST_INSERT_ID()",
+           "/*!80000 DELETE FROM t1 */",
+           "/* unterminated SELECT 1",
+           "SELECTED",
+           "BEGIN",
+       }) {
+    SCOPED_TRACE(stmt);
+    EXPECT_FALSE(ClassicProtocolSplicer::is_read_only_statement(stmt));
+  }
+}
+
 int main(int argc, char *argv[]) {
   TlsLibraryContext lib_ctx;
   net::impl::socket::init();
@@ -0,0 +1,82 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "latency_histogram.h"
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram h;
+
+  EXPECT_EQ(h.count(), 0u);
+  EXPECT_EQ(h.percentile(99), 0us);
+}
+
+TEST(LatencyHistogramTest, BucketsAreContiguous) {
+  for (size_t ndx = 0; ndx < LatencyHistogram::kBuckets - 1; ++ndx) {
+    const auto upper = LatencyHistogram::bucket_upper_bound(ndx);
+
+    EXPECT_EQ(LatencyHistogram::bucket_index(upper), ndx);
+    EXPECT_EQ(LatencyHistogram::bucket_index(upper + 1), ndx + 1);
+  }
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram h;
+
+  for (int i = 0; i < 90; ++i) h.add(100us);
+  for (int i = 0; i < 10; ++i) h.add(10ms);
+
+  EXPECT_EQ(h.count(), 100u);
+
+  // reported values are the upper bound of the bucket, which is at most
+  // 1/kSubBuckets above the added value.
+  EXPECT_GE(h.percentile(50), 100us);
+  EXPECT_LT(h.percentile(50), 125us);
+  EXPECT_GE(h.percentile(90), 100us);
+  EXPECT_LT(h.percentile(90), 125us);
+  EXPECT_GE(h.percentile(99), 10ms);
+  EXPECT_LT(h.percentile(99), 12500us);
+}
+
+TEST(LatencyHistogramTest, Overflow) {
+  LatencyHistogram h;
+
+  h.add(std::chrono::hours(24 * 365));
+
+  EXPECT_EQ(h.count(), 1u);
+  EXPECT_EQ(h.percentile(100).count(),
+            LatencyHistogram::bucket_upper_bound(LatencyHistogram::kBuckets -
+                                                 1));
+}
+
+int main(int argc, char *argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (c) 2021, Oracle and/or its affiliates.
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License, version 2.0,
+  as published by the Free Software Foundation.
+
+  This program is also distributed with certain software (including
+  but not limited to OpenSSL) that is licensed under separate terms,
+  as designated in a particular file or component or in included license
+  documentation.  The authors of MySQL hereby grant you an additional
+  permission to link the program and your derivative works with the
+  separately licensed software that they have included with MySQL.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+
+#include "dest_least_loaded.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "mysql/harness/net_ts/io_context.h"
+#include "test/helpers.h"  // init_test_logger
+
+using namespace std::chrono_literals;
+
+class LeastLoadedDestinationTest : public ::testing::Test {
+ protected:
+  static std::vector<std::string> ids(Destinations dests) {
+    std::vector<std::string> res;
+    for (const auto &dest : dests) res.push_back(dest->id());
+    return res;
+  }
+
+  net::io_context io_ctx_;
+};
+
+TEST_F(LeastLoadedDestinationTest, Empty) {
+  DestLeastLoaded d(io_ctx_, routing::RoutingStrategy::kLeastConnections);
+
+  EXPECT_TRUE(d.destinations().empty());
+}
+
+TEST_F(LeastLoadedDestinationTest, LeastConnections) {
+  DestLeastLoaded d(io_ctx_, routing::RoutingStrategy::kLeastConnections);
+  d.add("addr1", 1);
+  d.add("addr2", 2);
+  d.add("addr3", 3);
+
+  // open a connection to addr1 and two to addr2
+  std::vector<std::function<void()>> on_close;
+  for (auto &dest : d.destinations()) {
+    if (dest->id() == "addr1:1") {
+      on_close.push_back(dest->connected(1ms));
+    } else if (dest->id() == "addr2:2") {
+      on_close.push_back(dest->connected(1ms));
+      on_close.push_back(dest->connected(1ms));
+    }
+  }
+
+  EXPECT_EQ(d.load("addr1:1")->active.load(), 1u);
+  EXPECT_EQ(d.load("addr2:2")->active.load(), 2u);
+
+  EXPECT_THAT(ids(d.destinations()),
+              ::testing::ElementsAre("addr3:3", "addr1:1", "addr2:2"));
+
+  // closing the connections releases the load
+  for (auto &cb : on_close) cb();
+
+  EXPECT_EQ(d.load("addr1:1")->active.load(), 0u);
+  EXPECT_EQ(d.load("addr2:2")->active.load(), 0u);
+}
+
+TEST_F(LeastLoadedDestinationTest, EqualLoadRotates) {
+  DestLeastLoaded d(io_ctx_, routing::RoutingStrategy::kLeastConnections);
+  d.add("addr1", 1);
+  d.add("addr2", 2);
+
+  EXPECT_THAT(ids(d.destinations()),
+              ::testing::ElementsAre("addr1:1", "addr2:2"));
+  EXPECT_THAT(ids(d.destinations()),
+              ::testing::ElementsAre("addr2:2", "addr1:1"));
+}
+
+TEST_F(LeastLoadedDestinationTest, EwmaLatency) {
+  DestLeastLoaded d(io_ctx_, routing::RoutingStrategy::kEwmaLatency);
+  d.add("addr1", 1);
+  d.add("addr2", 2);
+
+  std::vector<std::function<void()>> on_close;
+  for (auto &dest : d.destinations()) {
+    on_close.push_back(dest->connected(dest->id() == "addr1:1" ? 10ms : 1ms));
+  }
+  for (auto &cb : on_close) cb();
+
+  // idle, but addr1 is slower.
+  EXPECT_THAT(ids(d.destinations()),
+              ::testing::ElementsAre("addr2:2", "addr1:1"));
+  EXPECT_THAT(ids(d.destinations()),
+              ::testing::ElementsAre("addr2:2", "addr1:1"));
+}
+
+TEST_F(LeastLoadedDestinationTest, EwmaAverage) {
+  DestLeastLoaded::Load load;
+
+  // first sample is taken as is.
+  DestLeastLoaded::add_connect_latency(load, 1000us);
+  EXPECT_EQ(load.connect_latency_us.load(), 1000u);
+
+  DestLeastLoaded::add_connect_latency(load, 2000us);
+  EXPECT_EQ(load.connect_latency_us.load(),
+            (1000 * (100 - DestLeastLoaded::kEwmaWeightPercent) +
+             2000 * DestLeastLoaded::kEwmaWeightPercent) /
+                100);
+}
+
+int main(int argc, char *argv[]) {
+  init_test_logger();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -246,6 +246,46 @@ get_expected_status_fields(const int expected_active_connections,
          ASSERT_TRUE(value->IsInt());
          ASSERT_EQ(value->GetInt(), expected_blocked_hosts);
        }},
+      {"/statements",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/replicaEligibleStatements",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/bytesToServer",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/bytesFromServer",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/connectLatency/count",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/connectLatency/p99",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/firstByteLatency/count",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
+      {"/firstByteLatency/p99",
+       [](const JsonValue *value) {
+         ASSERT_TRUE(value != nullptr);
+         ASSERT_TRUE(value->IsUint64());
+       }},
   };
 }
 
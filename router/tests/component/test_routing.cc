@@ -713,8 +713,9 @@ const RoutingConfigParam routing_config_param[] = {
        EXPECT_THAT(lines,
                    ::testing::Contains(::testing::HasSubstr(
                        "option routing_strategy in [routing] is invalid; valid "
-                       "are first-available, "
-                       "next-available, and round-robin (was 'invalid')")));
+                       "are first-available, next-available, round-robin, "
+                       "least-connections, and ewma-latency (was "
+                       "'invalid')")));
      }},
     {"empty_mode",
      {
@@ -751,7 +751,8 @@ TEST_F(RouterRoutingStrategyStatic, InvalidMode) {
       router,
       "option routing_strategy in \\[routing:test_default\\] is invalid; valid "
       "are "
-      "first-available, next-available, and round-robin \\(was 'invalid'\\)",
+      "first-available, next-available, round-robin, least-connections, and "
+      "ewma-latency \\(was 'invalid'\\)",
       500ms));
 }
 
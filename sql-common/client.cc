@@ -1297,7 +1297,8 @@ bool cli_advanced_command(MYSQL *mysql, enum enum_server_command command,
     vio_set_blocking_flag(mysql->net.vio, true);
 
   if (mysql->status != MYSQL_STATUS_READY ||
-      mysql->server_status & SERVER_MORE_RESULTS_EXISTS) {
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+      (command != COM_QUIT && PIPELINE_PENDING(mysql))) {
     DBUG_PRINT("error", ("state: %d", mysql->status));
     set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
     return true;
@@ -1483,7 +1484,8 @@ net_async_status cli_advanced_command_nonblocking(
     }
 
     if (mysql->status != MYSQL_STATUS_READY ||
-        mysql->server_status & SERVER_MORE_RESULTS_EXISTS) {
+        mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+        (command != COM_QUIT && PIPELINE_PENDING(mysql))) {
       DBUG_PRINT("error", ("state: %d", mysql->status));
       set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
       return NET_ASYNC_COMPLETE;
@@ -1844,6 +1846,9 @@ void end_server(MYSQL *mysql) {
   net_end(&mysql->net);
   //  net_extension_free(&mysql->net);
   free_old_query(mysql);
+  /* The results of pipelined queries are lost with the connection */
+  if (mysql->extension)
+    static_cast<MYSQL_EXTENSION *>(mysql->extension)->pipeline_pending = 0;
   errno = save_errno;
   MYSQL_TRACE(DISCONNECTED, mysql, ());
 }
@@ -7408,6 +7413,191 @@ net_async_status STDCALL mysql_send_query_nonblocking(MYSQL *mysql,
   return ret;
 }
 
+/**
+  Sends a query without waiting for the results of the queries sent before
+  it. The server executes pipelined queries in order, and their results are
+  read in the same order with mysql_pipeline_read_result(). An error in one
+  query does not affect the queries queued after it.
+
+  Pipelining hides the network round trip between independent statements.
+  Since the server stops reading queries while the client does not read
+  results, results should be read before the socket buffers fill up. LOAD
+  DATA LOCAL must not be pipelined, because the server would read the next
+  queries as the file contents. Other commands return
+  CR_COMMANDS_OUT_OF_SYNC until all pending results are read.
+
+  @param[in]   mysql               connection handle
+  @param[in]   query               query string to be executed
+  @param[in]   length              length of query
+
+  @retval      0                   the query was sent
+  @retval      1                   error, the connection is unusable if the
+                                   pending results were lost
+*/
+int STDCALL mysql_pipeline_send_query(MYSQL *mysql, const char *query,
+                                      ulong length) {
+  DBUG_TRACE;
+  DBUG_PRINT("query", ("Query = '%-.*s'", (int)length, query));
+  NET *net = &mysql->net;
+  MYSQL_EXTENSION *ext = MYSQL_EXTENSION_PTR(mysql);
+
+  if (mysql->net.vio == nullptr) {
+    set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    return 1;
+  }
+  if (mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS ||
+      ASYNC_DATA(mysql)->async_op_status != ASYNC_OP_UNSET) {
+    DBUG_PRINT("error", ("state: %d", mysql->status));
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    return 1;
+  }
+  /* Compressed packets share a sequence number across commands */
+  if (net->compress) {
+    set_mysql_error(mysql, CR_NOT_IMPLEMENTED, unknown_sqlstate);
+    return 1;
+  }
+
+  if (STATE_DATA(mysql)) free_state_change_info(ext);
+  uchar *ret_data;
+  unsigned long ret_data_length;
+  if (mysql_prepare_com_query_parameters(mysql, &ret_data, &ret_data_length))
+    return 1;
+
+  /*
+    The response is expected to follow a single command packet. Larger
+    queries would need the sequence number of each one to be remembered.
+  */
+  if (length + 1 + ret_data_length >= MAX_PACKET_LENGTH) {
+    if (ret_data) my_free(ret_data);
+    set_mysql_error(mysql, CR_NET_PACKET_TOO_LARGE, unknown_sqlstate);
+    return 1;
+  }
+
+  /*
+    Unlike cli_advanced_command(), do not net_clear(): the socket may hold
+    the results of the queries sent before this one.
+  */
+  net_clear_error(net);
+  net->pkt_nr = net->compress_pkt_nr = 0;
+  MYSQL_TRACE(SEND_COMMAND, mysql,
+              (COM_QUERY, ret_data_length, length, ret_data,
+               pointer_cast<const uchar *>(query)));
+  bool error = net_write_command(net, (uchar)COM_QUERY, ret_data,
+                                 ret_data_length,
+                                 pointer_cast<const uchar *>(query), length);
+  if (ret_data) my_free(ret_data);
+  if (error) {
+    DBUG_PRINT("error",
+               ("Can't send command to server. Error: %d", socket_errno));
+    if (net->last_errno == ER_NET_PACKET_TOO_LARGE)
+      set_mysql_error(mysql, CR_NET_PACKET_TOO_LARGE, unknown_sqlstate);
+    else
+      set_mysql_error(mysql, CR_SERVER_GONE_ERROR, unknown_sqlstate);
+    end_server(mysql);
+    return 1;
+  }
+  MYSQL_TRACE(PACKET_SENT, mysql, (ret_data_length + length));
+  ext->pipeline_pending++;
+  return 0;
+}
+
+/**
+  Prepares the connection to read the result of the oldest pipelined query.
+
+  @param[in]   mysql               connection handle
+  @param[in]   blocking            true if the result is read in blocking mode
+
+  @retval      false               a result is pending
+  @retval      true                error, no pipelined query is pending
+*/
+static bool mysql_pipeline_next(MYSQL *mysql, bool blocking) {
+  if (!PIPELINE_PENDING(mysql) || mysql->status != MYSQL_STATUS_READY ||
+      mysql->server_status & SERVER_MORE_RESULTS_EXISTS) {
+    DBUG_PRINT("error", ("state: %d", mysql->status));
+    set_mysql_error(mysql, CR_COMMANDS_OUT_OF_SYNC, unknown_sqlstate);
+    return true;
+  }
+  /* net_write_command() turned off non blocking operations */
+  if (vio_is_blocking(mysql->net.vio) != blocking)
+    vio_set_blocking_flag(mysql->net.vio, blocking);
+  /* The response follows the single packet of the command */
+  mysql->net.pkt_nr = mysql->net.compress_pkt_nr = 1;
+  mysql->info = nullptr;
+  mysql->affected_rows = ~(my_ulonglong)0;
+  MYSQL_TRACE_STAGE(mysql, WAIT_FOR_RESULT);
+  return false;
+}
+
+/**
+  Accounts for the result of a pipelined query being read.
+*/
+static void mysql_pipeline_done(MYSQL *mysql) {
+  MYSQL_EXTENSION *ext = MYSQL_EXTENSION_PTR(mysql);
+  /* end_server() already dropped the pending results on a network error */
+  if (ext->pipeline_pending > 0) ext->pipeline_pending--;
+}
+
+/**
+  Reads the result of the oldest query sent with mysql_pipeline_send_query().
+  It is used like mysql_read_query_result(): a result set is then read with
+  mysql_store_result() or mysql_use_result(), and the results of a multi
+  statement with mysql_next_result(), before the next pipelined result.
+
+  @param[in]   mysql               connection handle
+
+  @retval      false               success
+  @retval      true                the query failed, or no query is pending
+*/
+bool STDCALL mysql_pipeline_read_result(MYSQL *mysql) {
+  DBUG_TRACE;
+  if (mysql_pipeline_next(mysql, true)) return true;
+  bool ret = (*mysql->methods->read_query_result)(mysql);
+  mysql_pipeline_done(mysql);
+  return ret;
+}
+
+/**
+  Nonblocking version of mysql_pipeline_read_result().
+
+  @param[in]   mysql               connection handle
+
+  @retval      NET_ASYNC_ERROR     the query failed, or no query is pending
+  @retval      NET_ASYNC_NOT_READY result not read yet, call this API again
+  @retval      NET_ASYNC_COMPLETE  the result was read
+*/
+net_async_status STDCALL mysql_pipeline_read_result_nonblocking(MYSQL *mysql) {
+  DBUG_TRACE;
+  MYSQL_ASYNC *async_context = ASYNC_DATA(mysql);
+
+  if (async_context->async_query_state == QUERY_IDLE) {
+    if (async_context->async_op_status != ASYNC_OP_UNSET ||
+        mysql_pipeline_next(mysql, false))
+      return NET_ASYNC_ERROR;
+    async_context->async_op_status = ASYNC_OP_QUERY;
+    async_context->async_query_state = QUERY_READING_RESULT;
+    DBUG_PRINT("async", ("set state=%d", async_context->async_query_state));
+  }
+
+  net_async_status status =
+      (*mysql->methods->read_query_result_nonblocking)(mysql);
+  if (status == NET_ASYNC_NOT_READY) return NET_ASYNC_NOT_READY;
+
+  async_context->async_op_status = ASYNC_OP_UNSET;
+  async_context->async_query_state = QUERY_IDLE;
+  DBUG_PRINT("async", ("set state=%d", async_context->async_query_state));
+  mysql_pipeline_done(mysql);
+  return status == NET_ASYNC_ERROR ? NET_ASYNC_ERROR : NET_ASYNC_COMPLETE;
+}
+
+/**
+  Returns the number of pipelined queries whose result was not read yet.
+*/
+unsigned int STDCALL mysql_pipeline_pending(MYSQL *mysql) {
+  return PIPELINE_PENDING(mysql) ? MYSQL_EXTENSION_PTR(mysql)->pipeline_pending
+                                 : 0;
+}
+
 int STDCALL mysql_real_query(MYSQL *mysql, const char *query, ulong length) {
   int retval;
   DBUG_TRACE;
@@ -24,6 +24,8 @@
 #include <my_io.h>
 #include <my_sys.h>
 #include <mysql/psi/mysql_file.h>
+#include <string.h>
+#include <algorithm>
 #include "my_dbug.h"
 
 IO_CACHE_istream::IO_CACHE_istream() {}
@@ -81,6 +83,72 @@ bool IO_CACHE_istream::seek(my_off_t offset) {
   return res;
 }
 
+Mmap_istream::~Mmap_istream() { close(); }
+
+bool Mmap_istream::open(
+#ifdef HAVE_PSI_INTERFACE
+    PSI_file_key log_file_key MY_ATTRIBUTE((unused)),
+#endif
+    const char *file_name) {
+  m_file = mysql_file_open(log_file_key, file_name, O_RDONLY, MYF(MY_WME));
+  if (m_file < 0) return true;
+  if (remap()) {
+    close();
+    return true;
+  }
+  return false;
+}
+
+void Mmap_istream::close() {
+  if (m_data != nullptr) my_munmap(m_data, static_cast<size_t>(m_mapped));
+  m_data = nullptr;
+  m_mapped = 0;
+  m_position = 0;
+  if (m_file >= 0) mysql_file_close(m_file, MYF(MY_WME));
+  m_file = -1;
+}
+
+bool Mmap_istream::remap() {
+  const my_off_t size = mysql_file_seek(m_file, 0L, MY_SEEK_END, MYF(0));
+  if (size == MY_FILEPOS_ERROR) return true;
+  if (size <= m_mapped) return false;
+
+  void *data = my_mmap(nullptr, static_cast<size_t>(size), PROT_READ,
+                       MAP_SHARED, m_file, 0);
+  if (data == MAP_FAILED) return true;
+  if (m_data != nullptr) my_munmap(m_data, static_cast<size_t>(m_mapped));
+  m_data = static_cast<unsigned char *>(data);
+  m_mapped = size;
+  return false;
+}
+
+my_off_t Mmap_istream::length() {
+  if (remap()) return MY_FILEPOS_ERROR;
+  return m_mapped;
+}
+
+ssize_t Mmap_istream::read(unsigned char *buffer, size_t length) {
+  DBUG_TRACE;
+  if ((m_position + length > m_mapped && remap()) ||
+      DBUG_EVALUATE_IF("simulate_magic_header_io_failure", 1, 0))
+    return -1;
+  if (m_position >= m_mapped) return 0;
+
+  const size_t n = static_cast<size_t>(
+      std::min(static_cast<my_off_t>(length), m_mapped - m_position));
+  memcpy(buffer, m_data + m_position, n);
+  m_position += n;
+  return static_cast<ssize_t>(n);
+}
+
+bool Mmap_istream::seek(my_off_t offset) {
+  DBUG_TRACE;
+  bool res = false;
+  m_position = offset;
+  DBUG_EXECUTE_IF("simulate_seek_failure", res = true;);
+  return res;
+}
+
 Stdin_istream::Stdin_istream() {}
 
 Stdin_istream::~Stdin_istream() { close(); }
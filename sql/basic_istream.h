@@ -124,6 +124,61 @@ class IO_CACHE_istream : public Basic_seekable_istream {
   IO_CACHE m_io_cache;
 };
 
+/**
+   A file input stream reading a memory mapping of the file. read() copies
+   straight from the mapping, without the read() calls and the IO_CACHE
+   buffer in between. A file that grows, like the active relay log, is
+   mapped again when a read goes past the mapped length; the part of the
+   file that is read must not be truncated away while it is open.
+*/
+class Mmap_istream : public Basic_seekable_istream {
+ public:
+  Mmap_istream() {}
+  Mmap_istream(const Mmap_istream &) = delete;
+  Mmap_istream &operator=(const Mmap_istream &) = delete;
+  ~Mmap_istream() override;
+
+  /**
+     Open the stream. It opens the file and maps what it holds.
+
+     @param[in] log_file_key  The PSI_file_key for this stream
+     @param[in] file_name  The file to be opened
+     @retval false  Success
+     @retval true  Error
+  */
+  bool open(
+#ifdef HAVE_PSI_INTERFACE
+      PSI_file_key log_file_key,
+#endif
+      const char *file_name);
+  /**
+    Closes the stream. It unmaps the file and closes it.
+  */
+  void close();
+
+  ssize_t read(unsigned char *buffer, size_t length) override;
+  bool seek(my_off_t offset) override;
+
+  /**
+     Get the length of the file.
+  */
+  my_off_t length() override;
+
+ private:
+  /**
+     Map the file again if it grew since it was mapped.
+
+     @retval false  Success
+     @retval true  Error
+  */
+  bool remap();
+
+  File m_file = -1;
+  unsigned char *m_data = nullptr;
+  my_off_t m_mapped = 0;
+  my_off_t m_position = 0;
+};
+
 /**
    A stdin input stream based on IO_CACHE. It provides a Basic_istream based on
    stdin.
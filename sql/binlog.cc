@@ -55,6 +55,7 @@
 #include "dur_prop.h"
 #include "libbinlogevents/include/compression/base.h"
 #include "libbinlogevents/include/compression/iterator.h"
+#include "libbinlogevents/include/compression/zstd.h"
 #include "libbinlogevents/include/control_events.h"
 #include "libbinlogevents/include/debug_vars.h"
 #include "libbinlogevents/include/rows_event.h"
@@ -161,12 +162,16 @@ static int limit_unsafe_warning_count = 0;
 
 static handlerton *binlog_hton;
 bool opt_binlog_order_commits = true;
+ulong opt_binlog_gtid_index_interval = 0;
+ulong opt_binlog_dump_cache_size = 0;
+uint opt_binlog_trx_compression_workers = 0;
 
 const char *log_bin_index = nullptr;
 const char *log_bin_basename = nullptr;
 
 /* Size for IO_CACHE buffer for binlog & relay log */
 ulong rpl_read_size;
+bool opt_relay_log_mmap = false;
 
 MYSQL_BIN_LOG mysql_bin_log(&sync_binlog_period);
 
@@ -366,6 +371,8 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
   }
 
   void close() {
+    if (m_dump_cache != nullptr) m_dump_cache->stop_file();
+    m_dump_cache = nullptr;
     m_pipeline_head.reset(nullptr);
     m_position = 0;
     m_encrypted_header_size = 0;
@@ -385,6 +392,8 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
 
     if (m_pipeline_head->write(buffer, length)) return true;
 
+    if (m_dump_cache != nullptr)
+      m_dump_cache->write(m_position, buffer, length);
     m_position += length;
     return false;
   }
@@ -402,6 +411,8 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
   */
   bool update(const unsigned char *buffer, my_off_t length, my_off_t offset) {
     assert(m_pipeline_head != nullptr);
+    /* Dump threads read the bytes updated from the file again */
+    if (m_dump_cache != nullptr) m_dump_cache->truncate(offset);
     return m_pipeline_head->seek(offset) ||
            m_pipeline_head->write(buffer, length);
   }
@@ -417,6 +428,7 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
   bool truncate(my_off_t offset) {
     assert(m_pipeline_head != nullptr);
 
+    if (m_dump_cache != nullptr) m_dump_cache->truncate(offset);
     if (m_pipeline_head->truncate(offset)) return true;
     m_position = offset;
     return false;
@@ -428,6 +440,12 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
   my_off_t position() { return m_position; }
   bool is_empty() { return position() == 0; }
   bool is_open() { return m_pipeline_head != nullptr; }
+  /**
+    Copy what is written from now on into cache, up to close().
+
+    @param[in] cache  the cache of the dump threads
+  */
+  void set_dump_cache(Binlog_dump_cache *cache) { m_dump_cache = cache; }
   /**
     Returns the encrypted header size of the binary log file.
 
@@ -470,6 +488,7 @@ class MYSQL_BIN_LOG::Binlog_ofile : public Basic_ostream {
   int m_encrypted_header_size = 0;
   std::unique_ptr<Truncatable_ostream> m_pipeline_head;
   bool m_encrypted = false;
+  Binlog_dump_cache *m_dump_cache = nullptr;
 };
 
 /**
@@ -1240,6 +1259,11 @@ class Binlog_event_writer : public Basic_ostream {
   uchar header[LOG_EVENT_HEADER_LEN];
   my_off_t header_len = 0;
   uint32 event_len = 0;
+  /* Body checksums of the cache being copied, see set_event_checksums() */
+  const Binlog_event_checksums *event_checksums = nullptr;
+  size_t event_index = 0;
+  /* True if the checksum of the current event is already complete */
+  bool body_checksummed = false;
 
  public:
   /**
@@ -1276,6 +1300,25 @@ class Binlog_event_writer : public Basic_ostream {
     int4store(header + LOG_POS_OFFSET, end_log_pos);
     // update the checksum
     if (have_checksum) checksum = my_checksum(checksum, header, header_len);
+
+    // Complete it with the body checksum computed when the cache was written
+    if (event_checksums != nullptr) {
+      if (have_checksum && event_index < event_checksums->count()) {
+        checksum = event_checksums->event_checksum(event_index, checksum);
+        body_checksummed = true;
+      }
+      event_index++;
+    }
+  }
+
+  /**
+    Sets the body checksums of the binlog cache which is copied next, or
+    nullptr once it is copied. The events in the cache must be written
+    from the first one.
+  */
+  void set_event_checksums(const Binlog_event_checksums *checksums) {
+    event_checksums = checksums;
+    event_index = 0;
   }
 
   bool write(const unsigned char *buffer, my_off_t length) override {
@@ -1306,7 +1349,7 @@ class Binlog_event_writer : public Basic_ostream {
         if (m_binlog_file->write(buffer, write_bytes)) return true;
 
         // update the checksum
-        if (have_checksum)
+        if (have_checksum && !body_checksummed)
           checksum = my_checksum(checksum, buffer, write_bytes);
 
         event_len -= write_bytes;
@@ -1321,6 +1364,7 @@ class Binlog_event_writer : public Basic_ostream {
           if (m_binlog_file->write(checksum_buf, BINLOG_CHECKSUM_LEN))
             return true;
           checksum = initial_checksum;
+          body_checksummed = false;
         }
       }
     }
@@ -1619,6 +1663,7 @@ bool MYSQL_BIN_LOG::write_transaction(THD *thd, binlog_cache_data *cache_data,
   DBUG_PRINT("info",
              ("transaction_length= %llu", gtid_event.transaction_length));
 
+  my_off_t gtid_pos = m_binlog_file->position();
   bool ret = gtid_event.write(writer);
   if (ret) goto end;
 
@@ -1629,6 +1674,9 @@ bool MYSQL_BIN_LOG::write_transaction(THD *thd, binlog_cache_data *cache_data,
   ret = mysql_bin_log.write_cache(thd, cache_data, writer);
 
   if (!ret) {
+    m_gtid_index.add(log_file_name, gtid_pos, thd->owned_sid,
+                     thd->owned_gtid.sidno > 0 ? thd->owned_gtid.gno : 0,
+                     opt_binlog_gtid_index_interval);
     // update stats if monitoring is active
     binlog::global_context.monitoring_context()
         .transaction_compression()
@@ -1923,6 +1971,12 @@ bool binlog_cache_data::compress(THD *thd) {
 
     ctype = compressor->compression_type_code();
 
+    // large transactions are compressed in parallel parts
+    compressor->set_workers(
+        uncompressed_size >= 2 * binary_log::transaction::compression::
+                                      Zstd_comp::PARALLEL_JOB_SIZE
+            ? opt_binlog_trx_compression_workers
+            : 0);
     compressor->open();
 
     // inject the compressor in the output stream
@@ -3439,6 +3493,7 @@ MYSQL_BIN_LOG::MYSQL_BIN_LOG(uint *sync_period, bool relay_log)
       inited(false),
       m_binlog_file(new Binlog_ofile()),
       m_key_LOCK_log(key_LOG_LOCK_log),
+      m_gtid_index(&LOCK_binlog_end_pos),
       bytes_written(0),
       file_id(1),
       sync_period_ptr(sync_period),
@@ -3475,6 +3530,7 @@ void MYSQL_BIN_LOG::cleanup() {
     mysql_mutex_destroy(&LOCK_xids);
     mysql_cond_destroy(&update_cond);
     mysql_cond_destroy(&m_prep_xids_cond);
+    m_dump_cache.destroy();
     if (!is_relay_log) {
       Commit_stage_manager::get_instance().deinit();
     }
@@ -3497,6 +3553,7 @@ void MYSQL_BIN_LOG::init_pthread_objects() {
   mysql_mutex_init(m_key_LOCK_xids, &LOCK_xids, MY_MUTEX_INIT_FAST);
   mysql_cond_init(m_key_update_cond, &update_cond);
   mysql_cond_init(m_key_prep_xids_cond, &m_prep_xids_cond);
+  m_dump_cache.init();
   if (!is_relay_log) {
     Commit_stage_manager::get_instance().init(
         m_key_LOCK_flush_queue, m_key_LOCK_sync_queue, m_key_LOCK_commit_queue,
@@ -3743,6 +3800,13 @@ bool MYSQL_BIN_LOG::open(PSI_file_key log_file_key, const char *log_name,
 
   if (ret) goto err;
 
+  /* Encrypted files are read through a decrypting stream, at other offsets */
+  if (!is_relay_log && opt_binlog_dump_cache_size > 0 &&
+      m_binlog_file->get_encrypted_header_size() == 0) {
+    m_dump_cache.start_file(log_file_name, opt_binlog_dump_cache_size);
+    m_binlog_file->set_dump_cache(&m_dump_cache);
+  }
+
   atomic_log_state = LOG_OPENED;
   return false;
 
@@ -4446,6 +4510,17 @@ end:
   return error != 0 ? true : false;
 }
 
+my_off_t MYSQL_BIN_LOG::find_first_pos_not_in_gtid_set(
+    const char *binlog_file_name, const Gtid_set *gtid_set) {
+  DBUG_TRACE;
+  /* Only what is flushed and synced may be sent */
+  my_off_t end = is_active(binlog_file_name) ? get_binlog_end_pos()
+                                              : MY_FILEPOS_ERROR;
+  my_off_t pos = m_gtid_index.find(binlog_file_name, gtid_set, end);
+  DBUG_PRINT("info", ("first position not in the gtid set: %llu", pos));
+  return pos;
+}
+
 bool MYSQL_BIN_LOG::init_gtid_sets(Gtid_set *all_gtids, Gtid_set *lost_gtids,
                                    bool verify_checksum, bool need_lock,
                                    Transaction_boundary_parser *trx_parser,
@@ -4969,6 +5044,8 @@ bool MYSQL_BIN_LOG::open_binlog(
     bytes_written += extra_description_event->common_header->data_written;
   }
   if (m_binlog_file->flush_and_sync()) goto err;
+  if (!is_relay_log && opt_binlog_gtid_index_interval > 0)
+    m_gtid_index.start_file(log_file_name, m_binlog_file->position());
 
   if (write_file_name_to_index_file) {
     DBUG_EXECUTE_IF("crash_create_critical_before_update_index",
@@ -5557,6 +5634,7 @@ bool MYSQL_BIN_LOG::reset_logs(THD *thd, bool delete_only) {
   name = nullptr;  // Protect against free
   close(LOG_CLOSE_TO_BE_OPENED, false /*need_lock_log=false*/,
         false /*need_lock_index=false*/);
+  m_gtid_index.clear();
 
   /*
     First delete all old log files and then update the index file.
@@ -6132,6 +6210,7 @@ int MYSQL_BIN_LOG::purge_index_entry(THD *thd, ulonglong *decrease_log_space,
         }
 
         DBUG_PRINT("info", ("purging %s", log_info.log_file_name));
+        m_gtid_index.remove(log_info.log_file_name);
         if (!mysql_file_delete(key_file_binlog, log_info.log_file_name,
                                MYF(0))) {
           DBUG_EXECUTE_IF("wait_in_purge_index_entry", {
@@ -7207,7 +7286,10 @@ bool MYSQL_BIN_LOG::do_write_cache(Binlog_cache_storage *cache,
 #endif
 
   bool error = false;
-  if (cache->copy_to(writer, &error)) {
+  writer->set_event_checksums(&cache->event_checksums());
+  bool ret = cache->copy_to(writer, &error);
+  writer->set_event_checksums(nullptr);
+  if (ret) {
     if (error) report_binlog_write_error();
     return true;
   }
@@ -7293,7 +7375,12 @@ bool MYSQL_BIN_LOG::write_incident(Incident_log_event *ev, THD *thd,
     else
       mysql_mutex_assert_owner(&LOCK_log);
     /* Write an incident event into binlog directly. */
+    my_off_t incident_pos = m_binlog_file->position();
     error = write_event_to_binlog(ev);
+    /* Dump threads must not seek past it */
+    if (!error)
+      m_gtid_index.add(log_file_name, incident_pos, binary_log::Uuid(), 0,
+                       opt_binlog_gtid_index_interval);
     /*
       Write an error to log. So that user might have a chance
       to be alerted and explore incident details.
@@ -45,6 +45,8 @@
 #include "mysql/psi/mysql_mutex.h"
 #include "mysql/udf_registration_types.h"
 #include "mysql_com.h"  // Item_result
+#include "sql/binlog_dump_cache.h"
+#include "sql/binlog_gtid_index.h"
 #include "sql/rpl_commit_stage_manager.h"
 #include "sql/rpl_trx_tracking.h"
 #include "sql/tc_log.h"            // TC_LOG
@@ -198,6 +200,10 @@ class MYSQL_BIN_LOG : public TC_LOG {
   mysql_cond_t update_cond;
 
   std::atomic<my_off_t> atomic_binlog_end_pos;
+  /* Where dump threads can seek to, under LOCK_binlog_end_pos */
+  Binlog_gtid_index m_gtid_index;
+  /* The tail of the active file, for dump threads that caught up */
+  Binlog_dump_cache m_dump_cache;
   ulonglong bytes_written;
   IO_CACHE index_file;
   char index_file_name[FN_REFLEN];
@@ -375,6 +381,18 @@ class MYSQL_BIN_LOG : public TC_LOG {
                                       const Gtid_set *gtid_set,
                                       Gtid *first_gtid, const char **errmsg);
 
+  /**
+    Find the first transaction in a binary log that may not be in the
+    given gtid set, as far as the index of binlog_gtid_index_interval
+    tells.
+
+    @param binlog_file_name the binary log, as in the index file
+    @param gtid_set the given gtid set
+    @return the position of its Gtid_log_event, or BIN_LOG_HEADER_SIZE
+  */
+  my_off_t find_first_pos_not_in_gtid_set(const char *binlog_file_name,
+                                          const Gtid_set *gtid_set);
+
   /**
     Reads the set of all GTIDs in the binary/relay log, and the set
     of all lost GTIDs in the binary log, and stores each set in
@@ -881,6 +899,8 @@ class MYSQL_BIN_LOG : public TC_LOG {
     return atomic_binlog_end_pos;
   }
   mysql_mutex_t *get_binlog_end_pos_lock() { return &LOCK_binlog_end_pos; }
+  /** The recently written events, read without LOCK_log. */
+  Binlog_dump_cache *get_dump_cache() { return &m_dump_cache; }
   void lock_binlog_end_pos() { mysql_mutex_lock(&LOCK_binlog_end_pos); }
   void unlock_binlog_end_pos() { mysql_mutex_unlock(&LOCK_binlog_end_pos); }
 
@@ -969,7 +989,11 @@ int query_error_code(const THD *thd, bool not_killed);
 extern const char *log_bin_index;
 extern const char *log_bin_basename;
 extern bool opt_binlog_order_commits;
+extern ulong opt_binlog_gtid_index_interval;
+extern ulong opt_binlog_dump_cache_size;
+extern uint opt_binlog_trx_compression_workers;
 extern ulong rpl_read_size;
+extern bool opt_relay_log_mmap;
 /**
   Turns a relative log binary log path into a full path, based on the
   opt_bin_logname or opt_relay_logname. Also trims the cr-lf at the
@@ -0,0 +1,136 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/binlog_dump_cache.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "libbinlogevents/include/binlog_event.h"  // EVENT_LEN_OFFSET
+#include "my_byteorder.h"
+#include "my_sys.h"
+#include "mysql/psi/mysql_rwlock.h"
+#include "mysql/service_mysql_alloc.h"
+
+void Binlog_dump_cache::init() { mysql_rwlock_init(0, &m_lock); }
+
+void Binlog_dump_cache::destroy() {
+  m_active = false;
+  my_free(m_buffer);
+  m_buffer = nullptr;
+  m_size = 0;
+  mysql_rwlock_destroy(&m_lock);
+}
+
+void Binlog_dump_cache::start_file(const char *file, ulong size) {
+  mysql_rwlock_wrlock(&m_lock);
+  if (size != m_size) {
+    my_free(m_buffer);
+    m_buffer = nullptr;
+    m_size = 0;
+    if (size > 0) {
+      m_buffer = static_cast<uchar *>(
+          my_malloc(PSI_NOT_INSTRUMENTED, size, MYF(0)));
+      if (m_buffer != nullptr) m_size = size;
+    }
+  }
+  m_file = file;
+  m_start = m_end = 0;
+  m_active = m_size > 0;
+  mysql_rwlock_unlock(&m_lock);
+}
+
+void Binlog_dump_cache::stop_file() {
+  if (!m_active) return;
+  mysql_rwlock_wrlock(&m_lock);
+  m_active = false;
+  m_file.clear();
+  m_start = m_end = 0;
+  mysql_rwlock_unlock(&m_lock);
+}
+
+void Binlog_dump_cache::write(my_off_t pos, const uchar *buffer,
+                              my_off_t length) {
+  if (!m_active || length == 0) return;
+  mysql_rwlock_wrlock(&m_lock);
+  if (pos != m_end) m_start = m_end = pos;
+  if (length > m_size) {
+    /* Only the tail of it fits */
+    buffer += length - m_size;
+    m_end += length - m_size;
+    m_start = m_end;
+    length = m_size;
+  }
+  my_off_t offset = m_end % m_size;
+  my_off_t first = std::min(length, m_size - offset);
+  memcpy(m_buffer + offset, buffer, first);
+  memcpy(m_buffer, buffer + first, length - first);
+  m_end += length;
+  m_start = std::max(m_start, m_end - std::min(m_end, m_size));
+  mysql_rwlock_unlock(&m_lock);
+}
+
+void Binlog_dump_cache::truncate(my_off_t pos) {
+  if (!m_active) return;
+  mysql_rwlock_wrlock(&m_lock);
+  m_end = std::min(m_end, pos);
+  m_start = std::min(m_start, m_end);
+  mysql_rwlock_unlock(&m_lock);
+}
+
+bool Binlog_dump_cache::holds(const char *file, my_off_t pos,
+                              my_off_t length) const {
+  return pos >= m_start && pos + length <= m_end && m_file == file;
+}
+
+void Binlog_dump_cache::read(my_off_t pos, my_off_t length,
+                             uchar *buffer) const {
+  my_off_t offset = pos % m_size;
+  my_off_t first = std::min(length, m_size - offset);
+  memcpy(buffer, m_buffer + offset, first);
+  memcpy(buffer + first, m_buffer, length - first);
+}
+
+uint32 Binlog_dump_cache::event_length(const char *file, my_off_t pos) {
+  if (!m_active) return 0;
+  uint32 length = 0;
+  mysql_rwlock_rdlock(&m_lock);
+  if (holds(file, pos, EVENT_LEN_OFFSET + 4)) {
+    uchar header[EVENT_LEN_OFFSET + 4];
+    read(pos, sizeof(header), header);
+    length = uint4korr(header + EVENT_LEN_OFFSET);
+    if (length < LOG_EVENT_MINIMAL_HEADER_LEN || !holds(file, pos, length))
+      length = 0;
+  }
+  mysql_rwlock_unlock(&m_lock);
+  return length;
+}
+
+bool Binlog_dump_cache::copy(const char *file, my_off_t pos, uint32 length,
+                             uchar *buffer) {
+  if (!m_active) return true;
+  mysql_rwlock_rdlock(&m_lock);
+  bool missing = !holds(file, pos, length);
+  if (!missing) read(pos, length, buffer);
+  mysql_rwlock_unlock(&m_lock);
+  return missing;
+}
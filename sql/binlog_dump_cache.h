@@ -0,0 +1,101 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef BINLOG_DUMP_CACHE_INCLUDED
+#define BINLOG_DUMP_CACHE_INCLUDED
+
+#include <atomic>
+#include <string>
+
+#include "my_inttypes.h"
+#include "my_io.h"  // my_off_t
+#include "mysql/components/services/mysql_rwlock_bits.h"
+
+/**
+  @file sql/binlog_dump_cache.h
+
+  The last binlog_dump_cache_size bytes written to the active binary log
+  file, kept in memory for the dump threads. A dump thread that has
+  caught up asks for events that were written a moment ago; all dump
+  threads copy them from here instead of each reading them from the
+  file and verifying their checksums again. A dump thread that has
+  fallen behind the window reads the file as before.
+
+  The window is filled as the file is written, under LOCK_log, and is
+  only ever a copy of bytes of the file: any write not appended to the
+  window restarts it at the position written.
+*/
+class Binlog_dump_cache {
+ public:
+  void init();
+  void destroy();
+
+  /**
+    Start caching the binary log file, of which nothing is written yet.
+    Called with LOCK_log held.
+
+    @param size binlog_dump_cache_size; 0 turns the cache off
+  */
+  void start_file(const char *file, ulong size);
+
+  /** Stop caching, the file closed. Called with LOCK_log held. */
+  void stop_file();
+
+  /** Append the bytes written at pos. Called with LOCK_log held. */
+  void write(my_off_t pos, const uchar *buffer, my_off_t length);
+
+  /** The file was truncated to pos. Called with LOCK_log held. */
+  void truncate(my_off_t pos);
+
+  /**
+    The length of the event at pos of file, or 0 if the window does not
+    hold all of it.
+  */
+  uint32 event_length(const char *file, my_off_t pos);
+
+  /**
+    Copy the length bytes at pos of file into buffer.
+
+    @retval false Success
+    @retval true  The window does not hold them (any more)
+  */
+  bool copy(const char *file, my_off_t pos, uint32 length, uchar *buffer);
+
+ private:
+  /** Whether [pos, pos + length) of file is in the window, under m_lock */
+  bool holds(const char *file, my_off_t pos, my_off_t length) const;
+  /** Copy [pos, pos + length) of the window, under m_lock */
+  void read(my_off_t pos, my_off_t length, uchar *buffer) const;
+
+  mysql_rwlock_t m_lock;
+  /** Whether a file is cached, so that dump threads need not lock */
+  std::atomic<bool> m_active{false};
+
+  /* Under m_lock; the byte at pos of the file is m_buffer[pos % m_size] */
+  std::string m_file;
+  uchar *m_buffer = nullptr;
+  my_off_t m_size = 0;
+  my_off_t m_start = 0;
+  my_off_t m_end = 0;
+};
+
+#endif /* BINLOG_DUMP_CACHE_INCLUDED */
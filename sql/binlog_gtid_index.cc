@@ -0,0 +1,113 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include "sql/binlog_gtid_index.h"
+
+#include <utility>
+
+#include "mysql/psi/mysql_mutex.h"
+#include "libbinlogevents/include/binlog_event.h"  // BIN_LOG_HEADER_SIZE
+#include "sql/rpl_gtid.h"
+
+void Binlog_gtid_index::start_file(const char *file, my_off_t pos) {
+  m_file = file;
+  m_last_pos = pos;
+  m_pending.clear();
+  mysql_mutex_lock(m_lock);
+  m_files[m_file].clear();
+  mysql_mutex_unlock(m_lock);
+}
+
+void Binlog_gtid_index::add(const char *file, my_off_t pos,
+                            const binary_log::Uuid &sid, int64 gno,
+                            ulong interval) {
+  if (m_file.empty()) return;
+  if (interval == 0 || m_file != file) {
+    /* Transactions went unnoted: the entries to come would be wrong */
+    m_file.clear();
+    m_pending.clear();
+    return;
+  }
+
+  if (pos - m_last_pos >= interval && !m_pending.empty()) {
+    Entry entry{pos, std::move(m_pending)};
+    mysql_mutex_lock(m_lock);
+    m_files[m_file].push_back(std::move(entry));
+    mysql_mutex_unlock(m_lock);
+    m_pending.clear();
+    m_last_pos = pos;
+  }
+
+  if (gno > 0 && !m_pending.empty() && m_pending.back().end == gno &&
+      m_pending.back().sid == sid)
+    m_pending.back().end++;
+  else if (gno > 0)
+    m_pending.push_back({sid, gno, gno + 1});
+  else
+    m_pending.push_back({sid, 0, 0});
+}
+
+bool Binlog_gtid_index::contains(const Gtid_set *gtids, const Range &range) {
+  if (range.start == 0) return false;
+  rpl_sidno sidno = gtids->get_sid_map()->sid_to_sidno(range.sid);
+  if (sidno <= 0 || sidno > gtids->get_max_sidno()) return false;
+  Gtid_set::Const_interval_iterator ivit(gtids, sidno);
+  for (const Gtid_set::Interval *iv = ivit.get(); iv != nullptr;
+       ivit.next(), iv = ivit.get()) {
+    if (iv->start > range.start) break;
+    if (iv->end >= range.end) return true;
+  }
+  return false;
+}
+
+my_off_t Binlog_gtid_index::find(const char *file, const Gtid_set *gtids,
+                                 my_off_t end) const {
+  my_off_t pos = BIN_LOG_HEADER_SIZE;
+  mysql_mutex_lock(m_lock);
+  auto it = m_files.find(file);
+  if (it != m_files.end()) {
+    for (const Entry &entry : it->second) {
+      if (entry.pos >= end) break;
+      bool all = true;
+      for (const Range &range : entry.ranges)
+        if (!(all = contains(gtids, range))) break;
+      if (!all) break;
+      pos = entry.pos;
+    }
+  }
+  mysql_mutex_unlock(m_lock);
+  return pos;
+}
+
+void Binlog_gtid_index::remove(const char *file) {
+  mysql_mutex_lock(m_lock);
+  m_files.erase(file);
+  mysql_mutex_unlock(m_lock);
+}
+
+void Binlog_gtid_index::clear() {
+  m_file.clear();
+  m_pending.clear();
+  mysql_mutex_lock(m_lock);
+  m_files.clear();
+  mysql_mutex_unlock(m_lock);
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#ifndef BINLOG_GTID_INDEX_INCLUDED
+#define BINLOG_GTID_INDEX_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libbinlogevents/include/uuid.h"  // binary_log::Uuid
+#include "my_inttypes.h"
+#include "my_io.h"  // my_off_t
+#include "mysql/components/services/mysql_mutex_bits.h"
+
+class Gtid_set;
+
+/**
+  @file sql/binlog_gtid_index.h
+
+  A sparse index of the transactions in the binary log files, kept in
+  memory, so that a dump thread serving a replica with AUTO_POSITION = 1
+  seeks past the transactions the replica has instead of reading them.
+
+  Every binlog_gtid_index_interval bytes of a file, the index notes the
+  position of a Gtid_log_event together with the GTIDs of the
+  transactions between it and the previous such position. A file is
+  indexed from its Previous_gtids_log_event on, so only files opened
+  while binlog_gtid_index_interval was not 0 are indexed, and setting it
+  to 0 stops indexing the active file.
+*/
+class Binlog_gtid_index {
+ public:
+  /**
+    @param lock Protects the positions noted so far; the writer takes it
+                once per interval only.
+  */
+  explicit Binlog_gtid_index(mysql_mutex_t *lock) : m_lock(lock) {}
+
+  /**
+    Start indexing a binary log file, its header events written up to pos.
+    Called with LOCK_log held.
+  */
+  void start_file(const char *file, my_off_t pos);
+
+  /**
+    Note the transaction whose Gtid_log_event was written at pos of file.
+    Called with LOCK_log held.
+
+    @param sid      SID of the transaction
+    @param gno      GNO of the transaction, or 0 when it has no GTID, or
+                    for an event written outside of any transaction
+    @param interval binlog_gtid_index_interval; 0 stops indexing
+  */
+  void add(const char *file, my_off_t pos, const binary_log::Uuid &sid,
+           int64 gno, ulong interval);
+
+  /**
+    The position in file of the last noted transaction such that every
+    transaction before it is in gtids, BIN_LOG_HEADER_SIZE if there is no
+    such transaction.
+
+    @param gtids a Gtid_set without a sid lock
+    @param end   positions from end on are not looked at
+  */
+  my_off_t find(const char *file, const Gtid_set *gtids, my_off_t end) const;
+
+  /** Forget file, purged. */
+  void remove(const char *file);
+
+  /** Forget everything, for RESET MASTER. */
+  void clear();
+
+ private:
+  /** The GTIDs [start, end) of one SID, or a barrier if start == 0 */
+  struct Range {
+    binary_log::Uuid sid;
+    int64 start;
+    int64 end;
+  };
+
+  struct Entry {
+    my_off_t pos;
+    /** The transactions from the previous entry, or the file start, on */
+    std::vector<Range> ranges;
+  };
+
+  static bool contains(const Gtid_set *gtids, const Range &range);
+
+  mysql_mutex_t *m_lock;
+  /** Indexed files, under m_lock */
+  std::map<std::string, std::vector<Entry>> m_files;
+
+  /* The file being written and its transactions since the last entry */
+  std::string m_file;
+  my_off_t m_last_pos = 0;
+  std::vector<Range> m_pending;
+};
+
+#endif /* BINLOG_GTID_INDEX_INCLUDED */
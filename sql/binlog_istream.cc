@@ -224,6 +224,14 @@ std::unique_ptr<Basic_seekable_istream> Binlog_ifile::open_file(
 
 std::unique_ptr<Basic_seekable_istream> Relaylog_ifile::open_file(
     const char *file_name) {
+  if (opt_relay_log_mmap) {
+    Mmap_istream *ifile = new Mmap_istream;
+    if (ifile->open(key_file_relaylog, file_name)) {
+      delete ifile;
+      return nullptr;
+    }
+    return std::unique_ptr<Basic_seekable_istream>(ifile);
+  }
   IO_CACHE_istream *ifile = new IO_CACHE_istream;
   if (ifile->open(key_file_relaylog, key_file_relaylog_cache, file_name,
                   MYF(MY_WME | MY_DONT_CHECK_FILESIZE), rpl_read_size)) {
@@ -23,6 +23,8 @@
 #include "sql/binlog_ostream.h"
 #include <algorithm>
 #include "my_aes.h"
+#include "my_byteorder.h"
+#include "my_checksum.h"
 #include "my_inttypes.h"
 #include "my_rnd.h"
 #include "my_sys.h"
@@ -249,12 +251,133 @@ bool IO_CACHE_binlog_cache_storage::setup_ciphers_password() {
   return false;
 }
 
+/*
+  CRC32 arithmetic in the bit-reflected representation used by zlib. A CRC
+  is shifted over n zero bytes by multiplying it with x^(8n) modulo the
+  polynomial, which is how crc32_combine() joins the checksums of two
+  buffers.
+*/
+static const uint32 CRC32_POLYNOMIAL = 0xedb88320;
+
+/** Multiplies a and b modulo the CRC32 polynomial. a must not be zero. */
+static uint32 crc32_multmodp(uint32 a, uint32 b) {
+  uint32 m = 1U << 31;
+  uint32 p = 0;
+
+  for (;;) {
+    if (a & m) {
+      p ^= b;
+      if ((a & (m - 1)) == 0) break;
+    }
+    m >>= 1;
+    b = (b & 1) ? (b >> 1) ^ CRC32_POLYNOMIAL : b >> 1;
+  }
+  return p;
+}
+
+/** Returns x^(8 * length) modulo the CRC32 polynomial. */
+static uint32 crc32_shift(my_off_t length) {
+  struct Powers {
+    /* power[k] is x^(2^k) */
+    uint32 power[32];
+
+    Powers() {
+      uint32 p = 1U << 30;
+      power[0] = p;
+      for (int k = 1; k < 32; k++) power[k] = p = crc32_multmodp(p, p);
+    }
+  };
+  static const Powers powers;
+
+  uint32 p = 1U << 31;
+  for (unsigned int k = 3; length != 0; length >>= 1, k++)
+    if (length & 1) p = crc32_multmodp(powers.power[k & 31], p);
+  return p;
+}
+
+void Binlog_event_checksums::update(const unsigned char *buffer,
+                                    my_off_t length) {
+  if (!m_enabled) return;
+  m_length += length;
+
+  while (length > 0) {
+    if (m_body_left == 0) {
+      my_off_t header_incr =
+          std::min<my_off_t>(LOG_EVENT_HEADER_LEN - m_header_len, length);
+
+      memcpy(m_header + m_header_len, buffer, header_incr);
+      m_header_len += header_incr;
+      buffer += header_incr;
+      length -= header_incr;
+      if (m_header_len < LOG_EVENT_HEADER_LEN) break;
+
+      uint32 event_len = uint4korr(m_header + EVENT_LEN_OFFSET);
+      if (event_len <= LOG_EVENT_HEADER_LEN) {
+        disable();
+        return;
+      }
+      m_header_len = 0;
+      m_body_len = m_body_left = event_len - LOG_EVENT_HEADER_LEN;
+      m_checksum = my_checksum(0L, nullptr, 0);
+    } else {
+      my_off_t body_incr = std::min(m_body_left, length);
+
+      m_checksum = my_checksum(m_checksum, buffer, body_incr);
+      m_body_left -= body_incr;
+      buffer += body_incr;
+      length -= body_incr;
+
+      if (m_body_left == 0) {
+        m_events.push_back({m_checksum, crc32_shift(m_body_len)});
+        // Keep the checksums collected so far, but do not grow any more
+        if (m_events.size() >= MAX_EVENTS) {
+          m_enabled = false;
+          return;
+        }
+      }
+    }
+  }
+}
+
+void Binlog_event_checksums::truncate(my_off_t offset) {
+  if (offset == 0)
+    reset();
+  else if (!m_enabled || offset != m_length)
+    disable();
+}
+
+void Binlog_event_checksums::reset() {
+  // Do not keep the memory used by a large transaction
+  if (m_events.capacity() > 1024)
+    std::vector<Event>().swap(m_events);
+  else
+    m_events.clear();
+  m_header_len = 0;
+  m_body_left = 0;
+  m_length = 0;
+  m_enabled = binlog_checksum_options != binary_log::BINLOG_CHECKSUM_ALG_OFF;
+}
+
+void Binlog_event_checksums::disable() {
+  std::vector<Event>().swap(m_events);
+  m_enabled = false;
+}
+
+uint32 Binlog_event_checksums::event_checksum(size_t index,
+                                              uint32 header_checksum) const {
+  assert(index < m_events.size());
+  const Event &event = m_events[index];
+  return crc32_multmodp(event.body_shift, header_checksum) ^
+         event.body_checksum;
+}
+
 bool Binlog_cache_storage::open(my_off_t cache_size, my_off_t max_cache_size) {
   const char *LOG_PREFIX = "ML";
 
   if (m_file.open(mysql_tmpdir, LOG_PREFIX, cache_size, max_cache_size))
     return true;
   m_pipeline_head = &m_file;
+  m_event_checksums.reset();
   return false;
 }
 
@@ -24,6 +24,9 @@
 #define BINLOG_OSTREAM_INCLUDED
 
 #include <openssl/evp.h>
+#include <vector>
+
+#include "libbinlogevents/include/binlog_event.h"
 #include "sql/basic_ostream.h"
 #include "sql/rpl_log_encryption.h"
 
@@ -169,6 +172,65 @@ class IO_CACHE_binlog_cache_storage : public Truncatable_ostream {
    binlog events. This way of arranging the classes separates storage layer
    and binlog layer, hides the implementation detail of low level storage.
 */
+/**
+  Keeps the CRC32 of the body of every event written into a binlog cache.
+
+  Event headers are patched with end_log_pos when the cache is flushed, so
+  the event checksum cannot be computed before that. Its body, however, is
+  final once the event is written into the cache. Binlog_event_checksums
+  checksums the bodies as the session writes them, together with the factor
+  that shifts a CRC over the body length. When the cache is flushed, the
+  checksum of each event is then computed from its header only, instead of
+  reading the whole transaction through the CRC while holding LOCK_log.
+
+  Only a prefix of the cache is covered: tracking stops if the cache is
+  truncated in the middle, if it holds more than MAX_EVENTS events, or if
+  binlog checksums were disabled when the cache was started.
+*/
+class Binlog_event_checksums {
+ public:
+  static const size_t MAX_EVENTS = 1 << 20;
+
+  /** Checksums the bodies of the events in the buffer. */
+  void update(const unsigned char *buffer, my_off_t length);
+  /** Drops the events after offset, or all of them if it is not the end. */
+  void truncate(my_off_t offset);
+  /** Starts over on an empty cache. */
+  void reset();
+  /** Stops tracking after an error. */
+  void disable();
+
+  /** Returns the number of complete events whose checksum is known. */
+  size_t count() const { return m_events.size(); }
+  /**
+    Completes the checksum of an event.
+
+    @param index  The position of the event in the cache.
+    @param header_checksum  The checksum of the event header, as written into
+                            the binary log.
+
+    @return the checksum of the whole event.
+  */
+  uint32 event_checksum(size_t index, uint32 header_checksum) const;
+
+ private:
+  struct Event {
+    /** CRC32 of the event body. */
+    uint32 body_checksum;
+    /** x^(8 * body length) modulo the CRC32 polynomial. */
+    uint32 body_shift;
+  };
+
+  std::vector<Event> m_events;
+  unsigned char m_header[LOG_EVENT_HEADER_LEN];
+  my_off_t m_header_len = 0;
+  my_off_t m_body_left = 0;
+  my_off_t m_body_len = 0;
+  uint32 m_checksum = 0;
+  my_off_t m_length = 0;
+  bool m_enabled = false;
+};
+
 class Binlog_cache_storage : public Basic_ostream {
  public:
   ~Binlog_cache_storage() override;
@@ -178,7 +240,12 @@ class Binlog_cache_storage : public Basic_ostream {
 
   bool write(const unsigned char *buffer, my_off_t length) override {
     assert(m_pipeline_head != nullptr);
-    return m_pipeline_head->write(buffer, length);
+    if (m_pipeline_head->write(buffer, length)) {
+      m_event_checksums.disable();
+      return true;
+    }
+    m_event_checksums.update(buffer, length);
+    return false;
   }
   /**
      Truncates some data at the end of the binlog cache.
@@ -187,13 +254,19 @@ class Binlog_cache_storage : public Basic_ostream {
      @retval false  Success
      @retval true  Error
   */
-  bool truncate(my_off_t offset) { return m_pipeline_head->truncate(offset); }
+  bool truncate(my_off_t offset) {
+    m_event_checksums.truncate(offset);
+    return m_pipeline_head->truncate(offset);
+  }
 
   /**
      Reset status and drop all data. It looks like a cache was never used
      after reset.
   */
-  bool reset() { return m_file.reset(); }
+  bool reset() {
+    m_event_checksums.reset();
+    return m_file.reset();
+  }
   /**
      Returns the count of disk writes
   */
@@ -229,10 +302,17 @@ class Binlog_cache_storage : public Basic_ostream {
      Returns true if binlog cache is empty.
   */
   bool is_empty() const { return length() == 0; }
+  /**
+     Returns the body checksums of the events in the cache.
+  */
+  const Binlog_event_checksums &event_checksums() const {
+    return m_event_checksums;
+  }
 
  private:
   Truncatable_ostream *m_pipeline_head = nullptr;
   IO_CACHE_binlog_cache_storage m_file;
+  Binlog_event_checksums m_event_checksums;
 };
 
 /**
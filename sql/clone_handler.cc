@@ -229,10 +229,18 @@ int Clone_handler::validate_dir(const char *in_dir, char *out_dir) {
   /* Convert the path to native os format. */
   convert_dirname(out_dir, in_dir, nullptr);
 
-  /* Check if the data directory exists already. */
+  /* Check if the data directory exists already. A directory left by an
+  earlier clone is allowed here and the clone plugin decides if it can be
+  refreshed by incremental clone. */
   if (mysql_file_stat(key_file_misc, out_dir, &stat_info, MYF(0)) != nullptr) {
-    my_error(ER_DB_CREATE_EXISTS, MYF(0), in_dir);
-    return ER_DB_CREATE_EXISTS;
+    std::string clone_dir(out_dir);
+    clone_dir.append("#clone");
+
+    if (mysql_file_stat(key_file_misc, clone_dir.c_str(), &stat_info,
+                        MYF(0)) == nullptr) {
+      my_error(ER_DB_CREATE_EXISTS, MYF(0), in_dir);
+      return ER_DB_CREATE_EXISTS;
+    }
   }
 
   /* Check if path is within current data directory */
@@ -38,6 +38,7 @@
 #include "sql/filesort.h"
 #include "sql/handler.h"
 #include "sql/item.h"
+#include "sql/item_cmpfunc.h"
 #include "sql/item_sum.h"
 #include "sql/join_optimizer/access_path.h"
 #include "sql/join_optimizer/join_optimizer.h"
@@ -78,12 +79,127 @@ void SwitchSlice(JOIN *join, int slice_num) {
 
 }  // namespace
 
+/**
+  Whether item can be compared by FilterIterator::MatchComparisons(): an
+  integer column or an integer literal.
+*/
+static bool is_integer_column(const Item *item) {
+  if (item->type() != Item::FIELD_ITEM) return false;
+  switch (down_cast<const Item_field *>(item)->field->real_type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static bool is_integer_literal(const Item *item) {
+  return item->type() == Item::INT_ITEM && item->basic_const_item();
+}
+
+void FilterIterator::CompileCondition() {
+  std::vector<Item *> conjuncts;
+  if (m_condition->type() == Item::COND_ITEM &&
+      down_cast<Item_cond *>(m_condition)->functype() ==
+          Item_func::COND_AND_FUNC) {
+    for (Item &item : *down_cast<Item_cond *>(m_condition)->argument_list())
+      conjuncts.push_back(&item);
+  } else {
+    conjuncts.push_back(m_condition);
+  }
+
+  for (Item *item : conjuncts) {
+    if (item->type() != Item::FUNC_ITEM) break;
+    Item_func *const func = down_cast<Item_func *>(item);
+    Item_func::Functype op = func->functype();
+    if (op != Item_func::EQ_FUNC && op != Item_func::NE_FUNC &&
+        op != Item_func::LT_FUNC && op != Item_func::LE_FUNC &&
+        op != Item_func::GT_FUNC && op != Item_func::GE_FUNC)
+      break;
+
+    Item *column = func->arguments()[0];
+    Item *literal = func->arguments()[1];
+    if (!is_integer_column(column) || !is_integer_literal(literal)) {
+      std::swap(column, literal);
+      if (!is_integer_column(column) || !is_integer_literal(literal)) break;
+      // Keep the column on the left: 10 < a is a > 10.
+      if (op == Item_func::LT_FUNC)
+        op = Item_func::GT_FUNC;
+      else if (op == Item_func::LE_FUNC)
+        op = Item_func::GE_FUNC;
+      else if (op == Item_func::GT_FUNC)
+        op = Item_func::LT_FUNC;
+      else if (op == Item_func::GE_FUNC)
+        op = Item_func::LE_FUNC;
+    }
+
+    m_comparisons.push_back({down_cast<Item_field *>(column),
+                             literal->val_int(), literal->unsigned_flag, op});
+  }
+
+  if (m_comparisons.size() != conjuncts.size()) m_comparisons.clear();
+}
+
+bool FilterIterator::MatchComparisons() const {
+  for (const IntegerComparison &comparison : m_comparisons) {
+    const Field *field = comparison.field->field;
+    if (field->is_null()) return false;
+
+    const longlong a = field->val_int();
+    const longlong b = comparison.value;
+    const bool a_unsigned = field->is_unsigned();
+    const bool b_unsigned = comparison.value_is_unsigned;
+
+    // -1, 0 or 1 as a is less than, equal to or greater than b.
+    int cmp;
+    if (a_unsigned == b_unsigned || (a >= 0 && b >= 0)) {
+      cmp = a_unsigned || b_unsigned
+                ? (static_cast<ulonglong>(a) > static_cast<ulonglong>(b)) -
+                      (static_cast<ulonglong>(a) < static_cast<ulonglong>(b))
+                : (a > b) - (a < b);
+    } else {
+      // One is unsigned and the other negative.
+      cmp = a_unsigned ? 1 : -1;
+    }
+
+    bool matched;
+    switch (comparison.op) {
+      case Item_func::EQ_FUNC:
+        matched = cmp == 0;
+        break;
+      case Item_func::NE_FUNC:
+        matched = cmp != 0;
+        break;
+      case Item_func::LT_FUNC:
+        matched = cmp < 0;
+        break;
+      case Item_func::LE_FUNC:
+        matched = cmp <= 0;
+        break;
+      case Item_func::GT_FUNC:
+        matched = cmp > 0;
+        break;
+      default:
+        assert(comparison.op == Item_func::GE_FUNC);
+        matched = cmp >= 0;
+        break;
+    }
+    if (!matched) return false;
+  }
+  return true;
+}
+
 int FilterIterator::Read() {
   for (;;) {
     int err = m_source->Read();
     if (err != 0) return err;
 
-    bool matched = m_condition->val_int();
+    bool matched =
+        m_comparisons.empty() ? m_condition->val_int() : MatchComparisons();
 
     if (thd()->killed) {
       thd()->send_kill_message();
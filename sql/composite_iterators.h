@@ -75,7 +75,9 @@ class FilterIterator final : public RowIterator {
  public:
   FilterIterator(THD *thd, unique_ptr_destroy_only<RowIterator> source,
                  Item *condition)
-      : RowIterator(thd), m_source(move(source)), m_condition(condition) {}
+      : RowIterator(thd), m_source(move(source)), m_condition(condition) {
+    CompileCondition();
+  }
 
   bool Init() override { return m_source->Init(); }
 
@@ -91,9 +93,38 @@ class FilterIterator final : public RowIterator {
   }
   void UnlockRow() override { m_source->UnlockRow(); }
 
+  /// Whether Read() evaluates the condition without the Item tree.
+  bool IsConditionCompiled() const { return !m_comparisons.empty(); }
+
  private:
+  /**
+    A comparison of an integer column to an integer literal, such as
+    t1.a < 10, that Read() evaluates from the column directly instead of
+    through the Item tree of the condition.
+  */
+  struct IntegerComparison {
+    Item_field *field;
+    longlong value;
+    bool value_is_unsigned;
+    /// EQ_FUNC, NE_FUNC, LT_FUNC, LE_FUNC, GT_FUNC or GE_FUNC, with the
+    /// column on the left.
+    Item_func::Functype op;
+  };
+
+  /**
+    Fill m_comparisons if the condition is one comparison of the above form
+    or an AND of them only. A row matches when all of them are true; a NULL
+    column value makes its comparison false, which rejects the row just as
+    the NULL the condition would give.
+  */
+  void CompileCondition();
+
+  /// Evaluate m_comparisons for the current row.
+  bool MatchComparisons() const;
+
   unique_ptr_destroy_only<RowIterator> m_source;
   Item *m_condition;
+  std::vector<IntegerComparison> m_comparisons;
 };
 
 /**
@@ -25,6 +25,7 @@
 #ifndef CONNECTION_HANDLER_IMPL_INCLUDED
 #define CONNECTION_HANDLER_IMPL_INCLUDED
 
+#include <atomic>
 #include <list>
 
 #include "mysql/psi/mysql_cond.h"                 // mysql_cond_t
@@ -118,4 +119,55 @@ class One_thread_connection_handler : public Connection_handler {
   uint get_max_threads() const override { return 1; }
 };
 
+/**
+  This class represents the connection handling functionality
+  of connections being multiplexed over a pool of worker threads.
+
+  Connections are spread over thread groups. Each group waits for input
+  on its idle connections with epoll and hands a connection with input to
+  one of its worker threads, which executes the command and puts the
+  connection back into the poll set. At most 1 + thread_pool_oversubscribe
+  workers of a group execute commands at a time; workers waiting for locks
+  or I/O don't count. Connections with an open transaction are served
+  first. A timer thread starts an additional worker for a group that made
+  no progress for thread_pool_stall_limit milliseconds.
+
+  Only available where epoll is, init() fails elsewhere.
+*/
+class Thread_pool_connection_handler : public Connection_handler {
+  Thread_pool_connection_handler(const Thread_pool_connection_handler &);
+  Thread_pool_connection_handler &operator=(
+      const Thread_pool_connection_handler &);
+
+ public:
+  // System variables
+  static uint size;
+  static uint oversubscribe;
+  static uint stall_limit;
+  static uint max_threads;
+  static uint idle_timeout;
+  static bool buffered_read;
+
+  // Status variables
+  static std::atomic<ulong> thread_count;
+  static std::atomic<ulong> idle_thread_count;
+  static std::atomic<ulong> stall_count;
+
+  /**
+    Create the thread groups and start the timer thread.
+
+    @retval true if the pool could not be created.
+  */
+  static bool init();
+  static void destroy();
+
+  Thread_pool_connection_handler() {}
+  ~Thread_pool_connection_handler() override {}
+
+ protected:
+  bool add_connection(Channel_info *channel_info) override;
+
+  uint get_max_threads() const override { return max_threads; }
+};
+
 #endif  // CONNECTION_HANDLER_IMPL_INCLUDED
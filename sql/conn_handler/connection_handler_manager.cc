@@ -155,6 +155,18 @@ bool Connection_handler_manager::init() {
     case SCHEDULER_NO_THREADS:
       connection_handler = new (std::nothrow) One_thread_connection_handler();
       break;
+    case SCHEDULER_THREAD_POOL:
+      /*
+        Without epoll there is no thread pool, serve the connections the
+        default way then.
+      */
+      if (Thread_pool_connection_handler::init())
+        connection_handler =
+            new (std::nothrow) Per_thread_connection_handler();
+      else
+        connection_handler =
+            new (std::nothrow) Thread_pool_connection_handler();
+      break;
     default:
       assert(false);
   }
@@ -162,6 +174,7 @@ bool Connection_handler_manager::init() {
   if (connection_handler == nullptr) {
     // This is a static member function.
     Per_thread_connection_handler::destroy();
+    Thread_pool_connection_handler::destroy();
     return true;
   }
 
@@ -172,6 +185,7 @@ bool Connection_handler_manager::init() {
     delete connection_handler;
     // This is a static member function.
     Per_thread_connection_handler::destroy();
+    Thread_pool_connection_handler::destroy();
     return true;
   }
 
@@ -208,6 +222,7 @@ void Connection_handler_manager::wait_till_no_connection() {
 
 void Connection_handler_manager::destroy_instance() {
   Per_thread_connection_handler::destroy();
+  Thread_pool_connection_handler::destroy();
 
   if (m_instance != nullptr) {
     delete m_instance;
@@ -0,0 +1,838 @@
+/*
+   Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include "my_config.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+#include "my_compiler.h"
+#include "my_dbug.h"
+#include "my_inttypes.h"
+#include "my_psi_config.h"
+#include "my_systime.h"  // my_micro_time
+#include "my_thread.h"
+#include "mysql/components/services/psi_thread_bits.h"
+#include "mysql/psi/mysql_cond.h"
+#include "mysql/psi/mysql_mutex.h"
+#include "mysql/psi/mysql_socket.h"
+#include "mysql/psi/mysql_thread.h"
+#include "mysql/service_thd_wait.h"
+#include "mysqld_error.h"                   // ER_*
+#include "sql/conn_handler/channel_info.h"  // Channel_info
+#include "sql/conn_handler/connection_handler_impl.h"
+#include "sql/conn_handler/connection_handler_manager.h"  // Connection_handler_manager
+#include "sql/conn_handler/thread_pool_queue.h"
+#include "sql/current_thd.h"
+#include "sql/mysqld.h"              // connection_attrib
+#include "sql/mysqld_thd_manager.h"  // Global_THD_manager
+#include "sql/protocol_classic.h"
+#include "sql/sql_class.h"             // THD
+#include "sql/sql_connect.h"           // close_connection
+#include "sql/sql_parse.h"             // do_command
+#include "sql/sql_thd_internal_api.h"  // thd_set_thread_stack
+#include "violite.h"
+
+// Initialize static members
+uint Thread_pool_connection_handler::size = 0;
+uint Thread_pool_connection_handler::oversubscribe = 3;
+uint Thread_pool_connection_handler::stall_limit = 500;
+uint Thread_pool_connection_handler::max_threads = 1000;
+uint Thread_pool_connection_handler::idle_timeout = 60;
+bool Thread_pool_connection_handler::buffered_read = true;
+std::atomic<ulong> Thread_pool_connection_handler::thread_count{0};
+std::atomic<ulong> Thread_pool_connection_handler::idle_thread_count{0};
+std::atomic<ulong> Thread_pool_connection_handler::stall_count{0};
+
+#ifdef HAVE_EPOLL
+
+namespace {
+
+struct Thread_group;
+
+/**
+  A client connection served by the thread pool.
+*/
+struct Pool_connection {
+  /** until the connection is picked up for login. */
+  Channel_info *channel_info{nullptr};
+  THD *thd{nullptr};
+  Thread_group *group{nullptr};
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_thread *psi{nullptr};
+#endif
+  bool logged_in{false};
+  /**
+    the socket is in the group's poll set (possibly disarmed). Protected
+    by LOCK_thd_data, see start_io().
+  */
+  bool in_poll_set{false};
+  /** inside thd_wait_begin()/thd_wait_end(). */
+  bool in_wait{false};
+
+  /**
+    waiting in the poll set for input.
+
+    Whoever clears it under the group mutex owns the connection. Protected
+    by the group mutex.
+  */
+  bool waiting{false};
+  /** when waiting times out, in microseconds. Protected by the group mutex. */
+  ulonglong wait_deadline{0};
+
+  /** position in Thread_group::connections. */
+  std::list<Pool_connection *>::iterator pos;
+};
+
+struct Thread_group : Thread_pool_queue<Pool_connection> {
+  mysql_mutex_t mutex;
+  /** idle workers wait here for work. */
+  mysql_cond_t cond;
+  int pollfd{-1};
+
+  /** all connections of the group, scanned for wait_timeout. */
+  std::list<Pool_connection *> connections;
+  /**
+    closed connections that may still be in the batch of events the current
+    listener is processing. Freed when it is done.
+  */
+  std::vector<Pool_connection *> zombies;
+
+  /** workers, including the ones being started. */
+  uint thread_count{0};
+  /** workers executing a command and blocked in a wait. */
+  uint blocked_thread_count{0};
+  /** workers waiting on cond. */
+  uint waiting_thread_count{0};
+  /** a worker is waiting in epoll_wait(). */
+  bool has_listener{false};
+  bool shutdown{false};
+};
+
+constexpr int kMaxEvents = 16;
+constexpr int kListenerTimeoutMs = 1000;
+
+Thread_group *all_groups = nullptr;
+uint group_count = 0;
+std::atomic<uint> next_group{0};
+
+my_thread_handle timer_thread;
+bool timer_shutdown = false;  // Protected by LOCK_thread_pool_timer
+mysql_mutex_t LOCK_thread_pool_timer;
+mysql_cond_t COND_thread_pool_timer;
+
+#ifdef HAVE_PSI_INTERFACE
+PSI_mutex_key key_LOCK_thread_group;
+PSI_mutex_key key_LOCK_thread_pool_timer;
+
+PSI_mutex_info all_thread_pool_mutexes[] = {
+    {&key_LOCK_thread_group, "LOCK_thread_group", 0, 0, PSI_DOCUMENT_ME},
+    {&key_LOCK_thread_pool_timer, "LOCK_thread_pool_timer",
+     PSI_FLAG_SINGLETON, 0, PSI_DOCUMENT_ME}};
+
+PSI_cond_key key_COND_thread_group;
+PSI_cond_key key_COND_thread_pool_timer;
+
+PSI_cond_info all_thread_pool_conds[] = {
+    {&key_COND_thread_group, "COND_thread_group", 0, 0, PSI_DOCUMENT_ME},
+    {&key_COND_thread_pool_timer, "COND_thread_pool_timer", PSI_FLAG_SINGLETON,
+     0, PSI_DOCUMENT_ME}};
+
+PSI_thread_key key_thread_pool_worker;
+PSI_thread_key key_thread_pool_timer;
+
+PSI_thread_info all_thread_pool_threads[] = {
+    {&key_thread_pool_worker, "thread_pool_worker", 0, 0, PSI_DOCUMENT_ME},
+    {&key_thread_pool_timer, "thread_pool_timer", PSI_FLAG_SINGLETON, 0,
+     PSI_DOCUMENT_ME}};
+#endif
+
+Vio *connection_vio(Pool_connection *conn) {
+  return conn->thd->get_protocol_classic()->get_vio();
+}
+
+}  // namespace
+
+extern "C" {
+static void *worker_main(void *arg);
+}
+
+/**
+  Start a worker for the group.
+
+  The group mutex must be held.
+
+  @retval true if the thread could not be created.
+*/
+static bool create_worker(Thread_group *group) {
+  if (Thread_pool_connection_handler::thread_count >=
+      Thread_pool_connection_handler::max_threads)
+    return true;
+
+  my_thread_handle id;
+  if (mysql_thread_create(key_thread_pool_worker, &id, &connection_attrib,
+                          worker_main, group) != 0)
+    return true;
+
+  group->thread_count++;
+  Thread_pool_connection_handler::thread_count++;
+  Global_THD_manager::get_instance()->inc_thread_created();
+  return false;
+}
+
+static bool too_many_active_threads(const Thread_group *group) {
+  return group->too_many_active_threads(
+      Thread_pool_connection_handler::oversubscribe);
+}
+
+/**
+  Make sure someone serves the queued connections of the group, or polls
+  for new input if nobody does.
+
+  The group mutex must be held.
+*/
+static void wake_or_create_worker(Thread_group *group) {
+  if (group->waiting_thread_count > 0) {
+    mysql_cond_signal(&group->cond);
+    return;
+  }
+
+  // a worker that is starting or between two commands picks it up
+  if (group->thread_count > group->active_thread_count +
+                                group->blocked_thread_count +
+                                (group->has_listener ? 1 : 0))
+    return;
+
+  if (too_many_active_threads(group) && group->high_prio_queue.empty() &&
+      group->has_listener)
+    return;
+
+  create_worker(group);
+}
+
+/**
+  Queue a connection which has input.
+
+  The group mutex must be held.
+*/
+static void enqueue(Thread_group *group, Pool_connection *conn) {
+  conn->waiting = false;
+  group->enqueue(conn, conn->thd != nullptr &&
+                           conn->thd->in_active_multi_stmt_transaction());
+}
+
+/**
+  Take the next connection to serve from the queues.
+
+  The group mutex must be held.
+*/
+static Pool_connection *dequeue(Thread_group *group) {
+  return group->dequeue(Thread_pool_connection_handler::oversubscribe);
+}
+
+/**
+  Wait for input on the connections of the group and queue them.
+
+  The group mutex must be held, it is released while waiting.
+*/
+static void listen(Thread_group *group) {
+  struct epoll_event events[kMaxEvents];
+
+  group->has_listener = true;
+  mysql_mutex_unlock(&group->mutex);
+
+  const int n =
+      epoll_wait(group->pollfd, events, kMaxEvents, kListenerTimeoutMs);
+
+  mysql_mutex_lock(&group->mutex);
+  group->has_listener = false;
+
+  for (int i = 0; i < n; i++) {
+    auto *conn = static_cast<Pool_connection *>(events[i].data.ptr);
+
+    // already taken by a kill notification
+    if (!conn->waiting) continue;
+
+    enqueue(group, conn);
+  }
+
+  // no listener references them anymore
+  for (auto *conn : group->zombies) delete conn;
+  group->zombies.clear();
+}
+
+/**
+  Get the next connection to serve for a worker.
+
+  The group mutex must be held.
+
+  @retval nullptr if the worker should exit.
+*/
+static Pool_connection *get_event(Thread_group *group) {
+  for (;;) {
+    if (group->shutdown) return nullptr;
+
+    Pool_connection *conn = dequeue(group);
+    if (conn != nullptr) {
+      // more work, or nobody left to poll: get help
+      if (!group->queues_empty() ||
+          (!group->has_listener && group->waiting_thread_count > 0))
+        wake_or_create_worker(group);
+
+      return conn;
+    }
+
+    if (!group->has_listener) {
+      listen(group);
+      continue;
+    }
+
+    group->waiting_thread_count++;
+    Thread_pool_connection_handler::idle_thread_count++;
+
+    struct timespec abstime;
+    set_timespec(&abstime, Thread_pool_connection_handler::idle_timeout);
+    const int err = mysql_cond_timedwait(&group->cond, &group->mutex, &abstime);
+
+    group->waiting_thread_count--;
+    Thread_pool_connection_handler::idle_thread_count--;
+
+    // retire idle workers, but keep one to poll
+    if (is_timeout(err) && group->thread_count > 1) return nullptr;
+  }
+}
+
+/**
+  Make the connection's THD the current one of the worker.
+*/
+static void attach(Pool_connection *conn, char *stack_start) {
+  THD *thd = conn->thd;
+
+  thd_set_thread_stack(thd, stack_start);
+  thd->store_globals();
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(set_thread)(conn->psi);
+  PSI_THREAD_CALL(set_thread_os_id)(conn->psi);
+#endif
+  mysql_thread_set_psi_id(thd->thread_id());
+  mysql_thread_set_psi_THD(thd);
+  mysql_socket_set_thread_owner(connection_vio(conn)->mysql_socket);
+}
+
+static void detach(Pool_connection *conn,
+                   PSI_thread *worker_psi MY_ATTRIBUTE((unused))) {
+  conn->thd->restore_globals();
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  PSI_THREAD_CALL(set_thread)(worker_psi);
+#endif
+}
+
+/**
+  Create the THD of a new connection and authenticate the client.
+
+  @retval true if the connection has to be closed.
+*/
+static bool login(Pool_connection *conn, char *stack_start) {
+  Channel_info *channel_info = conn->channel_info;
+  conn->channel_info = nullptr;
+
+  THD *thd = channel_info->create_thd();
+  if (thd == nullptr) {
+    connection_errors_internal++;
+    channel_info->send_error_and_close_channel(ER_OUT_OF_RESOURCES, 0, false);
+    delete channel_info;
+    return true;
+  }
+  delete channel_info;
+
+  thd->set_new_thread_id();
+  thd->scheduler.data = conn;
+  conn->thd = thd;
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  conn->psi = PSI_THREAD_CALL(new_thread)(key_thread_one_connection, thd,
+                                          thd->thread_id());
+  thd->set_psi(conn->psi);
+#endif
+
+  attach(conn, stack_start);
+  Global_THD_manager::get_instance()->add_thd(thd);
+
+  if (thd_prepare_connection(thd)) {
+    Connection_handler_manager::get_instance()->inc_aborted_connects();
+    return true;
+  }
+
+  conn->logged_in = true;
+
+  /*
+    Not earlier: a buffer filled during the connection phase could
+    swallow the start of the TLS handshake. TLS connections keep reading
+    through their BIO. handle_event() drains the buffer before the
+    connection goes back to the poll set.
+  */
+  if (Thread_pool_connection_handler::buffered_read)
+    vio_set_buffered_read(connection_vio(conn));
+  return false;
+}
+
+/**
+  Put the connection back into the poll set.
+
+  @retval true if the connection has to be closed.
+*/
+static bool start_io(Pool_connection *conn) {
+  THD *thd = conn->thd;
+  Thread_group *group = conn->group;
+
+  // a concurrent KILL closes the socket under LOCK_thd_data
+  mysql_mutex_lock(&thd->LOCK_thd_data);
+  if (thd->killed == THD::KILL_CONNECTION) {
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+    return true;
+  }
+
+  mysql_mutex_lock(&group->mutex);
+  conn->waiting = true;
+  conn->wait_deadline =
+      my_micro_time() + thd->variables.net_wait_timeout * 1000000ULL;
+  mysql_mutex_unlock(&group->mutex);
+
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLONESHOT;
+  ev.data.ptr = conn;
+
+  const int fd = mysql_socket_getfd(connection_vio(conn)->mysql_socket);
+  const int res = thread_pool_arm(&conn->in_poll_set, [&](bool add) {
+    return epoll_ctl(group->pollfd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd,
+                     &ev);
+  });
+  mysql_mutex_unlock(&thd->LOCK_thd_data);
+
+  if (res != 0) {
+    bool owned;
+    mysql_mutex_lock(&group->mutex);
+    owned = conn->waiting;
+    conn->waiting = false;
+    mysql_mutex_unlock(&group->mutex);
+
+    // if a kill notification took it meanwhile, it will close it
+    return owned;
+  }
+
+  return false;
+}
+
+/**
+  Remove a connection from its group and free it.
+
+  The socket is closed already, which removed it from the poll set.
+*/
+static void retire(Pool_connection *conn) {
+  Thread_group *group = conn->group;
+
+  mysql_mutex_lock(&group->mutex);
+  group->connections.erase(conn->pos);
+  if (group->has_listener)
+    group->zombies.push_back(conn);
+  else
+    delete conn;
+  mysql_mutex_unlock(&group->mutex);
+}
+
+/**
+  Serve a connection that has input: authenticate it if it is new, else
+  execute its commands.
+*/
+static void handle_event(Pool_connection *conn,
+                         PSI_thread *worker_psi MY_ATTRIBUTE((unused))) {
+  char stack_start;
+  bool close;
+
+  if (conn->thd == nullptr) {
+    close = login(conn, &stack_start);
+
+    if (conn->thd == nullptr) {
+      Connection_handler_manager::get_instance()->inc_aborted_connects();
+      Connection_handler_manager::dec_connection_count();
+      retire(conn);
+      return;
+    }
+  } else {
+    attach(conn, &stack_start);
+    close = false;
+  }
+
+  THD *thd = conn->thd;
+  if (!close) {
+    // serve all commands the client sent already before polling again
+    do {
+      if (!thd_connection_alive(thd) || do_command(thd)) {
+        close = true;
+        break;
+      }
+    } while (connection_vio(conn)->has_data(connection_vio(conn)));
+  }
+
+  if (!close) {
+    detach(conn, worker_psi);
+    if (!start_io(conn)) return;
+
+    attach(conn, &stack_start);
+  }
+
+  if (conn->logged_in) end_connection(thd);
+  close_connection(thd, 0, false, false);
+
+  thd->get_stmt_da()->reset_diagnostics_area();
+  thd->release_resources();
+  Global_THD_manager::get_instance()->remove_thd(thd);
+  Connection_handler_manager::dec_connection_count();
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  thd->set_psi(nullptr);
+  PSI_THREAD_CALL(delete_current_thread)();
+  PSI_THREAD_CALL(set_thread)(worker_psi);
+#endif
+
+  delete thd;
+  current_thd = nullptr;
+  THR_MALLOC = nullptr;
+
+  retire(conn);
+}
+
+extern "C" {
+static void *worker_main(void *arg) {
+  Thread_group *group = static_cast<Thread_group *>(arg);
+  PSI_thread *worker_psi = nullptr;
+
+  if (my_thread_init()) {
+    mysql_mutex_lock(&group->mutex);
+    group->thread_count--;
+    Thread_pool_connection_handler::thread_count--;
+    mysql_cond_broadcast(&group->cond);
+    mysql_mutex_unlock(&group->mutex);
+    my_thread_exit(nullptr);
+    return nullptr;
+  }
+
+#ifdef HAVE_PSI_THREAD_INTERFACE
+  worker_psi = PSI_THREAD_CALL(get_thread)();
+#endif
+
+  mysql_mutex_lock(&group->mutex);
+  for (;;) {
+    Pool_connection *conn = get_event(group);
+    if (conn == nullptr) break;
+
+    mysql_mutex_unlock(&group->mutex);
+    handle_event(conn, worker_psi);
+    mysql_mutex_lock(&group->mutex);
+
+    group->active_thread_count--;
+  }
+  group->thread_count--;
+  Thread_pool_connection_handler::thread_count--;
+  // destroy() waits for the workers to exit
+  mysql_cond_broadcast(&group->cond);
+  mysql_mutex_unlock(&group->mutex);
+
+  my_thread_end();
+  my_thread_exit(nullptr);
+  return nullptr;
+}
+}  // extern "C"
+
+/**
+  Close connections that exceeded wait_timeout and get a stalled group
+  going again.
+*/
+static void check_group(Thread_group *group, ulonglong now) {
+  mysql_mutex_lock(&group->mutex);
+
+  if (group->check_stall(!group->has_listener &&
+                         !group->connections.empty())) {
+    // all workers are busy with long running commands
+    Thread_pool_connection_handler::stall_count++;
+    wake_or_create_worker(group);
+  }
+
+  for (auto *conn : group->connections) {
+    if (!conn->waiting || conn->wait_deadline > now) continue;
+
+    // LOCK_thd_data is taken before the group mutex elsewhere, retry next
+    // time if it is busy
+    if (mysql_mutex_trylock(&conn->thd->LOCK_thd_data) != 0) continue;
+
+    // the client gets EOF like when the server closes the idle connection
+    // itself, which the worker handles as usual
+    Vio *vio = connection_vio(conn);
+    if (!vio->inactive) mysql_socket_shutdown(vio->mysql_socket, SHUT_RD);
+    conn->wait_deadline = ~0ULL;
+
+    mysql_mutex_unlock(&conn->thd->LOCK_thd_data);
+  }
+
+  mysql_mutex_unlock(&group->mutex);
+}
+
+extern "C" {
+static void *timer_main(void *) {
+  my_thread_init();
+
+  mysql_mutex_lock(&LOCK_thread_pool_timer);
+  while (!timer_shutdown) {
+    struct timespec abstime;
+    set_timespec_nsec(&abstime,
+                      Thread_pool_connection_handler::stall_limit * 1000000ULL);
+    mysql_cond_timedwait(&COND_thread_pool_timer, &LOCK_thread_pool_timer,
+                         &abstime);
+    if (timer_shutdown) break;
+
+    mysql_mutex_unlock(&LOCK_thread_pool_timer);
+    const ulonglong now = my_micro_time();
+    for (uint i = 0; i < group_count; i++) check_group(&all_groups[i], now);
+    mysql_mutex_lock(&LOCK_thread_pool_timer);
+  }
+  mysql_mutex_unlock(&LOCK_thread_pool_timer);
+
+  my_thread_end();
+  return nullptr;
+}
+}  // extern "C"
+
+static Pool_connection *pool_connection(THD *thd) {
+  return thd == nullptr ? nullptr
+                        : static_cast<Pool_connection *>(thd->scheduler.data);
+}
+
+/**
+  A worker blocks: let another one serve the group meanwhile.
+*/
+static void pool_wait_begin(THD *thd, int) {
+  Pool_connection *conn = pool_connection(thd);
+  if (conn == nullptr || conn->in_wait) return;
+
+  conn->in_wait = true;
+
+  Thread_group *group = conn->group;
+  mysql_mutex_lock(&group->mutex);
+  group->active_thread_count--;
+  group->blocked_thread_count++;
+  if (!group->queues_empty()) wake_or_create_worker(group);
+  mysql_mutex_unlock(&group->mutex);
+}
+
+static void pool_wait_end(THD *thd) {
+  Pool_connection *conn = pool_connection(thd);
+  if (conn == nullptr || !conn->in_wait) return;
+
+  conn->in_wait = false;
+
+  Thread_group *group = conn->group;
+  mysql_mutex_lock(&group->mutex);
+  group->blocked_thread_count--;
+  group->active_thread_count++;
+  mysql_mutex_unlock(&group->mutex);
+}
+
+/**
+  KILL closed the socket of the connection, which removed it from the poll
+  set: queue it so that a worker closes it.
+
+  Called with LOCK_thd_data held.
+*/
+static void pool_post_kill_notification(THD *thd) {
+  Pool_connection *conn = pool_connection(thd);
+  if (conn == nullptr) return;
+
+  Thread_group *group = conn->group;
+  mysql_mutex_lock(&group->mutex);
+  if (conn->waiting) {
+    group->enqueue(conn, true);
+    conn->waiting = false;
+    wake_or_create_worker(group);
+  }
+  mysql_mutex_unlock(&group->mutex);
+}
+
+static THD_event_functions pool_event_functions = {
+    pool_wait_begin, pool_wait_end, pool_post_kill_notification};
+
+bool Thread_pool_connection_handler::init() {
+#ifdef HAVE_PSI_INTERFACE
+  int count = static_cast<int>(array_elements(all_thread_pool_mutexes));
+  mysql_mutex_register("sql", all_thread_pool_mutexes, count);
+
+  count = static_cast<int>(array_elements(all_thread_pool_conds));
+  mysql_cond_register("sql", all_thread_pool_conds, count);
+
+  count = static_cast<int>(array_elements(all_thread_pool_threads));
+  mysql_thread_register("sql", all_thread_pool_threads, count);
+#endif
+
+  group_count = size != 0 ? size : std::thread::hardware_concurrency();
+  if (group_count == 0) group_count = 1;
+
+  all_groups = new (std::nothrow) Thread_group[group_count];
+  if (all_groups == nullptr) return true;
+
+  for (uint i = 0; i < group_count; i++) {
+    Thread_group *group = &all_groups[i];
+
+    mysql_mutex_init(key_LOCK_thread_group, &group->mutex, MY_MUTEX_INIT_FAST);
+    mysql_cond_init(key_COND_thread_group, &group->cond);
+
+    group->pollfd = epoll_create(kMaxEvents);
+    if (group->pollfd == -1) {
+      destroy();
+      return true;
+    }
+  }
+
+  mysql_mutex_init(key_LOCK_thread_pool_timer, &LOCK_thread_pool_timer,
+                   MY_MUTEX_INIT_FAST);
+  mysql_cond_init(key_COND_thread_pool_timer, &COND_thread_pool_timer);
+  timer_shutdown = false;
+
+  if (mysql_thread_create(key_thread_pool_timer, &timer_thread, nullptr,
+                          timer_main, nullptr) != 0) {
+    mysql_mutex_destroy(&LOCK_thread_pool_timer);
+    mysql_cond_destroy(&COND_thread_pool_timer);
+    destroy();
+    return true;
+  }
+
+  Connection_handler_manager::event_functions = &pool_event_functions;
+  return false;
+}
+
+void Thread_pool_connection_handler::destroy() {
+  if (all_groups == nullptr) return;
+
+  if (Connection_handler_manager::event_functions == &pool_event_functions) {
+    mysql_mutex_lock(&LOCK_thread_pool_timer);
+    timer_shutdown = true;
+    mysql_cond_signal(&COND_thread_pool_timer);
+    mysql_mutex_unlock(&LOCK_thread_pool_timer);
+    my_thread_join(&timer_thread, nullptr);
+
+    mysql_mutex_destroy(&LOCK_thread_pool_timer);
+    mysql_cond_destroy(&COND_thread_pool_timer);
+
+    Connection_handler_manager::event_functions = nullptr;
+  }
+
+  for (uint i = 0; i < group_count; i++) {
+    Thread_group *group = &all_groups[i];
+
+    if (group->pollfd != -1) {
+      mysql_mutex_lock(&group->mutex);
+      group->shutdown = true;
+      mysql_cond_broadcast(&group->cond);
+      // a listener notices within kListenerTimeoutMs
+      while (group->thread_count > 0)
+        mysql_cond_wait(&group->cond, &group->mutex);
+      for (auto *conn : group->zombies) delete conn;
+      group->zombies.clear();
+      mysql_mutex_unlock(&group->mutex);
+
+      close(group->pollfd);
+    }
+
+    mysql_mutex_destroy(&group->mutex);
+    mysql_cond_destroy(&group->cond);
+  }
+
+  delete[] all_groups;
+  all_groups = nullptr;
+  group_count = 0;
+}
+
+bool Thread_pool_connection_handler::add_connection(
+    Channel_info *channel_info) {
+  Pool_connection *conn = new (std::nothrow) Pool_connection;
+  if (conn == nullptr) {
+    connection_errors_internal++;
+    channel_info->send_error_and_close_channel(ER_OUT_OF_RESOURCES, 0, false);
+    Connection_handler_manager::dec_connection_count();
+    return true;
+  }
+
+  Thread_group *group =
+      &all_groups[thread_pool_next_group(&next_group, group_count)];
+  conn->channel_info = channel_info;
+  conn->group = group;
+
+  mysql_mutex_lock(&group->mutex);
+  if (group->thread_count == 0) {
+    if (create_worker(group)) {
+      mysql_mutex_unlock(&group->mutex);
+
+      delete conn;
+      connection_errors_internal++;
+      channel_info->send_error_and_close_channel(ER_CANT_CREATE_THREAD, 0,
+                                                 true);
+      Connection_handler_manager::dec_connection_count();
+      return true;
+    }
+  } else {
+    wake_or_create_worker(group);
+  }
+
+  group->connections.push_back(conn);
+  conn->pos = std::prev(group->connections.end());
+  // the login is served like input on an established connection
+  group->enqueue(conn, false);
+  mysql_mutex_unlock(&group->mutex);
+
+  return false;
+}
+
+#else  // HAVE_EPOLL
+
+bool Thread_pool_connection_handler::init() { return true; }
+
+void Thread_pool_connection_handler::destroy() {}
+
+bool Thread_pool_connection_handler::add_connection(Channel_info *) {
+  assert(false);
+  return true;
+}
+
+#endif  // HAVE_EPOLL
@@ -0,0 +1,154 @@
+#ifndef THREAD_POOL_QUEUE_INCLUDED
+#define THREAD_POOL_QUEUE_INCLUDED
+
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <atomic>
+#include <deque>
+
+#include "my_inttypes.h"
+
+/**
+  Pick the thread group of a new connection, round robin.
+
+  @param next         counter shared by all connections
+  @param group_count  number of thread groups, not zero
+*/
+inline uint thread_pool_next_group(std::atomic<uint> *next, uint group_count) {
+  return (*next)++ % group_count;
+}
+
+/**
+  Put a connection's socket into the poll set of its group: add it the
+  first time, modify it later. in_poll_set is set before arming, because
+  the armed socket can wake another worker at once, which has to modify
+  it rather than add it again. It is reset if adding failed.
+
+  Call it under the lock that serializes the arming of the connection.
+
+  @param in_poll_set  whether the socket was added, updated
+  @param arm          arm(add) adds or modifies the socket, returns 0 on
+                      success
+
+  @return the result of arm
+*/
+template <typename Arm>
+int thread_pool_arm(bool *in_poll_set, Arm arm) {
+  const bool add = !*in_poll_set;
+  *in_poll_set = true;
+  const int res = arm(add);
+  if (res != 0 && add) *in_poll_set = false;
+  return res;
+}
+
+/**
+  The work queues of a thread group of the pool-of-threads connection
+  handler, and the state that decides which connection a worker serves
+  next. Every member is protected by the group mutex.
+
+  Connections with an open transaction go to the high priority queue and
+  are served even when the group already has its limit of active workers,
+  so that their locks are released sooner.
+*/
+template <typename Connection>
+struct Thread_pool_queue {
+  /** connections with input, served in order. */
+  std::deque<Connection *> queue;
+  /** connections with input and an open transaction, served first. */
+  std::deque<Connection *> high_prio_queue;
+
+  /** workers executing a command and not blocked in a wait. */
+  uint active_thread_count{0};
+  /** the timer detected a stall, the active thread limit is lifted once. */
+  bool stalled{false};
+
+  /** events picked up by workers; the timer compares it between checks. */
+  ulonglong dequeue_count{0};
+  ulonglong last_dequeue_count{0};
+
+  bool queues_empty() const { return queue.empty() && high_prio_queue.empty(); }
+
+  /**
+    At most 1 + oversubscribe workers execute commands, unless the group
+    is stalled.
+  */
+  bool too_many_active_threads(uint oversubscribe) const {
+    return active_thread_count >= 1 + oversubscribe && !stalled;
+  }
+
+  void enqueue(Connection *conn, bool high_prio) {
+    if (high_prio)
+      high_prio_queue.push_back(conn);
+    else
+      queue.push_back(conn);
+  }
+
+  /**
+    Take the next connection to serve, and count the worker that serves it
+    as active.
+
+    @retval nullptr if there is nothing to serve within the active limit.
+  */
+  Connection *dequeue(uint oversubscribe) {
+    Connection *conn = nullptr;
+
+    if (!high_prio_queue.empty()) {
+      conn = high_prio_queue.front();
+      high_prio_queue.pop_front();
+    } else if (!queue.empty() && !too_many_active_threads(oversubscribe)) {
+      conn = queue.front();
+      queue.pop_front();
+    }
+
+    if (conn != nullptr) {
+      active_thread_count++;
+      dequeue_count++;
+      stalled = false;
+    }
+
+    return conn;
+  }
+
+  /**
+    Called by the timer every thread_pool_stall_limit milliseconds.
+
+    The group is stalled if no worker picked up work since the last check
+    while connections were queued, or while no worker polled the group's
+    connections.
+
+    @param unpolled  the group has connections and nobody polls them
+
+    @retval true if the group is stalled.
+  */
+  bool check_stall(bool unpolled) {
+    const bool progress = dequeue_count != last_dequeue_count;
+    last_dequeue_count = dequeue_count;
+
+    if (progress || (queues_empty() && !unpolled)) return false;
+
+    stalled = true;
+    return true;
+  }
+};
+
+#endif  // THREAD_POOL_QUEUE_INCLUDED
@@ -2153,6 +2153,27 @@ static bool fill_partitioning_from_dd(THD *thd, TABLE_SHARE *share,
   if (!share->partition_info_str) return true;
 
   share->partition_info_str_len = buf_len;
+
+  if (part_info->has_shareable_partitions()) {
+    /*
+      Parsing only needs to produce the partition expression, so any
+      partitioning type taking an expression will do.
+    */
+    static const char header_start[] = " PARTITION BY HASH (";
+    const size_t header_len =
+        sizeof(header_start) - 1 + part_info->part_func_len + 1;
+    char *header =
+        static_cast<char *>(share->mem_root.Alloc(header_len + 1));
+    if (!header) return true;
+    char *pos = my_stpcpy(header, header_start);
+    memcpy(pos, part_info->part_func_string, part_info->part_func_len);
+    pos += part_info->part_func_len;
+    *pos++ = ')';
+    *pos = '\0';
+    share->partition_header_str = header;
+    share->partition_header_str_len = header_len;
+  }
+
   share->m_part_info = part_info;
   return (false);
 }
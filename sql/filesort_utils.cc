@@ -121,6 +121,46 @@ class Mem_compare_varlen_key {
   bool use_hash;
 };
 
+/*
+  Radix sort pays off over comparison sorts for many rows of short keys:
+  it does one pass over the rows per byte of key.
+*/
+constexpr size_t RADIX_SORT_MIN_ROWS = 10000;
+constexpr size_t RADIX_SORT_MAX_KEY_LENGTH = 16;
+
+/*
+  LSD radix sort of the records in [first, first + n) on their first
+  key_len bytes, the last byte first. Stable, like std::stable_sort, and
+  gives the same order as Mem_compare. tmp must have room for n pointers.
+  Bytes that are the same in every key take no pass.
+*/
+void radix_sort_records(uchar **first, size_t n, size_t key_len,
+                        uchar **tmp) {
+  assert(key_len <= RADIX_SORT_MAX_KEY_LENGTH);
+  size_t counts[RADIX_SORT_MAX_KEY_LENGTH][256] = {};
+  for (size_t i = 0; i < n; ++i) {
+    const uchar *key = first[i];
+    for (size_t byte = 0; byte < key_len; ++byte) ++counts[byte][key[byte]];
+  }
+
+  uchar **src = first;
+  uchar **dst = tmp;
+  for (size_t byte = key_len; byte-- > 0;) {
+    size_t *count = counts[byte];
+    if (count[src[0][byte]] == n) continue;
+
+    size_t offset = 0;
+    for (size_t value = 0; value < 256; ++value) {
+      const size_t c = count[value];
+      count[value] = offset;
+      offset += c;
+    }
+    for (size_t i = 0; i < n; ++i) dst[count[src[i][byte]]++] = src[i];
+    std::swap(src, dst);
+  }
+  if (src != first) memcpy(first, src, n * sizeof(*first));
+}
+
 template <class Comp>
 class Equality_from_less {
  public:
@@ -191,6 +231,34 @@ size_t Filesort_buffer::sort_buffer(Sort_param *param, size_t num_input_rows,
     key_len -= param->sum_ref_length;
   }
 
+  /*
+    Many rows of short keys, all of which need sorting: radix sort them if
+    its second array of record pointers fits in the rest of the sort buffer.
+  */
+  if (num_input_rows >= RADIX_SORT_MIN_ROWS &&
+      key_len <= RADIX_SORT_MAX_KEY_LENGTH && !prefilter_nth_element) {
+    const size_t tmp_bytes = num_input_rows * sizeof(uchar *);
+    const size_t used_bytes =
+        m_record_pointers.capacity() * sizeof(m_record_pointers[0]) +
+        m_current_block_size + m_space_used_other_blocks;
+    if (used_bytes + tmp_bytes <= m_max_size_in_bytes) {
+      unique_ptr_my_free<uchar *[]> tmp(static_cast<uchar **>(
+          my_malloc(key_memory_Filesort_buffer_sort_keys, tmp_bytes, MYF(0))));
+      if (tmp != nullptr) {
+        m_peak_memory_used = max(m_peak_memory_used, used_bytes + tmp_bytes);
+        param->m_sort_algorithm = Sort_param::FILESORT_ALG_RADIX;
+        radix_sort_records(&*it_begin, num_input_rows, key_len, tmp.get());
+        if (param->m_remove_duplicates) {
+          num_input_rows =
+              unique(it_begin, it_end,
+                     Equality_from_less<Mem_compare>(Mem_compare(key_len))) -
+              it_begin;
+        }
+        return std::min(num_input_rows, max_output_rows);
+      }
+    }
+  }
+
   /*
     std::stable_sort has some extra overhead in allocating the temp buffer,
     which takes some time. The cutover point where it starts to get faster
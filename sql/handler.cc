@@ -6708,6 +6708,8 @@ int DsMrr_impl::dsmrr_fill_buffer() {
   varlen_sort(
       rowids_buf, rowids_buf_cur, elem_size,
       [this](const uchar *a, const uchar *b) { return h->cmp_ref(a, b) < 0; });
+  h->prefetch_positions(rowids_buf, (rowids_buf_cur - rowids_buf) / elem_size,
+                        elem_size);
   rowids_buf_last = rowids_buf_cur;
   rowids_buf_cur = rowids_buf;
   return 0;
@@ -74,6 +74,7 @@ class Alter_info;
 class Create_field;
 class Field;
 class Item;
+class my_decimal;
 class JOIN;
 class Json_dom;
 class Partition_handler;
@@ -514,6 +515,12 @@ enum enum_alter_inplace_result {
 */
 #define HA_MULTI_VALUED_KEY_SUPPORT (1LL << 55)
 
+/**
+  column_aggregate() counts the non-NULL values of a column over the whole
+  table and sums them for an integer column, see optimize_aggregated_query().
+*/
+#define HA_AGGREGATE_COLUMN_INSTANT (1LL << 56)
+
 /*
   Bits in index_flags(index_number) for what you can do with index.
   If you do not implement indexes, just return zero here.
@@ -4927,6 +4934,24 @@ class handler {
   */
   virtual int records_from_index(ha_rows *num_rows, uint index);
 
+  /**
+    Number of rows in table where a column is not NULL and, for an integer
+    column, the sum of its values. Used for COUNT(), SUM() and AVG() of the
+    column without a WHERE clause by engines supporting
+    HA_AGGREGATE_COLUMN_INSTANT, which may read the table on several threads.
+
+      @param field            Column to aggregate, not a virtual column.
+      @param num_not_null [out]  Number of rows where it is not NULL.
+      @param sum [out]        Sum of its values, or nullptr if not wanted.
+
+      @retval 0 for OK, one of the HA_xxx values in case of error.
+  */
+  virtual int column_aggregate(const Field *field MY_ATTRIBUTE((unused)),
+                               ha_rows *num_not_null MY_ATTRIBUTE((unused)),
+                               my_decimal *sum MY_ATTRIBUTE((unused))) {
+    return HA_ERR_WRONG_COMMAND;
+  }
+
  private:
   /**
     Function will handle the error code from call to records() and
@@ -4963,6 +4988,20 @@ class handler {
     return handle_records_error(records_from_index(num_rows, index), num_rows);
   }
 
+  /**
+    Wrapper function to call column_aggregate() in storage engine.
+
+      @param field            Column to aggregate.
+      @param num_not_null [out]  Number of rows where it is not NULL.
+      @param sum [out]        Sum of its values, or nullptr if not wanted.
+
+      @retval 0 for OK, one of the HA_xxx values in case of error.
+  */
+  int ha_column_aggregate(const Field *field, ha_rows *num_not_null,
+                          my_decimal *sum) {
+    return column_aggregate(field, num_not_null, sum);
+  }
+
   /**
     Return upper bound of current number of records in the table
     (max. of how many records one will retrieve when doing a full table scan)
@@ -5190,6 +5229,39 @@ class handler {
                                    key_range *max_key MY_ATTRIBUTE((unused))) {
     return (ha_rows)10;
   }
+
+  /**
+    Hint that a key is about to be looked up.
+
+    The engine may start reading the pages the key is on, without waiting
+    for them, so that the lookup does not wait for the disk. Nothing is
+    read by default.
+
+    @param inx      Index number
+    @param key      Key in the format of key_copy()
+    @param length   Key length
+  */
+
+  virtual void prefetch_key(uint inx MY_ATTRIBUTE((unused)),
+                            const uchar *key MY_ATTRIBUTE((unused)),
+                            uint length MY_ATTRIBUTE((unused))) {}
+
+  /**
+    Hint that the rows at a batch of positions are about to be read with
+    rnd_pos(), in the order given.
+
+    The positions are sorted as by cmp_ref(). The engine may start reading
+    the pages the rows are on, and reuse the work of locating one row for
+    the next, until the scan ends. Nothing is done by default.
+
+    @param positions  First position, in the format of ref
+    @param count      Number of positions
+    @param stride     Distance in bytes from one position to the next
+  */
+
+  virtual void prefetch_positions(const uchar *positions MY_ATTRIBUTE((unused)),
+                                  size_t count MY_ATTRIBUTE((unused)),
+                                  size_t stride MY_ATTRIBUTE((unused))) {}
   /*
     If HA_PRIMARY_KEY_REQUIRED_FOR_POSITION is set, then it sets ref
     (reference to the row, aka position, with the primary key given in
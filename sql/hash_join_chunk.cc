@@ -22,6 +22,7 @@
 
 #include "sql/hash_join_chunk.h"
 
+#include <fcntl.h>
 #include <stddef.h>
 #include <new>
 #include <utility>
@@ -88,6 +89,15 @@ bool HashJoinChunk::Rewind() {
   return false;
 }
 
+void HashJoinChunk::Prefetch() const {
+#ifndef _WIN32
+  // The file is not created before the first flush of the IO_CACHE.
+  if (m_file.file >= 0) {
+    posix_fadvise(m_file.file, 0, 0, POSIX_FADV_WILLNEED);
+  }
+#endif
+}
+
 bool HashJoinChunk::WriteRowToChunk(String *buffer, bool matched) {
   if (StoreFromTableBuffers(m_tables, buffer)) {
     my_error(ER_OUTOFMEMORY, MYF(ME_FATALERROR),
@@ -125,6 +125,11 @@ class HashJoinChunk {
   /// @retval true on error
   bool Rewind();
 
+  /// Ask the operating system to start reading what has been written to the
+  /// chunk file, so that the reads of it do not wait for the disk. The reads
+  /// run in the background while the current chunk pair is processed.
+  void Prefetch() const;
+
  private:
   // A collection of which tables the chunk file holds data from. Used to
   // determine where to read data from, and where to put the data back.
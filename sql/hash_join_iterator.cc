@@ -554,6 +554,15 @@ bool HashJoinIterator::ReadNextHashJoinChunk() {
     // Since we are moving to a new set of chunk files, ensure that we read from
     // the chunk file and not from the probe row saving file.
     m_read_from_probe_row_saving = false;
+
+    // Let the disk read the probe chunk of this pair and the build chunk of
+    // the next one while we build and probe the hash table.
+    if (m_current_chunk < static_cast<int>(m_chunk_files_on_disk.size())) {
+      m_chunk_files_on_disk[m_current_chunk].probe_chunk.Prefetch();
+    }
+    if (m_current_chunk + 1 < static_cast<int>(m_chunk_files_on_disk.size())) {
+      m_chunk_files_on_disk[m_current_chunk + 1].build_chunk.Prefetch();
+    }
   }
 
   if (m_current_chunk == static_cast<int>(m_chunk_files_on_disk.size())) {
@@ -219,6 +219,7 @@ Histogram::Histogram(MEM_ROOT *mem_root, const std::string &db_name,
     : m_null_values_fraction(INVALID_NULL_VALUES_FRACTION),
       m_charset(nullptr),
       m_num_buckets_specified(0),
+      m_last_updated(0),
       m_mem_root(mem_root),
       m_hist_type(type),
       m_data_type(data_type) {
@@ -237,6 +238,7 @@ Histogram::Histogram(MEM_ROOT *mem_root, const Histogram &other)
       m_null_values_fraction(other.m_null_values_fraction),
       m_charset(other.m_charset),
       m_num_buckets_specified(other.m_num_buckets_specified),
+      m_last_updated(other.m_last_updated),
       m_mem_root(mem_root),
       m_hist_type(other.m_hist_type),
       m_data_type(other.m_data_type) {
@@ -517,6 +519,16 @@ bool Histogram::json_to_histogram(const Json_object &json_object) {
   // Get the charset (my_sys.h)
   m_charset = get_charset(static_cast<uint>(charset_id->value()), MYF(0));
 
+  // When the histogram was stored; older versions may not have it.
+  const Json_dom *last_updated_dom = json_object.get(last_updated_str());
+  if (last_updated_dom != nullptr &&
+      last_updated_dom->json_type() == enum_json_type::J_DATETIME) {
+    bool in_dst_time_gap;
+    m_last_updated = my_tz_UTC->TIME_to_gmt_sec(
+        down_cast<const Json_datetime *>(last_updated_dom)->value(),
+        &in_dst_time_gap);
+  }
+
   return false;
 }
 
@@ -930,6 +942,16 @@ bool update_histogram(THD *thd, TABLE_LIST *table, const columns_set &columns,
   bitmap_clear_all(tbl->read_set);
   std::vector<Field *, Histogram_key_allocator<Field *>> resolved_fields;
 
+  /*
+    With histogram_update_modified_only, a histogram stored after the last
+    modification of the table the storage engine knows of is kept. An engine
+    that does not know when the table was modified reports 0.
+  */
+  my_time_t modified_time = 0;
+  if (thd->variables.histogram_update_modified_only &&
+      tbl->file->info(HA_STATUS_TIME | HA_STATUS_NO_LOCK) == 0)
+    modified_time = static_cast<my_time_t>(tbl->file->stats.update_time);
+
   for (const std::string &column_name : columns) {
     Field *field = find_field_in_table_sef(tbl, column_name.c_str());
 
@@ -953,6 +975,20 @@ bool update_histogram(THD *thd, TABLE_LIST *table, const columns_set &columns,
                       Message::COVERED_BY_SINGLE_PART_UNIQUE_INDEX);
       continue;
     }
+
+    if (modified_time != 0) {
+      const Histogram *existing = nullptr;
+      if (find_histogram(
+              thd, std::string(table->db, table->db_length),
+              std::string(table->table_name, table->table_name_length),
+              column_name, &existing))
+        return true; /* purecov: deadcode */
+
+      if (existing != nullptr && existing->get_last_updated() > modified_time) {
+        results.emplace(column_name, Message::HISTOGRAM_UP_TO_DATE);
+        continue;
+      }
+    }
     resolved_fields.push_back(field);
 
     bitmap_set_bit(tbl->read_set, field->field_index());
@@ -49,6 +49,7 @@
 
 #include "lex_string.h"  // LEX_CSTRING
 #include "my_base.h"     // ha_rows
+#include "my_time.h"     // my_time_t
 #include "sql/histograms/value_map_type.h"
 #include "sql/mem_root_allocator.h"   // Mem_root_allocator
 #include "sql/stateless_allocator.h"  // Stateless_allocator
@@ -87,7 +88,8 @@ enum class Message {
   COVERED_BY_SINGLE_PART_UNIQUE_INDEX,
   NO_HISTOGRAM_FOUND,
   HISTOGRAM_DELETED,
-  SERVER_READ_ONLY
+  SERVER_READ_ONLY,
+  HISTOGRAM_UP_TO_DATE
 };
 
 struct Histogram_psi_key_alloc {
@@ -165,6 +167,9 @@ class Histogram {
   /// The number of buckets originally specified
   size_t m_num_buckets_specified;
 
+  /// When the histogram was stored (UTC), 0 if not known
+  my_time_t m_last_updated;
+
   /// String representation of the JSON field "buckets".
   static constexpr const char *buckets_str() { return "buckets"; }
 
@@ -358,6 +363,9 @@ class Histogram {
   /// @return the sampling rate used to generate this histogram
   double get_sampling_rate() const { return m_sampling_rate; }
 
+  /// @return when this histogram was stored, or 0 if it was not read back
+  my_time_t get_last_updated() const { return m_last_updated; }
+
   /**
     Returns the histogram type as a readable string.
 
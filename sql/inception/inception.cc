@@ -7,21 +7,44 @@
 
 #include "sql/inception/inception_audit.h"
 #include "sql/inception/inception_backup.h"
+#include "sql/inception/inception_batch.h"
+#include "sql/inception/inception_cache.h"
 #include "sql/inception/inception_context.h"
 #include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_fanout.h"
+#include "sql/inception/inception_job.h"
+#include "sql/inception/inception_kept.h"
 #include "sql/inception/inception_log.h"
+#include "sql/inception/inception_parallel.h"  // is_table_statement
 #include "sql/inception/inception_parse.h"
+#include "sql/inception/inception_profile.h"
+#include "sql/inception/inception_resgroup.h"
 #include "sql/inception/inception_result.h"
+#include "sql/inception/inception_sched.h"
+#include "sql/inception/inception_script.h"
+#include "sql/inception/inception_shadow.h"
+#include "sql/inception/inception_snapshot.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_stream.h"
+#include "sql/inception/inception_sysvars.h"
 #include "sql/inception/inception_tree.h"
-
-#include "sql/sql_class.h"  // THD
-#include "sql/sql_error.h"  // my_ok, my_error
-#include "sql/sql_lex.h"    // SQLCOM_EMPTY_QUERY, Lex_input_stream
-
-#include <cctype>   // isdigit
+#include "sql/inception/inception_verify.h"
+
+#include "sql/key_spec.h"        // Foreign_key_spec
+#include "sql/psi_memory_key.h"  // key_memory_thd_main_mem_root
+#include "sql/sql_alter.h"       // Alter_info
+#include "sql/sql_class.h"       // THD
+#include "sql/sql_digest.h"      // get_max_digest_length
+#include "sql/sql_error.h"       // my_ok, my_error
+#include "sql/sql_lex.h"         // SQLCOM_EMPTY_QUERY, Lex_input_stream
+#include "sql/sql_parse.h"       // parse_sql
+
+#include <algorithm>
+#include <cctype>   // isdigit, isspace
 #include <cerrno>   // errno, ERANGE
 #include <chrono>
 #include <climits>  // UINT32_MAX
+#include <cstdint>  // SIZE_MAX
 #include <cstring>  // strncasecmp
 #include <string>
 
@@ -69,7 +92,7 @@ static std::string strip_inception_comment(const char *query, size_t length) {
 }
 
 static bool parse_first_version(const std::string &text, uint *major,
-                                uint *minor) {
+                                uint *minor, uint *patch = nullptr) {
   size_t i = 0;
   while (i < text.size()) {
     if (!isdigit(static_cast<unsigned char>(text[i]))) {
@@ -90,6 +113,11 @@ static bool parse_first_version(const std::string &text, uint *major,
     }
     *major = static_cast<uint>(strtoul(text.c_str() + i, nullptr, 10));
     *minor = static_cast<uint>(strtoul(text.c_str() + j + 1, nullptr, 10));
+    if (patch)
+      *patch = k + 1 < text.size() && text[k] == '.' &&
+                       isdigit(static_cast<unsigned char>(text[k + 1]))
+                   ? static_cast<uint>(strtoul(text.c_str() + k + 1, nullptr, 10))
+                   : 0;
     return true;
   }
   return false;
@@ -121,21 +149,34 @@ static void maybe_detect_remote_db_profile(InceptionContext *ctx) {
 
   uint major = ctx->db_version_major;
   uint minor = ctx->db_version_minor;
+  uint patch = 0;
   bool parsed = false;
 
   if (ctx->db_type == DbType::TIDB || is_tidb) {
     parsed = parse_tidb_version(server_info, &major, &minor);
     if (!parsed) parsed = parse_first_version(server_info, &major, &minor);
   } else {
-    parsed = parse_first_version(server_info, &major, &minor);
+    parsed = parse_first_version(server_info, &major, &minor, &patch);
   }
 
   if (parsed) {
     ctx->db_version_major = major;
     ctx->db_version_minor = minor;
+    ctx->db_version_patch = patch;
   }
 }
 
+/**
+ * Detect the db type/version on the connection connect_remote_async()
+ * opened, once per session, and publish the session again with it.
+ */
+static void await_remote_db_profile(THD *thd, InceptionContext *ctx) {
+  if (!ctx->profile_pending) return;
+  ctx->profile_pending = false;
+  maybe_detect_remote_db_profile(ctx);
+  publish_session(thd, ctx);
+}
+
 /**
  * Set up inception session context from a magic_start comment.
  * @return false on success, true on parse error (my_error already sent).
@@ -150,8 +191,38 @@ static bool setup_inception_session(THD *thd) {
              "Failed to parse inception_magic_start comment");
     return true;
   }
+  status_add(STATUS_SESSIONS);
+
+  /* The whole batch is audited under the rules as they are now, with
+     the --profile overrides on top */
+  compile_rule_plan(&ctx->rules);
+  if (!ctx->rule_profile.empty()) {
+    std::string err;
+    if (apply_rule_profile(ctx->rule_profile, &ctx->rules, &err)) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+      return true;
+    }
+  }
+
+  /* --schema-file: audit against a schema dump, without the target */
+  if (!ctx->schema_file.empty()) {
+    if (ctx->mode != OpMode::CHECK) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                      "--schema-file audits offline and only works with "
+                      "--enable-check");
+      return true;
+    }
+    std::shared_ptr<ShadowCatalog> shadow = std::make_shared<ShadowCatalog>();
+    std::string err;
+    if (load_shadow_schema(ctx->schema_file, shadow.get(), &err)) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+      return true;
+    }
+    ctx->shadow = shadow;
+  }
 
   if ((ctx->mode == OpMode::CHECK || ctx->mode == OpMode::EXECUTE) &&
+      !ctx->shadow &&
       (!ctx->explicit_host || !ctx->explicit_user || !ctx->explicit_port)) {
     my_printf_error(
         ER_UNKNOWN_ERROR, "%s", MYF(0),
@@ -159,10 +230,107 @@ static bool setup_inception_session(THD *thd) {
     return true;
   }
 
-  /* Auto-detect db type/version from remote when not explicitly provided. */
-  maybe_detect_remote_db_profile(ctx);
+  /* --target-group: the shard list kept in inception_target_groups */
+  if (!ctx->target_group.empty() &&
+      !resolve_target_group(ctx->target_group, &ctx->targets)) {
+    my_printf_error(ER_UNKNOWN_ERROR,
+                    "Unknown target group '%s' (see inception_target_groups)",
+                    MYF(0), ctx->target_group.c_str());
+    return true;
+  }
+  if (!ctx->targets.empty() && !ctx->resume_batch.empty()) {
+    my_printf_error(
+        ER_UNKNOWN_ERROR, "%s", MYF(0),
+        "--resume continues one target; resubmit the shard alone with its "
+        "--host and --port");
+    return true;
+  }
+
+  /* --dry-run-target: one sandbox, never the audited target */
+  if (!ctx->dry_run_target.empty()) {
+    std::vector<std::pair<std::string, uint>> sandbox;
+    parse_host_list(ctx->dry_run_target, &sandbox);
+    if (sandbox.size() != 1) {
+      my_printf_error(ER_UNKNOWN_ERROR,
+                      "Invalid --dry-run-target '%s': expected host:port",
+                      MYF(0), ctx->dry_run_target.c_str());
+      return true;
+    }
+    if (ctx->mode != OpMode::CHECK) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                      "--dry-run-target only works with --enable-check");
+      return true;
+    }
+    if (strcasecmp(sandbox[0].first.c_str(), ctx->host.c_str()) == 0 &&
+        sandbox[0].second == ctx->port) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                      "--dry-run-target must be a sandbox, not the audited "
+                      "--host and --port");
+      return true;
+    }
+    ctx->dry_run_sandbox = sandbox[0];
+  }
+
+  /* --audit-host: one replica for the read-only audit queries */
+  if (!ctx->audit_host.empty()) {
+    std::vector<std::pair<std::string, uint>> replica;
+    parse_host_list(ctx->audit_host, &replica);
+    if (replica.size() != 1) {
+      my_printf_error(ER_UNKNOWN_ERROR,
+                      "Invalid --audit-host '%s': expected host:port", MYF(0),
+                      ctx->audit_host.c_str());
+      return true;
+    }
+    /* The target itself: nothing to route */
+    if (strcasecmp(replica[0].first.c_str(), ctx->host.c_str()) != 0 ||
+        replica[0].second != ctx->port)
+      ctx->audit_server = replica[0];
+  }
+
+  /* --enable-split-files: the groups go to inception_split_dir */
+  if (ctx->split_to_files) {
+    std::string err;
+    if (ctx->mode != OpMode::SPLIT) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                      "--enable-split-files only works with --enable-split");
+      return true;
+    }
+    if (ctx->split_files.start(&err)) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+      return true;
+    }
+  }
+
+  /* inception_check_max_sessions_per_target: wait, visible in "inception
+     show sessions" and killable, before anything reaches the target */
+  if (ctx->mode == OpMode::CHECK && !ctx->shadow) {
+    publish_session(thd, ctx);
+    if (!ctx->check_slot.acquire(ctx, SlotKind::CHECK)) {
+      my_printf_error(ER_UNKNOWN_ERROR,
+                      "Killed while waiting for a CHECK slot on %s:%u",
+                      MYF(0), ctx->host.c_str(), ctx->port);
+      ctx->reset();
+      return true;
+    }
+  }
+
+  /* Confine the session, and the threads it starts below, to
+     inception_resource_group */
+  bind_session_resource_group(thd, ctx);
+
+  /* Connect while the client sends the batch; the db type/version is
+     detected from it before the first statement is audited. */
+  connect_remote_async(ctx);
+  ctx->profile_pending = true;
+
+  /* Keep the target's cached schema fresh from its binlog. */
+  start_schema_watch(ctx);
+
+  /* Warm the metadata cache while the client streams statements. */
+  if (thd->db().str) start_schema_prefetch(ctx, thd->db().str);
 
   ctx->session_start_time = std::chrono::steady_clock::now();
+  publish_session(thd, ctx);
   return false;
 }
 
@@ -171,15 +339,28 @@ static bool setup_inception_session(THD *thd) {
  * on remote target, and send the result set.
  */
 static void do_inception_commit(THD *thd) {
-  InceptionContext *ctx = get_context(thd);
-  if (!ctx->active) {
+  InceptionContext *ctx = find_active_context(thd);
+  if (!ctx) {
     my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
              "inception_magic_commit without inception_magic_start");
     return;
   }
+  await_remote_db_profile(thd, ctx);
+
+  /* The audit of the batch is complete: the rules across its statements
+     report before anything is executed */
+  analyze_batch(ctx);
+  rule_stats_merge(ctx->rule_stats);
 
   /* SPLIT mode: send grouped results */
   if (ctx->mode == OpMode::SPLIT) {
+    std::string err;
+    if (ctx->split_files.close_group(&err)) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+      ctx->reset();
+      return;
+    }
+    plan_split_groups(&ctx->split_nodes);
     send_split_results(thd, ctx);
     ctx->reset();
     return;
@@ -192,6 +373,38 @@ static void do_inception_commit(THD *thd) {
     return;
   }
 
+  /* A background job, the shards and the parallel lanes take the nodes
+     to threads of their own: the spilled texts come back first */
+  if (ctx->mode == OpMode::EXECUTE &&
+      (ctx->async || !ctx->targets.empty() || ctx->parallel))
+    ctx->load_all_nodes();
+
+  /* Async execute: hand the batch to a background job */
+  if (ctx->mode == OpMode::EXECUTE && ctx->async) {
+    int total = static_cast<int>(ctx->cache_nodes.size());
+    uint64_t job_id = submit_job(thd, ctx);
+    send_job_submitted_result(thd, job_id, total);
+    ctx->reset();
+    return;
+  }
+
+  /* Fan-out: run the batch on every --targets shard; each shard writes
+     its own session audit record */
+  if (ctx->mode == OpMode::EXECUTE && !ctx->targets.empty()) {
+    execute_fanout(thd, ctx);
+    std::shared_ptr<KeptResults> kept = results_to_keep(thd->thread_id(), true);
+    if (!send_fanout_results(thd, ctx, kept.get()) && kept)
+      keep_results(std::move(kept));
+    ctx->reset();
+    return;
+  }
+
+  /* --dry-run-target: measure the batch on the sandbox */
+  if (ctx->mode == OpMode::CHECK && ctx->dry_run_sandbox.second != 0) {
+    ctx->load_all_nodes();
+    dry_run_statements(thd, ctx);
+  }
+
   /* Execute mode: run statements on remote target */
   if (ctx->mode == OpMode::EXECUTE) {
     if (execute_statements(thd, ctx)) {
@@ -200,18 +413,25 @@ static void do_inception_commit(THD *thd) {
     if (ctx->backup) {
       generate_rollback(thd, ctx);
     }
+    verify_written_tables(ctx);
   }
 
-  /* Send results to client */
-  send_inception_results(thd, ctx);
+  /* Send results to client, keeping them for inception get results */
+  {
+    std::shared_ptr<KeptResults> kept =
+        results_to_keep(thd->thread_id(), false);
+    if (!send_inception_results(thd, ctx, kept.get()) && kept)
+      keep_results(std::move(kept));
+  }
 
   /* Write session audit log */
   {
     auto now = std::chrono::steady_clock::now();
     int64_t duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now - ctx->session_start_time).count();
-    int total = static_cast<int>(ctx->cache_nodes.size());
-    int errors = 0;
+    int total = static_cast<int>(ctx->cache_nodes.size() +
+                                 ctx->result_spool.records());
+    int errors = ctx->spooled_errors;
     for (const auto &n : ctx->cache_nodes) {
       if (n.errlevel >= ERRLEVEL_ERROR) errors++;
     }
@@ -223,7 +443,7 @@ static void do_inception_commit(THD *thd) {
 }
 
 /**
- * Handle "inception ..." commands (get/show/set/kill).
+ * Handle "inception ..." commands (get/show/set/reload/kill).
  * @return true if the query was handled, false if not an inception command.
  */
 static bool handle_inception_command(THD *thd) {
@@ -242,7 +462,8 @@ static bool handle_inception_command(THD *thd) {
     len--;
   }
 
-  /* Match "inception show sessions" */
+  /* Match "inception show sessions" / "cache" / "pool" / "admission" /
+     "audit_log" */
   if (len >= 15 && strncasecmp(q, "inception show ", 15) == 0) {
     const char *sub = q + 15;
     size_t sub_len = len - 15;
@@ -256,12 +477,89 @@ static bool handle_inception_command(THD *thd) {
                         "Failed to send sessions result set.");
       return true;
     }
+    if (sub_len == 5 && strncasecmp(sub, "cache", 5) == 0) {
+      if (send_cache_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send cache result set.");
+      return true;
+    }
+    if (sub_len == 4 && strncasecmp(sub, "pool", 4) == 0) {
+      if (send_pool_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send pool result set.");
+      return true;
+    }
+    if (sub_len == 9 && strncasecmp(sub, "admission", 9) == 0) {
+      if (send_admission_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send admission result set.");
+      return true;
+    }
+    if (sub_len == 9 && strncasecmp(sub, "audit_log", 9) == 0) {
+      if (send_audit_log_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send audit_log result set.");
+      return true;
+    }
+    if (sub_len == 4 && strncasecmp(sub, "jobs", 4) == 0) {
+      if (send_jobs_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send jobs result set.");
+      return true;
+    }
+    if (sub_len == 11 && strncasecmp(sub, "checkpoints", 11) == 0) {
+      if (send_checkpoints_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send checkpoints result set.");
+      return true;
+    }
+    if (sub_len == 10 && strncasecmp(sub, "rule_stats", 10) == 0) {
+      if (send_rule_stats_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send rule_stats result set.");
+      return true;
+    }
+    if (sub_len == 13 && strncasecmp(sub, "rule_profiles", 13) == 0) {
+      if (send_rule_profiles_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send rule_profiles result set.");
+      return true;
+    }
+    if (sub_len == 15 && strncasecmp(sub, "rule_components", 15) == 0) {
+      if (send_rule_components_result(thd))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to send rule_components result set.");
+      return true;
+    }
     my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
-                    "Unknown inception show command. Supported: sessions");
+                    "Unknown inception show command. Supported: sessions, cache, pool, admission, audit_log, jobs, checkpoints, rule_stats, rule_profiles, rule_components");
     return true;
   }
 
-  /* Match "inception set sleep <thread_id> <ms>" */
+  /* Match "inception reload rule_profiles" */
+  if (len >= 17 && strncasecmp(q, "inception reload ", 17) == 0) {
+    const char *sub = q + 17;
+    size_t sub_len = len - 17;
+    while (sub_len > 0 && (*sub == ' ' || *sub == '\t')) {
+      sub++;
+      sub_len--;
+    }
+    if (sub_len == 13 && strncasecmp(sub, "rule_profiles", 13) == 0) {
+      std::string err;
+      if (reload_rule_profiles(&err))
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+      else
+        my_ok(thd);
+      return true;
+    }
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                    "Unknown inception reload command. Supported: "
+                    "rule_profiles");
+    return true;
+  }
+
+  /* Match "inception set sleep <thread_id> <ms>" /
+     "inception set rate <host>:<port> <rows/s> <statements/s> | default" */
   if (len >= 14 && strncasecmp(q, "inception set ", 14) == 0) {
     const char *sub = q + 14;
     size_t sub_len = len - 14;
@@ -306,8 +604,43 @@ static bool handle_inception_command(THD *thd) {
       }
       return true;
     }
+    if (sub_len > 5 && strncasecmp(sub, "rate ", 5) == 0) {
+      static const char *usage =
+          "Usage: inception set rate <host>:<port> "
+          "<rows_per_second> <statements_per_second> | default";
+      std::string args(sub + 5, sub_len - 5);
+      char target[256], rows_arg[32], stmts_arg[32];
+      int n = sscanf(args.c_str(), "%255s %31s %31s", target, rows_arg,
+                     stmts_arg);
+      char *colon = n >= 2 ? strrchr(target, ':') : nullptr;
+      char *end = nullptr;
+      unsigned long port = colon ? strtoul(colon + 1, &end, 10) : 0;
+      if (!colon || colon == target || *end != '\0' || port == 0 ||
+          port > 65535) {
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), usage);
+        return true;
+      }
+      *colon = '\0';
+      if (n == 2 && strcasecmp(rows_arg, "default") == 0) {
+        set_target_rate(target, static_cast<uint>(port), true, 0, 0);
+        my_ok(thd);
+        return true;
+      }
+      char *end_rows = nullptr, *end_stmts = nullptr;
+      errno = 0;
+      unsigned long rows = n == 3 ? strtoul(rows_arg, &end_rows, 10) : 0;
+      unsigned long stmts = n == 3 ? strtoul(stmts_arg, &end_stmts, 10) : 0;
+      if (n != 3 || *end_rows != '\0' || *end_stmts != '\0' ||
+          errno == ERANGE || rows > UINT32_MAX || stmts > UINT32_MAX) {
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), usage);
+        return true;
+      }
+      set_target_rate(target, static_cast<uint>(port), false, rows, stmts);
+      my_ok(thd);
+      return true;
+    }
     my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
-             "Unknown inception set command. Supported: sleep");
+             "Unknown inception set command. Supported: sleep, rate");
     return true;
   }
 
@@ -345,13 +678,116 @@ static bool handle_inception_command(THD *thd) {
       send_encrypt_password_result(thd, arg, arg_len);
       return true;
     }
+    /* "inception get results {<job_id> | session <thread_id>}
+        [offset [limit]] [errlevel>=N]" */
+    if (sub_len >= 7 && strncasecmp(sub, "results", 7) == 0) {
+      const char *arg = sub + 7;
+      size_t arg_len = sub_len - 7;
+      while (arg_len > 0 && (*arg == ' ' || *arg == '\t')) {
+        arg++;
+        arg_len--;
+      }
+      const bool session = arg_len > 8 && strncasecmp(arg, "session", 7) == 0 &&
+                           (arg[7] == ' ' || arg[7] == '\t');
+      if (session) {
+        arg += 8;
+        arg_len -= 8;
+        while (arg_len > 0 && (*arg == ' ' || *arg == '\t')) {
+          arg++;
+          arg_len--;
+        }
+      }
+      char *end = nullptr;
+      errno = 0;
+      unsigned long long id = strtoull(arg, &end, 10);
+      ResultPage page;
+      const bool paged = end != arg + arg_len;
+      if (arg_len == 0 || end == arg || errno == ERANGE ||
+          (session && id > UINT32_MAX) ||
+          (paged && *end != ' ' && *end != '\t') ||
+          parse_result_page(end, arg_len - static_cast<size_t>(end - arg),
+                            &page)) {
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                 "Usage: inception get results {<job_id> | session "
+                 "<thread_id>} [offset [limit]] [errlevel>=N]");
+        return true;
+      }
+      if (session) {
+        std::shared_ptr<const KeptResults> kept =
+            find_kept_results(static_cast<uint32_t>(id));
+        if (kept) {
+          send_kept_results(thd, *kept, page);
+        } else {
+          char errbuf[128];
+          snprintf(errbuf, sizeof(errbuf),
+                   "No results kept for thread %llu "
+                   "(inception_result_keep_time).",
+                   id);
+          my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), errbuf);
+        }
+        return true;
+      }
+      const unsigned long long job_id = id;
+      std::shared_ptr<InceptionContext> job_ctx;
+      JobLookup found = find_finished_job(job_id, &job_ctx);
+      if (found == JobLookup::FOUND && paged) {
+        KeptResults rows(0, !job_ctx->shards.empty(), SIZE_MAX);
+        keep_job_results(job_ctx.get(), &rows);
+        send_kept_results(thd, rows, page);
+      } else if (found == JobLookup::FOUND) {
+        if (job_ctx->shards.empty())
+          send_inception_results(thd, job_ctx.get());
+        else
+          send_fanout_results(thd, job_ctx.get());
+      } else {
+        char errbuf[128];
+        if (found == JobLookup::NOT_FINISHED)
+          snprintf(errbuf, sizeof(errbuf), "Job %llu has not finished yet.",
+                   job_id);
+        else
+          snprintf(errbuf, sizeof(errbuf), "Job %llu not found.", job_id);
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), errbuf);
+      }
+      return true;
+    }
     /* Unknown sub-command */
     my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
-             "Unknown inception get command. Supported: sqltypes, encrypt_password");
+             "Unknown inception get command. Supported: sqltypes, encrypt_password, results");
     return true;
   }
 
-  /* Match "inception kill <thread_id> [force]" */
+  /* Match "inception pause <thread_id>" / "inception resume <thread_id>" */
+  const bool is_pause = len >= 16 && strncasecmp(q, "inception pause ", 16) == 0;
+  if (is_pause || (len >= 17 && strncasecmp(q, "inception resume ", 17) == 0)) {
+    const char *args = q + (is_pause ? 16 : 17);
+    size_t args_len = len - (is_pause ? 16 : 17);
+    while (args_len > 0 && (*args == ' ' || *args == '\t')) {
+      args++;
+      args_len--;
+    }
+    char *end1 = nullptr;
+    errno = 0;
+    unsigned long raw_tid = strtoul(args, &end1, 10);
+    if (end1 == args || end1 != args + args_len || errno == ERANGE ||
+        raw_tid > UINT32_MAX) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+               is_pause ? "Usage: inception pause <thread_id>"
+                        : "Usage: inception resume <thread_id>");
+      return true;
+    }
+    uint32_t tid = static_cast<uint32_t>(raw_tid);
+    if (set_paused_by_thread_id(tid, is_pause)) {
+      my_ok(thd);
+    } else {
+      char errbuf[128];
+      snprintf(errbuf, sizeof(errbuf),
+               "Thread %u not found or not in active inception session.", tid);
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), errbuf);
+    }
+    return true;
+  }
+
+  /* Match "inception kill <thread_id> [force]" / "inception kill job <job_id> [force]" */
   if (len >= 15 && strncasecmp(q, "inception kill ", 15) == 0) {
     const char *args = q + 15;
     size_t args_len = len - 15;
@@ -359,6 +795,37 @@ static bool handle_inception_command(THD *thd) {
       args++;
       args_len--;
     }
+    if (args_len > 4 && strncasecmp(args, "job ", 4) == 0) {
+      const char *jargs = args + 4;
+      size_t jargs_len = args_len - 4;
+      while (jargs_len > 0 && (*jargs == ' ' || *jargs == '\t')) {
+        jargs++;
+        jargs_len--;
+      }
+      char *end = nullptr;
+      errno = 0;
+      unsigned long long job_id = strtoull(jargs, &end, 10);
+      if (end == jargs || errno == ERANGE) {
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                 "Usage: inception kill job <job_id> [force]");
+        return true;
+      }
+      const char *rest = end;
+      size_t rest_len = jargs_len - static_cast<size_t>(end - jargs);
+      while (rest_len > 0 && (*rest == ' ' || *rest == '\t')) {
+        rest++;
+        rest_len--;
+      }
+      bool force_kill = rest_len >= 5 && strncasecmp(rest, "force", 5) == 0;
+      if (kill_job(job_id, force_kill)) {
+        my_ok(thd);
+      } else {
+        char errbuf[128];
+        snprintf(errbuf, sizeof(errbuf), "Job %llu not found.", job_id);
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), errbuf);
+      }
+      return true;
+    }
     /* Parse thread_id */
     char *end1 = nullptr;
     errno = 0;
@@ -394,35 +861,426 @@ static bool handle_inception_command(THD *thd) {
   return false; /* not an inception command */
 }
 
+/* Cache the statement sql that failed to parse, with the parser's error,
+   and clear the error. */
+static void record_parse_error(THD *thd, InceptionContext *ctx,
+                               std::string sql) {
+  const char *errmsg = thd->get_stmt_da()->message_text();
+  SqlCacheNode &node = ctx->add_sql(std::move(sql), SQLCOM_END);
+  node.stage = STAGE_CHECKED;
+  node.stage_status = "Audit completed";
+  node.append_error("SQL parse error: %s", errmsg ? errmsg : "unknown");
+
+  thd->clear_error();
+}
+
+/**
+ * Parse the NUL-terminated text on thd as dispatch_sql_command() does,
+ * digest included, once what the previous statement left is reset.
+ * @return true on a parse error, left in the diagnostics area.
+ */
+static bool parse_inner_statement(THD *thd, Parser_state *parser_state,
+                                  const char *text, size_t length) {
+  thd->set_query(text, length);
+  if (parser_state->init(thd, text, length)) return true;
+  if (get_max_digest_length() != 0)
+    parser_state->m_input.m_compute_digest = true;
+  thd->m_digest = &thd->m_digest_state;
+  thd->m_digest->reset(thd->m_token_array, get_max_digest_length());
+
+  mysql_reset_thd_for_next_command(thd);
+  lex_start(thd);
+  return parse_sql(thd, parser_state, nullptr);
+}
+
+/* Release what parse_inner_statement() left in thd->lex. */
+static void end_inner_statement(THD *thd) {
+  thd->lex->destroy();
+  thd->end_statement();
+  thd->cleanup_after_query();
+}
+
+/**
+ * Whether text is an INSERT for audit_long_insert():
+ * at least inception_insert_stream_min_size bytes, in a client character
+ * set the scan can read byte by byte.
+ */
+static bool scan_long_insert(THD *thd, const char *text, size_t length,
+                             InsertValuesScan *scan) {
+  if (opt_insert_stream_min_size == 0 || length < opt_insert_stream_min_size ||
+      thd->charset()->escape_with_backslash_is_dangerous)
+    return false;
+  const sql_mode_t mode = thd->variables.sql_mode;
+  return !scan_insert_values(text, length,
+                             !(mode & MODE_NO_BACKSLASH_ESCAPES),
+                             !(mode & MODE_ANSI_QUOTES), scan) &&
+         scan->length >= opt_insert_stream_min_size;
+}
+
+/**
+ * Audit the INSERT scan_long_insert() accepted in text from its head, the
+ * statement through its second row: the parser builds no Item of the
+ * other rows, while the node caches (and EXECUTE runs) the whole text.
+ * Leaves thd->lex to end_inner_statement().
+ */
+static void audit_long_insert(THD *thd, InceptionContext *ctx,
+                              Parser_state *parser_state, const char *text,
+                              const InsertValuesScan &scan) {
+  const char *head = strmake_root(thd->mem_root, text, scan.head_length);
+  if (!head ||
+      parse_inner_statement(thd, parser_state, head, scan.head_length)) {
+    /* An error of the head is the error of the statement */
+    record_parse_error(thd, ctx, std::string(text, scan.length));
+    return;
+  }
+  status_add(STATUS_STATEMENTS_STREAMED);
+  thd->set_query(text, scan.length);
+  intercept_statement(thd);
+}
+
+/**
+ * A long INSERT at the start of the packet, in a session: audit it with
+ * audit_long_insert() and point the multi-statement loop past it.
+ * @return true if the statement was handled.
+ */
+static bool handle_long_insert(THD *thd, Lex_input_stream *lip,
+                               const char *q, size_t length) {
+  InceptionContext *ctx = find_active_context(thd);
+  InsertValuesScan scan;
+  if (!ctx || ctx->mode == OpMode::QUERY_TREE ||
+      !scan_long_insert(thd, q, length, &scan))
+    return false;
+
+  const LEX_CSTRING saved_query = thd->query();
+  Parser_state parser_state;
+  audit_long_insert(thd, ctx, &parser_state, q, scan);
+  const bool failed = thd->is_error();
+  end_inner_statement(thd);
+  thd->set_query(saved_query);
+  lex_start(thd);
+
+  if (scan.semicolon) {
+    lip->found_semicolon = q + scan.next;
+    thd->server_status |= SERVER_MORE_RESULTS_EXISTS;
+  }
+  if (!failed && !thd->get_stmt_da()->is_set()) my_ok(thd);
+  return true;
+}
+
+/**
+ * Parse and intercept each statement of a script, as dispatch_sql_command()
+ * does for the statements of a packet, in a MEM_ROOT of its own emptied
+ * between statements. Parse errors are cached like handle_parse_error().
+ * Stops early on a kill, or on an error that must reach the client (left
+ * in the diagnostics area).
+ * @return number of statements audited.
+ */
+static size_t audit_script(THD *thd, InceptionContext *ctx,
+                           const ScriptFile &file) {
+  const LEX_CSTRING saved_query = thd->query();
+  MEM_ROOT *const saved_root = thd->mem_root;
+  sql_digest_state *const saved_digest = thd->m_digest;
+  MEM_ROOT stmt_root(key_memory_thd_main_mem_root, 8192);
+
+  ScriptScanner scanner(file.data(), file.size());
+  std::string text;
+  const char *begin;
+  size_t length;
+  size_t count = 0;
+  while (!thd->killed && scanner.next(&begin, &length)) {
+    thd->mem_root = &stmt_root;
+
+    Parser_state parser_state;
+    InsertValuesScan scan;
+    if (ctx->mode != OpMode::QUERY_TREE &&
+        scan_long_insert(thd, begin, length, &scan)) {
+      audit_long_insert(thd, ctx, &parser_state, begin, scan);
+    } else {
+      /* The parser reads a NUL-terminated copy of the statement */
+      text.assign(begin, length);
+      if (parse_inner_statement(thd, &parser_state, text.c_str(),
+                                text.size()))
+        record_parse_error(thd, ctx, text);
+      else
+        intercept_statement(thd);
+    }
+    count++;
+    const bool failed = thd->is_error();
+
+    end_inner_statement(thd);
+    thd->mem_root = saved_root;
+    stmt_root.ClearForReuse();
+    if (failed) break;
+    thd->get_stmt_da()->reset_diagnostics_area();
+    thd->get_stmt_da()->reset_condition_info(thd);
+  }
+
+  thd->set_query(saved_query);
+  thd->m_digest = saved_digest;
+  if (saved_digest)
+    saved_digest->reset(thd->m_token_array, get_max_digest_length());
+  lex_start(thd);
+  return count;
+}
+
+/**
+ * "inception audit file '<name>'" inside a session: audit the statements
+ * of <name> in inception_script_dir as if the client had sent them.
+ * @return true if the query was handled.
+ */
+static bool handle_audit_file(THD *thd, Lex_input_stream *lip) {
+  const char *q = thd->query().str;
+  const char *end = q + thd->query().length;
+  while (q < end && isspace(static_cast<unsigned char>(*q))) q++;
+
+  static const char CMD[] = "inception audit file";
+  const size_t cmd_len = sizeof(CMD) - 1;
+  if (static_cast<size_t>(end - q) < cmd_len ||
+      strncasecmp(q, CMD, cmd_len) != 0)
+    return false;
+
+  const char *p = q + cmd_len;
+  while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+  const char *name_end = nullptr;
+  if (p < end && (*p == '\'' || *p == '"')) {
+    const char quote = *p++;
+    name_end = static_cast<const char *>(memchr(p, quote, end - p));
+  }
+  if (!name_end) {
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                    "Usage: inception audit file '<name>'");
+    return true;
+  }
+  const std::string name(p, name_end - p);
+
+  /* More statements may follow in the same packet */
+  const char *next = nullptr;
+  p = name_end + 1;
+  while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+  if (p < end && *p == ';') {
+    next = ++p;
+    while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+    if (p == end) next = nullptr;
+  } else if (p < end) {
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                    "Usage: inception audit file '<name>'");
+    return true;
+  }
+
+  InceptionContext *ctx = find_active_context(thd);
+  if (!ctx) {
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                    "inception audit file must follow inception_magic_start.");
+    return true;
+  }
+
+  ScriptFile file;
+  std::string err;
+  if (file.open(name, &err)) {
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+    return true;
+  }
+  const size_t count = audit_script(thd, ctx, file);
+  fprintf(stderr, "[Inception] %zu statements audited from %s\n", count,
+          file.path().c_str());
+  fflush(stderr);
+  if (thd->is_error()) return true;
+
+  if (next) {
+    lip->found_semicolon = next;
+    thd->server_status |= SERVER_MORE_RESULTS_EXISTS;
+  }
+  my_ok(thd, count);
+  return true;
+}
+
+/**
+ * "inception get tree [<options>] <statement>": the QUERY_TREE result of
+ * one statement in one round trip, without a session. <options> is a
+ * comment such as magic_start's naming the target SELECT * is expanded
+ * from; without --host it stays "*". Statements after it in the packet
+ * run as usual.
+ * @return true if the query was handled.
+ */
+static bool handle_get_tree(THD *thd, Lex_input_stream *lip) {
+  const char *q = thd->query().str;
+  const char *end = q + thd->query().length;
+  while (q < end && isspace(static_cast<unsigned char>(*q))) q++;
+  while (end > q && (isspace(static_cast<unsigned char>(end[-1])) ||
+                     end[-1] == ';'))
+    end--;
+
+  static const char CMD[] = "inception get tree";
+  const size_t cmd_len = sizeof(CMD) - 1;
+  if (static_cast<size_t>(end - q) < cmd_len ||
+      strncasecmp(q, CMD, cmd_len) != 0 ||
+      (q + cmd_len < end && !isspace(static_cast<unsigned char>(q[cmd_len])) &&
+       q[cmd_len] != '/'))
+    return false;
+
+  const char *p = q + cmd_len;
+  while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+
+  /* Stack context: never registered, published or kept */
+  InceptionContext ctx;
+  if (p + 1 < end && p[0] == '/' && p[1] == '*') {
+    const char *close = nullptr;
+    for (const char *c = p + 2; c + 1 < end; c++)
+      if (c[0] == '*' && c[1] == '/') {
+        close = c + 2;
+        break;
+      }
+    if (!close) {
+      my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                      "Unterminated options comment in inception get tree");
+      return true;
+    }
+    parse_inception_start(p, static_cast<size_t>(close - p), &ctx);
+    p = close;
+    while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+  }
+  if (p == end) {
+    my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                    "Usage: inception get tree [/*--host=...;--port=...;*/] "
+                    "<statement>");
+    return true;
+  }
+  ctx.mode = OpMode::QUERY_TREE;
+  /* No target: leave SELECT * unexpanded, do not connect */
+  if (!ctx.explicit_host) ctx.remote_conn_failed = true;
+
+  /* The parser wants a NUL-terminated copy; it lives in the statement's
+     MEM_ROOT, freed with the command */
+  const size_t length = static_cast<size_t>(end - p);
+  const char *text = thd->strmake(p, length);
+  if (!text) return true;
+  const LEX_CSTRING saved_query = thd->query();
+
+  Parser_state parser_state;
+  const bool parse_error =
+      parse_inner_statement(thd, &parser_state, text, length);
+  const char *next = parser_state.m_lip.found_semicolon;
+  if (!parse_error) {
+    QueryTreeNode node;
+    node.id = 1;
+    size_t sql_len = next ? static_cast<size_t>(next - 1 - text) : length;
+    while (sql_len > 0 && isspace(static_cast<unsigned char>(text[sql_len - 1])))
+      sql_len--;
+    node.sql_text.assign(text, sql_len);
+    node.query_tree_json = extract_query_tree(thd, &ctx);
+    ctx.tree_nodes.push_back(std::move(node));
+  }
+  const bool failed = thd->is_error();
+  end_inner_statement(thd);
+  thd->set_query(saved_query);
+  lex_start(thd);
+  if (failed) {
+    ctx.reset();
+    return true;
+  }
+
+  if (next) {
+    lip->found_semicolon = p + (next - text);
+    thd->server_status |= SERVER_MORE_RESULTS_EXISTS;
+  }
+  send_query_tree_results(thd, &ctx);
+  ctx.reset();
+  return true;
+}
+
 /* ================================================================
  *  Public interface — called from sql_parse.cc (4 hook points)
  * ================================================================ */
 
-bool before_parse(THD *thd) {
-  const char *q = thd->query().str;
-  size_t q_len = thd->query().length;
+/** The word after "inception", as far as before_parse() routes it. */
+enum CommandVerb { VERB_NONE, VERB_AUDIT, VERB_GET, VERB_OTHER };
 
-  if (is_inception_commit(q, q_len)) {
-    do_inception_commit(thd);
-    return true;
+/**
+ * Classify the verb at [p, end): length and first letter pick the one
+ * candidate among audit, get, kill, pause, reload, resume, set and show
+ * (the third letter tells reload from resume), and a single comparison
+ * confirms it.
+ */
+static CommandVerb command_verb(const char *p, const char *end) {
+  const char *w = p;
+  while (w < end && isalpha(static_cast<unsigned char>(*w))) w++;
+  const size_t len = static_cast<size_t>(w - p);
+  if (len < 3 || len > 6 || (w < end && !isspace(static_cast<unsigned char>(*w))))
+    return VERB_NONE;
+
+  const char *word = nullptr;
+  CommandVerb verb = VERB_OTHER;
+  switch (len * 32 + (tolower(static_cast<unsigned char>(*p)) - 'a')) {
+    case 3 * 32 + ('g' - 'a'): word = "get";  verb = VERB_GET; break;
+    case 3 * 32 + ('s' - 'a'): word = "set";    break;
+    case 4 * 32 + ('k' - 'a'): word = "kill";   break;
+    case 4 * 32 + ('s' - 'a'): word = "show";   break;
+    case 5 * 32 + ('a' - 'a'): word = "audit";  verb = VERB_AUDIT; break;
+    case 5 * 32 + ('p' - 'a'): word = "pause";  break;
+    case 6 * 32 + ('r' - 'a'):
+      word = tolower(static_cast<unsigned char>(p[2])) == 's' ? "resume"
+                                                               : "reload";
+      break;
+    default: return VERB_NONE;
   }
-  if (is_inception_start(q, q_len)) {
-    if (setup_inception_session(thd)) return true;  /* parse error */
-    /* Fall through — let MySQL parser continue.
-       The parser strips the comment; any SQL after it
-       gets parsed and intercepted by intercept_statement(). */
+  return strncasecmp(p, word, len) == 0 ? verb : VERB_NONE;
+}
+
+bool before_parse(THD *thd, Lex_input_stream *lip) {
+  const char *q = thd->query().str;
+  const char *end = q + thd->query().length;
+
+  /* Runs for every query on the server: anything that does not open with
+     a comment or with the word "inception" leaves after a byte or two. */
+  while (q < end && isspace(static_cast<unsigned char>(*q))) q++;
+  if (end - q < 2) return false;
+
+  if (q[0] == '/' && q[1] == '*') {
+    switch (magic_comment(q, static_cast<size_t>(end - q))) {
+      case MAGIC_COMMIT:
+        do_inception_commit(thd);
+        return true;
+      case MAGIC_START:
+        if (setup_inception_session(thd)) return true;  /* parse error */
+        /* Let the MySQL parser continue. It strips the comment; any SQL
+           after it gets parsed and intercepted by intercept_statement(). */
+        break;
+      case MAGIC_NONE:
+        break;
+    }
+    return false;
   }
-  if (handle_inception_command(thd)) {
+
+  /* Long INSERT / REPLACE of a session: see inception_stream.h */
+  if ((q[0] == 'i' || q[0] == 'I' || q[0] == 'r' || q[0] == 'R') &&
+      handle_long_insert(thd, lip, q, static_cast<size_t>(end - q)))
     return true;
+
+  const size_t prefix_len = 9; /* "inception" */
+  if ((q[0] != 'i' && q[0] != 'I') ||
+      static_cast<size_t>(end - q) <= prefix_len ||
+      strncasecmp(q, "inception", prefix_len) != 0 ||
+      !isspace(static_cast<unsigned char>(q[prefix_len])))
+    return false;
+  const char *p = q + prefix_len;
+  while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+
+  switch (command_verb(p, end)) {
+    case VERB_AUDIT:
+      return handle_audit_file(thd, lip);
+    case VERB_GET:
+      return handle_get_tree(thd, lip) || handle_inception_command(thd);
+    case VERB_OTHER:
+      return handle_inception_command(thd);
+    case VERB_NONE:
+      break;
   }
   return false;
 }
 
 bool handle_parse_error(THD *thd, Lex_input_stream *lip) {
-  if (!get_context(thd)->active) return false;
-
-  InceptionContext *ctx = get_context(thd);
-  const char *errmsg = thd->get_stmt_da()->message_text();
+  InceptionContext *ctx = find_active_context(thd);
+  if (!ctx) return false;
 
   /* Truncate the stored SQL at the first semicolon — when parsing fails,
      thd->query() contains the entire remaining multi-statement text.
@@ -432,12 +1290,7 @@ bool handle_parse_error(THD *thd, Lex_input_stream *lip) {
   size_t semi = sql.find(';');
   if (semi != std::string::npos) sql.resize(semi);
 
-  SqlCacheNode &node = ctx->add_sql(sql, SQLCOM_END);
-  node.stage = STAGE_CHECKED;
-  node.stage_status = "Audit completed";
-  node.append_error("SQL parse error: %s", errmsg ? errmsg : "unknown");
-
-  thd->clear_error();
+  record_parse_error(thd, ctx, std::move(sql));
 
   /* Fix found_semicolon so the multi-statement loop can continue */
   if (!lip->found_semicolon) {
@@ -458,8 +1311,9 @@ bool handle_parse_error(THD *thd, Lex_input_stream *lip) {
 }
 
 bool intercept_statement(THD *thd) {
-  InceptionContext *ctx = get_context(thd);
-  if (!ctx->active) return false; /* not in inception session */
+  InceptionContext *ctx = find_active_context(thd);
+  if (!ctx) return false; /* not in inception session */
+  await_remote_db_profile(thd, ctx);
 
   LEX *lex = thd->lex;
 
@@ -559,16 +1413,58 @@ bool intercept_statement(THD *thd) {
       ddlflag = 1;
     }
 
+    /* Tables for parallel_group / depends_on: every table the statement
+       names, plus the parents of foreign keys it declares */
+    std::vector<std::string> tables;
+    auto add_table = [&](const char *db, const char *name) {
+      if (!db || !name) return;
+      std::string key = std::string(db) + "." + name;
+      for (auto &c : key)
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+      if (std::find(tables.begin(), tables.end(), key) == tables.end())
+        tables.push_back(key);
+    };
+    for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global)
+      if (!tl->is_derived())
+        add_table(tl->db ? tl->db : thd->db().str, tl->table_name);
+    bool barrier = !is_table_statement(lex->sql_command);
+    if ((lex->sql_command == SQLCOM_CREATE_TABLE ||
+         lex->sql_command == SQLCOM_ALTER_TABLE) &&
+        lex->alter_info) {
+      /* The parent of a dropped foreign key is not named */
+      if (lex->alter_info->flags & Alter_info::DROP_FOREIGN_KEY)
+        barrier = true;
+      for (const Key_spec *key : lex->alter_info->key_list) {
+        if (key->type != KEYTYPE_FOREIGN) continue;
+        const auto *fk = down_cast<const Foreign_key_spec *>(key);
+        add_table(fk->ref_db.str ? fk->ref_db.str : thd->db().str,
+                  fk->ref_table.str);
+      }
+    }
+    if (tables.empty()) barrier = true;
+
     /* Check if we can append to the last split node */
     bool merged = false;
+    std::string err;
     if (!ctx->split_nodes.empty()) {
       SplitNode &last = ctx->split_nodes.back();
       if (last.table_name == tbl_name && last.db_name == db_name &&
           last.is_ddl_type == is_ddl) {
         /* Same table, same type → append */
-        last.sql_text += sql_text + ";\n";
+        sql_text += ";\n";
+        if (!ctx->split_to_files) {
+          last.sql_text += sql_text;
+        } else if (ctx->split_files.append(sql_text, &err)) {
+          my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+          return true;
+        }
         /* ddlflag escalates: if any statement in the group is high-risk */
         if (ddlflag) last.ddlflag = 1;
+        for (auto &key : tables)
+          if (std::find(last.tables.begin(), last.tables.end(), key) ==
+              last.tables.end())
+            last.tables.push_back(std::move(key));
+        if (barrier) last.barrier = true;
         merged = true;
       }
     }
@@ -580,6 +1476,8 @@ bool intercept_statement(THD *thd) {
       sn.table_name = tbl_name;
       sn.is_ddl_type = is_ddl;
       sn.ddlflag = ddlflag;
+      sn.tables = std::move(tables);
+      sn.barrier = barrier;
 
       std::string use_prefix;
       if (!ctx->current_usedb.empty()) {
@@ -588,8 +1486,20 @@ bool intercept_statement(THD *thd) {
         use_prefix = "USE " + db_name + ";\n";
       }
       sn.sql_text = use_prefix + sql_text + ";\n";
+      if (ctx->split_to_files) {
+        /* The group before is complete: its file is closed here */
+        std::string text;
+        text.swap(sn.sql_text);
+        const int id = static_cast<int>(ctx->split_nodes.size()) + 1;
+        if (ctx->split_files.open_group(id, &sn.sql_text, &err) ||
+            ctx->split_files.append(text, &err)) {
+          my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0), err.c_str());
+          return true;
+        }
+      }
       ctx->split_nodes.push_back(std::move(sn));
     }
+    spool_finished_results(ctx);
 
     my_ok(thd);
     return true;
@@ -624,6 +1534,7 @@ bool intercept_statement(THD *thd) {
     node.sql_text = sql_text;
     node.query_tree_json = extract_query_tree(thd, ctx);
     ctx->tree_nodes.push_back(std::move(node));
+    spool_finished_results(ctx);
 
     my_ok(thd);
     return true;
@@ -646,17 +1557,22 @@ bool intercept_statement(THD *thd) {
     if (db) {
       LEX_CSTRING db_str = {db, strlen(db)};
       thd->set_db(db_str);
+      start_schema_prefetch(ctx, db);
     }
   }
+  spool_finished_results(ctx);
+  ctx->spill_nodes(ctx->cache_nodes.size());
 
   my_ok(thd);
   return true; /* intercepted, skip normal execution */
 }
 
 bool handle_use_db(THD *thd, const char *db, size_t length) {
-  if (!get_context(thd)->active) return false;
+  InceptionContext *ctx = find_active_context(thd);
+  if (!ctx) return false;
   LEX_CSTRING db_str = {db, length};
   thd->set_db(db_str);
+  start_schema_prefetch(ctx, thd->db().str);
   my_ok(thd);
   return true;
 }
@@ -20,12 +20,17 @@ namespace inception {
  * Called from dispatch_sql_command() BEFORE the MySQL parser runs.
  *
  * Handles: inception_magic_start, inception_magic_commit,
+ *          "inception audit file '<name>'" and "inception get tree ..."
+ *          (lip->found_semicolon is set when more statements follow
+ *          them in the packet),
  *          and "inception get/show/set/kill ..." commands.
+ * Runs for every query; one that opens with neither a comment nor the
+ * word "inception" is rejected on its first non-blank bytes.
  *
  * @return true if the query was fully handled (caller should return),
  *         false if the MySQL parser should continue normally.
  */
-bool before_parse(THD *thd);
+bool before_parse(THD *thd, Lex_input_stream *lip);
 
 /**
  * Parse-error hook: record parse errors during active inception sessions.
@@ -5,8 +5,21 @@
 
 #include "sql/inception/inception_audit.h"
 
+#include "sql/inception/inception_batch.h"
+#include "sql/inception/inception_cache.h"
+#include "sql/inception/inception_coldata.h"
+#include "sql/inception/inception_component.h"
 #include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_monitor.h"  // read_replication_delay
+#include "sql/inception/inception_osc.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_profile.h"
 #include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sched.h"  // QuerySlot
+#include "sql/inception/inception_shadow.h"
+#include "sql/inception/inception_status.h"
 #include "sql/inception/inception_sysvars.h"
 #include "sql/create_field.h"  // Create_field
 #include "sql/handler.h"       // HA_CREATE_INFO, handlerton
@@ -22,118 +35,335 @@
 #include "sql/item_func.h"     // Item_func
 
 #include "mysql_com.h"          // UNSIGNED_FLAG
-#include "include/sha1.h"      // compute_sha1_hash, SHA1_HASH_SIZE
-#include "sql/sql_digest.h"    // compute_digest_text, sql_digest_storage
+#include "my_thread.h"          // my_thread_init, my_thread_end
+#include "sql/sql_digest.h"    // compute_digest_hash, sql_digest_storage
+#include "sha2.h"              // SHA_EVP256
 
 #include "sql/item_cmpfunc.h"  // Item_cond, Item_func_in
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cstdio>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
 
 namespace inception {
 
 /* ---- Remote connection helpers ---- */
 
 /**
- * Lazily connect to the remote target MySQL server.
+ * Lazily borrow a connection to the remote target MySQL server from the pool.
  * Returns the MYSQL* handle (stored in ctx->remote_conn), or nullptr on failure.
+ * The connection goes back to the pool in InceptionContext::reset().
  */
 MYSQL *get_remote_conn(InceptionContext *ctx) {
+  if (ctx->connect_thread.joinable()) {
+    ctx->connect_thread.join();
+    if (ctx->warm_conn) {
+      ctx->remote_conn = ctx->warm_conn;
+      ctx->warm_conn = nullptr;
+    } else if (!ctx->warm_conn_error.empty()) {
+      ctx->remote_conn_error = std::move(ctx->warm_conn_error);
+      ctx->warm_conn_error.clear();
+      ctx->remote_conn_failed = true;
+    }
+    /* Neither: the thread could not start, connect here */
+  }
   if (ctx->remote_conn) return ctx->remote_conn;
   if (ctx->remote_conn_failed) return nullptr;  /* Don't retry */
-
-  MYSQL *mysql = mysql_init(nullptr);
+  if (ctx->shadow) return nullptr;  /* --schema-file: offline */
+
+  PoolConnOptions opts;
+  opts.connect_timeout = 5;
+  std::string errmsg;
+  MYSQL *mysql = pool_acquire(ctx->host.empty() ? "127.0.0.1" : ctx->host,
+                              ctx->port, ctx->user.empty() ? "root" : ctx->user,
+                              ctx->password, opts, &errmsg);
   if (!mysql) {
+    ctx->remote_conn_error = errmsg;
     ctx->remote_conn_failed = true;
-    ctx->remote_conn_error = "mysql_init() failed";
     return nullptr;
   }
 
-  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
-  unsigned int timeout = 5;
-  mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
-
-  const char *host = ctx->host.empty() ? "127.0.0.1" : ctx->host.c_str();
-  const char *user = ctx->user.empty() ? "root" : ctx->user.c_str();
-  const char *pass = ctx->password.empty() ? nullptr : ctx->password.c_str();
+  ctx->remote_conn = mysql;
+  return mysql;
+}
 
-  if (!mysql_real_connect(mysql, host, user, pass, nullptr, ctx->port,
-                          nullptr, 0)) {
-    ctx->remote_conn_error = mysql_error(mysql);
-    ctx->remote_conn_failed = true;
-    mysql_close(mysql);
-    return nullptr;
+bool audit_host_usable(MYSQL *mysql, std::string *why) {
+  if (opt_audit_host_max_lag == 0) return true;
+  long delay = 0;
+  if (read_replication_delay(mysql, &delay)) {
+    *why = "it is not a replica";
+    return false;
+  }
+  if (delay < 0) {
+    *why = "replication is stopped (Seconds_Behind_Master is NULL)";
+    return false;
   }
+  if (static_cast<ulong>(delay) > opt_audit_host_max_lag) {
+    *why = format_sql("it is %lds behind, over inception_audit_host_max_lag",
+                      delay);
+    return false;
+  }
+  return true;
+}
 
-  ctx->remote_conn = mysql;
+/**
+ * The --audit-host replica, connected on first use, for the read-only
+ * audit queries of the session; primary when there is none, it cannot be
+ * reached or it lags (logged once per session).
+ */
+MYSQL *get_audit_conn(InceptionContext *ctx, MYSQL *primary) {
+  if (!primary || ctx->audit_server.first.empty() || ctx->audit_conn_failed)
+    return primary;
+  if (ctx->audit_conn) return ctx->audit_conn;
+
+  const std::string where = ctx->audit_server.first + ":" +
+                            std::to_string(ctx->audit_server.second);
+  PoolConnOptions opts;
+  opts.connect_timeout = 5;
+  std::string why;
+  MYSQL *mysql = pool_acquire(ctx->audit_server.first,
+                              ctx->audit_server.second,
+                              ctx->user.empty() ? "root" : ctx->user,
+                              ctx->password, opts, &why);
+  if (mysql && !audit_host_usable(mysql, &why)) {
+    pool_release(mysql, PoolRelease::CLEAN);
+    mysql = nullptr;
+  }
+  if (!mysql) {
+    fprintf(stderr, "[Inception] --audit-host %s not used: %s; auditing "
+            "against the target.\n", where.c_str(), why.c_str());
+    fflush(stderr);
+    ctx->audit_conn_failed = true;
+    return primary;
+  }
+  ctx->audit_conn = mysql;
   return mysql;
 }
 
+void connect_remote_async(InceptionContext *ctx) {
+  if (ctx->remote_conn || ctx->remote_conn_failed || ctx->shadow ||
+      ctx->connect_thread.joinable())
+    return;
+
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  std::string password = ctx->password;
+  uint port = ctx->port;
+  MYSQL **conn_out = &ctx->warm_conn;
+  std::string *error_out = &ctx->warm_conn_error;
+
+  auto work = [=]() {
+    if (my_thread_init()) return;
+    bind_worker_resource_group();
+    PoolConnOptions opts;
+    opts.connect_timeout = 5;
+    *conn_out = pool_acquire(host, port, user, password, opts, error_out);
+    my_thread_end();
+  };
+
+  try {
+    ctx->connect_thread = std::thread(work);
+  } catch (const std::system_error &) {
+    /* No thread available: get_remote_conn() connects on first use. */
+  }
+}
+
+/* ---- Rule instrumentation ---- */
+
+/* Indexed by AuditRule */
+static const char *const RULE_NAMES[RULE_COUNT] = {
+    "preload",
+    "metadata",
+    "explain",
+    "create_database",
+    "drop_database",
+    "create_table",
+    "column",
+    "index",
+    "must_have_columns",
+    "alter_table",
+    "insert",
+    "update",
+    "delete",
+    "select",
+    "drop_table",
+    "truncate",
+    "dml_literals",
+    "component",
+};
+
+const char *audit_rule_name(int rule) {
+  return rule >= 0 && rule < RULE_COUNT ? RULE_NAMES[rule] : "";
+}
+
+static InceptionMutex g_rule_stats_mutex("rule_stats");
+static RuleStats g_rule_stats;
+
+void rule_stats_merge(const RuleStats &stats) {
+  std::lock_guard<InceptionMutex> lock(g_rule_stats_mutex);
+  for (int i = 0; i < RULE_COUNT; i++) {
+    g_rule_stats[i].calls += stats[i].calls;
+    g_rule_stats[i].time_ns += stats[i].time_ns;
+    g_rule_stats[i].remote_queries += stats[i].remote_queries;
+    g_rule_stats[i].violations += stats[i].violations;
+  }
+}
+
+RuleStats get_rule_stats() {
+  std::lock_guard<InceptionMutex> lock(g_rule_stats_mutex);
+  return g_rule_stats;
+}
+
+/**
+ * Times one run of an AuditRule into ctx->rule_stats, with the remote
+ * queries it sent and the messages it appended to node (nullptr for the
+ * lookups, which report nothing). What nested scopes measured is left to
+ * them.
+ */
+class RuleScope {
+ public:
+  RuleScope(InceptionContext *ctx, const SqlCacheNode *node, AuditRule rule)
+      : m_ctx(ctx),
+        m_node(node),
+        m_rule(rule),
+        m_parent(ctx->rule_scope),
+        m_queries(ctx->remote_queries),
+        m_findings(node ? node->findings : 0),
+        m_start(std::chrono::steady_clock::now()) {
+    ctx->rule_scope = this;
+  }
+
+  ~RuleScope() {
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - m_start)
+                            .count();
+    const uint64_t queries = m_ctx->remote_queries - m_queries;
+    const uint64_t findings = m_node ? m_node->findings - m_findings : 0;
+    RuleStat &stat = m_ctx->rule_stats[m_rule];
+    stat.calls++;
+    stat.time_ns += ns - std::min(ns, m_child_ns);
+    stat.remote_queries += queries - std::min(queries, m_child_queries);
+    stat.violations += findings - std::min(findings, m_child_findings);
+    if (m_parent) {
+      m_parent->m_child_ns += ns;
+      m_parent->m_child_queries += queries;
+      if (m_node == m_parent->m_node) m_parent->m_child_findings += findings;
+    }
+    m_ctx->rule_scope = m_parent;
+  }
+
+  RuleScope(const RuleScope &) = delete;
+  RuleScope &operator=(const RuleScope &) = delete;
+
+ private:
+  InceptionContext *m_ctx;
+  const SqlCacheNode *m_node;
+  const AuditRule m_rule;
+  RuleScope *m_parent;
+  const uint64_t m_queries;
+  const int m_findings;
+  const std::chrono::steady_clock::time_point m_start;
+  uint64_t m_child_ns = 0;
+  uint64_t m_child_queries = 0;
+  uint64_t m_child_findings = 0;
+};
+
+/** CPU time of the calling thread, in microseconds. */
+static uint64_t thread_cpu_us() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) return 0;
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Adds the audit of a statement to its audit log timing: the thread CPU
+ * time it used, and the metadata queries sent for it and their time.
+ */
+class AuditTiming {
+ public:
+  AuditTiming(InceptionContext *ctx, SqlCacheNode *node)
+      : m_ctx(ctx),
+        m_node(node),
+        m_cpu_us(thread_cpu_us()),
+        m_queries(ctx->remote_queries),
+        m_remote_us(ctx->remote_us) {}
+
+  ~AuditTiming() {
+    const uint64_t cpu_us = thread_cpu_us();
+    m_node->audit_cpu_us += cpu_us - std::min(cpu_us, m_cpu_us);
+    m_node->metadata_us += m_ctx->remote_us - m_remote_us;
+    m_node->round_trips +=
+        static_cast<uint32_t>(m_ctx->remote_queries - m_queries);
+  }
+
+  AuditTiming(const AuditTiming &) = delete;
+  AuditTiming &operator=(const AuditTiming &) = delete;
+
+ private:
+  InceptionContext *m_ctx;
+  SqlCacheNode *m_node;
+  const uint64_t m_cpu_us;
+  const uint64_t m_queries;
+  const uint64_t m_remote_us;
+};
+
+/*
+ * Existence / row-count checks are answered from the shared metadata cache
+ * (inception_cache.cc): the first reference to a table loads its columns,
+ * indexes and row estimate in one round trip.
+ */
+
+/**
+ * Whether metadata checks can be answered: from the remote target, or
+ * offline from the --schema-file catalog (no connection then).
+ */
+static bool have_meta(InceptionContext *ctx, MYSQL *remote) {
+  return remote || ctx->shadow;
+}
+
 /** Check if a database exists on the remote server. */
-static bool remote_db_exists(MYSQL *mysql, const char *db_name) {
-  char query[256];
-  snprintf(query, sizeof(query), remote_sql::SHOW_DATABASES_LIKE, db_name);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return false;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-  bool exists = (mysql_num_rows(res) > 0);
-  mysql_free_result(res);
-  return exists;
+static bool remote_db_exists(InceptionContext *ctx, MYSQL *mysql,
+                             const char *db_name) {
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  return cached_db_exists(ctx, mysql, db_name);
 }
 
 /** Check if a table exists on the remote server in the given database. */
-static bool remote_table_exists(MYSQL *mysql, const char *db_name,
+static bool remote_table_exists(InceptionContext *ctx, MYSQL *mysql,
+                                const char *db_name,
                                 const char *table_name) {
-  /* Switch to the target database first */
-  char use_query[256];
-  snprintf(use_query, sizeof(use_query), remote_sql::USE_DATABASE, db_name);
-  if (mysql_real_query(mysql, use_query,
-                       static_cast<unsigned long>(strlen(use_query))))
-    return false;
-
-  char query[256];
-  snprintf(query, sizeof(query), remote_sql::SHOW_TABLES_LIKE, table_name);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return false;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-  bool exists = (mysql_num_rows(res) > 0);
-  mysql_free_result(res);
-  return exists;
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  TableMetaPtr meta = get_table_meta(ctx, mysql, db_name, table_name);
+  return meta && meta->exists;
 }
 
 /** Check if a column exists in a table on the remote server. */
-static bool remote_column_exists(MYSQL *mysql, const char *db_name,
+static bool remote_column_exists(InceptionContext *ctx, MYSQL *mysql,
+                                 const char *db_name,
                                  const char *table_name,
                                  const char *column_name) {
-  char query[512];
-  snprintf(query, sizeof(query), remote_sql::CHECK_COLUMN_EXISTS,
-           db_name, table_name, column_name);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return false;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-  bool exists = (mysql_num_rows(res) > 0);
-  mysql_free_result(res);
-  return exists;
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  TableMetaPtr meta = get_table_meta(ctx, mysql, db_name, table_name);
+  return meta && meta->find_column(column_name) != nullptr;
 }
 
 /** Check if an index exists in a table on the remote server. */
-static bool remote_index_exists(MYSQL *mysql, const char *db_name,
+static bool remote_index_exists(InceptionContext *ctx, MYSQL *mysql,
+                                const char *db_name,
                                 const char *table_name,
                                 const char *index_name) {
-  char query[512];
-  snprintf(query, sizeof(query), remote_sql::CHECK_INDEX_EXISTS,
-           db_name, table_name, index_name);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return false;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-  bool exists = (mysql_num_rows(res) > 0);
-  mysql_free_result(res);
-  return exists;
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  TableMetaPtr meta = get_table_meta(ctx, mysql, db_name, table_name);
+  return meta && meta->has_index(index_name);
 }
 
 /**
@@ -141,48 +371,65 @@ static bool remote_index_exists(MYSQL *mysql, const char *db_name,
  * Uses information_schema.TABLES.TABLE_ROWS for fast estimation.
  * Returns -1 on failure.
  */
-static int64_t remote_table_rows(MYSQL *mysql, const char *db_name,
+static int64_t remote_table_rows(InceptionContext *ctx, MYSQL *mysql,
+                                 const char *db_name,
                                  const char *table_name) {
-  char query[512];
-  snprintf(query, sizeof(query), remote_sql::GET_TABLE_ROWS,
-           db_name, table_name);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return -1;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return -1;
-  MYSQL_ROW row = mysql_fetch_row(res);
-  int64_t count = -1;
-  if (row && row[0]) {
-    count = strtoll(row[0], nullptr, 10);
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  TableMetaPtr meta = get_table_meta(ctx, mysql, db_name, table_name);
+  return (meta && meta->exists) ? meta->table_rows : -1;
+}
+
+/** What explain_plan() reads from the EXPLAIN of a DML statement. */
+struct ExplainPlan {
+  int64_t rows = -1;        /* estimated rows, -1 if unknown */
+  bool full_scan = false;   /* some table is read whole ... */
+  std::string scan_table;   /* ... the largest of them */
+  int64_t scan_rows = 0;
+  bool filesort = false;    /* a step sorts with a filesort ... */
+  bool temporary = false;   /* ... or through a temporary table */
+  int64_t sort_rows = 0;    /* rows of the largest such step */
+};
+
+/** Index of the result column called name, or fallback. */
+static int explain_column(MYSQL_RES *res, const char *name, int fallback) {
+  MYSQL_FIELD *fields = mysql_fetch_fields(res);
+  for (unsigned int i = 0; i < res->field_count; i++) {
+    if (fields[i].name && strcasecmp(fields[i].name, name) == 0)
+      return static_cast<int>(i);
   }
-  mysql_free_result(res);
-  return count;
+  return static_cast<unsigned int>(fallback) < res->field_count ? fallback
+                                                                 : -1;
 }
 
 /**
- * Estimate affected rows of a DML statement using EXPLAIN on the remote server.
- * Sends "EXPLAIN <sql>" and reads the optimizer's rows estimate.
- * Supports both MySQL (rows at index 9) and TiDB (estRows at index 1).
- * More accurate than TABLE_ROWS for UPDATE/DELETE with WHERE clause.
- * Returns -1 on failure.
+ * EXPLAIN a DML statement on the remote server and read the optimizer's
+ * plan: the rows estimate, a whole-table read (MySQL type ALL or index,
+ * TiDB TableFullScan) and a filesort or temporary table (MySQL Extra,
+ * TiDB Sort operator). More accurate than TABLE_ROWS for UPDATE/DELETE
+ * with a WHERE clause.
+ * @return false on success, true if the plan could not be read.
  */
-static int64_t explain_rows(MYSQL *mysql, const char *db,
-                            const std::string &sql_text, bool is_tidb) {
-  /* Set database context for EXPLAIN */
-  {
-    std::string use_sql = "USE `" + std::string(db) + "`";
-    if (mysql_real_query(mysql, use_sql.c_str(),
-                         static_cast<unsigned long>(use_sql.size())))
-      return -1;
-  }
+static bool explain_plan(InceptionContext *ctx, MYSQL *mysql, const char *db,
+                         const std::string &sql_text, bool is_tidb,
+                         ExplainPlan *plan) {
+  RuleScope scope(ctx, nullptr, RULE_EXPLAIN);
+  StageScope stage(stage_inception_remote_check);
+  QuerySlot slot(ctx, mysql);
+  if (slot.killed()) return true;
+  ctx->remote_queries++;
+  status_add(STATUS_REMOTE_QUERIES);
+  /* Set database context for EXPLAIN (no round trip if already there) */
+  if (pool_select_db(mysql, db)) return true;
 
   std::string explain_sql = "EXPLAIN " + sql_text;
+  const auto start = std::chrono::steady_clock::now();
   if (mysql_real_query(mysql, explain_sql.c_str(),
                        static_cast<unsigned long>(explain_sql.size())))
-    return -1;
+    return true;
 
   MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return -1;
+  ctx->remote_us += record_remote_latency(mysql, REMOTE_EXPLAIN, start);
+  if (!res) return true;
 
   /*
    * MySQL EXPLAIN columns (5.7+/8.0):
@@ -192,34 +439,59 @@ static int64_t explain_rows(MYSQL *mysql, const char *db,
    * TiDB EXPLAIN columns:
    *   0:id 1:estRows 2:task 3:access object 4:operator info
    */
-  const int rows_idx = is_tidb ? 1 : 9;
-  const unsigned int field_count = res->field_count;
-
-  /* Safety check: ensure the rows column index is within bounds */
-  if (static_cast<unsigned int>(rows_idx) >= field_count) {
+  const int rows_idx = explain_column(res, is_tidb ? "estRows" : "rows",
+                                      is_tidb ? 1 : 9);
+  const int table_idx = explain_column(res, is_tidb ? "access object" : "table",
+                                       is_tidb ? 3 : 2);
+  const int type_idx = is_tidb ? 0 : explain_column(res, "type", 4);
+  const int extra_idx = is_tidb ? -1 : explain_column(res, "Extra", 11);
+  if (rows_idx < 0) {
     mysql_free_result(res);
-    return -1;
+    return true;
   }
 
   int64_t total = 0;
   bool first_row = true;
   MYSQL_ROW row;
   while ((row = mysql_fetch_row(res))) {
-    if (row[rows_idx]) {
-      double val = strtod(row[rows_idx], nullptr);
-      if (first_row) {
-        /* For TiDB, take only the first row (root operator);
-           for MySQL single-table DML, usually only 1 row anyway. */
-        total = static_cast<int64_t>(val);
-        first_row = false;
-      } else if (!is_tidb) {
-        total += static_cast<int64_t>(val);
-      }
+    if (!row[rows_idx]) continue;
+    const int64_t val = static_cast<int64_t>(strtod(row[rows_idx], nullptr));
+    if (first_row) {
+      /* For TiDB, take only the first row (root operator);
+         for MySQL single-table DML, usually only 1 row anyway. */
+      total = val;
+      first_row = false;
+    } else if (!is_tidb) {
+      total += val;
+    }
+
+    const char *type = type_idx >= 0 ? row[type_idx] : nullptr;
+    const bool full_scan =
+        type && (is_tidb ? strstr(type, "TableFullScan") != nullptr
+                         : (strcmp(type, "ALL") == 0 ||
+                            strcmp(type, "index") == 0));
+    if (full_scan && (!plan->full_scan || val > plan->scan_rows)) {
+      const char *table = table_idx >= 0 ? row[table_idx] : nullptr;
+      if (table && is_tidb && strncmp(table, "table:", 6) == 0) table += 6;
+      plan->full_scan = true;
+      plan->scan_table = table ? table : "";
+      plan->scan_rows = val;
+    }
+
+    const char *extra = extra_idx >= 0 ? row[extra_idx] : nullptr;
+    const bool filesort = is_tidb ? type && strncmp(type, "Sort", 4) == 0
+                                  : extra && strstr(extra, "Using filesort");
+    const bool temporary = extra && strstr(extra, "Using temporary");
+    if (filesort || temporary) {
+      plan->filesort |= filesort;
+      plan->temporary |= temporary;
+      plan->sort_rows = std::max(plan->sort_rows, val);
     }
   }
 
   mysql_free_result(res);
-  return total;
+  plan->rows = total;
+  return false;
 }
 
 /* ---- Batch table tracking helpers ---- */
@@ -260,32 +532,38 @@ static bool is_valid_identifier(const char *name) {
 /* ---- Column check (shared by CREATE TABLE / ALTER TABLE ADD COLUMN) ---- */
 
 static void check_column(Create_field *field, SqlCacheNode *node,
-                         InceptionContext *ctx = nullptr) {
+                         InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+
+  /* No column rule is on: only the JSON version check below can report */
+  if (!rules.column_rules && field->sql_type != MYSQL_TYPE_JSON) return;
+  RuleScope scope(ctx, node, RULE_COLUMN);
+
   /* Column name length */
-  if (opt_check_max_column_name_length > 0 &&
-      strlen(field->field_name) > opt_check_max_column_name_length) {
+  if (rules.check_max_column_name_length > 0 &&
+      strlen(field->field_name) > rules.check_max_column_name_length) {
     node->append_warning(
         "Column '%s' name length %zu exceeds max %lu.",
         field->field_name, strlen(field->field_name),
-        opt_check_max_column_name_length);
+        rules.check_max_column_name_length);
   }
 
   /* Column name format */
-  if (opt_check_identifier > 0 && !is_valid_identifier(field->field_name)) {
-    node->report(opt_check_identifier,
+  if (rules.check_identifier > 0 && !is_valid_identifier(field->field_name)) {
+    node->report(rules.check_identifier,
         "Column '%s' name should be lowercase letters, digits and underscores.",
         field->field_name);
   }
 
   /* Column comment */
-  if (opt_check_column_comment > 0 && field->comment.length == 0) {
-    node->report(opt_check_column_comment,
+  if (rules.check_column_comment > 0 && field->comment.length == 0) {
+    node->report(rules.check_column_comment,
         "Column '%s' must have a comment.", field->field_name);
   }
 
   /* Nullable check (skip for JSON/BLOB/TEXT — these types commonly allow NULL
      and cannot have simple literal defaults) */
-  if (opt_check_nullable > 0 && field->is_nullable) {
+  if (rules.check_nullable > 0 && field->is_nullable) {
     switch (field->sql_type) {
       case MYSQL_TYPE_JSON:
       case MYSQL_TYPE_TINY_BLOB:
@@ -294,7 +572,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
       case MYSQL_TYPE_LONG_BLOB:
         break;  /* skip nullable warning for JSON/BLOB/TEXT */
       default:
-        node->report(opt_check_nullable,
+        node->report(rules.check_nullable,
             "Column '%s' is nullable; consider NOT NULL with a default.",
             field->field_name);
         break;
@@ -302,7 +580,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
   }
 
   /* NOT NULL without DEFAULT (skip for JSON/BLOB/TEXT) */
-  if (opt_check_not_null_default > 0 && !field->is_nullable &&
+  if (rules.check_not_null_default > 0 && !field->is_nullable &&
       !(field->auto_flags & Field::NEXT_NUMBER) &&
       field->constant_default == nullptr &&
       !(field->auto_flags & Field::DEFAULT_NOW) &&
@@ -311,7 +589,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
       field->sql_type != MYSQL_TYPE_BLOB &&
       field->sql_type != MYSQL_TYPE_MEDIUM_BLOB &&
       field->sql_type != MYSQL_TYPE_LONG_BLOB) {
-    node->report(opt_check_not_null_default,
+    node->report(rules.check_not_null_default,
         "Column '%s' is NOT NULL but has no DEFAULT value.",
         field->field_name);
   }
@@ -331,23 +609,23 @@ static void check_column(Create_field *field, SqlCacheNode *node,
         (field->auto_flags & Field::GENERATED_FROM_EXPRESSION) ||
         field->m_default_val_expr != nullptr;
     if (ctx && is_json_or_blob && has_explicit_default &&
-        opt_check_json_blob_text_default > 0 &&
+        rules.check_json_blob_text_default > 0 &&
         (ctx->db_type == DbType::MYSQL || ctx->db_type == DbType::TIDB)) {
       node->report(
-          opt_check_json_blob_text_default,
+          rules.check_json_blob_text_default,
           "Column '%s': explicit DEFAULT on JSON/BLOB/TEXT is not allowed.",
           field->field_name);
     }
   }
 
   /* BLOB/TEXT type */
-  if (opt_check_blob_type > 0) {
+  if (rules.check_blob_type > 0) {
     switch (field->sql_type) {
       case MYSQL_TYPE_TINY_BLOB:
       case MYSQL_TYPE_BLOB:
       case MYSQL_TYPE_MEDIUM_BLOB:
       case MYSQL_TYPE_LONG_BLOB:
-        node->report(opt_check_blob_type,
+        node->report(rules.check_blob_type,
             "Column '%s' uses BLOB/TEXT type.", field->field_name);
         break;
       default:
@@ -356,22 +634,22 @@ static void check_column(Create_field *field, SqlCacheNode *node,
   }
 
   /* ENUM type */
-  if (opt_check_enum_type > 0 && field->sql_type == MYSQL_TYPE_ENUM) {
-    node->report(opt_check_enum_type,
+  if (rules.check_enum_type > 0 && field->sql_type == MYSQL_TYPE_ENUM) {
+    node->report(rules.check_enum_type,
         "Column '%s' uses ENUM type, not recommended.",
         field->field_name);
   }
 
   /* SET type */
-  if (opt_check_set_type > 0 && field->sql_type == MYSQL_TYPE_SET) {
-    node->report(opt_check_set_type,
+  if (rules.check_set_type > 0 && field->sql_type == MYSQL_TYPE_SET) {
+    node->report(rules.check_set_type,
         "Column '%s' uses SET type, not recommended.",
         field->field_name);
   }
 
   /* BIT type */
-  if (opt_check_bit_type > 0 && field->sql_type == MYSQL_TYPE_BIT) {
-    node->report(opt_check_bit_type,
+  if (rules.check_bit_type > 0 && field->sql_type == MYSQL_TYPE_BIT) {
+    node->report(rules.check_bit_type,
         "Column '%s' uses BIT type, not recommended.",
         field->field_name);
   }
@@ -384,60 +662,60 @@ static void check_column(Create_field *field, SqlCacheNode *node,
       node->append_error(
           "Column '%s': JSON type is not supported in MySQL %u.%u.",
           field->field_name, ctx->db_version_major, ctx->db_version_minor);
-    } else if (opt_check_json_type > 0) {
-      node->report(opt_check_json_type,
+    } else if (rules.check_json_type > 0) {
+      node->report(rules.check_json_type,
           "Column '%s' uses JSON type.",
           field->field_name);
     }
   }
 
   /* CHAR length check */
-  if (opt_check_max_char_length > 0 && field->sql_type == MYSQL_TYPE_STRING) {
+  if (rules.check_max_char_length > 0 && field->sql_type == MYSQL_TYPE_STRING) {
     size_t width = field->max_display_width_in_codepoints();
-    if (width > opt_check_max_char_length) {
+    if (width > rules.check_max_char_length) {
       node->append_warning(
           "Column '%s' CHAR(%zu) exceeds max %lu; consider VARCHAR.",
-          field->field_name, width, opt_check_max_char_length);
+          field->field_name, width, rules.check_max_char_length);
     }
   }
 
   /* Auto-increment checks */
   if (field->auto_flags & Field::NEXT_NUMBER) {
     /* Must be unsigned */
-    if (opt_check_autoincrement > 0 && !(field->flags & UNSIGNED_FLAG)) {
-      node->report(opt_check_autoincrement,
+    if (rules.check_autoincrement > 0 && !(field->flags & UNSIGNED_FLAG)) {
+      node->report(rules.check_autoincrement,
           "Auto-increment column '%s' should be UNSIGNED.",
           field->field_name);
     }
     /* Must be INT/BIGINT */
-    if (opt_check_autoincrement > 0) {
+    if (rules.check_autoincrement > 0) {
       switch (field->sql_type) {
         case MYSQL_TYPE_LONG:      // INT
         case MYSQL_TYPE_LONGLONG:  // BIGINT
           break;
         default:
-          node->report(opt_check_autoincrement,
+          node->report(rules.check_autoincrement,
               "Auto-increment column '%s' should be INT or BIGINT.",
               field->field_name);
           break;
       }
     }
     /* Auto-increment column must be named "id" */
-    if (opt_check_autoincrement_name > 0 &&
+    if (rules.check_autoincrement_name > 0 &&
         strcasecmp(field->field_name, "id") != 0) {
-      node->report(opt_check_autoincrement_name,
+      node->report(rules.check_autoincrement_name,
           "Auto-increment column '%s' should be named 'id'.",
           field->field_name);
     }
   }
 
   /* TIMESTAMP must have DEFAULT */
-  if (opt_check_timestamp_default > 0) {
+  if (rules.check_timestamp_default > 0) {
     if (field->sql_type == MYSQL_TYPE_TIMESTAMP ||
         field->sql_type == MYSQL_TYPE_TIMESTAMP2) {
       if (field->constant_default == nullptr &&
           !(field->auto_flags & Field::DEFAULT_NOW)) {
-        node->report(opt_check_timestamp_default,
+        node->report(rules.check_timestamp_default,
             "TIMESTAMP column '%s' must have a DEFAULT value.",
             field->field_name);
       }
@@ -445,7 +723,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
   }
 
   /* Column-level charset check */
-  if (opt_check_column_charset > 0 && field->charset != nullptr) {
+  if (rules.check_column_charset > 0 && field->charset != nullptr) {
     /* If column has explicit charset, warn */
     if (field->charset && field->sql_type != MYSQL_TYPE_BLOB &&
         field->sql_type != MYSQL_TYPE_TINY_BLOB &&
@@ -454,7 +732,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
       /* Only report if the charset was explicitly specified by the user.
          Check: if the column has explicit_collation flag set. */
       if (field->is_explicit_collation) {
-        node->report(opt_check_column_charset,
+        node->report(rules.check_column_charset,
             "Column '%s' specifies a character set; use table default instead.",
             field->field_name);
       }
@@ -462,7 +740,7 @@ static void check_column(Create_field *field, SqlCacheNode *node,
   }
 
   /* All new columns must have DEFAULT value (skip for JSON/BLOB/TEXT) */
-  if (opt_check_column_default_value > 0 &&
+  if (rules.check_column_default_value > 0 &&
       !(field->auto_flags & Field::NEXT_NUMBER) &&
       field->constant_default == nullptr &&
       !(field->auto_flags & Field::DEFAULT_NOW) &&
@@ -471,15 +749,15 @@ static void check_column(Create_field *field, SqlCacheNode *node,
       field->sql_type != MYSQL_TYPE_BLOB &&
       field->sql_type != MYSQL_TYPE_MEDIUM_BLOB &&
       field->sql_type != MYSQL_TYPE_LONG_BLOB) {
-    node->report(opt_check_column_default_value,
+    node->report(rules.check_column_default_value,
         "Column '%s' must have a DEFAULT value.",
         field->field_name);
   }
 
   /* Identifier keyword check: column name must not be a MySQL reserved keyword */
-  if (opt_check_identifier_keyword > 0 && field->field_name) {
+  if (rules.check_identifier_keyword > 0 && field->field_name) {
     if (is_keyword(field->field_name, strlen(field->field_name))) {
-      node->report(opt_check_identifier_keyword,
+      node->report(rules.check_identifier_keyword,
           "Column name '%s' is a MySQL reserved keyword.",
           field->field_name);
     }
@@ -510,35 +788,34 @@ static int int_type_rank_from_name(const char *name) {
   return 0;
 }
 
-/** Remote column type info from information_schema. */
-struct RemoteColumnInfo {
-  std::string data_type;       /* e.g. "int", "varchar", "text" */
-  int64_t char_max_length;     /* CHARACTER_MAXIMUM_LENGTH, -1 if N/A */
-  int64_t numeric_precision;   /* NUMERIC_PRECISION, -1 if N/A */
-  int64_t numeric_scale;       /* NUMERIC_SCALE, -1 if N/A */
-};
+/** Range of the integer type of rank (see int_type_rank) as SQL literals. */
+static void int_type_bounds(int rank, bool is_unsigned, std::string *lo,
+                            std::string *hi) {
+  static const char *const signed_max[] = {
+      "127", "32767", "8388607", "2147483647", "9223372036854775807"};
+  static const char *const unsigned_max[] = {
+      "255", "65535", "16777215", "4294967295", "18446744073709551615"};
+  *hi = is_unsigned ? unsigned_max[rank - 1] : signed_max[rank - 1];
+  *lo = is_unsigned ? "0" : "-" + std::to_string(std::stoull(*hi) + 1);
+}
+
+/** Largest value of DECIMAL(precision, scale), e.g. "999.99". */
+static std::string decimal_type_max(uint precision, uint scale) {
+  std::string max(precision > scale ? precision - scale : 1,
+                  precision > scale ? '9' : '0');
+  if (scale > 0) max += "." + std::string(scale, '9');
+  return max;
+}
 
 /** Query remote column type info. Returns true on success. */
-static bool remote_column_info(MYSQL *mysql, const char *db,
-                               const char *table, const char *column,
-                               RemoteColumnInfo *info) {
-  char query[512];
-  snprintf(query, sizeof(query), remote_sql::GET_COLUMN_INFO,
-           db, table, column);
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
-    return false;
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-  MYSQL_ROW row = mysql_fetch_row(res);
-  if (!row || !row[0]) {
-    mysql_free_result(res);
-    return false;
-  }
-  info->data_type = row[0];
-  info->char_max_length = (row[1]) ? strtoll(row[1], nullptr, 10) : -1;
-  info->numeric_precision = (row[2]) ? strtoll(row[2], nullptr, 10) : -1;
-  info->numeric_scale = (row[3]) ? strtoll(row[3], nullptr, 10) : -1;
-  mysql_free_result(res);
+static bool remote_column_info(InceptionContext *ctx, MYSQL *mysql,
+                               const char *db, const char *table,
+                               const char *column, RemoteColumnInfo *info) {
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  TableMetaPtr meta = get_table_meta(ctx, mysql, db, table);
+  const RemoteColumnInfo *col = meta ? meta->find_column(column) : nullptr;
+  if (!col) return false;
+  *info = *col;
   return true;
 }
 
@@ -565,29 +842,30 @@ static bool is_blob_type_name(const char *name) {
 
 static void check_index(const Key_spec *key, SqlCacheNode *node,
                         Alter_info *alter_info,
-                        MYSQL *remote = nullptr,
-                        const char *db = nullptr,
-                        const char *table_name = nullptr,
-                        InceptionContext *ctx = nullptr) {
+                        MYSQL *remote, const char *db,
+                        const char *table_name, InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_INDEX);
+
   /* Index column count limit */
-  if (opt_check_max_index_parts > 0 && key->columns.size() > opt_check_max_index_parts) {
+  if (rules.check_max_index_parts > 0 && key->columns.size() > rules.check_max_index_parts) {
     node->append_warning(
         "Index '%s' has %zu columns, exceeds max %lu.",
         key->name.str ? key->name.str : "(unnamed)",
-        key->columns.size(), opt_check_max_index_parts);
+        key->columns.size(), rules.check_max_index_parts);
   }
 
   /* Index naming convention: idx_ for normal, uniq_ for unique */
-  if (opt_check_index_prefix > 0 && key->name.str) {
+  if (rules.check_index_prefix > 0 && key->name.str) {
     if (key->type == KEYTYPE_UNIQUE) {
       if (strncasecmp(key->name.str, "uniq_", 5) != 0) {
-        node->report(opt_check_index_prefix,
+        node->report(rules.check_index_prefix,
             "Unique index '%s' should have 'uniq_' prefix.",
             key->name.str);
       }
     } else if (key->type == KEYTYPE_MULTIPLE) {
       if (strncasecmp(key->name.str, "idx_", 4) != 0) {
-        node->report(opt_check_index_prefix,
+        node->report(rules.check_index_prefix,
             "Index '%s' should have 'idx_' prefix.",
             key->name.str);
       }
@@ -595,14 +873,14 @@ static void check_index(const Key_spec *key, SqlCacheNode *node,
   }
 
   /* Foreign key check */
-  if (opt_check_foreign_key > 0 && key->type == KEYTYPE_FOREIGN) {
-    node->report(opt_check_foreign_key, "Foreign keys are not allowed.");
+  if (rules.check_foreign_key > 0 && key->type == KEYTYPE_FOREIGN) {
+    node->report(rules.check_foreign_key, "Foreign keys are not allowed.");
   }
 
   /* TiDB foreign key check: TiDB does not support foreign keys */
   if (ctx && ctx->db_type == DbType::TIDB &&
-      opt_check_tidb_foreign_key > 0 && key->type == KEYTYPE_FOREIGN) {
-    node->report(opt_check_tidb_foreign_key,
+      rules.check_tidb_foreign_key > 0 && key->type == KEYTYPE_FOREIGN) {
+    node->report(rules.check_tidb_foreign_key,
         "TiDB does not support FOREIGN KEY constraints.");
   }
 
@@ -631,9 +909,9 @@ static void check_index(const Key_spec *key, SqlCacheNode *node,
       }
 
       /* Fallback: query remote server for column type (ALTER ADD INDEX case) */
-      if (!found_local && remote && db && table_name) {
+      if (!found_local && have_meta(ctx, remote) && db && table_name) {
         RemoteColumnInfo col_info;
-        if (remote_column_info(remote, db, table_name, col_name, &col_info)) {
+        if (remote_column_info(ctx, remote, db, table_name, col_name, &col_info)) {
           if (is_blob_type_name(col_info.data_type.c_str())) {
             node->append_error(
                 "Index '%s' on BLOB/TEXT column '%s' must specify a prefix "
@@ -649,7 +927,7 @@ static void check_index(const Key_spec *key, SqlCacheNode *node,
      We compute column key bytes manually to avoid calling
      Create_field::max_display_width_in_bytes() which asserts charset != nullptr
      and would crash for non-string types (INT, DATE, etc.). */
-  if (opt_check_index_length > 0 && alter_info) {
+  if (rules.check_index_length > 0 && alter_info) {
     size_t total_bytes = 0;
     for (const Key_part_spec *key_part : key->columns) {
       const char *col_name = key_part->get_field_name();
@@ -704,9 +982,9 @@ static void check_index(const Key_spec *key, SqlCacheNode *node,
       }
 
       /* Fallback: query remote for ALTER ADD INDEX on existing columns */
-      if (!found && remote && db && table_name) {
+      if (!found && have_meta(ctx, remote) && db && table_name) {
         RemoteColumnInfo col_info;
-        if (remote_column_info(remote, db, table_name, col_name, &col_info)) {
+        if (remote_column_info(ctx, remote, db, table_name, col_name, &col_info)) {
           if (prefix_len > 0) {
             /* Assume utf8mb4 (4 bytes) for remote columns as worst case */
             col_bytes = prefix_len * 4;
@@ -717,28 +995,124 @@ static void check_index(const Key_spec *key, SqlCacheNode *node,
       }
 
       /* Check single column key length */
-      if (opt_check_index_column_max_bytes > 0 &&
-          col_bytes > opt_check_index_column_max_bytes) {
-        node->report(opt_check_index_length,
+      if (rules.check_index_column_max_bytes > 0 &&
+          col_bytes > rules.check_index_column_max_bytes) {
+        node->report(rules.check_index_length,
             "Index '%s' column '%s' key length %zu bytes exceeds max %lu.",
             key->name.str ? key->name.str : "(unnamed)",
-            col_name, col_bytes, opt_check_index_column_max_bytes);
+            col_name, col_bytes, rules.check_index_column_max_bytes);
       }
 
       total_bytes += col_bytes;
     }
 
     /* Check total index key length */
-    if (opt_check_index_total_max_bytes > 0 &&
-        total_bytes > opt_check_index_total_max_bytes) {
-      node->report(opt_check_index_length,
+    if (rules.check_index_total_max_bytes > 0 &&
+        total_bytes > rules.check_index_total_max_bytes) {
+      node->report(rules.check_index_length,
           "Index '%s' total key length %zu bytes exceeds max %lu.",
           key->name.str ? key->name.str : "(unnamed)",
-          total_bytes, opt_check_index_total_max_bytes);
+          total_bytes, rules.check_index_total_max_bytes);
     }
   }
 }
 
+/* ---- Redundant index check against the target (ALTER / CREATE INDEX) ---- */
+
+static std::string lower_name(const char *name) {
+  std::string s(name ? name : "");
+  for (auto &c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return s;
+}
+
+/** "(a, b(10))" of an index, for messages. */
+static std::string index_parts_text(const IndexInfo &index) {
+  std::string text = "(";
+  for (size_t i = 0; i < index.parts.size(); i++) {
+    if (i) text += ", ";
+    text += index.parts[i];
+  }
+  return text + ")";
+}
+
+/** parts of a are a strict left prefix of those of b. */
+static bool left_prefix(const IndexInfo &a, const IndexInfo &b) {
+  return a.parts.size() < b.parts.size() &&
+         std::equal(a.parts.begin(), a.parts.end(), b.parts.begin());
+}
+
+/**
+ * Compare the keys alter_info adds to db.table with the table's existing
+ * indexes (from the metadata cache, less those the statement drops) and
+ * with the keys added before them. An index is redundant when another
+ * has the same parts, or when its parts are a left prefix of another's,
+ * unless it is unique and the other is not; a new index also makes an
+ * existing non-unique one redundant that way. FULLTEXT and SPATIAL
+ * indexes only duplicate their own kind.
+ */
+static void check_redundant_indexes(SqlCacheNode *node, InceptionContext *ctx,
+                                    MYSQL *remote, const char *db,
+                                    const char *table_name,
+                                    const Alter_info *alter_info) {
+  const RulePlan &rules = ctx->rules;
+  if (rules.check_duplicate_index == 0 || !db || !table_name ||
+      !have_meta(ctx, remote))
+    return;
+  TableMetaPtr meta;
+  {
+    RuleScope scope(ctx, nullptr, RULE_METADATA);
+    meta = get_table_meta(ctx, remote, db, table_name);
+  }
+  if (!meta || !meta->exists) return;
+
+  std::vector<std::pair<std::string, IndexInfo>> others;
+  for (const auto &def : meta->index_defs) {
+    bool dropped = false;
+    for (const auto *drop : alter_info->drop_list) {
+      if (drop->type == Alter_drop::KEY &&
+          strcasecmp(drop->name, def.first.c_str()) == 0)
+        dropped = true;
+    }
+    if (!dropped) others.emplace_back(def.first, def.second);
+  }
+
+  for (const Key_spec *key : alter_info->key_list) {
+    if (key->type == KEYTYPE_FOREIGN || key->type == KEYTYPE_PRIMARY) continue;
+    const IndexInfo added = index_info(*key);
+    std::string name = key->name.str && key->name.length
+                           ? key->name.str
+                           : (added.parts.empty() ? "" : added.parts[0]);
+    for (const auto &other : others) {
+      const IndexInfo &o = other.second;
+      if (added.ordered != o.ordered) continue;
+      const bool same = added.parts == o.parts;
+      if (same && (!added.unique || o.unique)) {
+        node->report(rules.check_duplicate_index,
+            "Index '%s' %s duplicates index '%s' of '%s.%s'.", name.c_str(),
+            index_parts_text(added).c_str(), other.first.c_str(), db,
+            table_name);
+        break;
+      }
+      if (added.ordered && !added.unique && left_prefix(added, o)) {
+        node->report(rules.check_duplicate_index,
+            "Index '%s' %s is a left prefix of index '%s' %s of '%s.%s' and "
+            "is redundant.",
+            name.c_str(), index_parts_text(added).c_str(),
+            other.first.c_str(), index_parts_text(o).c_str(), db, table_name);
+        break;
+      }
+      if (added.ordered && !o.unique && (same || left_prefix(o, added))) {
+        node->report(rules.check_duplicate_index,
+            "Index '%s' %s makes index '%s' %s of '%s.%s' redundant.",
+            name.c_str(), index_parts_text(added).c_str(),
+            other.first.c_str(), index_parts_text(o).c_str(), db, table_name);
+        break;
+      }
+    }
+    others.emplace_back(lower_name(name.c_str()), added);
+  }
+}
+
 /* ---- Must-have columns check ---- */
 
 /** Map type name → enum_field_types. MYSQL_TYPE_NULL = unrecognized. */
@@ -830,26 +1204,14 @@ static bool has_keyword(const char *spec, size_t spec_len, const char *kw) {
 }
 
 /**
- * Required column definition parsed from the config string.
- *
- * Format: "name TYPE [UNSIGNED] [NOT NULL] [AUTO_INCREMENT] [COMMENT]; ..."
- * Example:
+ * Parse one required column definition of the config string (see
+ * RequiredColumn). Example:
  *   "id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT;
  *    create_time DATETIME NOT NULL COMMENT;
  *    update_time DATETIME NOT NULL COMMENT"
  */
-struct RequiredColumn {
-  char name[128];
-  enum_field_types sql_type;  /* MYSQL_TYPE_NULL = not specified */
-  bool need_unsigned;
-  bool need_not_null;
-  bool need_auto_increment;
-  bool need_comment;
-};
-
 static RequiredColumn parse_required_column(const char *spec, size_t len) {
-  RequiredColumn req{};
-  req.sql_type = MYSQL_TYPE_NULL;
+  RequiredColumn req;
 
   /* Trim */
   while (len > 0 && (*spec == ' ' || *spec == '\t')) { spec++; len--; }
@@ -859,9 +1221,7 @@ static RequiredColumn parse_required_column(const char *spec, size_t len) {
   /* First token = column name */
   size_t i = 0;
   while (i < len && spec[i] != ' ' && spec[i] != '\t') i++;
-  size_t name_len = i < sizeof(req.name) ? i : sizeof(req.name) - 1;
-  memcpy(req.name, spec, name_len);
-  req.name[name_len] = '\0';
+  req.name.assign(spec, i < 127 ? i : 127);
 
   /* Second token = type name (if present) */
   while (i < len && (spec[i] == ' ' || spec[i] == '\t')) i++;
@@ -884,18 +1244,8 @@ static RequiredColumn parse_required_column(const char *spec, size_t len) {
   return req;
 }
 
-/**
- * Check opt_must_have_columns against create_list.
- *
- * Format: column definitions separated by ';'.
- * Each definition: name TYPE [UNSIGNED] [NOT NULL] [AUTO_INCREMENT] [COMMENT]
- *
- * Every keyword present in the config becomes a requirement.
- * If a keyword is absent, that attribute is not checked.
- */
-static void check_must_have_columns(Alter_info *alter_info,
-                                    SqlCacheNode *node) {
-  const char *p = opt_must_have_columns;
+std::vector<RequiredColumn> parse_must_have_columns(const char *p) {
+  std::vector<RequiredColumn> columns;
   while (*p) {
     while (*p == ' ' || *p == '\t' || *p == '\n' || *p == ';') p++;
     if (*p == '\0') break;
@@ -907,48 +1257,58 @@ static void check_must_have_columns(Alter_info *alter_info,
     RequiredColumn req = parse_required_column(p, spec_len);
     p += spec_len;
 
-    if (req.name[0] == '\0') continue;
+    if (!req.name.empty()) columns.push_back(std::move(req));
+  }
+  return columns;
+}
+
+/** Check the session's must-have columns against create_list. */
+static void check_must_have_columns(Alter_info *alter_info,
+                                    SqlCacheNode *node,
+                                    const RulePlan &rules) {
+  for (const RequiredColumn &req : rules.must_have_columns) {
+    const char *name = req.name.c_str();
 
     /* Find the column in create_list */
     bool found = false;
     List_iterator<Create_field> it(alter_info->create_list);
     Create_field *field;
     while ((field = it++)) {
-      if (strcasecmp(field->field_name, req.name) == 0) {
+      if (strcasecmp(field->field_name, name) == 0) {
         found = true;
 
         /* Type check */
         if (req.sql_type != MYSQL_TYPE_NULL &&
             !type_compatible(field->sql_type, req.sql_type)) {
-          node->report(opt_check_must_have_columns,
+          node->report(rules.check_must_have_columns,
               "Required column '%s' must be %s, but found %s.",
-              req.name, type_display_name(req.sql_type),
+              name, type_display_name(req.sql_type),
               type_display_name(field->sql_type));
         }
 
         /* UNSIGNED check */
         if (req.need_unsigned && !(field->flags & UNSIGNED_FLAG)) {
-          node->report(opt_check_must_have_columns,
-              "Required column '%s' must be UNSIGNED.", req.name);
+          node->report(rules.check_must_have_columns,
+              "Required column '%s' must be UNSIGNED.", name);
         }
 
         /* NOT NULL check */
         if (req.need_not_null && field->is_nullable) {
-          node->report(opt_check_must_have_columns,
-              "Required column '%s' must be NOT NULL.", req.name);
+          node->report(rules.check_must_have_columns,
+              "Required column '%s' must be NOT NULL.", name);
         }
 
         /* AUTO_INCREMENT check */
         if (req.need_auto_increment &&
             !(field->auto_flags & Field::NEXT_NUMBER)) {
-          node->report(opt_check_must_have_columns,
-              "Required column '%s' must be AUTO_INCREMENT.", req.name);
+          node->report(rules.check_must_have_columns,
+              "Required column '%s' must be AUTO_INCREMENT.", name);
         }
 
         /* COMMENT check */
         if (req.need_comment && field->comment.length == 0) {
-          node->report(opt_check_must_have_columns,
-              "Required column '%s' must have a COMMENT.", req.name);
+          node->report(rules.check_must_have_columns,
+              "Required column '%s' must have a COMMENT.", name);
         }
 
         break;
@@ -958,7 +1318,7 @@ static void check_must_have_columns(Alter_info *alter_info,
     if (!found) {
       /* Build a human-readable description of what was required */
       char desc[512];
-      int pos = snprintf(desc, sizeof(desc), "%s", req.name);
+      int pos = snprintf(desc, sizeof(desc), "%s", name);
       if (req.sql_type != MYSQL_TYPE_NULL)
         pos += snprintf(desc + pos, sizeof(desc) - pos, " %s",
                         type_display_name(req.sql_type));
@@ -970,16 +1330,134 @@ static void check_must_have_columns(Alter_info *alter_info,
         pos += snprintf(desc + pos, sizeof(desc) - pos, " AUTO_INCREMENT");
       if (req.need_comment)
         pos += snprintf(desc + pos, sizeof(desc) - pos, " COMMENT");
-      node->report(opt_check_must_have_columns,
+      node->report(rules.check_must_have_columns,
           "Required column is missing: %s.", desc);
     }
   }
 }
 
+/* ---- Rule plan ---- */
+
+void compile_rule_plan(RulePlan *plan) {
+  *plan = RulePlan();
+  plan->check_primary_key = opt_check_primary_key;
+  plan->check_table_comment = opt_check_table_comment;
+  plan->check_column_comment = opt_check_column_comment;
+  plan->check_engine_innodb = opt_check_engine_innodb;
+  plan->check_dml_where = opt_check_dml_where;
+  plan->check_dml_limit = opt_check_dml_limit;
+  plan->check_insert_column = opt_check_insert_column;
+  plan->check_select_star = opt_check_select_star;
+  plan->check_nullable = opt_check_nullable;
+  plan->check_foreign_key = opt_check_foreign_key;
+  plan->check_blob_type = opt_check_blob_type;
+  plan->check_index_prefix = opt_check_index_prefix;
+  plan->check_enum_type = opt_check_enum_type;
+  plan->check_set_type = opt_check_set_type;
+  plan->check_bit_type = opt_check_bit_type;
+  plan->check_json_type = opt_check_json_type;
+  plan->check_json_blob_text_default = opt_check_json_blob_text_default;
+  plan->check_create_select = opt_check_create_select;
+  plan->check_identifier = opt_check_identifier;
+  plan->check_not_null_default = opt_check_not_null_default;
+  plan->check_duplicate_index = opt_check_duplicate_index;
+  plan->check_drop_database = opt_check_drop_database;
+  plan->check_drop_table = opt_check_drop_table;
+  plan->check_truncate_table = opt_check_truncate_table;
+  plan->check_delete = opt_check_delete;
+  plan->check_autoincrement = opt_check_autoincrement;
+  plan->check_partition = opt_check_partition;
+  plan->check_orderby_in_dml = opt_check_orderby_in_dml;
+  plan->check_orderby_rand = opt_check_orderby_rand;
+  plan->check_dml_full_scan = opt_check_dml_full_scan;
+  plan->check_dml_filesort = opt_check_dml_filesort;
+  plan->check_dml_binlog_size = opt_check_dml_binlog_size;
+  plan->check_autoincrement_init_value = opt_check_autoincrement_init_value;
+  plan->check_autoincrement_name = opt_check_autoincrement_name;
+  plan->check_timestamp_default = opt_check_timestamp_default;
+  plan->check_column_charset = opt_check_column_charset;
+  plan->check_column_default_value = opt_check_column_default_value;
+  plan->check_identifier_keyword = opt_check_identifier_keyword;
+  plan->check_merge_alter_table = opt_check_merge_alter_table;
+  plan->check_column_position_rebuild = opt_check_column_position_rebuild;
+  plan->check_varchar_shrink = opt_check_varchar_shrink;
+  plan->check_lossy_type_change = opt_check_lossy_type_change;
+  plan->check_decimal_change = opt_check_decimal_change;
+  plan->check_column_data = opt_check_column_data;
+  plan->check_tidb_merge_alter = opt_check_tidb_merge_alter;
+  plan->check_tidb_varchar_shrink = opt_check_tidb_varchar_shrink;
+  plan->check_tidb_decimal_change = opt_check_tidb_decimal_change;
+  plan->check_tidb_lossy_type_change = opt_check_tidb_lossy_type_change;
+  plan->check_tidb_foreign_key = opt_check_tidb_foreign_key;
+  plan->check_index_length = opt_check_index_length;
+  plan->check_insert_values_match = opt_check_insert_values_match;
+  plan->check_insert_duplicate_column = opt_check_insert_duplicate_column;
+  plan->check_column_exists = opt_check_column_exists;
+  plan->check_must_have_columns = opt_check_must_have_columns;
+  plan->check_max_indexes = opt_check_max_indexes;
+  plan->check_max_index_parts = opt_check_max_index_parts;
+  plan->check_max_update_rows = opt_check_max_update_rows;
+  plan->check_explain_min_rows = opt_check_explain_min_rows;
+  plan->check_max_dml_binlog_size = opt_check_max_dml_binlog_size;
+  plan->check_max_char_length = opt_check_max_char_length;
+  plan->check_max_primary_key_parts = opt_check_max_primary_key_parts;
+  plan->check_max_table_name_length = opt_check_max_table_name_length;
+  plan->check_max_column_name_length = opt_check_max_column_name_length;
+  plan->check_max_columns = opt_check_max_columns;
+  plan->check_index_column_max_bytes = opt_check_index_column_max_bytes;
+  plan->check_index_total_max_bytes = opt_check_index_total_max_bytes;
+  plan->check_in_count = opt_check_in_count;
+  set_support_charset(plan, opt_support_charset);
+
+  if (plan->check_must_have_columns > 0 && opt_must_have_columns)
+    plan->must_have_columns = parse_must_have_columns(opt_must_have_columns);
+
+  update_column_rules(plan);
+}
+
+void set_support_charset(RulePlan *plan, const char *list) {
+  plan->support_charset.clear();
+  plan->support_charsets.clear();
+  if (!list || list[0] == '\0') return;
+  plan->support_charset = list;
+  const char *p = list;
+  while (*p) {
+    const char *comma = strchr(p, ',');
+    size_t len = comma ? (size_t)(comma - p) : strlen(p);
+    plan->support_charsets.emplace_back(p, len);
+    p += len;
+    if (*p == ',') p++;
+  }
+}
+
+void update_column_rules(RulePlan *plan) {
+  plan->column_rules =
+      plan->check_max_column_name_length > 0 || plan->check_identifier > 0 ||
+      plan->check_column_comment > 0 || plan->check_nullable > 0 ||
+      plan->check_not_null_default > 0 ||
+      plan->check_json_blob_text_default > 0 || plan->check_blob_type > 0 ||
+      plan->check_enum_type > 0 || plan->check_set_type > 0 ||
+      plan->check_bit_type > 0 || plan->check_json_type > 0 ||
+      plan->check_max_char_length > 0 || plan->check_autoincrement > 0 ||
+      plan->check_autoincrement_name > 0 ||
+      plan->check_timestamp_default > 0 || plan->check_column_charset > 0 ||
+      plan->check_column_default_value > 0 ||
+      plan->check_identifier_keyword > 0;
+}
+
+/** True if csname is in the session's inception_support_charset list. */
+static bool charset_allowed(const RulePlan &rules, const char *csname) {
+  for (const std::string &cs : rules.support_charsets)
+    if (strcasecmp(cs.c_str(), csname) == 0) return true;
+  return false;
+}
+
 /* ---- CREATE TABLE ---- */
 
 static void audit_create_table(THD *thd, SqlCacheNode *node,
                                InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_CREATE_TABLE);
   LEX *lex = thd->lex;
   HA_CREATE_INFO *create_info = lex->create_info;
   Alter_info *alter_info = lex->alter_info;
@@ -997,7 +1475,8 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
               db, tbl->table_name);
         } else {
           MYSQL *remote = get_remote_conn(ctx);
-          if (remote && remote_table_exists(remote, db, tbl->table_name)) {
+          if (have_meta(ctx, remote) &&
+              remote_table_exists(ctx, remote, db, tbl->table_name)) {
             node->append_error(
                 "Table '%s.%s' already exists on remote server.",
                 db, tbl->table_name);
@@ -1008,7 +1487,7 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
   }
 
   /* 1. Must have PRIMARY KEY */
-  if (opt_check_primary_key > 0) {
+  if (rules.check_primary_key > 0) {
     bool has_pk = false;
     for (const Key_spec *key : alter_info->key_list) {
       if (key->type == KEYTYPE_PRIMARY) {
@@ -1017,55 +1496,39 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
       }
     }
     if (!has_pk) {
-      node->report(opt_check_primary_key, "Table must have a PRIMARY KEY.");
+      node->report(rules.check_primary_key, "Table must have a PRIMARY KEY.");
     }
   }
 
   /* 2. Must have table comment */
-  if (opt_check_table_comment > 0 && create_info->comment.length == 0) {
-    node->report(opt_check_table_comment, "Table must have a comment.");
+  if (rules.check_table_comment > 0 && create_info->comment.length == 0) {
+    node->report(rules.check_table_comment, "Table must have a comment.");
   }
 
   /* 3. Must use InnoDB */
-  if (opt_check_engine_innodb > 0) {
+  if (rules.check_engine_innodb > 0) {
     handlerton *engine = create_info->db_type;
     if (engine && engine != innodb_hton) {
-      node->report(opt_check_engine_innodb,
+      node->report(rules.check_engine_innodb,
           "Table engine must be InnoDB (found '%s').",
           ha_resolve_storage_engine_name(engine));
     }
   }
 
   /* 4. Charset whitelist */
-  if (opt_support_charset && opt_support_charset[0] != '\0') {
+  if (!rules.support_charsets.empty()) {
     const CHARSET_INFO *tbl_cs = create_info->default_table_charset;
-    if (tbl_cs) {
-      /* Check if table charset is in the allowed list (comma-separated) */
-      bool found = false;
-      const char *p = opt_support_charset;
-      while (*p) {
-        const char *comma = strchr(p, ',');
-        size_t len = comma ? (size_t)(comma - p) : strlen(p);
-        if (strncasecmp(p, tbl_cs->csname, len) == 0 &&
-            strlen(tbl_cs->csname) == len) {
-          found = true;
-          break;
-        }
-        p += len;
-        if (*p == ',') p++;
-      }
-      if (!found) {
-        node->append_error(
-            "Table charset '%s' is not in allowed list '%s'.",
-            tbl_cs->csname, opt_support_charset);
-      }
+    if (tbl_cs && !charset_allowed(rules, tbl_cs->csname)) {
+      node->append_error(
+          "Table charset '%s' is not in allowed list '%s'.",
+          tbl_cs->csname, rules.support_charset.c_str());
     }
   }
 
   /* 5. CREATE TABLE ... SELECT rejection */
-  if (opt_check_create_select > 0) {
+  if (rules.check_create_select > 0) {
     if (!lex->query_block->field_list_is_empty()) {
-      node->report(opt_check_create_select,
+      node->report(rules.check_create_select,
           "CREATE TABLE ... SELECT is not allowed.");
     }
   }
@@ -1074,24 +1537,24 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
   {
     TABLE_LIST *tbl = lex->query_tables;
     if (tbl && tbl->table_name) {
-      if (opt_check_max_table_name_length > 0 &&
-          strlen(tbl->table_name) > opt_check_max_table_name_length) {
+      if (rules.check_max_table_name_length > 0 &&
+          strlen(tbl->table_name) > rules.check_max_table_name_length) {
         node->append_warning(
             "Table name '%s' length %zu exceeds max %lu.",
             tbl->table_name, strlen(tbl->table_name),
-            opt_check_max_table_name_length);
+            rules.check_max_table_name_length);
       }
       /* 7. Table name identifier format */
-      if (opt_check_identifier > 0 && !is_valid_identifier(tbl->table_name)) {
-        node->report(opt_check_identifier,
+      if (rules.check_identifier > 0 && !is_valid_identifier(tbl->table_name)) {
+        node->report(rules.check_identifier,
             "Table name '%s' should be lowercase letters, digits and "
             "underscores.",
             tbl->table_name);
       }
       /* Table name must not be a MySQL reserved keyword */
-      if (opt_check_identifier_keyword > 0) {
+      if (rules.check_identifier_keyword > 0) {
         if (is_keyword(tbl->table_name, strlen(tbl->table_name))) {
-          node->report(opt_check_identifier_keyword,
+          node->report(rules.check_identifier_keyword,
               "Table name '%s' is a MySQL reserved keyword.",
               tbl->table_name);
         }
@@ -1100,10 +1563,10 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
   }
 
   /* 8. Column count limit */
-  if (opt_check_max_columns > 0 &&
-      alter_info->create_list.elements > opt_check_max_columns) {
+  if (rules.check_max_columns > 0 &&
+      alter_info->create_list.elements > rules.check_max_columns) {
     node->append_warning("Table has %u columns, exceeds max %lu.",
-                         alter_info->create_list.elements, opt_check_max_columns);
+                         alter_info->create_list.elements, rules.check_max_columns);
   }
 
   /* 9-14. Column checks */
@@ -1118,9 +1581,9 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
   /* 15-18. Index checks */
   {
     /* Total index count limit */
-    if (opt_check_max_indexes > 0 && alter_info->key_list.size() > opt_check_max_indexes) {
+    if (rules.check_max_indexes > 0 && alter_info->key_list.size() > rules.check_max_indexes) {
       node->append_warning("Table has %zu indexes, exceeds max %lu.",
-                           alter_info->key_list.size(), opt_check_max_indexes);
+                           alter_info->key_list.size(), rules.check_max_indexes);
     }
 
     for (const Key_spec *key : alter_info->key_list) {
@@ -1128,19 +1591,19 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
     }
 
     /* Primary key column count limit */
-    if (opt_check_max_primary_key_parts > 0) {
+    if (rules.check_max_primary_key_parts > 0) {
       for (const Key_spec *key : alter_info->key_list) {
         if (key->type == KEYTYPE_PRIMARY &&
-            key->columns.size() > opt_check_max_primary_key_parts) {
+            key->columns.size() > rules.check_max_primary_key_parts) {
           node->append_warning(
               "PRIMARY KEY has %zu columns, exceeds max %lu.",
-              key->columns.size(), opt_check_max_primary_key_parts);
+              key->columns.size(), rules.check_max_primary_key_parts);
         }
       }
     }
 
     /* Duplicate/redundant index detection */
-    if (opt_check_duplicate_index > 0) {
+    if (rules.check_duplicate_index > 0) {
       const auto &keys = alter_info->key_list;
       for (size_t i = 0; i < keys.size(); i++) {
         const Key_spec *a = keys[i];
@@ -1169,7 +1632,7 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
                 a->columns.size() <= b->columns.size() ? a : b;
             const Key_spec *longer =
                 a->columns.size() <= b->columns.size() ? b : a;
-            node->report(opt_check_duplicate_index,
+            node->report(rules.check_duplicate_index,
                 "Index '%s' is a prefix of '%s' and may be redundant.",
                 shorter->name.str ? shorter->name.str : "(unnamed)",
                 longer->name.str ? longer->name.str : "(unnamed)");
@@ -1180,21 +1643,21 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
   }
 
   /* 19. Partition check */
-  if (opt_check_partition > 0 && lex->part_info != nullptr) {
-    node->report(opt_check_partition,
+  if (rules.check_partition > 0 && lex->part_info != nullptr) {
+    node->report(rules.check_partition,
         "Partitioned tables are not recommended.");
   }
 
   /* 20. Must-have columns check */
-  if (opt_check_must_have_columns > 0 &&
-      opt_must_have_columns && opt_must_have_columns[0] != '\0') {
-    check_must_have_columns(alter_info, node);
+  if (!rules.must_have_columns.empty()) {
+    RuleScope must_have(ctx, node, RULE_MUST_HAVE_COLUMNS);
+    check_must_have_columns(alter_info, node, rules);
   }
 
   /* 21. AUTO_INCREMENT init value must be 1 */
-  if (opt_check_autoincrement_init_value > 0 &&
+  if (rules.check_autoincrement_init_value > 0 &&
       create_info->auto_increment_value > 1) {
-    node->report(opt_check_autoincrement_init_value,
+    node->report(rules.check_autoincrement_init_value,
         "AUTO_INCREMENT initial value is %llu, should be 1.",
         create_info->auto_increment_value);
   }
@@ -1226,6 +1689,8 @@ static void audit_create_table(THD *thd, SqlCacheNode *node,
 
 static void audit_create_db(THD *thd, SqlCacheNode *node,
                             InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_CREATE_DATABASE);
   LEX *lex = thd->lex;
   const char *db_name = lex->name.str;
 
@@ -1234,52 +1699,37 @@ static void audit_create_db(THD *thd, SqlCacheNode *node,
   /* Remote existence check: database already exists? */
   if (db_name) {
     MYSQL *remote = get_remote_conn(ctx);
-    if (remote && remote_db_exists(remote, db_name)) {
+    if (have_meta(ctx, remote) && remote_db_exists(ctx, remote, db_name)) {
       node->append_error("Database '%s' already exists on remote server.",
                          db_name);
     }
   }
 
   /* Database name identifier format */
-  if (opt_check_identifier > 0 && db_name && !is_valid_identifier(db_name)) {
-    node->report(opt_check_identifier,
+  if (rules.check_identifier > 0 && db_name && !is_valid_identifier(db_name)) {
+    node->report(rules.check_identifier,
         "Database name '%s' should be lowercase letters, digits and "
         "underscores.",
         db_name);
   }
 
   /* Database name length */
-  if (opt_check_max_table_name_length > 0 && db_name &&
-      strlen(db_name) > opt_check_max_table_name_length) {
+  if (rules.check_max_table_name_length > 0 && db_name &&
+      strlen(db_name) > rules.check_max_table_name_length) {
     node->append_warning("Database name '%s' length %zu exceeds max %lu.",
                          db_name, strlen(db_name),
-                         opt_check_max_table_name_length);
+                         rules.check_max_table_name_length);
   }
 
   /* Charset whitelist */
-  if (opt_support_charset && opt_support_charset[0] != '\0') {
+  if (!rules.support_charsets.empty()) {
     HA_CREATE_INFO *create_info = lex->create_info;
     const CHARSET_INFO *db_cs =
         create_info ? create_info->default_table_charset : nullptr;
-    if (db_cs) {
-      bool found = false;
-      const char *p = opt_support_charset;
-      while (*p) {
-        const char *comma = strchr(p, ',');
-        size_t len = comma ? (size_t)(comma - p) : strlen(p);
-        if (strncasecmp(p, db_cs->csname, len) == 0 &&
-            strlen(db_cs->csname) == len) {
-          found = true;
-          break;
-        }
-        p += len;
-        if (*p == ',') p++;
-      }
-      if (!found) {
-        node->append_error(
-            "Database charset '%s' is not in allowed list '%s'.",
-            db_cs->csname, opt_support_charset);
-      }
+    if (db_cs && !charset_allowed(rules, db_cs->csname)) {
+      node->append_error(
+          "Database charset '%s' is not in allowed list '%s'.",
+          db_cs->csname, rules.support_charset.c_str());
     }
   }
 }
@@ -1288,11 +1738,13 @@ static void audit_create_db(THD *thd, SqlCacheNode *node,
 
 static void audit_drop_db(THD *thd, SqlCacheNode *node,
                           InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_DROP_DATABASE);
   const char *db_name = thd->lex->name.str;
   node->db_name = db_name ? db_name : "";
 
-  if (opt_check_drop_database > 0) {
-    node->report(opt_check_drop_database,
+  if (rules.check_drop_database > 0) {
+    node->report(rules.check_drop_database,
         "DROP DATABASE will permanently remove database '%s'.",
         db_name ? db_name : "(unknown)");
   }
@@ -1300,7 +1752,7 @@ static void audit_drop_db(THD *thd, SqlCacheNode *node,
   /* Remote existence check */
   if (db_name) {
     MYSQL *remote = get_remote_conn(ctx);
-    if (remote && !remote_db_exists(remote, db_name)) {
+    if (have_meta(ctx, remote) && !remote_db_exists(ctx, remote, db_name)) {
       node->append_warning("Database '%s' does not exist on remote server.",
                            db_name);
     }
@@ -1357,83 +1809,241 @@ static std::string resolve_alter_sub_type(ulonglong flags) {
   return result.empty() ? "OTHER" : result;
 }
 
+/* ---- ALTER TABLE algorithm prediction ---- */
+
+/* Algorithm levels, worst wins: 0=INSTANT, 1=INPLACE, 2=COPY */
+enum { ALG_INSTANT = 0, ALG_INPLACE = 1, ALG_COPY = 2 };
+
+/* Operations InnoDB runs INSTANT from some release on, INPLACE before */
+enum InstantOp {
+  INSTANT_ADD_COLUMN_LAST,      /* ADD COLUMN at the end of the row */
+  INSTANT_ADD_COLUMN_ANYWHERE,  /* ADD COLUMN ... FIRST / AFTER */
+  INSTANT_DROP_COLUMN,
+  INSTANT_RENAME_COLUMN,
+  INSTANT_COLUMN_METADATA,      /* default, comment, ENUM / SET extension */
+  INSTANT_TABLE_METADATA,       /* RENAME TO, table COMMENT and options */
+  INSTANT_COLUMN_VISIBILITY
+};
+
+/* First MySQL release (major * 10000 + minor * 100 + patch) of each */
+static const struct {
+  InstantOp op;
+  uint since;
+} instant_since[] = {
+    {INSTANT_ADD_COLUMN_LAST, 80012},   {INSTANT_ADD_COLUMN_ANYWHERE, 80029},
+    {INSTANT_DROP_COLUMN, 80029},       {INSTANT_RENAME_COLUMN, 80028},
+    {INSTANT_COLUMN_METADATA, 80000},   {INSTANT_TABLE_METADATA, 80000},
+    {INSTANT_COLUMN_VISIBILITY, 80023},
+};
+
 /**
- * Predict the DDL algorithm MySQL will use for this ALTER TABLE.
- * Returns "INSTANT", "INPLACE", or "COPY".
- * When multiple operations are combined, returns the worst (most expensive).
+ * The release the rules of instant_since[] are looked up with. TiDB
+ * changes metadata online wherever MySQL does so at its newest.
  */
-static std::string predict_alter_algorithm(LEX *lex, InceptionContext *ctx) {
-  Alter_info *alter_info = lex->alter_info;
-  ulonglong flags = alter_info->flags;
-  bool is_80 = (ctx->db_version_major >= 8);
+static uint rule_version(const InceptionContext *ctx) {
+  if (ctx->db_type == DbType::TIDB) return ~0u;
+  return ctx->db_version_major * 10000 + ctx->db_version_minor * 100 +
+         ctx->db_version_patch;
+}
+
+/** ALG_INSTANT if the target runs op INSTANT, else ALG_INPLACE. */
+static int instant_level(uint version, InstantOp op) {
+  for (const auto &rule : instant_since)
+    if (rule.op == op) return version >= rule.since ? ALG_INSTANT : ALG_INPLACE;
+  return ALG_INPLACE;
+}
+
+/* Types whose RemoteColumnInfo tells definitions apart; a temporal or
+   floating-point type of the same name may still differ in precision */
+static bool comparable_type(const std::string &t) {
+  static const char *const types[] = {
+      "tinyint", "smallint", "mediumint", "int", "bigint", "decimal",
+      "bit", "char", "varchar", "binary", "varbinary", "tinytext", "text",
+      "mediumtext", "longtext", "tinyblob", "blob", "mediumblob",
+      "longblob", "enum", "set"};
+  for (const char *name : types)
+    if (t == name) return true;
+  return false;
+}
 
-  /* Algorithm levels: 0=INSTANT, 1=INPLACE, 2=COPY */
-  int worst = 0;
+/** Bytes per character of the named charset, 4 when it is unknown. */
+static uint charset_mbmaxlen(const std::string &name) {
+  if (name.empty()) return 4;
+  const CHARSET_INFO *cs =
+      get_charset_by_csname(name.c_str(), MY_CS_PRIMARY, MYF(0));
+  return cs ? cs->mbmaxlen : 4;
+}
 
-  auto raise = [&](int level) { if (level > worst) worst = level; };
+/** Bytes an ENUM or SET of n members stores per row. */
+static size_t member_storage(const std::string &type, size_t n) {
+  if (type == "enum") return n <= 255 ? 1 : 2;
+  const size_t bytes = (n + 7) / 8;
+  return bytes > 4 ? 8 : bytes;
+}
 
-  /* ADD COLUMN: INSTANT on 8.0+, INPLACE on 5.7 */
-  if (flags & Alter_info::ALTER_ADD_COLUMN)
-    raise(is_80 ? 0 : 1);
+/**
+ * Algorithm of one MODIFY / CHANGE COLUMN against the column's current
+ * definition old: metadata only when the type stays (a rename is INSTANT
+ * from 8.0.28), or when ENUM / SET members are only appended within the
+ * same storage size; INPLACE for a VARCHAR widened within the same
+ * length-byte class or a nullability change; COPY otherwise.
+ */
+static int change_column_level(const Create_field &field,
+                               const RemoteColumnInfo *old, uint version) {
+  if (!old || field.gcol_info) return ALG_COPY;
+  const RemoteColumnInfo now = column_from_field(field);
+  if (!comparable_type(now.data_type) || now.data_type != old->data_type ||
+      now.is_unsigned != old->is_unsigned)
+    return ALG_COPY;
+  if (!now.charset.empty() && !old->charset.empty() &&
+      now.charset != old->charset)
+    return ALG_COPY;
+
+  int level;
+  if (now.char_max_length == old->char_max_length &&
+      now.numeric_precision == old->numeric_precision &&
+      now.numeric_scale == old->numeric_scale && now.values == old->values) {
+    level = my_strcasecmp(system_charset_info, field.change,
+                          field.field_name)
+                ? instant_level(version, INSTANT_RENAME_COLUMN)
+                : instant_level(version, INSTANT_COLUMN_METADATA);
+  } else if (now.data_type == "enum" || now.data_type == "set") {
+    const bool appended =
+        now.values.size() >= old->values.size() &&
+        std::equal(old->values.begin(), old->values.end(),
+                   now.values.begin()) &&
+        member_storage(now.data_type, now.values.size()) ==
+            member_storage(old->data_type, old->values.size());
+    if (!appended) return ALG_COPY;
+    level = instant_level(version, INSTANT_COLUMN_METADATA);
+  } else if (now.data_type == "varchar" || now.data_type == "varbinary") {
+    if (now.char_max_length < old->char_max_length) return ALG_COPY;
+    const uint mbmaxlen =
+        now.data_type == "varbinary"
+            ? 1
+            : charset_mbmaxlen(now.charset.empty() ? old->charset
+                                                   : now.charset);
+    /* Up to 255 bytes the row stores the length in one byte, else two */
+    if ((old->char_max_length * mbmaxlen <= 255) !=
+        (now.char_max_length * mbmaxlen <= 255))
+      return ALG_COPY;
+    level = ALG_INPLACE;
+  } else {
+    return ALG_COPY;
+  }
+  /* NULL <-> NOT NULL and moving the column rebuild the table */
+  if (now.nullable != old->nullable || field.after) level = ALG_INPLACE;
+  return level;
+}
 
-  /* DROP COLUMN: INPLACE */
-  if (flags & Alter_info::ALTER_DROP_COLUMN)
-    raise(1);
+/**
+ * Predict the DDL algorithm the target will use for this ALTER TABLE:
+ * "INSTANT", "INPLACE" or "COPY", the worst of its operations. Column
+ * changes are judged against the table's current definitions (metadata
+ * cache); what InnoDB runs INSTANT depends on the release (instant_since[])
+ * and never applies to ADD / DROP COLUMN of a ROW_FORMAT=COMPRESSED table.
+ * Without the current definition a MODIFY / CHANGE is taken as COPY.
+ * *positioned tells whether the ALTER would be INSTANT with its added
+ * columns at the end of the row instead of FIRST / AFTER.
+ */
+static std::string predict_alter_algorithm(LEX *lex, InceptionContext *ctx,
+                                           MYSQL *remote, const char *db,
+                                           const char *table_name,
+                                           bool in_batch, bool *positioned) {
+  Alter_info *alter_info = lex->alter_info;
+  ulonglong flags = alter_info->flags;
+  const uint version = rule_version(ctx);
 
-  /* MODIFY/CHANGE COLUMN: default COPY (type change);
-     purely changing default/comment/nullable could be INSTANT/INPLACE
-     but we can't always tell statically, so conservative COPY */
-  if (flags & Alter_info::ALTER_CHANGE_COLUMN)
-    raise(2);
+  TableMetaPtr meta;
+  if (!in_batch && have_meta(ctx, remote) && db && table_name) {
+    RuleScope scope(ctx, nullptr, RULE_METADATA);
+    meta = get_table_meta(ctx, remote, db, table_name);
+    if (meta && !meta->exists) meta.reset();
+  }
+  const bool compressed = meta && meta->row_format == "compressed";
 
-  /* CHANGE DEFAULT only: INSTANT */
-  if (flags & Alter_info::ALTER_CHANGE_COLUMN_DEFAULT)
-    raise(0);
+  int worst = ALG_INSTANT;
+  int worst_at_end = ALG_INSTANT;  /* with every ADD COLUMN at the end */
+  auto raise = [&](int level) {
+    if (level > worst) worst = level;
+    if (level > worst_at_end) worst_at_end = level;
+  };
 
-  /* COLUMN ORDER (FIRST/AFTER): INPLACE */
-  if (flags & Alter_info::ALTER_COLUMN_ORDER)
-    raise(1);
+  /* ADD / MODIFY / CHANGE COLUMN, one definition at a time */
+  bool column_ops = false;
+  List_iterator<Create_field> it(alter_info->create_list);
+  Create_field *field;
+  while ((field = it++)) {
+    column_ops = true;
+    if (field->change) {
+      raise(change_column_level(
+          *field, meta ? meta->find_column(field->change) : nullptr,
+          version));
+    } else if (field->gcol_info && field->stored_in_db) {
+      raise(ALG_COPY);  /* a STORED generated column is computed by a copy */
+    } else if (compressed || (field->flags & AUTO_INCREMENT_FLAG)) {
+      raise(ALG_INPLACE);
+    } else {
+      const int at_end = instant_level(version, INSTANT_ADD_COLUMN_LAST);
+      worst = std::max(worst, field->after ? instant_level(
+                                                 version,
+                                                 INSTANT_ADD_COLUMN_ANYWHERE)
+                                           : at_end);
+      worst_at_end = std::max(worst_at_end, at_end);
+    }
+  }
 
-  /* ADD INDEX: INPLACE */
-  if (flags & Alter_info::ALTER_ADD_INDEX)
-    raise(1);
+  for (const auto *drop : alter_info->drop_list) {
+    if (drop->type != Alter_drop::COLUMN) continue;
+    column_ops = true;
+    raise(compressed ? ALG_INPLACE
+                     : instant_level(version, INSTANT_DROP_COLUMN));
+  }
+
+  for (const auto *col : alter_info->alter_list) {
+    if (col->change_type() != Alter_column::Type::RENAME_COLUMN) continue;
+    column_ops = true;
+    raise(instant_level(version, INSTANT_RENAME_COLUMN));
+  }
 
-  /* DROP INDEX: INPLACE */
-  if (flags & Alter_info::ALTER_DROP_INDEX)
-    raise(1);
+  /* A column change not seen above: conservative COPY */
+  if ((flags & Alter_info::ALTER_CHANGE_COLUMN) && !column_ops)
+    raise(ALG_COPY);
 
-  /* RENAME INDEX: INPLACE */
-  if (flags & Alter_info::ALTER_RENAME_INDEX)
-    raise(1);
+  /* SET / DROP DEFAULT */
+  if (flags & Alter_info::ALTER_CHANGE_COLUMN_DEFAULT)
+    raise(instant_level(version, INSTANT_COLUMN_METADATA));
 
-  /* INDEX VISIBILITY: INPLACE */
-  if (flags & Alter_info::ALTER_INDEX_VISIBILITY)
-    raise(1);
+  /* ADD / DROP / RENAME INDEX, INDEX VISIBILITY: INPLACE */
+  if (flags & (Alter_info::ALTER_ADD_INDEX | Alter_info::ALTER_DROP_INDEX |
+               Alter_info::ALTER_RENAME_INDEX |
+               Alter_info::ALTER_INDEX_VISIBILITY))
+    raise(ALG_INPLACE);
 
-  /* RENAME TABLE: INSTANT */
+  /* RENAME TABLE */
   if (flags & Alter_info::ALTER_RENAME)
-    raise(0);
+    raise(instant_level(version, INSTANT_TABLE_METADATA));
 
   /* ORDER BY: COPY */
   if (flags & Alter_info::ALTER_ORDER)
-    raise(2);
+    raise(ALG_COPY);
 
   /* OPTIONS: depends on what changed */
   if (flags & Alter_info::ALTER_OPTIONS) {
     HA_CREATE_INFO *ci = lex->create_info;
     if (ci && (ci->used_fields & HA_CREATE_USED_ENGINE))
-      raise(2);  /* ENGINE change → COPY */
+      raise(ALG_COPY);  /* ENGINE change → COPY */
     else
-      raise(0);  /* COMMENT/CHARSET only → INSTANT */
+      raise(instant_level(version, INSTANT_TABLE_METADATA));
   }
 
   /* KEYS ON/OFF: INPLACE */
   if (flags & Alter_info::ALTER_KEYS_ONOFF)
-    raise(1);
+    raise(ALG_INPLACE);
 
   /* FORCE (rebuild): COPY */
   if (flags & Alter_info::ALTER_RECREATE)
-    raise(2);
+    raise(ALG_COPY);
 
   /* Partition operations: COPY */
   if (flags & (Alter_info::ALTER_ADD_PARTITION |
@@ -1443,26 +2053,271 @@ static std::string predict_alter_algorithm(LEX *lex, InceptionContext *ctx) {
                Alter_info::ALTER_EXCHANGE_PARTITION |
                Alter_info::ALTER_TRUNCATE_PARTITION |
                Alter_info::ALTER_REMOVE_PARTITIONING))
-    raise(2);
+    raise(ALG_COPY);
 
   /* DISCARD/IMPORT TABLESPACE: INPLACE */
   if (flags & (Alter_info::ALTER_DISCARD_TABLESPACE |
                Alter_info::ALTER_IMPORT_TABLESPACE))
-    raise(1);
+    raise(ALG_INPLACE);
 
-  /* COLUMN VISIBILITY: INSTANT */
+  /* COLUMN VISIBILITY */
   if (flags & Alter_info::ALTER_COLUMN_VISIBILITY)
-    raise(0);
+    raise(instant_level(version, INSTANT_COLUMN_VISIBILITY));
+
+  *positioned = worst != ALG_INSTANT && worst_at_end == ALG_INSTANT;
 
   switch (worst) {
-    case 0:  return "INSTANT";
-    case 1:  return "INPLACE";
-    default: return "COPY";
+    case ALG_INSTANT: return "INSTANT";
+    case ALG_INPLACE: return "INPLACE";
+    default:          return "COPY";
   }
 }
 
+/**
+ * Whether an ALTER only rebuilds the table, keeping its definition: FORCE,
+ * ENGINE=InnoDB or both, without ALGORITHM or LOCK.
+ */
+static bool rebuild_only(const Alter_info *alter_info,
+                         const HA_CREATE_INFO *create_info) {
+  const ulonglong rebuild =
+      Alter_info::ALTER_RECREATE | Alter_info::ALTER_OPTIONS;
+  if (!(alter_info->flags & rebuild) || (alter_info->flags & ~rebuild) ||
+      alter_info->requested_algorithm !=
+          Alter_info::ALTER_TABLE_ALGORITHM_DEFAULT ||
+      alter_info->requested_lock != Alter_info::ALTER_TABLE_LOCK_DEFAULT)
+    return false;
+  if (!(alter_info->flags & Alter_info::ALTER_OPTIONS)) return true;
+  return create_info && create_info->used_fields == HA_CREATE_USED_ENGINE &&
+         create_info->db_type == innodb_hton;
+}
+
+/**
+ * Choose how an ALTER TABLE runs, estimate how long it takes and whether
+ * writes wait for it. With inception_exec_partition_rebuild, an ALTER that
+ * only rebuilds a table of two or more partitions runs one partition at a
+ * time (PARTITION). Otherwise a COPY ALTER goes through the online schema
+ * change (OSC) engine when inception_osc_on is set, the engine can run it
+ * and the table is at least inception_osc_min_table_size MB or
+ * inception_osc_min_table_rows rows; everything else runs natively. The
+ * estimate assumes one pass over data and indexes at the target's rebuild
+ * speed for the algorithm (cache_rebuild_speed(); OSC adds --sleep between
+ * chunks, PARTITION between partitions). Writes wait for a native COPY, an
+ * explicit LOCK=SHARED or EXCLUSIVE, and a FULLTEXT or SPATIAL index, which
+ * InnoDB builds under a shared lock; TiDB runs all DDL online. A native
+ * COPY of a table that large in one statement is warned about.
+ */
+static void plan_alter_execution(SqlCacheNode *node, InceptionContext *ctx,
+                                 const Alter_info *alter_info,
+                                 const HA_CREATE_INFO *create_info,
+                                 MYSQL *remote, const char *db,
+                                 const char *table_name, bool in_batch) {
+  const int64_t MB = 1024 * 1024;
+  int64_t rows = -1, bytes = -1;
+  if (!in_batch && have_meta(ctx, remote) && db && table_name) {
+    RuleScope scope(ctx, nullptr, RULE_METADATA);
+    TableMetaPtr meta = get_table_meta(ctx, remote, db, table_name);
+    if (meta && meta->exists) {
+      rows = meta->table_rows;
+      bytes = meta->table_bytes;
+    }
+  }
+  const bool is_copy = node->ddl_algorithm == "COPY";
+  const bool large =
+      (bytes >= 0 &&
+       bytes >= static_cast<int64_t>(opt_osc_min_table_size) * MB) ||
+      (rows >= 0 && rows >= static_cast<int64_t>(opt_osc_min_table_rows));
+  size_t partitions = 0;
+  if (opt_exec_partition_rebuild && ctx->db_type != DbType::TIDB &&
+      !in_batch && have_meta(ctx, remote) && db && table_name &&
+      rebuild_only(alter_info, create_info)) {
+    RuleScope scope(ctx, nullptr, RULE_METADATA);
+    MYSQL *reader = get_audit_conn(ctx, remote);
+    QuerySlot slot(ctx, reader);
+    std::vector<std::string> names;
+    ctx->remote_queries++;
+    status_add(STATUS_REMOTE_QUERIES);
+    if (!slot.killed() && !list_partitions(reader, db, table_name, &names))
+      partitions = names.size();
+  }
+  const bool by_partition = partitions >= 2;
+  const bool osc =
+      !by_partition && opt_osc_on && is_copy && node->osc_capable && large;
+  node->exec_strategy = by_partition ? "PARTITION" : osc ? "OSC" : "NATIVE";
+  node->table_bytes = bytes;
+
+  bool locks = !osc && (is_copy || alter_info->requested_algorithm ==
+                                       Alter_info::ALTER_TABLE_ALGORITHM_COPY);
+  if (alter_info->requested_lock == Alter_info::ALTER_TABLE_LOCK_SHARED ||
+      alter_info->requested_lock == Alter_info::ALTER_TABLE_LOCK_EXCLUSIVE)
+    locks = true;
+  for (const Key_spec *key : alter_info->key_list)
+    if (key->type == KEYTYPE_FULLTEXT || key->type == KEYTYPE_SPATIAL)
+      locks = true;
+  node->locks_writes = locks && ctx->db_type != DbType::TIDB ? "YES" : "NO";
+
+  /* --enable-online-alter: the ALTER leaves ALGORITHM and LOCK to us */
+  node->online_clause =
+      ctx->db_type != DbType::TIDB && !osc &&
+      (node->ddl_algorithm == "INSTANT" || node->ddl_algorithm == "INPLACE") &&
+      alter_info->requested_algorithm ==
+          Alter_info::ALTER_TABLE_ALGORITHM_DEFAULT &&
+      alter_info->requested_lock == Alter_info::ALTER_TABLE_LOCK_DEFAULT &&
+      !(alter_info->flags &
+        (Alter_info::ALTER_ADD_PARTITION | Alter_info::ALTER_DROP_PARTITION |
+         Alter_info::ALTER_COALESCE_PARTITION |
+         Alter_info::ALTER_REORGANIZE_PARTITION |
+         Alter_info::ALTER_EXCHANGE_PARTITION |
+         Alter_info::ALTER_TRUNCATE_PARTITION |
+         Alter_info::ALTER_REMOVE_PARTITIONING |
+         Alter_info::ALTER_DISCARD_TABLESPACE |
+         Alter_info::ALTER_IMPORT_TABLESPACE));
+
+  if (node->ddl_algorithm == "INSTANT") {
+    node->estimated_time = "0";
+    return;
+  }
+  if (bytes < 0) return;  /* unknown size: no estimate */
+  double secs = static_cast<double>(bytes) /
+                (cache_rebuild_speed(cache_target(ctx), node->ddl_algorithm) *
+                 MB);
+  if (osc && rows > 0 && ctx->sleep_ms > 0) {
+    int64_t chunks = (rows + static_cast<int64_t>(opt_osc_chunk_size) - 1) /
+                     static_cast<int64_t>(opt_osc_chunk_size);
+    secs += static_cast<double>(chunks) * ctx->sleep_ms / 1000.0;
+  }
+  if (by_partition)
+    secs += static_cast<double>(partitions - 1) * ctx->sleep_ms / 1000.0;
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%.0f", secs);
+  node->estimated_time = buf;
+
+  if (is_copy && !osc && !by_partition && large) {
+    node->append_warning(
+        "ALTER TABLE rebuilds %s.%s (%lld MB, ~%lld rows) with "
+        "ALGORITHM=COPY, blocking writes for about %s s; consider "
+        "inception_osc_on.",
+        db, table_name, static_cast<long long>(bytes / MB),
+        static_cast<long long>(rows), buf);
+  }
+}
+
+/** ALTER algorithm rank for merging predictions: INSTANT < INPLACE < COPY. */
+static int algorithm_rank(const std::string &algorithm) {
+  if (algorithm == "COPY") return 2;
+  if (algorithm == "INPLACE") return 1;
+  return 0;
+}
+
+/**
+ * --enable-merge-alter: fold this ALTER into the run of adjacent ALTERs on
+ * the same table right before it, when appending its clauses to the run's
+ * first ALTER does the same as running them one after another: no clause
+ * that must stand alone (RENAME, ORDER BY, partitioning, tablespaces), no
+ * explicit ALGORITHM/LOCK, and no column or index name touched by an
+ * earlier ALTER of the run. The first ALTER then predicts the combined
+ * algorithm and strategy.
+ *
+ * @return true if node was folded into the run.
+ */
+static bool fold_into_previous_alter(LEX *lex, SqlCacheNode *node,
+                                     InceptionContext *ctx,
+                                     const std::string &key) {
+  InceptionContext::AlterGroup &group = ctx->alter_group;
+  const size_t index = ctx->cache_nodes.size() - 1;
+  Alter_info *alter_info = lex->alter_info;
+
+  std::set<std::string> columns, indexes;
+  List_iterator<Create_field> it(alter_info->create_list);
+  Create_field *field;
+  while ((field = it++)) {
+    columns.insert(lower_name(field->field_name));
+    if (field->change) columns.insert(lower_name(field->change));
+  }
+  for (const auto *drop : alter_info->drop_list) {
+    if (drop->type == Alter_drop::COLUMN)
+      columns.insert(lower_name(drop->name));
+    else
+      indexes.insert(lower_name(drop->name));
+  }
+  for (const auto *col : alter_info->alter_list) {
+    columns.insert(lower_name(col->name));
+    if (col->m_new_name) columns.insert(lower_name(col->m_new_name));
+  }
+  for (const Key_spec *k : alter_info->key_list)
+    if (k->name.str && k->name.length > 0) indexes.insert(lower_name(k->name.str));
+  for (const auto *rk : alter_info->alter_rename_key_list) {
+    indexes.insert(lower_name(rk->old_name));
+    indexes.insert(lower_name(rk->new_name));
+  }
+  for (const auto *iv : alter_info->alter_index_visibility_list)
+    indexes.insert(lower_name(iv->name()));
+  for (const auto *ce : alter_info->alter_constraint_enforcement_list)
+    indexes.insert(lower_name(ce->name));
+
+  const ulonglong standalone =
+      Alter_info::ALTER_RENAME | Alter_info::ALTER_ORDER |
+      Alter_info::ALTER_ADD_PARTITION | Alter_info::ALTER_DROP_PARTITION |
+      Alter_info::ALTER_COALESCE_PARTITION |
+      Alter_info::ALTER_REORGANIZE_PARTITION |
+      Alter_info::ALTER_EXCHANGE_PARTITION |
+      Alter_info::ALTER_TRUNCATE_PARTITION |
+      Alter_info::ALTER_REMOVE_PARTITIONING |
+      Alter_info::ALTER_DISCARD_TABLESPACE |
+      Alter_info::ALTER_IMPORT_TABLESPACE;
+  std::string spec;
+  const bool mergeable =
+      ctx->merge_alter && ctx->mode == OpMode::EXECUTE &&
+      ctx->db_type != DbType::TIDB && !(alter_info->flags & standalone) &&
+      !lex->part_info &&
+      alter_info->requested_algorithm ==
+          Alter_info::ALTER_TABLE_ALGORITHM_DEFAULT &&
+      alter_info->requested_lock == Alter_info::ALTER_TABLE_LOCK_DEFAULT &&
+      alter_specification(node->sql_text, &spec);
+
+  auto disjoint = [](const std::set<std::string> &a,
+                     const std::set<std::string> &b) {
+    for (const auto &name : a)
+      if (b.count(name)) return false;
+    return true;
+  };
+
+  bool folded = false;
+  if (mergeable && group.table == key && group.last + 1 == index &&
+      disjoint(columns, group.columns) && disjoint(indexes, group.indexes)) {
+    SqlCacheNode &head = ctx->cache_nodes[group.head];
+    const bool osc = head.exec_strategy == "OSC" || node->exec_strategy == "OSC";
+    if (!osc || (head.osc_capable && node->osc_capable)) {
+      folded = true;
+      if (algorithm_rank(node->ddl_algorithm) >
+          algorithm_rank(head.ddl_algorithm))
+        head.ddl_algorithm = node->ddl_algorithm;
+      head.exec_strategy = osc ? "OSC" : "NATIVE";
+      head.online_clause = head.online_clause && node->online_clause &&
+                           head.ddl_algorithm != "COPY";
+      if (osc)
+        head.locks_writes = "NO";
+      else if (node->locks_writes == "YES" || head.ddl_algorithm == "COPY")
+        head.locks_writes = "YES";
+    }
+  }
+
+  if (!folded) {
+    group = InceptionContext::AlterGroup();
+    if (!mergeable) return false;
+    group.table = key;
+    group.head = index;
+  }
+  group.last = index;
+  group.columns.insert(columns.begin(), columns.end());
+  group.indexes.insert(indexes.begin(), indexes.end());
+  node->merged_alter = folded;
+  return folded;
+}
+
 static void audit_alter_table(THD *thd, SqlCacheNode *node,
                               InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_ALTER_TABLE);
   LEX *lex = thd->lex;
   Alter_info *alter_info = lex->alter_info;
   TABLE_LIST *tbl = lex->query_tables;
@@ -1472,6 +2327,20 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
   /* Set fine-grained sub_type: ALTER_TABLE.ADD_COLUMN, etc. */
   node->sub_type = resolve_alter_sub_type(alter_info->flags);
 
+  /* A ghost-table copy cannot rename the table or move partitions */
+  node->osc_capable =
+      db && table_name &&
+      !(alter_info->flags &
+        (Alter_info::ALTER_RENAME | Alter_info::ALTER_ADD_PARTITION |
+         Alter_info::ALTER_DROP_PARTITION |
+         Alter_info::ALTER_COALESCE_PARTITION |
+         Alter_info::ALTER_REORGANIZE_PARTITION |
+         Alter_info::ALTER_EXCHANGE_PARTITION |
+         Alter_info::ALTER_TRUNCATE_PARTITION |
+         Alter_info::ALTER_REMOVE_PARTITIONING |
+         Alter_info::ALTER_DISCARD_TABLESPACE |
+         Alter_info::ALTER_IMPORT_TABLESPACE));
+
   /* Get remote connection (shared across all checks) */
   MYSQL *remote = (db && table_name) ? get_remote_conn(ctx) : nullptr;
 
@@ -1483,16 +2352,16 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
   }
 
   /* Check if the target table exists (skip for batch-created tables) */
-  if (!in_batch && remote && db && table_name) {
-    if (!remote_table_exists(remote, db, table_name)) {
+  if (!in_batch && have_meta(ctx, remote) && db && table_name) {
+    if (!remote_table_exists(ctx, remote, db, table_name)) {
       node->append_error("Table '%s.%s' does not exist on remote server.",
                          db, table_name);
     }
   }
 
   /* Row count estimation for ALTER TABLE */
-  if (!in_batch && remote && db && table_name) {
-    int64_t rows = remote_table_rows(remote, db, table_name);
+  if (!in_batch && have_meta(ctx, remote) && db && table_name) {
+    int64_t rows = remote_table_rows(ctx, remote, db, table_name);
     if (rows >= 0) node->affected_rows = rows;
   }
 
@@ -1513,8 +2382,9 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
         std::string col(field->field_name);
         for (auto &c : col) c = tolower(c);
         ctx->batch_tables[bkey].insert(col);
-      } else if (remote && remote_column_exists(remote, db, table_name,
-                                         field->field_name)) {
+      } else if (have_meta(ctx, remote) &&
+                 remote_column_exists(ctx, remote, db, table_name,
+                                      field->field_name)) {
         node->append_error(
             "Column '%s' already exists in '%s.%s' on remote server.",
             field->field_name, db, table_name);
@@ -1540,8 +2410,9 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
             for (auto &c : col) c = tolower(c);
             ctx->batch_tables[bkey].erase(col);
           }
-        } else if (remote && !remote_column_exists(remote, db, table_name,
-                                            drop->name)) {
+        } else if (have_meta(ctx, remote) &&
+                   !remote_column_exists(ctx, remote, db, table_name,
+                                         drop->name)) {
           node->append_error(
               "Column '%s' does not exist in '%s.%s' on remote server.",
               drop->name, db, table_name);
@@ -1554,6 +2425,7 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
   if (alter_info->flags & Alter_info::ALTER_CHANGE_COLUMN) {
     List_iterator<Create_field> it(alter_info->create_list);
     Create_field *field;
+    std::vector<ColumnFit> fits;  /* inception_check_column_data */
     while ((field = it++)) {
       check_column(field, node, ctx);
       if (in_batch) {
@@ -1566,29 +2438,40 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
         /* Skip type narrowing checks for batch tables (no old type info) */
       } else {
         /* Check column exists on remote before modifying */
-        if (remote && !remote_column_exists(remote, db, table_name,
-                                            field->field_name)) {
+        if (have_meta(ctx, remote) &&
+            !remote_column_exists(ctx, remote, db, table_name,
+                                  field->field_name)) {
           node->append_error(
               "Column '%s' does not exist in '%s.%s' on remote server.",
               field->field_name, db, table_name);
         }
         /* Type compatibility check: detect narrowing */
-        if (remote && db && table_name) {
+        if (have_meta(ctx, remote) && db && table_name) {
           RemoteColumnInfo old_info;
-          if (remote_column_info(remote, db, table_name,
+          if (remote_column_info(ctx, remote, db, table_name,
                                  field->field_name, &old_info)) {
             /* Integer type narrowing: e.g. INT → SMALLINT */
             int old_rank = int_type_rank_from_name(old_info.data_type.c_str());
             int new_rank = int_type_rank(field->sql_type);
             if (old_rank > 0 && new_rank > 0 && new_rank < old_rank) {
-              node->report(opt_check_lossy_type_change,
+              node->report(rules.check_lossy_type_change,
                   "Column '%s' type narrowing: %s -> %s, may truncate data.",
                   field->field_name, old_info.data_type.c_str(),
                   type_display_name(field->sql_type));
+              if (rules.check_column_data > 0) {
+                ColumnFit fit;
+                fit.column = field->field_name;
+                fit.kind = ColumnFit::RANGE;
+                const bool is_unsigned = field->flags & UNSIGNED_FLAG;
+                int_type_bounds(new_rank, is_unsigned, &fit.lo, &fit.hi);
+                fit.new_type = std::string(type_display_name(field->sql_type)) +
+                               (is_unsigned ? " UNSIGNED" : "");
+                fits.push_back(fit);
+              }
               /* TiDB: stricter lossy type change check */
               if (ctx->db_type == DbType::TIDB &&
-                  opt_check_tidb_lossy_type_change > 0) {
-                node->report(opt_check_tidb_lossy_type_change,
+                  rules.check_tidb_lossy_type_change > 0) {
+                node->report(rules.check_tidb_lossy_type_change,
                     "TiDB does not support lossy type change: '%s' %s -> %s.",
                     field->field_name, old_info.data_type.c_str(),
                     type_display_name(field->sql_type));
@@ -1601,17 +2484,26 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
               if (new_is_string) {
                 size_t new_len = field->max_display_width_in_codepoints();
                 if (static_cast<int64_t>(new_len) < old_info.char_max_length) {
-                  node->report(opt_check_varchar_shrink,
+                  node->report(rules.check_varchar_shrink,
                       "Column '%s' length reduced: %lld -> %zu, may truncate "
                       "data.",
                       field->field_name,
                       static_cast<long long>(old_info.char_max_length),
                       new_len);
+                  if (rules.check_column_data > 0) {
+                    ColumnFit fit;
+                    fit.column = field->field_name;
+                    fit.max_length = static_cast<long long>(new_len);
+                    fit.new_type =
+                        std::string(type_display_name(field->sql_type)) +
+                        "(" + std::to_string(new_len) + ")";
+                    fits.push_back(fit);
+                  }
                   /* TiDB: stricter VARCHAR shrink check */
                   if (ctx->db_type == DbType::TIDB &&
-                      opt_check_tidb_varchar_shrink > 0 &&
+                      rules.check_tidb_varchar_shrink > 0 &&
                       field->sql_type == MYSQL_TYPE_VARCHAR) {
-                    node->report(opt_check_tidb_varchar_shrink,
+                    node->report(rules.check_tidb_varchar_shrink,
                         "TiDB does not support shrinking VARCHAR length: "
                         "'%s' %lld -> %zu.",
                         field->field_name,
@@ -1626,13 +2518,34 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
                 field->sql_type == MYSQL_TYPE_NEWDECIMAL &&
                 (old_info.numeric_precision >= 0 ||
                  old_info.numeric_scale >= 0)) {
-              node->report(opt_check_decimal_change,
+              node->report(rules.check_decimal_change,
                   "Column '%s' DECIMAL precision/scale changed.",
                   field->field_name);
+              /* Fewer integer digits, or no more negative values: rows
+                 may be out of range. A smaller scale only rounds. */
+              const long long precision = static_cast<long long>(
+                  field->max_display_width_in_codepoints());
+              const long long scale = field->decimals;
+              const bool is_unsigned = field->flags & UNSIGNED_FLAG;
+              if (rules.check_column_data > 0 &&
+                  (precision - scale <
+                       old_info.numeric_precision - old_info.numeric_scale ||
+                   (is_unsigned && !old_info.is_unsigned))) {
+                ColumnFit fit;
+                fit.column = field->field_name;
+                fit.kind = ColumnFit::RANGE;
+                fit.hi = decimal_type_max(static_cast<uint>(precision),
+                                          static_cast<uint>(scale));
+                fit.lo = is_unsigned ? "0" : "-" + fit.hi;
+                fit.new_type = "DECIMAL(" + std::to_string(precision) + "," +
+                               std::to_string(scale) + ")" +
+                               (is_unsigned ? " UNSIGNED" : "");
+                fits.push_back(fit);
+              }
               /* TiDB: stricter DECIMAL change check */
               if (ctx->db_type == DbType::TIDB &&
-                  opt_check_tidb_decimal_change > 0) {
-                node->report(opt_check_tidb_decimal_change,
+                  rules.check_tidb_decimal_change > 0) {
+                node->report(rules.check_tidb_decimal_change,
                     "TiDB does not support changing DECIMAL precision/scale "
                     "for column '%s'.",
                     field->field_name);
@@ -1642,6 +2555,9 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
         }
       }
     }
+    if (!fits.empty() && db && table_name)
+      check_column_data(ctx, node, rules.check_column_data, db, table_name,
+                        fits);
   }
 
   /* --- ADD INDEX --- */
@@ -1650,6 +2566,8 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
       check_index(key, node, alter_info,
                   in_batch ? nullptr : remote, db, table_name, ctx);
     }
+    if (!in_batch)
+      check_redundant_indexes(node, ctx, remote, db, table_name, alter_info);
   }
 
   /* --- DROP INDEX --- */
@@ -1657,8 +2575,8 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
     for (const auto &drop : alter_info->drop_list) {
       if (drop->type == Alter_drop::KEY) {
         /* Skip remote index check for batch-created tables */
-        if (!in_batch && remote && !remote_index_exists(remote, db, table_name,
-                                           drop->name)) {
+        if (!in_batch && have_meta(ctx, remote) &&
+            !remote_index_exists(ctx, remote, db, table_name, drop->name)) {
           node->append_error(
               "Index '%s' does not exist in '%s.%s' on remote server.",
               drop->name, db, table_name);
@@ -1676,30 +2594,18 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
   /* --- OPTIONS (ENGINE change check) --- */
   if (alter_info->flags & Alter_info::ALTER_OPTIONS) {
     HA_CREATE_INFO *create_info = lex->create_info;
-    if (opt_check_engine_innodb > 0 && create_info && create_info->db_type) {
+    if (rules.check_engine_innodb > 0 && create_info && create_info->db_type) {
       handlerton *engine = create_info->db_type;
       if (engine != innodb_hton) {
-        node->report(opt_check_engine_innodb,
+        node->report(rules.check_engine_innodb,
             "Changing engine to '%s' is not allowed; must use InnoDB.",
             ha_resolve_storage_engine_name(engine));
       }
     }
   }
 
-  /* --- Merge ALTER TABLE check --- */
-  if (opt_check_merge_alter_table > 0 && db && table_name) {
-    std::string key = std::string(db) + "." + table_name;
-    if (ctx->altered_tables.count(key) > 0) {
-      node->report(opt_check_merge_alter_table,
-          "Table '%s.%s' has been altered before in this session; "
-          "consider merging into a single ALTER TABLE statement.",
-          db, table_name);
-    }
-    ctx->altered_tables.insert(key);
-  }
-
   /* --- TiDB: reject multiple operations in a single ALTER --- */
-  if (ctx->db_type == DbType::TIDB && opt_check_tidb_merge_alter > 0) {
+  if (ctx->db_type == DbType::TIDB && rules.check_tidb_merge_alter > 0) {
     int op_categories = 0;
     if (alter_info->flags & Alter_info::ALTER_ADD_COLUMN)    op_categories++;
     if (alter_info->flags & Alter_info::ALTER_DROP_COLUMN)   op_categories++;
@@ -1715,34 +2621,79 @@ static void audit_alter_table(THD *thd, SqlCacheNode *node,
       while (cf_it++) add_col_count++;
     }
     if (op_categories > 1 || add_col_count > 1) {
-      node->report(opt_check_tidb_merge_alter,
+      node->report(rules.check_tidb_merge_alter,
           "TiDB does not support multiple operations in a single "
           "ALTER TABLE; split into separate statements.");
     }
   }
 
-  /* Predict DDL algorithm */
-  node->ddl_algorithm = predict_alter_algorithm(lex, ctx);
+  /* Predict DDL algorithm, then pick native vs online schema change */
+  bool positioned = false;
+  node->ddl_algorithm = predict_alter_algorithm(lex, ctx, remote, db,
+                                                table_name, in_batch,
+                                                &positioned);
+  if (positioned) {
+    node->report(rules.check_column_position_rebuild,
+        "ADD COLUMN ... FIRST / AFTER makes this ALTER rebuild %s.%s "
+        "(%s) on MySQL %u.%u.%u; added at the end of the row the columns "
+        "would be INSTANT.",
+        db ? db : "", table_name ? table_name : "",
+        node->ddl_algorithm.c_str(), ctx->db_version_major,
+        ctx->db_version_minor, ctx->db_version_patch);
+  }
+  plan_alter_execution(node, ctx, alter_info, lex->create_info, remote, db,
+                       table_name, in_batch);
+
+  /* --- Merge ALTER TABLE: fold (--enable-merge-alter) or warn --- */
+  if (db && table_name) {
+    std::string key = std::string(db) + "." + table_name;
+    bool folded = fold_into_previous_alter(lex, node, ctx, key);
+    if (!folded && rules.check_merge_alter_table > 0 &&
+        ctx->altered_tables.count(key) > 0) {
+      node->report(rules.check_merge_alter_table,
+          "Table '%s.%s' has been altered before in this session; "
+          "consider merging into a single ALTER TABLE statement.",
+          db, table_name);
+    }
+    ctx->altered_tables.insert(key);
+  }
+}
+
+/* ---- CREATE INDEX ---- */
+
+static void audit_create_index(THD *thd, SqlCacheNode *node,
+                               InceptionContext *ctx) {
+  RuleScope scope(ctx, node, RULE_ALTER_TABLE);
+  LEX *lex = thd->lex;
+  TABLE_LIST *tbl = lex->query_tables;
+  const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
+  const char *table_name = tbl ? tbl->table_name : nullptr;
+  if (!lex->alter_info || !db || !table_name ||
+      ctx->batch_tables.count(batch_table_key(db, table_name)))
+    return;
+  check_redundant_indexes(node, ctx, get_remote_conn(ctx), db, table_name,
+                          lex->alter_info);
 }
 
 /* ---- IN clause size check (recursive) ---- */
 
-static void check_in_clause(Item *item, SqlCacheNode *node) {
-  if (!item || opt_check_in_count == 0) return;
+static void check_in_clause(Item *item, SqlCacheNode *node,
+                            const RulePlan &rules) {
+  if (!item || rules.check_in_count == 0) return;
 
   if (item->type() == Item::FUNC_ITEM) {
     auto *func = down_cast<Item_func *>(item);
     if (func->functype() == Item_func::IN_FUNC) {
       uint in_count = func->arg_count - 1;  /* subtract left-side expression */
-      if (in_count > opt_check_in_count) {
+      if (in_count > rules.check_in_count) {
         node->append_warning(
             "IN clause has %u items, exceeds max %lu.",
-            in_count, opt_check_in_count);
+            in_count, rules.check_in_count);
       }
     }
     /* Recurse into function arguments */
     for (uint i = 0; i < func->arg_count; i++)
-      check_in_clause(func->arguments()[i], node);
+      check_in_clause(func->arguments()[i], node, rules);
   }
 
   if (item->type() == Item::COND_ITEM) {
@@ -1750,7 +2701,7 @@ static void check_in_clause(Item *item, SqlCacheNode *node) {
     List_iterator<Item> it(*cond->argument_list());
     Item *sub;
     while ((sub = it++))
-      check_in_clause(sub, node);
+      check_in_clause(sub, node, rules);
   }
 }
 
@@ -1758,6 +2709,8 @@ static void check_in_clause(Item *item, SqlCacheNode *node) {
 
 static void audit_insert(THD *thd, SqlCacheNode *node,
                          InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_INSERT);
   LEX *lex = thd->lex;
 
   /* Check table exists (batch or remote) */
@@ -1769,7 +2722,8 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
       std::string key = batch_table_key(db, table_name);
       if (ctx->batch_tables.count(key) == 0) {
         MYSQL *remote = get_remote_conn(ctx);
-        if (remote && !remote_table_exists(remote, db, table_name)) {
+        if (have_meta(ctx, remote) &&
+            !remote_table_exists(ctx, remote, db, table_name)) {
           node->append_error("Table '%s.%s' does not exist on remote server.",
                              db, table_name);
         }
@@ -1778,33 +2732,16 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
   }
 
   /* Must specify column list */
-  if (opt_check_insert_column > 0) {
+  if (rules.check_insert_column > 0) {
     auto *cmd = dynamic_cast<Sql_cmd_insert_base *>(lex->m_sql_cmd);
     if (cmd && cmd->insert_field_list.empty()) {
-      node->report(opt_check_insert_column,
+      node->report(rules.check_insert_column,
           "INSERT/REPLACE should specify an explicit column list.");
     }
   }
 
-  /* INSERT column/value count mismatch */
-  if (opt_check_insert_values_match > 0) {
-    auto *cmd = dynamic_cast<Sql_cmd_insert_base *>(lex->m_sql_cmd);
-    if (cmd && !cmd->insert_field_list.empty()) {
-      size_t expected = cmd->insert_field_list.size();
-      for (const auto &row : cmd->insert_many_values) {
-        size_t actual = row->size();
-        if (actual != expected) {
-          node->report(opt_check_insert_values_match,
-              "INSERT column count %zu does not match value count %zu.",
-              expected, actual);
-          break;
-        }
-      }
-    }
-  }
-
   /* INSERT duplicate column detection */
-  if (opt_check_insert_duplicate_column > 0) {
+  if (rules.check_insert_duplicate_column > 0) {
     auto *cmd = dynamic_cast<Sql_cmd_insert_base *>(lex->m_sql_cmd);
     if (cmd && !cmd->insert_field_list.empty()) {
       std::set<std::string> seen;
@@ -1814,7 +2751,7 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
         std::string lower_name(name);
         for (auto &c : lower_name) c = tolower(c);
         if (!seen.insert(lower_name).second) {
-          node->report(opt_check_insert_duplicate_column,
+          node->report(rules.check_insert_duplicate_column,
               "Duplicate column '%s' in INSERT column list.", name);
         }
       }
@@ -1822,20 +2759,20 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
   }
 
   /* INSERT ... SELECT must have WHERE */
-  if (opt_check_dml_where > 0) {
+  if (rules.check_dml_where > 0) {
     if (lex->sql_command == SQLCOM_INSERT_SELECT ||
         lex->sql_command == SQLCOM_REPLACE_SELECT) {
       /* The SELECT part is the first query_block */
       Query_block *qb = lex->query_block;
       if (qb->where_cond() == nullptr) {
-        node->report(opt_check_dml_where,
+        node->report(rules.check_dml_where,
             "INSERT ... SELECT without a WHERE clause on the SELECT.");
       }
     }
   }
 
   /* Check that INSERT columns exist (batch or remote table) */
-  if (opt_check_column_exists > 0) {
+  if (rules.check_column_exists > 0) {
     TABLE_LIST *tbl = lex->query_tables;
     const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
     const char *table_name = tbl ? tbl->table_name : nullptr;
@@ -1852,13 +2789,13 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
           if (!name) continue;
           if (in_batch) {
             if (!batch_column_exists(ctx, db, table_name, name)) {
-              node->report(opt_check_column_exists,
+              node->report(rules.check_column_exists,
                   "Column '%s' does not exist in '%s.%s'.",
                   name, db, table_name);
             }
-          } else if (remote &&
-                     !remote_column_exists(remote, db, table_name, name)) {
-            node->report(opt_check_column_exists,
+          } else if (have_meta(ctx, remote) &&
+                     !remote_column_exists(ctx, remote, db, table_name, name)) {
+            node->report(rules.check_column_exists,
                 "Column '%s' does not exist in '%s.%s'.",
                 name, db, table_name);
           }
@@ -1868,10 +2805,198 @@ static void audit_insert(THD *thd, SqlCacheNode *node,
   }
 }
 
+/* ---- UPDATE / DELETE plan ---- */
+
+/**
+ * The target's binlog_row_image (upper-case), "NONE" if it does not log
+ * UPDATE/DELETE as row events, "" if it could not be read. Asked once per
+ * session.
+ */
+static const std::string &target_binlog_row_image(InceptionContext *ctx,
+                                                  MYSQL *mysql) {
+  if (!ctx->binlog_row_image.empty()) return ctx->binlog_row_image;
+  RuleScope scope(ctx, nullptr, RULE_METADATA);
+  StageScope stage(stage_inception_remote_check);
+  QuerySlot slot(ctx, mysql);
+  if (slot.killed()) return ctx->binlog_row_image;
+  ctx->remote_queries++;
+  status_add(STATUS_REMOTE_QUERIES);
+  std::vector<std::string> row;
+  bool found = false;
+  const auto start = std::chrono::steady_clock::now();
+  const bool failed =
+      query_one_row(mysql, remote_sql::BINLOG_SETTINGS, &row, &found);
+  ctx->remote_us += record_remote_latency(mysql, REMOTE_METADATA, start);
+  if (failed) return ctx->binlog_row_image;
+  if (found && row.size() >= 3 && row[0] == "1" &&
+      strcasecmp(row[1].c_str(), "ROW") == 0) {
+    ctx->binlog_row_image = row[2];
+    std::transform(ctx->binlog_row_image.begin(), ctx->binlog_row_image.end(),
+                   ctx->binlog_row_image.begin(), ::toupper);
+  } else {
+    ctx->binlog_row_image = "NONE";
+  }
+  return ctx->binlog_row_image;
+}
+
+/**
+ * Row event bytes one row of an UPDATE/DELETE adds to the binlog: its
+ * before image, plus its after image for an UPDATE, each AVG_ROW_LENGTH
+ * bytes (data over rows if unknown). With binlog_row_image=MINIMAL they
+ * shrink to the primary key and the SET columns, at an even share of the
+ * row per column. -1 if the table size is unknown.
+ */
+static int64_t binlog_row_bytes(const TableMeta &meta, const std::string &image,
+                                bool is_update, size_t set_columns) {
+  int64_t row_len = meta.avg_row_length;
+  if (row_len <= 0 && meta.table_rows > 0 && meta.table_bytes > 0)
+    row_len = meta.table_bytes / meta.table_rows;
+  if (row_len <= 0) return -1;
+  if (image != "MINIMAL") return is_update ? 2 * row_len : row_len;
+
+  const size_t columns = std::max<size_t>(meta.column_order.size(), 1);
+  const int64_t column_len = std::max<int64_t>(row_len / columns, 1);
+  auto pk = meta.index_defs.find("primary");
+  const size_t key_parts =
+      pk != meta.index_defs.end() ? pk->second.parts.size() : columns;
+  int64_t bytes = column_len * static_cast<int64_t>(key_parts);
+  if (is_update)
+    bytes += column_len *
+             static_cast<int64_t>(std::min(set_columns, columns));
+  return bytes;
+}
+
+/**
+ * inception_check_dml_binlog_size: estimate the row events of an UPDATE or
+ * DELETE of rows rows, and the time a replica needs to apply them at the
+ * target's apply speed (cache_apply_speed()). Report them over
+ * inception_check_max_dml_binlog_size or inception_exec_max_replication_delay,
+ * with the chunk size that keeps a replica under the latter.
+ */
+static void check_dml_binlog_size(THD *thd, SqlCacheNode *node,
+                                  InceptionContext *ctx, MYSQL *remote,
+                                  const char *db, const char *table_name,
+                                  int64_t rows, const char *verb) {
+  const RulePlan &rules = ctx->rules;
+  if (rules.check_dml_binlog_size == 0 || rows <= 0 || !remote ||
+      ctx->db_type == DbType::TIDB)
+    return;
+  const std::string &image = target_binlog_row_image(ctx, remote);
+  if (image.empty() || image == "NONE") return;
+
+  TableMetaPtr meta;
+  {
+    RuleScope scope(ctx, nullptr, RULE_METADATA);
+    meta = get_table_meta(ctx, remote, db, table_name);
+  }
+  if (!meta || !meta->exists) return;
+  const bool is_update = thd->lex->sql_command == SQLCOM_UPDATE ||
+                         thd->lex->sql_command == SQLCOM_UPDATE_MULTI;
+  const int64_t row_bytes = binlog_row_bytes(
+      *meta, image, is_update, thd->lex->query_block->fields.size());
+  if (row_bytes <= 0) return;
+  node->binlog_row_bytes = row_bytes;
+
+  const double MB = 1024.0 * 1024.0;
+  const double mb = static_cast<double>(row_bytes) * rows / MB;
+  if (rules.check_max_dml_binlog_size > 0 &&
+      mb > static_cast<double>(rules.check_max_dml_binlog_size)) {
+    node->report(rules.check_dml_binlog_size,
+        "%s writes about %.0f MB of row events to the binlog (~%lld rows of "
+        "%lld bytes, binlog_row_image=%s), over %lu MB.",
+        verb, mb, (long long)rows, (long long)row_bytes, image.c_str(),
+        rules.check_max_dml_binlog_size);
+  }
+
+  if (opt_exec_max_replication_delay == 0) return;
+  const double speed = cache_apply_speed(cache_target(ctx));
+  const double secs = mb / speed;
+  const double max_delay = static_cast<double>(opt_exec_max_replication_delay);
+  if (secs > max_delay) {
+    const long long chunk =
+        std::max(1LL, static_cast<long long>(rows * max_delay / secs));
+    node->report(rules.check_dml_binlog_size,
+        "%s would delay the replicas by about %.0f s (%.0f MB of row events "
+        "at %.1f MB/s), over inception_exec_max_replication_delay=%lu; run it "
+        "with --enable-chunked-dml and inception_exec_chunk_size of at most "
+        "%lld rows.",
+        verb, secs, mb, speed, opt_exec_max_replication_delay, chunk);
+  }
+}
+
+/**
+ * Estimate the rows of an UPDATE/DELETE (EXPLAIN, else TABLE_ROWS) into
+ * node->affected_rows, and apply the EXPLAIN plan rules: a whole-table
+ * read or a filesort / temporary table over check_explain_min_rows rows.
+ */
+static void audit_dml_plan(THD *thd, SqlCacheNode *node,
+                           InceptionContext *ctx, const char *verb) {
+  const RulePlan &rules = ctx->rules;
+  LEX *lex = thd->lex;
+  TABLE_LIST *tbl = lex->query_tables;
+  const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
+  const char *table_name = tbl ? tbl->table_name : nullptr;
+  if (!db || !table_name) return;
+  MYSQL *remote = get_remote_conn(ctx);
+  if (!have_meta(ctx, remote)) return;
+
+  ExplainPlan plan;
+  const bool is_tidb = (ctx->db_type == DbType::TIDB);
+  /* On the --audit-host replica, else (or when it fails there) the target */
+  MYSQL *reader = get_audit_conn(ctx, remote);
+  bool no_plan = !remote;
+  if (remote) {
+    no_plan = explain_plan(ctx, reader, db, node->sql_text, is_tidb, &plan);
+    if (no_plan && reader != remote)
+      no_plan = explain_plan(ctx, remote, db, node->sql_text, is_tidb, &plan);
+  }
+  if (!no_plan) {
+    const int64_t min_rows = static_cast<int64_t>(rules.check_explain_min_rows);
+    if (rules.check_dml_full_scan > 0 && plan.full_scan &&
+        plan.scan_rows >= min_rows) {
+      const char *scan_table =
+          plan.scan_table.empty() ? table_name : plan.scan_table.c_str();
+      if (lex->query_block->where_cond())
+        node->report(rules.check_dml_full_scan,
+            "%s reads all ~%lld rows of table '%s': no usable index on "
+            "the WHERE columns.",
+            verb, (long long)plan.scan_rows, scan_table);
+      else
+        node->report(rules.check_dml_full_scan,
+            "%s reads all ~%lld rows of table '%s'.",
+            verb, (long long)plan.scan_rows, scan_table);
+    }
+    if (rules.check_dml_filesort > 0 && (plan.filesort || plan.temporary) &&
+        plan.sort_rows >= min_rows) {
+      node->report(rules.check_dml_filesort,
+          "%s sorts ~%lld rows with %s.", verb, (long long)plan.sort_rows,
+          plan.filesort && plan.temporary
+              ? "a temporary table and a filesort"
+              : (plan.filesort ? "a filesort" : "a temporary table"));
+    }
+  }
+
+  int64_t rows = plan.rows;
+  if (rows < 0) rows = remote_table_rows(ctx, remote, db, table_name);
+  if (rows >= 0) {
+    node->affected_rows = rows;
+    if (rules.check_max_update_rows > 0 &&
+        static_cast<uint64_t>(rows) > rules.check_max_update_rows) {
+      node->append_warning(
+          "Table '%s.%s' has approximately %lld rows, exceeds max %lu. "
+          "Consider batching the %s.",
+          db, table_name, (long long)rows, rules.check_max_update_rows, verb);
+    }
+    check_dml_binlog_size(thd, node, ctx, remote, db, table_name, rows, verb);
+  }
+}
+
 /* ---- UPDATE ---- */
 
 static void audit_update(THD *thd, SqlCacheNode *node,
                          InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_UPDATE);
   LEX *lex = thd->lex;
   Query_block *qb = lex->query_block;
 
@@ -1884,7 +3009,8 @@ static void audit_update(THD *thd, SqlCacheNode *node,
       std::string key = batch_table_key(db, table_name);
       if (ctx->batch_tables.count(key) == 0) {
         MYSQL *remote = get_remote_conn(ctx);
-        if (remote && !remote_table_exists(remote, db, table_name)) {
+        if (have_meta(ctx, remote) &&
+            !remote_table_exists(ctx, remote, db, table_name)) {
           node->append_error("Table '%s.%s' does not exist on remote server.",
                              db, table_name);
         }
@@ -1893,55 +3019,30 @@ static void audit_update(THD *thd, SqlCacheNode *node,
   }
 
   /* Must have WHERE */
-  if (opt_check_dml_where > 0 && qb->where_cond() == nullptr) {
-    node->report(opt_check_dml_where,
+  if (rules.check_dml_where > 0 && qb->where_cond() == nullptr) {
+    node->report(rules.check_dml_where,
         "UPDATE without a WHERE clause is not allowed.");
   }
 
   /* LIMIT check */
-  if (opt_check_dml_limit > 0 && qb->has_limit()) {
-    node->report(opt_check_dml_limit,
+  if (rules.check_dml_limit > 0 && qb->has_limit()) {
+    node->report(rules.check_dml_limit,
         "UPDATE with LIMIT is not recommended.");
   }
 
   /* ORDER BY check */
-  if (opt_check_orderby_in_dml > 0 && qb->is_ordered()) {
-    node->report(opt_check_orderby_in_dml,
+  if (rules.check_orderby_in_dml > 0 && qb->is_ordered()) {
+    node->report(rules.check_orderby_in_dml,
         "UPDATE with ORDER BY is not recommended.");
   }
 
-  /* IN clause size check */
-  check_in_clause(qb->where_cond(), node);
-
-  /* Row count estimation via EXPLAIN */
-  {
-    TABLE_LIST *tbl = lex->query_tables;
-    const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
-    const char *table_name = tbl ? tbl->table_name : nullptr;
-    if (db && table_name) {
-      MYSQL *remote = get_remote_conn(ctx);
-      if (remote) {
-        bool is_tidb = (ctx->db_type == DbType::TIDB);
-        int64_t rows = explain_rows(remote, db, node->sql_text, is_tidb);
-        if (rows < 0) rows = remote_table_rows(remote, db, table_name);
-        if (rows >= 0) {
-          node->affected_rows = rows;
-          if (opt_check_max_update_rows > 0 &&
-              static_cast<uint64_t>(rows) > opt_check_max_update_rows) {
-            node->append_warning(
-                "Table '%s.%s' has approximately %lld rows, exceeds max %lu. "
-                "Consider batching the UPDATE.",
-                db, table_name, (long long)rows, opt_check_max_update_rows);
-          }
-        }
-      }
-    }
-  }
+  /* Row count estimation and plan rules via EXPLAIN */
+  audit_dml_plan(thd, node, ctx, "UPDATE");
 
   /* Check that UPDATE SET columns exist (batch or remote table).
      Note: Use qb->fields (populated during parsing) instead of
      Sql_cmd_update::original_fields (only set during prepare). */
-  if (opt_check_column_exists > 0) {
+  if (rules.check_column_exists > 0) {
     TABLE_LIST *tbl = lex->query_tables;
     const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
     const char *table_name = tbl ? tbl->table_name : nullptr;
@@ -1956,13 +3057,13 @@ static void audit_update(THD *thd, SqlCacheNode *node,
         if (!name) continue;
         if (in_batch) {
           if (!batch_column_exists(ctx, db, table_name, name)) {
-            node->report(opt_check_column_exists,
+            node->report(rules.check_column_exists,
                 "Column '%s' does not exist in '%s.%s'.",
                 name, db, table_name);
           }
-        } else if (remote &&
-                   !remote_column_exists(remote, db, table_name, name)) {
-          node->report(opt_check_column_exists,
+        } else if (have_meta(ctx, remote) &&
+                   !remote_column_exists(ctx, remote, db, table_name, name)) {
+          node->report(rules.check_column_exists,
               "Column '%s' does not exist in '%s.%s'.",
               name, db, table_name);
         }
@@ -1975,12 +3076,14 @@ static void audit_update(THD *thd, SqlCacheNode *node,
 
 static void audit_delete(THD *thd, SqlCacheNode *node,
                          InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_DELETE);
   LEX *lex = thd->lex;
   Query_block *qb = lex->query_block;
 
   /* DELETE statement level check */
-  if (opt_check_delete > 0) {
-    node->report(opt_check_delete,
+  if (rules.check_delete > 0) {
+    node->report(rules.check_delete,
         "DELETE statement is restricted by audit policy.");
   }
 
@@ -1993,7 +3096,8 @@ static void audit_delete(THD *thd, SqlCacheNode *node,
       std::string key = batch_table_key(db, table_name);
       if (ctx->batch_tables.count(key) == 0) {
         MYSQL *remote = get_remote_conn(ctx);
-        if (remote && !remote_table_exists(remote, db, table_name)) {
+        if (have_meta(ctx, remote) &&
+            !remote_table_exists(ctx, remote, db, table_name)) {
           node->append_error("Table '%s.%s' does not exist on remote server.",
                              db, table_name);
         }
@@ -2002,72 +3106,50 @@ static void audit_delete(THD *thd, SqlCacheNode *node,
   }
 
   /* Must have WHERE */
-  if (opt_check_dml_where > 0 && qb->where_cond() == nullptr) {
-    node->report(opt_check_dml_where,
+  if (rules.check_dml_where > 0 && qb->where_cond() == nullptr) {
+    node->report(rules.check_dml_where,
         "DELETE without a WHERE clause is not allowed.");
   }
 
   /* LIMIT check */
-  if (opt_check_dml_limit > 0 && qb->has_limit()) {
-    node->report(opt_check_dml_limit,
+  if (rules.check_dml_limit > 0 && qb->has_limit()) {
+    node->report(rules.check_dml_limit,
         "DELETE with LIMIT is not recommended.");
   }
 
   /* ORDER BY check */
-  if (opt_check_orderby_in_dml > 0 && qb->is_ordered()) {
-    node->report(opt_check_orderby_in_dml,
+  if (rules.check_orderby_in_dml > 0 && qb->is_ordered()) {
+    node->report(rules.check_orderby_in_dml,
         "DELETE with ORDER BY is not recommended.");
   }
 
-  /* IN clause size check */
-  check_in_clause(qb->where_cond(), node);
-
-  /* Row count estimation via EXPLAIN */
-  {
-    TABLE_LIST *tbl = lex->query_tables;
-    const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
-    const char *table_name = tbl ? tbl->table_name : nullptr;
-    if (db && table_name) {
-      MYSQL *remote = get_remote_conn(ctx);
-      if (remote) {
-        bool is_tidb = (ctx->db_type == DbType::TIDB);
-        int64_t rows = explain_rows(remote, db, node->sql_text, is_tidb);
-        if (rows < 0) rows = remote_table_rows(remote, db, table_name);
-        if (rows >= 0) {
-          node->affected_rows = rows;
-          if (opt_check_max_update_rows > 0 &&
-              static_cast<uint64_t>(rows) > opt_check_max_update_rows) {
-            node->append_warning(
-                "Table '%s.%s' has approximately %lld rows, exceeds max %lu. "
-                "Consider batching the DELETE.",
-                db, table_name, (long long)rows, opt_check_max_update_rows);
-          }
-        }
-      }
-    }
-  }
+  /* Row count estimation and plan rules via EXPLAIN */
+  audit_dml_plan(thd, node, ctx, "DELETE");
 }
 
 /* ---- SELECT ---- */
 
-static void audit_select(THD *thd, SqlCacheNode *node) {
+static void audit_select(THD *thd, SqlCacheNode *node,
+                         InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_SELECT);
   LEX *lex = thd->lex;
   Query_block *qb = lex->query_block;
 
   /* SELECT * check */
-  if (opt_check_select_star > 0 && qb->with_wild > 0) {
-    node->report(opt_check_select_star,
+  if (rules.check_select_star > 0 && qb->with_wild > 0) {
+    node->report(rules.check_select_star,
         "SELECT * is not recommended; specify columns.");
   }
 
   /* ORDER BY RAND() check */
-  if (opt_check_orderby_rand > 0 && qb->is_ordered()) {
+  if (rules.check_orderby_rand > 0 && qb->is_ordered()) {
     for (ORDER *ord = qb->order_list.first; ord; ord = ord->next) {
       Item *item = *ord->item;
       if (item->type() == Item::FUNC_ITEM) {
         auto *func = down_cast<Item_func *>(item);
         if (strcasecmp(func->func_name(), "rand") == 0) {
-          node->report(opt_check_orderby_rand,
+          node->report(rules.check_orderby_rand,
               "ORDER BY RAND() is not recommended; causes full table scan.");
           break;
         }
@@ -2076,14 +3158,18 @@ static void audit_select(THD *thd, SqlCacheNode *node) {
   }
 
   /* IN clause size check */
-  check_in_clause(qb->where_cond(), node);
+  check_in_clause(qb->where_cond(), node, rules);
 }
 
 /* ---- DROP TABLE ---- */
 
-static void audit_drop_table(THD *, SqlCacheNode *node) {
-  if (opt_check_drop_table > 0) {
-    node->report(opt_check_drop_table,
+static void audit_drop_table(THD *, SqlCacheNode *node,
+                             InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_DROP_TABLE);
+
+  if (rules.check_drop_table > 0) {
+    node->report(rules.check_drop_table,
         "DROP TABLE will permanently remove the table.");
   }
 }
@@ -2092,12 +3178,14 @@ static void audit_drop_table(THD *, SqlCacheNode *node) {
 
 static void audit_truncate(THD *thd, SqlCacheNode *node,
                            InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_TRUNCATE);
   TABLE_LIST *tbl = thd->lex->query_tables;
   const char *db = (tbl && tbl->db) ? tbl->db : thd->db().str;
   const char *table_name = tbl ? tbl->table_name : nullptr;
 
-  if (opt_check_truncate_table > 0) {
-    node->report(opt_check_truncate_table,
+  if (rules.check_truncate_table > 0) {
+    node->report(rules.check_truncate_table,
         "TRUNCATE TABLE will remove all data from '%s.%s'.",
         db ? db : "", table_name ? table_name : "");
   }
@@ -2107,12 +3195,12 @@ static void audit_truncate(THD *thd, SqlCacheNode *node,
     std::string key = batch_table_key(db, table_name);
     if (ctx->batch_tables.count(key) == 0) {
       MYSQL *remote = get_remote_conn(ctx);
-      if (remote) {
-        if (!remote_table_exists(remote, db, table_name)) {
+      if (have_meta(ctx, remote)) {
+        if (!remote_table_exists(ctx, remote, db, table_name)) {
           node->append_error("Table '%s.%s' does not exist on remote server.",
                              db, table_name);
         } else {
-          int64_t rows = remote_table_rows(remote, db, table_name);
+          int64_t rows = remote_table_rows(ctx, remote, db, table_name);
           if (rows >= 0) node->affected_rows = rows;
         }
       }
@@ -2120,54 +3208,391 @@ static void audit_truncate(THD *thd, SqlCacheNode *node,
   }
 }
 
+/* ---- Literal-dependent DML rules ---- */
+
+/**
+ * The INSERT / UPDATE / DELETE rules whose outcome depends on literals the
+ * digest folds away (the VALUES rows, the items of an IN list). They run
+ * for every statement; the rest of the rules go through the audit memo.
+ */
+static void audit_dml_literals(THD *thd, SqlCacheNode *node,
+                               InceptionContext *ctx) {
+  const RulePlan &rules = ctx->rules;
+  RuleScope scope(ctx, node, RULE_DML_LITERALS);
+  LEX *lex = thd->lex;
+  switch (lex->sql_command) {
+    case SQLCOM_INSERT:
+    case SQLCOM_INSERT_SELECT:
+    case SQLCOM_REPLACE:
+    case SQLCOM_REPLACE_SELECT: {
+      /* INSERT column/value count mismatch */
+      if (rules.check_insert_values_match == 0) break;
+      auto *cmd = dynamic_cast<Sql_cmd_insert_base *>(lex->m_sql_cmd);
+      if (cmd && !cmd->insert_field_list.empty()) {
+        size_t expected = cmd->insert_field_list.size();
+        for (const auto &row : cmd->insert_many_values) {
+          size_t actual = row->size();
+          if (actual != expected) {
+            node->report(rules.check_insert_values_match,
+                "INSERT column count %zu does not match value count %zu.",
+                expected, actual);
+            break;
+          }
+        }
+      }
+      break;
+    }
+    default:
+      /* IN clause size check */
+      check_in_clause(lex->query_block->where_cond(), node, rules);
+      break;
+  }
+}
+
+/* ---- Audit memo ---- */
+
+using DmlAudit = void (*)(THD *, SqlCacheNode *, InceptionContext *);
+
+/**
+ * Run the literal-independent rules of a DML statement, or reuse what they
+ * reported for an earlier statement of the same shape (sqlsha1) under the
+ * same default database. Their findings and row estimate are appended to
+ * node the same way on a hit and on a miss.
+ */
+static void audit_dml_shape(THD *thd, SqlCacheNode *node,
+                            InceptionContext *ctx, DmlAudit audit) {
+  const InceptionContext::AuditMemo *memo = nullptr;
+  InceptionContext::AuditMemo fresh;
+  std::string key;
+  if (opt_audit_memo_size > 0 && !node->sqlsha1.empty()) {
+    key = node->sqlsha1 + "|" + (thd->db().str ? thd->db().str : "");
+    auto it = ctx->audit_memo_index.find(key);
+    if (it != ctx->audit_memo_index.end()) {
+      ctx->audit_memo.splice(ctx->audit_memo.begin(), ctx->audit_memo,
+                             it->second);
+      memo = &it->second->second;
+      ctx->audit_memo_hits++;
+    }
+  }
+
+  if (!memo) {
+    /* The text is lent to the shape, not copied */
+    SqlCacheNode shape;
+    shape.sql_text.swap(node->sql_text);
+    audit(thd, &shape, ctx);
+    node->sql_text.swap(shape.sql_text);
+    fresh.errlevel = shape.errlevel;
+    fresh.errmsg = std::move(shape.errmsg);
+    fresh.affected_rows = shape.affected_rows;
+    memo = &fresh;
+    if (!key.empty()) {
+      ctx->audit_memo.emplace_front(key, fresh);
+      ctx->audit_memo_index[key] = ctx->audit_memo.begin();
+      while (ctx->audit_memo.size() > opt_audit_memo_size) {
+        ctx->audit_memo_index.erase(ctx->audit_memo.back().first);
+        ctx->audit_memo.pop_back();
+      }
+    }
+  }
+
+  if (!memo->errmsg.empty()) {
+    if (!node->errmsg.empty()) node->errmsg += "\n";
+    node->errmsg += memo->errmsg;
+  }
+  if (node->errlevel < memo->errlevel) node->errlevel = memo->errlevel;
+  node->affected_rows = memo->affected_rows;
+}
+
 /* ---- SQL Fingerprint ---- */
 
+/* Width of the fingerprint: 160 bits, the size of the former SHA1 one */
+static const size_t SQLSHA1_BYTES = 20;
+
 void compute_sqlsha1(THD *thd, SqlCacheNode *node) {
   if (!thd->m_digest) return;
-  sql_digest_storage *digest = &thd->m_digest->m_digest_storage;
-  if (digest->is_empty()) return;
+  const sql_digest_storage *digest = &thd->m_digest->m_digest_storage;
+  if (digest->m_byte_count == 0) return;
+
+  /* SHA-256 of the parser's token array, the statement digest of
+     performance_schema; literals are already folded into value tokens,
+     so the normalized text need not be rebuilt */
+  static_assert(SQLSHA1_BYTES <= DIGEST_HASH_SIZE, "digest hash too short");
+  unsigned char hash[DIGEST_HASH_SIZE];
+  compute_digest_hash(digest, hash);
+
+  static const char hex_digits[] = "0123456789abcdef";
+  char hex[SQLSHA1_BYTES * 2];
+  for (size_t i = 0; i < SQLSHA1_BYTES; i++) {
+    hex[i * 2] = hex_digits[hash[i] >> 4];
+    hex[i * 2 + 1] = hex_digits[hash[i] & 0x0f];
+  }
+  node->sqlsha1.assign(hex, sizeof(hex));
+}
 
-  /* Get normalized SQL text (literals replaced with ?) */
-  String digest_text;
-  compute_digest_text(digest, &digest_text);
-  if (digest_text.length() == 0) return;
+/* ---- Audit result cache ---- */
 
-  /* Compute SHA1 hash */
-  uint8 hash[SHA1_HASH_SIZE];
-  compute_sha1_hash(hash, digest_text.ptr(), digest_text.length());
+/**
+ * What the rules of one statement reported and set on its node, and what
+ * it added to the batch tracking of its session, for a later session that
+ * audits the same statement under the same settings.
+ */
+struct CachedAudit {
+  int errlevel = ERRLEVEL_OK;
+  std::string errmsg;
+  int findings = 0;
+  int64_t affected_rows = 0;
+  int64_t table_bytes = -1;
+  int64_t binlog_row_bytes = -1;
+  std::string db_name, table_name;
+  std::string sub_type, ddl_algorithm, exec_strategy, estimated_time,
+      locks_writes;
+  bool osc_capable = false;
+  bool online_clause = false;
+  std::vector<std::pair<std::string, std::set<std::string>>> batch_tables;
+  std::vector<std::string> batch_databases;
+  std::vector<std::string> altered_tables;
+
+  /* Valid while the target's schema epoch is unchanged, then for
+     inception_metadata_cache_ttl seconds unless the binlog watcher
+     streamed when it was audited */
+  bool watched = false;
+  uint64_t epoch = 0;
+  std::chrono::steady_clock::time_point loaded_at;
+};
 
-  /* Convert to 40-char hex string */
-  char hex[SHA1_HASH_SIZE * 2 + 1];
-  for (int i = 0; i < SHA1_HASH_SIZE; i++)
-    snprintf(hex + i * 2, 3, "%02x", hash[i]);
-  node->sqlsha1 = hex;
-}
+using CachedAuditPtr = std::shared_ptr<const CachedAudit>;
+using AuditCacheList = std::list<std::pair<std::string, CachedAuditPtr>>;
+
+static InceptionMutex g_audit_cache_mutex("audit_cache");
+static AuditCacheList g_audit_cache;  /* most recently used first */
+static std::unordered_map<std::string, AuditCacheList::iterator>
+    g_audit_cache_index;
+
+/** A statement looked up in the cache; key is empty if it may not be. */
+struct AuditCacheLookup {
+  std::string key;
+  uint64_t epoch = 0;
+  bool watched = false;
+  /* "db.table" of the statement's tables, the database it creates or
+     drops, and the sizes of the batch tracking before its audit */
+  std::vector<std::string> tables;
+  std::string database;
+  size_t batch_tables = 0, batch_databases = 0, altered_tables = 0;
+};
 
-/* ---- Main entry ---- */
+/** The session settings the rules read besides the statement and target. */
+static const std::string &audit_cache_env(InceptionContext *ctx) {
+  if (ctx->audit_cache_env.empty()) {
+    std::string text = rule_plan_fingerprint(ctx->rules);
+    char buf[96];
+    snprintf(buf, sizeof(buf), "|%d|%d|%u.%u.%u|%d|%lu",
+             static_cast<int>(ctx->mode), static_cast<int>(ctx->db_type),
+             ctx->db_version_major, ctx->db_version_minor,
+             ctx->db_version_patch, ctx->merge_alter ? 1 : 0,
+             static_cast<ulong>(ctx->sleep_ms));
+    text += buf;
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA_EVP256(reinterpret_cast<const unsigned char *>(text.data()),
+               text.size(), hash);
+    ctx->audit_cache_env.assign(reinterpret_cast<const char *>(hash),
+                                sizeof(hash));
+  }
+  return ctx->audit_cache_env;
+}
 
-bool audit_statement(THD *thd, SqlCacheNode *node, InceptionContext *ctx) {
+/**
+ * Whether the audit of the statement may come from the cache: a connected
+ * target, no --schema-file, and none of its tables touched by an earlier
+ * statement of the batch, so that what the rules see depends only on the
+ * statement, the target and the settings. Fills lookup.
+ */
+static bool audit_cacheable(THD *thd, SqlCacheNode *node,
+                            InceptionContext *ctx, AuditCacheLookup *lookup) {
   LEX *lex = thd->lex;
+  if (opt_audit_cache_size == 0 || !ctx->remote_conn ||
+      ctx->remote_conn_failed || ctx->shadow || !node->errmsg.empty())
+    return false;
+  /* Nothing to reuse, and merged ALTERs depend on the ALTER before */
+  if (lex->sql_command == SQLCOM_CHANGE_DB ||
+      lex->sql_command == SQLCOM_SET_OPTION ||
+      (lex->sql_command == SQLCOM_ALTER_TABLE && ctx->merge_alter))
+    return false;
+  /* Results would expire at once */
+  bool watched = false;
+  const uint64_t epoch = cache_schema_epoch(cache_target(ctx), &watched);
+  if (!watched && opt_metadata_cache_ttl == 0) return false;
+
+  for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global) {
+    const char *db = tl->db ? tl->db : thd->db().str;
+    if (!db || !tl->table_name || tl->is_derived()) continue;
+    std::string key = batch_table_key(db, tl->table_name);
+    if (ctx->batch_tables.count(key) || ctx->altered_tables.count(key))
+      return false;
+    lookup->tables.push_back(std::move(key));
+  }
+  if ((lex->sql_command == SQLCOM_CREATE_DB ||
+       lex->sql_command == SQLCOM_DROP_DB) &&
+      lex->name.str) {
+    lookup->database = lex->name.str;
+    if (ctx->batch_databases.count(lookup->database)) return false;
+  }
+
+  const std::string &text = node->sql_text;
+  unsigned char hash[SHA256_DIGEST_LENGTH];
+  SHA_EVP256(reinterpret_cast<const unsigned char *>(text.data()), text.size(),
+             hash);
+  char live[96];
+  snprintf(live, sizeof(live), "|%d|%lu|%lu|%lu|%lu|%lu|", opt_osc_on ? 1 : 0,
+           opt_osc_min_table_rows, opt_osc_min_table_size, opt_osc_chunk_size,
+           opt_ddl_rebuild_speed, opt_exec_tidb_batch_min_rows);
+  lookup->key.assign(reinterpret_cast<const char *>(hash), sizeof(hash));
+  lookup->key += audit_cache_env(ctx);
+  lookup->key += live;
+  if (thd->db().str) lookup->key += thd->db().str;
+  lookup->key += '|';
+  lookup->key += cache_target(ctx);
+  lookup->epoch = epoch;
+  lookup->watched = watched;
+  lookup->batch_tables = ctx->batch_tables.size();
+  lookup->batch_databases = ctx->batch_databases.size();
+  lookup->altered_tables = ctx->altered_tables.size();
+  return true;
+}
 
-  node->stage = STAGE_CHECKED;
-  node->stage_status = "Audit completed";
+/**
+ * Look the statement up in the cache and, on a hit, set on node and ctx
+ * what its rules did when it was audited.
+ * @return true on a hit; false to audit it, with *lookup filled if the
+ *         result is to be stored.
+ */
+static bool audit_cache_replay(THD *thd, SqlCacheNode *node,
+                               InceptionContext *ctx,
+                               AuditCacheLookup *lookup) {
+  if (!audit_cacheable(thd, node, ctx, lookup)) {
+    lookup->key.clear();
+    return false;
+  }
 
-  /* Proactively test remote connection; warn on failure (once) */
-  if (!ctx->remote_conn && !ctx->remote_conn_failed) {
-    get_remote_conn(ctx);
+  CachedAuditPtr cached;
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<InceptionMutex> lock(g_audit_cache_mutex);
+    auto it = g_audit_cache_index.find(lookup->key);
+    if (it != g_audit_cache_index.end()) {
+      const CachedAudit &e = *it->second->second;
+      if (e.epoch == lookup->epoch &&
+          (e.watched || now - e.loaded_at < std::chrono::seconds(
+                                                opt_metadata_cache_ttl))) {
+        g_audit_cache.splice(g_audit_cache.begin(), g_audit_cache,
+                             it->second);
+        cached = it->second->second;
+      } else {
+        g_audit_cache.erase(it->second);
+        g_audit_cache_index.erase(it);
+      }
+    }
   }
-  if (ctx->remote_conn_failed) {
-    node->append_error(
-        "Cannot connect to remote server %s:%u (%s).",
-        ctx->host.c_str(), ctx->port, ctx->remote_conn_error.c_str());
+  if (!cached) {
+    status_add(STATUS_AUDIT_CACHE_MISSES);
+    return false;
   }
 
-  /* Fill table/db metadata */
-  TABLE_LIST *first_table = lex->query_block->get_table_list();
-  if (first_table) {
-    if (first_table->db) node->db_name = first_table->db;
-    if (first_table->table_name) node->table_name = first_table->table_name;
+  status_add(STATUS_AUDIT_CACHE_HITS);
+  ctx->audit_cache_hits++;
+  node->errlevel = std::max(node->errlevel, cached->errlevel);
+  node->errmsg = cached->errmsg;
+  node->findings += cached->findings;
+  node->affected_rows = cached->affected_rows;
+  node->table_bytes = cached->table_bytes;
+  node->binlog_row_bytes = cached->binlog_row_bytes;
+  node->db_name = cached->db_name;
+  node->table_name = cached->table_name;
+  node->sub_type = cached->sub_type;
+  node->ddl_algorithm = cached->ddl_algorithm;
+  node->exec_strategy = cached->exec_strategy;
+  node->estimated_time = cached->estimated_time;
+  node->locks_writes = cached->locks_writes;
+  node->osc_capable = cached->osc_capable;
+  node->online_clause = cached->online_clause;
+  for (const auto &table : cached->batch_tables)
+    ctx->batch_tables[table.first] = table.second;
+  ctx->batch_databases.insert(cached->batch_databases.begin(),
+                              cached->batch_databases.end());
+  ctx->altered_tables.insert(cached->altered_tables.begin(),
+                             cached->altered_tables.end());
+  /* What an ALTER outside --enable-merge-alter leaves of the run */
+  if (thd->lex->sql_command == SQLCOM_ALTER_TABLE)
+    ctx->alter_group = InceptionContext::AlterGroup();
+  return true;
+}
+
+/**
+ * Store what the rules just did for the statement of lookup. Skipped when
+ * the target failed meanwhile, or when the statement changed the batch
+ * tracking of another table than its own, which a replay could not redo.
+ */
+static void audit_cache_store(const SqlCacheNode *node, InceptionContext *ctx,
+                              const AuditCacheLookup &lookup) {
+  if (lookup.key.empty() || ctx->remote_conn_failed) return;
+
+  auto e = std::make_shared<CachedAudit>();
+  for (const std::string &key : lookup.tables) {
+    auto it = ctx->batch_tables.find(key);
+    if (it != ctx->batch_tables.end())
+      e->batch_tables.emplace_back(key, it->second);
+    if (ctx->altered_tables.count(key)) e->altered_tables.push_back(key);
+  }
+  if (!lookup.database.empty() && ctx->batch_databases.count(lookup.database))
+    e->batch_databases.push_back(lookup.database);
+  if (ctx->batch_tables.size() !=
+          lookup.batch_tables + e->batch_tables.size() ||
+      ctx->batch_databases.size() !=
+          lookup.batch_databases + e->batch_databases.size() ||
+      ctx->altered_tables.size() !=
+          lookup.altered_tables + e->altered_tables.size())
+    return;
+
+  e->errlevel = node->errlevel;
+  e->errmsg = node->errmsg;
+  e->findings = node->findings;
+  e->affected_rows = node->affected_rows;
+  e->table_bytes = node->table_bytes;
+  e->binlog_row_bytes = node->binlog_row_bytes;
+  e->db_name = node->db_name;
+  e->table_name = node->table_name;
+  e->sub_type = node->sub_type;
+  e->ddl_algorithm = node->ddl_algorithm;
+  e->exec_strategy = node->exec_strategy;
+  e->estimated_time = node->estimated_time;
+  e->locks_writes = node->locks_writes;
+  e->osc_capable = node->osc_capable;
+  e->online_clause = node->online_clause;
+  e->watched = lookup.watched;
+  e->epoch = lookup.epoch;
+  e->loaded_at = std::chrono::steady_clock::now();
+
+  std::lock_guard<InceptionMutex> lock(g_audit_cache_mutex);
+  auto it = g_audit_cache_index.find(lookup.key);
+  if (it != g_audit_cache_index.end()) {
+    /* Audited by another session meanwhile */
+    it->second->second = std::move(e);
+    g_audit_cache.splice(g_audit_cache.begin(), g_audit_cache, it->second);
+  } else {
+    g_audit_cache.emplace_front(lookup.key, std::move(e));
+    g_audit_cache_index[lookup.key] = g_audit_cache.begin();
+  }
+  while (g_audit_cache.size() > opt_audit_cache_size) {
+    g_audit_cache_index.erase(g_audit_cache.back().first);
+    g_audit_cache.pop_back();
   }
+}
+
+/* ---- Main entry ---- */
 
+/** The rules of the statement's type. */
+static void audit_by_command(THD *thd, SqlCacheNode *node,
+                             InceptionContext *ctx) {
+  LEX *lex = thd->lex;
   switch (lex->sql_command) {
     case SQLCOM_CREATE_DB:
       audit_create_db(thd, node, ctx);
@@ -2184,25 +3609,31 @@ bool audit_statement(THD *thd, SqlCacheNode *node, InceptionContext *ctx) {
     case SQLCOM_ALTER_TABLE:
       audit_alter_table(thd, node, ctx);
       break;
+    case SQLCOM_CREATE_INDEX:
+      audit_create_index(thd, node, ctx);
+      break;
     case SQLCOM_INSERT:
     case SQLCOM_INSERT_SELECT:
     case SQLCOM_REPLACE:
     case SQLCOM_REPLACE_SELECT:
-      audit_insert(thd, node, ctx);
+      audit_dml_shape(thd, node, ctx, audit_insert);
+      audit_dml_literals(thd, node, ctx);
       break;
     case SQLCOM_UPDATE:
     case SQLCOM_UPDATE_MULTI:
-      audit_update(thd, node, ctx);
+      audit_dml_shape(thd, node, ctx, audit_update);
+      audit_dml_literals(thd, node, ctx);
       break;
     case SQLCOM_DELETE:
     case SQLCOM_DELETE_MULTI:
-      audit_delete(thd, node, ctx);
+      audit_dml_shape(thd, node, ctx, audit_delete);
+      audit_dml_literals(thd, node, ctx);
       break;
     case SQLCOM_SELECT:
-      audit_select(thd, node);
+      audit_select(thd, node, ctx);
       break;
     case SQLCOM_DROP_TABLE:
-      audit_drop_table(thd, node);
+      audit_drop_table(thd, node, ctx);
       break;
     case SQLCOM_TRUNCATE:
       audit_truncate(thd, node, ctx);
@@ -2210,10 +3641,164 @@ bool audit_statement(THD *thd, SqlCacheNode *node, InceptionContext *ctx) {
     default:
       break;
   }
+}
+
+/**
+ * --enable-parallel: the tables of every TABLE_LIST of the statement
+ * (RENAME and CREATE ... LIKE list both sides), and whether a CREATE or
+ * ALTER TABLE adds or drops a foreign key, whose other table is not in
+ * the list.
+ */
+static void record_lane_tables(THD *thd, SqlCacheNode *node) {
+  LEX *lex = thd->lex;
+  for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global) {
+    const char *db = tl->db ? tl->db : thd->db().str;
+    if (!db || !tl->table_name || tl->is_derived()) continue;
+    std::string key = std::string(db) + "." + tl->table_name;
+    for (auto &c : key) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    if (std::find(node->tables.begin(), node->tables.end(), key) ==
+        node->tables.end())
+      node->tables.push_back(key);
+  }
+  if ((lex->sql_command == SQLCOM_CREATE_TABLE ||
+       lex->sql_command == SQLCOM_ALTER_TABLE) &&
+      lex->alter_info) {
+    if (lex->alter_info->flags & (Alter_info::ADD_FOREIGN_KEY |
+                                  Alter_info::DROP_FOREIGN_KEY))
+      node->fk_change = true;
+    for (const Key_spec *key : lex->alter_info->key_list)
+      if (key->type == KEYTYPE_FOREIGN) node->fk_change = true;
+  }
+}
+
+bool audit_statement(THD *thd, SqlCacheNode *node, InceptionContext *ctx) {
+  LEX *lex = thd->lex;
+  StageScope stage(stage_inception_audit);
+  AuditTiming timing(ctx, node);
+  StatementMetaScope statement_meta(ctx);
+  status_add(STATUS_STATEMENTS_AUDITED);
+
+  node->stage = STAGE_CHECKED;
+  node->stage_status = "Audit completed";
 
-  /* Compute SQL fingerprint after audit */
+  /* Proactively test remote connection; warn on failure (once) */
+  if (!ctx->remote_conn && !ctx->remote_conn_failed) {
+    get_remote_conn(ctx);
+  }
+  if (ctx->remote_conn_failed) {
+    node->append_error(
+        "Cannot connect to remote server %s:%u (%s).",
+        ctx->host.c_str(), ctx->port, ctx->remote_conn_error.c_str());
+  }
+
+  /* Load metadata of every remote table the statement references in one
+     round trip; the per-table checks below then hit the cache. Tables
+     created earlier in this batch are not on the remote yet. */
+  if (ctx->remote_conn) {
+    std::vector<SchemaTable> refs;
+    for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global) {
+      const char *db = tl->db ? tl->db : thd->db().str;
+      if (!db || !tl->table_name || tl->is_derived()) continue;
+      if (ctx->batch_tables.count(batch_table_key(db, tl->table_name))) continue;
+      refs.emplace_back(db, tl->table_name);
+    }
+    RuleScope scope(ctx, node, RULE_PRELOAD);
+    preload_table_meta(ctx, ctx->remote_conn, refs);
+  }
+
+  /* Fill table/db metadata */
+  TABLE_LIST *first_table = lex->query_block->get_table_list();
+  if (first_table) {
+    if (first_table->db) node->db_name = first_table->db;
+    if (first_table->table_name) node->table_name = first_table->table_name;
+  }
+
+  /* SQL fingerprint; also the audit memo key of DML */
   compute_sqlsha1(thd, node);
 
+  switch (lex->sql_command) {
+    case SQLCOM_INSERT:
+    case SQLCOM_INSERT_SELECT:
+    case SQLCOM_REPLACE:
+    case SQLCOM_REPLACE_SELECT:
+    case SQLCOM_UPDATE:
+    case SQLCOM_UPDATE_MULTI:
+    case SQLCOM_DELETE:
+    case SQLCOM_DELETE_MULTI:
+    case SQLCOM_SELECT:
+    case SQLCOM_CHANGE_DB:
+    case SQLCOM_SET_OPTION:
+      break;
+    default:
+      /* DDL and anything else may change what the memoized rules see */
+      ctx->audit_memo.clear();
+      ctx->audit_memo_index.clear();
+      break;
+  }
+
+  /* The rules of the statement type, or what they found for the same
+     statement in an earlier session (inception_audit_cache_size) */
+  AuditCacheLookup lookup;
+  if (!audit_cache_replay(thd, node, ctx, &lookup)) {
+    audit_by_command(thd, node, ctx);
+    audit_cache_store(node, ctx, lookup);
+  }
+
+  /* Rules of installed components, for this command only */
+  if (have_component_rules()) {
+    RuleScope scope(ctx, node, RULE_COMPONENT);
+    run_component_rules(thd, node, ctx);
+  }
+
+  /* --enable-chunked-dml: single-table UPDATE/DELETE without ORDER BY or
+     LIMIT can be executed as primary-key range chunks. */
+  if (ctx->chunked_dml && ctx->mode == OpMode::EXECUTE &&
+      (lex->sql_command == SQLCOM_UPDATE ||
+       lex->sql_command == SQLCOM_DELETE)) {
+    Query_block *qb = lex->query_block;
+    node->chunkable = qb->table_list.elements == 1 &&
+                      qb->order_list.elements == 0 && !qb->select_limit &&
+                      !node->db_name.empty() && !node->table_name.empty();
+  }
+
+  /* --enable-tidb-batch-dml: the same statements on TiDB, once EXPLAIN
+     estimates them past inception_exec_tidb_batch_min_rows, run in batches
+     instead of one transaction over the size limit. */
+  if (ctx->tidb_batch_dml && ctx->mode == OpMode::EXECUTE &&
+      ctx->db_type == DbType::TIDB &&
+      (lex->sql_command == SQLCOM_UPDATE ||
+       lex->sql_command == SQLCOM_DELETE)) {
+    Query_block *qb = lex->query_block;
+    node->tidb_batch =
+        qb->table_list.elements == 1 && qb->order_list.elements == 0 &&
+        !qb->select_limit && !node->db_name.empty() &&
+        !node->table_name.empty() &&
+        static_cast<uint64_t>(node->affected_rows) >=
+            opt_exec_tidb_batch_min_rows;
+    if (node->tidb_batch) node->chunkable = true;
+  }
+
+  /* Plain single-row INSERT ... VALUES: consecutive ones of the same shape
+     can be merged into one multi-row INSERT at execute time. */
+  if (ctx->mode == OpMode::EXECUTE && lex->sql_command == SQLCOM_INSERT &&
+      !lex->is_ignore()) {
+    auto *cmd = dynamic_cast<Sql_cmd_insert_base *>(lex->m_sql_cmd);
+    node->single_row_insert = cmd && cmd->insert_many_values.size() == 1 &&
+                              cmd->duplicates == DUP_ERROR &&
+                              cmd->update_field_list.empty();
+  }
+
+  /* --enable-parallel: what the statement touches decides its lane */
+  if (ctx->mode == OpMode::EXECUTE && ctx->parallel)
+    record_lane_tables(thd, node);
+
+  /* --schema-file: later statements see what this DDL did */
+  if (ctx->shadow && node->errlevel < ERRLEVEL_ERROR)
+    shadow_apply_ddl(thd, ctx);
+
+  /* The rules across statements run on it at commit */
+  record_batch_statement(thd, *node, ctx);
+
   return false;
 }
 
@@ -2,12 +2,20 @@
  * @file inception_audit.h
  * @brief SQL audit rule engine.
  *
- * Skeleton — audit rules will be added incrementally.
+ * The rules read their levels and limits from the session's RulePlan
+ * (ctx->rules), not from the sysvars.
  */
 
 #ifndef SQL_INCEPTION_AUDIT_H
 #define SQL_INCEPTION_AUDIT_H
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "field_types.h"    // enum_field_types
+#include "my_inttypes.h"    // ulong
 #include "include/mysql.h"  // MYSQL
 
 class THD;
@@ -17,6 +25,176 @@ namespace inception {
 struct SqlCacheNode;
 struct InceptionContext;
 
+/**
+ * A required column of inception_must_have_columns.
+ * Format: "name TYPE [UNSIGNED] [NOT NULL] [AUTO_INCREMENT] [COMMENT]".
+ */
+struct RequiredColumn {
+  std::string name;
+  enum_field_types sql_type = MYSQL_TYPE_NULL;  /* NULL = not specified */
+  bool need_unsigned = false;
+  bool need_not_null = false;
+  bool need_auto_increment = false;
+  bool need_comment = false;
+};
+
+/**
+ * The rule configuration of a session, compiled at magic_start: every
+ * level and limit as the sysvars were then, and the list variables parsed
+ * once instead of per statement. A SET GLOBAL takes effect from the next
+ * session, so one batch is audited under one configuration.
+ */
+struct RulePlan {
+  /* Audit rule level variables (0=OFF, 1=WARNING, 2=ERROR) */
+  ulong check_primary_key = 0;
+  ulong check_table_comment = 0;
+  ulong check_column_comment = 0;
+  ulong check_engine_innodb = 0;
+  ulong check_dml_where = 0;
+  ulong check_dml_limit = 0;
+  ulong check_insert_column = 0;
+  ulong check_select_star = 0;
+  ulong check_nullable = 0;
+  ulong check_foreign_key = 0;
+  ulong check_blob_type = 0;
+  ulong check_index_prefix = 0;
+  ulong check_enum_type = 0;
+  ulong check_set_type = 0;
+  ulong check_bit_type = 0;
+  ulong check_json_type = 0;
+  ulong check_json_blob_text_default = 0;
+  ulong check_create_select = 0;
+  ulong check_identifier = 0;
+  ulong check_not_null_default = 0;
+  ulong check_duplicate_index = 0;
+  ulong check_drop_database = 0;
+  ulong check_drop_table = 0;
+  ulong check_truncate_table = 0;
+  ulong check_delete = 0;
+  ulong check_autoincrement = 0;
+  ulong check_partition = 0;
+  ulong check_orderby_in_dml = 0;
+  ulong check_orderby_rand = 0;
+  ulong check_dml_full_scan = 0;
+  ulong check_dml_filesort = 0;
+  ulong check_dml_binlog_size = 0;
+  ulong check_autoincrement_init_value = 0;
+  ulong check_autoincrement_name = 0;
+  ulong check_timestamp_default = 0;
+  ulong check_column_charset = 0;
+  ulong check_column_default_value = 0;
+  ulong check_identifier_keyword = 0;
+  ulong check_merge_alter_table = 0;
+  ulong check_column_position_rebuild = 0;
+  ulong check_varchar_shrink = 0;
+  ulong check_lossy_type_change = 0;
+  ulong check_decimal_change = 0;
+  ulong check_column_data = 0;
+
+  /* TiDB-specific audit rule variables (0=OFF, 1=WARNING, 2=ERROR) */
+  ulong check_tidb_merge_alter = 0;
+  ulong check_tidb_varchar_shrink = 0;
+  ulong check_tidb_decimal_change = 0;
+  ulong check_tidb_lossy_type_change = 0;
+  ulong check_tidb_foreign_key = 0;
+
+  /* Index length audit rule (0=OFF, 1=WARNING, 2=ERROR) */
+  ulong check_index_length = 0;
+
+  /* INSERT/UPDATE validation rules (0=OFF, 1=WARNING, 2=ERROR) */
+  ulong check_insert_values_match = 0;
+  ulong check_insert_duplicate_column = 0;
+  ulong check_column_exists = 0;
+  ulong check_must_have_columns = 0;
+
+  /* Numeric limit variables (also checks) */
+  ulong check_max_indexes = 0;
+  ulong check_max_index_parts = 0;
+  ulong check_max_update_rows = 0;
+  ulong check_explain_min_rows = 0;
+  ulong check_max_dml_binlog_size = 0;
+  ulong check_max_char_length = 0;
+  ulong check_max_primary_key_parts = 0;
+  ulong check_max_table_name_length = 0;
+  ulong check_max_column_name_length = 0;
+  ulong check_max_columns = 0;
+  ulong check_index_column_max_bytes = 0;
+  ulong check_index_total_max_bytes = 0;
+  ulong check_in_count = 0;
+  /* inception_support_charset, split at ',' (empty = any charset) */
+  std::string support_charset;
+  std::vector<std::string> support_charsets;
+
+  /* inception_must_have_columns; empty when check_must_have_columns is off */
+  std::vector<RequiredColumn> must_have_columns;
+
+  /* Any per-column rule of check_column() is on */
+  bool column_rules = false;
+};
+
+/** Snapshot the rule sysvars into *plan. */
+void compile_rule_plan(RulePlan *plan);
+
+/**
+ * Split an inception_must_have_columns value into its column definitions,
+ * separated by ';'. Every keyword present in a definition becomes a
+ * requirement; an absent keyword is not checked.
+ */
+std::vector<RequiredColumn> parse_must_have_columns(const char *p);
+
+/** Set plan's inception_support_charset list to list (nullptr = any). */
+void set_support_charset(RulePlan *plan, const char *list);
+
+/** Recompute plan->column_rules after its levels changed. */
+void update_column_rules(RulePlan *plan);
+
+/**
+ * The units of the audit that are timed: the rules of one statement type,
+ * the per-column and per-index rule passes, and the metadata lookups and
+ * EXPLAINs they make. Time, remote queries and violations of a nested unit
+ * are not counted again in the enclosing one.
+ */
+enum AuditRule {
+  RULE_PRELOAD,            /* batch metadata load of a statement's tables */
+  RULE_METADATA,           /* existence / column / index / row lookups */
+  RULE_EXPLAIN,            /* EXPLAIN row estimates */
+  RULE_CREATE_DATABASE,
+  RULE_DROP_DATABASE,
+  RULE_CREATE_TABLE,
+  RULE_COLUMN,             /* one column of CREATE / ALTER TABLE */
+  RULE_INDEX,              /* one index of CREATE / ALTER TABLE */
+  RULE_MUST_HAVE_COLUMNS,
+  RULE_ALTER_TABLE,
+  RULE_INSERT,
+  RULE_UPDATE,
+  RULE_DELETE,
+  RULE_SELECT,
+  RULE_DROP_TABLE,
+  RULE_TRUNCATE,
+  RULE_DML_LITERALS,       /* VALUES / IN list rules of DML */
+  RULE_COMPONENT,          /* rules registered by components */
+  RULE_COUNT
+};
+
+/** Name of an AuditRule in "inception show rule_stats" and the audit log. */
+const char *audit_rule_name(int rule);
+
+/** Counters of one AuditRule. */
+struct RuleStat {
+  uint64_t calls = 0;
+  uint64_t time_ns = 0;
+  uint64_t remote_queries = 0;
+  uint64_t violations = 0;  /* errors and warnings reported */
+};
+
+using RuleStats = std::array<RuleStat, RULE_COUNT>;
+
+/** Add a finished session's counters to the server-wide ones. */
+void rule_stats_merge(const RuleStats &stats);
+
+/** Server-wide counters since startup, for "inception show rule_stats". */
+RuleStats get_rule_stats();
+
 /**
  * Audit a single parsed SQL statement against inception rules.
  * Populates node->errlevel and node->errmsg.
@@ -36,9 +214,32 @@ bool audit_statement(THD *thd, SqlCacheNode *node, InceptionContext *ctx);
 MYSQL *get_remote_conn(InceptionContext *ctx);
 
 /**
- * Compute SQL fingerprint (SHA1 of normalized SQL text).
- * Uses MySQL's digest infrastructure to normalize literals to '?'.
- * Populates node->sqlsha1 with a 40-char hex string.
+ * Start opening the remote connection in a background thread, so that
+ * TCP, TLS and authentication overlap with the client sending the batch.
+ * get_remote_conn() waits for it. Owning thread only.
+ */
+void connect_remote_async(InceptionContext *ctx);
+
+/**
+ * Connection for read-only audit queries (metadata loads, EXPLAIN): the
+ * --audit-host replica of ctx, or primary (the get_remote_conn() handle)
+ * when none is set or it is not usable. Callers that read nothing or an
+ * error from the replica ask primary again: it may not have caught up.
+ */
+MYSQL *get_audit_conn(InceptionContext *ctx, MYSQL *primary);
+
+/**
+ * Whether the server behind mysql may answer audit queries for
+ * --audit-host: a replica at most inception_audit_host_max_lag seconds
+ * behind, or any server when that is 0. Sets *why when not.
+ */
+bool audit_host_usable(MYSQL *mysql, std::string *why);
+
+/**
+ * Compute SQL fingerprint: the first 160 bits of the statement digest
+ * (SHA-256 of the parser token array, literals folded), which is the
+ * DIGEST of performance_schema. Populates node->sqlsha1 with a 40-char
+ * hex string.
  */
 void compute_sqlsha1(THD *thd, SqlCacheNode *node);
 
@@ -1,26 +1,846 @@
 /**
  * @file inception_backup.cc
- * @brief Backup and rollback SQL generation — skeleton implementation.
- *
- * TODO: Implement actual backup logic:
- *   1. For DDL (CREATE TABLE) -> generate DROP TABLE
- *   2. For DDL (ALTER TABLE)  -> generate reverse ALTER
- *   3. For DML -> capture binlog position before/after, parse binlog events,
- *      generate reverse INSERT/UPDATE/DELETE
- *   4. Store rollback SQL in backup database
+ * @brief Backup and rollback SQL generation from the remote binlog, or
+ *        from before images read ahead of the statement.
  */
 
 #include "sql/inception/inception_backup.h"
 
+#include "sql/inception/inception_audit.h"
+#include "sql/inception/inception_binlog.h"
 #include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_parse.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+#include "my_thread.h"  // my_thread_init, my_thread_end
 #include "sql/sql_class.h"
 
+#include <cctype>
+#include <cstdio>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
 namespace inception {
 
-bool generate_rollback(THD *thd [[maybe_unused]],
-                       InceptionContext *ctx [[maybe_unused]]) {
-  /* Skeleton: no-op */
+/* Rollback statements buffered before they are written with one
+   multi-row INSERT per backup table. */
+static constexpr size_t BACKUP_FLUSH_ROWS = 1000;
+static constexpr size_t BACKUP_FLUSH_BYTES = 4 * 1024 * 1024;
+
+/* Batches the decoder may run ahead of the backup writer. */
+static constexpr size_t BACKUP_WRITE_QUEUE = 4;
+
+bool is_backup_dml(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_INSERT:
+    case SQLCOM_INSERT_SELECT:
+    case SQLCOM_REPLACE:
+    case SQLCOM_REPLACE_SELECT:
+    case SQLCOM_UPDATE:
+    case SQLCOM_UPDATE_MULTI:
+    case SQLCOM_DELETE:
+    case SQLCOM_DELETE_MULTI:
+      return true;
+    default:
+      return false;
+  }
+}
+
+namespace {
+
+/** Backup table of one target table. Identifiers are quoted. */
+struct BackupTable {
+  std::string backup_db;
+  std::string backup_table;
+  std::string target;              /* `db`.`table` on the target */
+  std::vector<size_t> key;         /* primary key columns; empty = all */
+  std::vector<std::string> pending;  /* "('stmt', 'opid')" tuples */
+};
+
+/**
+ * Writes to the backup server run on their own thread, in submission
+ * order, so decoding the next batch overlaps the INSERT of the previous
+ * one. After the first failure the remaining statements are discarded.
+ */
+struct BackupWriter {
+  MYSQL *mysql = nullptr;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::pair<std::string, std::string>> queue;  /* what, sql */
+  bool done = false;
+  std::string error;
+  std::thread thread;
+};
+
+struct RollbackRun {
+  InceptionContext *ctx;
+  MYSQL *meta = nullptr;           /* target: information_schema lookups */
+  MYSQL *backup = nullptr;         /* backup server, owned by writer */
+  BackupWriter writer;
+  std::map<std::string, BackupTable> tables;  /* key: lower "db.table" */
+  std::set<std::string> created_dbs;
+  size_t pending_rows = 0;
+  size_t pending_bytes = 0;
+  int64_t rollback_rows = 0;
+  std::string error;
+};
+
+}  // namespace
+
+static void writer_main(BackupWriter *w) {
+  if (my_thread_init()) {
+    std::lock_guard<std::mutex> lock(w->mutex);
+    w->error = "Cannot initialize backup writer thread.";
+    w->queue.clear();
+    w->changed.notify_all();
+    return;
+  }
+  bind_worker_resource_group();
+  std::unique_lock<std::mutex> lock(w->mutex);
+  for (;;) {
+    w->changed.wait(lock, [w] { return w->done || !w->queue.empty(); });
+    if (w->queue.empty()) break;
+    auto item = std::move(w->queue.front());
+    w->queue.pop_front();
+    const bool skip = !w->error.empty();
+    lock.unlock();
+    std::string err;
+    bool failed = !skip && run_sql(w->mysql, item.second, &err);
+    lock.lock();
+    if (failed) w->error = item.first + ": " + err;
+    w->changed.notify_all();
+  }
+  lock.unlock();
+  my_thread_end();
+}
+
+/** Queue sql for the backup server; blocks while the writer is behind. */
+static bool submit(RollbackRun *run, std::string what, std::string sql) {
+  BackupWriter &w = run->writer;
+  std::unique_lock<std::mutex> lock(w.mutex);
+  w.changed.wait(lock, [&w] {
+    return !w.error.empty() || w.queue.size() < BACKUP_WRITE_QUEUE;
+  });
+  if (!w.error.empty()) {
+    run->error = w.error;
+    return true;
+  }
+  w.queue.emplace_back(std::move(what), std::move(sql));
+  w.changed.notify_all();
+  return false;
+}
+
+/** Wait for every queued write and stop the writer. */
+static bool finish_writer(RollbackRun *run) {
+  BackupWriter &w = run->writer;
+  {
+    std::lock_guard<std::mutex> lock(w.mutex);
+    w.done = true;
+    w.changed.notify_all();
+  }
+  w.thread.join();
+  if (w.error.empty()) return false;
+  if (run->error.empty()) run->error = w.error;
+  return true;
+}
+
+/** Escape a value for a single-quoted SQL string. */
+static std::string escape_string(const std::string &s) {
+  std::string out;
+  out.reserve(s.size() + 8);
+  for (char c : s) {
+    switch (c) {
+      case '\\': out += "\\\\"; break;
+      case '\'': out += "\\'"; break;
+      case '\0': out += "\\0"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\032': out += "\\Z"; break;
+      default: out += c;
+    }
+  }
+  return out;
+}
+
+static std::string lower(const std::string &s) {
+  std::string out = s;
+  for (auto &c : out) c = static_cast<char>(tolower(static_cast<uchar>(c)));
+  return out;
+}
+
+/** Backup schema of db on the target: "<host>_<port>_<db>". */
+static std::string backup_db_name(const InceptionContext *ctx,
+                                  const std::string &db) {
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  for (auto &c : host)
+    if (!isalnum(static_cast<uchar>(c))) c = '_';
+  return host + "_" + std::to_string(ctx->port) + "_" + db;
+}
+
+/** Create the backup schema of db and its information table, once. */
+static bool ensure_backup_db(RollbackRun *run, const std::string &db) {
+  std::string name = backup_db_name(run->ctx, db);
+  if (run->created_dbs.count(name)) return false;
+  std::string quoted = quote_ident(name);
+  std::string what = "Cannot create backup database " + name;
+  if (submit(run, what,
+             format_sql(remote_sql::CREATE_BACKUP_DB, quoted.c_str())) ||
+      submit(run, what,
+             format_sql(remote_sql::CREATE_BACKUP_INFO_TABLE, quoted.c_str())))
+    return true;
+  run->created_dbs.insert(name);
+  return false;
+}
+
+/** Backup table of a decoded table, created on first use. */
+static BackupTable *backup_table_for(RollbackRun *run, const BinlogTable &t) {
+  std::string key = lower(t.db) + "." + lower(t.table);
+  auto it = run->tables.find(key);
+  if (it != run->tables.end()) return &it->second;
+
+  if (ensure_backup_db(run, t.db)) return nullptr;
+  BackupTable bt;
+  bt.backup_db = quote_ident(backup_db_name(run->ctx, t.db));
+  bt.backup_table = quote_ident(t.table);
+  bt.target = quote_ident(t.db) + "." + quote_ident(t.table);
+
+  /* Match rows by primary key when there is one. */
+  char query[1024];
+  snprintf(query, sizeof(query), remote_sql::GET_PRIMARY_KEY, t.db.c_str(),
+           t.table.c_str());
+  if (mysql_real_query(run->meta, query,
+                       static_cast<unsigned long>(strlen(query)))) {
+    run->error = std::string("Cannot read primary key of ") + t.db + "." +
+                 t.table + ": " + mysql_error(run->meta);
+    return nullptr;
+  }
+  MYSQL_RES *res = mysql_store_result(run->meta);
+  if (res) {
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+      if (!row[0]) continue;
+      for (size_t i = 0; i < t.columns.size(); i++) {
+        if (strcasecmp(t.columns[i].name.c_str(), row[0]) == 0) {
+          bt.key.push_back(i);
+          break;
+        }
+      }
+    }
+    mysql_free_result(res);
+  }
+
+  if (submit(run, "Cannot create backup table for " + t.db + "." + t.table,
+             format_sql(remote_sql::CREATE_BACKUP_TABLE, bt.backup_db.c_str(),
+                        bt.backup_table.c_str())))
+    return nullptr;
+  return &(run->tables[key] = std::move(bt));
+}
+
+/** WHERE clause selecting the row image values. */
+static std::string row_condition(const BackupTable &bt, const BinlogTable &t,
+                                 const std::vector<std::string> &values) {
+  std::string where;
+  auto add = [&](size_t i) {
+    if (!where.empty()) where += " AND ";
+    where += quote_ident(t.columns[i].name);
+    where += values[i] == "NULL" ? " IS NULL" : " = " + values[i];
+  };
+  if (!bt.key.empty()) {
+    for (size_t i : bt.key) add(i);
+    return where;
+  }
+  for (size_t i = 0; i < t.columns.size(); i++)
+    if (!t.columns[i].generated) add(i);
+  return where + " LIMIT 1";
+}
+
+/** The statement that undoes one row change. */
+static std::string reverse_statement(const BackupTable &bt,
+                                     const RowChange &c) {
+  const BinlogTable &t = *c.table;
+  std::string sql;
+  switch (c.type) {
+    case RowChangeType::INSERT:
+      sql = "DELETE FROM " + bt.target + " WHERE " +
+            row_condition(bt, t, c.after);
+      break;
+    case RowChangeType::DELETE: {
+      std::string cols, vals;
+      for (size_t i = 0; i < t.columns.size(); i++) {
+        if (t.columns[i].generated) continue;
+        if (!cols.empty()) {
+          cols += ", ";
+          vals += ", ";
+        }
+        cols += quote_ident(t.columns[i].name);
+        vals += c.before[i];
+      }
+      sql = "INSERT INTO " + bt.target + " (" + cols + ") VALUES (" + vals +
+            ")";
+      break;
+    }
+    case RowChangeType::UPDATE: {
+      std::string set;
+      for (size_t i = 0; i < t.columns.size(); i++) {
+        if (t.columns[i].generated) continue;
+        if (!set.empty()) set += ", ";
+        set += quote_ident(t.columns[i].name) + " = " + c.before[i];
+      }
+      sql = "UPDATE " + bt.target + " SET " + set + " WHERE " +
+            row_condition(bt, t, c.after);
+      break;
+    }
+  }
+  return sql + ";";
+}
+
+/** Hand every buffered rollback statement to the writer. */
+static bool flush_pending(RollbackRun *run) {
+  for (auto &pair : run->tables) {
+    BackupTable &bt = pair.second;
+    if (bt.pending.empty()) continue;
+    std::string sql = format_sql(remote_sql::INSERT_BACKUP_ROWS,
+                                 bt.backup_db.c_str(), bt.backup_table.c_str());
+    for (size_t i = 0; i < bt.pending.size(); i++) {
+      if (i) sql += ", ";
+      sql += bt.pending[i];
+    }
+    bt.pending.clear();
+    if (submit(run, "Cannot write rollback statements", std::move(sql)))
+      return true;
+  }
+  run->pending_rows = 0;
+  run->pending_bytes = 0;
+  return false;
+}
+
+static bool add_change(RollbackRun *run, const RowChange &c,
+                       const std::string &opid) {
+  BackupTable *bt = backup_table_for(run, *c.table);
+  if (!bt) return true;
+  std::string tuple =
+      "('" + escape_string(reverse_statement(*bt, c)) + "', '" + opid + "')";
+  run->pending_bytes += tuple.size();
+  run->pending_rows++;
+  run->rollback_rows++;
+  bt->pending.push_back(std::move(tuple));
+  if (run->pending_rows >= BACKUP_FLUSH_ROWS ||
+      run->pending_bytes >= BACKUP_FLUSH_BYTES)
+    return flush_pending(run);
+  return false;
+}
+
+/** "'1718000000_12_3'" -> "1718000000_12_3" */
+static std::string opid_of(const SqlCacheNode &node) {
+  std::string opid = node.sequence;
+  if (opid.size() >= 2 && opid.front() == '\'' && opid.back() == '\'')
+    opid = opid.substr(1, opid.size() - 2);
+  return escape_string(opid);
+}
+
+static const char *backup_type(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_UPDATE:
+    case SQLCOM_UPDATE_MULTI:
+      return "UPDATE";
+    case SQLCOM_DELETE:
+    case SQLCOM_DELETE_MULTI:
+      return "DELETE";
+    default:
+      return "INSERT";
+  }
+}
+
+/** One REPLACE per backup database for the information rows of nodes. */
+static bool write_info(RollbackRun *run,
+                       const std::vector<SqlCacheNode *> &nodes) {
+  std::string host = run->ctx->host.empty() ? "127.0.0.1" : run->ctx->host;
+  std::map<std::string, std::string> rows;  /* backup db -> tuples */
+  for (auto *node : nodes) {
+    if (ensure_backup_db(run, node->db_name)) return true;
+    /* A node spilled by inception_max_session_memory has no text here */
+    std::string sql_text, errmsg;
+    if (run->ctx->read_node_text(*node, &sql_text, &errmsg)) {
+      run->error = "Cannot read the statement back from the spill file.";
+      return true;
+    }
+    std::string &tuples = rows[backup_db_name(run->ctx, node->db_name)];
+    if (!tuples.empty()) tuples += ", ";
+    tuples += format_sql(
+        remote_sql::BACKUP_INFO_ROW, opid_of(*node).c_str(),
+        escape_string(node->start_binlog_file).c_str(),
+        static_cast<unsigned long long>(node->start_binlog_pos),
+        escape_string(node->end_binlog_file).c_str(),
+        static_cast<unsigned long long>(node->end_binlog_pos),
+        escape_string(sql_text).c_str(), escape_string(host).c_str(),
+        escape_string(node->db_name).c_str(),
+        escape_string(node->table_name).c_str(), run->ctx->port,
+        backup_type(node->sql_command));
+  }
+  for (auto &pair : rows) {
+    if (submit(run, "Cannot write backup information",
+               format_sql(remote_sql::INSERT_BACKUP_INFO,
+                          quote_ident(pair.first).c_str()) +
+                   pair.second))
+      return true;
+  }
+  for (auto *node : nodes)
+    node->backup_dbname = backup_db_name(run->ctx, node->db_name);
+  return false;
+}
+
+/** Statements of one transaction (--txn-batch-size) share one window. */
+static bool same_window(const SqlCacheNode &a, const SqlCacheNode &b) {
+  return a.start_binlog_pos == b.start_binlog_pos &&
+         a.end_binlog_pos == b.end_binlog_pos &&
+         a.start_binlog_file == b.start_binlog_file &&
+         a.end_binlog_file == b.end_binlog_file;
+}
+
+/**
+ * Stream the binlog from the first statement's start to the last one's
+ * end and store the reverse of every row change the statements made.
+ * Within a shared window (a --txn-batch-size transaction or a merged
+ * INSERT), rows go to the statements in order, moving on once a statement
+ * has its affected_rows or at its last Rows event, whichever comes first.
+ * Memory is bounded by one event, the flush buffer and the writer queue.
+ */
+static bool backup_statements(RollbackRun *run,
+                              const std::vector<SqlCacheNode *> &nodes) {
+  InceptionContext *ctx = run->ctx;
+  std::set<unsigned long> threads;
+  for (const auto *n : nodes) threads.insert(n->exec_thread_id);
+
+  BinlogStream stream;
+  std::set<std::string> missing;
+  stream.set_resolver([&](const std::string &db, const std::string &table,
+                          std::vector<BinlogColumn> *columns) {
+    if (!threads.count(stream.thread_id())) return false;
+    std::string key = lower(db) + "." + lower(table);
+    if (missing.count(key)) return false;
+    std::string err;
+    if (load_binlog_columns(run->meta, db, table, columns, &err)) {
+      missing.insert(key);
+      return false;
+    }
+    return true;
+  });
+
+  BinlogPos start{nodes.front()->start_binlog_file,
+                  nodes.front()->start_binlog_pos};
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  std::string err;
+  if (stream.open(host, ctx->port, user, ctx->password, start, true, &err)) {
+    run->error = err;
+    return true;
+  }
+
+  size_t cur = 0;
+  size_t member = 0;        /* statement of nodes[cur]'s window being read */
+  int64_t member_rows = 0;  /* rows given to nodes[member] so far */
+  std::vector<RowChange> changes;
+  while (cur < nodes.size()) {
+    changes.clear();
+    BinlogRead r = stream.next(&changes, &err);
+    if (r == BinlogRead::ERROR) {
+      run->error = err;
+      return true;
+    }
+    if (r == BinlogRead::END) break;
+    if (changes.empty()) continue;
+
+    /* A row event lies strictly inside the window of its statement. */
+    const BinlogPos &pos = stream.position();
+    while (cur < nodes.size() &&
+           !binlog_pos_before(pos, BinlogPos{nodes[cur]->end_binlog_file,
+                                             nodes[cur]->end_binlog_pos})) {
+      cur++;
+      member = cur;
+      member_rows = 0;
+    }
+    if (cur == nodes.size()) break;
+    if (!binlog_pos_before(BinlogPos{nodes[cur]->start_binlog_file,
+                                     nodes[cur]->start_binlog_pos},
+                           pos))
+      continue;
+    if (changes.front().thread_id != nodes[cur]->exec_thread_id) continue;
+
+    auto has_next = [&] {
+      return member + 1 < nodes.size() &&
+             same_window(*nodes[member + 1], *nodes[cur]);
+    };
+    for (const auto &c : changes) {
+      while (has_next() && member_rows >= nodes[member]->affected_rows) {
+        member++;
+        member_rows = 0;
+      }
+      if (add_change(run, c, opid_of(*nodes[member]))) return true;
+      member_rows++;
+    }
+    if (stream.stmt_end() && has_next()) {
+      member++;
+      member_rows = 0;
+    }
+  }
+  return flush_pending(run) || write_info(run, nodes);
+}
+
+/** Connection to the server that stores the rollback statements. */
+static MYSQL *connect_backup(const InceptionContext *ctx, std::string *err) {
+  const bool separate = opt_backup_host && opt_backup_host[0] != '\0';
+  std::string host = separate ? opt_backup_host
+                              : (ctx->host.empty() ? "127.0.0.1" : ctx->host);
+  uint port = separate ? static_cast<uint>(opt_backup_port) : ctx->port;
+  std::string user = separate ? (opt_backup_user ? opt_backup_user : "")
+                              : ctx->user;
+  if (user.empty()) user = "root";
+  std::string password =
+      separate ? decrypt_password(opt_backup_password ? opt_backup_password
+                                                      : "")
+               : ctx->password;
+  PoolConnOptions opts;
+  opts.connect_timeout = 10;
+  opts.read_timeout = 600;
+  opts.write_timeout = 600;
+  std::string client_err;
+  MYSQL *mysql = pool_acquire(host, port, user, password, opts, &client_err);
+  if (!mysql)
+    *err = "Cannot connect to backup server " + host + ":" +
+           std::to_string(port) + ": " + client_err;
+  return mysql;
+}
+
+/** Weight of a statement in the rows of a range: its changed rows + 1. */
+static uint64_t row_weight(const SqlCacheNode *n) {
+  return static_cast<uint64_t>(std::max<int64_t>(n->affected_rows, 0)) + 1;
+}
+
+/**
+ * Back up one contiguous range of statements with its own binlog stream,
+ * metadata connection and backup connection, so ranges can run in
+ * parallel. Sets run->error on failure. The time it took goes to the
+ * backup_us of its statements by their row_weight(), as one stream reads
+ * the rows of all of them.
+ */
+static void backup_range(RollbackRun *run,
+                         const std::vector<SqlCacheNode *> &nodes) {
+  InceptionContext *ctx = run->ctx;
+  const auto start = std::chrono::steady_clock::now();
+  PoolConnOptions opts;
+  opts.connect_timeout = 5;
+  std::string err;
+  run->meta = pool_acquire(ctx->host.empty() ? "127.0.0.1" : ctx->host,
+                           ctx->port, ctx->user.empty() ? "root" : ctx->user,
+                           ctx->password, opts, &err);
+  if (!run->meta)
+    run->error = "Cannot connect to the remote server: " + err;
+  else if ((run->backup = connect_backup(ctx, &run->error))) {
+    run->writer.mysql = run->backup;
+    run->writer.thread = std::thread(writer_main, &run->writer);
+    backup_statements(run, nodes);
+    finish_writer(run);
+  }
+  if (run->backup) pool_release(run->backup, PoolRelease::CLEAN);
+  if (run->meta) pool_release(run->meta, PoolRelease::CLEAN);
+  run->backup = run->meta = nullptr;
+
+  const uint64_t us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  uint64_t total = 0;
+  for (const auto *n : nodes) total += row_weight(n);
+  for (auto *n : nodes)
+    n->backup_us += static_cast<uint64_t>(static_cast<double>(us) *
+                                          row_weight(n) / total);
+}
+
+/**
+ * Split nodes into at most parts contiguous ranges of about the same
+ * number of changed rows. Every statement (and every transaction) stays
+ * whole inside one range, so its rollback statements keep their order.
+ */
+static std::vector<std::vector<SqlCacheNode *>> split_ranges(
+    const std::vector<SqlCacheNode *> &nodes, size_t parts) {
+  uint64_t total = 0;
+  for (const auto *n : nodes) total += row_weight(n);
+  const uint64_t target = (total + parts - 1) / parts;
+
+  std::vector<std::vector<SqlCacheNode *>> ranges(1);
+  uint64_t weight = 0;
+  for (auto *n : nodes) {
+    if (weight >= target && ranges.size() < parts &&
+        !same_window(*ranges.back().back(), *n)) {
+      ranges.emplace_back();
+      weight = 0;
+    }
+    ranges.back().push_back(n);
+    weight += row_weight(n);
+  }
+  return ranges;
+}
+
+/* ---- Before images (inception_backup_strategy=SELECT) ---- */
+
+struct ImageRun {
+  RollbackRun rollback;
+  SqlCacheNode *node = nullptr;
+  BinlogTable table;
+  bool writing = false;  /* writer thread started, not yet finished */
+};
+
+/** A selected value as a SQL literal, in the binlog decoder's forms. */
+static std::string image_literal(const MYSQL_FIELD &f, const char *v,
+                                 unsigned long len) {
+  if (!v) return "NULL";
+  if (IS_NUM(f.type)) return std::string(v, len);
+  bool binary = f.charsetnr == 63;
+  switch (f.type) {
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_TIME:
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_NEWDATE:
+      binary = false;
+      break;
+    default:
+      break;
+  }
+  if (!binary) return "'" + escape_string(std::string(v, len)) + "'";
+  if (len == 0) return "''";
+  static const char hex_digits[] = "0123456789ABCDEF";
+  std::string out = "0x";
+  out.reserve(2 + 2 * len);
+  for (unsigned long i = 0; i < len; i++) {
+    const uchar c = static_cast<uchar>(v[i]);
+    out += hex_digits[c >> 4];
+    out += hex_digits[c & 0x0f];
+  }
+  return out;
+}
+
+BeforeImages::BeforeImages(InceptionContext *ctx, SqlCacheNode *node)
+    : m_run(new ImageRun) {
+  m_run->rollback.ctx = ctx;
+  m_run->node = node;
+}
+
+BeforeImages::~BeforeImages() {
+  RollbackRun &run = m_run->rollback;
+  if (m_run->writing) finish_writer(&run);
+  if (run.backup) pool_release(run.backup, PoolRelease::CLEAN);
+}
+
+bool BeforeImages::capture(MYSQL *mysql, const std::string &pk_name,
+                           const std::string &cond,
+                           const std::function<bool()> &pause,
+                           std::string *err) {
+  RollbackRun *run = &m_run->rollback;
+  const SqlCacheNode &node = *m_run->node;
+  BinlogTable &t = m_run->table;
+  t.db = node.db_name;
+  t.table = node.table_name;
+  if (load_binlog_columns(mysql, t.db, t.table, &t.columns, err)) return true;
+  if (!(run->backup = connect_backup(run->ctx, err))) return true;
+  run->meta = mysql;  /* in the open transaction, between chunks only */
+  run->writer.mysql = run->backup;
+  run->writer.thread = std::thread(writer_main, &run->writer);
+  m_run->writing = true;
+  if (!backup_table_for(run, t)) {
+    *err = run->error;
+    return true;
+  }
+
+  std::string columns;
+  size_t key = t.columns.size();
+  for (size_t i = 0; i < t.columns.size(); i++) {
+    if (i) columns += ", ";
+    columns += quote_ident(t.columns[i].name);
+    if (strcasecmp(t.columns[i].name.c_str(), pk_name.c_str()) == 0) key = i;
+  }
+  if (key == t.columns.size()) {
+    *err = "primary key " + pk_name + " is not a column of " + t.db + "." +
+           t.table;
+    return true;
+  }
+  const std::string db = quote_ident(t.db);
+  const std::string table = quote_ident(t.table);
+  const std::string pk = quote_ident(pk_name);
+  /* Newline before ')' in case the condition ends in a -- comment */
+  const std::string where =
+      cond.empty() ? "WHERE " : "WHERE (" + cond + "\n) AND ";
+  const std::string opid = opid_of(node);
+  const unsigned long chunk_rows = opt_backup_select_chunk_size;
+
+  std::string last;
+  RowChange c;
+  c.type = node.sql_command == SQLCOM_DELETE ? RowChangeType::DELETE
+                                             : RowChangeType::UPDATE;
+  c.table = &t;
+  c.thread_id = 0;
+  for (;;) {
+    const std::string query =
+        last.empty()
+            ? format_sql(remote_sql::IMAGE_FIRST_CHUNK, columns.c_str(),
+                         db.c_str(), table.c_str(), where.c_str(), pk.c_str(),
+                         chunk_rows)
+            : format_sql(remote_sql::IMAGE_NEXT_CHUNK, columns.c_str(),
+                         db.c_str(), table.c_str(), where.c_str(), pk.c_str(),
+                         last.c_str(), pk.c_str(), chunk_rows);
+    if (mysql_real_query(mysql, query.c_str(),
+                         static_cast<unsigned long>(query.size()))) {
+      *err = std::string("cannot read before images: ") + mysql_error(mysql);
+      return true;
+    }
+    /* One chunk, bounded by inception_backup_select_chunk_size */
+    MYSQL_RES *res = mysql_store_result(mysql);
+    if (!res) {
+      *err = std::string("cannot read before images: ") + mysql_error(mysql);
+      return true;
+    }
+    const MYSQL_FIELD *fields = mysql_fetch_fields(res);
+    const unsigned int nfields = mysql_num_fields(res);
+    unsigned long rows = 0;
+    bool failed = false;
+    MYSQL_ROW row;
+    while (!failed && (row = mysql_fetch_row(res))) {
+      const unsigned long *lengths = mysql_fetch_lengths(res);
+      c.before.clear();
+      for (unsigned int i = 0; i < nfields; i++)
+        c.before.push_back(image_literal(fields[i], row[i], lengths[i]));
+      c.after = c.before;  /* the key an UPDATE leaves alone */
+      last = c.before[key];
+      rows++;
+      failed = add_change(run, c, opid);
+    }
+    mysql_free_result(res);
+    /* One multi-row INSERT per chunk */
+    if (failed || flush_pending(run)) {
+      *err = run->error;
+      return true;
+    }
+    if (rows < chunk_rows) return false;
+    if (pause()) {
+      *err = "the session was killed while reading before images.";
+      return true;
+    }
+  }
+}
+
+int64_t BeforeImages::rows() const { return m_run->rollback.rollback_rows; }
+
+bool BeforeImages::keep(std::string *err) {
+  RollbackRun *run = &m_run->rollback;
+  bool failed = write_info(run, {m_run->node});
+  m_run->writing = false;
+  failed = finish_writer(run) || failed;
+  if (failed) {
+    m_run->node->backup_dbname.clear();
+    *err = run->error;
+    return true;
+  }
+  m_run->node->before_images = true;
   return false;
 }
 
+void BeforeImages::drop() {
+  RollbackRun *run = &m_run->rollback;
+  if (!m_run->writing) return;
+  for (auto &pair : run->tables) {
+    BackupTable &bt = pair.second;
+    bt.pending.clear();
+    submit(run, "Cannot delete before images",
+           format_sql(remote_sql::DELETE_BACKUP_ROWS, bt.backup_db.c_str(),
+                      bt.backup_table.c_str(),
+                      opid_of(*m_run->node).c_str()));
+  }
+  m_run->writing = false;
+  finish_writer(run);
+}
+
+bool generate_rollback(THD *thd [[maybe_unused]], InceptionContext *ctx) {
+  /* TiDB has no MySQL binlog to read rows from */
+  if (ctx->db_type == DbType::TIDB) return false;
+
+  std::vector<SqlCacheNode *> nodes;
+  for (auto &node : ctx->cache_nodes) {
+    if (node.stage != STAGE_EXECUTED || !is_backup_dml(node.sql_command) ||
+        node.before_images)
+      continue;
+    if (node.start_binlog_file.empty() ||
+        !binlog_pos_before(
+            BinlogPos{node.start_binlog_file, node.start_binlog_pos},
+            BinlogPos{node.end_binlog_file, node.end_binlog_pos})) {
+      if (node.affected_rows > 0 && node.start_binlog_file.empty())
+        node.append_warning("Backup skipped: binlog position of the "
+                            "statement is not available.");
+      continue;  /* nothing was written */
+    }
+    nodes.push_back(&node);
+  }
+  if (nodes.empty()) return false;
+
+  std::string err;
+  MYSQL *mysql = get_remote_conn(ctx);
+  if (!mysql)
+    err = "Cannot connect to the remote server.";
+  else
+    check_binlog_settings(mysql, &err);
+  if (!err.empty()) {
+    for (auto *node : nodes)
+      node->append_warning("Backup failed: %s", err.c_str());
+    return true;
+  }
+
+  /* One binlog stream per range; the first range runs on this thread. */
+  auto ranges = split_ranges(
+      nodes, std::min<size_t>(nodes.size(), std::max<ulong>(opt_backup_threads,
+                                                            1)));
+  std::vector<RollbackRun> runs(ranges.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    runs[i].ctx = ctx;
+    if (i == 0) continue;
+    workers.emplace_back([&runs, &ranges, i] {
+      if (my_thread_init()) {
+        runs[i].error = "Cannot initialize backup thread.";
+        return;
+      }
+      bind_worker_resource_group();
+      backup_range(&runs[i], ranges[i]);
+      my_thread_end();
+    });
+  }
+  backup_range(&runs[0], ranges[0]);
+  for (auto &w : workers) w.join();
+
+  bool failed = false;
+  int64_t rollback_rows = 0;
+  for (size_t i = 0; i < ranges.size(); i++) {
+    rollback_rows += runs[i].rollback_rows;
+    if (runs[i].error.empty()) continue;
+    failed = true;
+    for (auto *node : ranges[i]) {
+      node->backup_dbname.clear();
+      node->append_warning("Backup failed: %s", runs[i].error.c_str());
+    }
+  }
+  fprintf(stderr, "[Inception] Backup: %s, %lld rollback statements for %zu "
+          "statements in %zu ranges.\n", failed ? "failed" : "done",
+          static_cast<long long>(rollback_rows), nodes.size(), ranges.size());
+  fflush(stderr);
+  return failed;
+}
+
 }  // namespace inception
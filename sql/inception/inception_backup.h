@@ -1,28 +1,95 @@
 /**
  * @file inception_backup.h
  * @brief Backup and rollback SQL generation.
+ *
+ * EXECUTE mode records the binlog position before and after every DML
+ * statement. After the batch, the target's binlog is streamed over that
+ * window, the row events written by inception's own remote session are
+ * decoded and one reverse statement per row (DELETE for INSERT, INSERT for
+ * DELETE, UPDATE back to the before image) is stored on the backup server:
+ *
+ *   <host>_<port>_<db>.`$_$Inception_backup_information$_$`  one row per
+ *                                                           statement
+ *   <host>_<port>_<db>.<table>         rollback_statement, opid_time
+ *
+ * Rolling back a statement means running its rollback_statement rows in
+ * descending id order.
+ *
+ * With inception_backup_strategy=SELECT, for targets whose binlog cannot
+ * be read, a single-table UPDATE/DELETE runs in its own transaction after
+ * BeforeImages read the rows it will change (SELECT ... FOR UPDATE with
+ * the statement's WHERE, in primary key chunks) and queued one reverse
+ * statement per row for the same tables.
  */
 
 #ifndef SQL_INCEPTION_BACKUP_H
 #define SQL_INCEPTION_BACKUP_H
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "include/mysql.h"  // MYSQL
+#include "my_sqlcommand.h"  // enum_sql_command
+
 class THD;
 
 namespace inception {
 
 struct InceptionContext;
+struct SqlCacheNode;
+struct ImageRun;
+
+/** INSERT/REPLACE/UPDATE/DELETE (and their multi-table forms). */
+bool is_backup_dml(enum_sql_command cmd);
 
 /**
- * Generate rollback SQL for executed statements.
- * For DDL: generate reverse DDL (e.g. DROP TABLE for CREATE TABLE).
- * For DML: parse remote binlog to generate reverse SQL.
- *
- * Skeleton — actual backup logic to be implemented.
+ * Generate rollback SQL for the DML statements executed in this batch and
+ * store it in the backup database. Problems are reported as warnings on
+ * the affected statements; they never undo the execution.
  *
  * @return false on success, true on error.
  */
 bool generate_rollback(THD *thd, InceptionContext *ctx);
 
+/**
+ * The before images of one UPDATE/DELETE (inception_backup_strategy=
+ * SELECT). The caller opens the transaction, calls capture(), runs the
+ * statement and then keep()s the images if it committed or drop()s them.
+ * Writes to the backup server go through a writer thread of their own,
+ * with one multi-row INSERT per chunk.
+ */
+class BeforeImages {
+ public:
+  BeforeImages(InceptionContext *ctx, SqlCacheNode *node);
+  ~BeforeImages();
+
+  /**
+   * Read the rows of node's table matching cond (its WHERE, empty for
+   * none) in order of the single integer primary key pk_name, with
+   * "SELECT ... FOR UPDATE" on mysql, inception_backup_select_chunk_size
+   * rows at a time. pause runs between chunks; it returns true to stop.
+   *
+   * @return false on success, true on error (*err set).
+   */
+  bool capture(MYSQL *mysql, const std::string &pk_name,
+               const std::string &cond, const std::function<bool()> &pause,
+               std::string *err);
+
+  /** Before images read so far. */
+  int64_t rows() const;
+
+  /** The statement committed: write its information row; true on error. */
+  bool keep(std::string *err);
+
+  /** The statement did not commit: delete the images written so far. */
+  void drop();
+
+ private:
+  std::unique_ptr<ImageRun> m_run;
+};
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_BACKUP_H
@@ -0,0 +1,336 @@
+/**
+ * @file inception_batch.cc
+ * @brief Commit-time analysis of the whole batch.
+ */
+
+#include "sql/inception/inception_batch.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_shadow.h"  // index_info
+#include "sql/create_field.h"  // Create_field
+#include "sql/key_spec.h"      // Key_spec
+#include "sql/sql_alter.h"     // Alter_info
+#include "sql/sql_class.h"     // THD
+#include "sql/sql_lex.h"       // LEX
+#include "sql/sql_list.h"      // List_iterator
+#include "sql/table.h"         // TABLE_LIST
+
+#include <strings.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace inception {
+
+static std::string lower(const char *s) {
+  std::string r(s ? s : "");
+  for (auto &c : r) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return r;
+}
+
+uint32_t BatchIR::table_id(const std::string &key) {
+  auto it = table_ids.emplace(lower(key.c_str()),
+                              static_cast<uint32_t>(tables.size()));
+  if (it.second) tables.push_back(key);
+  return it.first->second;
+}
+
+/* The name MySQL gives key: PRIMARY, its own or its first column */
+static std::string key_name(const Key_spec &key) {
+  if (key.type == KEYTYPE_PRIMARY) return "PRIMARY";
+  if (key.name.str && key.name.length) return key.name.str;
+  if (!key.columns.empty() && key.columns[0]->get_field_name())
+    return key.columns[0]->get_field_name();
+  return std::string();
+}
+
+static void add_keys(const Alter_info &alter_info, BatchRecord *rec) {
+  for (const Key_spec *key : alter_info.key_list) {
+    if (key->type == KEYTYPE_FOREIGN) continue;
+    rec->added.emplace_back(key_name(*key), index_info(*key));
+  }
+}
+
+/* The drop, column and rename clauses of an ALTER TABLE / CREATE INDEX /
+   DROP INDEX */
+static void alter_clauses(const Alter_info &alter_info, BatchRecord *rec) {
+  for (const auto *drop : alter_info.drop_list) {
+    if (drop->type == Alter_drop::KEY)
+      rec->dropped_indexes.push_back(lower(drop->name));
+    else if (drop->type == Alter_drop::COLUMN)
+      rec->dropped_columns.push_back(lower(drop->name));
+  }
+  /* A renamed column leaves the indexes on its old name */
+  List_iterator<Create_field> it(const_cast<List<Create_field> &>(
+      alter_info.create_list));
+  Create_field *field;
+  while ((field = it++))
+    if (field->change && strcasecmp(field->change, field->field_name) != 0)
+      rec->dropped_columns.push_back(lower(field->change));
+  for (const auto *col : alter_info.alter_list)
+    if (col->change_type() == Alter_column::Type::RENAME_COLUMN)
+      rec->dropped_columns.push_back(lower(col->name));
+  for (const auto *rk : alter_info.alter_rename_key_list)
+    rec->renamed_indexes.emplace_back(lower(rk->old_name), rk->new_name);
+  add_keys(alter_info, rec);
+}
+
+void record_batch_statement(THD *thd, const SqlCacheNode &node,
+                            InceptionContext *ctx) {
+  if (ctx->shadow) return;
+  LEX *lex = thd->lex;
+  BatchIR &ir = ctx->batch_ir;
+  const char *current_db = thd->db().str;
+  auto table_of = [&](const TABLE_LIST *tl) {
+    std::string key(tl->db ? tl->db : (current_db ? current_db : ""));
+    key += '.';
+    key += tl->table_name;
+    return ir.table_id(key);
+  };
+  BatchRecord rec;
+  rec.id = node.id;
+
+  switch (lex->sql_command) {
+    case SQLCOM_CREATE_TABLE: {
+      TABLE_LIST *tl = lex->query_tables;
+      if (!tl || !tl->table_name) return;
+      rec.kind = BatchRecord::CREATE;
+      rec.table = table_of(tl);
+      /* CREATE TABLE ... LIKE leaves the table with indexes unknown */
+      if (lex->alter_info) add_keys(*lex->alter_info, &rec);
+      ir.records.push_back(std::move(rec));
+      break;
+    }
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX: {
+      TABLE_LIST *tl = lex->query_tables;
+      if (!tl || !tl->table_name || !lex->alter_info) return;
+      rec.kind = BatchRecord::ALTER;
+      rec.table = table_of(tl);
+      alter_clauses(*lex->alter_info, &rec);
+      if (lex->alter_info->flags & Alter_info::ALTER_RENAME) {
+        const LEX_CSTRING &new_db = lex->alter_info->new_db_name;
+        const LEX_CSTRING &new_name = lex->alter_info->new_table_name;
+        std::string key(new_db.str ? new_db.str
+                                   : (tl->db ? tl->db : current_db ? current_db
+                                                                   : ""));
+        key += '.';
+        key += new_name.str ? new_name.str : tl->table_name;
+        rec.new_table = ir.table_id(key);
+        rec.rename_table = true;
+      }
+      if (rec.added.empty() && rec.dropped_indexes.empty() &&
+          rec.dropped_columns.empty() && rec.renamed_indexes.empty() &&
+          !rec.rename_table)
+        return;
+      ir.records.push_back(std::move(rec));
+      break;
+    }
+    case SQLCOM_DROP_TABLE:
+      for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global) {
+        if (!tl->table_name) continue;
+        BatchRecord drop;
+        drop.kind = BatchRecord::DROP;
+        drop.id = node.id;
+        drop.table = table_of(tl);
+        ir.records.push_back(std::move(drop));
+      }
+      break;
+    case SQLCOM_RENAME_TABLE:
+      for (TABLE_LIST *tl = lex->query_tables; tl && tl->next_local;
+           tl = tl->next_local->next_local) {
+        BatchRecord rename;
+        rename.kind = BatchRecord::RENAME;
+        rename.id = node.id;
+        rename.table = table_of(tl);
+        rename.new_table = table_of(tl->next_local);
+        ir.records.push_back(std::move(rename));
+      }
+      break;
+    case SQLCOM_DROP_DB:
+      if (!lex->name.str) return;
+      rec.kind = BatchRecord::DROP_DATABASE;
+      rec.table = ir.table_id(std::string(lex->name.str) + '.');
+      ir.records.push_back(std::move(rec));
+      break;
+    default:
+      break;
+  }
+}
+
+namespace {
+
+/** An index added in the batch and not dropped since. */
+struct LiveIndex {
+  std::string name;
+  IndexInfo index;
+  int id;  /* of the statement that added it */
+};
+
+/** The live indexes of a table by their parts (index_signature()). */
+using TableIndexes = std::unordered_map<std::string, LiveIndex>;
+
+/** One finding of analyze_batch(). */
+struct Finding {
+  int id;
+  int level;
+  std::string message;
+};
+
+}  // namespace
+
+/* Equal for indexes of the same kind and parts */
+static std::string index_signature(const IndexInfo &index) {
+  std::string sig = index.ordered ? "" : "~";
+  for (const auto &part : index.parts) {
+    sig += part;
+    sig += ',';
+  }
+  return sig;
+}
+
+/* "(a, b(10))" */
+static std::string parts_text(const IndexInfo &index) {
+  std::string text = "(";
+  for (size_t i = 0; i < index.parts.size(); i++) {
+    if (i) text += ", ";
+    text += index.parts[i];
+  }
+  return text + ")";
+}
+
+static bool has_column(const IndexInfo &index, const std::string &column) {
+  for (const auto &part : index.parts)
+    if (part.compare(0, part.find('('), column) == 0) return true;
+  return false;
+}
+
+static void drop_index(TableIndexes *live, const std::string &name) {
+  for (auto it = live->begin(); it != live->end(); ++it) {
+    if (lower(it->second.name.c_str()) == name) {
+      live->erase(it);
+      return;
+    }
+  }
+}
+
+/* The added indexes of rec against those of the batch before it */
+static void check_added_indexes(const BatchRecord &rec, const BatchIR &ir,
+                                int level, TableIndexes *live,
+                                std::vector<Finding> *findings) {
+  const std::string &table = ir.tables[rec.table];
+  for (const auto &added : rec.added) {
+    const std::string sig = index_signature(added.second);
+    auto it = live->find(sig);
+    if (it == live->end()) {
+      live->emplace(sig, LiveIndex{added.first, added.second, rec.id});
+      continue;
+    }
+    LiveIndex &other = it->second;
+    if (rec.kind == BatchRecord::CREATE || other.id == rec.id) continue;
+    char msg[1024];
+    if (!added.second.unique || other.index.unique) {
+      snprintf(msg, sizeof(msg),
+               "Index '%s' %s duplicates index '%s' added to '%s' by "
+               "statement %d.",
+               added.first.c_str(), parts_text(added.second).c_str(),
+               other.name.c_str(), table.c_str(), other.id);
+    } else {
+      snprintf(msg, sizeof(msg),
+               "Index '%s' %s makes index '%s' added to '%s' by statement "
+               "%d redundant.",
+               added.first.c_str(), parts_text(added.second).c_str(),
+               other.name.c_str(), table.c_str(), other.id);
+      other = LiveIndex{added.first, added.second, rec.id};
+    }
+    findings->push_back({rec.id, level, msg});
+  }
+}
+
+void analyze_batch(InceptionContext *ctx) {
+  BatchIR &ir = ctx->batch_ir;
+  const int level = static_cast<int>(ctx->rules.check_duplicate_index);
+  if (ir.records.empty() || level == 0 || ctx->shadow) return;
+
+  std::unordered_map<uint32_t, TableIndexes> tables;
+  std::vector<Finding> findings;
+  for (const BatchRecord &rec : ir.records) {
+    switch (rec.kind) {
+      case BatchRecord::CREATE: {
+        TableIndexes &live = tables[rec.table];
+        live.clear();
+        check_added_indexes(rec, ir, level, &live, &findings);
+        break;
+      }
+      case BatchRecord::ALTER: {
+        TableIndexes &live = tables[rec.table];
+        for (const auto &name : rec.dropped_indexes) drop_index(&live, name);
+        for (const auto &column : rec.dropped_columns)
+          for (auto it = live.begin(); it != live.end();)
+            it = has_column(it->second.index, column) ? live.erase(it)
+                                                      : std::next(it);
+        for (const auto &rk : rec.renamed_indexes)
+          for (auto &index : live)
+            if (lower(index.second.name.c_str()) == rk.first)
+              index.second.name = rk.second;
+        check_added_indexes(rec, ir, level, &live, &findings);
+        if (rec.rename_table && rec.new_table != rec.table) {
+          TableIndexes moved;
+          moved.swap(live);
+          tables.erase(rec.table);
+          tables[rec.new_table] = std::move(moved);
+        }
+        break;
+      }
+      case BatchRecord::DROP:
+        tables.erase(rec.table);
+        break;
+      case BatchRecord::RENAME: {
+        auto it = tables.find(rec.table);
+        TableIndexes moved;
+        if (it != tables.end()) {
+          moved.swap(it->second);
+          tables.erase(it);
+        }
+        tables[rec.new_table] = std::move(moved);
+        break;
+      }
+      case BatchRecord::DROP_DATABASE: {
+        const std::string prefix = lower(ir.tables[rec.table].c_str());
+        for (auto it = tables.begin(); it != tables.end();)
+          it = lower(ir.tables[it->first].c_str()).compare(
+                   0, prefix.size(), prefix) == 0
+                   ? tables.erase(it)
+                   : std::next(it);
+        break;
+      }
+    }
+  }
+
+  /* Onto the nodes still in memory; the others when read back */
+  std::stable_sort(findings.begin(), findings.end(),
+                   [](const Finding &a, const Finding &b) {
+                     return a.id < b.id;
+                   });
+  auto node = ctx->cache_nodes.begin();
+  for (Finding &f : findings) {
+    while (node != ctx->cache_nodes.end() && node->id < f.id) ++node;
+    if (node != ctx->cache_nodes.end() && node->id == f.id)
+      node->report(f.level, "%s", f.message.c_str());
+    else
+      ir.findings[f.id].emplace_back(f.level, std::move(f.message));
+  }
+}
+
+void apply_batch_findings(InceptionContext *ctx, SqlCacheNode *node) {
+  auto it = ctx->batch_ir.findings.find(node->id);
+  if (it == ctx->batch_ir.findings.end()) return;
+  const bool error = node->errlevel >= ERRLEVEL_ERROR;
+  for (const auto &f : it->second)
+    node->report(f.first, "%s", f.second.c_str());
+  /* spooled_errors counted the node by its level when spooled */
+  if (!error && node->errlevel >= ERRLEVEL_ERROR) ctx->spooled_errors++;
+}
+
+}  // namespace inception
@@ -0,0 +1,93 @@
+/**
+ * @file inception_batch.h
+ * @brief Commit-time analysis of the whole batch.
+ *
+ * Most rules see one statement and what the target holds. Rules across
+ * statements keep incremental state in the context instead (batch_tables,
+ * altered_tables), and what the target cannot tell them goes unseen: an
+ * index added by one ALTER of the batch is not among the indexes the next
+ * ALTER of the table is compared with.
+ *
+ * After its audit, record_batch_statement() keeps a compact record of what
+ * a DDL statement does to the indexes of a table (DML records nothing).
+ * At commit, before anything is executed, analyze_batch() walks the
+ * records once with a hash index per table and reports on the statements:
+ *
+ *   - an index whose parts an index added earlier in the batch already has
+ *     (inception_check_duplicate_index)
+ *
+ * The findings of nodes moved to the result spool are added as the rows
+ * are read back (apply_batch_findings()). --schema-file sessions apply
+ * the DDL to their catalog, and the per-statement rules see it there.
+ */
+
+#ifndef SQL_INCEPTION_BATCH_H
+#define SQL_INCEPTION_BATCH_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sql/inception/inception_cache.h"  // IndexInfo
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/** What one statement does to the indexes of a table. */
+struct BatchRecord {
+  enum Kind : uint8_t { CREATE, ALTER, DROP, RENAME, DROP_DATABASE };
+  Kind kind = ALTER;
+  int id = 0;                 /* SqlCacheNode::id */
+  uint32_t table = 0;         /* BatchIR::tables; the "db." prefix for
+                                 DROP_DATABASE */
+  uint32_t new_table = 0;     /* RENAME, or an ALTER with rename_table */
+  bool rename_table = false;
+  std::vector<std::pair<std::string, IndexInfo>> added;  /* name, index */
+  std::vector<std::string> dropped_indexes;              /* lower-case */
+  std::vector<std::string> dropped_columns;              /* lower-case */
+  std::vector<std::pair<std::string, std::string>> renamed_indexes;
+};
+
+/** The records of a batch; cleared with the context. */
+struct BatchIR {
+  std::vector<std::string> tables;  /* "db.table" as first written */
+  std::unordered_map<std::string, uint32_t> table_ids;  /* lower-case */
+  std::vector<BatchRecord> records;
+  /* analyze_batch() findings of spooled nodes: id -> (level, message) */
+  std::map<int, std::vector<std::pair<int, std::string>>> findings;
+
+  uint32_t table_id(const std::string &key);
+  void clear() {
+    tables.clear();
+    table_ids.clear();
+    records.clear();
+    findings.clear();
+  }
+};
+
+/**
+ * Record what the DDL statement in thd->lex, audited into node, does to
+ * indexes, whether or not node has an error: the index stays when the
+ * error is fixed. Nothing for other statements or in a --schema-file
+ * session.
+ */
+void record_batch_statement(THD *thd, const SqlCacheNode &node,
+                            InceptionContext *ctx);
+
+/** Run the rules across the statements recorded in ctx->batch_ir. */
+void analyze_batch(InceptionContext *ctx);
+
+/** Report on node, read back from the result spool, what analyze_batch()
+    found for it. */
+void apply_batch_findings(InceptionContext *ctx, SqlCacheNode *node);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_BATCH_H
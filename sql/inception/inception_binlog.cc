@@ -0,0 +1,684 @@
+/**
+ * @file inception_binlog.cc
+ * @brief Remote binlog streaming and row event decoding.
+ */
+
+#include "sql/inception/inception_binlog.h"
+
+#include "sql/inception/inception_remote_sql.h"
+
+#include "libbinlogevents/include/binlog_event.h"
+#include "libbinlogevents/include/control_events.h"
+#include "libbinlogevents/include/rows_event.h"
+#include "libbinlogevents/include/statement_events.h"
+#include "my_byteorder.h"
+#include "my_time.h"
+#include "sql/json_binary.h"
+#include "sql/json_dom.h"
+#include "sql/my_decimal.h"
+#include "sql/mysqld.h"  // server_version
+#include "sql/rpl_constants.h"  // BINLOG_DUMP_NON_BLOCK
+#include "sql/rpl_utility.h"  // table_def
+#include "sql_string.h"  // String
+
+#include <strings.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace inception {
+
+bool binlog_pos_before(const BinlogPos &a, const BinlogPos &b) {
+  /* mysql-bin.000009 < mysql-bin.000010: same base name, fixed-width seq */
+  if (a.file.size() != b.file.size()) return a.file.size() < b.file.size();
+  int cmp = a.file.compare(b.file);
+  if (cmp != 0) return cmp < 0;
+  return a.pos < b.pos;
+}
+
+bool get_binlog_position(MYSQL *mysql, BinlogPos *pos, std::string *errmsg) {
+  if (mysql_real_query(mysql, remote_sql::SHOW_MASTER_STATUS,
+                       strlen(remote_sql::SHOW_MASTER_STATUS))) {
+    *errmsg = std::string("SHOW MASTER STATUS failed: ") + mysql_error(mysql);
+    return true;
+  }
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) {
+    *errmsg = std::string("SHOW MASTER STATUS failed: ") + mysql_error(mysql);
+    return true;
+  }
+  return read_binlog_position(res, pos, errmsg);
+}
+
+bool read_binlog_position(MYSQL_RES *res, BinlogPos *pos,
+                          std::string *errmsg) {
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool err = !row || !row[0] || !row[1];
+  if (err) {
+    *errmsg = "Binary logging is not enabled on the remote server.";
+  } else {
+    pos->file = row[0];
+    pos->pos = strtoull(row[1], nullptr, 10);
+  }
+  mysql_free_result(res);
+  return err;
+}
+
+bool check_binlog_settings(MYSQL *mysql, std::string *errmsg) {
+  if (mysql_real_query(mysql, remote_sql::BINLOG_SETTINGS,
+                       strlen(remote_sql::BINLOG_SETTINGS))) {
+    *errmsg = std::string("Cannot read binlog settings: ") + mysql_error(mysql);
+    return true;
+  }
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) {
+    *errmsg = std::string("Cannot read binlog settings: ") + mysql_error(mysql);
+    return true;
+  }
+  MYSQL_ROW row = mysql_fetch_row(res);
+  std::string log_bin, format, image, options;
+  if (row) {
+    log_bin = row[0] ? row[0] : "";
+    format = row[1] ? row[1] : "";
+    image = row[2] ? row[2] : "";
+    options = row[3] ? row[3] : "";
+  }
+  mysql_free_result(res);
+  if (log_bin == "1" && strcasecmp(format.c_str(), "ROW") == 0 &&
+      strcasecmp(image.c_str(), "FULL") == 0 &&
+      strcasestr(options.c_str(), "PARTIAL_JSON") == nullptr)
+    return false;
+  *errmsg = "Requires log_bin=ON, binlog_format=ROW, binlog_row_image=FULL "
+            "and binlog_row_value_options='' (have log_bin=" + log_bin +
+            ", binlog_format=" + format + ", binlog_row_image=" + image +
+            ", binlog_row_value_options='" + options + "').";
+  return true;
+}
+
+bool load_binlog_columns(MYSQL *mysql, const std::string &db,
+                         const std::string &table,
+                         std::vector<BinlogColumn> *columns,
+                         std::string *errmsg) {
+  char query[1024];
+  snprintf(query, sizeof(query), remote_sql::GET_BINLOG_COLUMNS, db.c_str(),
+           table.c_str());
+  columns->clear();
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query)))) {
+    *errmsg = std::string("Cannot read columns: ") + mysql_error(mysql);
+    return true;
+  }
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) {
+    *errmsg = std::string("Cannot read columns: ") + mysql_error(mysql);
+    return true;
+  }
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    BinlogColumn col;
+    col.name = row[0] ? row[0] : "";
+    col.is_unsigned = row[1] && strstr(row[1], "unsigned") != nullptr;
+    col.generated = row[2] && strstr(row[2], "GENERATED") != nullptr;
+    columns->push_back(col);
+  }
+  mysql_free_result(res);
+  if (columns->empty()) {
+    *errmsg = "Table " + db + "." + table + " does not exist.";
+    return true;
+  }
+  return false;
+}
+
+/* ---- Value decoding ---- */
+
+/**
+ * Append bytes as a string literal. Printable ASCII without backslashes is
+ * quoted (safe under any sql_mode and ASCII-compatible charset), anything
+ * else becomes a hex literal so no charset conversion can alter it.
+ */
+static void append_bytes_literal(std::string *out, const uchar *p, size_t len,
+                                 bool as_utf8mb4) {
+  bool plain = true;
+  for (size_t i = 0; i < len && plain; i++)
+    plain = (p[i] >= 0x20 && p[i] < 0x7f && p[i] != '\\');
+  if (plain) {
+    *out += '\'';
+    for (size_t i = 0; i < len; i++) {
+      if (p[i] == '\'') *out += '\'';
+      *out += static_cast<char>(p[i]);
+    }
+    *out += '\'';
+    return;
+  }
+  static const char hex[] = "0123456789ABCDEF";
+  /* JSON columns reject binary strings; give the literal a charset. */
+  if (as_utf8mb4) *out += "CONVERT(";
+  *out += "0x";
+  for (size_t i = 0; i < len; i++) {
+    *out += hex[p[i] >> 4];
+    *out += hex[p[i] & 0x0f];
+  }
+  if (as_utf8mb4) *out += " USING utf8mb4)";
+}
+
+static void append_quoted(std::string *out, const char *s) {
+  *out += '\'';
+  *out += s;
+  *out += '\'';
+}
+
+/** Little-endian length prefix of 1..4 bytes. */
+static uint32 read_length(const uchar *p, uint bytes) {
+  switch (bytes) {
+    case 1: return *p;
+    case 2: return uint2korr(p);
+    case 3: return uint3korr(p);
+    default: return uint4korr(p);
+  }
+}
+
+/**
+ * Append the SQL literal of one binlog column value.
+ * Returns false if the type is not supported.
+ */
+static bool append_value(std::string *out, enum_field_types type, uint meta,
+                         bool is_unsigned, const uchar *p, uint32 len) {
+  char buf[MAX_DATE_STRING_REP_LENGTH + 64];
+  switch (type) {
+    case MYSQL_TYPE_TINY:
+      snprintf(buf, sizeof(buf), "%d",
+               is_unsigned ? static_cast<int>(*p)
+                           : static_cast<int>(static_cast<signed char>(*p)));
+      break;
+    case MYSQL_TYPE_SHORT:
+      snprintf(buf, sizeof(buf), "%d",
+               is_unsigned ? static_cast<int>(uint2korr(p))
+                           : static_cast<int>(sint2korr(p)));
+      break;
+    case MYSQL_TYPE_INT24:
+      snprintf(buf, sizeof(buf), "%ld",
+               is_unsigned ? static_cast<long>(uint3korr(p))
+                           : static_cast<long>(sint3korr(p)));
+      break;
+    case MYSQL_TYPE_LONG:
+      snprintf(buf, sizeof(buf), "%lld",
+               is_unsigned ? static_cast<long long>(uint4korr(p))
+                           : static_cast<long long>(sint4korr(p)));
+      break;
+    case MYSQL_TYPE_LONGLONG:
+      if (is_unsigned)
+        snprintf(buf, sizeof(buf), "%llu",
+                 static_cast<unsigned long long>(uint8korr(p)));
+      else
+        snprintf(buf, sizeof(buf), "%lld",
+                 static_cast<long long>(sint8korr(p)));
+      break;
+    case MYSQL_TYPE_YEAR:
+      snprintf(buf, sizeof(buf), "%d", *p ? 1900 + *p : 0);
+      break;
+    case MYSQL_TYPE_FLOAT:
+      snprintf(buf, sizeof(buf), "%.9g", static_cast<double>(float4get(p)));
+      break;
+    case MYSQL_TYPE_DOUBLE:
+      snprintf(buf, sizeof(buf), "%.17g", float8get(p));
+      break;
+    case MYSQL_TYPE_NEWDECIMAL: {
+      my_decimal dec;
+      binary2my_decimal(0, p, &dec, static_cast<int>(meta >> 8),
+                        static_cast<int>(meta & 0xff));
+      int buf_len = static_cast<int>(sizeof(buf)) - 1;
+      decimal2string(&dec, buf, &buf_len);
+      buf[buf_len] = '\0';
+      break;
+    }
+    case MYSQL_TYPE_BIT: {
+      ulonglong v = 0;
+      for (uint32 i = 0; i < len; i++) v = (v << 8) | p[i];
+      snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+      break;
+    }
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET: {
+      /* Index / bitmask: assigning the number keeps the exact member(s). */
+      ulonglong v = 0;
+      for (uint32 i = len; i > 0; i--) v = (v << 8) | p[i - 1];
+      snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+      break;
+    }
+    case MYSQL_TYPE_NEWDATE:
+    case MYSQL_TYPE_DATE: {
+      uint32 v = uint3korr(p);
+      snprintf(buf, sizeof(buf), "'%04u-%02u-%02u'", v >> 9, (v >> 5) & 15,
+               v & 31);
+      break;
+    }
+    case MYSQL_TYPE_TIME: {
+      long v = sint3korr(p);
+      long a = v < 0 ? -v : v;
+      snprintf(buf, sizeof(buf), "'%s%02ld:%02ld:%02ld'", v < 0 ? "-" : "",
+               a / 10000, (a / 100) % 100, a % 100);
+      break;
+    }
+    case MYSQL_TYPE_TIME2: {
+      MYSQL_TIME lt;
+      TIME_from_longlong_time_packed(&lt, my_time_packed_from_binary(p, meta));
+      char tbuf[MAX_DATE_STRING_REP_LENGTH];
+      my_time_to_str(lt, tbuf, meta);
+      append_quoted(out, tbuf);
+      return true;
+    }
+    case MYSQL_TYPE_DATETIME: {
+      ulonglong v = uint8korr(p);
+      ulonglong d = v / 1000000, t = v % 1000000;
+      snprintf(buf, sizeof(buf), "'%04llu-%02llu-%02llu %02llu:%02llu:%02llu'",
+               d / 10000, (d / 100) % 100, d % 100, t / 10000, (t / 100) % 100,
+               t % 100);
+      break;
+    }
+    case MYSQL_TYPE_DATETIME2: {
+      MYSQL_TIME lt;
+      TIME_from_longlong_datetime_packed(
+          &lt, my_datetime_packed_from_binary(p, meta));
+      char tbuf[MAX_DATE_STRING_REP_LENGTH];
+      my_datetime_to_str(lt, tbuf, meta);
+      append_quoted(out, tbuf);
+      return true;
+    }
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_TIMESTAMP2: {
+      struct timeval tv;
+      if (type == MYSQL_TYPE_TIMESTAMP) {
+        tv.tv_sec = uint4korr(p);
+        tv.tv_usec = 0;
+        meta = 0;
+      } else {
+        my_timestamp_from_binary(&tv, p, meta);
+      }
+      if (tv.tv_sec == 0 && tv.tv_usec == 0) {
+        snprintf(buf, sizeof(buf), "'0000-00-00 00:00:00'");
+      } else if (meta == 0) {
+        snprintf(buf, sizeof(buf), "FROM_UNIXTIME(%ld)",
+                 static_cast<long>(tv.tv_sec));
+      } else {
+        char frac[8];
+        snprintf(frac, sizeof(frac), "%06ld", static_cast<long>(tv.tv_usec));
+        frac[meta > 6 ? 6 : meta] = '\0';
+        snprintf(buf, sizeof(buf), "FROM_UNIXTIME(%ld.%s)",
+                 static_cast<long>(tv.tv_sec), frac);
+      }
+      break;
+    }
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING: {
+      uint prefix = meta > 255 ? 2 : 1;
+      append_bytes_literal(out, p + prefix, read_length(p, prefix), false);
+      return true;
+    }
+    case MYSQL_TYPE_STRING: {
+      /* CHAR: the prefix width follows the declared byte length. */
+      uint max_len = (((meta >> 4) & 0x300) ^ 0x300) + (meta & 0xff);
+      uint prefix = max_len > 255 ? 2 : 1;
+      append_bytes_literal(out, p + prefix, read_length(p, prefix), false);
+      return true;
+    }
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_GEOMETRY: {
+      uint prefix = meta ? meta : 4;
+      append_bytes_literal(out, p + prefix, read_length(p, prefix), false);
+      return true;
+    }
+    case MYSQL_TYPE_JSON: {
+      uint prefix = meta ? meta : 4;
+      uint32 jlen = read_length(p, prefix);
+      if (jlen == 0) {
+        *out += "'null'";
+        return true;
+      }
+      json_binary::Value v = json_binary::parse_binary(
+          reinterpret_cast<const char *>(p + prefix), jlen);
+      if (v.type() == json_binary::Value::ERROR) return false;
+      Json_wrapper w(v);
+      String text;
+      if (w.to_string(&text, false, "inception_binlog")) return false;
+      append_bytes_literal(out, reinterpret_cast<const uchar *>(text.ptr()),
+                           text.length(), true);
+      return true;
+    }
+    default:
+      return false;
+  }
+  *out += buf;
+  return true;
+}
+
+/* ---- Stream ---- */
+
+/** Exposes the decoded row buffer of a Rows event. */
+class RowsEventView : public binary_log::Rows_event {
+ public:
+  RowsEventView(const char *buf, const binary_log::Format_description_event *fde)
+      : Rows_event(buf, fde) {}
+  const std::vector<uint8_t> &rows() const { return row; }
+  const std::vector<uint8_t> &before_image() const {
+    return columns_before_image;
+  }
+  const std::vector<uint8_t> &after_image() const {
+    return columns_after_image;
+  }
+  binary_log::Log_event_type type() const { return m_type; }
+};
+
+static std::string watch_key(const std::string &db, const std::string &table) {
+  std::string key = db + "." + table;
+  for (auto &c : key) c = static_cast<char>(tolower(static_cast<uchar>(c)));
+  return key;
+}
+
+/** Distinct replica server ids, so concurrent streams do not evict each
+    other's dump threads on the source. */
+static uint32 next_server_id() {
+  static std::atomic<uint32> counter{0};
+  static const uint32 base =
+      0x40000000u | ((static_cast<uint32>(time(nullptr)) * 2654435761u) &
+                     0x3fff0000u);
+  return base | (counter.fetch_add(1) & 0xffffu);
+}
+
+BinlogStream::BinlogStream() { memset(&m_rpl, 0, sizeof(m_rpl)); }
+
+BinlogStream::~BinlogStream() { close(); }
+
+void BinlogStream::watch(const std::string &db, const std::string &table,
+                         const std::vector<BinlogColumn> &columns) {
+  BinlogTable &t = m_watched[watch_key(db, table)];
+  t.db = db;
+  t.table = table;
+  t.columns = columns;
+}
+
+bool BinlogStream::open(const std::string &host, uint port,
+                        const std::string &user, const std::string &password,
+                        const BinlogPos &start, bool non_blocking,
+                        std::string *errmsg) {
+  close();
+  m_mysql = mysql_init(nullptr);
+  if (!m_mysql) {
+    *errmsg = "mysql_init() failed: out of memory";
+    return true;
+  }
+  unsigned int connect_timeout = 10;
+  /* Heartbeats arrive every second; 30s of silence means a dead source. */
+  unsigned int read_timeout = 30;
+  mysql_options(m_mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
+  mysql_options(m_mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connect_timeout);
+  mysql_options(m_mysql, MYSQL_OPT_READ_TIMEOUT, &read_timeout);
+  if (!mysql_real_connect(m_mysql, host.c_str(), user.c_str(),
+                          password.empty() ? nullptr : password.c_str(),
+                          nullptr, port, nullptr, 0)) {
+    *errmsg = std::string("Cannot open binlog connection: ") +
+              mysql_error(m_mysql);
+    close();
+    return true;
+  }
+
+  /* Announce checksum support, or the source refuses to dump. */
+  binary_log::enum_binlog_checksum_alg alg = binary_log::BINLOG_CHECKSUM_ALG_OFF;
+  if (mysql_real_query(m_mysql, remote_sql::SELECT_BINLOG_CHECKSUM,
+                       strlen(remote_sql::SELECT_BINLOG_CHECKSUM)) == 0) {
+    MYSQL_RES *res = mysql_store_result(m_mysql);
+    if (res) {
+      MYSQL_ROW row = mysql_fetch_row(res);
+      if (row && row[0] && strcasecmp(row[0], "CRC32") == 0)
+        alg = binary_log::BINLOG_CHECKSUM_ALG_CRC32;
+      mysql_free_result(res);
+    }
+  }
+  if (mysql_real_query(m_mysql, remote_sql::SET_MASTER_BINLOG_CHECKSUM,
+                       strlen(remote_sql::SET_MASTER_BINLOG_CHECKSUM)) ||
+      (!non_blocking &&
+       mysql_real_query(m_mysql, remote_sql::SET_MASTER_HEARTBEAT_PERIOD,
+                        strlen(remote_sql::SET_MASTER_HEARTBEAT_PERIOD)))) {
+    *errmsg = std::string("Cannot prepare binlog connection: ") +
+              mysql_error(m_mysql);
+    close();
+    return true;
+  }
+
+  /* Decodes the leading fake Rotate until the real FDE arrives. */
+  m_fde.reset(new binary_log::Format_description_event(BINLOG_VERSION,
+                                                       ::server_version));
+  m_fde->footer()->checksum_alg = alg;
+  m_maps.clear();
+  m_pos = start;
+
+  memset(&m_rpl, 0, sizeof(m_rpl));
+  m_rpl.file_name = m_pos.file.c_str();
+  m_rpl.file_name_length = m_pos.file.size();
+  m_rpl.start_position = m_pos.pos;
+  m_rpl.server_id = next_server_id();
+  m_rpl.flags = non_blocking ? BINLOG_DUMP_NON_BLOCK : 0;
+  if (mysql_binlog_open(m_mysql, &m_rpl)) {
+    *errmsg = std::string("COM_BINLOG_DUMP failed: ") + mysql_error(m_mysql);
+    close();
+    return true;
+  }
+  return false;
+}
+
+void BinlogStream::close() {
+  if (!m_mysql) return;
+  mysql_close(m_mysql);
+  m_mysql = nullptr;
+  m_maps.clear();
+}
+
+BinlogRead BinlogStream::next(std::vector<RowChange> *out,
+                              std::string *errmsg) {
+  if (!m_mysql) {
+    *errmsg = "Binlog stream is not open.";
+    return BinlogRead::ERROR;
+  }
+  if (mysql_binlog_fetch(m_mysql, &m_rpl)) {
+    *errmsg = std::string("Binlog read failed: ") + mysql_error(m_mysql);
+    return BinlogRead::ERROR;
+  }
+  if (m_rpl.size == 0) return BinlogRead::END;
+
+  /* Skip the OK byte in front of every event packet */
+  const char *ev = reinterpret_cast<const char *>(m_rpl.buffer) + 1;
+  size_t len = m_rpl.size - 1;
+  if (len < LOG_EVENT_MINIMAL_HEADER_LEN) {
+    *errmsg = "Binlog read failed: truncated event.";
+    return BinlogRead::ERROR;
+  }
+  int type = static_cast<uchar>(ev[EVENT_TYPE_OFFSET]);
+  uint32 log_pos = uint4korr(ev + LOG_POS_OFFSET);
+  m_last_type = type;
+  m_stmt_end = false;
+
+  switch (type) {
+    case binary_log::ROTATE_EVENT: {
+      binary_log::Rotate_event rotate(ev, m_fde.get());
+      if (!rotate.header()->get_is_valid()) {
+        *errmsg = "Binlog read failed: invalid Rotate event.";
+        return BinlogRead::ERROR;
+      }
+      m_pos.file.assign(rotate.new_log_ident, rotate.ident_len);
+      m_pos.pos = rotate.pos;
+      /* Table ids are only meaningful within one binlog file. */
+      m_maps.clear();
+      return BinlogRead::EVENT;
+    }
+    case binary_log::FORMAT_DESCRIPTION_EVENT: {
+      std::unique_ptr<binary_log::Format_description_event> fde(
+          new binary_log::Format_description_event(ev, m_fde.get()));
+      if (!fde->header()->get_is_valid()) {
+        *errmsg = "Binlog read failed: invalid Format_description event.";
+        return BinlogRead::ERROR;
+      }
+      m_fde = std::move(fde);
+      break;
+    }
+    case binary_log::QUERY_EVENT: {
+      /* The BEGIN of a row-based transaction names its session; DDL is
+         logged as Query events too. */
+      binary_log::Query_event query(ev, m_fde.get(), binary_log::QUERY_EVENT);
+      if (query.header()->get_is_valid()) {
+        m_thread_id = query.thread_id;
+        m_query.assign(query.query ? query.query : "",
+                       query.query ? query.q_len : 0);
+        m_query_db.assign(query.db ? query.db : "", query.db ? query.db_len : 0);
+      }
+      break;
+    }
+    case binary_log::TABLE_MAP_EVENT: {
+      binary_log::Table_map_event map(ev, m_fde.get());
+      if (!map.header()->get_is_valid()) {
+        *errmsg = "Binlog read failed: invalid Table_map event.";
+        return BinlogRead::ERROR;
+      }
+      std::string key = watch_key(map.get_db_name(), map.get_table_name());
+      auto it = m_watched.find(key);
+      std::vector<BinlogColumn> columns;
+      if (it == m_watched.end() && m_resolver &&
+          m_resolver(map.get_db_name(), map.get_table_name(), &columns)) {
+        watch(map.get_db_name(), map.get_table_name(), columns);
+        it = m_watched.find(key);
+      }
+      if (it == m_watched.end()) {
+        m_maps.erase(map.get_table_id());
+        break;
+      }
+      MappedTable &mt = m_maps[map.get_table_id()];
+      mt.table = &it->second;
+      mt.def.reset(new table_def(map.m_coltype, map.m_colcnt,
+                                 map.m_field_metadata,
+                                 static_cast<int>(map.m_field_metadata_size),
+                                 map.m_null_bits, map.m_flags));
+      break;
+    }
+    case binary_log::WRITE_ROWS_EVENT:
+    case binary_log::UPDATE_ROWS_EVENT:
+    case binary_log::DELETE_ROWS_EVENT:
+    case binary_log::WRITE_ROWS_EVENT_V1:
+    case binary_log::UPDATE_ROWS_EVENT_V1:
+    case binary_log::DELETE_ROWS_EVENT_V1:
+    case binary_log::PARTIAL_UPDATE_ROWS_EVENT:
+      if (decode_rows(ev, out, errmsg)) return BinlogRead::ERROR;
+      break;
+    default:
+      break;
+  }
+  /* log_pos is 0 for artificial events (e.g. the FDE resent on connect) */
+  if (log_pos) m_pos.pos = log_pos;
+  return BinlogRead::EVENT;
+}
+
+bool BinlogStream::decode_rows(const char *buf, std::vector<RowChange> *out,
+                               std::string *errmsg) {
+  RowsEventView rows(buf, m_fde.get());
+  if (!rows.header()->get_is_valid()) {
+    *errmsg = "Binlog read failed: invalid Rows event.";
+    return true;
+  }
+  m_stmt_end = rows.get_flags() & binary_log::Rows_event::STMT_END_F;
+  auto it = m_maps.find(rows.get_table_id());
+  if (it == m_maps.end()) return false;  /* not a watched table */
+  const BinlogTable *table = it->second.table;
+  const table_def &def = *it->second.def;
+
+  if (rows.type() == binary_log::PARTIAL_UPDATE_ROWS_EVENT) {
+    *errmsg = "Partial JSON updates (binlog_row_value_options=PARTIAL_JSON) "
+              "on " + table->db + "." + table->table + " cannot be decoded.";
+    return true;
+  }
+  ulong width = rows.get_width();
+  if (width != def.size() || width != table->columns.size()) {
+    *errmsg = "Row event of " + table->db + "." + table->table + " has " +
+              std::to_string(width) + " columns, expected " +
+              std::to_string(table->columns.size()) +
+              " (table changed during the stream?).";
+    return true;
+  }
+
+  RowChangeType change;
+  switch (rows.type()) {
+    case binary_log::WRITE_ROWS_EVENT:
+    case binary_log::WRITE_ROWS_EVENT_V1:
+      change = RowChangeType::INSERT;
+      break;
+    case binary_log::UPDATE_ROWS_EVENT:
+    case binary_log::UPDATE_ROWS_EVENT_V1:
+      change = RowChangeType::UPDATE;
+      break;
+    default:
+      change = RowChangeType::DELETE;
+      break;
+  }
+
+  const std::vector<uint8_t> &data = rows.rows();
+  const uchar *p = data.data();
+  const uchar *end = p + data.size();
+
+  auto truncated = [&]() {
+    *errmsg = "Binlog read failed: truncated row in " + table->db + "." +
+              table->table + ".";
+    return true;
+  };
+
+  /* Decode one row image at p into values. */
+  auto decode_image = [&](const std::vector<uint8_t> &image,
+                          std::vector<std::string> *values) -> bool {
+    uint present = 0;
+    for (ulong i = 0; i < width; i++)
+      if (image[i / 8] & (1 << (i % 8))) present++;
+    if (present != width) {
+      *errmsg = "Row image of " + table->db + "." + table->table +
+                " is not complete (binlog_row_image must be FULL).";
+      return true;
+    }
+    const uchar *null_bits = p;
+    p += (present + 7) / 8;
+    if (p > end) return truncated();
+    values->assign(width, std::string());
+    for (ulong i = 0; i < width; i++) {
+      if (null_bits[i / 8] & (1 << (i % 8))) {
+        (*values)[i] = "NULL";
+        continue;
+      }
+      uint32 len = def.calc_field_size(static_cast<uint>(i), p);
+      if (p + len > end) return truncated();
+      if (!append_value(&(*values)[i], def.type(i), def.field_metadata(i),
+                        table->columns[i].is_unsigned, p, len)) {
+        *errmsg = "Column " + table->columns[i].name + " of " + table->db +
+                  "." + table->table + " has an unsupported binlog type " +
+                  std::to_string(static_cast<int>(def.type(i))) + ".";
+        return true;
+      }
+      p += len;
+    }
+    return false;
+  };
+
+  while (p < end) {
+    RowChange rc;
+    rc.type = change;
+    rc.table = table;
+    rc.thread_id = m_thread_id;
+    if (change == RowChangeType::INSERT) {
+      if (decode_image(rows.before_image(), &rc.after)) return true;
+    } else {
+      if (decode_image(rows.before_image(), &rc.before)) return true;
+      if (change == RowChangeType::UPDATE &&
+          decode_image(rows.after_image(), &rc.after))
+        return true;
+    }
+    out->push_back(std::move(rc));
+  }
+  return false;
+}
+
+}  // namespace inception
@@ -0,0 +1,186 @@
+/**
+ * @file inception_binlog.h
+ * @brief Remote binlog streaming and row event decoding.
+ *
+ * Opens a replication stream (COM_BINLOG_DUMP) on the target, decodes
+ * Table_map and Rows events of the watched tables with libbinlogevents and
+ * turns every row image into a vector of SQL literals, ready to be pasted
+ * into a generated statement. Used by the online schema change engine to
+ * replay concurrent writes on the ghost table and by the backup module to
+ * build rollback statements.
+ *
+ * Requires binlog_format=ROW and binlog_row_image=FULL on the target, and
+ * REPLICATION SLAVE / REPLICATION CLIENT for the connecting user.
+ */
+
+#ifndef SQL_INCEPTION_BINLOG_H
+#define SQL_INCEPTION_BINLOG_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL, MYSQL_RPL
+
+namespace binary_log {
+class Format_description_event;
+}
+class table_def;
+
+namespace inception {
+
+/** A binlog coordinate: file name and byte offset in it. */
+struct BinlogPos {
+  std::string file;
+  uint64_t pos = 0;
+};
+
+/** True if a is strictly before b. Same-server file names sort in order. */
+bool binlog_pos_before(const BinlogPos &a, const BinlogPos &b);
+
+/** Current end of the binlog (SHOW MASTER STATUS). Returns true on error. */
+bool get_binlog_position(MYSQL *mysql, BinlogPos *pos, std::string *errmsg);
+
+/** Same, from a stored SHOW MASTER STATUS result, which it frees. */
+bool read_binlog_position(MYSQL_RES *res, BinlogPos *pos,
+                          std::string *errmsg);
+
+/**
+ * Check that the target logs full row images the decoder can read:
+ * log_bin=ON, binlog_format=ROW, binlog_row_image=FULL and no
+ * PARTIAL_JSON. Returns true (with *errmsg) if not, or on error.
+ */
+bool check_binlog_settings(MYSQL *mysql, std::string *errmsg);
+
+/** One column of a watched table, in ordinal order. */
+struct BinlogColumn {
+  std::string name;
+  bool is_unsigned = false;
+  bool generated = false;  /* VIRTUAL/STORED GENERATED: cannot be written */
+};
+
+/**
+ * Load the column list of db.table from information_schema.
+ * Returns true on error (including a missing table).
+ */
+bool load_binlog_columns(MYSQL *mysql, const std::string &db,
+                         const std::string &table,
+                         std::vector<BinlogColumn> *columns,
+                         std::string *errmsg);
+
+/** A table whose row events are decoded. */
+struct BinlogTable {
+  std::string db;
+  std::string table;
+  std::vector<BinlogColumn> columns;
+};
+
+enum class RowChangeType { INSERT, UPDATE, DELETE };
+
+/**
+ * One decoded row change. Values are SQL literals in column order:
+ * NULL, numbers, quoted strings, 0x... hex for non-ASCII bytes,
+ * FROM_UNIXTIME(...) for TIMESTAMP.
+ */
+struct RowChange {
+  RowChangeType type;
+  const BinlogTable *table;
+  uint32_t thread_id;               /* session of the enclosing transaction */
+  std::vector<std::string> before;  /* UPDATE, DELETE */
+  std::vector<std::string> after;   /* INSERT, UPDATE */
+};
+
+/** Result of BinlogStream::next(). */
+enum class BinlogRead { EVENT, END, ERROR };
+
+/**
+ * A replication stream from one target. Not thread-safe; one reader thread
+ * owns it. A blocking stream receives a heartbeat every second while the
+ * binlog is idle, so next() always returns within about a second.
+ */
+class BinlogStream {
+ public:
+  BinlogStream();
+  ~BinlogStream();
+  BinlogStream(const BinlogStream &) = delete;
+  BinlogStream &operator=(const BinlogStream &) = delete;
+
+  /** Decode row events of db.table (call before open()). */
+  void watch(const std::string &db, const std::string &table,
+             const std::vector<BinlogColumn> &columns);
+
+  /**
+   * Asked for every Table_map event of a table that is not watched:
+   * return true with the columns to start watching it. Refusals are not
+   * remembered, so the resolver may decide per transaction (thread_id()).
+   */
+  using TableResolver =
+      std::function<bool(const std::string &db, const std::string &table,
+                         std::vector<BinlogColumn> *columns)>;
+  void set_resolver(TableResolver resolver) {
+    m_resolver = std::move(resolver);
+  }
+
+  /**
+   * Connect and request the binlog from start. A non-blocking stream ends
+   * (next() returns END) at the current end of the binlog. Returns true on
+   * error with *errmsg set.
+   */
+  bool open(const std::string &host, uint port, const std::string &user,
+            const std::string &password, const BinlogPos &start,
+            bool non_blocking, std::string *errmsg);
+
+  /**
+   * Read one event. Row changes of watched tables are appended to *out.
+   * EVENT: one event consumed (possibly with no rows), END: end of a
+   * non-blocking stream, ERROR: *errmsg set.
+   */
+  BinlogRead next(std::vector<RowChange> *out, std::string *errmsg);
+
+  /** Coordinate right after the last event read. */
+  const BinlogPos &position() const { return m_pos; }
+
+  /** Session of the transaction being read (from its BEGIN Query event). */
+  uint32_t thread_id() const { return m_thread_id; }
+
+  /** Type code of the last event read (binary_log::Log_event_type). */
+  int last_event_type() const { return m_last_type; }
+
+  /** True if the last event read was the final Rows event of a statement. */
+  bool stmt_end() const { return m_stmt_end; }
+
+  /** Text and default database of the last Query event read. */
+  const std::string &last_query() const { return m_query; }
+  const std::string &last_query_db() const { return m_query_db; }
+
+  void close();
+
+ private:
+  struct MappedTable {
+    const BinlogTable *table;
+    std::unique_ptr<table_def> def;
+  };
+
+  bool decode_rows(const char *buf, std::vector<RowChange> *out,
+                   std::string *errmsg);
+
+  MYSQL *m_mysql = nullptr;
+  MYSQL_RPL m_rpl;
+  std::unique_ptr<binary_log::Format_description_event> m_fde;
+  std::map<std::string, BinlogTable> m_watched;  /* key: lower "db.table" */
+  TableResolver m_resolver;
+  std::map<uint64_t, MappedTable> m_maps;        /* key: table id */
+  BinlogPos m_pos;
+  int m_last_type = 0;
+  bool m_stmt_end = false;                       /* STMT_END_F of last event */
+  uint32_t m_thread_id = 0;                      /* from the last Query event */
+  std::string m_query;                           /* same */
+  std::string m_query_db;
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_BINLOG_H
@@ -0,0 +1,1156 @@
+/**
+ * @file inception_cache.cc
+ * @brief Remote schema metadata cache shared by inception sessions.
+ */
+
+#include "sql/inception/inception_cache.h"
+
+#include "sql/inception/inception_audit.h"  // get_audit_conn
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_parse.h"  // decrypt_password
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sched.h"  // QuerySlot
+#include "sql/inception/inception_shadow.h"
+#include "sql/inception/inception_shared.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_dbug.h"
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <strings.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+namespace inception {
+
+namespace {
+
+struct CacheEntry {
+  TableMetaPtr meta;
+  std::string target;
+  std::string db_name;
+  std::string table_name;
+  uint64_t hits = 0;
+  bool pinned = false;  /* kept fresh by the binlog watcher, no TTL */
+};
+
+struct SchemaEntry {
+  bool exists = false;
+  std::string target;
+  std::string db_name;
+  uint64_t hits = 0;
+  std::chrono::steady_clock::time_point loaded_at;
+};
+
+/* Binlog watcher state of one target (inception_snapshot.h) */
+struct WatchState {
+  bool live = false;   /* streaming: new entries can be pinned */
+  uint64_t epoch = 0;  /* bumped by every invalidation of the target */
+};
+
+InceptionMutex g_cache_mutex("metadata_cache");
+std::map<std::string, CacheEntry> g_tables;    /* target/db.table */
+std::map<std::string, SchemaEntry> g_schemas;  /* target/db */
+std::map<std::string, WatchState> g_watch;     /* target */
+/* Per target: whether it compares names case-insensitively
+   (lower_case_table_names != 0); absent until learned */
+std::map<std::string, bool> g_fold_case;
+std::map<std::string, double> g_rebuild_speed; /* target/algorithm or BINLOG */
+
+/* Startup warm-up (inception_metadata_warm_schemas), one thread a target */
+std::vector<std::thread> g_warmup_threads;
+std::atomic<bool> g_warmup_stop{false};
+
+std::string lower(const char *s) {
+  std::string r(s ? s : "");
+  for (auto &c : r) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return r;
+}
+
+/**
+ * A db or table name as the cache keys it: lower-cased when target
+ * compares names case-insensitively, so that DB.T and db.t share one
+ * entry and one invalidation. Caller holds g_cache_mutex.
+ */
+std::string key_name(const std::string &target, const std::string &name) {
+  auto it = g_fold_case.find(target);
+  return it != g_fold_case.end() && it->second ? lower(name.c_str()) : name;
+}
+
+std::string table_key(const std::string &target, const std::string &db,
+                      const std::string &table) {
+  return target + '/' + key_name(target, db) + '.' + key_name(target, table);
+}
+
+std::string schema_key(const std::string &target, const std::string &db) {
+  return target + '/' + key_name(target, db);
+}
+
+bool expired(std::chrono::steady_clock::time_point loaded_at,
+             std::chrono::steady_clock::time_point now) {
+  return now - loaded_at >= std::chrono::seconds(opt_metadata_cache_ttl);
+}
+
+/** Pinned entries only go away when the watcher sees DDL on them. */
+bool stale(const CacheEntry &e, std::chrono::steady_clock::time_point now) {
+  return !e.pinned && expired(e.meta->loaded_at, now);
+}
+
+/* Invalidation epoch of target, read before a load. Caller holds the lock. */
+uint64_t watch_epoch(const std::string &target) {
+  auto it = g_watch.find(target);
+  return it == g_watch.end() ? 0 : it->second.epoch;
+}
+
+/**
+ * Whether an entry loaded since epoch may be pinned: the watcher is live
+ * and saw no DDL on the target during the load, which the entry might
+ * predate. Caller holds the lock.
+ */
+bool can_pin(const std::string &target, uint64_t epoch) {
+  auto it = g_watch.find(target);
+  return it != g_watch.end() && it->second.live && it->second.epoch == epoch;
+}
+
+/**
+ * Make room for one more table entry: drop expired entries first, then
+ * the oldest ones. Caller holds g_cache_mutex.
+ */
+void evict_for_insert(std::chrono::steady_clock::time_point now) {
+  if (g_tables.size() < opt_metadata_cache_max_tables) return;
+  for (auto it = g_tables.begin(); it != g_tables.end();) {
+    if (stale(it->second, now))
+      it = g_tables.erase(it);
+    else
+      ++it;
+  }
+  while (!g_tables.empty() &&
+         g_tables.size() >= opt_metadata_cache_max_tables) {
+    auto oldest = g_tables.begin();
+    for (auto it = g_tables.begin(); it != g_tables.end(); ++it) {
+      if (it->second.meta->loaded_at < oldest->second.meta->loaded_at)
+        oldest = it;
+    }
+    g_tables.erase(oldest);
+  }
+}
+
+/**
+ * Drop every entry of target, retiring what was derived from them (the
+ * epoch moves). Caller holds g_cache_mutex.
+ */
+void drop_target(const std::string &target) {
+  g_watch[target].epoch++;
+  for (auto it = g_schemas.begin(); it != g_schemas.end();) {
+    if (it->second.target == target)
+      it = g_schemas.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = g_tables.begin(); it != g_tables.end();) {
+    if (it->second.target == target)
+      it = g_tables.erase(it);
+    else
+      ++it;
+  }
+}
+
+/** Drop the entries of target if another instance invalidated it. */
+void sync_shared_epoch(const std::string &target) {
+  if (!shared_cache_enabled() || !shared_epoch_changed(target)) return;
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  drop_target(target);
+}
+
+/**
+ * Learn lower_case_table_names of target through mysql, once; the query
+ * counts in ctx->remote_queries unless ctx is null. Entries stored before
+ * it was learned are keyed on the names as given, so they are dropped when
+ * names turn out to fold. On error the names stay as given and the next
+ * load asks again.
+ */
+void learn_name_case(InceptionContext *ctx, const std::string &target,
+                     MYSQL *mysql) {
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    if (g_fold_case.count(target)) return;
+  }
+  if (ctx) ctx->remote_queries++;
+  status_add(STATUS_REMOTE_QUERIES);
+  const char *query = remote_sql::SHOW_LOWER_CASE_TABLE_NAMES;
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+    return;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  const bool known = row && row[0];
+  const bool fold = known && strtol(row[0], nullptr, 10) != 0;
+  mysql_free_result(res);
+  if (!known) return;
+
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  if (!g_fold_case.emplace(target, fold).second || !fold) return;
+  drop_target(target);
+}
+
+/** Store an entry of the shared tier: it may predate the watcher, so it
+    is never pinned. Caller holds g_cache_mutex. */
+void put_shared_entry(const std::string &target, const SchemaTable &name,
+                      TableMetaPtr meta) {
+  const auto now = std::chrono::steady_clock::now();
+  if (meta->exists) {
+    SchemaEntry &schema = g_schemas[schema_key(target, name.first)];
+    if (schema.target.empty() || !schema.exists) {
+      schema.exists = true;
+      schema.target = target;
+      schema.db_name = name.first;
+      schema.hits = 0;
+      schema.loaded_at = now;
+    }
+  }
+  const std::string key = table_key(target, name.first, name.second);
+  if (g_tables.count(key) == 0) evict_for_insert(now);
+  CacheEntry &entry = g_tables[key];
+  entry.meta = std::move(meta);
+  entry.target = target;
+  entry.db_name = name.first;
+  entry.table_name = name.second;
+  entry.hits = 0;
+  entry.pinned = false;
+}
+
+/** The members of an "enum('a','b')" or "set(...)" COLUMN_TYPE. */
+std::vector<std::string> type_values(const char *column_type) {
+  std::vector<std::string> values;
+  const char *p = column_type ? strchr(column_type, '(') : nullptr;
+  while (p && (p = strchr(p, '\''))) {
+    std::string value;
+    for (p++; *p; p++) {
+      if (*p == '\'' && p[1] == '\'')
+        p++;
+      else if (*p == '\'')
+        break;
+      value += *p;
+    }
+    values.push_back(std::move(value));
+    if (*p) p++;
+  }
+  return values;
+}
+
+/** Fill a RemoteColumnInfo from (DATA_TYPE, CHAR_MAX_LEN, PRECISION, SCALE,
+    CHARACTER_SET_NAME, IS_NULLABLE, COLUMN_TYPE). */
+RemoteColumnInfo column_from_row(MYSQL_ROW cols) {
+  RemoteColumnInfo info;
+  info.data_type = cols[0];
+  info.char_max_length = cols[1] ? strtoll(cols[1], nullptr, 10) : -1;
+  info.numeric_precision = cols[2] ? strtoll(cols[2], nullptr, 10) : -1;
+  info.numeric_scale = cols[3] ? strtoll(cols[3], nullptr, 10) : -1;
+  info.charset = cols[4] ? lower(cols[4]) : "";
+  info.nullable = !cols[5] || strcasecmp(cols[5], "NO") != 0;
+  info.is_unsigned = cols[6] && strstr(cols[6], " unsigned") != nullptr;
+  if (info.data_type == "enum" || info.data_type == "set")
+    info.values = type_values(cols[6]);
+  return info;
+}
+
+/** Add one index part from (INDEX_NAME, COLUMN_NAME, NON_UNIQUE, SUB_PART,
+    INDEX_TYPE), rows of an index coming in SEQ_IN_INDEX order. */
+void index_part_from_row(TableMeta *meta, MYSQL_ROW cols) {
+  const std::string name = lower(cols[0]);
+  meta->indexes.insert(name);
+  IndexInfo &index = meta->index_defs[name];
+  index.unique = cols[2] && strcmp(cols[2], "0") == 0;
+  index.ordered = !cols[4] || (strcasecmp(cols[4], "FULLTEXT") != 0 &&
+                               strcasecmp(cols[4], "SPATIAL") != 0);
+  std::string part = cols[1] ? lower(cols[1]) : "()";
+  if (cols[1] && cols[3]) part += "(" + std::string(cols[3]) + ")";
+  index.parts.push_back(std::move(part));
+}
+
+/** Load one table's metadata in a single round trip. */
+TableMetaPtr load_table_meta(MYSQL *mysql, const char *db, const char *table) {
+  char query[2048];
+  snprintf(query, sizeof(query), remote_sql::GET_TABLE_METADATA, db, table, db,
+           table, db, table);
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+    return nullptr;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return nullptr;
+
+  auto meta = std::make_shared<TableMeta>();
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    if (!row[0]) continue;
+    switch (row[0][0]) {
+      case 'T':
+        meta->exists = true;
+        meta->table_rows = row[1] ? strtoll(row[1], nullptr, 10) : -1;
+        meta->table_bytes = row[2] ? strtoll(row[2], nullptr, 10) : -1;
+        meta->row_format = row[3] ? lower(row[3]) : "";
+        meta->avg_row_length = row[4] ? strtoll(row[4], nullptr, 10) : -1;
+        break;
+      case 'C': {
+        if (!row[1] || !row[2]) break;
+        meta->add_column(row[1], column_from_row(row + 2));
+        break;
+      }
+      case 'I':
+        if (row[1]) index_part_from_row(meta.get(), row + 1);
+        break;
+    }
+  }
+  mysql_free_result(res);
+  meta->loaded_at = std::chrono::steady_clock::now();
+  return meta;
+}
+
+/** Run a prefetch query and hand every row to fn. Returns true on error. */
+template <typename F>
+bool for_each_row(MYSQL *mysql, const char *tmpl, const std::string &db, F fn) {
+  char query[512];
+  snprintf(query, sizeof(query), tmpl, db.c_str());
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    if (row[0]) fn(row);
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+/**
+ * Load every table of db with three set-based queries and store them in the
+ * cache. Returns the number of tables loaded, or -1 on error.
+ */
+long prefetch_schema(MYSQL *mysql, const std::string &target,
+                     const std::string &db) {
+  std::map<std::string, std::shared_ptr<TableMeta>> tables;
+  learn_name_case(nullptr, target, mysql);
+  uint64_t epoch;
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    epoch = watch_epoch(target);
+  }
+
+  if (for_each_row(mysql, remote_sql::PREFETCH_SCHEMA_TABLES, db,
+                   [&](MYSQL_ROW row) {
+                     auto meta = std::make_shared<TableMeta>();
+                     meta->exists = true;
+                     meta->table_rows =
+                         row[1] ? strtoll(row[1], nullptr, 10) : -1;
+                     meta->table_bytes =
+                         row[2] ? strtoll(row[2], nullptr, 10) : -1;
+                     meta->row_format = row[3] ? lower(row[3]) : "";
+                     meta->avg_row_length =
+                         row[4] ? strtoll(row[4], nullptr, 10) : -1;
+                     tables[row[0]] = meta;
+                   }))
+    return -1;
+  if (for_each_row(mysql, remote_sql::PREFETCH_SCHEMA_COLUMNS, db,
+                   [&](MYSQL_ROW row) {
+                     auto it = tables.find(row[0]);
+                     if (it == tables.end() || !row[1] || !row[2]) return;
+                     it->second->add_column(row[1], column_from_row(row + 2));
+                   }))
+    return -1;
+  if (for_each_row(mysql, remote_sql::PREFETCH_SCHEMA_INDEXES, db,
+                   [&](MYSQL_ROW row) {
+                     auto it = tables.find(row[0]);
+                     if (it == tables.end() || !row[1]) return;
+                     index_part_from_row(it->second.get(), row + 1);
+                   }))
+    return -1;
+  DBUG_EXECUTE_IF("inception_invalidate_during_metadata_load",
+                  cache_invalidate_schema(target, db););
+
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  /* Invalidated during the load: any table may predate the DDL, so keep
+     none of them; the audit loads them on demand. */
+  if (watch_epoch(target) != epoch) return 0;
+  for (auto it = g_tables.begin(); it != g_tables.end();) {
+    if (stale(it->second, now))
+      it = g_tables.erase(it);
+    else
+      ++it;
+  }
+  const bool pin = can_pin(target, epoch);
+  /* Never evict live entries for a prefetch; stop at capacity instead. */
+  long stored = 0;
+  for (auto &pair : tables) {
+    if (g_tables.size() >= opt_metadata_cache_max_tables) break;
+    pair.second->loaded_at = now;
+    CacheEntry &entry = g_tables[table_key(target, db, pair.first)];
+    entry.meta = pair.second;
+    entry.target = target;
+    entry.db_name = db;
+    entry.table_name = pair.first;
+    entry.hits = 0;
+    entry.pinned = pin;
+    stored++;
+  }
+  /* An empty result does not prove the schema exists; leave that entry to
+     cached_db_exists(). */
+  if (!tables.empty()) {
+    SchemaEntry &schema = g_schemas[schema_key(target, db)];
+    schema.exists = true;
+    schema.target = target;
+    schema.db_name = db;
+    schema.hits = 0;
+    schema.loaded_at = now;
+  }
+  return stored;
+}
+
+}  // namespace
+
+void TableMeta::add_column(const std::string &name,
+                           const RemoteColumnInfo &info) {
+  auto ins = columns.emplace(lower(name.c_str()), info);
+  if (ins.second)
+    column_order.push_back(name);
+  else
+    ins.first->second = info;
+}
+
+void TableMeta::drop_column(const std::string &name) {
+  const std::string key = lower(name.c_str());
+  if (!columns.erase(key)) return;
+  for (auto it = column_order.begin(); it != column_order.end(); ++it) {
+    if (lower(it->c_str()) == key) {
+      column_order.erase(it);
+      break;
+    }
+  }
+}
+
+const RemoteColumnInfo *TableMeta::find_column(const char *name) const {
+  auto it = columns.find(lower(name));
+  return it == columns.end() ? nullptr : &it->second;
+}
+
+bool TableMeta::has_index(const char *name) const {
+  return indexes.count(lower(name)) > 0;
+}
+
+std::string cache_target(const InceptionContext *ctx) {
+  std::string target = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  target += ':';
+  target += std::to_string(ctx->port);
+  return target;
+}
+
+TableMetaPtr get_table_meta(InceptionContext *ctx, MYSQL *mysql,
+                            const char *db, const char *table) {
+  if (ctx->shadow && db && table)
+    return shadow_table_meta(*ctx->shadow, db, table);
+  if (!mysql || !db || !table) return nullptr;
+  if (opt_metadata_cache_ttl == 0 && !ctx->statement_meta.empty()) {
+    auto it = ctx->statement_meta.find(std::string(db) + '.' + table);
+    if (it != ctx->statement_meta.end()) return it->second;
+  }
+  const std::string target = cache_target(ctx);
+
+  uint64_t epoch = 0;
+  if (opt_metadata_cache_ttl > 0) {
+    learn_name_case(ctx, target, mysql);
+    sync_shared_epoch(target);
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    auto it = g_tables.find(table_key(target, db, table));
+    if (it != g_tables.end()) {
+      if (!stale(it->second, std::chrono::steady_clock::now())) {
+        it->second.hits++;
+        status_add(STATUS_CACHE_HITS);
+        return it->second.meta;
+      }
+      g_tables.erase(it);
+    }
+    epoch = watch_epoch(target);
+  }
+
+  /* Next the shared tier; what it lacks is stored there at the version
+     read before the load */
+  const SchemaTable name(db, table);
+  uint64_t shared_epoch = 0;
+  bool shared = shared_cache_enabled();
+  if (shared) {
+    std::vector<std::pair<SchemaTable, TableMetaPtr>> found;
+    shared = !shared_get_tables(target, {name}, &found, &shared_epoch);
+    if (shared && !found.empty()) {
+      status_add(STATUS_SHARED_CACHE_HITS);
+      std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+      put_shared_entry(target, name, found[0].second);
+      return found[0].second;
+    }
+    if (shared) status_add(STATUS_SHARED_CACHE_MISSES);
+  }
+
+  /* Miss: query outside the lock, concurrent loads of the same key are
+     harmless (last one wins). */
+  ctx->remote_queries++;
+  status_add(STATUS_CACHE_MISSES);
+  status_add(STATUS_REMOTE_QUERIES);
+  TableMetaPtr meta;
+  {
+    StageScope stage(stage_inception_remote_check);
+    MYSQL *reader = get_audit_conn(ctx, mysql);
+    {
+      QuerySlot slot(ctx, reader);
+      if (slot.killed()) return nullptr;
+      const auto start = std::chrono::steady_clock::now();
+      meta = load_table_meta(reader, db, table);
+      ctx->remote_us += record_remote_latency(reader, REMOTE_METADATA, start);
+    }
+    /* Not on the --audit-host replica: it may not have caught up */
+    if (reader != mysql && (!meta || !meta->exists)) {
+      QuerySlot slot(ctx, mysql);
+      if (slot.killed()) return nullptr;
+      ctx->remote_queries++;
+      status_add(STATUS_REMOTE_QUERIES);
+      const auto start = std::chrono::steady_clock::now();
+      meta = load_table_meta(mysql, db, table);
+      ctx->remote_us += record_remote_latency(mysql, REMOTE_METADATA, start);
+    }
+  }
+  if (!meta || opt_metadata_cache_ttl == 0) return meta;
+  DBUG_EXECUTE_IF("inception_invalidate_during_metadata_load",
+                  cache_invalidate_table(target, db, table););
+
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    /* Invalidated during the load: meta may predate the DDL, so it answers
+       this statement only */
+    if (watch_epoch(target) != epoch) return meta;
+    evict_for_insert(meta->loaded_at);
+    CacheEntry &entry = g_tables[table_key(target, db, table)];
+    entry.meta = meta;
+    entry.target = target;
+    entry.db_name = db;
+    entry.table_name = table;
+    entry.hits = 0;
+    entry.pinned = can_pin(target, epoch);
+  }
+  if (shared) shared_put_tables(target, {{name, meta}}, shared_epoch);
+  return meta;
+}
+
+/* Max tables per preload query; larger statements take several waves. */
+static constexpr size_t PRELOAD_BATCH = 64;
+
+StatementMetaScope::~StatementMetaScope() {
+  m_ctx->statement_meta.clear();
+  m_ctx->statement_schemas.clear();
+}
+
+void preload_table_meta(InceptionContext *ctx, MYSQL *mysql,
+                        const std::vector<SchemaTable> &refs) {
+  if (!mysql || refs.size() < 2) return;
+  const std::string target = cache_target(ctx);
+  /* Without the cache the tables answer the statement only */
+  const bool cached = opt_metadata_cache_ttl > 0;
+
+  /* Result rows are matched case-insensitively (lower_case_table_names may
+     fold the stored names); names differing only in case stay on-demand. */
+  std::map<std::string, SchemaTable> missing;  /* lower(db.table) -> ref */
+  std::set<std::string> ambiguous;
+  uint64_t epoch;
+  if (cached) {
+    learn_name_case(ctx, target, mysql);
+    sync_shared_epoch(target);
+  }
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    auto now = std::chrono::steady_clock::now();
+    epoch = watch_epoch(target);
+    for (const auto &ref : refs) {
+      if (!cached) {
+        if (ctx->statement_meta.count(ref.first + '.' + ref.second)) continue;
+      } else {
+        auto it = g_tables.find(table_key(target, ref.first, ref.second));
+        if (it != g_tables.end() && !stale(it->second, now)) continue;
+      }
+      std::string lkey = lower(ref.first.c_str()) + '.' +
+                         lower(ref.second.c_str());
+      auto ins = missing.emplace(lkey, ref);
+      if (!ins.second && ins.first->second != ref) ambiguous.insert(lkey);
+    }
+  }
+  for (const auto &lkey : ambiguous) missing.erase(lkey);
+
+  /* The shared tier has the others loaded already, maybe */
+  uint64_t shared_epoch = 0;
+  bool shared = cached && missing.size() >= 2 && shared_cache_enabled();
+  if (shared) {
+    std::vector<SchemaTable> asked;
+    for (const auto &pair : missing) asked.push_back(pair.second);
+    std::vector<std::pair<SchemaTable, TableMetaPtr>> found;
+    shared = !shared_get_tables(target, asked, &found, &shared_epoch);
+    status_add(STATUS_SHARED_CACHE_HITS, found.size());
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    for (auto &pair : found) {
+      missing.erase(lower(pair.first.first.c_str()) + '.' +
+                    lower(pair.first.second.c_str()));
+      put_shared_entry(target, pair.first, std::move(pair.second));
+    }
+  }
+  /* A single table costs the same round trip either way. */
+  if (missing.size() < 2) return;
+  MYSQL *reader = get_audit_conn(ctx, mysql);
+
+  auto it = missing.begin();
+  while (it != missing.end()) {
+    std::map<std::string, std::shared_ptr<TableMeta>> wave;
+    std::string list;
+    for (size_t n = 0; it != missing.end() && n < PRELOAD_BATCH; ++it, ++n) {
+      if (!list.empty()) list += ',';
+      list += "('" + it->second.first + "','" + it->second.second + "')";
+      wave[it->first] = std::make_shared<TableMeta>();
+    }
+
+    std::vector<char> query(strlen(remote_sql::GET_TABLES_METADATA) +
+                            3 * list.size() + 1);
+    snprintf(query.data(), query.size(), remote_sql::GET_TABLES_METADATA,
+             list.c_str(), list.c_str(), list.c_str());
+    ctx->remote_queries++;
+    status_add(STATUS_REMOTE_QUERIES);
+    StageScope stage(stage_inception_remote_check);
+    QuerySlot slot(ctx, reader);
+    if (slot.killed()) return;
+    const auto start = std::chrono::steady_clock::now();
+    if (mysql_real_query(reader, query.data(),
+                         static_cast<unsigned long>(strlen(query.data()))))
+      return;
+    MYSQL_RES *res = mysql_store_result(reader);
+    ctx->remote_us += record_remote_latency(reader, REMOTE_METADATA, start);
+    if (!res) return;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+      if (!row[0] || !row[1] || !row[2]) continue;
+      auto w = wave.find(lower(row[1]) + '.' + lower(row[2]));
+      if (w == wave.end()) continue;
+      TableMeta &meta = *w->second;
+      switch (row[0][0]) {
+        case 'T':
+          meta.exists = true;
+          meta.table_rows = row[3] ? strtoll(row[3], nullptr, 10) : -1;
+          meta.table_bytes = row[4] ? strtoll(row[4], nullptr, 10) : -1;
+          meta.row_format = row[5] ? lower(row[5]) : "";
+          meta.avg_row_length = row[6] ? strtoll(row[6], nullptr, 10) : -1;
+          break;
+        case 'C':
+          if (row[3] && row[4])
+            meta.add_column(row[3], column_from_row(row + 4));
+          break;
+        case 'I':
+          if (row[3]) index_part_from_row(&meta, row + 3);
+          break;
+      }
+    }
+    mysql_free_result(res);
+
+    /* Missing on the --audit-host replica: get_table_meta() asks the
+       target when a statement needs them */
+    if (reader != mysql) {
+      for (auto w = wave.begin(); w != wave.end();)
+        w = w->second->exists ? std::next(w) : wave.erase(w);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (!cached) {
+      for (auto &pair : wave) {
+        const SchemaTable &ref = missing[pair.first];
+        pair.second->loaded_at = now;
+        if (pair.second->exists) ctx->statement_schemas.insert(ref.first);
+        ctx->statement_meta[ref.first + '.' + ref.second] =
+            std::move(pair.second);
+      }
+      continue;
+    }
+    if (shared) status_add(STATUS_SHARED_CACHE_MISSES, wave.size());
+    std::vector<std::pair<SchemaTable, TableMetaPtr>> loaded;
+    std::unique_lock<InceptionMutex> lock(g_cache_mutex);
+    /* Invalidated during the load: leave the rest to get_table_meta() */
+    if (watch_epoch(target) != epoch) return;
+    const bool pin = can_pin(target, epoch);
+    for (auto &pair : wave) {
+      const SchemaTable &ref = missing[pair.first];
+      if (shared) loaded.emplace_back(ref, pair.second);
+      pair.second->loaded_at = now;
+      if (pair.second->exists) {
+        /* A database holding a table exists: no SHOW DATABASES for it */
+        SchemaEntry &schema = g_schemas[schema_key(target, ref.first)];
+        if (schema.target.empty() || !schema.exists) {
+          schema.exists = true;
+          schema.target = target;
+          schema.db_name = ref.first;
+          schema.hits = 0;
+          schema.loaded_at = now;
+        }
+      }
+      evict_for_insert(now);
+      CacheEntry &entry = g_tables[table_key(target, ref.first, ref.second)];
+      entry.meta = pair.second;
+      entry.target = target;
+      entry.db_name = ref.first;
+      entry.table_name = ref.second;
+      entry.hits = 0;
+      entry.pinned = pin;
+    }
+    lock.unlock();
+    if (shared) shared_put_tables(target, loaded, shared_epoch);
+  }
+}
+
+/**
+ * SHOW DATABASES LIKE db on mysql. Returns true on error; *exists is set
+ * otherwise.
+ */
+static bool query_db_exists(InceptionContext *ctx, MYSQL *mysql,
+                            const char *db, bool *exists) {
+  char query[256];
+  snprintf(query, sizeof(query), remote_sql::SHOW_DATABASES_LIKE, db);
+  StageScope stage(stage_inception_remote_check);
+  QuerySlot slot(ctx, mysql);
+  if (slot.killed()) return true;
+  const auto start = std::chrono::steady_clock::now();
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  ctx->remote_us += record_remote_latency(mysql, REMOTE_METADATA, start);
+  if (!res) return true;
+  *exists = (mysql_num_rows(res) > 0);
+  mysql_free_result(res);
+  return false;
+}
+
+bool cached_db_exists(InceptionContext *ctx, MYSQL *mysql, const char *db) {
+  if (ctx->shadow && db) return shadow_db_exists(*ctx->shadow, db);
+  if (!mysql || !db) return false;
+  if (opt_metadata_cache_ttl == 0 && ctx->statement_schemas.count(db))
+    return true;
+  const std::string target = cache_target(ctx);
+
+  uint64_t epoch = 0;
+  if (opt_metadata_cache_ttl > 0) {
+    learn_name_case(ctx, target, mysql);
+    sync_shared_epoch(target);
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    epoch = watch_epoch(target);
+    auto it = g_schemas.find(schema_key(target, db));
+    if (it != g_schemas.end()) {
+      if (!expired(it->second.loaded_at, std::chrono::steady_clock::now())) {
+        it->second.hits++;
+        status_add(STATUS_CACHE_HITS);
+        return it->second.exists;
+      }
+      g_schemas.erase(it);
+    }
+  }
+
+  ctx->remote_queries++;
+  status_add(STATUS_CACHE_MISSES);
+  status_add(STATUS_REMOTE_QUERIES);
+  bool exists = false;
+  MYSQL *reader = get_audit_conn(ctx, mysql);
+  if (query_db_exists(ctx, reader, db, &exists) && reader == mysql)
+    return false;
+  /* Not on the --audit-host replica: it may not have caught up */
+  if (reader != mysql && !exists) {
+    ctx->remote_queries++;
+    status_add(STATUS_REMOTE_QUERIES);
+    if (query_db_exists(ctx, mysql, db, &exists)) return false;
+  }
+
+  if (opt_metadata_cache_ttl > 0) {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    if (watch_epoch(target) != epoch) return exists;
+    SchemaEntry &entry = g_schemas[schema_key(target, db)];
+    entry.exists = exists;
+    entry.target = target;
+    entry.db_name = db;
+    entry.hits = 0;
+    entry.loaded_at = std::chrono::steady_clock::now();
+  }
+  return exists;
+}
+
+uint64_t cache_schema_epoch(const std::string &target, bool *watched) {
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  auto it = g_watch.find(target);
+  *watched = it != g_watch.end() && it->second.live;
+  return it == g_watch.end() ? 0 : it->second.epoch;
+}
+
+void cache_invalidate_table(const std::string &target, const std::string &db,
+                            const std::string &table) {
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    g_tables.erase(table_key(target, db, table));
+    g_watch[target].epoch++;
+  }
+  if (shared_cache_enabled()) shared_bump_epoch(target);
+}
+
+void cache_invalidate_schema(const std::string &target, const std::string &db) {
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    g_watch[target].epoch++;
+    g_schemas.erase(schema_key(target, db));
+    const std::string prefix = schema_key(target, db) + '.';
+    auto it = g_tables.lower_bound(prefix);
+    while (it != g_tables.end() &&
+           it->first.compare(0, prefix.size(), prefix) == 0)
+      it = g_tables.erase(it);
+  }
+  if (shared_cache_enabled()) shared_bump_epoch(target);
+}
+
+void cache_invalidate_ddl(const std::string &target, const std::string &db,
+                          const std::string &table) {
+  const std::string ldb = lower(db.c_str());
+  const std::string ltable = lower(table.c_str());
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    g_watch[target].epoch++;
+    for (auto it = g_schemas.begin(); it != g_schemas.end();) {
+      if (table.empty() && it->second.target == target &&
+          lower(it->second.db_name.c_str()) == ldb)
+        it = g_schemas.erase(it);
+      else
+        ++it;
+    }
+    for (auto it = g_tables.begin(); it != g_tables.end();) {
+      const CacheEntry &e = it->second;
+      if (e.target == target && lower(e.db_name.c_str()) == ldb &&
+          (table.empty() || lower(e.table_name.c_str()) == ltable))
+        it = g_tables.erase(it);
+      else
+        ++it;
+    }
+  }
+  /* Every instance's watcher sees the DDL; the extra bumps are harmless */
+  if (shared_cache_enabled()) shared_bump_epoch(target);
+}
+
+void cache_set_watched(const std::string &target, bool live) {
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  WatchState &w = g_watch[target];
+  if (w.live == live) return;
+  w.live = live;
+  w.epoch++;
+  if (live) return;
+  /* DDL may now go unseen: back to the TTL */
+  for (auto &pair : g_tables)
+    if (pair.second.target == target) pair.second.pinned = false;
+}
+
+void cache_put_pinned(const std::string &target, const std::string &db,
+                      const std::string &table, TableMetaPtr meta) {
+  if (opt_metadata_cache_ttl == 0) return;
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  auto w = g_watch.find(target);
+  if (w == g_watch.end() || !w->second.live) return;
+  const std::string key = table_key(target, db, table);
+  if (g_tables.count(key) == 0) evict_for_insert(meta->loaded_at);
+  CacheEntry &entry = g_tables[key];
+  entry.meta = std::move(meta);
+  entry.target = target;
+  entry.db_name = db;
+  entry.table_name = table;
+  entry.hits = 0;
+  entry.pinned = true;
+}
+
+std::vector<std::pair<SchemaTable, TableMetaPtr>> cache_pinned_tables(
+    const std::string &target) {
+  std::vector<std::pair<SchemaTable, TableMetaPtr>> result;
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  for (const auto &pair : g_tables) {
+    const CacheEntry &e = pair.second;
+    if (e.pinned && e.target == target)
+      result.emplace_back(SchemaTable(e.db_name, e.table_name), e.meta);
+  }
+  return result;
+}
+
+/** Learned speed of target for kind (an ALTER algorithm or "BINLOG"). */
+static double learned_speed(const std::string &target, const std::string &kind,
+                            ulong default_speed) {
+  /* The shared speed has the statements of every instance */
+  double speed;
+  if (shared_cache_enabled() && shared_rebuild_speed(target, kind, &speed))
+    return speed;
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  auto it = g_rebuild_speed.find(target + '/' + kind);
+  return it != g_rebuild_speed.end() ? it->second
+                                     : static_cast<double>(default_speed);
+}
+
+static void note_speed(const std::string &target, const std::string &kind,
+                       int64_t bytes, double seconds) {
+  const double mb = static_cast<double>(bytes) / (1024.0 * 1024.0);
+  if (mb < 1.0 || seconds < 1.0) return;
+  const double speed = mb / seconds;
+  {
+    std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+    auto ins = g_rebuild_speed.emplace(target + '/' + kind, speed);
+    /* Weighted toward the recent runs: the target's load changes */
+    if (!ins.second)
+      ins.first->second = 0.7 * ins.first->second + 0.3 * speed;
+  }
+  if (shared_cache_enabled()) shared_note_rebuild(target, kind, speed);
+}
+
+double cache_rebuild_speed(const std::string &target,
+                           const std::string &algorithm) {
+  return learned_speed(target, algorithm, opt_ddl_rebuild_speed);
+}
+
+void cache_note_rebuild(const std::string &target,
+                        const std::string &algorithm, int64_t bytes,
+                        double seconds) {
+  note_speed(target, algorithm, bytes, seconds);
+}
+
+double cache_apply_speed(const std::string &target) {
+  return learned_speed(target, "BINLOG", opt_replica_apply_speed);
+}
+
+void cache_note_apply(const std::string &target, int64_t bytes,
+                      double seconds) {
+  note_speed(target, "BINLOG", bytes, seconds);
+}
+
+std::vector<CacheEntryInfo> get_cache_entries() {
+  std::lock_guard<InceptionMutex> lock(g_cache_mutex);
+  std::vector<CacheEntryInfo> result;
+  auto now = std::chrono::steady_clock::now();
+  for (auto &pair : g_schemas) {
+    const SchemaEntry &e = pair.second;
+    if (expired(e.loaded_at, now)) continue;
+    CacheEntryInfo ci;
+    ci.target = e.target;
+    ci.db_name = e.db_name;
+    ci.exists = e.exists;
+    ci.columns = 0;
+    ci.indexes = 0;
+    ci.table_rows = -1;
+    ci.hits = e.hits;
+    ci.age_sec = std::chrono::duration<double>(now - e.loaded_at).count();
+    result.push_back(std::move(ci));
+  }
+  for (auto &pair : g_tables) {
+    const CacheEntry &e = pair.second;
+    if (stale(e, now)) continue;
+    CacheEntryInfo ci;
+    ci.target = e.target;
+    ci.db_name = e.db_name;
+    ci.table_name = e.table_name;
+    ci.exists = e.meta->exists;
+    ci.columns = static_cast<int>(e.meta->columns.size());
+    ci.indexes = static_cast<int>(e.meta->indexes.size());
+    ci.table_rows = e.meta->table_rows;
+    ci.hits = e.hits;
+    ci.watched = e.pinned;
+    ci.age_sec =
+        std::chrono::duration<double>(now - e.meta->loaded_at).count();
+    result.push_back(std::move(ci));
+  }
+  return result;
+}
+
+void start_schema_prefetch(InceptionContext *ctx, const char *db) {
+  if (!opt_metadata_prefetch || opt_metadata_cache_ttl == 0) return;
+  if (ctx->mode != OpMode::CHECK && ctx->mode != OpMode::EXECUTE) return;
+  if (!db || !*db || !ctx->prefetch_db.empty() || ctx->remote_conn_failed ||
+      ctx->shadow)
+    return;
+
+  ctx->prefetch_db = db;
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  std::string password = ctx->password;
+  uint port = ctx->port;
+  const auto audit_server = ctx->audit_server;
+  std::string target = cache_target(ctx);
+  std::string schema = db;
+  std::atomic<long> *tables_out = &ctx->prefetch_tables;
+  std::atomic<long> *ms_out = &ctx->prefetch_ms;
+
+  auto work = [=]() {
+    if (my_thread_init()) return;
+    bind_worker_resource_group();
+    auto start = std::chrono::steady_clock::now();
+    long loaded = -1;
+    PoolConnOptions opts;
+    opts.connect_timeout = 5;
+    opts.read_timeout = 60;
+    std::string errmsg;
+    MYSQL *mysql = nullptr;
+    /* The --audit-host replica when it is in sync, else the target */
+    if (!audit_server.first.empty()) {
+      mysql = pool_acquire(audit_server.first, audit_server.second, user,
+                           password, opts, &errmsg);
+      if (mysql && !audit_host_usable(mysql, &errmsg)) {
+        pool_release(mysql, PoolRelease::CLEAN);
+        mysql = nullptr;
+      }
+    }
+    if (!mysql) mysql = pool_acquire(host, port, user, password, opts, &errmsg);
+    if (mysql) {
+      loaded = prefetch_schema(mysql, target, schema);
+      pool_release(mysql, PoolRelease::CLEAN);
+    }
+    long ms = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    if (loaded < 0) {
+      fprintf(stderr, "[Inception] Metadata prefetch of %s/%s failed.\n",
+              target.c_str(), schema.c_str());
+      fflush(stderr);
+      loaded = 0;
+    }
+    ms_out->store(ms);
+    tables_out->store(loaded);
+    my_thread_end();
+  };
+
+  try {
+    ctx->prefetch_thread = std::thread(work);
+  } catch (const std::system_error &) {
+    /* No thread available: audit falls back to on-demand loading. */
+  }
+}
+
+namespace {
+
+/** The schemas of one target to warm, in the order configured. */
+struct WarmupTarget {
+  std::string host;
+  uint port = 3306;
+  std::vector<std::string> schemas;
+};
+
+/** Parse "host[:port]/db, ..." into targets; bad entries are logged. */
+std::vector<WarmupTarget> parse_warmup_list(const char *list) {
+  std::vector<WarmupTarget> targets;
+  const std::string s(list);
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t end = s.find(',', start);
+    if (end == std::string::npos) end = s.size();
+    std::string entry = s.substr(start, end - start);
+    start = end + 1;
+    const size_t first = entry.find_first_not_of(" \t");
+    if (first == std::string::npos) continue;
+    entry = entry.substr(first, entry.find_last_not_of(" \t") - first + 1);
+
+    const size_t slash = entry.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 == entry.size()) {
+      fprintf(stderr,
+              "[Inception] Ignoring metadata warm-up entry '%s': expected "
+              "host:port/schema.\n",
+              entry.c_str());
+      fflush(stderr);
+      continue;
+    }
+    std::string host = entry.substr(0, slash);
+    uint port = 3306;
+    const size_t colon = host.rfind(':');
+    if (colon != std::string::npos) {
+      port = static_cast<uint>(strtoul(host.c_str() + colon + 1, nullptr, 10));
+      host.erase(colon);
+    }
+    WarmupTarget *target = nullptr;
+    for (auto &t : targets)
+      if (t.host == host && t.port == port) target = &t;
+    if (!target) {
+      targets.emplace_back();
+      target = &targets.back();
+      target->host = host;
+      target->port = port;
+    }
+    target->schemas.push_back(entry.substr(slash + 1));
+  }
+  return targets;
+}
+
+}  // namespace
+
+void start_schema_warmup() {
+  if (!opt_metadata_warm_schemas || !*opt_metadata_warm_schemas ||
+      opt_metadata_cache_ttl == 0)
+    return;
+  std::string user = opt_inception_user ? opt_inception_user : "";
+  if (user.empty()) user = "root";
+  const std::string password =
+      decrypt_password(opt_inception_password ? opt_inception_password : "");
+
+  for (const WarmupTarget &t : parse_warmup_list(opt_metadata_warm_schemas)) {
+    auto work = [t, user, password]() {
+      if (my_thread_init()) return;
+      const std::string target = t.host + ':' + std::to_string(t.port);
+      PoolConnOptions opts;
+      opts.connect_timeout = 5;
+      opts.read_timeout = 60;
+      std::string errmsg;
+      MYSQL *mysql = pool_acquire(t.host, t.port, user, password, opts, &errmsg);
+      if (!mysql) {
+        fprintf(stderr, "[Inception] Metadata warm-up of %s failed: %s\n",
+                target.c_str(), errmsg.c_str());
+        fflush(stderr);
+        my_thread_end();
+        return;
+      }
+      bool failed = false;
+      for (const auto &schema : t.schemas) {
+        if (g_warmup_stop.load()) break;
+        auto start = std::chrono::steady_clock::now();
+        const long loaded = prefetch_schema(mysql, target, schema);
+        const long ms = static_cast<long>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+        if (loaded < 0) {
+          fprintf(stderr, "[Inception] Metadata warm-up of %s/%s failed.\n",
+                  target.c_str(), schema.c_str());
+          failed = true;
+        } else {
+          fprintf(stderr,
+                  "[Inception] Metadata warm-up of %s/%s: %ld tables in "
+                  "%ld ms.\n",
+                  target.c_str(), schema.c_str(), loaded, ms);
+        }
+        fflush(stderr);
+        if (failed) break;
+      }
+      pool_release(mysql, failed ? PoolRelease::DIRTY : PoolRelease::CLEAN);
+      my_thread_end();
+    };
+    try {
+      g_warmup_threads.emplace_back(work);
+    } catch (const std::system_error &) {
+      /* No thread available: the target is loaded on demand. */
+    }
+  }
+}
+
+void schema_warmup_shutdown() {
+  g_warmup_stop.store(true);
+  for (auto &t : g_warmup_threads) t.join();
+  g_warmup_threads.clear();
+}
+
+}  // namespace inception
@@ -0,0 +1,247 @@
+/**
+ * @file inception_cache.h
+ * @brief Remote schema metadata cache shared by inception sessions.
+ *
+ * The audit rules ask many small questions about the remote target
+ * (does the table exist, does this column exist, what is its type, ...).
+ * Instead of one round trip per question, the first reference to a table
+ * loads its row estimate, size, columns and index names in a single query;
+ * later checks are answered from memory.
+ *
+ * Entries are keyed by target (host:port) + schema + table, shared across
+ * sessions, expire after inception_metadata_cache_ttl seconds and are
+ * invalidated when EXECUTE mode runs DDL against the table. On a target
+ * with lower_case_table_names set, the names in the key are lower-cased.
+ * A load that overlaps an invalidation of its target is not stored.
+ *
+ * A session with --schema-file answers from its shadow catalog instead
+ * (inception_shadow.h) and never touches the shared entries.
+ *
+ * With inception_metadata_snapshot_dir set, a binlog watcher per target
+ * (inception_snapshot.h) invalidates entries on DDL, so entries loaded
+ * while it streams are pinned: they stay until DDL touches their table
+ * instead of expiring after the TTL.
+ *
+ * With inception_shared_cache_host set, a miss asks the tier the inception
+ * instances share (inception_shared.h) before the target.
+ *
+ * Next to the metadata, the cache keeps what each target's native ALTERs
+ * have shown of its rebuild speed, for the estimated_time of later ones.
+ */
+
+#ifndef SQL_INCEPTION_CACHE_H
+#define SQL_INCEPTION_CACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+struct InceptionContext;
+
+/** Column type info from information_schema.COLUMNS. */
+struct RemoteColumnInfo {
+  std::string data_type;       /* e.g. "int", "varchar", "text" */
+  int64_t char_max_length;     /* CHARACTER_MAXIMUM_LENGTH, -1 if N/A */
+  int64_t numeric_precision;   /* NUMERIC_PRECISION, -1 if N/A */
+  int64_t numeric_scale;       /* NUMERIC_SCALE, -1 if N/A */
+  std::string charset;         /* CHARACTER_SET_NAME, "" if N/A or unknown */
+  bool nullable = true;        /* IS_NULLABLE */
+  bool is_unsigned = false;    /* COLUMN_TYPE says unsigned */
+  std::vector<std::string> values;  /* ENUM / SET members, in order */
+};
+
+/** Definition of one index, as far as redundancy checks compare them. */
+struct IndexInfo {
+  bool unique = false;   /* PRIMARY or UNIQUE */
+  bool ordered = true;   /* BTREE / HASH, not FULLTEXT or SPATIAL */
+  /* Lower-case column names in key order, "name(len)" for a prefix and
+     "()" for an expression part */
+  std::vector<std::string> parts;
+};
+
+/** Metadata of one remote table, loaded in a single round trip. */
+struct TableMeta {
+  bool exists = false;
+  int64_t table_rows = -1;                          /* TABLE_ROWS estimate */
+  int64_t table_bytes = -1;                         /* DATA_ + INDEX_LENGTH */
+  std::string row_format;                           /* lower-case, "" unknown */
+  int64_t avg_row_length = -1;                      /* AVG_ROW_LENGTH */
+  std::map<std::string, RemoteColumnInfo> columns;  /* key: lower-case name */
+  std::vector<std::string> column_order;  /* names as stored, by position */
+  std::set<std::string> indexes;                    /* lower-case names */
+  std::map<std::string, IndexInfo> index_defs;      /* key: lower-case name */
+  std::chrono::steady_clock::time_point loaded_at;
+
+  /** Add name (or update it in place) at the end of column_order. */
+  void add_column(const std::string &name, const RemoteColumnInfo &info);
+  void drop_column(const std::string &name);
+
+  const RemoteColumnInfo *find_column(const char *name) const;
+  bool has_index(const char *name) const;
+};
+
+using TableMetaPtr = std::shared_ptr<const TableMeta>;
+
+/** Cache key prefix of the session's remote target: "host:port". */
+std::string cache_target(const InceptionContext *ctx);
+
+/**
+ * Get metadata of db.table on the session's target, loading it through
+ * mysql on a miss. Returns nullptr if the remote query failed.
+ * Thread-safe; the returned snapshot stays valid after invalidation.
+ * Here and below, every query sent counts in ctx->remote_queries.
+ */
+TableMetaPtr get_table_meta(InceptionContext *ctx, MYSQL *mysql,
+                            const char *db, const char *table);
+
+/** A (schema, table) reference of the statement being audited. */
+using SchemaTable = std::pair<std::string, std::string>;
+
+/**
+ * Load every uncached table of refs in one round trip, so the per-table
+ * checks of the statement that follows are answered from the cache; a
+ * database with one of them is known to exist too. With the cache
+ * disabled the tables go to ctx->statement_meta for the statement being
+ * audited only (see StatementMetaScope). No-op for a single table.
+ */
+void preload_table_meta(InceptionContext *ctx, MYSQL *mysql,
+                        const std::vector<SchemaTable> &refs);
+
+/**
+ * The audit of one statement. With inception_metadata_cache_ttl = 0,
+ * get_table_meta() and cached_db_exists() answer from what
+ * preload_table_meta() loaded inside the scope; it is dropped at its end,
+ * so that no later statement, nor the execution, sees it.
+ */
+class StatementMetaScope {
+ public:
+  explicit StatementMetaScope(InceptionContext *ctx) : m_ctx(ctx) {}
+  ~StatementMetaScope();
+  StatementMetaScope(const StatementMetaScope &) = delete;
+  StatementMetaScope &operator=(const StatementMetaScope &) = delete;
+
+ private:
+  InceptionContext *m_ctx;
+};
+
+/**
+ * Check whether a database exists on the session's target (cached).
+ * Returns false if it does not exist or the remote query failed.
+ */
+bool cached_db_exists(InceptionContext *ctx, MYSQL *mysql, const char *db);
+
+/**
+ * Start loading every table of db into the cache on a background thread,
+ * with one query each against information_schema TABLES, COLUMNS and
+ * STATISTICS. At most one prefetch per session; progress is published in
+ * ctx->prefetch_tables / ctx->prefetch_ms. Owning thread only.
+ */
+void start_schema_prefetch(InceptionContext *ctx, const char *db);
+
+/**
+ * Start loading the schemas of inception_metadata_warm_schemas into the
+ * cache, the way start_schema_prefetch() does, on a thread per target and
+ * with inception_user / inception_password. Called once at server startup.
+ */
+void start_schema_warmup();
+
+/** Let the warm-up threads finish the schema they load. At shutdown. */
+void schema_warmup_shutdown();
+
+/**
+ * Schema version of target, bumped by every invalidation below and by the
+ * binlog watcher starting or stopping; *watched tells whether the watcher
+ * streams, so that no DDL goes unseen. Results derived from the target's
+ * schema elsewhere compare it to notice DDL.
+ */
+uint64_t cache_schema_epoch(const std::string &target, bool *watched);
+
+/** Drop the cached entry of one table. */
+void cache_invalidate_table(const std::string &target, const std::string &db,
+                            const std::string &table);
+
+/** Drop the cached schema entry and all its tables. */
+void cache_invalidate_schema(const std::string &target, const std::string &db);
+
+/**
+ * Drop the entries of db.table, or of all of db when table is empty,
+ * comparing names case-insensitively. Used for DDL seen in the binlog.
+ */
+void cache_invalidate_ddl(const std::string &target, const std::string &db,
+                          const std::string &table);
+
+/**
+ * Mark the binlog watcher of target as streaming or not. Entries loaded
+ * while it streams are pinned; when it stops, pinned entries fall back to
+ * the TTL.
+ */
+void cache_set_watched(const std::string &target, bool live);
+
+/** Store a pinned entry from a snapshot file. No-op unless watched. */
+void cache_put_pinned(const std::string &target, const std::string &db,
+                      const std::string &table, TableMetaPtr meta);
+
+/** The pinned entries of target, for its snapshot file. */
+std::vector<std::pair<SchemaTable, TableMetaPtr>> cache_pinned_tables(
+    const std::string &target);
+
+/**
+ * Rebuild speed of target for algorithm ("INPLACE" or "COPY") in MB/s,
+ * learned from the native ALTERs executed against it since startup;
+ * inception_ddl_rebuild_speed until one of them has been timed.
+ */
+double cache_rebuild_speed(const std::string &target,
+                           const std::string &algorithm);
+
+/**
+ * Learn from a native ALTER of algorithm that went through bytes of data
+ * and indexes in seconds. Runs under a second or a MB are ignored: their
+ * time is mostly locking and round trips.
+ */
+void cache_note_rebuild(const std::string &target,
+                        const std::string &algorithm, int64_t bytes,
+                        double seconds);
+
+/**
+ * MB/s of row events the replicas of target apply, learned like the
+ * rebuild speed from the UPDATE/DELETE statements executed against it;
+ * inception_replica_apply_speed until one of them has been timed.
+ */
+double cache_apply_speed(const std::string &target);
+
+/**
+ * Learn from an UPDATE/DELETE whose row events of bytes took seconds on the
+ * target: a replica applying them alone needs about the same time.
+ */
+void cache_note_apply(const std::string &target, int64_t bytes,
+                      double seconds);
+
+/** Snapshot of one cache entry for "inception show cache". */
+struct CacheEntryInfo {
+  std::string target;
+  std::string db_name;
+  std::string table_name;   /* empty for schema-existence entries */
+  bool exists;
+  int columns;
+  int indexes;
+  int64_t table_rows;
+  uint64_t hits;
+  double age_sec;
+  bool watched = false;     /* pinned by the binlog watcher */
+};
+
+/** Collect all live (non-expired) cache entries. Thread-safe. */
+std::vector<CacheEntryInfo> get_cache_entries();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_CACHE_H
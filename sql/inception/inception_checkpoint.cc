@@ -0,0 +1,288 @@
+/**
+ * @file inception_checkpoint.cc
+ * @brief Persisted execution checkpoints for --resume.
+ */
+
+#include "sql/inception/inception_checkpoint.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"  // bare_statement
+#include "sql/inception/inception_sysvars.h"
+
+#include "include/sha1.h"  // compute_sha1_hash, SHA1_HASH_SIZE
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace inception {
+
+static const char *CHECKPOINT_MAGIC = "inception_checkpoint 1";
+static const char *CHECKPOINT_SUFFIX = ".ckpt";
+
+/* Tells apart batches started in the same second */
+static std::atomic<unsigned> g_batch_seq{0};
+
+static std::string text_sha1(const std::string &text) {
+  uint8 hash[SHA1_HASH_SIZE];
+  compute_sha1_hash(hash, text.data(), text.size());
+  char hex[SHA1_HASH_SIZE * 2 + 1];
+  for (int i = 0; i < SHA1_HASH_SIZE; i++)
+    snprintf(hex + i * 2, 3, "%02x", hash[i]);
+  return hex;
+}
+
+/* Batch ids become file names: no path separators, no dots */
+static bool valid_batch_id(const std::string &id) {
+  if (id.empty() || id.size() > 64) return false;
+  for (char c : id)
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-')
+      return false;
+  return true;
+}
+
+static std::string checkpoint_dir() {
+  const char *dir = opt_exec_checkpoint_dir;
+  return dir && *dir ? dir : "";
+}
+
+static std::string target_of(const InceptionContext *ctx) {
+  std::string host = ctx->host;
+  for (auto &c : host) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return host + ":" + std::to_string(ctx->port);
+}
+
+/** Parsed checkpoint file. */
+struct CheckpointFile {
+  std::string target;
+  std::vector<std::string> nodes;
+  int completed = 0;
+  int chunk_node = 0;
+  long chunks = 0;
+  int64_t chunk_rows = 0;
+  std::string boundary;
+};
+
+/** Returns true if path is missing or not a checkpoint. */
+static bool read_checkpoint(const std::string &path, CheckpointFile *out) {
+  std::ifstream in(path);
+  std::string line;
+  if (!in || !std::getline(in, line) || line != CHECKPOINT_MAGIC) return true;
+  while (std::getline(in, line)) {
+    std::istringstream words(line);
+    std::string key;
+    words >> key;
+    if (key == "target") {
+      words >> out->target;
+    } else if (key == "node") {
+      out->nodes.push_back(line.substr(5));
+    } else if (key == "completed") {
+      words >> out->completed;
+    } else if (key == "chunk") {
+      words >> out->chunk_node >> out->chunks >> out->chunk_rows >>
+          out->boundary;
+    }
+  }
+  return out->target.empty();
+}
+
+std::vector<CheckpointInfo> list_checkpoints() {
+  std::vector<CheckpointInfo> result;
+  const std::string dir = checkpoint_dir();
+  if (dir.empty()) return result;
+  DIR *d = opendir(dir.c_str());
+  if (!d) return result;
+  const size_t suffix_len = strlen(CHECKPOINT_SUFFIX);
+  while (struct dirent *e = readdir(d)) {
+    std::string name = e->d_name;
+    if (name.size() <= suffix_len ||
+        name.compare(name.size() - suffix_len, suffix_len,
+                     CHECKPOINT_SUFFIX) != 0)
+      continue;
+    const std::string path = dir + "/" + name;
+    CheckpointFile f;
+    if (read_checkpoint(path, &f)) continue;
+    CheckpointInfo ci;
+    ci.batch_id = name.substr(0, name.size() - suffix_len);
+    size_t colon = f.target.rfind(':');
+    ci.host = f.target.substr(0, colon);
+    if (colon != std::string::npos)
+      ci.port = static_cast<uint>(strtoul(f.target.c_str() + colon + 1,
+                                          nullptr, 10));
+    ci.total_sql = static_cast<int>(f.nodes.size());
+    ci.completed_id = f.completed;
+    ci.chunk_node_id = f.chunk_node;
+    ci.chunks = f.chunks;
+    ci.chunk_rows = f.chunk_rows;
+    ci.chunk_boundary = f.boundary;
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0) ci.updated = st.st_mtime;
+    result.push_back(std::move(ci));
+  }
+  closedir(d);
+  std::sort(result.begin(), result.end(),
+            [](const CheckpointInfo &a, const CheckpointInfo &b) {
+              return a.updated != b.updated ? a.updated < b.updated
+                                            : a.batch_id < b.batch_id;
+            });
+  return result;
+}
+
+bool BatchCheckpoint::open(InceptionContext *ctx, std::string *err) {
+  const std::string dir = checkpoint_dir();
+  const std::string &resume = ctx->resume_batch;
+  if (dir.empty()) {
+    if (resume.empty()) return false;
+    *err = "--resume needs inception_exec_checkpoint_dir.";
+    return true;
+  }
+
+  m_target = target_of(ctx);
+  for (const auto &node : ctx->cache_nodes) {
+    m_nodes.push_back(std::to_string(node.id) + " " +
+                      (node.sqlsha1.empty() ? "-" : node.sqlsha1) + " " +
+                      text_sha1(bare_statement(node)));
+    m_last_id = node.id;
+  }
+
+  if (!resume.empty()) {
+    if (!valid_batch_id(resume)) {
+      *err = "Invalid --resume batch id '" + resume + "'.";
+      return true;
+    }
+    CheckpointFile f;
+    if (read_checkpoint(dir + "/" + resume + CHECKPOINT_SUFFIX, &f)) {
+      *err = "No checkpoint '" + resume + "' in " + dir + ".";
+      return true;
+    }
+    if (f.target != m_target) {
+      *err = "Checkpoint '" + resume + "' is for " + f.target + ", not " +
+             m_target + ".";
+      return true;
+    }
+    if (f.nodes != m_nodes) {
+      size_t n = 0;
+      while (n < f.nodes.size() && n < m_nodes.size() &&
+             f.nodes[n] == m_nodes[n])
+        n++;
+      *err = "Checkpoint '" + resume + "' was written for other statements "
+             "(they differ from statement " + std::to_string(n + 1) +
+             " on); resubmit the original batch.";
+      return true;
+    }
+    m_id = resume;
+    m_completed = f.completed;
+    m_resumed_through = f.completed;
+    m_chunk_node = f.chunk_node;
+    m_chunks = f.chunks;
+    m_chunk_rows = f.chunk_rows;
+    m_boundary = f.boundary;
+  } else {
+    char id[64];
+    time_t now = time(nullptr);
+    struct tm tm_buf;
+    localtime_r(&now, &tm_buf);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d%H%M%S", &tm_buf);
+    /* A restart resets the sequence: skip ids already on disk */
+    do {
+      snprintf(id, sizeof(id), "%s_%u", stamp, ++g_batch_seq);
+    } while (access((dir + "/" + id + CHECKPOINT_SUFFIX).c_str(), F_OK) == 0);
+    m_id = id;
+  }
+
+  m_path = dir + "/" + m_id + CHECKPOINT_SUFFIX;
+  save();
+  fprintf(stderr, "[Inception] Checkpoint %s for %s%s\n", m_id.c_str(),
+          m_target.c_str(),
+          m_resumed_through > 0
+              ? (", resuming after statement " +
+                 std::to_string(m_resumed_through) + ".").c_str()
+              : ".");
+  fflush(stderr);
+  return false;
+}
+
+bool BatchCheckpoint::resumed_chunk(int node_id, std::string *boundary,
+                                    long *chunks, int64_t *rows) const {
+  if (node_id <= m_resumed_through || node_id != m_chunk_node ||
+      m_boundary.empty())
+    return false;
+  *boundary = m_boundary;
+  *chunks = m_chunks;
+  *rows = m_chunk_rows;
+  return true;
+}
+
+void BatchCheckpoint::finished(int node_id, bool failed) {
+  if (!active()) return;
+  if (failed) m_broken = true;
+  if (m_broken || node_id <= m_completed) return;
+  m_completed = node_id;
+  if (m_chunk_node == node_id) {
+    m_chunk_node = 0;
+    m_boundary.clear();
+  }
+  save();
+}
+
+void BatchCheckpoint::chunk_done(int node_id, const std::string &boundary,
+                                 long chunks, int64_t rows) {
+  if (!active() || m_broken) return;
+  m_chunk_node = node_id;
+  m_boundary = boundary;
+  m_chunks = chunks;
+  m_chunk_rows = rows;
+  save();
+}
+
+void BatchCheckpoint::close() {
+  if (!active()) return;
+  /* Done, or nothing to resume from */
+  if ((!m_broken && m_completed >= m_last_id) ||
+      (m_completed == 0 && m_chunk_node == 0)) {
+    unlink(m_path.c_str());
+  } else {
+    fprintf(stderr, "[Inception] Checkpoint %s kept after statement %d; "
+            "resubmit with --resume=%s to continue.\n", m_id.c_str(),
+            m_completed, m_id.c_str());
+    fflush(stderr);
+  }
+  m_path.clear();
+}
+
+/** Rewrite the file: write a temporary, fsync, rename over the old one. */
+void BatchCheckpoint::save() {
+  const std::string tmp = m_path + ".tmp";
+  FILE *fp = fopen(tmp.c_str(), "w");
+  bool failed = !fp;
+  if (fp) {
+    fprintf(fp, "%s\ntarget %s\n", CHECKPOINT_MAGIC, m_target.c_str());
+    for (const auto &n : m_nodes) fprintf(fp, "node %s\n", n.c_str());
+    fprintf(fp, "completed %d\n", m_completed);
+    if (m_chunk_node > 0)
+      fprintf(fp, "chunk %d %ld %lld %s\n", m_chunk_node, m_chunks,
+              static_cast<long long>(m_chunk_rows), m_boundary.c_str());
+    failed = fflush(fp) != 0 || fsync(fileno(fp)) != 0;
+    failed = fclose(fp) != 0 || failed;
+    failed = failed || rename(tmp.c_str(), m_path.c_str()) != 0;
+  }
+  if (failed && !m_save_failed) {
+    fprintf(stderr, "[Inception] Cannot write checkpoint %s: %s\n",
+            m_path.c_str(), strerror(errno));
+    fflush(stderr);
+  }
+  m_save_failed = m_save_failed || failed;
+}
+
+}  // namespace inception
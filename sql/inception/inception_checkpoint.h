@@ -0,0 +1,111 @@
+/**
+ * @file inception_checkpoint.h
+ * @brief Persisted execution checkpoints for --resume.
+ *
+ * With inception_exec_checkpoint_dir set, every EXECUTE batch writes
+ * <dir>/<batch_id>.ckpt: its target, the sqlsha1 and a SHA1 of the text of
+ * each statement, the id of the last statement completed in order, and
+ * for chunked DML the primary key boundary of the last committed chunk.
+ * The file is rewritten (write, fsync, rename) after each completed
+ * statement and each chunk, so it survives a killed session or a mysqld
+ * restart, and is removed once the whole batch has completed.
+ *
+ * Resubmitting the same statements with --resume=<batch_id> checks that
+ * the target and every statement match, then skips the statements already
+ * completed (USE and SET still run, they only set up the session) and
+ * continues a chunked statement after its last boundary. Audit findings
+ * on the skipped statements describe the state the earlier run created
+ * (e.g. "table already exists") and do not block the batch.
+ *
+ * The last completed id only advances over a contiguous run of successes:
+ * a failed statement, even under --enable-force, is where a resume starts.
+ */
+
+#ifndef SQL_INCEPTION_CHECKPOINT_H
+#define SQL_INCEPTION_CHECKPOINT_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "my_inttypes.h"  // uint
+
+namespace inception {
+
+struct InceptionContext;
+
+/** One checkpoint file, for "inception show checkpoints". */
+struct CheckpointInfo {
+  std::string batch_id;
+  std::string host;
+  uint port = 0;
+  int total_sql = 0;
+  int completed_id = 0;     /* last statement completed in order, 0 = none */
+  int chunk_node_id = 0;    /* statement stopped between chunks, 0 = none */
+  long chunks = 0;
+  int64_t chunk_rows = 0;
+  std::string chunk_boundary;
+  time_t updated = 0;
+};
+
+/** Checkpoints in inception_exec_checkpoint_dir, oldest first. */
+std::vector<CheckpointInfo> list_checkpoints();
+
+class BatchCheckpoint {
+ public:
+  BatchCheckpoint() = default;
+  ~BatchCheckpoint() { close(); }
+  BatchCheckpoint(const BatchCheckpoint &) = delete;
+  BatchCheckpoint &operator=(const BatchCheckpoint &) = delete;
+
+  /**
+   * Start the checkpoint of ctx's batch: a new one, or with --resume the
+   * saved one. Inactive when no checkpoint directory is set. Returns true
+   * with *err set if --resume cannot continue this batch.
+   */
+  bool open(InceptionContext *ctx, std::string *err);
+
+  bool active() const { return !m_path.empty(); }
+
+  /** Statements up to this id completed in an earlier run (0 = none). */
+  int resumed_through() const { return m_resumed_through; }
+
+  /**
+   * Chunk position of node_id saved by an earlier run. Returns true with
+   * the last committed boundary and the chunks / rows done so far.
+   */
+  bool resumed_chunk(int node_id, std::string *boundary, long *chunks,
+                     int64_t *rows) const;
+
+  /** Statement node_id finished; persists the new position. */
+  void finished(int node_id, bool failed);
+
+  /** A chunk of node_id committed up to boundary; persists it. */
+  void chunk_done(int node_id, const std::string &boundary, long chunks,
+                  int64_t rows);
+
+  /** End of the batch: removes the file if every statement completed. */
+  void close();
+
+ private:
+  void save();
+
+  std::string m_path;
+  std::string m_id;
+  std::string m_target;                /* host:port */
+  std::vector<std::string> m_nodes;    /* "id sqlsha1 text-sha1" lines */
+  int m_last_id = 0;
+  int m_completed = 0;
+  int m_resumed_through = 0;
+  bool m_broken = false;               /* a statement failed */
+  int m_chunk_node = 0;
+  long m_chunks = 0;
+  int64_t m_chunk_rows = 0;
+  std::string m_boundary;
+  bool m_save_failed = false;          /* logged once */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_CHECKPOINT_H
@@ -0,0 +1,213 @@
+/**
+ * @file inception_coldata.cc
+ * @brief Whether the rows of a table fit a column an ALTER narrows,
+ *        measured on a replica.
+ */
+
+#include "sql/inception/inception_coldata.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"  // ChunkPacer, query_one_row
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace inception {
+
+namespace {
+
+/** One key range: pk >= lo (the first of the table) or pk > lo, pk <= hi. */
+struct Range {
+  std::string lo, hi;
+  bool first;
+};
+
+}  // namespace
+
+/**
+ * Cut db.table into ranges of inception_column_data_chunk_size rows of its
+ * key pk (quoted). An empty table has none. Returns true on error.
+ */
+static bool plan_ranges(MYSQL *mysql, const std::string &db,
+                        const std::string &table, const std::string &pk,
+                        std::vector<Range> *ranges) {
+  std::vector<std::string> bounds;
+  bool found = false;
+  std::string query = format_sql(remote_sql::CHUNK_PK_RANGE, pk.c_str(),
+                                 pk.c_str(), db.c_str(), table.c_str());
+  if (query_one_row(mysql, query, &bounds, &found)) return true;
+  if (!found) return false;
+  const std::string max_pk = bounds[1];
+
+  std::string lower = bounds[0];
+  bool first = true;
+  for (;;) {
+    std::vector<std::string> boundary;
+    query = format_sql(remote_sql::CHUNK_NEXT_BOUNDARY, pk.c_str(),
+                       db.c_str(), table.c_str(), pk.c_str(),
+                       first ? ">=" : ">", lower.c_str(), pk.c_str(),
+                       opt_column_data_chunk_size - 1);
+    if (query_one_row(mysql, query, &boundary, &found)) return true;
+    const std::string upper = found ? boundary[0] : max_pk;
+    ranges->push_back(Range{lower, upper, first});
+    if (!found || upper == max_pk) break;
+    lower = upper;
+    first = false;
+  }
+  return false;
+}
+
+/** Select list of the range query: one aggregate per column. */
+static std::string select_list(const std::vector<ColumnFit> &columns) {
+  std::string list;
+  for (const auto &fit : columns) {
+    const std::string col = quote_ident(fit.column);
+    if (!list.empty()) list += ", ";
+    if (fit.kind == ColumnFit::LENGTH)
+      list += "MAX(CHAR_LENGTH(" + col + "))";
+    else
+      list += "SUM(" + col + " < " + fit.lo + " OR " + col + " > " + fit.hi +
+              ")";
+  }
+  return list;
+}
+
+static void log_scan_error(const std::string &db, const std::string &table,
+                           const std::string &replica, const std::string &err) {
+  fprintf(stderr, "[Inception] inception_check_column_data: cannot scan "
+          "%s.%s on replica %s: %s\n", db.c_str(), table.c_str(),
+          replica.c_str(), err.c_str());
+  fflush(stderr);
+}
+
+void check_column_data(InceptionContext *ctx, SqlCacheNode *node, ulong level,
+                       const std::string &db, const std::string &table,
+                       const std::vector<ColumnFit> &columns) {
+  if (level == 0 || columns.empty() || ctx->slave_hosts.empty()) return;
+  const auto &replica = ctx->slave_hosts.front();
+  const std::string where =
+      replica.first + ":" + std::to_string(replica.second);
+
+  PoolConnOptions opts;
+  opts.connect_timeout = 10;
+  std::string err;
+  MYSQL *mysql = pool_acquire(replica.first, replica.second, ctx->user,
+                              ctx->password, opts, &err);
+  if (!mysql) {
+    log_scan_error(db, table, where, err);
+    return;
+  }
+  const std::string pk_name = single_integer_pk(mysql, db, table);
+  std::vector<Range> ranges;
+  const std::string pk = quote_ident(pk_name);
+  const std::string qdb = quote_ident(db);
+  const std::string qtable = quote_ident(table);
+  bool failed = false;
+  if (!pk_name.empty()) {
+    failed = plan_ranges(mysql, qdb, qtable, pk, &ranges);
+    if (failed) err = mysql_error(mysql);
+  }
+  pool_release(mysql, failed ? PoolRelease::DIRTY : PoolRelease::CLEAN);
+  if (failed) {
+    log_scan_error(db, table, where, err);
+    return;
+  }
+  if (pk_name.empty() || ranges.empty()) return;
+
+  /* Per column: longest value (LENGTH) or rows out of range (RANGE) */
+  std::vector<long long> found(columns.size(), 0);
+  std::mutex mutex;  /* guards found and err */
+  std::atomic<size_t> next{0};
+  ChunkPacer pacer(opt_column_data_max_chunks_per_sec);
+  const std::string list = select_list(columns);
+
+  auto record_error = [&](const std::string &message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!failed) err = message;
+    failed = true;
+  };
+
+  auto work = [&] {
+    if (my_thread_init()) {
+      record_error("cannot initialize a scan thread");
+      return;
+    }
+    bind_worker_resource_group();
+    std::string conn_err;
+    MYSQL *conn = pool_acquire(replica.first, replica.second, ctx->user,
+                               ctx->password, opts, &conn_err);
+    if (!conn) record_error(conn_err);
+    bool conn_ok = conn != nullptr;
+    for (;;) {
+      const size_t i = next.fetch_add(1);
+      if (i >= ranges.size() || !conn_ok || pacer.wait(ctx)) break;
+      const Range &r = ranges[i];
+      const std::string query = format_sql(
+          remote_sql::COLUMN_DATA_CHUNK, list.c_str(), qdb.c_str(),
+          qtable.c_str(), pk.c_str(), r.first ? ">=" : ">", r.lo.c_str(),
+          pk.c_str(), r.hi.c_str());
+      std::vector<std::string> row;
+      bool has_row = false;
+      if (query_one_row(conn, query, &row, &has_row) ||
+          row.size() < columns.size()) {
+        record_error(mysql_error(conn));
+        conn_ok = false;
+        break;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      for (size_t c = 0; c < columns.size(); c++) {
+        const long long value = strtoll(row[c].c_str(), nullptr, 10);
+        if (columns[c].kind == ColumnFit::LENGTH)
+          found[c] = std::max(found[c], value);
+        else
+          found[c] += value;
+      }
+    }
+    if (conn) pool_release(conn, conn_ok ? PoolRelease::CLEAN
+                                         : PoolRelease::DIRTY);
+    my_thread_end();
+  };
+
+  std::vector<std::thread> threads;
+  const size_t workers =
+      std::min(ranges.size(), static_cast<size_t>(opt_column_data_workers));
+  for (size_t w = 0; w < workers; w++) threads.emplace_back(work);
+  for (auto &thread : threads) thread.join();
+
+  if (failed) {
+    log_scan_error(db, table, where, err);
+    return;
+  }
+  if (ctx->killed.load()) return;
+
+  for (size_t c = 0; c < columns.size(); c++) {
+    const ColumnFit &fit = columns[c];
+    if (fit.kind == ColumnFit::LENGTH && found[c] > fit.max_length)
+      node->report(level,
+                   "Column '%s' holds values of up to %lld characters on "
+                   "replica %s, longer than %s allows; the ALTER would fail "
+                   "or truncate them.",
+                   fit.column.c_str(), found[c], where.c_str(),
+                   fit.new_type.c_str());
+    else if (fit.kind == ColumnFit::RANGE && found[c] > 0)
+      node->report(level,
+                   "Column '%s' has %lld rows on replica %s outside the range "
+                   "of %s; the ALTER would fail or clip them.",
+                   fit.column.c_str(), found[c], where.c_str(),
+                   fit.new_type.c_str());
+  }
+}
+
+}  // namespace inception
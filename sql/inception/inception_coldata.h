@@ -0,0 +1,60 @@
+/**
+ * @file inception_coldata.h
+ * @brief Whether the rows of a table fit a column an ALTER narrows,
+ *        measured on a replica (inception_check_column_data).
+ *
+ * inception_check_varchar_shrink, inception_check_lossy_type_change and
+ * inception_check_decimal_change only compare the old and new definitions;
+ * whether the data fits shows when the ALTER fails halfway through a
+ * multi-hour copy. With inception_check_column_data at WARNING or ERROR,
+ * the columns such an ALTER shortens or narrows are checked against the
+ * data of the first --slave-hosts replica; the primary is never scanned.
+ * The table is cut into ranges of inception_column_data_chunk_size rows of
+ * its single integer primary key, and inception_column_data_workers
+ * threads scan them, at most inception_column_data_max_chunks_per_sec
+ * ranges a second over all threads, with one query per range:
+ *
+ *   SELECT MAX(CHAR_LENGTH(c1)), SUM(c2 < lo OR c2 > hi), ...
+ *   FROM db.t WHERE pk >= lo AND pk <= hi
+ *
+ * A column holding longer values than its new length, or rows outside the
+ * range of its new integer or DECIMAL type, is reported at the level of
+ * inception_check_column_data. Tables without a single integer primary
+ * key and batches without --slave-hosts are not scanned; a scan that fails
+ * is logged to the error log and reports nothing.
+ */
+
+#ifndef SQL_INCEPTION_COLDATA_H
+#define SQL_INCEPTION_COLDATA_H
+
+#include <string>
+#include <vector>
+
+#include "my_inttypes.h"  // ulong
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/** A column an ALTER narrows, and the values its new type holds. */
+struct ColumnFit {
+  enum Kind { LENGTH, RANGE };
+  std::string column;
+  Kind kind = LENGTH;
+  long long max_length = 0;  /* LENGTH: characters */
+  std::string lo, hi;        /* RANGE: inclusive bounds, numeric literals */
+  std::string new_type;      /* for the finding, e.g. "SMALLINT UNSIGNED" */
+};
+
+/**
+ * Scan db.table on the first --slave-hosts replica of ctx and report on
+ * node, at level, every column of columns whose data does not fit.
+ */
+void check_column_data(InceptionContext *ctx, SqlCacheNode *node, ulong level,
+                       const std::string &db, const std::string &table,
+                       const std::vector<ColumnFit> &columns);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_COLDATA_H
@@ -0,0 +1,274 @@
+/**
+ * @file inception_component.cc
+ * @brief Audit rules added by components (inception_audit_rule service).
+ */
+
+#include "sql/inception/inception_component.h"
+
+#include "sql/inception/inception_audit.h"    // get_remote_conn
+#include "sql/inception/inception_cache.h"    // get_table_meta
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_status.h"   // InceptionMutex
+#include "sql/sql_class.h"                    // THD
+#include "sql/sql_lex.h"                      // LEX
+#include "sql/table.h"                        // TABLE_LIST
+
+#include <strings.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+namespace inception {
+
+/** One registration of a component rule. */
+struct ComponentRule {
+  std::string name;
+  int sql_command;
+  inception_rule_fn fn;
+  void *arg;
+  std::atomic<uint64_t> calls{0};
+};
+
+using ComponentRulePtr = std::shared_ptr<ComponentRule>;
+
+/** The rules of every command; never changed once published. */
+struct ComponentRuleTable {
+  std::vector<ComponentRulePtr> by_command[SQLCOM_END + 1];
+};
+
+/* g_table is swapped under g_table_mutex; g_register_mutex serializes
+   (un)registrations, which build the next table from the current one */
+static InceptionMutex g_register_mutex("component_rules_register");
+static InceptionMutex g_table_mutex("component_rules");
+static std::shared_ptr<const ComponentRuleTable> g_table =
+    std::make_shared<const ComponentRuleTable>();
+static std::atomic<bool> g_any_rules{false};
+
+static std::shared_ptr<const ComponentRuleTable> rule_table() {
+  std::lock_guard<InceptionMutex> lock(g_table_mutex);
+  return g_table;
+}
+
+/**
+ * Publish next and wait until no audit runs a rule of the table it
+ * replaced, so that an unregistered rule is not called any more.
+ */
+static void publish_rule_table(std::shared_ptr<const ComponentRuleTable> next,
+                               bool any) {
+  std::shared_ptr<const ComponentRuleTable> old;
+  {
+    std::lock_guard<InceptionMutex> lock(g_table_mutex);
+    old = std::move(g_table);
+    g_table = std::move(next);
+    g_any_rules.store(any, std::memory_order_release);
+  }
+  while (old.use_count() > 1)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+std::vector<ComponentRuleInfo> get_component_rules() {
+  std::shared_ptr<const ComponentRuleTable> table = rule_table();
+  std::vector<ComponentRuleInfo> rules;
+  for (const auto &list : table->by_command)
+    for (const ComponentRulePtr &rule : list)
+      rules.push_back({rule->name, rule->sql_command,
+                       rule->calls.load(std::memory_order_relaxed)});
+  return rules;
+}
+
+}  // namespace inception
+
+using namespace inception;
+
+/**
+ * What a rule sees of the statement it is called for. The metadata
+ * snapshots it returned strings of are held until the call returns.
+ */
+struct inception_rule_statement_imp {
+  THD *thd;
+  SqlCacheNode *node;
+  InceptionContext *ctx;
+  std::vector<SchemaTable> tables;
+  std::vector<TableMetaPtr> held;
+
+  /** Metadata of db.table, nullptr if it cannot be read. */
+  const TableMeta *meta(const char *db, const char *table) {
+    MYSQL *remote = get_remote_conn(ctx);
+    if (!remote && !ctx->shadow) return nullptr;
+    TableMetaPtr meta = get_table_meta(ctx, remote, db, table);
+    if (!meta) return nullptr;
+    held.push_back(meta);
+    return meta.get();
+  }
+};
+
+namespace inception {
+
+bool have_component_rules() {
+  return g_any_rules.load(std::memory_order_acquire);
+}
+
+void run_component_rules(THD *thd, SqlCacheNode *node,
+                         InceptionContext *ctx) {
+  const int command = thd->lex->sql_command;
+  std::shared_ptr<const ComponentRuleTable> table = rule_table();
+  const std::vector<ComponentRulePtr> &rules = table->by_command[command];
+  if (rules.empty()) return;
+
+  inception_rule_statement_imp stmt{thd, node, ctx, {}, {}};
+  for (TABLE_LIST *tl = thd->lex->query_tables; tl; tl = tl->next_global) {
+    const char *db = tl->db ? tl->db : thd->db().str;
+    if (!db || !tl->table_name || tl->is_derived()) continue;
+    stmt.tables.emplace_back(db, tl->table_name);
+  }
+  for (const ComponentRulePtr &rule : rules) {
+    rule->calls.fetch_add(1, std::memory_order_relaxed);
+    rule->fn(&stmt, rule->arg);
+  }
+}
+
+}  // namespace inception
+
+/* ---- inception_audit_rule ---- */
+
+DEFINE_BOOL_METHOD(mysql_inception_audit_rule_imp::register_rule,
+                   (const char *name, int sql_command, inception_rule_fn fn,
+                    void *arg)) {
+  if (!name || !*name || !fn || sql_command < 0 || sql_command >= SQLCOM_END)
+    return true;
+  try {
+    std::lock_guard<InceptionMutex> lock(g_register_mutex);
+    std::shared_ptr<const ComponentRuleTable> current = rule_table();
+    for (const ComponentRulePtr &rule : current->by_command[sql_command])
+      if (strcasecmp(rule->name.c_str(), name) == 0) return true;
+
+    auto next = std::make_shared<ComponentRuleTable>(*current);
+    auto rule = std::make_shared<ComponentRule>();
+    rule->name = name;
+    rule->sql_command = sql_command;
+    rule->fn = fn;
+    rule->arg = arg;
+    next->by_command[sql_command].push_back(std::move(rule));
+    publish_rule_table(std::move(next), true);
+  } catch (const std::bad_alloc &) {
+    return true;
+  }
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_audit_rule_imp::unregister_rule,
+                   (const char *name)) {
+  if (!name) return true;
+  try {
+    std::lock_guard<InceptionMutex> lock(g_register_mutex);
+    auto next = std::make_shared<ComponentRuleTable>(*rule_table());
+    bool found = false, any = false;
+    for (auto &list : next->by_command) {
+      for (auto it = list.begin(); it != list.end();) {
+        if (strcasecmp((*it)->name.c_str(), name) == 0) {
+          it = list.erase(it);
+          found = true;
+        } else {
+          ++it;
+        }
+      }
+      any = any || !list.empty();
+    }
+    if (!found) return true;
+    publish_rule_table(std::move(next), any);
+  } catch (const std::bad_alloc &) {
+    return true;
+  }
+  return false;
+}
+
+/* ---- inception_rule_statement ---- */
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_command,
+                   (inception_rule_statement stmt, int *sql_command)) {
+  *sql_command = stmt->thd->lex->sql_command;
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_sql,
+                   (inception_rule_statement stmt, const char **sql,
+                    size_t *length)) {
+  *sql = stmt->node->sql_text.c_str();
+  *length = stmt->node->sql_text.size();
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_table,
+                   (inception_rule_statement stmt, unsigned int index,
+                    const char **db, const char **table)) {
+  if (index >= stmt->tables.size()) return true;
+  *db = stmt->tables[index].first.c_str();
+  *table = stmt->tables[index].second.c_str();
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_lex,
+                   (inception_rule_statement stmt, const void **lex)) {
+  *lex = stmt->thd->lex;
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::table_exists,
+                   (inception_rule_statement stmt, const char *db,
+                    const char *table, bool *exists)) {
+  if (!db || !table) return true;
+  std::string key(db);
+  key += '.';
+  key += table;
+  if (stmt->ctx->batch_tables.count(key)) {
+    *exists = true;
+    return false;
+  }
+  const TableMeta *meta = stmt->meta(db, table);
+  if (!meta) return true;
+  *exists = meta->exists;
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_table_rows,
+                   (inception_rule_statement stmt, const char *db,
+                    const char *table, long long *rows)) {
+  if (!db || !table) return true;
+  const TableMeta *meta = stmt->meta(db, table);
+  if (!meta || !meta->exists) return true;
+  *rows = meta->table_rows;
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::get_column_type,
+                   (inception_rule_statement stmt, const char *db,
+                    const char *table, const char *column,
+                    const char **data_type)) {
+  if (!db || !table || !column) return true;
+  const TableMeta *meta = stmt->meta(db, table);
+  const RemoteColumnInfo *info = meta ? meta->find_column(column) : nullptr;
+  if (!info) return true;
+  *data_type = info->data_type.c_str();
+  return false;
+}
+
+DEFINE_BOOL_METHOD(mysql_inception_rule_statement_imp::report,
+                   (inception_rule_statement stmt, int level,
+                    const char *message)) {
+  if (!message) return true;
+  switch (level) {
+    case INCEPTION_RULE_WARNING:
+      stmt->node->append_warning("%s", message);
+      return false;
+    case INCEPTION_RULE_ERROR:
+      stmt->node->append_error("%s", message);
+      return false;
+    default:
+      return true;
+  }
+}
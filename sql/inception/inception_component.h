@@ -0,0 +1,86 @@
+/**
+ * @file inception_component.h
+ * @brief Audit rules added by components (inception_audit_rule service).
+ *
+ * The server component provides the services of
+ * mysql/components/services/inception_audit_rule.h through the
+ * implementations below. Registered rules are kept in a table indexed by
+ * enum_sql_command, swapped as a whole on (un)registration, so the audit
+ * of a statement only reads the rules of its command from a snapshot and
+ * takes no lock while they run; an empty table costs one atomic load.
+ */
+
+#ifndef SQL_INCEPTION_COMPONENT_H
+#define SQL_INCEPTION_COMPONENT_H
+
+#include <mysql/components/service_implementation.h>
+#include <mysql/components/services/inception_audit_rule.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/** Whether any component rule is registered; one atomic load. */
+bool have_component_rules();
+
+/**
+ * Run the component rules registered for the statement's command on node.
+ * Called by audit_statement() after the built-in rules.
+ */
+void run_component_rules(THD *thd, SqlCacheNode *node,
+                         InceptionContext *ctx);
+
+/** A registered component rule, for "inception show rule_components". */
+struct ComponentRuleInfo {
+  std::string name;
+  int sql_command;
+  uint64_t calls;  /* statements it audited */
+};
+
+/** The registered rules, by command, then in registration order. */
+std::vector<ComponentRuleInfo> get_component_rules();
+
+}  // namespace inception
+
+/** inception_audit_rule of mysql_server. */
+class mysql_inception_audit_rule_imp {
+ public:
+  static DEFINE_BOOL_METHOD(register_rule, (const char *name, int sql_command,
+                                            inception_rule_fn fn, void *arg));
+  static DEFINE_BOOL_METHOD(unregister_rule, (const char *name));
+};
+
+/** inception_rule_statement of mysql_server. */
+class mysql_inception_rule_statement_imp {
+ public:
+  static DEFINE_BOOL_METHOD(get_command,
+                            (inception_rule_statement stmt, int *sql_command));
+  static DEFINE_BOOL_METHOD(get_sql, (inception_rule_statement stmt,
+                                      const char **sql, size_t *length));
+  static DEFINE_BOOL_METHOD(get_table, (inception_rule_statement stmt,
+                                        unsigned int index, const char **db,
+                                        const char **table));
+  static DEFINE_BOOL_METHOD(get_lex,
+                            (inception_rule_statement stmt, const void **lex));
+  static DEFINE_BOOL_METHOD(table_exists,
+                            (inception_rule_statement stmt, const char *db,
+                             const char *table, bool *exists));
+  static DEFINE_BOOL_METHOD(get_table_rows,
+                            (inception_rule_statement stmt, const char *db,
+                             const char *table, long long *rows));
+  static DEFINE_BOOL_METHOD(get_column_type,
+                            (inception_rule_statement stmt, const char *db,
+                             const char *table, const char *column,
+                             const char **data_type));
+  static DEFINE_BOOL_METHOD(report, (inception_rule_statement stmt, int level,
+                                     const char *message));
+};
+
+#endif  // SQL_INCEPTION_COMPONENT_H
@@ -5,88 +5,319 @@
 
 #include "sql/inception/inception_context.h"
 #include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_sched.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
 
 #include "sql/sql_class.h"  // THD
 #include "include/mysql.h"
 #include "include/sql_common.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 
 namespace inception {
 
-static std::mutex g_ctx_mutex;
-static std::map<THD *, InceptionContext> g_ctx_map;
+/* Every context registered, by thread id. Readers take a snapshot with
+   std::atomic_load and look it up without locking; registration and
+   removal, once per connection, copy the map under g_ctx_mutex and
+   publish the copy. A context lives on while a snapshot holds it. */
+using ContextMap =
+    std::unordered_map<uint32_t, std::shared_ptr<InceptionContext>>;
+
+static InceptionMutex g_ctx_mutex("sessions");
+static std::shared_ptr<const ContextMap> g_ctx_map =
+    std::make_shared<const ContextMap>();
+
+static void publish_map_locked(std::shared_ptr<ContextMap> map) {
+  std::atomic_store(&g_ctx_map, std::shared_ptr<const ContextMap>(std::move(map)));
+}
+
+/* The context of thread_id if its session is set up, from a snapshot */
+static std::shared_ptr<InceptionContext> find_session(uint32_t thread_id) {
+  std::shared_ptr<const ContextMap> map = std::atomic_load(&g_ctx_map);
+  auto it = map->find(thread_id);
+  if (it == map->end() || !std::atomic_load(&it->second->identity))
+    return nullptr;
+  return it->second;
+}
 
 InceptionContext *get_context(THD *thd) {
-  std::lock_guard<std::mutex> lock(g_ctx_mutex);
-  return &g_ctx_map[thd];
+  if (thd->inception_ctx) return thd->inception_ctx;
+  std::shared_ptr<InceptionContext> ctx = std::make_shared<InceptionContext>();
+  {
+    std::lock_guard<InceptionMutex> lock(g_ctx_mutex);
+    std::shared_ptr<ContextMap> map = std::make_shared<ContextMap>(*g_ctx_map);
+    (*map)[thd->thread_id()] = ctx;
+    publish_map_locked(std::move(map));
+  }
+  thd->inception_ctx = ctx.get();
+  return thd->inception_ctx;
+}
+
+InceptionContext *find_active_context(THD *thd) {
+  InceptionContext *ctx = thd->inception_ctx;
+  return (ctx && ctx->active) ? ctx : nullptr;
+}
+
+void publish_session(THD *thd, InceptionContext *ctx) {
+  std::shared_ptr<SessionIdentity> id = std::make_shared<SessionIdentity>();
+  id->thread_id = thd->thread_id();
+  id->host = ctx->host;
+  id->port = ctx->port;
+  id->user = ctx->user;
+  id->mode = ctx->mode;
+  id->db_type = ctx->db_type;
+  id->start = ctx->session_start_time;
+  std::atomic_store(&ctx->identity,
+                    std::shared_ptr<const SessionIdentity>(std::move(id)));
 }
 
 void destroy_context(THD *thd) {
-  std::lock_guard<std::mutex> lock(g_ctx_mutex);
-  g_ctx_map.erase(thd);
+  /* Connections that never used inception have nothing registered. */
+  if (!thd->inception_ctx) return;
+  /* Session ended without commit: hand the audit connection back outside
+     the map lock (the reset may need a round trip). */
+  InceptionContext *ctx = thd->inception_ctx;
+  std::atomic_store(&ctx->identity, std::shared_ptr<const SessionIdentity>());
+  ctx->drop_warm_conn();
+  if (ctx->remote_conn) {
+    pool_release(ctx->remote_conn, PoolRelease::DB_CHANGED);
+    ctx->remote_conn = nullptr;
+  }
+  if (ctx->audit_conn) {
+    pool_release(ctx->audit_conn, PoolRelease::DB_CHANGED);
+    ctx->audit_conn = nullptr;
+  }
+  /* Freed here, or by the last snapshot holding it */
+  std::shared_ptr<InceptionContext> owned;
+  {
+    std::lock_guard<InceptionMutex> lock(g_ctx_mutex);
+    std::shared_ptr<ContextMap> map = std::make_shared<ContextMap>(*g_ctx_map);
+    auto it = map->find(thd->thread_id());
+    if (it != map->end()) {
+      owned = std::move(it->second);
+      map->erase(it);
+    }
+    publish_map_locked(std::move(map));
+  }
+  thd->inception_ctx = nullptr;
 }
 
 bool set_sleep_by_thread_id(uint32_t thread_id, uint64_t ms) {
-  std::lock_guard<std::mutex> lock(g_ctx_mutex);
-  for (auto &pair : g_ctx_map) {
-    if (pair.first->thread_id() == thread_id && pair.second.active) {
-      pair.second.sleep_ms = ms;
-      return true;
-    }
+  std::shared_ptr<InceptionContext> ctx = find_session(thread_id);
+  if (!ctx) return false;
+  ctx->sleep_ms.store(ms);
+  ctx->notify_control();
+  return true;
+}
+
+bool set_paused_by_thread_id(uint32_t thread_id, bool paused) {
+  std::shared_ptr<InceptionContext> ctx = find_session(thread_id);
+  if (!ctx) return false;
+  ctx->paused.store(paused);
+  ctx->notify_control();
+  fprintf(stderr, "[Inception] Session %u %s.\n", thread_id,
+          paused ? "paused" : "resumed");
+  fflush(stderr);
+  return true;
+}
+
+void InceptionContext::publish_executed(size_t upto, int counted) {
+  int done = -counted;
+  upto = std::min(upto, cache_nodes.size());
+  for (; progress_through < upto; progress_through++) {
+    const SqlCacheNode &node = cache_nodes[progress_through];
+    if (node.stage < STAGE_EXECUTED) continue;
+    if (progress_lane && (node.sql_command == SQLCOM_CHANGE_DB ||
+                          node.sql_command == SQLCOM_SET_OPTION))
+      continue;
+    done++;
+  }
+  if (done == 0) return;
+  for (InceptionContext *c = this; c; c = c->progress_parent)
+    c->executed_sql.fetch_add(done, std::memory_order_relaxed);
+}
+
+void InceptionContext::spill_nodes(size_t upto) {
+  const size_t budget = opt_max_session_memory;
+  if (budget == 0) return;
+  upto = std::min(upto, cache_nodes.size());
+  for (; text_bytes > budget && spill_next < upto; spill_next++) {
+    SqlCacheNode &node = cache_nodes[spill_next];
+    if (node.spilled || node.sql_text.size() > UINT32_MAX ||
+        node.errmsg.size() > UINT32_MAX)
+      continue;
+    uint64_t offset;
+    /* A file that cannot be written keeps the rest in memory */
+    if (text_spill.put(node.sql_text, node.errmsg, &offset)) return;
+    const size_t freed = node.sql_text.size() + node.errmsg.size();
+    node.spilled = true;
+    node.spill_offset = offset;
+    node.spill_sql_len = static_cast<uint32_t>(node.sql_text.size());
+    node.spill_msg_len = static_cast<uint32_t>(node.errmsg.size());
+    std::string().swap(node.sql_text);
+    std::string().swap(node.errmsg);
+    text_bytes -= std::min(text_bytes, freed);
+    status_add(STATUS_STATEMENTS_SPILLED);
+  }
+}
+
+bool InceptionContext::read_node_text(const SqlCacheNode &node,
+                                      std::string *sql_text,
+                                      std::string *errmsg) const {
+  if (!node.spilled) {
+    *sql_text = node.sql_text;
+    *errmsg = node.errmsg;
+    return false;
+  }
+  if (text_spill.get(node.spill_offset, node.spill_sql_len,
+                     node.spill_msg_len, sql_text, errmsg))
+    return true;
+  if (!node.errmsg.empty()) {
+    if (!errmsg->empty()) *errmsg += "\n";
+    *errmsg += node.errmsg;
   }
   return false;
 }
 
-bool kill_session(uint32_t thread_id, bool force) {
-  std::string host, user, password;
-  uint port = 0;
-  unsigned long remote_tid = 0;
-  bool found = false;
+bool InceptionContext::load_node(SqlCacheNode *node) {
+  if (!node->spilled) return false;
+  std::string sql_text, errmsg;
+  if (read_node_text(*node, &sql_text, &errmsg)) return true;
+  node->sql_text.swap(sql_text);
+  node->errmsg.swap(errmsg);
+  node->spilled = false;
+  text_bytes += node->sql_text.size() + node->errmsg.size();
+  /* Spilled again, once done with, by the next spill_nodes() */
+  spill_next = std::min(spill_next,
+                        static_cast<size_t>(node - cache_nodes.data()));
+  return false;
+}
 
-  {
-    std::lock_guard<std::mutex> lock(g_ctx_mutex);
-    for (auto &pair : g_ctx_map) {
-      if (pair.first->thread_id() == thread_id && pair.second.active) {
-        pair.second.killed.store(true);
-        if (force) {
-          host = pair.second.host;
-          user = pair.second.user;
-          password = pair.second.password;
-          port = pair.second.port;
-          remote_tid = pair.second.remote_exec_thread_id.load();
-        }
-        found = true;
-        break;
-      }
-    }
+void InceptionContext::load_all_nodes() {
+  for (auto &node : cache_nodes) {
+    if (!load_node(&node)) continue;
+    node.spilled = false;
+    node.append_error("Cannot read the statement back from the spill file.");
   }
+}
+
+bool InceptionContext::sleep_unless_killed(uint64_t ms) {
+  std::unique_lock<std::mutex> lock(control_mutex);
+  control_cond.wait_for(lock, std::chrono::milliseconds(ms),
+                        [this] { return killed.load(); });
+  return killed.load();
+}
 
-  if (!found) return false;
-
-  /* Force kill: connect to remote and KILL the running thread */
-  if (force && remote_tid > 0 && !host.empty()) {
-    MYSQL *tmp = mysql_init(nullptr);
-    if (tmp) {
-      mysql_options(tmp, MYSQL_SET_CHARSET_NAME, "utf8mb4");
-      unsigned int timeout = 5;
-      mysql_options(tmp, MYSQL_OPT_CONNECT_TIMEOUT, &timeout);
-      const char *h = host.c_str();
-      const char *u = user.empty() ? "root" : user.c_str();
-      const char *p = password.empty() ? nullptr : password.c_str();
-      if (mysql_real_connect(tmp, h, u, p, nullptr, port, nullptr, 0)) {
-        char kill_sql[64];
-        snprintf(kill_sql, sizeof(kill_sql), remote_sql::KILL_THREAD, remote_tid);
-        mysql_real_query(tmp, kill_sql,
-                         static_cast<unsigned long>(strlen(kill_sql)));
-        fprintf(stderr, "[Inception] Force killed remote thread %lu on %s:%u\n",
-                remote_tid, h, port);
-        fflush(stderr);
-      }
-      mysql_close(tmp);
+bool InceptionContext::wait_between_statements() {
+  const auto start = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(control_mutex);
+  for (;;) {
+    if (killed.load()) return true;
+    if (paused.load()) {
+      control_cond.wait(lock);
+      continue;
     }
+    /* Re-read each time: "inception set sleep" may shorten or extend it */
+    auto deadline = start + std::chrono::milliseconds(sleep_ms.load());
+    if (std::chrono::steady_clock::now() >= deadline) return false;
+    control_cond.wait_until(lock, deadline);
   }
+}
+
+void kill_remote_thread(const std::string &host, uint port,
+                        const std::string &user, const std::string &password,
+                        unsigned long remote_tid) {
+  if (remote_tid == 0 || host.empty()) return;
+  PoolConnOptions opts;
+  opts.connect_timeout = 5;
+  std::string errmsg;
+  MYSQL *tmp = pool_acquire(host, port, user.empty() ? "root" : user,
+                            password, opts, &errmsg);
+  if (tmp) {
+    char kill_sql[64];
+    snprintf(kill_sql, sizeof(kill_sql), remote_sql::KILL_THREAD, remote_tid);
+    mysql_real_query(tmp, kill_sql,
+                     static_cast<unsigned long>(strlen(kill_sql)));
+    fprintf(stderr, "[Inception] Force killed remote thread %lu on %s:%u\n",
+            remote_tid, host.c_str(), port);
+    fflush(stderr);
+    pool_release(tmp, PoolRelease::CLEAN);
+  }
+}
+
+void copy_exec_settings(const InceptionContext &from, InceptionContext *to) {
+  to->active = true;
+  to->host = from.host;
+  to->user = from.user;
+  to->password = from.password;
+  to->port = from.port;
+  to->explicit_host = from.explicit_host;
+  to->explicit_user = from.explicit_user;
+  to->explicit_port = from.explicit_port;
+  to->mode = from.mode;
+  to->force = from.force;
+  to->backup = from.backup;
+  to->ignore_warnings = from.ignore_warnings;
+  to->chunked_dml = from.chunked_dml;
+  to->tidb_batch_dml = from.tidb_batch_dml;
+  to->verify = from.verify;
+  to->merge_alter = from.merge_alter;
+  to->online_alter = from.online_alter;
+  to->parallel = from.parallel;
+  to->sleep_ms.store(from.sleep_ms.load());
+  to->txn_batch_size = from.txn_batch_size;
+  to->priority = from.priority;
+  to->resume_batch = from.resume_batch;
+  to->slave_hosts = from.slave_hosts;
+  to->targets = from.targets;
+  to->target_group = from.target_group;
+  to->dry_run_target = from.dry_run_target;
+  to->dry_run_sandbox = from.dry_run_sandbox;
+  to->rule_profile = from.rule_profile;
+  to->db_type = from.db_type;
+  to->db_version_major = from.db_version_major;
+  to->db_version_minor = from.db_version_minor;
+  to->db_version_patch = from.db_version_patch;
+  to->session_start_time = from.session_start_time;
+  to->remote_conn_failed = from.remote_conn_failed;
+  to->remote_conn_error = from.remote_conn_error;
+  to->prefetch_tables.store(from.prefetch_tables.load());
+  to->prefetch_ms.store(from.prefetch_ms.load());
+  to->audit_memo_hits = from.audit_memo_hits;
+  to->audit_cache_hits = from.audit_cache_hits;
+  to->rule_stats = from.rule_stats;
+}
+
+static void add_remote_threads(InceptionContext &ctx,
+                               std::vector<RemoteThread> *result) {
+  unsigned long tid = ctx.remote_exec_thread_id.load();
+  if (tid != 0) result->push_back({ctx.host, ctx.port, ctx.user, ctx.password, tid});
+  std::lock_guard<std::mutex> lock(ctx.control_mutex);
+  for (const auto &shard : ctx.shards) add_remote_threads(*shard, result);
+  for (const auto &lane : ctx.lanes) add_remote_threads(*lane, result);
+}
+
+std::vector<RemoteThread> remote_threads(InceptionContext &ctx) {
+  std::vector<RemoteThread> result;
+  add_remote_threads(ctx, &result);
+  return result;
+}
+
+bool kill_session(uint32_t thread_id, bool force) {
+  std::shared_ptr<InceptionContext> ctx = find_session(thread_id);
+  if (!ctx) return false;
+
+  ctx->killed.store(true);
+  ctx->notify_control();
+  std::vector<RemoteThread> remote;
+  if (force) remote = remote_threads(*ctx);
+
+  /* Force kill: connect to remote and KILL the running thread(s) */
+  for (const auto &t : remote)
+    kill_remote_thread(t.host, t.port, t.user, t.password, t.tid);
 
   fprintf(stderr, "[Inception] Session %u marked as killed%s.\n",
           thread_id, force ? " (force)" : "");
@@ -112,32 +343,54 @@ static const char *dbtype_name(DbType t) {
   return "Unknown";
 }
 
+size_t count_active_sessions() {
+  std::shared_ptr<const ContextMap> map = std::atomic_load(&g_ctx_map);
+  size_t n = 0;
+  for (const auto &pair : *map)
+    if (std::atomic_load(&pair.second->identity)) n++;
+  return n;
+}
+
 std::vector<SessionInfo> get_active_sessions() {
-  std::lock_guard<std::mutex> lock(g_ctx_mutex);
+  std::shared_ptr<const ContextMap> map = std::atomic_load(&g_ctx_map);
   std::vector<SessionInfo> result;
+  result.reserve(map->size());
   auto now = std::chrono::steady_clock::now();
-  for (auto &pair : g_ctx_map) {
-    auto &ctx = pair.second;
-    if (!ctx.active) continue;
+  for (const auto &pair : *map) {
+    const InceptionContext &ctx = *pair.second;
+    std::shared_ptr<const SessionIdentity> id = std::atomic_load(&ctx.identity);
+    if (!id) continue;
     SessionInfo si;
-    si.thread_id = pair.first->thread_id();
-    si.host = ctx.host;
-    si.port = ctx.port;
-    si.user = ctx.user;
-    si.mode = mode_name(ctx.mode);
-    si.db_type = dbtype_name(ctx.db_type);
-    si.sleep_ms = ctx.sleep_ms;
-    si.total_sql = static_cast<int>(ctx.cache_nodes.size());
-    si.executed_sql = 0;
-    for (auto &node : ctx.cache_nodes) {
-      if (node.stage >= STAGE_EXECUTED) si.executed_sql++;
-    }
-    si.elapsed_sec = std::chrono::duration<double>(
-        now - ctx.session_start_time).count();
+    si.thread_id = id->thread_id;
+    si.host = id->host;
+    si.port = id->port;
+    si.user = id->user;
+    si.mode = mode_name(id->mode);
+    si.db_type = dbtype_name(id->db_type);
+    si.sleep_ms = ctx.sleep_ms.load();
+    si.paused = ctx.paused.load();
+    si.total_sql = ctx.total_sql.load(std::memory_order_relaxed);
+    si.executed_sql = ctx.executed_sql.load(std::memory_order_relaxed);
+    si.elapsed_sec = std::chrono::duration<double>(now - id->start).count();
     si.threads_running = ctx.last_threads_running.load();
-    si.repl_delay = ctx.last_repl_delay.load();
+    si.repl_delay_ms = ctx.last_repl_delay_ms.load();
+    si.prefetch_tables = ctx.prefetch_tables.load();
+    si.prefetch_ms = ctx.prefetch_ms.load();
+    si.chunk_node_id = ctx.chunk_node_id.load();
+    si.chunks_done = ctx.chunks_done.load();
+    si.chunk_rows = ctx.chunk_rows.load();
+    si.progress_node_id = ctx.progress_node_id.load();
+    si.progress_permille = ctx.progress_permille.load();
+    si.progress_rate = ctx.progress_rate.load();
+    si.progress_eta_sec = ctx.progress_eta_sec.load();
+    si.sched = scheduler_state(&ctx, id->host, id->port);
     result.push_back(std::move(si));
   }
+  /* Oldest connection first, not in hash order */
+  std::sort(result.begin(), result.end(),
+            [](const SessionInfo &a, const SessionInfo &b) {
+              return a.thread_id < b.thread_id;
+            });
   return result;
 }
 
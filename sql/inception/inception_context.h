@@ -8,23 +8,37 @@
 #ifndef SQL_INCEPTION_CONTEXT_H
 #define SQL_INCEPTION_CONTEXT_H
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <cstdio>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "include/mysql.h"  // MYSQL
+#include "sql/inception/inception_audit.h"  // RulePlan
+#include "sql/inception/inception_batch.h"  // BatchIR
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_sched.h"  // ExecSlot
+#include "sql/inception/inception_spool.h"
 #include "sql/sql_lex.h"    // enum_sql_command
 
 class THD;
 
 namespace inception {
 
+struct ShadowCatalog;
+class RuleScope;
+
 /** Operation mode */
 enum class OpMode { CHECK = 0, EXECUTE = 1, SPLIT = 2, QUERY_TREE = 4 };
 
@@ -48,40 +62,85 @@ struct SqlCacheNode {
   int stage = STAGE_NONE;
   int errlevel = ERRLEVEL_OK;
   std::string errmsg;
+  int findings = 0;  /* messages appended to errmsg */
   std::string stage_status;
   int64_t affected_rows = 0;
   std::string sequence;
   std::string backup_dbname;
-  std::string execute_time;
+  double execute_seconds = -1;  /* on the target, < 0 = not executed */
   std::string sqlsha1;
   enum_sql_command sql_command = SQLCOM_END;
   std::string sub_type;       /* Fine-grained type, e.g. ALTER_ADD_COLUMN */
   std::string ddl_algorithm;  /* INSTANT/INPLACE/COPY for ALTER, empty otherwise */
+  std::string exec_strategy;  /* NATIVE/OSC/PARTITION for ALTER, else empty */
+  std::string estimated_time; /* predicted ALTER duration (seconds), "" if unknown */
+  std::string locks_writes;   /* YES/NO for ALTER, empty otherwise */
+  int64_t table_bytes = -1;   /* ALTER: size of the table when audited */
+  int64_t binlog_row_bytes = -1; /* UPDATE/DELETE: row event bytes per row */
+  bool chunkable = false;     /* single-table UPDATE/DELETE for --enable-chunked-dml */
+  bool tidb_batch = false;    /* chunkable, as TiDB non-transactional DML */
+  bool osc_capable = false;   /* ALTER the online schema change engine can run */
+  bool online_clause = false; /* --enable-online-alter may add ALGORITHM/LOCK */
+  bool single_row_insert = false; /* INSERT ... VALUES (one row), no IGNORE/ON DUP */
+  bool merged_alter = false;  /* --enable-merge-alter: runs with the ALTER before it */
+  bool before_images = false; /* backed up by SELECT before it ran, not from binlog */
+
+  /* --enable-parallel: lower-case "db.table" of every table the statement
+     reads or writes, and whether it adds or drops a foreign key */
+  std::vector<std::string> tables;
+  bool fk_change = false;
+
+  /* Backup: binlog coordinates around the execution of a DML statement
+     and the remote session that ran it (empty/0 when not captured) */
+  std::string start_binlog_file;
+  uint64_t start_binlog_pos = 0;
+  std::string end_binlog_file;
+  uint64_t end_binlog_pos = 0;
+  unsigned long exec_thread_id = 0;
+
+  /* Where the statement's time went, in microseconds, for the audit log:
+     CPU of the audit, metadata and EXPLAIN queries sent for it, load
+     throttle waits, SHOW WARNINGS after it and its backup; round_trips
+     counts those queries and its executions. A round trip shared by several
+     statements (multi-statement batch, merged INSERT) counts on the first */
+  uint64_t audit_cpu_us = 0;
+  uint64_t metadata_us = 0;
+  uint64_t throttle_wait_us = 0;
+  uint64_t warnings_us = 0;
+  uint64_t backup_us = 0;
+  uint32_t round_trips = 0;
+
+  /* --enable-server-timing: the statement's TIMER_WAIT, LOCK_TIME (in
+     microseconds) and ROWS_EXAMINED on the target, from its
+     performance_schema.events_statements_history; -1 when not captured */
+  int64_t server_us = -1;
+  int64_t lock_us = -1;
+  int64_t rows_examined = -1;
+
+  /* inception_max_session_memory: sql_text and errmsg moved to the
+     session's text_spill (sql_text then empty, errmsg holding only what
+     was appended since); see InceptionContext::spill_nodes() */
+  bool spilled = false;
+  uint32_t spill_sql_len = 0;
+  uint32_t spill_msg_len = 0;
+  uint64_t spill_offset = 0;
 
   /** Append an error message; sets errlevel to ERROR. */
   void append_error(const char *fmt, ...)
       __attribute__((format(printf, 2, 3))) {
-    char buf[1024];
     va_list ap;
     va_start(ap, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, ap);
+    append_message(ERRLEVEL_ERROR, fmt, ap);
     va_end(ap);
-    if (!errmsg.empty()) errmsg += "\n";
-    errmsg += buf;
-    if (errlevel < ERRLEVEL_ERROR) errlevel = ERRLEVEL_ERROR;
   }
 
   /** Append a warning message; sets errlevel to WARNING if not already ERROR. */
   void append_warning(const char *fmt, ...)
       __attribute__((format(printf, 2, 3))) {
-    char buf[1024];
     va_list ap;
     va_start(ap, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, ap);
+    append_message(ERRLEVEL_WARNING, fmt, ap);
     va_end(ap);
-    if (!errmsg.empty()) errmsg += "\n";
-    errmsg += buf;
-    if (errlevel < ERRLEVEL_WARNING) errlevel = ERRLEVEL_WARNING;
   }
 
   /**
@@ -91,15 +150,38 @@ struct SqlCacheNode {
   void report(ulong level, const char *fmt, ...)
       __attribute__((format(printf, 3, 4))) {
     if (level == 0) return;
-    char buf[1024];
     va_list ap;
     va_start(ap, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, ap);
+    append_message(level >= 2 ? ERRLEVEL_ERROR : ERRLEVEL_WARNING, fmt, ap);
     va_end(ap);
+  }
+
+  /** execute_seconds as the execute_time column shows it, "" if not run. */
+  std::string execute_time_text() const {
+    if (execute_seconds < 0) return std::string();
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.3f", execute_seconds);
+    return buf;
+  }
+
+ private:
+  /* Format a message straight onto the end of errmsg (no staging buffer),
+     cut at 1023 bytes, and raise errlevel to level */
+  void append_message(int level, const char *fmt, va_list ap) {
+    const size_t max_len = 1023;
+    va_list probe;
+    va_copy(probe, ap);
+    const int len = vsnprintf(nullptr, 0, fmt, probe);
+    va_end(probe);
+    if (len < 0) return;
     if (!errmsg.empty()) errmsg += "\n";
-    errmsg += buf;
-    int int_level = (level >= 2) ? ERRLEVEL_ERROR : ERRLEVEL_WARNING;
-    if (errlevel < int_level) errlevel = int_level;
+    const size_t at = errmsg.size();
+    const size_t n = std::min(static_cast<size_t>(len), max_len);
+    errmsg.resize(at + n + 1);
+    vsnprintf(&errmsg[at], n + 1, fmt, ap);
+    errmsg.resize(at + n);
+    if (errlevel < level) errlevel = level;
+    findings++;
   }
 };
 
@@ -109,11 +191,16 @@ struct SqlCacheNode {
  * Used by SPLIT mode to return grouped results.
  */
 struct SplitNode {
-  std::string sql_text;     // Merged SQL text (multiple statements joined by ";\n")
+  std::string sql_text;     // Merged SQL text (multiple statements joined by ";\n"),
+                            // or the path of its file (--enable-split-files)
   std::string db_name;      // Current db context
   std::string table_name;   // Target table name
   int ddlflag = 0;          // 1=ALTER TABLE/DROP TABLE (high-risk), 0=otherwise
   bool is_ddl_type = false; // Internal: whether this group is DDL-type
+  std::vector<std::string> tables;  // Lower-case "db.table" keys it touches
+  bool barrier = false;     // Must run after everything before it and alone
+  int parallel_group = 0;   // DAG level: groups of one level may run at once
+  std::vector<int> depends_on;  // Result ids of the groups it must follow
 };
 
 /**
@@ -126,6 +213,21 @@ struct QueryTreeNode {
   std::string query_tree_json;
 };
 
+/**
+ * What "inception show sessions" reports of a session besides its
+ * progress, published by publish_session() once magic_start is set up and
+ * never changed afterwards, so other threads read it without a lock.
+ */
+struct SessionIdentity {
+  uint32_t thread_id;
+  std::string host;
+  uint port;
+  std::string user;
+  OpMode mode;
+  DbType db_type;
+  std::chrono::steady_clock::time_point start;
+};
+
 /**
  * Per-THD inception session context.
  * Created when inception_magic_start is received,
@@ -150,34 +252,135 @@ struct InceptionContext {
   bool force = false;
   bool backup = true;
   bool ignore_warnings = false;
-  uint64_t sleep_ms = 0;
+  bool chunked_dml = false;   /* --enable-chunked-dml */
+  bool tidb_batch_dml = false; /* --enable-tidb-batch-dml */
+  bool verify = false;        /* --enable-verify: checksum the replicas after */
+  bool merge_alter = false;   /* --enable-merge-alter */
+  bool online_alter = false;  /* --enable-online-alter: ALGORITHM/LOCK added */
+  bool async = false;         /* --enable-async: EXECUTE as a background job */
+  bool parallel = false;      /* --enable-parallel: independent tables in lanes */
+  bool tidb_ddl_jobs = false; /* concurrent TiDB DDL jobs (execute_parallel) */
+  bool split_to_files = false; /* --enable-split-files: groups to split_files */
+  bool server_timing = false; /* --enable-server-timing: performance_schema */
+  std::atomic<uint64_t> sleep_ms{0};  /* --sleep, "inception set sleep" */
+  uint txn_batch_size = 0;    /* --txn-batch-size: DML per transaction */
+  uint priority = 0;          /* --priority: scheduler order, higher first */
+  std::string resume_batch;   /* --resume: checkpoint to continue from */
+  std::string schema_file;    /* --schema-file: audit offline (see shadow) */
+  std::string rule_profile;   /* --profile: inception_rule_profiles section */
 
   /* Slave hosts for replication delay check (parsed from --slave-hosts) */
   std::vector<std::pair<std::string, uint>> slave_hosts;
 
+  /* --targets / --target-group: shards an EXECUTE batch fans out to; the
+     batch is audited against host:port only */
+  std::vector<std::pair<std::string, uint>> targets;
+  std::string target_group;
+
+  /* --dry-run-target: the sandbox a CHECK batch runs on at commit to
+     measure its cost (see dry_run_statements()); port 0 = none */
+  std::string dry_run_target;
+  std::pair<std::string, uint> dry_run_sandbox{std::string(), 0};
+  std::string audit_host;  /* --audit-host, validated into audit_server */
+  std::pair<std::string, uint> audit_server{std::string(), 0};
+
+  /* Fan-out: one context per target, in --targets order, with its copy of
+     the batch and its results. Guarded by control_mutex, since kills and
+     "inception show sessions" read it from other threads. */
+  std::vector<std::unique_ptr<InceptionContext>> shards;
+
+  /* --enable-parallel: the lanes of the phase being executed (see
+     inception_parallel.h). Guarded by control_mutex like shards. */
+  std::vector<std::unique_ptr<InceptionContext>> lanes;
+
   /* Remote database type and version (auto-detected from remote) */
   DbType db_type = DbType::MYSQL;
   uint db_version_major = 8;          /* e.g. 8 */
   uint db_version_minor = 0;          /* e.g. 0 */
+  uint db_version_patch = 0;          /* e.g. 32; 0 for TiDB */
+  /* Target's binlog_row_image, "NONE" if it does not log rows and "" until
+     an UPDATE/DELETE asked (inception_check_dml_binlog_size) */
+  std::string binlog_row_image;
 
   /* Kill flag: set by "inception kill <id>" from another session */
   std::atomic<bool> killed{false};
 
+  /* Pause flag: set by "inception pause <id>", cleared by "inception resume <id>" */
+  std::atomic<bool> paused{false};
+
+  /* Wakes the executing thread when killed / paused / sleep_ms change */
+  std::mutex control_mutex;
+  std::condition_variable control_cond;
+
   /* Remote execution thread id (for "inception kill <id> force") */
   std::atomic<unsigned long> remote_exec_thread_id{0};
 
   /* Cached remote load stats (updated by wait_for_remote_ready) */
   std::atomic<ulong> last_threads_running{0};
-  std::atomic<long> last_repl_delay{-1};  /* -1 = not checked, >=0 = seconds */
+  std::atomic<long> last_repl_delay_ms{-1};  /* -1 = not checked */
+
+  /* Chunked DML progress of the statement being executed (0 = none) */
+  std::atomic<int> chunk_node_id{0};
+  std::atomic<long> chunks_done{0};
+  std::atomic<int64_t> chunk_rows{0};
+
+  /* Progress of the statement on the wire, sampled by the statement
+     monitor (node 0 = none, -1 = unknown) */
+  std::atomic<int> progress_node_id{0};
+  std::atomic<long> progress_permille{-1};
+  std::atomic<long> progress_rate{-1};  /* work units (TiDB: rows) per second */
+  std::atomic<long> progress_eta_sec{-1};
+
+  /* Statements of the batch (with --targets, every shard's copy) and those
+     done with (executed, skipped or killed), for monitoring. Written by
+     the executing thread through publish_executed(); a shard or lane also
+     adds to each progress_parent up the chain, and a lane leaves out the
+     USE and SET it replays, which its batch counts on merging. */
+  std::atomic<int> total_sql{0};
+  std::atomic<int> executed_sql{0};
+  InceptionContext *progress_parent = nullptr;
+  bool progress_lane = false;
+  size_t progress_through = 0;  /* cache_nodes counted so far */
+
+  /* Set while the session is registered and set up; other threads read it
+     with std::atomic_load only (see SessionIdentity) */
+  std::shared_ptr<const SessionIdentity> identity;
 
   /* Session timing for audit log */
   std::chrono::steady_clock::time_point session_start_time;
 
+  /* Client that submitted a background job (the job has no THD) */
+  uint32_t client_thread_id = 0;
+  std::string client_user;
+  std::string client_host;
+
+  /* inception_resource_group the connection's thread is bound to, and the
+     group it had before; kept across sessions, reset() leaves them */
+  std::string resource_group;
+  std::string resource_group_before;
+
   /* Remote connection for CHECK mode existence checks */
   MYSQL *remote_conn = nullptr;
   bool remote_conn_failed = false;     /* true if connection attempt failed */
   std::string remote_conn_error;       /* error message from failed connection */
 
+  /* --audit-host: connection for read-only audit queries (get_audit_conn()).
+     Once it fails or lags too far, the audit reads from remote_conn. */
+  MYSQL *audit_conn = nullptr;
+  bool audit_conn_failed = false;
+
+  /* inception_check_max_sessions_per_target: held by a CHECK session from
+     inception_magic_start to the end of its batch */
+  ExecSlot check_slot;
+
+  /* Connection opened in the background at magic_start
+     (connect_remote_async()). The thread only writes the two fields
+     below; get_remote_conn() joins it and takes the connection over. */
+  std::thread connect_thread;
+  MYSQL *warm_conn = nullptr;
+  std::string warm_conn_error;
+  bool profile_pending = false;  /* db_type/version not detected yet */
+
   /* Cached SQL statements and their audit results */
   std::vector<SqlCacheNode> cache_nodes;
   int next_id = 1;
@@ -188,10 +391,43 @@ struct InceptionContext {
 
   /* QUERY_TREE mode: per-statement JSON tree */
   std::vector<QueryTreeNode> tree_nodes;
+  /* SELECT * expansions of the statement being walked, which decide
+     whether its tree may be cached (inception_tree.cc) */
+  uint32_t tree_star_lookups = 0;
+  bool tree_star_failed = false;
+
+  /* inception_result_spool_size: finished results moved out of cache_nodes
+     (CHECK), tree_nodes (QUERY_TREE) or the sql_text of split_nodes before
+     split_spooled (SPLIT); they come before what is left in the vectors */
+  RowSpool result_spool;
+  int spooled_errors = 0;    /* of them with errlevel ERROR (CHECK) */
+  size_t split_spooled = 0;
+
+  /* --enable-split-files: SPLIT groups go to inception_split_dir as they
+     form; the sql_text of a split node is then the path of its file */
+  SplitFiles split_files;
+
+  /* inception_max_session_memory: texts of cache_nodes over the budget,
+     the bytes of sql_text and errmsg still in memory (statement texts
+     exactly, messages as of spilling or loading) and the first node
+     spill_nodes() looks at */
+  TextSpill text_spill;
+  size_t text_bytes = 0;
+  size_t spill_next = 0;
 
   /* Merge ALTER tracking: tables already altered in this session (db.table) */
   std::set<std::string> altered_tables;
 
+  /* --enable-merge-alter: the run of adjacent ALTERs on one table that the
+     next ALTER may be folded into */
+  struct AlterGroup {
+    std::string table;               /* "db.table", empty = none */
+    size_t head = 0;                 /* cache_nodes index of the first ALTER */
+    size_t last = 0;                 /* cache_nodes index of the last ALTER */
+    std::set<std::string> columns;   /* lower-case names touched so far */
+    std::set<std::string> indexes;   /* index/constraint names touched so far */
+  } alter_group;
+
   /* Batch-level schema tracking for CHECK mode:
      tables created in the current batch (key: "db.table", value: column names) */
   std::map<std::string, std::set<std::string>> batch_tables;
@@ -199,13 +435,141 @@ struct InceptionContext {
   /* Databases created in the current batch */
   std::set<std::string> batch_databases;
 
-  /** Add a SQL statement to the cache and return a reference to it. */
-  SqlCacheNode &add_sql(const std::string &sql, enum_sql_command cmd) {
+  /* What the DDL of the batch does to indexes, for analyze_batch() at
+     commit */
+  BatchIR batch_ir;
+
+  /* inception_metadata_cache_ttl = 0: the tables preload_table_meta()
+     loaded for the statement being audited ("db.table" as referenced)
+     and the databases holding one of them (StatementMetaScope) */
+  std::map<std::string, TableMetaPtr> statement_meta;
+  std::set<std::string> statement_schemas;
+
+  /* --schema-file: offline catalog the audit asks instead of the remote
+     target, with the batch's DDL applied (inception_shadow.h) */
+  std::shared_ptr<ShadowCatalog> shadow;
+
+  /* Rule levels, limits and parsed list variables as of magic_start */
+  RulePlan rules;
+
+  /* Per-rule audit counters of this session (inception_audit.cc), merged
+     into the server-wide ones at commit; remote_queries counts the
+     metadata queries sent on its behalf, remote_us the time they took */
+  RuleStats rule_stats;
+  uint64_t remote_queries = 0;
+  uint64_t remote_us = 0;
+  RuleScope *rule_scope = nullptr;  /* innermost running scope */
+
+  /* Audit memo: results of the literal-independent INSERT/UPDATE/DELETE
+     rules per "sqlsha1|default db", most recently used first, at most
+     inception_audit_memo_size entries; cleared by any other audited
+     statement, since DDL changes what the rules see */
+  struct AuditMemo {
+    int errlevel = ERRLEVEL_OK;
+    std::string errmsg;
+    int64_t affected_rows = 0;  /* EXPLAIN / TABLE_ROWS estimate */
+  };
+  using AuditMemoList = std::list<std::pair<std::string, AuditMemo>>;
+  AuditMemoList audit_memo;
+  std::unordered_map<std::string, AuditMemoList::iterator> audit_memo_index;
+  uint64_t audit_memo_hits = 0;
+
+  /* inception_audit_cache_size: digest of the session settings the audit
+     depends on (rule plan, target type and version, mode), computed at the
+     first lookup, and the statements answered from the cache */
+  std::string audit_cache_env;
+  uint64_t audit_cache_hits = 0;
+
+  /* Background schema prefetch into the metadata cache (inception_cache.cc).
+     The thread only touches the two atomics; it is joined in reset(). */
+  std::thread prefetch_thread;
+  std::string prefetch_db;                /* schema prefetched, empty = none */
+  std::atomic<long> prefetch_tables{-1};  /* -1 = not run or still running */
+  std::atomic<long> prefetch_ms{-1};
+
+  ~InceptionContext() {
+    if (prefetch_thread.joinable()) prefetch_thread.join();
+    drop_warm_conn();
+  }
+
+  /** Join connect_thread and give back a connection nobody took. */
+  void drop_warm_conn() {
+    if (connect_thread.joinable()) connect_thread.join();
+    if (warm_conn) {
+      pool_release(warm_conn, PoolRelease::CLEAN);
+      warm_conn = nullptr;
+    }
+    warm_conn_error.clear();
+  }
+
+  /**
+   * Wake the executing thread after killed, paused or sleep_ms changed.
+   * Call after storing the new value.
+   */
+  void notify_control() {
+    std::lock_guard<std::mutex> lock(control_mutex);
+    control_cond.notify_all();
+  }
+
+  /**
+   * Sleep up to ms, returning early when the session is killed.
+   * @return true if killed.
+   */
+  bool sleep_unless_killed(uint64_t ms);
+
+  /**
+   * Between two statements (or chunks): the --sleep interval, following
+   * "inception set sleep" changes as they happen, then wait while paused.
+   * @return true if killed.
+   */
+  bool wait_between_statements();
+
+  /**
+   * Count cache_nodes before upto that are done with, and not counted yet,
+   * into executed_sql and that of every progress_parent; counted of them
+   * were counted already (by lanes). Executing thread only.
+   */
+  void publish_executed(size_t upto, int counted = 0);
+
+  /**
+   * inception_max_session_memory: while the texts held by cache_nodes
+   * exceed it, move those of the nodes before upto, oldest first, to
+   * text_spill. Session's (or executing) thread only.
+   */
+  void spill_nodes(size_t upto);
+
+  /**
+   * Bring the texts of a spilled node of cache_nodes back into it; what
+   * was appended to errmsg meanwhile follows the spilled messages.
+   * @return true on I/O error, the node then stays spilled.
+   */
+  bool load_node(SqlCacheNode *node);
+
+  /**
+   * load_node() for every node, before copies of the nodes go to other
+   * threads; a node that cannot be read back reports it as an error.
+   */
+  void load_all_nodes();
+
+  /**
+   * The sql_text and errmsg of node as load_node() would make them,
+   * leaving node alone. Any thread. @return true on I/O error.
+   */
+  bool read_node_text(const SqlCacheNode &node, std::string *sql_text,
+                      std::string *errmsg) const;
+
+  /**
+   * Add a SQL statement to the cache and return a reference to it. The
+   * text is moved in: pass a temporary or std::move() it.
+   */
+  SqlCacheNode &add_sql(std::string sql, enum_sql_command cmd) {
     SqlCacheNode node;
     node.id = next_id++;
-    node.sql_text = sql;
+    text_bytes += sql.size();
+    node.sql_text = std::move(sql);
     node.sql_command = cmd;
     cache_nodes.push_back(std::move(node));
+    total_sql.fetch_add(1, std::memory_order_relaxed);
     return cache_nodes.back();
   }
 
@@ -223,54 +587,174 @@ struct InceptionContext {
     force = false;
     backup = true;
     ignore_warnings = false;
+    chunked_dml = false;
+    tidb_batch_dml = false;
+    verify = false;
+    merge_alter = false;
+    online_alter = false;
+    async = false;
+    parallel = false;
+    tidb_ddl_jobs = false;
+    split_to_files = false;
+    server_timing = false;
     sleep_ms = 0;
+    txn_batch_size = 0;
+    priority = 0;
+    resume_batch.clear();
+    schema_file.clear();
+    rule_profile.clear();
+    client_thread_id = 0;
+    client_user.clear();
+    client_host.clear();
     killed.store(false);
+    paused.store(false);
     remote_exec_thread_id.store(0);
     last_threads_running.store(0);
-    last_repl_delay.store(-1);
+    last_repl_delay_ms.store(-1);
+    chunk_node_id.store(0);
+    chunks_done.store(0);
+    chunk_rows.store(0);
+    progress_node_id.store(0);
+    progress_permille.store(-1);
+    progress_rate.store(-1);
+    progress_eta_sec.store(-1);
+    total_sql.store(0);
+    executed_sql.store(0);
+    progress_parent = nullptr;
+    progress_lane = false;
+    progress_through = 0;
+    std::atomic_store(&identity, std::shared_ptr<const SessionIdentity>());
     slave_hosts.clear();
+    targets.clear();
+    target_group.clear();
+    dry_run_target.clear();
+    dry_run_sandbox = {std::string(), 0};
+    audit_host.clear();
+    audit_server = {std::string(), 0};
+    {
+      std::lock_guard<std::mutex> lock(control_mutex);
+      shards.clear();
+      lanes.clear();
+    }
     db_type = DbType::MYSQL;
     db_version_major = 8;
     db_version_minor = 0;
+    db_version_patch = 0;
+    binlog_row_image.clear();
     cache_nodes.clear();
     next_id = 1;
     split_nodes.clear();
     tree_nodes.clear();
+    tree_star_lookups = 0;
+    tree_star_failed = false;
+    result_spool.clear();
+    split_files.clear();
+    spooled_errors = 0;
+    split_spooled = 0;
+    text_spill.clear();
+    text_bytes = 0;
+    spill_next = 0;
     current_usedb.clear();
     altered_tables.clear();
+    alter_group = AlterGroup();
     batch_tables.clear();
     batch_databases.clear();
+    batch_ir.clear();
+    statement_meta.clear();
+    statement_schemas.clear();
+    shadow.reset();
+    rules = RulePlan();
+    rule_stats = RuleStats();
+    remote_queries = 0;
+    remote_us = 0;
+    rule_scope = nullptr;
+    audit_memo.clear();
+    audit_memo_index.clear();
+    audit_memo_hits = 0;
+    audit_cache_env.clear();
+    audit_cache_hits = 0;
+    if (prefetch_thread.joinable()) prefetch_thread.join();
+    prefetch_db.clear();
+    prefetch_tables.store(-1);
+    prefetch_ms.store(-1);
+    drop_warm_conn();
+    profile_pending = false;
     remote_conn_failed = false;
     remote_conn_error.clear();
     if (remote_conn) {
-      mysql_close(remote_conn);
+      /* Audit/EXPLAIN may have sent USE on it. */
+      pool_release(remote_conn, PoolRelease::DB_CHANGED);
       remote_conn = nullptr;
     }
+    audit_conn_failed = false;
+    if (audit_conn) {
+      pool_release(audit_conn, PoolRelease::DB_CHANGED);
+      audit_conn = nullptr;
+    }
+    check_slot.release();
   }
 };
 
-/* --- Global context map (THD* -> InceptionContext) --- */
+/**
+ * Copy the target and the execution options of from into to: everything
+ * execute_statements() and generate_rollback() read except the batch
+ * itself (cache_nodes, next_id) and the submitting client.
+ */
+void copy_exec_settings(const InceptionContext &from, InceptionContext *to);
+
+/* --- Global session registry (thread id -> InceptionContext) --- */
 
 /**
  * Get or create the InceptionContext for the given THD.
- * Thread-safe.
+ * The context is registered by thread id on first use and cached in
+ * THD::inception_ctx afterwards. Must be called from the THD's own thread.
  */
 InceptionContext *get_context(THD *thd);
 
+/**
+ * Return the InceptionContext of the given THD if it is in an active
+ * inception session, nullptr otherwise. Lock-free and never allocates,
+ * so ordinary traffic pays a single branch. Owning thread only.
+ */
+InceptionContext *find_active_context(THD *thd);
+
+/**
+ * Publish the identity of the session of thd, set up from magic_start,
+ * which makes it visible to "inception show sessions", kill, pause and
+ * set sleep until ctx is reset. Owning thread only.
+ */
+void publish_session(THD *thd, InceptionContext *ctx);
+
 /**
  * Destroy the InceptionContext for the given THD.
- * Called from THD destructor. Thread-safe.
+ * Called from THD destructor. Thread-safe. A monitoring thread still
+ * holding the context releases it last.
  */
 void destroy_context(THD *thd);
 
+/*
+ * The functions below look sessions up in a snapshot of the registry and
+ * read only atomics and published identities: they take no global lock
+ * and never wait for the sessions they look at.
+ */
+
 /**
  * Set sleep_ms for an active inception session identified by thread_id.
  * Called from another session via "inception set sleep <tid> <ms>".
- * Thread-safe (holds g_ctx_mutex).
+ * Thread-safe.
  * @return true if the thread was found and updated, false otherwise.
  */
 bool set_sleep_by_thread_id(uint32_t thread_id, uint64_t ms);
 
+/**
+ * Pause (paused=true) or resume an active inception session by thread_id.
+ * A paused EXECUTE session stops before its next statement or chunk.
+ * Called from another session via "inception pause|resume <tid>".
+ * Thread-safe.
+ * @return true if the thread was found, false otherwise.
+ */
+bool set_paused_by_thread_id(uint32_t thread_id, bool paused);
+
 /** Snapshot of an active inception session for "inception show sessions". */
 struct SessionInfo {
   uint32_t thread_id;
@@ -280,19 +764,33 @@ struct SessionInfo {
   std::string mode;       /* CHECK / EXECUTE / SPLIT / QUERY_TREE */
   std::string db_type;    /* MySQL / TiDB / MariaDB */
   uint64_t sleep_ms;
+  bool paused;            /* "inception pause" in effect */
   int total_sql;          /* total SQL count in cache */
-  int executed_sql;       /* how many reached STAGE_EXECUTED */
+  int executed_sql;       /* how many are executed, skipped or killed */
   double elapsed_sec;     /* seconds since session start */
   ulong threads_running;  /* last seen Threads_running on primary (0 if not checked) */
-  long repl_delay;        /* max Seconds_Behind_Master (-1 = not checked) */
+  long repl_delay_ms;     /* max replica lag in ms (-1 = not checked) */
+  long prefetch_tables;   /* tables prefetched into the cache (-1 = none/running) */
+  long prefetch_ms;       /* prefetch duration (-1 = none/running) */
+  int chunk_node_id;      /* statement being chunked (0 = none) */
+  long chunks_done;
+  int64_t chunk_rows;     /* rows affected by committed chunks */
+  int progress_node_id;   /* statement with a progress sample (0 = none) */
+  long progress_permille; /* -1 = unknown, same for the two below */
+  long progress_rate;
+  long progress_eta_sec;
+  std::string sched;      /* scheduler state (see scheduler_state()) */
 };
 
 /**
  * Collect snapshots of all active inception sessions.
- * Thread-safe (holds g_ctx_mutex).
+ * Thread-safe.
  */
 std::vector<SessionInfo> get_active_sessions();
 
+/** Number of active inception sessions. Thread-safe. */
+size_t count_active_sessions();
+
 /**
  * Kill an active inception session by thread_id.
  * Graceful (force=false): sets killed flag, execution stops after current stmt.
@@ -302,6 +800,30 @@ std::vector<SessionInfo> get_active_sessions();
  */
 bool kill_session(uint32_t thread_id, bool force);
 
+/**
+ * KILL remote_tid on host:port over a pooled connection (the force part of
+ * kill_session()). No-op if remote_tid is 0 or host is empty.
+ */
+void kill_remote_thread(const std::string &host, uint port,
+                        const std::string &user, const std::string &password,
+                        unsigned long remote_tid);
+
+/** A statement running on a target, for force kills. */
+struct RemoteThread {
+  std::string host;
+  uint port;
+  std::string user;
+  std::string password;
+  unsigned long tid;
+};
+
+/**
+ * The remote statements a force kill of ctx must stop: its own, and those
+ * of its --targets shards and --enable-parallel lanes. Call while holding
+ * ctx; KILL them with kill_remote_thread() afterwards.
+ */
+std::vector<RemoteThread> remote_threads(InceptionContext &ctx);
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_CONTEXT_H
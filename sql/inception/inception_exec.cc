@@ -5,29 +5,51 @@
 
 #include "sql/inception/inception_exec.h"
 
+#include "sql/inception/inception_backup.h"
+#include "sql/inception/inception_binlog.h"
+#include "sql/inception/inception_cache.h"
+#include "sql/inception/inception_checkpoint.h"
+#include "sql/inception/inception_parallel.h"
 #include "sql/inception/inception_context.h"
 #include "sql/inception/inception_log.h"
+#include "sql/inception/inception_heartbeat.h"
+#include "sql/inception/inception_load.h"
+#include "sql/inception/inception_mdl.h"
+#include "sql/inception/inception_monitor.h"
+#include "sql/inception/inception_osc.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_prepare.h"
 #include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_sched.h"
+#include "sql/inception/inception_status.h"
 #include "sql/inception/inception_sysvars.h"
 #include "sql/sql_class.h"
 
 #include "include/mysql.h"
 #include "include/sql_common.h"
+#include "my_byteorder.h"  // int2store
+#include "mysqld_error.h"  // ER_ALTER_OPERATION_NOT_SUPPORTED
 
+#include <algorithm>
 #include <chrono>
+#include <cstdarg>
+#include <cstdlib>
 #include <cstring>
 #include <cstdio>
 #include <ctime>
+#include <map>
 
 namespace inception {
 
 /**
- * Strip inception_magic_start comment from SQL text.
+ * Offset of the statement in sql past the inception_magic_start comment.
  * The first cached SQL may be: "/*...inception_magic_start;* / CREATE DATABASE ..."
  * For remote execution, we only want: "CREATE DATABASE ..."
+ * Only the comment is scanned, so the statement is never copied.
  */
-static std::string strip_inception_comment(const std::string &sql) {
-  const char *p = sql.c_str();
+static size_t inception_comment_end(const std::string &sql) {
+  const char *begin = sql.c_str();
+  const char *p = begin;
   const char *end = p + sql.size();
 
   /* Skip leading whitespace */
@@ -39,62 +61,69 @@ static std::string strip_inception_comment(const std::string &sql) {
     const char *close = strstr(p + 2, "*/");
     if (close) {
       /* Check if this comment contains inception_magic_start */
-      std::string comment(p, close + 2 - p);
-      if (comment.find("inception_magic_start") != std::string::npos) {
+      static const char MAGIC[] = "inception_magic_start";
+      if (std::search(p, close, MAGIC, MAGIC + sizeof(MAGIC) - 1) != close) {
         p = close + 2;
         /* Skip whitespace after comment */
         while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
           p++;
-        if (p < end) {
-          return std::string(p, end - p);
-        }
-        return "";
+        return static_cast<size_t>(p - begin);
       }
     }
   }
-  return sql;
+  return 0;
+}
+
+size_t bare_statement_bounds(const SqlCacheNode &node, size_t *length) {
+  const std::string &sql = node.sql_text;
+  const size_t begin = inception_comment_end(sql);
+  size_t end = sql.size();
+  while (end > begin && (sql[end - 1] == ';' ||
+                         isspace(static_cast<unsigned char>(sql[end - 1]))))
+    end--;
+  *length = end - begin;
+  return begin;
+}
+
+std::string bare_statement(const SqlCacheNode &node) {
+  size_t length;
+  const size_t begin = bare_statement_bounds(node, &length);
+  return node.sql_text.substr(begin, length);
+}
+
+/* bare_statement(node).empty(), without the copy */
+static bool bare_statement_empty(const SqlCacheNode &node) {
+  size_t length;
+  bare_statement_bounds(node, &length);
+  return length == 0;
 }
 
 /**
- * Connect to the remote target MySQL server.
+ * Borrow a connection to the remote target MySQL server from the pool.
  * Returns a MYSQL* handle on success, nullptr on failure.
+ * Give it back with pool_release(mysql, PoolRelease::DIRTY).
  */
 static MYSQL *connect_remote(InceptionContext *ctx, std::string &errmsg) {
-  MYSQL *mysql = mysql_init(nullptr);
-  if (!mysql) {
-    errmsg = "mysql_init() failed: out of memory";
-    return nullptr;
-  }
-
-  /* Set connection charset to utf8mb4 */
-  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
-
+  PoolConnOptions opts;
   /* Connection timeout 10 seconds */
-  unsigned int connect_timeout = 10;
-  mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connect_timeout);
-
+  opts.connect_timeout = 10;
   /* Read/write timeouts: 600 seconds (10 minutes).
      Original inception used 86400 (24h) which is excessive.
      10 minutes is generous enough for large DDL operations. */
-  unsigned int rw_timeout = 600;
-  mysql_options(mysql, MYSQL_OPT_READ_TIMEOUT, &rw_timeout);
-  mysql_options(mysql, MYSQL_OPT_WRITE_TIMEOUT, &rw_timeout);
-
+  opts.read_timeout = 600;
+  opts.write_timeout = 600;
   /* Auto-reconnect if the connection drops mid-session */
-  bool reconnect = true;
-  mysql_options(mysql, MYSQL_OPT_RECONNECT, &reconnect);
+  opts.reconnect = true;
 
-  const char *host = ctx->host.empty() ? "127.0.0.1" : ctx->host.c_str();
-  const char *user = ctx->user.empty() ? "root" : ctx->user.c_str();
-  const char *pass = ctx->password.empty() ? nullptr : ctx->password.c_str();
-  unsigned int port = ctx->port;
-
-  if (!mysql_real_connect(mysql, host, user, pass, nullptr, port, nullptr, 0)) {
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  std::string err;
+  MYSQL *mysql = pool_acquire(host, ctx->port, user, ctx->password, opts, &err);
+  if (!mysql) {
     char buf[512];
-    snprintf(buf, sizeof(buf), "Cannot connect to remote %s:%u: %s", host, port,
-             mysql_error(mysql));
+    snprintf(buf, sizeof(buf), "Cannot connect to remote %s:%u: %s",
+             host.c_str(), ctx->port, err.c_str());
     errmsg = buf;
-    mysql_close(mysql);
     return nullptr;
   }
 
@@ -102,20 +131,10 @@ static MYSQL *connect_remote(InceptionContext *ctx, std::string &errmsg) {
 }
 
 /**
- * Collect warnings from the remote server via SHOW WARNINGS.
- * Appends them to the node's errmsg as warnings (Level: Code Message).
+ * Append the rows of a SHOW WARNINGS result to the node's errmsg as
+ * warnings (Level: Code Message), then free it.
  */
-static void collect_remote_warnings(MYSQL *mysql, SqlCacheNode *node) {
-  /* Access warning_count directly from MYSQL struct
-     (mysql_warning_count() is in libmysqlclient, not linked in server) */
-  if (mysql->warning_count == 0) return;
-
-  if (mysql_real_query(mysql, remote_sql::SHOW_WARNINGS,
-                       strlen(remote_sql::SHOW_WARNINGS))) return;
-
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return;
-
+static void record_warnings(MYSQL_RES *res, SqlCacheNode *node) {
   MYSQL_ROW row;
   while ((row = mysql_fetch_row(res))) {
     /* SHOW WARNINGS columns: Level, Code, Message */
@@ -134,6 +153,105 @@ static void collect_remote_warnings(MYSQL *mysql, SqlCacheNode *node) {
   mysql_free_result(res);
 }
 
+/** Microseconds since start, for the audit log timing of a statement. */
+static uint64_t us_since(std::chrono::steady_clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+}
+
+/** Collect warnings of the last statement from the remote server. */
+static void collect_remote_warnings(MYSQL *mysql, SqlCacheNode *node) {
+  /* Access warning_count directly from MYSQL struct
+     (mysql_warning_count() is in libmysqlclient, not linked in server) */
+  if (mysql->warning_count == 0) return;
+
+  const auto start = std::chrono::steady_clock::now();
+  node->round_trips++;
+  if (mysql_real_query(mysql, remote_sql::SHOW_WARNINGS,
+                       strlen(remote_sql::SHOW_WARNINGS))) return;
+
+  MYSQL_RES *res = mysql_store_result(mysql);
+  node->warnings_us += us_since(start);
+  if (res) record_warnings(res, node);
+}
+
+/**
+ * Count a round trip carrying bytes of SQL for node, in its round_trips
+ * and in Inception_* (inception_status.h).
+ */
+static void count_sent(SqlCacheNode *node, size_t bytes) {
+  node->round_trips++;
+  status_add(STATUS_REMOTE_QUERIES);
+  status_add(STATUS_BYTES_SENT, bytes);
+}
+
+/**
+ * Record affected_rows, execute_time and the remote warnings of the
+ * statement that just completed on mysql.
+ */
+static void record_execution(MYSQL *mysql, SqlCacheNode *node,
+                             std::chrono::steady_clock::time_point start) {
+  auto end_time = std::chrono::steady_clock::now();
+  double elapsed =
+      std::chrono::duration<double>(end_time - start).count();
+
+  /* Safe affected_rows: mysql returns ~0ULL on error or certain edge cases */
+  my_ulonglong raw_rows = mysql->affected_rows;
+  if (raw_rows == ~(my_ulonglong)0) {
+    node->affected_rows = 0;
+  } else {
+    node->affected_rows = static_cast<int64_t>(raw_rows);
+  }
+
+  node->execute_seconds = elapsed;
+  node->stage = STAGE_EXECUTED;
+  node->stage_status = "Execute completed";
+  status_add(STATUS_STATEMENTS_EXECUTED);
+
+  /* Always collect remote warnings via SHOW WARNINGS */
+  collect_remote_warnings(mysql, node);
+}
+
+/**
+ * Read the next result of a multi-statement query. Returns true on error
+ * or if there is none. mysql_next_result() is in libmysqlclient, not linked
+ * in server; its next_result method is read_query_result.
+ */
+static bool next_result(MYSQL *mysql) {
+  if (!(mysql->server_status & SERVER_MORE_RESULTS_EXISTS)) return true;
+  net_clear_error(&mysql->net);
+  mysql->affected_rows = ~(my_ulonglong)0;
+  return (*mysql->methods->read_query_result)(mysql);
+}
+
+/**
+ * Read and drop every result of the statement just sent, one row at a
+ * time, so a large SELECT or the result sets of a CALL never sit in memory
+ * together; mysql_use_result() is in libmysqlclient, its use_result method
+ * is cli_use_result. *rows counts the rows read, *had_rows is set if any
+ * result had a result set. Returns true if reading a result failed.
+ */
+static bool discard_results(MYSQL *mysql, my_ulonglong *rows,
+                            bool *had_rows) {
+  *rows = 0;
+  *had_rows = false;
+  for (;;) {
+    if (mysql->field_count > 0) {
+      MYSQL_RES *res = (*mysql->methods->use_result)(mysql);
+      if (!res) return true;
+      *had_rows = true;
+      while (mysql_fetch_row(res)) (*rows)++;
+      const bool failed = mysql_errno(mysql) != 0;
+      mysql_free_result(res);
+      if (failed) return true;
+    }
+    if (!(mysql->server_status & SERVER_MORE_RESULTS_EXISTS)) return false;
+    if (next_result(mysql)) return true;
+  }
+}
+
 /**
  * Execute a single SQL statement on the remote server.
  * Records affected_rows and execute_time in the node.
@@ -144,173 +262,356 @@ static void collect_remote_warnings(MYSQL *mysql, SqlCacheNode *node) {
 static bool execute_one(MYSQL *mysql, SqlCacheNode *node) {
   auto start = std::chrono::steady_clock::now();
 
-  /* Strip inception comment if present (first cached SQL may contain it) */
-  std::string exec_sql = strip_inception_comment(node->sql_text);
-  if (exec_sql.empty()) {
+  /* Skip the inception comment if present (first cached SQL may contain
+     it); the text is sent from the node itself */
+  const size_t skip = inception_comment_end(node->sql_text);
+  const char *exec_sql = node->sql_text.data() + skip;
+  const size_t exec_len = node->sql_text.size() - skip;
+  if (exec_len == 0) {
     node->stage = STAGE_EXECUTED;
     node->stage_status = "Execute completed";
     return false;
   }
 
-  if (mysql_real_query(mysql, exec_sql.c_str(),
-                       static_cast<unsigned long>(exec_sql.length()))) {
+  count_sent(node, exec_len);
+  if (mysql_real_query(mysql, exec_sql, static_cast<unsigned long>(exec_len))) {
     node->append_error("Execute failed: %s", mysql_error(mysql));
     node->stage = STAGE_EXECUTED;
     node->stage_status = "Execute failed";
     return true;
   }
 
-  /* Consume any result set (e.g., from SELECT, SHOW, etc.) */
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (res) {
-    mysql_free_result(res);
+  /* Drain the result sets of SELECT, SHOW or CALL; a SELECT reports the
+     rows it returned */
+  my_ulonglong rows;
+  bool had_rows;
+  if (discard_results(mysql, &rows, &had_rows)) {
+    node->append_error("Execute failed: %s", mysql_error(mysql));
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Execute failed";
+    return true;
   }
+  record_remote_latency(mysql, REMOTE_EXECUTE, start);
+  if (had_rows) mysql->affected_rows = rows;
 
-  auto end_time = std::chrono::steady_clock::now();
-  double elapsed =
-      std::chrono::duration<double>(end_time - start).count();
+  record_execution(mysql, node, start);
+  return false;
+}
 
-  /* Safe affected_rows: mysql returns ~0ULL on error or certain edge cases */
-  my_ulonglong raw_rows = mysql->affected_rows;
-  if (raw_rows == ~(my_ulonglong)0) {
-    node->affected_rows = 0;
-  } else {
-    node->affected_rows = static_cast<int64_t>(raw_rows);
+/**
+ * Execute a DML statement of a repeated shape as a prepared statement
+ * (inception_exec_prepare_min_repeats), falling back to execute_one() when
+ * it has no safe template or its prepare failed.
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_prepared(MYSQL *mysql, PreparedStatements *prepared,
+                             SqlCacheNode *node) {
+  auto start = std::chrono::steady_clock::now();
+  std::string err;
+  node->round_trips++;
+  status_add(STATUS_REMOTE_QUERIES);
+  switch (prepared->execute(bare_statement(*node), &err)) {
+    case PreparedResult::UNSUPPORTED:
+      return execute_one(mysql, node);
+    case PreparedResult::FAILED:
+      node->append_error("Execute failed: %s", err.c_str());
+      node->stage = STAGE_EXECUTED;
+      node->stage_status = "Execute failed";
+      return true;
+    case PreparedResult::OK:
+      break;
   }
+  record_remote_latency(mysql, REMOTE_EXECUTE, start);
+  record_execution(mysql, node, start);
+  return false;
+}
 
-  char time_buf[64];
-  snprintf(time_buf, sizeof(time_buf), "%.3f", elapsed);
-  node->execute_time = time_buf;
-  node->stage = STAGE_EXECUTED;
-  node->stage_status = "Execute completed";
+/**
+ * --enable-server-timing: read how long the statement that just ran on
+ * mysql took on the target itself, and what it waited for locks and
+ * examined, telling the target's time from the network's in execute_us.
+ * Left at -1 if performance_schema or its statements history is off.
+ */
+static void capture_server_timing(MYSQL *mysql, SqlCacheNode *node) {
+  std::vector<std::string> row;
+  bool found;
+  count_sent(node, strlen(remote_sql::STATEMENT_SERVER_TIMING));
+  if (query_one_row(mysql, remote_sql::STATEMENT_SERVER_TIMING, &row,
+                    &found) ||
+      !found)
+    return;
+  /* picoseconds */
+  node->server_us =
+      static_cast<int64_t>(strtoull(row[0].c_str(), nullptr, 10) / 1000000);
+  node->lock_us =
+      static_cast<int64_t>(strtoull(row[1].c_str(), nullptr, 10) / 1000000);
+  node->rows_examined =
+      static_cast<int64_t>(strtoull(row[2].c_str(), nullptr, 10));
+}
 
-  /* Always collect remote warnings via SHOW WARNINGS */
-  collect_remote_warnings(mysql, node);
+/**
+ * Drop metadata cache entries made stale by an executed DDL statement,
+ * so later audits against this target see the new definition.
+ */
+static void invalidate_cached_metadata(InceptionContext *ctx,
+                                       const SqlCacheNode &node) {
+  if (node.db_name.empty()) return;
+  switch (node.sql_command) {
+    case SQLCOM_CREATE_DB:
+    case SQLCOM_DROP_DB:
+    case SQLCOM_ALTER_DB:
+    case SQLCOM_DROP_TABLE:   /* may list several tables */
+    case SQLCOM_RENAME_TABLE: /* touches source and target names */
+      cache_invalidate_schema(cache_target(ctx), node.db_name);
+      break;
+    case SQLCOM_CREATE_TABLE:
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_TRUNCATE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX:
+      cache_invalidate_table(cache_target(ctx), node.db_name,
+                             node.table_name);
+      break;
+    default:
+      break;
+  }
+}
 
-  return false;
+/**
+ * Time a native ALTER that went through the table's data into the target's
+ * rebuild speed (cache_note_rebuild()), so that the estimated_time of the
+ * ALTERs audited after it follows what the target actually does.
+ */
+static void calibrate_rebuild_speed(InceptionContext *ctx,
+                                    const SqlCacheNode &node, bool failed) {
+  if (failed || node.sql_command != SQLCOM_ALTER_TABLE ||
+      node.exec_strategy != "NATIVE" || node.table_bytes <= 0 ||
+      node.ddl_algorithm == "INSTANT" || node.execute_seconds < 0)
+    return;
+  cache_note_rebuild(cache_target(ctx), node.ddl_algorithm, node.table_bytes,
+                     node.execute_seconds);
 }
 
 /**
- * Connect to a slave host for replication delay checking.
- * Uses the same user/password as the main connection.
+ * Time an UPDATE/DELETE into the target's replica apply speed
+ * (cache_note_apply()): its row events, the bytes per row estimated by the
+ * audit times the rows it changed, took execute_seconds to produce, and
+ * take a replica about as long to apply.
  */
-static MYSQL *connect_slave(const std::string &host, uint port,
-                            InceptionContext *ctx, std::string &errmsg) {
-  MYSQL *mysql = mysql_init(nullptr);
-  if (!mysql) {
-    errmsg = "mysql_init() failed";
-    return nullptr;
-  }
+static void calibrate_apply_speed(InceptionContext *ctx,
+                                  const SqlCacheNode &node, bool failed) {
+  if (failed || node.binlog_row_bytes <= 0 || node.affected_rows <= 0 ||
+      node.execute_seconds < 0)
+    return;
+  cache_note_apply(cache_target(ctx),
+                   node.binlog_row_bytes * node.affected_rows,
+                   node.execute_seconds);
+}
+
+/* inception_exec_online_alter_fallback */
+static const ulong ONLINE_ALTER_FALLBACK_ERROR = 0;
+static const ulong ONLINE_ALTER_FALLBACK_OSC = 1;
+
+/** Whether node takes the --enable-online-alter path in execute_online_alter(). */
+static bool online_alter_applies(const InceptionContext *ctx,
+                                 const SqlCacheNode &node) {
+  std::string spec;
+  return ctx->online_alter && node.sql_command == SQLCOM_ALTER_TABLE &&
+         node.online_clause && node.exec_strategy == "NATIVE" &&
+         (node.ddl_algorithm == "INSTANT" || node.ddl_algorithm == "INPLACE") &&
+         alter_specification(node.sql_text, &spec) && !spec.empty();
+}
 
-  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
-  unsigned int connect_timeout = 10;
-  mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connect_timeout);
-  unsigned int rw_timeout = 30;
-  mysql_options(mysql, MYSQL_OPT_READ_TIMEOUT, &rw_timeout);
+/**
+ * --enable-online-alter: run an ALTER predicted INSTANT or INPLACE with
+ * that algorithm spelled out, ", ALGORITHM=INSTANT" or ", ALGORITHM=INPLACE,
+ * LOCK=NONE", so that the target refuses it rather than silently copying
+ * the table or blocking writes. A refused INSTANT is retried INPLACE; when
+ * INPLACE is refused as well, inception_exec_online_alter_fallback decides:
+ * the online schema change engine (OSC, if it can run the ALTER), the
+ * statement as written (COPY), or no execution (ERROR).
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_online_alter(MYSQL *mysql, InceptionContext *ctx,
+                                 SqlCacheNode *node,
+                                 const std::function<bool()> &pause) {
+  static const char *const ALGORITHMS[] = {"INSTANT", "INPLACE"};
+  static const char *const CLAUSES[] = {", ALGORITHM=INSTANT",
+                                        ", ALGORITHM=INPLACE, LOCK=NONE"};
+  const std::string sql = node->sql_text;
+  const std::string bare = bare_statement(*node);
+  const int errlevel = node->errlevel;
+  const std::string errmsg = node->errmsg;
+
+  std::string refused;
+  for (size_t a = node->ddl_algorithm == "INSTANT" ? 0 : 1; a < 2; a++) {
+    unsigned int err = 0;
+    node->sql_text = bare + CLAUSES[a];
+    const bool failed = execute_mdl_guarded(mysql, ctx, node, [&] {
+      const bool f = execute_one(mysql, node);
+      err = f ? mysql_errno(mysql) : 0;
+      return f;
+    });
+    node->sql_text = sql;
+    if (!failed) {
+      node->ddl_algorithm = ALGORITHMS[a];
+      node->stage_status += std::string(" (ALGORITHM=") + ALGORITHMS[a] + ")";
+      return false;
+    }
+    if (err != ER_ALTER_OPERATION_NOT_SUPPORTED &&
+        err != ER_ALTER_OPERATION_NOT_SUPPORTED_REASON)
+      return true;
 
-  const char *user = ctx->user.empty() ? "root" : ctx->user.c_str();
-  const char *pass = ctx->password.empty() ? nullptr : ctx->password.c_str();
+    /* Refused: only the outcome of the last attempt is reported */
+    refused = mysql_error(mysql);
+    node->errlevel = errlevel;
+    node->errmsg = errmsg;
+    fprintf(stderr, "[Inception] ALGORITHM=%s refused for %s.%s: %s\n",
+            ALGORITHMS[a], node->db_name.c_str(), node->table_name.c_str(),
+            refused.c_str());
+    fflush(stderr);
+  }
 
-  if (!mysql_real_connect(mysql, host.c_str(), user, pass, nullptr, port,
-                          nullptr, 0)) {
-    char buf[512];
-    snprintf(buf, sizeof(buf), "Cannot connect to slave %s:%u: %s",
-             host.c_str(), port, mysql_error(mysql));
-    errmsg = buf;
-    mysql_close(mysql);
-    return nullptr;
+  if (opt_exec_online_alter_fallback == ONLINE_ALTER_FALLBACK_OSC &&
+      node->osc_capable) {
+    node->append_warning("The target refused ALGORITHM=INSTANT/INPLACE, "
+                         "LOCK=NONE; running the ALTER through the online "
+                         "schema change.");
+    node->exec_strategy = "OSC";
+    node->ddl_algorithm = "COPY";
+    node->locks_writes = "NO";
+    return osc_execute(mysql, ctx, node, pause);
   }
-  return mysql;
+  if (opt_exec_online_alter_fallback == ONLINE_ALTER_FALLBACK_ERROR ||
+      opt_exec_online_alter_fallback == ONLINE_ALTER_FALLBACK_OSC) {
+    node->append_error("ALTER not executed: the target refused "
+                       "ALGORITHM=INSTANT/INPLACE, LOCK=NONE (%s)%s.",
+                       refused.c_str(),
+                       opt_exec_online_alter_fallback ==
+                               ONLINE_ALTER_FALLBACK_OSC
+                           ? " and the online schema change cannot run it"
+                           : "");
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Execute failed";
+    return true;
+  }
+  node->append_warning("The target refused ALGORITHM=INSTANT/INPLACE, "
+                       "LOCK=NONE; ALTER run without them.");
+  node->ddl_algorithm = "COPY";
+  node->locks_writes = "YES";
+  return execute_mdl_guarded(mysql, ctx, node,
+                             [&] { return execute_one(mysql, node); });
 }
 
 /**
- * Wait until target server load is below thresholds.
- * Checks:
+ * Wait until target server load is below thresholds, as last sampled by
+ * the shared load sampler of the target (inception_load.h):
  *   1. Threads_running on primary (if opt_exec_max_threads_running > 0)
- *   2. Seconds_Behind_Master on each slave (if opt_exec_max_replication_delay > 0)
- * Loops with 1-second sleep until all checks pass.
+ *   2. Replication lag of each slave (if opt_exec_max_replication_delay > 0),
+ *      from the heartbeat table when configured
+ *   3. InnoDB history list length on primary
+ *      (if opt_exec_max_history_list_length > 0)
+ *   4. Redo checkpoint age on primary (if opt_exec_max_checkpoint_age_pct > 0)
+ *   5. p99 statement latency on primary (if opt_exec_max_statement_p99_ms > 0)
+ * Re-checks at every new sample until all checks pass; a kill ends the
+ * wait at once. Unknown metrics never hold execution. With stopped_only,
+ * as under the adaptive throttle, only stopped replication holds it.
  */
-static bool wait_for_remote_ready(MYSQL *mysql,
-                                  std::vector<MYSQL *> &slave_conns,
-                                  InceptionContext *ctx) {
+static bool wait_for_remote_ready(const LoadWatch &load, InceptionContext *ctx,
+                                  bool stopped_only = false) {
+  std::string logged;
   for (;;) {
     if (ctx->killed.load()) return true;
 
-    bool need_wait = false;
+    const LoadSample s = load.sample();
+    char reason[160] = "";
 
     /* Check Threads_running on primary */
-    if (opt_exec_max_threads_running > 0) {
-      if (mysql_real_query(mysql, remote_sql::SHOW_THREADS_RUNNING,
-                           strlen(remote_sql::SHOW_THREADS_RUNNING)) == 0) {
-        MYSQL_RES *res = mysql_store_result(mysql);
-        if (res) {
-          MYSQL_ROW row = mysql_fetch_row(res);
-          if (row && row[1]) {
-            ulong running = strtoul(row[1], nullptr, 10);
-            ctx->last_threads_running.store(running);
-            if (running > opt_exec_max_threads_running) {
-              fprintf(stderr,
-                      "[Inception] Waiting: Threads_running=%lu > %lu\n",
-                      running, opt_exec_max_threads_running);
-              fflush(stderr);
-              need_wait = true;
-            }
-          }
-          mysql_free_result(res);
-        }
-      }
+    if (s.threads_running >= 0) {
+      const ulong running = static_cast<ulong>(s.threads_running);
+      ctx->last_threads_running.store(running);
+      if (!stopped_only && opt_exec_max_threads_running > 0 &&
+          running > opt_exec_max_threads_running)
+        snprintf(reason, sizeof(reason), "Threads_running=%lu > %lu", running,
+                 opt_exec_max_threads_running);
     }
 
     /* Check replication delay on user-specified slave hosts */
-    long max_delay = -1;
-    if (!need_wait && opt_exec_max_replication_delay > 0) {
-      for (auto *slave : slave_conns) {
-        if (mysql_real_query(slave, remote_sql::SHOW_SLAVE_STATUS,
-                             strlen(remote_sql::SHOW_SLAVE_STATUS)) == 0) {
-          MYSQL_RES *res = mysql_store_result(slave);
-          if (res) {
-            /* Seconds_Behind_Master is column index 32 in SHOW SLAVE STATUS */
-            unsigned int num_fields = mysql_num_fields(res);
-            MYSQL_ROW row = mysql_fetch_row(res);
-            if (row && num_fields > 32 && row[32]) {
-              ulong delay = strtoul(row[32], nullptr, 10);
-              if (static_cast<long>(delay) > max_delay)
-                max_delay = static_cast<long>(delay);
-              if (delay > opt_exec_max_replication_delay) {
-                fprintf(stderr,
-                        "[Inception] Waiting: slave replication delay=%lus "
-                        "> %lu\n",
-                        delay, opt_exec_max_replication_delay);
-                fflush(stderr);
-                need_wait = true;
-              }
-            } else if (row && num_fields > 32 && !row[32]) {
-              /* NULL means replication is not running or broken */
-              fprintf(stderr,
-                      "[Inception] Waiting: slave Seconds_Behind_Master "
-                      "is NULL (replication may be stopped)\n");
-              fflush(stderr);
-              need_wait = true;
-            }
-            mysql_free_result(res);
-          }
-        }
-        if (need_wait) break;
+    if (s.repl_lag_ms >= 0) ctx->last_repl_delay_ms.store(s.repl_lag_ms);
+    if (!*reason && opt_exec_max_replication_delay > 0) {
+      const long limit_ms =
+          static_cast<long>(opt_exec_max_replication_delay) * 1000;
+      if (s.repl_stopped) {
+        /* NULL means replication is not running or broken */
+        snprintf(reason, sizeof(reason),
+                 "slave Seconds_Behind_Master is NULL "
+                 "(replication may be stopped)");
+      } else if (!stopped_only && s.repl_lag_ms > limit_ms) {
+        snprintf(reason, sizeof(reason),
+                 "slave replication delay=%.3fs > %lu",
+                 s.repl_lag_ms / 1000.0, opt_exec_max_replication_delay);
       }
     }
-    if (max_delay >= 0) ctx->last_repl_delay.store(max_delay);
 
-    if (!need_wait) break;
+    /* Check unpurged undo, checkpoint age and statement latency on primary;
+       the adaptive throttle paces on these instead */
+    if (!stopped_only) {
+      if (!*reason && opt_exec_max_history_list_length > 0 &&
+          s.history_length > static_cast<long long>(
+                                 opt_exec_max_history_list_length))
+        snprintf(reason, sizeof(reason), "history list length=%lld > %lu",
+                 s.history_length, opt_exec_max_history_list_length);
+      if (!*reason && opt_exec_max_checkpoint_age_pct > 0 &&
+          s.checkpoint_age_pct >
+              static_cast<long>(opt_exec_max_checkpoint_age_pct))
+        snprintf(reason, sizeof(reason), "checkpoint age=%ld%% > %lu%%",
+                 s.checkpoint_age_pct, opt_exec_max_checkpoint_age_pct);
+      if (!*reason && opt_exec_max_statement_p99_ms > 0 &&
+          s.p99_ms > static_cast<long>(opt_exec_max_statement_p99_ms))
+        snprintf(reason, sizeof(reason), "statement p99=%ldms > %lums",
+                 s.p99_ms, opt_exec_max_statement_p99_ms);
+    }
+
+    if (!*reason) break;
+    if (logged != reason) {
+      fprintf(stderr, "[Inception] Waiting: %s\n", reason);
+      fflush(stderr);
+      logged = reason;
+    }
 
-    /* Sleep 1 second before retrying */
-    struct timespec ts;
-    ts.tv_sec = 1;
-    ts.tv_nsec = 0;
-    nanosleep(&ts, nullptr);
+    if (ctx->sleep_unless_killed(load.interval_ms())) return true;
   }
   return false;
 }
 
+/**
+ * The load throttle before a statement or chunk: wait while a ceiling is
+ * crossed or, with inception_exec_adaptive_throttle, wait only for stopped
+ * replication and then pause for the controller's current pace.
+ *
+ * @return true if the session was killed.
+ */
+static bool throttle(LoadWatch &load, InceptionContext *ctx,
+                     SqlCacheNode *node) {
+  StageScope stage(stage_inception_throttle_wait);
+  const auto start = std::chrono::steady_clock::now();
+  bool killed;
+  if (!opt_exec_adaptive_throttle) {
+    killed = wait_for_remote_ready(load, ctx);
+  } else if (wait_for_remote_ready(load, ctx, true)) {
+    killed = true;
+  } else {
+    const uint64_t pause = load.pace_ms(load.sample());
+    killed = pause > 0 && ctx->sleep_unless_killed(pause);
+  }
+  const uint64_t waited_us = us_since(start);
+  node->throttle_wait_us += waited_us;
+  status_add(STATUS_THROTTLE_WAIT_MS, waited_us / 1000);
+  return killed;
+}
+
 static bool parse_onoff_value(const char *v) {
   if (!v) return false;
   if (strcmp(v, "1") == 0) return true;
@@ -340,8 +641,9 @@ static bool check_remote_read_only(MYSQL *mysql, bool &read_only,
   return true;
 }
 
-static bool pre_execute_checks(MYSQL *mysql, std::vector<MYSQL *> &slave_conns,
-                               InceptionContext *ctx, SqlCacheNode *node) {
+static bool pre_execute_checks(MYSQL *mysql, LoadWatch &load,
+                               TargetBudget &budget, InceptionContext *ctx,
+                               SqlCacheNode *node) {
   if (opt_exec_check_read_only) {
     bool read_only = false;
     std::string ro_err;
@@ -361,108 +663,1172 @@ static bool pre_execute_checks(MYSQL *mysql, std::vector<MYSQL *> &slave_conns,
     }
   }
 
-  if (opt_exec_max_threads_running > 0 ||
-      (!slave_conns.empty() && opt_exec_max_replication_delay > 0)) {
-    if (wait_for_remote_ready(mysql, slave_conns, ctx)) {
-      node->stage = STAGE_EXECUTED;
-      node->stage_status = "Killed by user";
-      return true;
-    }
+  if ((load.active() && throttle(load, ctx, node)) || budget.pay()) {
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Killed by user";
+    return true;
   }
 
   return false;
 }
 
-bool execute_statements(THD *thd, InceptionContext *ctx) {
-  if (ctx->cache_nodes.empty()) return false;
+/* ---- Chunked DML (--enable-chunked-dml) ---- */
 
-  /* Check if already killed before we start */
-  if (ctx->killed.load()) {
-    for (auto &node : ctx->cache_nodes) {
-      node.stage = STAGE_EXECUTED;
-      node.stage_status = "Killed by user";
-    }
-    return true;
+std::string quote_ident(const std::string &name) {
+  std::string out = "`";
+  for (char c : name) {
+    if (c == '`') out += '`';
+    out += c;
   }
+  out += '`';
+  return out;
+}
 
-  /* Connect to remote target */
-  std::string conn_err;
-  MYSQL *mysql = connect_remote(ctx, conn_err);
-  if (!mysql) {
-    /* Record connection error on all nodes */
-    for (auto &node : ctx->cache_nodes) {
-      node.append_error("%s", conn_err.c_str());
-      node.stage = STAGE_EXECUTED;
-      node.stage_status = "Execute failed";
-    }
+bool run_sql(MYSQL *mysql, const std::string &sql, std::string *err) {
+  if (mysql_real_query(mysql, sql.c_str(),
+                       static_cast<unsigned long>(sql.size()))) {
+    *err = mysql_error(mysql);
     return true;
   }
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (res) mysql_free_result(res);
+  return false;
+}
 
-  /* Store remote thread id for force kill support
-     (use struct member directly; mysql_thread_id() is in libmysqlclient) */
-  ctx->remote_exec_thread_id.store(mysql->thread_id);
-
-  bool has_error = false;
-  bool stop_exec = false;
-
-  int total = static_cast<int>(ctx->cache_nodes.size());
-  int idx = 0;
+std::string format_sql(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(nullptr, 0, fmt, args);
+  va_end(args);
+  if (n <= 0) return std::string();
+  std::string out(static_cast<size_t>(n) + 1, '\0');
+  va_start(args, fmt);
+  vsnprintf(&out[0], out.size(), fmt, args);
+  va_end(args);
+  out.resize(static_cast<size_t>(n));
+  return out;
+}
 
-  /* Pre-scan: if any statement has audit ERROR or WARNING,
-     block the entire batch from executing.
-     --enable-force: skip ERROR check (force execute despite audit errors)
-     --enable-ignore-warnings: skip WARNING check */
-  for (const auto &node : ctx->cache_nodes) {
-    if (node.errlevel >= ERRLEVEL_ERROR && !ctx->force) {
-      stop_exec = true;
-      break;
-    }
-    if (node.errlevel >= ERRLEVEL_WARNING && !ctx->ignore_warnings) {
-      stop_exec = true;
-      break;
-    }
+/**
+ * If sql[i] starts a quoted string or identifier or a comment, move i to
+ * its last character and return true.
+ */
+static bool skip_quoted(const std::string &sql, size_t &i) {
+  size_t n = sql.size();
+  char c = sql[i];
+  if (c == '\'' || c == '"' || c == '`') {
+    for (i++; i < n && sql[i] != c; i++)
+      if (sql[i] == '\\' && c != '`') i++;
+    return true;
   }
-
-  if (stop_exec) {
-    fprintf(stderr, "[Inception] Audit findings detected, "
-            "skipping entire batch (%d statements).\n", total);
-    fflush(stderr);
-    /* Audit found errors — keep stage as CHECKED, do not execute */
-    mysql_close(mysql);
+  if (c == '#' || (c == '-' && i + 2 < n && sql[i + 1] == '-' &&
+                   isspace(static_cast<unsigned char>(sql[i + 2])))) {
+    while (i < n && sql[i] != '\n') i++;
+    return true;
+  }
+  if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+    size_t close = sql.find("*/", i + 2);
+    i = (close == std::string::npos) ? n : close + 1;
     return true;
   }
+  return false;
+}
 
-  /* Reset stop_exec for runtime error tracking (--enable-force) */
-  stop_exec = false;
+static bool is_ident_char(char c) {
+  return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
 
-  /* Connect to user-specified slave hosts for replication delay checking */
-  std::vector<MYSQL *> slave_conns;
-  if (opt_exec_max_replication_delay > 0 && !ctx->slave_hosts.empty()) {
-    for (auto &sh : ctx->slave_hosts) {
-      std::string err;
-      MYSQL *s = connect_slave(sh.first, sh.second, ctx, err);
-      if (s) {
-        slave_conns.push_back(s);
-      } else {
-        fprintf(stderr, "[Inception] Slave %s:%u connect failed: %s\n",
-                sh.first.c_str(), sh.second, err.c_str());
-        fflush(stderr);
-      }
-    }
+/**
+ * Offset of the first keyword kw outside quotes, comments and parentheses,
+ * or npos.
+ */
+static size_t find_top_level_keyword(const std::string &sql, const char *kw) {
+  size_t n = sql.size();
+  size_t len = strlen(kw);
+  int depth = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (skip_quoted(sql, i)) continue;
+    if (sql[i] == '(') depth++;
+    if (sql[i] == ')') depth--;
+    if (depth == 0 && i + len <= n && strncasecmp(&sql[i], kw, len) == 0 &&
+        (i == 0 || !is_ident_char(sql[i - 1])) &&
+        (i + len == n || !is_ident_char(sql[i + len])))
+      return i;
   }
+  return std::string::npos;
+}
 
-  for (auto &node : ctx->cache_nodes) {
-    idx++;
+/**
+ * Split a single-table UPDATE/DELETE into the text before its top-level
+ * WHERE and the condition after it (cond is empty if there is no WHERE).
+ * Quotes, comments and parenthesised subqueries are skipped.
+ */
+static void split_top_level_where(const std::string &sql, std::string *prefix,
+                                  std::string *cond) {
+  size_t where = find_top_level_keyword(sql, "WHERE");
+  if (where == std::string::npos) {
+    *prefix = sql;
+    cond->clear();
+    return;
+  }
+  *prefix = sql.substr(0, where);
+  *cond = sql.substr(where + 5);
+}
 
-    /* Check if session was killed by another thread */
-    if (ctx->killed.load()) {
-      node.stage = STAGE_EXECUTED;
-      node.stage_status = "Killed by user";
-      fprintf(stderr, "[Inception] [%d/%d] KILLED: %.200s\n",
-              idx, total, node.sql_text.c_str());
-      fflush(stderr);
+bool query_one_row(MYSQL *mysql, const std::string &query,
+                   std::vector<std::string> *out, bool *found) {
+  *found = false;
+  if (mysql_real_query(mysql, query.c_str(),
+                       static_cast<unsigned long>(query.size())))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  if (row) {
+    *found = true;
+    out->clear();
+    for (unsigned int i = 0; i < mysql_num_fields(res); i++)
+      out->push_back(row[i] ? row[i] : "");
+    if (!row[0]) *found = false;
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+/** Case-insensitive search for name as a whole identifier in text. */
+static bool mentions_identifier(const std::string &text,
+                                const std::string &name) {
+  auto is_ident = [](char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+  };
+  for (size_t i = 0; i + name.size() <= text.size(); i++) {
+    if (strncasecmp(&text[i], name.c_str(), name.size()) != 0) continue;
+    if (i > 0 && is_ident(text[i - 1])) continue;
+    if (i + name.size() < text.size() && is_ident(text[i + name.size()]))
       continue;
-    }
+    return true;
+  }
+  return false;
+}
+
+std::string single_integer_pk(MYSQL *mysql, const std::string &db,
+                              const std::string &table) {
+  char query[1024];
+  snprintf(query, sizeof(query), remote_sql::GET_PRIMARY_KEY, db.c_str(),
+           table.c_str());
+  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+    return "";
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return "";
+  std::string col;
+  bool integer = false;
+  int ncols = 0;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    ncols++;
+    if (!row[0] || !row[1]) continue;
+    col = row[0];
+    integer = strcasecmp(row[1], "tinyint") == 0 ||
+              strcasecmp(row[1], "smallint") == 0 ||
+              strcasecmp(row[1], "mediumint") == 0 ||
+              strcasecmp(row[1], "int") == 0 ||
+              strcasecmp(row[1], "bigint") == 0;
+  }
+  mysql_free_result(res);
+  return (ncols == 1 && integer) ? col : "";
+}
+
+bool list_partitions(MYSQL *mysql, const std::string &db,
+                     const std::string &table,
+                     std::vector<std::string> *names) {
+  const std::string query =
+      format_sql(remote_sql::GET_PARTITION_NAMES, db.c_str(), table.c_str());
+  if (mysql_real_query(mysql, query.c_str(),
+                       static_cast<unsigned long>(query.size())))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res)))
+    if (row[0]) names->push_back(row[0]);
+  mysql_free_result(res);
+  return false;
+}
+
+bool ChunkPacer::wait(InceptionContext *ctx) {
+  if (m_per_sec == 0) return ctx->killed.load();
+  const auto now = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point slot;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    slot = std::max(now, m_next);
+    m_next = slot + std::chrono::microseconds(1000000 / m_per_sec);
+  }
+  const auto ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(slot - now)
+          .count();
+  if (ms > 0) return ctx->sleep_unless_killed(static_cast<uint64_t>(ms));
+  return ctx->killed.load();
+}
+
+/**
+ * Between two chunks of a long-running statement: the Threads_running /
+ * replication-delay throttle, then --sleep and "inception pause".
+ *
+ * @return true if the session was killed.
+ */
+static bool pause_between_chunks(LoadWatch &load, TargetBudget &budget,
+                                 InceptionContext *ctx, SqlCacheNode *node) {
+  if (ctx->killed.load() || (load.active() && throttle(load, ctx, node)) ||
+      budget.pay())
+    return true;
+  return ctx->wait_between_statements();
+}
+
+/** Whether the TiDB target runs cmd as non-transactional DML ("BATCH ..."). */
+static bool tidb_batch_supported(const InceptionContext *ctx,
+                                 enum_sql_command cmd) {
+  if (ctx->db_type != DbType::TIDB) return false;
+  const uint version = ctx->db_version_major * 100 + ctx->db_version_minor;
+  return version >= (cmd == SQLCOM_DELETE ? 601u : 605u);
+}
+
+/**
+ * --enable-tidb-batch-dml: run a large UPDATE/DELETE on TiDB as
+ * "BATCH [ON pk] LIMIT <inception_exec_chunk_size> <statement>", which
+ * TiDB splits into transactions of that many rows on the server (DELETE
+ * from 6.1, UPDATE from 6.5). It answers with the number of batches and
+ * their status; the rows changed are not reported, affected_rows keeps
+ * the audit's estimate.
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_tidb_batch(MYSQL *mysql, InceptionContext *ctx,
+                               SqlCacheNode *node, const std::string &pk_name) {
+  std::string sql = "BATCH ";
+  if (!pk_name.empty()) sql += "ON " + quote_ident(pk_name) + " ";
+  sql += "LIMIT " + std::to_string(opt_exec_chunk_size) + " " +
+         bare_statement(*node);
+
+  fprintf(stderr, "[Inception] TiDB batch DML: %s.%s, %lu rows per batch.\n",
+          node->db_name.c_str(), node->table_name.c_str(),
+          opt_exec_chunk_size);
+  fflush(stderr);
+  const auto start = std::chrono::steady_clock::now();
+  ctx->chunk_node_id.store(node->id);
+  ctx->chunks_done.store(0);
+  ctx->chunk_rows.store(0);
+
+  count_sent(node, sql.size());
+  bool failed = false;
+  long jobs = 0;
+  if (mysql_real_query(mysql, sql.c_str(),
+                       static_cast<unsigned long>(sql.size()))) {
+    node->append_error("Execute failed: %s", mysql_error(mysql));
+    failed = true;
+  } else {
+    /* One row: number of jobs, job status ("all succeeded") */
+    MYSQL_RES *res = mysql_store_result(mysql);
+    record_remote_latency(mysql, REMOTE_EXECUTE, start);
+    if (res) {
+      MYSQL_ROW row = mysql_fetch_row(res);
+      if (row && row[0]) jobs = strtol(row[0], nullptr, 10);
+      if (row && mysql_num_fields(res) > 1 && row[1] &&
+          strcmp(row[1], "all succeeded") != 0) {
+        node->append_error("TiDB batch DML: %s", row[1]);
+        failed = true;
+      }
+      mysql_free_result(res);
+    }
+    ctx->chunks_done.store(jobs);
+    collect_remote_warnings(mysql, node);
+  }
+
+  node->execute_seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+  node->stage = STAGE_EXECUTED;
+  if (failed) {
+    node->stage_status = "Execute failed";
+  } else {
+    char status[64];
+    snprintf(status, sizeof(status), "Execute completed (%ld batches)", jobs);
+    node->stage_status = status;
+    status_add(STATUS_STATEMENTS_EXECUTED);
+  }
+  ctx->chunk_node_id.store(0);
+  return failed;
+}
+
+/**
+ * Execute a single-table UPDATE/DELETE as consecutive primary-key ranges of
+ * inception_exec_chunk_size rows, each committed on its own, with the
+ * Threads_running / replication-delay throttle and --sleep applied between
+ * chunks. Falls back to execute_one() when the table has no single integer
+ * primary key or is empty. Each committed chunk is checkpointed, and with
+ * --resume the statement continues after the last checkpointed chunk.
+ * A --enable-tidb-batch-dml statement goes to execute_tidb_batch() when
+ * the TiDB release has non-transactional DML for it, and is chunked here
+ * otherwise.
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_chunked(MYSQL *mysql, LoadWatch &load,
+                            TargetBudget &budget, BatchCheckpoint &checkpoint,
+                            InceptionContext *ctx, SqlCacheNode *node) {
+  std::string pk_name =
+      single_integer_pk(mysql, node->db_name, node->table_name);
+  std::string sql = bare_statement(*node);
+  std::string prefix, cond;
+  split_top_level_where(sql, &prefix, &cond);
+
+  /* TiDB refuses a BATCH UPDATE of its shard column itself */
+  if (node->tidb_batch && tidb_batch_supported(ctx, node->sql_command) &&
+      !(node->sql_command == SQLCOM_UPDATE && !pk_name.empty() &&
+        mentions_identifier(prefix, pk_name)))
+    return execute_tidb_batch(mysql, ctx, node, pk_name);
+  if (pk_name.empty()) {
+    fprintf(stderr, "[Inception] Chunked DML: %s.%s has no single integer "
+            "primary key, executing as one statement.\n",
+            node->db_name.c_str(), node->table_name.c_str());
+    fflush(stderr);
+    return execute_one(mysql, node);
+  }
+
+  /* An UPDATE that may assign the key would move rows between chunks. */
+  if (node->sql_command == SQLCOM_UPDATE &&
+      mentions_identifier(prefix, pk_name)) {
+    fprintf(stderr, "[Inception] Chunked DML: UPDATE may modify primary key "
+            "%s, executing as one statement.\n", pk_name.c_str());
+    fflush(stderr);
+    return execute_one(mysql, node);
+  }
+
+  const std::string pk = quote_ident(pk_name);
+  const std::string db = quote_ident(node->db_name);
+  const std::string table = quote_ident(node->table_name);
+
+  char query[1024];
+  snprintf(query, sizeof(query), remote_sql::CHUNK_PK_RANGE, pk.c_str(),
+           pk.c_str(), db.c_str(), table.c_str());
+  std::vector<std::string> range;
+  bool found = false;
+  if (query_one_row(mysql, query, &range, &found) || !found)
+    return execute_one(mysql, node);  /* empty table or lookup failed */
+  const std::string max_pk = range[1];
+
+  /* Newline before ')' in case the condition ends in a -- comment */
+  std::string where =
+      cond.empty() ? " WHERE " : " WHERE (" + cond + "\n) AND ";
+
+  auto start = std::chrono::steady_clock::now();
+  ctx->chunk_node_id.store(node->id);
+  ctx->chunks_done.store(0);
+  ctx->chunk_rows.store(0);
+
+  std::string lower = range[0];
+  const char *op = ">=";
+  int64_t total_rows = 0;
+  long chunks = 0;
+  bool failed = false;
+  if (checkpoint.resumed_chunk(node->id, &lower, &chunks, &total_rows)) {
+    op = ">";
+    ctx->chunks_done.store(chunks);
+    ctx->chunk_rows.store(total_rows);
+    fprintf(stderr, "[Inception] Chunked DML: resuming after %s = %s "
+            "(%ld chunks, %lld rows done before).\n", pk.c_str(),
+            lower.c_str(), chunks, static_cast<long long>(total_rows));
+    fflush(stderr);
+  }
+
+  for (;;) {
+    /* Upper bound: the chunk_size-th key from lower, or the max key */
+    snprintf(query, sizeof(query), remote_sql::CHUNK_NEXT_BOUNDARY, pk.c_str(),
+             db.c_str(), table.c_str(), pk.c_str(), op, lower.c_str(),
+             pk.c_str(), opt_exec_chunk_size - 1);
+    std::vector<std::string> boundary;
+    if (query_one_row(mysql, query, &boundary, &found)) {
+      node->append_error("Chunked DML: cannot read chunk boundary: %s",
+                         mysql_error(mysql));
+      failed = true;
+      break;
+    }
+    bool last = !found;
+    std::string upper = last ? max_pk : boundary[0];
+
+    std::string chunk_sql = prefix + where + pk + " " + op + " " + lower +
+                            " AND " + pk + " <= " + upper;
+    count_sent(node, chunk_sql.size());
+    const auto chunk_start = std::chrono::steady_clock::now();
+    if (mysql_real_query(mysql, chunk_sql.c_str(),
+                         static_cast<unsigned long>(chunk_sql.size()))) {
+      node->append_error("Execute failed at chunk %ld (%s %s %s, <= %s): %s",
+                         chunks + 1, pk.c_str(), op, lower.c_str(),
+                         upper.c_str(), mysql_error(mysql));
+      failed = true;
+      break;
+    }
+    MYSQL_RES *res = mysql_store_result(mysql);
+    if (res) mysql_free_result(res);
+    record_remote_latency(mysql, REMOTE_EXECUTE, chunk_start);
+    my_ulonglong raw_rows = mysql->affected_rows;
+    if (raw_rows == ~(my_ulonglong)0) raw_rows = 0;
+    total_rows += static_cast<int64_t>(raw_rows);
+    budget.charge(1, raw_rows);
+    chunks++;
+    ctx->chunks_done.store(chunks);
+    ctx->chunk_rows.store(total_rows);
+    collect_remote_warnings(mysql, node);
+    checkpoint.chunk_done(node->id, upper, chunks, total_rows);
+
+    if (last) break;
+    lower = upper;
+    op = ">";
+
+    if (pause_between_chunks(load, budget, ctx, node)) {
+      node->append_error("Killed by user after %ld chunks.", chunks);
+      failed = true;
+      break;
+    }
+  }
+
+  if (failed && chunks > 0)
+    node->append_error("%ld earlier chunks (%lld rows) were already committed.",
+                       chunks, static_cast<long long>(total_rows));
+
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+  node->execute_seconds = elapsed;
+  node->affected_rows = total_rows;
+  node->stage = STAGE_EXECUTED;
+  node->stage_status = failed ? (ctx->killed.load() ? "Killed by user"
+                                                    : "Execute failed")
+                              : "Execute completed";
+  if (!failed) status_add(STATUS_STATEMENTS_EXECUTED);
+  ctx->chunk_node_id.store(0);
+
+  fprintf(stderr, "[Inception] Chunked DML: %ld chunks, %lld rows.\n", chunks,
+          static_cast<long long>(total_rows));
+  fflush(stderr);
+  return failed;
+}
+
+/* ---- Partition rebuild (inception_exec_partition_rebuild) ---- */
+
+/**
+ * Run an ALTER that only rebuilds a partitioned table (exec_strategy
+ * PARTITION) as "ALTER TABLE db.t REBUILD PARTITION p" for each partition
+ * in turn, each under the metadata lock guard, with the load throttle,
+ * --sleep and "inception pause" between partitions. Each rebuilt
+ * partition is checkpointed, and with --resume the statement continues
+ * with the next one. A table no longer partitioned runs the ALTER as
+ * written.
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_partition_rebuild(MYSQL *mysql, LoadWatch &load,
+                                      TargetBudget &budget,
+                                      BatchCheckpoint &checkpoint,
+                                      InceptionContext *ctx,
+                                      SqlCacheNode *node) {
+  std::vector<std::string> partitions;
+  if (list_partitions(mysql, node->db_name, node->table_name, &partitions) ||
+      partitions.empty()) {
+    fprintf(stderr, "[Inception] Partition rebuild: %s.%s has no partitions, "
+            "executing as one statement.\n", node->db_name.c_str(),
+            node->table_name.c_str());
+    fflush(stderr);
+    return execute_mdl_guarded(mysql, ctx, node,
+                               [&] { return execute_one(mysql, node); });
+  }
+
+  const std::string prefix = "ALTER TABLE " + quote_ident(node->db_name) +
+                             "." + quote_ident(node->table_name) +
+                             " REBUILD PARTITION ";
+  const auto start = std::chrono::steady_clock::now();
+  ctx->chunk_node_id.store(node->id);
+  ctx->chunks_done.store(0);
+  ctx->chunk_rows.store(0);
+
+  size_t next = 0;
+  long done = 0;
+  std::string last;
+  int64_t unused_rows = 0;
+  if (checkpoint.resumed_chunk(node->id, &last, &done, &unused_rows)) {
+    const auto it = std::find(partitions.begin(), partitions.end(), last);
+    if (it != partitions.end()) {
+      next = static_cast<size_t>(it - partitions.begin()) + 1;
+      ctx->chunks_done.store(done);
+      fprintf(stderr, "[Inception] Partition rebuild: resuming after "
+              "partition %s (%ld done before).\n", last.c_str(), done);
+      fflush(stderr);
+    } else {
+      done = 0;
+    }
+  }
+
+  bool failed = false;
+  for (size_t p = next; p < partitions.size(); p++) {
+    const std::string step = prefix + quote_ident(partitions[p]);
+    fprintf(stderr, "[Inception] Partition rebuild %s.%s: %s (%zu/%zu)\n",
+            node->db_name.c_str(), node->table_name.c_str(),
+            partitions[p].c_str(), p + 1, partitions.size());
+    fflush(stderr);
+    failed = execute_mdl_guarded(mysql, ctx, node, [&] {
+      count_sent(node, step.size());
+      const auto step_start = std::chrono::steady_clock::now();
+      if (mysql_real_query(mysql, step.c_str(),
+                           static_cast<unsigned long>(step.size()))) {
+        node->append_error("Execute failed at partition %s (%zu of %zu): %s",
+                           partitions[p].c_str(), p + 1, partitions.size(),
+                           mysql_error(mysql));
+        return true;
+      }
+      MYSQL_RES *res = mysql_store_result(mysql);
+      if (res) mysql_free_result(res);
+      record_remote_latency(mysql, REMOTE_EXECUTE, step_start);
+      collect_remote_warnings(mysql, node);
+      return false;
+    });
+    if (failed) break;
+    done++;
+    budget.charge(1, 0);
+    ctx->chunks_done.store(done);
+    checkpoint.chunk_done(node->id, partitions[p], done, 0);
+
+    if (p + 1 < partitions.size() &&
+        pause_between_chunks(load, budget, ctx, node)) {
+      node->append_error("Killed by user after %ld of %zu partitions.", done,
+                         partitions.size());
+      failed = true;
+      break;
+    }
+  }
+
+  if (failed && done > 0)
+    node->append_error("%ld partitions were already rebuilt.", done);
+
+  node->execute_seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start)
+                              .count();
+  node->affected_rows = 0;
+  node->stage = STAGE_EXECUTED;
+  if (failed) {
+    node->stage_status =
+        ctx->killed.load() ? "Killed by user" : "Execute failed";
+  } else {
+    char status[64];
+    snprintf(status, sizeof(status), "Execute completed (%ld partitions)",
+             done);
+    node->stage_status = status;
+    status_add(STATUS_STATEMENTS_EXECUTED);
+  }
+  ctx->chunk_node_id.store(0);
+  return failed;
+}
+
+/* ---- Before-image backup (inception_backup_strategy=SELECT) ---- */
+
+/**
+ * Whether node is backed up from before images instead of the binlog: a
+ * single-table UPDATE/DELETE without ORDER BY or LIMIT, whose WHERE
+ * selects exactly the rows it changes, that runs as one statement.
+ */
+static bool wants_before_images(const InceptionContext *ctx,
+                                const SqlCacheNode &node) {
+  if (opt_backup_strategy != 1 || !ctx->backup || node.chunkable ||
+      node.exec_strategy == "OSC")
+    return false;
+  if (node.sql_command != SQLCOM_UPDATE && node.sql_command != SQLCOM_DELETE)
+    return false;
+  const std::string sql = bare_statement(node);
+  return find_top_level_keyword(sql, "LIMIT") == std::string::npos &&
+         find_top_level_keyword(sql, "ORDER") == std::string::npos;
+}
+
+/**
+ * Run a wants_before_images() statement in a transaction of its own,
+ * after BeforeImages locked and stored the rows it is about to change;
+ * the load throttle and --sleep apply between the chunks read. The images
+ * are dropped unless the statement commits. A statement that cannot be
+ * captured (no single integer primary key, or an UPDATE that may assign
+ * it) runs as usual and keeps the binlog backup.
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+static bool execute_with_images(MYSQL *mysql, LoadWatch &load,
+                                TargetBudget &budget, InceptionContext *ctx,
+                                SqlCacheNode *node) {
+  const std::string pk_name =
+      single_integer_pk(mysql, node->db_name, node->table_name);
+  std::string prefix, cond;
+  split_top_level_where(bare_statement(*node), &prefix, &cond);
+  if (pk_name.empty() || (node->sql_command == SQLCOM_UPDATE &&
+                          mentions_identifier(prefix, pk_name))) {
+    node->append_warning(
+        "Before images not captured: %s, the backup is read from the binlog.",
+        pk_name.empty() ? "the table has no single integer primary key"
+                        : "the UPDATE may assign its primary key");
+    return execute_one(mysql, node);
+  }
+
+  std::string err;
+  if (run_sql(mysql, remote_sql::TXN_BEGIN, &err)) {
+    node->append_error("Execute failed: cannot start transaction: %s",
+                       err.c_str());
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Execute failed";
+    return true;
+  }
+  BeforeImages images(ctx, node);
+  const auto start = std::chrono::steady_clock::now();
+  bool failed = images.capture(
+      mysql, pk_name, cond,
+      [&] { return pause_between_chunks(load, budget, ctx, node); }, &err);
+  const uint64_t captured_us = us_since(start);
+  node->backup_us += captured_us;
+  if (failed) {
+    node->append_error("Execute failed: backup: %s", err.c_str());
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Execute failed";
+  } else {
+    fprintf(stderr, "[Inception] Before images: %lld rows of %s.%s in "
+            "%.3fs.\n", static_cast<long long>(images.rows()),
+            node->db_name.c_str(), node->table_name.c_str(),
+            captured_us / 1e6);
+    fflush(stderr);
+    failed = execute_one(mysql, node);
+  }
+  if (!failed && run_sql(mysql, remote_sql::TXN_COMMIT, &err)) {
+    node->append_error("Commit failed: %s", err.c_str());
+    node->stage_status = "Execute failed";
+    node->affected_rows = 0;
+    failed = true;
+  }
+  if (failed) {
+    run_sql(mysql, remote_sql::TXN_ROLLBACK, &err);
+    images.drop();
+    return true;
+  }
+
+  const auto keep_start = std::chrono::steady_clock::now();
+  const bool kept = !images.keep(&err);
+  node->backup_us += us_since(keep_start);
+  if (!kept) {
+    node->append_warning("Backup failed: %s", err.c_str());
+  } else {
+    char status[96];
+    snprintf(status, sizeof(status), "%s (before images: %lld rows)",
+             node->stage_status.c_str(),
+             static_cast<long long>(images.rows()));
+    node->stage_status = status;
+  }
+  return false;
+}
+
+/* ---- Multi-statement batches (inception_exec_batch_statements) ---- */
+
+/** Single-table DML that may share a round trip with its neighbours. */
+static bool batchable(const SqlCacheNode &node) {
+  if (node.chunkable || node.exec_strategy == "OSC") return false;
+  switch (node.sql_command) {
+    case SQLCOM_INSERT:
+    case SQLCOM_REPLACE:
+    case SQLCOM_UPDATE:
+    case SQLCOM_DELETE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * Switch multi-statement support of the remote session with COM_SET_OPTION
+ * (mysql_set_server_option() is in libmysqlclient, not linked in server).
+ */
+static bool set_multi_statements(MYSQL *mysql, bool on) {
+  uchar buff[2];
+  int2store(buff, static_cast<uint>(on ? MYSQL_OPTION_MULTI_STATEMENTS_ON
+                                       : MYSQL_OPTION_MULTI_STATEMENTS_OFF));
+  return simple_command(mysql, COM_SET_OPTION, buff, sizeof(buff), 0);
+}
+
+/**
+ * Run batch in one multi-statement round trip. Every statement is followed
+ * by SHOW WARNINGS and, with capture, SHOW MASTER STATUS, so affected rows,
+ * warnings and the backup binlog window are still recorded per node.
+ *
+ * The server stops at the first failing statement. Returns how many
+ * leading nodes of batch ran; *failed is set if the last of them failed.
+ * The remaining nodes are untouched.
+ */
+static size_t execute_batch(MYSQL *mysql,
+                            const std::vector<SqlCacheNode *> &batch,
+                            bool capture, bool *failed) {
+  *failed = false;
+  std::string sql;
+  if (capture) {
+    sql += remote_sql::SHOW_MASTER_STATUS;
+    sql += ";\n";
+  }
+  for (const auto *node : batch) {
+    /* Newline before ';' in case the statement ends in a -- comment */
+    size_t length;
+    const size_t begin = bare_statement_bounds(*node, &length);
+    sql.append(node->sql_text, begin, length);
+    sql += "\n;\n";
+    sql += remote_sql::SHOW_WARNINGS;
+    sql += ";\n";
+    if (capture) {
+      sql += remote_sql::SHOW_MASTER_STATUS;
+      sql += ";\n";
+    }
+  }
+
+  auto last = std::chrono::steady_clock::now();
+  count_sent(batch.front(), sql.size());
+  bool err = mysql_real_query(mysql, sql.c_str(),
+                              static_cast<unsigned long>(sql.size())) != 0;
+  BinlogPos pos;
+  bool have_pos = false;
+  std::string binlog_err;
+  if (capture) {
+    if (err) return 0;
+    MYSQL_RES *res = mysql_store_result(mysql);
+    have_pos = res && !read_binlog_position(res, &pos, &binlog_err);
+    err = next_result(mysql);
+  }
+
+  size_t done = 0;
+  while (done < batch.size()) {
+    SqlCacheNode *node = batch[done];
+    if (err) {
+      if (mysql_errno(mysql) == 0) return done;  /* no result: not run */
+      node->append_error("Execute failed: %s", mysql_error(mysql));
+      node->stage = STAGE_EXECUTED;
+      node->stage_status = "Execute failed";
+      *failed = true;
+      return done + 1;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    const double elapsed = std::chrono::duration<double>(now - last).count();
+    record_remote_latency(mysql, REMOTE_EXECUTE, last);
+    last = now;
+    my_ulonglong raw_rows = mysql->affected_rows;
+    node->affected_rows =
+        raw_rows == ~(my_ulonglong)0 ? 0 : static_cast<int64_t>(raw_rows);
+    node->execute_seconds = elapsed;
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = "Execute completed";
+    status_add(STATUS_STATEMENTS_EXECUTED);
+    done++;
+
+    if (next_result(mysql)) return done;
+    if (MYSQL_RES *res = mysql_store_result(mysql))
+      record_warnings(res, node);
+
+    if (capture) {
+      if (next_result(mysql)) return done;
+      BinlogPos end;
+      MYSQL_RES *res = mysql_store_result(mysql);
+      bool have_end = res && !read_binlog_position(res, &end, &binlog_err);
+      if (have_pos && have_end) {
+        node->start_binlog_file = pos.file;
+        node->start_binlog_pos = pos.pos;
+        node->end_binlog_file = end.file;
+        node->end_binlog_pos = end.pos;
+        node->exec_thread_id = mysql->thread_id;
+      }
+      pos = end;
+      have_pos = have_end;
+    }
+    if (done < batch.size()) err = next_result(mysql);
+  }
+  return done;
+}
+
+/* ---- Multi-row INSERT merging (inception_exec_merge_inserts) ---- */
+
+/**
+ * Split a single-row INSERT into the text up to and including VALUES and
+ * the row tuple "(...)". Returns false if it has no VALUES keyword or
+ * anything follows the tuple.
+ */
+static bool split_values_row(const std::string &sql, std::string *prefix,
+                             std::string *row) {
+  size_t kw = find_top_level_keyword(sql, "VALUES");
+  size_t kw_len = 6;
+  if (kw == std::string::npos) {
+    kw = find_top_level_keyword(sql, "VALUE");
+    kw_len = 5;
+  }
+  if (kw == std::string::npos) return false;
+
+  size_t n = sql.size();
+  size_t open = kw + kw_len;
+  while (open < n && isspace(static_cast<unsigned char>(sql[open]))) open++;
+  if (open == n || sql[open] != '(') return false;
+  int depth = 0;
+  size_t close = open;
+  for (; close < n; close++) {
+    if (skip_quoted(sql, close)) continue;
+    if (sql[close] == '(') depth++;
+    if (sql[close] == ')' && --depth == 0) break;
+  }
+  if (close >= n) return false;
+  for (size_t i = close + 1; i < n; i++)
+    if (!isspace(static_cast<unsigned char>(sql[i]))) return false;
+  *prefix = sql.substr(0, kw + kw_len);
+  *row = sql.substr(open, close - open + 1);
+  return true;
+}
+
+/**
+ * The longest run of nodes from first that can share one INSERT: the
+ * same fingerprint, target table and column text, at most max_nodes and
+ * limit bytes. Fills *sql with the merged statement.
+ */
+static std::vector<SqlCacheNode *> collect_merged_insert(
+    InceptionContext *ctx, size_t first, size_t max_nodes, size_t limit,
+    std::string *sql) {
+  std::vector<SqlCacheNode *> group;
+  std::string prefix;
+  const SqlCacheNode &head = ctx->cache_nodes[first];
+  for (size_t j = first;
+       j < ctx->cache_nodes.size() && group.size() < max_nodes; j++) {
+    SqlCacheNode &next = ctx->cache_nodes[j];
+    if (!next.single_row_insert || next.sqlsha1.empty() ||
+        next.sqlsha1 != head.sqlsha1 || next.db_name != head.db_name ||
+        next.table_name != head.table_name || ctx->load_node(&next))
+      break;
+    std::string p, row;
+    if (!split_values_row(bare_statement(next), &p, &row)) break;
+    if (group.empty()) {
+      prefix = p;
+      *sql = prefix + " " + row;
+    } else {
+      if (p != prefix || sql->size() + row.size() + 2 > limit) break;
+      *sql += ", ";
+      *sql += row;
+    }
+    group.push_back(&next);
+  }
+  return group;
+}
+
+/**
+ * Run a merged INSERT. Every node gets affected_rows 1 (a plain INSERT
+ * inserts each row or fails as a whole), the total execute_time and a
+ * stage_status naming the merged ids; warnings go to the first node, an
+ * error to every node.
+ *
+ * @return false on success, true on error.
+ */
+static bool execute_merged_insert(MYSQL *mysql, const std::string &sql,
+                                  const std::vector<SqlCacheNode *> &group) {
+  auto start = std::chrono::steady_clock::now();
+  const int first_id = group.front()->id;
+  const int last_id = group.back()->id;
+  count_sent(group.front(), sql.size());
+  if (mysql_real_query(mysql, sql.c_str(),
+                       static_cast<unsigned long>(sql.size()))) {
+    for (auto *node : group) {
+      node->append_error("Execute failed (merged INSERT of ids %d-%d): %s",
+                         first_id, last_id, mysql_error(mysql));
+      node->stage = STAGE_EXECUTED;
+      node->stage_status = "Execute failed";
+    }
+    return true;
+  }
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (res) mysql_free_result(res);
+  record_remote_latency(mysql, REMOTE_EXECUTE, start);
+
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+  char status[96];
+  snprintf(status, sizeof(status),
+           "Execute completed (merged INSERT, ids %d-%d)", first_id, last_id);
+  for (auto *node : group) {
+    node->affected_rows = 1;
+    node->execute_seconds = elapsed;
+    node->stage = STAGE_EXECUTED;
+    node->stage_status = status;
+  }
+  status_add(STATUS_STATEMENTS_EXECUTED, group.size());
+  collect_remote_warnings(mysql, group.front());
+  return false;
+}
+
+static bool execute_batch(THD *thd, InceptionContext *ctx) {
+
+  /* Check if already killed before we start */
+  if (ctx->killed.load()) {
+    for (auto &node : ctx->cache_nodes) {
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Killed by user";
+    }
+    return true;
+  }
+
+  /* --enable-parallel: statements on unrelated tables in lanes of their own */
+  if (ctx->parallel) return execute_parallel(thd, ctx);
+
+  /* TiDB 6.2+ runs DDL jobs on different tables at the same time */
+  if (opt_exec_tidb_ddl_concurrency > 0 && ctx->db_type == DbType::TIDB &&
+      ctx->db_version_major * 100 + ctx->db_version_minor >= 602 &&
+      !ctx->tidb_ddl_jobs && !ctx->progress_lane) {
+    ctx->tidb_ddl_jobs = true;
+    bool failed = execute_parallel(thd, ctx);
+    ctx->tidb_ddl_jobs = false;
+    return failed;
+  }
+
+  /* Connect to remote target */
+  std::string conn_err;
+  MYSQL *mysql = connect_remote(ctx, conn_err);
+  if (!mysql) {
+    /* Record connection error on all nodes */
+    for (auto &node : ctx->cache_nodes) {
+      node.append_error("%s", conn_err.c_str());
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Execute failed";
+    }
+    return true;
+  }
+
+  /* Store remote thread id for force kill support
+     (use struct member directly; mysql_thread_id() is in libmysqlclient) */
+  ctx->remote_exec_thread_id.store(mysql->thread_id);
+
+  /* Persisted position of the batch; with --resume, the earlier run's */
+  BatchCheckpoint checkpoint;
+  std::string checkpoint_err;
+  if (checkpoint.open(ctx, &checkpoint_err)) {
+    for (auto &node : ctx->cache_nodes) {
+      node.append_error("%s", checkpoint_err.c_str());
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Execute failed";
+    }
+    ctx->remote_exec_thread_id.store(0);
+    pool_release(mysql, PoolRelease::CLEAN);
+    return true;
+  }
+  /* Completed by the earlier run; session setup (USE, SET) runs again */
+  auto completed_before = [&](const SqlCacheNode &node) {
+    return node.id <= checkpoint.resumed_through() &&
+           node.sql_command != SQLCOM_CHANGE_DB &&
+           node.sql_command != SQLCOM_SET_OPTION;
+  };
+
+  bool has_error = false;
+  bool stop_exec = false;
+
+  int total = static_cast<int>(ctx->cache_nodes.size());
+  int idx = 0;
+
+  /* Pre-scan: if any statement has audit ERROR or WARNING,
+     block the entire batch from executing.
+     --enable-force: skip ERROR check (force execute despite audit errors)
+     --enable-ignore-warnings: skip WARNING check
+     Findings on statements completed before a --resume checkpoint describe
+     what that run created ("table already exists") and are ignored. */
+  for (const auto &node : ctx->cache_nodes) {
+    if (completed_before(node)) continue;
+    if (node.errlevel >= ERRLEVEL_ERROR && !ctx->force) {
+      stop_exec = true;
+      break;
+    }
+    if (node.errlevel >= ERRLEVEL_WARNING && !ctx->ignore_warnings) {
+      stop_exec = true;
+      break;
+    }
+  }
+
+  if (stop_exec) {
+    fprintf(stderr, "[Inception] Audit findings detected, "
+            "skipping entire batch (%d statements).\n", total);
+    fflush(stderr);
+    /* Audit found errors — keep stage as CHECKED, do not execute */
+    pool_release(mysql, PoolRelease::CLEAN);
+    return true;
+  }
+
+  /* Per-target concurrency limit across sessions and background jobs */
+  ExecSlot session_slot;
+  if (!session_slot.acquire(ctx, SlotKind::SESSION)) {
+    for (auto &node : ctx->cache_nodes) {
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Killed by user";
+    }
+    ctx->remote_exec_thread_id.store(0);
+    pool_release(mysql, PoolRelease::CLEAN);
+    return true;
+  }
+
+  /* Reset stop_exec for runtime error tracking (--enable-force) */
+  stop_exec = false;
+
+  /* Heartbeats first, so the first lag sample can read one */
+  HeartbeatWriter heartbeat(ctx);
+  /* Target load for the throttle, sampled once per target for all batches */
+  LoadWatch load(ctx);
+  /* Rows/statements per second of the target, shared by all batches */
+  TargetBudget budget(ctx);
+
+  /* Watches the target load while each statement runs */
+  StatementMonitor monitor(ctx);
+
+  /* Generate sequence: 'exec_time_thread_id_seqno' (same as old inception) */
+  auto assign_sequence = [&](SqlCacheNode &node) {
+    char seq_buf[128];
+    snprintf(seq_buf, sizeof(seq_buf), "'%ld_%u_%d'",
+             static_cast<long>(time(nullptr)),
+             thd ? thd->thread_id() : ctx->client_thread_id, node.id);
+    node.sequence = seq_buf;
+  };
+
+  /* Logging, audit log and sequence of a node that has run */
+  auto finish_node = [&](SqlCacheNode &node, int n, bool exec_failed) {
+    checkpoint.finished(node.id, exec_failed);
+    if (exec_failed) {
+      has_error = true;
+      fprintf(stderr, "[Inception] [%d/%d] FAILED: %s\n",
+              n, total, node.errmsg.c_str());
+      fflush(stderr);
+      if (!ctx->force) {
+        stop_exec = true;
+      }
+    } else {
+      fprintf(stderr, "[Inception] [%d/%d] OK (%.3fs, affected: %ld)\n",
+              n, total,
+              std::max(node.execute_seconds, 0.0),
+              static_cast<long>(node.affected_rows));
+      fflush(stderr);
+    }
+
+    /* Write statement-level audit log */
+    audit_log_statement(thd, ctx, &node);
+
+    /* Before images were stored under the sequence given before it ran */
+    if (node.stage == STAGE_EXECUTED && node.sequence.empty())
+      assign_sequence(node);
+  };
+
+  /* Remote thread id on which multi-statements were switched on */
+  unsigned long multi_thread_id = 0;
+
+  /* Fingerprints repeated often enough to run as prepared statements */
+  std::map<std::string, size_t> shape_repeats;
+  if (opt_exec_prepare_min_repeats > 0) {
+    for (const auto &n : ctx->cache_nodes)
+      if (batchable(n) && !n.sqlsha1.empty()) shape_repeats[n.sqlsha1]++;
+  }
+  PreparedStatements prepared(mysql);
+
+  /* Target's max_allowed_packet, read before the first merged INSERT */
+  uint64_t max_packet = 0;
+
+  /* --txn-batch-size: the open transaction and its executed nodes, which
+     are finished (logged) only once it commits or rolls back. */
+  struct TxnEntry {
+    SqlCacheNode *node;
+    int idx;
+    bool failed;
+  };
+  std::vector<TxnEntry> txn;
+  bool in_txn = false;
+  bool txn_capture = false;
+  BinlogPos txn_start;
+
+  auto open_txn = [&](bool capture, std::string *err) {
+    std::string binlog_err;
+    txn_capture =
+        capture && !get_binlog_position(mysql, &txn_start, &binlog_err);
+    if (run_sql(mysql, remote_sql::TXN_BEGIN, err)) return true;
+    in_txn = true;
+    return false;
+  };
+
+  /* Commit, or roll back with reason, and finish the transaction's nodes */
+  auto close_txn = [&](const char *rollback_reason) {
+    std::string err;
+    if (!rollback_reason) {
+      if (run_sql(mysql, remote_sql::TXN_COMMIT, &err)) {
+        for (auto &e : txn) {
+          e.node->append_error("Commit failed: %s", err.c_str());
+          e.node->stage_status = "Execute failed";
+          e.node->affected_rows = 0;
+          e.failed = true;
+        }
+      } else if (txn_capture) {
+        BinlogPos end;
+        std::string binlog_err;
+        if (!get_binlog_position(mysql, &end, &binlog_err)) {
+          for (auto &e : txn) {
+            e.node->start_binlog_file = txn_start.file;
+            e.node->start_binlog_pos = txn_start.pos;
+            e.node->end_binlog_file = end.file;
+            e.node->end_binlog_pos = end.pos;
+            e.node->exec_thread_id = mysql->thread_id;
+          }
+        }
+      }
+    } else {
+      run_sql(mysql, remote_sql::TXN_ROLLBACK, &err);
+      for (auto &e : txn) {
+        if (e.failed) continue;
+        e.node->append_error("Rolled back: %s", rollback_reason);
+        e.node->stage_status = "Execute rolled back";
+        e.node->affected_rows = 0;
+        e.failed = true;
+      }
+    }
+    for (auto &e : txn) finish_node(*e.node, e.idx, e.failed);
+    txn.clear();
+    in_txn = false;
+  };
+
+  const size_t count = ctx->cache_nodes.size();
+  for (size_t i = 0; i < count; i++) {
+    ctx->publish_executed(i);
+    SqlCacheNode &node = ctx->cache_nodes[i];
+    idx++;
+
+    /* inception_max_session_memory: the texts of the nodes done with (but
+       those of the open transaction) may go back to the spill file; this
+       node's come back */
+    ctx->spill_nodes(txn.empty() ? i
+                                 : static_cast<size_t>(txn.front().node -
+                                                       ctx->cache_nodes.data()));
+    if (ctx->load_node(&node)) {
+      if (in_txn) close_txn(nullptr);
+      node.spilled = false;
+      node.append_error("Cannot read the statement back from the spill file.");
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Execute failed";
+      finish_node(node, idx, true);
+      continue;
+    }
+
+    const bool groupable = ctx->txn_batch_size > 0 && batchable(node) &&
+                           !bare_statement_empty(node) &&
+                           !wants_before_images(ctx, node);
+    if (in_txn && ctx->killed.load())
+      close_txn("the session was killed before the transaction committed.");
+    else if (in_txn && !groupable)
+      close_txn(nullptr);
+
+    /* Check if session was killed by another thread */
+    if (ctx->killed.load()) {
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Killed by user";
+      fprintf(stderr, "[Inception] [%d/%d] KILLED: %.200s\n",
+              idx, total, node.sql_text.c_str());
+      fflush(stderr);
+      continue;
+    }
 
     /* Runtime error from a previous statement — skip subsequent unless force */
     if (stop_exec) {
@@ -475,8 +1841,21 @@ bool execute_statements(THD *thd, InceptionContext *ctx) {
       continue;
     }
 
-    /* Unified pre-execute checks: read_only gate + throttle checks. */
-    if (pre_execute_checks(mysql, slave_conns, ctx, &node)) {
+    /* --resume: ran before the checkpoint */
+    if (completed_before(node)) {
+      node.errlevel = ERRLEVEL_OK;
+      node.errmsg.clear();
+      node.stage = STAGE_SKIPPED;
+      node.stage_status = "Skipped (completed before checkpoint)";
+      fprintf(stderr, "[Inception] [%d/%d] RESUMED PAST: %.200s\n",
+              idx, total, node.sql_text.c_str());
+      fflush(stderr);
+      continue;
+    }
+
+    /* Unified pre-execute checks: read_only gate + throttle checks.
+       Not inside a transaction, which would hold its locks while waiting. */
+    if (!in_txn && pre_execute_checks(mysql, load, budget, ctx, &node)) {
       has_error = true;
       stop_exec = true;
       fprintf(stderr, "[Inception] [%d/%d] PRECHECK FAILED: %s\n",
@@ -485,56 +1864,409 @@ bool execute_statements(THD *thd, InceptionContext *ctx) {
       continue;
     }
 
-    /* Log before execution */
-    fprintf(stderr, "[Inception] [%d/%d] Executing: %.200s\n",
-            idx, total, node.sql_text.c_str());
-    fflush(stderr);
+    /* Backup: binlog window of the statement for generate_rollback() */
+    bool capture = ctx->backup && ctx->db_type != DbType::TIDB &&
+                   is_backup_dml(node.sql_command);
 
-    if (execute_one(mysql, &node)) {
-      has_error = true;
-      fprintf(stderr, "[Inception] [%d/%d] FAILED: %s\n",
-              idx, total, node.errmsg.c_str());
+    if (groupable && !in_txn) {
+      std::string err;
+      if (open_txn(capture, &err)) {
+        node.append_error("Execute failed: cannot start transaction: %s",
+                          err.c_str());
+        node.stage = STAGE_EXECUTED;
+        node.stage_status = "Execute failed";
+        finish_node(node, idx, true);
+        continue;
+      }
+    }
+    /* Inside a transaction the window is the whole transaction's */
+    if (in_txn) capture = false;
+
+    const size_t txn_room =
+        in_txn ? ctx->txn_batch_size - txn.size() : static_cast<size_t>(-1);
+
+    /* Consecutive single-row INSERTs of one shape run as one statement */
+    std::vector<SqlCacheNode *> batch;
+    std::string merged_sql;
+    if (opt_exec_merge_inserts && node.single_row_insert && txn_room > 1) {
+      if (max_packet == 0) {
+        std::vector<std::string> row;
+        bool found = false;
+        max_packet = 4 * 1024 * 1024;  /* server default */
+        if (!query_one_row(mysql, remote_sql::SHOW_MAX_ALLOWED_PACKET, &row,
+                           &found) &&
+            found && !row[0].empty())
+          max_packet = strtoull(row[0].c_str(), nullptr, 10);
+      }
+      /* Leave room for the packet header and the session's own use */
+      size_t limit = max_packet > 2048 ? max_packet - 1024 : 1024;
+      batch = collect_merged_insert(ctx, i, txn_room, limit, &merged_sql);
+      if (batch.size() < 2) batch.clear();
+    }
+
+    /* Consecutive plain DML share one round trip; the pre-checks above
+       run once per batch. */
+    size_t batch_max = std::min<size_t>(opt_exec_batch_statements, txn_room);
+    if (batch.empty() && batch_max > 1 && ctx->sleep_ms == 0) {
+      size_t bytes = 0;
+      for (size_t j = i; j < count && batch.size() < batch_max; j++) {
+        SqlCacheNode &next = ctx->cache_nodes[j];
+        if (!batchable(next) || ctx->load_node(&next) ||
+            bare_statement_empty(next) || wants_before_images(ctx, next))
+          break;
+        bytes += next.sql_text.size();
+        if (!batch.empty() && bytes > opt_exec_batch_bytes) break;
+        batch.push_back(&next);
+      }
+    }
+    if (batch.size() > 1 && merged_sql.empty() &&
+        multi_thread_id != mysql->thread_id) {
+      /* Again after an auto-reconnect, which resets the option */
+      if (set_multi_statements(mysql, true))
+        batch.clear();
+      else
+        multi_thread_id = mysql->thread_id;
+    }
+
+    /* Per-target DDL limit; held until the statement has run (DDL is
+       never batched, so it always takes the single-statement path) */
+    ExecSlot ddl_slot;
+    if (is_scheduled_ddl(node.sql_command) &&
+        !ddl_slot.acquire(ctx, SlotKind::DDL)) {
+      node.stage = STAGE_EXECUTED;
+      node.stage_status = "Killed by user";
+      fprintf(stderr, "[Inception] [%d/%d] KILLED: %.200s\n",
+              idx, total, node.sql_text.c_str());
       fflush(stderr);
-      if (!ctx->force) {
-        stop_exec = true;
+      continue;
+    }
+
+    size_t ran = 0;
+    bool last_failed = false;
+    bool all_failed = false;
+    /* What chunked DML charges chunk by chunk is not charged again below */
+    const uint64_t charged_statements = budget.charged_statements();
+    const uint64_t charged_rows = budget.charged_rows();
+    /* Chunked DML, OSC and partition rebuilds throttle between their own
+       chunks */
+    if (!node.chunkable && node.exec_strategy != "OSC" &&
+        node.exec_strategy != "PARTITION")
+      monitor.begin(mysql->thread_id, node);
+    if (!merged_sql.empty()) {
+      fprintf(stderr, "[Inception] [%d-%d/%d] Executing merged INSERT: "
+              "%.200s\n", idx, idx + static_cast<int>(batch.size()) - 1,
+              total, merged_sql.c_str());
+      fflush(stderr);
+      BinlogPos binlog_start, binlog_end;
+      std::string binlog_err;
+      if (capture && get_binlog_position(mysql, &binlog_start, &binlog_err))
+        capture = false;  /* generate_rollback() reports the missing window */
+      all_failed = execute_merged_insert(mysql, merged_sql, batch);
+      /* The statement's rows are spread over its nodes in row order */
+      if (capture && !get_binlog_position(mysql, &binlog_end, &binlog_err)) {
+        for (auto *n : batch) {
+          n->start_binlog_file = binlog_start.file;
+          n->start_binlog_pos = binlog_start.pos;
+          n->end_binlog_file = binlog_end.file;
+          n->end_binlog_pos = binlog_end.pos;
+          n->exec_thread_id = mysql->thread_id;
+        }
       }
-    } else {
-      fprintf(stderr, "[Inception] [%d/%d] OK (%.3fs, affected: %ld)\n",
-              idx, total,
-              node.execute_time.empty() ? 0.0 : atof(node.execute_time.c_str()),
-              static_cast<long>(node.affected_rows));
+      last_failed = all_failed;
+      ran = batch.size();
+    } else if (batch.size() > 1) {
+      fprintf(stderr, "[Inception] [%d-%d/%d] Executing batch: %.200s\n",
+              idx, idx + static_cast<int>(batch.size()) - 1, total,
+              node.sql_text.c_str());
       fflush(stderr);
+      ran = execute_batch(mysql, batch, capture, &last_failed);
+      /* Nothing ran: fall back to one statement at a time */
     }
 
-    /* Write statement-level audit log */
-    audit_log_statement(thd, ctx, &node);
+    /* --enable-merge-alter: the ALTERs folded into this one run with it */
+    std::vector<SqlCacheNode *> folded;
+    if (ran == 0 && node.sql_command == SQLCOM_ALTER_TABLE) {
+      std::string combined = bare_statement(node);
+      for (size_t j = i + 1; j < count && ctx->cache_nodes[j].merged_alter;
+           j++) {
+        std::string spec;
+        if (ctx->load_node(&ctx->cache_nodes[j]) ||
+            !alter_specification(ctx->cache_nodes[j].sql_text, &spec))
+          break;
+        combined += ", " + spec;
+        folded.push_back(&ctx->cache_nodes[j]);
+      }
+      if (!folded.empty()) {
+        node.sql_text = combined;
+        fprintf(stderr, "[Inception] [%d-%d/%d] Merged ALTER of ids %d-%d\n",
+                idx, idx + static_cast<int>(folded.size()), total, node.id,
+                folded.back()->id);
+        fflush(stderr);
+      }
+    }
+
+    if (ran == 0) {
+      /* Log before execution */
+      fprintf(stderr, "[Inception] [%d/%d] Executing: %.200s\n",
+              idx, total, node.sql_text.c_str());
+      fflush(stderr);
 
-    /* Generate sequence: 'exec_time_thread_id_seqno' (same as old inception) */
-    if (node.stage == STAGE_EXECUTED) {
-      char seq_buf[128];
-      snprintf(seq_buf, sizeof(seq_buf), "'%ld_%u_%d'",
-               static_cast<long>(time(nullptr)), thd->thread_id(),
-               node.id);
-      node.sequence = seq_buf;
+      BinlogPos binlog_start;
+      std::string binlog_err;
+      if (capture && get_binlog_position(mysql, &binlog_start, &binlog_err))
+        capture = false;  /* generate_rollback() reports the missing window */
+
+      bool timed = false;  /* ran in one statement: server timing applies */
+      if (node.exec_strategy == "OSC") {
+        last_failed = osc_execute(mysql, ctx, &node, [&] {
+          return pause_between_chunks(load, budget, ctx, &node);
+        });
+      } else if (node.exec_strategy == "PARTITION") {
+        last_failed = execute_partition_rebuild(mysql, load, budget,
+                                                checkpoint, ctx, &node);
+      } else if (online_alter_applies(ctx, node)) {
+        last_failed = execute_online_alter(mysql, ctx, &node, [&] {
+          return pause_between_chunks(load, budget, ctx, &node);
+        });
+        timed = true;
+      } else if (node.chunkable) {
+        last_failed =
+            execute_chunked(mysql, load, budget, checkpoint, ctx, &node);
+      } else if (wants_before_images(ctx, node)) {
+        assign_sequence(node);
+        last_failed = execute_with_images(mysql, load, budget, ctx, &node);
+      } else if (batchable(node) && !node.sqlsha1.empty() &&
+                 opt_exec_prepare_min_repeats > 0 &&
+                 shape_repeats[node.sqlsha1] >= opt_exec_prepare_min_repeats) {
+        last_failed = execute_prepared(mysql, &prepared, &node);
+        timed = true;
+      } else {
+        last_failed = execute_mdl_guarded(mysql, ctx, &node, [&] {
+          return execute_one(mysql, &node);
+        });
+        timed = true;
+      }
+      /* Only where the statement was the last one sent on mysql */
+      if (timed && ctx->server_timing && !last_failed)
+        capture_server_timing(mysql, &node);
+      invalidate_cached_metadata(ctx, node);
+      calibrate_rebuild_speed(ctx, node, last_failed);
+      calibrate_apply_speed(ctx, node, last_failed);
+      BinlogPos binlog_end;
+      if (capture && !get_binlog_position(mysql, &binlog_end, &binlog_err)) {
+        node.start_binlog_file = binlog_start.file;
+        node.start_binlog_pos = binlog_start.pos;
+        node.end_binlog_file = binlog_end.file;
+        node.end_binlog_pos = binlog_end.pos;
+        node.exec_thread_id = mysql->thread_id;
+      }
+      batch.assign(1, &node);
+      ran = 1;
+
+      if (!folded.empty()) {
+        char status[96];
+        snprintf(status, sizeof(status), "%s (merged ALTER, ids %d-%d)",
+                 node.stage_status.c_str(), node.id, folded.back()->id);
+        node.stage_status = status;
+        for (auto *f : folded) {
+          if (last_failed)
+            f->append_error("Execute failed (merged ALTER of ids %d-%d), "
+                            "see id %d.", node.id, folded.back()->id, node.id);
+          f->stage = node.stage;
+          f->stage_status = status;
+          f->execute_seconds = node.execute_seconds;
+          f->affected_rows = node.affected_rows;
+          batch.push_back(f);
+        }
+        ran = batch.size();
+        all_failed = last_failed;
+      }
+    }
+    ddl_slot.release();
+
+    /* Charge the target's budget; folded ALTERs ran as part of node */
+    {
+      uint64_t statements = ran - folded.size();
+      uint64_t rows = 0;
+      for (size_t k = 0; k < ran - folded.size(); k++)
+        if (batch[k]->affected_rows > 0)
+          rows += static_cast<uint64_t>(batch[k]->affected_rows);
+      statements -= std::min(statements,
+                             budget.charged_statements() - charged_statements);
+      rows -= std::min(rows, budget.charged_rows() - charged_rows);
+      budget.charge(statements, rows);
     }
 
-    /* Optional sleep between statements (read once to avoid TOCTOU
-       since another thread may update sleep_ms via set_sleep_by_thread_id) */
-    uint64_t sleep_val = ctx->sleep_ms;
-    if (sleep_val > 0 && !stop_exec) {
-      struct timespec ts;
-      ts.tv_sec = static_cast<time_t>(sleep_val / 1000);
-      ts.tv_nsec = static_cast<long>((sleep_val % 1000) * 1000000);
-      nanosleep(&ts, nullptr);
+    std::string breach;
+    if (monitor.end(&breach))
+      node.append_error("Killed by the load monitor: %s during execution.",
+                        breach.c_str());
+    else if (!breach.empty())
+      node.append_warning("Load ceiling crossed during execution: %s.",
+                          breach.c_str());
+
+    for (size_t k = 0; k < ran; k++) {
+      const bool failed = all_failed || (last_failed && k + 1 == ran);
+      if (in_txn)
+        txn.push_back({batch[k], idx + static_cast<int>(k), failed});
+      else
+        finish_node(*batch[k], idx + static_cast<int>(k), failed);
     }
+    i += ran - 1;
+    idx += static_cast<int>(ran) - 1;
+
+    if (in_txn && last_failed)
+      close_txn("a statement in the same transaction failed.");
+    else if (in_txn && txn.size() >= ctx->txn_batch_size)
+      close_txn(nullptr);
+    if (in_txn) continue;
+
+    /* Optional sleep between statements and "inception pause"; kill,
+       resume and "inception set sleep" wake it at once. A kill is
+       handled at the top of the next iteration. */
+    if (!stop_exec) ctx->wait_between_statements();
   }
+  if (in_txn)
+    close_txn(ctx->killed.load()
+                  ? "the session was killed before the transaction committed."
+                  : nullptr);
 
-  /* Close slave connections */
-  for (auto *s : slave_conns) mysql_close(s);
+  prepared.close_all();
+  if (multi_thread_id != 0 && multi_thread_id == mysql->thread_id)
+    set_multi_statements(mysql, false);
 
   ctx->remote_exec_thread_id.store(0);
-  mysql_close(mysql);
+  /* User SQL ran on it: reset the session before it is reused */
+  pool_release(mysql, PoolRelease::DIRTY);
   return has_error;
 }
 
+/* ---- --dry-run-target ---- */
+
+/** Server-wide counters of the sandbox that a dry run reports the growth of. */
+struct SandboxCounters {
+  uint64_t redo_bytes = 0;    /* Innodb_os_log_written */
+  uint64_t rows_read = 0;     /* Innodb_rows_read */
+  uint64_t lock_waits = 0;    /* Innodb_row_lock_waits */
+  uint64_t lock_wait_ms = 0;  /* Innodb_row_lock_time */
+};
+
+/** Read the sandbox's counters into *c. Returns true on error. */
+static bool read_sandbox_counters(MYSQL *mysql, SandboxCounters *c) {
+  if (mysql_real_query(mysql, remote_sql::SHOW_DRY_RUN_STATUS,
+                       strlen(remote_sql::SHOW_DRY_RUN_STATUS)))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    if (!row[0] || !row[1]) continue;
+    const uint64_t value = strtoull(row[1], nullptr, 10);
+    if (strcasecmp(row[0], "Innodb_os_log_written") == 0)
+      c->redo_bytes = value;
+    else if (strcasecmp(row[0], "Innodb_rows_read") == 0)
+      c->rows_read = value;
+    else if (strcasecmp(row[0], "Innodb_row_lock_waits") == 0)
+      c->lock_waits = value;
+    else if (strcasecmp(row[0], "Innodb_row_lock_time") == 0)
+      c->lock_wait_ms = value;
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+/* Mark every node from i on with status, e.g. why the dry run skipped it */
+static void dry_run_mark(InceptionContext *ctx, size_t i, const char *status) {
+  for (; i < ctx->cache_nodes.size(); i++)
+    ctx->cache_nodes[i].stage_status = status;
+}
+
+void dry_run_statements(THD *thd, InceptionContext *ctx) {
+  if (ctx->cache_nodes.empty()) return;
+  const std::string &host = ctx->dry_run_sandbox.first;
+  const uint port = ctx->dry_run_sandbox.second;
+
+  /* What EXECUTE would refuse to run is not dry run either */
+  for (const auto &node : ctx->cache_nodes) {
+    if (node.errlevel >= ERRLEVEL_ERROR && !ctx->force) {
+      dry_run_mark(ctx, 0, "Audit completed; dry run skipped: audit errors");
+      return;
+    }
+  }
+
+  InceptionContext sandbox;
+  copy_exec_settings(*ctx, &sandbox);
+  sandbox.host = host;
+  sandbox.port = port;
+  std::string err;
+  MYSQL *mysql = connect_remote(&sandbox, err);
+  if (!mysql) {
+    ctx->cache_nodes[0].append_warning("Dry run: %s", err.c_str());
+    dry_run_mark(ctx, 0, "Audit completed; dry run failed");
+    return;
+  }
+  StageScope stage(stage_inception_execute);
+  /* "inception kill ... force" reaches the statement on the sandbox */
+  ctx->remote_exec_thread_id.store(mysql->thread_id);
+
+  SandboxCounters before;
+  bool have_counters = !read_sandbox_counters(mysql, &before);
+  for (size_t i = 0; i < ctx->cache_nodes.size(); i++) {
+    SqlCacheNode &node = ctx->cache_nodes[i];
+    if (ctx->killed.load() || (thd && thd->killed)) {
+      dry_run_mark(ctx, i, "Audit completed; dry run killed");
+      break;
+    }
+
+    /* The run leaves its stage, messages and warnings on a scratch node */
+    SqlCacheNode run;
+    run.sql_text.swap(node.sql_text);
+    const bool failed = execute_one(mysql, &run);
+    node.sql_text.swap(run.sql_text);
+    node.round_trips += run.round_trips;
+    if (failed) {
+      node.append_warning("Dry run on %s:%u: %s", host.c_str(), port,
+                          run.errmsg.c_str());
+      node.stage_status = "Audit completed; dry run failed";
+      /* The statements after it would run on the wrong schema */
+      dry_run_mark(ctx, i + 1, "Audit completed; dry run stopped");
+      break;
+    }
+
+    node.execute_seconds = run.execute_seconds;
+    node.estimated_time = run.execute_time_text();
+    node.affected_rows = run.affected_rows;
+    SandboxCounters after;
+    char status[256];
+    if (have_counters && !read_sandbox_counters(mysql, &after)) {
+      snprintf(status, sizeof(status),
+               "Dry run completed: %ss, %lld rows, %llu rows read, "
+               "%llu redo bytes, %llu row lock waits (%llu ms)",
+               node.estimated_time.c_str(), (long long)node.affected_rows,
+               (unsigned long long)(after.rows_read - before.rows_read),
+               (unsigned long long)(after.redo_bytes - before.redo_bytes),
+               (unsigned long long)(after.lock_waits - before.lock_waits),
+               (unsigned long long)(after.lock_wait_ms - before.lock_wait_ms));
+      before = after;
+    } else {
+      have_counters = false;
+      snprintf(status, sizeof(status), "Dry run completed: %ss, %lld rows",
+               node.estimated_time.c_str(), (long long)node.affected_rows);
+    }
+    node.stage_status = status;
+  }
+
+  ctx->remote_exec_thread_id.store(0);
+  pool_release(mysql, PoolRelease::DIRTY);
+}
+
+bool execute_statements(THD *thd, InceptionContext *ctx) {
+  if (ctx->cache_nodes.empty()) return false;
+  StageScope stage(stage_inception_execute);
+  bool failed = execute_batch(thd, ctx);
+  /* Whatever the batch ended with, skipped and killed statements too */
+  ctx->publish_executed(ctx->cache_nodes.size());
+  return failed;
+}
+
 }  // namespace inception
@@ -6,22 +6,102 @@
 #ifndef SQL_INCEPTION_EXEC_H
 #define SQL_INCEPTION_EXEC_H
 
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+#include "my_compiler.h"    // MY_ATTRIBUTE
+
 class THD;
 
 namespace inception {
 
 struct InceptionContext;
+struct SqlCacheNode;
 
 /**
  * Execute all cached SQL statements on the remote target MySQL.
  * Uses mysql_real_connect() to connect to ctx->host:ctx->port.
- *
- * Skeleton — actual execution logic to be implemented.
+ * thd is nullptr when a background job worker runs the batch.
  *
  * @return false on success, true on error.
  */
 bool execute_statements(THD *thd, InceptionContext *ctx);
 
+/**
+ * --dry-run-target: run the audited CHECK batch, one statement at a time,
+ * on ctx->dry_run_sandbox (a clone of the target) and report what each
+ * statement actually cost there: execute_time, estimated_time and
+ * affected_rows become the measured ones, and stage_status adds the rows
+ * read, redo bytes and row lock waits it added to the sandbox's global
+ * counters. A failure there is a warning; the statements after it are not
+ * run. Skipped when the batch has audit errors (unless --enable-force).
+ */
+void dry_run_statements(THD *thd, InceptionContext *ctx);
+
+/* ---- Helpers shared with the online schema change and backup modules ---- */
+
+/** Statement text without the inception comment, trailing ';' and space. */
+std::string bare_statement(const SqlCacheNode &node);
+
+/**
+ * Where bare_statement(node) lies in node.sql_text: its offset, and its
+ * length in *length, for callers that do not need a copy.
+ */
+size_t bare_statement_bounds(const SqlCacheNode &node, size_t *length);
+
+/** Quote an identifier with backticks. */
+std::string quote_ident(const std::string &name);
+
+/** Run a statement, discarding any result. Returns true with *err set. */
+bool run_sql(MYSQL *mysql, const std::string &sql, std::string *err);
+
+/** snprintf into a std::string, for templates with unbounded arguments. */
+std::string format_sql(const char *fmt, ...)
+    MY_ATTRIBUTE((format(printf, 1, 2)));
+
+/**
+ * Run a query expected to return one row and copy its columns into *out.
+ * *found is false if there is no row or its first column is NULL.
+ * Returns true on error.
+ */
+bool query_one_row(MYSQL *mysql, const std::string &query,
+                   std::vector<std::string> *out, bool *found);
+
+/**
+ * Name of the primary key of db.table if it is a single integer column,
+ * empty otherwise (or if the lookup failed).
+ */
+std::string single_integer_pk(MYSQL *mysql, const std::string &db,
+                              const std::string &table);
+
+/**
+ * Partitions of db.table in definition order into *names (none if it is
+ * not partitioned). Returns true if the lookup failed.
+ */
+bool list_partitions(MYSQL *mysql, const std::string &db,
+                     const std::string &table,
+                     std::vector<std::string> *names);
+
+/**
+ * Spaces the key-range chunks of several scanning threads at per_sec a
+ * second (0 = no limit).
+ */
+class ChunkPacer {
+ public:
+  explicit ChunkPacer(ulong per_sec) : m_per_sec(per_sec) {}
+
+  /** Wait for the next slot. @return true if the session was killed. */
+  bool wait(InceptionContext *ctx);
+
+ private:
+  const ulong m_per_sec;
+  std::mutex m_mutex;
+  std::chrono::steady_clock::time_point m_next;
+};
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_EXEC_H
@@ -0,0 +1,215 @@
+/**
+ * @file inception_fanout.cc
+ * @brief One EXECUTE batch fanned out over many shards (--targets).
+ */
+
+#include "sql/inception/inception_fanout.h"
+
+#include "sql/inception/inception_backup.h"
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_log.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/inception/inception_verify.h"
+#include "sql/sql_class.h"  // THD, Security_context
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <strings.h>
+#include <thread>
+
+namespace inception {
+
+/* How often the coordinator re-checks the submitting session's controls
+   when nothing woke it */
+static const std::chrono::milliseconds CONTROL_POLL(200);
+
+static std::string trim(const std::string &s) {
+  size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos) return "";
+  size_t e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+
+void parse_host_list(const std::string &list,
+                     std::vector<std::pair<std::string, uint>> *hosts) {
+  hosts->clear();
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t comma = list.find(',', pos);
+    if (comma == std::string::npos) comma = list.size();
+    std::string entry = trim(list.substr(pos, comma - pos));
+    auto colon = entry.rfind(':');
+    if (colon != std::string::npos) {
+      std::string h = entry.substr(0, colon);
+      uint p = static_cast<uint>(strtoul(entry.c_str() + colon + 1, nullptr, 10));
+      if (!h.empty() && p > 0 && p <= 65535) hosts->emplace_back(h, p);
+    }
+    pos = comma + 1;
+  }
+}
+
+bool resolve_target_group(const std::string &name,
+                          std::vector<std::pair<std::string, uint>> *targets) {
+  const char *opt = opt_target_groups;
+  if (!opt || !*opt) return false;
+  std::string groups(opt);
+  size_t pos = 0;
+  while (pos < groups.size()) {
+    size_t semi = groups.find(';', pos);
+    if (semi == std::string::npos) semi = groups.size();
+    std::string entry = groups.substr(pos, semi - pos);
+    size_t eq = entry.find('=');
+    if (eq != std::string::npos && trim(entry.substr(0, eq)) == name) {
+      parse_host_list(entry.substr(eq + 1), targets);
+      return !targets->empty();
+    }
+    pos = semi + 1;
+  }
+  return false;
+}
+
+/** The EXECUTE half of do_inception_commit() for one shard. */
+static void run_shard(InceptionContext *shard) {
+  execute_statements(nullptr, shard);
+  if (shard->backup) generate_rollback(nullptr, shard);
+  verify_written_tables(shard);
+
+  int total = static_cast<int>(shard->cache_nodes.size());
+  int errors = 0;
+  for (const auto &n : shard->cache_nodes)
+    if (n.errlevel >= ERRLEVEL_ERROR) errors++;
+  int64_t duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - shard->session_start_time).count();
+  audit_log_session(nullptr, shard, total, errors, duration_ms);
+  if (shard->remote_conn) {
+    pool_release(shard->remote_conn, PoolRelease::DB_CHANGED);
+    shard->remote_conn = nullptr;
+  }
+
+  fprintf(stderr, "[Inception] Shard %s:%u finished (%d errors).\n",
+          shard->host.c_str(), shard->port, errors);
+  fflush(stderr);
+}
+
+void run_subbatches(InceptionContext *parent,
+                    const std::vector<InceptionContext *> &list,
+                    size_t workers,
+                    const std::function<void(InceptionContext *)> &run) {
+  const size_t n = list.size();
+  std::atomic<size_t> next{0};
+  size_t finished = 0;  /* guarded by parent->control_mutex */
+  std::vector<std::thread> threads;
+  for (size_t w = 0; w < std::min(n, workers); w++) {
+    threads.emplace_back([&] {
+      const bool thread_ok = !my_thread_init();
+      if (thread_ok) bind_worker_resource_group();
+      for (;;) {
+        size_t i = next.fetch_add(1);
+        if (i >= n) break;
+        if (thread_ok) {
+          run(list[i]);
+        } else {
+          for (auto &node : list[i]->cache_nodes) {
+            node.append_error("Cannot initialize execution worker thread.");
+            node.stage = STAGE_EXECUTED;
+            node.stage_status = "Execute failed";
+          }
+        }
+        {
+          std::lock_guard<std::mutex> lock(parent->control_mutex);
+          finished++;
+        }
+        parent->control_cond.notify_all();
+      }
+      if (thread_ok) my_thread_end();
+    });
+  }
+
+  /* Forward kill / pause / sleep of the submitting session */
+  bool killed = parent->killed.load();
+  bool paused = parent->paused.load();
+  uint64_t sleep_ms = parent->sleep_ms.load();
+  std::unique_lock<std::mutex> lock(parent->control_mutex);
+  while (finished < n) {
+    if (parent->killed.load() != killed || parent->paused.load() != paused ||
+        parent->sleep_ms.load() != sleep_ms) {
+      killed = parent->killed.load();
+      paused = parent->paused.load();
+      sleep_ms = parent->sleep_ms.load();
+      for (auto *child : list) {
+        child->killed.store(killed);
+        child->paused.store(paused);
+        child->sleep_ms.store(sleep_ms);
+        child->notify_control();
+      }
+    }
+    parent->control_cond.wait_for(lock, CONTROL_POLL);
+  }
+  lock.unlock();
+  for (auto &t : threads) t.join();
+}
+
+void execute_fanout(THD *thd, InceptionContext *ctx) {
+  std::string client_user = ctx->client_user;
+  std::string client_host = ctx->client_host;
+  if (thd) {
+    const char *user = thd->security_context()->user().str;
+    const char *host = thd->security_context()->host_or_ip().str;
+    client_user = user ? user : "";
+    client_host = host ? host : "";
+  }
+
+  std::vector<std::unique_ptr<InceptionContext>> shards;
+  for (const auto &t : ctx->targets) {
+    std::unique_ptr<InceptionContext> shard(new InceptionContext);
+    copy_exec_settings(*ctx, shard.get());
+    shard->host = t.first;
+    shard->port = t.second;
+    /* --slave-hosts replicate the representative shard */
+    if (strcasecmp(t.first.c_str(), ctx->host.c_str()) != 0 ||
+        t.second != ctx->port)
+      shard->slave_hosts.clear();
+    shard->targets.clear();
+    shard->target_group.clear();
+    shard->killed.store(ctx->killed.load());
+    shard->paused.store(ctx->paused.load());
+    shard->cache_nodes = ctx->cache_nodes;
+    shard->total_sql.store(static_cast<int>(ctx->cache_nodes.size()));
+    shard->progress_parent = ctx;
+    shard->next_id = ctx->next_id;
+    shard->client_thread_id = thd ? thd->thread_id() : ctx->client_thread_id;
+    shard->client_user = client_user;
+    shard->client_host = client_host;
+    shards.push_back(std::move(shard));
+  }
+
+  std::vector<InceptionContext *> list;
+  for (const auto &s : shards) list.push_back(s.get());
+  {
+    std::lock_guard<std::mutex> lock(ctx->control_mutex);
+    ctx->shards.swap(shards);
+  }
+  /* The batch once per shard */
+  ctx->total_sql.store(static_cast<int>(ctx->cache_nodes.size() * list.size()));
+
+  const size_t n = list.size();
+  const size_t worker_count =
+      std::min(n, static_cast<size_t>(opt_exec_fanout_workers));
+  fprintf(stderr,
+          "[Inception] Fan-out of %zu statements to %zu targets, %zu at a "
+          "time.\n",
+          ctx->cache_nodes.size(), n, worker_count);
+  fflush(stderr);
+
+  run_subbatches(ctx, list, worker_count, run_shard);
+}
+
+}  // namespace inception
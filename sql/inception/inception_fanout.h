@@ -0,0 +1,74 @@
+/**
+ * @file inception_fanout.h
+ * @brief One EXECUTE batch fanned out over many shards (--targets).
+ *
+ * Sharded deployments keep one schema on many servers; submitting the same
+ * script once per shard repeats the audit and its remote round trips every
+ * time. With --targets=host:port,host:port,... (or --target-group=<name>,
+ * a list kept in inception_target_groups) the batch is audited once,
+ * against --host/--port as the representative shard, and at commit runs on
+ * every listed target.
+ *
+ * Each target gets its own context with a copy of the audited batch, run
+ * by execute_statements() on one of at most inception_exec_fanout_workers
+ * threads, so throttling (load sampler, rate budget, scheduler slots) is
+ * per target as it is for separate sessions. --slave-hosts belongs to the
+ * representative and is only watched on that target. Kill, pause and
+ * "inception set sleep" on the submitting session reach every shard, and
+ * each shard writes its own rollback and audit log records.
+ *
+ * The result set is the usual one plus a target column, one row per shard
+ * and statement.
+ */
+
+#ifndef SQL_INCEPTION_FANOUT_H
+#define SQL_INCEPTION_FANOUT_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "my_inttypes.h"  // uint
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+
+/**
+ * Parse "host:port,host:port" into *hosts, skipping malformed entries.
+ * Used for --slave-hosts, --targets and inception_target_groups.
+ */
+void parse_host_list(const std::string &list,
+                     std::vector<std::pair<std::string, uint>> *hosts);
+
+/**
+ * Look name up in inception_target_groups
+ * ("name=host:port,...;name2=..."). Returns false if there is no such
+ * group or it lists no valid target.
+ */
+bool resolve_target_group(const std::string &name,
+                          std::vector<std::pair<std::string, uint>> *targets);
+
+/**
+ * Run each context of list with run() on at most workers threads and
+ * forward kill / pause / sleep of parent to them until all returned.
+ * Shared by the fan-out shards and the --enable-parallel lanes.
+ */
+void run_subbatches(InceptionContext *parent,
+                    const std::vector<InceptionContext *> &list,
+                    size_t workers,
+                    const std::function<void(InceptionContext *)> &run);
+
+/**
+ * Run the audited batch of ctx on each of ctx->targets and keep the
+ * per-target results in ctx->shards. Returns when every shard finished.
+ * thd is the submitting client, nullptr for a background job.
+ */
+void execute_fanout(THD *thd, InceptionContext *ctx);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_FANOUT_H
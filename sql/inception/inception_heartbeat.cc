@@ -0,0 +1,177 @@
+/**
+ * @file inception_heartbeat.cc
+ * @brief Heartbeat-table replication lag for the --slave-hosts replicas.
+ */
+
+#include "sql/inception/inception_heartbeat.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"  // quote_ident
+#include "sql/inception/inception_monitor.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/mysqld.h"  // server_id
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace inception {
+
+/* How long the constructor waits for the first heartbeat write */
+static const std::chrono::seconds FIRST_WRITE_TIMEOUT(10);
+
+static long long now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string heartbeat_table() {
+  const char *opt = opt_exec_heartbeat_table;
+  if (!opt || !*opt) return "";
+  std::string name(opt);
+  size_t dot = name.find('.');
+  if (dot == 0 || dot == std::string::npos || dot + 1 == name.size() ||
+      name.find('.', dot + 1) != std::string::npos)
+    return "";
+  return quote_ident(name.substr(0, dot)) + "." +
+         quote_ident(name.substr(dot + 1));
+}
+
+/** Lag from the heartbeat row of this server. Returns true on error. */
+static bool read_heartbeat_lag(MYSQL *mysql, const std::string &table,
+                               long *lag_ms) {
+  char sql[512];
+  snprintf(sql, sizeof(sql), remote_sql::HEARTBEAT_READ, table.c_str(),
+           server_id);
+  if (mysql_real_query(mysql, sql, static_cast<unsigned long>(strlen(sql))) !=
+      0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool failed = !(row && row[0]);
+  if (!failed) {
+    long long lag = (now_us() - strtoll(row[0], nullptr, 10)) / 1000;
+    *lag_ms = lag > 0 ? static_cast<long>(lag) : 0;
+  }
+  mysql_free_result(res);
+  return failed;
+}
+
+bool read_replica_lag(MYSQL *mysql, long *lag_ms) {
+  long delay = 0;
+  if (read_replication_delay(mysql, &delay)) return true;
+  /* Stopped replication wins: a stale heartbeat row would only grow */
+  if (delay < 0) {
+    *lag_ms = -1;
+    return false;
+  }
+  std::string table = heartbeat_table();
+  if (!table.empty() && !read_heartbeat_lag(mysql, table, lag_ms))
+    return false;
+  *lag_ms = delay * 1000;
+  return false;
+}
+
+HeartbeatWriter::HeartbeatWriter(InceptionContext *ctx) : m_ctx(ctx) {
+  /* Nobody reads the lag otherwise */
+  if (ctx->slave_hosts.empty() || (opt_exec_max_replication_delay == 0 &&
+                                   opt_exec_monitor_max_replication_delay == 0))
+    return;
+  m_table = heartbeat_table();
+  if (m_table.empty()) {
+    if (opt_exec_heartbeat_table && *opt_exec_heartbeat_table) {
+      fprintf(stderr, "[Inception] inception_exec_heartbeat_table '%s' is not "
+              "db.table, heartbeat disabled.\n", opt_exec_heartbeat_table);
+      fflush(stderr);
+    }
+    return;
+  }
+  m_thread = std::thread([this] { run(); });
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cond.wait_for(lock, FIRST_WRITE_TIMEOUT, [this] { return m_started; });
+}
+
+HeartbeatWriter::~HeartbeatWriter() {
+  if (!m_thread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+}
+
+/** One heartbeat. Logs the first failure only. */
+void HeartbeatWriter::write(MYSQL *mysql, bool *logged) {
+  char sql[512];
+  snprintf(sql, sizeof(sql), remote_sql::HEARTBEAT_WRITE, m_table.c_str(),
+           server_id, now_us());
+  if (mysql_real_query(mysql, sql, static_cast<unsigned long>(strlen(sql))) ==
+      0)
+    return;
+  if (!*logged) {
+    fprintf(stderr, "[Inception] Heartbeat write to %s failed: %s\n",
+            m_table.c_str(), mysql_error(mysql));
+    fflush(stderr);
+    *logged = true;
+  }
+}
+
+void HeartbeatWriter::run() {
+  MYSQL *mysql = nullptr;
+  const bool thread_ok = !my_thread_init();
+  if (thread_ok) {
+    bind_worker_resource_group();
+    PoolConnOptions opts;
+    opts.connect_timeout = 5;
+    opts.read_timeout = 30;
+    std::string user = m_ctx->user.empty() ? "root" : m_ctx->user;
+    std::string host = m_ctx->host.empty() ? "127.0.0.1" : m_ctx->host;
+    std::string err;
+    mysql = pool_acquire(host, m_ctx->port, user, m_ctx->password, opts, &err);
+    if (!mysql) {
+      fprintf(stderr, "[Inception] Heartbeat cannot connect to %s:%u: %s\n",
+              host.c_str(), m_ctx->port, err.c_str());
+      fflush(stderr);
+    } else {
+      char sql[512];
+      snprintf(sql, sizeof(sql), remote_sql::HEARTBEAT_CREATE_TABLE,
+               m_table.c_str());
+      if (mysql_real_query(mysql, sql,
+                           static_cast<unsigned long>(strlen(sql))) != 0) {
+        fprintf(stderr, "[Inception] Cannot create heartbeat table %s: %s\n",
+                m_table.c_str(), mysql_error(mysql));
+        fflush(stderr);
+      }
+    }
+  }
+
+  bool logged = false;
+  if (mysql) write(mysql, &logged);
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_started = true;
+  m_cond.notify_all();
+  while (mysql && !m_stop) {
+    m_cond.wait_for(lock,
+                    std::chrono::milliseconds(opt_exec_heartbeat_interval_ms),
+                    [this] { return m_stop; });
+    if (m_stop) break;
+    lock.unlock();
+    write(mysql, &logged);
+    lock.lock();
+  }
+  lock.unlock();
+
+  if (mysql) pool_release(mysql, PoolRelease::CLEAN);
+  if (thread_ok) my_thread_end();
+}
+
+}  // namespace inception
@@ -0,0 +1,78 @@
+/**
+ * @file inception_heartbeat.h
+ * @brief Heartbeat-table replication lag for the --slave-hosts replicas.
+ *
+ * Seconds_Behind_Master has whole-second resolution and measures the age
+ * of the event the SQL thread is applying, not how far the replica is
+ * behind the primary: it reads 0 while the IO thread is behind, and jumps
+ * when a long transaction finishes. With inception_exec_heartbeat_table
+ * set to db.table, every EXECUTE batch that has --slave-hosts and a
+ * replication delay ceiling owns a
+ * HeartbeatWriter thread that, on its own pooled primary connection,
+ * REPLACEs the row id = @@server_id (of this inception server) with the
+ * current time in microseconds every inception_exec_heartbeat_interval_ms.
+ * The lag of a replica is then now minus the ts it has replicated, in
+ * milliseconds.
+ *
+ * Both timestamps come from this inception server's clock, so clock skew
+ * between primary and replicas does not matter. The table is created on
+ * the primary if missing; the database must exist. Until a replica has a
+ * row for this server the lag falls back to Seconds_Behind_Master.
+ */
+
+#ifndef SQL_INCEPTION_HEARTBEAT_H
+#define SQL_INCEPTION_HEARTBEAT_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+struct InceptionContext;
+
+/**
+ * inception_exec_heartbeat_table quoted as `db`.`table`, or empty when the
+ * variable is unset or not of the form db.table.
+ */
+std::string heartbeat_table();
+
+/**
+ * Replication lag of the replica behind mysql in milliseconds, from the
+ * heartbeat table when configured, else Seconds_Behind_Master * 1000.
+ * *lag_ms is -1 when replication is stopped or broken. Returns true on
+ * error or when the server is not a replica.
+ */
+bool read_replica_lag(MYSQL *mysql, long *lag_ms);
+
+class HeartbeatWriter {
+ public:
+  /**
+   * Starts the writer when a heartbeat table is configured and ctx has
+   * --slave-hosts, and waits for the first write so the first lag check
+   * does not read a row left over from an earlier batch.
+   */
+  explicit HeartbeatWriter(InceptionContext *ctx);
+  ~HeartbeatWriter();
+  HeartbeatWriter(const HeartbeatWriter &) = delete;
+  HeartbeatWriter &operator=(const HeartbeatWriter &) = delete;
+
+ private:
+  void run();
+  void write(MYSQL *mysql, bool *logged);
+
+  InceptionContext *m_ctx;
+  std::string m_table;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop = false;
+  bool m_started = false;  /* first write attempted */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_HEARTBEAT_H
@@ -0,0 +1,313 @@
+/**
+ * @file inception_job.cc
+ * @brief Background execution jobs (--enable-async).
+ */
+
+#include "sql/inception/inception_job.h"
+
+#include "sql/inception/inception_backup.h"
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_fanout.h"
+#include "sql/inception/inception_log.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/inception/inception_verify.h"
+#include "sql/sql_class.h"  // THD, Security_context
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace inception {
+
+namespace {
+
+enum class JobState { QUEUED, RUNNING, FINISHED };
+
+struct Job {
+  uint64_t id = 0;
+  JobState state = JobState::QUEUED;
+  std::shared_ptr<InceptionContext> ctx;
+  time_t submitted = 0;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::time_point finished;
+};
+
+/**
+ * Jobs by id and the queue the workers take them from. Allocated once and
+ * never freed, so workers may outlive static destructors if the server
+ * exits without job_shutdown().
+ */
+struct JobRegistry {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::map<uint64_t, std::shared_ptr<Job>> jobs;
+  std::deque<std::shared_ptr<Job>> queue;
+  std::vector<std::thread> workers;
+  size_t idle = 0;
+  uint64_t next_id = 1;
+  bool stop = false;
+};
+
+}  // namespace
+
+static JobRegistry *registry() {
+  static JobRegistry *r = new JobRegistry;
+  return r;
+}
+
+/** Drop the oldest finished jobs beyond inception_job_history. */
+static void trim_history(JobRegistry *r) {
+  size_t finished = 0;
+  for (const auto &kv : r->jobs)
+    if (kv.second->state == JobState::FINISHED) finished++;
+  for (auto it = r->jobs.begin();
+       it != r->jobs.end() && finished > opt_job_history;) {
+    if (it->second->state == JobState::FINISHED) {
+      it = r->jobs.erase(it);
+      finished--;
+    } else {
+      ++it;
+    }
+  }
+}
+
+/** Release what the batch borrowed; the results stay in ctx. */
+static void release_job_resources(InceptionContext *ctx) {
+  if (ctx->remote_conn) {
+    pool_release(ctx->remote_conn, PoolRelease::DB_CHANGED);
+    ctx->remote_conn = nullptr;
+  }
+}
+
+/** The EXECUTE half of do_inception_commit(), without a client. */
+static void run_job(Job *job) {
+  InceptionContext *ctx = job->ctx.get();
+  fprintf(stderr, "[Inception] Job %llu started (%zu statements on %s:%u).\n",
+          static_cast<unsigned long long>(job->id), ctx->cache_nodes.size(),
+          ctx->host.c_str(), ctx->port);
+  fflush(stderr);
+
+  int errors = 0;
+  if (!ctx->targets.empty()) {
+    /* Each shard writes its own session audit record */
+    execute_fanout(nullptr, ctx);
+    for (const auto &shard : ctx->shards)
+      for (const auto &n : shard->cache_nodes)
+        if (n.errlevel >= ERRLEVEL_ERROR) errors++;
+  } else {
+    execute_statements(nullptr, ctx);
+    if (ctx->backup) generate_rollback(nullptr, ctx);
+    verify_written_tables(ctx);
+
+    int total = static_cast<int>(ctx->cache_nodes.size());
+    for (const auto &n : ctx->cache_nodes)
+      if (n.errlevel >= ERRLEVEL_ERROR) errors++;
+    int64_t duration_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - ctx->session_start_time)
+            .count();
+    audit_log_session(nullptr, ctx, total, errors, duration_ms);
+  }
+  release_job_resources(ctx);
+
+  fprintf(stderr, "[Inception] Job %llu finished (%d errors).\n",
+          static_cast<unsigned long long>(job->id), errors);
+  fflush(stderr);
+}
+
+static void worker_main(JobRegistry *r) {
+  if (my_thread_init()) {
+    fprintf(stderr, "[Inception] Cannot initialize job worker thread.\n");
+    fflush(stderr);
+    std::lock_guard<std::mutex> lock(r->mutex);
+    r->idle--;
+    return;
+  }
+  bind_worker_resource_group();
+  std::unique_lock<std::mutex> lock(r->mutex);
+  for (;;) {
+    r->cond.wait(lock, [r] { return r->stop || !r->queue.empty(); });
+    if (r->stop) break;
+    std::shared_ptr<Job> job = r->queue.front();
+    r->queue.pop_front();
+    r->idle--;
+    job->state = JobState::RUNNING;
+    job->started = std::chrono::steady_clock::now();
+    lock.unlock();
+
+    run_job(job.get());
+
+    lock.lock();
+    job->state = JobState::FINISHED;
+    job->finished = std::chrono::steady_clock::now();
+    r->idle++;
+    trim_history(r);
+  }
+  r->idle--;
+  lock.unlock();
+  my_thread_end();
+}
+
+uint64_t submit_job(THD *thd, InceptionContext *ctx) {
+  auto job = std::make_shared<Job>();
+  job->ctx = std::make_shared<InceptionContext>();
+  InceptionContext *jc = job->ctx.get();
+
+  /* What execute_statements(), generate_rollback() and the results need */
+  copy_exec_settings(*ctx, jc);
+  jc->cache_nodes = std::move(ctx->cache_nodes);
+  ctx->cache_nodes.clear();
+  jc->total_sql.store(static_cast<int>(jc->cache_nodes.size()));
+  jc->next_id = ctx->next_id;
+  jc->client_thread_id = thd->thread_id();
+  const char *user = thd->security_context()->user().str;
+  const char *host = thd->security_context()->host_or_ip().str;
+  jc->client_user = user ? user : "";
+  jc->client_host = host ? host : "";
+
+  job->submitted = time(nullptr);
+
+  JobRegistry *r = registry();
+  std::lock_guard<std::mutex> lock(r->mutex);
+  job->id = r->next_id++;
+  r->jobs[job->id] = job;
+  r->queue.push_back(job);
+  if (r->idle < r->queue.size() && r->workers.size() < opt_job_workers) {
+    r->idle++;
+    r->workers.emplace_back(worker_main, r);
+  }
+  r->cond.notify_one();
+  return job->id;
+}
+
+std::vector<JobInfo> get_jobs() {
+  JobRegistry *r = registry();
+  std::lock_guard<std::mutex> lock(r->mutex);
+  std::vector<JobInfo> result;
+  auto now = std::chrono::steady_clock::now();
+  for (const auto &kv : r->jobs) {
+    const Job &job = *kv.second;
+    const InceptionContext &ctx = *job.ctx;
+    JobInfo ji;
+    ji.id = job.id;
+    ji.state = job.state == JobState::QUEUED    ? "QUEUED"
+               : job.state == JobState::RUNNING ? "RUNNING"
+                                                : "FINISHED";
+    ji.client_thread_id = ctx.client_thread_id;
+    ji.client_user = ctx.client_user;
+    ji.host = ctx.host;
+    ji.port = ctx.port;
+    ji.total_sql = static_cast<int>(ctx.cache_nodes.size());
+    ji.executed_sql = 0;
+    ji.errors = 0;
+    for (const auto &node : ctx.cache_nodes) {
+      if (node.stage >= STAGE_EXECUTED) ji.executed_sql++;
+      if (node.errlevel >= ERRLEVEL_ERROR) ji.errors++;
+    }
+    {
+      /* Fan-out: the batch once per shard */
+      std::lock_guard<std::mutex> shards_lock(job.ctx->control_mutex);
+      if (!ctx.shards.empty()) {
+        ji.total_sql = 0;
+        ji.executed_sql = 0;
+        ji.errors = 0;
+        for (const auto &shard : ctx.shards) {
+          ji.total_sql += static_cast<int>(shard->cache_nodes.size());
+          for (const auto &node : shard->cache_nodes) {
+            if (node.stage >= STAGE_EXECUTED) ji.executed_sql++;
+            if (node.errlevel >= ERRLEVEL_ERROR) ji.errors++;
+          }
+        }
+      }
+    }
+    ji.submitted = job.submitted;
+    ji.elapsed_sec =
+        job.state == JobState::QUEUED
+            ? 0.0
+            : std::chrono::duration<double>(
+                  (job.state == JobState::FINISHED ? job.finished : now) -
+                  job.started).count();
+    result.push_back(std::move(ji));
+  }
+  return result;
+}
+
+JobLookup find_finished_job(uint64_t id,
+                            std::shared_ptr<InceptionContext> *ctx) {
+  JobRegistry *r = registry();
+  std::lock_guard<std::mutex> lock(r->mutex);
+  auto it = r->jobs.find(id);
+  if (it == r->jobs.end()) return JobLookup::NOT_FOUND;
+  if (it->second->state != JobState::FINISHED) return JobLookup::NOT_FINISHED;
+  *ctx = it->second->ctx;
+  return JobLookup::FOUND;
+}
+
+bool kill_job(uint64_t id, bool force) {
+  std::vector<RemoteThread> remote;
+  {
+    JobRegistry *r = registry();
+    std::lock_guard<std::mutex> lock(r->mutex);
+    auto it = r->jobs.find(id);
+    if (it == r->jobs.end()) return false;
+    Job &job = *it->second;
+    InceptionContext &ctx = *job.ctx;
+    ctx.killed.store(true);
+    ctx.notify_control();
+    if (job.state == JobState::QUEUED) {
+      /* Never reached a worker: finish it here */
+      for (auto qit = r->queue.begin(); qit != r->queue.end(); ++qit) {
+        if (qit->get() == &job) {
+          r->queue.erase(qit);
+          break;
+        }
+      }
+      for (auto &node : ctx.cache_nodes) {
+        node.stage = STAGE_EXECUTED;
+        node.stage_status = "Killed by user";
+      }
+      job.state = JobState::FINISHED;
+      job.started = job.finished = std::chrono::steady_clock::now();
+      trim_history(r);
+    } else if (job.state == JobState::RUNNING && force) {
+      remote = remote_threads(ctx);
+    }
+  }
+
+  for (const auto &t : remote)
+    kill_remote_thread(t.host, t.port, t.user, t.password, t.tid);
+  fprintf(stderr, "[Inception] Job %llu marked as killed%s.\n",
+          static_cast<unsigned long long>(id), force ? " (force)" : "");
+  fflush(stderr);
+  return true;
+}
+
+void job_shutdown() {
+  JobRegistry *r = registry();
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(r->mutex);
+    if (r->stop) return;
+    r->stop = true;
+    r->queue.clear();
+    for (auto &kv : r->jobs) {
+      kv.second->ctx->killed.store(true);
+      kv.second->ctx->notify_control();
+    }
+    workers.swap(r->workers);
+  }
+  r->cond.notify_all();
+  for (auto &t : workers) t.join();
+}
+
+}  // namespace inception
@@ -0,0 +1,80 @@
+/**
+ * @file inception_job.h
+ * @brief Background execution jobs (--enable-async).
+ *
+ * With --enable-async=1, inception_magic_commit of an EXECUTE batch does
+ * not run the statements on the client connection: the audited batch is
+ * handed to a server-side worker pool (inception_job_workers threads) and
+ * the commit returns its job id at once. The job keeps running when the
+ * client disconnects; its results stay available until it is one of more
+ * than inception_job_history finished jobs.
+ *
+ *   inception show jobs                    queued, running and finished jobs
+ *   inception get results <job_id>         result set of a finished job
+ *   inception kill job <job_id> [force]    stop it after the current statement
+ */
+
+#ifndef SQL_INCEPTION_JOB_H
+#define SQL_INCEPTION_JOB_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+
+/**
+ * Queue the EXECUTE batch of ctx as a background job. The batch and the
+ * target settings are moved into the job; ctx itself is left for the
+ * caller to reset. Returns the job id.
+ */
+uint64_t submit_job(THD *thd, InceptionContext *ctx);
+
+/** Snapshot of a job for "inception show jobs". */
+struct JobInfo {
+  uint64_t id;
+  std::string state;        /* QUEUED / RUNNING / FINISHED */
+  uint32_t client_thread_id;
+  std::string client_user;
+  std::string host;         /* target */
+  uint port;
+  int total_sql;
+  int executed_sql;         /* how many reached STAGE_EXECUTED */
+  int errors;               /* statements with errlevel ERROR */
+  time_t submitted;
+  double elapsed_sec;       /* running: so far; finished: total; queued: 0 */
+};
+
+std::vector<JobInfo> get_jobs();
+
+/** Outcome of find_finished_job(). */
+enum class JobLookup { FOUND, NOT_FOUND, NOT_FINISHED };
+
+/**
+ * Get the context holding the results of finished job id. The context is
+ * no longer written to and stays valid while *ctx is held.
+ */
+JobLookup find_finished_job(uint64_t id,
+                            std::shared_ptr<InceptionContext> *ctx);
+
+/**
+ * Stop job id after its current statement (a queued job is finished at
+ * once with every statement killed). force also KILLs the statement
+ * running on the target. Returns false if there is no such job.
+ */
+bool kill_job(uint64_t id, bool force);
+
+/**
+ * Kill running jobs, drop queued ones and join the workers.
+ * Called once at server shutdown, before the audit log is flushed.
+ */
+void job_shutdown();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_JOB_H
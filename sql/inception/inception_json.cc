@@ -0,0 +1,133 @@
+/**
+ * @file inception_json.cc
+ * @brief JsonWriter and json_escape_append().
+ */
+
+#include "sql/inception/inception_json.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace inception {
+
+namespace {
+
+/* The bytes json_escape_append() does not copy as they are */
+struct EscapeTable {
+  bool needs[256] = {};
+  EscapeTable() {
+    for (int c = 0; c < 0x20; c++) needs[c] = true;
+    needs[static_cast<unsigned char>('"')] = true;
+    needs[static_cast<unsigned char>('\\')] = true;
+  }
+};
+
+const EscapeTable g_escape;
+
+/** Length of the leading run of s that needs no escaping. */
+size_t safe_run(const char *s, size_t len) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i backslash = _mm_set1_epi8('\\');
+  const __m128i control = _mm_set1_epi8(0x1f);
+  for (; i + 16 <= len; i += 16) {
+    const __m128i v =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    /* Unsigned v <= 0x1f exactly when max(v, 0x1f) == 0x1f */
+    const __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+        _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+    const int mask = _mm_movemask_epi8(hit);
+    if (mask != 0) return i + static_cast<size_t>(__builtin_ctz(mask));
+  }
+#endif
+  while (i < len && !g_escape.needs[static_cast<unsigned char>(s[i])]) i++;
+  return i;
+}
+
+void append_decimal(std::string *out, uint64_t n) {
+  char buf[20];
+  char *p = buf + sizeof(buf);
+  do {
+    *--p = static_cast<char>('0' + n % 10);
+    n /= 10;
+  } while (n > 0);
+  out->append(p, buf + sizeof(buf) - p);
+}
+
+}  // namespace
+
+void json_escape_append(std::string *out, const char *s, size_t len) {
+  static const char hex_digits[] = "0123456789abcdef";
+  size_t pos = 0;
+  while (pos < len) {
+    const size_t run = safe_run(s + pos, len - pos);
+    out->append(s + pos, run);
+    pos += run;
+    if (pos == len) break;
+
+    const unsigned char c = static_cast<unsigned char>(s[pos++]);
+    switch (c) {
+      case '"':  out->append("\\\"", 2); break;
+      case '\\': out->append("\\\\", 2); break;
+      case '\n': out->append("\\n", 2);  break;
+      case '\r': out->append("\\r", 2);  break;
+      case '\t': out->append("\\t", 2);  break;
+      default: {
+        const char u[6] = {'\\', 'u', '0', '0', hex_digits[c >> 4],
+                           hex_digits[c & 0x0f]};
+        out->append(u, sizeof(u));
+        break;
+      }
+    }
+  }
+}
+
+void JsonWriter::key(const char *name) {
+  separate();
+  m_out->push_back('"');
+  m_out->append(name);
+  m_out->append("\":", 2);
+  m_comma = false;
+}
+
+void JsonWriter::value(const char *s, size_t len) {
+  separate();
+  m_out->push_back('"');
+  json_escape_append(m_out, s, len);
+  m_out->push_back('"');
+  m_comma = true;
+}
+
+void JsonWriter::value_truncated(const char *s, size_t len, size_t max_len) {
+  if (len <= max_len) {
+    value(s, len);
+    return;
+  }
+  separate();
+  m_out->push_back('"');
+  json_escape_append(m_out, s, max_len);
+  m_out->append("...\"", 4);
+  m_comma = true;
+}
+
+void JsonWriter::value_int(int64_t n) {
+  separate();
+  if (n < 0) {
+    m_out->push_back('-');
+    append_decimal(m_out, 0 - static_cast<uint64_t>(n));
+  } else {
+    append_decimal(m_out, static_cast<uint64_t>(n));
+  }
+  m_comma = true;
+}
+
+void JsonWriter::value_uint(uint64_t n) {
+  separate();
+  append_decimal(m_out, n);
+  m_comma = true;
+}
+
+}  // namespace inception
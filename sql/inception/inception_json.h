@@ -0,0 +1,71 @@
+/**
+ * @file inception_json.h
+ * @brief JsonWriter: JSON appended in place to one std::string.
+ *
+ * The QUERY_TREE documents and the audit log lines are written front to
+ * back into a single preallocated buffer, commas placed by the writer,
+ * instead of being concatenated from temporary strings. Strings are
+ * escaped by json_escape_append(), which copies the runs of bytes that
+ * need no escaping in bulk (found 16 bytes at a time with SSE2).
+ */
+
+#ifndef SQL_INCEPTION_JSON_H
+#define SQL_INCEPTION_JSON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace inception {
+
+/**
+ * Append s[0, len) to *out as the inside of a JSON string: '"', '\\' and
+ * the control characters escaped, every other byte (UTF-8 included) as is.
+ */
+void json_escape_append(std::string *out, const char *s, size_t len);
+
+class JsonWriter {
+ public:
+  /** Write to the end of *out, which the caller may reserve first. */
+  explicit JsonWriter(std::string *out) : m_out(out) {}
+
+  void begin_object() { open('{'); }
+  void end_object() { close('}'); }
+  void begin_array() { open('['); }
+  void end_array() { close(']'); }
+
+  /** "name": — name is written as is, it must not need escaping. */
+  void key(const char *name);
+
+  void value(const char *s, size_t len);
+  void value(const char *s) { value(s ? s : "", s ? strlen(s) : 0); }
+  void value(const std::string &s) { value(s.data(), s.size()); }
+
+  /** The first max_len bytes of s, followed by "..." when cut. */
+  void value_truncated(const char *s, size_t len, size_t max_len);
+
+  void value_int(int64_t n);
+  void value_uint(uint64_t n);
+
+ private:
+  void separate() {
+    if (m_comma) m_out->push_back(',');
+  }
+  void open(char c) {
+    separate();
+    m_out->push_back(c);
+    m_comma = false;
+  }
+  void close(char c) {
+    m_out->push_back(c);
+    m_comma = true;
+  }
+
+  std::string *m_out;
+  bool m_comma = false; /* a value precedes in the current container */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_JSON_H
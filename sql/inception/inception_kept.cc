@@ -0,0 +1,164 @@
+/**
+ * @file inception_kept.cc
+ * @brief Result sets of finished sessions kept for paging.
+ */
+
+#include "sql/inception/inception_kept.h"
+
+#include "sql/inception/inception_status.h"   // InceptionMutex
+#include "sql/inception/inception_sysvars.h"
+
+#include <strings.h>  // strncasecmp
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace inception {
+
+/* The varint lengths of RowSpool (inception_spool.cc) */
+static void put_length(std::string *buf, uint64_t len) {
+  while (len >= 0x80) {
+    buf->push_back(static_cast<char>((len & 0x7f) | 0x80));
+    len >>= 7;
+  }
+  buf->push_back(static_cast<char>(len));
+}
+
+static uint64_t get_length(const std::string &buf, size_t *pos) {
+  uint64_t len = 0;
+  for (int shift = 0;; shift += 7) {
+    const unsigned char c = static_cast<unsigned char>(buf[(*pos)++]);
+    len |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80)) return len;
+  }
+}
+
+void KeptResults::add(const std::vector<std::string> &fields, int errlevel) {
+  if (m_overflow) return;
+  m_offsets.push_back(m_data.size());
+  m_errlevels.push_back(static_cast<uint8_t>(errlevel));
+  put_length(&m_data, fields.size());
+  for (const auto &field : fields) {
+    put_length(&m_data, field.size());
+    m_data.append(field);
+  }
+  if (bytes() > m_limit) {
+    m_overflow = true;
+    std::string().swap(m_data);
+    std::vector<size_t>().swap(m_offsets);
+    std::vector<uint8_t>().swap(m_errlevels);
+  }
+}
+
+void KeptResults::row(size_t i, std::vector<std::string> *fields) const {
+  size_t pos = m_offsets[i];
+  fields->resize(get_length(m_data, &pos));
+  for (auto &field : *fields) {
+    const size_t len = get_length(m_data, &pos);
+    field.assign(m_data, pos, len);
+    pos += len;
+  }
+}
+
+/* The last kept results of each connection, by thread id */
+static InceptionMutex g_kept_mutex("kept_results");
+static std::map<uint32_t, std::shared_ptr<const KeptResults>> g_kept;
+
+static bool expired(const KeptResults &kept,
+                    std::chrono::steady_clock::time_point now) {
+  return now - kept.kept_at >= std::chrono::seconds(opt_result_keep_time);
+}
+
+std::shared_ptr<KeptResults> results_to_keep(uint32_t thread_id,
+                                             bool with_target) {
+  if (opt_result_keep_time == 0) return nullptr;
+  return std::make_shared<KeptResults>(thread_id, with_target,
+                                       opt_result_keep_size);
+}
+
+void keep_results(std::shared_ptr<KeptResults> results) {
+  const auto now = std::chrono::steady_clock::now();
+  results->kept_at = now;
+  std::lock_guard<InceptionMutex> lock(g_kept_mutex);
+  g_kept.erase(results->thread_id());
+
+  size_t total = 0;
+  for (auto it = g_kept.begin(); it != g_kept.end();) {
+    if (expired(*it->second, now)) {
+      it = g_kept.erase(it);
+    } else {
+      total += it->second->bytes();
+      ++it;
+    }
+  }
+  if (results->overflow()) {
+    fprintf(stderr,
+            "[Inception] Results of thread %u not kept: more than "
+            "inception_result_keep_size bytes.\n",
+            results->thread_id());
+    fflush(stderr);
+    return;
+  }
+  /* The oldest go first */
+  while (!g_kept.empty() && total + results->bytes() > opt_result_keep_size) {
+    auto oldest = g_kept.begin();
+    for (auto it = g_kept.begin(); it != g_kept.end(); ++it)
+      if (it->second->kept_at < oldest->second->kept_at) oldest = it;
+    total -= oldest->second->bytes();
+    g_kept.erase(oldest);
+  }
+  const uint32_t thread_id = results->thread_id();
+  g_kept[thread_id] = std::move(results);
+}
+
+std::shared_ptr<const KeptResults> find_kept_results(uint32_t thread_id) {
+  std::lock_guard<InceptionMutex> lock(g_kept_mutex);
+  auto it = g_kept.find(thread_id);
+  if (it == g_kept.end()) return nullptr;
+  if (opt_result_keep_time == 0 ||
+      expired(*it->second, std::chrono::steady_clock::now())) {
+    g_kept.erase(it);
+    return nullptr;
+  }
+  return it->second;
+}
+
+bool parse_result_page(const char *args, size_t len, ResultPage *page) {
+  *page = ResultPage();
+  const char *p = args;
+  const char *end = args + len;
+  int numbers = 0;
+  bool errlevel = false;
+  for (;;) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p == end) return false;
+    const char *word = p;
+    while (p < end && *p != ' ' && *p != '\t') p++;
+    const size_t word_len = static_cast<size_t>(p - word);
+
+    if (word_len > 10 && strncasecmp(word, "errlevel>=", 10) == 0) {
+      if (errlevel || word_len != 11 || word[10] < '0' || word[10] > '2')
+        return true;
+      page->min_errlevel = word[10] - '0';
+      errlevel = true;
+      continue;
+    }
+    /* offset and limit come before errlevel>=N */
+    if (errlevel || numbers == 2 || word[0] < '0' || word[0] > '9')
+      return true;
+    char *num_end = nullptr;
+    errno = 0;
+    const unsigned long long n = strtoull(word, &num_end, 10);
+    if (num_end != p || errno == ERANGE) return true;
+    if (numbers++ == 0)
+      page->offset = n;
+    else
+      page->limit = n;
+  }
+}
+
+}  // namespace inception
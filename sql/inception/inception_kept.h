@@ -0,0 +1,98 @@
+/**
+ * @file inception_kept.h
+ * @brief Result sets of finished sessions kept for paging.
+ *
+ * The commit of a CHECK or EXECUTE batch sends its whole result set at
+ * once. With inception_result_keep_time > 0 it is also kept here in
+ * compact form, the last one of each connection, so that a client can page
+ * through it later from any connection (errors first, say) instead of
+ * buffering a result set of 100000 rows:
+ *
+ *   inception get results session <thread_id> [offset [limit]] [errlevel>=N]
+ *
+ * A set is dropped inception_result_keep_time seconds after its commit,
+ * and the oldest first while all of them hold more than
+ * inception_result_keep_size bytes.
+ */
+
+#ifndef SQL_INCEPTION_KEPT_H
+#define SQL_INCEPTION_KEPT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace inception {
+
+/** The rows of a result set, each a list of fields; read-only once kept. */
+class KeptResults {
+ public:
+  /** @param limit bytes beyond which add() gives up (see overflow()) */
+  KeptResults(uint32_t thread_id, bool with_target, size_t limit)
+      : m_thread_id(thread_id), m_with_target(with_target), m_limit(limit) {}
+
+  /** Append a row of fields whose err_level is errlevel. */
+  void add(const std::vector<std::string> &fields, int errlevel);
+
+  size_t rows() const { return m_errlevels.size(); }
+  int errlevel(size_t i) const { return m_errlevels[i]; }
+  /** The fields of row i, as add() got them. */
+  void row(size_t i, std::vector<std::string> *fields) const;
+
+  uint32_t thread_id() const { return m_thread_id; }
+  /** The rows end with the target column (a --targets batch). */
+  bool with_target() const { return m_with_target; }
+  /** More than limit bytes were added: the rows were dropped. */
+  bool overflow() const { return m_overflow; }
+  size_t bytes() const {
+    return m_data.size() + m_offsets.size() * sizeof(size_t) +
+           m_errlevels.size();
+  }
+
+  std::chrono::steady_clock::time_point kept_at;
+
+ private:
+  uint32_t m_thread_id;
+  bool m_with_target;
+  size_t m_limit;
+  bool m_overflow = false;
+  std::string m_data;              /* fields, each after its length */
+  std::vector<size_t> m_offsets;   /* where each row starts in m_data */
+  std::vector<uint8_t> m_errlevels;
+};
+
+/**
+ * A KeptResults to fill while the commit of thread_id sends its result
+ * set, nullptr if inception_result_keep_time is 0.
+ */
+std::shared_ptr<KeptResults> results_to_keep(uint32_t thread_id,
+                                             bool with_target);
+
+/**
+ * Keep results in place of the last ones of its connection, dropping
+ * those past inception_result_keep_time or inception_result_keep_size.
+ */
+void keep_results(std::shared_ptr<KeptResults> results);
+
+/** The kept results of the last commit of thread_id, nullptr if none. */
+std::shared_ptr<const KeptResults> find_kept_results(uint32_t thread_id);
+
+/** Which rows of a result set "inception get results" sends. */
+struct ResultPage {
+  uint64_t offset = 0;    /* rows skipped, of those passing min_errlevel */
+  uint64_t limit = 0;     /* 0 = all */
+  int min_errlevel = 0;   /* errlevel>=N */
+};
+
+/**
+ * Parse "[offset [limit]] [errlevel>=N]".
+ * @return false on success, true if args are not of that form.
+ */
+bool parse_result_page(const char *args, size_t len, ResultPage *page);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_KEPT_H
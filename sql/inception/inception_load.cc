@@ -0,0 +1,466 @@
+/**
+ * @file inception_load.cc
+ * @brief Shared target load sampler behind the between-statement throttle.
+ */
+
+#include "sql/inception/inception_load.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_heartbeat.h"
+#include "sql/inception/inception_monitor.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "include/mysql.h"
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inception {
+
+/* How long a new subscriber waits for the first sample */
+static const std::chrono::seconds FIRST_SAMPLE_TIMEOUT(10);
+
+/* Adaptive throttle: back-off floor, recovery step and hold band */
+static const uint64_t ADAPTIVE_MIN_BACKOFF_MS = 100;
+static const uint64_t ADAPTIVE_STEP_MS = 50;
+static const double ADAPTIVE_LOW_PRESSURE = 0.8;
+
+/* Fewer statements since the previous sample give no p99 */
+static const unsigned long long P99_MIN_STATEMENTS = 20;
+
+static int64_t steady_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static bool read_history_length(MYSQL *mysql, long long *length) {
+  if (mysql_real_query(mysql, remote_sql::SELECT_HISTORY_LIST_LENGTH,
+                       strlen(remote_sql::SELECT_HISTORY_LIST_LENGTH)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool failed = !(row && row[0]);
+  if (!failed) *length = strtoll(row[0], nullptr, 10);
+  mysql_free_result(res);
+  return failed;
+}
+
+/** Number after label in SHOW ENGINE INNODB STATUS text; false if absent. */
+static bool status_number(const char *status, const char *label,
+                          unsigned long long *value) {
+  const char *p = strstr(status, label);
+  if (!p) return false;
+  *value = strtoull(p + strlen(label), nullptr, 10);
+  return true;
+}
+
+/** Redo log capacity in bytes. Returns true on error. */
+static bool read_redo_capacity(MYSQL *mysql, unsigned long long *capacity) {
+  if (mysql_real_query(mysql, remote_sql::SELECT_REDO_CAPACITY,
+                       strlen(remote_sql::SELECT_REDO_CAPACITY)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool failed = !(row && row[0]);
+  if (!failed) *capacity = strtoull(row[0], nullptr, 10);
+  mysql_free_result(res);
+  return failed || *capacity == 0;
+}
+
+/** LSN minus last checkpoint, in bytes. Returns true on error. */
+static bool read_checkpoint_age(MYSQL *mysql, unsigned long long *age) {
+  if (mysql_real_query(mysql, remote_sql::SHOW_ENGINE_INNODB_STATUS,
+                       strlen(remote_sql::SHOW_ENGINE_INNODB_STATUS)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  /* Columns: Type, Name, Status */
+  MYSQL_ROW row = mysql_fetch_row(res);
+  unsigned long long lsn = 0, checkpoint = 0;
+  bool failed = !(row && mysql_num_fields(res) > 2 && row[2]) ||
+                !status_number(row[2], "Log sequence number", &lsn) ||
+                !status_number(row[2], "Last checkpoint at", &checkpoint);
+  if (!failed) *age = lsn > checkpoint ? lsn - checkpoint : 0;
+  mysql_free_result(res);
+  return failed;
+}
+
+/** One sampler thread and its connections, shared by its subscribers. */
+class TargetSampler {
+ public:
+  explicit TargetSampler(const InceptionContext *ctx)
+      : m_host(ctx->host.empty() ? "127.0.0.1" : ctx->host),
+        m_port(ctx->port),
+        m_user(ctx->user.empty() ? "root" : ctx->user),
+        m_password(ctx->password),
+        m_slave_hosts(ctx->slave_hosts) {}
+
+  int refs = 0;  /* guarded by g_load_mutex */
+
+  void start() { m_thread = std::thread([this] { run(); }); }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+  }
+
+  void wait_first_sample() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait_for(lock, FIRST_SAMPLE_TIMEOUT, [this] { return m_sampled; });
+  }
+
+  LoadSample sample() const {
+    LoadSample s;
+    int64_t at = m_sampled_at.load();
+    /* A sampler stuck on a hung server must not hold execution forever */
+    int64_t max_age = 3 * static_cast<int64_t>(interval_ms()) + 1000;
+    if (at == 0 || steady_ms() - at > max_age) return s;
+    s.fresh = true;
+    s.threads_running = m_threads_running.load();
+    s.repl_lag_ms = m_repl_lag_ms.load();
+    s.repl_stopped = m_repl_stopped.load();
+    s.history_length = m_history_length.load();
+    s.checkpoint_age_pct = m_checkpoint_age_pct.load();
+    s.p99_ms = m_p99_ms.load();
+    s.sampled_at = at;
+    return s;
+  }
+
+  /** Lag from heartbeats moves in heartbeat steps; sample at that pace. */
+  uint64_t interval_ms() const {
+    uint64_t ms = opt_exec_load_sample_interval_ms;
+    if (opt_exec_max_replication_delay > 0 && !m_slave_hosts.empty() &&
+        !heartbeat_table().empty())
+      ms = std::min<uint64_t>(ms, opt_exec_heartbeat_interval_ms);
+    return ms;
+  }
+
+ private:
+  void connect() {
+    PoolConnOptions opts;
+    opts.connect_timeout = 10;
+    opts.read_timeout = 30;
+    std::string err;
+    m_primary = pool_acquire(m_host, m_port, m_user, m_password, opts, &err);
+    if (!m_primary) {
+      fprintf(stderr, "[Inception] Load sampler cannot connect to %s:%u: %s\n",
+              m_host.c_str(), m_port, err.c_str());
+      fflush(stderr);
+    }
+    for (auto &sh : m_slave_hosts) {
+      MYSQL *s = pool_acquire(sh.first, sh.second, m_user, m_password, opts,
+                              &err);
+      if (s) {
+        m_slaves.push_back(s);
+      } else {
+        fprintf(stderr, "[Inception] Slave %s:%u connect failed: %s\n",
+                sh.first.c_str(), sh.second, err.c_str());
+        fflush(stderr);
+      }
+    }
+  }
+
+  long checkpoint_age_pct() {
+    unsigned long long age = 0;
+    if ((m_redo_capacity == 0 &&
+         read_redo_capacity(m_primary, &m_redo_capacity)) ||
+        read_checkpoint_age(m_primary, &age))
+      return -1;
+    return static_cast<long>(age * 100 / m_redo_capacity);
+  }
+
+  /**
+   * p99 of the statements the target finished since the previous call,
+   * from the deltas of the global statement latency histogram.
+   */
+  long statement_p99_ms() {
+    if (mysql_real_query(m_primary, remote_sql::SELECT_STATEMENT_HISTOGRAM,
+                         strlen(remote_sql::SELECT_STATEMENT_HISTOGRAM)) != 0)
+      return -1;
+    MYSQL_RES *res = mysql_store_result(m_primary);
+    if (!res) return -1;
+    std::map<unsigned long long, unsigned long long> hist;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+      if (row[0] && row[1])
+        hist[strtoull(row[0], nullptr, 10)] = strtoull(row[1], nullptr, 10);
+    }
+    mysql_free_result(res);
+
+    /* Bucket upper bound (picoseconds) -> statements since last time */
+    std::vector<std::pair<unsigned long long, unsigned long long>> delta;
+    unsigned long long total = 0;
+    const bool first = m_histogram.empty();
+    for (auto &b : hist) {
+      auto it = m_histogram.find(b.first);
+      unsigned long long prev = it == m_histogram.end() ? 0 : it->second;
+      /* A TRUNCATE of the histogram restarts the counts */
+      unsigned long long d = b.second >= prev ? b.second - prev : b.second;
+      if (d == 0) continue;
+      delta.emplace_back(b.first, d);
+      total += d;
+    }
+    m_histogram.swap(hist);
+    if (first || total < P99_MIN_STATEMENTS) return -1;
+
+    const unsigned long long rank = (total * 99 + 99) / 100;
+    unsigned long long seen = 0;
+    for (auto &b : delta) {
+      seen += b.second;
+      if (seen >= rank) return static_cast<long>(b.first / 1000000000ULL);
+    }
+    return -1;
+  }
+
+  /** Reads the metrics whose ceiling is set now; the rest stay unknown. */
+  void sample_once() {
+    const auto start = std::chrono::steady_clock::now();
+    long running = -1;
+    ulong value = 0;
+    if (opt_exec_max_threads_running > 0 && m_primary &&
+        !read_threads_running(m_primary, &value))
+      running = static_cast<long>(value);
+
+    long long history = -1;  /* stays -1 on error */
+    if (opt_exec_max_history_list_length > 0 && m_primary)
+      read_history_length(m_primary, &history);
+
+    long checkpoint = -1;
+    if (opt_exec_max_checkpoint_age_pct > 0 && m_primary)
+      checkpoint = checkpoint_age_pct();
+
+    long p99 = -1;
+    if (opt_exec_max_statement_p99_ms > 0 && m_primary)
+      p99 = statement_p99_ms();
+
+    if (m_primary && (running >= 0 || history >= 0 || checkpoint >= 0 ||
+                      p99 >= 0))
+      record_remote_latency(m_primary, REMOTE_THROTTLE_POLL, start);
+
+    long worst = -1;
+    bool stopped = false;
+    if (opt_exec_max_replication_delay > 0) {
+      for (auto *s : m_slaves) {
+        long lag = 0;
+        const auto poll_start = std::chrono::steady_clock::now();
+        const bool failed = read_replica_lag(s, &lag);
+        record_remote_latency(s, REMOTE_THROTTLE_POLL, poll_start);
+        if (failed) continue;
+        if (lag < 0) {
+          stopped = true;
+          continue;
+        }
+        worst = std::max(worst, lag);
+      }
+    }
+
+    m_threads_running.store(running);
+    m_history_length.store(history);
+    m_checkpoint_age_pct.store(checkpoint);
+    m_p99_ms.store(p99);
+    m_repl_lag_ms.store(worst);
+    m_repl_stopped.store(stopped);
+    m_sampled_at.store(steady_ms());
+  }
+
+  void run() {
+    const bool thread_ok = !my_thread_init();
+    if (thread_ok) {
+      bind_worker_resource_group();
+      connect();
+      sample_once();
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_sampled = true;
+    m_cond.notify_all();
+    while (thread_ok && !m_stop) {
+      m_cond.wait_for(lock, std::chrono::milliseconds(interval_ms()),
+                      [this] { return m_stop; });
+      if (m_stop) break;
+      lock.unlock();
+      sample_once();
+      lock.lock();
+    }
+    lock.unlock();
+
+    /* Only inception's own status queries ran on them */
+    if (m_primary) pool_release(m_primary, PoolRelease::CLEAN);
+    for (auto *s : m_slaves) pool_release(s, PoolRelease::CLEAN);
+    if (thread_ok) my_thread_end();
+  }
+
+  const std::string m_host;
+  const unsigned int m_port;
+  const std::string m_user;
+  const std::string m_password;
+  const std::vector<std::pair<std::string, unsigned int>> m_slave_hosts;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop = false;
+  bool m_sampled = false;  /* first sample attempted */
+
+  std::atomic<long> m_threads_running{-1};
+  std::atomic<long> m_repl_lag_ms{-1};
+  std::atomic<bool> m_repl_stopped{false};
+  std::atomic<long long> m_history_length{-1};
+  std::atomic<long> m_checkpoint_age_pct{-1};
+  std::atomic<long> m_p99_ms{-1};
+  std::atomic<int64_t> m_sampled_at{0};  /* steady ms, 0 = never */
+
+  /* Used by the sampler thread only */
+  MYSQL *m_primary = nullptr;
+  std::vector<MYSQL *> m_slaves;
+  unsigned long long m_redo_capacity = 0;  /* 0 = not read yet */
+  std::map<unsigned long long, unsigned long long> m_histogram;
+};
+
+static InceptionMutex g_load_mutex("load_samplers");
+static std::map<std::string, TargetSampler *> g_samplers;
+
+static std::string lower(std::string s) {
+  for (auto &c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return s;
+}
+
+/** Batches share a sampler only with the same servers and user. */
+static std::string sampler_key(const InceptionContext *ctx) {
+  std::vector<std::string> slaves;
+  for (auto &sh : ctx->slave_hosts)
+    slaves.push_back(lower(sh.first) + ":" + std::to_string(sh.second));
+  std::sort(slaves.begin(), slaves.end());
+  std::string key = ctx->user + "@" + lower(ctx->host) + ":" +
+                    std::to_string(ctx->port);
+  for (auto &s : slaves) key += "," + s;
+  return key;
+}
+
+LoadWatch::LoadWatch(InceptionContext *ctx) {
+  const bool watch_delay =
+      opt_exec_max_replication_delay > 0 && !ctx->slave_hosts.empty();
+  if (opt_exec_max_threads_running == 0 && !watch_delay &&
+      opt_exec_max_history_list_length == 0 &&
+      opt_exec_max_checkpoint_age_pct == 0 &&
+      opt_exec_max_statement_p99_ms == 0)
+    return;
+
+  m_key = sampler_key(ctx);
+  {
+    std::lock_guard<InceptionMutex> lock(g_load_mutex);
+    TargetSampler *&sampler = g_samplers[m_key];
+    if (!sampler) {
+      sampler = new TargetSampler(ctx);
+      sampler->start();
+    }
+    sampler->refs++;
+    m_sampler = sampler;
+  }
+  /* Returns at once when the sampler was already running */
+  m_sampler->wait_first_sample();
+}
+
+LoadWatch::~LoadWatch() {
+  if (!m_sampler) return;
+  {
+    std::lock_guard<InceptionMutex> lock(g_load_mutex);
+    if (--m_sampler->refs > 0) return;
+    g_samplers.erase(m_key);
+  }
+  /* Outside the lock: a new batch on the same target starts a new one */
+  m_sampler->stop();
+  delete m_sampler;
+}
+
+LoadSample LoadWatch::sample() const {
+  return m_sampler ? m_sampler->sample() : LoadSample();
+}
+
+uint64_t LoadWatch::interval_ms() const {
+  return m_sampler ? m_sampler->interval_ms()
+                   : opt_exec_load_sample_interval_ms;
+}
+
+/** Fold one signal into the running maximum. */
+static void pressure_of(double value, ulong ceiling, const char *name,
+                        double *worst, const char **signal) {
+  if (ceiling == 0 || value < 0) return;
+  double p = value / static_cast<double>(ceiling);
+  if (p > *worst) {
+    *worst = p;
+    *signal = name;
+  }
+}
+
+double load_pressure(const LoadSample &s, const char **signal) {
+  double worst = 0;
+  *signal = nullptr;
+  if (!s.fresh) return 0;
+  pressure_of(static_cast<double>(s.threads_running),
+              opt_exec_max_threads_running, "Threads_running", &worst, signal);
+  pressure_of(s.repl_lag_ms < 0 ? -1 : s.repl_lag_ms / 1000.0,
+              opt_exec_max_replication_delay, "replication delay", &worst,
+              signal);
+  pressure_of(static_cast<double>(s.history_length),
+              opt_exec_max_history_list_length, "history list length",
+              &worst, signal);
+  pressure_of(static_cast<double>(s.checkpoint_age_pct),
+              opt_exec_max_checkpoint_age_pct, "checkpoint age", &worst,
+              signal);
+  pressure_of(static_cast<double>(s.p99_ms), opt_exec_max_statement_p99_ms,
+              "statement p99", &worst, signal);
+  return worst;
+}
+
+uint64_t LoadWatch::pace_ms(const LoadSample &s) {
+  if (!s.fresh || s.sampled_at == m_paced_sample) return m_pace_ms;
+  m_paced_sample = s.sampled_at;
+
+  const char *signal = nullptr;
+  const double pressure = load_pressure(s, &signal);
+  const uint64_t before = m_pace_ms;
+  if (pressure >= 1.0) {
+    /* Multiplicative back-off */
+    m_pace_ms = std::min<uint64_t>(
+        std::max(m_pace_ms * 2, ADAPTIVE_MIN_BACKOFF_MS),
+        opt_exec_adaptive_max_pause_ms);
+  } else if (pressure < ADAPTIVE_LOW_PRESSURE && m_pace_ms > 0) {
+    /* Additive speed-up */
+    uint64_t step = std::max(m_pace_ms / 8, ADAPTIVE_STEP_MS);
+    m_pace_ms = m_pace_ms > step ? m_pace_ms - step : 0;
+  }
+  if (m_pace_ms > before) {
+    fprintf(stderr, "[Inception] Throttle: %s at %.0f%% of its ceiling, "
+            "pausing %llums per statement.\n", signal, pressure * 100,
+            static_cast<unsigned long long>(m_pace_ms));
+    fflush(stderr);
+  } else if (before > 0 && m_pace_ms == 0) {
+    fprintf(stderr, "[Inception] Throttle: load below ceilings, full speed.\n");
+    fflush(stderr);
+  }
+  return m_pace_ms;
+}
+
+}  // namespace inception
@@ -0,0 +1,102 @@
+/**
+ * @file inception_load.h
+ * @brief Shared target load sampler behind the between-statement throttle.
+ *
+ * The inception_exec_max_threads_running / inception_exec_max_replication_delay
+ * / inception_exec_max_history_list_length throttle used to query the
+ * primary and every --slave-hosts replica itself before each statement,
+ * so twenty sessions on one target meant twenty pollers on each replica.
+ * Now all EXECUTE batches with the same target, user and replica list
+ * share one sampler thread. It owns pooled connections to those servers,
+ * samples Threads_running, replica lag (see inception_heartbeat.h) and the
+ * InnoDB history list length every inception_exec_load_sample_interval_ms,
+ * and publishes them through atomics; the throttle only reads them.
+ *
+ * The sampler starts with its first subscriber and stops with its last.
+ * A metric that could not be read, or a sample older than a few intervals,
+ * counts as unknown and does not hold execution, as a failed query did
+ * before.
+ *
+ * Two more signals, redo checkpoint age (percent of the redo log capacity)
+ * and the p99 latency of the statements the target finished since the
+ * previous sample (performance_schema.events_statements_histogram_global),
+ * are sampled once their ceilings are set.
+ *
+ * By default every ceiling is a threshold: execution waits while one is
+ * crossed. With inception_exec_adaptive_throttle=ON the ceilings become
+ * set points of an AIMD controller instead. Each new sample gives a
+ * pressure, the highest load / ceiling ratio over the set signals, and the
+ * batch paces itself with a pause before every statement and chunk: the
+ * pause doubles (at least ADAPTIVE_MIN_BACKOFF_MS, at most
+ * inception_exec_adaptive_max_pause_ms) while the pressure is at or above
+ * 1, and shrinks by an eighth (at least ADAPTIVE_STEP_MS) once it falls
+ * below ADAPTIVE_LOW_PRESSURE, so a batch settles at the highest rate the
+ * target sustains instead of alternating full speed and stalls. Stopped
+ * replication still stops execution outright.
+ */
+
+#ifndef SQL_INCEPTION_LOAD_H
+#define SQL_INCEPTION_LOAD_H
+
+#include <cstdint>
+#include <string>
+
+namespace inception {
+
+struct InceptionContext;
+class TargetSampler;
+
+/** What the throttle needs from the last sample. */
+struct LoadSample {
+  bool fresh = false;             /* false: everything below is unknown */
+  long threads_running = -1;      /* -1 = unknown */
+  long repl_lag_ms = -1;          /* max over the replicas, -1 = unknown */
+  bool repl_stopped = false;      /* a replica has Seconds_Behind_Master NULL */
+  long long history_length = -1;  /* -1 = unknown */
+  long checkpoint_age_pct = -1;   /* -1 = unknown */
+  long p99_ms = -1;               /* -1 = unknown or too few statements */
+  int64_t sampled_at = 0;         /* identifies the sample */
+};
+
+/**
+ * Highest load / ceiling ratio over the signals whose ceiling is set and
+ * value is known, 0 if none. *signal names it (nullptr when 0).
+ */
+double load_pressure(const LoadSample &s, const char **signal);
+
+/** A batch's subscription to the sampler of its target. */
+class LoadWatch {
+ public:
+  /**
+   * Subscribes when any throttle ceiling is set, starting the sampler if
+   * this is its first subscriber and waiting for its first sample.
+   */
+  explicit LoadWatch(InceptionContext *ctx);
+  ~LoadWatch();
+  LoadWatch(const LoadWatch &) = delete;
+  LoadWatch &operator=(const LoadWatch &) = delete;
+
+  bool active() const { return m_sampler != nullptr; }
+
+  /** Latest published values; not fresh when inactive. */
+  LoadSample sample() const;
+
+  /** Milliseconds between two samples, for waiters. */
+  uint64_t interval_ms() const;
+
+  /**
+   * Adaptive throttle: the pause before the next statement, updated once
+   * per new sample in s.
+   */
+  uint64_t pace_ms(const LoadSample &s);
+
+ private:
+  std::string m_key;
+  TargetSampler *m_sampler = nullptr;
+  uint64_t m_pace_ms = 0;
+  int64_t m_paced_sample = 0;  /* sampled_at of the last sample applied */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_LOAD_H
@@ -3,69 +3,108 @@
  * @brief Inception operation audit log — JSONL format.
  *
  * Writes one JSON object per line (JSONL) to the file specified by
- * inception_audit_log. Uses fprintf + fflush for crash safety.
+ * inception_audit_log. Session threads only format the line and append it
+ * to an in-memory queue; a dedicated writer thread drains the queue in
+ * batches, so executing statements never wait on the log device.
  *
  * Session log example:
  *   {"time":"2026-02-13T12:00:00","type":"session","user":"dba",
  *    "client_host":"10.0.0.1","target":"192.168.1.1:3306",
  *    "target_user":"root","mode":"EXECUTE","statements":5,
- *    "errors":0,"duration_ms":1234}
+ *    "errors":0,"duration_ms":1234,"prefetch_tables":120,
+ *    "prefetch_ms":85,"audit_memo_hits":9990,"audit_cache_hits":0,
+ *    "rule_stats":{"column":{"calls":40,"us":310,"remote_queries":0,
+ *    "violations":2},"metadata":{...}}}
+ *
+ * rule_stats lists the audit rules that ran in the session (see
+ * "inception show rule_stats"); us is their exclusive wall time.
  *
  * Statement log example:
  *   {"time":"2026-02-13T12:00:01","type":"statement","user":"dba",
  *    "client_host":"10.0.0.1","target":"192.168.1.1:3306",
  *    "id":1,"sql":"CREATE TABLE ...","result":"OK",
- *    "affected_rows":0,"execute_time":"0.050"}
+ *    "affected_rows":0,"execute_time":"0.050","audit_cpu_us":120,
+ *    "metadata_us":900,"throttle_wait_us":0,"execute_us":50012,
+ *    "warnings_us":0,"backup_us":0,"round_trips":2,"server_us":48730,
+ *    "lock_us":210,"rows_examined":0}
+ *
+ * The *_us fields break down where the statement's time went: CPU of its
+ * audit, the metadata and EXPLAIN queries sent for it, load throttle
+ * waits, its execution, SHOW WARNINGS after it and its backup (binlog
+ * backup time is shared out by changed rows); round_trips counts those
+ * queries and its executions. server_us, lock_us and rows_examined are the
+ * target's own account of the execution (--enable-server-timing), present
+ * only when captured: execute_us - server_us is network and queueing.
  */
 
 #include "sql/inception/inception_log.h"
 
+#include "sql/inception/inception_audit.h"  // audit_rule_name
 #include "sql/inception/inception_context.h"
+#include "sql/inception/inception_json.h"
+#include "sql/inception/inception_log_sink.h"
+#include "sql/inception/inception_resgroup.h"
 #include "sql/inception/inception_sysvars.h"
 #include "sql/sql_class.h"  // THD, Security_context
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <ctime>
 #include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 namespace inception {
 
-static FILE *g_log_fp = nullptr;
-static std::string g_log_path;
-static std::mutex g_log_mutex;
-
-/** Escape a string for JSON output. */
-static std::string json_escape(const char *s, size_t max_len = 0) {
-  if (!s) return "";
-  std::string out;
-  out.reserve(128);
-  size_t count = 0;
-  for (const char *p = s; *p; p++) {
-    if (max_len > 0 && ++count > max_len) {
-      out += "...";
-      break;
-    }
-    switch (*p) {
-      case '"':  out += "\\\""; break;
-      case '\\': out += "\\\\"; break;
-      case '\n': out += "\\n";  break;
-      case '\r': out += "\\r";  break;
-      case '\t': out += "\\t";  break;
-      default:
-        if (static_cast<unsigned char>(*p) < 0x20) {
-          char buf[8];
-          snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(*p));
-          out += buf;
-        } else {
-          out += *p;
-        }
-        break;
-    }
-  }
-  return out;
-}
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+/**
+ * Queue shared by producers and the writer thread. Producers hold the
+ * mutex only to move one pre-formatted line in; the writer swaps the whole
+ * batch out and does all file I/O without it.
+ *
+ * Allocated once and never freed, so the writer thread may outlive static
+ * destructors if the server exits without audit_log_shutdown().
+ */
+struct LogQueue {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::vector<std::string> lines;
+  uint64_t queued_bytes = 0;
+  bool stop = false;
+  std::thread writer;
+
+  /* Counters, protected by mutex */
+  uint64_t written = 0;
+  uint64_t dropped = 0;
+  uint64_t rotations = 0;
+  uint64_t syncs = 0;
+  std::string path;  /* file the writer currently has open */
+};
+
+/* File state, touched by the writer thread only. */
+struct LogFile {
+  FILE *fp = nullptr;
+  std::string path;
+  uint64_t size = 0;
+  time_t opened_at = 0;
+  Clock::time_point last_sync;
+  bool dirty = false;  /* written since last fsync */
+};
+
+LogQueue *g_queue = nullptr;
+std::once_flag g_queue_once;
+
+}  // namespace
 
 /** Get current time as ISO 8601 string. */
 static std::string now_iso8601() {
@@ -88,103 +127,354 @@ static const char *mode_name(OpMode mode) {
   }
 }
 
-void audit_log_open() {
-  std::lock_guard<std::mutex> lock(g_log_mutex);
-  if (!opt_audit_log || opt_audit_log[0] == '\0') {
-    /* disabled — close if previously open */
-    if (g_log_fp) { fclose(g_log_fp); g_log_fp = nullptr; g_log_path.clear(); }
-    return;
+/* ---- Writer thread ---- */
+
+static void log_file_close(LogFile *lf) {
+  if (!lf->fp) return;
+  fflush(lf->fp);
+  if (lf->dirty && opt_audit_log_sync_interval > 0) fsync(fileno(lf->fp));
+  fclose(lf->fp);
+  lf->fp = nullptr;
+  lf->path.clear();
+  lf->dirty = false;
+}
+
+static bool log_file_open(LogFile *lf, const std::string &path) {
+  lf->fp = fopen(path.c_str(), "a");
+  if (!lf->fp) {
+    fprintf(stderr, "[Inception] WARNING: Cannot open audit log '%s': %s\n",
+            path.c_str(), strerror(errno));
+    fflush(stderr);
+    return false;
   }
+  struct stat st;
+  lf->size = (fstat(fileno(lf->fp), &st) == 0) ? st.st_size : 0;
+  lf->path = path;
+  lf->opened_at = time(nullptr);
+  lf->last_sync = Clock::now();
+  return true;
+}
 
-  /* Reopen if path changed */
-  if (g_log_fp && g_log_path != opt_audit_log) {
-    fclose(g_log_fp);
-    g_log_fp = nullptr;
-    g_log_path.clear();
+/**
+ * Rename the current file to "<path>.<YYYYmmdd-HHMMSS>[.N]" and start a new
+ * one at the same path.
+ */
+static bool log_file_rotate(LogFile *lf) {
+  std::string path = lf->path;
+  log_file_close(lf);
+
+  time_t t = time(nullptr);
+  struct tm tm_buf;
+  localtime_r(&t, &tm_buf);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm_buf);
+  std::string rotated = path + "." + stamp;
+  struct stat st;
+  for (int n = 1; stat(rotated.c_str(), &st) == 0; n++)
+    rotated = path + "." + stamp + "." + std::to_string(n);
+
+  if (rename(path.c_str(), rotated.c_str()) != 0) {
+    fprintf(stderr, "[Inception] WARNING: Cannot rotate audit log '%s': %s\n",
+            path.c_str(), strerror(errno));
+    fflush(stderr);
   }
+  return log_file_open(lf, path);
+}
 
-  if (g_log_fp) return;  /* already open with same path */
+static bool rotation_due(const LogFile &lf) {
+  if (lf.size == 0) return false;
+  if (opt_audit_log_rotate_size > 0 && lf.size >= opt_audit_log_rotate_size)
+    return true;
+  return opt_audit_log_rotate_interval > 0 &&
+         time(nullptr) - lf.opened_at >=
+             static_cast<time_t>(opt_audit_log_rotate_interval);
+}
 
-  g_log_fp = fopen(opt_audit_log, "a");
-  if (g_log_fp) {
-    g_log_path = opt_audit_log;
-  } else {
-    fprintf(stderr, "[Inception] WARNING: Cannot open audit log '%s': %s\n",
-            opt_audit_log, strerror(errno));
+static void writer_main(LogQueue *q) {
+  bind_worker_resource_group();
+  LogFile lf;
+  std::vector<std::string> batch;
+
+  for (;;) {
+    bool stop;
+    {
+      std::unique_lock<std::mutex> lock(q->mutex);
+      /* Wake at least once a second for group fsync and time rotation. */
+      auto wait = std::chrono::milliseconds(
+          opt_audit_log_sync_interval > 0 && opt_audit_log_sync_interval < 1000
+              ? opt_audit_log_sync_interval
+              : 1000);
+      q->cond.wait_for(lock, wait,
+                       [q] { return q->stop || !q->lines.empty(); });
+      batch.swap(q->lines);
+      q->queued_bytes = 0;
+      stop = q->stop;
+    }
+
+    /* Follow SET GLOBAL inception_audit_log (empty = closed). */
+    std::string path =
+        (opt_audit_log && opt_audit_log[0] != '\0') ? opt_audit_log : "";
+    if (lf.fp && lf.path != path) log_file_close(&lf);
+    if (!lf.fp && !path.empty() && !batch.empty()) log_file_open(&lf, path);
+
+    uint64_t written = 0, rotations = 0, syncs = 0;
+    if (lf.fp) {
+      if (rotation_due(lf) && log_file_rotate(&lf)) rotations++;
+      for (const auto &line : batch) {
+        if (!lf.fp) break;
+        if (fwrite(line.data(), 1, line.size(), lf.fp) != line.size()) break;
+        lf.size += line.size();
+        lf.dirty = true;
+        written++;
+        if (opt_audit_log_rotate_size > 0 &&
+            lf.size >= opt_audit_log_rotate_size && log_file_rotate(&lf))
+          rotations++;
+      }
+      if (lf.fp) {
+        fflush(lf.fp);
+        /* Group fsync: one per interval, not one per line. */
+        auto now = Clock::now();
+        if (lf.dirty && opt_audit_log_sync_interval > 0 &&
+            now - lf.last_sync >=
+                std::chrono::milliseconds(opt_audit_log_sync_interval)) {
+          fsync(fileno(lf.fp));
+          lf.last_sync = now;
+          lf.dirty = false;
+          syncs++;
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(q->mutex);
+      q->written += written;
+      q->dropped += batch.size() - written;
+      q->rotations += rotations;
+      q->syncs += syncs;
+      q->path = lf.path;
+    }
+    batch.clear();
+    if (stop) break;
+  }
+  log_file_close(&lf);
+}
+
+static LogQueue *log_queue() {
+  std::call_once(g_queue_once, [] {
+    g_queue = new LogQueue;
+    g_queue->writer = std::thread(writer_main, g_queue);
+  });
+  return g_queue;
+}
+
+/**
+ * Hand one formatted line to the writer. Never blocks on I/O; when more
+ * than inception_audit_log_buffer_size bytes are already waiting the line
+ * is dropped and counted.
+ */
+static void log_enqueue(std::string line) {
+  if (audit_sink_enabled()) audit_sink_enqueue(line);
+  if (!opt_audit_log || opt_audit_log[0] == '\0') return;
+
+  LogQueue *q = log_queue();
+  bool first_drop = false;
+  {
+    std::lock_guard<std::mutex> lock(q->mutex);
+    if (q->stop) return;
+    if (q->queued_bytes + line.size() > opt_audit_log_buffer_size) {
+      first_drop = (q->dropped++ == 0);
+    } else {
+      q->queued_bytes += line.size();
+      q->lines.push_back(std::move(line));
+    }
+  }
+  if (first_drop) {
+    fprintf(stderr,
+            "[Inception] WARNING: Audit log buffer full, dropping records "
+            "(see inception show audit_log).\n");
+    fflush(stderr);
   }
+  q->cond.notify_one();
+}
+
+/** The file or the sink wants the records. */
+static bool audit_log_enabled() {
+  return (opt_audit_log && opt_audit_log[0] != '\0') || audit_sink_enabled();
 }
 
 void audit_log_session(THD *thd, InceptionContext *ctx,
                        int statements, int errors, int64_t duration_ms) {
-  /* Open / reopen / close based on current opt_audit_log */
-  audit_log_open();
-  if (!g_log_fp) return;
+  if (!audit_log_enabled()) return;
 
-  /* Extract user info from THD security context */
-  const char *user = thd->security_context()->user().str;
-  const char *client_host = thd->security_context()->host_or_ip().str;
+  /* Extract user info from THD security context (background jobs have
+     no THD; they carry the submitting client's) */
+  const char *user = thd ? thd->security_context()->user().str
+                         : ctx->client_user.c_str();
+  const char *client_host = thd ? thd->security_context()->host_or_ip().str
+                                : ctx->client_host.c_str();
 
   /* Build target string: host:port */
   char target[256];
   snprintf(target, sizeof(target), "%s:%u",
            ctx->host.empty() ? "127.0.0.1" : ctx->host.c_str(), ctx->port);
 
-  std::string time_str = now_iso8601();
-
-  std::lock_guard<std::mutex> lock(g_log_mutex);
-  fprintf(g_log_fp,
-      "{\"time\":\"%s\",\"type\":\"session\","
-      "\"user\":\"%s\",\"client_host\":\"%s\","
-      "\"target\":\"%s\",\"target_user\":\"%s\","
-      "\"mode\":\"%s\",\"statements\":%d,"
-      "\"errors\":%d,\"duration_ms\":%lld}\n",
-      time_str.c_str(),
-      json_escape(user ? user : "").c_str(),
-      json_escape(client_host ? client_host : "").c_str(),
-      json_escape(target).c_str(),
-      json_escape(ctx->user.c_str()).c_str(),
-      mode_name(ctx->mode),
-      statements, errors,
-      static_cast<long long>(duration_ms));
-  fflush(g_log_fp);
-}
+  std::string line;
+  line.reserve(512 + 96 * RULE_COUNT);
+  JsonWriter w(&line);
+  w.begin_object();
+  w.key("time");
+  w.value(now_iso8601());
+  w.key("type");
+  w.value("session", 7);
+  w.key("user");
+  w.value(user);
+  w.key("client_host");
+  w.value(client_host);
+  w.key("target");
+  w.value(target);
+  w.key("target_user");
+  w.value(ctx->user);
+  w.key("mode");
+  w.value(mode_name(ctx->mode));
+  w.key("statements");
+  w.value_int(statements);
+  w.key("errors");
+  w.value_int(errors);
+  w.key("duration_ms");
+  w.value_int(duration_ms);
+  w.key("prefetch_tables");
+  w.value_int(ctx->prefetch_tables.load());
+  w.key("prefetch_ms");
+  w.value_int(ctx->prefetch_ms.load());
+  w.key("audit_memo_hits");
+  w.value_uint(ctx->audit_memo_hits);
+  w.key("audit_cache_hits");
+  w.value_uint(ctx->audit_cache_hits);
 
-void audit_log_statement(THD *thd, InceptionContext *ctx,
-                         const SqlCacheNode *node) {
-  /* Open / reopen / close based on current opt_audit_log */
-  audit_log_open();
-  if (!g_log_fp) return;
-
-  const char *user = thd->security_context()->user().str;
-  const char *client_host = thd->security_context()->host_or_ip().str;
+  w.key("rule_stats");
+  w.begin_object();
+  for (int i = 0; i < RULE_COUNT; i++) {
+    const RuleStat &st = ctx->rule_stats[i];
+    if (st.calls == 0) continue;
+    w.key(audit_rule_name(i));
+    w.begin_object();
+    w.key("calls");
+    w.value_uint(st.calls);
+    w.key("us");
+    w.value_uint(st.time_ns / 1000);
+    w.key("remote_queries");
+    w.value_uint(st.remote_queries);
+    w.key("violations");
+    w.value_uint(st.violations);
+    w.end_object();
+  }
+  w.end_object();
+  w.end_object();
+  line.push_back('\n');
+  log_enqueue(std::move(line));
+}
 
+std::string audit_log_statement_line(const char *user,
+                                     const char *client_host,
+                                     const InceptionContext *ctx,
+                                     const SqlCacheNode *node) {
   char target[256];
   snprintf(target, sizeof(target), "%s:%u",
            ctx->host.empty() ? "127.0.0.1" : ctx->host.c_str(), ctx->port);
 
   const char *result = (node->errlevel >= ERRLEVEL_ERROR) ? "ERROR" : "OK";
-  std::string time_str = now_iso8601();
-
-  /* Truncate SQL to 4096 chars in log */
-  std::string sql_escaped = json_escape(node->sql_text.c_str(), 4096);
-
-  std::lock_guard<std::mutex> lock(g_log_mutex);
-  fprintf(g_log_fp,
-      "{\"time\":\"%s\",\"type\":\"statement\","
-      "\"user\":\"%s\",\"client_host\":\"%s\","
-      "\"target\":\"%s\",\"id\":%d,"
-      "\"sql\":\"%s\",\"result\":\"%s\","
-      "\"affected_rows\":%lld,\"execute_time\":\"%s\"}\n",
-      time_str.c_str(),
-      json_escape(user ? user : "").c_str(),
-      json_escape(client_host ? client_host : "").c_str(),
-      json_escape(target).c_str(),
-      node->id,
-      sql_escaped.c_str(),
-      result,
-      static_cast<long long>(node->affected_rows),
-      node->execute_time.c_str());
-  fflush(g_log_fp);
+
+  /* SQL truncated to 4096 bytes in the log */
+  const size_t max_sql = 4096;
+  std::string line;
+  line.reserve(256 + std::min(node->sql_text.size(), max_sql) * 5 / 4);
+  JsonWriter w(&line);
+  w.begin_object();
+  w.key("time");
+  w.value(now_iso8601());
+  w.key("type");
+  w.value("statement", 9);
+  w.key("user");
+  w.value(user);
+  w.key("client_host");
+  w.value(client_host);
+  w.key("target");
+  w.value(target);
+  w.key("id");
+  w.value_int(node->id);
+  w.key("sql");
+  w.value_truncated(node->sql_text.data(), node->sql_text.size(), max_sql);
+  w.key("result");
+  w.value(result);
+  w.key("affected_rows");
+  w.value_int(node->affected_rows);
+  w.key("execute_time");
+  w.value(node->execute_time_text());
+  w.key("audit_cpu_us");
+  w.value_uint(node->audit_cpu_us);
+  w.key("metadata_us");
+  w.value_uint(node->metadata_us);
+  w.key("throttle_wait_us");
+  w.value_uint(node->throttle_wait_us);
+  w.key("execute_us");
+  w.value_uint(node->execute_seconds < 0
+                   ? 0
+                   : static_cast<uint64_t>(node->execute_seconds * 1e6));
+  w.key("warnings_us");
+  w.value_uint(node->warnings_us);
+  w.key("backup_us");
+  w.value_uint(node->backup_us);
+  w.key("round_trips");
+  w.value_uint(node->round_trips);
+  if (node->server_us >= 0) {
+    w.key("server_us");
+    w.value_int(node->server_us);
+    w.key("lock_us");
+    w.value_int(node->lock_us);
+    w.key("rows_examined");
+    w.value_int(node->rows_examined);
+  }
+  w.end_object();
+  line.push_back('\n');
+  return line;
+}
+
+void audit_log_statement(THD *thd, InceptionContext *ctx,
+                         const SqlCacheNode *node) {
+  if (!audit_log_enabled()) return;
+
+  const char *user = thd ? thd->security_context()->user().str
+                         : ctx->client_user.c_str();
+  const char *client_host = thd ? thd->security_context()->host_or_ip().str
+                                : ctx->client_host.c_str();
+
+  log_enqueue(audit_log_statement_line(user, client_host, ctx, node));
+}
+
+AuditLogStats get_audit_log_stats() {
+  AuditLogStats st;
+  LogQueue *q = log_queue();
+  std::lock_guard<std::mutex> lock(q->mutex);
+  st.path = q->path;
+  st.queued = q->lines.size();
+  st.queued_bytes = q->queued_bytes;
+  st.written = q->written;
+  st.dropped = q->dropped;
+  st.rotations = q->rotations;
+  st.syncs = q->syncs;
+  return st;
+}
+
+void audit_log_shutdown() {
+  audit_sink_shutdown();
+  if (!g_queue) return;
+  {
+    std::lock_guard<std::mutex> lock(g_queue->mutex);
+    if (g_queue->stop) return;
+    g_queue->stop = true;
+  }
+  g_queue->cond.notify_one();
+  if (g_queue->writer.joinable()) g_queue->writer.join();
 }
 
 }  // namespace inception
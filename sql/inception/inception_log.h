@@ -6,12 +6,17 @@
  * Two log levels:
  *   - Session: one line per inception session (commit)
  *   - Statement: one line per SQL execution (EXECUTE mode only)
+ *
+ * Lines are queued in memory and written by a background writer thread
+ * with group fsync and size/time based rotation. When inception_audit_sink
+ * is set they are also shipped to a collector (inception_log_sink.h).
  */
 
 #ifndef SQL_INCEPTION_LOG_H
 #define SQL_INCEPTION_LOG_H
 
 #include <cstdint>
+#include <string>
 
 class THD;
 
@@ -20,18 +25,11 @@ namespace inception {
 struct InceptionContext;
 struct SqlCacheNode;
 
-/**
- * Open the audit log file based on opt_audit_log.
- * Called once at session commit time (lazy open).
- * If opt_audit_log is empty/null, logging is disabled.
- */
-void audit_log_open();
-
 /**
  * Write a session-level audit log entry.
  * Called at inception commit, before ctx->reset().
  *
- * @param thd          Current thread
+ * @param thd          Current thread, nullptr for a background job
  * @param ctx          Inception context
  * @param statements   Total number of SQL statements
  * @param errors       Number of statements with errors
@@ -44,13 +42,41 @@ void audit_log_session(THD *thd, InceptionContext *ctx,
  * Write a statement-level audit log entry.
  * Called after each SQL execution in EXECUTE mode.
  *
- * @param thd   Current thread
+ * @param thd   Current thread, nullptr for a background job
  * @param ctx   Inception context
  * @param node  The executed SQL cache node
  */
 void audit_log_statement(THD *thd, InceptionContext *ctx,
                          const SqlCacheNode *node);
 
+/**
+ * The JSON line audit_log_statement() queues for node, which user on
+ * client_host ran through ctx; ends with a newline.
+ */
+std::string audit_log_statement_line(const char *user,
+                                     const char *client_host,
+                                     const InceptionContext *ctx,
+                                     const SqlCacheNode *node);
+
+/** Writer state for "inception show audit_log". */
+struct AuditLogStats {
+  std::string path;       /* file currently open, empty if none */
+  uint64_t queued;        /* lines waiting for the writer */
+  uint64_t queued_bytes;
+  uint64_t written;       /* lines written since startup */
+  uint64_t dropped;       /* lines lost: buffer full or file not writable */
+  uint64_t rotations;
+  uint64_t syncs;         /* group fsync calls */
+};
+
+AuditLogStats get_audit_log_stats();
+
+/**
+ * Drain the queue, close the file and stop the writer and shipper threads.
+ * Called once at server shutdown.
+ */
+void audit_log_shutdown();
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_LOG_H
@@ -0,0 +1,560 @@
+/**
+ * @file inception_log_sink.cc
+ * @brief The audit log shipper thread, its spool file and the HTTP sink.
+ */
+
+#include "sql/inception/inception_log_sink.h"
+
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace inception {
+
+using Clock = std::chrono::steady_clock;
+
+/* Connect, send and receive timeout of one delivery */
+static constexpr int SINK_TIMEOUT_MS = 10000;
+static constexpr auto RETRY_MIN = std::chrono::seconds(1);
+static constexpr auto RETRY_MAX = std::chrono::seconds(30);
+/* A spool batch is cut here even if it has fewer records */
+static constexpr size_t SPOOL_BATCH_BYTES = 4 * 1024 * 1024;
+
+/* ---- HTTP sink ---- */
+
+namespace {
+
+/** gzip (RFC 1952) of in into *out. @return false on a zlib error. */
+bool gzip(const std::string &in, std::string *out) {
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  /* 16 + MAX_WBITS: a gzip header and trailer instead of zlib's */
+  if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+  out->resize(deflateBound(&zs, static_cast<uLong>(in.size())) + 32);
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(in.data()));
+  zs.avail_in = static_cast<uInt>(in.size());
+  zs.next_out = reinterpret_cast<Bytef *>(&(*out)[0]);
+  zs.avail_out = static_cast<uInt>(out->size());
+  const int rc = deflate(&zs, Z_FINISH);
+  out->resize(zs.total_out);
+  deflateEnd(&zs);
+  return rc == Z_STREAM_END;
+}
+
+class HttpSink : public AuditSink {
+ public:
+  HttpSink(std::string host, std::string port, std::string path)
+      : m_host(std::move(host)), m_port(std::move(port)),
+        m_path(std::move(path)) {}
+  ~HttpSink() override { disconnect(); }
+
+  bool deliver(const std::string &records, bool compress,
+               std::string *err) override {
+    std::string compressed;
+    if (compress && !gzip(records, &compressed)) compress = false;
+    const std::string &body = compress ? compressed : records;
+
+    std::string request = "POST " + m_path + " HTTP/1.1\r\nHost: " + m_host +
+                          "\r\nContent-Type: application/x-ndjson\r\n";
+    if (compress) request += "Content-Encoding: gzip\r\n";
+    request += "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+
+    /* A kept-alive connection the collector closed fails on first use */
+    const bool reused = m_fd >= 0;
+    if (exchange(request, body, err)) return true;
+    return reused && exchange(request, body, err);
+  }
+
+ private:
+  bool exchange(const std::string &head, const std::string &body,
+                std::string *err) {
+    if (m_fd < 0 && !connect_sink(err)) return false;
+    int status = 0;
+    if (!send_all(head) || !send_all(body)) {
+      *err = std::string("send failed: ") + strerror(errno);
+    } else if (read_response(&status, err)) {
+      if (status >= 200 && status < 300) return true;
+      *err = "HTTP status " + std::to_string(status);
+      return false;
+    }
+    disconnect();
+    return false;
+  }
+
+  bool connect_sink(std::string *err) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *res = nullptr;
+    const int rc = getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &res);
+    if (rc != 0) {
+      *err = "cannot resolve " + m_host + ": " + gai_strerror(rc);
+      return false;
+    }
+    *err = "cannot connect to " + m_host + ":" + m_port;
+    for (struct addrinfo *ai = res; ai && m_fd < 0; ai = ai->ai_next) {
+      int fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+      if (fd < 0) continue;
+      if (connect_timed(fd, ai->ai_addr, ai->ai_addrlen)) {
+        m_fd = fd;
+      } else {
+        close(fd);
+      }
+    }
+    freeaddrinfo(res);
+    if (m_fd < 0) return false;
+    struct timeval tv = {SINK_TIMEOUT_MS / 1000, 0};
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(m_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    return true;
+  }
+
+  static bool connect_timed(int fd, const struct sockaddr *addr,
+                            socklen_t len) {
+    const int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int rc = connect(fd, addr, len);
+    if (rc != 0 && errno == EINPROGRESS) {
+      struct pollfd pfd = {fd, POLLOUT, 0};
+      int soerr = 0;
+      socklen_t soerr_len = sizeof(soerr);
+      rc = (poll(&pfd, 1, SINK_TIMEOUT_MS) == 1 &&
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &soerr, &soerr_len) == 0 &&
+            soerr == 0)
+               ? 0
+               : -1;
+    }
+    fcntl(fd, F_SETFL, flags);
+    return rc == 0;
+  }
+
+  bool send_all(const std::string &data) {
+    size_t off = 0;
+    while (off < data.size()) {
+      ssize_t n = send(m_fd, data.data() + off, data.size() - off, MSG_NOSIGNAL);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return false;
+      off += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  /**
+   * Read the status line and headers, and the body when it is framed by
+   * Content-Length; any other framing ends the connection after it.
+   */
+  bool read_response(int *status, std::string *err) {
+    std::string buf;
+    size_t header_end;
+    char chunk[4096];
+    while ((header_end = buf.find("\r\n\r\n")) == std::string::npos) {
+      if (buf.size() > 65536) {
+        *err = "response header too long";
+        return false;
+      }
+      ssize_t n = recv(m_fd, chunk, sizeof(chunk), 0);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        *err = n == 0 ? std::string("connection closed by the sink")
+                      : std::string("receive failed: ") + strerror(errno);
+        return false;
+      }
+      buf.append(chunk, static_cast<size_t>(n));
+    }
+    if (buf.compare(0, 5, "HTTP/") != 0 ||
+        sscanf(buf.c_str(), "HTTP/%*s %d", status) != 1) {
+      *err = "malformed HTTP response";
+      return false;
+    }
+
+    long long content_length = -1;
+    bool keep_alive = true;
+    size_t pos = buf.find("\r\n");
+    while (pos < header_end) {
+      const size_t next = buf.find("\r\n", pos + 2);
+      const std::string line = buf.substr(pos + 2, next - pos - 2);
+      pos = next;
+      if (strncasecmp(line.c_str(), "Content-Length:", 15) == 0)
+        content_length = strtoll(line.c_str() + 15, nullptr, 10);
+      else if (strncasecmp(line.c_str(), "Connection:", 11) == 0 &&
+               strcasestr(line.c_str() + 11, "close"))
+        keep_alive = false;
+      else if (strncasecmp(line.c_str(), "Transfer-Encoding:", 18) == 0)
+        keep_alive = false;
+    }
+
+    if (content_length < 0) keep_alive = false;
+    long long left =
+        content_length - static_cast<long long>(buf.size() - header_end - 4);
+    while (keep_alive && left > 0) {
+      ssize_t n = recv(m_fd, chunk,
+                       static_cast<size_t>(std::min<long long>(
+                           left, static_cast<long long>(sizeof(chunk)))),
+                       0);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) keep_alive = false;
+      else left -= n;
+    }
+    if (!keep_alive) disconnect();
+    return true;
+  }
+
+  void disconnect() {
+    if (m_fd >= 0) close(m_fd);
+    m_fd = -1;
+  }
+
+  const std::string m_host;
+  const std::string m_port;
+  const std::string m_path;
+  int m_fd = -1;
+};
+
+}  // namespace
+
+std::unique_ptr<AuditSink> make_audit_sink(const std::string &uri,
+                                           std::string *err) {
+  static const char HTTP[] = "http://";
+  const size_t scheme_len = sizeof(HTTP) - 1;
+  if (uri.size() <= scheme_len ||
+      strncasecmp(uri.c_str(), HTTP, scheme_len) != 0) {
+    *err = "unsupported inception_audit_sink '" + uri +
+           "' (expected http://host[:port]/path)";
+    return nullptr;
+  }
+  const size_t slash = uri.find('/', scheme_len);
+  std::string authority = uri.substr(scheme_len, slash - scheme_len);
+  std::string path = slash == std::string::npos ? "/" : uri.substr(slash);
+  std::string port = "80";
+  /* [v6addr]:port or host:port */
+  size_t colon = authority.rfind(':');
+  if (colon != std::string::npos &&
+      authority.find(']', colon) == std::string::npos) {
+    port = authority.substr(colon + 1);
+    authority.resize(colon);
+  }
+  if (authority.size() > 2 && authority.front() == '[' &&
+      authority.back() == ']')
+    authority = authority.substr(1, authority.size() - 2);
+  if (authority.empty() || port.empty()) {
+    *err = "no host in inception_audit_sink '" + uri + "'";
+    return nullptr;
+  }
+  return std::unique_ptr<AuditSink>(
+      new HttpSink(std::move(authority), std::move(port), std::move(path)));
+}
+
+/* ---- Shipper thread ---- */
+
+namespace {
+
+/**
+ * Records waiting for the shipper. Allocated once and never freed, as the
+ * audit log queue is.
+ */
+struct SinkQueue {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<std::string> lines;
+  uint64_t queued_bytes = 0;
+  bool stop = false;
+  std::thread shipper;
+};
+
+/* Shipper state, touched by the shipper thread only. */
+struct Shipper {
+  std::string uri;  /* sink was made from */
+  std::unique_ptr<AuditSink> sink;
+  std::vector<std::string> batch;  /* taken from memory, not delivered yet */
+  std::string spool;               /* spool file, empty = none */
+  off_t spool_shipped = 0;         /* records before this offset delivered */
+  off_t spool_size = 0;
+  Clock::time_point retry_at;      /* no delivery before, after a failure */
+  Clock::duration backoff = Clock::duration::zero();
+  bool warned = false;             /* failure reported since last success */
+};
+
+SinkQueue *g_sink = nullptr;
+std::once_flag g_sink_once;
+
+}  // namespace
+
+static std::string join_lines(const std::vector<std::string> &lines) {
+  size_t size = 0;
+  for (const auto &l : lines) size += l.size();
+  std::string out;
+  out.reserve(size);
+  for (const auto &l : lines) out += l;
+  return out;
+}
+
+/** Follow SET GLOBAL inception_audit_sink_spool_dir. */
+static void follow_spool_dir(Shipper *sh) {
+  const char *dir = opt_audit_sink_spool_dir;
+  std::string path;
+  if (dir && *dir) {
+    path = dir;
+    if (path.back() != '/') path += '/';
+    path += "inception_audit_sink.spool";
+  }
+  if (path == sh->spool) return;
+  sh->spool = path;
+  sh->spool_shipped = 0;
+  struct stat st;
+  /* Records left by a previous run are shipped first */
+  sh->spool_size = !path.empty() && stat(path.c_str(), &st) == 0 ? st.st_size
+                                                                  : 0;
+}
+
+/** Append lines to the spool file. @return false if it cannot be written. */
+static bool spool_append(Shipper *sh, const std::vector<std::string> &lines) {
+  FILE *fp = fopen(sh->spool.c_str(), "a");
+  if (!fp) {
+    fprintf(stderr, "[Inception] WARNING: Cannot open audit sink spool "
+            "'%s': %s\n", sh->spool.c_str(), strerror(errno));
+    fflush(stderr);
+    status_add(STATUS_AUDIT_SINK_DROPPED, lines.size());
+    return false;
+  }
+  size_t written = 0;
+  for (const auto &line : lines) {
+    if (fwrite(line.data(), 1, line.size(), fp) != line.size()) break;
+    sh->spool_size += static_cast<off_t>(line.size());
+    written++;
+  }
+  fclose(fp);
+  status_add(STATUS_AUDIT_SINK_SPOOLED, written);
+  status_add(STATUS_AUDIT_SINK_DROPPED, lines.size() - written);
+  return written == lines.size();
+}
+
+/**
+ * The next batch_size records of the spool file into *records.
+ * @return records read; 0 if there is none or the file cannot be read.
+ */
+static size_t spool_read(Shipper *sh, std::string *records, off_t *end) {
+  FILE *fp = fopen(sh->spool.c_str(), "r");
+  if (!fp) return 0;
+  size_t count = 0;
+  if (fseeko(fp, sh->spool_shipped, SEEK_SET) == 0) {
+    char *line = nullptr;
+    size_t cap = 0;
+    ssize_t n;
+    while (count < opt_audit_sink_batch_size &&
+           records->size() < SPOOL_BATCH_BYTES &&
+           (n = getline(&line, &cap, fp)) > 0) {
+      /* A record cut by a crash is not shipped half */
+      if (line[n - 1] != '\n') break;
+      records->append(line, static_cast<size_t>(n));
+      count++;
+    }
+    free(line);
+  }
+  fclose(fp);
+  *end = sh->spool_shipped + static_cast<off_t>(records->size());
+  return count;
+}
+
+/** Make or remake the sink of inception_audit_sink. */
+static bool follow_sink(Shipper *sh) {
+  const char *opt = opt_audit_sink;
+  const std::string uri = opt ? opt : "";
+  if (uri != sh->uri) {
+    sh->uri = uri;
+    sh->sink.reset();
+    sh->retry_at = Clock::time_point();
+    sh->backoff = Clock::duration::zero();
+    sh->warned = false;
+    if (uri.empty()) return false;
+    std::string err;
+    sh->sink = make_audit_sink(uri, &err);
+    if (!sh->sink) {
+      fprintf(stderr, "[Inception] WARNING: %s\n", err.c_str());
+      fflush(stderr);
+    }
+  }
+  return sh->sink != nullptr;
+}
+
+static bool deliver(Shipper *sh, const std::string &records, size_t count) {
+  std::string err;
+  if (sh->sink->deliver(records, opt_audit_sink_compress, &err)) {
+    status_add(STATUS_AUDIT_SINK_SHIPPED, count);
+    sh->backoff = Clock::duration::zero();
+    sh->retry_at = Clock::time_point();
+    sh->warned = false;
+    return true;
+  }
+  status_add(STATUS_AUDIT_SINK_RETRIES);
+  sh->backoff = sh->backoff == Clock::duration::zero()
+                    ? Clock::duration(RETRY_MIN)
+                    : std::min<Clock::duration>(sh->backoff * 2, RETRY_MAX);
+  sh->retry_at = Clock::now() + sh->backoff;
+  if (!sh->warned) {
+    fprintf(stderr, "[Inception] WARNING: Audit sink '%s' failed: %s; "
+            "retrying.\n", sh->uri.c_str(), err.c_str());
+    fflush(stderr);
+    sh->warned = true;
+  }
+  return false;
+}
+
+/** Ship the oldest batch of the spool file, emptying it at the end. */
+static void ship_spool(Shipper *sh) {
+  std::string records;
+  off_t end = 0;
+  const size_t count = spool_read(sh, &records, &end);
+  if (count > 0 && !deliver(sh, records, count)) return;
+  sh->spool_shipped = end;
+  /* Nothing after the shipped records (or they cannot be read): start over */
+  if (count == 0 || sh->spool_shipped >= sh->spool_size) {
+    if (truncate(sh->spool.c_str(), 0) != 0 && errno != ENOENT) {
+      fprintf(stderr, "[Inception] WARNING: Cannot empty audit sink spool "
+              "'%s': %s\n", sh->spool.c_str(), strerror(errno));
+      fflush(stderr);
+    }
+    sh->spool_shipped = 0;
+    sh->spool_size = 0;
+  }
+}
+
+static void shipper_main(SinkQueue *q) {
+  bind_worker_resource_group();
+  Shipper sh;
+  std::vector<std::string> spill;
+
+  for (;;) {
+    follow_spool_dir(&sh);
+    const bool ready = follow_sink(&sh);
+    const bool backing_off = Clock::now() < sh.retry_at;
+    const bool can_spool = ready && !sh.spool.empty();
+    bool stop;
+    {
+      std::unique_lock<std::mutex> lock(q->mutex);
+      const bool busy = ready && !backing_off &&
+                        (sh.spool_size > 0 || !sh.batch.empty());
+      /* Wake at least once a second to follow the variables */
+      if (!busy)
+        q->cond.wait_until(
+            lock,
+            backing_off ? std::min(sh.retry_at, Clock::now() + RETRY_MIN)
+                        : Clock::now() + RETRY_MIN,
+            [&] {
+              return q->stop ||
+                     (!q->lines.empty() && (can_spool || !backing_off));
+            });
+      stop = q->stop;
+      /* Behind the spool, with the sink failing or falling behind, newer
+         records go to the spool after the older ones */
+      const bool to_spool =
+          can_spool && (sh.spool_size > 0 || backing_off ||
+                        q->queued_bytes > opt_audit_sink_buffer_size / 2);
+      size_t take = 0;
+      if (to_spool || stop || !ready)
+        take = q->lines.size();
+      else if (sh.batch.empty())
+        take = std::min<size_t>(q->lines.size(), opt_audit_sink_batch_size);
+      std::vector<std::string> &into = to_spool ? spill : sh.batch;
+      for (size_t i = 0; i < take; i++) {
+        q->queued_bytes -= q->lines.front().size();
+        into.push_back(std::move(q->lines.front()));
+        q->lines.pop_front();
+      }
+    }
+
+    if (!ready) {
+      /* Disabled, or not a sink: nothing is shipped */
+      status_add(STATUS_AUDIT_SINK_DROPPED, sh.batch.size());
+      sh.batch.clear();
+      if (stop) break;
+      continue;
+    }
+    if (!spill.empty()) {
+      spool_append(&sh, spill);
+      spill.clear();
+    }
+
+    if (stop) {
+      /* Keep what is left for the next start, or try to deliver it once */
+      if (!sh.batch.empty()) {
+        if (!sh.spool.empty())
+          spool_append(&sh, sh.batch);
+        else if (backing_off ||
+                 !deliver(&sh, join_lines(sh.batch), sh.batch.size()))
+          status_add(STATUS_AUDIT_SINK_DROPPED, sh.batch.size());
+      }
+      break;
+    }
+    if (Clock::now() < sh.retry_at) continue;
+
+    if (sh.spool_size > 0) {
+      ship_spool(&sh);
+    } else if (!sh.batch.empty()) {
+      if (deliver(&sh, join_lines(sh.batch), sh.batch.size()) ||
+          (!sh.spool.empty() && spool_append(&sh, sh.batch)))
+        sh.batch.clear();
+      /* Otherwise the batch is delivered again after the backoff */
+    }
+  }
+}
+
+static SinkQueue *sink_queue() {
+  std::call_once(g_sink_once, [] {
+    g_sink = new SinkQueue;
+    g_sink->shipper = std::thread(shipper_main, g_sink);
+  });
+  return g_sink;
+}
+
+bool audit_sink_enabled() { return opt_audit_sink && opt_audit_sink[0] != '\0'; }
+
+void audit_sink_enqueue(const std::string &line) {
+  SinkQueue *q = sink_queue();
+  {
+    std::lock_guard<std::mutex> lock(q->mutex);
+    if (q->stop) return;
+    if (q->queued_bytes + line.size() > opt_audit_sink_buffer_size) {
+      status_add(STATUS_AUDIT_SINK_DROPPED);
+      return;
+    }
+    q->queued_bytes += line.size();
+    q->lines.push_back(line);
+  }
+  q->cond.notify_one();
+}
+
+void audit_sink_shutdown() {
+  if (!g_sink) return;
+  {
+    std::lock_guard<std::mutex> lock(g_sink->mutex);
+    if (g_sink->stop) return;
+    g_sink->stop = true;
+  }
+  g_sink->cond.notify_one();
+  if (g_sink->shipper.joinable()) g_sink->shipper.join();
+}
+
+}  // namespace inception
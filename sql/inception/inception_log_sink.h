@@ -0,0 +1,67 @@
+/**
+ * @file inception_log_sink.h
+ * @brief Shipping of the audit log records to an external collector
+ *        (inception_audit_sink).
+ *
+ * Besides the local JSONL file, every audit log record can be handed to a
+ * sink. Sessions only append the line to a bounded in-memory queue; a
+ * shipper thread takes up to inception_audit_sink_batch_size records at a
+ * time and delivers them, gzip compressed when inception_audit_sink_compress
+ * is ON. A failed delivery is retried after 1 second, doubling up to 30.
+ *
+ * While the sink is down or slower than the sessions, the shipper moves
+ * the queued records to <inception_audit_sink_spool_dir>/
+ * inception_audit_sink.spool and ships them from there, oldest first, once
+ * the sink accepts them again; the file is emptied when it has been shipped
+ * and is picked up again after a restart. Without a spool directory the
+ * failed batch is kept and records beyond inception_audit_sink_buffer_size
+ * are dropped. Delivery is at least once: a batch whose answer was lost is
+ * sent again.
+ *
+ * Sinks implement AuditSink; make_audit_sink() picks one by the scheme of
+ * inception_audit_sink. "http://host[:port]/path" POSTs the records as
+ * application/x-ndjson over a kept-alive connection.
+ */
+
+#ifndef SQL_INCEPTION_LOG_SINK_H
+#define SQL_INCEPTION_LOG_SINK_H
+
+#include <memory>
+#include <string>
+
+namespace inception {
+
+class AuditSink {
+ public:
+  virtual ~AuditSink() = default;
+
+  /**
+   * Deliver records, JSON lines each ending in a newline.
+   * @return false with *err set if the sink did not accept them.
+   */
+  virtual bool deliver(const std::string &records, bool compress,
+                       std::string *err) = 0;
+};
+
+/** The sink uri names; nullptr with *err set if it names none. */
+std::unique_ptr<AuditSink> make_audit_sink(const std::string &uri,
+                                           std::string *err);
+
+/** True when inception_audit_sink is set. */
+bool audit_sink_enabled();
+
+/**
+ * Queue one formatted audit log line for the sink. Never blocks on I/O;
+ * the line is dropped and counted when the queue is full.
+ */
+void audit_sink_enqueue(const std::string &line);
+
+/**
+ * Ship or spool what is queued and stop the shipper thread.
+ * Called once at server shutdown, from audit_log_shutdown().
+ */
+void audit_sink_shutdown();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_LOG_SINK_H
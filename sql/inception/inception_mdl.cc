@@ -0,0 +1,142 @@
+/**
+ * @file inception_mdl.cc
+ * @brief Metadata-lock aware execution of table DDL.
+ */
+
+#include "sql/inception/inception_mdl.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"  // run_sql, format_sql
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "mysqld_error.h"  // ER_LOCK_WAIT_TIMEOUT
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace inception {
+
+/* Sleep between two attempts: doubles from the first to the second */
+static const uint64_t MDL_MIN_BACKOFF_MS = 1000;
+static const uint64_t MDL_MAX_BACKOFF_MS = 30000;
+
+bool needs_table_mdl(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_DROP_TABLE:
+    case SQLCOM_RENAME_TABLE:
+    case SQLCOM_TRUNCATE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool find_mdl_blockers(MYSQL *mysql, const std::string &db,
+                       const std::string &table, std::string *blockers) {
+  std::string query =
+      format_sql(remote_sql::MDL_BLOCKERS, db.c_str(), table.c_str());
+  if (mysql_real_query(mysql, query.c_str(),
+                       static_cast<unsigned long>(query.length())))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  blockers->clear();
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    char buf[256];
+    snprintf(buf, sizeof(buf), "id %s (%s %s", row[0] ? row[0] : "?",
+             row[1] ? row[1] : "?", row[2] ? row[2] : "?");
+    if (!blockers->empty()) *blockers += "; ";
+    *blockers += buf;
+    if (row[3]) {
+      *blockers += ", trx ";
+      *blockers += row[3];
+      *blockers += "s";
+    }
+    *blockers += ")";
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+bool execute_mdl_guarded(MYSQL *mysql, InceptionContext *ctx,
+                         SqlCacheNode *node,
+                         const std::function<bool()> &attempt) {
+  if (opt_exec_ddl_lock_wait_timeout == 0 || !needs_table_mdl(node->sql_command))
+    return attempt();
+
+  std::string err;
+  const bool timeout_set = !run_sql(
+      mysql,
+      format_sql(remote_sql::MDL_SET_LOCK_WAIT_TIMEOUT,
+                 opt_exec_ddl_lock_wait_timeout),
+      &err);
+  if (!timeout_set) {
+    fprintf(stderr, "[Inception] Cannot set lock_wait_timeout for DDL, using "
+            "the session default: %s\n", err.c_str());
+    fflush(stderr);
+  }
+
+  const ulong attempts = opt_exec_ddl_lock_retries + 1;
+  const int errlevel = node->errlevel;
+  const std::string errmsg = node->errmsg;
+  uint64_t backoff = MDL_MIN_BACKOFF_MS;
+  bool failed = false;
+  for (ulong n = 1;; n++) {
+    std::string blockers;
+    std::string why;
+    if (!node->table_name.empty() &&
+        !find_mdl_blockers(mysql, node->db_name, node->table_name,
+                           &blockers) &&
+        !blockers.empty()) {
+      why = "metadata lock held by " + blockers;
+      if (n == attempts) {
+        node->append_error("DDL not started after %lu attempts, %s.%s has a "
+                           "%s.", attempts, node->db_name.c_str(),
+                           node->table_name.c_str(), why.c_str());
+        node->stage = STAGE_EXECUTED;
+        node->stage_status = "Execute failed";
+        failed = true;
+        break;
+      }
+    } else {
+      failed = attempt();
+      if (!failed || mysql_errno(mysql) != ER_LOCK_WAIT_TIMEOUT) break;
+      if (n == attempts) {
+        node->append_error("Gave up after %lu lock wait timeouts of %lus.",
+                           attempts, opt_exec_ddl_lock_wait_timeout);
+        break;
+      }
+      why = "lock wait timeout";
+      /* Only the error of the last attempt is reported */
+      node->errlevel = errlevel;
+      node->errmsg = errmsg;
+    }
+
+    fprintf(stderr, "[Inception] DDL on %s.%s, attempt %lu/%lu: %s, retrying "
+            "in %llums.\n", node->db_name.c_str(), node->table_name.c_str(),
+            n, attempts, why.c_str(), static_cast<unsigned long long>(backoff));
+    fflush(stderr);
+    if (ctx->sleep_unless_killed(backoff)) {
+      node->append_error("Killed by user while waiting for the metadata lock "
+                         "(%s).", why.c_str());
+      node->stage = STAGE_EXECUTED;
+      node->stage_status = "Killed by user";
+      failed = true;
+      break;
+    }
+    backoff = std::min(backoff * 2, MDL_MAX_BACKOFF_MS);
+  }
+
+  if (timeout_set)
+    run_sql(mysql, remote_sql::MDL_RESET_LOCK_WAIT_TIMEOUT, &err);
+  return failed;
+}
+
+}  // namespace inception
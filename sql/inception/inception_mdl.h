@@ -0,0 +1,67 @@
+/**
+ * @file inception_mdl.h
+ * @brief Metadata-lock aware execution of table DDL.
+ *
+ * An ALTER / DROP / TRUNCATE that waits for the metadata lock of its table
+ * behind a long transaction holds a pending exclusive MDL, and every query
+ * on the table that arrives after it queues too: a one-second DDL turns
+ * into an outage that lasts as long as the transaction. With
+ * inception_exec_ddl_lock_wait_timeout set, such a statement is guarded:
+ *
+ *   1. Pre-flight: sessions holding or waiting for a metadata lock on the
+ *      table are read from performance_schema.metadata_locks, with their
+ *      transaction age from information_schema.innodb_trx. While there are
+ *      any, the DDL is not sent at all.
+ *   2. The DDL runs with SESSION lock_wait_timeout set to that many
+ *      seconds, so if a blocker appears after the pre-flight the pending
+ *      lock gives up quickly instead of piling queries up behind it.
+ *   3. A blocked pre-flight or a lock wait timeout (ER_LOCK_WAIT_TIMEOUT)
+ *      is retried up to inception_exec_ddl_lock_retries times, sleeping
+ *      MDL_MIN_BACKOFF_MS doubling up to MDL_MAX_BACKOFF_MS in between.
+ *
+ * The pre-flight needs the wait/lock/metadata/sql/mdl instrument (on by
+ * default in MySQL 8.0); without it metadata_locks is empty and only the
+ * short lock wait protects the table. Online schema change has its own
+ * cut-over lock handling (inception_osc_lock_wait_timeout).
+ */
+
+#ifndef SQL_INCEPTION_MDL_H
+#define SQL_INCEPTION_MDL_H
+
+#include <functional>
+#include <string>
+
+#include "include/mysql.h"  // MYSQL
+#include "sql/sql_lex.h"    // enum_sql_command
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/** Statements that take an exclusive metadata lock on their table. */
+bool needs_table_mdl(enum_sql_command cmd);
+
+/**
+ * Other sessions holding or waiting for a metadata lock on db.table, as
+ * "id 123 (SHARED_READ GRANTED, trx 45s)" joined by "; " (a few at most),
+ * empty if none. Returns true on error.
+ */
+bool find_mdl_blockers(MYSQL *mysql, const std::string &db,
+                       const std::string &table, std::string *blockers);
+
+/**
+ * Run a table DDL through attempt(), which executes node on mysql and
+ * returns true on failure with the error recorded in node, under the
+ * guard described above. Without inception_exec_ddl_lock_wait_timeout
+ * this is just attempt().
+ *
+ * @return false on success, true on error (error recorded in node).
+ */
+bool execute_mdl_guarded(MYSQL *mysql, InceptionContext *ctx,
+                         SqlCacheNode *node,
+                         const std::function<bool()> &attempt);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_MDL_H
@@ -0,0 +1,404 @@
+/**
+ * @file inception_monitor.cc
+ * @brief Target load monitor that runs while a statement executes.
+ */
+
+#include "sql/inception/inception_monitor.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_heartbeat.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace inception {
+
+/* Poll interval while a statement runs */
+static const std::chrono::milliseconds MONITOR_INTERVAL(1000);
+
+bool read_threads_running(MYSQL *mysql, ulong *running) {
+  if (mysql_real_query(mysql, remote_sql::SHOW_THREADS_RUNNING,
+                       strlen(remote_sql::SHOW_THREADS_RUNNING)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool failed = !(row && row[1]);
+  if (!failed) *running = strtoul(row[1], nullptr, 10);
+  mysql_free_result(res);
+  return failed;
+}
+
+bool read_replication_delay(MYSQL *mysql, long *delay) {
+  if (mysql_real_query(mysql, remote_sql::SHOW_SLAVE_STATUS,
+                       strlen(remote_sql::SHOW_SLAVE_STATUS)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  /* Seconds_Behind_Master is column index 32 in SHOW SLAVE STATUS */
+  unsigned int num_fields = mysql_num_fields(res);
+  MYSQL_ROW row = mysql_fetch_row(res);
+  bool failed = !(row && num_fields > 32);
+  if (!failed)
+    *delay = row[32] ? static_cast<long>(strtoul(row[32], nullptr, 10)) : -1;
+  mysql_free_result(res);
+  return failed;
+}
+
+/**
+ * WORK_COMPLETED / WORK_ESTIMATED of the current stage of remote_tid.
+ * Both stay -1 when the stage has no estimate. Returns true on error.
+ */
+static bool read_stage_progress(MYSQL *mysql, unsigned long remote_tid,
+                                long long *done, long long *total) {
+  char sql[512];
+  snprintf(sql, sizeof(sql), remote_sql::STAGE_PROGRESS, remote_tid);
+  if (mysql_real_query(mysql, sql, static_cast<unsigned long>(strlen(sql))) !=
+      0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  if (row && row[0] && row[1]) {
+    *done = strtoll(row[0], nullptr, 10);
+    *total = strtoll(row[1], nullptr, 10);
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+/**
+ * ROW_COUNT and JOB_ID of the running TiDB DDL job on db.table; both stay
+ * -1 when there is none. Returns true on error.
+ */
+static bool read_tidb_job(MYSQL *mysql, const std::string &db,
+                          const std::string &table, long long *rows,
+                          long long *job_id) {
+  if (mysql_real_query(mysql, remote_sql::TIDB_SHOW_DDL_JOBS,
+                       strlen(remote_sql::TIDB_SHOW_DDL_JOBS)) != 0)
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return true;
+  /* Columns differ between TiDB versions: look them up by name */
+  int db_col = -1, table_col = -1, rows_col = -1, state_col = -1;
+  int id_col = -1;
+  MYSQL_FIELD *fields = mysql_fetch_fields(res);
+  for (unsigned int i = 0; i < mysql_num_fields(res); i++) {
+    if (strcasecmp(fields[i].name, "JOB_ID") == 0) id_col = i;
+    if (strcasecmp(fields[i].name, "DB_NAME") == 0) db_col = i;
+    if (strcasecmp(fields[i].name, "TABLE_NAME") == 0) table_col = i;
+    if (strcasecmp(fields[i].name, "ROW_COUNT") == 0) rows_col = i;
+    if (strcasecmp(fields[i].name, "STATE") == 0) state_col = i;
+  }
+  bool failed = id_col < 0 || db_col < 0 || table_col < 0 || rows_col < 0 ||
+                state_col < 0;
+  MYSQL_ROW row;
+  while (!failed && (row = mysql_fetch_row(res))) {
+    if (row[state_col] && strcasecmp(row[state_col], "running") == 0 &&
+        row[db_col] && strcasecmp(row[db_col], db.c_str()) == 0 &&
+        row[table_col] && strcasecmp(row[table_col], table.c_str()) == 0 &&
+        row[rows_col] && row[id_col]) {
+      *rows = strtoll(row[rows_col], nullptr, 10);
+      *job_id = strtoll(row[id_col], nullptr, 10);
+      break;
+    }
+  }
+  mysql_free_result(res);
+  return failed;
+}
+
+/** Whether running TiDB DDL jobs get inception_exec_tidb_ddl_reorg_*. */
+static bool tune_tidb_jobs(const InceptionContext *ctx) {
+  return ctx->db_type == DbType::TIDB &&
+         ctx->db_version_major * 100 + ctx->db_version_minor >= 803 &&
+         (opt_exec_tidb_ddl_reorg_threads > 0 ||
+          opt_exec_tidb_ddl_reorg_batch_size > 0);
+}
+
+/**
+ * Apply inception_exec_tidb_ddl_reorg_* to TiDB DDL job job_id. Returns
+ * true on error.
+ */
+static bool alter_tidb_job(MYSQL *mysql, long long job_id) {
+  std::string options;
+  if (opt_exec_tidb_ddl_reorg_threads > 0)
+    options = "THREAD = " + std::to_string(opt_exec_tidb_ddl_reorg_threads);
+  if (opt_exec_tidb_ddl_reorg_batch_size > 0) {
+    if (!options.empty()) options += ", ";
+    options += "BATCH_SIZE = " +
+               std::to_string(opt_exec_tidb_ddl_reorg_batch_size);
+  }
+  char sql[160];
+  snprintf(sql, sizeof(sql), remote_sql::TIDB_ALTER_DDL_JOB, job_id,
+           options.c_str());
+  if (mysql_real_query(mysql, sql, static_cast<unsigned long>(strlen(sql))))
+    return true;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (res) mysql_free_result(res);
+  return false;
+}
+
+/** TABLE_ROWS estimate of db.table, -1 if unknown. */
+static long long read_table_rows(MYSQL *mysql, const std::string &db,
+                                 const std::string &table) {
+  char sql[512];
+  snprintf(sql, sizeof(sql), remote_sql::TABLE_ROWS_ESTIMATE, db.c_str(),
+           table.c_str());
+  if (mysql_real_query(mysql, sql, static_cast<unsigned long>(strlen(sql))) !=
+      0)
+    return -1;
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return -1;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  long long rows = row && row[0] ? strtoll(row[0], nullptr, 10) : -1;
+  mysql_free_result(res);
+  return rows;
+}
+
+StatementMonitor::StatementMonitor(InceptionContext *ctx) : m_ctx(ctx) {
+  const bool watch_delay = opt_exec_monitor_max_replication_delay > 0 &&
+                           !ctx->slave_hosts.empty();
+  if (opt_exec_monitor_max_threads_running > 0 || watch_delay ||
+      opt_exec_progress || tune_tidb_jobs(ctx))
+    m_thread = std::thread([this] { run(); });
+}
+
+StatementMonitor::~StatementMonitor() {
+  if (!m_thread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cond.notify_all();
+  m_thread.join();
+}
+
+void StatementMonitor::begin(unsigned long remote_tid,
+                             const SqlCacheNode &node) {
+  if (!m_thread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_running = true;
+    m_generation++;
+    m_remote_tid = remote_tid;
+    m_tripped = false;
+    m_aborted = false;
+    m_breach.clear();
+    m_node_id = node.id;
+    m_db = node.db_name;
+    m_table = node.table_name;
+  }
+  m_cond.notify_all();
+}
+
+bool StatementMonitor::end(std::string *breach) {
+  breach->clear();
+  if (!m_thread.joinable()) return false;
+  /* Waits for a KILL QUERY in flight, so it never hits the next statement */
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_running) return false;
+  m_running = false;
+  m_ctx->progress_node_id.store(0);
+  *breach = m_breach;
+  return m_aborted;
+}
+
+/** Open the monitor's own connections, once. */
+void StatementMonitor::connect() {
+  if (!m_connected) {
+    m_connected = true;
+    PoolConnOptions opts;
+    opts.connect_timeout = 10;
+    opts.read_timeout = 30;
+    std::string user = m_ctx->user.empty() ? "root" : m_ctx->user;
+    std::string host = m_ctx->host.empty() ? "127.0.0.1" : m_ctx->host;
+    std::string err;
+    m_primary = pool_acquire(host, m_ctx->port, user, m_ctx->password, opts,
+                             &err);
+    if (!m_primary) {
+      fprintf(stderr, "[Inception] Load monitor cannot connect to %s:%u: %s\n",
+              host.c_str(), m_ctx->port, err.c_str());
+      fflush(stderr);
+    }
+    if (opt_exec_monitor_max_replication_delay > 0) {
+      for (auto &sh : m_ctx->slave_hosts) {
+        MYSQL *s = pool_acquire(sh.first, sh.second, user, m_ctx->password,
+                                opts, &err);
+        if (s) m_slaves.push_back(s);
+      }
+    }
+  }
+}
+
+/**
+ * One round of checks on the monitor's own connections. Returns the
+ * breached ceiling, or an empty string.
+ */
+std::string StatementMonitor::poll() {
+  char buf[160];
+  const ulong max_running = opt_exec_monitor_max_threads_running;
+  ulong running = 0;
+  if (max_running > 0 && m_primary &&
+      !read_threads_running(m_primary, &running)) {
+    m_ctx->last_threads_running.store(running);
+    if (running > max_running) {
+      snprintf(buf, sizeof(buf), "Threads_running=%lu > %lu", running,
+               max_running);
+      return buf;
+    }
+  }
+
+  const ulong max_delay = opt_exec_monitor_max_replication_delay;
+  long worst = -1;
+  for (auto *s : m_slaves) {
+    long delay = 0;
+    if (max_delay == 0 || read_replica_lag(s, &delay)) continue;
+    if (delay < 0) {
+      snprintf(buf, sizeof(buf), "replica %s:%u Seconds_Behind_Master is NULL",
+               s->host ? s->host : "?", s->port);
+      return buf;
+    }
+    if (delay > worst) worst = delay;
+    if (delay > static_cast<long>(max_delay) * 1000) {
+      m_ctx->last_repl_delay_ms.store(delay);
+      snprintf(buf, sizeof(buf), "replication delay=%.3fs > %lus",
+               delay / 1000.0, max_delay);
+      return buf;
+    }
+  }
+  if (worst >= 0) m_ctx->last_repl_delay_ms.store(worst);
+  return "";
+}
+
+/**
+ * How far the statement of generation gen got. Rate and ETA are averaged
+ * from its first sample, which smooths out stage boundaries. A TiDB job
+ * seen for the first time gets the reorg settings here.
+ */
+StatementMonitor::Progress StatementMonitor::sample_progress(
+    uint64_t gen, unsigned long remote_tid, const std::string &db,
+    const std::string &table) {
+  Progress p;
+  if (!m_primary || remote_tid == 0) return p;
+  if (gen != m_progress_gen) {
+    m_progress_gen = gen;
+    m_first_done = -1;
+    m_table_rows = -1;
+    if (m_ctx->db_type == DbType::TIDB && !table.empty())
+      m_table_rows = read_table_rows(m_primary, db, table);
+  }
+
+  long long done = -1, total = -1;
+  if (m_ctx->db_type == DbType::TIDB) {
+    long long job_id = -1;
+    if (table.empty() || read_tidb_job(m_primary, db, table, &done, &job_id))
+      return p;
+    if (job_id >= 0 && job_id != m_tuned_job && tune_tidb_jobs(m_ctx)) {
+      m_tuned_job = job_id;
+      if (alter_tidb_job(m_primary, job_id)) {
+        fprintf(stderr, "[Inception] Cannot set the reorg workers of TiDB DDL "
+                "job %lld: %s\n", job_id, mysql_error(m_primary));
+        fflush(stderr);
+      }
+    }
+    if (!opt_exec_progress) return p;
+    total = m_table_rows;
+  } else if (read_stage_progress(m_primary, remote_tid, &done, &total)) {
+    return p;
+  }
+  if (done < 0) return p;
+
+  auto now = std::chrono::steady_clock::now();
+  if (m_first_done < 0 || done < m_first_done) {
+    m_first_done = done;
+    m_first_at = now;
+  }
+  if (total > 0)
+    p.permille = static_cast<long>(std::min<long long>(done * 1000 / total,
+                                                       1000));
+  double seconds = std::chrono::duration<double>(now - m_first_at).count();
+  if (seconds > 0 && done > m_first_done) {
+    double rate = (done - m_first_done) / seconds;
+    p.rate = static_cast<long>(rate);
+    if (total > done) p.eta_sec = static_cast<long>((total - done) / rate);
+  }
+  return p;
+}
+
+void StatementMonitor::release_connections() {
+  if (m_primary) pool_release(m_primary, PoolRelease::CLEAN);
+  for (auto *s : m_slaves) pool_release(s, PoolRelease::CLEAN);
+  m_primary = nullptr;
+  m_slaves.clear();
+}
+
+void StatementMonitor::run() {
+  if (my_thread_init()) return;
+  bind_worker_resource_group();
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    if (!m_running) {
+      m_cond.wait(lock);
+      continue;
+    }
+    const uint64_t gen = m_generation;
+    /* Statements shorter than one interval are never polled */
+    m_cond.wait_for(lock, MONITOR_INTERVAL, [&] {
+      return m_stop || !m_running || m_generation != gen;
+    });
+    if (m_stop || !m_running || m_generation != gen) continue;
+
+    /* After a breach only progress is still sampled */
+    const bool check = !m_tripped;
+    const unsigned long remote_tid = m_remote_tid;
+    const int node_id = m_node_id;
+    const std::string db = m_db;
+    const std::string table = m_table;
+    lock.unlock();
+    connect();
+    std::string breach = check ? poll() : "";
+    Progress p;
+    if (opt_exec_progress || tune_tidb_jobs(m_ctx))
+      p = sample_progress(gen, remote_tid, db, table);
+    lock.lock();
+    if (!m_running || m_generation != gen) continue;
+    if (p.permille >= 0 || p.rate >= 0) {
+      m_ctx->progress_permille.store(p.permille);
+      m_ctx->progress_rate.store(p.rate);
+      m_ctx->progress_eta_sec.store(p.eta_sec);
+      m_ctx->progress_node_id.store(node_id);
+    }
+    if (breach.empty()) continue;
+
+    m_tripped = true;
+    m_breach = breach;
+    const bool abort = opt_exec_monitor_abort && m_primary && m_remote_tid;
+    fprintf(stderr, "[Inception] Load monitor: %s while remote thread %lu "
+            "runs a statement%s.\n", breach.c_str(), m_remote_tid,
+            abort ? ", killing the query" : "");
+    fflush(stderr);
+    if (abort) {
+      /* Still under m_mutex: end() cannot return before this completes */
+      char kill_sql[64];
+      snprintf(kill_sql, sizeof(kill_sql), remote_sql::KILL_QUERY,
+               m_remote_tid);
+      m_aborted = mysql_real_query(
+                      m_primary, kill_sql,
+                      static_cast<unsigned long>(strlen(kill_sql))) == 0;
+    }
+  }
+  lock.unlock();
+  release_connections();
+  my_thread_end();
+}
+
+}  // namespace inception
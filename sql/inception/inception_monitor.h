@@ -0,0 +1,128 @@
+/**
+ * @file inception_monitor.h
+ * @brief Target load monitor that runs while a statement executes.
+ *
+ * The Threads_running / replication-delay throttle in inception_exec.cc only
+ * runs between statements; once a long ALTER or UPDATE is on the wire
+ * nobody looks at the target. A StatementMonitor owns a thread with its own
+ * pooled connections to the primary and the --slave-hosts replicas. While
+ * a statement runs (begin() .. end()) it polls them every second, and when
+ * inception_exec_monitor_max_threads_running or
+ * inception_exec_monitor_max_replication_delay is exceeded it reports the
+ * breach on the statement, and with inception_exec_monitor_abort=ON sends
+ * KILL QUERY for the statement over its own connection.
+ *
+ * With inception_exec_progress=ON (the default) the same thread also
+ * samples how far the statement got: on MySQL the WORK_COMPLETED /
+ * WORK_ESTIMATED of its current stage in
+ * performance_schema.events_stages_current (InnoDB ALTER TABLE reports
+ * one estimate over all its stages; DML reports none), on TiDB the
+ * ROW_COUNT of the running job of its table in ADMIN SHOW DDL JOBS against
+ * the TABLE_ROWS estimate. Percent complete, rate and ETA are published on
+ * the context for the stmt_progress column of "inception show sessions".
+ * The events_stages_current consumer is off by default on MySQL; without
+ * it nothing is reported. On TiDB 8.3+ the job found there is also given
+ * inception_exec_tidb_ddl_reorg_threads / _batch_size with ADMIN ALTER DDL
+ * JOBS, once per job.
+ *
+ * One connection carries one command at a time, so watching the target
+ * needs a second connection whether or not the statement itself is sent
+ * with the non-blocking client API; the statement keeps the blocking path.
+ */
+
+#ifndef SQL_INCEPTION_MONITOR_H
+#define SQL_INCEPTION_MONITOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/** Threads_running of the server behind mysql. Returns true on error. */
+bool read_threads_running(MYSQL *mysql, ulong *running);
+
+/**
+ * Seconds_Behind_Master of the replica behind mysql; *delay is -1 when it
+ * is NULL (replication stopped or broken). Returns true on error or when
+ * the server is not a replica.
+ */
+bool read_replication_delay(MYSQL *mysql, long *delay);
+
+class StatementMonitor {
+ public:
+  /**
+   * Starts the monitor thread only if a ceiling is configured or progress
+   * reporting is on.
+   */
+  explicit StatementMonitor(InceptionContext *ctx);
+  ~StatementMonitor();
+  StatementMonitor(const StatementMonitor &) = delete;
+  StatementMonitor &operator=(const StatementMonitor &) = delete;
+
+  /**
+   * Statement node (the first of a batch) is about to run on remote
+   * connection remote_tid. Not used for chunked DML and OSC, which
+   * throttle between their own chunks and report chunk_progress.
+   */
+  void begin(unsigned long remote_tid, const SqlCacheNode &node);
+
+  /**
+   * The statement returned. Sets *breach to the ceiling it crossed while
+   * running (empty if none). Returns true if the monitor killed it.
+   */
+  bool end(std::string *breach);
+
+ private:
+  /** Progress sample of one statement; -1 = unknown */
+  struct Progress {
+    long permille = -1;
+    long rate = -1;       /* work units (TiDB: rows) per second */
+    long eta_sec = -1;
+  };
+
+  void run();
+  void connect();
+  std::string poll();
+  Progress sample_progress(uint64_t gen, unsigned long remote_tid,
+                           const std::string &db, const std::string &table);
+  void release_connections();
+
+  InceptionContext *m_ctx;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  bool m_stop = false;
+  bool m_running = false;        /* between begin() and end() */
+  uint64_t m_generation = 0;     /* bumped by begin() */
+  unsigned long m_remote_tid = 0;
+  bool m_tripped = false;        /* breach seen for the current statement */
+  bool m_aborted = false;
+  std::string m_breach;
+  int m_node_id = 0;             /* statement of the current begin() */
+  std::string m_db;
+  std::string m_table;
+
+  /* Used by the monitor thread only */
+  MYSQL *m_primary = nullptr;
+  std::vector<MYSQL *> m_slaves;
+  bool m_connected = false;
+  uint64_t m_progress_gen = 0;   /* statement the fields below belong to */
+  long long m_first_done = -1;   /* work done at its first sample */
+  std::chrono::steady_clock::time_point m_first_at;
+  long long m_table_rows = -1;   /* TiDB: TABLE_ROWS, read once */
+  long long m_tuned_job = -1;    /* TiDB: last job given reorg settings */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_MONITOR_H
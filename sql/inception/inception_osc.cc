@@ -0,0 +1,804 @@
+/**
+ * @file inception_osc.cc
+ * @brief Built-in online schema change (ghost table, no triggers).
+ */
+
+#include "sql/inception/inception_osc.h"
+
+#include "sql/inception/inception_binlog.h"
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <strings.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace inception {
+
+/* Row changes buffered between the binlog reader and the applier. */
+static constexpr size_t OSC_QUEUE_MAX = 10000;
+
+/* Replayed changes per transaction outside the cut-over. */
+static constexpr size_t OSC_APPLY_BATCH = 100;
+
+/* Cut-over attempts before giving up, and how long each may keep the
+   tables locked waiting for the replay to reach the locked position. */
+static constexpr int OSC_CUTOVER_ATTEMPTS = 5;
+static constexpr int OSC_CUTOVER_CATCHUP_SEC = 10;
+
+namespace {
+
+/** Hand-off between the binlog reader thread and the applier. */
+struct OscQueue {
+  std::mutex mutex;
+  std::condition_variable changed;   /* changes, position or failure */
+  std::condition_variable not_full;
+  std::deque<RowChange> changes;
+  BinlogPos pos;                     /* stream position after changes */
+  bool stop = false;
+  bool failed = false;
+  std::string error;
+};
+
+/** One online ALTER in progress. Identifiers are quoted. */
+struct OscRun {
+  MYSQL *mysql;
+  InceptionContext *ctx;
+  SqlCacheNode *node;
+
+  std::string db, table, ghost, old;
+  std::string ghost_name, old_name;  /* unquoted */
+  std::string pk;
+  size_t pk_index = 0;               /* in the original's columns */
+  std::vector<size_t> copy_index;    /* original columns the ghost keeps */
+  std::string column_list;
+  std::vector<BinlogColumn> columns;
+  std::vector<std::string> deferred;  /* KEY definitions left off the ghost */
+
+  BinlogStream stream;
+  OscQueue queue;
+  std::thread reader;
+
+  bool ghost_created = false;
+  bool locked = false;
+  bool lock_timeout_set = false;
+  int64_t copied = 0;
+  int64_t applied = 0;
+  long chunks = 0;
+  std::string error;
+};
+
+}  // namespace
+
+/* ---- ALTER TABLE text ---- */
+
+/** Skip whitespace and comments from i. */
+static size_t skip_space(const std::string &s, size_t i) {
+  for (;;) {
+    while (i < s.size() && isspace(static_cast<unsigned char>(s[i]))) i++;
+    if (s.compare(i, 2, "/*") == 0) {
+      size_t close = s.find("*/", i + 2);
+      if (close == std::string::npos) return s.size();
+      i = close + 2;
+      continue;
+    }
+    if (i < s.size() &&
+        (s[i] == '#' || (s.compare(i, 2, "--") == 0 && i + 2 < s.size() &&
+                         isspace(static_cast<unsigned char>(s[i + 2]))))) {
+      while (i < s.size() && s[i] != '\n') i++;
+      continue;
+    }
+    return i;
+  }
+}
+
+/** Skip a bare or backquoted identifier; npos if there is none at i. */
+static size_t skip_ident(const std::string &s, size_t i) {
+  if (i < s.size() && s[i] == '`') {
+    for (i++; i < s.size(); i++) {
+      if (s[i] != '`') continue;
+      if (i + 1 < s.size() && s[i + 1] == '`') {
+        i++;
+        continue;
+      }
+      return i + 1;
+    }
+    return std::string::npos;
+  }
+  size_t start = i;
+  while (i < s.size() && (isalnum(static_cast<unsigned char>(s[i])) ||
+                          s[i] == '_' || s[i] == '$' ||
+                          static_cast<unsigned char>(s[i]) >= 0x80))
+    i++;
+  return i == start ? std::string::npos : i;
+}
+
+static bool skip_keyword(const std::string &s, size_t *i, const char *kw) {
+  size_t n = strlen(kw);
+  if (strncasecmp(s.c_str() + *i, kw, n) != 0) return false;
+  if (*i + n < s.size() && (isalnum(static_cast<unsigned char>(s[*i + n])) ||
+                            s[*i + n] == '_'))
+    return false;
+  *i += n;
+  return true;
+}
+
+bool alter_specification(const std::string &sql, std::string *spec) {
+  size_t i = skip_space(sql, 0);
+  if (!skip_keyword(sql, &i, "ALTER")) return false;
+  i = skip_space(sql, i);
+  if (!skip_keyword(sql, &i, "TABLE")) return false;
+  i = skip_ident(sql, skip_space(sql, i));
+  if (i == std::string::npos) return false;
+  size_t j = skip_space(sql, i);
+  if (j < sql.size() && sql[j] == '.') {
+    i = skip_ident(sql, skip_space(sql, j + 1));
+    if (i == std::string::npos) return false;
+  }
+  *spec = sql.substr(i);
+  while (!spec->empty() && (spec->back() == ';' ||
+                            isspace(static_cast<unsigned char>(spec->back()))))
+    spec->pop_back();
+  size_t first = skip_space(*spec, 0);
+  spec->erase(0, first);
+  return !spec->empty();
+}
+
+/* ---- Binlog replay ---- */
+
+static void reader_main(OscRun *run) {
+  if (my_thread_init()) {
+    std::lock_guard<std::mutex> lock(run->queue.mutex);
+    run->queue.failed = true;
+    run->queue.error = "Cannot initialize binlog reader thread.";
+    run->queue.changed.notify_all();
+    return;
+  }
+  bind_worker_resource_group();
+  OscQueue &q = run->queue;
+  std::vector<RowChange> batch;
+  std::string err;
+  for (;;) {
+    batch.clear();
+    BinlogRead r = run->stream.next(&batch, &err);
+    std::unique_lock<std::mutex> lock(q.mutex);
+    if (q.stop) break;
+    if (r != BinlogRead::EVENT) {
+      q.failed = true;
+      q.error = r == BinlogRead::END ? "Binlog stream ended unexpectedly." : err;
+      q.changed.notify_all();
+      break;
+    }
+    q.not_full.wait(lock, [&] {
+      return q.stop || q.changes.size() < OSC_QUEUE_MAX;
+    });
+    if (q.stop) break;
+    for (auto &c : batch) q.changes.push_back(std::move(c));
+    q.pos = run->stream.position();
+    q.changed.notify_all();
+  }
+  my_thread_end();
+}
+
+/** Statements that replay one row change on the ghost table. */
+static void change_statements(const OscRun &run, const RowChange &c,
+                              std::vector<std::string> *out) {
+  auto del = [&](const std::vector<std::string> &row) {
+    return "DELETE FROM " + run.db + "." + run.ghost + " WHERE " + run.pk +
+           " = " + row[run.pk_index];
+  };
+  auto replace = [&](const std::vector<std::string> &row) {
+    std::string sql = "REPLACE INTO " + run.db + "." + run.ghost + " (" +
+                      run.column_list + ") VALUES (";
+    for (size_t k = 0; k < run.copy_index.size(); k++) {
+      if (k) sql += ", ";
+      sql += row[run.copy_index[k]];
+    }
+    return sql + ")";
+  };
+  switch (c.type) {
+    case RowChangeType::INSERT:
+      out->push_back(replace(c.after));
+      break;
+    case RowChangeType::DELETE:
+      out->push_back(del(c.before));
+      break;
+    case RowChangeType::UPDATE:
+      if (c.before[run.pk_index] != c.after[run.pk_index])
+        out->push_back(del(c.before));
+      out->push_back(replace(c.after));
+      break;
+  }
+}
+
+/**
+ * Replay everything queued so far. Under LOCK TABLES each statement
+ * autocommits (START TRANSACTION would release the locks).
+ */
+static bool apply_queued(OscRun *run, bool in_lock) {
+  std::deque<RowChange> batch;
+  {
+    std::lock_guard<std::mutex> lock(run->queue.mutex);
+    if (run->queue.failed) {
+      run->error = "Binlog replay failed: " + run->queue.error;
+      return true;
+    }
+    batch.swap(run->queue.changes);
+  }
+  run->queue.not_full.notify_all();
+
+  std::vector<std::string> stmts;
+  std::string err;
+  auto failed = [&] {
+    run->error = "Binlog replay on ghost table failed: " + err;
+    return true;
+  };
+  size_t in_trx = 0;
+  for (const auto &c : batch) {
+    if (!in_lock && in_trx == 0 &&
+        run_sql(run->mysql, remote_sql::OSC_BEGIN, &err))
+      return failed();
+    stmts.clear();
+    change_statements(*run, c, &stmts);
+    for (const auto &sql : stmts)
+      if (run_sql(run->mysql, sql, &err)) return failed();
+    run->applied++;
+    if (!in_lock && ++in_trx == OSC_APPLY_BATCH) {
+      if (run_sql(run->mysql, remote_sql::OSC_COMMIT, &err)) return failed();
+      in_trx = 0;
+    }
+  }
+  if (in_trx && run_sql(run->mysql, remote_sql::OSC_COMMIT, &err))
+    return failed();
+  return false;
+}
+
+/**
+ * Replay until the stream has passed target. With timeout_sec > 0, gives
+ * up after that long and sets *timed_out. Returns true on error.
+ */
+static bool catch_up(OscRun *run, const BinlogPos &target, bool in_lock,
+                     int timeout_sec, bool *timed_out) {
+  *timed_out = false;
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+  for (;;) {
+    if (apply_queued(run, in_lock)) return true;
+    std::unique_lock<std::mutex> lock(run->queue.mutex);
+    if (run->queue.changes.empty() &&
+        !binlog_pos_before(run->queue.pos, target))
+      return false;
+    if (run->ctx->killed.load()) {
+      run->error = "Killed by user.";
+      return true;
+    }
+    if (timeout_sec > 0 && std::chrono::steady_clock::now() >= deadline) {
+      *timed_out = true;
+      return false;
+    }
+    if (run->queue.changes.empty() && !run->queue.failed)
+      run->queue.changed.wait_for(lock, std::chrono::milliseconds(100));
+  }
+}
+
+void deferrable_indexes(const std::string &create_table, std::string *drop,
+                        std::vector<std::string> *keys) {
+  size_t start = 0;
+  while (start < create_table.size()) {
+    size_t end = create_table.find('\n', start);
+    if (end == std::string::npos) end = create_table.size();
+    std::string line = create_table.substr(start, end - start);
+    start = end + 1;
+    if (line.compare(0, 7, "  KEY `") != 0) continue;
+    const size_t name_end = skip_ident(line, 6);
+    if (name_end == std::string::npos) continue;
+    if (line.back() == ',') line.pop_back();
+    if (!drop->empty()) *drop += ", ";
+    *drop += "DROP INDEX " + line.substr(6, name_end - 6);
+    keys->push_back(line.substr(2));
+  }
+}
+
+std::string deferred_index_spec(const std::vector<std::string> &keys) {
+  std::string spec;
+  for (const auto &key : keys) {
+    if (!spec.empty()) spec += ", ";
+    spec += "ADD " + key;
+  }
+  return spec + remote_sql::OSC_ADD_INDEXES_ONLINE;
+}
+
+/* ---- Phases ---- */
+
+/**
+ * inception_osc_defer_indexes: drop the plain KEYs of the ghost, so the
+ * copy only appends to its primary key; build_deferred_indexes() adds
+ * them back. Unique keys stay, INSERT IGNORE depends on them. If the
+ * ghost cannot do without them (an AUTO_INCREMENT column they cover),
+ * the copy keeps them.
+ */
+static void defer_indexes(OscRun *run) {
+  if (!opt_osc_defer_indexes) return;
+  MYSQL *mysql = run->mysql;
+  std::vector<std::string> row;
+  bool found = false;
+  if (query_one_row(mysql,
+                    format_sql(remote_sql::OSC_SHOW_CREATE_GHOST,
+                               run->db.c_str(), run->ghost.c_str()),
+                    &row, &found) ||
+      !found || row.size() < 2)
+    return;
+
+  std::vector<std::string> keys;
+  std::string drop;
+  deferrable_indexes(row[1], &drop, &keys);
+  if (keys.empty()) return;
+
+  std::string err;
+  if (run_sql(mysql,
+              format_sql(remote_sql::OSC_ALTER_GHOST, run->db.c_str(),
+                         run->ghost.c_str(), drop.c_str()),
+              &err)) {
+    fprintf(stderr, "[Inception] OSC: keeping the indexes of %s during the "
+            "copy: %s\n", run->ghost_name.c_str(), err.c_str());
+    fflush(stderr);
+    return;
+  }
+  run->deferred.swap(keys);
+}
+
+/** Check the target and the table, then create and alter the ghost. */
+static bool prepare(OscRun *run) {
+  SqlCacheNode *node = run->node;
+  MYSQL *mysql = run->mysql;
+  std::string err;
+
+  std::string spec;
+  if (!alter_specification(node->sql_text, &spec)) {
+    run->error = "Cannot extract the ALTER TABLE specification.";
+    return true;
+  }
+  if (node->table_name.size() + 5 > 64) {
+    run->error = "Table name is too long for the ghost table name.";
+    return true;
+  }
+  run->ghost_name = "_" + node->table_name + "_gho";
+  run->old_name = "_" + node->table_name + "_del";
+  run->db = quote_ident(node->db_name);
+  run->table = quote_ident(node->table_name);
+  run->ghost = quote_ident(run->ghost_name);
+  run->old = quote_ident(run->old_name);
+
+  if (check_binlog_settings(mysql, &err)) {
+    run->error = err;
+    return true;
+  }
+
+  std::string pk_name =
+      single_integer_pk(mysql, node->db_name, node->table_name);
+  if (pk_name.empty()) {
+    run->error = "Requires a single-column integer primary key.";
+    return true;
+  }
+  run->pk = quote_ident(pk_name);
+
+  std::vector<std::string> row;
+  bool found = false;
+  char query[2048];
+  const char *db = node->db_name.c_str();
+  const char *tbl = node->table_name.c_str();
+  snprintf(query, sizeof(query), remote_sql::OSC_TABLE_BLOCKERS, db, tbl, db,
+           tbl, db, tbl);
+  if (query_one_row(mysql, query, &row, &found) || !found) {
+    run->error = std::string("Cannot check foreign keys and triggers: ") +
+                 mysql_error(mysql);
+    return true;
+  }
+  if (row[0] != "0" || row[1] != "0") {
+    run->error = "Tables with foreign keys or triggers are not supported.";
+    return true;
+  }
+  snprintf(query, sizeof(query), remote_sql::OSC_LEFTOVER_TABLE, db,
+           run->ghost_name.c_str(), run->old_name.c_str());
+  if (query_one_row(mysql, query, &row, &found)) {
+    run->error = std::string("Cannot check ghost table: ") +
+                 mysql_error(mysql);
+    return true;
+  }
+  if (found) {
+    run->error = "Table " + node->db_name + "." + row[0] +
+                 " already exists (left over by an earlier run?).";
+    return true;
+  }
+
+  if (load_binlog_columns(mysql, node->db_name, node->table_name,
+                          &run->columns, &err)) {
+    run->error = err;
+    return true;
+  }
+
+  snprintf(query, sizeof(query), remote_sql::OSC_CREATE_GHOST,
+           run->db.c_str(), run->ghost.c_str(), run->db.c_str(),
+           run->table.c_str());
+  if (run_sql(mysql, query, &err)) {
+    run->error = "Cannot create ghost table: " + err;
+    return true;
+  }
+  run->ghost_created = true;
+
+  std::string alter = format_sql(remote_sql::OSC_ALTER_GHOST, run->db.c_str(),
+                                 run->ghost.c_str(), spec.c_str());
+  if (run_sql(mysql, alter, &err)) {
+    run->error = "ALTER on ghost table failed: " + err;
+    return true;
+  }
+
+  /* Copy and replay address rows by the same primary key. */
+  if (strcasecmp(single_integer_pk(mysql, node->db_name, run->ghost_name)
+                     .c_str(),
+                 pk_name.c_str()) != 0) {
+    run->error = "The ALTER must keep the primary key " + pk_name + ".";
+    return true;
+  }
+
+  defer_indexes(run);
+
+  std::vector<BinlogColumn> ghost_columns;
+  if (load_binlog_columns(mysql, node->db_name, run->ghost_name,
+                          &ghost_columns, &err)) {
+    run->error = err;
+    return true;
+  }
+  for (size_t i = 0; i < run->columns.size(); i++) {
+    const BinlogColumn &col = run->columns[i];
+    if (strcasecmp(col.name.c_str(), pk_name.c_str()) == 0) run->pk_index = i;
+    if (col.generated) continue;
+    for (const auto &gc : ghost_columns) {
+      if (gc.generated || strcasecmp(gc.name.c_str(), col.name.c_str()) != 0)
+        continue;
+      if (!run->column_list.empty()) run->column_list += ", ";
+      run->column_list += quote_ident(col.name);
+      run->copy_index.push_back(i);
+      break;
+    }
+  }
+  return false;
+}
+
+/** Start streaming the binlog from the current position. */
+static bool start_replay(OscRun *run) {
+  InceptionContext *ctx = run->ctx;
+  BinlogPos start;
+  std::string err;
+  if (get_binlog_position(run->mysql, &start, &err)) {
+    run->error = err;
+    return true;
+  }
+  run->stream.watch(run->node->db_name, run->node->table_name, run->columns);
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  if (run->stream.open(host, ctx->port, user, ctx->password, start, false,
+                       &err)) {
+    run->error = err;
+    return true;
+  }
+  run->queue.pos = start;
+  run->reader = std::thread(reader_main, run);
+  return false;
+}
+
+/** Copy all rows that existed when the copy started, in PK chunks. */
+static bool copy_rows(OscRun *run, const std::function<bool()> &pause) {
+  MYSQL *mysql = run->mysql;
+  char query[2048];
+  snprintf(query, sizeof(query), remote_sql::CHUNK_PK_RANGE, run->pk.c_str(),
+           run->pk.c_str(), run->db.c_str(), run->table.c_str());
+  std::vector<std::string> range;
+  bool found = false;
+  if (query_one_row(mysql, query, &range, &found)) {
+    run->error = std::string("Cannot read primary key range: ") +
+                 mysql_error(mysql);
+    return true;
+  }
+  if (!found) return false;  /* empty table: the binlog has everything */
+
+  run->ctx->chunk_node_id.store(run->node->id);
+  run->ctx->chunks_done.store(0);
+  run->ctx->chunk_rows.store(0);
+
+  const std::string max_pk = range[1];
+  std::string lower = range[0];
+  const char *op = ">=";
+  std::string err;
+  for (;;) {
+    snprintf(query, sizeof(query), remote_sql::CHUNK_NEXT_BOUNDARY,
+             run->pk.c_str(), run->db.c_str(), run->table.c_str(),
+             run->pk.c_str(), op, lower.c_str(), run->pk.c_str(),
+             opt_osc_chunk_size - 1);
+    std::vector<std::string> boundary;
+    if (query_one_row(mysql, query, &boundary, &found)) {
+      run->error = std::string("Cannot read chunk boundary: ") +
+                   mysql_error(mysql);
+      return true;
+    }
+    bool last = !found;
+    std::string upper = last ? max_pk : boundary[0];
+
+    std::string copy = format_sql(
+        remote_sql::OSC_COPY_CHUNK, run->db.c_str(), run->ghost.c_str(),
+        run->column_list.c_str(), run->column_list.c_str(), run->db.c_str(),
+        run->table.c_str(), run->pk.c_str(), op, lower.c_str(),
+        run->pk.c_str(), upper.c_str());
+    if (run_sql(mysql, copy, &err)) {
+      run->error =
+          "Row copy failed at chunk " + std::to_string(run->chunks + 1) + ": " +
+          err;
+      return true;
+    }
+    my_ulonglong rows = mysql->affected_rows;
+    if (rows != ~(my_ulonglong)0) run->copied += static_cast<int64_t>(rows);
+    run->chunks++;
+    run->ctx->chunks_done.store(run->chunks);
+    run->ctx->chunk_rows.store(run->copied);
+
+    /* Keep the replay close behind so the cut-over lock stays short. */
+    if (apply_queued(run, false)) return true;
+    if (last) return false;
+    lower = upper;
+    op = ">";
+    if (pause()) {
+      run->error = "Killed by user after " + std::to_string(run->chunks) +
+                   " chunks.";
+      return true;
+    }
+  }
+}
+
+/**
+ * Add the indexes defer_indexes() dropped in one ALTER on a second
+ * connection, while this one keeps replaying the binlog: the server
+ * builds them from sorted runs instead of the copy maintaining them row
+ * by row.
+ */
+static bool build_deferred_indexes(OscRun *run) {
+  if (run->deferred.empty()) return false;
+  InceptionContext *ctx = run->ctx;
+  std::string err;
+  PoolConnOptions opts;
+  MYSQL *side = pool_acquire(ctx->host.empty() ? "127.0.0.1" : ctx->host,
+                             ctx->port, ctx->user.empty() ? "root" : ctx->user,
+                             ctx->password, opts, &err);
+  if (!side) {
+    run->error = "Cannot connect to add the deferred indexes: " + err;
+    return true;
+  }
+
+  const std::string alter = format_sql(
+      remote_sql::OSC_ALTER_GHOST, run->db.c_str(), run->ghost.c_str(),
+      deferred_index_spec(run->deferred).c_str());
+  fprintf(stderr, "[Inception] OSC: adding %zu deferred indexes to %s.\n",
+          run->deferred.size(), run->ghost_name.c_str());
+  fflush(stderr);
+
+  std::atomic<bool> done{false};
+  bool failed = false;
+  std::string alter_err;
+  std::thread builder([&] {
+    if (my_thread_init()) {
+      failed = true;
+      alter_err = "Cannot initialize index build thread.";
+    } else {
+      bind_worker_resource_group();
+      failed = run_sql(side, alter, &alter_err);
+      my_thread_end();
+    }
+    done.store(true);
+  });
+
+  bool stopped = false;  /* replay failed or killed: the ALTER is killed */
+  while (!done.load()) {
+    if (stopped) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      continue;
+    }
+    if (apply_queued(run, false)) {
+      stopped = true;
+    } else if (ctx->killed.load()) {
+      run->error = "Killed by user while adding the deferred indexes.";
+      stopped = true;
+    }
+    if (stopped) {
+      run_sql(run->mysql,
+              format_sql(remote_sql::KILL_QUERY, side->thread_id), &err);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(run->queue.mutex);
+    if (run->queue.changes.empty() && !run->queue.failed)
+      run->queue.changed.wait_for(lock, std::chrono::milliseconds(100));
+  }
+  builder.join();
+  pool_release(side, failed ? PoolRelease::DIRTY : PoolRelease::CLEAN);
+
+  if (stopped) return true;
+  if (failed) {
+    run->error = "Adding the deferred indexes to the ghost table failed: " +
+                 alter_err;
+    return true;
+  }
+  return false;
+}
+
+/** Lock both tables, drain the binlog up to the lock, swap, unlock. */
+static bool cut_over(OscRun *run, const std::function<bool()> &pause) {
+  MYSQL *mysql = run->mysql;
+  std::string err;
+  char query[1024];
+
+  BinlogPos target;
+  bool timed_out = false;
+  if (get_binlog_position(mysql, &target, &err)) {
+    run->error = err;
+    return true;
+  }
+  if (catch_up(run, target, false, 0, &timed_out)) return true;
+
+  snprintf(query, sizeof(query), remote_sql::OSC_SET_LOCK_WAIT_TIMEOUT,
+           opt_osc_lock_wait_timeout);
+  if (run_sql(mysql, query, &err)) {
+    run->error = "Cannot set lock_wait_timeout: " + err;
+    return true;
+  }
+  run->lock_timeout_set = true;
+
+  snprintf(query, sizeof(query), remote_sql::OSC_LOCK_TABLES, run->db.c_str(),
+           run->table.c_str(), run->db.c_str(), run->ghost.c_str());
+  for (int attempt = 1; attempt <= OSC_CUTOVER_ATTEMPTS; attempt++) {
+    if (run_sql(mysql, query, &err)) {
+      fprintf(stderr, "[Inception] OSC: cut-over lock attempt %d/%d failed: "
+              "%s\n", attempt, OSC_CUTOVER_ATTEMPTS, err.c_str());
+      fflush(stderr);
+    } else {
+      run->locked = true;
+      /* Nothing can write the table now: drain up to this position. */
+      if (get_binlog_position(mysql, &target, &err)) {
+        run->error = err;
+        return true;
+      }
+      if (catch_up(run, target, true, OSC_CUTOVER_CATCHUP_SEC, &timed_out))
+        return true;
+      if (!timed_out) break;
+      fprintf(stderr, "[Inception] OSC: replay did not reach %s:%llu within "
+              "%ds, releasing locks (attempt %d/%d).\n", target.file.c_str(),
+              static_cast<unsigned long long>(target.pos),
+              OSC_CUTOVER_CATCHUP_SEC, attempt, OSC_CUTOVER_ATTEMPTS);
+      fflush(stderr);
+      run_sql(mysql, remote_sql::UNLOCK_TABLES, &err);
+      run->locked = false;
+    }
+    if (attempt == OSC_CUTOVER_ATTEMPTS) {
+      run->error = "Cut-over failed after " +
+                   std::to_string(OSC_CUTOVER_ATTEMPTS) + " attempts.";
+      return true;
+    }
+    /* Back off, then get close again before the next attempt. */
+    if (pause()) {
+      run->error = "Killed by user during cut-over.";
+      return true;
+    }
+    if (get_binlog_position(mysql, &target, &err)) {
+      run->error = err;
+      return true;
+    }
+    if (catch_up(run, target, false, 0, &timed_out)) return true;
+  }
+
+  snprintf(query, sizeof(query), remote_sql::OSC_RENAME_TABLES,
+           run->db.c_str(), run->table.c_str(), run->db.c_str(),
+           run->old.c_str(), run->db.c_str(), run->ghost.c_str(),
+           run->db.c_str(), run->table.c_str());
+  if (run_sql(mysql, query, &err)) {
+    run->error = "RENAME TABLE failed: " + err;
+    return true;
+  }
+  run->ghost_created = false;  /* it is the table now */
+  run_sql(mysql, remote_sql::UNLOCK_TABLES, &err);
+  run->locked = false;
+  return false;
+}
+
+/** Stop the reader, release locks and, on failure, drop the ghost. */
+static void cleanup(OscRun *run) {
+  if (run->reader.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(run->queue.mutex);
+      run->queue.stop = true;
+    }
+    run->queue.not_full.notify_all();
+    /* The reader wakes up with the next event or heartbeat (~1s). */
+    run->reader.join();
+  }
+  run->stream.close();
+
+  std::string err;
+  char query[1024];
+  if (run->locked) {
+    run_sql(run->mysql, remote_sql::UNLOCK_TABLES, &err);
+    run->locked = false;
+  }
+  run_sql(run->mysql, remote_sql::OSC_ROLLBACK, &err);
+  if (run->ghost_created) {
+    snprintf(query, sizeof(query), remote_sql::DROP_TABLE_IF_EXISTS,
+             run->db.c_str(), run->ghost.c_str());
+    if (run_sql(run->mysql, query, &err)) {
+      fprintf(stderr, "[Inception] OSC: cannot drop ghost table %s: %s\n",
+              run->ghost_name.c_str(), err.c_str());
+      fflush(stderr);
+    }
+  }
+  if (run->lock_timeout_set)
+    run_sql(run->mysql, remote_sql::OSC_RESET_LOCK_WAIT_TIMEOUT, &err);
+  run->ctx->chunk_node_id.store(0);
+}
+
+bool osc_execute(MYSQL *mysql, InceptionContext *ctx, SqlCacheNode *node,
+                 const std::function<bool()> &pause) {
+  auto start = std::chrono::steady_clock::now();
+  OscRun run;
+  run.mysql = mysql;
+  run.ctx = ctx;
+  run.node = node;
+
+  fprintf(stderr, "[Inception] OSC: %s.%s via ghost table.\n",
+          node->db_name.c_str(), node->table_name.c_str());
+  fflush(stderr);
+
+  bool failed = prepare(&run) || start_replay(&run) ||
+                copy_rows(&run, pause) || build_deferred_indexes(&run) ||
+                cut_over(&run, pause);
+  cleanup(&run);
+
+  if (!failed && opt_osc_drop_old_table) {
+    std::string err;
+    char query[1024];
+    snprintf(query, sizeof(query), remote_sql::DROP_TABLE_IF_EXISTS,
+             run.db.c_str(), run.old.c_str());
+    if (run_sql(mysql, query, &err))
+      node->append_warning("Online schema change done, but dropping %s "
+                           "failed: %s", run.old_name.c_str(), err.c_str());
+  }
+
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+  node->execute_seconds = elapsed;
+  node->affected_rows = run.copied;
+  node->stage = STAGE_EXECUTED;
+  if (failed) {
+    node->append_error("Online schema change failed: %s", run.error.c_str());
+    node->stage_status = ctx->killed.load() ? "Killed by user"
+                                            : "Execute failed";
+  } else {
+    node->stage_status = "Execute completed";
+  }
+
+  fprintf(stderr, "[Inception] OSC: %s, %ld chunks, %lld rows copied, "
+          "%lld binlog row changes replayed.\n",
+          failed ? "failed" : "done", run.chunks,
+          static_cast<long long>(run.copied),
+          static_cast<long long>(run.applied));
+  fflush(stderr);
+  return failed;
+}
+
+}  // namespace inception
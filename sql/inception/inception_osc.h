@@ -0,0 +1,68 @@
+/**
+ * @file inception_osc.h
+ * @brief Built-in online schema change (ghost table, no triggers).
+ *
+ * With inception_osc_on, an ALTER TABLE predicted as COPY is not sent to
+ * the target as is. Instead, in the style of gh-ost:
+ *
+ *   1. _<table>_gho is created LIKE the table and the ALTER runs on it;
+ *   2. rows are copied in throttled primary-key chunks (INSERT IGNORE);
+ *   3. meanwhile the target's binlog is streamed from the position taken
+ *      before the copy and every row change of the table is replayed on
+ *      the ghost (REPLACE / DELETE by primary key);
+ *   4. cut-over: LOCK TABLES both WRITE, drain the binlog up to the
+ *      locked position, RENAME TABLE table TO _<table>_del,
+ *      _<table>_gho TO table, UNLOCK TABLES.
+ *
+ * Writes to the table are blocked only for the short cut-over.
+ */
+
+#ifndef SQL_INCEPTION_OSC_H
+#define SQL_INCEPTION_OSC_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+struct InceptionContext;
+struct SqlCacheNode;
+
+/**
+ * Run the ALTER TABLE of node through the online schema change engine on
+ * mysql. pause() is called between chunks (throttle, --sleep) and returns
+ * true if the session was killed. Records affected_rows (rows copied),
+ * execute_time and any error in node.
+ *
+ * @return false on success, true on error (the ghost table is dropped and
+ *         the original table is left untouched).
+ */
+bool osc_execute(MYSQL *mysql, InceptionContext *ctx, SqlCacheNode *node,
+                 const std::function<bool()> &pause);
+
+/**
+ * Extract what follows "ALTER TABLE [db.]tbl" (the ghost table's ALTER,
+ * or the clauses --enable-merge-alter appends to a preceding ALTER).
+ * Returns false if the text does not have that shape.
+ */
+bool alter_specification(const std::string &sql, std::string *spec);
+
+/**
+ * The plain KEYs of a SHOW CREATE TABLE text, which
+ * inception_osc_defer_indexes leaves off the ghost during the copy:
+ * *drop gets "DROP INDEX `k1`, DROP INDEX `k2`" and *keys their
+ * definitions, e.g. "KEY `k1` (`a`)". The primary key and UNIQUE,
+ * FULLTEXT and SPATIAL keys are not deferred.
+ */
+void deferrable_indexes(const std::string &create_table, std::string *drop,
+                        std::vector<std::string> *keys);
+
+/** The ALTER specification that adds keys back after the copy. */
+std::string deferred_index_spec(const std::vector<std::string> &keys);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_OSC_H
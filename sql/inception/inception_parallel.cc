@@ -0,0 +1,429 @@
+/**
+ * @file inception_parallel.cc
+ * @brief Parallel execution of statements on unrelated tables
+ *        (--enable-parallel).
+ */
+
+#include "sql/inception/inception_parallel.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"
+#include "sql/inception/inception_fanout.h"  // run_subbatches
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/sql_class.h"  // THD, Security_context
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inception {
+
+namespace {
+
+enum class NodeKind { SESSION, LANE, BARRIER };
+
+/** A run of nodes [begin, end) of the batch; a barrier phase has one. */
+struct Phase {
+  size_t begin;
+  size_t end;
+  bool barrier;
+};
+
+/** Disjoint sets of lower-case "db.table" keys. */
+class TableSets {
+ public:
+  const std::string &find(const std::string &key) {
+    auto it = m_parent.find(key);
+    if (it == m_parent.end()) it = m_parent.emplace(key, key).first;
+    if (it->second == key) return it->first;
+    const std::string &root = find(it->second);
+    it->second = root;
+    return root;
+  }
+
+  void join(const std::string &a, const std::string &b) {
+    std::string ra = find(a);
+    const std::string &rb = find(b);
+    if (ra != rb) m_parent[ra] = rb;
+  }
+
+ private:
+  std::map<std::string, std::string> m_parent;
+};
+
+/** One lane of a phase: its context and, per node, the batch index (-1 =
+    setup replayed from before the phase). */
+struct Lane {
+  std::unique_ptr<InceptionContext> ctx;
+  std::vector<long> origin;
+};
+
+}  // namespace
+
+static bool is_session_node(const SqlCacheNode &node) {
+  return node.sql_command == SQLCOM_CHANGE_DB ||
+         node.sql_command == SQLCOM_SET_OPTION;
+}
+
+bool is_table_statement(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_CREATE_TABLE:
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_DROP_TABLE:
+    case SQLCOM_RENAME_TABLE:
+    case SQLCOM_TRUNCATE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX:
+    case SQLCOM_INSERT:
+    case SQLCOM_INSERT_SELECT:
+    case SQLCOM_REPLACE:
+    case SQLCOM_REPLACE_SELECT:
+    case SQLCOM_UPDATE:
+    case SQLCOM_UPDATE_MULTI:
+    case SQLCOM_DELETE:
+    case SQLCOM_DELETE_MULTI:
+    case SQLCOM_SELECT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** Table DDL that TiDB runs as a DDL job. */
+static bool is_table_ddl(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_CREATE_TABLE:
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_DROP_TABLE:
+    case SQLCOM_RENAME_TABLE:
+    case SQLCOM_TRUNCATE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** ddl_only: concurrent TiDB DDL jobs, where other statements are barriers */
+static NodeKind node_kind(const SqlCacheNode &node, bool ddl_only) {
+  if (is_session_node(node)) return NodeKind::SESSION;
+  if (!is_table_statement(node.sql_command) || node.fk_change ||
+      node.tables.empty() || (ddl_only && !is_table_ddl(node.sql_command)))
+    return NodeKind::BARRIER;
+  return NodeKind::LANE;
+}
+
+/**
+ * Foreign keys on the target between tables of the schemas the batch
+ * touches, as pairs of "db.table" keys. Returns true on error.
+ */
+static bool load_fk_relations(
+    InceptionContext *ctx,
+    std::vector<std::pair<std::string, std::string>> *relations) {
+  std::set<std::string> schemas;
+  for (const auto &node : ctx->cache_nodes)
+    for (const auto &key : node.tables)
+      schemas.insert(key.substr(0, key.find('.')));
+  if (schemas.empty()) return false;
+
+  PoolConnOptions opts;
+  opts.connect_timeout = 10;
+  opts.read_timeout = 60;
+  std::string host = ctx->host.empty() ? "127.0.0.1" : ctx->host;
+  std::string user = ctx->user.empty() ? "root" : ctx->user;
+  std::string err;
+  MYSQL *mysql = pool_acquire(host, ctx->port, user, ctx->password, opts, &err);
+  if (!mysql) return true;
+
+  bool failed = false;
+  for (const auto &db : schemas) {
+    std::string query =
+        format_sql(remote_sql::FK_RELATIONS, db.c_str(), db.c_str());
+    if (mysql_real_query(mysql, query.c_str(),
+                         static_cast<unsigned long>(query.length()))) {
+      failed = true;
+      break;
+    }
+    MYSQL_RES *res = mysql_store_result(mysql);
+    if (!res) {
+      failed = true;
+      break;
+    }
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(res))) {
+      if (!row[0] || !row[1] || !row[2] || !row[3]) continue;
+      std::string child = std::string(row[0]) + "." + row[1];
+      std::string parent = std::string(row[2]) + "." + row[3];
+      for (auto &c : child) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+      for (auto &c : parent) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+      relations->emplace_back(child, parent);
+    }
+    mysql_free_result(res);
+  }
+  pool_release(mysql, failed ? PoolRelease::DIRTY : PoolRelease::CLEAN);
+  return failed;
+}
+
+/** Cut the batch at barriers. */
+static std::vector<Phase> plan_phases(const InceptionContext &ctx) {
+  std::vector<Phase> phases;
+  const size_t count = ctx.cache_nodes.size();
+  size_t begin = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (node_kind(ctx.cache_nodes[i], ctx.tidb_ddl_jobs) != NodeKind::BARRIER)
+      continue;
+    if (i > begin) phases.push_back({begin, i, false});
+    phases.push_back({i, i + 1, true});
+    begin = i + 1;
+  }
+  if (begin < count) phases.push_back({begin, count, false});
+  return phases;
+}
+
+/**
+ * The statement nodes of each lane of a phase, lanes in the order of their
+ * first statement. A phase of session setup only has one empty lane.
+ */
+static std::vector<std::vector<size_t>> plan_lanes(
+    const InceptionContext &ctx, const Phase &phase,
+    const std::vector<std::pair<std::string, std::string>> &relations) {
+  std::vector<std::vector<size_t>> lanes;
+  if (phase.barrier) {
+    lanes.push_back({phase.begin});
+    return lanes;
+  }
+
+  TableSets sets;
+  for (const auto &rel : relations) sets.join(rel.first, rel.second);
+  for (size_t i = phase.begin; i < phase.end; i++) {
+    const SqlCacheNode &node = ctx.cache_nodes[i];
+    if (node_kind(node, ctx.tidb_ddl_jobs) != NodeKind::LANE) continue;
+    for (size_t t = 1; t < node.tables.size(); t++)
+      sets.join(node.tables[0], node.tables[t]);
+  }
+
+  std::map<std::string, size_t> lane_of;
+  for (size_t i = phase.begin; i < phase.end; i++) {
+    const SqlCacheNode &node = ctx.cache_nodes[i];
+    if (node_kind(node, ctx.tidb_ddl_jobs) != NodeKind::LANE) continue;
+    auto it = lane_of.emplace(sets.find(node.tables[0]), lanes.size()).first;
+    if (it->second == lanes.size()) lanes.emplace_back();
+    lanes[it->second].push_back(i);
+  }
+  if (lanes.empty()) lanes.emplace_back();
+  return lanes;
+}
+
+static Lane build_lane(THD *thd, InceptionContext *ctx, const Phase &phase,
+                       const std::vector<size_t> &statements) {
+  Lane lane;
+  lane.ctx.reset(new InceptionContext);
+  InceptionContext *lc = lane.ctx.get();
+  copy_exec_settings(*ctx, lc);
+  lc->parallel = false;
+  lc->progress_parent = ctx;
+  lc->progress_lane = true;
+  lc->killed.store(ctx->killed.load());
+  lc->paused.store(ctx->paused.load());
+  lc->next_id = ctx->next_id;
+  lc->client_thread_id = thd ? thd->thread_id() : ctx->client_thread_id;
+  lc->client_user = ctx->client_user;
+  lc->client_host = ctx->client_host;
+  if (thd) {
+    const char *user = thd->security_context()->user().str;
+    const char *host = thd->security_context()->host_or_ip().str;
+    lc->client_user = user ? user : "";
+    lc->client_host = host ? host : "";
+  }
+
+  /* Session state at the start of the phase: every SET, the last USE */
+  long last_use = -1;
+  for (size_t i = 0; i < phase.begin; i++)
+    if (ctx->cache_nodes[i].sql_command == SQLCOM_CHANGE_DB)
+      last_use = static_cast<long>(i);
+  for (size_t i = 0; i < phase.begin; i++) {
+    const SqlCacheNode &node = ctx->cache_nodes[i];
+    if (node.sql_command == SQLCOM_SET_OPTION ||
+        static_cast<long>(i) == last_use) {
+      lc->cache_nodes.push_back(node);
+      lane.origin.push_back(-1);
+    }
+  }
+
+  std::set<size_t> mine(statements.begin(), statements.end());
+  for (size_t i = phase.begin; i < phase.end; i++) {
+    const SqlCacheNode &node = ctx->cache_nodes[i];
+    if (!is_session_node(node) && !mine.count(i)) continue;
+    lc->cache_nodes.push_back(node);
+    lane.origin.push_back(static_cast<long>(i));
+  }
+  return lane;
+}
+
+bool execute_parallel(THD *thd, InceptionContext *ctx) {
+  const bool ddl_jobs = ctx->tidb_ddl_jobs;
+  const char *mode =
+      ddl_jobs ? "inception_exec_tidb_ddl_concurrency" : "--enable-parallel";
+  const ulong width =
+      ddl_jobs ? opt_exec_tidb_ddl_concurrency : opt_exec_parallel_per_target;
+
+  /* Same contract as the serial path where it does not apply. With
+     tidb_ddl_jobs set, execute_statements() does not come back here. */
+  auto serial = [&](const char *why) {
+    if (why) {
+      fprintf(stderr, "[Inception] %s: %s, executing serially.\n", mode, why);
+      fflush(stderr);
+    }
+    const bool parallel = ctx->parallel;
+    ctx->parallel = false;
+    bool failed = execute_statements(thd, ctx);
+    ctx->parallel = parallel;
+    return failed;
+  };
+
+  /* Audit findings: the serial path reports the whole batch as skipped */
+  for (const auto &node : ctx->cache_nodes) {
+    if ((node.errlevel >= ERRLEVEL_ERROR && !ctx->force) ||
+        (node.errlevel >= ERRLEVEL_WARNING && !ctx->ignore_warnings))
+      return serial(nullptr);
+  }
+  if (!ctx->resume_batch.empty() ||
+      (opt_exec_checkpoint_dir && *opt_exec_checkpoint_dir))
+    return serial("checkpoints follow batch order");
+
+  std::vector<std::pair<std::string, std::string>> relations;
+  if (load_fk_relations(ctx, &relations))
+    return serial("cannot read foreign keys of the target");
+
+  std::vector<Phase> phases = plan_phases(*ctx);
+  std::vector<std::vector<std::vector<size_t>>> plan;
+  size_t widest = 0;
+  for (const auto &phase : phases) {
+    plan.push_back(plan_lanes(*ctx, phase, relations));
+    widest = std::max(widest, plan.back().size());
+  }
+  if (widest < 2) return serial(nullptr);
+
+  fprintf(stderr,
+          "[Inception] Parallel execution of %zu statements%s: %zu phases, up "
+          "to %zu lanes, %lu at a time.\n",
+          ctx->cache_nodes.size(), ddl_jobs ? " (TiDB DDL jobs)" : "",
+          phases.size(), widest, width);
+  fflush(stderr);
+
+  bool has_error = false;
+  bool stop_exec = false;
+  for (size_t p = 0; p < phases.size(); p++) {
+    const Phase &phase = phases[p];
+
+    /* A failed phase stops the batch unless --enable-force */
+    if (stop_exec) {
+      for (size_t i = phase.begin; i < phase.end; i++) {
+        SqlCacheNode &node = ctx->cache_nodes[i];
+        node.stage = STAGE_SKIPPED;
+        node.stage_status = "Skipped due to prior error";
+        node.append_error("Skipped: previous statement had errors.");
+      }
+      ctx->publish_executed(phase.end);
+      continue;
+    }
+
+    std::vector<Lane> lanes;
+    for (const auto &statements : plan[p])
+      lanes.push_back(build_lane(thd, ctx, phase, statements));
+    std::vector<InceptionContext *> list;
+    {
+      std::lock_guard<std::mutex> lock(ctx->control_mutex);
+      for (auto &lane : lanes) {
+        list.push_back(lane.ctx.get());
+        ctx->lanes.push_back(std::move(lane.ctx));
+      }
+    }
+
+    run_subbatches(ctx, list, width,
+                   [](InceptionContext *lane) {
+                     execute_statements(nullptr, lane);
+                   });
+
+    /* Results back into the batch. A USE / SET replayed by several lanes
+       reports its worst run. */
+    std::vector<bool> merged(ctx->cache_nodes.size(), false);
+    for (size_t l = 0; l < lanes.size(); l++) {
+      InceptionContext *lc = list[l];
+      for (size_t k = 0; k < lc->cache_nodes.size(); k++) {
+        long o = lanes[l].origin[k];
+        if (o < 0) continue;
+        SqlCacheNode &dst = ctx->cache_nodes[o];
+        SqlCacheNode &src = lc->cache_nodes[k];
+        if (merged[o] && src.errlevel <= dst.errlevel) continue;
+        dst = std::move(src);
+        merged[o] = true;
+      }
+    }
+    /* The lanes counted the phase's statements but its USE and SET */
+    int counted = 0;
+    for (InceptionContext *lc : list) counted += lc->executed_sql.load();
+    ctx->publish_executed(phase.end, counted);
+    {
+      std::lock_guard<std::mutex> lock(ctx->control_mutex);
+      ctx->lanes.clear();
+    }
+
+    for (size_t i = phase.begin; i < phase.end; i++) {
+      if (ctx->cache_nodes[i].errlevel >= ERRLEVEL_ERROR) {
+        has_error = true;
+        if (!ctx->force) stop_exec = true;
+      }
+    }
+  }
+  return has_error;
+}
+
+void plan_split_groups(std::vector<SplitNode> *nodes) {
+  std::map<std::string, size_t> last_touch;  /* table -> last group */
+  std::vector<size_t> since_barrier;         /* groups after last barrier */
+  std::vector<bool> followed(nodes->size(), false);
+  long last_barrier = -1;
+
+  for (size_t i = 0; i < nodes->size(); i++) {
+    SplitNode &sn = (*nodes)[i];
+    std::set<size_t> deps;
+    if (sn.barrier) {
+      for (size_t g : since_barrier)
+        if (!followed[g]) deps.insert(g);
+      since_barrier.clear();
+      last_touch.clear();
+    } else {
+      for (const auto &key : sn.tables) {
+        auto it = last_touch.find(key);
+        if (it != last_touch.end()) deps.insert(it->second);
+        last_touch[key] = i;
+      }
+      since_barrier.push_back(i);
+    }
+    if (deps.empty() && last_barrier >= 0)
+      deps.insert(static_cast<size_t>(last_barrier));
+    if (sn.barrier) last_barrier = static_cast<long>(i);
+
+    sn.parallel_group = 1;
+    sn.depends_on.clear();
+    for (size_t d : deps) {
+      followed[d] = true;
+      sn.parallel_group =
+          std::max(sn.parallel_group, (*nodes)[d].parallel_group + 1);
+      sn.depends_on.push_back(static_cast<int>(d) + 1);
+    }
+  }
+}
+
+}  // namespace inception
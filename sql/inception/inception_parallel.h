@@ -0,0 +1,79 @@
+/**
+ * @file inception_parallel.h
+ * @brief Parallel execution of statements on unrelated tables
+ *        (--enable-parallel).
+ *
+ * EXECUTE runs a batch strictly in order on one connection, so forty
+ * ALTERs of forty unrelated tables take forty times one ALTER. With
+ * --enable-parallel=1 the batch is cut into phases at barrier statements:
+ * anything that is not a table statement (CREATE / DROP DATABASE, views,
+ * routines, grants, ...), a CREATE or ALTER TABLE that adds or drops a
+ * foreign key, and a statement whose tables are unknown. A barrier runs
+ * alone, after everything before it and before everything after it.
+ *
+ * Within a phase, statements sharing a table, or touching two tables a
+ * foreign key on the target links, belong to the same lane, so the
+ * dependency graph is a union of the tables each statement touches. The
+ * lanes run side by side, at most inception_exec_parallel_per_target at a
+ * time, each through execute_statements() on its own pooled connection and
+ * in batch order within itself. Each lane replays the session setup (SET
+ * statements and the last USE) that came before its first statement, and
+ * every USE / SET inside the phase, so unqualified names resolve as in
+ * the batch.
+ *
+ * A failed statement stops its own lane; the other lanes of the phase
+ * finish, and without --enable-force the later phases are skipped. Batches
+ * with audit findings, --resume or inception_exec_checkpoint_dir run
+ * serially, as does a batch with nothing to run side by side. Triggers
+ * and views are not followed to the tables behind them.
+ *
+ * On a TiDB 6.2+ target with inception_exec_tidb_ddl_concurrency set, a
+ * batch without --enable-parallel is planned the same way but only table
+ * DDL goes into lanes; DML and everything else is a barrier. TiDB answers
+ * a DDL statement when its job is done, so each lane holds one job on the
+ * wire and at most inception_exec_tidb_ddl_concurrency jobs run at once.
+ * The statement monitor of each lane follows its job in ADMIN SHOW DDL
+ * JOBS for progress and applies the reorg settings (inception_monitor.h).
+ *
+ * SPLIT mode reports the same plan for external runners: each group gets
+ * a parallel_group level and the ids of the groups it depends on. SPLIT
+ * does not connect to the target, so only foreign keys declared in the
+ * batch (REFERENCES) link tables there.
+ */
+
+#ifndef SQL_INCEPTION_PARALLEL_H
+#define SQL_INCEPTION_PARALLEL_H
+
+#include <vector>
+
+#include "my_sqlcommand.h"  // enum_sql_command
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+struct SplitNode;
+
+/** Statements that touch the tables in their table list and nothing else. */
+bool is_table_statement(enum_sql_command cmd);
+
+/**
+ * Execute the batch of ctx in parallel lanes (see above). Same contract as
+ * execute_statements(), which calls it for --enable-parallel batches and,
+ * with ctx->tidb_ddl_jobs set, for concurrent TiDB DDL jobs.
+ * @return true if any statement failed.
+ */
+bool execute_parallel(THD *thd, InceptionContext *ctx);
+
+/**
+ * Fill parallel_group and depends_on of the SPLIT groups in *nodes. A
+ * group depends on the last earlier group sharing one of its tables, a
+ * barrier on every group since the previous barrier that nothing depends
+ * on yet, and each group on the barrier before it. Levels start at 1.
+ */
+void plan_split_groups(std::vector<SplitNode> *nodes);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_PARALLEL_H
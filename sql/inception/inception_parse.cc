@@ -9,12 +9,14 @@
 
 #include "sql/inception/inception_parse.h"
 
+#include <cctype>
 #include <cstdlib>
 #include <cstring>
 #include <string>
 #include <vector>
 
 #include "sql/inception/inception_context.h"
+#include "sql/inception/inception_fanout.h"  // parse_host_list
 #include "sql/inception/inception_sysvars.h"
 #include "include/my_aes.h"
 #include "include/base64.h"
@@ -33,8 +35,10 @@ static const char *find_ci(const char *haystack, size_t haystack_len,
                            const char *needle) {
   size_t needle_len = strlen(needle);
   if (needle_len > haystack_len) return nullptr;
+  const int first = tolower(static_cast<unsigned char>(needle[0]));
   for (size_t i = 0; i <= haystack_len - needle_len; ++i) {
-    if (strncasecmp(haystack + i, needle, needle_len) == 0)
+    if (tolower(static_cast<unsigned char>(haystack[i])) == first &&
+        strncasecmp(haystack + i, needle, needle_len) == 0)
       return haystack + i;
   }
   return nullptr;
@@ -52,22 +56,25 @@ static size_t first_comment_len(const char *p, const char *end) {
   return static_cast<size_t>(close + 2 - p);
 }
 
-bool is_inception_start(const char *query, size_t length) {
-  if (!query || length < 24) return false;
+MagicComment magic_comment(const char *query, size_t length) {
+  static const char PREFIX[] = "inception_magic_";
+  const size_t prefix_len = sizeof(PREFIX) - 1;
+  if (!query || length < 24) return MAGIC_NONE;
   const char *p = skip_whitespace(query, query + length);
   size_t clen = first_comment_len(p, query + length);
-  if (clen == 0) return false;
-  /* Only search within the first comment */
-  return find_ci(p, clen, "inception_magic_start") != nullptr;
-}
-
-bool is_inception_commit(const char *query, size_t length) {
-  if (!query || length < 24) return false;
-  const char *p = skip_whitespace(query, query + length);
-  size_t clen = first_comment_len(p, query + length);
-  if (clen == 0) return false;
-  /* Only search within the first comment */
-  return find_ci(p, clen, "inception_magic_commit") != nullptr;
+  if (clen == 0) return MAGIC_NONE;
+  /* Only search within the first comment; commit wins over start */
+  const char *end = p + clen;
+  MagicComment kind = MAGIC_NONE;
+  for (const char *m = p; (m = find_ci(m, static_cast<size_t>(end - m),
+                                       PREFIX)) != nullptr;
+       m += prefix_len) {
+    const char *word = m + prefix_len;
+    const size_t rest = static_cast<size_t>(end - word);
+    if (rest >= 6 && strncasecmp(word, "commit", 6) == 0) return MAGIC_COMMIT;
+    if (rest >= 5 && strncasecmp(word, "start", 5) == 0) kind = MAGIC_START;
+  }
+  return kind;
 }
 
 /**
@@ -104,35 +111,51 @@ static void parse_option(const char *key, size_t key_len, const char *val,
     ctx->backup = (val_len > 0 && val[0] == '1');
   } else if (match("enable-ignore-warnings")) {
     ctx->ignore_warnings = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-chunked-dml")) {
+    ctx->chunked_dml = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-tidb-batch-dml")) {
+    ctx->tidb_batch_dml = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-verify")) {
+    ctx->verify = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-merge-alter")) {
+    ctx->merge_alter = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-online-alter")) {
+    ctx->online_alter = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-async")) {
+    ctx->async = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-parallel")) {
+    ctx->parallel = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-split-files")) {
+    ctx->split_to_files = (val_len > 0 && val[0] == '1');
+  } else if (match("enable-server-timing")) {
+    ctx->server_timing = (val_len > 0 && val[0] == '1');
   } else if (match("sleep")) {
     ctx->sleep_ms = strtoull(val, nullptr, 10);
+  } else if (match("txn-batch-size")) {
+    ctx->txn_batch_size = static_cast<uint>(strtoul(val, nullptr, 10));
+  } else if (match("priority")) {
+    ctx->priority = static_cast<uint>(strtoul(val, nullptr, 10));
+  } else if (match("resume")) {
+    ctx->resume_batch.assign(val, val_len);
+  } else if (match("schema-file")) {
+    ctx->schema_file.assign(val, val_len);
+  } else if (match("profile")) {
+    ctx->rule_profile.assign(val, val_len);
   } else if (match("slave-hosts") || match("slave_hosts")) {
-    /* Parse "ip1:port1,ip2:port2" format */
-    std::string v(val, val_len);
-    ctx->slave_hosts.clear();
-    size_t pos = 0;
-    while (pos < v.size()) {
-      size_t comma = v.find(',', pos);
-      if (comma == std::string::npos) comma = v.size();
-      std::string entry = v.substr(pos, comma - pos);
-      auto colon = entry.rfind(':');
-      if (colon != std::string::npos) {
-        std::string h = entry.substr(0, colon);
-        uint p = static_cast<uint>(strtoul(entry.c_str() + colon + 1, nullptr, 10));
-        if (!h.empty() && p > 0)
-          ctx->slave_hosts.emplace_back(h, p);
-      }
-      pos = comma + 1;
-    }
+    /* "ip1:port1,ip2:port2" */
+    parse_host_list(std::string(val, val_len), &ctx->slave_hosts);
+  } else if (match("targets")) {
+    parse_host_list(std::string(val, val_len), &ctx->targets);
+  } else if (match("target-group")) {
+    ctx->target_group.assign(val, val_len);
+  } else if (match("dry-run-target")) {
+    ctx->dry_run_target.assign(val, val_len);
+  } else if (match("audit-host")) {
+    ctx->audit_host.assign(val, val_len);
   }
 }
 
-/**
- * Decrypt a password if it has the "AES:" prefix.
- * Uses AES-128-ECB (same as MySQL AES_ENCRYPT/AES_DECRYPT default).
- * Returns the original string if no prefix or decryption fails.
- */
-static std::string decrypt_password(const std::string &encrypted) {
+std::string decrypt_password(const std::string &encrypted) {
   if (encrypted.size() <= 4 || strncmp(encrypted.c_str(), "AES:", 4) != 0)
     return encrypted;
   if (!opt_inception_password_encrypt_key ||
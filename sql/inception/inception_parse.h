@@ -7,6 +7,7 @@
 #define SQL_INCEPTION_PARSE_H
 
 #include <cstddef>
+#include <string>
 
 class THD;
 
@@ -14,17 +15,15 @@ namespace inception {
 
 struct InceptionContext;
 
-/**
- * Check if the query string is an inception_magic_start comment.
- * e.g.: / *--user=root;--host=10.0.0.1;inception_magic_start;* /
- */
-bool is_inception_start(const char *query, size_t length);
+/** The marker of a query's leading comment. */
+enum MagicComment { MAGIC_NONE, MAGIC_START, MAGIC_COMMIT };
 
 /**
- * Check if the query string is an inception_magic_commit comment.
- * e.g.: / *inception_magic_commit;* /
+ * Classify the first comment of the query, scanned once:
+ * MAGIC_START for / *--user=root;--host=10.0.0.1;inception_magic_start;* /,
+ * MAGIC_COMMIT for / *inception_magic_commit;* /.
  */
-bool is_inception_commit(const char *query, size_t length);
+MagicComment magic_comment(const char *query, size_t length);
 
 /**
  * Parse inception_magic_start comment and populate InceptionContext.
@@ -34,6 +33,13 @@ bool is_inception_commit(const char *query, size_t length);
 bool parse_inception_start(const char *query, size_t length,
                            InceptionContext *ctx);
 
+/**
+ * Decrypt a password if it has the "AES:" prefix.
+ * Uses AES-128-ECB (same as MySQL AES_ENCRYPT/AES_DECRYPT default).
+ * Returns the original string if no prefix or decryption fails.
+ */
+std::string decrypt_password(const std::string &encrypted);
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_PARSE_H
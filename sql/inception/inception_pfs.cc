@@ -0,0 +1,351 @@
+/**
+ * @file inception_pfs.cc
+ * @brief performance_schema.inception_sessions and inception_remote_latency.
+ *
+ * The built-in daemon plugin inception_pfs adds two tables through the
+ * pfs_plugin_table service, the way plugin/pfs_table_plugin does:
+ *
+ *   inception_sessions        one row per active session, the fields of
+ *                             "inception show sessions" as typed columns
+ *                             (NULL where that command shows "-").
+ *   inception_remote_latency  the histogram of remote round trips per
+ *                             target, query class (metadata, explain,
+ *                             execute, throttle_poll) and bucket, with the
+ *                             cumulative quantile of each bucket
+ *                             (inception_status.h). TRUNCATE TABLE resets it.
+ *
+ * A scan copies the sessions or histograms once, in rnd_init, and reads
+ * the copy, so the registry mutexes are held only while copying. The
+ * plugin is mandatory: if the tables cannot be added it logs why and
+ * inception runs without them.
+ */
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_status.h"
+#include "sql/mysqld.h"  // srv_registry
+
+#include "mysql/components/services/pfs_plugin_table_service.h"
+#include "mysql/plugin.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace inception {
+
+namespace {
+
+SERVICE_TYPE(pfs_plugin_table) *table_svc = nullptr;
+my_h_service table_svc_handle = nullptr;
+
+void set_string(PSI_field *f, const std::string &s) {
+  table_svc->set_field_varchar_utf8_len(f, s.c_str(),
+                                        static_cast<unsigned int>(s.size()));
+}
+
+void set_ubigint(PSI_field *f, unsigned long long v) {
+  table_svc->set_field_ubigint(f, {v, false});
+}
+
+/* BIGINT, NULL where the value is unknown (negative) */
+void set_bigint_known(PSI_field *f, long long v) {
+  table_svc->set_field_bigint(f, {v, v < 0});
+}
+
+/* INTEGER statement id, NULL for 0 (none) */
+void set_statement_id(PSI_field *f, int id) {
+  table_svc->set_field_integer(f, {id, id <= 0});
+}
+
+/**
+ * Table handle: a copy of the rows taken by rnd_init and the position in
+ * it. pos is what the Performance Schema saves and restores for rnd_pos.
+ */
+template <typename Row>
+struct Snapshot {
+  unsigned int pos = 0;
+  unsigned int next_pos = 0;
+  std::vector<Row> rows;
+};
+
+template <typename Row>
+PSI_table_handle *snapshot_open(PSI_pos **pos) {
+  auto *h = new Snapshot<Row>();
+  *pos = reinterpret_cast<PSI_pos *>(&h->pos);
+  return reinterpret_cast<PSI_table_handle *>(h);
+}
+
+template <typename Row>
+void snapshot_close(PSI_table_handle *handle) {
+  delete reinterpret_cast<Snapshot<Row> *>(handle);
+}
+
+/* A random-position pass (rnd_init(false) before rnd_pos) keeps the copy
+   the positions refer to. */
+template <typename Row, std::vector<Row> (*Load)()>
+int snapshot_rnd_init(PSI_table_handle *handle, bool scan) {
+  auto *h = reinterpret_cast<Snapshot<Row> *>(handle);
+  if (scan || h->rows.empty()) h->rows = Load();
+  return 0;
+}
+
+template <typename Row>
+int snapshot_rnd_next(PSI_table_handle *handle) {
+  auto *h = reinterpret_cast<Snapshot<Row> *>(handle);
+  h->pos = h->next_pos;
+  if (h->pos >= h->rows.size()) return PFS_HA_ERR_END_OF_FILE;
+  h->next_pos = h->pos + 1;
+  return 0;
+}
+
+template <typename Row>
+int snapshot_rnd_pos(PSI_table_handle *handle) {
+  auto *h = reinterpret_cast<Snapshot<Row> *>(handle);
+  return h->pos < h->rows.size() ? 0 : PFS_HA_ERR_RECORD_DELETED;
+}
+
+template <typename Row>
+void snapshot_reset_position(PSI_table_handle *handle) {
+  auto *h = reinterpret_cast<Snapshot<Row> *>(handle);
+  h->pos = 0;
+  h->next_pos = 0;
+}
+
+template <typename Row>
+const Row &current_row(PSI_table_handle *handle) {
+  auto *h = reinterpret_cast<Snapshot<Row> *>(handle);
+  return h->rows[h->pos];
+}
+
+/* ---- inception_sessions ---- */
+
+int sessions_read_column_value(PSI_table_handle *handle, PSI_field *field,
+                               unsigned int index) {
+  const SessionInfo &si = current_row<SessionInfo>(handle);
+  switch (index) {
+    case 0: set_ubigint(field, si.thread_id); break;
+    case 1: set_string(field, si.host); break;
+    case 2: table_svc->set_field_uinteger(field, {si.port, false}); break;
+    case 3: set_string(field, si.user); break;
+    case 4: set_string(field, si.mode); break;
+    case 5: set_string(field, si.db_type); break;
+    case 6: set_ubigint(field, si.sleep_ms); break;
+    case 7: table_svc->set_field_enum(field, {si.paused ? 1ULL : 2ULL, false});
+      break;
+    case 8: table_svc->set_field_integer(field, {si.total_sql, false}); break;
+    case 9: table_svc->set_field_integer(field, {si.executed_sql, false});
+      break;
+    case 10: table_svc->set_field_double(field, {si.elapsed_sec, false});
+      break;
+    case 11: set_ubigint(field, si.threads_running); break;
+    case 12: set_bigint_known(field, si.repl_delay_ms); break;
+    case 13: set_bigint_known(field, si.prefetch_tables); break;
+    case 14: set_bigint_known(field, si.prefetch_ms); break;
+    case 15: set_statement_id(field, si.chunk_node_id); break;
+    case 16: set_bigint_known(field, si.chunks_done); break;
+    case 17: set_bigint_known(field, si.chunk_rows); break;
+    case 18: set_statement_id(field, si.progress_node_id); break;
+    case 19: set_bigint_known(field, si.progress_permille); break;
+    case 20: set_bigint_known(field, si.progress_rate); break;
+    case 21: set_bigint_known(field, si.progress_eta_sec); break;
+    case 22: set_string(field, si.sched); break;
+    default: assert(0); break;
+  }
+  return 0;
+}
+
+unsigned long long sessions_row_count() { return count_active_sessions(); }
+
+void init_sessions_share(PFS_engine_table_share_proxy *share) {
+  share->m_table_name = "inception_sessions";
+  share->m_table_name_length = strlen(share->m_table_name);
+  share->m_table_definition =
+      "THREAD_ID BIGINT UNSIGNED not null, HOST VARCHAR(255), "
+      "PORT INTEGER UNSIGNED, USER VARCHAR(64), MODE VARCHAR(16), "
+      "DB_TYPE VARCHAR(16), SLEEP_MS BIGINT UNSIGNED, "
+      "PAUSED ENUM('YES','NO'), TOTAL_SQL INTEGER, EXECUTED_SQL INTEGER, "
+      "ELAPSED_SEC DOUBLE, THREADS_RUNNING BIGINT UNSIGNED, "
+      "REPL_DELAY_MS BIGINT, PREFETCH_TABLES BIGINT, PREFETCH_MS BIGINT, "
+      "CHUNK_STATEMENT_ID INTEGER, CHUNKS_DONE BIGINT, CHUNK_ROWS BIGINT, "
+      "PROGRESS_STATEMENT_ID INTEGER, PROGRESS_PERMILLE BIGINT, "
+      "PROGRESS_ROWS_PER_SEC BIGINT, PROGRESS_ETA_SEC BIGINT, "
+      "SCHED VARCHAR(32)";
+  share->m_ref_length = sizeof(unsigned int);
+  share->m_acl = READONLY;
+  share->get_row_count = sessions_row_count;
+  share->delete_all_rows = nullptr;
+  share->m_proxy_engine_table = {
+      snapshot_rnd_next<SessionInfo>,
+      snapshot_rnd_init<SessionInfo, get_active_sessions>,
+      snapshot_rnd_pos<SessionInfo>,
+      nullptr, /* no index */
+      nullptr,
+      nullptr,
+      sessions_read_column_value,
+      snapshot_reset_position<SessionInfo>,
+      nullptr, /* read-only */
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      snapshot_open<SessionInfo>,
+      snapshot_close<SessionInfo>};
+}
+
+/* ---- inception_remote_latency ---- */
+
+struct LatencyRow {
+  std::string target;
+  int cls;
+  unsigned int bucket;
+  unsigned long long count;
+  unsigned long long count_and_lower;
+  double quantile;
+};
+
+/* One row per bucket of every histogram */
+std::vector<LatencyRow> load_latency_rows() {
+  std::vector<LatencyRow> rows;
+  for (const RemoteLatency &h : get_remote_latency()) {
+    unsigned long long total = 0;
+    for (uint64_t c : h.counts) total += c;
+    unsigned long long below = 0;
+    for (int b = 0; b < LATENCY_BUCKETS; b++) {
+      below += h.counts[b];
+      rows.push_back({h.target, h.cls, static_cast<unsigned int>(b),
+                      h.counts[b], below,
+                      total ? static_cast<double>(below) / total : 0.0});
+    }
+  }
+  return rows;
+}
+
+int latency_read_column_value(PSI_table_handle *handle, PSI_field *field,
+                              unsigned int index) {
+  const LatencyRow &row = current_row<LatencyRow>(handle);
+  switch (index) {
+    case 0: set_string(field, row.target); break;
+    case 1: set_string(field, remote_query_class_name(row.cls)); break;
+    case 2: table_svc->set_field_uinteger(field, {row.bucket, false}); break;
+    case 3:
+      set_ubigint(field, row.bucket ? LATENCY_BUCKET_US[row.bucket - 1] : 0);
+      break;
+    case 4:
+      if (row.bucket + 1 == LATENCY_BUCKETS)
+        table_svc->set_field_null(field);  /* open bucket */
+      else
+        set_ubigint(field, LATENCY_BUCKET_US[row.bucket]);
+      break;
+    case 5: set_ubigint(field, row.count); break;
+    case 6: set_ubigint(field, row.count_and_lower); break;
+    case 7: table_svc->set_field_double(field, {row.quantile, false}); break;
+    default: assert(0); break;
+  }
+  return 0;
+}
+
+unsigned long long latency_row_count() {
+  return count_remote_latency() * LATENCY_BUCKETS;
+}
+
+int latency_delete_all_rows() {
+  reset_remote_latency();
+  return 0;
+}
+
+void init_latency_share(PFS_engine_table_share_proxy *share) {
+  share->m_table_name = "inception_remote_latency";
+  share->m_table_name_length = strlen(share->m_table_name);
+  share->m_table_definition =
+      "TARGET VARCHAR(255) not null, QUERY_CLASS VARCHAR(16) not null, "
+      "BUCKET_NUMBER INTEGER UNSIGNED not null, "
+      "BUCKET_LOW_US BIGINT UNSIGNED not null, BUCKET_HIGH_US BIGINT UNSIGNED, "
+      "COUNT_BUCKET BIGINT UNSIGNED not null, "
+      "COUNT_BUCKET_AND_LOWER BIGINT UNSIGNED not null, "
+      "BUCKET_QUANTILE DOUBLE not null";
+  share->m_ref_length = sizeof(unsigned int);
+  share->m_acl = TRUNCATABLE;
+  share->get_row_count = latency_row_count;
+  share->delete_all_rows = latency_delete_all_rows;
+  share->m_proxy_engine_table = {
+      snapshot_rnd_next<LatencyRow>,
+      snapshot_rnd_init<LatencyRow, load_latency_rows>,
+      snapshot_rnd_pos<LatencyRow>,
+      nullptr, /* no index */
+      nullptr,
+      nullptr,
+      latency_read_column_value,
+      snapshot_reset_position<LatencyRow>,
+      nullptr, /* read-only */
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      snapshot_open<LatencyRow>,
+      snapshot_close<LatencyRow>};
+}
+
+PFS_engine_table_share_proxy sessions_share;
+PFS_engine_table_share_proxy latency_share;
+PFS_engine_table_share_proxy *shares[] = {&sessions_share, &latency_share};
+
+void release_table_service() {
+  srv_registry->release(table_svc_handle);
+  table_svc_handle = nullptr;
+  table_svc = nullptr;
+}
+
+}  // namespace
+
+static int inception_pfs_init(void *) {
+  if (srv_registry->acquire("pfs_plugin_table", &table_svc_handle)) {
+    fprintf(stderr,
+            "[Inception] pfs_plugin_table service not found, "
+            "performance_schema.inception_* tables disabled\n");
+    fflush(stderr);
+    table_svc_handle = nullptr;
+    return 0;
+  }
+  table_svc =
+      reinterpret_cast<SERVICE_TYPE(pfs_plugin_table) *>(table_svc_handle);
+
+  init_sessions_share(&sessions_share);
+  init_latency_share(&latency_share);
+  if (table_svc->add_tables(shares, array_elements(shares))) {
+    fprintf(stderr,
+            "[Inception] Cannot add performance_schema.inception_* tables\n");
+    fflush(stderr);
+    release_table_service();
+  }
+  return 0;
+}
+
+static int inception_pfs_deinit(void *) {
+  if (!table_svc) return 0;
+  int ret = table_svc->delete_tables(shares, array_elements(shares));
+  release_table_service();
+  return ret;
+}
+
+}  // namespace inception
+
+static struct st_mysql_daemon inception_pfs_plugin = {
+    MYSQL_DAEMON_INTERFACE_VERSION};
+
+mysql_declare_plugin(inception_pfs){
+    MYSQL_DAEMON_PLUGIN,
+    &inception_pfs_plugin,
+    "inception_pfs",
+    "Inception",
+    "performance_schema tables of inception sessions and remote latency",
+    PLUGIN_LICENSE_GPL,
+    inception::inception_pfs_init,   /* Plugin Init */
+    nullptr,                         /* Plugin Check uninstall */
+    inception::inception_pfs_deinit, /* Plugin Deinit */
+    0x0100,                          /* 1.0 */
+    nullptr,                         /* Status Variables */
+    nullptr,                         /* System Variables */
+    nullptr,                         /* Config options */
+    0,                               /* Flags */
+} mysql_declare_plugin_end;
@@ -0,0 +1,410 @@
+/**
+ * @file inception_pool.cc
+ * @brief Remote connection pool shared by inception sessions.
+ */
+
+#include "sql/inception/inception_pool.h"
+
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "include/mysql_com_server.h"
+#include "include/sha1.h"
+#include "include/sql_common.h"
+#include "include/violite.h"
+#include "my_byteorder.h"  // uint3korr
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace inception {
+
+using Clock = std::chrono::steady_clock;
+
+/* Connections idle for less than this are reused without a COM_PING. */
+static constexpr auto PING_AFTER_IDLE = std::chrono::seconds(1);
+
+namespace {
+
+/* Net timeouts the connection had right after connect, restored on release. */
+struct NetDefaults {
+  unsigned int read_timeout;
+  unsigned int write_timeout;
+};
+
+struct IdleConn {
+  MYSQL *mysql;
+  NetDefaults defaults;
+  Clock::time_point since;
+};
+
+struct PoolTarget {
+  std::string target;  /* host:port */
+  std::string user;
+  std::deque<IdleConn> idle;  /* most recently released at the back */
+  int in_use = 0;
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+};
+
+struct Lease {
+  std::string key;
+  NetDefaults defaults;
+};
+
+}  // namespace
+
+static InceptionMutex g_pool_mutex("connection_pool");
+static std::map<std::string, PoolTarget> g_targets;  /* key: pool_key() */
+static std::map<MYSQL *, Lease> g_leases;
+
+/** "host:port/user/sha1hex(password)" — the password itself is never kept. */
+static std::string pool_key(const std::string &host, uint port,
+                            const std::string &user,
+                            const std::string &password) {
+  uint8 digest[SHA1_HASH_SIZE];
+  compute_sha1_hash(digest, password.data(), password.size());
+  static const char hex[] = "0123456789abcdef";
+  std::string key = host + ":" + std::to_string(port) + "/" + user + "/";
+  for (uint8 b : digest) {
+    key += hex[b >> 4];
+    key += hex[b & 0x0f];
+  }
+  return key;
+}
+
+/** Move idle connections older than the idle timeout into *out. Lock held. */
+static void collect_expired(Clock::time_point now, std::vector<MYSQL *> *out) {
+  auto timeout = std::chrono::seconds(opt_conn_pool_idle_timeout);
+  for (auto &pair : g_targets) {
+    auto &idle = pair.second.idle;
+    while (!idle.empty() && now - idle.front().since >= timeout) {
+      out->push_back(idle.front().mysql);
+      idle.pop_front();
+    }
+  }
+}
+
+/* ---- Protocol compression (inception_remote_compression) ---- */
+
+/** Compression of one target; algorithm empty = uncompressed. */
+struct Compression {
+  std::string algorithm;  /* "zstd" or "zlib" */
+  unsigned int level = 0; /* zstd only, 0 = client default */
+};
+
+static std::string trim(const std::string &s) {
+  size_t b = 0, e = s.size();
+  while (b < e && isspace(static_cast<unsigned char>(s[b]))) b++;
+  while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) e--;
+  return s.substr(b, e - b);
+}
+
+/**
+ * The inception_remote_compression entry of host:port, else the entry
+ * without a target. Unknown algorithms are skipped.
+ */
+static Compression compression_for(const std::string &host, uint port) {
+  Compression fallback;
+  const char *opt = opt_remote_compression;
+  if (!opt || !*opt) return fallback;
+  const std::string rules(opt);
+  const std::string target = host + ":" + std::to_string(port);
+  size_t pos = 0;
+  while (pos < rules.size()) {
+    size_t semi = rules.find(';', pos);
+    if (semi == std::string::npos) semi = rules.size();
+    std::string entry = trim(rules.substr(pos, semi - pos));
+    pos = semi + 1;
+    std::string who;
+    size_t eq = entry.find('=');
+    if (eq != std::string::npos) {
+      who = trim(entry.substr(0, eq));
+      entry = trim(entry.substr(eq + 1));
+    }
+    size_t colon = entry.find(':');
+    std::string algorithm = entry.substr(0, colon);
+    for (auto &c : algorithm)
+      c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    Compression c;
+    if (algorithm == "zstd" || algorithm == "zlib")
+      c.algorithm = algorithm;
+    else if (algorithm != "off")
+      continue;
+    if (colon != std::string::npos && algorithm == "zstd") {
+      unsigned long level = strtoul(entry.c_str() + colon + 1, nullptr, 10);
+      c.level = static_cast<unsigned int>(std::min(std::max(level, 1UL), 22UL));
+    }
+    if (who == target) return c;
+    if (who.empty() || who == "*") fallback = c;
+  }
+  return fallback;
+}
+
+/* No-op: the header hooks are only installed to count */
+static void before_header(NET *, void *, size_t) {}
+
+/**
+ * Count the packet whose header was just read: count header bytes (7
+ * with compression) and the payload length it announces on the wire,
+ * and the payload as it is after decompression.
+ */
+static void after_header(NET *net, void *, size_t count, bool rc) {
+  if (rc) return;
+  const uchar *header = net->buff + net->where_b;
+  const size_t length = uint3korr(header);
+  size_t unpacked = count + length;
+  if (net->compress) {
+    const size_t original = uint3korr(header + NET_HEADER_SIZE);
+    unpacked = original ? original : length;
+  }
+  status_add(STATUS_REMOTE_WIRE_BYTES_RECEIVED, count + length);
+  status_add(STATUS_REMOTE_BYTES_RECEIVED, unpacked);
+}
+
+/**
+ * Net extension of a pooled connection: its compression context in the
+ * server build (client.cc keeps it there) and the header hooks that count
+ * received bytes. Freed by close_conn().
+ */
+static NET_SERVER *new_net_extension() {
+  NET_SERVER *extn = new NET_SERVER();
+  extn->m_before_header = before_header;
+  extn->m_after_header = after_header;
+  extn->m_user_data = extn;  /* non-null enables the hooks */
+  extn->compress_ctx.algorithm = MYSQL_UNCOMPRESSED;
+  return extn;
+}
+
+/** mysql_close() and free the net extension of new_net_extension(). */
+static void close_conn(MYSQL *mysql) {
+  NET_SERVER *extn = MYSQL_EXTENSION_PTR(mysql)->server_extn;
+  mysql_close(mysql);
+  delete extn;
+}
+
+static void close_all(const std::vector<MYSQL *> &conns) {
+  for (MYSQL *m : conns) close_conn(m);
+}
+
+/** Apply per-borrow timeouts and reconnect flag. */
+static void apply_options(MYSQL *mysql, const NetDefaults &defaults,
+                          const PoolConnOptions &opts) {
+  mysql->options.read_timeout = opts.read_timeout;
+  mysql->options.write_timeout = opts.write_timeout;
+  my_net_set_read_timeout(&mysql->net, opts.read_timeout ? opts.read_timeout
+                                                         : defaults.read_timeout);
+  my_net_set_write_timeout(&mysql->net, opts.write_timeout
+                                            ? opts.write_timeout
+                                            : defaults.write_timeout);
+  /* mysql_reconnect() ends the compression context the new connection
+     shares with the old one: compressed connections report the error */
+  mysql->reconnect = opts.reconnect && !mysql->net.compress;
+}
+
+static MYSQL *open_conn(const std::string &host, uint port,
+                        const std::string &user, const std::string &password,
+                        unsigned int connect_timeout,
+                        const Compression &compression, NetDefaults *defaults,
+                        std::string *errmsg) {
+  MYSQL *mysql = mysql_init(nullptr);
+  if (!mysql) {
+    *errmsg = "mysql_init() failed: out of memory";
+    return nullptr;
+  }
+  mysql_extension_set_server_extn(mysql, new_net_extension());
+  mysql_options(mysql, MYSQL_SET_CHARSET_NAME, "utf8mb4");
+  mysql_options(mysql, MYSQL_OPT_CONNECT_TIMEOUT, &connect_timeout);
+  if (!compression.algorithm.empty()) {
+    /* Uncompressed when the server lacks the algorithm (zstd before 8.0.18) */
+    const std::string algorithms = compression.algorithm + ",uncompressed";
+    mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS, algorithms.c_str());
+    if (compression.level > 0)
+      mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL,
+                    &compression.level);
+  }
+  if (!mysql_real_connect(mysql, host.c_str(), user.c_str(),
+                          password.empty() ? nullptr : password.c_str(),
+                          nullptr, port, nullptr, 0)) {
+    *errmsg = mysql_error(mysql);
+    close_conn(mysql);
+    return nullptr;
+  }
+  /* client.cc attaches the extension to the net only to compress */
+  if (!mysql->net.extension)
+    mysql->net.extension = MYSQL_EXTENSION_PTR(mysql)->server_extn;
+  defaults->read_timeout = mysql->net.read_timeout;
+  defaults->write_timeout = mysql->net.write_timeout;
+  return mysql;
+}
+
+MYSQL *pool_acquire(const std::string &host, uint port, const std::string &user,
+                    const std::string &password, const PoolConnOptions &opts,
+                    std::string *errmsg) {
+  /* Connections of another compression setting are not reused */
+  const Compression compression = compression_for(host, port);
+  std::string key = pool_key(host, port, user, password);
+  if (!compression.algorithm.empty())
+    key += "/" + compression.algorithm + ":" +
+           std::to_string(compression.level);
+  std::vector<MYSQL *> to_close;
+
+  for (;;) {
+    IdleConn cand{nullptr, {0, 0}, Clock::time_point()};
+    {
+      std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+      collect_expired(Clock::now(), &to_close);
+      PoolTarget &t = g_targets[key];
+      if (t.target.empty()) {
+        t.target = host + ":" + std::to_string(port);
+        t.user = user;
+      }
+      if (!t.idle.empty()) {
+        cand = t.idle.back();
+        t.idle.pop_back();
+      } else {
+        t.misses++;
+      }
+      /* Counted as in use while being health-checked or connected. */
+      t.in_use++;
+    }
+    close_all(to_close);
+    to_close.clear();
+
+    if (!cand.mysql) break;
+
+    bool healthy = true;
+    if (Clock::now() - cand.since >= PING_AFTER_IDLE)
+      healthy = !simple_command(cand.mysql, COM_PING, nullptr, 0, 0);
+
+    std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+    PoolTarget &t = g_targets[key];
+    if (healthy) {
+      t.hits++;
+      g_leases[cand.mysql] = Lease{key, cand.defaults};
+      apply_options(cand.mysql, cand.defaults, opts);
+      return cand.mysql;
+    }
+    t.in_use--;
+    to_close.push_back(cand.mysql);
+    /* Dead connection: close it and try the next idle one. */
+  }
+
+  NetDefaults defaults{0, 0};
+  MYSQL *mysql = open_conn(host, port, user, password, opts.connect_timeout,
+                           compression, &defaults, errmsg);
+  std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+  if (!mysql) {
+    g_targets[key].in_use--;
+    return nullptr;
+  }
+  g_leases[mysql] = Lease{key, defaults};
+  apply_options(mysql, defaults, opts);
+  return mysql;
+}
+
+int pool_select_db(MYSQL *mysql, const char *db) {
+  if (mysql->db && strcmp(mysql->db, db) == 0) return 0;
+  return mysql_select_db(mysql, db);
+}
+
+/** Bring a returned connection back to a neutral session state. */
+static bool reset_conn(MYSQL *mysql, PoolRelease state) {
+  if (!mysql->net.vio || mysql->status != MYSQL_STATUS_READY) return false;
+  if (state == PoolRelease::CLEAN) return true;
+
+  if (state == PoolRelease::DIRTY) {
+    free_old_query(mysql);
+    if (simple_command(mysql, COM_RESET_CONNECTION, nullptr, 0, 0))
+      return false;
+    mysql->insert_id = 0;
+    mysql->affected_rows = ~(my_ulonglong)0;
+    /* The reset restores the server's default charset. */
+    if (mysql_set_character_set(mysql, "utf8mb4")) return false;
+  }
+  /* COM_RESET_CONNECTION keeps the default database; neutralize it. User
+     SQL may have switched it behind the tracker's back, so always send. */
+  if (state == PoolRelease::DIRTY)
+    return mysql_select_db(mysql, "information_schema") == 0;
+  /* DB_CHANGED: only pool_select_db() switched it, and a connection that
+     never selected a database has nothing to neutralize. */
+  return !mysql->db || pool_select_db(mysql, "information_schema") == 0;
+}
+
+void pool_release(MYSQL *mysql, PoolRelease state) {
+  if (!mysql) return;
+
+  Lease lease;
+  bool leased = false;
+  {
+    std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+    auto it = g_leases.find(mysql);
+    if (it != g_leases.end()) {
+      lease = it->second;
+      g_leases.erase(it);
+      leased = true;
+    }
+  }
+  if (!leased) {
+    /* Not borrowed from the pool. */
+    mysql_close(mysql);
+    return;
+  }
+
+  /* Restore connection defaults before anything else can block. */
+  PoolConnOptions neutral;
+  neutral.read_timeout = 0;
+  neutral.write_timeout = 0;
+  neutral.reconnect = false;
+  apply_options(mysql, lease.defaults, neutral);
+
+  bool keep = opt_conn_pool_max_idle > 0 && reset_conn(mysql, state);
+
+  std::vector<MYSQL *> to_close;
+  {
+    std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+    PoolTarget &t = g_targets[lease.key];
+    t.in_use--;
+    if (keep && t.idle.size() < opt_conn_pool_max_idle)
+      t.idle.push_back(IdleConn{mysql, lease.defaults, Clock::now()});
+    else
+      to_close.push_back(mysql);
+    /* Shrink targets left over from a lowered cap. */
+    while (t.idle.size() > opt_conn_pool_max_idle) {
+      to_close.push_back(t.idle.front().mysql);
+      t.idle.pop_front();
+    }
+  }
+  close_all(to_close);
+}
+
+std::vector<PoolTargetInfo> get_pool_status() {
+  std::vector<PoolTargetInfo> result;
+  std::vector<MYSQL *> to_close;
+  {
+    std::lock_guard<InceptionMutex> lock(g_pool_mutex);
+    collect_expired(Clock::now(), &to_close);
+    for (const auto &pair : g_targets) {
+      const PoolTarget &t = pair.second;
+      PoolTargetInfo info;
+      info.target = t.target;
+      info.user = t.user;
+      info.idle = static_cast<int>(t.idle.size());
+      info.in_use = t.in_use;
+      info.hits = t.hits;
+      info.misses = t.misses;
+      result.push_back(info);
+    }
+  }
+  close_all(to_close);
+  return result;
+}
+
+}  // namespace inception
@@ -0,0 +1,78 @@
+/**
+ * @file inception_pool.h
+ * @brief Remote connection pool shared by inception sessions.
+ *
+ * Audit, execute, query-tree, replica-lag and kill paths all borrow their
+ * remote connections here instead of paying TCP + TLS + auth each time.
+ * Idle connections are keyed by (host, port, user, SHA1 of password), kept
+ * for inception_conn_pool_idle_timeout seconds, pinged before reuse when
+ * they have been idle for a while, and capped per target by
+ * inception_conn_pool_max_idle.
+ */
+
+#ifndef SQL_INCEPTION_POOL_H
+#define SQL_INCEPTION_POOL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+/** Per-borrow connection settings. */
+struct PoolConnOptions {
+  unsigned int connect_timeout = 5;  /* used only when a new connection is opened */
+  unsigned int read_timeout = 0;     /* 0 = connection default */
+  unsigned int write_timeout = 0;    /* 0 = connection default */
+  bool reconnect = false;
+};
+
+/** What the borrower may have changed on the remote session. */
+enum class PoolRelease {
+  CLEAN,       /* only inception's own fully-qualified queries */
+  DB_CHANGED,  /* a USE may have been sent */
+  DIRTY        /* arbitrary user SQL ran (session vars, temp tables, ...) */
+};
+
+/**
+ * Borrow a connection to host:port as user, opening one if no healthy idle
+ * connection is available. Returns nullptr on failure with *errmsg set to
+ * the client error text. Thread-safe.
+ */
+MYSQL *pool_acquire(const std::string &host, uint port, const std::string &user,
+                    const std::string &password, const PoolConnOptions &opts,
+                    std::string *errmsg);
+
+/**
+ * Give a borrowed connection back. DB_CHANGED/DIRTY connections are reset
+ * first (COM_RESET_CONNECTION for DIRTY, then USE information_schema so the
+ * next borrower cannot inherit a default database); connections that fail
+ * the reset, are not from the pool, or exceed the idle cap are closed.
+ */
+void pool_release(MYSQL *mysql, PoolRelease state);
+
+/**
+ * Make db the default database of a borrowed connection with COM_INIT_DB,
+ * skipping the round trip when it already is (tracked in mysql->db, which
+ * the client library keeps current). Returns non-zero on error.
+ */
+int pool_select_db(MYSQL *mysql, const char *db);
+
+/** Per-target snapshot for "inception show pool". */
+struct PoolTargetInfo {
+  std::string target;  /* host:port */
+  std::string user;
+  int idle;
+  int in_use;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+/** Close expired idle connections and report every known target. */
+std::vector<PoolTargetInfo> get_pool_status();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_POOL_H
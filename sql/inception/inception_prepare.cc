@@ -0,0 +1,330 @@
+/**
+ * @file inception_prepare.cc
+ * @brief Server-side prepared statements for repeated DML shapes.
+ */
+
+#include "sql/inception/inception_prepare.h"
+
+#include "include/mysql.h"
+#include "include/sql_common.h"
+#include "my_alloc.h"      // free_root
+#include "my_byteorder.h"  // int4store, uint2korr, uint4korr
+#include "mysql/service_mysql_alloc.h"  // my_free
+#include "mysqld_error.h"  // ER_UNKNOWN_STMT_HANDLER
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace inception {
+
+/* Prepared statements kept per session (the target caps them globally
+   with max_prepared_stmt_count). */
+static const size_t MAX_PREPARED_STATEMENTS = 64;
+
+namespace {
+
+/** A literal lifted out of the statement text, bound as one ? parameter. */
+struct Literal {
+  enum_field_types type = MYSQL_TYPE_VAR_STRING;
+  bool is_unsigned = false;
+  std::string text;  /* VAR_STRING, NEWDECIMAL */
+  long long ival = 0;
+  double dval = 0;
+};
+
+}  // namespace
+
+static bool is_ident_char(char c) {
+  unsigned char u = static_cast<unsigned char>(c);
+  return isalnum(u) || c == '_' || c == '$' || c == '@' || u >= 0x80;
+}
+
+/** Last word of out, ignoring trailing spaces, upper-cased. */
+static std::string last_word(const std::string &out) {
+  size_t end = out.size();
+  while (end > 0 && isspace(static_cast<unsigned char>(out[end - 1]))) end--;
+  size_t begin = end;
+  while (begin > 0 && is_ident_char(out[begin - 1])) begin--;
+  std::string word = out.substr(begin, end - begin);
+  for (auto &c : word) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+  return word;
+}
+
+/**
+ * Replace the numeric and string literals of sql with ? and collect their
+ * values. Returns false if the statement has no safe template: comments,
+ * double quotes (ANSI_QUOTES), backslash escapes, placeholders already in
+ * the text, or clauses where a literal is not a value (ORDER/GROUP BY
+ * positions, CAST/CONVERT lengths, COLLATE). Introduced, hex and
+ * DATE/TIME/TIMESTAMP literals stay in the template as text.
+ */
+static bool make_template(const std::string &sql, std::string *tmpl,
+                          std::vector<Literal> *lits) {
+  const size_t n = sql.size();
+  tmpl->clear();
+  tmpl->reserve(n);
+  size_t i = 0;
+  while (i < n) {
+    char c = sql[i];
+    if (c == '"' || c == '?' || c == '\\' || c == '{' || c == '#')
+      return false;
+    if ((c == '/' && i + 1 < n && sql[i + 1] == '*') ||
+        (c == '-' && i + 1 < n && sql[i + 1] == '-'))
+      return false;
+
+    if (c == '`') {
+      size_t close = sql.find('`', i + 1);
+      if (close == std::string::npos) return false;
+      tmpl->append(sql, i, close + 1 - i);
+      i = close + 1;
+      continue;
+    }
+
+    if (c == '\'') {
+      /* _utf8mb4'..', N'..', X'..', b'..' */
+      bool introduced = i > 0 && is_ident_char(sql[i - 1]);
+      std::string word = last_word(*tmpl);
+      std::string value;
+      size_t j = i + 1;
+      for (;; j++) {
+        if (j >= n || sql[j] == '\\') return false;
+        if (sql[j] == '\'') {
+          if (j + 1 < n && sql[j + 1] == '\'') {
+            value += '\'';
+            j++;
+            continue;
+          }
+          break;
+        }
+        value += sql[j];
+      }
+      if (introduced || word == "DATE" || word == "TIME" ||
+          word == "TIMESTAMP") {
+        tmpl->append(sql, i, j + 1 - i);
+      } else {
+        Literal lit;
+        lit.type = MYSQL_TYPE_VAR_STRING;
+        lit.text = value;
+        lits->push_back(lit);
+        tmpl->push_back('?');
+      }
+      i = j + 1;
+      continue;
+    }
+
+    if (isdigit(static_cast<unsigned char>(c))) {
+      size_t j = i;
+      bool decimal = false, exponent = false;
+      while (j < n && isdigit(static_cast<unsigned char>(sql[j]))) j++;
+      if (j < n && sql[j] == '.') {
+        decimal = true;
+        for (j++; j < n && isdigit(static_cast<unsigned char>(sql[j])); j++) {
+        }
+      }
+      if (j < n && (sql[j] == 'e' || sql[j] == 'E')) {
+        size_t k = j + 1;
+        if (k < n && (sql[k] == '+' || sql[k] == '-')) k++;
+        if (k < n && isdigit(static_cast<unsigned char>(sql[k]))) {
+          exponent = true;
+          for (j = k; j < n && isdigit(static_cast<unsigned char>(sql[j])); j++) {
+          }
+        }
+      }
+      /* Part of a name (t.1, 1abc) or a hex/bit number (0x1F, 0b01) */
+      if ((i > 0 && sql[i - 1] == '.') || (j < n && is_ident_char(sql[j]))) {
+        size_t k = i;
+        while (k < n && is_ident_char(sql[k])) k++;
+        tmpl->append(sql, i, k - i);
+        i = k;
+        continue;
+      }
+
+      /* Bound with the type the parser would give the literal */
+      Literal lit;
+      std::string num = sql.substr(i, j - i);
+      if (exponent) {
+        lit.type = MYSQL_TYPE_DOUBLE;
+        lit.dval = strtod(num.c_str(), nullptr);
+      } else if (decimal || num.size() > 20) {
+        lit.type = MYSQL_TYPE_NEWDECIMAL;
+        lit.text = num;
+      } else {
+        errno = 0;
+        unsigned long long u = strtoull(num.c_str(), nullptr, 10);
+        if (errno == ERANGE) {
+          lit.type = MYSQL_TYPE_NEWDECIMAL;
+          lit.text = num;
+        } else {
+          lit.type = MYSQL_TYPE_LONGLONG;
+          lit.is_unsigned = u > static_cast<unsigned long long>(LLONG_MAX);
+          lit.ival = static_cast<long long>(u);
+        }
+      }
+      lits->push_back(lit);
+      tmpl->push_back('?');
+      i = j;
+      continue;
+    }
+
+    if (is_ident_char(c)) {
+      size_t j = i;
+      while (j < n && is_ident_char(sql[j])) j++;
+      std::string word = sql.substr(i, j - i);
+      if (strcasecmp(word.c_str(), "ORDER") == 0 ||
+          strcasecmp(word.c_str(), "GROUP") == 0 ||
+          strcasecmp(word.c_str(), "CAST") == 0 ||
+          strcasecmp(word.c_str(), "CONVERT") == 0 ||
+          strcasecmp(word.c_str(), "COLLATE") == 0)
+        return false;
+      tmpl->append(word);
+      i = j;
+      continue;
+    }
+
+    tmpl->push_back(c);
+    i++;
+  }
+  return true;
+}
+
+/**
+ * COM_STMT_PREPARE tmpl and read the response the way libmysql's
+ * cli_read_prepare_result() does (the parameter definitions are skipped).
+ */
+bool PreparedStatements::prepare(const std::string &tmpl, Entry *entry) {
+  free_old_query(m_mysql);
+  if ((*m_mysql->methods->advanced_command)(
+          m_mysql, COM_STMT_PREPARE, nullptr, 0,
+          reinterpret_cast<const uchar *>(tmpl.data()), tmpl.size(), false,
+          nullptr))
+    return true;
+
+  ulong packet_length = cli_safe_read(m_mysql, nullptr);
+  if (packet_length == packet_error || packet_length < 9) return true;
+
+  const uchar *pos = m_mysql->net.read_pos;
+  entry->stmt_id = uint4korr(pos + 1);
+  uint field_count = uint2korr(pos + 5);
+  entry->param_count = uint2korr(pos + 7);
+
+  bool full_metadata = true;
+  if (packet_length >= 12 &&
+      (m_mysql->client_flag & CLIENT_OPTIONAL_RESULTSET_METADATA))
+    full_metadata = *(pos + 12) == RESULTSET_METADATA_FULL;
+
+  if (full_metadata && entry->param_count != 0) {
+    if (!cli_read_metadata(m_mysql, entry->param_count, 7)) return true;
+    free_root(m_mysql->field_alloc, MYF(0));
+  }
+  if (full_metadata && field_count != 0) {
+    if (!cli_read_metadata(m_mysql, field_count, 7)) return true;
+    free_root(m_mysql->field_alloc, MYF(0));
+  }
+  return false;
+}
+
+PreparedResult PreparedStatements::execute(const std::string &sql,
+                                           std::string *err) {
+  /* An auto-reconnect dropped the session's statements with it */
+  if (m_thread_id != m_mysql->thread_id) {
+    m_stmts.clear();
+    m_thread_id = m_mysql->thread_id;
+  }
+
+  std::string tmpl;
+  std::vector<Literal> lits;
+  if (!make_template(sql, &tmpl, &lits)) return PreparedResult::UNSUPPORTED;
+
+  auto it = m_stmts.find(tmpl);
+  if (it == m_stmts.end()) {
+    if (m_stmts.size() >= MAX_PREPARED_STATEMENTS)
+      return PreparedResult::UNSUPPORTED;
+    Entry entry;
+    entry.failed = prepare(tmpl, &entry);
+    if (entry.failed) {
+      fprintf(stderr, "[Inception] Prepare failed, sending as text: %s\n",
+              mysql_error(m_mysql));
+      fflush(stderr);
+    }
+    it = m_stmts.emplace(tmpl, entry).first;
+  }
+  Entry &entry = it->second;
+  if (entry.failed || entry.param_count != lits.size())
+    return PreparedResult::UNSUPPORTED;
+
+  std::vector<MYSQL_BIND> binds(lits.size());
+  std::vector<unsigned long> lengths(lits.size());
+  for (size_t k = 0; k < lits.size(); k++) {
+    Literal &lit = lits[k];
+    MYSQL_BIND &b = binds[k];
+    b.buffer_type = lit.type;
+    if (lit.type == MYSQL_TYPE_LONGLONG) {
+      b.buffer = &lit.ival;
+      b.is_unsigned = lit.is_unsigned;
+    } else if (lit.type == MYSQL_TYPE_DOUBLE) {
+      b.buffer = &lit.dval;
+    } else {
+      b.buffer = &lit.text[0];
+      lengths[k] = static_cast<unsigned long>(lit.text.size());
+      b.buffer_length = lengths[k];
+      b.length = &lengths[k];
+    }
+    fix_param_bind(&b, static_cast<uint>(k));
+  }
+
+  uchar *data = nullptr;
+  ulong length = 0;
+  if (!binds.empty()) {
+    const bool send_named_params =
+        (m_mysql->server_capabilities & CLIENT_QUERY_ATTRIBUTES) != 0;
+    net_clear(&m_mysql->net, true);
+    if (mysql_int_serialize_param_data(
+            &m_mysql->net, static_cast<uint>(binds.size()), binds.data(),
+            nullptr, 1, &data, &length, 1, send_named_params, false))
+      return PreparedResult::UNSUPPORTED;
+  }
+
+  uchar header[9];
+  int4store(header, entry.stmt_id);
+  header[4] = 0;  /* CURSOR_TYPE_NO_CURSOR */
+  int4store(header + 5, 1);  /* iteration count */
+  bool failed =
+      (*m_mysql->methods->advanced_command)(m_mysql, COM_STMT_EXECUTE, header,
+                                            sizeof(header), data, length,
+                                            true, nullptr) ||
+      (*m_mysql->methods->read_query_result)(m_mysql);
+  my_free(data);
+
+  if (failed && mysql_errno(m_mysql) == ER_UNKNOWN_STMT_HANDLER) {
+    /* Statement was not run (session changed under us) */
+    m_stmts.clear();
+    return PreparedResult::UNSUPPORTED;
+  }
+  if (failed) {
+    *err = mysql_error(m_mysql);
+    return PreparedResult::FAILED;
+  }
+  return PreparedResult::OK;
+}
+
+void PreparedStatements::close_all() {
+  if (m_thread_id == m_mysql->thread_id) {
+    for (const auto &kv : m_stmts) {
+      if (kv.second.failed) continue;
+      uchar buff[4];
+      int4store(buff, kv.second.stmt_id);
+      /* No response is sent for COM_STMT_CLOSE */
+      (*m_mysql->methods->advanced_command)(m_mysql, COM_STMT_CLOSE, nullptr,
+                                            0, buff, sizeof(buff), true,
+                                            nullptr);
+    }
+  }
+  m_stmts.clear();
+}
+
+}  // namespace inception
@@ -0,0 +1,69 @@
+/**
+ * @file inception_prepare.h
+ * @brief Server-side prepared statements for repeated DML shapes.
+ *
+ * A batch often carries hundreds of statements that differ only in their
+ * literals (same sqlsha1). Instead of sending each as text, inception
+ * rewrites the statement into a template with its literals replaced by ?,
+ * prepares the template once per remote session (COM_STMT_PREPARE) and
+ * executes every later statement of that shape through the binary protocol
+ * (COM_STMT_EXECUTE) with the literals bound as parameters, so the target
+ * parses and resolves it only once.
+ *
+ * The libmysqlclient mysql_stmt_* API is not linked in the server, so the
+ * commands are sent with advanced_command() and the bound values are
+ * serialized with mysql_int_serialize_param_data() (sql-common).
+ */
+
+#ifndef SQL_INCEPTION_PREPARE_H
+#define SQL_INCEPTION_PREPARE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "include/mysql.h"  // MYSQL
+
+namespace inception {
+
+/** Outcome of PreparedStatements::execute(). */
+enum class PreparedResult {
+  UNSUPPORTED,  /* not run: no safe template or prepare failed, send as text */
+  OK,           /* ran; mysql->affected_rows / warning_count are current */
+  FAILED        /* ran and the target returned an error */
+};
+
+/**
+ * Prepared templates of one remote session, keyed by template text. A
+ * template whose prepare fails is remembered and not tried again.
+ */
+class PreparedStatements {
+ public:
+  explicit PreparedStatements(MYSQL *mysql) : m_mysql(mysql) {}
+
+  /**
+   * Run sql (one bare DML statement) as a prepared statement, preparing
+   * its template on first use. On FAILED *err holds the target's error.
+   */
+  PreparedResult execute(const std::string &sql, std::string *err);
+
+  /** COM_STMT_CLOSE every prepared statement (before the session is reused). */
+  void close_all();
+
+ private:
+  struct Entry {
+    uint32_t stmt_id = 0;
+    unsigned int param_count = 0;
+    bool failed = false;  /* prepare failed: always send as text */
+  };
+
+  bool prepare(const std::string &tmpl, Entry *entry);
+
+  MYSQL *m_mysql;
+  unsigned long m_thread_id = 0;          /* session the entries belong to */
+  std::map<std::string, Entry> m_stmts;   /* key: template text */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_PREPARE_H
@@ -0,0 +1,381 @@
+/**
+ * @file inception_profile.cc
+ * @brief Named rule profiles (inception_rule_profiles, --profile).
+ */
+
+#include "sql/inception/inception_profile.h"
+
+#include "sql/inception/inception_audit.h"  // RulePlan, parse_must_have_columns
+#include "sql/inception/inception_status.h"  // InceptionMutex
+#include "sql/inception/inception_sysvars.h"
+
+#include <sys/stat.h>
+#include <strings.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace inception {
+
+/** A rule variable a profile can set and its valid range. */
+struct RuleVar {
+  const char *name;  /* without the "inception_" prefix */
+  ulong RulePlan::*field;
+  bool level;        /* OFF/WARNING/ERROR */
+  ulong min, max;
+};
+
+#define LEVEL(f) {#f, &RulePlan::f, true, 0, 2}
+#define LIMIT(f, lo, hi) {#f, &RulePlan::f, false, lo, hi}
+static const RuleVar RULE_VARS[] = {
+    LEVEL(check_primary_key),
+    LEVEL(check_table_comment),
+    LEVEL(check_column_comment),
+    LEVEL(check_engine_innodb),
+    LEVEL(check_dml_where),
+    LEVEL(check_dml_limit),
+    LEVEL(check_insert_column),
+    LEVEL(check_select_star),
+    LEVEL(check_nullable),
+    LEVEL(check_foreign_key),
+    LEVEL(check_blob_type),
+    LEVEL(check_index_prefix),
+    LEVEL(check_enum_type),
+    LEVEL(check_set_type),
+    LEVEL(check_bit_type),
+    LEVEL(check_json_type),
+    LEVEL(check_json_blob_text_default),
+    LEVEL(check_create_select),
+    LEVEL(check_identifier),
+    LEVEL(check_not_null_default),
+    LEVEL(check_duplicate_index),
+    LEVEL(check_drop_database),
+    LEVEL(check_drop_table),
+    LEVEL(check_truncate_table),
+    LEVEL(check_delete),
+    LEVEL(check_autoincrement),
+    LEVEL(check_partition),
+    LEVEL(check_orderby_in_dml),
+    LEVEL(check_orderby_rand),
+    LEVEL(check_dml_full_scan),
+    LEVEL(check_dml_filesort),
+    LEVEL(check_dml_binlog_size),
+    LEVEL(check_autoincrement_init_value),
+    LEVEL(check_autoincrement_name),
+    LEVEL(check_timestamp_default),
+    LEVEL(check_column_charset),
+    LEVEL(check_column_default_value),
+    LEVEL(check_identifier_keyword),
+    LEVEL(check_merge_alter_table),
+    LEVEL(check_column_position_rebuild),
+    LEVEL(check_varchar_shrink),
+    LEVEL(check_lossy_type_change),
+    LEVEL(check_decimal_change),
+    LEVEL(check_column_data),
+    LEVEL(check_tidb_merge_alter),
+    LEVEL(check_tidb_varchar_shrink),
+    LEVEL(check_tidb_decimal_change),
+    LEVEL(check_tidb_lossy_type_change),
+    LEVEL(check_tidb_foreign_key),
+    LEVEL(check_index_length),
+    LEVEL(check_insert_values_match),
+    LEVEL(check_insert_duplicate_column),
+    LEVEL(check_column_exists),
+    LEVEL(check_must_have_columns),
+    LIMIT(check_max_indexes, 1, 128),
+    LIMIT(check_max_index_parts, 1, 64),
+    LIMIT(check_max_update_rows, 1, 4294967295UL),
+    LIMIT(check_explain_min_rows, 0, 4294967295UL),
+    LIMIT(check_max_dml_binlog_size, 0, 1048576),
+    LIMIT(check_max_char_length, 1, 255),
+    LIMIT(check_max_primary_key_parts, 1, 64),
+    LIMIT(check_max_table_name_length, 0, 255),
+    LIMIT(check_max_column_name_length, 0, 255),
+    LIMIT(check_max_columns, 0, 4096),
+    LIMIT(check_index_column_max_bytes, 0, 65535),
+    LIMIT(check_index_total_max_bytes, 0, 65535),
+    LIMIT(check_in_count, 0, 4294967295UL),
+};
+#undef LEVEL
+#undef LIMIT
+
+static const size_t RULE_VAR_COUNT = sizeof(RULE_VARS) / sizeof(RULE_VARS[0]);
+
+/** The overrides of one profile, parsed when the file is loaded. */
+struct RuleProfile {
+  std::vector<std::pair<size_t, ulong>> values;  /* RULE_VARS index, value */
+  bool set_support_charset = false;
+  std::string support_charset;
+  bool set_must_have_columns = false;
+  std::vector<RequiredColumn> must_have_columns;
+
+  size_t settings() const {
+    return values.size() + set_support_charset + set_must_have_columns;
+  }
+};
+
+/** One load of the profiles file; shared read-only by the sessions. */
+struct RuleProfileSet {
+  std::string path;
+  time_t loaded = 0;
+  std::map<std::string, RuleProfile> profiles;
+};
+
+static InceptionMutex g_profiles_mutex("rule_profiles");
+static std::shared_ptr<const RuleProfileSet> g_profiles;
+/* Modification time and size of a file, to notice it was rewritten */
+using FileStamp = std::pair<time_t, off_t>;
+
+/* The path and stamp last read, loaded or not, so a file that does not
+   parse is not read again by every session until it changes */
+static std::string g_tried_path;
+static FileStamp g_tried_stamp;
+
+static std::string trim(const std::string &s) {
+  size_t b = s.find_first_not_of(" \t\r\n");
+  if (b == std::string::npos) return "";
+  size_t e = s.find_last_not_of(" \t\r\n");
+  return s.substr(b, e - b + 1);
+}
+
+static bool valid_profile_name(const std::string &name) {
+  if (name.empty()) return false;
+  for (char c : name)
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-')
+      return false;
+  return true;
+}
+
+/** Parse a level or limit value of var. @return true if invalid. */
+static bool parse_rule_value(const RuleVar &var, const std::string &text,
+                             ulong *value) {
+  if (var.level) {
+    static const char *names[] = {"OFF", "WARNING", "ERROR"};
+    for (ulong i = 0; i < 3; i++)
+      if (strcasecmp(text.c_str(), names[i]) == 0) {
+        *value = i;
+        return false;
+      }
+  }
+  if (text.empty() || text[0] == '-' || text[0] == '+') return true;
+  char *end = nullptr;
+  errno = 0;
+  const unsigned long long n = strtoull(text.c_str(), &end, 10);
+  if (*end != '\0' || errno == ERANGE || n < var.min || n > var.max)
+    return true;
+  *value = static_cast<ulong>(n);
+  return false;
+}
+
+/** Parse the profiles file at path into *set. @return true on error. */
+static bool load_profiles(const std::string &path, RuleProfileSet *set,
+                          std::string *err) {
+  std::ifstream in(path);
+  if (!in) {
+    *err = "Cannot open rule profiles file '" + path + "'.";
+    return true;
+  }
+  set->path = path;
+  set->loaded = time(nullptr);
+
+  std::string line;
+  RuleProfile *profile = nullptr;
+  for (int lineno = 1; std::getline(in, line); lineno++) {
+    auto fail = [&](const std::string &what) {
+      *err = path + ":" + std::to_string(lineno) + ": " + what;
+      return true;
+    };
+    line = trim(line);
+    if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+    if (line[0] == '[') {
+      if (line.back() != ']') return fail("expected [profile name].");
+      const std::string name = trim(line.substr(1, line.size() - 2));
+      if (!valid_profile_name(name))
+        return fail("invalid profile name '" + name + "'.");
+      if (set->profiles.count(name))
+        return fail("duplicate profile '" + name + "'.");
+      profile = &set->profiles[name];
+      continue;
+    }
+
+    const size_t eq = line.find('=');
+    if (eq == std::string::npos) return fail("expected variable = value.");
+    if (!profile) return fail("setting outside of a [profile] section.");
+    std::string key = trim(line.substr(0, eq));
+    const std::string value = trim(line.substr(eq + 1));
+    if (strncasecmp(key.c_str(), "inception_", 10) == 0) key.erase(0, 10);
+
+    if (strcasecmp(key.c_str(), "support_charset") == 0) {
+      profile->set_support_charset = true;
+      profile->support_charset = value;
+      continue;
+    }
+    if (strcasecmp(key.c_str(), "must_have_columns") == 0) {
+      profile->set_must_have_columns = true;
+      profile->must_have_columns = parse_must_have_columns(value.c_str());
+      continue;
+    }
+    size_t i = 0;
+    while (i < RULE_VAR_COUNT && strcasecmp(key.c_str(), RULE_VARS[i].name))
+      i++;
+    if (i == RULE_VAR_COUNT)
+      return fail("unknown rule variable '" + key + "'.");
+    ulong n;
+    if (parse_rule_value(RULE_VARS[i], value, &n))
+      return fail("invalid value '" + value + "' for inception_" + key +
+                  (RULE_VARS[i].level
+                       ? " (expected OFF, WARNING or ERROR)."
+                       : " (expected " + std::to_string(RULE_VARS[i].min) +
+                             " to " + std::to_string(RULE_VARS[i].max) +
+                             ")."));
+    bool replaced = false;
+    for (auto &v : profile->values)
+      if (v.first == i) {
+        v.second = n;
+        replaced = true;
+      }
+    if (!replaced) profile->values.emplace_back(i, n);
+  }
+  if (in.bad()) {
+    *err = "Cannot read rule profiles file '" + path + "'.";
+    return true;
+  }
+  return false;
+}
+
+static FileStamp file_stamp(const std::string &path) {
+  struct stat st;
+  if (stat(path.c_str(), &st)) return FileStamp();
+  return FileStamp(st.st_mtime, st.st_size);
+}
+
+/** Load path and swap it in. @return true on error, the old set stays. */
+static bool swap_in(const std::string &path, std::string *err) {
+  auto set = std::make_shared<RuleProfileSet>();
+  const FileStamp stamp = file_stamp(path);
+  const bool failed = !path.empty() && load_profiles(path, set.get(), err);
+
+  std::lock_guard<InceptionMutex> lock(g_profiles_mutex);
+  g_tried_path = path;
+  g_tried_stamp = stamp;
+  if (failed) return true;
+  g_profiles = std::move(set);
+  return false;
+}
+
+bool reload_rule_profiles(std::string *err) {
+  const std::string path = opt_rule_profiles ? opt_rule_profiles : "";
+  if (swap_in(path, err)) return true;
+  std::shared_ptr<const RuleProfileSet> set;
+  {
+    std::lock_guard<InceptionMutex> lock(g_profiles_mutex);
+    set = g_profiles;
+  }
+  fprintf(stderr, "[Inception] Rule profiles: %zu loaded from '%s'.\n",
+          set->profiles.size(), path.c_str());
+  fflush(stderr);
+  return false;
+}
+
+bool apply_rule_profile(const std::string &name, RulePlan *plan,
+                        std::string *err) {
+  const std::string path = opt_rule_profiles ? opt_rule_profiles : "";
+  if (path.empty()) {
+    *err = "--profile needs inception_rule_profiles.";
+    return true;
+  }
+
+  /* Re-read a file that is new or was changed since it was last read */
+  std::shared_ptr<const RuleProfileSet> set;
+  bool stale;
+  const FileStamp stamp = file_stamp(path);
+  {
+    std::lock_guard<InceptionMutex> lock(g_profiles_mutex);
+    set = g_profiles;
+    stale = g_tried_path != path || g_tried_stamp != stamp;
+  }
+  if (stale) {
+    std::string load_err;
+    if (!reload_rule_profiles(&load_err)) {
+      std::lock_guard<InceptionMutex> lock(g_profiles_mutex);
+      set = g_profiles;
+    } else if (!set || set->path != path) {
+      *err = load_err;
+      return true;
+    } else {
+      fprintf(stderr, "[Inception] Rule profiles not reloaded, keeping the "
+              "ones loaded: %s\n", load_err.c_str());
+      fflush(stderr);
+    }
+  }
+  if (!set || set->path != path) {
+    *err = "Rule profiles file '" + path + "' could not be loaded.";
+    return true;
+  }
+
+  auto it = set->profiles.find(name);
+  if (it == set->profiles.end()) {
+    *err = "Unknown rule profile '" + name + "' (see " + path + ").";
+    return true;
+  }
+  const RuleProfile &profile = it->second;
+  for (const auto &v : profile.values)
+    (plan->*RULE_VARS[v.first].field) = v.second;
+  if (profile.set_support_charset)
+    set_support_charset(plan, profile.support_charset.c_str());
+  if (plan->check_must_have_columns == 0)
+    plan->must_have_columns.clear();
+  else if (profile.set_must_have_columns)
+    plan->must_have_columns = profile.must_have_columns;
+  else if (plan->must_have_columns.empty() && opt_must_have_columns)
+    plan->must_have_columns = parse_must_have_columns(opt_must_have_columns);
+  update_column_rules(plan);
+  return false;
+}
+
+std::string rule_plan_fingerprint(const RulePlan &plan) {
+  std::string text;
+  text.reserve(8 * RULE_VAR_COUNT + plan.support_charset.size() + 64);
+  char buf[32];
+  for (size_t i = 0; i < RULE_VAR_COUNT; i++) {
+    snprintf(buf, sizeof(buf), "%lu,", plan.*RULE_VARS[i].field);
+    text += buf;
+  }
+  text += plan.support_charset;
+  for (const RequiredColumn &col : plan.must_have_columns) {
+    snprintf(buf, sizeof(buf), ";%d%d%d%d%d ", static_cast<int>(col.sql_type),
+             col.need_unsigned, col.need_not_null, col.need_auto_increment,
+             col.need_comment);
+    text += buf;
+    text += col.name;
+  }
+  return text;
+}
+
+std::vector<RuleProfileInfo> get_rule_profiles() {
+  std::shared_ptr<const RuleProfileSet> set;
+  {
+    std::lock_guard<InceptionMutex> lock(g_profiles_mutex);
+    set = g_profiles;
+  }
+  std::vector<RuleProfileInfo> result;
+  if (!set) return result;
+  char loaded[32];
+  struct tm tm_buf;
+  localtime_r(&set->loaded, &tm_buf);
+  strftime(loaded, sizeof(loaded), "%Y-%m-%d %H:%M:%S", &tm_buf);
+  for (const auto &pair : set->profiles)
+    result.push_back(
+        {pair.first, pair.second.settings(), set->path, loaded});
+  return result;
+}
+
+}  // namespace inception
@@ -0,0 +1,78 @@
+/**
+ * @file inception_profile.h
+ * @brief Named rule profiles (inception_rule_profiles, --profile).
+ *
+ * A profile file holds [name] sections of "variable = value" lines, each
+ * overriding one rule variable for the sessions that pass --profile=name:
+ *
+ *   # team_a audits strictly, team_b allows wider tables
+ *   [team_a]
+ *   inception_check_primary_key = ERROR
+ *   inception_check_max_indexes = 8
+ *   [team_b]
+ *   check_max_columns = 200
+ *   support_charset = utf8mb4,utf8
+ *
+ * Any variable of the RulePlan can be set, with or without the
+ * "inception_" prefix; levels take OFF/WARNING/ERROR or 0/1/2, limits the
+ * range of their sysvar. What a profile does not set keeps the global
+ * value, so SET GLOBAL still reaches every profile from the next session.
+ *
+ * The file is parsed once into a profile set that sessions share. It is
+ * read again by the next --profile session after the file or the variable
+ * changed, or on "inception reload rule_profiles"; the new set is swapped
+ * in, so a session sees either the old or the new profiles, never a mix.
+ * A file that does not parse is rejected as a whole and the profiles in
+ * use stay.
+ */
+
+#ifndef SQL_INCEPTION_PROFILE_H
+#define SQL_INCEPTION_PROFILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace inception {
+
+struct RulePlan;
+
+/**
+ * Apply profile name on top of plan, compiled from the rule sysvars.
+ * The profiles are (re)loaded first if inception_rule_profiles names
+ * another file than the one loaded.
+ * @return false on success, true with *err set if there is no such profile
+ *         or the file cannot be loaded.
+ */
+bool apply_rule_profile(const std::string &name, RulePlan *plan,
+                        std::string *err);
+
+/**
+ * Re-read inception_rule_profiles and swap the new profiles in
+ * ("inception reload rule_profiles").
+ * @return false on success, true with *err set if the file was rejected;
+ *         the profiles in use are kept then.
+ */
+bool reload_rule_profiles(std::string *err);
+
+/**
+ * Every setting of plan as text: equal for two plans exactly when they
+ * audit alike, whether they came from the sysvars or a profile. Part of
+ * the key of the audit result cache.
+ */
+std::string rule_plan_fingerprint(const RulePlan &plan);
+
+/** A loaded profile, for "inception show rule_profiles". */
+struct RuleProfileInfo {
+  std::string name;
+  size_t settings;  /* variables it overrides */
+  std::string path;
+  std::string loaded;  /* local time the file was read */
+};
+
+/** The loaded profiles, in name order. Thread-safe. */
+std::vector<RuleProfileInfo> get_rule_profiles();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_PROFILE_H
@@ -17,56 +17,488 @@ namespace remote_sql {
 constexpr const char *SHOW_DATABASES_LIKE =
     "SHOW DATABASES LIKE '%s'";
 
-constexpr const char *USE_DATABASE =
-    "USE `%s`";
+// ---- Metadata cache (inception_cache.cc) ----
 
-constexpr const char *SHOW_TABLES_LIKE =
-    "SHOW TABLES LIKE '%s'";
+/* One round trip per table: 'T' row (exists + TABLE_ROWS + data and index
+   bytes + ROW_FORMAT + AVG_ROW_LENGTH), one 'C' row per column in
+   ORDINAL_POSITION order (type, lengths, charset, IS_NULLABLE, COLUMN_TYPE),
+   one 'I' row per index part (name, column, NON_UNIQUE, SUB_PART,
+   INDEX_TYPE) in key order.
+   Arguments: (db, table) x 3. */
+constexpr const char *GET_TABLE_METADATA =
+    "SELECT 'T', TABLE_ROWS, DATA_LENGTH + INDEX_LENGTH, ROW_FORMAT, "
+    "AVG_ROW_LENGTH, NULL, NULL, NULL, NULL, NULL "
+    "FROM information_schema.TABLES "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' "
+    "UNION ALL "
+    "SELECT 'C', COLUMN_NAME, DATA_TYPE, CHARACTER_MAXIMUM_LENGTH, "
+    "NUMERIC_PRECISION, NUMERIC_SCALE, CHARACTER_SET_NAME, IS_NULLABLE, "
+    "COLUMN_TYPE, ORDINAL_POSITION "
+    "FROM information_schema.COLUMNS "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' "
+    "UNION ALL "
+    "SELECT 'I', INDEX_NAME, COLUMN_NAME, NON_UNIQUE, SUB_PART, INDEX_TYPE, "
+    "NULL, NULL, NULL, SEQ_IN_INDEX "
+    "FROM information_schema.STATISTICS "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' "
+    "ORDER BY 10";
 
-constexpr const char *CHECK_COLUMN_EXISTS =
-    "SELECT 1 FROM information_schema.COLUMNS "
-    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' AND COLUMN_NAME='%s'";
+/* Statement-wide preload: GET_TABLE_METADATA for several tables at once.
+   Each %s is the same "('db','t1'),('db','t2'),..." list. */
+constexpr const char *GET_TABLES_METADATA =
+    "SELECT 'T', TABLE_SCHEMA, TABLE_NAME, TABLE_ROWS, "
+    "DATA_LENGTH + INDEX_LENGTH, ROW_FORMAT, AVG_ROW_LENGTH, NULL, NULL, "
+    "NULL, NULL, NULL "
+    "FROM information_schema.TABLES "
+    "WHERE (TABLE_SCHEMA, TABLE_NAME) IN (%s) "
+    "UNION ALL "
+    "SELECT 'C', TABLE_SCHEMA, TABLE_NAME, COLUMN_NAME, DATA_TYPE, "
+    "CHARACTER_MAXIMUM_LENGTH, NUMERIC_PRECISION, NUMERIC_SCALE, "
+    "CHARACTER_SET_NAME, IS_NULLABLE, COLUMN_TYPE, ORDINAL_POSITION "
+    "FROM information_schema.COLUMNS "
+    "WHERE (TABLE_SCHEMA, TABLE_NAME) IN (%s) "
+    "UNION ALL "
+    "SELECT 'I', TABLE_SCHEMA, TABLE_NAME, INDEX_NAME, COLUMN_NAME, "
+    "NON_UNIQUE, SUB_PART, INDEX_TYPE, NULL, NULL, NULL, SEQ_IN_INDEX "
+    "FROM information_schema.STATISTICS "
+    "WHERE (TABLE_SCHEMA, TABLE_NAME) IN (%s) "
+    "ORDER BY 12";
 
-constexpr const char *CHECK_INDEX_EXISTS =
-    "SELECT 1 FROM information_schema.STATISTICS "
-    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' AND INDEX_NAME='%s' LIMIT 1";
+/* Schema-wide prefetch: one set-based query per information_schema table. */
+constexpr const char *PREFETCH_SCHEMA_TABLES =
+    "SELECT TABLE_NAME, TABLE_ROWS, DATA_LENGTH + INDEX_LENGTH, ROW_FORMAT, "
+    "AVG_ROW_LENGTH "
+    "FROM information_schema.TABLES "
+    "WHERE TABLE_SCHEMA='%s'";
 
-constexpr const char *GET_TABLE_ROWS =
-    "SELECT TABLE_ROWS FROM information_schema.TABLES "
-    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s'";
+constexpr const char *PREFETCH_SCHEMA_COLUMNS =
+    "SELECT TABLE_NAME, COLUMN_NAME, DATA_TYPE, CHARACTER_MAXIMUM_LENGTH, "
+    "NUMERIC_PRECISION, NUMERIC_SCALE, CHARACTER_SET_NAME, IS_NULLABLE, "
+    "COLUMN_TYPE "
+    "FROM information_schema.COLUMNS WHERE TABLE_SCHEMA='%s' "
+    "ORDER BY TABLE_NAME, ORDINAL_POSITION";
 
-constexpr const char *GET_COLUMN_INFO =
-    "SELECT DATA_TYPE, CHARACTER_MAXIMUM_LENGTH, "
-    "NUMERIC_PRECISION, NUMERIC_SCALE "
-    "FROM information_schema.COLUMNS "
-    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' AND COLUMN_NAME='%s'";
+constexpr const char *PREFETCH_SCHEMA_INDEXES =
+    "SELECT TABLE_NAME, INDEX_NAME, COLUMN_NAME, NON_UNIQUE, SUB_PART, "
+    "INDEX_TYPE "
+    "FROM information_schema.STATISTICS WHERE TABLE_SCHEMA='%s' "
+    "ORDER BY TABLE_NAME, INDEX_NAME, SEQ_IN_INDEX";
+
+// ---- Shared cache tier (inception_shared.cc) ----
+
+/* Sent to inception_shared_cache_host, not to a target. String arguments
+   are escaped. */
+constexpr const char *SHARED_CREATE_DB =
+    "CREATE DATABASE IF NOT EXISTS inception_shared "
+    "DEFAULT CHARACTER SET utf8mb4";
+
+/* Invalidation version of a target, bumped by every DDL on it */
+constexpr const char *SHARED_CREATE_EPOCH_TABLE =
+    "CREATE TABLE IF NOT EXISTS inception_shared.target_epoch ("
+    "target VARCHAR(255) NOT NULL, epoch BIGINT UNSIGNED NOT NULL, "
+    "PRIMARY KEY (target)) ENGINE=InnoDB";
+
+/* One table's metadata in the snapshot file encoding, valid while epoch is
+   that of its target. Names compare as the target's do with
+   lower_case_table_names = 0. */
+constexpr const char *SHARED_CREATE_META_TABLE =
+    "CREATE TABLE IF NOT EXISTS inception_shared.table_meta ("
+    "target VARCHAR(255) NOT NULL, db_name VARCHAR(64) NOT NULL, "
+    "table_name VARCHAR(64) NOT NULL, epoch BIGINT UNSIGNED NOT NULL, "
+    "loaded_at DATETIME(6) NOT NULL, meta MEDIUMBLOB NOT NULL, "
+    "PRIMARY KEY (target, db_name, table_name)) "
+    "ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_bin";
+
+constexpr const char *SHARED_CREATE_SPEED_TABLE =
+    "CREATE TABLE IF NOT EXISTS inception_shared.rebuild_speed ("
+    "target VARCHAR(255) NOT NULL, algorithm VARCHAR(16) NOT NULL, "
+    "mb_per_sec DOUBLE NOT NULL, PRIMARY KEY (target, algorithm)) "
+    "ENGINE=InnoDB";
+
+/* The target's epoch, then one row per entry of the (db, table) list of
+   that epoch and younger than the TTL; a single row of NULL names if there
+   is none. The list is "('db','table'),...". Args: target, target, ttl
+   seconds, list */
+constexpr const char *SHARED_GET_TABLES =
+    "SELECT e.epoch, m.db_name, m.table_name, m.meta FROM "
+    "(SELECT COALESCE(MAX(epoch), 0) AS epoch "
+    "FROM inception_shared.target_epoch WHERE target = '%s') e "
+    "LEFT JOIN inception_shared.table_meta m ON m.target = '%s' "
+    "AND m.epoch = e.epoch AND m.loaded_at > NOW(6) - INTERVAL %lu SECOND "
+    "AND (m.db_name, m.table_name) IN (%s)";
+
+/* Followed by SHARED_TABLE_ROW tuples */
+constexpr const char *SHARED_PUT_TABLES =
+    "REPLACE INTO inception_shared.table_meta "
+    "(target, db_name, table_name, epoch, loaded_at, meta) VALUES ";
+
+/* Args: target, db, table, epoch read before the load, meta */
+constexpr const char *SHARED_TABLE_ROW =
+    "('%s', '%s', '%s', %llu, NOW(6), '%s')";
+
+/* Arg: target */
+constexpr const char *SHARED_GET_EPOCH =
+    "SELECT epoch FROM inception_shared.target_epoch WHERE target = '%s'";
+
+/* The new epoch is the insert id. Arg: target */
+constexpr const char *SHARED_BUMP_EPOCH =
+    "INSERT INTO inception_shared.target_epoch (target, epoch) "
+    "VALUES ('%s', LAST_INSERT_ID(1)) "
+    "ON DUPLICATE KEY UPDATE epoch = LAST_INSERT_ID(epoch + 1)";
+
+/* Args: target, algorithm */
+constexpr const char *SHARED_GET_SPEED =
+    "SELECT mb_per_sec FROM inception_shared.rebuild_speed "
+    "WHERE target = '%s' AND algorithm = '%s'";
+
+/* Weighted like the local speeds. Args: target, algorithm, MB/s */
+constexpr const char *SHARED_NOTE_SPEED =
+    "INSERT INTO inception_shared.rebuild_speed (target, algorithm, mb_per_sec) "
+    "VALUES ('%s', '%s', %f) ON DUPLICATE KEY UPDATE "
+    "mb_per_sec = 0.7 * mb_per_sec + 0.3 * VALUES(mb_per_sec)";
 
 // ---- Execution phase (inception_exec.cc) ----
 
 constexpr const char *SHOW_WARNINGS =
     "SHOW WARNINGS";
 
+/* --enable-server-timing: the last statement of this connection but its
+   SHOW WARNINGS; timers in picoseconds. A subquery, not
+   PS_CURRENT_THREAD_ID(), which 5.7 lacks */
+constexpr const char *STATEMENT_SERVER_TIMING =
+    "SELECT TIMER_WAIT, LOCK_TIME, ROWS_EXAMINED "
+    "FROM performance_schema.events_statements_history "
+    "WHERE THREAD_ID = (SELECT THREAD_ID FROM performance_schema.threads "
+    "WHERE PROCESSLIST_ID = CONNECTION_ID()) "
+    "AND EVENT_NAME <> 'statement/sql/show_warnings' "
+    "ORDER BY EVENT_ID DESC LIMIT 1";
+
+/* Metadata cache keys: whether the target folds db and table names */
+constexpr const char *SHOW_LOWER_CASE_TABLE_NAMES =
+    "SELECT @@lower_case_table_names";
+
+/* Size cap of a merged multi-row INSERT */
+constexpr const char *SHOW_MAX_ALLOWED_PACKET =
+    "SELECT @@max_allowed_packet";
+
+/* --txn-batch-size transactions */
+constexpr const char *TXN_BEGIN =
+    "BEGIN";
+constexpr const char *TXN_COMMIT =
+    "COMMIT";
+constexpr const char *TXN_ROLLBACK =
+    "ROLLBACK";
+
 constexpr const char *SHOW_THREADS_RUNNING =
     "SHOW GLOBAL STATUS LIKE 'Threads_running'";
 
+/* --dry-run-target: the counters a statement moves on the sandbox */
+constexpr const char *SHOW_DRY_RUN_STATUS =
+    "SHOW GLOBAL STATUS WHERE Variable_name IN ('Innodb_os_log_written', "
+    "'Innodb_rows_read', 'Innodb_row_lock_waits', 'Innodb_row_lock_time')";
+
 constexpr const char *SHOW_SLAVE_STATUS =
     "SHOW SLAVE STATUS";
 
+/* Unpurged undo, enabled by default in INNODB_METRICS */
+constexpr const char *SELECT_HISTORY_LIST_LENGTH =
+    "SELECT `COUNT` FROM information_schema.INNODB_METRICS "
+    "WHERE NAME = 'trx_rseg_history_len'";
+
+/* Redo checkpoint age: lsn - last checkpoint over the redo capacity */
+constexpr const char *SELECT_REDO_CAPACITY =
+    "SELECT @@innodb_log_file_size * @@innodb_log_files_in_group";
+constexpr const char *SHOW_ENGINE_INNODB_STATUS =
+    "SHOW ENGINE INNODB STATUS";
+
+/* p99 statement latency: bucket upper bound (ps) and cumulative count */
+constexpr const char *SELECT_STATEMENT_HISTOGRAM =
+    "SELECT BUCKET_TIMER_HIGH, COUNT_BUCKET "
+    "FROM performance_schema.events_statements_histogram_global "
+    "WHERE COUNT_BUCKET > 0";
+
 constexpr const char *SHOW_GLOBAL_READ_ONLY =
     "SELECT @@GLOBAL.read_only";
 
-// ---- Query tree phase (inception_tree.cc) ----
+/* Chunked DML (--enable-chunked-dml): primary key columns in order. */
+constexpr const char *GET_PRIMARY_KEY =
+    "SELECT s.COLUMN_NAME, c.DATA_TYPE "
+    "FROM information_schema.STATISTICS s "
+    "JOIN information_schema.COLUMNS c "
+    "ON c.TABLE_SCHEMA = s.TABLE_SCHEMA AND c.TABLE_NAME = s.TABLE_NAME "
+    "AND c.COLUMN_NAME = s.COLUMN_NAME "
+    "WHERE s.TABLE_SCHEMA='%s' AND s.TABLE_NAME='%s' "
+    "AND s.INDEX_NAME='PRIMARY' ORDER BY s.SEQ_IN_INDEX";
 
-constexpr const char *GET_TABLE_COLUMNS =
-    "SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+/* inception_exec_partition_rebuild: partitions in definition order, one
+   row each even when subpartitioned. Args: db, table */
+constexpr const char *GET_PARTITION_NAMES =
+    "SELECT PARTITION_NAME FROM information_schema.PARTITIONS "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' "
+    "AND PARTITION_NAME IS NOT NULL "
+    "GROUP BY PARTITION_NAME ORDER BY MIN(PARTITION_ORDINAL_POSITION)";
+
+/* Args: pk, pk, db, table */
+constexpr const char *CHUNK_PK_RANGE =
+    "SELECT MIN(%s), MAX(%s) FROM %s.%s";
+
+/* End of the next chunk. Args: pk, db, table, pk, op (">=" or ">"),
+   lower bound, pk, chunk_size - 1 */
+constexpr const char *CHUNK_NEXT_BOUNDARY =
+    "SELECT %s FROM %s.%s WHERE %s %s %s ORDER BY %s LIMIT %lu, 1";
+
+// ---- Binlog stream (inception_binlog.cc) ----
+
+constexpr const char *SHOW_MASTER_STATUS =
+    "SHOW MASTER STATUS";
+
+/* Columns in row-image order, with signedness and generated flag. */
+constexpr const char *GET_BINLOG_COLUMNS =
+    "SELECT COLUMN_NAME, COLUMN_TYPE, EXTRA FROM information_schema.COLUMNS "
     "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' "
     "ORDER BY ORDINAL_POSITION";
 
+constexpr const char *BINLOG_SETTINGS =
+    "SELECT @@GLOBAL.log_bin, @@GLOBAL.binlog_format, "
+    "@@GLOBAL.binlog_row_image, @@GLOBAL.binlog_row_value_options";
+
+constexpr const char *SELECT_BINLOG_CHECKSUM =
+    "SELECT @@GLOBAL.binlog_checksum";
+
+constexpr const char *SET_MASTER_BINLOG_CHECKSUM =
+    "SET @master_binlog_checksum = @@GLOBAL.binlog_checksum";
+
+/* Heartbeat every second (nanoseconds) while the binlog is idle. */
+constexpr const char *SET_MASTER_HEARTBEAT_PERIOD =
+    "SET @master_heartbeat_period = 1000000000";
+
+// ---- Online schema change (inception_osc.cc) ----
+
+/* Tables the engine refuses: foreign keys (either side) or triggers would
+   not follow the swapped table. Args: db, table, db, table, db, table */
+constexpr const char *OSC_TABLE_BLOCKERS =
+    "SELECT (SELECT COUNT(*) FROM information_schema.REFERENTIAL_CONSTRAINTS "
+    "WHERE (CONSTRAINT_SCHEMA='%s' AND TABLE_NAME='%s') "
+    "OR (UNIQUE_CONSTRAINT_SCHEMA='%s' AND REFERENCED_TABLE_NAME='%s')), "
+    "(SELECT COUNT(*) FROM information_schema.TRIGGERS "
+    "WHERE EVENT_OBJECT_SCHEMA='%s' AND EVENT_OBJECT_TABLE='%s')";
+
+/* Args: db, ghost, old */
+constexpr const char *OSC_LEFTOVER_TABLE =
+    "SELECT TABLE_NAME FROM information_schema.TABLES "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME IN ('%s', '%s') LIMIT 1";
+
+constexpr const char *OSC_BEGIN =
+    "START TRANSACTION";
+
+constexpr const char *OSC_COMMIT =
+    "COMMIT";
+
+constexpr const char *OSC_ROLLBACK =
+    "ROLLBACK";
+
+/* Identifiers below are already quoted. Args: db, ghost, db, table */
+constexpr const char *OSC_CREATE_GHOST =
+    "CREATE TABLE %s.%s LIKE %s.%s";
+
+/* Args: db, ghost, alter specification */
+constexpr const char *OSC_ALTER_GHOST =
+    "ALTER TABLE %s.%s %s";
+
+/* The ghost's secondary indexes, deferred past the copy. Args: db, ghost */
+constexpr const char *OSC_SHOW_CREATE_GHOST =
+    "SHOW CREATE TABLE %s.%s";
+
+/* Appended to the ADD of the deferred indexes: a sorted build while the
+   replay keeps writing */
+constexpr const char *OSC_ADD_INDEXES_ONLINE =
+    ", ALGORITHM=INPLACE, LOCK=NONE";
+
+/* Copies one chunk; binlog replay wins over copied rows (REPLACE vs
+   INSERT IGNORE). Args: db, ghost, columns, columns, db, table, pk, op,
+   lower, pk, upper */
+constexpr const char *OSC_COPY_CHUNK =
+    "INSERT IGNORE INTO %s.%s (%s) SELECT %s FROM %s.%s FORCE INDEX (PRIMARY) "
+    "WHERE %s %s %s AND %s <= %s LOCK IN SHARE MODE";
+
+constexpr const char *OSC_SET_LOCK_WAIT_TIMEOUT =
+    "SET SESSION lock_wait_timeout = %lu";
+
+constexpr const char *OSC_RESET_LOCK_WAIT_TIMEOUT =
+    "SET SESSION lock_wait_timeout = DEFAULT";
+
+/* Args: db, table, db, ghost */
+constexpr const char *OSC_LOCK_TABLES =
+    "LOCK TABLES %s.%s WRITE, %s.%s WRITE";
+
+constexpr const char *UNLOCK_TABLES =
+    "UNLOCK TABLES";
+
+/* Atomic swap under LOCK TABLES. Args: db, table, db, old, db, ghost,
+   db, table */
+constexpr const char *OSC_RENAME_TABLES =
+    "RENAME TABLE %s.%s TO %s.%s, %s.%s TO %s.%s";
+
+constexpr const char *DROP_TABLE_IF_EXISTS =
+    "DROP TABLE IF EXISTS %s.%s";
+
+// ---- Backup (inception_backup.cc) ----
+
+/* Identifiers below are already quoted. Arg: backup db */
+constexpr const char *CREATE_BACKUP_DB =
+    "CREATE DATABASE IF NOT EXISTS %s DEFAULT CHARACTER SET utf8mb4";
+
+/* One row per backed-up statement (same layout as the original Inception).
+   Arg: backup db */
+constexpr const char *CREATE_BACKUP_INFO_TABLE =
+    "CREATE TABLE IF NOT EXISTS %s.`$_$Inception_backup_information$_$` ("
+    "opid_time VARCHAR(50) NOT NULL, "
+    "start_binlog_file VARCHAR(512), start_binlog_pos BIGINT UNSIGNED, "
+    "end_binlog_file VARCHAR(512), end_binlog_pos BIGINT UNSIGNED, "
+    "sql_statement MEDIUMTEXT, host VARCHAR(64), dbname VARCHAR(64), "
+    "tablename VARCHAR(64), port INT, time TIMESTAMP NULL, "
+    "type VARCHAR(20), PRIMARY KEY (opid_time)"
+    ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4";
+
+/* Rollback statements of one table, in binlog order. Args: backup db,
+   table */
+constexpr const char *CREATE_BACKUP_TABLE =
+    "CREATE TABLE IF NOT EXISTS %s.%s ("
+    "id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT, "
+    "rollback_statement MEDIUMTEXT, opid_time VARCHAR(50), "
+    "PRIMARY KEY (id), KEY idx_opid_time (opid_time)"
+    ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4";
+
+/* Followed by "('stmt','opid'),...". Args: backup db, table */
+constexpr const char *INSERT_BACKUP_ROWS =
+    "INSERT INTO %s.%s (rollback_statement, opid_time) VALUES ";
+
+/* Followed by BACKUP_INFO_ROW tuples. Arg: backup db */
+constexpr const char *INSERT_BACKUP_INFO =
+    "REPLACE INTO %s.`$_$Inception_backup_information$_$` "
+    "(opid_time, start_binlog_file, start_binlog_pos, end_binlog_file, "
+    "end_binlog_pos, sql_statement, host, dbname, tablename, port, time, "
+    "type) VALUES ";
+
+/* String arguments are escaped. Args: opid, start file, start pos, end
+   file, end pos, sql, host, db, table, port, type */
+constexpr const char *BACKUP_INFO_ROW =
+    "('%s', '%s', %llu, '%s', %llu, '%s', '%s', '%s', '%s', %u, NOW(), "
+    "'%s')";
+
+/* Rollback statements of a statement that did not commit. Args: backup
+   db, table, opid */
+constexpr const char *DELETE_BACKUP_ROWS =
+    "DELETE FROM %s.%s WHERE opid_time = '%s'";
+
+/* Before images (inception_backup_strategy=SELECT), the first chunk and
+   those after a key. where is "WHERE (cond) AND " or "WHERE ". Args:
+   columns, db, table, where, [pk, key,] pk, chunk rows */
+constexpr const char *IMAGE_FIRST_CHUNK =
+    "SELECT %s FROM %s.%s %s1 = 1 ORDER BY %s LIMIT %lu FOR UPDATE";
+constexpr const char *IMAGE_NEXT_CHUNK =
+    "SELECT %s FROM %s.%s %s%s > %s ORDER BY %s LIMIT %lu FOR UPDATE";
+
 // ---- Session management (inception_context.cc) ----
 
 constexpr const char *KILL_THREAD =
     "KILL %lu";
 
+// ---- Statement load monitor (inception_monitor.cc) ----
+
+constexpr const char *KILL_QUERY =
+    "KILL QUERY %lu";
+
+/* Progress of the current stage of a connection. Arg: processlist id */
+constexpr const char *STAGE_PROGRESS =
+    "SELECT s.WORK_COMPLETED, s.WORK_ESTIMATED "
+    "FROM performance_schema.events_stages_current s "
+    "JOIN performance_schema.threads t ON t.THREAD_ID = s.THREAD_ID "
+    "WHERE t.PROCESSLIST_ID = %lu";
+
+constexpr const char *TIDB_SHOW_DDL_JOBS =
+    "ADMIN SHOW DDL JOBS";
+
+/* TiDB 8.3+. Args: job id, options ("THREAD = n, BATCH_SIZE = n") */
+constexpr const char *TIDB_ALTER_DDL_JOB =
+    "ADMIN ALTER DDL JOBS %lld %s";
+
+/* Args: db, table */
+constexpr const char *TABLE_ROWS_ESTIMATE =
+    "SELECT TABLE_ROWS FROM information_schema.TABLES "
+    "WHERE TABLE_SCHEMA = '%s' AND TABLE_NAME = '%s'";
+
+// ---- Replication heartbeat (inception_heartbeat.cc) ----
+
+constexpr const char *HEARTBEAT_CREATE_TABLE =
+    "CREATE TABLE IF NOT EXISTS %s ("
+    "id INT UNSIGNED NOT NULL PRIMARY KEY COMMENT 'inception server_id', "
+    "ts BIGINT NOT NULL COMMENT 'microseconds since the epoch'"
+    ") ENGINE=InnoDB";
+
+constexpr const char *HEARTBEAT_WRITE =
+    "REPLACE INTO %s (id, ts) VALUES (%lu, %lld)";
+
+constexpr const char *HEARTBEAT_READ =
+    "SELECT ts FROM %s WHERE id = %lu";
+
+// ---- Metadata lock guard (inception_mdl.cc) ----
+
+/* Other sessions with a metadata lock on the table, oldest transaction
+   first. Args: db, table */
+constexpr const char *MDL_BLOCKERS =
+    "SELECT t.PROCESSLIST_ID, m.LOCK_TYPE, m.LOCK_STATUS, "
+    "TIMESTAMPDIFF(SECOND, x.trx_started, NOW()) "
+    "FROM performance_schema.metadata_locks m "
+    "JOIN performance_schema.threads t ON t.THREAD_ID = m.OWNER_THREAD_ID "
+    "LEFT JOIN information_schema.INNODB_TRX x "
+    "ON x.trx_mysql_thread_id = t.PROCESSLIST_ID "
+    "WHERE m.OBJECT_TYPE = 'TABLE' AND m.OBJECT_SCHEMA = '%s' "
+    "AND m.OBJECT_NAME = '%s' AND t.PROCESSLIST_ID IS NOT NULL "
+    "AND t.PROCESSLIST_ID <> CONNECTION_ID() "
+    "ORDER BY x.trx_started IS NULL, x.trx_started LIMIT 5";
+
+constexpr const char *MDL_SET_LOCK_WAIT_TIMEOUT =
+    "SET SESSION lock_wait_timeout = %lu";
+
+constexpr const char *MDL_RESET_LOCK_WAIT_TIMEOUT =
+    "SET SESSION lock_wait_timeout = DEFAULT";
+
+// ---- Parallel lanes (inception_parallel.cc) ----
+
+/* Foreign keys from or to tables of a schema. Args: db, db */
+constexpr const char *FK_RELATIONS =
+    "SELECT CONSTRAINT_SCHEMA, TABLE_NAME, UNIQUE_CONSTRAINT_SCHEMA, "
+    "REFERENCED_TABLE_NAME FROM information_schema.REFERENTIAL_CONSTRAINTS "
+    "WHERE CONSTRAINT_SCHEMA = '%s' OR UNIQUE_CONSTRAINT_SCHEMA = '%s'";
+
+// ---- Replica verification (inception_verify.cc) ----
+
+/* Columns in table order. Args: db, table */
+constexpr const char *VERIFY_COLUMNS =
+    "SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+    "WHERE TABLE_SCHEMA='%s' AND TABLE_NAME='%s' ORDER BY ORDINAL_POSITION";
+
+constexpr const char *VERIFY_GTID_EXECUTED =
+    "SELECT @@GLOBAL.gtid_executed";
+
+/* 0 once the replica executed the set, 1 on timeout. Args: set, seconds */
+constexpr const char *VERIFY_WAIT_GTID =
+    "SELECT WAIT_FOR_EXECUTED_GTID_SET('%s', %lu)";
+
+/* Rows and checksum of a key range. Args: row expression, db, table, pk,
+   op (">=" or ">"), lower bound, pk, upper bound */
+constexpr const char *VERIFY_CHUNK_CHECKSUM =
+    "SELECT COUNT(*), COALESCE(BIT_XOR(CRC32(%s)), 0) FROM %s.%s "
+    "WHERE %s %s %s AND %s <= %s";
+
+// ---- Column data checks (inception_coldata.cc) ----
+
+/* Aggregates of a key range. Args: select list, db, table, pk,
+   op (">=" or ">"), lower bound, pk, upper bound */
+constexpr const char *COLUMN_DATA_CHUNK =
+    "SELECT %s FROM %s.%s WHERE %s %s %s AND %s <= %s";
+
 }  // namespace remote_sql
 }  // namespace inception
 
@@ -0,0 +1,156 @@
+/**
+ * @file inception_resgroup.cc
+ * @brief inception_resource_group: session and background thread binding.
+ */
+
+#include "sql/inception/inception_resgroup.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_status.h"   // InceptionMutex
+#include "sql/inception/inception_sysvars.h"
+#include "sql/debug_sync.h"                     // resource_group_mgr.h
+#include "sql/mdl.h"                            // MDL_EXPLICIT
+#include "sql/resourcegroups/resource_group.h"
+#include "sql/resourcegroups/resource_group_mgr.h"
+#include "sql/sql_class.h"                      // THD
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace inception {
+
+using resourcegroups::Resource_group;
+using resourcegroups::Resource_group_mgr;
+using resourcegroups::Thread_resource_control;
+
+/** What background threads apply, read by the last session that bound. */
+struct WorkerControls {
+  std::string group;
+  Thread_resource_control controls;
+};
+
+static InceptionMutex g_controls_mutex("resource_group_controls");
+static std::shared_ptr<const WorkerControls> g_controls;
+
+/* The last group report_unbound() logged, so a bad setting is said once */
+static InceptionMutex g_report_mutex("resource_group_report");
+static std::string g_reported;
+
+static std::string configured_group() {
+  const char *name = opt_resource_group;
+  return name ? name : "";
+}
+
+static void report_unbound(const std::string &group, const char *why) {
+  {
+    std::lock_guard<InceptionMutex> lock(g_report_mutex);
+    if (g_reported == group) return;
+    g_reported = group;
+  }
+  fprintf(stderr,
+          "[Inception] Resource group '%s' %s; inception threads are not "
+          "bound to it.\n",
+          group.c_str(), why);
+  fflush(stderr);
+}
+
+/**
+ * Move the thread of thd to the group named name ("" = the user default)
+ * as SET RESOURCE GROUP does, and copy the group's controls to *controls.
+ * @return why it failed, nullptr on success.
+ */
+static const char *move_session(THD *thd, const std::string &name,
+                                Thread_resource_control *controls) {
+  Resource_group_mgr *mgr = Resource_group_mgr::instance();
+  MDL_ticket *ticket = nullptr;
+  if (!name.empty() &&
+      mgr->acquire_shared_mdl_for_resource_group(thd, name.c_str(),
+                                                 MDL_EXPLICIT, &ticket, true)) {
+    thd->clear_error();
+    return "cannot be locked";
+  }
+
+  Resource_group *to = name.empty() ? mgr->usr_default_resource_group()
+                                    : mgr->get_resource_group(name);
+  const char *why = nullptr;
+  if (!to)
+    why = "does not exist";
+  else if (to->type() != resourcegroups::Type::USER_RESOURCE_GROUP)
+    why = "is not a USER resource group";
+  else if (!to->enabled())
+    why = "is disabled";
+
+  if (!why) {
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    Resource_group *from = thd->resource_group_ctx()->m_cur_resource_group;
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+    if (from != to && !mgr->move_resource_group(from, to)) {
+      why = "cannot be applied to the thread";
+    } else {
+      mysql_mutex_lock(&thd->LOCK_thd_data);
+      thd->resource_group_ctx()->m_cur_resource_group = to;
+      mysql_mutex_unlock(&thd->LOCK_thd_data);
+      if (controls) *controls = *to->controller();
+    }
+  }
+  if (ticket) mgr->release_shared_mdl_for_resource_group(thd, ticket);
+  return why;
+}
+
+void bind_session_resource_group(THD *thd, InceptionContext *ctx) {
+  const std::string group = configured_group();
+  if (group.empty() && ctx->resource_group.empty()) return;
+  Resource_group_mgr *mgr = Resource_group_mgr::instance();
+  if (!mgr->resource_group_support()) {
+    report_unbound(group, "is not supported by this server");
+    return;
+  }
+
+  /* The variable was cleared: back to the group the thread had */
+  if (group.empty()) {
+    if (move_session(thd, ctx->resource_group_before, nullptr))
+      move_session(thd, std::string(), nullptr);
+    ctx->resource_group.clear();
+    ctx->resource_group_before.clear();
+    return;
+  }
+
+  if (ctx->resource_group.empty()) {
+    mysql_mutex_lock(&thd->LOCK_thd_data);
+    const Resource_group *cur = thd->resource_group_ctx()->m_cur_resource_group;
+    ctx->resource_group_before =
+        cur && !mgr->is_resource_group_default(cur) ? cur->name() : "";
+    mysql_mutex_unlock(&thd->LOCK_thd_data);
+  }
+
+  auto next = std::make_shared<WorkerControls>();
+  next->group = group;
+  const char *why = move_session(thd, group, &next->controls);
+  if (why) {
+    report_unbound(group, why);
+    return;
+  }
+  ctx->resource_group = group;
+  {
+    std::lock_guard<InceptionMutex> lock(g_report_mutex);
+    g_reported.clear();
+  }
+  std::lock_guard<InceptionMutex> lock(g_controls_mutex);
+  g_controls = std::move(next);
+}
+
+void bind_worker_resource_group() {
+  std::shared_ptr<const WorkerControls> current;
+  {
+    std::lock_guard<InceptionMutex> lock(g_controls_mutex);
+    current = g_controls;
+  }
+  if (!current || current->group != configured_group()) return;
+  Thread_resource_control controls = current->controls;
+  if (controls.apply_control())
+    report_unbound(current->group, "cannot be applied to background threads");
+}
+
+}  // namespace inception
@@ -0,0 +1,47 @@
+/**
+ * @file inception_resgroup.h
+ * @brief Binding inception threads to a resource group
+ *        (inception_resource_group).
+ *
+ * Audit and execution run on the client connection threads, and heavy
+ * CHECK or QUERY_TREE sessions compete for CPU with the other clients of
+ * the server. With inception_resource_group naming a USER resource group
+ * (CREATE RESOURCE GROUP ... VCPU = ... THREAD_PRIORITY = ...), every
+ * connection that starts an inception session moves to it, as SET
+ * RESOURCE GROUP would, and the background threads inception starts for
+ * it (jobs, shards, lanes, backup, verification, monitors, log writers)
+ * take its CPU affinity and priority when they start.
+ *
+ * A connection stays in the group until it disconnects, or until a
+ * session starts after the variable changed. Background threads have no
+ * THD: they apply the controls the last bound session read under the
+ * group's metadata lock, and an ALTER RESOURCE GROUP reaches them only
+ * when they are started again.
+ */
+
+#ifndef SQL_INCEPTION_RESGROUP_H
+#define SQL_INCEPTION_RESGROUP_H
+
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+
+/**
+ * Move the thread of thd to inception_resource_group, or back to the group
+ * it had before when the variable was cleared. Called from
+ * inception_magic_start; a group that does not exist, is disabled or is
+ * not a USER group is logged once and leaves the thread where it is.
+ */
+void bind_session_resource_group(THD *thd, InceptionContext *ctx);
+
+/**
+ * Apply the CPU affinity and priority of inception_resource_group to the
+ * calling thread. Called first thing by inception's background threads.
+ */
+void bind_worker_resource_group();
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_RESGROUP_H
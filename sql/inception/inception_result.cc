@@ -1,13 +1,25 @@
 /**
  * @file inception_result.cc
- * @brief Send the 13-column inception result set to the client.
+ * @brief Send the 18-column inception result set to the client.
  *
  * Uses the same Protocol API pattern as mysqld_show_privileges() in sql_show.cc.
  */
 
 #include "sql/inception/inception_result.h"
 
+#include "sql/inception/inception_audit.h"
+#include "sql/inception/inception_batch.h"
+#include "sql/inception/inception_cache.h"
+#include "sql/inception/inception_checkpoint.h"
+#include "sql/inception/inception_component.h"
 #include "sql/inception/inception_context.h"
+#include "sql/inception/inception_job.h"
+#include "sql/inception/inception_kept.h"
+#include "sql/inception/inception_log.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_profile.h"
+#include "sql/inception/inception_sched.h"  // get_admission_status
+#include "sql/inception/inception_spool.h"
 #include "sql/inception/inception_sysvars.h"
 #include "sql/item.h"          // Item_empty_string, Item_return_int
 #include "sql/protocol.h"      // Protocol
@@ -15,6 +27,9 @@
 #include "include/my_aes.h"    // my_aes_encrypt
 #include "include/base64.h"    // base64_encode
 
+#include <algorithm>
+#include <ctime>
+#include <string>
 #include <vector>
 
 namespace inception {
@@ -92,10 +107,8 @@ static const char *sql_type_name(enum_sql_command cmd) {
   return "OTHER";
 }
 
-bool send_inception_results(THD *thd, InceptionContext *ctx) {
-  Protocol *protocol = thd->get_protocol();
-
-  /* Build field list (15 columns) */
+/** The 18 columns of send_inception_results(), plus target for fan-out. */
+static bool send_results_metadata(THD *thd, bool with_target) {
   mem_root_deque<Item *> field_list(thd->mem_root);
   field_list.push_back(new Item_return_int("id", 20, MYSQL_TYPE_LONG));
   field_list.push_back(new Item_empty_string("stage", 64));
@@ -113,67 +126,305 @@ bool send_inception_results(THD *thd, InceptionContext *ctx) {
   field_list.push_back(new Item_empty_string("ddl_algorithm", 16));
   field_list.push_back(new Item_empty_string("db_type", 16));
   field_list.push_back(new Item_empty_string("db_version", 16));
+  field_list.push_back(new Item_empty_string("exec_strategy", 16));
+  field_list.push_back(new Item_empty_string("estimated_time", 64));
+  field_list.push_back(new Item_empty_string("locks_writes", 8));
+  if (with_target) field_list.push_back(new Item_empty_string("target", 128));
 
-  if (thd->send_result_metadata(field_list,
-                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
-    return true;
+  return thd->send_result_metadata(field_list,
+                                   Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF);
+}
 
-  /* Prepare db_type and db_version strings (same for all rows) */
-  const bool profile_unknown = ctx->remote_conn_failed;
-  const char *db_type_str = profile_unknown
-                                ? "Unknown"
-                                : ((ctx->db_type == DbType::TIDB) ? "TiDB" : "MySQL");
-  char db_version_buf[16];
-  if (profile_unknown) {
+/* The SqlCacheNode fields of a result row, for RowSpool */
+static std::vector<std::string> node_fields(const SqlCacheNode &node) {
+  return {std::to_string(node.id),
+          std::to_string(node.stage),
+          std::to_string(static_cast<int>(node.sql_command)),
+          std::to_string(node.errlevel),
+          node.stage_status,
+          node.errmsg,
+          node.sql_text,
+          std::to_string(node.affected_rows),
+          node.sequence,
+          node.backup_dbname,
+          node.execute_time_text(),
+          node.sqlsha1,
+          node.sub_type,
+          node.ddl_algorithm,
+          node.exec_strategy,
+          node.estimated_time,
+          node.locks_writes};
+}
+
+static bool node_from_fields(std::vector<std::string> *f, SqlCacheNode *node) {
+  if (f->size() != 17) return false;
+  node->id = atoi((*f)[0].c_str());
+  node->stage = atoi((*f)[1].c_str());
+  node->sql_command = static_cast<enum_sql_command>(atoi((*f)[2].c_str()));
+  node->errlevel = atoi((*f)[3].c_str());
+  node->stage_status.swap((*f)[4]);
+  node->errmsg.swap((*f)[5]);
+  node->sql_text.swap((*f)[6]);
+  node->affected_rows = strtoll((*f)[7].c_str(), nullptr, 10);
+  node->sequence.swap((*f)[8]);
+  node->backup_dbname.swap((*f)[9]);
+  node->execute_seconds =
+      (*f)[10].empty() ? -1 : strtod((*f)[10].c_str(), nullptr);
+  node->sqlsha1.swap((*f)[11]);
+  node->sub_type.swap((*f)[12]);
+  node->ddl_algorithm.swap((*f)[13]);
+  node->exec_strategy.swap((*f)[14]);
+  node->estimated_time.swap((*f)[15]);
+  node->locks_writes.swap((*f)[16]);
+  return true;
+}
+
+void spool_finished_results(InceptionContext *ctx) {
+  const size_t limit = opt_result_spool_size;
+  if (limit == 0) return;
+  RowSpool &spool = ctx->result_spool;
+
+  switch (ctx->mode) {
+    case OpMode::CHECK:
+      /* Nothing audits a statement again once it is audited; a dry run
+         runs the whole batch at commit */
+      if (ctx->dry_run_sandbox.second != 0) break;
+      for (const auto &node : ctx->cache_nodes) {
+        spool.append(node_fields(node), limit);
+        if (node.errlevel >= ERRLEVEL_ERROR) ctx->spooled_errors++;
+      }
+      ctx->cache_nodes.clear();
+      break;
+    case OpMode::SPLIT:
+      /* The last group may still grow; the others keep what
+         plan_split_groups() needs */
+      for (; ctx->split_spooled + 1 < ctx->split_nodes.size();
+           ctx->split_spooled++) {
+        std::string &text = ctx->split_nodes[ctx->split_spooled].sql_text;
+        spool.append({text}, limit);
+        std::string().swap(text);
+      }
+      break;
+    case OpMode::QUERY_TREE:
+      for (const auto &node : ctx->tree_nodes)
+        spool.append({std::to_string(node.id), node.sql_text,
+                      node.query_tree_json},
+                     limit);
+      ctx->tree_nodes.clear();
+      break;
+    default:
+      break;
+  }
+}
+
+/* @return true, after sending the error */
+static bool spool_read_error() {
+  my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                  "Failed to read the spooled inception results back");
+  return true;
+}
+
+/* Start reading ctx->result_spool. @return true on error (my_error sent). */
+static bool rewind_spool(InceptionContext *ctx) {
+  if (ctx->result_spool.records() == 0 || !ctx->result_spool.rewind())
+    return false;
+  return spool_read_error();
+}
+
+static bool store_result_row(Protocol *protocol, const SqlCacheNode &node,
+                             const char *db_type_str,
+                             const char *db_version_buf,
+                             const char *target) {
+  protocol->start_row();
+  protocol->store((int)node.id);
+  protocol->store(stage_name(node.stage, node.sql_command),
+                  system_charset_info);
+  protocol->store((int)node.errlevel);
+  protocol->store_string(node.stage_status.c_str(), node.stage_status.length(),
+                         system_charset_info);
+  /* errormessage: "None" when no error */
+  if (node.errmsg.empty())
+    protocol->store_string("None", 4, system_charset_info);
+  else
+    protocol->store_string(node.errmsg.c_str(), node.errmsg.length(),
+                           system_charset_info);
+  protocol->store_string(node.sql_text.c_str(), node.sql_text.length(),
+                         system_charset_info);
+  protocol->store((longlong)node.affected_rows);
+  protocol->store_string(node.sequence.c_str(), node.sequence.length(),
+                         system_charset_info);
+  protocol->store_string(node.backup_dbname.c_str(), node.backup_dbname.length(),
+                         system_charset_info);
+  const std::string execute_time = node.execute_time_text();
+  protocol->store_string(execute_time.c_str(), execute_time.length(),
+                         system_charset_info);
+  protocol->store_string(node.sqlsha1.c_str(), node.sqlsha1.length(),
+                         system_charset_info);
+  /* sqltype: base type, or "BASE.SUB_TYPE" when sub_type is set */
+  std::string type_val = sql_type_name(node.sql_command);
+  if (!node.sub_type.empty()) {
+    type_val += ".";
+    type_val += node.sub_type;
+  }
+  protocol->store_string(type_val.c_str(), type_val.length(),
+                         system_charset_info);
+  protocol->store_string(node.ddl_algorithm.c_str(),
+                         node.ddl_algorithm.length(), system_charset_info);
+  protocol->store_string(db_type_str, strlen(db_type_str),
+                         system_charset_info);
+  protocol->store_string(db_version_buf, strlen(db_version_buf),
+                         system_charset_info);
+  protocol->store_string(node.exec_strategy.c_str(),
+                         node.exec_strategy.length(), system_charset_info);
+  protocol->store_string(node.estimated_time.c_str(),
+                         node.estimated_time.length(), system_charset_info);
+  protocol->store_string(node.locks_writes.c_str(), node.locks_writes.length(),
+                         system_charset_info);
+  if (target) protocol->store_string(target, strlen(target), system_charset_info);
+  return protocol->end_row();
+}
+
+/* The db_type and db_version columns of the rows of ctx */
+static const char *result_profile(const InceptionContext *ctx,
+                                  char (&db_version_buf)[16]) {
+  if (ctx->remote_conn_failed) {
     db_version_buf[0] = '\0';
-  } else {
-    snprintf(db_version_buf, sizeof(db_version_buf), "%u.%u",
-             ctx->db_version_major, ctx->db_version_minor);
+    return "Unknown";
   }
+  snprintf(db_version_buf, sizeof(db_version_buf), "%u.%u",
+           ctx->db_version_major, ctx->db_version_minor);
+  return ctx->db_type == DbType::TIDB ? "TiDB" : "MySQL";
+}
+
+/* Add a sent row to kept: node_fields(), db_type, db_version [, target] */
+static void keep_result_row(KeptResults *kept, const SqlCacheNode &node,
+                            const char *db_type_str,
+                            const char *db_version_buf, const char *target) {
+  std::vector<std::string> fields = node_fields(node);
+  fields.emplace_back(db_type_str);
+  fields.emplace_back(db_version_buf);
+  if (target) fields.emplace_back(target);
+  kept->add(fields, node.errlevel);
+}
+
+/**
+ * One row per statement of ctx, the spooled ones first; with target set,
+ * it is stored as the last column. Each row sent is added to kept, if
+ * set. @return true on error.
+ */
+static bool send_result_rows(Protocol *protocol, InceptionContext *ctx,
+                             const char *target, KeptResults *kept) {
+  /* Prepare db_type and db_version strings (same for all rows) */
+  char db_version_buf[16];
+  const char *db_type_str = result_profile(ctx, db_version_buf);
 
   /* Send rows */
+  if (rewind_spool(ctx)) return true;
+  std::vector<std::string> fields;
+  while (ctx->result_spool.next(&fields)) {
+    SqlCacheNode node;
+    if (!node_from_fields(&fields, &node)) return spool_read_error();
+    apply_batch_findings(ctx, &node);
+    if (store_result_row(protocol, node, db_type_str, db_version_buf, target))
+      return true;
+    if (kept) keep_result_row(kept, node, db_type_str, db_version_buf, target);
+  }
+  if (ctx->result_spool.error()) return spool_read_error();
   for (const auto &node : ctx->cache_nodes) {
-    protocol->start_row();
-    protocol->store((int)node.id);
-    protocol->store(stage_name(node.stage, node.sql_command),
-                    system_charset_info);
-    protocol->store((int)node.errlevel);
-    protocol->store_string(node.stage_status.c_str(), node.stage_status.length(),
-                           system_charset_info);
-    /* errormessage: "None" when no error */
-    if (node.errmsg.empty())
-      protocol->store_string("None", 4, system_charset_info);
-    else
-      protocol->store_string(node.errmsg.c_str(), node.errmsg.length(),
-                             system_charset_info);
-    protocol->store_string(node.sql_text.c_str(), node.sql_text.length(),
-                           system_charset_info);
-    protocol->store((longlong)node.affected_rows);
-    protocol->store_string(node.sequence.c_str(), node.sequence.length(),
-                           system_charset_info);
-    protocol->store_string(node.backup_dbname.c_str(), node.backup_dbname.length(),
-                           system_charset_info);
-    protocol->store_string(node.execute_time.c_str(), node.execute_time.length(),
-                           system_charset_info);
-    protocol->store_string(node.sqlsha1.c_str(), node.sqlsha1.length(),
-                           system_charset_info);
-    /* sqltype: base type, or "BASE.SUB_TYPE" when sub_type is set */
-    std::string type_val = sql_type_name(node.sql_command);
-    if (!node.sub_type.empty()) {
-      type_val += ".";
-      type_val += node.sub_type;
+    if (node.spilled) {
+      /* inception_max_session_memory: a copy with the texts read back */
+      SqlCacheNode copy = node;
+      if (ctx->read_node_text(node, &copy.sql_text, &copy.errmsg)) {
+        my_printf_error(ER_UNKNOWN_ERROR, "%s", MYF(0),
+                        "Failed to read a spilled inception statement back");
+        return true;
+      }
+      if (store_result_row(protocol, copy, db_type_str, db_version_buf,
+                           target))
+        return true;
+      if (kept)
+        keep_result_row(kept, copy, db_type_str, db_version_buf, target);
+      continue;
     }
-    protocol->store_string(type_val.c_str(), type_val.length(),
-                           system_charset_info);
-    protocol->store_string(node.ddl_algorithm.c_str(),
-                           node.ddl_algorithm.length(), system_charset_info);
-    protocol->store_string(db_type_str, strlen(db_type_str),
-                           system_charset_info);
-    protocol->store_string(db_version_buf, strlen(db_version_buf),
-                           system_charset_info);
-    if (protocol->end_row()) return true;
+    if (store_result_row(protocol, node, db_type_str, db_version_buf, target))
+      return true;
+    if (kept) keep_result_row(kept, node, db_type_str, db_version_buf, target);
   }
+  return false;
+}
 
+bool send_inception_results(THD *thd, InceptionContext *ctx,
+                            KeptResults *kept) {
+  if (send_results_metadata(thd, false)) return true;
+  if (send_result_rows(thd->get_protocol(), ctx, nullptr, kept)) return true;
+  my_eof(thd);
+  return false;
+}
+
+bool send_fanout_results(THD *thd, InceptionContext *ctx, KeptResults *kept) {
+  if (send_results_metadata(thd, true)) return true;
+  for (const auto &shard : ctx->shards) {
+    char target[128];
+    snprintf(target, sizeof(target), "%s:%u", shard->host.c_str(),
+             shard->port);
+    if (send_result_rows(thd->get_protocol(), shard.get(), target, kept))
+      return true;
+  }
+  my_eof(thd);
+  return false;
+}
+
+void keep_job_results(InceptionContext *ctx, KeptResults *kept) {
+  std::vector<InceptionContext *> parts;
+  if (ctx->shards.empty())
+    parts.push_back(ctx);
+  else
+    for (const auto &shard : ctx->shards) parts.push_back(shard.get());
+  for (InceptionContext *part : parts) {
+    char db_version_buf[16];
+    const char *db_type_str = result_profile(part, db_version_buf);
+    char target[128];
+    snprintf(target, sizeof(target), "%s:%u", part->host.c_str(), part->port);
+    for (const auto &node : part->cache_nodes)
+      keep_result_row(kept, node, db_type_str, db_version_buf,
+                      kept->with_target() ? target : nullptr);
+  }
+}
+
+bool send_kept_results(THD *thd, const KeptResults &kept,
+                       const ResultPage &page) {
+  if (send_results_metadata(thd, kept.with_target())) return true;
+  Protocol *protocol = thd->get_protocol();
+  uint64_t skip = page.offset;
+  uint64_t sent = 0;
+  std::vector<std::string> fields;
+  std::string db_type, db_version, target;
+  for (size_t i = 0; i < kept.rows(); i++) {
+    if (page.limit > 0 && sent == page.limit) break;
+    if (kept.errlevel(i) < page.min_errlevel) continue;
+    if (skip > 0) {
+      skip--;
+      continue;
+    }
+    /* The fields of keep_result_row() */
+    kept.row(i, &fields);
+    if (fields.size() != (kept.with_target() ? 20U : 19U))
+      return spool_read_error();
+    if (kept.with_target()) {
+      target.swap(fields.back());
+      fields.pop_back();
+    }
+    db_version.swap(fields.back());
+    fields.pop_back();
+    db_type.swap(fields.back());
+    fields.pop_back();
+    SqlCacheNode node;
+    if (!node_from_fields(&fields, &node)) return spool_read_error();
+    if (store_result_row(protocol, node, db_type.c_str(), db_version.c_str(),
+                         kept.with_target() ? target.c_str() : nullptr))
+      return true;
+    sent++;
+  }
   my_eof(thd);
   return false;
 }
@@ -265,24 +516,42 @@ bool send_sqltypes_result(THD *thd) {
 bool send_split_results(THD *thd, InceptionContext *ctx) {
   Protocol *protocol = thd->get_protocol();
 
-  /* Build field list: 3 columns */
+  /* Build field list: 5 columns */
   mem_root_deque<Item *> field_list(thd->mem_root);
   field_list.push_back(new Item_return_int("id", 20, MYSQL_TYPE_LONG));
   field_list.push_back(new Item_empty_string("sql_statement", 4096));
   field_list.push_back(new Item_return_int("ddlflag", 20, MYSQL_TYPE_LONG));
+  field_list.push_back(
+      new Item_return_int("parallel_group", 20, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("depends_on", 1024));
 
   if (thd->send_result_metadata(field_list,
                                 Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
     return true;
 
-  /* Send rows */
+  /* Send rows; the sql_text of the first split_spooled is spooled */
+  if (rewind_spool(ctx)) return true;
   int id = 1;
+  std::vector<std::string> spooled;
   for (const auto &sn : ctx->split_nodes) {
+    const std::string *text = &sn.sql_text;
+    if (static_cast<size_t>(id - 1) < ctx->split_spooled) {
+      if (!ctx->result_spool.next(&spooled) || spooled.size() != 1)
+        return spool_read_error();
+      text = &spooled[0];
+    }
     protocol->start_row();
     protocol->store((int)id++);
-    protocol->store_string(sn.sql_text.c_str(), sn.sql_text.length(),
+    protocol->store_string(text->c_str(), text->length(),
                            system_charset_info);
     protocol->store((int)sn.ddlflag);
+    protocol->store((int)sn.parallel_group);
+    std::string deps;
+    for (int d : sn.depends_on) {
+      if (!deps.empty()) deps += ",";
+      deps += std::to_string(d);
+    }
+    protocol->store_string(deps.c_str(), deps.length(), system_charset_info);
     if (protocol->end_row()) return true;
   }
 
@@ -303,7 +572,20 @@ bool send_query_tree_results(THD *thd, InceptionContext *ctx) {
                                 Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
     return true;
 
-  /* Send rows */
+  /* Send rows, the spooled ones first */
+  if (rewind_spool(ctx)) return true;
+  std::vector<std::string> fields;
+  while (ctx->result_spool.next(&fields)) {
+    if (fields.size() != 3) return spool_read_error();
+    protocol->start_row();
+    protocol->store((int)atoi(fields[0].c_str()));
+    protocol->store_string(fields[1].c_str(), fields[1].length(),
+                           system_charset_info);
+    protocol->store_string(fields[2].c_str(), fields[2].length(),
+                           system_charset_info);
+    if (protocol->end_row()) return true;
+  }
+  if (ctx->result_spool.error()) return spool_read_error();
   for (const auto &node : ctx->tree_nodes) {
     protocol->start_row();
     protocol->store((int)node.id);
@@ -386,11 +668,18 @@ bool send_sessions_result(THD *thd) {
   field_list.push_back(new Item_empty_string("mode", 16));
   field_list.push_back(new Item_empty_string("db_type", 16));
   field_list.push_back(new Item_return_int("sleep_ms", 10, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("paused", 1, MYSQL_TYPE_TINY));
   field_list.push_back(new Item_return_int("total_sql", 10, MYSQL_TYPE_LONG));
   field_list.push_back(new Item_return_int("executed_sql", 10, MYSQL_TYPE_LONG));
   field_list.push_back(new Item_empty_string("elapsed", 16));
   field_list.push_back(new Item_return_int("threads_running", 10, MYSQL_TYPE_LONG));
   field_list.push_back(new Item_empty_string("repl_delay", 16));
+  field_list.push_back(
+      new Item_return_int("prefetch_tables", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("prefetch_time", 16));
+  field_list.push_back(new Item_empty_string("chunk_progress", 64));
+  field_list.push_back(new Item_empty_string("sched", 32));
+  field_list.push_back(new Item_empty_string("stmt_progress", 64));
 
   if (thd->send_result_metadata(field_list,
                                 Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
@@ -410,6 +699,7 @@ bool send_sessions_result(THD *thd) {
     protocol->store_string(si.db_type.c_str(), si.db_type.length(),
                            system_charset_info);
     protocol->store_longlong(static_cast<longlong>(si.sleep_ms), true);
+    protocol->store_tiny(si.paused ? 1 : 0);
     protocol->store_long(static_cast<longlong>(si.total_sql));
     protocol->store_long(static_cast<longlong>(si.executed_sql));
     char elapsed_buf[32];
@@ -417,15 +707,444 @@ bool send_sessions_result(THD *thd) {
     protocol->store_string(elapsed_buf, strlen(elapsed_buf),
                            system_charset_info);
     protocol->store_long(static_cast<longlong>(si.threads_running));
-    /* repl_delay: -1 means not checked, show as "-" */
-    if (si.repl_delay < 0) {
+    /* repl_delay: -1 means not checked, show as "-"; ms only from heartbeats */
+    if (si.repl_delay_ms < 0) {
       protocol->store_string("-", 1, system_charset_info);
     } else {
       char delay_buf[32];
-      snprintf(delay_buf, sizeof(delay_buf), "%lds", si.repl_delay);
+      if (si.repl_delay_ms % 1000 == 0)
+        snprintf(delay_buf, sizeof(delay_buf), "%lds", si.repl_delay_ms / 1000);
+      else
+        snprintf(delay_buf, sizeof(delay_buf), "%.3fs",
+                 si.repl_delay_ms / 1000.0);
       protocol->store_string(delay_buf, strlen(delay_buf),
                              system_charset_info);
     }
+    /* prefetch: -1 means not started or still running, show as "-" */
+    protocol->store_long(
+        static_cast<longlong>(si.prefetch_tables < 0 ? 0 : si.prefetch_tables));
+    if (si.prefetch_ms < 0) {
+      protocol->store_string("-", 1, system_charset_info);
+    } else {
+      char prefetch_buf[32];
+      snprintf(prefetch_buf, sizeof(prefetch_buf), "%ldms", si.prefetch_ms);
+      protocol->store_string(prefetch_buf, strlen(prefetch_buf),
+                             system_charset_info);
+    }
+    /* chunk_progress: "id=3 chunks=12 rows=11875", "-" when not chunking */
+    if (si.chunk_node_id <= 0) {
+      protocol->store_string("-", 1, system_charset_info);
+    } else {
+      char chunk_buf[64];
+      snprintf(chunk_buf, sizeof(chunk_buf), "id=%d chunks=%ld rows=%lld",
+               si.chunk_node_id, si.chunks_done,
+               static_cast<long long>(si.chunk_rows));
+      protocol->store_string(chunk_buf, strlen(chunk_buf),
+                             system_charset_info);
+    }
+    protocol->store_string(si.sched.c_str(), si.sched.length(),
+                           system_charset_info);
+    /* stmt_progress: "id=3 42.5% 1520/s eta=95s", "-" when not sampled */
+    if (si.progress_node_id <= 0) {
+      protocol->store_string("-", 1, system_charset_info);
+    } else {
+      char progress_buf[64];
+      int n = snprintf(progress_buf, sizeof(progress_buf), "id=%d",
+                       si.progress_node_id);
+      if (si.progress_permille >= 0)
+        n += snprintf(progress_buf + n, sizeof(progress_buf) - n, " %.1f%%",
+                      si.progress_permille / 10.0);
+      if (si.progress_rate >= 0)
+        n += snprintf(progress_buf + n, sizeof(progress_buf) - n, " %ld/s",
+                      si.progress_rate);
+      if (si.progress_eta_sec >= 0)
+        snprintf(progress_buf + n, sizeof(progress_buf) - n, " eta=%lds",
+                 si.progress_eta_sec);
+      protocol->store_string(progress_buf, strlen(progress_buf),
+                             system_charset_info);
+    }
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_cache_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("target", 80));
+  field_list.push_back(new Item_empty_string("db_name", 64));
+  field_list.push_back(new Item_empty_string("table_name", 64));
+  field_list.push_back(new Item_empty_string("exists", 3));
+  field_list.push_back(new Item_return_int("columns", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("indexes", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(
+      new Item_return_int("table_rows", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("hits", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_empty_string("age", 16));
+  field_list.push_back(new Item_empty_string("watched", 3));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  auto entries = get_cache_entries();
+  for (auto &ci : entries) {
+    protocol->start_row();
+    protocol->store_string(ci.target.c_str(), ci.target.length(),
+                           system_charset_info);
+    protocol->store_string(ci.db_name.c_str(), ci.db_name.length(),
+                           system_charset_info);
+    protocol->store_string(ci.table_name.c_str(), ci.table_name.length(),
+                           system_charset_info);
+    protocol->store_string(ci.exists ? "YES" : "NO", ci.exists ? 3 : 2,
+                           system_charset_info);
+    protocol->store_long(static_cast<longlong>(ci.columns));
+    protocol->store_long(static_cast<longlong>(ci.indexes));
+    protocol->store_longlong(static_cast<longlong>(ci.table_rows), false);
+    protocol->store_longlong(static_cast<longlong>(ci.hits), true);
+    char age_buf[32];
+    snprintf(age_buf, sizeof(age_buf), "%.1fs", ci.age_sec);
+    protocol->store_string(age_buf, strlen(age_buf), system_charset_info);
+    protocol->store_string(ci.watched ? "YES" : "NO", ci.watched ? 3 : 2,
+                           system_charset_info);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_pool_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("target", 80));
+  field_list.push_back(new Item_empty_string("user", 64));
+  field_list.push_back(new Item_return_int("idle", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("in_use", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("hits", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("misses", 20, MYSQL_TYPE_LONGLONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  auto targets = get_pool_status();
+  for (auto &pi : targets) {
+    protocol->start_row();
+    protocol->store_string(pi.target.c_str(), pi.target.length(),
+                           system_charset_info);
+    protocol->store_string(pi.user.c_str(), pi.user.length(),
+                           system_charset_info);
+    protocol->store_long(static_cast<longlong>(pi.idle));
+    protocol->store_long(static_cast<longlong>(pi.in_use));
+    protocol->store_longlong(static_cast<longlong>(pi.hits), true);
+    protocol->store_longlong(static_cast<longlong>(pi.misses), true);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_admission_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("target", 80));
+  field_list.push_back(new Item_empty_string("kind", 8));
+  field_list.push_back(new Item_return_int("max", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("running", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("queued", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(
+      new Item_return_int("admitted", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("waited", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("wait_ms", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(
+      new Item_return_int("max_wait_ms", 20, MYSQL_TYPE_LONGLONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  for (const auto &ai : get_admission_status()) {
+    protocol->start_row();
+    protocol->store_string(ai.target.c_str(), ai.target.length(),
+                           system_charset_info);
+    protocol->store_string(ai.kind, strlen(ai.kind), system_charset_info);
+    protocol->store_long(static_cast<longlong>(ai.limit));
+    protocol->store_long(static_cast<longlong>(ai.running));
+    protocol->store_long(static_cast<longlong>(ai.queued));
+    protocol->store_longlong(static_cast<longlong>(ai.admitted), true);
+    protocol->store_longlong(static_cast<longlong>(ai.waited), true);
+    protocol->store_longlong(static_cast<longlong>(ai.wait_ms), true);
+    protocol->store_longlong(static_cast<longlong>(ai.max_wait_ms), true);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_audit_log_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("path", FN_REFLEN));
+  field_list.push_back(new Item_return_int("queued", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(
+      new Item_return_int("queued_bytes", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("written", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("dropped", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(
+      new Item_return_int("rotations", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_return_int("syncs", 20, MYSQL_TYPE_LONGLONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  AuditLogStats st = get_audit_log_stats();
+  protocol->start_row();
+  protocol->store_string(st.path.c_str(), st.path.length(),
+                         system_charset_info);
+  protocol->store_longlong(static_cast<longlong>(st.queued), true);
+  protocol->store_longlong(static_cast<longlong>(st.queued_bytes), true);
+  protocol->store_longlong(static_cast<longlong>(st.written), true);
+  protocol->store_longlong(static_cast<longlong>(st.dropped), true);
+  protocol->store_longlong(static_cast<longlong>(st.rotations), true);
+  protocol->store_longlong(static_cast<longlong>(st.syncs), true);
+  if (protocol->end_row()) return true;
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_job_submitted_result(THD *thd, uint64_t job_id, int total_sql) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_return_int("job_id", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_empty_string("stage", 16));
+  field_list.push_back(new Item_return_int("total_sql", 10, MYSQL_TYPE_LONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  protocol->start_row();
+  protocol->store_longlong(static_cast<longlong>(job_id), true);
+  protocol->store_string("QUEUED", 6, system_charset_info);
+  protocol->store_long(static_cast<longlong>(total_sql));
+  if (protocol->end_row()) return true;
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_jobs_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_return_int("job_id", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_empty_string("state", 16));
+  field_list.push_back(new Item_return_int("thread_id", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("user", 32));
+  field_list.push_back(new Item_empty_string("host", 64));
+  field_list.push_back(new Item_return_int("port", 5, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("total_sql", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("executed_sql", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("errors", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("submitted", 20));
+  field_list.push_back(new Item_empty_string("elapsed", 16));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  auto jobs = get_jobs();
+  for (auto &ji : jobs) {
+    protocol->start_row();
+    protocol->store_longlong(static_cast<longlong>(ji.id), true);
+    protocol->store_string(ji.state.c_str(), ji.state.length(),
+                           system_charset_info);
+    protocol->store_long(static_cast<longlong>(ji.client_thread_id));
+    protocol->store_string(ji.client_user.c_str(), ji.client_user.length(),
+                           system_charset_info);
+    protocol->store_string(ji.host.c_str(), ji.host.length(),
+                           system_charset_info);
+    protocol->store_long(static_cast<longlong>(ji.port));
+    protocol->store_long(static_cast<longlong>(ji.total_sql));
+    protocol->store_long(static_cast<longlong>(ji.executed_sql));
+    protocol->store_long(static_cast<longlong>(ji.errors));
+    char submitted_buf[32];
+    struct tm tm_buf;
+    localtime_r(&ji.submitted, &tm_buf);
+    strftime(submitted_buf, sizeof(submitted_buf), "%Y-%m-%d %H:%M:%S",
+             &tm_buf);
+    protocol->store_string(submitted_buf, strlen(submitted_buf),
+                           system_charset_info);
+    char elapsed_buf[32];
+    snprintf(elapsed_buf, sizeof(elapsed_buf), "%.1fs", ji.elapsed_sec);
+    protocol->store_string(elapsed_buf, strlen(elapsed_buf),
+                           system_charset_info);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_checkpoints_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("batch_id", 64));
+  field_list.push_back(new Item_empty_string("host", 64));
+  field_list.push_back(new Item_return_int("port", 5, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("total_sql", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_return_int("completed_id", 10, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("chunk_progress", 96));
+  field_list.push_back(new Item_empty_string("updated", 20));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  auto checkpoints = list_checkpoints();
+  for (auto &ci : checkpoints) {
+    protocol->start_row();
+    protocol->store_string(ci.batch_id.c_str(), ci.batch_id.length(),
+                           system_charset_info);
+    protocol->store_string(ci.host.c_str(), ci.host.length(),
+                           system_charset_info);
+    protocol->store_long(static_cast<longlong>(ci.port));
+    protocol->store_long(static_cast<longlong>(ci.total_sql));
+    protocol->store_long(static_cast<longlong>(ci.completed_id));
+    /* Same format as "inception show sessions", plus the last boundary */
+    if (ci.chunk_node_id <= 0) {
+      protocol->store_string("-", 1, system_charset_info);
+    } else {
+      char chunk_buf[96];
+      snprintf(chunk_buf, sizeof(chunk_buf), "id=%d chunks=%ld rows=%lld pk=%s",
+               ci.chunk_node_id, ci.chunks,
+               static_cast<long long>(ci.chunk_rows),
+               ci.chunk_boundary.c_str());
+      protocol->store_string(chunk_buf, strlen(chunk_buf),
+                             system_charset_info);
+    }
+    char updated_buf[32];
+    struct tm tm_buf;
+    localtime_r(&ci.updated, &tm_buf);
+    strftime(updated_buf, sizeof(updated_buf), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    protocol->store_string(updated_buf, strlen(updated_buf),
+                           system_charset_info);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_rule_stats_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("rule", 32));
+  field_list.push_back(new Item_return_int("calls", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_empty_string("time_ms", 20));
+  field_list.push_back(new Item_empty_string("avg_us", 20));
+  field_list.push_back(
+      new Item_return_int("remote_queries", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(
+      new Item_return_int("violations", 20, MYSQL_TYPE_LONGLONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  const RuleStats stats = get_rule_stats();
+  std::vector<int> order;
+  for (int i = 0; i < RULE_COUNT; i++) order.push_back(i);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return stats[a].time_ns > stats[b].time_ns;
+  });
+
+  for (int i : order) {
+    const RuleStat &st = stats[i];
+    protocol->start_row();
+    const char *name = audit_rule_name(i);
+    protocol->store_string(name, strlen(name), system_charset_info);
+    protocol->store_longlong(static_cast<longlong>(st.calls), true);
+    char time_buf[32];
+    snprintf(time_buf, sizeof(time_buf), "%.3f", st.time_ns / 1e6);
+    protocol->store_string(time_buf, strlen(time_buf), system_charset_info);
+    char avg_buf[32];
+    snprintf(avg_buf, sizeof(avg_buf), "%.1f",
+             st.calls ? st.time_ns / 1e3 / st.calls : 0.0);
+    protocol->store_string(avg_buf, strlen(avg_buf), system_charset_info);
+    protocol->store_longlong(static_cast<longlong>(st.remote_queries), true);
+    protocol->store_longlong(static_cast<longlong>(st.violations), true);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_rule_profiles_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("profile", 64));
+  field_list.push_back(
+      new Item_return_int("settings", 20, MYSQL_TYPE_LONGLONG));
+  field_list.push_back(new Item_empty_string("path", 512));
+  field_list.push_back(new Item_empty_string("loaded", 20));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  for (const RuleProfileInfo &p : get_rule_profiles()) {
+    protocol->start_row();
+    protocol->store_string(p.name.c_str(), p.name.size(), system_charset_info);
+    protocol->store_longlong(static_cast<longlong>(p.settings), true);
+    protocol->store_string(p.path.c_str(), p.path.size(), system_charset_info);
+    protocol->store_string(p.loaded.c_str(), p.loaded.size(),
+                           system_charset_info);
+    if (protocol->end_row()) return true;
+  }
+
+  my_eof(thd);
+  return false;
+}
+
+bool send_rule_components_result(THD *thd) {
+  Protocol *protocol = thd->get_protocol();
+
+  mem_root_deque<Item *> field_list(thd->mem_root);
+  field_list.push_back(new Item_empty_string("rule", 64));
+  field_list.push_back(
+      new Item_return_int("sql_command", 20, MYSQL_TYPE_LONG));
+  field_list.push_back(new Item_empty_string("sql_type", 64));
+  field_list.push_back(new Item_return_int("calls", 20, MYSQL_TYPE_LONGLONG));
+
+  if (thd->send_result_metadata(field_list,
+                                Protocol::SEND_NUM_ROWS | Protocol::SEND_EOF))
+    return true;
+
+  for (const ComponentRuleInfo &r : get_component_rules()) {
+    const char *type =
+        sql_type_name(static_cast<enum_sql_command>(r.sql_command));
+    protocol->start_row();
+    protocol->store_string(r.name.c_str(), r.name.size(), system_charset_info);
+    protocol->store_long(r.sql_command);
+    protocol->store_string(type, strlen(type), system_charset_info);
+    protocol->store_longlong(static_cast<longlong>(r.calls), true);
     if (protocol->end_row()) return true;
   }
 
@@ -7,21 +7,59 @@
 #define SQL_INCEPTION_RESULT_H
 
 #include <cstddef>
+#include <cstdint>
 
 class THD;
 
 namespace inception {
 
 struct InceptionContext;
+class KeptResults;
+struct ResultPage;
 
 /**
- * Send all cached SQL audit/execute results as a 15-column result set.
+ * With inception_result_spool_size > 0, move the results of ctx that are
+ * final into ctx->result_spool (see inception_spool.h): every audited
+ * statement in CHECK, every query tree in QUERY_TREE and the SQL text of
+ * every group but the last in SPLIT. Called after each statement.
+ */
+void spool_finished_results(InceptionContext *ctx);
+
+/**
+ * Send all cached SQL audit/execute results as an 18-column result set.
  * Columns: id, stage, err_level, stage_status, err_message, sql_text,
  *          affected_rows, sequence, backup_dbname, execute_time, sql_sha1,
- *          sql_type, ddl_algorithm, db_type, db_version
+ *          sql_type, ddl_algorithm, db_type, db_version, exec_strategy,
+ *          estimated_time, locks_writes
+ * With kept set, every row sent is also added to it (inception_kept.h).
+ * @return false on success, true on error.
+ */
+bool send_inception_results(THD *thd, InceptionContext *ctx,
+                            KeptResults *kept = nullptr);
+
+/**
+ * Send the results of a --targets batch: the columns of
+ * send_inception_results() followed by target (host:port), one row per
+ * shard and statement, shards in --targets order.
+ * @return false on success, true on error.
+ */
+bool send_fanout_results(THD *thd, InceptionContext *ctx,
+                         KeptResults *kept = nullptr);
+
+/**
+ * Add the result rows of the finished background job ctx to kept, as
+ * send_inception_results() or send_fanout_results() sends them.
+ */
+void keep_job_results(InceptionContext *ctx, KeptResults *kept);
+
+/**
+ * Send the rows of page of a result set kept by send_inception_results()
+ * or send_fanout_results(), with their columns.
+ * Triggered by: inception get results ... [offset [limit]] [errlevel>=N]
  * @return false on success, true on error.
  */
-bool send_inception_results(THD *thd, InceptionContext *ctx);
+bool send_kept_results(THD *thd, const KeptResults &kept,
+                       const ResultPage &page);
 
 /**
  * Send the supported SQL types table.
@@ -33,7 +71,8 @@ bool send_sqltypes_result(THD *thd);
 
 /**
  * Send SPLIT mode grouped results.
- * Columns: id (INT), sql_statement (VARCHAR), ddlflag (INT)
+ * Columns: id (INT), sql_statement (VARCHAR), ddlflag (INT),
+ *          parallel_group (INT), depends_on (VARCHAR, comma-separated ids)
  * @return false on success, true on error.
  */
 bool send_split_results(THD *thd, InceptionContext *ctx);
@@ -55,13 +94,101 @@ bool send_encrypt_password_result(THD *thd, const char *plain, size_t len);
 
 /**
  * Send active inception sessions as a result set.
- * Columns: thread_id, host, port, user, mode, db_type, sleep_ms,
- *          total_sql, executed_sql, elapsed_sec
+ * Columns: thread_id, host, port, user, mode, db_type, sleep_ms, paused,
+ *          total_sql, executed_sql, elapsed, threads_running, repl_delay,
+ *          prefetch_tables, prefetch_time, chunk_progress, sched
  * Triggered by: inception show sessions
  * @return false on success, true on error.
  */
 bool send_sessions_result(THD *thd);
 
+/**
+ * Send the remote metadata cache contents as a result set.
+ * Columns: target, db_name, table_name, exists, columns, indexes,
+ *          table_rows, hits, age
+ * Schema-existence entries have an empty table_name.
+ * Triggered by: inception show cache
+ * @return false on success, true on error.
+ */
+bool send_cache_result(THD *thd);
+
+/**
+ * Send the remote connection pool status as a result set.
+ * Columns: target, user, idle, in_use, hits, misses
+ * Triggered by: inception show pool
+ * @return false on success, true on error.
+ */
+bool send_pool_result(THD *thd);
+
+/**
+ * Send the admission control state of every target as a result set.
+ * Columns: target, kind, max, running, queued, admitted, waited, wait_ms,
+ *          max_wait_ms
+ * Triggered by: inception show admission
+ * @return false on success, true on error.
+ */
+bool send_admission_result(THD *thd);
+
+/**
+ * Send the audit log writer status as a single-row result set.
+ * Columns: path, queued, queued_bytes, written, dropped, rotations, syncs
+ * Triggered by: inception show audit_log
+ * @return false on success, true on error.
+ */
+bool send_audit_log_result(THD *thd);
+
+/**
+ * Send the reply of an async inception_magic_commit as a single-row result set.
+ * Columns: job_id, stage (QUEUED), total_sql
+ * @return false on success, true on error.
+ */
+bool send_job_submitted_result(THD *thd, uint64_t job_id, int total_sql);
+
+/**
+ * Send background execution jobs as a result set.
+ * Columns: job_id, state, thread_id, user, host, port, total_sql,
+ *          executed_sql, errors, submitted, elapsed
+ * Triggered by: inception show jobs
+ * @return false on success, true on error.
+ */
+bool send_jobs_result(THD *thd);
+
+/**
+ * Send the saved execution checkpoints as a result set.
+ * Columns: batch_id, host, port, total_sql, completed_id, chunk_progress,
+ *          updated
+ * Triggered by: inception show checkpoints
+ * @return false on success, true on error.
+ */
+bool send_checkpoints_result(THD *thd);
+
+/**
+ * Send the server-wide audit rule counters as a result set, one row per
+ * rule, most time first.
+ * Columns: rule, calls, time_ms, avg_us, remote_queries, violations
+ * Triggered by: inception show rule_stats
+ * @return false on success, true on error.
+ */
+bool send_rule_stats_result(THD *thd);
+
+/**
+ * Send the rule profiles loaded from inception_rule_profiles as a result
+ * set, one row per profile in name order.
+ * Columns: profile, settings, path, loaded
+ * Triggered by: inception show rule_profiles
+ * @return false on success, true on error.
+ */
+bool send_rule_profiles_result(THD *thd);
+
+/**
+ * Send the audit rules registered by components as a result set, one row
+ * per (rule, command).
+ * Columns: rule, sql_command, sql_type, calls
+ * Triggered by: inception show rule_components
+ * @return false on success, true on error.
+ */
+bool send_rule_components_result(THD *thd);
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_RESULT_H
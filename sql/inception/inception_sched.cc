@@ -0,0 +1,402 @@
+/**
+ * @file inception_sched.cc
+ * @brief Cross-session execution scheduler, per target host:port.
+ */
+
+#include "sql/inception/inception_sched.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace inception {
+
+namespace {
+
+struct Waiter {
+  const InceptionContext *ctx;
+  const ExecSlot *slot;  /* a session may wait for several query slots */
+  uint priority;
+};
+
+/** Holders and waiters of one kind of slot on one target. */
+struct SlotQueue {
+  std::multiset<const InceptionContext *> holders;
+  std::vector<Waiter> waiting;  /* priority desc, then arrival */
+};
+
+/** What "inception show admission" reports of one queue. */
+struct AdmissionCounters {
+  uint64_t admitted = 0;
+  uint64_t waited = 0;
+  uint64_t wait_us = 0;
+  uint64_t max_wait_us = 0;
+};
+
+const int SLOT_KINDS = 4;
+
+/**
+ * One token bucket; tokens may go negative (debt) because statements are
+ * charged after they ran.
+ */
+struct Bucket {
+  double tokens = 0;
+  ulong limit = 0;  /* per second, 0 = unlimited */
+
+  /* Set the limit in force; a newly limited bucket starts full */
+  void set_limit(ulong l) {
+    if (l == limit) return;
+    if (limit == 0)
+      tokens = l;
+    else
+      tokens = std::min<double>(tokens, l);
+    limit = l;
+  }
+  void refill(double seconds) {
+    if (limit > 0) tokens = std::min<double>(limit, tokens + seconds * limit);
+  }
+  /* Milliseconds until the debt is paid off, 0 if none */
+  uint64_t wait_ms() const {
+    if (limit == 0 || tokens >= 0) return 0;
+    return static_cast<uint64_t>(-tokens * 1000 / limit) + 1;
+  }
+};
+
+struct TargetBudgetState {
+  Bucket rows;
+  Bucket statements;
+  std::chrono::steady_clock::time_point refilled =
+      std::chrono::steady_clock::now();
+};
+
+/** Limits set with "inception set rate" */
+struct RateLimit {
+  ulong rows_per_sec;
+  ulong statements_per_sec;
+};
+
+struct TargetSlots {
+  SlotQueue queues[SLOT_KINDS];  /* indexed by SlotKind */
+  bool empty() const {
+    for (const auto &q : queues)
+      if (!q.holders.empty() || !q.waiting.empty()) return false;
+    return true;
+  }
+};
+
+}  // namespace
+
+static std::mutex g_sched_mutex;
+static std::condition_variable g_sched_cond;
+static std::map<std::string, TargetSlots> g_targets;
+/* Kept for the life of the server: one small entry per target used */
+static std::map<std::string, TargetBudgetState> g_budgets;
+static std::map<std::string, RateLimit> g_rate_limits;
+static std::map<std::string, std::array<AdmissionCounters, SLOT_KINDS>>
+    g_admission;
+
+/* How often a queued session looks at its kill flag */
+static const std::chrono::milliseconds KILL_POLL_INTERVAL(200);
+
+static std::string target_key(const std::string &host, uint port) {
+  std::string key = host;
+  for (auto &c : key) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return key + ":" + std::to_string(port);
+}
+
+static std::string target_key(const InceptionContext *ctx) {
+  return target_key(ctx->host, ctx->port);
+}
+
+static ulong slot_limit(SlotKind kind) {
+  switch (kind) {
+    case SlotKind::SESSION: return opt_exec_max_sessions_per_target;
+    case SlotKind::DDL:     return opt_exec_max_ddl_per_target;
+    case SlotKind::CHECK:   return opt_check_max_sessions_per_target;
+    default:                return opt_check_max_queries_per_target;
+  }
+}
+
+static const char *const SLOT_NAMES[SLOT_KINDS] = {"EXECUTE", "DDL", "CHECK",
+                                                   "QUERY"};
+
+/**
+ * Index of the waiter of q to admit next: the first, in priority and
+ * arrival order, of those whose session holds the fewest slots of q.
+ * Sessions hold at most one slot of the other kinds, so for them this is
+ * the head of the queue.
+ */
+static size_t next_waiter(const SlotQueue &q) {
+  size_t best = 0;
+  size_t best_held = ~static_cast<size_t>(0);
+  for (size_t i = 0; i < q.waiting.size() && best_held > 0; i++) {
+    const size_t held = q.holders.count(q.waiting[i].ctx);
+    if (held < best_held) {
+      best = i;
+      best_held = held;
+    }
+  }
+  return best;
+}
+
+bool is_scheduled_ddl(enum_sql_command cmd) {
+  switch (cmd) {
+    case SQLCOM_CREATE_TABLE:
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_DROP_TABLE:
+    case SQLCOM_RENAME_TABLE:
+    case SQLCOM_TRUNCATE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX:
+    case SQLCOM_CREATE_DB:
+    case SQLCOM_DROP_DB:
+    case SQLCOM_ALTER_DB:
+    case SQLCOM_CREATE_VIEW:
+    case SQLCOM_DROP_VIEW:
+    case SQLCOM_CREATE_TRIGGER:
+    case SQLCOM_DROP_TRIGGER:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ExecSlot::acquire(InceptionContext *ctx, SlotKind kind) {
+  return acquire(ctx, kind, ctx->host, ctx->port);
+}
+
+bool ExecSlot::acquire(InceptionContext *ctx, SlotKind kind,
+                       const std::string &host, uint port) {
+  release();
+  const std::string key = target_key(host, port);
+  const int k = static_cast<int>(kind);
+  static const char *const WHAT[SLOT_KINDS] = {"execution", "DDL", "CHECK",
+                                               "query"};
+  const char *what = WHAT[k];
+
+  std::unique_lock<std::mutex> lock(g_sched_mutex);
+  SlotQueue *q = &g_targets[key].queues[k];
+  Waiter me{ctx, this, ctx->priority};
+  auto pos = std::find_if(q->waiting.begin(), q->waiting.end(),
+                          [&](const Waiter &w) { return w.priority < me.priority; });
+  q->waiting.insert(pos, me);
+  g_admission[key];  /* listed while queued, even before a first grant */
+  auto mine = [this](const Waiter &w) { return w.slot == this; };
+
+  auto queued_at = std::chrono::steady_clock::now();
+  bool queued = false;
+  bool logged = false;
+  for (;;) {
+    /* q stays valid: a target is not erased while it has waiters */
+    ulong limit = slot_limit(kind);
+    if (q->waiting[next_waiter(*q)].slot == this &&
+        (limit == 0 || q->holders.size() < limit))
+      break;
+    queued = true;
+    if (ctx->killed.load()) {
+      q->waiting.erase(
+          std::find_if(q->waiting.begin(), q->waiting.end(), mine));
+      if (g_targets[key].empty()) g_targets.erase(key);
+      g_sched_cond.notify_all();
+      return false;
+    }
+    /* Query slots are many and short: "inception show admission" */
+    if (!logged && kind != SlotKind::QUERY) {
+      fprintf(stderr, "[Inception] Waiting for a %s slot on %s "
+              "(%zu running, %zu queued).\n", what, key.c_str(),
+              q->holders.size(), q->waiting.size());
+      fflush(stderr);
+      logged = true;
+    }
+    g_sched_cond.wait_for(lock, KILL_POLL_INTERVAL);
+  }
+
+  q->waiting.erase(std::find_if(q->waiting.begin(), q->waiting.end(), mine));
+  q->holders.insert(ctx);
+  m_ctx = ctx;
+  m_kind = kind;
+  m_key = key;
+  AdmissionCounters &counters = g_admission[key][k];
+  counters.admitted++;
+  if (queued) {
+    const uint64_t us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - queued_at)
+            .count());
+    counters.waited++;
+    counters.wait_us += us;
+    counters.max_wait_us = std::max(counters.max_wait_us, us);
+  }
+  /* The next in line may fit as well (limit raised meanwhile) */
+  g_sched_cond.notify_all();
+
+  if (logged) {
+    double waited = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - queued_at).count();
+    fprintf(stderr, "[Inception] Got a %s slot on %s after %.1fs.\n",
+            what, key.c_str(), waited);
+    fflush(stderr);
+  }
+  return true;
+}
+
+void ExecSlot::release() {
+  if (!m_ctx) return;
+  {
+    std::lock_guard<std::mutex> lock(g_sched_mutex);
+    auto it = g_targets.find(m_key);
+    if (it != g_targets.end()) {
+      auto &holders = it->second.queues[static_cast<int>(m_kind)].holders;
+      auto held = holders.find(m_ctx);
+      if (held != holders.end()) holders.erase(held);
+      if (it->second.empty()) g_targets.erase(it);
+    }
+  }
+  g_sched_cond.notify_all();
+  m_ctx = nullptr;
+}
+
+QuerySlot::QuerySlot(InceptionContext *ctx, MYSQL *mysql) {
+  m_killed = mysql && mysql->host
+                 ? !m_slot.acquire(ctx, SlotKind::QUERY, mysql->host,
+                                   mysql->port)
+                 : !m_slot.acquire(ctx, SlotKind::QUERY);
+}
+
+/** The budget of key with its limits and tokens brought up to date. */
+static TargetBudgetState *refreshed_budget(const std::string &key) {
+  TargetBudgetState *b = &g_budgets[key];
+  auto limit = g_rate_limits.find(key);
+  b->rows.set_limit(limit == g_rate_limits.end() ? opt_exec_max_rows_per_sec
+                                                 : limit->second.rows_per_sec);
+  b->statements.set_limit(limit == g_rate_limits.end()
+                              ? opt_exec_max_statements_per_sec
+                              : limit->second.statements_per_sec);
+  auto now = std::chrono::steady_clock::now();
+  double seconds = std::chrono::duration<double>(now - b->refilled).count();
+  b->refilled = now;
+  b->rows.refill(seconds);
+  b->statements.refill(seconds);
+  return b;
+}
+
+/* Longest single sleep while paying: limit changes apply within it */
+static const uint64_t BUDGET_POLL_MS = 1000;
+
+bool TargetBudget::pay() {
+  const std::string key = target_key(m_ctx);
+  bool logged = false;
+  for (;;) {
+    uint64_t wait = 0;
+    {
+      std::lock_guard<std::mutex> lock(g_sched_mutex);
+      TargetBudgetState *b = refreshed_budget(key);
+      wait = std::max(b->rows.wait_ms(), b->statements.wait_ms());
+    }
+    if (wait == 0) return false;
+    if (!logged && wait >= 100) {
+      fprintf(stderr, "[Inception] Rate budget of %s exhausted, waiting "
+              "%llums.\n", key.c_str(), static_cast<unsigned long long>(wait));
+      fflush(stderr);
+      logged = true;
+    }
+    if (m_ctx->sleep_unless_killed(std::min(wait, BUDGET_POLL_MS))) return true;
+  }
+}
+
+void TargetBudget::charge(uint64_t statements, uint64_t rows) {
+  m_statements += statements;
+  m_rows += rows;
+  std::lock_guard<std::mutex> lock(g_sched_mutex);
+  TargetBudgetState *b = refreshed_budget(target_key(m_ctx));
+  if (b->rows.limit > 0) b->rows.tokens -= static_cast<double>(rows);
+  if (b->statements.limit > 0)
+    b->statements.tokens -= static_cast<double>(statements);
+}
+
+void set_target_rate(const std::string &host, uint port, bool use_default,
+                     ulong rows_per_sec, ulong statements_per_sec) {
+  const std::string key = target_key(host, port);
+  {
+    std::lock_guard<std::mutex> lock(g_sched_mutex);
+    if (use_default)
+      g_rate_limits.erase(key);
+    else
+      g_rate_limits[key] = RateLimit{rows_per_sec, statements_per_sec};
+  }
+  if (use_default)
+    fprintf(stderr, "[Inception] Rate budget of %s reset to the defaults.\n",
+            key.c_str());
+  else
+    fprintf(stderr, "[Inception] Rate budget of %s set to %lu rows/s, "
+            "%lu statements/s.\n", key.c_str(), rows_per_sec,
+            statements_per_sec);
+  fflush(stderr);
+}
+
+/** "RUNNING" / "QUEUED n/m" for one queue, empty if ctx is not in it. */
+static std::string queue_state(const SlotQueue &q,
+                               const InceptionContext *ctx) {
+  if (q.holders.count(ctx)) return "RUNNING";
+  for (size_t i = 0; i < q.waiting.size(); i++) {
+    if (q.waiting[i].ctx == ctx)
+      return "QUEUED " + std::to_string(i + 1) + "/" +
+             std::to_string(q.waiting.size());
+  }
+  return "";
+}
+
+std::vector<AdmissionInfo> get_admission_status() {
+  std::vector<AdmissionInfo> result;
+  std::lock_guard<std::mutex> lock(g_sched_mutex);
+  for (const auto &target : g_admission) {
+    auto slots = g_targets.find(target.first);
+    for (int k = 0; k < SLOT_KINDS; k++) {
+      const AdmissionCounters &c = target.second[k];
+      const SlotQueue *q =
+          slots == g_targets.end() ? nullptr : &slots->second.queues[k];
+      if (c.admitted == 0 && (!q || q->waiting.empty())) continue;
+      AdmissionInfo info;
+      info.target = target.first;
+      info.kind = SLOT_NAMES[k];
+      info.limit = slot_limit(static_cast<SlotKind>(k));
+      info.running = q ? q->holders.size() : 0;
+      info.queued = q ? q->waiting.size() : 0;
+      info.admitted = c.admitted;
+      info.waited = c.waited;
+      info.wait_ms = c.wait_us / 1000;
+      info.max_wait_ms = c.max_wait_us / 1000;
+      result.push_back(info);
+    }
+  }
+  return result;
+}
+
+std::string scheduler_state(const InceptionContext *ctx,
+                            const std::string &host, uint port) {
+  std::lock_guard<std::mutex> lock(g_sched_mutex);
+  auto it = g_targets.find(target_key(host, port));
+  if (it == g_targets.end()) return "-";
+  std::string session = queue_state(it->second.queues[0], ctx);
+  std::string ddl = queue_state(it->second.queues[1], ctx);
+  if (session.empty()) {
+    const std::string check = queue_state(
+        it->second.queues[static_cast<int>(SlotKind::CHECK)], ctx);
+    return check.empty() ? "-" : "CHECK " + check;
+  }
+  if (ddl.empty()) return session;
+  if (ddl == "RUNNING") return "RUNNING DDL";
+  return session + ", DDL " + ddl;
+}
+
+}  // namespace inception
@@ -0,0 +1,162 @@
+/**
+ * @file inception_sched.h
+ * @brief Cross-session execution scheduler, per target host:port.
+ *
+ * Every EXECUTE batch (client session or background job) takes a session
+ * slot on its target before running its first statement, and each DDL
+ * statement additionally takes a DDL slot on that target. With
+ * inception_exec_max_sessions_per_target / inception_exec_max_ddl_per_target
+ * set, batches beyond the limit wait in a queue ordered by --priority
+ * (higher first), then arrival, and the throttle checks of the batches
+ * that do run no longer compete with an unbounded number of others.
+ * Targets are independent: a full queue on one primary never delays
+ * another. 0 (the default) means unlimited, which only tracks the slots.
+ *
+ * The audit is admitted the same way, so that a burst of CI pipelines
+ * checking against one primary queues inside inception instead of
+ * reaching it: each CHECK session takes a CHECK slot at
+ * inception_magic_start (inception_check_max_sessions_per_target), and
+ * each remote metadata or EXPLAIN query of an audit, in any mode, a query
+ * slot on the server it is sent to (inception_check_max_queries_per_target).
+ * A free query slot goes to the waiting session holding the fewest, so a
+ * session with several queries in flight cannot starve the others.
+ *
+ * The queue position of each session appears in the sched column of
+ * "inception show sessions", and the running, queued and waited counts of
+ * every target in "inception show admission".
+ *
+ * Each target also has a rows/second and a statements/second token bucket
+ * that every batch running against it, chunk by chunk for chunked DML,
+ * draws from: inception_exec_max_rows_per_sec /
+ * inception_exec_max_statements_per_sec, or the limits set for that target
+ * with "inception set rate". The cost of a statement (its affected_rows)
+ * is only known once it ran, so a statement is charged afterwards and may
+ * take a bucket into debt; the next statement on that target, from any
+ * batch, waits until the debt is refilled. Buckets hold at most one second
+ * of budget.
+ */
+
+#ifndef SQL_INCEPTION_SCHED_H
+#define SQL_INCEPTION_SCHED_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+#include "sql/sql_lex.h"    // enum_sql_command
+
+namespace inception {
+
+struct InceptionContext;
+
+enum class SlotKind { SESSION, DDL, CHECK, QUERY };
+
+/** Statements that take a DDL slot. */
+bool is_scheduled_ddl(enum_sql_command cmd);
+
+/** One slot on the target of a context; released on destruction. */
+class ExecSlot {
+ public:
+  ExecSlot() = default;
+  ~ExecSlot() { release(); }
+  ExecSlot(const ExecSlot &) = delete;
+  ExecSlot &operator=(const ExecSlot &) = delete;
+
+  /**
+   * Wait for a slot of kind on ctx's target. Returns false, without a
+   * slot, if ctx is killed while queued.
+   */
+  bool acquire(InceptionContext *ctx, SlotKind kind);
+
+  /** The same on host:port, for a query sent elsewhere (--audit-host). */
+  bool acquire(InceptionContext *ctx, SlotKind kind, const std::string &host,
+               uint port);
+
+  /** Give the slot back (no-op if none is held). */
+  void release();
+
+ private:
+  InceptionContext *m_ctx = nullptr;
+  SlotKind m_kind = SlotKind::SESSION;
+  std::string m_key;  /* target the slot is held on */
+};
+
+/**
+ * A query slot on the server behind mysql, held while one remote metadata
+ * or EXPLAIN query of the audit of ctx runs.
+ */
+class QuerySlot {
+ public:
+  QuerySlot(InceptionContext *ctx, MYSQL *mysql);
+
+  /** ctx was killed while queued: the query must not be sent. */
+  bool killed() const { return m_killed; }
+
+ private:
+  ExecSlot m_slot;
+  bool m_killed = false;
+};
+
+/** A batch's share of the row / statement budget of its target. */
+class TargetBudget {
+ public:
+  explicit TargetBudget(InceptionContext *ctx) : m_ctx(ctx) {}
+  TargetBudget(const TargetBudget &) = delete;
+  TargetBudget &operator=(const TargetBudget &) = delete;
+
+  /**
+   * Before a statement or chunk: wait until the target's buckets are out
+   * of debt. Returns true if ctx is killed while waiting.
+   */
+  bool pay();
+
+  /** After a statement or chunk: take its cost from the target's buckets. */
+  void charge(uint64_t statements, uint64_t rows);
+
+  /** Totals charged so far, so a caller can skip what inner loops charged. */
+  uint64_t charged_statements() const { return m_statements; }
+  uint64_t charged_rows() const { return m_rows; }
+
+ private:
+  InceptionContext *m_ctx;
+  uint64_t m_statements = 0;
+  uint64_t m_rows = 0;
+};
+
+/**
+ * "inception set rate": the rows/second and statements/second budget of
+ * host:port (0 = unlimited), or back to the global defaults.
+ */
+void set_target_rate(const std::string &host, uint port, bool use_default,
+                     ulong rows_per_sec, ulong statements_per_sec);
+
+/** One kind of slot on one target, for "inception show admission". */
+struct AdmissionInfo {
+  std::string target;  /* host:port */
+  const char *kind;    /* EXECUTE, DDL, CHECK or QUERY */
+  ulong limit;         /* 0 = unlimited */
+  size_t running;
+  size_t queued;
+  uint64_t admitted;   /* slots granted since startup */
+  uint64_t waited;     /* of which had to queue */
+  uint64_t wait_ms;    /* total time queued */
+  uint64_t max_wait_ms;
+};
+
+/** Every kind of slot used on every target since startup. */
+std::vector<AdmissionInfo> get_admission_status();
+
+/**
+ * Scheduler state of ctx for "inception show sessions": "RUNNING",
+ * "QUEUED 2/5", "RUNNING, DDL QUEUED 1/1", "RUNNING DDL", "CHECK RUNNING",
+ * "CHECK QUEUED 3/8", or "-" when it holds and waits for nothing. ctx
+ * executes on host:port; the context itself is only compared, so another
+ * thread may ask.
+ */
+std::string scheduler_state(const InceptionContext *ctx,
+                            const std::string &host, uint port);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SCHED_H
@@ -0,0 +1,166 @@
+/**
+ * @file inception_script.cc
+ * @brief ScriptFile (mapped scripts of inception_script_dir) and
+ *        ScriptScanner (the mysql client's statement splitting).
+ */
+
+#include "sql/inception/inception_script.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_dir.h"  // my_fstat, MY_STAT
+#include "my_sys.h"  // my_open, my_close, my_mmap
+
+#include <fcntl.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace inception {
+
+/* ---- ScriptFile ---- */
+
+ScriptFile::~ScriptFile() {
+  if (m_data) my_munmap(m_data, m_size);
+  if (m_fd >= 0) my_close(m_fd, MYF(0));
+}
+
+bool ScriptFile::open(const std::string &name, std::string *err) {
+  const char *dir = opt_script_dir;
+  if (!dir || !*dir) {
+    *err = "inception audit file needs inception_script_dir.";
+    return true;
+  }
+  /* A plain name inside the directory: no separators, no hidden files */
+  bool valid = !name.empty() && name[0] != '.';
+  for (char c : name)
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-' &&
+        c != '.')
+      valid = false;
+  if (!valid) {
+    *err = "Invalid script name '" + name + "': expected a file name in "
+           "inception_script_dir.";
+    return true;
+  }
+
+  m_path = std::string(dir) + "/" + name;
+  m_fd = my_open(m_path.c_str(), O_RDONLY, MYF(0));
+  MY_STAT st;
+  if (m_fd < 0 || my_fstat(m_fd, &st)) {
+    *err = "Cannot open script file '" + m_path + "'.";
+    return true;
+  }
+  m_size = static_cast<size_t>(st.st_size);
+  if (m_size == 0) return false;
+  void *map = my_mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+  if (map == MAP_FAILED) {
+    m_size = 0;
+    *err = "Cannot map script file '" + m_path + "'.";
+    return true;
+  }
+  m_data = static_cast<char *>(map);
+  /* Read once, front to back */
+  madvise(m_data, m_size, MADV_SEQUENTIAL);
+  return false;
+}
+
+/* ---- ScriptScanner ---- */
+
+/* "DELIMITER <x>" at the start of a statement */
+bool ScriptScanner::at_delimiter_command() const {
+  static const size_t n = 9;
+  if (m_size - m_pos <= n || strncasecmp(m_text + m_pos, "DELIMITER", n) != 0)
+    return false;
+  const char c = m_text[m_pos + n];
+  return c == ' ' || c == '\t';
+}
+
+void ScriptScanner::skip_quoted(char quote) {
+  m_pos++;
+  while (m_pos < m_size) {
+    const char c = m_text[m_pos++];
+    if (c == '\n') m_lines++;
+    if (c == '\\' && quote != '`' && m_pos < m_size) {
+      if (m_text[m_pos] == '\n') m_lines++;
+      m_pos++;
+    } else if (c == quote) {
+      /* A doubled quote stands for itself */
+      if (m_pos < m_size && m_text[m_pos] == quote)
+        m_pos++;
+      else
+        return;
+    }
+  }
+}
+
+void ScriptScanner::skip_to_eol() {
+  const void *eol = memchr(m_text + m_pos, '\n', m_size - m_pos);
+  m_pos = eol ? static_cast<size_t>(static_cast<const char *>(eol) - m_text)
+              : m_size;
+}
+
+bool ScriptScanner::next(const char **begin, size_t *length) {
+  for (;;) {
+    while (m_pos < m_size && isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+      if (m_text[m_pos] == '\n') m_lines++;
+      m_pos++;
+    }
+    if (m_pos >= m_size) return false;
+
+    if (at_delimiter_command()) {
+      size_t b = m_pos + 9;
+      skip_to_eol();
+      while (b < m_pos && (m_text[b] == ' ' || m_text[b] == '\t')) b++;
+      size_t e = m_pos;
+      while (e > b && isspace(static_cast<unsigned char>(m_text[e - 1]))) e--;
+      if (e > b) m_delimiter.assign(m_text + b, e - b);
+      continue;
+    }
+
+    const size_t start = m_pos;
+    const size_t start_line = m_lines;
+    size_t end = m_size;
+    while (m_pos < m_size) {
+      const char c = m_text[m_pos];
+      if (c == m_delimiter[0] &&
+          m_size - m_pos >= m_delimiter.size() &&
+          memcmp(m_text + m_pos, m_delimiter.data(), m_delimiter.size()) == 0) {
+        end = m_pos;
+        m_pos += m_delimiter.size();
+        break;
+      }
+      const char d = m_pos + 1 < m_size ? m_text[m_pos + 1] : '\0';
+      if (c == '\'' || c == '"' || c == '`') {
+        skip_quoted(c);
+      } else if (c == '#' ||
+                 (c == '-' && d == '-' &&
+                  (m_pos + 2 >= m_size ||
+                   isspace(static_cast<unsigned char>(m_text[m_pos + 2]))))) {
+        skip_to_eol();
+      } else if (c == '/' && d == '*') {
+        m_pos += 2;
+        while (m_pos < m_size &&
+               !(m_text[m_pos] == '*' && m_pos + 1 < m_size &&
+                 m_text[m_pos + 1] == '/')) {
+          if (m_text[m_pos] == '\n') m_lines++;
+          m_pos++;
+        }
+        m_pos = std::min(m_pos + 2, m_size);
+      } else {
+        if (c == '\n') m_lines++;
+        m_pos++;
+      }
+    }
+
+    while (end > start && isspace(static_cast<unsigned char>(m_text[end - 1])))
+      end--;
+    if (end == start) continue;
+    *begin = m_text + start;
+    *length = end - start;
+    m_line = start_line;
+    return true;
+  }
+}
+
+}  // namespace inception
@@ -0,0 +1,80 @@
+/**
+ * @file inception_script.h
+ * @brief "inception audit file": scripts read on the server.
+ *
+ * A client that sends a script statement by statement pays a round trip,
+ * a parse of the packet and an OK for each of them. Inside a session,
+ *
+ *   inception audit file '<name>'
+ *
+ * has the server map <name> from inception_script_dir, split it with
+ * ScriptScanner and audit the statements in one loop, answering once.
+ */
+
+#ifndef SQL_INCEPTION_SCRIPT_H
+#define SQL_INCEPTION_SCRIPT_H
+
+#include <cstddef>
+#include <string>
+
+#include "my_io.h"  // File
+
+namespace inception {
+
+/** A script file mapped read-only. */
+class ScriptFile {
+ public:
+  ScriptFile() = default;
+  ~ScriptFile();
+  ScriptFile(const ScriptFile &) = delete;
+  ScriptFile &operator=(const ScriptFile &) = delete;
+
+  /**
+   * Map the file name of inception_script_dir.
+   * @return true with *err set on error.
+   */
+  bool open(const std::string &name, std::string *err);
+
+  const char *data() const { return m_data; }
+  size_t size() const { return m_size; }
+  const std::string &path() const { return m_path; }
+
+ private:
+  std::string m_path;
+  File m_fd = -1;
+  char *m_data = nullptr;
+  size_t m_size = 0;
+};
+
+/**
+ * Split a script into statements as the mysql client does: at the
+ * delimiter (";" until a DELIMITER line changes it), not inside quotes,
+ * backticks or comments. Statements are returned as ranges of the text,
+ * without the delimiter; those of only spaces are skipped.
+ */
+class ScriptScanner {
+ public:
+  ScriptScanner(const char *text, size_t size) : m_text(text), m_size(size) {}
+
+  /** The next statement in *begin, *length. @return false at the end. */
+  bool next(const char **begin, size_t *length);
+
+  /** 1-based line of the last statement returned, for messages. */
+  size_t line() const { return m_line; }
+
+ private:
+  bool at_delimiter_command() const;
+  void skip_quoted(char quote);
+  void skip_to_eol();
+
+  const char *m_text;
+  size_t m_size;
+  size_t m_pos = 0;
+  size_t m_lines = 1;  /* line of m_pos */
+  size_t m_line = 0;
+  std::string m_delimiter = ";";
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SCRIPT_H
@@ -0,0 +1,800 @@
+/**
+ * @file inception_shadow.cc
+ * @brief Offline shadow schema: audit against a schema dump instead of the
+ *        remote target (--schema-file).
+ */
+
+#include "sql/inception/inception_shadow.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/create_field.h"  // Create_field
+#include "sql/key_spec.h"      // Key_spec
+#include "sql/my_decimal.h"    // my_decimal_length_to_precision
+#include "sql/mysqld.h"        // first_keyword
+#include "sql/sql_alter.h"     // Alter_info
+#include "sql/sql_class.h"     // THD
+#include "sql/sql_lex.h"       // LEX
+#include "sql/sql_list.h"      // List_iterator
+#include "sql/table.h"         // TABLE_LIST
+
+#include "m_ctype.h"  // my_charset_bin
+
+#include <strings.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace inception {
+
+/* Dumps larger than this are refused rather than read into memory */
+static const std::streamoff MAX_SCHEMA_FILE = 256LL * 1024 * 1024;
+
+static std::string lower(const std::string &s) {
+  std::string out(s);
+  for (auto &c : out) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  return out;
+}
+
+static std::string table_key(const std::string &db, const std::string &table) {
+  return lower(db) + '.' + lower(table);
+}
+
+/* ---- Dump tokenizer ---- */
+
+namespace {
+
+using Statement = std::vector<SqlToken>;
+
+/**
+ * Split a dump into tokenized statements. Honours DELIMITER, drops
+ * comments and keeps the body of versioned comments (/ *!40101 ... * /),
+ * which is where mysqldump puts IF NOT EXISTS and table options.
+ */
+class DumpScanner {
+ public:
+  explicit DumpScanner(const std::string &text) : m_text(text) {}
+
+  bool next(Statement *stmt) {
+    stmt->clear();
+    while (m_pos < m_text.size()) {
+      skip_space();
+      if (m_pos >= m_text.size()) break;
+      if (stmt->empty() && starts_with_word("DELIMITER")) {
+        size_t eol = m_text.find('\n', m_pos);
+        if (eol == std::string::npos) eol = m_text.size();
+        std::string arg = m_text.substr(m_pos + 9, eol - m_pos - 9);
+        size_t b = arg.find_first_not_of(" \t\r");
+        size_t e = arg.find_last_not_of(" \t\r");
+        if (b != std::string::npos) m_delimiter = arg.substr(b, e - b + 1);
+        m_pos = eol;
+        continue;
+      }
+      if (m_text.compare(m_pos, m_delimiter.size(), m_delimiter) == 0) {
+        m_pos += m_delimiter.size();
+        if (!stmt->empty()) return true;
+        continue;
+      }
+      if (skip_comment()) continue;
+      stmt->push_back(read_token());
+    }
+    return !stmt->empty();
+  }
+
+ private:
+  void skip_space() {
+    while (m_pos < m_text.size() &&
+           isspace(static_cast<unsigned char>(m_text[m_pos])))
+      m_pos++;
+  }
+
+  bool starts_with_word(const char *word) const {
+    size_t n = strlen(word);
+    if (m_text.size() - m_pos <= n) return false;
+    if (strncasecmp(m_text.c_str() + m_pos, word, n) != 0) return false;
+    return isspace(static_cast<unsigned char>(m_text[m_pos + n]));
+  }
+
+  bool skip_comment() {
+    const char c = m_text[m_pos];
+    const char d = m_pos + 1 < m_text.size() ? m_text[m_pos + 1] : '\0';
+    const char e = m_pos + 2 < m_text.size() ? m_text[m_pos + 2] : '\0';
+    if (c == '#' || (c == '-' && d == '-' && (e == '\0' || isspace(
+                                                  static_cast<unsigned char>(e))))) {
+      size_t eol = m_text.find('\n', m_pos);
+      m_pos = eol == std::string::npos ? m_text.size() : eol + 1;
+      return true;
+    }
+    if (c == '/' && d == '*' && e == '!') {
+      m_pos += 3;
+      while (m_pos < m_text.size() &&
+             isdigit(static_cast<unsigned char>(m_text[m_pos])))
+        m_pos++;
+      m_versioned++;
+      return true;
+    }
+    if (c == '/' && d == '*') {
+      size_t end = m_text.find("*/", m_pos + 2);
+      m_pos = end == std::string::npos ? m_text.size() : end + 2;
+      return true;
+    }
+    if (c == '*' && d == '/' && m_versioned > 0) {
+      m_pos += 2;
+      m_versioned--;
+      return true;
+    }
+    return false;
+  }
+
+  SqlToken read_token() {
+    const char c = m_text[m_pos];
+    if (c == '`' || c == '\'' || c == '"') {
+      std::string out;
+      m_pos++;
+      while (m_pos < m_text.size()) {
+        char ch = m_text[m_pos++];
+        if (ch == '\\' && c != '`' && m_pos < m_text.size()) {
+          out += m_text[m_pos++];
+        } else if (ch == c) {
+          if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            out += c;
+            m_pos++;
+          } else {
+            break;
+          }
+        } else {
+          out += ch;
+        }
+      }
+      return {c == '`' ? SqlToken::IDENT : SqlToken::STRING, out};
+    }
+    if (isdigit(static_cast<unsigned char>(c))) {
+      size_t b = m_pos;
+      while (m_pos < m_text.size() &&
+             (isalnum(static_cast<unsigned char>(m_text[m_pos])) ||
+              m_text[m_pos] == '.'))
+        m_pos++;
+      return {SqlToken::NUMBER, m_text.substr(b, m_pos - b)};
+    }
+    if (isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$' ||
+        static_cast<unsigned char>(c) >= 0x80) {
+      size_t b = m_pos;
+      while (m_pos < m_text.size() &&
+             (isalnum(static_cast<unsigned char>(m_text[m_pos])) ||
+              m_text[m_pos] == '_' || m_text[m_pos] == '$' ||
+              static_cast<unsigned char>(m_text[m_pos]) >= 0x80))
+        m_pos++;
+      return {SqlToken::WORD, m_text.substr(b, m_pos - b)};
+    }
+    m_pos++;
+    return {SqlToken::PUNCT, std::string(1, c)};
+  }
+
+  const std::string &m_text;
+  size_t m_pos = 0;
+  std::string m_delimiter = ";";
+  int m_versioned = 0;  /* open versioned comments */
+};
+
+/* ---- Dump statements ---- */
+
+bool is_word(const Statement &s, size_t i, const char *word) {
+  return i < s.size() && s[i].type == SqlToken::WORD &&
+         strcasecmp(s[i].text.c_str(), word) == 0;
+}
+
+bool is_punct(const Statement &s, size_t i, char c) {
+  return i < s.size() && s[i].type == SqlToken::PUNCT && s[i].text[0] == c;
+}
+
+bool is_name(const Statement &s, size_t i) {
+  return i < s.size() &&
+         (s[i].type == SqlToken::IDENT || s[i].type == SqlToken::WORD);
+}
+
+/** Skip "IF NOT EXISTS" at *i. */
+void skip_if_not_exists(const Statement &s, size_t *i) {
+  if (is_word(s, *i, "IF") && is_word(s, *i + 1, "NOT") &&
+      is_word(s, *i + 2, "EXISTS"))
+    *i += 3;
+}
+
+/** Read [db.]name at *i; db stays untouched when unqualified. */
+bool read_table_name(const Statement &s, size_t *i, std::string *db,
+                     std::string *table) {
+  if (!is_name(s, *i)) return false;
+  *table = s[(*i)++].text;
+  if (is_punct(s, *i, '.') && is_name(s, *i + 1)) {
+    *db = *table;
+    *table = s[*i + 1].text;
+    *i += 2;
+  }
+  return true;
+}
+
+/** Index of the token closing the parenthesis opened at open. */
+size_t close_paren(const Statement &s, size_t open) {
+  int depth = 0;
+  for (size_t i = open; i < s.size(); i++) {
+    if (is_punct(s, i, '(')) depth++;
+    if (is_punct(s, i, ')') && --depth == 0) return i;
+  }
+  return s.size();
+}
+
+/** Canonical information_schema DATA_TYPE of a type keyword. */
+std::string canonical_type(const std::string &word) {
+  std::string t = lower(word);
+  if (t == "integer") return "int";
+  if (t == "bool" || t == "boolean") return "tinyint";
+  if (t == "numeric" || t == "dec" || t == "fixed") return "decimal";
+  if (t == "real") return "double";
+  if (t == "character") return "char";
+  return t;
+}
+
+/** Fill the lengths of col from its type and arguments, like I_S.COLUMNS. */
+void set_type_lengths(RemoteColumnInfo *col, const std::vector<std::string> &args,
+                      bool is_unsigned) {
+  const std::string &t = col->data_type;
+  int64_t a0 = args.empty() ? -1 : strtoll(args[0].c_str(), nullptr, 10);
+  int64_t a1 = args.size() < 2 ? -1 : strtoll(args[1].c_str(), nullptr, 10);
+  col->char_max_length = -1;
+  col->numeric_precision = -1;
+  col->numeric_scale = -1;
+
+  if (t == "char" || t == "binary") {
+    col->char_max_length = a0 < 0 ? 1 : a0;
+  } else if (t == "varchar" || t == "varbinary") {
+    col->char_max_length = a0;
+  } else if (t == "tinytext" || t == "tinyblob") {
+    col->char_max_length = 255;
+  } else if (t == "text" || t == "blob") {
+    col->char_max_length = 65535;
+  } else if (t == "mediumtext" || t == "mediumblob") {
+    col->char_max_length = 16777215;
+  } else if (t == "longtext" || t == "longblob") {
+    col->char_max_length = 4294967295LL;
+  } else if (t == "enum" || t == "set") {
+    int64_t len = 0;
+    for (const auto &v : args) {
+      int64_t n = static_cast<int64_t>(v.size());
+      len = t == "enum" ? std::max(len, n) : len + n + (len ? 1 : 0);
+    }
+    col->char_max_length = len;
+  } else if (t == "tinyint") {
+    col->numeric_precision = 3;
+    col->numeric_scale = 0;
+  } else if (t == "smallint") {
+    col->numeric_precision = 5;
+    col->numeric_scale = 0;
+  } else if (t == "mediumint") {
+    col->numeric_precision = is_unsigned ? 8 : 7;
+    col->numeric_scale = 0;
+  } else if (t == "int") {
+    col->numeric_precision = 10;
+    col->numeric_scale = 0;
+  } else if (t == "bigint") {
+    col->numeric_precision = is_unsigned ? 20 : 19;
+    col->numeric_scale = 0;
+  } else if (t == "decimal") {
+    col->numeric_precision = a0 < 0 ? 10 : a0;
+    col->numeric_scale = a1 < 0 ? 0 : a1;
+  } else if (t == "float" || t == "double") {
+    col->numeric_precision = a0 >= 0 ? a0 : (t == "float" ? 12 : 22);
+    col->numeric_scale = a1;
+  } else if (t == "bit") {
+    col->numeric_precision = a0 < 0 ? 1 : a0;
+  }
+}
+
+/** Index name and first column of a key definition starting at *i. */
+std::string read_index_name(const Statement &s, size_t i) {
+  if (is_name(s, i) && !is_word(s, i, "USING")) return s[i].text;
+  /* Unnamed: MySQL names the index after its first column */
+  while (i < s.size() && !is_punct(s, i, '(')) i++;
+  return is_name(s, i + 1) ? s[i + 1].text : "";
+}
+
+/** Key parts of the first "(...)" list at or after i, as IndexInfo::parts. */
+std::vector<std::string> read_key_parts(const Statement &s, size_t i) {
+  std::vector<std::string> parts;
+  while (i < s.size() && !is_punct(s, i, '(')) i++;
+  const size_t end = close_paren(s, i);
+  size_t k = i + 1;
+  while (k < end) {
+    std::string part = "()";
+    if (is_name(s, k)) {
+      part = lower(s[k].text);
+      if (is_punct(s, k + 1, '(') && k + 2 < end &&
+          s[k + 2].type == SqlToken::NUMBER && is_punct(s, k + 3, ')'))
+        part += "(" + s[k + 2].text + ")";
+    }
+    parts.push_back(std::move(part));
+    /* Next part: past ASC/DESC and the comma, at depth 0 */
+    int depth = 0;
+    while (k < end && !(depth == 0 && is_punct(s, k, ','))) {
+      if (is_punct(s, k, '(')) depth++;
+      if (is_punct(s, k, ')')) depth--;
+      k++;
+    }
+    k++;
+  }
+  return parts;
+}
+
+/** Record index name of meta with its definition. */
+void add_shadow_index(TableMeta *meta, const std::string &name, bool unique,
+                      bool ordered, std::vector<std::string> parts) {
+  const std::string key = lower(name);
+  meta->indexes.insert(key);
+  IndexInfo &index = meta->index_defs[key];
+  index.unique = unique;
+  index.ordered = ordered;
+  index.parts = std::move(parts);
+}
+
+/** Apply one item of a CREATE TABLE body, tokens [b, e). */
+void parse_item(const Statement &s, size_t b, size_t e, TableMeta *meta) {
+  Statement item(s.begin() + b, s.begin() + e);
+  size_t i = 0;
+  std::string symbol;
+  if (is_word(item, i, "CONSTRAINT")) {
+    i++;
+    if (is_name(item, i) && !is_word(item, i, "PRIMARY") &&
+        !is_word(item, i, "UNIQUE") && !is_word(item, i, "FOREIGN") &&
+        !is_word(item, i, "CHECK"))
+      symbol = item[i++].text;
+  }
+
+  if (is_word(item, i, "PRIMARY")) {
+    add_shadow_index(meta, "primary", true, true, read_key_parts(item, i));
+    return;
+  }
+  if (is_word(item, i, "FOREIGN") || is_word(item, i, "CHECK")) return;
+  if (is_word(item, i, "UNIQUE") || is_word(item, i, "FULLTEXT") ||
+      is_word(item, i, "SPATIAL") || is_word(item, i, "KEY") ||
+      is_word(item, i, "INDEX")) {
+    const bool unique = is_word(item, i, "UNIQUE");
+    const bool ordered =
+        !is_word(item, i, "FULLTEXT") && !is_word(item, i, "SPATIAL");
+    if (!is_word(item, i, "KEY") && !is_word(item, i, "INDEX")) i++;
+    if (is_word(item, i, "KEY") || is_word(item, i, "INDEX")) i++;
+    std::string name = is_name(item, i) && !is_word(item, i, "USING")
+                           ? item[i].text
+                           : (symbol.empty() ? read_index_name(item, i) : symbol);
+    if (!name.empty())
+      add_shadow_index(meta, name, unique, ordered, read_key_parts(item, i));
+    return;
+  }
+
+  /* Column: name type[(args)] attributes */
+  if (!is_name(item, i) || !is_name(item, i + 1)) return;
+  const std::string column = item[i].text;
+  RemoteColumnInfo col;
+  col.data_type = canonical_type(item[i + 1].text);
+  i += 2;
+  if (col.data_type == "double" && is_word(item, i, "PRECISION")) i++;
+  if (col.data_type == "char" && is_word(item, i, "VARYING")) {
+    col.data_type = "varchar";
+    i++;
+  }
+  std::vector<std::string> args;
+  if (is_punct(item, i, '(')) {
+    size_t end = close_paren(item, i);
+    for (size_t k = i + 1; k < end; k++)
+      if (!is_punct(item, k, ',')) args.push_back(item[k].text);
+    i = end + 1;
+  }
+  if (col.data_type == "enum" || col.data_type == "set") col.values = args;
+  bool is_unsigned = false;
+  for (size_t k = i; k < item.size(); k++) {
+    if (is_word(item, k, "UNSIGNED")) is_unsigned = true;
+    if (is_word(item, k, "NOT") && is_word(item, k + 1, "NULL"))
+      col.nullable = false;
+    if (is_word(item, k, "CHARSET") && is_name(item, k + 1))
+      col.charset = lower(item[k + 1].text);
+    if (is_word(item, k, "CHARACTER") && is_word(item, k + 1, "SET") &&
+        is_name(item, k + 2))
+      col.charset = lower(item[k + 2].text);
+    if (is_word(item, k, "PRIMARY") && is_word(item, k + 1, "KEY"))
+      add_shadow_index(meta, "primary", true, true, {lower(column)});
+    else if (is_word(item, k, "UNIQUE"))
+      add_shadow_index(meta, column, true, true, {lower(column)});
+  }
+  set_type_lengths(&col, args, is_unsigned);
+  col.is_unsigned = is_unsigned;
+  meta->add_column(column, col);
+}
+
+/** CREATE TABLE [IF NOT EXISTS] [db.]name (...) options | LIKE other */
+void parse_create_table(const Statement &s, size_t i,
+                        const std::string &current_db,
+                        ShadowCatalog *catalog) {
+  skip_if_not_exists(s, &i);
+  std::string db = current_db;
+  std::string table;
+  if (!read_table_name(s, &i, &db, &table) || db.empty()) return;
+
+  std::shared_ptr<TableMeta> meta = std::make_shared<TableMeta>();
+  meta->exists = true;
+  meta->loaded_at = std::chrono::steady_clock::now();
+
+  size_t like = is_punct(s, i, '(') ? i + 1 : i;
+  if (is_word(s, like, "LIKE")) {
+    like++;
+    std::string src_db = current_db;
+    std::string src;
+    if (!read_table_name(s, &like, &src_db, &src)) return;
+    auto it = catalog->tables.find(table_key(src_db, src));
+    if (it == catalog->tables.end()) return;
+    *meta = *it->second;
+    meta->table_rows = 0;
+  } else if (is_punct(s, i, '(')) {
+    size_t end = close_paren(s, i);
+    size_t item = i + 1;
+    int depth = 0;
+    for (size_t k = i + 1; k <= end && k < s.size(); k++) {
+      if (is_punct(s, k, '(')) depth++;
+      if (is_punct(s, k, ')')) depth--;
+      if ((depth == 0 && is_punct(s, k, ',')) || k == end) {
+        parse_item(s, item, k, meta.get());
+        item = k + 1;
+      }
+    }
+    /* Row estimate: the dump's AUTO_INCREMENT, when it has one */
+    for (size_t k = end + 1; k < s.size(); k++) {
+      size_t v = is_punct(s, k + 1, '=') ? k + 2 : k + 1;
+      if (is_word(s, k, "ROW_FORMAT") && is_name(s, v))
+        meta->row_format = lower(s[v].text);
+      if (!is_word(s, k, "AUTO_INCREMENT")) continue;
+      if (v < s.size() && s[v].type == SqlToken::NUMBER)
+        meta->table_rows = strtoll(s[v].text.c_str(), nullptr, 10) - 1;
+    }
+  } else {
+    return;
+  }
+
+  catalog->databases.insert(lower(db));
+  catalog->tables[table_key(db, table)] = meta;
+}
+
+void apply_dump_statement(const Statement &s, std::string *current_db,
+                          ShadowCatalog *catalog) {
+  size_t i = 0;
+  if (is_word(s, 0, "USE") && is_name(s, 1)) {
+    *current_db = s[1].text;
+    return;
+  }
+  if (!is_word(s, i++, "CREATE")) return;
+  if (is_word(s, i, "OR") && is_word(s, i + 1, "REPLACE")) i += 2;
+  if (is_word(s, i, "DATABASE") || is_word(s, i, "SCHEMA")) {
+    i++;
+    skip_if_not_exists(s, &i);
+    if (is_name(s, i)) catalog->databases.insert(lower(s[i].text));
+    return;
+  }
+  if (is_word(s, i, "TABLE")) parse_create_table(s, i + 1, *current_db, catalog);
+}
+
+}  // namespace
+
+std::vector<SqlToken> tokenize_statement(const std::string &text) {
+  DumpScanner scanner(text);
+  Statement stmt;
+  scanner.next(&stmt);
+  return stmt;
+}
+
+bool load_shadow_schema(const std::string &file, ShadowCatalog *catalog,
+                        std::string *err) {
+  const char *dir = opt_shadow_schema_dir;
+  if (!dir || !*dir) {
+    *err = "--schema-file needs inception_shadow_schema_dir.";
+    return true;
+  }
+  /* A plain name inside the directory: no separators, no hidden files */
+  bool valid = !file.empty() && file[0] != '.';
+  for (char c : file)
+    if (!isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-' &&
+        c != '.')
+      valid = false;
+  if (!valid) {
+    *err = "Invalid --schema-file '" + file + "': expected a file name in "
+           "inception_shadow_schema_dir.";
+    return true;
+  }
+
+  const std::string path = std::string(dir) + "/" + file;
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    *err = "Cannot open schema file '" + path + "'.";
+    return true;
+  }
+  in.seekg(0, std::ios::end);
+  if (in.tellg() > MAX_SCHEMA_FILE) {
+    *err = "Schema file '" + path + "' is larger than 256MB.";
+    return true;
+  }
+  in.seekg(0, std::ios::beg);
+  std::ostringstream buf;
+  buf << in.rdbuf();
+  const std::string text = buf.str();
+
+  DumpScanner scanner(text);
+  Statement stmt;
+  std::string current_db;
+  while (scanner.next(&stmt)) apply_dump_statement(stmt, &current_db, catalog);
+
+  fprintf(stderr,
+          "[Inception] Shadow schema '%s': %zu databases, %zu tables.\n",
+          file.c_str(), catalog->databases.size(), catalog->tables.size());
+  fflush(stderr);
+  return false;
+}
+
+TableMetaPtr shadow_table_meta(const ShadowCatalog &catalog, const char *db,
+                               const char *table) {
+  static const TableMetaPtr missing = std::make_shared<TableMeta>();
+  auto it = catalog.tables.find(table_key(db, table));
+  return it == catalog.tables.end() ? missing : it->second;
+}
+
+bool shadow_db_exists(const ShadowCatalog &catalog, const char *db) {
+  return catalog.databases.count(lower(db)) > 0;
+}
+
+/* ---- Virtual DDL ---- */
+
+RemoteColumnInfo column_from_field(const Create_field &field) {
+  const bool binary = field.charset == &my_charset_bin;
+  const char *name = "";
+  switch (field.sql_type) {
+    case MYSQL_TYPE_TINY:        name = "tinyint"; break;
+    case MYSQL_TYPE_SHORT:       name = "smallint"; break;
+    case MYSQL_TYPE_INT24:       name = "mediumint"; break;
+    case MYSQL_TYPE_LONG:        name = "int"; break;
+    case MYSQL_TYPE_LONGLONG:    name = "bigint"; break;
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:  name = "decimal"; break;
+    case MYSQL_TYPE_FLOAT:       name = "float"; break;
+    case MYSQL_TYPE_DOUBLE:      name = "double"; break;
+    case MYSQL_TYPE_BIT:         name = "bit"; break;
+    case MYSQL_TYPE_STRING:      name = binary ? "binary" : "char"; break;
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:     name = binary ? "varbinary" : "varchar"; break;
+    case MYSQL_TYPE_TINY_BLOB:   name = binary ? "tinyblob" : "tinytext"; break;
+    case MYSQL_TYPE_BLOB:        name = binary ? "blob" : "text"; break;
+    case MYSQL_TYPE_MEDIUM_BLOB: name = binary ? "mediumblob" : "mediumtext"; break;
+    case MYSQL_TYPE_LONG_BLOB:   name = binary ? "longblob" : "longtext"; break;
+    case MYSQL_TYPE_DATE:
+    case MYSQL_TYPE_NEWDATE:     name = "date"; break;
+    case MYSQL_TYPE_TIME:
+    case MYSQL_TYPE_TIME2:       name = "time"; break;
+    case MYSQL_TYPE_DATETIME:
+    case MYSQL_TYPE_DATETIME2:   name = "datetime"; break;
+    case MYSQL_TYPE_TIMESTAMP:
+    case MYSQL_TYPE_TIMESTAMP2:  name = "timestamp"; break;
+    case MYSQL_TYPE_YEAR:        name = "year"; break;
+    case MYSQL_TYPE_JSON:        name = "json"; break;
+    case MYSQL_TYPE_ENUM:        name = "enum"; break;
+    case MYSQL_TYPE_SET:         name = "set"; break;
+    case MYSQL_TYPE_GEOMETRY:    name = "geometry"; break;
+    default: break;
+  }
+
+  RemoteColumnInfo col;
+  col.data_type = name;
+  const std::string width =
+      std::to_string(field.max_display_width_in_codepoints());
+  std::vector<std::string> args;
+  if (field.sql_type == MYSQL_TYPE_NEWDECIMAL ||
+      field.sql_type == MYSQL_TYPE_DECIMAL) {
+    uint precision = my_decimal_length_to_precision(
+        static_cast<uint>(field.max_display_width_in_codepoints()),
+        field.decimals, field.is_unsigned);
+    args = {std::to_string(precision), std::to_string(field.decimals)};
+  } else if (field.sql_type != MYSQL_TYPE_FLOAT &&
+             field.sql_type != MYSQL_TYPE_DOUBLE) {
+    args = {width};
+  }
+  set_type_lengths(&col, args, field.is_unsigned);
+  if (col.data_type == "enum" || col.data_type == "set") {
+    col.char_max_length = static_cast<int64_t>(field.max_display_width_in_codepoints());
+    List_iterator<String> it(const_cast<List<String> &>(field.interval_list));
+    String *value;
+    while ((value = it++)) col.values.emplace_back(value->ptr(), value->length());
+  }
+  if (col.char_max_length >= 0 && !binary && field.charset)
+    col.charset = lower(field.charset->csname);
+  col.nullable = !(field.flags & NOT_NULL_FLAG);
+  col.is_unsigned = field.is_unsigned;
+  return col;
+}
+
+/** Index of name in meta->column_order, or its size. */
+static size_t column_position(const TableMeta &meta, const std::string &name) {
+  const std::string key = lower(name);
+  size_t i = 0;
+  while (i < meta.column_order.size() && lower(meta.column_order[i]) != key)
+    i++;
+  return i;
+}
+
+/**
+ * Put column name where ADD / CHANGE / MODIFY leaves it: FIRST, AFTER
+ * another column, else in place of the column it replaces or at the end.
+ */
+static void place_column(TableMeta *meta, const std::string &name,
+                         const RemoteColumnInfo &info, const char *replaces,
+                         const char *after) {
+  size_t pos = meta->column_order.size();
+  for (const char *old : {replaces, name.c_str()}) {
+    if (!old || !meta->columns.erase(lower(old))) continue;
+    const size_t i = column_position(*meta, old);
+    if (i < meta->column_order.size()) {
+      meta->column_order.erase(meta->column_order.begin() + i);
+      pos = std::min(pos, i);
+    }
+  }
+  if (after == first_keyword)
+    pos = 0;
+  else if (after)
+    pos = std::min(column_position(*meta, after) + 1,
+                   meta->column_order.size());
+  meta->columns[lower(name)] = info;
+  meta->column_order.insert(meta->column_order.begin() + pos, name);
+}
+
+IndexInfo index_info(const Key_spec &key) {
+  IndexInfo index;
+  index.unique = key.type == KEYTYPE_PRIMARY || key.type == KEYTYPE_UNIQUE;
+  index.ordered = key.type != KEYTYPE_FULLTEXT && key.type != KEYTYPE_SPATIAL;
+  for (const Key_part_spec *part : key.columns) {
+    if (!part->get_field_name()) {
+      index.parts.push_back("()");
+      continue;
+    }
+    std::string name = lower(part->get_field_name());
+    if (part->get_prefix_length())
+      name += "(" + std::to_string(part->get_prefix_length()) + ")";
+    index.parts.push_back(std::move(name));
+  }
+  return index;
+}
+
+/** The ALTER TABLE / CREATE INDEX / DROP INDEX clauses of alter_info on meta. */
+static void apply_alter(const Alter_info &alter_info, TableMeta *meta) {
+  for (const auto *drop : alter_info.drop_list) {
+    if (drop->type == Alter_drop::COLUMN)
+      meta->drop_column(drop->name);
+    else if (drop->type == Alter_drop::KEY) {
+      meta->indexes.erase(lower(drop->name));
+      meta->index_defs.erase(lower(drop->name));
+    }
+  }
+
+  List_iterator<Create_field> it(const_cast<List<Create_field> &>(
+      alter_info.create_list));
+  Create_field *field;
+  while ((field = it++))
+    place_column(meta, field->field_name, column_from_field(*field),
+                 field->change, field->after);
+
+  for (const auto *col : alter_info.alter_list) {
+    if (col->change_type() != Alter_column::Type::RENAME_COLUMN) continue;
+    auto c = meta->columns.find(lower(col->name));
+    if (c == meta->columns.end()) continue;
+    RemoteColumnInfo info = c->second;
+    meta->columns.erase(c);
+    meta->columns[lower(col->m_new_name)] = info;
+    const size_t i = column_position(*meta, col->name);
+    if (i < meta->column_order.size())
+      meta->column_order[i] = col->m_new_name;
+  }
+
+  for (const auto *rk : alter_info.alter_rename_key_list) {
+    if (!meta->indexes.erase(lower(rk->old_name))) continue;
+    meta->indexes.insert(lower(rk->new_name));
+    auto def = meta->index_defs.find(lower(rk->old_name));
+    if (def == meta->index_defs.end()) continue;
+    IndexInfo index = std::move(def->second);
+    meta->index_defs.erase(def);
+    meta->index_defs[lower(rk->new_name)] = std::move(index);
+  }
+
+  for (const Key_spec *key : alter_info.key_list) {
+    if (key->type == KEYTYPE_FOREIGN) continue;
+    std::string name;
+    if (key->type == KEYTYPE_PRIMARY)
+      name = "primary";
+    else if (key->name.str && key->name.length)
+      name = key->name.str;
+    else if (!key->columns.empty() && key->columns[0]->get_field_name())
+      name = key->columns[0]->get_field_name();
+    if (name.empty()) continue;
+    meta->indexes.insert(lower(name));
+    meta->index_defs[lower(name)] = index_info(*key);
+  }
+}
+
+void shadow_apply_ddl(THD *thd, InceptionContext *ctx) {
+  ShadowCatalog *catalog = ctx->shadow.get();
+  if (!catalog) return;
+  LEX *lex = thd->lex;
+  const char *current_db = thd->db().str;
+  auto db_of = [current_db](const TABLE_LIST *tl) -> std::string {
+    return tl->db ? tl->db : (current_db ? current_db : "");
+  };
+
+  switch (lex->sql_command) {
+    case SQLCOM_CREATE_DB:
+      if (lex->name.str) catalog->databases.insert(lower(lex->name.str));
+      break;
+    case SQLCOM_DROP_DB: {
+      if (!lex->name.str) break;
+      const std::string db = lower(lex->name.str);
+      catalog->databases.erase(db);
+      auto it = catalog->tables.lower_bound(db + '.');
+      while (it != catalog->tables.end() &&
+             it->first.compare(0, db.size() + 1, db + '.') == 0)
+        it = catalog->tables.erase(it);
+      break;
+    }
+    case SQLCOM_DROP_TABLE:
+      for (TABLE_LIST *tl = lex->query_tables; tl; tl = tl->next_global)
+        catalog->tables.erase(table_key(db_of(tl), tl->table_name));
+      break;
+    case SQLCOM_RENAME_TABLE:
+      for (TABLE_LIST *tl = lex->query_tables; tl && tl->next_local;
+           tl = tl->next_local->next_local) {
+        auto it = catalog->tables.find(table_key(db_of(tl), tl->table_name));
+        if (it == catalog->tables.end()) continue;
+        TableMetaPtr meta = it->second;
+        catalog->tables.erase(it);
+        catalog->tables[table_key(db_of(tl->next_local),
+                                  tl->next_local->table_name)] = meta;
+      }
+      break;
+    case SQLCOM_TRUNCATE: {
+      TABLE_LIST *tl = lex->query_tables;
+      if (!tl) break;
+      auto it = catalog->tables.find(table_key(db_of(tl), tl->table_name));
+      if (it == catalog->tables.end()) break;
+      auto meta = std::make_shared<TableMeta>(*it->second);
+      meta->table_rows = 0;
+      it->second = meta;
+      break;
+    }
+    case SQLCOM_ALTER_TABLE:
+    case SQLCOM_CREATE_INDEX:
+    case SQLCOM_DROP_INDEX: {
+      TABLE_LIST *tl = lex->query_tables;
+      if (!tl || !lex->alter_info) break;
+      auto it = catalog->tables.find(table_key(db_of(tl), tl->table_name));
+      if (it == catalog->tables.end()) break;
+      /* Copy on write: snapshots handed out stay as they were */
+      auto meta = std::make_shared<TableMeta>(*it->second);
+      apply_alter(*lex->alter_info, meta.get());
+      if (lex->alter_info->flags & Alter_info::ALTER_RENAME) {
+        const LEX_CSTRING &new_db = lex->alter_info->new_db_name;
+        const LEX_CSTRING &new_name = lex->alter_info->new_table_name;
+        catalog->tables.erase(it);
+        catalog->tables[table_key(new_db.str ? new_db.str : db_of(tl),
+                                  new_name.str ? new_name.str
+                                               : tl->table_name)] = meta;
+      } else {
+        it->second = meta;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+}  // namespace inception
@@ -0,0 +1,101 @@
+/**
+ * @file inception_shadow.h
+ * @brief Offline shadow schema: audit against a schema dump instead of the
+ *        remote target (--schema-file).
+ *
+ * Every existence, type and index rule asks the target, so a CHECK needs
+ * network access to production. With --schema-file=<name> the session
+ * loads a schema dump from inception_shadow_schema_dir, the output of
+ * "mysqldump --no-data" or a series of SHOW CREATE TABLE statements, into an
+ * in-memory catalog of databases and tables with their columns (type,
+ * length, precision), indexes (key parts, uniqueness) and row estimate (AUTO_INCREMENT - 1
+ * when the dump has one). get_table_meta() and cached_db_exists() then
+ * answer from the catalog and the session never connects to the target,
+ * so --host, --user and --port may be omitted. Rules that need a live
+ * server (EXPLAIN row estimates, version detection) fall back to the
+ * catalog or are skipped.
+ *
+ * DDL of the batch that passed the audit is applied to the catalog as it
+ * goes: CREATE / DROP DATABASE, DROP / RENAME / TRUNCATE TABLE, and the
+ * column, index and rename clauses of ALTER TABLE, CREATE INDEX and DROP
+ * INDEX. Tables created in the batch stay in ctx->batch_tables as before.
+ *
+ * The catalog belongs to the session and is only read and changed by the
+ * thread auditing it. Only CHECK mode uses it; EXECUTE needs the target.
+ */
+
+#ifndef SQL_INCEPTION_SHADOW_H
+#define SQL_INCEPTION_SHADOW_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "sql/inception/inception_cache.h"  // TableMeta, TableMetaPtr
+
+class Create_field;
+class Key_spec;
+class THD;
+
+namespace inception {
+
+struct InceptionContext;
+
+/** Databases and tables of a schema dump; keys are lower-case. */
+struct ShadowCatalog {
+  std::set<std::string> databases;
+  std::map<std::string, TableMetaPtr> tables;  /* "db.table" */
+};
+
+/** A token of a dump statement or of a statement read from the binlog. */
+struct SqlToken {
+  enum Type { WORD, IDENT, STRING, NUMBER, PUNCT };
+  Type type;
+  std::string text;  /* unquoted for IDENT and STRING */
+};
+
+/**
+ * Tokens of the first statement of text, up to ';'. Comments are dropped
+ * and the bodies of versioned comments kept.
+ */
+std::vector<SqlToken> tokenize_statement(const std::string &text);
+
+/**
+ * Load the dump named file from inception_shadow_schema_dir into *catalog.
+ * file must be a plain name inside that directory. Returns true on error
+ * with the reason in *err.
+ */
+bool load_shadow_schema(const std::string &file, ShadowCatalog *catalog,
+                        std::string *err);
+
+/**
+ * Metadata of db.table in the catalog; a TableMeta with exists = false
+ * when the dump has no such table. Never nullptr.
+ */
+TableMetaPtr shadow_table_meta(const ShadowCatalog &catalog, const char *db,
+                               const char *table);
+
+/** True if the catalog has database db. */
+bool shadow_db_exists(const ShadowCatalog &catalog, const char *db);
+
+/** IndexInfo of a key of a parsed CREATE / ALTER statement. */
+IndexInfo index_info(const Key_spec &key);
+
+/**
+ * information_schema view of a column definition of a parsed CREATE /
+ * ALTER statement: DATA_TYPE, lengths, nullability, ENUM / SET members and
+ * the character set when the definition names one.
+ */
+RemoteColumnInfo column_from_field(const Create_field &field);
+
+/**
+ * Apply the DDL statement in thd->lex, which passed the audit, to
+ * ctx->shadow. No-op for anything else.
+ */
+void shadow_apply_ddl(THD *thd, InceptionContext *ctx);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SHADOW_H
@@ -0,0 +1,320 @@
+/**
+ * @file inception_shared.cc
+ * @brief Metadata cache tier shared by inception instances.
+ */
+
+#include "sql/inception/inception_shared.h"
+
+#include "sql/inception/inception_exec.h"  // format_sql, run_sql
+#include "sql/inception/inception_parse.h"  // decrypt_password
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_snapshot.h"  // encode_table_meta
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace inception {
+
+namespace {
+
+/* How often an instance compares the version of a target */
+const std::chrono::seconds EPOCH_INTERVAL(1);
+
+/* An unreachable tier is tried again after this */
+const std::chrono::seconds RETRY_INTERVAL(30);
+
+/* How long a shared rebuild speed is used before it is read again */
+const std::chrono::seconds SPEED_INTERVAL(60);
+
+/* Statement size at which stored entries are sent */
+const size_t PUT_BATCH_BYTES = 1024 * 1024;
+
+struct EpochState {
+  bool known = false;
+  uint64_t epoch = 0;
+  std::chrono::steady_clock::time_point checked;
+};
+
+struct SpeedState {
+  bool asked = false;
+  bool found = false;
+  double speed = 0;
+  std::chrono::steady_clock::time_point read;
+};
+
+InceptionMutex g_shared_mutex("shared_cache");
+std::string g_server;                     /* host:port the state is of */
+bool g_tables_ready = false;              /* inception_shared created */
+std::chrono::steady_clock::time_point g_down_until;
+std::map<std::string, EpochState> g_epochs;  /* target */
+std::map<std::string, SpeedState> g_speeds;  /* target/algorithm */
+
+/** A pooled connection to the tier; false while it is down. */
+class SharedConn {
+ public:
+  SharedConn();
+  ~SharedConn() {
+    if (m_mysql)
+      pool_release(m_mysql, m_failed ? PoolRelease::DIRTY : PoolRelease::CLEAN);
+  }
+  SharedConn(const SharedConn &) = delete;
+  SharedConn &operator=(const SharedConn &) = delete;
+
+  explicit operator bool() const { return m_mysql && !m_failed; }
+  MYSQL *mysql() const { return m_mysql; }
+
+  /** s escaped for a single-quoted string. */
+  std::string escape(const std::string &s) const;
+
+  /** Run query, discarding any result. Returns true on error. */
+  bool run(const std::string &query);
+
+  /** Run query and store its result; nullptr on error. */
+  MYSQL_RES *select(const std::string &query);
+
+ private:
+  void down(const std::string &err);
+
+  std::string m_server;
+  MYSQL *m_mysql = nullptr;
+  bool m_failed = false;
+};
+
+SharedConn::SharedConn() {
+  const std::string host = opt_shared_cache_host ? opt_shared_cache_host : "";
+  if (host.empty()) return;
+  const uint port = static_cast<uint>(opt_shared_cache_port);
+  m_server = host + ':' + std::to_string(port);
+  bool ready;
+  {
+    std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+    if (g_server != m_server) {
+      /* Another server: nothing known of it yet */
+      g_server = m_server;
+      g_tables_ready = false;
+      g_down_until = std::chrono::steady_clock::time_point();
+      g_epochs.clear();
+      g_speeds.clear();
+    }
+    if (std::chrono::steady_clock::now() < g_down_until) return;
+    ready = g_tables_ready;
+  }
+
+  std::string user = opt_shared_cache_user ? opt_shared_cache_user : "";
+  if (user.empty()) user = "root";
+  const std::string password = decrypt_password(
+      opt_shared_cache_password ? opt_shared_cache_password : "");
+  PoolConnOptions opts;
+  opts.connect_timeout = 2;
+  opts.read_timeout = 5;
+  opts.write_timeout = 5;
+  std::string err;
+  m_mysql = pool_acquire(host, port, user, password, opts, &err);
+  if (!m_mysql) {
+    down(err);
+    return;
+  }
+  if (ready) return;
+  for (const char *query :
+       {remote_sql::SHARED_CREATE_DB, remote_sql::SHARED_CREATE_EPOCH_TABLE,
+        remote_sql::SHARED_CREATE_META_TABLE,
+        remote_sql::SHARED_CREATE_SPEED_TABLE})
+    if (run(query)) return;
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  if (g_server == m_server) g_tables_ready = true;
+}
+
+void SharedConn::down(const std::string &err) {
+  m_failed = true;
+  fprintf(stderr,
+          "[Inception] Shared cache tier %s unavailable for %lld seconds: "
+          "%s\n",
+          m_server.c_str(), static_cast<long long>(RETRY_INTERVAL.count()),
+          err.c_str());
+  fflush(stderr);
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  if (g_server == m_server)
+    g_down_until = std::chrono::steady_clock::now() + RETRY_INTERVAL;
+}
+
+std::string SharedConn::escape(const std::string &s) const {
+  std::string out(s.size() * 2 + 1, '\0');
+  out.resize(mysql_real_escape_string_quote(
+      m_mysql, &out[0], s.data(), static_cast<unsigned long>(s.size()),
+      '\''));
+  return out;
+}
+
+bool SharedConn::run(const std::string &query) {
+  if (!*this) return true;
+  std::string err;
+  if (!run_sql(m_mysql, query, &err)) return false;
+  down(err);
+  return true;
+}
+
+MYSQL_RES *SharedConn::select(const std::string &query) {
+  if (!*this) return nullptr;
+  MYSQL_RES *res = nullptr;
+  if (mysql_real_query(m_mysql, query.data(),
+                       static_cast<unsigned long>(query.size())) == 0)
+    res = mysql_store_result(m_mysql);
+  if (!res) down(mysql_error(m_mysql));
+  return res;
+}
+
+}  // namespace
+
+bool shared_cache_enabled() {
+  return opt_metadata_cache_ttl > 0 && opt_shared_cache_host &&
+         opt_shared_cache_host[0] != '\0';
+}
+
+bool shared_get_tables(const std::string &target,
+                       const std::vector<SchemaTable> &refs,
+                       std::vector<std::pair<SchemaTable, TableMetaPtr>> *found,
+                       uint64_t *epoch) {
+  if (refs.empty()) return true;
+  SharedConn conn;
+  if (!conn) return true;
+  const std::string t = conn.escape(target);
+  std::string list;
+  for (const auto &ref : refs) {
+    if (!list.empty()) list += ',';
+    list += "('" + conn.escape(ref.first) + "','" + conn.escape(ref.second) +
+            "')";
+  }
+  MYSQL_RES *res = conn.select(format_sql(remote_sql::SHARED_GET_TABLES,
+                                          t.c_str(), t.c_str(),
+                                          opt_metadata_cache_ttl,
+                                          list.c_str()));
+  if (!res) return true;
+  *epoch = 0;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    if (row[0]) *epoch = strtoull(row[0], nullptr, 10);
+    if (!row[1] || !row[2] || !row[3]) continue;
+    const unsigned long *lengths = mysql_fetch_lengths(res);
+    TableMetaPtr meta = decode_table_meta(std::string(row[3], lengths[3]));
+    if (meta) found->emplace_back(SchemaTable(row[1], row[2]), std::move(meta));
+  }
+  mysql_free_result(res);
+  return false;
+}
+
+void shared_put_tables(
+    const std::string &target,
+    const std::vector<std::pair<SchemaTable, TableMetaPtr>> &tables,
+    uint64_t epoch) {
+  if (tables.empty()) return;
+  SharedConn conn;
+  if (!conn) return;
+  const std::string t = conn.escape(target);
+  std::string query;
+  for (const auto &table : tables) {
+    const std::string text = encode_table_meta(
+        table.first.first, table.first.second, *table.second);
+    if (text.empty()) continue;
+    query += query.empty() ? remote_sql::SHARED_PUT_TABLES : ",";
+    query += format_sql(remote_sql::SHARED_TABLE_ROW, t.c_str(),
+                        conn.escape(table.first.first).c_str(),
+                        conn.escape(table.first.second).c_str(),
+                        static_cast<unsigned long long>(epoch),
+                        conn.escape(text).c_str());
+    if (query.size() < PUT_BATCH_BYTES) continue;
+    if (conn.run(query)) return;
+    query.clear();
+  }
+  if (!query.empty()) conn.run(query);
+}
+
+void shared_bump_epoch(const std::string &target) {
+  SharedConn conn;
+  if (!conn || conn.run(format_sql(remote_sql::SHARED_BUMP_EPOCH,
+                                   conn.escape(target).c_str())))
+    return;
+  /* Our own bump alone is no reason to drop the local entries */
+  const uint64_t epoch = mysql_insert_id(conn.mysql());
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  EpochState &state = g_epochs[target];
+  if (state.known && state.epoch + 1 == epoch) state.epoch = epoch;
+}
+
+bool shared_epoch_changed(const std::string &target) {
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+    EpochState &state = g_epochs[target];
+    if (state.known && now - state.checked < EPOCH_INTERVAL) return false;
+    state.checked = now;
+  }
+  SharedConn conn;
+  if (!conn) return false;
+  MYSQL_RES *res = conn.select(format_sql(remote_sql::SHARED_GET_EPOCH,
+                                          conn.escape(target).c_str()));
+  if (!res) return false;
+  MYSQL_ROW row = mysql_fetch_row(res);
+  const uint64_t epoch =
+      row && row[0] ? strtoull(row[0], nullptr, 10) : 0;
+  mysql_free_result(res);
+
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  EpochState &state = g_epochs[target];
+  const bool changed = state.known && state.epoch != epoch;
+  state.known = true;
+  state.epoch = epoch;
+  return changed;
+}
+
+bool shared_rebuild_speed(const std::string &target,
+                          const std::string &algorithm, double *speed) {
+  const std::string key = target + '/' + algorithm;
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+    SpeedState &state = g_speeds[key];
+    if (state.asked && now - state.read < SPEED_INTERVAL) {
+      *speed = state.speed;
+      return state.found;
+    }
+    /* The others use the speed read last while this one asks */
+    state.asked = true;
+    state.read = now;
+  }
+  SharedConn conn;
+  MYSQL_RES *res =
+      conn ? conn.select(format_sql(remote_sql::SHARED_GET_SPEED,
+                                    conn.escape(target).c_str(),
+                                    conn.escape(algorithm).c_str()))
+           : nullptr;
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  SpeedState &state = g_speeds[key];
+  if (res) {
+    MYSQL_ROW row = mysql_fetch_row(res);
+    state.found = row && row[0];
+    if (state.found) state.speed = strtod(row[0], nullptr);
+    mysql_free_result(res);
+  }
+  *speed = state.speed;
+  return state.found;
+}
+
+void shared_note_rebuild(const std::string &target,
+                         const std::string &algorithm, double speed) {
+  SharedConn conn;
+  if (!conn ||
+      conn.run(format_sql(remote_sql::SHARED_NOTE_SPEED,
+                          conn.escape(target).c_str(),
+                          conn.escape(algorithm).c_str(), speed)))
+    return;
+  std::lock_guard<InceptionMutex> lock(g_shared_mutex);
+  g_speeds.erase(target + '/' + algorithm);
+}
+
+}  // namespace inception
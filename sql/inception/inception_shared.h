@@ -0,0 +1,80 @@
+/**
+ * @file inception_shared.h
+ * @brief Metadata cache tier shared by inception instances.
+ *
+ * Several inception instances behind a load balancer each keep their own
+ * metadata cache (inception_cache.h), so every one of them loads every
+ * table from the production target. With inception_shared_cache_host set,
+ * the instances pointed at the same MySQL server share its database
+ * inception_shared as a second tier:
+ *
+ *   - a local miss asks table_meta before the target, and what is loaded
+ *     from the target is stored there, in the snapshot file encoding
+ *     (inception_snapshot.h), for inception_metadata_cache_ttl seconds;
+ *   - target_epoch holds a version per target, bumped by every
+ *     invalidation an instance makes (DDL it executed, DDL its binlog
+ *     watcher saw). An entry is only valid at the version it was loaded
+ *     at, read before the load, so an entry stored while DDL ran is never
+ *     answered. Each instance compares the version at most once per
+ *     EPOCH_INTERVAL and drops its local entries of a target when it
+ *     moved, which also retires its audit cache results of that target;
+ *   - rebuild_speed holds the speeds learned from timed native ALTERs
+ *     (cache_note_rebuild()), so every instance estimates with all of them.
+ *
+ * The tier is an optimization only: an unreachable server is retried
+ * after RETRY_INTERVAL, and meanwhile every instance asks the targets
+ * itself. Off with inception_metadata_cache_ttl = 0, like the local cache.
+ * Entries from the tier are never pinned by the binlog watcher.
+ */
+
+#ifndef SQL_INCEPTION_SHARED_H
+#define SQL_INCEPTION_SHARED_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sql/inception/inception_cache.h"  // SchemaTable, TableMetaPtr
+
+namespace inception {
+
+/** inception_shared_cache_host is set and the metadata cache is on. */
+bool shared_cache_enabled();
+
+/**
+ * The entries of refs the tier holds at the current version of target,
+ * appended to *found, the version in *epoch.
+ * @return true if the tier could not be asked.
+ */
+bool shared_get_tables(const std::string &target,
+                       const std::vector<SchemaTable> &refs,
+                       std::vector<std::pair<SchemaTable, TableMetaPtr>> *found,
+                       uint64_t *epoch);
+
+/** Store tables loaded from target since version epoch was read. */
+void shared_put_tables(
+    const std::string &target,
+    const std::vector<std::pair<SchemaTable, TableMetaPtr>> &tables,
+    uint64_t epoch);
+
+/** Bump the version of target: its entries in the tier are stale. */
+void shared_bump_epoch(const std::string &target);
+
+/**
+ * Whether the version of target moved since this instance last compared
+ * it; compared at most once per EPOCH_INTERVAL, false in between.
+ */
+bool shared_epoch_changed(const std::string &target);
+
+/** The shared rebuild speed of target and algorithm, false if none. */
+bool shared_rebuild_speed(const std::string &target,
+                          const std::string &algorithm, double *speed);
+
+/** Blend speed (MB/s) of one timed ALTER into the shared one. */
+void shared_note_rebuild(const std::string &target,
+                         const std::string &algorithm, double speed);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SHARED_H
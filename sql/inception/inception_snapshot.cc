@@ -0,0 +1,626 @@
+/**
+ * @file inception_snapshot.cc
+ * @brief Persistent schema snapshots kept fresh from the target's binlog.
+ */
+
+#include "sql/inception/inception_snapshot.h"
+
+#include "sql/inception/inception_binlog.h"
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_shadow.h"  // tokenize_statement
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "libbinlogevents/include/binlog_event.h"  // QUERY_EVENT
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <strings.h>
+#include <system_error>
+#include <thread>
+
+namespace inception {
+
+/* Version 2: "col" lines in column order, names as stored.
+   Version 3: "idx" lines carry uniqueness, kind and key parts.
+   Version 4: "table" lines carry ROW_FORMAT, "col" lines the charset,
+   nullability, signedness and ENUM / SET members. */
+static const char *SNAPSHOT_MAGIC = "inception-schema-snapshot 4";
+
+/* How often a streaming watcher rewrites its snapshot */
+static const std::chrono::seconds SNAPSHOT_INTERVAL(60);
+
+/* A failed watcher is restarted by a later session at most this often */
+static const std::chrono::seconds RETRY_INTERVAL(60);
+
+/* ---- DDL in binlog Query events ---- */
+
+namespace {
+
+class DdlReader {
+ public:
+  DdlReader(const std::string &db, const std::string &query)
+      : m_db(db), m_tok(tokenize_statement(query)) {}
+
+  std::vector<SchemaTable> tables() {
+    if (word(0, "RENAME") && word(1, "TABLE")) {
+      /* RENAME TABLE a TO b, c TO d */
+      m_pos = 2;
+      while (read_name()) {
+        if (!word(m_pos, "TO") && !punct(m_pos, ',')) break;
+        m_pos++;
+      }
+      return done();
+    }
+    if (word(0, "TRUNCATE")) {
+      m_pos = word(1, "TABLE") ? 2 : 1;
+      read_name();
+      return done();
+    }
+    const bool create = word(0, "CREATE");
+    const bool drop = word(0, "DROP");
+    if (!create && !drop && !word(0, "ALTER")) return m_out;
+
+    /* Skip OR REPLACE, ALGORITHM = .., DEFINER = .., UNIQUE, ... up to the
+       object type */
+    for (m_pos = 1; m_pos < m_tok.size() && m_pos < 16; m_pos++) {
+      if (word(m_pos, "TEMPORARY")) return m_out;  /* not in the cache */
+      if (word(m_pos, "DATABASE") || word(m_pos, "SCHEMA")) {
+        m_pos++;
+        skip_if_exists();
+        if (m_pos < m_tok.size() && is_name(m_pos))
+          m_out.emplace_back(m_tok[m_pos].text, "");
+        else if (!m_db.empty())
+          m_out.emplace_back(m_db, "");
+        return m_out;
+      }
+      if (word(m_pos, "TABLE") || word(m_pos, "VIEW")) {
+        m_pos++;
+        skip_if_exists();
+        if (!read_name()) return done();
+        if (drop) {
+          while (punct(m_pos, ',')) {
+            m_pos++;
+            if (!read_name()) break;
+          }
+        } else if (!create) {
+          read_alter_rename();
+        }
+        return done();
+      }
+      if (word(m_pos, "INDEX")) {
+        while (m_pos < m_tok.size() && !word(m_pos, "ON")) m_pos++;
+        m_pos++;
+        read_name();
+        return done();
+      }
+      /* USER, ROLE, TRIGGER, PROCEDURE, FUNCTION, EVENT, TABLESPACE, ... */
+      if (is_name(m_pos) && m_tok[m_pos].type == SqlToken::WORD &&
+          !word(m_pos, "OR") && !word(m_pos, "REPLACE") &&
+          !word(m_pos, "UNIQUE") && !word(m_pos, "FULLTEXT") &&
+          !word(m_pos, "SPATIAL") && !word(m_pos, "ONLINE") &&
+          !word(m_pos, "OFFLINE") && !word(m_pos, "ALGORITHM") &&
+          !word(m_pos, "DEFINER") && !word(m_pos, "SQL") &&
+          !word(m_pos, "SECURITY") && !word(m_pos, "UNDEFINED") &&
+          !word(m_pos, "MERGE") && !word(m_pos, "TEMPTABLE") &&
+          !word(m_pos, "INVOKER") && !word(m_pos, "CURRENT_USER") &&
+          m_pos > 0 && !punct(m_pos - 1, '=') && !punct(m_pos - 1, '@'))
+        return m_out;
+    }
+    return m_out;
+  }
+
+ private:
+  bool word(size_t i, const char *w) const {
+    return i < m_tok.size() && m_tok[i].type == SqlToken::WORD &&
+           strcasecmp(m_tok[i].text.c_str(), w) == 0;
+  }
+
+  bool punct(size_t i, char c) const {
+    return i < m_tok.size() && m_tok[i].type == SqlToken::PUNCT &&
+           m_tok[i].text[0] == c;
+  }
+
+  bool is_name(size_t i) const {
+    return i < m_tok.size() && (m_tok[i].type == SqlToken::IDENT ||
+                                m_tok[i].type == SqlToken::WORD);
+  }
+
+  void skip_if_exists() {
+    if (word(m_pos, "IF") && word(m_pos + 1, "NOT") &&
+        word(m_pos + 2, "EXISTS"))
+      m_pos += 3;
+    else if (word(m_pos, "IF") && word(m_pos + 1, "EXISTS"))
+      m_pos += 2;
+  }
+
+  /** [db.]table at m_pos into m_out; false if there is none. */
+  bool read_name() {
+    if (!is_name(m_pos)) {
+      m_failed = true;
+      return false;
+    }
+    std::string db = m_db;
+    std::string table = m_tok[m_pos++].text;
+    if (punct(m_pos, '.') && is_name(m_pos + 1)) {
+      db = table;
+      table = m_tok[m_pos + 1].text;
+      m_pos += 2;
+    }
+    if (db.empty()) {
+      m_failed = true;
+      return false;
+    }
+    m_out.emplace_back(db, table);
+    return true;
+  }
+
+  /** ALTER TABLE a ... RENAME [TO | AS] b also changes b. */
+  void read_alter_rename() {
+    for (; m_pos < m_tok.size(); m_pos++) {
+      if (!word(m_pos, "RENAME")) continue;
+      size_t k = m_pos + 1;
+      if (word(k, "COLUMN") || word(k, "INDEX") || word(k, "KEY")) continue;
+      if (word(k, "TO") || word(k, "AS")) k++;
+      m_pos = k;
+      read_name();
+      return;
+    }
+  }
+
+  /** Unparsable table DDL: drop the whole default database. */
+  std::vector<SchemaTable> done() {
+    if (m_failed && !m_db.empty()) m_out.emplace_back(m_db, "");
+    return m_out;
+  }
+
+  const std::string m_db;
+  const std::vector<SqlToken> m_tok;
+  size_t m_pos = 0;
+  bool m_failed = false;
+  std::vector<SchemaTable> m_out;
+};
+
+}  // namespace
+
+std::vector<SchemaTable> binlog_ddl_tables(const std::string &db,
+                                           const std::string &query) {
+  return DdlReader(db, query).tables();
+}
+
+/* ---- Snapshot files ---- */
+
+/** Pinned tables of a target and the binlog position they are valid at. */
+struct Snapshot {
+  BinlogPos pos;
+  std::vector<std::pair<SchemaTable, std::shared_ptr<TableMeta>>> tables;
+};
+
+static std::string snapshot_path(const std::string &host, uint port) {
+  const char *dir = opt_metadata_snapshot_dir;
+  std::string name;
+  for (char c : host)
+    name += (isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-')
+                ? c
+                : '_';
+  return std::string(dir ? dir : "") + "/" + name + "_" +
+         std::to_string(port) + ".snap";
+}
+
+/* Field separator of the snapshot lines; names containing it are skipped */
+static bool plain_name(const std::string &s) {
+  return s.find_first_of("\t\n") == std::string::npos;
+}
+
+static std::vector<std::string> split_tabs(const std::string &line) {
+  std::vector<std::string> fields;
+  size_t pos = 0;
+  for (;;) {
+    size_t tab = line.find('\t', pos);
+    fields.push_back(line.substr(pos, tab - pos));
+    if (tab == std::string::npos) break;
+    pos = tab + 1;
+  }
+  return fields;
+}
+
+/** ENUM / SET members as comma-separated hex, any bytes allowed in them. */
+static std::string hex_values(const std::vector<std::string> &values) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  for (const auto &v : values) {
+    if (!out.empty()) out += ',';
+    for (unsigned char c : v) {
+      out += digits[c >> 4];
+      out += digits[c & 0x0f];
+    }
+  }
+  return out;
+}
+
+static std::vector<std::string> unhex_values(const std::string &field) {
+  std::vector<std::string> values;
+  size_t pos = 0;
+  while (pos < field.size()) {
+    size_t comma = field.find(',', pos);
+    if (comma == std::string::npos) comma = field.size();
+    std::string v;
+    for (size_t i = pos; i + 1 < comma; i += 2)
+      v += static_cast<char>(strtol(field.substr(i, 2).c_str(), nullptr, 16));
+    values.push_back(std::move(v));
+    pos = comma + 1;
+  }
+  return values;
+}
+
+/** The comma-separated key parts of an "idx" line. */
+static std::vector<std::string> split_parts(const std::string &field) {
+  std::vector<std::string> parts;
+  size_t pos = 0;
+  while (pos < field.size()) {
+    size_t comma = field.find(',', pos);
+    if (comma == std::string::npos) comma = field.size();
+    parts.push_back(field.substr(pos, comma - pos));
+    pos = comma + 1;
+  }
+  return parts;
+}
+
+/**
+ * Apply one "table", "col" or "idx" line to *meta, a "table" line starting
+ * a new one named *name. Returns true if the line is none of them or
+ * belongs to no table.
+ */
+static bool parse_meta_line(const std::vector<std::string> &f,
+                            std::chrono::steady_clock::time_point now,
+                            std::shared_ptr<TableMeta> *meta,
+                            SchemaTable *name) {
+  if (f[0] == "table" && f.size() == 6) {
+    *meta = std::make_shared<TableMeta>();
+    TableMeta &m = **meta;
+    m.exists = f[3] != "-";
+    m.table_rows = strtoll(f[3].c_str(), nullptr, 10);
+    m.table_bytes = strtoll(f[4].c_str(), nullptr, 10);
+    if (f[5] != "-") m.row_format = f[5];
+    if (!m.exists) m.table_rows = -1;
+    m.loaded_at = now;
+    *name = SchemaTable(f[1], f[2]);
+  } else if (f[0] == "col" && f.size() == 10 && *meta) {
+    RemoteColumnInfo col;
+    col.data_type = f[2];
+    col.char_max_length = strtoll(f[3].c_str(), nullptr, 10);
+    col.numeric_precision = strtoll(f[4].c_str(), nullptr, 10);
+    col.numeric_scale = strtoll(f[5].c_str(), nullptr, 10);
+    if (f[6] != "-") col.charset = f[6];
+    col.nullable = f[7] == "1";
+    col.is_unsigned = f[8] == "1";
+    col.values = unhex_values(f[9]);
+    (*meta)->add_column(f[1], col);
+  } else if (f[0] == "idx" && (f.size() == 2 || f.size() == 5) && *meta) {
+    (*meta)->indexes.insert(f[1]);
+    if (f.size() == 5) {
+      IndexInfo &index = (*meta)->index_defs[f[1]];
+      index.unique = f[2] == "1";
+      index.ordered = f[3] == "1";
+      index.parts = split_parts(f[4]);
+    }
+  } else {
+    return true;
+  }
+  return false;
+}
+
+/** Returns true if path is missing, for another target, or malformed. */
+static bool read_snapshot(const std::string &path, const std::string &target,
+                          Snapshot *out) {
+  std::ifstream in(path);
+  std::string line;
+  if (!in || !std::getline(in, line) || line != SNAPSHOT_MAGIC) return true;
+  if (!std::getline(in, line) || line != "target\t" + target) return true;
+  if (!std::getline(in, line)) return true;
+  std::vector<std::string> f = split_tabs(line);
+  if (f.size() != 3 || f[0] != "binlog" || f[1].empty()) return true;
+  out->pos.file = f[1];
+  out->pos.pos = strtoull(f[2].c_str(), nullptr, 10);
+
+  const auto now = std::chrono::steady_clock::now();
+  std::shared_ptr<TableMeta> meta;
+  SchemaTable name;
+  while (std::getline(in, line)) {
+    f = split_tabs(line);
+    if (f[0] == "end") continue;
+    const bool started = f[0] == "table";
+    if (parse_meta_line(f, now, &meta, &name)) return true;
+    if (started) out->tables.emplace_back(name, meta);
+  }
+  return line != "end";
+}
+
+std::string encode_table_meta(const std::string &db, const std::string &table,
+                              const TableMeta &m) {
+  if (!plain_name(db) || !plain_name(table)) return "";
+  const char *row_format =
+      m.row_format.empty() || !plain_name(m.row_format)
+          ? "-"
+          : m.row_format.c_str();
+  std::string out;
+  char buf[256];
+  if (m.exists) {
+    snprintf(buf, sizeof(buf), "\t%lld\t%lld\t",
+             static_cast<long long>(m.table_rows),
+             static_cast<long long>(m.table_bytes));
+    out += "table\t" + db + '\t' + table + buf + row_format + '\n';
+  } else {
+    out += "table\t" + db + '\t' + table + "\t-\t-1\t-\n";
+  }
+  for (const auto &name : m.column_order) {
+    const RemoteColumnInfo *c = m.find_column(name.c_str());
+    if (!c || !plain_name(name) || !plain_name(c->data_type) ||
+        !plain_name(c->charset))
+      continue;
+    snprintf(buf, sizeof(buf), "\t%lld\t%lld\t%lld\t",
+             static_cast<long long>(c->char_max_length),
+             static_cast<long long>(c->numeric_precision),
+             static_cast<long long>(c->numeric_scale));
+    out += "col\t" + name + '\t' + c->data_type + buf +
+           (c->charset.empty() ? "-" : c->charset) + '\t' +
+           (c->nullable ? '1' : '0') + '\t' + (c->is_unsigned ? '1' : '0') +
+           '\t' + hex_values(c->values) + '\n';
+  }
+  for (const auto &i : m.indexes) {
+    if (!plain_name(i)) continue;
+    auto def = m.index_defs.find(i);
+    std::string parts;
+    bool plain = def != m.index_defs.end();
+    if (plain) {
+      for (const auto &part : def->second.parts) {
+        plain = plain && plain_name(part) && part.find(',') == std::string::npos;
+        if (!parts.empty()) parts += ',';
+        parts += part;
+      }
+    }
+    /* Index written by name only loses its definition, not the table */
+    if (plain)
+      out += "idx\t" + i + '\t' + (def->second.unique ? '1' : '0') + '\t' +
+             (def->second.ordered ? '1' : '0') + '\t' + parts + '\n';
+    else
+      out += "idx\t" + i + '\n';
+  }
+  return out;
+}
+
+std::shared_ptr<TableMeta> decode_table_meta(const std::string &text) {
+  const auto now = std::chrono::steady_clock::now();
+  std::shared_ptr<TableMeta> meta;
+  SchemaTable name;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    std::vector<std::string> f = split_tabs(line);
+    /* One table per text */
+    if ((f[0] == "table" && meta) || parse_meta_line(f, now, &meta, &name))
+      return nullptr;
+  }
+  return meta;
+}
+
+/** Rewrite the file: write a temporary, fsync, rename over the old one. */
+static bool write_snapshot(const std::string &path, const std::string &target,
+                           const BinlogPos &pos) {
+  const std::string tmp = path + ".tmp";
+  FILE *fp = fopen(tmp.c_str(), "w");
+  if (!fp) return true;
+  fprintf(fp, "%s\ntarget\t%s\nbinlog\t%s\t%llu\n", SNAPSHOT_MAGIC,
+          target.c_str(), pos.file.c_str(),
+          static_cast<unsigned long long>(pos.pos));
+  for (const auto &t : cache_pinned_tables(target))
+    fputs(encode_table_meta(t.first.first, t.first.second, *t.second).c_str(),
+          fp);
+  fprintf(fp, "end\n");
+  bool failed = fflush(fp) != 0 || fsync(fileno(fp)) != 0;
+  failed = fclose(fp) != 0 || failed;
+  return failed || rename(tmp.c_str(), path.c_str()) != 0;
+}
+
+/* ---- Watchers ---- */
+
+/** One binlog watcher thread per target. */
+class SchemaWatcher {
+ public:
+  explicit SchemaWatcher(const InceptionContext *ctx)
+      : m_host(ctx->host.empty() ? "127.0.0.1" : ctx->host),
+        m_port(ctx->port),
+        m_user(ctx->user.empty() ? "root" : ctx->user),
+        m_password(ctx->password),
+        m_target(cache_target(ctx)),
+        m_path(snapshot_path(m_host, m_port)) {}
+
+  void start() { m_thread = std::thread([this] { run(); }); }
+
+  void stop() {
+    m_stop.store(true);
+    if (m_thread.joinable()) m_thread.join();
+  }
+
+  bool finished() const { return m_finished.load(); }
+  std::chrono::steady_clock::time_point started_at() const {
+    return m_started_at;
+  }
+
+ private:
+  void run();
+  bool open_stream(BinlogStream *stream, const BinlogPos &start,
+                   std::string *errmsg);
+  void save(const BinlogPos &pos);
+  void log(const char *what, const std::string &detail) {
+    fprintf(stderr, "[Inception] Schema watcher %s: %s%s%s\n",
+            m_target.c_str(), what, detail.empty() ? "" : " ",
+            detail.c_str());
+    fflush(stderr);
+  }
+
+  const std::string m_host;
+  const uint m_port;
+  const std::string m_user;
+  const std::string m_password;
+  const std::string m_target;
+  const std::string m_path;
+  const std::chrono::steady_clock::time_point m_started_at =
+      std::chrono::steady_clock::now();
+  std::thread m_thread;
+  std::atomic<bool> m_stop{false};
+  std::atomic<bool> m_finished{false};
+};
+
+/**
+ * Connect and read the first event from start, so a purged position shows
+ * up here rather than in the loop. Returns true on error.
+ */
+bool SchemaWatcher::open_stream(BinlogStream *stream, const BinlogPos &start,
+                                std::string *errmsg) {
+  if (stream->open(m_host, m_port, m_user, m_password, start, false, errmsg))
+    return true;
+  std::vector<RowChange> rows;
+  if (stream->next(&rows, errmsg) == BinlogRead::ERROR) {
+    stream->close();
+    return true;
+  }
+  return false;
+}
+
+void SchemaWatcher::save(const BinlogPos &pos) {
+  if (write_snapshot(m_path, m_target, pos))
+    log("cannot write snapshot", m_path + ": " + strerror(errno));
+}
+
+void SchemaWatcher::run() {
+  if (my_thread_init()) {
+    m_finished.store(true);
+    return;
+  }
+  bind_worker_resource_group();
+  std::string errmsg;
+  BinlogStream stream;
+
+  Snapshot snap;
+  bool have_snapshot = !read_snapshot(m_path, m_target, &snap);
+  bool opened = have_snapshot && !open_stream(&stream, snap.pos, &errmsg);
+  if (have_snapshot && !opened) {
+    log("snapshot position unavailable, starting over:", errmsg);
+    snap = Snapshot();
+    unlink(m_path.c_str());
+  }
+  if (!opened) {
+    /* No snapshot: entries loaded from now on are at least this new */
+    BinlogPos now;
+    PoolConnOptions opts;
+    opts.connect_timeout = 5;
+    MYSQL *mysql =
+        pool_acquire(m_host, m_port, m_user, m_password, opts, &errmsg);
+    bool failed = !mysql || get_binlog_position(mysql, &now, &errmsg);
+    if (mysql) pool_release(mysql, PoolRelease::CLEAN);
+    if (failed || open_stream(&stream, now, &errmsg)) {
+      log("not started:", errmsg);
+      m_finished.store(true);
+      my_thread_end();
+      return;
+    }
+  }
+
+  cache_set_watched(m_target, true);
+  for (auto &t : snap.tables)
+    cache_put_pinned(m_target, t.first.first, t.first.second,
+                     std::move(t.second));
+  log(have_snapshot && opened ? "resumed from snapshot at" : "streaming from",
+      stream.position().file + ":" + std::to_string(stream.position().pos));
+
+  auto saved_at = std::chrono::steady_clock::now();
+  std::vector<RowChange> rows;
+  while (!m_stop.load()) {
+    rows.clear();
+    BinlogRead r = stream.next(&rows, &errmsg);
+    if (r != BinlogRead::EVENT) {
+      log("binlog stream lost:", errmsg);
+      break;
+    }
+    if (stream.last_event_type() == binary_log::QUERY_EVENT) {
+      for (const auto &t :
+           binlog_ddl_tables(stream.last_query_db(), stream.last_query()))
+        cache_invalidate_ddl(m_target, t.first, t.second);
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - saved_at >= SNAPSHOT_INTERVAL) {
+      save(stream.position());
+      saved_at = now;
+    }
+  }
+
+  /* Every DDL up to the position is applied: the entries are valid there */
+  save(stream.position());
+  cache_set_watched(m_target, false);
+  stream.close();
+  m_finished.store(true);
+  my_thread_end();
+}
+
+static InceptionMutex g_watch_mutex("schema_watchers");
+static std::map<std::string, std::unique_ptr<SchemaWatcher>> g_watchers;
+static bool g_watch_stopped = false;
+
+void start_schema_watch(const InceptionContext *ctx) {
+  const char *dir = opt_metadata_snapshot_dir;
+  if (!dir || !*dir || opt_metadata_cache_ttl == 0) return;
+  if (ctx->mode != OpMode::CHECK && ctx->mode != OpMode::EXECUTE) return;
+  if (ctx->shadow || ctx->remote_conn_failed || !ctx->targets.empty())
+    return;
+
+  const std::string target = cache_target(ctx);
+  std::unique_ptr<SchemaWatcher> old;
+  {
+    std::lock_guard<InceptionMutex> lock(g_watch_mutex);
+    if (g_watch_stopped) return;
+    auto it = g_watchers.find(target);
+    if (it != g_watchers.end()) {
+      if (!it->second->finished() ||
+          std::chrono::steady_clock::now() - it->second->started_at() <
+              RETRY_INTERVAL)
+        return;
+      old = std::move(it->second);
+    }
+    std::unique_ptr<SchemaWatcher> w(new SchemaWatcher(ctx));
+    try {
+      w->start();
+    } catch (const std::system_error &) {
+      return;  /* no thread: the cache keeps its TTL */
+    }
+    g_watchers[target] = std::move(w);
+  }
+  if (old) old->stop();  /* finished: joins at once */
+}
+
+void schema_watch_shutdown() {
+  std::map<std::string, std::unique_ptr<SchemaWatcher>> watchers;
+  {
+    std::lock_guard<InceptionMutex> lock(g_watch_mutex);
+    g_watch_stopped = true;
+    watchers.swap(g_watchers);
+  }
+  for (auto &w : watchers) w.second->stop();
+}
+
+}  // namespace inception
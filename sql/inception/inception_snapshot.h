@@ -0,0 +1,72 @@
+/**
+ * @file inception_snapshot.h
+ * @brief Persistent schema snapshots kept fresh from the target's binlog.
+ *
+ * The metadata cache forgets every table after inception_metadata_cache_ttl
+ * seconds and reloads it from information_schema, although the schema of a
+ * production target rarely changes, and a restart of inception starts the
+ * cache from nothing. With inception_metadata_snapshot_dir set, the first
+ * CHECK or EXECUTE session on a target starts a watcher thread that tails
+ * the target's binlog (COM_BINLOG_DUMP with the session's credentials,
+ * which need REPLICATION SLAVE) and drops the cache entries of every table
+ * a DDL Query event touches, whoever ran it. While it streams, entries
+ * loaded into the cache are pinned and no longer expire.
+ *
+ * Every SNAPSHOT_INTERVAL and when the watcher stops, the pinned entries
+ * and the binlog position they are valid at are written to
+ * <dir>/<host>_<port>.snap. The next watcher of that target, after a
+ * restart too, loads the file into the cache and resumes the binlog from
+ * that position, so DDL run in between is applied before anything is
+ * answered from it. A snapshot whose position the target has purged is
+ * discarded.
+ *
+ * A watcher that loses the stream unpins its entries, which fall back to
+ * the TTL, and exits after writing its snapshot; the next session on the
+ * target starts a new one, at most once per RETRY_INTERVAL. Row
+ * estimates (TABLE_ROWS) of pinned entries are those of their load.
+ */
+
+#ifndef SQL_INCEPTION_SNAPSHOT_H
+#define SQL_INCEPTION_SNAPSHOT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sql/inception/inception_cache.h"  // SchemaTable
+
+namespace inception {
+
+struct InceptionContext;
+
+/**
+ * Start the binlog watcher of the session's target unless one runs or
+ * snapshots are off. Owning thread of ctx only.
+ */
+void start_schema_watch(const InceptionContext *ctx);
+
+/** Stop every watcher, writing its snapshot. Called at server shutdown. */
+void schema_watch_shutdown();
+
+/**
+ * Tables whose definition the binlog Query event query, run with default
+ * database db, may change. An entry with an empty table stands for the
+ * whole database. Empty for anything but DDL.
+ */
+std::vector<SchemaTable> binlog_ddl_tables(const std::string &db,
+                                           const std::string &query);
+
+/**
+ * The "table", "col" and "idx" lines of db.table as a snapshot file holds
+ * them, also the form the shared cache tier stores (inception_shared.h).
+ * Empty if db or table holds a tab or newline.
+ */
+std::string encode_table_meta(const std::string &db, const std::string &table,
+                              const TableMeta &meta);
+
+/** The table encode_table_meta() wrote text of; nullptr if malformed. */
+std::shared_ptr<TableMeta> decode_table_meta(const std::string &text);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SNAPSHOT_H
@@ -0,0 +1,304 @@
+/**
+ * @file inception_spool.cc
+ * @brief RowSpool: records of varint-length-prefixed fields, spilled to a
+ *        temporary file past a memory limit; TextSpill: texts by offset;
+ *        SplitFiles: SPLIT groups written to inception_split_dir.
+ */
+
+#include "sql/inception/inception_spool.h"
+
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_sys.h"                     // my_write, my_read, my_pread
+#include "sql/mysqld.h"                 // mysql_tmpdir
+#include "sql/sql_thd_internal_api.h"  // mysql_tmpfile_path
+
+#include <fcntl.h>
+#include <unistd.h>  // access
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+
+namespace inception {
+
+static const size_t READ_CHUNK = 64 * 1024;
+
+static void put_length(std::string *buf, uint64_t len) {
+  while (len >= 0x80) {
+    buf->push_back(static_cast<char>((len & 0x7f) | 0x80));
+    len >>= 7;
+  }
+  buf->push_back(static_cast<char>(len));
+}
+
+RowSpool::~RowSpool() { clear(); }
+
+void RowSpool::append(const std::vector<std::string> &fields, size_t limit) {
+  put_length(&m_buf, fields.size());
+  for (const auto &field : fields) {
+    put_length(&m_buf, field.size());
+    m_buf.append(field);
+  }
+  m_records++;
+  if (limit > 0 && m_buf.size() >= limit && !m_spill_failed) spill();
+}
+
+/* Move the records in memory to the end of the file. @return true on error,
+   the records then stay in memory. */
+bool RowSpool::spill() {
+  if (m_fd < 0) {
+    m_fd = mysql_tmpfile_path(mysql_tmpdir, "inception");
+    if (m_fd < 0) {
+      fprintf(stderr,
+              "[Inception] cannot create a result spool file in %s, "
+              "keeping the results in memory\n",
+              mysql_tmpdir);
+      fflush(stderr);
+      m_spill_failed = true;
+      return true;
+    }
+  }
+  if (my_write(m_fd, reinterpret_cast<const uchar *>(m_buf.data()),
+               m_buf.size(), MYF(MY_NABP | MY_WME))) {
+    fprintf(stderr,
+            "[Inception] cannot write the result spool file, keeping the "
+            "results in memory\n");
+    fflush(stderr);
+    m_spill_failed = true;
+    /* Nothing good in the file yet: go on in memory alone */
+    if (m_file_bytes == 0) {
+      my_close(m_fd, MYF(0));
+      m_fd = -1;
+    }
+    return true;
+  }
+  m_file_bytes += m_buf.size();
+  m_buf.clear();
+  return false;
+}
+
+bool RowSpool::rewind() {
+  m_rbuf.clear();
+  m_rpos = 0;
+  m_error = false;
+  if (m_fd < 0) {
+    m_rbuf.swap(m_buf);
+    return false;
+  }
+  /* A partly written spill leaves the file unreadable */
+  if (m_spill_failed && m_file_bytes > 0) m_error = true;
+  if (!m_error && !m_buf.empty()) {
+    m_spill_failed = false;
+    m_error = spill();
+  }
+  if (!m_error && my_seek(m_fd, 0, MY_SEEK_SET, MYF(0)) == MY_FILEPOS_ERROR)
+    m_error = true;
+  m_read_left = m_file_bytes;
+  return m_error;
+}
+
+/* Make n unread bytes available in m_rbuf. @return false if there are
+   fewer left (m_error set on an I/O error). */
+bool RowSpool::fill(size_t n) {
+  while (m_rbuf.size() - m_rpos < n) {
+    if (m_error || m_fd < 0 || m_read_left == 0) return false;
+    m_rbuf.erase(0, m_rpos);
+    m_rpos = 0;
+    const size_t chunk = static_cast<size_t>(
+        std::min<uint64_t>(m_read_left, std::max(n, READ_CHUNK)));
+    const size_t old = m_rbuf.size();
+    m_rbuf.resize(old + chunk);
+    if (my_read(m_fd, reinterpret_cast<uchar *>(&m_rbuf[old]), chunk,
+                MYF(MY_NABP | MY_WME))) {
+      m_error = true;
+      return false;
+    }
+    m_read_left -= chunk;
+  }
+  return true;
+}
+
+bool RowSpool::read_length(uint64_t *len) {
+  *len = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (!fill(1)) return false;
+    const unsigned char byte = static_cast<unsigned char>(m_rbuf[m_rpos++]);
+    *len |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+bool RowSpool::next(std::vector<std::string> *fields) {
+  if (!fill(1)) return false; /* the end, or m_error */
+  uint64_t count;
+  if (!read_length(&count)) {
+    m_error = true;
+    return false;
+  }
+  fields->resize(count);
+  for (auto &field : *fields) {
+    uint64_t len;
+    if (!read_length(&len) || !fill(len)) {
+      m_error = true;
+      return false;
+    }
+    field.assign(m_rbuf, m_rpos, len);
+    m_rpos += len;
+  }
+  return true;
+}
+
+void RowSpool::clear() {
+  if (m_fd >= 0) my_close(m_fd, MYF(0));
+  m_fd = -1;
+  m_buf.clear();
+  m_buf.shrink_to_fit();
+  m_rbuf.clear();
+  m_rbuf.shrink_to_fit();
+  m_rpos = 0;
+  m_file_bytes = 0;
+  m_read_left = 0;
+  m_records = 0;
+  m_spill_failed = false;
+  m_error = false;
+}
+
+TextSpill::~TextSpill() { clear(); }
+
+bool TextSpill::put(const std::string &a, const std::string &b,
+                    uint64_t *offset) {
+  if (m_failed) return true;
+  if (m_fd < 0) {
+    m_fd = mysql_tmpfile_path(mysql_tmpdir, "inception");
+    if (m_fd < 0) {
+      fprintf(stderr,
+              "[Inception] cannot create a statement spill file in %s, "
+              "keeping the statements in memory\n",
+              mysql_tmpdir);
+      fflush(stderr);
+      m_failed = true;
+      return true;
+    }
+  }
+  if (my_pwrite(m_fd, reinterpret_cast<const uchar *>(a.data()), a.size(),
+                m_end, MYF(MY_NABP | MY_WME)) ||
+      my_pwrite(m_fd, reinterpret_cast<const uchar *>(b.data()), b.size(),
+                m_end + a.size(), MYF(MY_NABP | MY_WME))) {
+    fprintf(stderr,
+            "[Inception] cannot write the statement spill file, keeping the "
+            "statements in memory\n");
+    fflush(stderr);
+    m_failed = true;
+    return true;
+  }
+  *offset = m_end;
+  m_end += a.size() + b.size();
+  return false;
+}
+
+bool TextSpill::get(uint64_t offset, size_t a_len, size_t b_len,
+                    std::string *a, std::string *b) const {
+  if (m_fd < 0 || offset + a_len + b_len > m_end) return true;
+  a->resize(a_len);
+  b->resize(b_len);
+  return (a_len > 0 && my_pread(m_fd, reinterpret_cast<uchar *>(&(*a)[0]),
+                                a_len, offset, MYF(MY_NABP | MY_WME))) ||
+         (b_len > 0 && my_pread(m_fd, reinterpret_cast<uchar *>(&(*b)[0]),
+                                b_len, offset + a_len, MYF(MY_NABP | MY_WME)));
+}
+
+void TextSpill::clear() {
+  if (m_fd >= 0) my_close(m_fd, MYF(0));
+  m_fd = -1;
+  m_end = 0;
+  m_failed = false;
+}
+
+/* ---- SplitFiles ---- */
+
+static const size_t SPLIT_WRITE_CHUNK = 256 * 1024;
+static std::atomic<uint32_t> g_split_seq{0};
+
+SplitFiles::~SplitFiles() { clear(); }
+
+bool SplitFiles::start(std::string *err) {
+  const char *dir = opt_split_dir;
+  if (!dir || !*dir) {
+    *err = "--enable-split-files needs inception_split_dir.";
+    return true;
+  }
+  if (access(dir, W_OK) != 0) {
+    *err = std::string("inception_split_dir '") + dir + "' is not writable.";
+    return true;
+  }
+  m_dir = dir;
+  time_t now = time(nullptr);
+  struct tm tm_buf;
+  localtime_r(&now, &tm_buf);
+  char stamp[32];
+  strftime(stamp, sizeof(stamp), "%Y%m%d%H%M%S", &tm_buf);
+  /* A restart resets the sequence: skip batches already on disk */
+  char batch[64];
+  do {
+    snprintf(batch, sizeof(batch), "split_%s_%u", stamp, ++g_split_seq);
+  } while (access((m_dir + "/" + batch + "_1.sql").c_str(), F_OK) == 0);
+  m_batch = batch;
+  return false;
+}
+
+bool SplitFiles::open_group(int id, std::string *path, std::string *err) {
+  if (close_group(err)) return true;
+  m_path = m_dir + "/" + m_batch + "_" + std::to_string(id) + ".sql";
+  m_fd = my_open(m_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, MYF(0));
+  if (m_fd < 0) {
+    *err = "Cannot create split file '" + m_path + "'.";
+    return true;
+  }
+  *path = m_path;
+  return false;
+}
+
+bool SplitFiles::append(const std::string &text, std::string *err) {
+  if (m_fd < 0) {
+    *err = "No split file is open.";
+    return true;
+  }
+  m_buf.append(text);
+  return m_buf.size() >= SPLIT_WRITE_CHUNK && flush(err);
+}
+
+bool SplitFiles::flush(std::string *err) {
+  if (m_buf.empty()) return false;
+  if (my_write(m_fd, reinterpret_cast<const uchar *>(m_buf.data()),
+               m_buf.size(), MYF(MY_NABP))) {
+    *err = "Cannot write split file '" + m_path + "'.";
+    return true;
+  }
+  m_buf.clear();
+  return false;
+}
+
+bool SplitFiles::close_group(std::string *err) {
+  if (m_fd < 0) return false;
+  const bool failed = flush(err);
+  m_buf.clear();
+  if (my_close(m_fd, MYF(0)) && !failed) {
+    *err = "Cannot close split file '" + m_path + "'.";
+    m_fd = -1;
+    return true;
+  }
+  m_fd = -1;
+  return failed;
+}
+
+void SplitFiles::clear() {
+  std::string ignored;
+  close_group(&ignored);
+  m_batch.clear();
+  m_dir.clear();
+}
+
+}  // namespace inception
@@ -0,0 +1,166 @@
+/**
+ * @file inception_spool.h
+ * @brief Compact store of the finished result rows of a large batch.
+ *
+ * A CHECK, SPLIT or QUERY_TREE session knows the result row of a statement
+ * as soon as the statement is audited, yet used to keep every node until
+ * commit. With inception_result_spool_size > 0 the finished rows go to the
+ * session's RowSpool instead: length-prefixed fields in memory up to
+ * inception_result_spool_size bytes, appended to a temporary file under
+ * --tmpdir beyond that, and read back in order by the result senders. The
+ * memory of a session is then bounded whatever the size of the script.
+ *
+ * EXECUTE keeps its nodes: they are executed, and backed up, at commit.
+ * Past inception_max_session_memory their texts go to a TextSpill instead,
+ * which reads any of them back by offset.
+ */
+
+#ifndef SQL_INCEPTION_SPOOL_H
+#define SQL_INCEPTION_SPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "my_io.h"  // File
+
+namespace inception {
+
+class RowSpool {
+ public:
+  RowSpool() = default;
+  ~RowSpool();
+  RowSpool(const RowSpool &) = delete;
+  RowSpool &operator=(const RowSpool &) = delete;
+
+  /** Append a record of fields; spill past limit bytes held in memory. */
+  void append(const std::vector<std::string> &fields, size_t limit);
+
+  /** Number of records appended. */
+  size_t records() const { return m_records; }
+
+  /** Bytes appended, in memory and in the file. */
+  uint64_t bytes() const { return m_file_bytes + m_buf.size(); }
+
+  /**
+   * Start reading the records back from the first, once all are appended.
+   * The records can be read once.
+   * @return true on I/O error.
+   */
+  bool rewind();
+
+  /**
+   * Read the next record into fields.
+   * @return false at the end or on an error (then error() is set).
+   */
+  bool next(std::vector<std::string> *fields);
+
+  bool error() const { return m_error; }
+
+  /** Drop every record and the file. */
+  void clear();
+
+ private:
+  bool spill();
+  bool fill(size_t n);
+  bool read_length(uint64_t *len);
+
+  std::string m_buf;         /* records not in the file */
+  File m_fd = -1;            /* temporary file, deleted on close */
+  uint64_t m_file_bytes = 0;
+  size_t m_records = 0;
+  bool m_spill_failed = false;
+
+  std::string m_rbuf;        /* read side */
+  size_t m_rpos = 0;
+  uint64_t m_read_left = 0;  /* file bytes not read yet */
+  bool m_error = false;
+};
+
+/**
+ * Append-only temporary file of texts read back by offset, for the
+ * sql_text and errmsg of statement nodes over the session memory budget.
+ * Reads do not move a file position, so threads may read at once.
+ */
+class TextSpill {
+ public:
+  TextSpill() = default;
+  ~TextSpill();
+  TextSpill(const TextSpill &) = delete;
+  TextSpill &operator=(const TextSpill &) = delete;
+
+  /**
+   * Append a and then b, the offset of a in *offset.
+   * @return true on error (logged once); nothing is then appended.
+   */
+  bool put(const std::string &a, const std::string &b, uint64_t *offset);
+
+  /**
+   * Read back a_len bytes at offset into *a and the b_len after them
+   * into *b. @return true on I/O error.
+   */
+  bool get(uint64_t offset, size_t a_len, size_t b_len, std::string *a,
+           std::string *b) const;
+
+  /** Bytes in the file. */
+  uint64_t bytes() const { return m_end; }
+
+  /** Drop the file. */
+  void clear();
+
+ private:
+  File m_fd = -1;  /* temporary file, deleted on close */
+  uint64_t m_end = 0;
+  bool m_failed = false;
+};
+
+/**
+ * --enable-split-files: the groups of a SPLIT session written to
+ * inception_split_dir as they form, <batch>_<id>.sql each, instead of
+ * being held as strings until commit. One group file is open at a time;
+ * the files are left for the client to collect.
+ */
+class SplitFiles {
+ public:
+  SplitFiles() = default;
+  ~SplitFiles();
+  SplitFiles(const SplitFiles &) = delete;
+  SplitFiles &operator=(const SplitFiles &) = delete;
+
+  /**
+   * Pick the batch name in inception_split_dir.
+   * @return true with *err if the directory is not set or not writable.
+   */
+  bool start(std::string *err);
+
+  bool started() const { return !m_batch.empty(); }
+
+  /**
+   * Close the current group and create the file of group id, its path in
+   * *path. @return true with *err on an I/O error.
+   */
+  bool open_group(int id, std::string *path, std::string *err);
+
+  /** Append text to the current group. @return true with *err on error. */
+  bool append(const std::string &text, std::string *err);
+
+  /** Write out and close the current group. @return true with *err. */
+  bool close_group(std::string *err);
+
+  /** Close the current group, if any, and forget the batch. */
+  void clear();
+
+ private:
+  bool flush(std::string *err);
+
+  std::string m_dir;
+  std::string m_batch;  /* file name prefix, empty = not started */
+  std::string m_path;   /* of the open group */
+  File m_fd = -1;
+  std::string m_buf;    /* appended, not written yet */
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_SPOOL_H
@@ -0,0 +1,187 @@
+/**
+ * @file inception_status.cc
+ * @brief Inception_* status variables, stages and instrumented mutexes.
+ */
+
+#include "sql/inception/inception_status.h"
+
+#include "sql/current_thd.h"
+#include "sql/sql_class.h"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace inception {
+
+std::atomic<uint64_t> g_status[STATUS_COUNT];
+
+template <StatusCounter C>
+static int show_counter(THD *, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  *reinterpret_cast<longlong *>(buff) =
+      static_cast<longlong>(g_status[C].load(std::memory_order_relaxed));
+  return 0;
+}
+
+#define INCEPTION_STATUS(name, counter)                           \
+  {                                                               \
+    name, (char *)&show_counter<counter>, SHOW_FUNC, SHOW_SCOPE_GLOBAL \
+  }
+
+SHOW_VAR status_vars[] = {
+    INCEPTION_STATUS("audit_cache_hits", STATUS_AUDIT_CACHE_HITS),
+    INCEPTION_STATUS("audit_cache_misses", STATUS_AUDIT_CACHE_MISSES),
+    INCEPTION_STATUS("audit_sink_dropped", STATUS_AUDIT_SINK_DROPPED),
+    INCEPTION_STATUS("audit_sink_retries", STATUS_AUDIT_SINK_RETRIES),
+    INCEPTION_STATUS("audit_sink_shipped", STATUS_AUDIT_SINK_SHIPPED),
+    INCEPTION_STATUS("audit_sink_spooled", STATUS_AUDIT_SINK_SPOOLED),
+    INCEPTION_STATUS("bytes_sent", STATUS_BYTES_SENT),
+    INCEPTION_STATUS("cache_hits", STATUS_CACHE_HITS),
+    INCEPTION_STATUS("cache_misses", STATUS_CACHE_MISSES),
+    INCEPTION_STATUS("query_tree_cache_hits", STATUS_QUERY_TREE_CACHE_HITS),
+    INCEPTION_STATUS("query_tree_cache_misses",
+                     STATUS_QUERY_TREE_CACHE_MISSES),
+    INCEPTION_STATUS("remote_bytes_received", STATUS_REMOTE_BYTES_RECEIVED),
+    INCEPTION_STATUS("remote_queries", STATUS_REMOTE_QUERIES),
+    INCEPTION_STATUS("remote_wire_bytes_received",
+                     STATUS_REMOTE_WIRE_BYTES_RECEIVED),
+    INCEPTION_STATUS("sessions", STATUS_SESSIONS),
+    INCEPTION_STATUS("shared_cache_hits", STATUS_SHARED_CACHE_HITS),
+    INCEPTION_STATUS("shared_cache_misses", STATUS_SHARED_CACHE_MISSES),
+    INCEPTION_STATUS("statements_audited", STATUS_STATEMENTS_AUDITED),
+    INCEPTION_STATUS("statements_executed", STATUS_STATEMENTS_EXECUTED),
+    INCEPTION_STATUS("statements_spilled", STATUS_STATEMENTS_SPILLED),
+    INCEPTION_STATUS("statements_streamed", STATUS_STATEMENTS_STREAMED),
+    INCEPTION_STATUS("throttle_wait_ms", STATUS_THROTTLE_WAIT_MS),
+    {NullS, NullS, SHOW_LONG, SHOW_SCOPE_ALL}};
+
+#undef INCEPTION_STATUS
+
+PSI_stage_info stage_inception_audit = {0, "inception audit", 0,
+                                        PSI_DOCUMENT_ME};
+PSI_stage_info stage_inception_remote_check = {0, "inception remote check", 0,
+                                               PSI_DOCUMENT_ME};
+PSI_stage_info stage_inception_execute = {0, "inception execute", 0,
+                                          PSI_DOCUMENT_ME};
+PSI_stage_info stage_inception_throttle_wait = {0, "inception throttle wait",
+                                                0, PSI_DOCUMENT_ME};
+
+const char *remote_query_class_name(int cls) {
+  static const char *const names[REMOTE_CLASS_COUNT] = {
+      "metadata", "explain", "execute", "throttle_poll"};
+  return cls >= 0 && cls < REMOTE_CLASS_COUNT ? names[cls] : "unknown";
+}
+
+const uint64_t LATENCY_BUCKET_US[LATENCY_BUCKETS] = {
+    100,     250,     500,     1000,    2500,     5000,
+    10000,   25000,   50000,   100000,  250000,   500000,
+    1000000, 2500000, 10000000, UINT64_MAX};
+
+/* InceptionMutex objects constructed so far, in construction order. A
+   function-local static, as they are themselves constructed statically. */
+static std::vector<InceptionMutex *> &mutex_registry() {
+  static std::vector<InceptionMutex *> registry;
+  return registry;
+}
+
+static InceptionMutex g_latency_mutex("remote_latency");
+static std::map<std::pair<std::string, int>, RemoteLatency> g_latency;
+
+uint64_t record_remote_latency(const MYSQL *mysql, RemoteQueryClass cls,
+                               std::chrono::steady_clock::time_point start) {
+  const uint64_t us = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  if (!mysql || !mysql->host) return us;
+  const int bucket = static_cast<int>(
+      std::lower_bound(LATENCY_BUCKET_US, LATENCY_BUCKET_US + LATENCY_BUCKETS,
+                       us) -
+      LATENCY_BUCKET_US);
+  std::string target = mysql->host;
+  target += ':';
+  target += std::to_string(mysql->port);
+
+  std::lock_guard<InceptionMutex> lock(g_latency_mutex);
+  RemoteLatency &h = g_latency[std::make_pair(target, static_cast<int>(cls))];
+  if (h.target.empty()) {
+    h.target = std::move(target);
+    h.cls = cls;
+  }
+  h.counts[bucket]++;
+  h.sum_us += us;
+  return us;
+}
+
+std::vector<RemoteLatency> get_remote_latency() {
+  std::lock_guard<InceptionMutex> lock(g_latency_mutex);
+  std::vector<RemoteLatency> result;
+  result.reserve(g_latency.size());
+  for (const auto &pair : g_latency) result.push_back(pair.second);
+  return result;
+}
+
+size_t count_remote_latency() {
+  std::lock_guard<InceptionMutex> lock(g_latency_mutex);
+  return g_latency.size();
+}
+
+void reset_remote_latency() {
+  std::lock_guard<InceptionMutex> lock(g_latency_mutex);
+  g_latency.clear();
+}
+
+void init_psi_keys() {
+#ifdef HAVE_PSI_INTERFACE
+  const char *category = "inception";
+
+  PSI_stage_info *stages[] = {
+      &stage_inception_audit, &stage_inception_remote_check,
+      &stage_inception_execute, &stage_inception_throttle_wait};
+  mysql_stage_register(category, stages,
+                       static_cast<int>(array_elements(stages)));
+
+  std::vector<PSI_mutex_info> mutexes;
+  for (InceptionMutex *m : mutex_registry())
+    mutexes.push_back({&m->m_key, m->m_name, PSI_FLAG_SINGLETON, 0,
+                       PSI_DOCUMENT_ME});
+  if (mutexes.empty()) return;
+  mysql_mutex_register(category, mutexes.data(),
+                       static_cast<int>(mutexes.size()));
+#ifdef HAVE_PSI_MUTEX_INTERFACE
+  for (InceptionMutex *m : mutex_registry())
+    m->m_mutex.m_psi =
+        PSI_MUTEX_CALL(init_mutex)(m->m_key, &m->m_mutex.m_mutex);
+#endif
+#endif /* HAVE_PSI_INTERFACE */
+}
+
+StageScope::StageScope(const PSI_stage_info &stage) {
+  THD *thd = current_thd;
+  if (!thd) return;
+  thd->enter_stage(&stage, &m_old, __func__, __FILE__, __LINE__);
+  m_entered = true;
+}
+
+StageScope::~StageScope() {
+  if (!m_entered) return;
+  current_thd->enter_stage(&m_old, nullptr, __func__, __FILE__, __LINE__);
+}
+
+InceptionMutex::InceptionMutex(const char *name) : m_name(name) {
+  mysql_mutex_init(PSI_NOT_INSTRUMENTED, &m_mutex, MY_MUTEX_INIT_FAST);
+  mutex_registry().push_back(this);
+}
+
+InceptionMutex::~InceptionMutex() {
+  /* Runs at exit, after the Performance Schema is gone: drop the
+     instrument without telling it. */
+  m_mutex.m_psi = nullptr;
+  mysql_mutex_destroy(&m_mutex);
+}
+
+}  // namespace inception
@@ -0,0 +1,197 @@
+/**
+ * @file inception_status.h
+ * @brief Inception_* global status variables and Performance Schema
+ *        instrumentation.
+ *
+ * SHOW GLOBAL STATUS LIKE 'Inception_%' reports server-wide counters since
+ * startup (never reset by FLUSH STATUS):
+ *
+ *   Inception_sessions             sessions started (magic_start parsed)
+ *   Inception_statements_audited   statements through audit_statement()
+ *   Inception_statements_executed  statements completed on a target
+ *   Inception_remote_queries       round trips to targets, audit and execute
+ *   Inception_bytes_sent           statement text sent to targets to execute
+ *   Inception_remote_bytes_received    protocol bytes received from targets,
+ *                                      after decompression
+ *   Inception_remote_wire_bytes_received  the same bytes as they crossed
+ *                                      the network (inception_remote_compression)
+ *   Inception_cache_hits           metadata cache lookups answered locally
+ *   Inception_cache_misses         metadata cache lookups sent to the target
+ *   Inception_shared_cache_hits    local misses answered by the shared tier
+ *                                  (inception_shared_cache_host)
+ *   Inception_shared_cache_misses  local misses it did not hold either
+ *   Inception_audit_cache_hits     statements whose audit result was reused
+ *                                  from an earlier session (inception_audit_cache_size)
+ *   Inception_audit_cache_misses   statements looked up there and audited in full
+ *   Inception_query_tree_cache_hits    QUERY_TREE results reused by digest
+ *   Inception_query_tree_cache_misses  QUERY_TREE results walked from the AST
+ *   Inception_throttle_wait_ms     time held by the execution load throttle
+ *   Inception_statements_spilled   statement texts moved to a spill file
+ *                                  (inception_max_session_memory)
+ *   Inception_statements_streamed  INSERTs audited from their first rows
+ *                                  (inception_insert_stream_min_size)
+ *   Inception_audit_sink_shipped   audit log records the sink accepted
+ *   Inception_audit_sink_retries   deliveries to the sink that failed
+ *   Inception_audit_sink_spooled   records that waited in the spool file
+ *   Inception_audit_sink_dropped   records lost: queue full and no spool
+ *
+ * The stages "inception audit", "inception remote check", "inception
+ * execute" and "inception throttle wait" show in events_stages_* and in
+ * PROCESSLIST State of the client thread; background jobs and parallel
+ * lanes have no THD and report no stage. The process-wide registries (the
+ * metadata cache, sessions, the connection pool, load samplers, schema
+ * watchers, rule statistics and remote latency) lock an InceptionMutex, instrumented as
+ * wait/synch/mutex/inception/<name>.
+ *
+ * Every round trip to a target is also timed into a latency histogram per
+ * target ("host:port") and query class, published with the sessions as
+ * performance_schema tables by the inception_pfs plugin (inception_pfs.cc).
+ */
+
+#ifndef SQL_INCEPTION_STATUS_H
+#define SQL_INCEPTION_STATUS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "include/mysql.h"  // MYSQL
+
+#include "mysql/psi/mysql_mutex.h"
+#include "mysql/psi/mysql_stage.h"
+#include "mysql/status_var.h"
+
+namespace inception {
+
+enum StatusCounter {
+  STATUS_SESSIONS,
+  STATUS_STATEMENTS_AUDITED,
+  STATUS_STATEMENTS_EXECUTED,
+  STATUS_REMOTE_QUERIES,
+  STATUS_BYTES_SENT,
+  STATUS_CACHE_HITS,
+  STATUS_CACHE_MISSES,
+  STATUS_THROTTLE_WAIT_MS,
+  STATUS_STATEMENTS_SPILLED,
+  STATUS_QUERY_TREE_CACHE_HITS,
+  STATUS_QUERY_TREE_CACHE_MISSES,
+  STATUS_REMOTE_BYTES_RECEIVED,
+  STATUS_REMOTE_WIRE_BYTES_RECEIVED,
+  STATUS_AUDIT_SINK_SHIPPED,
+  STATUS_AUDIT_SINK_RETRIES,
+  STATUS_AUDIT_SINK_SPOOLED,
+  STATUS_AUDIT_SINK_DROPPED,
+  STATUS_AUDIT_CACHE_HITS,
+  STATUS_AUDIT_CACHE_MISSES,
+  STATUS_STATEMENTS_STREAMED,
+  STATUS_SHARED_CACHE_HITS,
+  STATUS_SHARED_CACHE_MISSES,
+  STATUS_COUNT
+};
+
+extern std::atomic<uint64_t> g_status[STATUS_COUNT];
+
+inline void status_add(StatusCounter counter, uint64_t n = 1) {
+  g_status[counter].fetch_add(n, std::memory_order_relaxed);
+}
+
+/** The Inception_* entries, an SHOW_ARRAY member of mysqld's status_vars. */
+extern SHOW_VAR status_vars[];
+
+extern PSI_stage_info stage_inception_audit;
+extern PSI_stage_info stage_inception_remote_check;
+extern PSI_stage_info stage_inception_execute;
+extern PSI_stage_info stage_inception_throttle_wait;
+
+/** What a timed round trip to a target was for. */
+enum RemoteQueryClass {
+  REMOTE_METADATA,       /* information_schema / SHOW DATABASES lookups */
+  REMOTE_EXPLAIN,        /* EXPLAIN row estimates */
+  REMOTE_EXECUTE,        /* statements, chunks and batches executed */
+  REMOTE_THROTTLE_POLL,  /* one load sample of the throttle */
+  REMOTE_CLASS_COUNT
+};
+
+const char *remote_query_class_name(int cls);
+
+/** Upper bound (microseconds) of each latency bucket; the last is open. */
+constexpr int LATENCY_BUCKETS = 16;
+extern const uint64_t LATENCY_BUCKET_US[LATENCY_BUCKETS];
+
+/** Latency histogram of one target and query class. */
+struct RemoteLatency {
+  std::string target;
+  RemoteQueryClass cls;
+  std::array<uint64_t, LATENCY_BUCKETS> counts{};
+  uint64_t sum_us = 0;
+};
+
+/**
+ * Time the round trip on mysql, started at start, into the histogram of
+ * its target and cls. Thread-safe.
+ * @return the round trip in microseconds.
+ */
+uint64_t record_remote_latency(const MYSQL *mysql, RemoteQueryClass cls,
+                           std::chrono::steady_clock::time_point start);
+
+/** Copy of every histogram, by target then class. Thread-safe. */
+std::vector<RemoteLatency> get_remote_latency();
+
+/** Number of histograms. Thread-safe. */
+size_t count_remote_latency();
+
+/** Drop every histogram. Thread-safe. */
+void reset_remote_latency();
+
+/**
+ * Register the inception stages and mutexes with the Performance Schema
+ * and instrument the mutexes constructed so far. Called once from
+ * init_server_psi_keys(), before any inception code runs.
+ */
+void init_psi_keys();
+
+/**
+ * Enter stage on the THD of the calling thread, if it has one, and go
+ * back to the previous stage on destruction.
+ */
+class StageScope {
+ public:
+  explicit StageScope(const PSI_stage_info &stage);
+  ~StageScope();
+  StageScope(const StageScope &) = delete;
+  StageScope &operator=(const StageScope &) = delete;
+
+ private:
+  PSI_stage_info m_old{0, nullptr, 0, nullptr};
+  bool m_entered = false;
+};
+
+/**
+ * A mysql_mutex_t for objects of static storage duration, usable with
+ * std::lock_guard. Static constructors run before the Performance Schema
+ * keys exist, so the mutex starts uninstrumented and init_psi_keys()
+ * attaches the instrument named name.
+ */
+class InceptionMutex {
+ public:
+  explicit InceptionMutex(const char *name);
+  ~InceptionMutex();
+  InceptionMutex(const InceptionMutex &) = delete;
+  InceptionMutex &operator=(const InceptionMutex &) = delete;
+
+  void lock() { mysql_mutex_lock(&m_mutex); }
+  void unlock() { mysql_mutex_unlock(&m_mutex); }
+
+ private:
+  friend void init_psi_keys();
+  const char *m_name;
+  PSI_mutex_key m_key = 0;
+  mysql_mutex_t m_mutex;
+};
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_STATUS_H
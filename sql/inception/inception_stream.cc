@@ -0,0 +1,252 @@
+/**
+ * @file inception_stream.cc
+ * @brief scan_insert_values(): the lexical check of long INSERT statements.
+ */
+
+#include "sql/inception/inception_stream.h"
+
+#include <strings.h>  // strncasecmp
+
+#include <cctype>
+#include <cstring>
+
+namespace inception {
+
+namespace {
+
+/** A pass over the statement, front to back, that never backs up. */
+class InsertScanner {
+ public:
+  InsertScanner(const char *text, size_t length, bool backslash_escapes,
+                bool double_quote_strings)
+      : m_text(text),
+        m_length(length),
+        m_backslash_escapes(backslash_escapes),
+        m_double_quote_strings(double_quote_strings) {}
+
+  bool scan(InsertValuesScan *scan);
+
+ private:
+  char peek(size_t ahead = 0) const {
+    return m_pos + ahead < m_length ? m_text[m_pos + ahead] : '\0';
+  }
+  static bool is_ident_char(char c) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    return isalnum(u) || c == '_' || c == '$' || u >= 0x80;
+  }
+  void skip_space() {
+    while (m_pos < m_length &&
+           isspace(static_cast<unsigned char>(m_text[m_pos])))
+      m_pos++;
+  }
+  bool keyword(const char *word);
+  bool identifier();
+  bool quoted(char quote);
+  bool digits(bool (*is_digit)(char));
+  bool value();
+  bool row(size_t *values);
+
+  const char *m_text;
+  size_t m_length;
+  size_t m_pos = 0;
+  bool m_backslash_escapes;
+  bool m_double_quote_strings;
+};
+
+/* The bare word at m_pos is word: consume it. */
+bool InsertScanner::keyword(const char *word) {
+  const size_t n = strlen(word);
+  if (m_length - m_pos < n || strncasecmp(m_text + m_pos, word, n) != 0 ||
+      is_ident_char(peek(n)))
+    return false;
+  m_pos += n;
+  return true;
+}
+
+/* A bare or `quoted` identifier. @return false if there is none. */
+bool InsertScanner::identifier() {
+  if (peek() == '`') {
+    for (m_pos++; m_pos < m_length; m_pos++) {
+      if (m_text[m_pos] != '`') continue;
+      if (peek(1) != '`') {
+        m_pos++;
+        return true;
+      }
+      m_pos++;  /* `` stands for itself */
+    }
+    return false;
+  }
+  const size_t start = m_pos;
+  while (m_pos < m_length && is_ident_char(m_text[m_pos])) m_pos++;
+  return m_pos > start;
+}
+
+/* A string of quote at m_pos. @return false if it is not closed. */
+bool InsertScanner::quoted(char quote) {
+  for (m_pos++; m_pos < m_length; m_pos++) {
+    const char c = m_text[m_pos];
+    if (c == '\\' && m_backslash_escapes) {
+      m_pos++;
+    } else if (c == quote) {
+      if (peek(1) != quote) {
+        m_pos++;
+        return true;
+      }
+      m_pos++;  /* a doubled quote stands for itself */
+    }
+  }
+  return false;
+}
+
+static bool is_decimal(char c) { return c >= '0' && c <= '9'; }
+static bool is_hex(char c) {
+  return isxdigit(static_cast<unsigned char>(c)) != 0;
+}
+static bool is_bit(char c) { return c == '0' || c == '1'; }
+
+/* One or more digits. */
+bool InsertScanner::digits(bool (*is_digit)(char)) {
+  const size_t start = m_pos;
+  while (m_pos < m_length && is_digit(m_text[m_pos])) m_pos++;
+  return m_pos > start;
+}
+
+/**
+ * A literal the digest folds into a value: [+|-] number, 0x.., 0b..,
+ * X'..', B'..', or a string '..', N'..' (and ".." without ANSI_QUOTES).
+ */
+bool InsertScanner::value() {
+  bool sign = false;
+  if (peek() == '+' || peek() == '-') {
+    /* "--" opens a comment or a second sign; either way, parse it */
+    if (peek(1) == '-') return false;
+    m_pos++;
+    skip_space();
+    sign = true;
+  }
+  const char c = peek();
+  const char d = peek(1);
+  if (!sign && (c == '\'' || (c == '"' && m_double_quote_strings)))
+    return quoted(c);
+  if (!sign && (c == 'n' || c == 'N') && d == '\'') {
+    m_pos++;
+    return quoted('\'');
+  }
+  if ((c == 'x' || c == 'X' || c == 'b' || c == 'B') && d == '\'') {
+    /* X'..' needs hex digits in pairs, B'..' binary ones */
+    const bool hex = c == 'x' || c == 'X';
+    m_pos += 2;
+    const size_t start = m_pos;
+    digits(hex ? is_hex : is_bit);
+    if (peek() != '\'' || (hex && (m_pos - start) % 2 != 0)) return false;
+    m_pos++;
+    return !is_ident_char(peek());
+  }
+  if (c == '0' && (d == 'x' || d == 'b')) {
+    /* 0x.. and 0b.. (lower case only; 0X1 is an identifier) */
+    m_pos += 2;
+    return digits(d == 'x' ? is_hex : is_bit) && !is_ident_char(peek());
+  }
+  if (!is_decimal(c) && !(c == '.' && is_decimal(d))) return false;
+  digits(is_decimal);
+  if (peek() == '.') {
+    m_pos++;
+    digits(is_decimal);
+  }
+  if ((peek() == 'e' || peek() == 'E') &&
+      (is_decimal(peek(1)) ||
+       ((peek(1) == '+' || peek(1) == '-') && is_decimal(peek(2))))) {
+    m_pos += 2;
+    digits(is_decimal);
+  }
+  /* 1abc is an identifier */
+  return !is_ident_char(peek());
+}
+
+/* (value, ...) at m_pos, its number of values in *values. */
+bool InsertScanner::row(size_t *values) {
+  if (peek() != '(') return false;
+  m_pos++;
+  *values = 0;
+  for (;;) {
+    skip_space();
+    if (!value()) return false;
+    ++*values;
+    skip_space();
+    const char c = peek();
+    m_pos++;
+    if (c == ')') return true;
+    if (c != ',') return false;
+  }
+}
+
+bool InsertScanner::scan(InsertValuesScan *scan) {
+  skip_space();
+  if (!keyword("INSERT") && !keyword("REPLACE")) return false;
+
+  /* Modifiers in any order: the parser checks the head */
+  for (;;) {
+    skip_space();
+    if (!keyword("LOW_PRIORITY") && !keyword("DELAYED") &&
+        !keyword("HIGH_PRIORITY") && !keyword("IGNORE") && !keyword("INTO"))
+      break;
+  }
+  if (!identifier()) return false;
+  skip_space();
+  if (peek() == '.') {
+    m_pos++;
+    skip_space();
+    if (!identifier()) return false;
+    skip_space();
+  }
+  if (peek() == '(') {
+    m_pos++;
+    for (;;) {
+      skip_space();
+      if (!identifier()) return false;
+      skip_space();
+      const char c = peek();
+      m_pos++;
+      if (c == ')') break;
+      if (c != ',') return false;
+    }
+    skip_space();
+  }
+  if (!keyword("VALUES") && !keyword("VALUE")) return false;
+
+  size_t expected = 0;
+  for (;;) {
+    skip_space();
+    size_t values;
+    if (!row(&values)) return false;
+    if (++scan->rows == 1)
+      expected = values;
+    else if (values != expected)
+      return false;
+    if (scan->rows == 2) scan->head_length = m_pos;
+    scan->length = m_pos;
+    skip_space();
+    if (peek() != ',') break;
+    m_pos++;
+  }
+  if (scan->rows < 3) return false;
+
+  if (m_pos < m_length) {
+    if (m_text[m_pos] != ';') return false;
+    scan->semicolon = true;
+    scan->next = m_pos + 1;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool scan_insert_values(const char *text, size_t length,
+                        bool backslash_escapes, bool double_quote_strings,
+                        InsertValuesScan *scan) {
+  *scan = InsertValuesScan();
+  InsertScanner scanner(text, length, backslash_escapes, double_quote_strings);
+  return !scanner.scan(scan);
+}
+
+}  // namespace inception
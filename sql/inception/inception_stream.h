@@ -0,0 +1,52 @@
+/**
+ * @file inception_stream.h
+ * @brief Audit of long INSERT ... VALUES statements without a full parse.
+ *
+ * A dump can hold INSERTs of hundreds of thousands of rows; the parser
+ * builds an Item for every value of them before the audit reads a few
+ * names. The digest folds rows of constant literals into one token, so the
+ * statement through its second row has the tables, columns and sqlsha1 of
+ * the whole of it. Once scan_insert_values() has checked that the other
+ * rows are constant literals with as many values as the first, only that
+ * head goes through the parser (inception_insert_stream_min_size).
+ */
+
+#ifndef SQL_INCEPTION_STREAM_H
+#define SQL_INCEPTION_STREAM_H
+
+#include <cstddef>
+
+namespace inception {
+
+/** What scan_insert_values() found. */
+struct InsertValuesScan {
+  size_t length = 0;       /* statement through its last row */
+  size_t head_length = 0;  /* statement through its second row */
+  size_t rows = 0;
+  bool semicolon = false;  /* a ';' follows, ending at next */
+  size_t next = 0;         /* offset past the ';' */
+};
+
+/**
+ * Scan text for
+ *
+ *   {INSERT | REPLACE} [LOW_PRIORITY | DELAYED | HIGH_PRIORITY] [IGNORE]
+ *       [INTO] [db.]table [(column, ...)] {VALUES | VALUE} (row), ...
+ *
+ * of at least three rows, each with the same number of numbers, strings,
+ * hexadecimal or bit literals; a number may have a sign. Anything else
+ * (comments, NULL, DEFAULT, expressions, PARTITION, ON DUPLICATE KEY
+ * UPDATE, an alias), even where the head would parse it, makes it fail.
+ * The statement ends at the end of text or at a ';'.
+ *
+ * @param backslash_escapes '\' escapes in strings (no NO_BACKSLASH_ESCAPES)
+ * @param double_quote_strings '"' quotes strings (no ANSI_QUOTES)
+ * @return false on success, true if the statement needs a full parse.
+ */
+bool scan_insert_values(const char *text, size_t length,
+                        bool backslash_escapes, bool double_quote_strings,
+                        InsertValuesScan *scan);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_STREAM_H
@@ -39,6 +39,9 @@ ulong opt_check_autoincrement = 1;   /* default WARNING */
 ulong opt_check_partition = 1;       /* default WARNING */
 ulong opt_check_orderby_in_dml = 1;   /* default WARNING */
 ulong opt_check_orderby_rand = 1;     /* default WARNING */
+ulong opt_check_dml_full_scan = 1;    /* default WARNING */
+ulong opt_check_dml_filesort = 1;     /* default WARNING */
+ulong opt_check_dml_binlog_size = 1;  /* default WARNING */
 ulong opt_check_autoincrement_init_value = 1; /* default WARNING */
 ulong opt_check_autoincrement_name = 0; /* default OFF */
 ulong opt_check_timestamp_default = 1; /* default WARNING */
@@ -46,9 +49,11 @@ ulong opt_check_column_charset = 0;   /* default OFF */
 ulong opt_check_column_default_value = 0; /* default OFF */
 ulong opt_check_identifier_keyword = 0; /* default OFF */
 ulong opt_check_merge_alter_table = 1; /* default WARNING */
+ulong opt_check_column_position_rebuild = 1; /* default WARNING */
 ulong opt_check_varchar_shrink = 1;       /* default WARNING */
 ulong opt_check_lossy_type_change = 1;    /* default WARNING */
 ulong opt_check_decimal_change = 0;       /* default OFF */
+ulong opt_check_column_data = 0;          /* default OFF */
 
 ulong opt_check_tidb_merge_alter = 2;       /* default ERROR */
 ulong opt_check_tidb_varchar_shrink = 2;    /* default ERROR */
@@ -57,16 +62,43 @@ ulong opt_check_tidb_lossy_type_change = 2; /* default ERROR */
 ulong opt_check_tidb_foreign_key = 2;       /* default ERROR */
 
 bool opt_osc_on = false;
+ulong opt_osc_chunk_size = 1000;            /* rows copied per chunk */
+ulong opt_osc_lock_wait_timeout = 3;        /* default 3s cut-over lock wait */
+bool opt_osc_drop_old_table = true;         /* default ON */
+bool opt_osc_defer_indexes = true;          /* secondary indexes after the copy */
+ulong opt_osc_min_table_size = 100;         /* MB; smaller COPY ALTERs run natively */
+ulong opt_osc_min_table_rows = 1000000;     /* ... unless they have this many rows */
+ulong opt_ddl_rebuild_speed = 50;           /* MB/s, for estimated_time */
+ulong opt_replica_apply_speed = 10;         /* MB/s of row events */
+
+ulong opt_verify_workers = 4;               /* --enable-verify checksum threads */
+ulong opt_verify_chunk_size = 10000;        /* rows per checksummed range */
+ulong opt_verify_max_chunks_per_sec = 0;    /* default 0 = unlimited */
+ulong opt_verify_wait_timeout = 60;         /* seconds for replicas to catch up */
+ulong opt_column_data_workers = 4;          /* replica scan threads per ALTER */
+ulong opt_column_data_chunk_size = 10000;   /* rows per scanned range */
+ulong opt_column_data_max_chunks_per_sec = 20; /* 0 = unlimited */
 
 char *opt_osc_bin_dir = nullptr;
 char *opt_support_charset = nullptr;
 char *opt_must_have_columns = nullptr;
+char *opt_rule_profiles = nullptr;   /* profiles file for --profile, NULL = none */
+char *opt_resource_group = nullptr;  /* resource group of inception threads */
+char *opt_split_dir = nullptr;       /* --enable-split-files, NULL = not allowed */
 char *opt_audit_log = nullptr;
 
 char *opt_inception_user = nullptr;
 char *opt_inception_password = nullptr;
 char *opt_inception_password_encrypt_key = nullptr;
 
+char *opt_backup_host = nullptr;            /* NULL = back up to the target */
+ulong opt_backup_port = 3306;
+char *opt_backup_user = nullptr;
+char *opt_backup_password = nullptr;
+ulong opt_backup_threads = 4;               /* parallel binlog decoders */
+ulong opt_backup_strategy = 0;              /* default BINLOG */
+ulong opt_backup_select_chunk_size = 1000;
+
 ulong opt_check_index_length = 1;          /* default WARNING */
 ulong opt_check_insert_values_match = 2;   /* default ERROR */
 ulong opt_check_insert_duplicate_column = 2; /* default ERROR */
@@ -76,6 +108,8 @@ ulong opt_check_must_have_columns = 2;    /* default ERROR */
 ulong opt_check_max_indexes = 16;
 ulong opt_check_max_index_parts = 5;
 ulong opt_check_max_update_rows = 10000;
+ulong opt_check_explain_min_rows = 10000;
+ulong opt_check_max_dml_binlog_size = 1024;  /* MB, 0 = no size limit */
 ulong opt_check_max_char_length = 64;
 ulong opt_check_max_primary_key_parts = 5;
 ulong opt_check_max_table_name_length = 64;
@@ -87,7 +121,82 @@ ulong opt_check_in_count = 0;              /* default 0 = disabled */
 
 ulong opt_exec_max_threads_running = 0;    /* default 0 = disabled */
 ulong opt_exec_max_replication_delay = 0;  /* default 0 = disabled, unit: seconds */
+ulong opt_exec_max_history_list_length = 0;  /* default 0 = disabled */
+ulong opt_exec_load_sample_interval_ms = 1000;  /* default 1s */
+ulong opt_exec_max_checkpoint_age_pct = 0;  /* default 0 = disabled, % of redo capacity */
+ulong opt_exec_max_statement_p99_ms = 0;    /* default 0 = disabled */
+bool opt_exec_adaptive_throttle = false;    /* default OFF = wait at ceilings */
+ulong opt_exec_adaptive_max_pause_ms = 10000;  /* default 10s */
 bool opt_exec_check_read_only = true;      /* default ON */
+ulong opt_exec_chunk_size = 1000;          /* rows per chunk for --enable-chunked-dml */
+ulong opt_exec_tidb_batch_min_rows = 100000; /* --enable-tidb-batch-dml threshold */
+ulong opt_exec_batch_statements = 1;       /* default 1 = one round trip per statement */
+ulong opt_exec_batch_bytes = 1024 * 1024;  /* SQL bytes per multi-statement batch */
+bool opt_exec_merge_inserts = true;        /* default ON */
+ulong opt_exec_prepare_min_repeats = 10;   /* default 10, 0 = disabled */
+ulong opt_exec_max_sessions_per_target = 0;  /* default 0 = unlimited */
+ulong opt_exec_max_ddl_per_target = 0;       /* default 0 = unlimited */
+ulong opt_check_max_sessions_per_target = 0; /* default 0 = unlimited */
+ulong opt_check_max_queries_per_target = 0;  /* default 0 = unlimited */
+ulong opt_exec_max_rows_per_sec = 0;         /* default 0 = unlimited */
+ulong opt_exec_max_statements_per_sec = 0;   /* default 0 = unlimited */
+ulong opt_exec_ddl_lock_wait_timeout = 0;    /* default 0 = no MDL guard */
+ulong opt_exec_ddl_lock_retries = 10;        /* default 10 retries */
+ulong opt_exec_online_alter_fallback = 1;    /* default OSC */
+bool opt_exec_partition_rebuild = false;     /* default OFF */
+ulong opt_exec_monitor_max_threads_running = 0;    /* default 0 = disabled */
+ulong opt_exec_monitor_max_replication_delay = 0;  /* default 0 = disabled */
+bool opt_exec_monitor_abort = false;               /* default OFF = report only */
+bool opt_exec_progress = true;                     /* default ON */
+char *opt_exec_heartbeat_table = nullptr;          /* db.table, NULL = Seconds_Behind_Master */
+char *opt_exec_checkpoint_dir = nullptr;           /* NULL = no checkpoints */
+char *opt_shadow_schema_dir = nullptr;             /* NULL = no --schema-file */
+char *opt_script_dir = nullptr;                    /* NULL = no audit file */
+ulong opt_exec_heartbeat_interval_ms = 100;        /* default 100ms */
+
+ulong opt_metadata_cache_ttl = 60;          /* default 60s, 0 = disabled */
+ulong opt_metadata_cache_max_tables = 10000;
+bool opt_metadata_prefetch = true;          /* default ON */
+ulong opt_audit_host_max_lag = 10;          /* seconds, 0 = not checked */
+char *opt_metadata_warm_schemas = nullptr;  /* NULL = no startup warm-up */
+char *opt_metadata_snapshot_dir = nullptr;  /* NULL = no binlog watcher */
+char *opt_shared_cache_host = nullptr;      /* NULL = no shared cache tier */
+ulong opt_shared_cache_port = 3306;
+char *opt_shared_cache_user = nullptr;
+char *opt_shared_cache_password = nullptr;
+ulong opt_audit_memo_size = 10000;          /* DML shapes per session, 0 = off */
+ulong opt_audit_cache_size = 10000;         /* statements server-wide, 0 = off */
+ulong opt_insert_stream_min_size = 1024 * 1024; /* bytes, 0 = always parse in full */
+ulong opt_query_tree_cache_size = 10000;    /* trees server-wide, 0 = off */
+ulong opt_result_spool_size = 16 * 1024 * 1024; /* bytes in memory, 0 = off */
+ulong opt_max_session_memory = 256 * 1024 * 1024; /* statement texts, 0 = off */
+ulong opt_result_keep_time = 0;            /* seconds results stay pageable, 0 = off */
+ulong opt_result_keep_size = 256 * 1024 * 1024; /* bytes of all kept results */
+
+ulong opt_conn_pool_max_idle = 8;           /* default 8 per target, 0 = disabled */
+ulong opt_conn_pool_idle_timeout = 60;      /* default 60s */
+char *opt_remote_compression = nullptr;     /* [host:port=]algorithm[:level];... NULL = none */
+
+ulong opt_job_workers = 4;                  /* background job worker threads */
+ulong opt_job_history = 100;                /* finished jobs kept for results */
+
+ulong opt_exec_fanout_workers = 8;          /* shards executed at the same time */
+ulong opt_exec_parallel_per_target = 4;     /* --enable-parallel lanes at a time */
+ulong opt_exec_tidb_ddl_concurrency = 0;    /* TiDB DDL jobs at once, 0 = off */
+ulong opt_exec_tidb_ddl_reorg_threads = 0;  /* THREAD per job, 0 = default */
+ulong opt_exec_tidb_ddl_reorg_batch_size = 0; /* BATCH_SIZE, 0 = default */
+char *opt_target_groups = nullptr;          /* name=host:port,...;... NULL = none */
+
+ulong opt_audit_log_buffer_size = 8UL * 1024 * 1024;  /* default 8MB */
+ulong opt_audit_log_sync_interval = 1000;   /* default 1000ms, 0 = no fsync */
+ulong opt_audit_log_rotate_size = 0;        /* default 0 = disabled */
+ulong opt_audit_log_rotate_interval = 0;    /* default 0 = disabled */
+
+char *opt_audit_sink = nullptr;             /* http://host[:port]/path, NULL = none */
+ulong opt_audit_sink_batch_size = 500;      /* records per request */
+ulong opt_audit_sink_buffer_size = 8UL * 1024 * 1024;  /* default 8MB */
+bool opt_audit_sink_compress = false;       /* gzip request bodies */
+char *opt_audit_sink_spool_dir = nullptr;   /* NULL = drop instead of spooling */
 }  // namespace inception
 
 /* --- System variable registrations --- */
@@ -178,6 +287,13 @@ static Sys_var_enum Sys_inception_check_merge_alter_table(
     GLOBAL_VAR(inception::opt_check_merge_alter_table), CMD_LINE(OPT_ARG),
     inception_rule_level_names, DEFAULT(1));
 
+static Sys_var_enum Sys_inception_check_column_position_rebuild(
+    "inception_check_column_position_rebuild",
+    "Warn when ADD COLUMN ... FIRST / AFTER rebuilds a table that adding "
+    "the columns at the end would change INSTANT on the target's release.",
+    GLOBAL_VAR(inception::opt_check_column_position_rebuild),
+    CMD_LINE(OPT_ARG), inception_rule_level_names, DEFAULT(1));
+
 static Sys_var_enum Sys_inception_check_varchar_shrink(
     "inception_check_varchar_shrink",
     "Check when VARCHAR column length is reduced (may truncate data).",
@@ -196,6 +312,14 @@ static Sys_var_enum Sys_inception_check_decimal_change(
     GLOBAL_VAR(inception::opt_check_decimal_change), CMD_LINE(OPT_ARG),
     inception_rule_level_names, DEFAULT(0));
 
+static Sys_var_enum Sys_inception_check_column_data(
+    "inception_check_column_data",
+    "Scan the first --slave-hosts replica for values that do not fit a "
+    "column an ALTER shortens or narrows (VARCHAR/CHAR length, integer "
+    "type, DECIMAL precision).",
+    GLOBAL_VAR(inception::opt_check_column_data), CMD_LINE(OPT_ARG),
+    inception_rule_level_names, DEFAULT(0));
+
 /* ---- Column level ---- */
 
 static Sys_var_enum Sys_inception_check_column_comment(
@@ -286,7 +410,9 @@ static Sys_var_enum Sys_inception_check_foreign_key(
 
 static Sys_var_enum Sys_inception_check_duplicate_index(
     "inception_check_duplicate_index",
-    "Detect redundant indexes (e.g. idx(a) is covered by idx(a,b)).",
+    "Detect redundant indexes (e.g. idx(a) is covered by idx(a,b)), within "
+    "a CREATE TABLE and against the existing indexes for ALTER TABLE and "
+    "CREATE INDEX.",
     GLOBAL_VAR(inception::opt_check_duplicate_index), CMD_LINE(OPT_ARG),
     inception_rule_level_names, DEFAULT(1));
 
@@ -402,12 +528,48 @@ static Sys_var_enum Sys_inception_check_orderby_rand(
     GLOBAL_VAR(inception::opt_check_orderby_rand), CMD_LINE(OPT_ARG),
     inception_rule_level_names, DEFAULT(1));
 
+static Sys_var_enum Sys_inception_check_dml_full_scan(
+    "inception_check_dml_full_scan",
+    "Check UPDATE/DELETE whose EXPLAIN plan reads a whole table of at least "
+    "inception_check_explain_min_rows rows (no usable index on WHERE).",
+    GLOBAL_VAR(inception::opt_check_dml_full_scan), CMD_LINE(OPT_ARG),
+    inception_rule_level_names, DEFAULT(1));
+
+static Sys_var_enum Sys_inception_check_dml_filesort(
+    "inception_check_dml_filesort",
+    "Check UPDATE/DELETE whose EXPLAIN plan uses a filesort or a temporary "
+    "table over at least inception_check_explain_min_rows rows.",
+    GLOBAL_VAR(inception::opt_check_dml_filesort), CMD_LINE(OPT_ARG),
+    inception_rule_level_names, DEFAULT(1));
+
+static Sys_var_enum Sys_inception_check_dml_binlog_size(
+    "inception_check_dml_binlog_size",
+    "Check UPDATE/DELETE whose estimated row events exceed "
+    "inception_check_max_dml_binlog_size, or whose predicted replica apply "
+    "time exceeds inception_exec_max_replication_delay.",
+    GLOBAL_VAR(inception::opt_check_dml_binlog_size), CMD_LINE(OPT_ARG),
+    inception_rule_level_names, DEFAULT(1));
+
 static Sys_var_ulong Sys_inception_check_max_update_rows(
     "inception_check_max_update_rows",
     "Maximum rows affected by a single UPDATE/DELETE statement.",
     GLOBAL_VAR(inception::opt_check_max_update_rows), CMD_LINE(OPT_ARG),
     VALID_RANGE(1, 4294967295UL), DEFAULT(10000), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_inception_check_explain_min_rows(
+    "inception_check_explain_min_rows",
+    "Estimated rows from which inception_check_dml_full_scan and "
+    "inception_check_dml_filesort report (0 = any table).",
+    GLOBAL_VAR(inception::opt_check_explain_min_rows), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_check_max_dml_binlog_size(
+    "inception_check_max_dml_binlog_size",
+    "MB of row events from which inception_check_dml_binlog_size reports an "
+    "UPDATE/DELETE (0 = only the replica apply time is checked).",
+    GLOBAL_VAR(inception::opt_check_max_dml_binlog_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1048576), DEFAULT(1024), BLOCK_SIZE(1));
+
 static Sys_var_enum Sys_inception_check_insert_values_match(
     "inception_check_insert_values_match",
     "Check that INSERT column count matches value count.",
@@ -485,6 +647,49 @@ static Sys_var_ulong Sys_inception_exec_max_replication_delay(
     GLOBAL_VAR(inception::opt_exec_max_replication_delay), CMD_LINE(OPT_ARG),
     VALID_RANGE(0, 4294967295UL), DEFAULT(0), BLOCK_SIZE(1));
 
+static Sys_var_ulong Sys_inception_exec_max_history_list_length(
+    "inception_exec_max_history_list_length",
+    "Max InnoDB history list length on the primary before pausing "
+    "execution (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_max_history_list_length), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_load_sample_interval_ms(
+    "inception_exec_load_sample_interval_ms",
+    "Milliseconds between two samples of the target load, taken by one "
+    "sampler thread per target shared by all EXECUTE batches.",
+    GLOBAL_VAR(inception::opt_exec_load_sample_interval_ms), CMD_LINE(OPT_ARG),
+    VALID_RANGE(100, 60000), DEFAULT(1000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_checkpoint_age_pct(
+    "inception_exec_max_checkpoint_age_pct",
+    "Max redo checkpoint age on the primary, in percent of the redo log "
+    "capacity, before pausing execution (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_max_checkpoint_age_pct), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 100), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_statement_p99_ms(
+    "inception_exec_max_statement_p99_ms",
+    "Max p99 latency (ms) of the statements the primary finished between "
+    "two load samples, before pausing execution (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_max_statement_p99_ms), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_inception_exec_adaptive_throttle(
+    "inception_exec_adaptive_throttle",
+    "Treat the inception_exec_max_* load ceilings as set points of an AIMD "
+    "controller that paces statements and chunks, instead of waiting "
+    "while one is crossed.",
+    GLOBAL_VAR(inception::opt_exec_adaptive_throttle), CMD_LINE(OPT_ARG),
+    DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_inception_exec_adaptive_max_pause_ms(
+    "inception_exec_adaptive_max_pause_ms",
+    "Longest pause per statement the adaptive throttle backs off to.",
+    GLOBAL_VAR(inception::opt_exec_adaptive_max_pause_ms), CMD_LINE(OPT_ARG),
+    VALID_RANGE(100, 600000), DEFAULT(10000), BLOCK_SIZE(1));
+
 static Sys_var_bool Sys_inception_exec_check_read_only(
     "inception_exec_check_read_only",
     "Pre-check remote @@global.read_only before EXECUTE.",
@@ -492,18 +697,569 @@ static Sys_var_bool Sys_inception_exec_check_read_only(
     DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
     ON_UPDATE(nullptr));
 
+static Sys_var_ulong Sys_inception_exec_chunk_size(
+    "inception_exec_chunk_size",
+    "Rows per primary-key chunk when a session runs UPDATE/DELETE with "
+    "--enable-chunked-dml.",
+    GLOBAL_VAR(inception::opt_exec_chunk_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 1000000), DEFAULT(1000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_tidb_batch_min_rows(
+    "inception_exec_tidb_batch_min_rows",
+    "Estimated rows from which a TiDB UPDATE/DELETE runs in batches of "
+    "inception_exec_chunk_size rows with --enable-tidb-batch-dml "
+    "(0 = every such statement).",
+    GLOBAL_VAR(inception::opt_exec_tidb_batch_min_rows), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(100000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_batch_statements(
+    "inception_exec_batch_statements",
+    "Max consecutive plain INSERT/REPLACE/UPDATE/DELETE statements sent in "
+    "one multi-statement round trip in EXECUTE mode (1 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_batch_statements), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 10000), DEFAULT(1), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_batch_bytes(
+    "inception_exec_batch_bytes",
+    "Max SQL bytes per multi-statement round trip "
+    "(see inception_exec_batch_statements).",
+    GLOBAL_VAR(inception::opt_exec_batch_bytes), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1024, 64 * 1024 * 1024), DEFAULT(1024 * 1024),
+    BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_inception_exec_merge_inserts(
+    "inception_exec_merge_inserts",
+    "Execute consecutive single-row INSERT ... VALUES statements with the "
+    "same fingerprint and target table as one multi-row INSERT, up to the "
+    "target's max_allowed_packet.",
+    GLOBAL_VAR(inception::opt_exec_merge_inserts), CMD_LINE(OPT_ARG),
+    DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_inception_exec_prepare_min_repeats(
+    "inception_exec_prepare_min_repeats",
+    "Run DML whose fingerprint occurs at least this many times in a batch "
+    "as a server-side prepared statement, prepared once and executed with "
+    "its literals bound (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_prepare_min_repeats), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1000000), DEFAULT(10), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_sessions_per_target(
+    "inception_exec_max_sessions_per_target",
+    "Max EXECUTE batches running at once against one target host:port; "
+    "further batches queue by --priority, then arrival (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_exec_max_sessions_per_target), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_ddl_per_target(
+    "inception_exec_max_ddl_per_target",
+    "Max DDL statements running at once against one target host:port "
+    "across all EXECUTE batches (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_exec_max_ddl_per_target), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_check_max_sessions_per_target(
+    "inception_check_max_sessions_per_target",
+    "Max CHECK sessions auditing against one target host:port at once; "
+    "further sessions wait at inception_magic_start by --priority, then "
+    "arrival (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_check_max_sessions_per_target),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_check_max_queries_per_target(
+    "inception_check_max_queries_per_target",
+    "Max remote metadata and EXPLAIN queries of audits running at once "
+    "against one server host:port; a free slot goes to the waiting session "
+    "holding the fewest (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_check_max_queries_per_target),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_rows_per_sec(
+    "inception_exec_max_rows_per_sec",
+    "Affected rows per second all EXECUTE batches together may write to one "
+    "target host:port, for targets without \"inception set rate\" "
+    "(0 = unlimited).",
+    GLOBAL_VAR(inception::opt_exec_max_rows_per_sec), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_max_statements_per_sec(
+    "inception_exec_max_statements_per_sec",
+    "Statements per second all EXECUTE batches together may run against one "
+    "target host:port, for targets without \"inception set rate\" "
+    "(0 = unlimited).",
+    GLOBAL_VAR(inception::opt_exec_max_statements_per_sec), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_ddl_lock_wait_timeout(
+    "inception_exec_ddl_lock_wait_timeout",
+    "Session lock_wait_timeout in seconds for ALTER/DROP/TRUNCATE/RENAME "
+    "TABLE and CREATE/DROP INDEX in EXECUTE mode. When set, such a DDL is "
+    "not sent while another session has a metadata lock on its table, and "
+    "a blocked or timed-out attempt is retried with backoff (0 = off).",
+    GLOBAL_VAR(inception::opt_exec_ddl_lock_wait_timeout), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 3600), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_ddl_lock_retries(
+    "inception_exec_ddl_lock_retries",
+    "Retries of a DDL blocked by a metadata lock when "
+    "inception_exec_ddl_lock_wait_timeout is set.",
+    GLOBAL_VAR(inception::opt_exec_ddl_lock_retries), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1000), DEFAULT(10), BLOCK_SIZE(1));
+
+/* What --enable-online-alter does when the target refuses every algorithm */
+static const char *inception_online_alter_fallback_names[] = {"ERROR", "OSC",
+                                                              "COPY", NullS};
+
+static Sys_var_enum Sys_inception_exec_online_alter_fallback(
+    "inception_exec_online_alter_fallback",
+    "With --enable-online-alter, what to do when the target rejects "
+    "ALGORITHM=INSTANT and ALGORITHM=INPLACE, LOCK=NONE on an ALTER: "
+    "ERROR leaves it unexecuted, OSC runs it through the online schema "
+    "change tool, COPY runs it without the clauses.",
+    GLOBAL_VAR(inception::opt_exec_online_alter_fallback), CMD_LINE(OPT_ARG),
+    inception_online_alter_fallback_names, DEFAULT(1));
+
+static Sys_var_bool Sys_inception_exec_partition_rebuild(
+    "inception_exec_partition_rebuild",
+    "Run an ALTER TABLE that only rebuilds a partitioned table (FORCE or "
+    "ENGINE=InnoDB) as one ALTER TABLE ... REBUILD PARTITION per partition, "
+    "with the load throttle, --sleep and pause between partitions.",
+    GLOBAL_VAR(inception::opt_exec_partition_rebuild), CMD_LINE(OPT_ARG),
+    DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_inception_exec_monitor_max_threads_running(
+    "inception_exec_monitor_max_threads_running",
+    "Threads_running ceiling on the primary, checked every second while a "
+    "statement runs (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_monitor_max_threads_running),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 4294967295UL), DEFAULT(0),
+    BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_monitor_max_replication_delay(
+    "inception_exec_monitor_max_replication_delay",
+    "Replication delay ceiling (seconds) on the --slave-hosts replicas, "
+    "checked every second while a statement runs (0 = disabled).",
+    GLOBAL_VAR(inception::opt_exec_monitor_max_replication_delay),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 4294967295UL), DEFAULT(0),
+    BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_inception_exec_monitor_abort(
+    "inception_exec_monitor_abort",
+    "KILL QUERY a statement whose run crosses a monitor ceiling; when OFF "
+    "the breach is only reported as a warning on the statement.",
+    GLOBAL_VAR(inception::opt_exec_monitor_abort), CMD_LINE(OPT_ARG),
+    DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_bool Sys_inception_exec_progress(
+    "inception_exec_progress",
+    "Sample the percent complete, rate and ETA of a statement running for "
+    "more than a second (performance_schema.events_stages_current on MySQL, "
+    "ADMIN SHOW DDL JOBS on TiDB) for \"inception show sessions\".",
+    GLOBAL_VAR(inception::opt_exec_progress), CMD_LINE(OPT_ARG),
+    DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_charptr Sys_inception_exec_heartbeat_table(
+    "inception_exec_heartbeat_table",
+    "Heartbeat table (db.table) written on the primary and read on the "
+    "--slave-hosts replicas to measure replication lag in milliseconds. "
+    "Empty = use Seconds_Behind_Master.",
+    GLOBAL_VAR(inception::opt_exec_heartbeat_table), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_exec_checkpoint_dir(
+    "inception_exec_checkpoint_dir",
+    "Directory (must exist) where EXECUTE batches persist a checkpoint "
+    "after each statement and chunk, to continue with --resume=<batch_id> "
+    "after a kill or restart. Empty = no checkpoints.",
+    GLOBAL_VAR(inception::opt_exec_checkpoint_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_shadow_schema_dir(
+    "inception_shadow_schema_dir",
+    "Directory of schema dumps (mysqldump --no-data or SHOW CREATE TABLE "
+    "output) that CHECK sessions audit against offline with "
+    "--schema-file=<name>, without connecting to the target. "
+    "Empty = --schema-file disabled.",
+    GLOBAL_VAR(inception::opt_shadow_schema_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_script_dir(
+    "inception_script_dir",
+    "Directory of SQL scripts that a session audits on the server with "
+    "\"inception audit file '<name>'\", instead of sending them statement "
+    "by statement. Empty = inception audit file disabled.",
+    GLOBAL_VAR(inception::opt_script_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_exec_heartbeat_interval_ms(
+    "inception_exec_heartbeat_interval_ms",
+    "Milliseconds between heartbeat writes on the primary "
+    "(see inception_exec_heartbeat_table).",
+    GLOBAL_VAR(inception::opt_exec_heartbeat_interval_ms), CMD_LINE(OPT_ARG),
+    VALID_RANGE(10, 60000), DEFAULT(100), BLOCK_SIZE(1));
+
+/* ---- Remote metadata cache ---- */
+
+static Sys_var_ulong Sys_inception_metadata_cache_ttl(
+    "inception_metadata_cache_ttl",
+    "Seconds a cached remote table/schema metadata entry stays valid "
+    "(0 = disabled, every check queries the target).",
+    GLOBAL_VAR(inception::opt_metadata_cache_ttl), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 86400), DEFAULT(60), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_metadata_cache_max_tables(
+    "inception_metadata_cache_max_tables",
+    "Max number of tables kept in the remote metadata cache.",
+    GLOBAL_VAR(inception::opt_metadata_cache_max_tables), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_metadata_snapshot_dir(
+    "inception_metadata_snapshot_dir",
+    "Directory of schema snapshot files. When set, a thread per target tails "
+    "its binlog, drops cached metadata of every table a DDL changes and keeps "
+    "the rest past the TTL; the entries survive restarts in the snapshot. "
+    "Needs REPLICATION SLAVE. Empty = no watcher.",
+    GLOBAL_VAR(inception::opt_metadata_snapshot_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_shared_cache_host(
+    "inception_shared_cache_host",
+    "MySQL server holding the metadata cache tier shared by the inception "
+    "instances pointed at it (database inception_shared): a local cache "
+    "miss is answered from it before the target, entries loaded from a "
+    "target are stored there, and DDL executed or seen by one instance "
+    "invalidates them for all. Also shares the learned rebuild speeds. "
+    "Empty = every instance caches for itself.",
+    GLOBAL_VAR(inception::opt_shared_cache_host), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_shared_cache_port(
+    "inception_shared_cache_port",
+    "Port of inception_shared_cache_host.",
+    GLOBAL_VAR(inception::opt_shared_cache_port), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 65535), DEFAULT(3306), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_shared_cache_user(
+    "inception_shared_cache_user",
+    "User for inception_shared_cache_host.",
+    GLOBAL_VAR(inception::opt_shared_cache_user), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_shared_cache_password(
+    "inception_shared_cache_password",
+    "Password for inception_shared_cache_host. "
+    "Supports AES-encrypted value with 'AES:' prefix.",
+    GLOBAL_VAR(inception::opt_shared_cache_password), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_bool Sys_inception_metadata_prefetch(
+    "inception_metadata_prefetch",
+    "Prefetch all table metadata of the session's schema into the metadata "
+    "cache on a background thread when the schema becomes known.",
+    GLOBAL_VAR(inception::opt_metadata_prefetch), CMD_LINE(OPT_ARG),
+    DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_inception_audit_host_max_lag(
+    "inception_audit_host_max_lag",
+    "Seconds an --audit-host replica may be behind its source for the "
+    "session's metadata and EXPLAIN queries to go to it; otherwise they go "
+    "to the target. 0 = any server, replica or not.",
+    GLOBAL_VAR(inception::opt_audit_host_max_lag), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 86400), DEFAULT(10), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_metadata_warm_schemas(
+    "inception_metadata_warm_schemas",
+    "Comma-separated host:port/schema list loaded into the metadata cache "
+    "at startup, on a thread per target, with inception_user and "
+    "inception_password. Empty = tables are loaded when first audited.",
+    READ_ONLY GLOBAL_VAR(inception::opt_metadata_warm_schemas),
+    CMD_LINE(OPT_ARG), IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_audit_memo_size(
+    "inception_audit_memo_size",
+    "Max number of INSERT/UPDATE/DELETE shapes (sqlsha1 + default database) "
+    "per session whose literal-independent audit results and EXPLAIN row "
+    "estimate are reused by later statements of the same shape "
+    "(0 = disabled, every statement is audited in full).",
+    GLOBAL_VAR(inception::opt_audit_memo_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_audit_cache_size(
+    "inception_audit_cache_size",
+    "Max number of statement audit results shared by all sessions, keyed by "
+    "statement text, default database, target and rule configuration, so "
+    "that a resubmitted script re-audits only what changed; results follow "
+    "inception_metadata_cache_ttl and its invalidations (0 = disabled).",
+    GLOBAL_VAR(inception::opt_audit_cache_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_insert_stream_min_size(
+    "inception_insert_stream_min_size",
+    "INSERT ... VALUES statements of at least this many bytes whose rows "
+    "are all constant literals are checked by a lexical scan, and only "
+    "their first two rows go through the parser; the audit sees the same "
+    "tables, columns and digest (0 = always parse in full).",
+    GLOBAL_VAR(inception::opt_insert_stream_min_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, ULONG_MAX), DEFAULT(1024 * 1024), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_query_tree_cache_size(
+    "inception_query_tree_cache_size",
+    "Max number of QUERY_TREE results shared by all sessions, keyed by "
+    "statement digest, default database and target; trees that expanded "
+    "SELECT * from the target follow inception_metadata_cache_ttl and its "
+    "invalidations (0 = disabled, every statement is walked).",
+    GLOBAL_VAR(inception::opt_query_tree_cache_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_result_spool_size(
+    "inception_result_spool_size",
+    "Bytes of finished result rows a CHECK, SPLIT or QUERY_TREE session "
+    "keeps in memory in compact form; beyond it they are spilled to a "
+    "temporary file in --tmpdir until commit (0 = disabled, every statement "
+    "node is kept until commit).",
+    GLOBAL_VAR(inception::opt_result_spool_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, ULONG_MAX), DEFAULT(16 * 1024 * 1024), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_max_session_memory(
+    "inception_max_session_memory",
+    "Bytes of statement text and messages a session keeps in memory for "
+    "its cached statements; beyond it those of the oldest statements are "
+    "spilled to a temporary file in --tmpdir and read back when executed "
+    "or returned (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_max_session_memory), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, ULONG_MAX), DEFAULT(256 * 1024 * 1024), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_result_keep_time(
+    "inception_result_keep_time",
+    "Seconds the result set of a CHECK or EXECUTE commit is kept, the last "
+    "one of each connection, for inception get results session "
+    "<thread_id> to page through (0 = disabled).",
+    GLOBAL_VAR(inception::opt_result_keep_time), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 7 * 24 * 3600), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_result_keep_size(
+    "inception_result_keep_size",
+    "Bytes all result sets kept for inception_result_keep_time may hold; "
+    "the oldest are dropped first, and a larger one is not kept.",
+    GLOBAL_VAR(inception::opt_result_keep_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1024 * 1024, ULONG_MAX), DEFAULT(256 * 1024 * 1024),
+    BLOCK_SIZE(1));
+
+/* ---- Remote connection pool ---- */
+
+static Sys_var_ulong Sys_inception_conn_pool_max_idle(
+    "inception_conn_pool_max_idle",
+    "Max number of idle remote connections kept per (target, user) for reuse "
+    "by later inception sessions (0 = disabled, every session connects).",
+    GLOBAL_VAR(inception::opt_conn_pool_max_idle), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 1024), DEFAULT(8), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_conn_pool_idle_timeout(
+    "inception_conn_pool_idle_timeout",
+    "Seconds an idle pooled remote connection is kept before it is closed.",
+    GLOBAL_VAR(inception::opt_conn_pool_idle_timeout), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 86400), DEFAULT(60), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_remote_compression(
+    "inception_remote_compression",
+    "Protocol compression of new connections to targets, replicas and the "
+    "backup server, as host:port=algorithm[:level];...;algorithm[:level] "
+    "where the entry without a target applies to the others. Algorithms: "
+    "zstd (level 1-22), zlib, off. A server without the algorithm is "
+    "connected uncompressed. Empty = uncompressed.",
+    GLOBAL_VAR(inception::opt_remote_compression), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+/* ---- Background jobs ---- */
+
+static Sys_var_ulong Sys_inception_job_workers(
+    "inception_job_workers",
+    "Max number of server threads running --enable-async background jobs "
+    "at the same time; further jobs wait in the queue.",
+    GLOBAL_VAR(inception::opt_job_workers), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_job_history(
+    "inception_job_history",
+    "Number of finished background jobs whose results are kept for "
+    "inception get results; the oldest are dropped first.",
+    GLOBAL_VAR(inception::opt_job_history), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 100000), DEFAULT(100), BLOCK_SIZE(1));
+
+/* ---- Multi-target fan-out ---- */
+
+static Sys_var_ulong Sys_inception_exec_fanout_workers(
+    "inception_exec_fanout_workers",
+    "Max number of --targets shards one EXECUTE batch runs on at the same "
+    "time; the other shards wait for a free worker.",
+    GLOBAL_VAR(inception::opt_exec_fanout_workers), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 256), DEFAULT(8), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_parallel_per_target(
+    "inception_exec_parallel_per_target",
+    "Max number of --enable-parallel lanes (statement groups on unrelated "
+    "tables) one EXECUTE batch runs on its target at the same time.",
+    GLOBAL_VAR(inception::opt_exec_parallel_per_target), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_tidb_ddl_concurrency(
+    "inception_exec_tidb_ddl_concurrency",
+    "Max number of DDL jobs one EXECUTE batch on a TiDB 6.2+ target keeps "
+    "running at the same time, each on its own connection; DDL on unrelated "
+    "tables is submitted side by side. 0 = one at a time.",
+    GLOBAL_VAR(inception::opt_exec_tidb_ddl_concurrency), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_tidb_ddl_reorg_threads(
+    "inception_exec_tidb_ddl_reorg_threads",
+    "Reorg worker threads of each DDL job a batch runs on a TiDB 8.3+ "
+    "target (ADMIN ALTER DDL JOBS ... THREAD). 0 = tidb_ddl_reorg_worker_cnt.",
+    GLOBAL_VAR(inception::opt_exec_tidb_ddl_reorg_threads), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 256), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_exec_tidb_ddl_reorg_batch_size(
+    "inception_exec_tidb_ddl_reorg_batch_size",
+    "Reorg batch size of each DDL job a batch runs on a TiDB 8.3+ target "
+    "(ADMIN ALTER DDL JOBS ... BATCH_SIZE). 0 = tidb_ddl_reorg_batch_size.",
+    GLOBAL_VAR(inception::opt_exec_tidb_ddl_reorg_batch_size),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 10240), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_target_groups(
+    "inception_target_groups",
+    "Named shard lists for --target-group, as "
+    "name=host:port,host:port;name2=host:port,... Empty = none.",
+    GLOBAL_VAR(inception::opt_target_groups), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
 /* ---- Options ---- */
 
 static Sys_var_bool Sys_inception_osc_on(
     "inception_osc_on",
-    "Enable pt-online-schema-change for ALTER TABLE.",
+    "Run ALTER TABLE statements predicted as COPY through the built-in "
+    "online schema change (ghost table + binlog replay + atomic cut-over).",
     GLOBAL_VAR(inception::opt_osc_on), CMD_LINE(OPT_ARG),
     DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
     ON_UPDATE(nullptr));
 
+static Sys_var_ulong Sys_inception_osc_chunk_size(
+    "inception_osc_chunk_size",
+    "Rows copied from the original table to the ghost table per chunk.",
+    GLOBAL_VAR(inception::opt_osc_chunk_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 1000000), DEFAULT(1000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_osc_lock_wait_timeout(
+    "inception_osc_lock_wait_timeout",
+    "Seconds the cut-over waits for its table locks before backing off "
+    "and retrying.",
+    GLOBAL_VAR(inception::opt_osc_lock_wait_timeout), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 3600), DEFAULT(3), BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_inception_osc_drop_old_table(
+    "inception_osc_drop_old_table",
+    "Drop the original table (renamed to _<table>_del) after the cut-over.",
+    GLOBAL_VAR(inception::opt_osc_drop_old_table), CMD_LINE(OPT_ARG),
+    DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_bool Sys_inception_osc_defer_indexes(
+    "inception_osc_defer_indexes",
+    "Drop the non-unique secondary indexes of the ghost table before the "
+    "row copy and add them back in one sorted, online index build "
+    "afterwards.",
+    GLOBAL_VAR(inception::opt_osc_defer_indexes), CMD_LINE(OPT_ARG),
+    DEFAULT(true), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_inception_osc_min_table_size(
+    "inception_osc_min_table_size",
+    "With inception_osc_on, a COPY ALTER goes through the online schema "
+    "change only if the table has at least this many MB of data and "
+    "indexes, or at least inception_osc_min_table_rows rows. 0 = always.",
+    GLOBAL_VAR(inception::opt_osc_min_table_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(100), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_osc_min_table_rows(
+    "inception_osc_min_table_rows",
+    "Row estimate from which a COPY ALTER goes through the online schema "
+    "change regardless of inception_osc_min_table_size. 0 = always.",
+    GLOBAL_VAR(inception::opt_osc_min_table_rows), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 4294967295UL), DEFAULT(1000000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_ddl_rebuild_speed(
+    "inception_ddl_rebuild_speed",
+    "MB per second the target rebuilds or copies a table at; used for the "
+    "estimated_time of ALTER TABLE statements until executed ALTERs have "
+    "measured the target.",
+    GLOBAL_VAR(inception::opt_ddl_rebuild_speed), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 100000), DEFAULT(50), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_replica_apply_speed(
+    "inception_replica_apply_speed",
+    "MB of row events per second a replica of the target applies; used by "
+    "inception_check_dml_binlog_size until executed UPDATE/DELETE "
+    "statements have measured the target.",
+    GLOBAL_VAR(inception::opt_replica_apply_speed), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 100000), DEFAULT(10), BLOCK_SIZE(1));
+
+/* ---- Replica verification (--enable-verify) ---- */
+
+static Sys_var_ulong Sys_inception_verify_workers(
+    "inception_verify_workers",
+    "Threads checksumming key ranges on the target and the --slave-hosts "
+    "replicas after a batch run with --enable-verify.",
+    GLOBAL_VAR(inception::opt_verify_workers), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_verify_chunk_size(
+    "inception_verify_chunk_size",
+    "Rows per primary-key range checksummed by --enable-verify.",
+    GLOBAL_VAR(inception::opt_verify_chunk_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_verify_max_chunks_per_sec(
+    "inception_verify_max_chunks_per_sec",
+    "Key ranges --enable-verify checksums per second over all its threads "
+    "(0 = unlimited).",
+    GLOBAL_VAR(inception::opt_verify_max_chunks_per_sec), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 100000), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_verify_wait_timeout(
+    "inception_verify_wait_timeout",
+    "Seconds --enable-verify waits for the replicas to execute the GTIDs "
+    "of the target before comparing checksums.",
+    GLOBAL_VAR(inception::opt_verify_wait_timeout), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 3600), DEFAULT(60), BLOCK_SIZE(1));
+
+/* ---- Column data checks on a replica (inception_check_column_data) ---- */
+
+static Sys_var_ulong Sys_inception_column_data_workers(
+    "inception_column_data_workers",
+    "Threads scanning key ranges of one table on the replica for "
+    "inception_check_column_data.",
+    GLOBAL_VAR(inception::opt_column_data_workers), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_column_data_chunk_size(
+    "inception_column_data_chunk_size",
+    "Rows per primary-key range scanned by inception_check_column_data.",
+    GLOBAL_VAR(inception::opt_column_data_chunk_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 10000000), DEFAULT(10000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_column_data_max_chunks_per_sec(
+    "inception_column_data_max_chunks_per_sec",
+    "Key ranges inception_check_column_data scans per second over all its "
+    "threads (0 = unlimited).",
+    GLOBAL_VAR(inception::opt_column_data_max_chunks_per_sec),
+    CMD_LINE(OPT_ARG), VALID_RANGE(0, 100000), DEFAULT(20), BLOCK_SIZE(1));
+
 static Sys_var_charptr Sys_inception_osc_bin_dir(
     "inception_osc_bin_dir",
-    "Directory containing pt-online-schema-change binary.",
+    "Directory containing pt-online-schema-change binary "
+    "(unused by the built-in engine).",
     GLOBAL_VAR(inception::opt_osc_bin_dir), CMD_LINE(OPT_ARG),
     IN_FS_CHARSET, DEFAULT(nullptr));
 
@@ -522,12 +1278,101 @@ static Sys_var_charptr Sys_inception_must_have_columns(
     GLOBAL_VAR(inception::opt_must_have_columns), CMD_LINE(OPT_ARG),
     IN_FS_CHARSET, DEFAULT(nullptr));
 
+static Sys_var_charptr Sys_inception_rule_profiles(
+    "inception_rule_profiles",
+    "File of named rule profiles for the --profile option of "
+    "inception_magic_start: [name] sections of inception_check_* = value "
+    "lines overriding the global rule variables. Re-read when changed or "
+    "on 'inception reload rule_profiles'. Empty = no profiles.",
+    GLOBAL_VAR(inception::opt_rule_profiles), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_resource_group(
+    "inception_resource_group",
+    "USER resource group that connections running an inception session, "
+    "and the background threads inception starts, are bound to (CPU "
+    "affinity and thread priority). Empty = none.",
+    GLOBAL_VAR(inception::opt_resource_group), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_split_dir(
+    "inception_split_dir",
+    "Directory SPLIT sessions with --enable-split-files write their groups "
+    "to, one <batch>_<id>.sql file each, instead of returning the "
+    "statements. Empty = --enable-split-files not allowed.",
+    GLOBAL_VAR(inception::opt_split_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
 static Sys_var_charptr Sys_inception_audit_log(
     "inception_audit_log",
     "Path to inception operation audit log file. Empty = disabled.",
     GLOBAL_VAR(inception::opt_audit_log), CMD_LINE(OPT_ARG),
     IN_FS_CHARSET, DEFAULT(nullptr));
 
+static Sys_var_ulong Sys_inception_audit_log_buffer_size(
+    "inception_audit_log_buffer_size",
+    "Max bytes of audit log records waiting for the writer thread. "
+    "Records beyond this are dropped and counted instead of blocking.",
+    GLOBAL_VAR(inception::opt_audit_log_buffer_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(65536, 1024UL * 1024 * 1024), DEFAULT(8UL * 1024 * 1024),
+    BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_audit_log_sync_interval(
+    "inception_audit_log_sync_interval",
+    "Milliseconds between group fsync calls of the audit log "
+    "(0 = never fsync, only flush to the OS).",
+    GLOBAL_VAR(inception::opt_audit_log_sync_interval), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 60000), DEFAULT(1000), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_audit_log_rotate_size(
+    "inception_audit_log_rotate_size",
+    "Rotate the audit log when it reaches this many bytes (0 = disabled).",
+    GLOBAL_VAR(inception::opt_audit_log_rotate_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, ULONG_MAX), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_audit_log_rotate_interval(
+    "inception_audit_log_rotate_interval",
+    "Rotate the audit log after this many seconds (0 = disabled).",
+    GLOBAL_VAR(inception::opt_audit_log_rotate_interval), CMD_LINE(OPT_ARG),
+    VALID_RANGE(0, 31536000), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_audit_sink(
+    "inception_audit_sink",
+    "Collector the audit log records are also shipped to, as batches of "
+    "JSON lines POSTed to http://host[:port]/path. Empty = disabled.",
+    GLOBAL_VAR(inception::opt_audit_sink), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_audit_sink_batch_size(
+    "inception_audit_sink_batch_size",
+    "Max audit log records shipped in one request to inception_audit_sink.",
+    GLOBAL_VAR(inception::opt_audit_sink_batch_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 100000), DEFAULT(500), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_inception_audit_sink_buffer_size(
+    "inception_audit_sink_buffer_size",
+    "Max bytes of audit log records waiting in memory for the shipper "
+    "thread. Records beyond this go to inception_audit_sink_spool_dir, or "
+    "are dropped and counted when it is not set.",
+    GLOBAL_VAR(inception::opt_audit_sink_buffer_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(65536, 1024UL * 1024 * 1024), DEFAULT(8UL * 1024 * 1024),
+    BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_inception_audit_sink_compress(
+    "inception_audit_sink_compress",
+    "Send the request bodies to inception_audit_sink gzip compressed.",
+    GLOBAL_VAR(inception::opt_audit_sink_compress), CMD_LINE(OPT_ARG),
+    DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr),
+    ON_UPDATE(nullptr));
+
+static Sys_var_charptr Sys_inception_audit_sink_spool_dir(
+    "inception_audit_sink_spool_dir",
+    "Directory (must exist) where audit log records wait on disk while "
+    "inception_audit_sink is unreachable or slower than the sessions. "
+    "Empty = keep them in memory only.",
+    GLOBAL_VAR(inception::opt_audit_sink_spool_dir), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
 /* ---- Connection defaults ---- */
 
 static Sys_var_charptr Sys_inception_user(
@@ -549,3 +1394,61 @@ static Sys_var_charptr Sys_inception_password_encrypt_key(
     "Also used by 'inception get encrypt_password' command.",
     GLOBAL_VAR(inception::opt_inception_password_encrypt_key), CMD_LINE(OPT_ARG),
     IN_FS_CHARSET, DEFAULT(nullptr));
+
+/* ---- Backup server ---- */
+
+static Sys_var_charptr Sys_inception_backup_host(
+    "inception_backup_host",
+    "MySQL server that stores rollback statements (--enable-remote-backup). "
+    "Empty = the execution target itself.",
+    GLOBAL_VAR(inception::opt_backup_host), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_backup_port(
+    "inception_backup_port",
+    "Port of inception_backup_host.",
+    GLOBAL_VAR(inception::opt_backup_port), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 65535), DEFAULT(3306), BLOCK_SIZE(1));
+
+static Sys_var_charptr Sys_inception_backup_user(
+    "inception_backup_user",
+    "User for inception_backup_host.",
+    GLOBAL_VAR(inception::opt_backup_user), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_charptr Sys_inception_backup_password(
+    "inception_backup_password",
+    "Password for inception_backup_host. "
+    "Supports AES-encrypted value with 'AES:' prefix.",
+    GLOBAL_VAR(inception::opt_backup_password), CMD_LINE(OPT_ARG),
+    IN_FS_CHARSET, DEFAULT(nullptr));
+
+static Sys_var_ulong Sys_inception_backup_threads(
+    "inception_backup_threads",
+    "Threads that decode the binlog for rollback generation. The executed "
+    "statements are split into contiguous ranges of about the same number "
+    "of rows, each read by its own binlog stream.",
+    GLOBAL_VAR(inception::opt_backup_threads), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 64), DEFAULT(4), BLOCK_SIZE(1));
+
+/* Where the before images of UPDATE/DELETE come from */
+static const char *inception_backup_strategy_names[] = {"BINLOG", "SELECT",
+                                                        NullS};
+
+static Sys_var_enum Sys_inception_backup_strategy(
+    "inception_backup_strategy",
+    "How rollback statements of UPDATE and DELETE are made. BINLOG decodes "
+    "the target's binlog after the batch; SELECT reads the rows a "
+    "single-table UPDATE/DELETE will change with SELECT ... FOR UPDATE in "
+    "primary key order inside the statement's transaction, for targets "
+    "whose binlog cannot be read. INSERTs are always backed up from the "
+    "binlog.",
+    GLOBAL_VAR(inception::opt_backup_strategy), CMD_LINE(OPT_ARG),
+    inception_backup_strategy_names, DEFAULT(0));
+
+static Sys_var_ulong Sys_inception_backup_select_chunk_size(
+    "inception_backup_select_chunk_size",
+    "Rows read per SELECT ... FOR UPDATE when inception_backup_strategy is "
+    "SELECT; the load throttle runs between chunks.",
+    GLOBAL_VAR(inception::opt_backup_select_chunk_size), CMD_LINE(OPT_ARG),
+    VALID_RANGE(1, 1000000), DEFAULT(1000), BLOCK_SIZE(1));
@@ -43,6 +43,9 @@ extern ulong opt_check_autoincrement;
 extern ulong opt_check_partition;
 extern ulong opt_check_orderby_in_dml;
 extern ulong opt_check_orderby_rand;
+extern ulong opt_check_dml_full_scan;
+extern ulong opt_check_dml_filesort;
+extern ulong opt_check_dml_binlog_size;
 extern ulong opt_check_autoincrement_init_value;
 extern ulong opt_check_autoincrement_name;
 extern ulong opt_check_timestamp_default;
@@ -50,9 +53,11 @@ extern ulong opt_check_column_charset;
 extern ulong opt_check_column_default_value;
 extern ulong opt_check_identifier_keyword;
 extern ulong opt_check_merge_alter_table;
+extern ulong opt_check_column_position_rebuild;
 extern ulong opt_check_varchar_shrink;
 extern ulong opt_check_lossy_type_change;
 extern ulong opt_check_decimal_change;
+extern ulong opt_check_column_data;
 
 /* TiDB-specific audit rule variables (0=OFF, 1=WARNING, 2=ERROR) */
 extern ulong opt_check_tidb_merge_alter;
@@ -74,6 +79,8 @@ extern ulong opt_check_must_have_columns;
 extern ulong opt_check_max_indexes;
 extern ulong opt_check_max_index_parts;
 extern ulong opt_check_max_update_rows;
+extern ulong opt_check_explain_min_rows;
+extern ulong opt_check_max_dml_binlog_size;
 extern ulong opt_check_max_char_length;
 extern ulong opt_check_max_primary_key_parts;
 extern ulong opt_check_max_table_name_length;
@@ -86,22 +93,132 @@ extern ulong opt_check_in_count;
 /* Execution throttle variables */
 extern ulong opt_exec_max_threads_running;
 extern ulong opt_exec_max_replication_delay;
+extern ulong opt_exec_max_history_list_length;
+extern ulong opt_exec_load_sample_interval_ms;
+extern ulong opt_exec_max_checkpoint_age_pct;
+extern ulong opt_exec_max_statement_p99_ms;
+extern bool opt_exec_adaptive_throttle;
+extern ulong opt_exec_adaptive_max_pause_ms;
 extern bool opt_exec_check_read_only;
+extern ulong opt_exec_chunk_size;
+extern ulong opt_exec_tidb_batch_min_rows;
+extern ulong opt_exec_batch_statements;
+extern ulong opt_exec_batch_bytes;
+extern bool opt_exec_merge_inserts;
+extern ulong opt_exec_prepare_min_repeats;
+extern ulong opt_exec_max_sessions_per_target;
+extern ulong opt_exec_max_ddl_per_target;
+extern ulong opt_check_max_sessions_per_target;
+extern ulong opt_check_max_queries_per_target;
+extern ulong opt_exec_max_rows_per_sec;
+extern ulong opt_exec_max_statements_per_sec;
+extern ulong opt_exec_ddl_lock_wait_timeout;
+extern ulong opt_exec_ddl_lock_retries;
+extern ulong opt_exec_online_alter_fallback; /* 0=ERROR, 1=OSC, 2=COPY */
+extern bool opt_exec_partition_rebuild;
+extern ulong opt_exec_monitor_max_threads_running;
+extern ulong opt_exec_monitor_max_replication_delay;
+extern bool opt_exec_monitor_abort;
+extern bool opt_exec_progress;
+extern char *opt_exec_heartbeat_table;
+extern char *opt_exec_checkpoint_dir;
+extern char *opt_shadow_schema_dir;
+extern char *opt_script_dir;
+extern ulong opt_exec_heartbeat_interval_ms;
+
+/* Remote metadata cache */
+extern ulong opt_metadata_cache_ttl;
+extern ulong opt_metadata_cache_max_tables;
+extern bool opt_metadata_prefetch;
+extern ulong opt_audit_host_max_lag;
+extern char *opt_metadata_warm_schemas;
+extern char *opt_metadata_snapshot_dir;
+extern char *opt_shared_cache_host;
+extern ulong opt_shared_cache_port;
+extern char *opt_shared_cache_user;
+extern char *opt_shared_cache_password;
+extern ulong opt_audit_memo_size;
+extern ulong opt_audit_cache_size;
+extern ulong opt_insert_stream_min_size;
+extern ulong opt_query_tree_cache_size;
+extern ulong opt_result_spool_size;
+extern ulong opt_max_session_memory;
+extern ulong opt_result_keep_time;
+extern ulong opt_result_keep_size;
+
+/* Remote connection pool */
+extern ulong opt_conn_pool_max_idle;
+extern ulong opt_conn_pool_idle_timeout;
+extern char *opt_remote_compression;
+
+/* Background jobs */
+extern ulong opt_job_workers;
+extern ulong opt_job_history;
+
+/* Multi-target fan-out */
+extern ulong opt_exec_fanout_workers;
+extern ulong opt_exec_parallel_per_target;
+extern ulong opt_exec_tidb_ddl_concurrency;
+extern ulong opt_exec_tidb_ddl_reorg_threads;
+extern ulong opt_exec_tidb_ddl_reorg_batch_size;
+extern char *opt_target_groups;
 
 /* Boolean options (not audit rules) */
 extern bool opt_osc_on;
 
+/* Online schema change engine */
+extern ulong opt_osc_chunk_size;
+extern ulong opt_osc_lock_wait_timeout;
+extern bool opt_osc_drop_old_table;
+extern bool opt_osc_defer_indexes;
+extern ulong opt_osc_min_table_size;
+extern ulong opt_osc_min_table_rows;
+extern ulong opt_ddl_rebuild_speed;
+extern ulong opt_replica_apply_speed;
+extern ulong opt_verify_workers;
+extern ulong opt_verify_chunk_size;
+extern ulong opt_verify_max_chunks_per_sec;
+extern ulong opt_verify_wait_timeout;
+extern ulong opt_column_data_workers;
+extern ulong opt_column_data_chunk_size;
+extern ulong opt_column_data_max_chunks_per_sec;
+
 /* String options */
 extern char *opt_osc_bin_dir;
 extern char *opt_support_charset;
 extern char *opt_must_have_columns;
+extern char *opt_rule_profiles;
+extern char *opt_resource_group;
+extern char *opt_split_dir;
 extern char *opt_audit_log;
 
+/* Audit log writer */
+extern ulong opt_audit_log_buffer_size;
+extern ulong opt_audit_log_sync_interval;
+extern ulong opt_audit_log_rotate_size;
+extern ulong opt_audit_log_rotate_interval;
+
+/* Audit log shipping to an external sink */
+extern char *opt_audit_sink;
+extern ulong opt_audit_sink_batch_size;
+extern ulong opt_audit_sink_buffer_size;
+extern bool opt_audit_sink_compress;
+extern char *opt_audit_sink_spool_dir;
+
 /* Connection defaults */
 extern char *opt_inception_user;
 extern char *opt_inception_password;
 extern char *opt_inception_password_encrypt_key;
 
+/* Backup server (rollback statements) */
+extern char *opt_backup_host;
+extern ulong opt_backup_port;
+extern char *opt_backup_user;
+extern char *opt_backup_password;
+extern ulong opt_backup_threads;
+extern ulong opt_backup_strategy; /* 0=BINLOG, 1=SELECT */
+extern ulong opt_backup_select_chunk_size;
+
 }  // namespace inception
 
 #endif  // SQL_INCEPTION_SYSVARS_H
@@ -3,15 +3,23 @@
  * @brief Query tree extraction — walk MySQL 8.0 parser AST to JSON.
  *
  * Supports SELECT, INSERT, UPDATE, DELETE (+ UNION, subqueries, JOIN,
- * SELECT * expansion via remote schema).
+ * SELECT * expanded from the shared metadata cache of the target).
+ *
+ * Trees are cached server-wide by statement digest, default database and
+ * target (inception_query_tree_cache_size), so that the shapes a gateway
+ * sends over and over are walked, and their SELECT * expanded, once.
  */
 
 #include "sql/inception/inception_tree.h"
 #include "sql/inception/inception_context.h"
 #include "sql/inception/inception_audit.h"       // get_remote_conn
-#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_cache.h"       // get_table_meta, cache_target
+#include "sql/inception/inception_json.h"
+#include "sql/inception/inception_status.h"
+#include "sql/inception/inception_sysvars.h"
 
 #include "sql/sql_class.h"       // THD
+#include "sql/sql_digest.h"      // compute_digest_hash, sql_digest_storage
 #include "sql/sql_lex.h"         // LEX, Query_block, Query_expression
 #include "sql/sql_insert.h"      // Sql_cmd_insert_base
 #include "sql/sql_update.h"      // Sql_cmd_update
@@ -24,11 +32,15 @@
 #include "sql/table.h"           // TABLE_LIST, ORDER
 #include "include/mysql.h"       // MYSQL C API
 
+#include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <list>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace inception {
@@ -52,99 +64,71 @@ struct TableRef {
 };
 
 /* ================================================================
- *  JSON helpers (hand-rolled, no library dependency)
+ *  JSON output
  * ================================================================ */
 
-static std::string json_escape(const std::string &s) {
-  std::string out;
-  out.reserve(s.size() + 8);
-  for (char c : s) {
-    switch (c) {
-      case '"':  out += "\\\""; break;
-      case '\\': out += "\\\\"; break;
-      case '\n': out += "\\n";  break;
-      case '\r': out += "\\r";  break;
-      case '\t': out += "\\t";  break;
-      default:
-        if (static_cast<unsigned char>(c) < 0x20) {
-          char buf[8];
-          snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)c);
-          out += buf;
-        } else {
-          out += c;
-        }
-    }
-  }
-  return out;
-}
-
-static std::string json_str(const std::string &s) {
-  return "\"" + json_escape(s) + "\"";
-}
-
-static std::string column_ref_to_json(const ColumnRef &col) {
-  std::string j = "{";
-  j += "\"db\":" + json_str(col.db);
-  j += ",\"table\":" + json_str(col.table);
-  j += ",\"column\":" + json_str(col.column);
+static void column_ref_to_json(JsonWriter &w, const ColumnRef &col) {
+  w.begin_object();
+  w.key("db");
+  w.value(col.db);
+  w.key("table");
+  w.value(col.table);
+  w.key("column");
+  w.value(col.column);
   if (!col.expanded.empty()) {
-    j += ",\"expanded\":[";
-    for (size_t i = 0; i < col.expanded.size(); i++) {
-      if (i > 0) j += ",";
-      j += json_str(col.expanded[i]);
-    }
-    j += "]";
+    w.key("expanded");
+    w.begin_array();
+    for (const auto &name : col.expanded) w.value(name);
+    w.end_array();
   }
-  j += "}";
-  return j;
+  w.end_object();
 }
 
-static std::string column_refs_to_json(const std::vector<ColumnRef> &cols) {
-  std::string j = "[";
-  for (size_t i = 0; i < cols.size(); i++) {
-    if (i > 0) j += ",";
-    j += column_ref_to_json(cols[i]);
-  }
-  j += "]";
-  return j;
-}
-
-static std::string table_ref_to_json(const TableRef &tbl) {
-  std::string j = "{";
-  j += "\"db\":" + json_str(tbl.db);
-  j += ",\"table\":" + json_str(tbl.table);
-  j += ",\"alias\":" + json_str(tbl.alias);
-  j += ",\"type\":" + json_str(tbl.type);
-  j += "}";
-  return j;
+static void table_ref_to_json(JsonWriter &w, const TableRef &tbl) {
+  w.begin_object();
+  w.key("db");
+  w.value(tbl.db);
+  w.key("table");
+  w.value(tbl.table);
+  w.key("alias");
+  w.value(tbl.alias);
+  w.key("type");
+  w.value(tbl.type);
+  w.end_object();
 }
 
 static std::string build_json(
     const char *sql_type,
     const std::vector<TableRef> &tables,
     const std::map<std::string, std::vector<ColumnRef>> &columns) {
-  std::string j = "{";
-  j += "\"sql_type\":" + json_str(sql_type);
-
-  /* tables */
-  j += ",\"tables\":[";
-  for (size_t i = 0; i < tables.size(); i++) {
-    if (i > 0) j += ",";
-    j += table_ref_to_json(tables[i]);
-  }
-  j += "]";
-
-  /* columns */
-  j += ",\"columns\":{";
-  bool first = true;
+  /* Room for the usual document in one allocation */
+  size_t refs = tables.size();
+  for (const auto &kv : columns) refs += kv.second.size();
+  std::string j;
+  j.reserve(64 + 80 * refs);
+
+  JsonWriter w(&j);
+  w.begin_object();
+  w.key("sql_type");
+  w.value(sql_type);
+
+  w.key("tables");
+  w.begin_array();
+  for (const auto &tbl : tables) table_ref_to_json(w, tbl);
+  w.end_array();
+
+  w.key("columns");
+  w.begin_object();
   for (const auto &kv : columns) {
-    if (!first) j += ",";
-    first = false;
-    j += json_str(kv.first) + ":" + column_refs_to_json(kv.second);
+    /* Keys are the fixed usage names ("select", "where", ...) */
+    w.key(kv.first.c_str());
+    w.begin_array();
+    for (const auto &col : kv.second) column_ref_to_json(w, col);
+    w.end_array();
   }
-  j += "}";
+  w.end_object();
 
-  j += "}";
+  w.end_object();
   return j;
 }
 
@@ -280,35 +264,59 @@ static void walk_item(Item *item, Query_block *qb, const char *default_db,
 }
 
 /* ================================================================
- *  SELECT * expansion via remote schema
+ *  SELECT * expansion via the metadata cache
  * ================================================================ */
 
 /**
- * Query remote information_schema.COLUMNS to get all column names for a table.
+ * Column names of db.table in ordinal order, from the shared metadata cache
+ * (or the --schema-file catalog). Counts the lookup in
+ * ctx->tree_star_lookups, and sets tree_star_failed when the target could
+ * not answer.
  */
 static bool expand_star_columns(InceptionContext *ctx,
                                 const char *db, const char *table,
                                 std::vector<std::string> &cols) {
+  ctx->tree_star_lookups++;
   MYSQL *mysql = get_remote_conn(ctx);
-  if (!mysql || !db || !table) return false;
-
-  char query[512];
-  snprintf(query, sizeof(query), remote_sql::GET_TABLE_COLUMNS, db, table);
-
-  if (mysql_real_query(mysql, query, static_cast<unsigned long>(strlen(query))))
+  TableMetaPtr meta =
+      (db && table) ? get_table_meta(ctx, mysql, db, table) : nullptr;
+  if (!meta) {
+    ctx->tree_star_failed = true;
     return false;
-
-  MYSQL_RES *res = mysql_store_result(mysql);
-  if (!res) return false;
-
-  MYSQL_ROW row;
-  while ((row = mysql_fetch_row(res))) {
-    if (row[0]) cols.push_back(row[0]);
   }
-  mysql_free_result(res);
+  cols = meta->column_order;
   return !cols.empty();
 }
 
+/**
+ * Load the tables of every UNION member with a * in its select list in
+ * one round trip, so that expand_star_columns() finds them all cached.
+ */
+static void preload_star_tables(THD *thd, InceptionContext *ctx) {
+  const char *default_db = thd->db().str;
+  Query_expression *unit = thd->lex->unit;
+  if (!unit) return;
+  std::vector<SchemaTable> refs;
+  for (Query_block *qb = unit->first_query_block(); qb;
+       qb = qb->next_query_block()) {
+    bool star = false;
+    for (Item *item : qb->fields) {
+      if (item->type() == Item::FIELD_ITEM &&
+          down_cast<Item_field *>(item)->is_asterisk())
+        star = true;
+    }
+    if (!star) continue;
+    for (TABLE_LIST *tbl = qb->table_list.first; tbl; tbl = tbl->next_local) {
+      const char *db = tbl->db ? tbl->db : default_db;
+      if (tbl->is_derived() || !db || !tbl->table_name) continue;
+      refs.emplace_back(db, tbl->table_name);
+    }
+  }
+  if (refs.size() < 2) return;
+  MYSQL *mysql = get_remote_conn(ctx);
+  if (mysql) preload_table_meta(ctx, mysql, refs);
+}
+
 /* ================================================================
  *  Table extraction
  * ================================================================ */
@@ -551,6 +559,7 @@ static std::string handle_select(THD *thd, InceptionContext *ctx) {
   std::map<std::string, std::vector<ColumnRef>> columns;
 
   /* Process main query block + UNION blocks */
+  preload_star_tables(thd, ctx);
   Query_expression *unit = lex->unit;
   if (unit) {
     for (Query_block *qb = unit->first_query_block(); qb;
@@ -769,11 +778,7 @@ static std::string handle_other(THD *thd) {
   return build_json(type_name.c_str(), tables, columns);
 }
 
-/* ================================================================
- *  Public entry point
- * ================================================================ */
-
-std::string extract_query_tree(THD *thd, InceptionContext *ctx) {
+static std::string build_query_tree(THD *thd, InceptionContext *ctx) {
   LEX *lex = thd->lex;
 
   switch (lex->sql_command) {
@@ -799,4 +804,122 @@ std::string extract_query_tree(THD *thd, InceptionContext *ctx) {
   }
 }
 
+/* ================================================================
+ *  Tree cache
+ * ================================================================ */
+
+namespace {
+
+struct TreeEntry {
+  std::string json;
+  /* SELECT * expanded from the target: valid while the target's schema
+     epoch is unchanged, then for inception_metadata_cache_ttl seconds
+     unless the binlog watcher streamed when it was built */
+  bool remote = false;
+  bool watched = false;
+  uint64_t epoch = 0;
+  std::chrono::steady_clock::time_point loaded_at;
+};
+
+using TreeList = std::list<std::pair<std::string, TreeEntry>>;
+
+InceptionMutex g_tree_mutex("query_tree_cache");
+TreeList g_trees;  /* most recently used first */
+std::unordered_map<std::string, TreeList::iterator> g_tree_index;
+
+bool tree_fresh(const TreeEntry &e, uint64_t epoch,
+                std::chrono::steady_clock::time_point now) {
+  if (!e.remote) return true;
+  if (e.epoch != epoch) return false;
+  return e.watched ||
+         now - e.loaded_at < std::chrono::seconds(opt_metadata_cache_ttl);
+}
+
+}  // namespace
+
+/**
+ * "<digest hash>|<default db>|<target>", or empty when the statement has
+ * no complete digest (digests stop at max_digest_length, and the trees of
+ * two long statements with the same prefix differ).
+ */
+static std::string tree_cache_key(THD *thd, const std::string &target) {
+  if (!thd->m_digest) return std::string();
+  const sql_digest_storage *digest = &thd->m_digest->m_digest_storage;
+  if (digest->m_byte_count == 0 || digest->m_full) return std::string();
+
+  unsigned char hash[DIGEST_HASH_SIZE];
+  compute_digest_hash(digest, hash);
+  std::string key(reinterpret_cast<const char *>(hash), DIGEST_HASH_SIZE);
+  key += '|';
+  if (thd->db().str) key += thd->db().str;
+  key += '|';
+  key += target;
+  return key;
+}
+
+/* ================================================================
+ *  Public entry point
+ * ================================================================ */
+
+std::string extract_query_tree(THD *thd, InceptionContext *ctx) {
+  StatementMetaScope statement_meta(ctx);
+  const std::string target = cache_target(ctx);
+  /* --schema-file trees expand * from the session's own catalog */
+  const std::string key = opt_query_tree_cache_size > 0 && !ctx->shadow
+                              ? tree_cache_key(thd, target)
+                              : std::string();
+  if (key.empty()) return build_query_tree(thd, ctx);
+
+  /* Read before walking: DDL seen meanwhile makes the new entry stale */
+  bool watched = false;
+  const uint64_t epoch = cache_schema_epoch(target, &watched);
+  const auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<InceptionMutex> lock(g_tree_mutex);
+    auto it = g_tree_index.find(key);
+    if (it != g_tree_index.end()) {
+      if (tree_fresh(it->second->second, epoch, now)) {
+        g_trees.splice(g_trees.begin(), g_trees, it->second);
+        status_add(STATUS_QUERY_TREE_CACHE_HITS);
+        return it->second->second.json;
+      }
+      g_trees.erase(it->second);
+      g_tree_index.erase(it);
+    }
+  }
+
+  status_add(STATUS_QUERY_TREE_CACHE_MISSES);
+  ctx->tree_star_lookups = 0;
+  ctx->tree_star_failed = false;
+  std::string json = build_query_tree(thd, ctx);
+
+  TreeEntry entry;
+  entry.remote = ctx->tree_star_lookups > 0;
+  entry.watched = watched;
+  entry.epoch = epoch;
+  entry.loaded_at = now;
+  /* Keep no tree the target could not complete, nor one that would be
+     stale at once */
+  if (ctx->tree_star_failed ||
+      (entry.remote && !watched && opt_metadata_cache_ttl == 0))
+    return json;
+  entry.json = json;
+
+  std::lock_guard<InceptionMutex> lock(g_tree_mutex);
+  auto it = g_tree_index.find(key);
+  if (it != g_tree_index.end()) {
+    /* Walked by another session meanwhile */
+    it->second->second = std::move(entry);
+    g_trees.splice(g_trees.begin(), g_trees, it->second);
+  } else {
+    g_trees.emplace_front(key, std::move(entry));
+    g_tree_index[key] = g_trees.begin();
+  }
+  while (g_trees.size() > opt_query_tree_cache_size) {
+    g_tree_index.erase(g_trees.back().first);
+    g_trees.pop_back();
+  }
+  return json;
+}
+
 }  // namespace inception
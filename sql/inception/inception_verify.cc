@@ -0,0 +1,444 @@
+/**
+ * @file inception_verify.cc
+ * @brief Chunked checksums of the written tables on the replicas.
+ */
+
+#include "sql/inception/inception_verify.h"
+
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_exec.h"  // ChunkPacer, query_one_row
+#include "sql/inception/inception_pool.h"
+#include "sql/inception/inception_remote_sql.h"
+#include "sql/inception/inception_resgroup.h"
+#include "sql/inception/inception_sysvars.h"
+
+#include "my_thread.h"  // my_thread_init, my_thread_end
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace inception {
+
+/* Key ranges listed in one mismatch warning */
+static const size_t MAX_REPORTED_RANGES = 5;
+
+/* Below and above any integer key, signed or not */
+static const char KEY_MIN[] = "-9223372036854775808";
+static const char KEY_MAX[] = "18446744073709551615";
+
+namespace {
+
+/** A table the batch wrote and the statement its findings go to. */
+struct Table {
+  std::string db, name;
+  SqlCacheNode *node = nullptr;
+  std::string pk_name;
+  std::string pk;        /* quoted */
+  std::string row_expr;  /* argument of CRC32() */
+  size_t chunks = 0;
+};
+
+/** One chunk: pk >= lo (the first of its table) or pk > lo, and pk <= hi. */
+struct Range {
+  size_t table;
+  std::string lo, hi;
+  bool first;
+};
+
+/** A chunk whose checksum on replica (index into the servers) differs. */
+struct Mismatch {
+  size_t range;
+  size_t replica;
+};
+
+/** What a pass of checksum_ranges() found. */
+struct PassResult {
+  std::vector<Mismatch> differ;
+  std::map<size_t, std::string> errors;  /* first error per server */
+};
+
+}  // namespace
+
+static std::string server_name(const std::pair<std::string, uint> &server) {
+  return server.first + ":" + std::to_string(server.second);
+}
+
+/** The last executed statement of each table the batch wrote. */
+static std::vector<Table> written_tables(InceptionContext *ctx) {
+  std::vector<Table> tables;
+  std::map<std::string, size_t> index;
+  for (auto &node : ctx->cache_nodes) {
+    if (node.stage != STAGE_EXECUTED || node.errlevel >= ERRLEVEL_ERROR ||
+        node.execute_seconds < 0 || node.db_name.empty() ||
+        node.table_name.empty())
+      continue;
+    switch (node.sql_command) {
+      case SQLCOM_INSERT:
+      case SQLCOM_INSERT_SELECT:
+      case SQLCOM_REPLACE:
+      case SQLCOM_REPLACE_SELECT:
+      case SQLCOM_UPDATE:
+      case SQLCOM_DELETE:
+      case SQLCOM_LOAD:
+      case SQLCOM_ALTER_TABLE:
+        break;
+      default:
+        continue;
+    }
+    const std::string key = node.db_name + "." + node.table_name;
+    auto it = index.find(key);
+    if (it == index.end()) {
+      index[key] = tables.size();
+      tables.emplace_back();
+      tables.back().db = node.db_name;
+      tables.back().name = node.table_name;
+      tables.back().node = &node;
+    } else {
+      tables[it->second].node = &node;
+    }
+  }
+  return tables;
+}
+
+/**
+ * Read the key and columns of t on the target and cut it into ranges of
+ * inception_verify_chunk_size rows. @return the reason it was skipped,
+ * empty on success.
+ */
+static std::string plan_table(MYSQL *mysql, size_t table_index, Table *t,
+                              std::vector<Range> *ranges) {
+  t->pk_name = single_integer_pk(mysql, t->db, t->name);
+  if (t->pk_name.empty()) return "it has no single integer primary key";
+  t->pk = quote_ident(t->pk_name);
+  const std::string db = quote_ident(t->db);
+  const std::string table = quote_ident(t->name);
+
+  /* CONCAT_WS() skips NULLs: one ISNULL() flag per column tells NULL
+     from an empty string */
+  std::string query =
+      format_sql(remote_sql::VERIFY_COLUMNS, t->db.c_str(), t->name.c_str());
+  if (mysql_real_query(mysql, query.c_str(),
+                       static_cast<unsigned long>(query.size())))
+    return std::string("cannot read its columns: ") + mysql_error(mysql);
+  MYSQL_RES *res = mysql_store_result(mysql);
+  if (!res) return std::string("cannot read its columns: ") + mysql_error(mysql);
+  std::string values, flags;
+  MYSQL_ROW row;
+  while ((row = mysql_fetch_row(res))) {
+    if (!row[0]) continue;
+    const std::string col = quote_ident(row[0]);
+    values += ", " + col;
+    flags += (flags.empty() ? "" : ", ") + std::string("ISNULL(") + col + ")";
+  }
+  mysql_free_result(res);
+  if (values.empty()) return "it has no columns";
+  t->row_expr = "CONCAT_WS('#'" + values + ", CONCAT(" + flags + "))";
+
+  std::vector<std::string> bounds;
+  bool found = false;
+  query = format_sql(remote_sql::CHUNK_PK_RANGE, t->pk.c_str(), t->pk.c_str(),
+                     db.c_str(), table.c_str());
+  if (query_one_row(mysql, query, &bounds, &found))
+    return std::string("cannot read its key range: ") + mysql_error(mysql);
+  if (!found) {
+    /* Empty on the target: the replicas must be empty too */
+    ranges->push_back(Range{table_index, KEY_MIN, KEY_MAX, true});
+    t->chunks = 1;
+    return "";
+  }
+  const std::string max_pk = bounds[1];
+  const size_t first_range = ranges->size();
+
+  std::string lower = bounds[0];
+  bool first = true;
+  for (;;) {
+    std::vector<std::string> boundary;
+    query = format_sql(remote_sql::CHUNK_NEXT_BOUNDARY, t->pk.c_str(),
+                       db.c_str(), table.c_str(), t->pk.c_str(),
+                       first ? ">=" : ">", lower.c_str(), t->pk.c_str(),
+                       opt_verify_chunk_size - 1);
+    if (query_one_row(mysql, query, &boundary, &found))
+      return std::string("cannot read a chunk boundary: ") +
+             mysql_error(mysql);
+    const std::string upper = found ? boundary[0] : max_pk;
+    ranges->push_back(Range{table_index, lower, upper, first});
+    t->chunks++;
+    if (!found || upper == max_pk) break;
+    lower = upper;
+    first = false;
+  }
+  /* Rows a replica has beyond the target's key range differ as well */
+  (*ranges)[first_range].lo = KEY_MIN;
+  ranges->back().hi = KEY_MAX;
+  return "";
+}
+
+/**
+ * Wait until every replica (servers[1..]) executed the GTIDs the target
+ * (servers[0]) has executed now. Without GTIDs there is nothing to wait
+ * for; a replica that does not catch up in time gets an error.
+ */
+static void sync_replicas(InceptionContext *ctx,
+                          const std::vector<std::pair<std::string, uint>> &servers,
+                          std::map<size_t, std::string> *errors) {
+  PoolConnOptions opts;
+  opts.connect_timeout = 10;
+  opts.read_timeout = static_cast<unsigned int>(opt_verify_wait_timeout + 30);
+  std::string err;
+  MYSQL *primary = pool_acquire(servers[0].first, servers[0].second,
+                                ctx->user, ctx->password, opts, &err);
+  if (!primary) {
+    (*errors)[0] = err;
+    return;
+  }
+  std::vector<std::string> row;
+  bool found = false;
+  const bool failed =
+      query_one_row(primary, remote_sql::VERIFY_GTID_EXECUTED, &row, &found);
+  if (failed) (*errors)[0] = mysql_error(primary);
+  pool_release(primary, PoolRelease::CLEAN);
+  if (failed || !found || row[0].empty()) return;
+
+  const std::string wait = format_sql(remote_sql::VERIFY_WAIT_GTID,
+                                      row[0].c_str(), opt_verify_wait_timeout);
+  for (size_t s = 1; s < servers.size(); s++) {
+    MYSQL *replica = pool_acquire(servers[s].first, servers[s].second,
+                                  ctx->user, ctx->password, opts, &err);
+    if (!replica) {
+      (*errors)[s] = err;
+      continue;
+    }
+    if (query_one_row(replica, wait, &row, &found) || !found)
+      (*errors)[s] = std::string("cannot wait for its GTIDs: ") +
+                     mysql_error(replica);
+    else if (row[0] != "0")
+      (*errors)[s] = format_sql("did not catch up with the target within %lus",
+                                opt_verify_wait_timeout);
+    pool_release(replica, PoolRelease::CLEAN);
+  }
+}
+
+/** COUNT(*) and checksum of range r of t as "rows/checksum". */
+static bool range_checksum(MYSQL *mysql, const Table &t, const Range &r,
+                           std::string *sum) {
+  const std::string db = quote_ident(t.db);
+  const std::string table = quote_ident(t.name);
+  const std::string query = format_sql(
+      remote_sql::VERIFY_CHUNK_CHECKSUM, t.row_expr.c_str(), db.c_str(),
+      table.c_str(), t.pk.c_str(), r.first ? ">=" : ">", r.lo.c_str(),
+      t.pk.c_str(), r.hi.c_str());
+  std::vector<std::string> row;
+  bool found = false;
+  if (query_one_row(mysql, query, &row, &found) || row.size() < 2) return true;
+  *sum = row[0] + "/" + row[1];
+  return false;
+}
+
+/**
+ * Checksum the ranges listed in todo on every server, on at most
+ * inception_verify_workers threads with their own connections, and
+ * collect the ranges that differ between the target and a replica.
+ */
+static PassResult checksum_ranges(
+    InceptionContext *ctx,
+    const std::vector<std::pair<std::string, uint>> &servers,
+    const std::vector<Table> &tables, const std::vector<Range> &ranges,
+    const std::vector<size_t> &todo) {
+  PassResult result;
+  std::mutex mutex;  /* guards result */
+  std::atomic<size_t> next{0};
+  ChunkPacer pacer(opt_verify_max_chunks_per_sec);
+
+  auto record_error = [&](size_t server, const std::string &err) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!result.errors.count(server)) result.errors[server] = err;
+  };
+
+  auto work = [&] {
+    const bool thread_ok = !my_thread_init();
+    if (!thread_ok) {
+      record_error(0, "cannot initialize a verification thread");
+      return;
+    }
+    bind_worker_resource_group();
+    PoolConnOptions opts;
+    opts.connect_timeout = 10;
+    std::string err;
+    std::vector<MYSQL *> conns(servers.size(), nullptr);
+    for (size_t s = 0; s < servers.size(); s++) {
+      conns[s] = pool_acquire(servers[s].first, servers[s].second, ctx->user,
+                              ctx->password, opts, &err);
+      if (!conns[s]) record_error(s, err);
+    }
+    for (;;) {
+      const size_t i = next.fetch_add(1);
+      if (i >= todo.size() || !conns[0] || pacer.wait(ctx)) break;
+      const Range &r = ranges[todo[i]];
+      const Table &t = tables[r.table];
+      std::string expected;
+      if (range_checksum(conns[0], t, r, &expected)) {
+        record_error(0, mysql_error(conns[0]));
+        continue;
+      }
+      for (size_t s = 1; s < servers.size(); s++) {
+        std::string sum;
+        if (!conns[s]) continue;
+        if (range_checksum(conns[s], t, r, &sum)) {
+          record_error(s, mysql_error(conns[s]));
+        } else if (sum != expected) {
+          std::lock_guard<std::mutex> lock(mutex);
+          result.differ.push_back(Mismatch{todo[i], s});
+        }
+      }
+    }
+    for (MYSQL *conn : conns)
+      if (conn) pool_release(conn, PoolRelease::CLEAN);
+    my_thread_end();
+  };
+
+  std::vector<std::thread> threads;
+  const size_t workers =
+      std::min(todo.size(), static_cast<size_t>(opt_verify_workers));
+  for (size_t w = 0; w < workers; w++) threads.emplace_back(work);
+  for (auto &thread : threads) thread.join();
+  return result;
+}
+
+/** "`id` in (1000, 2000]" for a mismatch warning. */
+static std::string describe_range(const Table &t, const Range &r) {
+  return t.pk_name + " in " + (r.first ? "[" : "(") + r.lo + ", " + r.hi + "]";
+}
+
+void verify_written_tables(InceptionContext *ctx) {
+  if (!ctx->verify) return;
+  std::vector<Table> tables = written_tables(ctx);
+  if (tables.empty()) return;
+
+  auto skip_all = [&](const std::string &why) {
+    for (const auto &t : tables)
+      t.node->append_warning("Verify of %s.%s skipped: %s.", t.db.c_str(),
+                             t.name.c_str(), why.c_str());
+  };
+  if (ctx->db_type == DbType::TIDB) {
+    skip_all("not supported on TiDB");
+    return;
+  }
+  if (ctx->slave_hosts.empty()) {
+    skip_all("no --slave-hosts to compare with");
+    return;
+  }
+
+  std::vector<std::pair<std::string, uint>> servers;
+  servers.emplace_back(ctx->host, ctx->port);
+  servers.insert(servers.end(), ctx->slave_hosts.begin(),
+                 ctx->slave_hosts.end());
+
+  PoolConnOptions opts;
+  opts.connect_timeout = 10;
+  std::string err;
+  MYSQL *primary =
+      pool_acquire(ctx->host, ctx->port, ctx->user, ctx->password, opts, &err);
+  if (!primary) {
+    skip_all("cannot connect to the target: " + err);
+    return;
+  }
+  std::vector<Range> ranges;
+  std::vector<bool> planned(tables.size(), false);
+  for (size_t i = 0; i < tables.size(); i++) {
+    const size_t before = ranges.size();
+    const std::string why = plan_table(primary, i, &tables[i], &ranges);
+    if (why.empty()) {
+      planned[i] = true;
+      continue;
+    }
+    ranges.erase(ranges.begin() + before, ranges.end());
+    tables[i].node->append_warning("Verify of %s.%s skipped: %s.",
+                                   tables[i].db.c_str(), tables[i].name.c_str(),
+                                   why.c_str());
+  }
+  pool_release(primary, PoolRelease::CLEAN);
+
+  fprintf(stderr, "[Inception] Verify: %zu chunks of %zu tables on %zu "
+          "replicas, %lu workers.\n", ranges.size(), tables.size(),
+          servers.size() - 1, opt_verify_workers);
+  fflush(stderr);
+  const auto start = std::chrono::steady_clock::now();
+
+  std::map<size_t, std::string> errors;
+  sync_replicas(ctx, servers, &errors);
+  std::vector<size_t> todo(ranges.size());
+  for (size_t i = 0; i < todo.size(); i++) todo[i] = i;
+  PassResult pass = checksum_ranges(ctx, servers, tables, ranges, todo);
+
+  /* Differences may be writes still replicating: check those ranges again
+     once the replicas caught up with the target */
+  if (!pass.differ.empty() && !ctx->killed.load()) {
+    todo.clear();
+    for (const auto &m : pass.differ) todo.push_back(m.range);
+    std::sort(todo.begin(), todo.end());
+    todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+    std::map<size_t, std::string> resync_errors;
+    sync_replicas(ctx, servers, &resync_errors);
+    PassResult again = checksum_ranges(ctx, servers, tables, ranges, todo);
+    pass.differ.swap(again.differ);
+    for (const auto &e : again.errors) pass.errors.insert(e);
+    for (const auto &e : resync_errors) errors.insert(e);
+  }
+  for (const auto &e : pass.errors) errors.insert(e);
+
+  /* Findings per table, mismatches per replica in key order */
+  std::sort(pass.differ.begin(), pass.differ.end(),
+            [](const Mismatch &a, const Mismatch &b) {
+              return a.replica != b.replica ? a.replica < b.replica
+                                            : a.range < b.range;
+            });
+  const bool killed = ctx->killed.load();
+  for (size_t i = 0; i < tables.size(); i++) {
+    if (!planned[i]) continue;
+    Table &t = tables[i];
+    bool clean = !killed && errors.empty();
+    for (size_t s = 1; s < servers.size(); s++) {
+      size_t count = 0;
+      std::string listed;
+      for (const auto &m : pass.differ) {
+        if (m.replica != s || ranges[m.range].table != i) continue;
+        if (count++ < MAX_REPORTED_RANGES)
+          listed += (listed.empty() ? "" : ", ") +
+                    describe_range(t, ranges[m.range]);
+      }
+      if (count == 0) continue;
+      clean = false;
+      if (count > MAX_REPORTED_RANGES) listed += ", ...";
+      t.node->append_warning("Verify: %zu of %zu chunks of %s.%s differ on "
+                             "replica %s: %s.", count, t.chunks, t.db.c_str(),
+                             t.name.c_str(), server_name(servers[s]).c_str(),
+                             listed.c_str());
+    }
+    for (const auto &e : errors)
+      t.node->append_warning("Verify of %s.%s incomplete on %s: %s.",
+                             t.db.c_str(), t.name.c_str(),
+                             server_name(servers[e.first]).c_str(),
+                             e.second.c_str());
+    if (killed)
+      t.node->append_warning("Verify of %s.%s interrupted by kill.",
+                             t.db.c_str(), t.name.c_str());
+    if (clean)
+      t.node->stage_status += format_sql(" (verified: %zu chunks)", t.chunks);
+  }
+
+  fprintf(stderr, "[Inception] Verify: %zu chunks differ, %.1fs.\n",
+          pass.differ.size(),
+          std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                        start)
+              .count());
+  fflush(stderr);
+}
+
+}  // namespace inception
@@ -0,0 +1,38 @@
+/**
+ * @file inception_verify.h
+ * @brief Chunked checksums of the written tables on the replicas
+ *        (--enable-verify).
+ *
+ * After a batch ran, the replicas of --slave-hosts should hold the same
+ * rows as the target for every table it wrote. CHECKSUM TABLE reads a
+ * table in one thread on one server; with --enable-verify=1 each written
+ * table with a single integer primary key is cut instead into key ranges
+ * of inception_verify_chunk_size rows, and inception_verify_workers
+ * threads checksum the ranges on the target and on every replica:
+ *
+ *   SELECT COUNT(*), BIT_XOR(CRC32(CONCAT_WS('#', c1, ..., ISNULL flags)))
+ *   FROM db.t WHERE pk >= lo AND pk <= hi
+ *
+ * at most inception_verify_max_chunks_per_sec ranges a second. The
+ * replicas first wait (WAIT_FOR_EXECUTED_GTID_SET, up to
+ * inception_verify_wait_timeout seconds) for what the target had executed
+ * when verification started. A range that differs is checked again once
+ * the replicas caught up a second time, so writes of other sessions still
+ * in flight are not reported; those that still differ are reported as a
+ * warning on the last statement of the batch that wrote the table, whose
+ * stage_status otherwise ends in "(verified: N chunks)".
+ */
+
+#ifndef SQL_INCEPTION_VERIFY_H
+#define SQL_INCEPTION_VERIFY_H
+
+namespace inception {
+
+struct InceptionContext;
+
+/** Verify the tables the executed batch of ctx wrote, if --enable-verify. */
+void verify_written_tables(InceptionContext *ctx);
+
+}  // namespace inception
+
+#endif  // SQL_INCEPTION_VERIFY_H
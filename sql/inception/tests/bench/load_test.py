@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+"""
+Inception load test against a deterministic mock target.
+
+Starts the router's mysql_server_mock with mock_target.js (or uses one
+already listening), then for each concurrency level runs that many
+sessions against inception for --duration seconds. Each session sends
+batches of --statements statements, magic_start to magic_commit in one
+round trip, over and over, and the driver reports:
+
+  stmts/s   statements audited per second, over all sessions
+  p50, p99  commit latency: from sending a batch to its result (ms)
+
+Usage:
+  python3 load_test.py --mock-bin build/runtime_output_directory/mysql_server_mock
+  python3 load_test.py --mock-port 3310 --concurrency 1,8,64 --duration 5
+
+Environment (as the integration tests):
+  INCEPTION_HOST, INCEPTION_PORT, INCEPTION_USER, INCEPTION_PASSWORD
+
+Prerequisites:
+  pip install pymysql
+"""
+
+import argparse
+import os
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+import pymysql
+from pymysql.constants import CLIENT
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def parse_args():
+    p = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    p.add_argument("--inception-host", default=os.environ.get("INCEPTION_HOST", "127.0.0.1"))
+    p.add_argument("--inception-port", type=int, default=int(os.environ.get("INCEPTION_PORT", "3307")))
+    p.add_argument("--inception-user", default=os.environ.get("INCEPTION_USER", "root"))
+    p.add_argument("--inception-password", default=os.environ.get("INCEPTION_PASSWORD", ""))
+    p.add_argument("--mock-bin", help="mysql_server_mock to start; without it one must listen on --mock-host:--mock-port")
+    p.add_argument("--mock-host", default="127.0.0.1", help="target address as inception sees it")
+    p.add_argument("--mock-port", type=int, default=3310)
+    p.add_argument("--latency-ms", type=float, default=1.0, help="server time of every mock resultset")
+    p.add_argument("--concurrency", default="1,2,4,8,16,32,64,128,256")
+    p.add_argument("--duration", type=float, default=10.0, help="seconds per concurrency level")
+    p.add_argument("--statements", type=int, default=20, help="statements per batch")
+    p.add_argument("--execute", action="store_true", help="--enable-execute instead of --enable-check")
+    return p.parse_args()
+
+
+def start_mock(args):
+    env = dict(os.environ, INCEPTION_MOCK_LATENCY_MS=str(args.latency_ms))
+    proc = subprocess.Popen(
+        [args.mock_bin, "--filename=" + os.path.join(HERE, "mock_target.js"),
+         "--port=%d" % args.mock_port, "--module-prefix=" + HERE],
+        env=env, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    deadline = time.time() + 10
+    while time.time() < deadline:
+        if proc.poll() is not None:
+            sys.exit("mysql_server_mock exited with %d" % proc.returncode)
+        try:
+            socket.create_connection(("127.0.0.1", args.mock_port), 0.2).close()
+            return proc
+        except OSError:
+            time.sleep(0.1)
+    proc.kill()
+    sys.exit("mysql_server_mock did not listen on port %d" % args.mock_port)
+
+
+def batch_sql(args, session, seq):
+    """One batch: DDL and DML on the mock's bench.t1..t16, qualified names."""
+    stmts = []
+    for i in range(args.statements):
+        t = "bench.t%d" % ((session + i) % 16 + 1)
+        kind = i % 5
+        if kind == 0:
+            stmts.append(
+                "CREATE TABLE bench.new_%d_%d_%d (id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk', "
+                "name VARCHAR(64) NOT NULL DEFAULT '' COMMENT 'name', PRIMARY KEY (id)) "
+                "ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT 'load test';" % (session, seq, i))
+        elif kind == 1:
+            stmts.append("ALTER TABLE %s ADD COLUMN n%d INT NOT NULL DEFAULT 0 COMMENT 'n';" % (t, i))
+        elif kind == 2:
+            stmts.append("INSERT INTO %s (id, c0) VALUES (%d, 'a'), (%d, 'b');" % (t, seq * 2, seq * 2 + 1))
+        elif kind == 3:
+            stmts.append("UPDATE %s SET c1 = 'x' WHERE id = %d;" % (t, seq))
+        else:
+            stmts.append("DELETE FROM %s WHERE id < %d;" % (t, seq))
+    mode = "--enable-execute=1;--enable-force=1" if args.execute else "--enable-check=1"
+    magic_start = "/*--user=bench;--password=bench;--host=%s;--port=%d;%s;inception_magic_start;*/" % (
+        args.mock_host, args.mock_port, mode)
+    return "%s\n%s\n/*inception_magic_commit;*/" % (magic_start, "\n".join(stmts))
+
+
+def result_rows(cur):
+    """Rows of the inception result set (the one with a sql_type column)."""
+    while True:
+        if cur.description and "sql_type" in [d[0] for d in cur.description]:
+            return len(cur.fetchall())
+        if not cur.nextset():
+            return 0
+
+
+class Session(threading.Thread):
+    def __init__(self, args, index, deadline):
+        super().__init__(daemon=True)
+        self.args, self.index, self.deadline = args, index, deadline
+        self.statements = 0
+        self.errors = 0
+        self.latencies = []
+
+    def run(self):
+        conn = pymysql.connect(
+            host=self.args.inception_host, port=self.args.inception_port,
+            user=self.args.inception_user, password=self.args.inception_password,
+            charset="utf8mb4", autocommit=True, client_flag=CLIENT.MULTI_STATEMENTS)
+        try:
+            seq = 0
+            while time.time() < self.deadline:
+                seq += 1
+                sql = batch_sql(self.args, self.index, seq)
+                start = time.perf_counter()
+                try:
+                    cur = conn.cursor()
+                    cur.execute(sql)
+                    rows = result_rows(cur)
+                except pymysql.MySQLError:
+                    self.errors += 1
+                    continue
+                self.latencies.append(time.perf_counter() - start)
+                self.statements += rows
+        finally:
+            conn.close()
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0.0
+    k = max(0, int(round(p / 100.0 * len(sorted_values))) - 1)
+    return sorted_values[min(k, len(sorted_values) - 1)]
+
+
+def run_level(args, concurrency):
+    deadline = time.time() + args.duration
+    sessions = [Session(args, i, deadline) for i in range(concurrency)]
+    start = time.perf_counter()
+    for s in sessions:
+        s.start()
+    for s in sessions:
+        s.join()
+    elapsed = time.perf_counter() - start
+    latencies = sorted(l for s in sessions for l in s.latencies)
+    return (sum(s.statements for s in sessions) / elapsed,
+            percentile(latencies, 50) * 1000, percentile(latencies, 99) * 1000,
+            len(latencies), sum(s.errors for s in sessions))
+
+
+def main():
+    args = parse_args()
+    mock = start_mock(args) if args.mock_bin else None
+    try:
+        print("%-11s %12s %10s %10s %9s %7s" % ("concurrency", "stmts/s", "p50_ms", "p99_ms", "batches", "errors"))
+        for level in [int(c) for c in args.concurrency.split(",") if c.strip()]:
+            rate, p50, p99, batches, errors = run_level(args, level)
+            print("%-11d %12.1f %10.2f %10.2f %9d %7d" % (level, rate, p50, p99, batches, errors))
+            sys.stdout.flush()
+    finally:
+        if mock:
+            mock.terminate()
+            mock.wait()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,222 @@
+/*
+ * Deterministic remote target for inception load tests, a trace file of
+ * the router's mysql_server_mock (router/src/mock_server):
+ *
+ *   mysql_server_mock --filename=mock_target.js --port=3310
+ *
+ * Every database exists and holds the tables t1..t<INCEPTION_MOCK_TABLES>,
+ * each (id BIGINT, c0..c19 VARCHAR(64), PRIMARY KEY (id)); a table whose
+ * name starts with "new_" does not exist, so CREATE TABLE new_* passes the
+ * existence check. EXPLAIN estimates INCEPTION_MOCK_EXPLAIN_ROWS rows and
+ * any other statement gets an OK.
+ *
+ * Environment:
+ *   INCEPTION_MOCK_LATENCY_MS     server time of every resultset (default 1)
+ *   INCEPTION_MOCK_TABLES         tables per database (default 16)
+ *   INCEPTION_MOCK_EXPLAIN_ROWS   EXPLAIN rows estimate (default 1000)
+ *
+ * The mock applies exec_time to resultsets only: OK and error replies
+ * (and so executed DDL/DML) come back at once.
+ */
+
+function env_number(name, def) {
+  var v = process.getenv(name);
+  if (v === undefined || v === null || v === "") return def;
+  var n = Number(v);
+  return isNaN(n) ? def : n;
+}
+
+var latency_ms = env_number("INCEPTION_MOCK_LATENCY_MS", 1);
+var table_count = env_number("INCEPTION_MOCK_TABLES", 16);
+var explain_rows = env_number("INCEPTION_MOCK_EXPLAIN_ROWS", 1000);
+
+var TABLE_ROWS = 1000000;
+var TABLE_BYTES = 268435456;
+
+var columns = [["id", "bigint", null, 20, 0]];
+for (var i = 0; i < 20; i++) columns.push(["c" + i, "varchar", 64, null, null]);
+
+function table_exists(name) {
+  return name.toLowerCase().indexOf("new_") !== 0;
+}
+
+function table_names() {
+  var names = [];
+  for (var i = 1; i <= table_count; i++) names.push("t" + i);
+  return names;
+}
+
+function string_columns(names) {
+  return names.map(function(name) {
+    return {name: name, type: "STRING"};
+  });
+}
+
+function result(names, rows) {
+  return {
+    result: {columns: string_columns(names), rows: rows},
+    exec_time: latency_ms
+  };
+}
+
+/* Rows of GET_TABLE_METADATA ('T', 'C' and 'I' rows of 6 columns), with
+   prefix ([db, table] for GET_TABLES_METADATA) after the row type. */
+function metadata_rows(prefix, table) {
+  if (!table_exists(table)) return [];
+  var rows = [["T", TABLE_ROWS, TABLE_BYTES, null, null, null]];
+  columns.forEach(function(c) {
+    rows.push(["C"].concat(c));
+  });
+  rows.push(["I", "PRIMARY", null, null, null, null]);
+  return rows.map(function(row) {
+    return [row[0]].concat(prefix, row.slice(1));
+  });
+}
+
+/* First value of a WHERE <key>='<value>' in stmt */
+function where_value(stmt, key) {
+  var m = new RegExp(key + "\\s*=\\s*'([^']*)'", "i").exec(stmt);
+  return m ? m[1] : "";
+}
+
+var handlers = [
+  {
+    re: /^SELECT \(SELECT COUNT\(\*\) FROM information_schema\.REFERENTIAL_CONSTRAINTS/i,
+    fn: function() {
+      return result(["fks", "triggers"], [[0, 0]]);
+    }
+  },
+  {
+    re: /^SELECT s\.COLUMN_NAME, c\.DATA_TYPE FROM information_schema\.STATISTICS/i,
+    fn: function() {
+      return result(["COLUMN_NAME", "DATA_TYPE"], [["id", "bigint"]]);
+    }
+  },
+  {
+    re: /^SELECT 'T', TABLE_SCHEMA, TABLE_NAME,/i,
+    fn: function(stmt) {
+      var rows = [];
+      var list = /IN \(([^)]*\)(?:,\s*\([^)]*\))*)\)/i.exec(stmt);
+      var pair = /\('([^']*)',\s*'([^']*)'\)/g;
+      var m;
+      while (list && (m = pair.exec(list[1]))) {
+        rows = rows.concat(metadata_rows([m[1], m[2]], m[2]));
+      }
+      return result(["T", "TABLE_SCHEMA", "TABLE_NAME", "a", "b", "c", "d",
+                     "e"],
+                    rows);
+    }
+  },
+  {
+    re: /^SELECT 'T', TABLE_ROWS,/i,
+    fn: function(stmt) {
+      return result(["T", "a", "b", "c", "d", "e"],
+                    metadata_rows([], where_value(stmt, "TABLE_NAME")));
+    }
+  },
+  {
+    re: /^SELECT TABLE_NAME, TABLE_ROWS, DATA_LENGTH \+ INDEX_LENGTH FROM information_schema\.TABLES/i,
+    fn: function() {
+      return result(["TABLE_NAME", "TABLE_ROWS", "BYTES"],
+                    table_names().map(function(t) {
+                      return [t, TABLE_ROWS, TABLE_BYTES];
+                    }));
+    }
+  },
+  {
+    re: /^SELECT TABLE_NAME, COLUMN_NAME, DATA_TYPE,/i,
+    fn: function() {
+      var rows = [];
+      table_names().forEach(function(t) {
+        columns.forEach(function(c) {
+          rows.push([t].concat(c));
+        });
+      });
+      return result(["TABLE_NAME", "COLUMN_NAME", "DATA_TYPE",
+                     "CHARACTER_MAXIMUM_LENGTH", "NUMERIC_PRECISION",
+                     "NUMERIC_SCALE"],
+                    rows);
+    }
+  },
+  {
+    re: /^SELECT DISTINCT TABLE_NAME, INDEX_NAME FROM information_schema\.STATISTICS/i,
+    fn: function() {
+      return result(["TABLE_NAME", "INDEX_NAME"],
+                    table_names().map(function(t) {
+                      return [t, "PRIMARY"];
+                    }));
+    }
+  },
+  {
+    re: /^SELECT COLUMN_NAME, COLUMN_TYPE, EXTRA FROM information_schema\.COLUMNS/i,
+    fn: function() {
+      return result(["COLUMN_NAME", "COLUMN_TYPE", "EXTRA"],
+                    columns.map(function(c) {
+                      return [c[0], c[1] === "bigint" ? "bigint" : "varchar(64)",
+                              ""];
+                    }));
+    }
+  },
+  {
+    re: /^SELECT TABLE_NAME FROM information_schema\.TABLES/i,
+    fn: function() {
+      return result(["TABLE_NAME"], []);
+    }
+  },
+  {
+    re: /^SHOW DATABASES LIKE '([^']*)'/i,
+    fn: function(stmt, m) {
+      return result(["Database"], [[m[1]]]);
+    }
+  },
+  {
+    re: /^EXPLAIN /i,
+    fn: function() {
+      return result(["id", "select_type", "table", "partitions", "type",
+                     "possible_keys", "key", "key_len", "ref", "rows",
+                     "filtered", "Extra"],
+                    [[1, "SIMPLE", "t", null, "range", "PRIMARY", "PRIMARY",
+                      "8", null, explain_rows, "100.00", "Using where"]]);
+    }
+  },
+  {
+    re: /^SHOW WARNINGS/i,
+    fn: function() {
+      return result(["Level", "Code", "Message"], []);
+    }
+  },
+  {
+    re: /^SHOW SLAVE STATUS/i,
+    fn: function() {
+      return result(["Slave_IO_State"], []);
+    }
+  },
+  {
+    re: /^SHOW GLOBAL STATUS LIKE 'Threads_running'/i,
+    fn: function() {
+      return result(["Variable_name", "Value"], [["Threads_running", "1"]]);
+    }
+  },
+  {
+    re: /^SELECT @@max_allowed_packet/i,
+    fn: function() {
+      return result(["@@max_allowed_packet"], [[67108864]]);
+    }
+  },
+  {
+    re: /^SELECT @@GLOBAL\.read_only/i,
+    fn: function() {
+      return result(["@@GLOBAL.read_only"], [[0]]);
+    }
+  }
+];
+
+({
+  stmts: function(stmt) {
+    for (var i = 0; i < handlers.length; i++) {
+      var m = handlers[i].re.exec(stmt);
+      if (m) return handlers[i].fn(stmt, m);
+    }
+    return {ok: {}};
+  }
+})
@@ -8,9 +8,12 @@ Prerequisites:
 Environment variables:
   INCEPTION_HOST, INCEPTION_PORT
   REMOTE_HOST, REMOTE_PORT, REMOTE_USER, REMOTE_PASSWORD
+  PERF_BASELINE, PERF_TOLERANCE, PERF_UPDATE_BASELINE  (perf tests, -m perf)
 """
 
+import json
 import os
+import time
 import pymysql
 from pymysql.constants import CLIENT
 import pytest
@@ -258,7 +261,7 @@ def _find_inception_result(cur):
 def inception_check(sql_block, **kwargs):
     """
     Send a CHECK-mode inception request.
-    Returns list of dicts (one per result row) with keys matching the 15 columns.
+    Returns list of dicts (one per result row) with keys matching the 18 columns.
     """
     host = kwargs.get("remote_host", REMOTE_HOST)
     port = kwargs.get("remote_port", REMOTE_PORT)
@@ -289,7 +292,7 @@ def inception_check(sql_block, **kwargs):
 def inception_execute(sql_block, **kwargs):
     """
     Send an EXECUTE-mode inception request.
-    Returns list of dicts (one per result row) with keys matching the 15 columns.
+    Returns list of dicts (one per result row) with keys matching the 18 columns.
     """
     host = kwargs.get("remote_host", REMOTE_HOST)
     port = kwargs.get("remote_port", REMOTE_PORT)
@@ -422,12 +425,14 @@ def _find_query_tree_result(cur):
 def inception_split(sql_block, **kwargs):
     """
     Send a SPLIT-mode inception request.
-    Returns list of dicts with keys: ID, sql_statement, ddlflag.
+    Returns list of dicts with keys: ID, sql_statement, ddlflag,
+    parallel_group, depends_on.
     """
     host = kwargs.get("remote_host", REMOTE_HOST)
     port = kwargs.get("remote_port", REMOTE_PORT)
     user = kwargs.get("remote_user", REMOTE_USER)
     password = kwargs.get("remote_password", REMOTE_PASSWORD)
+    extra = kwargs.get("extra_params", "")
 
     magic_start = _build_magic_start(
         host=host,
@@ -435,6 +440,7 @@ def inception_split(sql_block, **kwargs):
         mode_option="--enable-split=1",
         user=user,
         password=password,
+        extra_params=extra,
     )
     magic_commit = "/*inception_magic_commit;*/"
     full_sql = f"{magic_start}\n{sql_block}\n{magic_commit}"
@@ -516,6 +522,26 @@ def test_db_name():
     return f"inception_test_{int(time.time())}"
 
 
+@pytest.fixture(scope="session", autouse=True)
+def _disable_metadata_cache():
+    """
+    Tests create and drop remote objects directly (remote_execute), which the
+    shared metadata cache cannot see. Run with the cache off; cache tests turn
+    it on explicitly.
+    """
+    try:
+        old = get_inception_var("inception_metadata_cache_ttl")
+        set_inception_var("inception_metadata_cache_ttl", 0)
+    except Exception:
+        old = None
+    yield
+    if old is not None:
+        try:
+            set_inception_var("inception_metadata_cache_ttl", int(old))
+        except Exception:
+            pass
+
+
 @pytest.fixture(autouse=True)
 def _cleanup_test_db(test_db_name):
     """
@@ -527,3 +553,138 @@ def _cleanup_test_db(test_db_name):
         remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
     except Exception:
         pass
+
+
+# --- Performance regression tests (-m perf) ---
+
+PERF_BASELINE = os.environ.get(
+    "PERF_BASELINE", os.path.join(os.path.dirname(__file__), "perf_baseline.json"))
+PERF_TOLERANCE = float(os.environ.get("PERF_TOLERANCE", "0.25"))
+PERF_UPDATE_BASELINE = os.environ.get("PERF_UPDATE_BASELINE", "") not in ("", "0")
+
+
+def pytest_configure(config):
+    config.addinivalue_line(
+        "markers", "perf: timed workload compared with perf_baseline.json "
+                   "(deselected unless -m perf)")
+
+
+def pytest_collection_modifyitems(config, items):
+    """Perf tests are long: run them only when -m selects them."""
+    if "perf" in (config.getoption("markexpr") or ""):
+        return
+    skip = pytest.mark.skip(reason="perf test, run with -m perf")
+    for item in items:
+        if "perf" in item.keywords:
+            item.add_marker(skip)
+
+
+def inception_status(name):
+    """Value of the global status variable name on the inception server."""
+    conn = _connect_inception()
+    try:
+        cur = conn.cursor()
+        cur.execute("SHOW GLOBAL STATUS LIKE %s", (name,))
+        row = cur.fetchone()
+        return int(row[1]) if row else 0
+    finally:
+        conn.close()
+
+
+def _inception_pid():
+    """Pid of a local inception server, or None."""
+    try:
+        conn = _connect_inception()
+        try:
+            cur = conn.cursor()
+            cur.execute("SELECT @@pid_file")
+            pid_file = cur.fetchone()[0]
+        finally:
+            conn.close()
+        with open(pid_file) as f:
+            return int(f.read().strip())
+    except Exception:
+        return None
+
+
+def _peak_rss_kb(pid):
+    """VmHWM of pid, in kB, or None off Linux or for a remote server."""
+    try:
+        with open(f"/proc/{pid}/status") as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1])
+    except Exception:
+        pass
+    return None
+
+
+class PerfRun:
+    """
+    Measures one workload: wall time, Inception_remote_queries and peak RSS
+    of the inception server (reset before the run when the server is local
+    and writable, else the peak since startup).
+    """
+
+    def __init__(self, name):
+        self.name = name
+        self.result = {}
+
+    def __enter__(self):
+        self._pid = _inception_pid()
+        if self._pid:
+            try:
+                with open(f"/proc/{self._pid}/clear_refs", "w") as f:
+                    f.write("5")
+            except Exception:
+                pass
+        self._remote = inception_status("Inception_remote_queries")
+        self._start = time.perf_counter()
+        return self
+
+    def __exit__(self, exc_type, exc, tb):
+        if exc_type:
+            return False
+        self.result["wall_s"] = round(time.perf_counter() - self._start, 3)
+        self.result["remote_queries"] = (
+            inception_status("Inception_remote_queries") - self._remote)
+        rss = _peak_rss_kb(self._pid) if self._pid else None
+        if rss is not None:
+            self.result["peak_rss_kb"] = rss
+        return False
+
+
+@pytest.fixture(scope="session")
+def perf_baseline():
+    """
+    The JSON baseline: {workload: {wall_s, remote_queries, peak_rss_kb}}.
+    A workload missing from it (or every workload with PERF_UPDATE_BASELINE=1)
+    is recorded instead of compared; the file is written at the end.
+    """
+    baseline = {}
+    if os.path.exists(PERF_BASELINE):
+        with open(PERF_BASELINE, encoding="utf-8") as f:
+            baseline = json.load(f)
+    recorded = {}
+
+    def check(run):
+        old = baseline.get(run.name)
+        if PERF_UPDATE_BASELINE or old is None:
+            recorded[run.name] = run.result
+            return
+        failures = []
+        for metric, value in run.result.items():
+            base = old.get(metric)
+            if base is None:
+                continue
+            limit = base * (1 + PERF_TOLERANCE)
+            if value > limit:
+                failures.append(f"{metric} {value} > {base} * {1 + PERF_TOLERANCE:.2f}")
+        assert not failures, f"{run.name} regressed: " + "; ".join(failures)
+
+    yield check
+    if recorded:
+        baseline.update(recorded)
+        with open(PERF_BASELINE, "w", encoding="utf-8") as f:
+            json.dump(baseline, f, indent=2, sort_keys=True)
+            f.write("\n")
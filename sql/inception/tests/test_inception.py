@@ -25,6 +25,7 @@ from conftest import (
     inception_query_tree,
     inception_get_sqltypes,
     inception_get_encrypt_password,
+    inception_status,
     remote_execute,
     remote_query,
     set_inception_var,
@@ -50,6 +51,15 @@ def _detected_db_profile():
     return db_type, version, major, minor
 
 
+def _remote_version_key():
+    """Remote MySQL release as major * 10000 + minor * 100 + patch."""
+    version = remote_query("SELECT VERSION()")[0][0]
+    m = re.match(r"^\s*(\d+)\.(\d+)\.(\d+)", version)
+    if not m:
+        return 0
+    return int(m.group(1)) * 10000 + int(m.group(2)) * 100 + int(m.group(3))
+
+
 # ===========================================================================
 # Config Parsing
 # ===========================================================================
@@ -110,17 +120,18 @@ class TestConfigParsing:
 # ===========================================================================
 
 class TestResultFormat:
-    """Verify the 15-column result set format and column names."""
+    """Verify the 18-column result set format and column names."""
 
-    def test_result_has_15_columns(self, test_db_name):
-        """Result set must have exactly 15 columns with correct names."""
+    def test_result_has_18_columns(self, test_db_name):
+        """Result set must have exactly 18 columns with correct names."""
         rows = inception_check(f"CREATE DATABASE {test_db_name};")
         assert len(rows) > 0
         expected_cols = [
             "id", "stage", "err_level", "stage_status", "err_message",
             "sql_text", "affected_rows", "sequence", "backup_dbname",
             "execute_time", "sql_sha1", "sql_type", "ddl_algorithm",
-            "db_type", "db_version",
+            "db_type", "db_version", "exec_strategy", "estimated_time",
+            "locks_writes",
         ]
         actual_cols = list(rows[0].keys())
         assert actual_cols == expected_cols, f"Columns mismatch: {actual_cols}"
@@ -840,6 +851,30 @@ class TestExecuteMode:
         assert good_row[0]["stage"] == "CHECKED"
         assert good_row[0]["stage_status"] == "Audit completed"
 
+    def test_execute_select_streams_rows(self, test_db_name):
+        """A SELECT is drained row by row: affected_rows is its row count
+        and the statements after it still run on the same connection."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'stream test'"
+        )
+        values = ", ".join(f"({i})" for i in range(1, 2001))
+        remote_execute(f"INSERT INTO `{test_db_name}`.t1 (id) VALUES {values}")
+        rows = inception_execute(
+            f"USE {test_db_name};\n"
+            f"SELECT id FROM t1 WHERE id > 0;\n"
+            f"INSERT INTO t1 (id) VALUES (5000);"
+        )
+        select_row = [r for r in rows if "SELECT" in r["sql_text"]][0]
+        assert select_row["stage_status"] == "Execute completed"
+        assert select_row["affected_rows"] == 2000
+        insert_row = [r for r in rows if "INSERT" in r["sql_text"]][0]
+        assert insert_row["err_level"] == 0, insert_row["err_message"]
+        assert insert_row["stage_status"] == "Execute completed"
+
 
 # ===========================================================================
 # System Variables
@@ -916,6 +951,37 @@ class TestSystemVariables:
             set_inception_var("inception_check_max_indexes", int(original))
 
 
+# ===========================================================================
+# Pre-parse Command Detection
+# ===========================================================================
+
+class TestCommandDispatch:
+    """before_parse() picks out inception commands and passes the rest on."""
+
+    def _query(self, sql):
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            cur = conn.cursor()
+            cur.execute(sql)
+            return cur.fetchall()
+        finally:
+            conn.close()
+
+    def test_command_case_and_leading_space(self):
+        """Leading blanks and upper case still reach the command handler."""
+        rows = self._query("\n  INCEPTION SHOW pool;")
+        assert isinstance(rows, (list, tuple))
+
+    def test_ordinary_queries_pass_through(self):
+        """A leading comment or an "inception" literal is plain SQL."""
+        assert self._query("/* app=web */ SELECT 1")[0][0] == 1
+        rows = self._query("SELECT 'inception show pool'")
+        assert rows[0][0] == "inception show pool"
+        with pytest.raises(Exception):
+            self._query("inception shout pool")
+
+
 # ===========================================================================
 # Parse Error Handling
 # ===========================================================================
@@ -1101,13 +1167,14 @@ class TestSplitMode:
     """Test SPLIT mode — SQL grouping by table + operation type."""
 
     def test_split_result_format(self, test_db_name):
-        """SPLIT result should have 3 columns: ID, sql_statement, ddlflag."""
+        """SPLIT result columns: id, sql_statement, ddlflag and the DAG."""
         rows = inception_split(
             f"USE {test_db_name};\n"
             f"INSERT INTO t1 (id) VALUES (1);"
         )
         assert len(rows) > 0
-        expected_cols = ["id", "sql_statement", "ddlflag"]
+        expected_cols = ["id", "sql_statement", "ddlflag",
+                         "parallel_group", "depends_on"]
         actual_cols = list(rows[0].keys())
         assert actual_cols == expected_cols
 
@@ -1213,6 +1280,107 @@ class TestSplitMode:
         assert rows[1]["id"] == 2
         assert rows[2]["id"] == 3
 
+    def test_split_unrelated_tables_share_level(self, test_db_name):
+        """Groups of unrelated tables are one parallel_group with no deps."""
+        rows = inception_split(
+            f"USE {test_db_name};\n"
+            f"INSERT INTO t1 (id) VALUES (1);\n"
+            f"INSERT INTO t2 (id) VALUES (1);\n"
+            f"UPDATE t1 SET id = 2 WHERE id = 1;"
+        )
+        assert len(rows) == 3
+        assert [r["parallel_group"] for r in rows] == [1, 1, 2]
+        assert [r["depends_on"] for r in rows] == ["", "", "1"]
+
+    def test_split_foreign_key_links_tables(self, test_db_name):
+        """A declared foreign key orders the child after its parent."""
+        rows = inception_split(
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE p (id INT PRIMARY KEY) ENGINE=InnoDB;\n"
+            f"CREATE TABLE c (id INT PRIMARY KEY, pid INT, "
+            f"FOREIGN KEY (pid) REFERENCES p (id)) ENGINE=InnoDB;"
+        )
+        assert len(rows) == 2
+        assert rows[1]["parallel_group"] == 2
+        assert rows[1]["depends_on"] == "1"
+
+    def test_split_barrier_depends_on_all(self, test_db_name):
+        """A database statement follows every open group, and all after it."""
+        rows = inception_split(
+            f"USE {test_db_name};\n"
+            f"INSERT INTO t1 (id) VALUES (1);\n"
+            f"INSERT INTO t2 (id) VALUES (1);\n"
+            f"CREATE DATABASE {test_db_name}_x;\n"
+            f"INSERT INTO t3 (id) VALUES (1);"
+        )
+        assert len(rows) == 4
+        assert [r["parallel_group"] for r in rows] == [1, 1, 2, 3]
+        assert rows[2]["depends_on"] == "1,2"
+        assert rows[3]["depends_on"] == "3"
+
+
+class TestSplitFiles:
+    """Test --enable-split-files: SPLIT groups written to inception_split_dir."""
+
+    SPLIT_DIR = "/tmp/inception_test_split"
+
+    @pytest.fixture(autouse=True)
+    def _dir(self):
+        import os
+        import shutil
+        shutil.rmtree(self.SPLIT_DIR, ignore_errors=True)
+        os.makedirs(self.SPLIT_DIR)
+        old = get_inception_var("inception_split_dir")
+        set_inception_var("inception_split_dir", self.SPLIT_DIR)
+        yield
+        set_inception_var("inception_split_dir", old or "")
+        shutil.rmtree(self.SPLIT_DIR, ignore_errors=True)
+
+    def _sql(self, db):
+        inserts = "".join(f"INSERT INTO t1 (id) VALUES ({i});\n"
+                          for i in range(500))
+        return (f"USE {db};\n{inserts}"
+                f"ALTER TABLE t1 ADD COLUMN c INT;\n"
+                f"INSERT INTO t2 (id) VALUES (1);")
+
+    def test_groups_in_files(self, test_db_name):
+        """Each group is a file holding what sql_statement would."""
+        import os
+        sql = self._sql(test_db_name)
+        in_memory = inception_split(sql)
+        rows = inception_split(sql, extra_params="--enable-split-files=1;")
+        assert len(rows) == len(in_memory) == 3
+        for r, m in zip(rows, in_memory):
+            path = r["sql_statement"]
+            assert os.path.dirname(path) == self.SPLIT_DIR
+            assert path.endswith(f"_{r['id']}.sql")
+            with open(path) as f:
+                assert f.read() == m["sql_statement"]
+            assert (r["ddlflag"], r["parallel_group"], r["depends_on"]) == \
+                (m["ddlflag"], m["parallel_group"], m["depends_on"])
+
+    def test_sessions_do_not_collide(self, test_db_name):
+        """Two sessions write files of their own."""
+        sql = f"USE {test_db_name};\nINSERT INTO t1 (id) VALUES (1);"
+        a = inception_split(sql, extra_params="--enable-split-files=1;")
+        b = inception_split(sql, extra_params="--enable-split-files=1;")
+        assert a[0]["sql_statement"] != b[0]["sql_statement"]
+
+    def test_needs_split_dir(self):
+        """Without inception_split_dir the option is refused."""
+        import pymysql
+        set_inception_var("inception_split_dir", "")
+        with pytest.raises(pymysql.err.MySQLError, match="inception_split_dir"):
+            inception_split("SELECT 1;",
+                            extra_params="--enable-split-files=1;")
+
+    def test_split_mode_only(self):
+        """The option belongs to SPLIT sessions."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="--enable-split"):
+            inception_check("SELECT 1;",
+                            extra_params="--enable-split-files=1;")
+
 
 # ===========================================================================
 # QUERY_TREE Mode
@@ -1550,6 +1718,111 @@ class TestQueryTreeMode:
 # ALTER TABLE Sub-Types
 # ===========================================================================
 
+    def test_query_tree_cache_reused(self, test_db_name):
+        """A repeated shape is answered from the tree cache, same JSON."""
+        sql = (f"USE {test_db_name};\n"
+               "SELECT e.*, d.name FROM employees e "
+               "JOIN departments d ON e.dept_id = d.id WHERE e.age > {};")
+        first = inception_query_tree(sql.format(30))
+        before = inception_status("Inception_query_tree_cache_hits")
+        second = inception_query_tree(sql.format(40))
+        assert inception_status("Inception_query_tree_cache_hits") > before
+        assert second[0]["query_tree"] == first[0]["query_tree"]
+        tree = json.loads(second[0]["query_tree"])
+        assert "salary" in json.dumps(tree)
+
+    def test_query_tree_cache_disabled(self, test_db_name):
+        """inception_query_tree_cache_size = 0 walks every statement."""
+        old = get_inception_var("inception_query_tree_cache_size")
+        set_inception_var("inception_query_tree_cache_size", 0)
+        try:
+            sql = f"USE {test_db_name};\nSELECT name FROM employees WHERE id = 7;"
+            inception_query_tree(sql)
+            before = inception_status("Inception_query_tree_cache_hits")
+            rows = inception_query_tree(sql)
+            assert inception_status("Inception_query_tree_cache_hits") == before
+        finally:
+            set_inception_var("inception_query_tree_cache_size", old)
+        assert "employees" in rows[0]["query_tree"]
+
+    def test_star_expansion_preloaded(self, test_db_name):
+        """Every * of a UNION is expanded, in column order, from one preload."""
+        for t in ("star_a", "star_b"):
+            remote_execute(
+                f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`{t}` ("
+                f"  zeta INT NOT NULL, alpha INT NOT NULL, mid INT NOT NULL"
+                f") ENGINE=InnoDB")
+        old = get_inception_var("inception_query_tree_cache_size")
+        set_inception_var("inception_query_tree_cache_size", 0)
+        try:
+            before = inception_status("Inception_remote_queries")
+            rows = inception_query_tree(
+                f"USE {test_db_name};\n"
+                "SELECT * FROM star_a UNION ALL SELECT * FROM star_b "
+                "UNION ALL SELECT * FROM star_a;")
+            queries = inception_status("Inception_remote_queries") - before
+        finally:
+            set_inception_var("inception_query_tree_cache_size", old)
+        tree = json.loads(rows[0]["query_tree"])
+        expanded = [c["expanded"] for c in tree["columns"]["select"]
+                    if c["column"] == "*"]
+        assert len(expanded) == 3
+        assert all(e == ["zeta", "alpha", "mid"] for e in expanded)
+        # One batched load instead of a lookup per *
+        assert queries <= 1
+
+    def _get_tree(self, sql, db=None):
+        from conftest import _connect_inception
+        conn = _connect_inception(multi_statements=True)
+        try:
+            cur = conn.cursor()
+            if db:
+                cur.execute(f"USE {db}")
+            cur.execute(sql)
+            rows = cur.fetchall()
+            results = [rows]
+            while cur.nextset():
+                results.append(cur.fetchall())
+            return results
+        finally:
+            conn.close()
+
+    def test_get_tree_one_round_trip(self, test_db_name):
+        """inception get tree answers like a QUERY_TREE session."""
+        from conftest import _build_magic_start, REMOTE_USER, REMOTE_PASSWORD
+        sql = ("SELECT e.*, d.name FROM employees e "
+               "JOIN departments d ON e.dept_id = d.id WHERE e.age > 30")
+        session = inception_query_tree(f"USE {test_db_name};\n{sql};")
+        options = _build_magic_start(REMOTE_HOST, REMOTE_PORT,
+                                     "--enable-query-tree=1",
+                                     REMOTE_USER, REMOTE_PASSWORD)
+        results = self._get_tree(f"inception get tree {options} {sql};",
+                                 db=test_db_name)
+        assert len(results) == 1 and len(results[0]) == 1
+        row = results[0][0]
+        assert row[0] == 1
+        assert row[1] == sql
+        assert row[2] == session[0]["query_tree"]
+
+    def test_get_tree_without_target(self, test_db_name):
+        """Without options SELECT * is not expanded; later statements run."""
+        results = self._get_tree(
+            "inception get tree SELECT * FROM employees; SELECT 7",
+            db=test_db_name)
+        assert len(results) == 2
+        tree = json.loads(results[0][0][2])
+        assert tree["sql_type"] == "SELECT"
+        assert tree["tables"][0]["table"] == "employees"
+        assert "expanded" not in json.dumps(tree)
+        assert results[1][0][0] == 7
+
+    def test_get_tree_parse_error(self):
+        """A statement that does not parse is reported as an error."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="syntax"):
+            self._get_tree("inception get tree SELEC 1")
+
+
 class TestAlterTableSubTypes:
     """Test ALTER TABLE sub-type classification in the sqltype column."""
 
@@ -2031,6 +2304,33 @@ class TestSqlFingerprint:
         assert len(ins1) > 0 and len(ins2) > 0
         assert ins1[0]["sql_sha1"] == ins2[0]["sql_sha1"]
 
+    def test_sqlsha1_differs_for_other_structure(self, test_db_name):
+        """Another column list or table gives another sqlsha1."""
+        rows = inception_check(
+            f"INSERT INTO {test_db_name}.t1 (id) VALUES (1);\n"
+            f"INSERT INTO {test_db_name}.t1 (id, c) VALUES (1, 2);\n"
+            f"INSERT INTO {test_db_name}.t2 (id) VALUES (1);"
+        )
+        shas = [r["sql_sha1"] for r in rows if "INSERT" in r["sql_text"]]
+        assert len(shas) == 3
+        assert len(set(shas)) == 3
+
+    def test_sqlsha1_is_performance_schema_digest(self, test_db_name):
+        """sqlsha1 is the leading 40 hex digits of STATEMENT_DIGEST()."""
+        sql = f"INSERT INTO {test_db_name}.t1 (id) VALUES (1)"
+        rows = inception_check(sql + ";")
+        ins = [r for r in rows if "INSERT" in r["sql_text"]]
+        assert len(ins) == 1
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            cur = conn.cursor()
+            cur.execute("SELECT STATEMENT_DIGEST(%s)", (sql,))
+            digest = cur.fetchone()[0]
+        finally:
+            conn.close()
+        assert digest.startswith(ins[0]["sql_sha1"])
+
 
 # ===========================================================================
 # ALTER TABLE Remote Checks (BLOB/TEXT index, MODIFY column narrowing)
@@ -2086,6 +2386,116 @@ class TestAlterTableRemoteChecks:
         if alter_row[0]["err_message"] != "None":
             assert "prefix" not in alter_row[0]["err_message"].lower()
 
+    def test_alter_add_index_duplicates_existing(self, test_db_name):
+        """ALTER ADD INDEX with the parts of an existing index is a duplicate."""
+        old = get_inception_var("inception_check_duplicate_index")
+        set_inception_var("inception_check_duplicate_index", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t_remote ADD INDEX idx_name2 (name(50));"
+            )
+        finally:
+            set_inception_var("inception_check_duplicate_index", old)
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alter_row) > 0
+        assert "duplicates index 'idx_name'" in alter_row[0]["err_message"]
+
+    def test_alter_add_index_left_prefix_of_primary(self, test_db_name):
+        """A non-unique index on the primary key columns is redundant."""
+        old = get_inception_var("inception_check_duplicate_index")
+        set_inception_var("inception_check_duplicate_index", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t_remote ADD INDEX idx_id (id);"
+            )
+        finally:
+            set_inception_var("inception_check_duplicate_index", old)
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alter_row) > 0
+        assert "primary" in alter_row[0]["err_message"].lower()
+
+    def test_create_index_makes_existing_redundant(self, test_db_name):
+        """CREATE INDEX extending an existing index makes that one redundant."""
+        old = get_inception_var("inception_check_duplicate_index")
+        set_inception_var("inception_check_duplicate_index", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"CREATE INDEX idx_name_age ON t_remote (name(50), age);"
+            )
+        finally:
+            set_inception_var("inception_check_duplicate_index", old)
+        create_row = [r for r in rows if "CREATE INDEX" in r["sql_text"]]
+        assert len(create_row) > 0
+        assert "makes index 'idx_name'" in create_row[0]["err_message"]
+
+    def test_alter_add_unique_index_not_duplicate(self, test_db_name):
+        """A UNIQUE index is not a duplicate of a non-unique one."""
+        old = get_inception_var("inception_check_duplicate_index")
+        set_inception_var("inception_check_duplicate_index", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t_remote ADD UNIQUE INDEX uniq_age (age);"
+            )
+        finally:
+            set_inception_var("inception_check_duplicate_index", old)
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alter_row) > 0
+        assert "duplicates" not in alter_row[0]["err_message"]
+        assert "left prefix" not in alter_row[0]["err_message"]
+
+    def _check_duplicates(self, sql):
+        old = get_inception_var("inception_check_duplicate_index")
+        set_inception_var("inception_check_duplicate_index", 1)
+        try:
+            return inception_check(sql)
+        finally:
+            set_inception_var("inception_check_duplicate_index", old)
+
+    def test_duplicate_index_across_alters(self, test_db_name):
+        """An index an earlier ALTER of the batch added is a duplicate."""
+        rows = self._check_duplicates(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t_remote ADD INDEX idx_age (age);\n"
+            f"ALTER TABLE t_remote ADD INDEX idx_age2 (age);"
+        )
+        alter_rows = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alter_rows) == 2
+        assert "idx_age" not in alter_rows[0]["err_message"]
+        assert (f"duplicates index 'idx_age' added to '{test_db_name}.t_remote' "
+                f"by statement {alter_rows[0]['id']}"
+                in alter_rows[1]["err_message"])
+
+    def test_duplicate_index_of_batch_table(self, test_db_name):
+        """CREATE INDEX on a table the batch created sees its indexes."""
+        rows = self._check_duplicates(
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t_batch_idx ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  code INT NOT NULL COMMENT 'code',"
+            f"  PRIMARY KEY (id),"
+            f"  UNIQUE KEY uniq_code (code)"
+            f") ENGINE=InnoDB COMMENT 'batch index test';\n"
+            f"CREATE INDEX idx_code ON t_batch_idx (code);"
+        )
+        create_row = [r for r in rows if "CREATE INDEX" in r["sql_text"]]
+        assert len(create_row) == 1
+        assert "duplicates index 'uniq_code'" in create_row[0]["err_message"]
+
+    def test_dropped_index_is_not_a_duplicate(self, test_db_name):
+        """An index dropped in between is no duplicate."""
+        rows = self._check_duplicates(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t_remote ADD INDEX idx_age (age);\n"
+            f"ALTER TABLE t_remote DROP INDEX idx_age;\n"
+            f"ALTER TABLE t_remote ADD INDEX idx_age2 (age);"
+        )
+        for r in rows:
+            assert "added to" not in r["err_message"], r["sql_text"]
+
     def test_alter_modify_column_length_reduction(self, test_db_name):
         """ALTER MODIFY COLUMN reducing length should warn about truncation."""
         rows = inception_check(
@@ -2208,6 +2618,54 @@ class TestDMLRowCountEstimation:
         finally:
             set_inception_var("inception_check_max_update_rows", int(original))
 
+    def _check_plan(self, test_db_name, sql):
+        original = get_inception_var("inception_check_explain_min_rows")
+        set_inception_var("inception_check_explain_min_rows", 0)
+        try:
+            rows = inception_check(f"USE {test_db_name};\n{sql}")
+        finally:
+            set_inception_var("inception_check_explain_min_rows", int(original))
+        return [r for r in rows if r["sql_text"].startswith(sql[:6])][0]
+
+    def test_full_scan_without_index(self, test_db_name):
+        """A WHERE on an unindexed column reads the whole table."""
+        row = self._check_plan(test_db_name,
+                               "UPDATE t_rows SET name = 'x' WHERE name = 'row1';")
+        assert "no usable index on the WHERE columns" in row["err_message"]
+
+    def test_index_lookup_not_flagged(self, test_db_name):
+        """A primary key lookup is no full scan."""
+        row = self._check_plan(test_db_name,
+                               "DELETE FROM t_rows WHERE id = 1;")
+        assert "reads all" not in (row["err_message"] or "")
+
+    def test_filesort_flagged(self, test_db_name):
+        """ORDER BY an unindexed column sorts with a filesort."""
+        row = self._check_plan(
+            test_db_name,
+            "UPDATE t_rows SET name = 'x' WHERE id > 0 ORDER BY name LIMIT 1;")
+        assert "with a filesort" in row["err_message"]
+
+    def test_plan_rules_respect_min_rows(self, test_db_name):
+        """Tables below inception_check_explain_min_rows are not flagged."""
+        rows = inception_check(
+            f"USE {test_db_name};\n"
+            f"UPDATE t_rows SET name = 'x' WHERE name = 'row1';")
+        row = [r for r in rows if r["sql_text"].startswith("UPDATE")][0]
+        assert "reads all" not in (row["err_message"] or "")
+
+    def test_binlog_size_small_dml_not_flagged(self, test_db_name):
+        """A few rows of row events stay under the binlog size limit."""
+        original = get_inception_var("inception_check_max_dml_binlog_size")
+        set_inception_var("inception_check_max_dml_binlog_size", 1)
+        try:
+            row = self._check_plan(test_db_name,
+                                   "UPDATE t_rows SET name = 'x' WHERE id > 0;")
+        finally:
+            set_inception_var("inception_check_max_dml_binlog_size",
+                              int(original))
+        assert "of row events" not in (row["err_message"] or "")
+
 
 # ===========================================================================
 # Must-Have Columns
@@ -3486,10 +3944,16 @@ class TestAuditLog:
             rows = inception_check(
                 f"CREATE DATABASE {test_db_name}_auditlog;"
             )
-            # Read log file
+            # Records are written by a background thread; wait briefly
+            lines = []
+            for _ in range(50):
+                if os.path.exists(log_file):
+                    with open(log_file, "r") as f:
+                        lines = f.readlines()
+                    if lines:
+                        break
+                time.sleep(0.1)
             assert os.path.exists(log_file), "Audit log file should be created"
-            with open(log_file, "r") as f:
-                lines = f.readlines()
             assert len(lines) >= 1, "Should have at least one session log line"
             # Parse the last line as JSON
             import json as json_mod
@@ -3502,6 +3966,132 @@ class TestAuditLog:
             if os.path.exists(log_file):
                 os.remove(log_file)
 
+    def test_audit_log_statement_timing(self, test_db_name):
+        """Statement records break down where the statement's time went."""
+        import json as json_mod
+        import os
+        log_file = "/tmp/inception_test_audit_timing.log"
+        if os.path.exists(log_file):
+            os.remove(log_file)
+        db = f"{test_db_name}_timing"
+        original = get_inception_var("inception_audit_log")
+        set_inception_var("inception_audit_log", log_file)
+        try:
+            inception_execute(f"CREATE DATABASE {db};")
+            entries = []
+            for _ in range(50):
+                if os.path.exists(log_file):
+                    with open(log_file, "r") as f:
+                        entries = [json_mod.loads(l) for l in f if l.strip()]
+                    if any(e["type"] == "statement" for e in entries):
+                        break
+                time.sleep(0.1)
+            stmts = [e for e in entries if e["type"] == "statement"]
+            assert stmts, "Should have a statement log line"
+            entry = stmts[-1]
+            for key in ("audit_cpu_us", "metadata_us", "throttle_wait_us",
+                        "execute_us", "warnings_us", "backup_us",
+                        "round_trips"):
+                assert isinstance(entry[key], int), key
+            assert entry["execute_us"] > 0
+            assert entry["round_trips"] >= 1
+            assert "server_us" not in entry
+        finally:
+            set_inception_var("inception_audit_log", original if original else "")
+            try:
+                remote_execute(f"DROP DATABASE IF EXISTS `{db}`")
+            except Exception:
+                pass
+            if os.path.exists(log_file):
+                os.remove(log_file)
+
+    def test_audit_log_server_timing(self, test_db_name):
+        """--enable-server-timing adds the target's own statement timing."""
+        import json as json_mod
+        import os
+        log_file = "/tmp/inception_test_audit_server_timing.log"
+        if os.path.exists(log_file):
+            os.remove(log_file)
+        db = f"{test_db_name}_srvtiming"
+        original = get_inception_var("inception_audit_log")
+        set_inception_var("inception_audit_log", log_file)
+        try:
+            inception_execute(f"CREATE DATABASE {db};",
+                              extra_params="--enable-server-timing=1;")
+            entries = []
+            for _ in range(50):
+                if os.path.exists(log_file):
+                    with open(log_file, "r") as f:
+                        entries = [json_mod.loads(l) for l in f if l.strip()]
+                    if any(e["type"] == "statement" for e in entries):
+                        break
+                time.sleep(0.1)
+            stmts = [e for e in entries if e["type"] == "statement"]
+            assert stmts, "Should have a statement log line"
+            entry = stmts[-1]
+            ps = remote_query("SELECT @@performance_schema")
+            if not ps or str(ps[0][0]) != "1":
+                assert "server_us" not in entry
+                return
+            for key in ("server_us", "lock_us", "rows_examined"):
+                assert isinstance(entry[key], int), key
+                assert entry[key] >= 0, key
+            assert entry["server_us"] <= entry["execute_us"]
+        finally:
+            set_inception_var("inception_audit_log", original if original else "")
+            try:
+                remote_execute(f"DROP DATABASE IF EXISTS `{db}`")
+            except Exception:
+                pass
+            if os.path.exists(log_file):
+                os.remove(log_file)
+
+    def test_show_audit_log_columns(self):
+        """inception show audit_log returns one row of writer counters."""
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show audit_log")
+            cols = [desc[0] for desc in cur.description]
+            rows = cur.fetchall()
+        finally:
+            conn.close()
+        assert cols == ["path", "queued", "queued_bytes", "written",
+                        "dropped", "rotations", "syncs"]
+        assert len(rows) == 1
+
+    def test_audit_log_rotate_size(self, test_db_name):
+        """A tiny rotate size moves the previous file aside."""
+        import glob
+        import os
+        log_file = "/tmp/inception_test_audit_rotate.log"
+        for f in glob.glob(log_file + "*"):
+            os.remove(f)
+        original = get_inception_var("inception_audit_log")
+        set_inception_var("inception_audit_log_rotate_size", 1)
+        set_inception_var("inception_audit_log", log_file)
+        try:
+            inception_check("SELECT 1;")
+            inception_check("SELECT 1;")
+            rotated = []
+            for _ in range(50):
+                rotated = glob.glob(log_file + ".*")
+                if rotated:
+                    break
+                time.sleep(0.1)
+            assert rotated, "Previous audit log should be renamed on rotation"
+        finally:
+            set_inception_var("inception_audit_log", original if original else "")
+            set_inception_var("inception_audit_log_rotate_size", 0)
+            for f in glob.glob(log_file + "*"):
+                os.remove(f)
+
     def test_audit_log_disabled_by_default(self):
         """When audit log is empty, no log file should be created."""
         original = get_inception_var("inception_audit_log")
@@ -3512,6 +4102,101 @@ class TestAuditLog:
         rows = inception_check("SELECT 1;")
         assert len(rows) > 0
 
+    @staticmethod
+    def _collector(handler_status=200):
+        """HTTP collector in a thread; returns (server, received bodies)."""
+        import gzip
+        import threading
+        from http.server import BaseHTTPRequestHandler, HTTPServer
+        received = []
+
+        class Handler(BaseHTTPRequestHandler):
+            protocol_version = "HTTP/1.1"
+
+            def do_POST(self):
+                body = self.rfile.read(int(self.headers["Content-Length"]))
+                if self.headers.get("Content-Encoding") == "gzip":
+                    body = gzip.decompress(body)
+                if handler_status == 200:
+                    received.append(body.decode("utf-8"))
+                self.send_response(handler_status)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+
+            def log_message(self, *args):
+                pass
+
+        server = HTTPServer(("127.0.0.1", 0), Handler)
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        return server, received
+
+    def _ship_session(self, test_db_name, received):
+        import json as json_mod
+        inception_check(f"CREATE DATABASE {test_db_name}_auditsink;")
+        for _ in range(50):
+            records = [json_mod.loads(line)
+                       for body in received for line in body.splitlines()]
+            if any(r["type"] == "session" for r in records):
+                return records
+            time.sleep(0.1)
+        return []
+
+    def test_audit_sink_receives_records(self, test_db_name):
+        """Records are POSTed as JSON lines to inception_audit_sink."""
+        server, received = self._collector()
+        original = get_inception_var("inception_audit_sink")
+        set_inception_var("inception_audit_sink",
+                          f"http://127.0.0.1:{server.server_port}/ingest")
+        set_inception_var("inception_audit_sink_compress", True)
+        try:
+            records = self._ship_session(test_db_name, received)
+            assert any(r["type"] == "session" and "statements" in r
+                       for r in records)
+        finally:
+            set_inception_var("inception_audit_sink", original or "")
+            set_inception_var("inception_audit_sink_compress", False)
+            server.shutdown()
+
+    def test_audit_sink_spools_while_down(self, test_db_name):
+        """Records refused by the sink wait in the spool and arrive later."""
+        import os
+        import shutil
+        failing, _ = self._collector(handler_status=503)
+        spool_dir = "/tmp/inception_test_sink_spool"
+        shutil.rmtree(spool_dir, ignore_errors=True)
+        os.makedirs(spool_dir)
+        os.chmod(spool_dir, 0o777)
+        original = get_inception_var("inception_audit_sink")
+        set_inception_var("inception_audit_sink_spool_dir", spool_dir)
+        set_inception_var("inception_audit_sink",
+                          f"http://127.0.0.1:{failing.server_port}/ingest")
+        try:
+            before = inception_status("Inception_audit_sink_spooled")
+            inception_check(f"CREATE DATABASE {test_db_name}_auditsink;")
+            for _ in range(50):
+                if inception_status("Inception_audit_sink_spooled") > before:
+                    break
+                time.sleep(0.1)
+            assert inception_status("Inception_audit_sink_spooled") > before
+
+            server, received = self._collector()
+            set_inception_var("inception_audit_sink",
+                              f"http://127.0.0.1:{server.server_port}/ingest")
+            import json as json_mod
+            for _ in range(100):
+                records = [json_mod.loads(line)
+                           for body in received for line in body.splitlines()]
+                if any(r["type"] == "session" for r in records):
+                    break
+                time.sleep(0.1)
+            assert any(r["type"] == "session" for r in records)
+            server.shutdown()
+        finally:
+            set_inception_var("inception_audit_sink", original or "")
+            set_inception_var("inception_audit_sink_spool_dir", "")
+            failing.shutdown()
+            shutil.rmtree(spool_dir, ignore_errors=True)
+
 
 # ===========================================================================
 # ORDER BY RAND() Check
@@ -4567,8 +5252,7 @@ class TestDDLAlgorithm:
             pytest.skip(f"MySQL-only tests, current db_type={db_type}")
 
     def test_add_column_algorithm_matches_detected_mysql_version(self, test_db_name):
-        """ADD COLUMN algorithm should follow detected MySQL major/minor version."""
-        _, _, major, minor = _detected_db_profile()
+        """ADD COLUMN at the end is INSTANT from MySQL 8.0.12 on."""
         remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
         remote_execute(
             f"CREATE TABLE `{test_db_name}`.t1 ("
@@ -4582,7 +5266,7 @@ class TestDDLAlgorithm:
         )
         alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
         assert len(alter_rows) > 0
-        expected = "INSTANT" if (major >= 8) else "INPLACE"
+        expected = "INSTANT" if _remote_version_key() >= 80012 else "INPLACE"
         assert alter_rows[0]["ddl_algorithm"] == expected
 
     def test_add_index_inplace(self, test_db_name):
@@ -4690,12 +5374,110 @@ class TestDDLAlgorithm:
         # ADD COLUMN=INSTANT + ADD INDEX=INPLACE → worst is INPLACE
         assert alter_rows[0]["ddl_algorithm"] == "INPLACE"
 
+    def _predict(self, test_db_name, columns, alter, options=""):
+        """ddl_algorithm of alter on a remote t1 (id, <columns>)."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  {columns},"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 {options} "
+            f"COMMENT 'alg test'"
+        )
+        rows = inception_check(f"USE {test_db_name};\n{alter}")
+        alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
+        assert len(alter_rows) > 0
+        return alter_rows[0]["ddl_algorithm"]
+
+    def test_varchar_widening_same_length_bytes_inplace(self, test_db_name):
+        """VARCHAR(20) → VARCHAR(50) utf8mb4 keeps 1 length byte: INPLACE."""
+        assert self._predict(
+            test_db_name, "name VARCHAR(20) NOT NULL COMMENT 'n'",
+            "ALTER TABLE t1 MODIFY COLUMN name VARCHAR(50) NOT NULL "
+            "COMMENT 'n';") == "INPLACE"
+
+    def test_varchar_shrinking_copy(self, test_db_name):
+        """Shortening a VARCHAR copies the table."""
+        assert self._predict(
+            test_db_name, "name VARCHAR(50) NOT NULL COMMENT 'n'",
+            "ALTER TABLE t1 MODIFY COLUMN name VARCHAR(20) NOT NULL "
+            "COMMENT 'n';") == "COPY"
+
+    def test_enum_append_instant(self, test_db_name):
+        """Appending ENUM members within the same storage size is INSTANT."""
+        assert self._predict(
+            test_db_name, "st ENUM('a','b') NOT NULL COMMENT 's'",
+            "ALTER TABLE t1 MODIFY COLUMN st ENUM('a','b','c') NOT NULL "
+            "COMMENT 's';") == "INSTANT"
+
+    def test_enum_reorder_copy(self, test_db_name):
+        """Inserting an ENUM member before existing ones renumbers: COPY."""
+        assert self._predict(
+            test_db_name, "st ENUM('a','b') NOT NULL COMMENT 's'",
+            "ALTER TABLE t1 MODIFY COLUMN st ENUM('c','a','b') NOT NULL "
+            "COMMENT 's';") == "COPY"
+
+    def test_nullability_change_inplace(self, test_db_name):
+        """NOT NULL → NULL with the same type rebuilds in place."""
+        assert self._predict(
+            test_db_name, "age INT NOT NULL COMMENT 'a'",
+            "ALTER TABLE t1 MODIFY COLUMN age INT NULL COMMENT 'a';"
+        ) == "INPLACE"
+
+    def test_change_column_rename_only(self, test_db_name):
+        """CHANGE with the same definition is a rename: INSTANT from 8.0.28."""
+        expected = "INSTANT" if _remote_version_key() >= 80028 else "INPLACE"
+        assert self._predict(
+            test_db_name, "age INT NOT NULL COMMENT 'a'",
+            "ALTER TABLE t1 CHANGE COLUMN age years INT NOT NULL "
+            "COMMENT 'a';") == expected
+
+    def test_add_column_after_follows_version(self, test_db_name):
+        """ADD COLUMN ... AFTER is INSTANT from 8.0.29, INPLACE before."""
+        expected = "INSTANT" if _remote_version_key() >= 80029 else "INPLACE"
+        assert self._predict(
+            test_db_name, "age INT NOT NULL COMMENT 'a'",
+            "ALTER TABLE t1 ADD COLUMN c1 INT COMMENT 'c' AFTER id;"
+        ) == expected
+
+    def test_add_column_after_rebuild_warned(self, test_db_name):
+        """Before 8.0.29 the position alone costs the INSTANT add: warned."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  age INT NOT NULL COMMENT 'a',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT 'alg test'"
+        )
+        rows = inception_check(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t1 ADD COLUMN c1 INT COMMENT 'c' AFTER id;\n"
+            f"ALTER TABLE t1 ADD COLUMN c2 INT COMMENT 'c';"
+        )
+        alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
+        warned = "FIRST / AFTER" in (alter_rows[0]["err_message"] or "")
+        assert warned == (_remote_version_key() < 80029)
+        assert "FIRST / AFTER" not in (alter_rows[1]["err_message"] or "")
+
+    def test_add_column_compressed_inplace(self, test_db_name):
+        """ROW_FORMAT=COMPRESSED tables never add columns INSTANT."""
+        try:
+            result = self._predict(
+                test_db_name, "age INT NOT NULL COMMENT 'a'",
+                "ALTER TABLE t1 ADD COLUMN c1 INT COMMENT 'c';",
+                options="ROW_FORMAT=COMPRESSED")
+        except Exception:
+            pytest.skip("Remote cannot create compressed tables")
+        assert result == "INPLACE"
+
 
 class TestShowSessions:
     """Test the 'inception show sessions' command."""
 
-    def test_sessions_returns_12_columns(self):
-        """inception show sessions should return 12 columns."""
+    def test_sessions_returns_17_columns(self):
+        """inception show sessions should return 17 columns."""
         import pymysql
         from conftest import INCEPTION_HOST, INCEPTION_PORT
         conn = pymysql.connect(
@@ -4708,8 +5490,10 @@ class TestShowSessions:
             col_names = [desc[0] for desc in cur.description]
             expected = [
                 "thread_id", "host", "port", "user", "mode", "db_type",
-                "sleep_ms", "total_sql", "executed_sql", "elapsed",
+                "sleep_ms", "paused", "total_sql", "executed_sql", "elapsed",
                 "threads_running", "repl_delay",
+                "prefetch_tables", "prefetch_time", "chunk_progress",
+                "sched", "stmt_progress",
             ]
             assert col_names == expected, f"Columns: {col_names}"
         finally:
@@ -4774,48 +5558,126 @@ class TestShowSessions:
         t.join(timeout=30)
         set_inception_var("inception_check_nullable", 1)
 
+    def test_sessions_progress_counters(self, test_db_name):
+        """executed_sql advances during the batch and never passes total_sql."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
 
-# ===========================================================================
-# inception set sleep
-# ===========================================================================
+        set_inception_var("inception_check_nullable", 0)
 
-class TestSetSleep:
-    """Test the 'inception set sleep' command."""
+        def run_execute():
+            try:
+                inception_execute(
+                    f"CREATE DATABASE {test_db_name};\n"
+                    f"USE {test_db_name};\n"
+                    f"CREATE TABLE t1 ("
+                    f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                    f"  PRIMARY KEY (id)"
+                    f") ENGINE=InnoDB COMMENT 'progress test';\n"
+                    f"INSERT INTO t1 (id) VALUES (1);\n"
+                    f"INSERT INTO t1 (id) VALUES (2);\n"
+                    f"INSERT INTO t1 (id) VALUES (3);",
+                    extra_params="--sleep=1000;",
+                )
+            except Exception:
+                pass
+
+        t = threading.Thread(target=run_execute)
+        t.start()
+        time.sleep(1.5)
 
-    def test_set_sleep_nonexistent_thread(self):
-        """inception set sleep on nonexistent thread should error."""
-        import pymysql
-        from conftest import INCEPTION_HOST, INCEPTION_PORT
         conn = pymysql.connect(
             host=INCEPTION_HOST, port=INCEPTION_PORT,
             user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
         )
         try:
             cur = conn.cursor()
-            with pytest.raises(pymysql.err.OperationalError):
-                cur.execute("inception set sleep 999999 1000")
+            seen = []
+            for _ in range(4):
+                cur.execute("inception show sessions")
+                sessions = cur.fetchall()
+                tids = [s["thread_id"] for s in sessions]
+                assert tids == sorted(tids)
+                for s in sessions:
+                    if s["mode"] == "EXECUTE":
+                        assert 0 <= s["executed_sql"] <= s["total_sql"]
+                        seen.append(s["executed_sql"])
+                time.sleep(1)
+            if not seen:
+                pytest.skip("No active EXECUTE session found")
+            assert seen == sorted(seen)
+            assert seen[-1] > 0
         finally:
             conn.close()
 
-    def test_set_sleep_bad_syntax(self):
-        """inception set sleep with wrong args should error."""
+        t.join(timeout=30)
+        set_inception_var("inception_check_nullable", 1)
+
+    def test_plain_connection_not_listed(self):
+        """Ordinary queries must not register an inception session."""
         import pymysql
         from conftest import INCEPTION_HOST, INCEPTION_PORT
         conn = pymysql.connect(
             host=INCEPTION_HOST, port=INCEPTION_PORT,
             user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
         )
         try:
             cur = conn.cursor()
-            with pytest.raises(pymysql.err.OperationalError):
-                cur.execute("inception set sleep abc")
+            cur.execute("SELECT CONNECTION_ID() AS tid")
+            tid = cur.fetchone()["tid"]
+            cur.execute("SELECT 1")
+            cur.execute("USE mysql")
+            cur.execute("inception show sessions")
+            tids = [s["thread_id"] for s in cur.fetchall()]
+            assert tid not in tids
         finally:
             conn.close()
 
-    def test_set_sleep_dynamic_adjustment(self, test_db_name):
-        """inception set sleep should dynamically adjust a running session's interval."""
-        import pymysql
-        import threading
+
+# ===========================================================================
+# inception set sleep
+# ===========================================================================
+
+class TestSetSleep:
+    """Test the 'inception set sleep' command."""
+
+    def test_set_sleep_nonexistent_thread(self):
+        """inception set sleep on nonexistent thread should error."""
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+        )
+        try:
+            cur = conn.cursor()
+            with pytest.raises(pymysql.err.OperationalError):
+                cur.execute("inception set sleep 999999 1000")
+        finally:
+            conn.close()
+
+    def test_set_sleep_bad_syntax(self):
+        """inception set sleep with wrong args should error."""
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+        )
+        try:
+            cur = conn.cursor()
+            with pytest.raises(pymysql.err.OperationalError):
+                cur.execute("inception set sleep abc")
+        finally:
+            conn.close()
+
+    def test_set_sleep_dynamic_adjustment(self, test_db_name):
+        """inception set sleep should dynamically adjust a running session's interval."""
+        import pymysql
+        import threading
         from conftest import (INCEPTION_HOST, INCEPTION_PORT,
                               REMOTE_HOST as RH, REMOTE_PORT as RP,
                               REMOTE_USER as RU, REMOTE_PASSWORD as RPW)
@@ -5088,7 +5950,7 @@ class TestAlterSubTypes:
         assert alter_rows[0]["ddl_algorithm"] == "COPY"
 
     def test_ddl_algorithm_drop_column_inplace(self, test_db_name):
-        """DROP COLUMN → INPLACE."""
+        """DROP COLUMN → INPLACE, INSTANT from MySQL 8.0.29 on."""
         remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
         remote_execute(
             f"CREATE TABLE `{test_db_name}`.t1 ("
@@ -5103,7 +5965,11 @@ class TestAlterSubTypes:
         )
         alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
         assert len(alter_rows) > 0
-        assert alter_rows[0]["ddl_algorithm"] == "INPLACE"
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "MySQL" and _remote_version_key() >= 80029:
+            assert alter_rows[0]["ddl_algorithm"] == "INSTANT"
+        else:
+            assert alter_rows[0]["ddl_algorithm"] == "INPLACE"
 
     def test_ddl_algorithm_drop_index_inplace(self, test_db_name):
         """DROP INDEX → INPLACE."""
@@ -5867,3 +6733,3401 @@ class TestQueryTreeCompleteness:
         join_cols = [c["column"] for c in tree["columns"].get("join", [])]
         assert "dept_id" in join_cols or "id" in join_cols, \
             f"Expected join columns in INSERT...SELECT, got: {join_cols}"
+
+
+# ===========================================================================
+# Remote metadata cache
+# ===========================================================================
+
+class TestMetadataCache:
+    """Test the shared remote metadata cache and 'inception show cache'."""
+
+    @pytest.fixture(autouse=True)
+    def enable_cache(self, test_db_name):
+        set_inception_var("inception_metadata_cache_ttl", 60)
+        try:
+            remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+            remote_execute(
+                f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`t_cache` ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+                f"  name VARCHAR(50) NOT NULL,"
+                f"  PRIMARY KEY (id),"
+                f"  INDEX idx_name (name)"
+                f") ENGINE=InnoDB"
+            )
+        except Exception:
+            pytest.skip("Cannot set up remote test table")
+        yield
+        set_inception_var("inception_metadata_cache_ttl", 0)
+
+    def _show_cache(self):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show cache")
+            cols = [desc[0] for desc in cur.description]
+            return cols, cur.fetchall()
+        finally:
+            conn.close()
+
+    def test_show_cache_columns(self):
+        """inception show cache should return 10 columns."""
+        cols, _ = self._show_cache()
+        assert cols == [
+            "target", "db_name", "table_name", "exists", "columns",
+            "indexes", "table_rows", "hits", "age", "watched",
+        ]
+
+    def test_table_loaded_once_and_reused(self, test_db_name):
+        """Repeated checks on one table are answered from one cache entry."""
+        sql = (f"USE {test_db_name};\n"
+               f"ALTER TABLE t_cache ADD COLUMN age INT NOT NULL DEFAULT 0 "
+               f"COMMENT 'age';")
+        inception_check(sql)
+        inception_check(sql)
+        _, entries = self._show_cache()
+        mine = [e for e in entries
+                if e["db_name"] == test_db_name and e["table_name"] == "t_cache"]
+        assert len(mine) == 1
+        assert mine[0]["exists"] == "YES"
+        assert mine[0]["columns"] == 2
+        assert mine[0]["indexes"] == 2
+        assert mine[0]["hits"] > 0
+
+    def test_executed_ddl_invalidates_entry(self, test_db_name):
+        """After EXECUTE adds a column, later checks must see it."""
+        inception_check(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t_cache DROP COLUMN name;"
+        )
+        inception_execute(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t_cache ADD COLUMN age INT NOT NULL DEFAULT 0 "
+            f"COMMENT 'age';",
+            extra_params="--enable-ignore-warnings=1;",
+        )
+        rows = inception_check(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t_cache DROP COLUMN age;"
+        )
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alter_row) > 0
+        assert "does not exist" not in (alter_row[0]["err_message"] or "")
+
+    def test_use_db_prefetches_schema(self, test_db_name):
+        """USE db in a CHECK batch loads the whole schema into the cache."""
+        remote_execute(
+            f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`t_cache2` ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB"
+        )
+        inception_check(f"USE {test_db_name};\nSELECT 1;")
+        _, entries = self._show_cache()
+        names = {e["table_name"] for e in entries
+                 if e["db_name"] == test_db_name}
+        assert {"t_cache", "t_cache2"} <= names
+
+    def test_prefetch_disabled(self, test_db_name):
+        """inception_metadata_prefetch=OFF leaves unreferenced tables out."""
+        set_inception_var("inception_metadata_prefetch", False)
+        try:
+            inception_check(f"USE {test_db_name};\nSELECT 1;")
+            _, entries = self._show_cache()
+            names = {e["table_name"] for e in entries
+                     if e["db_name"] == test_db_name}
+            assert "t_cache" not in names
+        finally:
+            set_inception_var("inception_metadata_prefetch", True)
+
+    def test_statement_tables_preloaded_together(self, test_db_name):
+        """Every table a statement references is loaded into the cache."""
+        remote_execute(
+            f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`t_cache2` ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB"
+        )
+        set_inception_var("inception_metadata_prefetch", False)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"INSERT INTO t_cache (name) SELECT 'x' FROM t_cache2 "
+                f"WHERE id > 0;"
+            )
+            assert len(rows) == 2
+            _, entries = self._show_cache()
+            mine = {e["table_name"]: e for e in entries
+                    if e["db_name"] == test_db_name}
+            assert mine["t_cache"]["exists"] == "YES"
+            assert mine["t_cache2"]["exists"] == "YES"
+            assert mine["t_cache2"]["columns"] == 1
+        finally:
+            set_inception_var("inception_metadata_prefetch", True)
+
+    def test_statement_tables_preloaded_without_cache(self, test_db_name):
+        """With the cache off, a join costs no query per extra table."""
+        for t in ("t_join_a", "t_join_b", "t_join_c", "t_join_d"):
+            remote_execute(
+                f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`{t}` ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB"
+            )
+        set_inception_var("inception_metadata_cache_ttl", 0)
+        set_inception_var("inception_metadata_prefetch", False)
+
+        def queries(sql):
+            before = inception_status("Inception_remote_queries")
+            rows = inception_check(f"USE {test_db_name};\n{sql}")
+            assert len(rows) == 2
+            for r in rows:
+                assert "does not exist" not in r["err_message"], r
+            return inception_status("Inception_remote_queries") - before
+
+        try:
+            two = queries("INSERT INTO t_cache (name) SELECT 'x' "
+                          "FROM t_join_a a WHERE a.id > 0;")
+            five = queries("INSERT INTO t_cache (name) SELECT 'x' "
+                           "FROM t_join_a a JOIN t_join_b b ON a.id = b.id "
+                           "JOIN t_join_c c ON b.id = c.id "
+                           "JOIN t_join_d d ON c.id = d.id WHERE a.id > 0;")
+        finally:
+            set_inception_var("inception_metadata_prefetch", True)
+        assert five - two <= 1
+
+    def test_invalidated_during_load_not_cached(self, test_db_name):
+        """A table invalidated while it loads answers the statement but is
+        not kept in the cache."""
+        if get_inception_var("debug") is None:
+            pytest.skip("Needs a debug build")
+        import uuid
+        table = f"t_race_{uuid.uuid4().hex[:8]}"
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.`{table}` ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'race'"
+        )
+        point = "inception_invalidate_during_metadata_load"
+        set_inception_var("inception_metadata_prefetch", False)
+        set_inception_var("debug", f"+d,{point}")
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE {table} ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c1';")
+        finally:
+            set_inception_var("debug", f"-d,{point}")
+            set_inception_var("inception_metadata_prefetch", True)
+            remote_execute(f"DROP TABLE IF EXISTS `{test_db_name}`.`{table}`")
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert "does not exist" not in (alter_row[0]["err_message"] or "")
+        _, entries = self._show_cache()
+        assert not [e for e in entries if e["table_name"] == table]
+
+    def test_prefetch_invalidated_during_load_not_cached(self, test_db_name):
+        """A schema prefetch that overlaps an invalidation keeps nothing."""
+        if get_inception_var("debug") is None:
+            pytest.skip("Needs a debug build")
+        import uuid
+        table = f"t_race_{uuid.uuid4().hex[:8]}"
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.`{table}` ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB"
+        )
+        point = "inception_invalidate_during_metadata_load"
+        set_inception_var("debug", f"+d,{point}")
+        try:
+            inception_check(f"USE {test_db_name};\nSELECT 1;")
+        finally:
+            set_inception_var("debug", f"-d,{point}")
+            remote_execute(f"DROP TABLE IF EXISTS `{test_db_name}`.`{table}`")
+        _, entries = self._show_cache()
+        assert not [e for e in entries if e["table_name"] == table]
+
+    def test_name_case_shares_entry(self, test_db_name):
+        """With lower_case_table_names set on the target, t_cache and
+        T_CACHE are one entry."""
+        rows = remote_query("SELECT @@lower_case_table_names")
+        if int(rows[0][0]) == 0:
+            pytest.skip("Target compares names case-sensitively")
+        set_inception_var("inception_metadata_prefetch", False)
+        try:
+            for name in ("t_cache", "T_CACHE"):
+                inception_check(
+                    f"USE {test_db_name};\n"
+                    f"ALTER TABLE {name} ADD COLUMN age INT NOT NULL "
+                    f"DEFAULT 0 COMMENT 'age';")
+        finally:
+            set_inception_var("inception_metadata_prefetch", True)
+        _, entries = self._show_cache()
+        mine = [e for e in entries
+                if e["db_name"].lower() == test_db_name.lower()
+                and e["table_name"].lower() == "t_cache"]
+        assert len(mine) == 1
+        assert mine[0]["hits"] > 0
+
+    def test_shared_cache_tier(self, test_db_name):
+        """A miss is stored in the shared tier; executed DDL moves the
+        version of its target there."""
+        from conftest import (REMOTE_HOST, REMOTE_PORT, REMOTE_USER,
+                              REMOTE_PASSWORD)
+        table = "t_cache_shared"
+        remote_execute(f"DROP TABLE IF EXISTS `{test_db_name}`.`{table}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.`{table}` ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'shared'"
+        )
+        target = f"{REMOTE_HOST}:{REMOTE_PORT}"
+
+        def epoch():
+            rows = remote_query(
+                "SELECT COALESCE(MAX(epoch), 0) FROM "
+                f"inception_shared.target_epoch WHERE target = '{target}'")
+            return int(rows[0][0])
+
+        set_inception_var("inception_metadata_prefetch", False)
+        set_inception_var("inception_shared_cache_host", REMOTE_HOST)
+        set_inception_var("inception_shared_cache_port", REMOTE_PORT)
+        set_inception_var("inception_shared_cache_user", REMOTE_USER or "")
+        set_inception_var("inception_shared_cache_password",
+                          REMOTE_PASSWORD or "")
+        try:
+            inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE {table} ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c1';")
+            rows = remote_query(
+                "SELECT meta FROM inception_shared.table_meta "
+                f"WHERE target = '{target}' AND db_name = '{test_db_name}' "
+                f"AND table_name = '{table}'")
+            assert rows and rows[0][0].startswith(b"table\t")
+            before = epoch()
+            inception_execute(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE {table} ADD COLUMN c2 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c2';")
+            assert epoch() > before
+        finally:
+            set_inception_var("inception_shared_cache_host", "")
+            set_inception_var("inception_shared_cache_user", "")
+            set_inception_var("inception_shared_cache_password", "")
+            set_inception_var("inception_shared_cache_port", 3306)
+            set_inception_var("inception_metadata_prefetch", True)
+            remote_execute(f"DROP TABLE IF EXISTS `{test_db_name}`.`{table}`")
+
+
+class TestConnectionPool:
+    """Test the shared remote connection pool and 'inception show pool'."""
+
+    def _show_pool(self):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show pool")
+            cols = [desc[0] for desc in cur.description]
+            return cols, cur.fetchall()
+        finally:
+            conn.close()
+
+    def _hits(self):
+        _, rows = self._show_pool()
+        return sum(r["hits"] for r in rows)
+
+    def test_show_pool_columns(self):
+        """inception show pool should return 6 columns."""
+        cols, _ = self._show_pool()
+        assert cols == ["target", "user", "idle", "in_use", "hits", "misses"]
+
+    def test_check_sessions_reuse_connection(self, test_db_name):
+        """A second CHECK session borrows the connection of the first."""
+        sql = f"USE {test_db_name};\nSELECT 1 FROM t_not_exist_pool;"
+        inception_check(sql)
+        before = self._hits()
+        inception_check(sql)
+        assert self._hits() > before
+        _, rows = self._show_pool()
+        assert all(r["in_use"] == 0 for r in rows)
+        assert any(r["idle"] > 0 for r in rows)
+
+    def test_magic_start_does_not_wait_for_connect(self):
+        """magic_start returns at once; the first statement reports the
+        connection opened in the background."""
+        from conftest import (
+            _build_magic_start, _connect_inception, _find_inception_result,
+        )
+        magic_start = _build_magic_start(
+            host="10.255.255.1", port=3306, mode_option="--enable-check=1",
+            user="root", password="",
+        )
+        conn = _connect_inception(multi_statements=True)
+        try:
+            cur = conn.cursor()
+            start = time.time()
+            cur.execute(magic_start)
+            assert time.time() - start < 2
+            cur.execute("SELECT 1;\n/*inception_magic_commit;*/")
+            rows = _find_inception_result(cur)
+        finally:
+            conn.close()
+        assert rows
+        assert "Cannot connect" in rows[0]["err_message"]
+
+
+
+class TestChunkedDML:
+    """Test --enable-chunked-dml primary-key chunking in EXECUTE mode."""
+
+    def test_chunked_delete_affects_all_rows(self, test_db_name):
+        """A chunked DELETE still removes every matching row."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        old_chunk = get_inception_var("inception_exec_chunk_size")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        set_inception_var("inception_exec_chunk_size", 3)
+        try:
+            values = ", ".join(f"({i}, 'n{i}')" for i in range(1, 11))
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'chunk test';\n"
+                f"INSERT INTO t1 (id, name) VALUES {values};\n"
+                f"DELETE FROM t1 WHERE id <> 5;",
+                extra_params="--enable-chunked-dml=1;",
+            )
+            delete_row = [r for r in rows if "DELETE" in r["sql_text"]][0]
+            assert delete_row["err_level"] == 0, delete_row["err_message"]
+            assert delete_row["affected_rows"] == 9
+            remaining = remote_query(f"SELECT id FROM {test_db_name}.t1")
+            assert [r[0] for r in remaining] == [5]
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+            set_inception_var("inception_exec_chunk_size", old_chunk)
+
+
+class TestTiDBBatchDML:
+    """Test --enable-tidb-batch-dml batching of large TiDB UPDATE/DELETE."""
+
+    @staticmethod
+    def _delete(test_db_name):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'batch dml test'"
+        )
+        values = ", ".join(f"({i}, 'n{i}')" for i in range(1, 11))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES {values}")
+        old_min = get_inception_var("inception_exec_tidb_batch_min_rows")
+        old_chunk = get_inception_var("inception_exec_chunk_size")
+        set_inception_var("inception_exec_tidb_batch_min_rows", 0)
+        set_inception_var("inception_exec_chunk_size", 3)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"DELETE FROM t1 WHERE id <> 5;",
+                extra_params="--enable-tidb-batch-dml=1;",
+            )
+        finally:
+            set_inception_var("inception_exec_tidb_batch_min_rows", old_min)
+            set_inception_var("inception_exec_chunk_size", old_chunk)
+        remaining = remote_query(f"SELECT id FROM `{test_db_name}`.t1")
+        assert [r[0] for r in remaining] == [5]
+        return [r for r in rows if "DELETE" in r["sql_text"]][0]
+
+    def test_tidb_delete_runs_in_batches(self, test_db_name):
+        """On TiDB the DELETE runs in batches and removes every matching row."""
+        db_type, _, major, minor = _detected_db_profile()
+        if db_type != "TiDB":
+            pytest.skip(f"TiDB-only test, current db_type={db_type}")
+        row = self._delete(test_db_name)
+        assert row["err_level"] == 0, row["err_message"]
+        if (major, minor) >= (6, 1):
+            assert row["stage_status"].startswith("Execute completed (")
+            assert row["stage_status"].endswith(" batches)")
+        else:
+            assert row["stage_status"] == "Execute completed"
+
+    def test_mysql_target_ignores_option(self, test_db_name):
+        """On MySQL the option leaves the DELETE as one statement."""
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "TiDB":
+            pytest.skip("MySQL-only test")
+        row = self._delete(test_db_name)
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["stage_status"] == "Execute completed"
+        assert row["affected_rows"] == 9
+
+
+class TestBatchedExecute:
+    """Test multi-statement batching (inception_exec_batch_statements)."""
+
+    def test_batch_demultiplexes_results(self, test_db_name):
+        """Rows, warnings and errors are still reported per statement."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        old_batch = get_inception_var("inception_exec_batch_statements")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        set_inception_var("inception_exec_batch_statements", 10)
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'batch test';\n"
+                f"INSERT INTO t1 (id, name) VALUES (1, 'a'), (2, 'b');\n"
+                f"INSERT INTO t1 (id, name) VALUES (3, 'c');\n"
+                f"UPDATE t1 SET name = 'x' WHERE id <= 3;\n"
+                f"INSERT INTO t1 (id, name) VALUES (3, 'dup');\n"
+                f"INSERT INTO t1 (id, name) VALUES (4, 'd');",
+                extra_params="--enable-remote-backup=0;",
+            )
+            dml = [r for r in rows if r["sql_type"] in ("INSERT", "UPDATE")]
+            assert [r["affected_rows"] for r in dml[:3]] == [2, 1, 3]
+            assert all(r["err_level"] == 0 for r in dml[:3])
+            assert dml[3]["err_level"] == 2
+            assert "Duplicate" in dml[3]["err_message"]
+            assert "Skipped" in dml[4]["err_message"]
+            ids = remote_query(f"SELECT id FROM {test_db_name}.t1 ORDER BY id")
+            assert [r[0] for r in ids] == [1, 2, 3]
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+            set_inception_var("inception_exec_batch_statements", old_batch)
+
+
+class TestMergedInsert:
+    """Test merging of single-row INSERTs (inception_exec_merge_inserts)."""
+
+    def test_single_row_inserts_are_merged(self, test_db_name):
+        """Consecutive same-shape INSERTs run as one, reported per row."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        try:
+            inserts = "".join(
+                f"INSERT INTO t1 (id, name) VALUES ({i}, 'n{i}');\n"
+                for i in range(1, 6))
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'merge test';\n"
+                f"{inserts}"
+                f"INSERT INTO t1 (name, id) VALUES ('other', 6);",
+                extra_params="--enable-remote-backup=0;",
+            )
+            ins = [r for r in rows if r["sql_type"] == "INSERT"]
+            assert len(ins) == 6
+            for r in ins:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["affected_rows"] == 1
+            first, last = ins[0]["id"], ins[4]["id"]
+            for r in ins[:5]:
+                assert r["stage_status"] == (
+                    f"Execute completed (merged INSERT, ids {first}-{last})")
+            assert ins[5]["stage_status"] == "Execute completed"
+            count = remote_query(f"SELECT COUNT(*) FROM {test_db_name}.t1")
+            assert count[0][0] == 6
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+
+
+class TestPreparedExecute:
+    """Test prepared execution of repeated shapes (inception_exec_prepare_min_repeats)."""
+
+    def test_repeated_updates_run_prepared(self, test_db_name):
+        """Same-fingerprint UPDATEs run through COM_STMT_EXECUTE with bound literals."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        old_repeats = get_inception_var("inception_exec_prepare_min_repeats")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        set_inception_var("inception_exec_prepare_min_repeats", 3)
+        try:
+            updates = "".join(
+                f"UPDATE t1 SET name = 'it''s {i}', price = {i}.25 "
+                f"WHERE id = {i};\n"
+                for i in range(1, 5))
+            before = remote_query(
+                "SHOW GLOBAL STATUS LIKE 'Com_stmt_execute'")[0][1]
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  price DECIMAL(10,2) NOT NULL COMMENT 'price',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'prepare test';\n"
+                f"INSERT INTO t1 (id, name, price) VALUES "
+                f"(1, 'a', 0), (2, 'b', 0), (3, 'c', 0), (4, 'd', 0);\n"
+                f"{updates}",
+                extra_params="--enable-remote-backup=0;",
+            )
+            after = remote_query(
+                "SHOW GLOBAL STATUS LIKE 'Com_stmt_execute'")[0][1]
+            upd = [r for r in rows if r["sql_type"] == "UPDATE"]
+            assert len(upd) == 4
+            for r in upd:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["affected_rows"] == 1
+            assert int(after) - int(before) >= 4
+            data = remote_query(
+                f"SELECT id, name, price FROM {test_db_name}.t1 ORDER BY id")
+            assert [(r[0], r[1], str(r[2])) for r in data] == [
+                (i, f"it's {i}", f"{i}.25") for i in range(1, 5)]
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+            set_inception_var("inception_exec_prepare_min_repeats", old_repeats)
+
+
+class TestMergeAlterExecute:
+    """Test --enable-merge-alter folding of adjacent ALTERs in EXECUTE mode."""
+
+    def test_adjacent_alters_run_as_one(self, test_db_name):
+        """Adjacent ALTERs of one table run as one statement, reported per row."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'merge alter test';\n"
+                f"ALTER TABLE t1 ADD COLUMN a INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+                f"ALTER TABLE t1 ADD COLUMN b INT NOT NULL DEFAULT 0 COMMENT 'b';\n"
+                f"ALTER TABLE t1 ADD INDEX idx_a (a);",
+                extra_params="--enable-merge-alter=1;",
+            )
+            alters = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+            assert len(alters) == 3
+            first, last = alters[0]["id"], alters[2]["id"]
+            for r in alters:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["stage_status"] == (
+                    f"Execute completed (merged ALTER, ids {first}-{last})")
+            assert "ADD INDEX idx_a" in alters[0]["sql_text"]
+            cols = remote_query(
+                f"SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+                f"WHERE TABLE_SCHEMA = '{test_db_name}' AND TABLE_NAME = 't1' "
+                f"ORDER BY ORDINAL_POSITION")
+            assert [c[0] for c in cols] == ["id", "a", "b"]
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+
+    def test_conflicting_alter_is_not_merged(self, test_db_name):
+        """An ALTER touching a column changed earlier in the run still warns."""
+        rows = inception_execute(
+            f"CREATE DATABASE {test_db_name};\n"
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'merge alter test';\n"
+            f"ALTER TABLE t1 ADD COLUMN a INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+            f"ALTER TABLE t1 MODIFY COLUMN a BIGINT NOT NULL DEFAULT 0 COMMENT 'a';",
+            extra_params="--enable-merge-alter=1;",
+        )
+        alters = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alters) == 2
+        assert "altered before" in alters[1]["err_message"].lower()
+
+
+class TestOnlineAlterExecute:
+    """Test --enable-online-alter ALGORITHM/LOCK clauses in EXECUTE mode."""
+
+    @staticmethod
+    def _alter(test_db_name, alter, extra_params="--enable-online-alter=1;"):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  a INT NOT NULL DEFAULT 0 COMMENT 'a',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'online alter test'"
+        )
+        rows = inception_execute(f"USE {test_db_name};\n{alter}",
+                                 extra_params=extra_params)
+        alters = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert len(alters) == 1
+        return alters[0]
+
+    def test_add_index_runs_inplace_lock_none(self, test_db_name):
+        """A predicted INPLACE ALTER runs with ALGORITHM=INPLACE, LOCK=NONE."""
+        row = self._alter(test_db_name, "ALTER TABLE t1 ADD INDEX idx_a (a);")
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["ddl_algorithm"] == "INPLACE"
+        assert row["stage_status"] == "Execute completed (ALGORITHM=INPLACE)"
+        idx = remote_query(
+            f"SELECT COUNT(*) FROM information_schema.STATISTICS "
+            f"WHERE TABLE_SCHEMA = '{test_db_name}' AND TABLE_NAME = 't1' "
+            f"AND INDEX_NAME = 'idx_a'")
+        assert idx[0][0] == 1
+
+    def test_add_column_reports_algorithm_used(self, test_db_name):
+        """ADD COLUMN reports the algorithm the target accepted."""
+        row = self._alter(
+            test_db_name,
+            "ALTER TABLE t1 ADD COLUMN b INT NOT NULL DEFAULT 0 COMMENT 'b';")
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["ddl_algorithm"] in ("INSTANT", "INPLACE")
+        assert row["stage_status"] == (
+            f"Execute completed (ALGORITHM={row['ddl_algorithm']})")
+
+    def test_explicit_algorithm_is_left_alone(self, test_db_name):
+        """An ALTER naming its own ALGORITHM runs as written."""
+        row = self._alter(
+            test_db_name,
+            "ALTER TABLE t1 ADD INDEX idx_a (a), ALGORITHM=INPLACE;")
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["stage_status"] == "Execute completed"
+
+    def test_off_by_default(self, test_db_name):
+        """Without the option the ALTER runs as written."""
+        row = self._alter(test_db_name, "ALTER TABLE t1 ADD INDEX idx_a (a);",
+                          extra_params="")
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["stage_status"] == "Execute completed"
+
+    def test_fallback_variable(self):
+        """inception_exec_online_alter_fallback defaults to OSC."""
+        assert get_inception_var("inception_exec_online_alter_fallback") == "OSC"
+
+
+class TestAsyncJobs:
+    """Test --enable-async background execution jobs."""
+
+    @staticmethod
+    def _submit(sql_block):
+        from conftest import (
+            _build_magic_start, _connect_inception, REMOTE_USER, REMOTE_PASSWORD,
+        )
+        magic_start = _build_magic_start(
+            host=REMOTE_HOST, port=REMOTE_PORT, mode_option="--enable-execute=1",
+            user=REMOTE_USER, password=REMOTE_PASSWORD,
+            extra_params="--enable-async=1;",
+        )
+        full_sql = f"{magic_start}\n{sql_block}\n/*inception_magic_commit;*/"
+        conn = _connect_inception(multi_statements=True)
+        try:
+            cur = conn.cursor()
+            cur.execute(full_sql)
+            while True:
+                if cur.description:
+                    columns = [desc[0] for desc in cur.description]
+                    if "job_id" in columns:
+                        return dict(zip(columns, cur.fetchone()))
+                if not cur.nextset():
+                    break
+            return None
+        finally:
+            conn.close()
+
+    def test_commit_returns_job_and_results_are_polled(self, test_db_name):
+        """Commit returns a job id; the results come from get results."""
+        from conftest import _connect_inception, _find_inception_result
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        try:
+            job = self._submit(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'async job test';\n"
+                f"INSERT INTO t1 (id) VALUES (1);"
+            )
+            assert job is not None
+            assert job["stage"] == "QUEUED"
+            assert job["total_sql"] == 4
+            job_id = job["job_id"]
+
+            conn = _connect_inception()
+            try:
+                cur = conn.cursor()
+                state = None
+                for _ in range(100):
+                    cur.execute("inception show jobs")
+                    columns = [desc[0] for desc in cur.description]
+                    jobs = [dict(zip(columns, r)) for r in cur.fetchall()]
+                    mine = [j for j in jobs if j["job_id"] == job_id]
+                    assert len(mine) == 1
+                    state = mine[0]["state"]
+                    if state == "FINISHED":
+                        break
+                    time.sleep(0.1)
+                assert state == "FINISHED"
+                assert mine[0]["executed_sql"] == 4
+                assert mine[0]["errors"] == 0
+
+                cur.execute(f"inception get results {job_id}")
+                rows = _find_inception_result(cur)
+            finally:
+                conn.close()
+            assert len(rows) == 4
+            for r in rows:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["stage"] == "EXECUTED"
+            count = remote_query(f"SELECT COUNT(*) FROM {test_db_name}.t1")
+            assert count[0][0] == 1
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+
+    def test_get_results_of_unknown_job(self):
+        """get results of a job that does not exist is an error."""
+        import pymysql
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            cur = conn.cursor()
+            with pytest.raises(pymysql.err.MySQLError, match="not found"):
+                cur.execute("inception get results 18446744073709551615")
+        finally:
+            conn.close()
+
+
+class TestKeptResults:
+    """Test inception get results session: paging kept result sets."""
+
+    @pytest.fixture(autouse=True)
+    def _keep(self):
+        old = get_inception_var("inception_result_keep_time")
+        set_inception_var("inception_result_keep_time", 60)
+        yield
+        set_inception_var("inception_result_keep_time", old)
+
+    def _check(self, db):
+        """CHECK a batch with two errors; returns (thread_id, rows)."""
+        from conftest import (REMOTE_HOST, REMOTE_PORT, REMOTE_USER,
+                              REMOTE_PASSWORD, _build_magic_start,
+                              _connect_inception, _find_inception_result)
+        sql = (f"CREATE DATABASE {db};\n"
+               f"USE {db};\n"
+               f"CREATE TABLE t1 ("
+               f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+               f"  PRIMARY KEY (id)"
+               f") ENGINE=InnoDB COMMENT 'kept results test';\n"
+               f"INSERT INTO t1 (id) VALUES (1);\n"
+               f"INSERT INTO no_such_a (id) VALUES (1);\n"
+               f"INSERT INTO t1 (id) VALUES (2);\n"
+               f"INSERT INTO no_such_b (id) VALUES (1);")
+        magic_start = _build_magic_start(
+            host=REMOTE_HOST, port=REMOTE_PORT, mode_option="--enable-check=1",
+            user=REMOTE_USER, password=REMOTE_PASSWORD)
+        conn = _connect_inception(multi_statements=True)
+        try:
+            cur = conn.cursor()
+            cur.execute("SELECT CONNECTION_ID()")
+            thread_id = cur.fetchone()[0]
+            cur.execute(f"{magic_start}\n{sql}\n/*inception_magic_commit;*/")
+            rows = _find_inception_result(cur)
+        finally:
+            conn.close()
+        return thread_id, rows
+
+    def _get(self, args):
+        from conftest import _connect_inception, _find_inception_result
+        conn = _connect_inception()
+        try:
+            cur = conn.cursor()
+            cur.execute(f"inception get results {args}")
+            return _find_inception_result(cur)
+        finally:
+            conn.close()
+
+    def test_pages_after_disconnect(self, test_db_name):
+        """The result set outlives its connection and pages like a slice."""
+        thread_id, rows = self._check(test_db_name)
+        assert len(rows) == 7
+        assert self._get(f"session {thread_id}") == rows
+        assert self._get(f"session {thread_id} 2 3") == rows[2:5]
+        assert self._get(f"session {thread_id} 5") == rows[5:]
+        assert self._get(f"session {thread_id} 100 10") == []
+
+    def test_errors_first(self, test_db_name):
+        """errlevel>=2 pages through the errors only."""
+        thread_id, rows = self._check(test_db_name)
+        errors = [r for r in rows if r["err_level"] >= 2]
+        assert len(errors) >= 2
+        assert self._get(f"session {thread_id} errlevel>=2") == errors
+        assert self._get(f"session {thread_id} 1 1 errlevel>=2") == errors[1:2]
+
+    def test_not_kept_when_disabled(self, test_db_name):
+        """With inception_result_keep_time=0 nothing is kept."""
+        import pymysql
+        set_inception_var("inception_result_keep_time", 0)
+        thread_id, _ = self._check(test_db_name)
+        set_inception_var("inception_result_keep_time", 60)
+        with pytest.raises(pymysql.err.MySQLError, match="No results kept"):
+            self._get(f"session {thread_id}")
+
+    def test_bad_page_is_an_error(self):
+        """Anything but [offset [limit]] [errlevel>=N] is refused."""
+        import pymysql
+        for args in ("session", "session 1 x", "session 1 2 3 4",
+                     "session 1 errlevel>=3", "session 1 errlevel>=1 2"):
+            with pytest.raises(pymysql.err.MySQLError, match="Usage"):
+                self._get(args)
+
+
+class TestExecScheduler:
+    """Test the per-target execution scheduler."""
+
+    def test_batch_queues_behind_session_limit(self, test_db_name):
+        """With one slot per target, a second batch waits for the first."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        other_db = f"{test_db_name}_b"
+        old_limit = get_inception_var("inception_exec_max_sessions_per_target")
+        old_nullable = get_inception_var("inception_check_nullable")
+        set_inception_var("inception_exec_max_sessions_per_target", 1)
+        set_inception_var("inception_check_nullable", 0)
+        results = {}
+
+        def run(key, db, extra):
+            try:
+                results[key] = inception_execute(
+                    f"CREATE DATABASE {db};\n"
+                    f"USE {db};\n"
+                    f"CREATE TABLE t1 ("
+                    f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                    f"  PRIMARY KEY (id)"
+                    f") ENGINE=InnoDB COMMENT 'sched test';",
+                    extra_params=extra,
+                )
+            except Exception as e:
+                results[key] = str(e)
+
+        first = threading.Thread(
+            target=run, args=("first", test_db_name, "--sleep=2000;"))
+        second = threading.Thread(
+            target=run, args=("second", other_db, "--priority=5;"))
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            first.start()
+            time.sleep(1.0)
+            second.start()
+            time.sleep(1.0)
+            cur = conn.cursor()
+            cur.execute("inception show sessions")
+            states = sorted(s["sched"] for s in cur.fetchall()
+                            if s["mode"] == "EXECUTE")
+            assert states == ["QUEUED 1/1", "RUNNING"], states
+            first.join(timeout=60)
+            second.join(timeout=60)
+            for key in ("first", "second"):
+                rows = results[key]
+                assert isinstance(rows, list), rows
+                for r in rows:
+                    assert r["err_level"] == 0, r["err_message"]
+                    assert r["stage"] == "EXECUTED"
+        finally:
+            conn.close()
+            set_inception_var("inception_exec_max_sessions_per_target", old_limit)
+            set_inception_var("inception_check_nullable", old_nullable)
+            remote_execute(f"DROP DATABASE IF EXISTS `{other_db}`")
+
+
+class TestAdmissionControl:
+    """Test per-target admission of CHECK sessions and metadata queries."""
+
+    @staticmethod
+    def _admission():
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show admission")
+            return cur.fetchall()
+        finally:
+            conn.close()
+
+    def test_checks_pass_at_limit_one(self, test_db_name):
+        """Concurrent checks all finish with one slot of each kind."""
+        import threading
+        names = ("inception_check_max_sessions_per_target",
+                 "inception_check_max_queries_per_target")
+        old = {n: get_inception_var(n) for n in names}
+        for n in names:
+            set_inception_var(n, 1)
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.t1 ("
+            f"id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT, PRIMARY KEY (id))")
+        results = []
+
+        def run():
+            try:
+                results.append(inception_check(
+                    f"USE {test_db_name};\n"
+                    f"ALTER TABLE t1 ADD COLUMN c INT NOT NULL DEFAULT 0 "
+                    f"COMMENT 'c';"))
+            except Exception as e:
+                results.append(str(e))
+
+        try:
+            threads = [threading.Thread(target=run) for _ in range(4)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join(timeout=60)
+            assert len(results) == 4
+            for rows in results:
+                assert isinstance(rows, list), rows
+                assert "Killed" not in str(rows)
+            kinds = {r["kind"]: r for r in self._admission()}
+            assert kinds["CHECK"]["max"] == 1
+            assert kinds["CHECK"]["admitted"] >= 4
+            assert kinds["CHECK"]["running"] == 0
+            assert kinds["QUERY"]["admitted"] >= 1
+        finally:
+            for n in names:
+                set_inception_var(n, old[n])
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+    def test_show_admission_columns(self):
+        """inception show admission should return 9 columns."""
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show admission")
+            cols = [d[0] for d in cur.description]
+            assert cols == ["target", "kind", "max", "running", "queued",
+                            "admitted", "waited", "wait_ms", "max_wait_ms"]
+        finally:
+            conn.close()
+
+
+class TestSessionControl:
+    """Test that kill / pause / resume wake an executing session at once."""
+
+    @staticmethod
+    def _batch(db):
+        return (
+            f"CREATE DATABASE {db};\n"
+            f"USE {db};\n"
+            f"CREATE TABLE t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'control test';\n"
+            f"INSERT INTO t1 (id) VALUES (1);"
+        )
+
+    @staticmethod
+    def _exec_session(cur):
+        cur.execute("inception show sessions")
+        sessions = [s for s in cur.fetchall() if s["mode"] == "EXECUTE"]
+        assert len(sessions) == 1, sessions
+        return sessions[0]
+
+    def test_kill_interrupts_sleep(self, test_db_name):
+        """inception kill ends a long --sleep without waiting it out."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        old_nullable = get_inception_var("inception_check_nullable")
+        set_inception_var("inception_check_nullable", 0)
+        result = {}
+
+        def run():
+            result["rows"] = inception_execute(
+                self._batch(test_db_name), extra_params="--sleep=60000;")
+
+        t = threading.Thread(target=run)
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            t.start()
+            time.sleep(1.0)
+            cur = conn.cursor()
+            sess = self._exec_session(cur)
+            killed_at = time.time()
+            cur.execute(f"inception kill {sess['thread_id']}")
+            t.join(timeout=30)
+            assert not t.is_alive()
+            assert time.time() - killed_at < 5
+            statuses = [r["stage_status"] for r in result["rows"]]
+            assert statuses[-1] == "Killed by user", statuses
+        finally:
+            conn.close()
+            set_inception_var("inception_check_nullable", old_nullable)
+
+    def test_pause_and_resume(self, test_db_name):
+        """A paused session runs no statement until it is resumed."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        old_nullable = get_inception_var("inception_check_nullable")
+        set_inception_var("inception_check_nullable", 0)
+        result = {}
+
+        def run():
+            result["rows"] = inception_execute(
+                self._batch(test_db_name), extra_params="--sleep=1000;")
+
+        t = threading.Thread(target=run)
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            t.start()
+            time.sleep(0.5)
+            cur = conn.cursor()
+            tid = self._exec_session(cur)["thread_id"]
+            cur.execute(f"inception pause {tid}")
+            time.sleep(0.2)
+            sess = self._exec_session(cur)
+            assert sess["paused"] == 1
+            executed = sess["executed_sql"]
+            time.sleep(2.5)
+            assert self._exec_session(cur)["executed_sql"] == executed
+            cur.execute(f"inception resume {tid}")
+            t.join(timeout=30)
+            assert not t.is_alive()
+            for r in result["rows"]:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["stage"] == "EXECUTED"
+        finally:
+            conn.close()
+            set_inception_var("inception_check_nullable", old_nullable)
+
+    def test_pause_unknown_thread(self):
+        """Pausing a thread without an inception session is an error."""
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+        )
+        try:
+            cur = conn.cursor()
+            with pytest.raises(pymysql.err.MySQLError, match="not found"):
+                cur.execute("inception pause 4294967295")
+        finally:
+            conn.close()
+
+
+class TestStatementMonitor:
+    """Test the load monitor that runs while a statement executes."""
+
+    def _run(self, test_db_name, abort):
+        old = {k: get_inception_var(k) for k in (
+            "inception_check_nullable",
+            "inception_exec_monitor_max_threads_running",
+            "inception_exec_monitor_abort")}
+        set_inception_var("inception_check_nullable", 0)
+        # The statement and the monitor's own SHOW STATUS already make 2
+        set_inception_var("inception_exec_monitor_max_threads_running", 1)
+        set_inception_var("inception_exec_monitor_abort", 1 if abort else 0)
+        try:
+            return inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  v INT NOT NULL DEFAULT 0 COMMENT 'v',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'monitor test';\n"
+                f"INSERT INTO t1 (id, v) VALUES (1, 0);\n"
+                f"UPDATE t1 SET v = 1 WHERE id = 1 AND SLEEP(3) = 0;",
+                extra_params="--enable-ignore-warnings=1;",
+            )
+        finally:
+            for k, v in old.items():
+                set_inception_var(k, v)
+
+    def test_breach_is_reported(self, test_db_name):
+        """A ceiling crossed mid-statement is reported as a warning."""
+        rows = self._run(test_db_name, abort=False)
+        update = [r for r in rows if r["sql_text"].startswith("UPDATE")][0]
+        assert update["stage_status"] == "Execute completed"
+        assert update["err_level"] == 1
+        assert "Threads_running=" in update["err_message"]
+
+    def test_breach_kills_statement(self, test_db_name):
+        """With inception_exec_monitor_abort=ON the statement is killed."""
+        started = time.time()
+        rows = self._run(test_db_name, abort=True)
+        update = [r for r in rows if r["sql_text"].startswith("UPDATE")][0]
+        assert update["err_level"] == 2
+        assert "load monitor" in update["err_message"]
+        assert time.time() - started < 10
+        value = remote_query(f"SELECT v FROM {test_db_name}.t1 WHERE id = 1")
+        assert value[0][0] == 0
+
+
+class TestReplicationHeartbeat:
+    """Test the heartbeat table behind inception_exec_heartbeat_table."""
+
+    def test_heartbeat_row_written_on_primary(self, test_db_name):
+        """A batch with --slave-hosts keeps a heartbeat row on the primary."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        old = {k: get_inception_var(k) for k in (
+            "inception_check_nullable",
+            "inception_exec_heartbeat_table",
+            "inception_exec_max_replication_delay")}
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_exec_heartbeat_table", f"{test_db_name}.hb")
+        set_inception_var("inception_exec_max_replication_delay", 3600)
+        before = int(time.time() * 1000000)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'heartbeat test';",
+                extra_params=(f"--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};"
+                              "--enable-ignore-warnings=1;"),
+            )
+        finally:
+            for k, v in old.items():
+                set_inception_var(k, v if v is not None else "")
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+        hb = remote_query(f"SELECT id, ts FROM `{test_db_name}`.hb")
+        assert len(hb) == 1
+        # Written from the inception clock, in microseconds
+        assert hb[0][1] >= before - 60 * 1000000
+
+    def test_invalid_heartbeat_table_is_ignored(self, test_db_name):
+        """A value that is not db.table leaves Seconds_Behind_Master in use."""
+        old = get_inception_var("inception_exec_heartbeat_table")
+        set_inception_var("inception_exec_heartbeat_table", "no_dot")
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};",
+                extra_params=f"--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};",
+            )
+        finally:
+            set_inception_var("inception_exec_heartbeat_table",
+                              old if old is not None else "")
+        assert rows[-1]["err_level"] == 0, rows[-1]["err_message"]
+
+
+class TestVerifyExecute:
+    """Test --enable-verify chunked checksums against the replicas."""
+
+    @staticmethod
+    def _update(test_db_name, extra_params):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'verify test'"
+        )
+        values = ", ".join(f"({i}, 'n{i}')" for i in range(1, 11))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES {values}")
+        old_chunk = get_inception_var("inception_verify_chunk_size")
+        set_inception_var("inception_verify_chunk_size", 3)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"UPDATE t1 SET name = NULL WHERE id = 4;",
+                extra_params=extra_params,
+            )
+        finally:
+            set_inception_var("inception_verify_chunk_size", old_chunk)
+        return [r for r in rows if "UPDATE" in r["sql_text"]][0]
+
+    def test_identical_replica_is_verified(self, test_db_name):
+        """Every range matches on a replica holding the same rows."""
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "TiDB":
+            pytest.skip("Verification needs MySQL")
+        # The target itself stands in for a replica in sync with it
+        row = self._update(
+            test_db_name,
+            f"--enable-verify=1;--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};")
+        assert row["err_level"] == 0, row["err_message"]
+        # ids 1-3, 4-6, 7-9 and 10
+        assert row["stage_status"] == "Execute completed (verified: 4 chunks)"
+
+    def test_without_replicas_is_skipped(self, test_db_name):
+        """Without --slave-hosts there is nothing to compare with."""
+        row = self._update(test_db_name, "--enable-verify=1;")
+        assert row["stage_status"] == "Execute completed"
+        assert "no --slave-hosts" in row["err_message"]
+
+    def test_off_by_default(self, test_db_name):
+        """Without the option nothing is verified."""
+        row = self._update(test_db_name,
+                           f"--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};")
+        assert row["err_level"] == 0, row["err_message"]
+        assert row["stage_status"] == "Execute completed"
+
+
+class TestColumnDataCheck:
+    """Test inception_check_column_data scans on the replica."""
+
+    @staticmethod
+    def _check(test_db_name, alter, extra_params):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'column data test'"
+        )
+        values = ", ".join(f"({i}, '{'x' * i}')" for i in range(1, 31))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES {values}")
+        old = {k: get_inception_var(k) for k in (
+            "inception_check_column_data",
+            "inception_column_data_chunk_size")}
+        set_inception_var("inception_check_column_data", 1)
+        set_inception_var("inception_column_data_chunk_size", 7)
+        try:
+            rows = inception_check(f"USE {test_db_name};\n{alter}",
+                                   extra_params=extra_params)
+        finally:
+            for k, v in old.items():
+                set_inception_var(k, v)
+        return [r for r in rows if "ALTER" in r["sql_text"]][0]
+
+    def test_values_too_long_are_reported(self, test_db_name):
+        """The longest value on the replica is compared with the new length."""
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "TiDB":
+            pytest.skip("Column data checks need a MySQL replica")
+        # The target itself stands in for a replica in sync with it
+        row = self._check(
+            test_db_name,
+            "ALTER TABLE t1 MODIFY name VARCHAR(20) NOT NULL COMMENT 'name';",
+            f"--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};")
+        assert "holds values of up to 30 characters" in row["err_message"]
+
+    def test_values_that_fit_are_not_reported(self, test_db_name):
+        """A shorter column that still holds every value is not reported."""
+        row = self._check(
+            test_db_name,
+            "ALTER TABLE t1 MODIFY name VARCHAR(40) NOT NULL COMMENT 'name';",
+            f"--slave-hosts={REMOTE_HOST}:{REMOTE_PORT};")
+        assert "holds values" not in (row["err_message"] or "")
+
+    def test_without_replicas_nothing_is_scanned(self, test_db_name):
+        """Without --slave-hosts the primary is never scanned."""
+        row = self._check(
+            test_db_name,
+            "ALTER TABLE t1 MODIFY name VARCHAR(20) NOT NULL COMMENT 'name';",
+            "")
+        assert "holds values" not in (row["err_message"] or "")
+
+
+class TestAuditHost:
+    """Test routing the read-only audit queries to --audit-host."""
+
+    def test_unreachable_audit_host_falls_back(self, test_db_name):
+        """Metadata comes from the target when the replica cannot be reached."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id INT NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'audit host test'"
+        )
+        rows = inception_check(
+            f"USE {test_db_name};\n"
+            f"ALTER TABLE t1 ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+            f"COMMENT 'c1';\n"
+            f"ALTER TABLE t_missing ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+            f"COMMENT 'c1';",
+            extra_params="--audit-host=127.0.0.1:1;")
+        assert "does not exist" not in (rows[1]["err_message"] or "")
+        assert "does not exist" in rows[2]["err_message"]
+
+    def test_invalid_audit_host(self):
+        """Anything but one host:port is refused."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="Invalid --audit-host"):
+            inception_check("SELECT 1;",
+                            extra_params="--audit-host=10.0.0.1:3306,10.0.0.2:3306;")
+
+
+class TestSharedLoadSampler:
+    """Test the throttle reading the shared per-target load sampler."""
+
+    def test_concurrent_batches_under_ceilings(self, test_db_name):
+        """Batches sharing one sampler run through when below every ceiling."""
+        import threading
+        old = {k: get_inception_var(k) for k in (
+            "inception_check_nullable",
+            "inception_exec_max_threads_running",
+            "inception_exec_max_history_list_length",
+            "inception_exec_load_sample_interval_ms")}
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_exec_max_threads_running", 100000)
+        set_inception_var("inception_exec_max_history_list_length", 4294967295)
+        set_inception_var("inception_exec_load_sample_interval_ms", 100)
+        results = {}
+
+        def run(i):
+            db = f"{test_db_name}_{i}"
+            try:
+                results[i] = inception_execute(
+                    f"CREATE DATABASE {db};\n"
+                    f"USE {db};\n"
+                    f"CREATE TABLE t1 ("
+                    f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                    f"  PRIMARY KEY (id)"
+                    f") ENGINE=InnoDB COMMENT 'sampler test';\n"
+                    f"INSERT INTO t1 (id) VALUES (1);",
+                    extra_params="--enable-remote-backup=0;",
+                )
+            except Exception as e:  # reported by the assert below
+                results[i] = e
+
+        try:
+            threads = [threading.Thread(target=run, args=(i,)) for i in range(3)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join(60)
+        finally:
+            for k, v in old.items():
+                set_inception_var(k, v)
+            for i in range(3):
+                remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}_{i}`")
+        for i in range(3):
+            assert not isinstance(results.get(i), Exception), results.get(i)
+            for r in results[i]:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["stage"] == "EXECUTED"
+
+
+class TestAdaptiveThrottle:
+    """Test inception_exec_adaptive_throttle pacing instead of waiting."""
+
+    def _run(self, test_db_name, settings):
+        keys = ["inception_check_nullable", "inception_exec_adaptive_throttle",
+                "inception_exec_load_sample_interval_ms"] + list(settings)
+        old = {k: get_inception_var(k) for k in keys}
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_exec_adaptive_throttle", 1)
+        set_inception_var("inception_exec_load_sample_interval_ms", 100)
+        for k, v in settings.items():
+            set_inception_var(k, v)
+        started = time.time()
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'adaptive test';\n"
+                f"INSERT INTO t1 (id) VALUES (1);\n"
+                f"INSERT INTO t1 (id) VALUES (2);",
+                extra_params="--enable-remote-backup=0;",
+            )
+        finally:
+            for k, v in old.items():
+                set_inception_var(k, v)
+        return rows, time.time() - started
+
+    def test_crossed_ceiling_paces_instead_of_stalling(self, test_db_name):
+        """A ceiling that is always crossed slows the batch without stopping it."""
+        # The sampler's own SHOW STATUS already counts as one running thread
+        rows, elapsed = self._run(test_db_name, {
+            "inception_exec_max_threads_running": 1,
+            "inception_exec_adaptive_max_pause_ms": 200,
+        })
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        assert elapsed < 30
+
+    def test_all_signals_below_ceilings(self, test_db_name):
+        """With every signal under its ceiling the batch runs at full speed."""
+        rows, elapsed = self._run(test_db_name, {
+            "inception_exec_max_threads_running": 100000,
+            "inception_exec_max_checkpoint_age_pct": 100,
+            "inception_exec_max_statement_p99_ms": 3600000,
+        })
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+        assert elapsed < 10
+
+
+class TestTargetRateBudget:
+    """Test the per-target rows/statements per second budget."""
+
+    def _command(self, sql):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+        )
+        try:
+            conn.cursor().execute(sql)
+        finally:
+            conn.close()
+
+    def test_set_rate_and_default(self):
+        """inception set rate accepts a budget and 'default'."""
+        self._command(f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} 1000 10")
+        self._command(f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} default")
+
+    def test_set_rate_bad_syntax(self):
+        """inception set rate with a missing port or values should error."""
+        import pymysql
+        for sql in ("inception set rate abc 1 1",
+                    f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} 1",
+                    f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} x 1"):
+            with pytest.raises(pymysql.err.OperationalError):
+                self._command(sql)
+
+    def test_statement_budget_slows_batch(self, test_db_name):
+        """2 statements/s on the target spreads the batch out but runs it all."""
+        old = get_inception_var("inception_check_nullable")
+        set_inception_var("inception_check_nullable", 0)
+        self._command(f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} 0 2")
+        started = time.time()
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'rate test';\n"
+                f"INSERT INTO t1 (id) VALUES (1);\n"
+                f"INSERT INTO t1 (id) VALUES (2);\n"
+                f"INSERT INTO t1 (id) VALUES (3);",
+                extra_params="--enable-remote-backup=0;",
+            )
+        finally:
+            self._command(
+                f"inception set rate {REMOTE_HOST}:{REMOTE_PORT} default")
+            set_inception_var("inception_check_nullable", old)
+        elapsed = time.time() - started
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        # A full bucket of 2 pays for the first statements, the rest wait
+        assert elapsed >= 1.0
+
+
+class TestMdlGuardedDDL:
+    """Test inception_exec_ddl_lock_wait_timeout pre-flight and retries."""
+
+    def test_ddl_waits_out_open_transaction(self, test_db_name):
+        """An ALTER behind an open transaction gives up instead of queueing."""
+        import pymysql
+        from conftest import REMOTE_USER_DIRECT, REMOTE_PASSWORD_DIRECT
+        remote_execute(f"CREATE DATABASE {test_db_name}")
+        remote_execute(
+            f"CREATE TABLE {test_db_name}.t1 (id INT NOT NULL PRIMARY KEY "
+            f"COMMENT 'pk') ENGINE=InnoDB COMMENT 'mdl test'")
+        blocker = pymysql.connect(
+            host=REMOTE_HOST, port=REMOTE_PORT, user=REMOTE_USER_DIRECT,
+            password=REMOTE_PASSWORD_DIRECT, charset="utf8mb4",
+        )
+        keys = ["inception_check_nullable", "inception_exec_ddl_lock_wait_timeout",
+                "inception_exec_ddl_lock_retries"]
+        old = {k: get_inception_var(k) for k in keys}
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_exec_ddl_lock_wait_timeout", 1)
+        set_inception_var("inception_exec_ddl_lock_retries", 1)
+        started = time.time()
+        try:
+            cur = blocker.cursor()
+            cur.execute("BEGIN")
+            cur.execute(f"SELECT * FROM {test_db_name}.t1")
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c1';",
+                extra_params="--enable-remote-backup=0;",
+            )
+        finally:
+            blocker.rollback()
+            blocker.close()
+            for k, v in old.items():
+                set_inception_var(k, v)
+        elapsed = time.time() - started
+        alter = [r for r in rows if "ALTER" in r["sql_text"].upper()][0]
+        assert alter["err_level"] == 2
+        assert "metadata lock" in alter["err_message"]
+        # One backoff (1s) and no statement left queued on the table
+        assert elapsed < 15
+        cols = remote_query(
+            f"SELECT COLUMN_NAME FROM information_schema.COLUMNS "
+            f"WHERE TABLE_SCHEMA='{test_db_name}' AND TABLE_NAME='t1'")
+        assert [c[0] for c in cols] == ["id"]
+
+    def test_ddl_runs_when_table_is_free(self, test_db_name):
+        """Without blockers the guarded ALTER runs on the first attempt."""
+        old = get_inception_var("inception_exec_ddl_lock_wait_timeout")
+        set_inception_var("inception_exec_ddl_lock_wait_timeout", 2)
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 (id INT NOT NULL PRIMARY KEY COMMENT 'pk') "
+                f"ENGINE=InnoDB COMMENT 'mdl test';\n"
+                f"ALTER TABLE t1 ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c1';",
+                extra_params="--enable-remote-backup=0;",
+            )
+        finally:
+            set_inception_var("inception_exec_ddl_lock_wait_timeout", old)
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+
+
+class TestStatementProgress:
+    """Test the stmt_progress column of a long ALTER TABLE."""
+
+    def test_alter_reports_progress(self, test_db_name):
+        """A rebuilding ALTER shows percent complete while it runs."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        remote_execute(
+            "UPDATE performance_schema.setup_consumers SET ENABLED = 'YES' "
+            "WHERE NAME LIKE 'events_stages_%'")
+        remote_execute(
+            "UPDATE performance_schema.setup_instruments SET ENABLED = 'YES', "
+            "TIMED = 'YES' WHERE NAME LIKE 'stage/innodb/alter%'")
+        remote_execute(f"CREATE DATABASE {test_db_name}")
+        remote_execute(
+            f"CREATE TABLE {test_db_name}.t1 (id INT NOT NULL PRIMARY KEY "
+            f"COMMENT 'pk', pad CHAR(200) NOT NULL DEFAULT '' COMMENT 'p') "
+            f"ENGINE=InnoDB COMMENT 'progress test'")
+        remote_execute(
+            f"INSERT INTO {test_db_name}.t1 (id, pad) "
+            f"WITH RECURSIVE seq (n) AS (SELECT 1 UNION ALL "
+            f"SELECT n + 1 FROM seq WHERE n < 500000) "
+            f"SELECT n, REPEAT('x', 200) FROM seq")
+        set_inception_var("inception_check_nullable", 0)
+        result_holder = {}
+
+        def run_execute():
+            result_holder["rows"] = inception_execute(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 ADD COLUMN c1 INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c1' AFTER id;",
+                extra_params="--enable-remote-backup=0;",
+            )
+
+        t = threading.Thread(target=run_execute)
+        t.start()
+        seen = []
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT,
+            user="root", charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            while t.is_alive():
+                cur.execute("inception show sessions")
+                seen += [s["stmt_progress"] for s in cur.fetchall()
+                         if s["mode"] == "EXECUTE" and s["stmt_progress"] != "-"]
+                time.sleep(0.3)
+        finally:
+            conn.close()
+            t.join(timeout=120)
+            set_inception_var("inception_check_nullable", 1)
+        for r in result_holder["rows"]:
+            assert r["err_level"] == 0, r["err_message"]
+        if not seen:
+            pytest.skip("ALTER finished before the first progress sample")
+        assert all(p.startswith("id=") for p in seen)
+        assert any("%" in p for p in seen), seen
+
+
+class TestResumeCheckpoint:
+    """Test inception_exec_checkpoint_dir and --resume=<batch_id>."""
+
+    CKPT_DIR = "/tmp/inception_test_checkpoints"
+
+    def _sql(self, test_db_name):
+        return (
+            f"CREATE DATABASE {test_db_name};\n"
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) COMMENT 'n',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'resume test';\n"
+            f"INSERT INTO t1 (name) VALUES ('a');\n"
+            f"INSERT INTO t1 (name) VALUES ('b');\n"
+            f"INSERT INTO t1 (name) VALUES ('c');"
+        )
+
+    def _show_checkpoints(self):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show checkpoints")
+            return cur.fetchall()
+        finally:
+            conn.close()
+
+    def _setup(self):
+        import os
+        import shutil
+        shutil.rmtree(self.CKPT_DIR, ignore_errors=True)
+        os.makedirs(self.CKPT_DIR)
+        old = {k: get_inception_var(k) for k in
+               ("inception_check_nullable", "inception_exec_checkpoint_dir")}
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_exec_checkpoint_dir", self.CKPT_DIR)
+        return old
+
+    def _teardown(self, old):
+        import shutil
+        set_inception_var("inception_check_nullable", old["inception_check_nullable"])
+        set_inception_var("inception_exec_checkpoint_dir",
+                          old["inception_exec_checkpoint_dir"] or "")
+        shutil.rmtree(self.CKPT_DIR, ignore_errors=True)
+
+    def test_completed_batch_leaves_no_checkpoint(self, test_db_name):
+        """A batch that completes removes its checkpoint."""
+        old = self._setup()
+        try:
+            rows = inception_execute(self._sql(test_db_name),
+                                     extra_params="--enable-remote-backup=0;")
+            for r in rows:
+                assert r["err_level"] == 0, r["err_message"]
+            assert self._show_checkpoints() == ()
+        finally:
+            self._teardown(old)
+
+    def test_resume_after_kill(self, test_db_name):
+        """A killed batch resumes without repeating completed statements."""
+        import pymysql
+        import threading
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        old = self._setup()
+        try:
+            holder = {}
+
+            def run_execute():
+                holder["rows"] = inception_execute(
+                    self._sql(test_db_name),
+                    extra_params="--enable-remote-backup=0;--sleep=1500;")
+
+            t = threading.Thread(target=run_execute)
+            t.start()
+            time.sleep(5)
+            conn = pymysql.connect(
+                host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+                charset="utf8mb4", autocommit=True,
+                cursorclass=pymysql.cursors.DictCursor,
+            )
+            try:
+                cur = conn.cursor()
+                cur.execute("inception show sessions")
+                for s in cur.fetchall():
+                    if s["mode"] == "EXECUTE":
+                        cur.execute(f"inception kill {s['thread_id']}")
+            finally:
+                conn.close()
+            t.join(timeout=60)
+
+            ckpts = self._show_checkpoints()
+            assert len(ckpts) == 1, ckpts
+            ckpt = ckpts[0]
+            assert ckpt["host"] == REMOTE_HOST.lower()
+            assert 0 < ckpt["completed_id"] < ckpt["total_sql"]
+
+            rows = inception_execute(
+                self._sql(test_db_name),
+                extra_params=f"--enable-remote-backup=0;"
+                             f"--resume={ckpt['batch_id']};")
+            for r in rows:
+                assert r["err_level"] == 0, r["err_message"]
+            assert any(r["stage"] == "SKIPPED" for r in rows)
+            count = remote_query(f"SELECT COUNT(*) FROM {test_db_name}.t1")
+            assert count[0][0] == 3
+            assert self._show_checkpoints() == ()
+        finally:
+            self._teardown(old)
+
+    def test_resume_unknown_batch(self, test_db_name):
+        """--resume with a batch id that has no checkpoint fails."""
+        old = self._setup()
+        try:
+            rows = inception_execute(
+                self._sql(test_db_name),
+                extra_params="--enable-remote-backup=0;--resume=nosuchbatch;")
+            assert any("No checkpoint" in (r["err_message"] or "")
+                       for r in rows)
+        finally:
+            self._teardown(old)
+
+
+class TestFanoutExecute:
+    """Test --targets / --target-group fan-out of one audited batch."""
+
+    def test_targets_run_batch_per_shard(self, test_db_name):
+        """Each target runs the batch and reports its own rows."""
+        remote_execute(f"CREATE DATABASE {test_db_name}")
+        remote_execute(
+            f"CREATE TABLE {test_db_name}.t1 (id BIGINT UNSIGNED NOT NULL "
+            f"AUTO_INCREMENT COMMENT 'pk', c INT NOT NULL DEFAULT 0 "
+            f"COMMENT 'c', PRIMARY KEY (id)) ENGINE=InnoDB COMMENT 'fan-out'")
+        # The same server twice stands in for two shards
+        target = f"{REMOTE_HOST}:{REMOTE_PORT}"
+        rows = inception_execute(
+            f"USE {test_db_name};\n"
+            f"INSERT INTO t1 (c) VALUES (1);",
+            extra_params=f"--enable-remote-backup=0;--targets={target},{target};",
+        )
+        assert len(rows) == 4
+        assert [r["target"] for r in rows] == [target] * 4
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        count = remote_query(f"SELECT COUNT(*) FROM {test_db_name}.t1")
+        assert count[0][0] == 2
+
+    def test_target_group(self, test_db_name):
+        """--target-group takes its shards from inception_target_groups."""
+        old = get_inception_var("inception_target_groups")
+        set_inception_var("inception_target_groups",
+                          f"grp1={REMOTE_HOST}:{REMOTE_PORT}")
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};",
+                extra_params="--enable-remote-backup=0;--target-group=grp1;",
+            )
+        finally:
+            set_inception_var("inception_target_groups", old or "")
+        assert len(rows) == 1
+        assert rows[0]["target"] == f"{REMOTE_HOST}:{REMOTE_PORT}"
+        assert rows[0]["stage"] == "EXECUTED", rows[0]["err_message"]
+
+    def test_unknown_target_group(self):
+        """An unknown group name fails inception_magic_start."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="Unknown target group"):
+            inception_execute(
+                "SELECT 1;", extra_params="--target-group=no_such_group;")
+
+    def test_resume_with_targets_rejected(self):
+        """--resume names one target's checkpoint and cannot fan out."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="--resume"):
+            inception_execute(
+                "SELECT 1;",
+                extra_params=f"--targets={REMOTE_HOST}:{REMOTE_PORT};"
+                             f"--resume=20260101000000_1;")
+
+
+class TestParallelExecute:
+    """Test --enable-parallel lanes of statements on unrelated tables."""
+
+    def _create_tables(self, db, names):
+        remote_execute(f"CREATE DATABASE {db}")
+        for t in names:
+            remote_execute(
+                f"CREATE TABLE {db}.{t} (id BIGINT UNSIGNED NOT NULL "
+                f"AUTO_INCREMENT COMMENT 'pk', c INT NOT NULL DEFAULT 0 "
+                f"COMMENT 'c', PRIMARY KEY (id)) ENGINE=InnoDB "
+                f"COMMENT 'parallel'")
+
+    def test_unrelated_tables_run_side_by_side(self, test_db_name):
+        """ALTERs of three tables run in three lanes, not one after another."""
+        self._create_tables(test_db_name, ["t1", "t2", "t3"])
+        sql = (f"USE {test_db_name};\n"
+               f"ALTER TABLE t1 ADD COLUMN a INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+               f"ALTER TABLE t2 ADD COLUMN a INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+               f"ALTER TABLE t3 ADD COLUMN a INT NOT NULL DEFAULT 0 COMMENT 'a';")
+        start = time.time()
+        rows = inception_execute(
+            sql, extra_params="--enable-remote-backup=0;--sleep=1000;"
+                              "--enable-parallel=1;")
+        elapsed = time.time() - start
+        assert len(rows) == 4
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        # Serially the four statements sleep 4s; each lane sleeps twice
+        assert elapsed < 3.5, f"lanes did not overlap ({elapsed:.1f}s)"
+        cols = remote_query(
+            f"SELECT COUNT(*) FROM information_schema.COLUMNS "
+            f"WHERE TABLE_SCHEMA = '{test_db_name}' AND COLUMN_NAME = 'a'")
+        assert cols[0][0] == 3
+
+    def test_same_table_keeps_batch_order(self, test_db_name):
+        """Statements of one table share a lane and run in batch order."""
+        self._create_tables(test_db_name, ["t1", "t2"])
+        rows = inception_execute(
+            f"USE {test_db_name};\n"
+            f"INSERT INTO t1 (c) VALUES (1);\n"
+            f"INSERT INTO t2 (c) VALUES (1);\n"
+            f"UPDATE t1 SET c = c + 1 WHERE id = 1;\n"
+            f"UPDATE t2 SET c = c * 10 WHERE id = 1;",
+            extra_params="--enable-remote-backup=0;--enable-parallel=1;",
+        )
+        assert [r["id"] for r in rows] == sorted(r["id"] for r in rows)
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        assert remote_query(f"SELECT c FROM {test_db_name}.t1")[0][0] == 2
+        assert remote_query(f"SELECT c FROM {test_db_name}.t2")[0][0] == 10
+
+    def test_barrier_runs_between_phases(self, test_db_name):
+        """CREATE DATABASE is a barrier: tables created after it see it."""
+        rows = inception_execute(
+            f"CREATE DATABASE {test_db_name};\n"
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t1 (id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT "
+            f"COMMENT 'pk', PRIMARY KEY (id)) ENGINE=InnoDB COMMENT 't1';\n"
+            f"CREATE TABLE t2 (id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT "
+            f"COMMENT 'pk', PRIMARY KEY (id)) ENGINE=InnoDB COMMENT 't2';",
+            extra_params="--enable-remote-backup=0;--enable-parallel=1;",
+        )
+        assert len(rows) == 4
+        for r in rows:
+            assert r["err_level"] == 0, r["err_message"]
+            assert r["stage"] == "EXECUTED"
+        tables = remote_query(
+            f"SELECT COUNT(*) FROM information_schema.TABLES "
+            f"WHERE TABLE_SCHEMA = '{test_db_name}'")
+        assert tables[0][0] == 2
+
+
+class TestAuditMemo:
+    """Test reuse of DML audit results across statements of one shape."""
+
+    def _create_table(self, db):
+        remote_execute(f"CREATE DATABASE {db}")
+        remote_execute(
+            f"CREATE TABLE {db}.t1 (id BIGINT UNSIGNED NOT NULL "
+            f"AUTO_INCREMENT COMMENT 'pk', c INT NOT NULL DEFAULT 0 "
+            f"COMMENT 'c', PRIMARY KEY (id)) ENGINE=InnoDB COMMENT 'memo'")
+
+    def test_value_count_checked_per_statement(self, test_db_name):
+        """VALUES rows differ between statements of one shape."""
+        self._create_table(test_db_name)
+        rows = inception_check(
+            f"USE {test_db_name};\n"
+            f"INSERT INTO t1 (id, c) VALUES (1, 1);\n"
+            f"INSERT INTO t1 (id, c) VALUES (2);\n"
+            f"INSERT INTO t1 (id, c) VALUES (3, 3);"
+        )
+        inserts = [r for r in rows if r["sql_text"].startswith("INSERT")]
+        assert len(inserts) == 3
+        assert inserts[0]["sql_sha1"] == inserts[1]["sql_sha1"]
+        assert "does not match" not in (inserts[0]["err_message"] or "")
+        assert "does not match" in inserts[1]["err_message"]
+        assert "does not match" not in (inserts[2]["err_message"] or "")
+
+    def test_in_clause_checked_per_statement(self, test_db_name):
+        """IN list sizes differ between statements of one shape."""
+        self._create_table(test_db_name)
+        old = get_inception_var("inception_check_in_count")
+        set_inception_var("inception_check_in_count", 3)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"UPDATE t1 SET c = 1 WHERE id IN (1, 2);\n"
+                f"UPDATE t1 SET c = 1 WHERE id IN (1, 2, 3, 4, 5);"
+            )
+        finally:
+            set_inception_var("inception_check_in_count", old)
+        updates = [r for r in rows if r["sql_text"].startswith("UPDATE")]
+        assert len(updates) == 2
+        assert "IN clause" not in (updates[0]["err_message"] or "")
+        assert "IN clause" in updates[1]["err_message"]
+
+    def test_memo_matches_full_audit(self, test_db_name):
+        """Results with the memo equal those with inception_audit_memo_size=0."""
+        self._create_table(test_db_name)
+        sql = (f"USE {test_db_name};\n"
+               + "".join(f"UPDATE t1 SET nope = {i} WHERE id = {i};\n"
+                         for i in range(5))
+               + "DELETE FROM t1 WHERE id = 1;\n"
+               + "DELETE FROM t1 WHERE id = 2;")
+        memo = inception_check(sql)
+        old = get_inception_var("inception_audit_memo_size")
+        set_inception_var("inception_audit_memo_size", 0)
+        try:
+            full = inception_check(sql)
+        finally:
+            set_inception_var("inception_audit_memo_size", old)
+        assert [(r["err_level"], r["err_message"], r["affected_rows"])
+                for r in memo] == \
+               [(r["err_level"], r["err_message"], r["affected_rows"])
+                for r in full]
+        assert "nope" in memo[1]["err_message"]
+
+
+class TestAuditCache:
+    """Test inception_audit_cache_size: resubmitted scripts re-audit only changes."""
+
+    def _script(self, db, column_comment):
+        return (f"USE {db};\n"
+                f"CREATE TABLE t_new (id BIGINT UNSIGNED NOT NULL "
+                f"AUTO_INCREMENT COMMENT 'pk', c INT NOT NULL DEFAULT 0 "
+                f"{column_comment}, PRIMARY KEY (id)) ENGINE=InnoDB "
+                f"COMMENT 'new';\n"
+                f"INSERT INTO t_new (id, c) VALUES (1, 1);\n"
+                f"UPDATE t1 SET nope = 1 WHERE id = 1;\n"
+                f"DELETE FROM t1 WHERE id = 2;")
+
+    def _results(self, rows):
+        return [(r["err_level"], r["err_message"], r["affected_rows"])
+                for r in rows if not r["sql_text"].startswith("USE")]
+
+    def test_resubmission_reuses_unchanged_statements(self, test_db_name):
+        """Unchanged statements hit; a changed one and its dependents re-audit."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 (id BIGINT UNSIGNED NOT NULL "
+            f"AUTO_INCREMENT COMMENT 'pk', PRIMARY KEY (id)) ENGINE=InnoDB "
+            f"COMMENT 't1'")
+        old_ttl = get_inception_var("inception_metadata_cache_ttl")
+        set_inception_var("inception_metadata_cache_ttl", 60)
+        try:
+            first = self._results(
+                inception_check(self._script(test_db_name, "")))
+            hits = inception_status("Inception_audit_cache_hits")
+            again = self._results(
+                inception_check(self._script(test_db_name, "")))
+            # The INSERT reads a table of the batch and is always audited
+            assert inception_status("Inception_audit_cache_hits") - hits == 3
+            assert again == first
+            assert "nope" in again[2][1]
+
+            # The CREATE changed: it re-audits, the rest is reused
+            hits = inception_status("Inception_audit_cache_hits")
+            edited = self._results(
+                inception_check(self._script(test_db_name, "COMMENT 'c'")))
+            assert inception_status("Inception_audit_cache_hits") - hits == 2
+            assert edited[1:] == first[1:]
+
+            # A stricter rule configuration is another key
+            old = get_inception_var("inception_check_column_comment")
+            set_inception_var("inception_check_column_comment", "OFF")
+            try:
+                hits = inception_status("Inception_audit_cache_hits")
+                inception_check(self._script(test_db_name, ""))
+                assert inception_status("Inception_audit_cache_hits") == hits
+            finally:
+                set_inception_var("inception_check_column_comment", old)
+        finally:
+            set_inception_var("inception_metadata_cache_ttl", int(old_ttl))
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+    def test_off_without_ttl(self, test_db_name):
+        """With inception_metadata_cache_ttl=0 nothing is reused."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        try:
+            sql = f"USE {test_db_name};\nDELETE FROM t_none WHERE id = 1;"
+            inception_check(sql)
+            hits = inception_status("Inception_audit_cache_hits")
+            inception_check(sql)
+            assert inception_status("Inception_audit_cache_hits") == hits
+        finally:
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+
+class TestInsertStream:
+    """Test inception_insert_stream_min_size: long INSERTs parse two rows."""
+
+    @pytest.fixture(autouse=True)
+    def _table(self, test_db_name):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 (id BIGINT UNSIGNED NOT NULL "
+            f"COMMENT 'pk', c VARCHAR(20) NOT NULL DEFAULT '' COMMENT 'c', "
+            f"PRIMARY KEY (id)) ENGINE=InnoDB COMMENT 't1'")
+        old = get_inception_var("inception_insert_stream_min_size")
+        set_inception_var("inception_insert_stream_min_size", 64)
+        yield
+        set_inception_var("inception_insert_stream_min_size", int(old))
+        remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+    def _insert(self, columns, rows):
+        return (f"INSERT INTO t1 ({columns}) VALUES "
+                + ", ".join(rows) + ";")
+
+    def _audit(self, db, sql):
+        streamed = inception_status("Inception_statements_streamed")
+        rows = inception_check(f"USE {db};\n{sql}")
+        row = [r for r in rows if r["sql_text"].startswith("INSERT")][0]
+        return (inception_status("Inception_statements_streamed") - streamed,
+                (row["err_level"], row["err_message"], row["sql_sha1"],
+                 row["sql_text"]))
+
+    def test_same_result_as_full_parse(self, test_db_name):
+        """Streamed and fully parsed audits of a statement agree."""
+        rows = [f"({i}, 'v{i}\\'x')" for i in range(200)]
+        for columns in ("id, c", "id, nope"):
+            sql = self._insert(columns, rows)
+            streamed, result = self._audit(test_db_name, sql)
+            assert streamed == 1
+            assert result[3] == sql[:-1]
+            set_inception_var("inception_insert_stream_min_size", 0)
+            try:
+                streamed, full = self._audit(test_db_name, sql)
+            finally:
+                set_inception_var("inception_insert_stream_min_size", 64)
+            assert streamed == 0
+            assert result == full
+        assert "nope" in result[1]
+
+    def test_falls_back_to_full_parse(self, test_db_name):
+        """NULL values or rows of another size are parsed in full."""
+        rows = [f"({i}, 'v')" for i in range(50)]
+        streamed, _ = self._audit(
+            test_db_name, self._insert("id, c", rows + ["(50, NULL)"]))
+        assert streamed == 0
+
+        streamed, result = self._audit(
+            test_db_name, self._insert("id, c", rows + ["(50)"]))
+        assert streamed == 0
+        assert "does not match" in result[1]
+
+    def test_execute_inserts_every_row(self, test_db_name):
+        """EXECUTE runs the whole statement, not the parsed head."""
+        sql = self._insert("id, c", [f"({i}, 'v')" for i in range(300)])
+        streamed = inception_status("Inception_statements_streamed")
+        rows = inception_execute(f"USE {test_db_name};\n{sql}")
+        assert inception_status("Inception_statements_streamed") - streamed == 1
+        assert all(r["stage"] == "EXECUTED" for r in rows), rows
+        count = remote_query(f"SELECT COUNT(*) FROM `{test_db_name}`.t1")
+        assert count[0][0] == 300
+
+    def test_long_literals_parse(self, test_db_name):
+        """Quotes, escapes and multi-byte characters around the 16-byte
+        blocks of the lexer's string scan end each literal where they should."""
+        set_inception_var("inception_insert_stream_min_size", 0)
+        pieces = ["\\'", "''", "\\\\", "\u4e2d\u6587", "\"", "\\n"]
+        rows = []
+        for n in (0, 1, 14, 15, 16, 17, 31, 32, 33, 47):
+            for piece in pieces:
+                rows.append(f"({len(rows)}, '{'a' * n}{piece}{'b' * (40 - n)}')")
+        rows.append(f"({len(rows)}, '{'c' * 16}')")
+        streamed, result = self._audit(test_db_name,
+                                       self._insert("id, c", rows))
+        assert streamed == 0
+        assert result[0] < 2, result[1]
+        assert "does not match" not in result[1]
+        assert result[3] == self._insert("id, c", rows)[:-1]
+
+
+class TestDryRun:
+    """Test --dry-run-target: a CHECK batch measured on a sandbox."""
+
+    def test_sandbox_must_not_be_target(self):
+        """The audited server itself is not a sandbox."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="sandbox"):
+            inception_check(
+                "SELECT 1;",
+                extra_params=f"--dry-run-target={REMOTE_HOST}:{REMOTE_PORT};")
+
+    def test_check_mode_only(self):
+        """EXECUTE already runs the batch; a dry run is for CHECK."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="--enable-check"):
+            inception_execute(
+                "SELECT 1;", extra_params="--dry-run-target=127.0.0.1:1;")
+
+    def test_invalid_target(self):
+        """One host:port, not a list."""
+        import pymysql
+        with pytest.raises(pymysql.err.MySQLError, match="host:port"):
+            inception_check(
+                "SELECT 1;",
+                extra_params="--dry-run-target=127.0.0.1:1,127.0.0.1:2;")
+
+    def test_skipped_on_audit_errors(self, test_db_name):
+        """A batch EXECUTE would refuse never reaches the sandbox."""
+        rows = inception_check(
+            f"USE {test_db_name};\nDELETE FROM no_such_table;",
+            extra_params="--dry-run-target=127.0.0.1:1;")
+        assert any(r["err_level"] == 2 for r in rows)
+        for r in rows:
+            assert r["stage"] == "CHECKED"
+            assert "dry run skipped" in r["stage_status"]
+
+    def test_unreachable_sandbox_is_a_warning(self, test_db_name):
+        """The audit result stands when the sandbox cannot be reached."""
+        remote_execute(f"CREATE DATABASE {test_db_name}")
+        rows = inception_check(
+            f"USE {test_db_name};",
+            extra_params="--dry-run-target=127.0.0.1:1;")
+        assert rows[0]["stage"] == "CHECKED"
+        assert rows[0]["err_level"] == 1
+        assert "Dry run" in rows[0]["err_message"]
+        assert rows[0]["stage_status"] == "Audit completed; dry run failed"
+
+
+class TestResourceGroup:
+    """Test inception_resource_group: session threads bound to a group."""
+
+    GROUP = "inception_test_rg"
+
+    @pytest.fixture(autouse=True)
+    def _group(self):
+        import pymysql
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            try:
+                conn.cursor().execute(
+                    f"CREATE RESOURCE GROUP {self.GROUP} TYPE = USER VCPU = 0")
+            except pymysql.err.MySQLError as e:
+                pytest.skip(f"resource groups unavailable: {e}")
+            old = get_inception_var("inception_resource_group")
+            yield
+            set_inception_var("inception_resource_group", old or "")
+            conn.cursor().execute(f"DROP RESOURCE GROUP {self.GROUP} FORCE")
+        finally:
+            conn.close()
+
+    def _session_group(self, group):
+        """Run a CHECK session and return the group its thread is in."""
+        from conftest import (_build_magic_start, _connect_inception,
+                              _find_inception_result, REMOTE_USER,
+                              REMOTE_PASSWORD)
+        set_inception_var("inception_resource_group", group)
+        options = _build_magic_start(REMOTE_HOST, REMOTE_PORT,
+                                     "--enable-check=1",
+                                     REMOTE_USER, REMOTE_PASSWORD)
+        conn = _connect_inception(multi_statements=True)
+        try:
+            cur = conn.cursor()
+            cur.execute(f"{options}\nSELECT 1;\n/*inception_magic_commit;*/")
+            rows = _find_inception_result(cur)
+            cur.execute("SELECT RESOURCE_GROUP FROM performance_schema.threads "
+                        "WHERE PROCESSLIST_ID = CONNECTION_ID()")
+            return rows, cur.fetchone()[0]
+        finally:
+            conn.close()
+
+    def test_session_bound(self):
+        """A connection that starts a session moves to the group."""
+        rows, group = self._session_group(self.GROUP)
+        assert len(rows) == 1
+        assert group == self.GROUP
+
+    def test_unknown_group_leaves_session_unbound(self):
+        """A group that does not exist does not fail the session."""
+        rows, group = self._session_group("no_such_group")
+        assert len(rows) == 1
+        assert rows[0]["err_level"] == 0, rows[0]["err_message"]
+        assert group == "USR_default"
+
+
+class TestShadowSchema:
+    """Test --schema-file: CHECK against a schema dump, without the target."""
+
+    SHADOW_DIR = "/tmp/inception_test_shadow"
+    DUMP = (
+        "-- MySQL dump 10.13\n"
+        "/*!40101 SET NAMES utf8mb4 */;\n"
+        "CREATE DATABASE /*!32312 IF NOT EXISTS*/ `shadow_db` "
+        "/*!40100 DEFAULT CHARACTER SET utf8mb4 */;\n"
+        "USE `shadow_db`;\n"
+        "DROP TABLE IF EXISTS `t1`;\n"
+        "CREATE TABLE `t1` (\n"
+        "  `id` bigint unsigned NOT NULL AUTO_INCREMENT COMMENT 'pk',\n"
+        "  `name` varchar(50) DEFAULT NULL COMMENT 'a;b',\n"
+        "  PRIMARY KEY (`id`),\n"
+        "  KEY `idx_name` (`name`)\n"
+        ") ENGINE=InnoDB AUTO_INCREMENT=1001 DEFAULT CHARSET=utf8mb4;\n"
+    )
+    # Nothing listens here: every answer has to come from the dump
+    OFFLINE = {"remote_host": "127.0.0.1", "remote_port": 1}
+
+    def _setup(self):
+        import os
+        import shutil
+        shutil.rmtree(self.SHADOW_DIR, ignore_errors=True)
+        os.makedirs(self.SHADOW_DIR)
+        with open(os.path.join(self.SHADOW_DIR, "prod.sql"), "w") as f:
+            f.write(self.DUMP)
+        old = get_inception_var("inception_shadow_schema_dir")
+        set_inception_var("inception_shadow_schema_dir", self.SHADOW_DIR)
+        return old
+
+    def _teardown(self, old):
+        import shutil
+        set_inception_var("inception_shadow_schema_dir", old or "")
+        shutil.rmtree(self.SHADOW_DIR, ignore_errors=True)
+
+    def test_metadata_answered_offline(self):
+        """Missing tables and columns are found in the dump, with no connection."""
+        old = self._setup()
+        try:
+            rows = inception_check(
+                "USE shadow_db;\n"
+                "INSERT INTO t1 (id, name) VALUES (1, 'a');\n"
+                "INSERT INTO t1 (id, nope) VALUES (1, 'a');\n"
+                "UPDATE t2 SET name = 'x' WHERE id = 1;",
+                extra_params="--schema-file=prod.sql;", **self.OFFLINE)
+        finally:
+            self._teardown(old)
+        assert len(rows) == 4
+        assert not any("Cannot connect" in (r["err_message"] or "")
+                       for r in rows), rows
+        assert "does not exist" not in (rows[1]["err_message"] or "")
+        assert "Column 'nope' does not exist" in rows[2]["err_message"]
+        assert "Table 'shadow_db.t2' does not exist" in rows[3]["err_message"]
+
+    def test_batch_ddl_applied(self):
+        """DDL earlier in the batch changes what later statements see."""
+        old = self._setup()
+        try:
+            rows = inception_check(
+                "USE shadow_db;\n"
+                "ALTER TABLE t1 ADD COLUMN age INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+                "INSERT INTO t1 (id, age) VALUES (1, 2);\n"
+                "ALTER TABLE t1 ADD COLUMN age INT NOT NULL DEFAULT 0 COMMENT 'a';\n"
+                "ALTER TABLE t1 DROP INDEX idx_name;\n"
+                "ALTER TABLE t1 DROP INDEX idx_name;",
+                extra_params="--schema-file=prod.sql;", **self.OFFLINE)
+        finally:
+            self._teardown(old)
+        assert len(rows) == 6
+        assert "does not exist" not in (rows[2]["err_message"] or "")
+        assert "Column 'age' already exists" in rows[3]["err_message"]
+        assert "Index 'idx_name' does not exist" not in (rows[4]["err_message"] or "")
+        assert "Index 'idx_name' does not exist" in rows[5]["err_message"]
+
+    def test_schema_file_rejections(self):
+        """Paths outside the directory and EXECUTE mode are refused."""
+        import pymysql
+        old = self._setup()
+        try:
+            with pytest.raises(pymysql.err.MySQLError, match="Invalid --schema-file"):
+                inception_check("SELECT 1;",
+                                extra_params="--schema-file=../prod.sql;")
+            with pytest.raises(pymysql.err.MySQLError, match="Cannot open schema file"):
+                inception_check("SELECT 1;",
+                                extra_params="--schema-file=missing.sql;")
+            with pytest.raises(pymysql.err.MySQLError, match="--enable-check"):
+                inception_execute("SELECT 1;",
+                                  extra_params="--schema-file=prod.sql;")
+        finally:
+            self._teardown(old)
+
+
+class TestRuleProfiles:
+    """Test inception_rule_profiles: named rule overrides chosen by --profile."""
+
+    PROFILES = "/tmp/inception_test_profiles.ini"
+    CREATE = "CREATE TABLE t1 (id INT NOT NULL PRIMARY KEY COMMENT 'pk');"
+
+    def _write(self, text):
+        with open(self.PROFILES, "w") as f:
+            f.write(text)
+
+    def _setup(self, text):
+        self._write(text)
+        old = get_inception_var("inception_rule_profiles")
+        set_inception_var("inception_rule_profiles", self.PROFILES)
+        return old
+
+    def _teardown(self, old):
+        import os
+        set_inception_var("inception_rule_profiles", old or "")
+        if os.path.exists(self.PROFILES):
+            os.remove(self.PROFILES)
+
+    def _create(self, test_db_name, profile):
+        rows = inception_check(
+            f"USE {test_db_name};\n{self.CREATE}",
+            extra_params=f"--profile={profile};")
+        return rows[-1]["err_message"] or ""
+
+    def test_profile_overrides_global_rules(self, test_db_name):
+        """Each profile changes only the rules it sets; the rest stay global."""
+        old_comment = get_inception_var("inception_check_table_comment")
+        old = self._setup(
+            "# table comments: off for team_a, warning for team_b\n"
+            "[team_a]\n"
+            "inception_check_table_comment = OFF\n"
+            "[team_b]\n"
+            "check_table_comment = 1\n")
+        set_inception_var("inception_check_table_comment", "ERROR")
+        try:
+            remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+            assert "Table must have a comment" not in self._create(
+                test_db_name, "team_a")
+            assert "Table must have a comment" in self._create(
+                test_db_name, "team_b")
+            rows = inception_check(f"USE {test_db_name};\n{self.CREATE}")
+            assert "Table must have a comment" in rows[-1]["err_message"]
+        finally:
+            set_inception_var("inception_check_table_comment", old_comment)
+            self._teardown(old)
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+    def test_reload_swaps_profiles(self, test_db_name):
+        """A changed file is picked up; a broken one is rejected whole."""
+        import pymysql
+        from conftest import _connect_inception
+        old = self._setup("[team_a]\ncheck_table_comment = OFF\n")
+        try:
+            remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+            self._create(test_db_name, "team_a")
+            self._write("[team_a]\ncheck_table_comment = OFF\n"
+                        "[team_c]\ncheck_max_indexes = 8\n"
+                        "support_charset = utf8mb4\n")
+            conn = _connect_inception()
+            try:
+                cur = conn.cursor()
+                cur.execute("inception reload rule_profiles")
+                cur.execute("inception show rule_profiles")
+                cols = [d[0] for d in cur.description]
+                profiles = {r[0]: r[1] for r in cur.fetchall()}
+                assert cols == ["profile", "settings", "path", "loaded"]
+                assert profiles == {"team_a": 1, "team_c": 2}
+
+                self._write("[team_a]\ncheck_table_comment = LOUD\n")
+                with pytest.raises(pymysql.err.MySQLError,
+                                   match="invalid value 'LOUD'"):
+                    cur.execute("inception reload rule_profiles")
+                cur.execute("inception show rule_profiles")
+                assert len(cur.fetchall()) == 2
+            finally:
+                conn.close()
+            with pytest.raises(pymysql.err.MySQLError,
+                               match="Unknown rule profile 'team_x'"):
+                self._create(test_db_name, "team_x")
+        finally:
+            self._teardown(old)
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+
+
+class TestRuleComponents:
+    """Test audit rules registered by a component (inception_audit_rule)."""
+
+    COMPONENT = "file://component_inception_rule_example"
+
+    def _install(self):
+        import pymysql
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            conn.cursor().execute(f"INSTALL COMPONENT '{self.COMPONENT}'")
+        except pymysql.err.MySQLError as e:
+            pytest.skip(f"inception_rule_example not available: {e}")
+        finally:
+            conn.close()
+
+    def _uninstall(self):
+        from conftest import _connect_inception
+        conn = _connect_inception()
+        try:
+            conn.cursor().execute(f"UNINSTALL COMPONENT '{self.COMPONENT}'")
+        finally:
+            conn.close()
+
+    def test_component_rule_runs_for_its_command(self, test_db_name):
+        """A rule runs for the command it registered, and not after UNINSTALL."""
+        from conftest import _connect_inception
+        sql = (f"USE {test_db_name};\n"
+               "CREATE TABLE tmp_orders (id INT NOT NULL PRIMARY KEY "
+               "COMMENT 'pk') COMMENT 'orders';\n"
+               "INSERT INTO tmp_orders VALUES (1);")
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        self._install()
+        try:
+            rows = inception_check(sql)
+            assert "must not start with 'tmp'" in rows[1]["err_message"]
+            assert rows[1]["err_level"] == 2
+            assert "must not start with 'tmp'" not in (
+                rows[2]["err_message"] or "")
+
+            conn = _connect_inception()
+            try:
+                cur = conn.cursor()
+                cur.execute("inception show rule_components")
+                cols = [d[0] for d in cur.description]
+                rules = {r[0]: r for r in cur.fetchall()}
+                assert cols == ["rule", "sql_command", "sql_type", "calls"]
+                assert rules["no_tmp_table"][2] == "CREATE_TABLE"
+                assert rules["no_tmp_table"][3] >= 1
+                assert "truncate_large_table" in rules
+            finally:
+                conn.close()
+        finally:
+            self._uninstall()
+            remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+        rows = inception_check(sql)
+        assert "must not start with 'tmp'" not in (rows[1]["err_message"] or "")
+
+
+class TestAuditFile:
+    """Test inception audit file: a script split and audited on the server."""
+
+    SCRIPT_DIR = "/tmp/inception_test_scripts"
+    SCRIPT = (
+        "-- two tables\n"
+        "CREATE TABLE af_t1 (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY "
+        "COMMENT 'pk', note VARCHAR(10) NOT NULL DEFAULT ';' COMMENT 'a;b'"
+        ") ENGINE=InnoDB COMMENT 'm';\n"
+        "/* ; inside a comment */\n"
+        "INSERT INTO af_t1 (id, note) VALUES (1, 'x;y');\n"
+        "SELEC broken;\n"
+        "DELIMITER $$\n"
+        "UPDATE af_t1 SET note = 'z' WHERE id = 1$$\n"
+        "DELIMITER ;\n"
+        "DELETE FROM af_t1 WHERE id = 1;\n"
+    )
+
+    def _setup(self):
+        import os
+        import shutil
+        shutil.rmtree(self.SCRIPT_DIR, ignore_errors=True)
+        os.makedirs(self.SCRIPT_DIR)
+        with open(os.path.join(self.SCRIPT_DIR, "batch.sql"), "w") as f:
+            f.write(self.SCRIPT)
+        old = get_inception_var("inception_script_dir")
+        set_inception_var("inception_script_dir", self.SCRIPT_DIR)
+        return old
+
+    def _teardown(self, old):
+        import shutil
+        set_inception_var("inception_script_dir", old or "")
+        shutil.rmtree(self.SCRIPT_DIR, ignore_errors=True)
+
+    def test_same_result_as_sent(self, test_db_name):
+        """The file is split like the client does and audited the same way."""
+        old = self._setup()
+        try:
+            from_file = inception_check(
+                f"USE {test_db_name};\n"
+                "inception audit file 'batch.sql';\n"
+                "INSERT INTO af_t1 (id, note) VALUES (2, 'w');")
+        finally:
+            self._teardown(old)
+        sent = inception_check(
+            f"USE {test_db_name};\n"
+            "CREATE TABLE af_t1 (id INT NOT NULL AUTO_INCREMENT PRIMARY KEY "
+            "COMMENT 'pk', note VARCHAR(10) NOT NULL DEFAULT ';' COMMENT 'a;b'"
+            ") ENGINE=InnoDB COMMENT 'm';\n"
+            "INSERT INTO af_t1 (id, note) VALUES (1, 'x;y');\n"
+            "SELEC broken;\n"
+            "UPDATE af_t1 SET note = 'z' WHERE id = 1;\n"
+            "DELETE FROM af_t1 WHERE id = 1;\n"
+            "INSERT INTO af_t1 (id, note) VALUES (2, 'w');")
+        assert len(from_file) == len(sent) == 7
+        assert [(r["err_level"], r["sql_type"]) for r in from_file] == \
+               [(r["err_level"], r["sql_type"]) for r in sent]
+        assert from_file[2]["sql_text"] == \
+            "INSERT INTO af_t1 (id, note) VALUES (1, 'x;y')"
+        assert "SQL parse error" in from_file[3]["err_message"]
+
+    def test_audit_file_rejections(self):
+        """Names outside the directory, missing files and no session fail."""
+        import pymysql
+        old = self._setup()
+        try:
+            with pytest.raises(pymysql.err.MySQLError, match="Invalid script name"):
+                inception_check("inception audit file '../batch.sql';")
+            with pytest.raises(pymysql.err.MySQLError, match="Cannot open script file"):
+                inception_check("inception audit file 'missing.sql';")
+            from conftest import _connect_inception
+            conn = _connect_inception()
+            try:
+                with pytest.raises(pymysql.err.MySQLError,
+                                   match="must follow inception_magic_start"):
+                    conn.cursor().execute("inception audit file 'batch.sql'")
+            finally:
+                conn.close()
+        finally:
+            self._teardown(old)
+
+
+class TestSchemaSnapshot:
+    """Test inception_metadata_snapshot_dir: cache kept fresh from the binlog."""
+
+    SNAPSHOT_DIR = "/tmp/inception_test_snapshots"
+
+    @pytest.fixture(autouse=True)
+    def enable_watch(self, test_db_name):
+        import os
+        import shutil
+        shutil.rmtree(self.SNAPSHOT_DIR, ignore_errors=True)
+        os.makedirs(self.SNAPSHOT_DIR)
+        old_ttl = get_inception_var("inception_metadata_cache_ttl")
+        old_dir = get_inception_var("inception_metadata_snapshot_dir")
+        set_inception_var("inception_metadata_cache_ttl", 1)
+        set_inception_var("inception_metadata_snapshot_dir", self.SNAPSHOT_DIR)
+        try:
+            remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+            remote_execute(
+                f"CREATE TABLE IF NOT EXISTS `{test_db_name}`.`t_watch` ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT,"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB"
+            )
+        except Exception:
+            pytest.skip("Cannot set up remote test table")
+        yield
+        set_inception_var("inception_metadata_cache_ttl", old_ttl)
+        set_inception_var("inception_metadata_snapshot_dir", old_dir or "")
+
+    def _watched(self, db, table):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show cache")
+            return any(e["db_name"] == db and e["table_name"] == table and
+                       e["watched"] == "YES" for e in cur.fetchall())
+        finally:
+            conn.close()
+
+    def test_ddl_outside_inception_reaches_pinned_entry(self, test_db_name):
+        """A pinned entry outlives the TTL and still sees DDL from elsewhere."""
+        import time
+        check = (f"USE {test_db_name};\n"
+                 f"ALTER TABLE t_watch DROP COLUMN age;")
+        inception_check(check)  # starts the watcher
+        time.sleep(2)
+        inception_check(check)  # loads t_watch while the watcher streams
+        if not self._watched(test_db_name, "t_watch"):
+            pytest.skip("Target binlog not readable (log_bin / REPLICATION SLAVE)")
+        time.sleep(2)  # past the TTL
+        assert self._watched(test_db_name, "t_watch")
+
+        remote_execute(f"ALTER TABLE `{test_db_name}`.`t_watch` "
+                       f"ADD COLUMN age INT NOT NULL DEFAULT 0")
+        time.sleep(2)
+        rows = inception_check(check)
+        alter_row = [r for r in rows if "ALTER TABLE" in r["sql_text"]]
+        assert "does not exist" not in (alter_row[0]["err_message"] or "")
+
+
+class TestRuleStats:
+    """Test inception show rule_stats: per-rule time, queries and violations."""
+
+    def _rule_stats(self):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("inception show rule_stats")
+            cols = [desc[0] for desc in cur.description]
+            return cols, {r["rule"]: r for r in cur.fetchall()}
+        finally:
+            conn.close()
+
+    def test_columns(self):
+        """One row per rule with calls, time and counters."""
+        cols, stats = self._rule_stats()
+        assert cols == ["rule", "calls", "time_ms", "avg_us",
+                        "remote_queries", "violations"]
+        assert {"create_table", "column", "index", "metadata",
+                "insert"} <= set(stats)
+
+    def test_create_table_counted(self, test_db_name):
+        """CREATE TABLE counts one call, one per column and the violations."""
+        old_comment = get_inception_var("inception_check_column_comment")
+        set_inception_var("inception_check_column_comment", 1)
+        _, before = self._rule_stats()
+        try:
+            inception_check(
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t_rule_stats ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  a INT NOT NULL DEFAULT 0,"
+                f"  b INT NOT NULL DEFAULT 0,"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'stats';")
+        finally:
+            set_inception_var("inception_check_column_comment", old_comment)
+        _, after = self._rule_stats()
+        delta = lambda rule, col: after[rule][col] - before[rule][col]
+        assert delta("create_table", "calls") >= 1
+        assert delta("column", "calls") >= 3
+        assert delta("column", "violations") >= 2  # a, b lack comments
+        assert float(after["column"]["time_ms"]) >= float(before["column"]["time_ms"])
+
+
+class TestStatusVariables:
+    """Test the Inception_* global status variables."""
+
+    def _status(self):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute("SHOW GLOBAL STATUS LIKE 'Inception\\_%'")
+            return {name: int(value) for name, value in cur.fetchall()}
+        finally:
+            conn.close()
+
+    def test_variables(self):
+        """Every counter is reported."""
+        status = self._status()
+        assert set(status) == {
+            "Inception_audit_cache_hits", "Inception_audit_cache_misses",
+            "Inception_audit_sink_dropped", "Inception_audit_sink_retries",
+            "Inception_audit_sink_shipped", "Inception_audit_sink_spooled",
+            "Inception_bytes_sent", "Inception_cache_hits",
+            "Inception_cache_misses", "Inception_query_tree_cache_hits",
+            "Inception_query_tree_cache_misses",
+            "Inception_remote_bytes_received", "Inception_remote_queries",
+            "Inception_remote_wire_bytes_received",
+            "Inception_sessions", "Inception_shared_cache_hits",
+            "Inception_shared_cache_misses", "Inception_statements_audited",
+            "Inception_statements_executed", "Inception_statements_spilled",
+            "Inception_statements_streamed", "Inception_throttle_wait_ms",
+        }
+
+    def test_check_counted(self, test_db_name):
+        """A CHECK session counts the session, its statements and lookups."""
+        before = self._status()
+        inception_check(
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t_status_vars ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'status';")
+        after = self._status()
+        delta = lambda name: after[name] - before[name]
+        assert delta("Inception_sessions") >= 1
+        assert delta("Inception_statements_audited") >= 2
+        assert (delta("Inception_cache_hits") +
+                delta("Inception_cache_misses")) >= 1
+
+    def test_compressed_connections(self, test_db_name):
+        """With inception_remote_compression a large result crosses the
+        wire in fewer bytes than it has after decompression."""
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "TiDB":
+            pytest.skip("TiDB does not negotiate protocol compression")
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(200) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'compression test'"
+        )
+        values = ", ".join(f"({i}, '{'x' * 200}')" for i in range(1, 1001))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES {values}")
+        old = get_inception_var("inception_remote_compression")
+        set_inception_var("inception_remote_compression", "zlib")
+        try:
+            before = self._status()
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"SELECT id, name FROM t1 WHERE id > 0;")
+            after = self._status()
+        finally:
+            set_inception_var("inception_remote_compression", old or "")
+        select_row = [r for r in rows if "SELECT" in r["sql_text"]][0]
+        assert select_row["affected_rows"] == 1000
+        delta = lambda name: after[name] - before[name]
+        assert delta("Inception_remote_bytes_received") > 200 * 1000
+        assert (delta("Inception_remote_wire_bytes_received") <
+                delta("Inception_remote_bytes_received") // 2)
+
+
+class TestPerformanceSchemaTables:
+    """Test performance_schema.inception_sessions / inception_remote_latency."""
+
+    def _query(self, sql):
+        import pymysql
+        from conftest import INCEPTION_HOST, INCEPTION_PORT
+        conn = pymysql.connect(
+            host=INCEPTION_HOST, port=INCEPTION_PORT, user="root",
+            charset="utf8mb4", autocommit=True,
+            cursorclass=pymysql.cursors.DictCursor,
+        )
+        try:
+            cur = conn.cursor()
+            cur.execute(sql)
+            cols = [desc[0] for desc in cur.description]
+            return cols, cur.fetchall()
+        finally:
+            conn.close()
+
+    def test_sessions_columns(self):
+        """Typed columns of inception show sessions."""
+        cols, _ = self._query(
+            "SELECT * FROM performance_schema.inception_sessions")
+        assert cols[:6] == ["THREAD_ID", "HOST", "PORT", "USER", "MODE",
+                            "DB_TYPE"]
+        assert {"EXECUTED_SQL", "REPL_DELAY_MS", "CHUNK_ROWS",
+                "PROGRESS_ETA_SEC", "SCHED"} <= set(cols)
+
+    def test_metadata_latency(self, test_db_name):
+        """A CHECK times its metadata lookups into the target's histogram."""
+        inception_check(
+            f"USE {test_db_name};\n"
+            f"CREATE TABLE t_pfs_latency ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'latency';")
+        _, rows = self._query(
+            "SELECT * FROM performance_schema.inception_remote_latency "
+            "WHERE QUERY_CLASS = 'metadata' ORDER BY TARGET, BUCKET_NUMBER")
+        assert rows
+        last = [r for r in rows if r["BUCKET_HIGH_US"] is None]
+        assert last and all(r["BUCKET_QUANTILE"] == 1.0 for r in last)
+        assert sum(r["COUNT_BUCKET"] for r in rows) >= 1
+
+
+class TestTxnBatchExecute:
+    """Test --txn-batch-size transaction grouping in EXECUTE mode."""
+
+    def test_failed_statement_rolls_back_transaction(self, test_db_name):
+        """A failure rolls back the statements of its transaction only."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'txn test';\n"
+                f"INSERT INTO t1 (id, name) VALUES (1, 'a');\n"
+                f"INSERT INTO t1 (id, name) VALUES (2, 'b');\n"
+                f"INSERT INTO t1 (id, name) VALUES (3, 'c');\n"
+                f"INSERT INTO t1 (id, name) VALUES (1, 'dup');",
+                extra_params="--txn-batch-size=2;--enable-remote-backup=0;",
+            )
+            ins = [r for r in rows if r["sql_type"] == "INSERT"]
+            assert [r["err_level"] for r in ins] == [0, 0, 2, 2]
+            assert "Rolled back" in ins[2]["err_message"]
+            assert ins[2]["affected_rows"] == 0
+            assert "Duplicate" in ins[3]["err_message"]
+            ids = remote_query(f"SELECT id FROM {test_db_name}.t1 ORDER BY id")
+            assert [r[0] for r in ids] == [1, 2]
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+
+
+class TestOnlineSchemaChange:
+    """Test the built-in online schema change engine (inception_osc_on)."""
+
+    def test_osc_copy_alter_keeps_rows(self, test_db_name):
+        """A COPY ALTER through the ghost table keeps every row."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'osc test'"
+        )
+        values = ", ".join(f"({i}, 'n{i}')" for i in range(1, 11))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES {values}"
+        )
+        old_osc = get_inception_var("inception_osc_on")
+        old_chunk = get_inception_var("inception_osc_chunk_size")
+        old_size = get_inception_var("inception_osc_min_table_size")
+        old_rows = get_inception_var("inception_osc_min_table_rows")
+        set_inception_var("inception_osc_on", 1)
+        set_inception_var("inception_osc_chunk_size", 3)
+        set_inception_var("inception_osc_min_table_size", 0)
+        set_inception_var("inception_osc_min_table_rows", 0)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 MODIFY COLUMN name VARCHAR(100) NOT NULL "
+                f"COMMENT 'longer';",
+            )
+            alter_row = [r for r in rows if "ALTER" in r["sql_text"]][0]
+            assert alter_row["ddl_algorithm"] == "COPY"
+            assert alter_row["exec_strategy"] == "OSC"
+            assert alter_row["err_level"] == 0, alter_row["err_message"]
+            assert alter_row["affected_rows"] == 10
+            col = remote_query(
+                f"SELECT CHARACTER_MAXIMUM_LENGTH FROM information_schema.COLUMNS "
+                f"WHERE TABLE_SCHEMA='{test_db_name}' AND TABLE_NAME='t1' "
+                f"AND COLUMN_NAME='name'"
+            )
+            assert int(col[0][0]) == 100
+            ids = remote_query(f"SELECT id FROM `{test_db_name}`.t1 ORDER BY id")
+            assert [int(r[0]) for r in ids] == list(range(1, 11))
+            leftovers = remote_query(
+                f"SELECT TABLE_NAME FROM information_schema.TABLES "
+                f"WHERE TABLE_SCHEMA='{test_db_name}' "
+                f"AND TABLE_NAME IN ('_t1_gho', '_t1_del')"
+            )
+            assert len(leftovers) == 0
+        finally:
+            set_inception_var("inception_osc_on", old_osc)
+            set_inception_var("inception_osc_chunk_size", old_chunk)
+            set_inception_var("inception_osc_min_table_size", old_size)
+            set_inception_var("inception_osc_min_table_rows", old_rows)
+
+    def test_osc_defers_secondary_indexes(self, test_db_name):
+        """The ghost gets its plain KEYs back after the copy, rows intact."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  code INT NOT NULL COMMENT 'code',"
+            f"  PRIMARY KEY (id),"
+            f"  UNIQUE KEY uk_code (code),"
+            f"  KEY idx_name (name)"
+            f") ENGINE=InnoDB COMMENT 'osc test'"
+        )
+        values = ", ".join(f"({i}, 'n{i}', {i})" for i in range(1, 11))
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name, code) VALUES {values}"
+        )
+        old_osc = get_inception_var("inception_osc_on")
+        old_chunk = get_inception_var("inception_osc_chunk_size")
+        old_size = get_inception_var("inception_osc_min_table_size")
+        old_rows = get_inception_var("inception_osc_min_table_rows")
+        old_defer = get_inception_var("inception_osc_defer_indexes")
+        set_inception_var("inception_osc_on", 1)
+        set_inception_var("inception_osc_chunk_size", 3)
+        set_inception_var("inception_osc_min_table_size", 0)
+        set_inception_var("inception_osc_min_table_rows", 0)
+        set_inception_var("inception_osc_defer_indexes", 1)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 MODIFY COLUMN name VARCHAR(100) NOT NULL "
+                f"COMMENT 'longer', ADD KEY idx_code_name (code, name);",
+            )
+            alter_row = [r for r in rows if "ALTER" in r["sql_text"]][0]
+            assert alter_row["exec_strategy"] == "OSC"
+            assert alter_row["err_level"] == 0, alter_row["err_message"]
+            assert alter_row["affected_rows"] == 10
+            keys = remote_query(
+                f"SELECT DISTINCT INDEX_NAME FROM information_schema.STATISTICS "
+                f"WHERE TABLE_SCHEMA='{test_db_name}' AND TABLE_NAME='t1'"
+            )
+            assert {r[0] for r in keys} == {
+                "PRIMARY", "idx_code_name", "idx_name", "uk_code"}
+            names = remote_query(
+                f"SELECT name FROM `{test_db_name}`.t1 FORCE INDEX (idx_name) "
+                f"ORDER BY name"
+            )
+            assert sorted(r[0] for r in names) == sorted(
+                f"n{i}" for i in range(1, 11))
+        finally:
+            set_inception_var("inception_osc_on", old_osc)
+            set_inception_var("inception_osc_chunk_size", old_chunk)
+            set_inception_var("inception_osc_min_table_size", old_size)
+            set_inception_var("inception_osc_min_table_rows", old_rows)
+            set_inception_var("inception_osc_defer_indexes", old_defer)
+
+    def test_small_table_copy_runs_native(self, test_db_name):
+        """Below the size thresholds a COPY ALTER is not routed to OSC."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'osc test'"
+        )
+        old_osc = get_inception_var("inception_osc_on")
+        set_inception_var("inception_osc_on", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 MODIFY COLUMN name VARCHAR(100) NOT NULL "
+                f"COMMENT 'longer';\n"
+                f"ALTER TABLE t1 ALTER COLUMN name SET DEFAULT '';",
+            )
+            alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
+            assert alter_rows[0]["ddl_algorithm"] == "COPY"
+            assert alter_rows[0]["exec_strategy"] == "NATIVE"
+            assert alter_rows[0]["estimated_time"] != ""
+            assert alter_rows[1]["ddl_algorithm"] == "INSTANT"
+            assert alter_rows[1]["estimated_time"] == "0"
+        finally:
+            set_inception_var("inception_osc_on", old_osc)
+
+    def test_locks_writes(self, test_db_name):
+        """locks_writes is YES for a native COPY and FULLTEXT, NO otherwise."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'lock test'"
+        )
+        old_osc = get_inception_var("inception_osc_on")
+        set_inception_var("inception_osc_on", 0)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 MODIFY COLUMN name VARCHAR(100) NOT NULL "
+                f"COMMENT 'longer';\n"
+                f"ALTER TABLE t1 ALTER COLUMN name SET DEFAULT '';\n"
+                f"ALTER TABLE t1 ADD INDEX idx_name (name);\n"
+                f"ALTER TABLE t1 ADD FULLTEXT INDEX ft_name (name);",
+            )
+            alter_rows = [r for r in rows if "ALTER" in r["sql_text"]]
+            assert [r["locks_writes"] for r in alter_rows] == \
+                ["YES", "NO", "NO", "YES"]
+            use_row = [r for r in rows if r["sql_text"].startswith("USE")]
+            assert use_row[0]["locks_writes"] == ""
+        finally:
+            set_inception_var("inception_osc_on", old_osc)
+
+
+class TestPartitionRebuild:
+    """Test inception_exec_partition_rebuild."""
+
+    @staticmethod
+    def _create(test_db_name, partitions):
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'partition rebuild test'"
+            + (f" PARTITION BY HASH (id) PARTITIONS {partitions}"
+               if partitions else "")
+        )
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id) VALUES (1), (2), (3), (4)")
+
+    def test_rebuild_runs_per_partition(self, test_db_name):
+        """FORCE on a partitioned table rebuilds one partition at a time."""
+        db_type, _, _, _ = _detected_db_profile()
+        if db_type == "TiDB":
+            pytest.skip("REBUILD PARTITION is MySQL only")
+        self._create(test_db_name, 3)
+        old = get_inception_var("inception_exec_partition_rebuild")
+        set_inception_var("inception_exec_partition_rebuild", 1)
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\nALTER TABLE t1 FORCE;",
+                extra_params="--enable-ignore-warnings=1;")
+        finally:
+            set_inception_var("inception_exec_partition_rebuild", old)
+        row = [r for r in rows if "ALTER" in r["sql_text"]][0]
+        assert row["exec_strategy"] == "PARTITION"
+        assert "(3 partitions)" in row["stage_status"]
+        count = remote_query(f"SELECT COUNT(*) FROM `{test_db_name}`.t1")
+        assert count[0][0] == 4
+
+    def test_other_alters_are_not_split(self, test_db_name):
+        """A definition change or an unpartitioned table keeps its strategy."""
+        self._create(test_db_name, 0)
+        old = get_inception_var("inception_exec_partition_rebuild")
+        set_inception_var("inception_exec_partition_rebuild", 1)
+        try:
+            rows = inception_check(
+                f"USE {test_db_name};\n"
+                f"ALTER TABLE t1 FORCE;\n"
+                f"ALTER TABLE t1 ROW_FORMAT=COMPRESSED;")
+        finally:
+            set_inception_var("inception_exec_partition_rebuild", old)
+        for row in [r for r in rows if "ALTER" in r["sql_text"]]:
+            assert row["exec_strategy"] != "PARTITION"
+
+class TestRemoteBackup:
+    """Test rollback statement generation (--enable-remote-backup)."""
+
+    def test_dml_rollback_statements(self, test_db_name):
+        """Each DML row change gets one reverse statement in the backup db."""
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        backup_db = None
+        try:
+            rows = inception_execute(
+                f"CREATE DATABASE {test_db_name};\n"
+                f"USE {test_db_name};\n"
+                f"CREATE TABLE t1 ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) NOT NULL COMMENT 'name',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'backup test';\n"
+                f"INSERT INTO t1 (id, name) VALUES (1, 'a'), (2, 'b'), (3, 'c');\n"
+                f"UPDATE t1 SET name = 'x' WHERE id = 2;\n"
+                f"DELETE FROM t1 WHERE id = 3;",
+                extra_params="--enable-remote-backup=1;",
+            )
+            dml = [r for r in rows
+                   if r["sql_type"] in ("INSERT", "UPDATE", "DELETE")]
+            assert len(dml) == 3
+            for r in dml:
+                assert r["err_level"] == 0, r["err_message"]
+                assert r["backup_dbname"] != ""
+            backup_db = dml[0]["backup_dbname"]
+
+            got = {}
+            for r in dml:
+                opid = r["sequence"].strip("'")
+                got[r["sql_type"]] = [
+                    row[0] for row in remote_query(
+                        f"SELECT rollback_statement FROM `{backup_db}`.t1 "
+                        f"WHERE opid_time = '{opid}' ORDER BY id")
+                ]
+            assert len(got["INSERT"]) == 3
+            assert all(s.startswith("DELETE FROM") for s in got["INSERT"])
+            assert len(got["UPDATE"]) == 1
+            assert got["UPDATE"][0].startswith("UPDATE")
+            assert "'b'" in got["UPDATE"][0]
+            assert len(got["DELETE"]) == 1
+            assert got["DELETE"][0].startswith("INSERT INTO")
+            assert "'c'" in got["DELETE"][0]
+
+            info = remote_query(
+                f"SELECT COUNT(*) FROM "
+                f"`{backup_db}`.`$_$Inception_backup_information$_$`")
+            assert int(info[0][0]) >= 3
+        finally:
+            set_inception_var("inception_check_nullable", old_nullable)
+            set_inception_var("inception_check_must_have_columns", old_mhc)
+            if backup_db:
+                remote_execute(f"DROP DATABASE IF EXISTS `{backup_db}`")
+
+    def test_select_strategy_before_images(self, test_db_name):
+        """inception_backup_strategy=SELECT reads the rows before the
+        statement, in chunks, and their rollback restores the table."""
+        remote_execute(f"CREATE DATABASE IF NOT EXISTS `{test_db_name}`")
+        remote_execute(
+            f"CREATE TABLE `{test_db_name}`.t1 ("
+            f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+            f"  name VARCHAR(50) NULL COMMENT 'name',"
+            f"  PRIMARY KEY (id)"
+            f") ENGINE=InnoDB COMMENT 'image test'"
+        )
+        remote_execute(
+            f"INSERT INTO `{test_db_name}`.t1 (id, name) VALUES "
+            f"(1, 'a'), (2, 'b''q'), (3, NULL), (4, 'd'), (5, 'e')")
+        before = remote_query(f"SELECT id, name FROM `{test_db_name}`.t1 "
+                              f"ORDER BY id")
+        old = {name: get_inception_var(name) for name in (
+            "inception_backup_strategy", "inception_backup_select_chunk_size")}
+        set_inception_var("inception_backup_strategy", "SELECT")
+        set_inception_var("inception_backup_select_chunk_size", 2)
+        backup_db = None
+        try:
+            rows = inception_execute(
+                f"USE {test_db_name};\n"
+                f"UPDATE t1 SET name = 'x' WHERE id > 1;\n"
+                f"DELETE FROM t1 WHERE id = 1;",
+                extra_params="--enable-remote-backup=1;",
+            )
+            dml = [r for r in rows if r["sql_type"] in ("UPDATE", "DELETE")]
+            assert [r["stage_status"] for r in dml] == [
+                "Execute completed (before images: 4 rows)",
+                "Execute completed (before images: 1 rows)"]
+            backup_db = dml[0]["backup_dbname"]
+            assert backup_db != ""
+
+            statements = []
+            for r in reversed(dml):
+                opid = r["sequence"].strip("'")
+                statements += [
+                    row[0] for row in remote_query(
+                        f"SELECT rollback_statement FROM `{backup_db}`.t1 "
+                        f"WHERE opid_time = '{opid}' ORDER BY id DESC")
+                ]
+            assert len(statements) == 5
+            for stmt in statements:
+                remote_execute(stmt)
+            after = remote_query(f"SELECT id, name FROM `{test_db_name}`.t1 "
+                                 f"ORDER BY id")
+            assert after == before
+        finally:
+            for name, value in old.items():
+                set_inception_var(name, value)
+            if backup_db:
+                remote_execute(f"DROP DATABASE IF EXISTS `{backup_db}`")
+
+
+class TestResultSpool:
+    """Test spooling finished results (inception_result_spool_size)."""
+
+    def _with_spool(self, size, fn):
+        old = get_inception_var("inception_result_spool_size")
+        set_inception_var("inception_result_spool_size", size)
+        try:
+            return fn()
+        finally:
+            set_inception_var("inception_result_spool_size", old)
+
+    def _compare(self, fn):
+        """Results kept in memory, spooled and spilled to a file agree."""
+        plain = self._with_spool(0, fn)
+        spooled = self._with_spool(16 * 1024 * 1024, fn)
+        spilled = self._with_spool(1, fn)
+        assert plain == spooled == spilled
+        return plain
+
+    def test_check_results_spilled(self, test_db_name):
+        stmts = [f"USE {test_db_name};"]
+        for i in range(50):
+            stmts.append(
+                f"CREATE TABLE t_spool{i} ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"  name VARCHAR(50) COMMENT 'name {i}',"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'spool';")
+        rows = self._compare(lambda: inception_check("\n".join(stmts)))
+        assert [r["id"] for r in rows] == list(range(1, len(stmts) + 1))
+        assert all("t_spool" in r["sql_text"] for r in rows[1:])
+
+    def test_split_results_spilled(self, test_db_name):
+        stmts = []
+        for i in range(20):
+            stmts.append(f"ALTER TABLE {test_db_name}.t{i} ADD COLUMN c INT;")
+            stmts.append(f"INSERT INTO {test_db_name}.t{i} VALUES (1);")
+        rows = self._compare(lambda: inception_split("\n".join(stmts)))
+        assert len(rows) == 40
+
+    def test_query_tree_results_spilled(self):
+        stmts = [f"SELECT a, b FROM db.t{i} WHERE id = {i};" for i in range(30)]
+        rows = self._compare(lambda: inception_query_tree("\n".join(stmts)))
+        assert len(rows) == 30
+        assert rows[29]["query_tree"]
+
+
+class TestSessionMemory:
+    """Test spilling statement texts past inception_max_session_memory."""
+
+    KEYS = ("id", "stage", "err_level", "stage_status", "err_message",
+            "sql_text", "affected_rows")
+
+    @pytest.fixture(autouse=True)
+    def _setup(self, test_db_name):
+        old = {name: get_inception_var(name) for name in (
+            "inception_max_session_memory", "inception_result_spool_size",
+            "inception_check_nullable", "inception_check_must_have_columns")}
+        set_inception_var("inception_result_spool_size", 0)
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+        yield
+        remote_execute(f"DROP DATABASE IF EXISTS `{test_db_name}`")
+        for name, value in old.items():
+            set_inception_var(name, value)
+
+    def _run(self, budget, fn):
+        """Rows of fn() with the budget, and the statements it spilled."""
+        set_inception_var("inception_max_session_memory", budget)
+        before = inception_status("Inception_statements_spilled")
+        rows = fn()
+        spilled = inception_status("Inception_statements_spilled") - before
+        return [{k: r[k] for k in self.KEYS} for r in rows], spilled
+
+    def _script(self, db, inserts):
+        stmts = [f"CREATE DATABASE {db};", f"USE {db};",
+                 f"CREATE TABLE t_mem ("
+                 f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                 f"  name VARCHAR(50) NOT NULL DEFAULT '' COMMENT 'name',"
+                 f"  PRIMARY KEY (id)"
+                 f") ENGINE=InnoDB COMMENT 'memory';"]
+        stmts += [f"INSERT INTO t_mem (id, name) VALUES ({i + 1}, 'n{i}');"
+                  for i in range(inserts)]
+        return "\n".join(stmts)
+
+    def test_check_results_unchanged(self, test_db_name):
+        sql = self._script(test_db_name, 40)
+        plain, none = self._run(0, lambda: inception_check(sql))
+        spilled, count = self._run(1, lambda: inception_check(sql))
+        assert none == 0 and count > 0
+        assert spilled == plain
+
+    def test_execute_reads_spilled_statements(self, test_db_name):
+        sql = self._script(test_db_name, 40)
+        rows, count = self._run(1, lambda: inception_execute(sql))
+        assert count > 0
+        assert all(r["stage_status"] == "Execute completed" for r in rows)
+        assert all("INSERT INTO t_mem" in r["sql_text"] for r in rows[3:])
+        count = remote_query(f"SELECT COUNT(*) FROM {test_db_name}.t_mem")
+        assert count[0][0] == 40
+
+
+@pytest.mark.perf
+class TestPerfRegression:
+    """
+    Timed end-to-end workloads against the local target (-m perf). Wall
+    time, remote queries and peak server RSS are compared with
+    perf_baseline.json, within PERF_TOLERANCE.
+    """
+
+    @pytest.fixture(autouse=True)
+    def _relaxed_rules(self):
+        old_nullable = get_inception_var("inception_check_nullable")
+        old_mhc = get_inception_var("inception_check_must_have_columns")
+        set_inception_var("inception_check_nullable", 0)
+        set_inception_var("inception_check_must_have_columns", 0)
+        yield
+        set_inception_var("inception_check_nullable", old_nullable)
+        set_inception_var("inception_check_must_have_columns", old_mhc)
+
+    @staticmethod
+    def _create_table(name, columns):
+        cols = "".join(
+            f"  c{i} VARCHAR(32) NOT NULL DEFAULT '' COMMENT 'c{i}',"
+            for i in range(columns - 1))
+        return (f"CREATE TABLE {name} ("
+                f"  id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'pk',"
+                f"{cols}"
+                f"  PRIMARY KEY (id)"
+                f") ENGINE=InnoDB COMMENT 'perf';")
+
+    def test_migration_5000_statements(self, test_db_name, perf_baseline):
+        """100 tables created, altered and filled: 5,000 statements."""
+        from conftest import PerfRun
+        stmts = [f"CREATE DATABASE {test_db_name};", f"USE {test_db_name};"]
+        for t in range(100):
+            stmts.append(self._create_table(f"t{t}", 4))
+        for t in range(100):
+            stmts.append(f"ALTER TABLE t{t} ADD COLUMN n INT NOT NULL DEFAULT 0 COMMENT 'n';")
+            stmts.append(f"ALTER TABLE t{t} ADD INDEX idx_c0 (c0);")
+        for i in range(4700):
+            t = i % 100
+            if i % 3 == 0:
+                stmts.append(f"INSERT INTO t{t} (id, c0, c1) VALUES ({i + 1}, 'a{i}', 'b');")
+            elif i % 3 == 1:
+                stmts.append(f"UPDATE t{t} SET c2 = 'x' WHERE id = {i};")
+            else:
+                stmts.append(f"DELETE FROM t{t} WHERE id = {i - 1};")
+        with PerfRun("migration_5000_statements") as run:
+            rows = inception_execute("\n".join(stmts))
+        assert len(rows) == len(stmts)
+        perf_baseline(run)
+
+    def test_insert_script_50k_rows(self, test_db_name, perf_baseline):
+        """500 INSERTs of 100 rows each."""
+        from conftest import PerfRun
+        stmts = [f"CREATE DATABASE {test_db_name};", f"USE {test_db_name};",
+                 self._create_table("t_rows", 3)]
+        for b in range(500):
+            values = ", ".join(
+                f"({b * 100 + r + 1}, 'name{r}', 'value')" for r in range(100))
+            stmts.append(f"INSERT INTO t_rows (id, c0, c1) VALUES {values};")
+        with PerfRun("insert_script_50k_rows") as run:
+            rows = inception_execute("\n".join(stmts))
+        assert len(rows) == len(stmts)
+        assert int(remote_query(
+            f"SELECT COUNT(*) FROM `{test_db_name}`.t_rows")[0][0]) == 50000
+        perf_baseline(run)
+
+    def test_create_table_200_columns(self, test_db_name, perf_baseline):
+        """CHECK of 20 CREATE TABLEs of 200 columns."""
+        from conftest import PerfRun
+        stmts = [f"CREATE DATABASE {test_db_name};", f"USE {test_db_name};"]
+        stmts += [self._create_table(f"t_wide{t}", 200) for t in range(20)]
+        with PerfRun("create_table_200_columns") as run:
+            rows = inception_check("\n".join(stmts))
+        assert len(rows) == len(stmts)
+        perf_baseline(run)
+
+    def test_query_tree_nested_selects(self, perf_baseline):
+        """QUERY_TREE of 100 SELECTs nested 20 subqueries deep."""
+        from conftest import PerfRun
+        sql = "SELECT id FROM db.t0 WHERE id > 0"
+        for depth in range(1, 20):
+            sql = (f"SELECT a{depth}.id, a{depth}.c0 FROM db.t{depth} a{depth} "
+                   f"WHERE a{depth}.id IN ({sql}) AND a{depth}.c1 = 'x'")
+        stmts = [f"{sql} LIMIT {i + 1};" for i in range(100)]
+        with PerfRun("query_tree_nested_selects") as run:
+            rows = inception_query_tree("\n".join(stmts))
+        assert len(rows) == 100
+        perf_baseline(run)
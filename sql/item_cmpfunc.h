@@ -1224,6 +1224,10 @@ class Item_func_opt_neg : public Item_int_func {
       : Item_int_func(pos, list), negated(false), pred_level(false) {
     if (is_negation) negate();
   }
+  Item_func_opt_neg(mem_root_deque<Item *> *list, bool is_negation)
+      : Item_int_func(list), negated(false), pred_level(false) {
+    if (is_negation) negate();
+  }
 
  public:
   inline void negate() { negated = !negated; }
@@ -2020,6 +2024,13 @@ class Item_func_in final : public Item_func_opt_neg {
     memset(&cmp_items, 0, sizeof(cmp_items));
     allowed_arg_cols = 0;  // Fetch this value from first argument
   }
+  /// Constructor used by the optimizer, the first element of list is the
+  /// left operand.
+  Item_func_in(mem_root_deque<Item *> *list, bool is_negation)
+      : Item_func_opt_neg(list, is_negation) {
+    memset(&cmp_items, 0, sizeof(cmp_items));
+    allowed_arg_cols = 0;  // Fetch this value from first argument
+  }
   ~Item_func_in() override;
   longlong val_int() override;
   bool fix_fields(THD *, Item **) override;
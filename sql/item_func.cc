@@ -5024,6 +5024,40 @@ longlong Item_func_gtid_subset::val_int() {
   const char *charp1, *charp2;
   int ret = 1;
   enum_return_status status;
+
+  /*
+    Checking many sets against the same large set, such as a copy of
+    gtid_executed, should not parse the large set again for every row.
+  */
+  if (args[1]->const_item() && !m_const_super_parsed &&
+      (string2 = args[1]->val_str(&buf2)) != nullptr &&
+      (charp2 = string2->c_ptr_safe()) != nullptr) {
+    // Parsed once; a set that does not parse takes the path below.
+    m_const_super_parsed = true;
+    m_const_super_sid_map = new (std::nothrow) Sid_map(nullptr /*no rwlock*/);
+    if (m_const_super_sid_map != nullptr) {
+      m_const_super_set =
+          new (std::nothrow) Gtid_set(m_const_super_sid_map, charp2, &status);
+      if (m_const_super_set == nullptr || status != RETURN_STATUS_OK) {
+        delete m_const_super_set;
+        m_const_super_set = nullptr;
+        delete m_const_super_sid_map;
+        m_const_super_sid_map = nullptr;
+      }
+    }
+  }
+
+  if (m_const_super_set != nullptr) {
+    if ((string1 = args[0]->val_str(&buf1)) != nullptr &&
+        (charp1 = string1->c_ptr_safe()) != nullptr) {
+      Sid_map sid_map(nullptr /*no rwlock*/);
+      const Gtid_set sub_set(&sid_map, charp1, &status);
+      if (status == RETURN_STATUS_OK)
+        ret = sub_set.is_subset(m_const_super_set) ? 1 : 0;
+    }
+    return ret;
+  }
+
   // get strings without lock
   if ((string1 = args[0]->val_str(&buf1)) != nullptr &&
       (charp1 = string1->c_ptr_safe()) != nullptr &&
@@ -5041,6 +5075,15 @@ longlong Item_func_gtid_subset::val_int() {
   return ret;
 }
 
+void Item_func_gtid_subset::cleanup() {
+  delete m_const_super_set;
+  m_const_super_set = nullptr;
+  delete m_const_super_sid_map;
+  m_const_super_sid_map = nullptr;
+  m_const_super_parsed = false;
+  Item_int_func::cleanup();
+}
+
 /**
   Enables a session to wait on a condition until a timeout or a network
   disconnect occurs.
@@ -63,10 +63,12 @@
 #include "sql_string.h"
 #include "template_utils.h"
 
+class Gtid_set;
 class Json_wrapper;
 class PT_item_list;
 class Protocol;
 class Query_block;
+class Sid_map;
 class THD;
 class sp_rcontext;
 struct MY_BITMAP;
@@ -2420,11 +2422,17 @@ class Item_master_gtid_set_wait final : public Item_int_func {
 class Item_func_gtid_subset final : public Item_int_func {
   String buf1;
   String buf2;
+  /// Parsed once if the second argument is constant.
+  Sid_map *m_const_super_sid_map{nullptr};
+  Gtid_set *m_const_super_set{nullptr};
+  /// The constant second argument was parsed, or failed to parse.
+  bool m_const_super_parsed{false};
 
  public:
   Item_func_gtid_subset(const POS &pos, Item *a, Item *b)
       : Item_int_func(pos, a, b) {}
   longlong val_int() override;
+  void cleanup() override;
   const char *func_name() const override { return "gtid_subset"; }
   bool resolve_type(THD *thd) override {
     if (param_type_is_default(thd, 0, -1)) return true;
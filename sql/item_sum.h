@@ -1025,6 +1025,20 @@ class Item_sum_sum : public Item_sum_num {
   void update_field() override;
   const char *func_name() const override { return "sum"; }
   Item *copy_or_same(THD *thd) override;
+  /**
+    Use a sum computed by the storage engine, see
+    handler::column_aggregate(). Also used by AVG().
+
+    @param sum_arg    Sum of the values of the argument that are not NULL.
+    @param count_arg  Number of such values.
+  */
+  void make_const(const my_decimal *sum_arg, ulonglong count_arg) {
+    assert(hybrid_type == DECIMAL_RESULT);
+    dec_buffs[curr_dec_buff] = *sum_arg;
+    m_count = count_arg;
+    null_value = count_arg == 0;
+    Item_sum::make_const();
+  }
 };
 
 class Item_sum_count : public Item_sum_int {
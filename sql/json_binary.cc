@@ -27,6 +27,7 @@
 #include <cassert>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <utility>
 
@@ -39,6 +40,7 @@
 #endif
 #include "sql/field.h"     // Field_json
 #include "sql/json_dom.h"  // Json_dom
+#include "sql/json_path.h"  // Json_path
 #include "sql/json_syntax_check.h"
 #include "sql/sql_class.h"  // THD
 #include "sql/sql_const.h"
@@ -2099,6 +2101,293 @@ int Value::eq(const Value &val) const {
 }
 #endif  // ifdef MYSQL_SERVER
 
+#ifdef MYSQL_SERVER
+bool Projection::add_path(const Json_path &path) {
+  if (path.leg_count() == 0) return true;
+
+  std::vector<std::string> members;
+  for (const Json_path_leg *leg : path) {
+    if (leg->get_type() != jpl_member) return true;
+    members.push_back(leg->get_member_name());
+  }
+
+  // Keep shorter paths first, so that project() sees a path before any of
+  // the paths that extend it.
+  const auto pos = std::upper_bound(
+      m_paths.begin(), m_paths.end(), members,
+      [](const std::vector<std::string> &a, const std::vector<std::string> &b) {
+        return a.size() < b.size();
+      });
+  m_paths.insert(pos, std::move(members));
+  return false;
+}
+
+namespace {
+/// A value in a document that is read through a Projection::Range_reader.
+struct Located_value {
+  /// The type of the value.
+  uint8 m_type;
+  /// The offset of the value in the document, after its type byte.
+  size_t m_offset;
+  /// True if the value is inlined in the value entry of its parent.
+  bool m_inlined;
+  /// The value entry of an inlined value.
+  char m_entry[LARGE_OFFSET_SIZE];
+};
+}  // namespace
+
+/**
+  Read a byte range of a document, checking that it is within the document.
+  @return false on success, true on error
+*/
+static bool read_range(const Projection::Range_reader &reader,
+                       size_t doc_length, size_t offset, size_t length,
+                       char *dest) {
+  if (offset > doc_length || length > doc_length - offset) return true;
+  return reader(offset, length, dest);
+}
+
+/**
+  Look up a member of an object in a document that is read through a
+  Projection::Range_reader. Only the header and the keys of the object
+  are read.
+
+  @param[in]  reader      reads byte ranges of the document
+  @param[in]  doc_length  the length of the document
+  @param[in]  object      the value to look in
+  @param[in]  key         the name of the member
+  @param[out] member      the member, if found
+  @param[out] found       whether the member was found
+  @return false on success, true if the document could not be read
+*/
+static bool lookup_member(const Projection::Range_reader &reader,
+                          size_t doc_length, const Located_value &object,
+                          const std::string &key, Located_value *member,
+                          bool *found) {
+  *found = false;
+  if (object.m_inlined || (object.m_type != JSONB_TYPE_SMALL_OBJECT &&
+                           object.m_type != JSONB_TYPE_LARGE_OBJECT))
+    return false;
+
+  const bool large = object.m_type == JSONB_TYPE_LARGE_OBJECT;
+  const size_t offset_size = json_binary::offset_size(large);
+  const size_t key_entry_size = json_binary::key_entry_size(large);
+  const size_t value_entry_size = json_binary::value_entry_size(large);
+
+  char header[2 * LARGE_OFFSET_SIZE];
+  if (read_range(reader, doc_length, object.m_offset, 2 * offset_size, header))
+    return true;
+  const size_t element_count = read_offset_or_size(header, large);
+  const size_t bytes = read_offset_or_size(header + offset_size, large);
+  if (bytes > doc_length - object.m_offset) return true;
+  if (element_count == 0) return false;
+
+  std::vector<char> entries(element_count *
+                            (key_entry_size + value_entry_size));
+  if (2 * offset_size + entries.size() > bytes ||
+      read_range(reader, doc_length, object.m_offset + 2 * offset_size,
+                 entries.size(), entries.data()))
+    return true;
+
+  // The keys are stored next to each other, in the order of the key entries.
+  const char *last_key_entry = &entries[(element_count - 1) * key_entry_size];
+  const size_t keys_begin = read_offset_or_size(entries.data(), large);
+  const size_t keys_end = read_offset_or_size(last_key_entry, large) +
+                          uint2korr(last_key_entry + offset_size);
+  if (keys_begin < 2 * offset_size + entries.size() || keys_end < keys_begin ||
+      keys_end > bytes)
+    return true;
+
+  std::vector<char> keys(keys_end - keys_begin);
+  if (read_range(reader, doc_length, object.m_offset + keys_begin, keys.size(),
+                 keys.data()))
+    return true;
+
+  // Keys are ordered on length first, then on contents. See lookup_index().
+  size_t lo = 0;
+  size_t hi = element_count;
+  while (lo < hi) {
+    const size_t idx = (lo + hi) / 2;
+    const char *key_entry = &entries[idx * key_entry_size];
+    const size_t key_len = uint2korr(key_entry + offset_size);
+    int cmp;
+    if (key.length() != key_len) {
+      cmp = key.length() > key_len ? 1 : -1;
+    } else {
+      const size_t key_offset = read_offset_or_size(key_entry, large);
+      if (key_offset < keys_begin || key_offset + key_len > keys_end)
+        return true;
+      cmp = memcmp(key.data(), &keys[key_offset - keys_begin], key_len);
+    }
+
+    if (cmp > 0) {
+      lo = idx + 1;
+    } else if (cmp < 0) {
+      hi = idx;
+    } else {
+      const char *value_entry = &entries[element_count * key_entry_size +
+                                         idx * value_entry_size];
+      member->m_type = static_cast<uint8>(*value_entry);
+      member->m_inlined = inlined_type(member->m_type, large);
+      member->m_offset = 0;
+      memset(member->m_entry, 0, sizeof(member->m_entry));
+      if (member->m_inlined) {
+        memcpy(member->m_entry, value_entry + 1, offset_size);
+      } else {
+        const size_t value_offset =
+            read_offset_or_size(value_entry + 1, large);
+        if (value_offset >= bytes) return true;
+        member->m_offset = object.m_offset + value_offset;
+      }
+      *found = true;
+      return false;
+    }
+  }
+
+  return false;
+}
+
+/**
+  Read a value from a document that is read through a
+  Projection::Range_reader, and convert it to a DOM.
+
+  @param[in]  thd         THD handle
+  @param[in]  reader      reads byte ranges of the document
+  @param[in]  doc_length  the length of the document
+  @param[in]  value       the value to read
+  @param[out] dom         the value as a DOM
+  @return false on success, true if the value could not be read
+*/
+static bool read_value_dom(const THD *thd,
+                           const Projection::Range_reader &reader,
+                           size_t doc_length, const Located_value &value,
+                           Json_dom_ptr *dom) {
+  std::vector<char> buffer(1, static_cast<char>(value.m_type));
+
+  if (value.m_inlined) {
+    buffer.insert(buffer.end(), value.m_entry,
+                  value.m_entry + sizeof(value.m_entry));
+  } else {
+    size_t size;
+    switch (value.m_type) {
+      case JSONB_TYPE_SMALL_OBJECT:
+      case JSONB_TYPE_LARGE_OBJECT:
+      case JSONB_TYPE_SMALL_ARRAY:
+      case JSONB_TYPE_LARGE_ARRAY: {
+        const bool large = value.m_type == JSONB_TYPE_LARGE_OBJECT ||
+                           value.m_type == JSONB_TYPE_LARGE_ARRAY;
+        char header[2 * LARGE_OFFSET_SIZE];
+        if (read_range(reader, doc_length, value.m_offset,
+                       2 * offset_size(large), header))
+          return true;
+        size = read_offset_or_size(header + offset_size(large), large);
+        break;
+      }
+      case JSONB_TYPE_STRING:
+      case JSONB_TYPE_OPAQUE: {
+        // An opaque value has a field type byte before its length.
+        const size_t prefix = value.m_type == JSONB_TYPE_OPAQUE ? 1 : 0;
+        char header[6];
+        const size_t avail =
+            std::min(sizeof(header), doc_length - value.m_offset);
+        uint32 length;
+        uint8 length_bytes;
+        if (avail <= prefix ||
+            read_range(reader, doc_length, value.m_offset, avail, header) ||
+            read_variable_length(header + prefix, avail - prefix, &length,
+                                 &length_bytes))
+          return true;
+        size = prefix + length_bytes + length;
+        break;
+      }
+      case JSONB_TYPE_LITERAL:
+        size = 1;
+        break;
+      case JSONB_TYPE_INT16:
+      case JSONB_TYPE_UINT16:
+        size = 2;
+        break;
+      case JSONB_TYPE_INT32:
+      case JSONB_TYPE_UINT32:
+        size = 4;
+        break;
+      case JSONB_TYPE_INT64:
+      case JSONB_TYPE_UINT64:
+      case JSONB_TYPE_DOUBLE:
+        size = 8;
+        break;
+      default:
+        return true;
+    }
+
+    buffer.resize(1 + size);
+    if (read_range(reader, doc_length, value.m_offset, size, &buffer[1]))
+      return true;
+  }
+
+  const Value binary = parse_binary(buffer.data(), buffer.size());
+  if (binary.type() == Value::ERROR) return true;
+  *dom = Json_wrapper(binary).clone_dom(thd);
+  return *dom == nullptr;
+}
+
+bool Projection::project(const THD *thd, const Range_reader &reader,
+                         size_t length, String *dest) const {
+  char type;
+  if (read_range(reader, length, 0, 1, &type)) return true;
+
+  // Only members of objects can be projected.
+  Located_value root;
+  root.m_type = static_cast<uint8>(type);
+  root.m_offset = 1;
+  root.m_inlined = false;
+  if (root.m_type != JSONB_TYPE_SMALL_OBJECT &&
+      root.m_type != JSONB_TYPE_LARGE_OBJECT)
+    return true;
+
+  Json_object result;
+  // The values in result that hold a whole member of the original document.
+  std::set<const Json_dom *> whole_values;
+
+  for (const std::vector<std::string> &members : m_paths) {
+    Located_value value = root;
+    bool found = true;
+    for (const std::string &member : members) {
+      if (lookup_member(reader, length, value, member, &value, &found))
+        return true;
+      if (!found) break;
+    }
+    if (!found) continue;
+
+    // Find or create the parent of the member in the result. Skip the path
+    // if a shorter path has already added a value that contains the member.
+    Json_object *parent = &result;
+    bool covered = false;
+    for (size_t i = 0; i + 1 < members.size() && !covered; ++i) {
+      Json_dom *child = parent->get(members[i]);
+      if (child == nullptr) {
+        Json_object_ptr object = create_dom_ptr<Json_object>();
+        Json_object *raw = object.get();
+        if (parent->add_alias(members[i], std::move(object))) return true;
+        parent = raw;
+      } else if (whole_values.count(child) != 0) {
+        covered = true;
+      } else {
+        parent = down_cast<Json_object *>(child);
+      }
+    }
+    if (covered || parent->get(members.back()) != nullptr) continue;
+
+    Json_dom_ptr dom;
+    if (read_value_dom(thd, reader, length, value, &dom)) return true;
+    whole_values.insert(dom.get());
+    if (parent->add_alias(members.back(), std::move(dom))) return true;
+  }
+
+  return serialize(thd, &result, dest);
+}
+#endif  // ifdef MYSQL_SERVER
+
 bool Value::to_std_string(std::string *buffer) const {
   buffer->clear();
   Json_wrapper wrapper(*this);
@@ -143,7 +143,9 @@
 #include <stddef.h>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 /*
   This file is part of our public interface for the 'json_binary' library.
@@ -155,6 +157,7 @@
 #ifdef MYSQL_SERVER
 class Field_json;
 class Json_dom;
+class Json_path;
 class Json_wrapper;
 class THD;
 #endif
@@ -528,6 +531,55 @@ bool for_each_node(const Value &value, const Func &func) {
 
   return false;
 }
+
+#ifdef MYSQL_SERVER
+/**
+  A set of JSON paths that consist of member legs only. A storage engine
+  that keeps a JSON document out of line can use project() to read just
+  the members named by the paths, instead of fetching the whole document.
+  Evaluating any of the paths on the projected document gives the same
+  result as evaluating it on the original document.
+*/
+class Projection {
+ public:
+  /**
+    Callback that reads a byte range of the original document.
+    It returns false on success, or true if the range could not be read.
+  */
+  using Range_reader =
+      std::function<bool(size_t offset, size_t length, char *dest)>;
+
+  /**
+    Add a path to the projection.
+
+    @param path  the path to add
+    @retval false on success
+    @retval true if the path is empty, or has legs other than member names
+  */
+  bool add_path(const Json_path &path);
+
+  /**
+    Build a document that contains only the members of the projection.
+    Only the header of each object on the paths and the values of the
+    projected members are read from the original document.
+
+    @param[in]  thd     THD handle
+    @param[in]  reader  reads byte ranges of the original document
+    @param[in]  length  the length of the original document
+    @param[out] dest    the projected document
+    @retval false on success
+    @retval true if the document could not be projected, in which case
+    the caller should read the whole document
+  */
+  bool project(const THD *thd, const Range_reader &reader, size_t length,
+               String *dest) const;
+
+ private:
+  /// The member names of each path, shortest paths first.
+  std::vector<std::vector<std::string>> m_paths;
+};
+#endif
+
 }  // namespace json_binary
 
 #endif /* JSON_BINARY_INCLUDED */
@@ -2420,6 +2420,78 @@ end:
   delete td;
 }
 
+/**
+  The length of a row image of table td with the columns of cols.
+
+  @return The length, 0 if the image is corrupted.
+*/
+static size_t row_image_length(table_def *td, MY_BITMAP *cols,
+                               const uchar *value, const uchar *end) {
+  const uchar *value0 = value;
+  Bit_reader null_bits(value);
+  value += (bitmap_bits_set(cols) + 7) / 8;
+  if (value > end) return 0;
+
+  for (size_t i = 0; i < td->size() && i < cols->n_bits; i++) {
+    if (bitmap_is_set(cols, i) == 0 || null_bits.get()) continue;
+    size_t fsize = td->calc_field_size((uint)i, value);
+    if (fsize > (size_t)(end - value)) return 0;
+    value += fsize;
+  }
+  return value - value0;
+}
+
+bool Rows_log_event::get_flashback_event(table_def *td, std::string *buf) {
+  Log_event_type type = get_type_code();
+  Log_event_type undo_type;
+  switch (type) {
+    case binary_log::WRITE_ROWS_EVENT:
+      undo_type = binary_log::DELETE_ROWS_EVENT;
+      break;
+    case binary_log::DELETE_ROWS_EVENT:
+      undo_type = binary_log::WRITE_ROWS_EVENT;
+      break;
+    case binary_log::UPDATE_ROWS_EVENT:
+      undo_type = binary_log::UPDATE_ROWS_EVENT;
+      break;
+    default:
+      return true;
+  }
+  if (!bitmap_is_set_all(&m_cols) ||
+      (type == binary_log::UPDATE_ROWS_EVENT && !bitmap_is_set_all(&m_cols_ai)))
+    return true;
+
+  size_t event_len = uint4korr(temp_buf + EVENT_LEN_OFFSET);
+  if (common_footer->checksum_alg == binary_log::BINLOG_CHECKSUM_ALG_CRC32)
+    event_len -= BINLOG_CHECKSUM_LEN;
+  const size_t rows_len = m_rows_end - m_rows_buf;
+  if (rows_len > event_len - LOG_EVENT_HEADER_LEN) return true;
+
+  /* Header, post header, width and column bitmaps are kept */
+  buf->assign(temp_buf, event_len - rows_len);
+  (*buf)[EVENT_TYPE_OFFSET] = static_cast<char>(undo_type);
+  uchar *flags_ptr =
+      pointer_cast<uchar *>(&(*buf)[LOG_EVENT_HEADER_LEN + ROWS_FLAGS_OFFSET]);
+  int2store(flags_ptr, uint2korr(flags_ptr) & ~STMT_END_F);
+
+  if (type != binary_log::UPDATE_ROWS_EVENT) {
+    buf->append(pointer_cast<const char *>(m_rows_buf), rows_len);
+  } else {
+    for (const uchar *value = m_rows_buf; value < m_rows_end;) {
+      size_t before_len = row_image_length(td, &m_cols, value, m_rows_end);
+      if (before_len == 0) return true;
+      size_t after_len =
+          row_image_length(td, &m_cols_ai, value + before_len, m_rows_end);
+      if (after_len == 0) return true;
+      buf->append(pointer_cast<const char *>(value) + before_len, after_len);
+      buf->append(pointer_cast<const char *>(value), before_len);
+      value += before_len + after_len;
+    }
+  }
+  int4store(pointer_cast<uchar *>(&(*buf)[EVENT_LEN_OFFSET]), buf->size());
+  return false;
+}
+
 void Log_event::print_base64(IO_CACHE *file, PRINT_EVENT_INFO *print_event_info,
                              bool more) const {
   const uchar *ptr = (const uchar *)temp_buf;
@@ -9437,6 +9509,47 @@ end:
   return error;
 }
 
+void Rows_log_event::prefetch_rows(Relay_log_info const *rli) {
+  DBUG_TRACE;
+  uint keyno = MAX_KEY;
+  const bool is_write = get_general_type_code() == binary_log::WRITE_ROWS_EVENT;
+  const bool is_update =
+      get_general_type_code() == binary_log::UPDATE_ROWS_EVENT;
+
+  if (is_write && m_rows_lookup_algorithm == ROW_LOOKUP_NOT_NEEDED)
+    keyno = m_table->s->primary_key;
+  else if (!is_write && m_rows_lookup_algorithm == ROW_LOOKUP_INDEX_SCAN)
+    keyno = m_key_index;
+
+  if (keyno >= MAX_KEY || thd->is_error()) return;
+
+  KEY *key_info = m_table->key_info + keyno;
+  uchar *key = static_cast<uchar *>(thd->alloc(key_info->key_length));
+  if (key == nullptr) return;
+
+  const uchar *saved_m_curr_row = m_curr_row;
+  const uchar *saved_m_curr_row_end = m_curr_row_end;
+
+  while (m_curr_row < m_rows_end) {
+    prepare_record(m_table, &this->m_local_cols, false);
+    if (unpack_current_row(rli, &m_cols, is_write)) break;
+    key_copy(key, m_table->record[0], key_info, 0);
+    m_table->file->prefetch_key(keyno, key, key_info->key_length);
+
+    if (is_update) {
+      m_curr_row = m_curr_row_end;
+      if (unpack_current_row(rli, &m_cols_ai, true /*is AI*/, true /*seek*/))
+        break;
+    }
+    if (m_curr_row_end <= m_curr_row) break;
+    m_curr_row = m_curr_row_end;
+  }
+
+  if (thd->is_error()) thd->clear_error();
+  m_curr_row = saved_m_curr_row;
+  m_curr_row_end = saved_m_curr_row_end;
+}
+
 int Rows_log_event::do_apply_event(Relay_log_info const *rli) {
   DBUG_TRACE;
   TABLE *table = nullptr;
@@ -9949,6 +10062,8 @@ int Rows_log_event::do_apply_event(Relay_log_info const *rli) {
     m_psi_progress.set_progress(mysql_set_stage(stage->m_key));
 #endif
 
+    if (opt_slave_prefetch_rows) prefetch_rows(rli);
+
     do {
       DBUG_PRINT("info", ("calling do_apply_row_ptr"));
 
@@ -2748,6 +2748,20 @@ class Rows_log_event : public virtual binary_log::Rows_event, public Log_event {
                                MY_BITMAP *cols_bitmap, const uchar *ptr,
                                const uchar *prefix,
                                enum_row_image_type row_image_type);
+  /**
+    The event that undoes this one: a Write_rows event becomes a
+    Delete_rows event and back, an Update_rows event gets its images
+    swapped. STMT_END_F is cleared.
+
+    @param td        The table the rows are of
+    @param[out] buf  The event, without a checksum
+
+    @retval false Success
+    @retval true  The event cannot be undone: it is not a version 2 Write,
+                  Update or Delete rows event, its rows do not hold all the
+                  columns (binlog_row_image=FULL) or they are corrupted.
+  */
+  bool get_flashback_event(table_def *td, std::string *buf);
 #endif
 
 #ifdef MYSQL_SERVER
@@ -3056,6 +3070,14 @@ class Rows_log_event : public virtual binary_log::Rows_event, public Log_event {
    */
   int do_apply_row(Relay_log_info const *rli);
 
+  /**
+     Hands the keys of all the rows of the event, as the lookup algorithm
+     will look them up, to handler::prefetch_key() before the first one is
+     applied (slave_prefetch_rows). m_curr_row is left as it was; an error
+     unpacking a row ends it and is left for the row apply to report.
+   */
+  void prefetch_rows(Relay_log_info const *rli);
+
   /**
      Implementation of the index scan and update algorithm. It uses
      PK, UK or regular Key to search for the record to update. When
@@ -767,6 +767,11 @@ MySQL clients support the protocol:
 #include "sql/events.h"              // Events
 #include "sql/handler.h"
 #include "sql/hostname_cache.h"  // hostname_cache_init
+#include "sql/inception/inception_cache.h"  // inception::start_schema_warmup
+#include "sql/inception/inception_job.h"  // inception::job_shutdown
+#include "sql/inception/inception_log.h"  // inception::audit_log_shutdown
+#include "sql/inception/inception_snapshot.h"  // inception::schema_watch_shutdown
+#include "sql/inception/inception_status.h"  // inception::status_vars
 #include "sql/init.h"            // unireg_init
 #include "sql/item.h"
 #include "sql/item_cmpfunc.h"  // Arg_comparator
@@ -791,6 +796,7 @@ MySQL clients support the protocol:
 #include "sql/protocol.h"
 #include "sql/psi_memory_key.h"  // key_memory_MYSQL_RELAY_LOG_index
 #include "sql/query_options.h"
+#include "sql/regexp/regexp_engine.h"               // free_regexp_cache
 #include "sql/replication.h"                        // thd_enter_cond
 #include "sql/resourcegroups/resource_group_mgr.h"  // init, post_init
 #ifdef _WIN32
@@ -1129,6 +1135,7 @@ const char *default_tmp_storage_engine;
 ulonglong temptable_max_ram;
 ulonglong temptable_max_mmap;
 bool temptable_use_mmap;
+ulong temptable_compression_min_length;
 static char compiled_default_collation_name[] = MYSQL_DEFAULT_COLLATION_NAME;
 static bool binlog_format_used = false;
 
@@ -1193,6 +1200,7 @@ bool opt_show_slave_auth_info;
 bool opt_log_slave_updates = false;
 char *opt_slave_skip_errors;
 bool opt_slave_allow_batching = false;
+bool opt_slave_prefetch_rows = false;
 
 /**
   compatibility option:
@@ -1256,6 +1264,7 @@ bool sp_automatic_privileges = true;
 
 int32_t opt_regexp_time_limit;
 int32_t opt_regexp_stack_limit;
+uint opt_regexp_cache_size;
 
 /** True, if restarted from a cloned database. This information
 is needed by GR to set some configurations right after clone. */
@@ -2472,6 +2481,13 @@ static void clean_up(bool print_message) {
 
   memcached_shutdown();
 
+  /* Stop background inception jobs and schema watchers, then flush pending
+     audit log records */
+  inception::job_shutdown();
+  inception::schema_warmup_shutdown();
+  inception::schema_watch_shutdown();
+  inception::audit_log_shutdown();
+
   release_keyring_handles();
   keyring_lockable_deinit();
 
@@ -2528,6 +2544,7 @@ static void clean_up(bool print_message) {
   rpl_channel_filters.clean_up();
   end_ssl();
   vio_end();
+  regexp::free_regexp_cache();
   u_cleanup();
 #if defined(ENABLED_DEBUG_SYNC)
   /* End the debug sync facility. See debug_sync.cc. */
@@ -7519,6 +7536,8 @@ int mysqld_main(int argc, char **argv)
 
   create_compress_gtid_table_thread();
 
+  inception::start_schema_warmup();
+
   LogEvent()
       .type(LOG_TYPE_ERROR)
       .subsys(LOG_SUBSYSTEM_TAG)
@@ -8633,6 +8652,32 @@ static int show_max_used_connections_time(THD *thd, SHOW_VAR *var, char *buff) {
   return 0;
 }
 
+static int show_mem_root_block_cache_bytes(THD *, SHOW_VAR *var,
+                                           char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  long long *value = reinterpret_cast<long long *>(buff);
+  *value = static_cast<long long>(mem_root_block_cache_bytes.load());
+  return 0;
+}
+
+static int show_mem_root_block_cache_hits(THD *, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  long long *value = reinterpret_cast<long long *>(buff);
+  *value = static_cast<long long>(mem_root_block_cache_hits.load());
+  return 0;
+}
+
+static int show_mem_root_block_cache_misses(THD *, SHOW_VAR *var,
+                                            char *buff) {
+  var->type = SHOW_LONGLONG;
+  var->value = buff;
+  long long *value = reinterpret_cast<long long *>(buff);
+  *value = static_cast<long long>(mem_root_block_cache_misses.load());
+  return 0;
+}
+
 static int show_num_thread_running(THD *, SHOW_VAR *var, char *buff) {
   var->type = SHOW_LONGLONG;
   var->value = buff;
@@ -8642,6 +8687,31 @@ static int show_num_thread_running(THD *, SHOW_VAR *var, char *buff) {
   return 0;
 }
 
+static int show_thread_pool_threads(THD *, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONG;
+  var->value = buff;
+  long *value = reinterpret_cast<long *>(buff);
+  *value = static_cast<long>(Thread_pool_connection_handler::thread_count);
+  return 0;
+}
+
+static int show_thread_pool_idle_threads(THD *, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONG;
+  var->value = buff;
+  long *value = reinterpret_cast<long *>(buff);
+  *value =
+      static_cast<long>(Thread_pool_connection_handler::idle_thread_count);
+  return 0;
+}
+
+static int show_thread_pool_stalls(THD *, SHOW_VAR *var, char *buff) {
+  var->type = SHOW_LONG;
+  var->value = buff;
+  long *value = reinterpret_cast<long *>(buff);
+  *value = static_cast<long>(Thread_pool_connection_handler::stall_count);
+  return 0;
+}
+
 static int show_num_thread_created(THD *, SHOW_VAR *var, char *buff) {
   var->type = SHOW_LONG;
   var->value = buff;
@@ -9125,6 +9195,8 @@ SHOW_VAR status_vars[] = {
      SHOW_LONGLONG_STATUS, SHOW_SCOPE_ALL},
     {"Handler_write", (char *)offsetof(System_status_var, ha_write_count),
      SHOW_LONGLONG_STATUS, SHOW_SCOPE_ALL},
+    {"Inception", (char *)inception::status_vars, SHOW_ARRAY,
+     SHOW_SCOPE_GLOBAL},
     {"Key_blocks_not_flushed",
      (char *)offsetof(KEY_CACHE, global_blocks_changed), SHOW_KEY_CACHE_LONG,
      SHOW_SCOPE_GLOBAL},
@@ -9161,6 +9233,12 @@ SHOW_VAR status_vars[] = {
      SHOW_SCOPE_GLOBAL},
     {"Max_used_connections_time", (char *)&show_max_used_connections_time,
      SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"Mem_root_block_cache_bytes", (char *)&show_mem_root_block_cache_bytes,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"Mem_root_block_cache_hits", (char *)&show_mem_root_block_cache_hits,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"Mem_root_block_cache_misses", (char *)&show_mem_root_block_cache_misses,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
     {"Not_flushed_delayed_rows", (char *)&delayed_rows_in_use,
      SHOW_LONG_NOFLUSH, SHOW_SCOPE_GLOBAL},
     {"Open_files", (char *)&my_file_opened, SHOW_LONG_NOFLUSH,
@@ -9338,6 +9416,12 @@ SHOW_VAR status_vars[] = {
      SHOW_SCOPE_GLOBAL},
     {"Tc_log_page_waits", (char *)&tc_log_page_waits, SHOW_LONG,
      SHOW_SCOPE_GLOBAL},
+    {"Thread_pool_idle_threads", (char *)&show_thread_pool_idle_threads,
+     SHOW_FUNC, SHOW_SCOPE_GLOBAL},
+    {"Thread_pool_stalls", (char *)&show_thread_pool_stalls, SHOW_FUNC,
+     SHOW_SCOPE_GLOBAL},
+    {"Thread_pool_threads", (char *)&show_thread_pool_threads, SHOW_FUNC,
+     SHOW_SCOPE_GLOBAL},
     {"Threads_cached",
      (char *)&Per_thread_connection_handler::blocked_pthread_count,
      SHOW_LONG_NOFLUSH, SHOW_SCOPE_GLOBAL},
@@ -11628,6 +11712,8 @@ static void init_server_psi_keys(void) {
   init_vio_psi_keys();
   /* TLS interfaces */
   init_tls_psi_keys();
+  /* Inception stages and mutexes */
+  inception::init_psi_keys();
 }
 #endif /* HAVE_PSI_INTERFACE */
 
@@ -174,6 +174,7 @@ extern ulong slave_exec_mode_options;
 extern Rpl_global_filter rpl_global_filter;
 extern int32_t opt_regexp_time_limit;
 extern int32_t opt_regexp_stack_limit;
+extern uint opt_regexp_cache_size;
 #ifdef _WIN32
 extern bool opt_no_monitor;
 #endif  // _WIN32
@@ -230,6 +231,7 @@ extern const char *default_tmp_storage_engine;
 extern ulonglong temptable_max_ram;
 extern ulonglong temptable_max_mmap;
 extern bool temptable_use_mmap;
+extern ulong temptable_compression_min_length;
 extern bool using_udf_functions;
 extern bool locked_in_memory;
 extern bool opt_using_transactions;
@@ -300,6 +302,7 @@ extern MYSQL_PLUGIN_IMPORT ulong max_connections;
 extern ulong max_digest_length;
 extern ulong max_connect_errors, connect_timeout;
 extern bool opt_slave_allow_batching;
+extern bool opt_slave_prefetch_rows;
 extern ulong slave_trans_retries;
 extern uint slave_net_timeout;
 extern ulong opt_mts_slave_parallel_workers;
@@ -109,6 +109,50 @@ ulonglong get_exact_record_count(TABLE_LIST *tables) {
   return count;
 }
 
+/**
+  Whether the argument of COUNT(), SUM() or AVG() is a column the storage
+  engine can aggregate in the execution phase, see
+  handler::column_aggregate(): a stored column of the only table, read
+  without locks, of an engine with HA_AGGREGATE_COLUMN_INSTANT.
+
+    @param thd          Thread handler
+    @param tables       Tables of the query block
+    @param arg          Argument of the aggregate function
+    @param need_integer The function sums its argument
+
+    @retval true if handler::column_aggregate() is to compute the function
+*/
+static bool is_column_aggregate(THD *thd, TABLE_LIST *tables, Item *arg,
+                                bool need_integer) {
+  if (tables->next_leaf != nullptr || tables->is_inner_table_of_outer_join())
+    return false;
+  TABLE *table = tables->table;
+  if (!(table->file->ha_table_flags() & HA_AGGREGATE_COLUMN_INSTANT) ||
+      table->force_index)
+    return false;
+  // Locking reads, and InnoDB turns reads into them with SERIALIZABLE
+  if ((table->reginfo.lock_type != TL_READ &&
+       table->reginfo.lock_type != TL_READ_HIGH_PRIORITY) ||
+      thd->tx_isolation == ISO_SERIALIZABLE || thd->locked_tables_mode)
+    return false;
+
+  Item *expr = arg->real_item();
+  if (expr->type() != Item::FIELD_ITEM) return false;
+  const Field *field = down_cast<Item_field *>(expr)->field;
+  if (field->table != table || field->is_virtual_gcol()) return false;
+  if (!need_integer) return true;
+  switch (field->type()) {
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_LONGLONG:
+      return true;
+    default:
+      return false;
+  }
+}
+
 /**
   Use index to read MIN(field) value.
 
@@ -443,6 +487,11 @@ bool optimize_aggregated_query(THD *thd, Query_block *select,
             if (fts_item->init_search(thd)) break;
             row_count = fts_item->get_count();
             have_exact_count = true;
+          } else if (conds == nullptr && tables_filled &&
+                     is_column_aggregate(thd, tables, item_count->get_arg(0),
+                                         false)) {
+            // COUNT(column) of a column that can be NULL
+            aggr_delayed = true;
           } else
             aggr_impossible = true;
 
@@ -453,6 +502,14 @@ bool optimize_aggregated_query(THD *thd, Query_block *select,
           }
           break;
         }
+        case Item_sum::SUM_FUNC:
+        case Item_sum::AVG_FUNC:
+          if (conds == nullptr && tables_filled &&
+              is_column_aggregate(thd, tables, item_sum->get_arg(0), true))
+            aggr_delayed = true;
+          else
+            aggr_impossible = true;
+          break;
         case Item_sum::MIN_FUNC:
         case Item_sum::MAX_FUNC: {
           int is_max = (item_sum->sum_func() == Item_sum::MAX_FUNC);
@@ -153,6 +153,60 @@ partition_info *partition_info::get_full_clone(THD *thd) {
   return clone;
 }
 
+/**
+  Take the partition definitions from the partition_info on the
+  TABLE_SHARE instead of parsing them for each TABLE instance.
+
+  Only the PARTITION BY clause has been parsed into this object, so the
+  partitioning type and the partition_elements are filled in here. The
+  elements are copied, since their state may change during ALTER, but
+  their names, options and values are shared with the TABLE_SHARE.
+
+  @param thd              Thread handle.
+  @param share_part_info  Partitioning as read from the data dictionary.
+
+  @retval true   Out of memory.
+  @retval false  Success.
+*/
+
+bool partition_info::set_partitions_from_share(
+    THD *thd, const partition_info *share_part_info) {
+  DBUG_TRACE;
+  assert(share_part_info->has_shareable_partitions());
+  assert(part_type == partition_type::HASH && !list_of_part_fields &&
+         !is_sub_partitioned());
+
+  part_type = share_part_info->part_type;
+  linear_hash_ind = false;
+  num_parts = share_part_info->num_parts;
+  use_default_partitions = share_part_info->use_default_partitions;
+  use_default_num_partitions = share_part_info->use_default_num_partitions;
+  defined_max_value = false;
+  partitions.clear();
+
+  List_iterator_fast<partition_element> part_it(
+      const_cast<List<partition_element> &>(share_part_info->partitions));
+  partition_element *part;
+  while ((part = part_it++)) {
+    partition_element *part_clone =
+        new (thd->mem_root) partition_element(*part);
+    if (part_clone == nullptr || partitions.push_back(part_clone)) {
+      mem_alloc_error(sizeof(partition_element));
+      return true;
+    }
+    if (part_clone->max_value) defined_max_value = true;
+    /* The parser flags a LIST partition having any negative value. */
+    if (part_type == partition_type::LIST) {
+      List_iterator_fast<part_elem_value> val_it(part_clone->list_val_list);
+      part_elem_value *val;
+      while ((val = val_it++)) {
+        if (!val->unsigned_flag) part_clone->signed_flag = true;
+      }
+    }
+  }
+  return false;
+}
+
 /**
   Mark named [sub]partition to be used/locked.
 
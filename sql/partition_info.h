@@ -469,6 +469,20 @@ class partition_info {
 
   partition_info *get_clone(THD *thd, bool reset = false);
   partition_info *get_full_clone(THD *thd);
+  /**
+    True if the partition definitions are fully described by the
+    partition_elements, i.e. RANGE or LIST partitioning on an expression
+    without subpartitions. The values then are plain integers and no Item
+    trees are needed, so the definitions can be shared between the
+    TABLE_SHARE and its TABLE instances.
+  */
+  bool has_shareable_partitions() const {
+    return (part_type == partition_type::RANGE ||
+            part_type == partition_type::LIST) &&
+           !column_list && !is_sub_partitioned() && part_func_len != 0;
+  }
+  bool set_partitions_from_share(THD *thd,
+                                 const partition_info *share_part_info);
   bool set_named_partition_bitmap(const char *part_name, size_t length);
   bool set_partition_bitmaps(TABLE_LIST *table_list);
   bool set_read_partitions(List<String> *partition_names);
@@ -25,15 +25,108 @@
 #include <stdint.h>
 
 #include <algorithm>  // copy
-#include <string>     // strlen
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>  // strlen
+#include <utility>
 
 #include "my_dbug.h"
+#include "sql/mysqld.h"  // opt_regexp_cache_size
 #include "sql/regexp/errors.h"
 #include "sql/sql_class.h"
 #include "template_utils.h"
 
 namespace regexp {
 
+namespace {
+
+/**
+  The compiled patterns of open_regexp(), most recently used first. The
+  URegularExpression objects in here are only ever cloned, never matched.
+*/
+class Pattern_cache {
+ public:
+  ~Pattern_cache() { Clear(); }
+
+  /// A clone of the cached pattern, nullptr if it is not cached.
+  URegularExpression *Clone(const std::u16string &pattern, uint flags,
+                            UErrorCode *error_code) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto it = m_index.find(Key(pattern, flags));
+    if (it == m_index.end()) return nullptr;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return uregex_clone(it->second->second, error_code);
+  }
+
+  /// Keeps a clone of re, compiled from pattern and flags.
+  void Insert(const std::u16string &pattern, uint flags,
+              const URegularExpression *re, size_t capacity) {
+    UErrorCode error_code = U_ZERO_ERROR;
+    URegularExpression *clone = uregex_clone(re, &error_code);
+    if (U_FAILURE(error_code)) {
+      uregex_close(clone);
+      return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    Key key(pattern, flags);
+    if (m_index.count(key) != 0) {
+      // Another session compiled it meanwhile.
+      uregex_close(clone);
+      return;
+    }
+    m_lru.emplace_front(key, clone);
+    m_index.emplace(std::move(key), m_lru.begin());
+    while (m_lru.size() > capacity) {
+      m_index.erase(m_lru.back().first);
+      uregex_close(m_lru.back().second);
+      m_lru.pop_back();
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (auto &entry : m_lru) uregex_close(entry.second);
+    m_lru.clear();
+    m_index.clear();
+  }
+
+ private:
+  using Key = std::pair<std::u16string, uint>;
+  using Entry = std::pair<Key, URegularExpression *>;
+
+  std::mutex m_mutex;
+  std::list<Entry> m_lru;
+  std::map<Key, std::list<Entry>::iterator> m_index;
+};
+
+Pattern_cache pattern_cache;
+
+}  // namespace
+
+URegularExpression *open_regexp(const std::u16string &pattern, uint flags,
+                                UParseError *parse_error,
+                                UErrorCode *error_code) {
+  const size_t capacity = opt_regexp_cache_size;
+  if (capacity > 0 && *error_code == U_ZERO_ERROR) {
+    URegularExpression *re = pattern_cache.Clone(pattern, flags, error_code);
+    if (re != nullptr) return re;
+  }
+
+  URegularExpression *re =
+      uregex_open(pointer_cast<const UChar *>(pattern.data()),
+                  static_cast<int32_t>(pattern.size()), flags, parse_error,
+                  error_code);
+
+  // Patterns that gave a warning are compiled every time to give it again.
+  if (capacity > 0 && *error_code == U_ZERO_ERROR)
+    pattern_cache.Insert(pattern, flags, re, capacity);
+  return re;
+}
+
+void free_regexp_cache() { pattern_cache.Clear(); }
+
 UBool QueryNotKilled(const void *thd, int32_t) {
   return !static_cast<const THD *>(thd)->is_killed();
 }
@@ -55,6 +55,28 @@ static constexpr CHARSET_INFO *regexp_lib_charset =
 
 const char *icu_version_string();
 
+/**
+  Opens a regular expression for pattern and flags, the way uregex_open()
+  does. A pattern that was compiled before is cloned from a cache shared by
+  all sessions instead of being compiled again; the clone shares the
+  compiled pattern but has its own match state, so it can be used
+  concurrently with other clones. The cache keeps the regexp_cache_size most
+  recently used patterns that compiled without errors or warnings.
+
+  @param pattern The pattern string in ICU's character set.
+  @param flags ICU flags.
+  @param[out] parse_error Set on a syntax error in the pattern.
+  @param[in,out] error_code ICU status.
+
+  @return The regular expression, to be closed with uregex_close().
+*/
+URegularExpression *open_regexp(const std::u16string &pattern, uint flags,
+                                UParseError *parse_error,
+                                UErrorCode *error_code);
+
+/// Closes the patterns in the cache used by open_regexp().
+void free_regexp_cache();
+
 /**
   Implements a match callback function for icu that aborts execution if the
   query was killed.
@@ -98,10 +120,7 @@ class Regexp_engine {
   Regexp_engine(const std::u16string &pattern, uint flags, int stack_limit,
                 int time_limit) {
     UParseError error;
-    auto upattern = pattern.data();
-    int length = pattern.size();
-    m_re = uregex_open(pointer_cast<const UChar *>(upattern), length, flags,
-                       &error, &m_error_code);
+    m_re = open_regexp(pattern, flags, &error, &m_error_code);
     uregex_setStackLimit(m_re, stack_limit, &m_error_code);
     uregex_setTimeLimit(m_re, time_limit, &m_error_code);
     uregex_setMatchCallback(m_re, QueryNotKilled, current_thd, &m_error_code);
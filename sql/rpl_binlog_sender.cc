@@ -951,6 +951,15 @@ int Binlog_sender::check_start_file() {
     return 1;
   }
 
+  /*
+    Seek past the transactions at the start of the file the slave has, as
+    far as the index of binlog_gtid_index_interval tells, rather than
+    reading them only to skip them.
+  */
+  if (m_using_gtid_protocol && m_start_pos == BIN_LOG_HEADER_SIZE)
+    m_start_pos = mysql_bin_log.find_first_pos_not_in_gtid_set(
+        m_linfo.log_file_name, m_exclude_gtid);
+
   Binlog_read_error binlog_read_error;
   Binlog_ifile binlog_ifile(&binlog_read_error);
   if (binlog_ifile.open(m_linfo.log_file_name)) {
@@ -1201,6 +1210,14 @@ inline int Binlog_sender::read_event(File_reader *reader, uchar **event_ptr,
     assert(!debug_sync_set_action(m_thd, STRING_WITH_LEN(act)));
   };);
 
+  if (!read_cached_event(reader, event_ptr, event_len)) {
+    set_last_pos(reader->position());
+#ifndef NDEBUG
+    if (check_event_count()) return 1;
+#endif
+    return 0;
+  }
+
   if (reader->read_event_data(event_ptr, event_len)) {
     if (reader->get_error_type() == Binlog_read_error::READ_EOF) {
       *event_ptr = nullptr;
@@ -1230,6 +1247,30 @@ inline int Binlog_sender::read_event(File_reader *reader, uchar **event_ptr,
   return 0;
 }
 
+bool Binlog_sender::read_cached_event(File_reader *reader, uchar **event_ptr,
+                                      uint32 *event_len) {
+  Binlog_dump_cache *cache = mysql_bin_log.get_dump_cache();
+  my_off_t pos = reader->position();
+  uint32 length = cache->event_length(m_linfo.log_file_name, pos);
+  if (length == 0) return true;
+
+  size_t packet_length = m_packet.length();
+  uchar *event = reader->allocator()->allocate(length);
+  if (event == nullptr) return true;
+  /*
+    The event was copied into the window as the server wrote it, so its
+    checksum is not verified again. It may have left the window since.
+  */
+  if (cache->copy(m_linfo.log_file_name, pos, length, event) ||
+      reader->seek(pos + length)) {
+    m_packet.length(packet_length);
+    return true;
+  }
+  *event_ptr = event;
+  *event_len = length;
+  return false;
+}
+
 int Binlog_sender::send_heartbeat_event(my_off_t log_pos) {
   DBUG_TRACE;
   const char *filename = m_linfo.log_file_name;
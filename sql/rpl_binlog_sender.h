@@ -308,6 +308,19 @@ class Binlog_sender {
      @retval 1 Fail
   */
   int read_event(File_reader *reader, uchar **event_ptr, uint32 *event_len);
+  /**
+     Reads the event at the position of reader from the dump cache of the
+     binlog, and moves reader past it.
+
+     @param[in] reader        File_reader of the binlog file.
+     @param[out] event_ptr    The buffer used to store the event.
+     @param[out] event_len    Length of the event.
+
+     @retval false Succeed
+     @retval true  The event is not cached; reader did not move
+  */
+  bool read_cached_event(File_reader *reader, uchar **event_ptr,
+                         uint32 *event_len);
   /**
     Check if it is allowed to send this event type.
 
@@ -2307,6 +2307,15 @@ class Gtid_set {
   mutable size_t cached_string_length;
   /// The String_format that was used when cached_string_length was computed.
   mutable const String_format *cached_string_format;
+  /**
+    If cached_string holds the text of the set in cached_string_format.
+    Only large sets are cached, see to_string(char *, ...).
+  */
+  mutable bool has_cached_string;
+  /// The text of the set, allocated with my_malloc.
+  mutable char *cached_string;
+  /// Size of the cached_string buffer.
+  mutable size_t cached_string_alloc;
 #ifndef NDEBUG
   /**
     The number of chunks.  Used only to check some invariants when
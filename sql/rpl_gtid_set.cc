@@ -69,6 +69,8 @@ using std::max;
 using std::min;
 
 #define MAX_NEW_CHUNK_ALLOCATE_TRIES 10
+/// Sets whose text is at least this long keep it cached, see to_string().
+#define CACHED_STRING_MIN_LENGTH 1024
 
 PSI_mutex_key Gtid_set::key_gtid_executed_free_intervals_mutex;
 
@@ -103,6 +105,9 @@ void Gtid_set::init() {
   has_cached_string_length = false;
   cached_string_length = 0;
   cached_string_format = nullptr;
+  has_cached_string = false;
+  cached_string = nullptr;
+  cached_string_alloc = 0;
   chunks = nullptr;
   free_intervals = nullptr;
   if (sid_lock)
@@ -115,6 +120,7 @@ void Gtid_set::init() {
 
 Gtid_set::~Gtid_set() {
   DBUG_TRACE;
+  my_free(cached_string);
   Interval_chunk *chunk = chunks;
   while (chunk != nullptr) {
     Interval_chunk *next_chunk = chunk->next;
@@ -263,6 +269,7 @@ void Gtid_set::clear() {
   DBUG_TRACE;
   has_cached_string_length = false;
   cached_string_length = 0;
+  has_cached_string = false;
   rpl_sidno max_sidno = get_max_sidno();
   if (max_sidno == 0) return;
   Interval_iterator free_ivit(this);
@@ -307,6 +314,7 @@ void Gtid_set::add_gno_interval(Interval_iterator *ivitp, rpl_gno start,
   Interval_iterator ivit = *ivitp;
   has_cached_string_length = false;
   cached_string_length = 0;
+  has_cached_string = false;
 
   while ((iv = ivit.get()) != nullptr) {
     if (iv->end >= start) {
@@ -354,6 +362,7 @@ void Gtid_set::remove_gno_interval(Interval_iterator *ivitp, rpl_gno start,
   Interval *iv;
   has_cached_string_length = false;
   cached_string_length = -1;
+  has_cached_string = false;
 
   // Skip intervals of 'this' that are completely before the removed interval.
   while (true) {
@@ -773,6 +782,17 @@ size_t Gtid_set::to_string(char *buf, bool need_lock,
     if (sid_lock != nullptr && need_lock) sid_lock->unlock();
     return sf->empty_set_string_length;
   }
+  /*
+    The text of a large set, like gtid_executed after many failovers, is
+    cached until the set changes, as it is requested again and again by
+    replica connections, SHOW statements and the like.
+  */
+  if (has_cached_string && cached_string_format == sf) {
+    assert(has_cached_string_length);
+    memcpy(buf, cached_string, cached_string_length + 1);
+    if (sid_lock != nullptr && need_lock) sid_lock->unlock();
+    return cached_string_length;
+  }
   rpl_sidno map_max_sidno = sid_map->get_max_sidno();
   assert(get_max_sidno() <= map_max_sidno);
   memcpy(buf, sf->begin, sf->begin_length);
@@ -818,6 +838,24 @@ size_t Gtid_set::to_string(char *buf, bool need_lock,
                       buf, strlen(buf), (ulong)(s - buf),
                       static_cast<unsigned long long>(get_string_length(sf))));
   assert((ulong)(s - buf) == get_string_length(sf));
+  const size_t len = s - buf;
+  if (len >= CACHED_STRING_MIN_LENGTH) {
+    if (cached_string_alloc < len + 1) {
+      my_free(cached_string);
+      cached_string_alloc = len + 1;
+      cached_string = static_cast<char *>(
+          my_malloc(key_memory_Gtid_set_to_string, cached_string_alloc,
+                    MYF(0)));
+      if (cached_string == nullptr) cached_string_alloc = 0;
+    }
+    if (cached_string != nullptr) {
+      memcpy(cached_string, buf, len + 1);
+      has_cached_string_length = true;
+      cached_string_length = len;
+      cached_string_format = sf;
+      has_cached_string = true;
+    }
+  }
   if (sid_lock != nullptr && need_lock) sid_lock->unlock();
   return (int)(s - buf);
 }
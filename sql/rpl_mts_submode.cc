@@ -58,6 +58,12 @@
 #include "sql/system_variables.h"
 #include "sql/table.h"
 
+/*
+  Attempts the logical clock coordinator makes to find a free worker,
+  yielding in between, before it sleeps until one is free.
+*/
+static const uint FREE_WORKER_SPINS = 100;
+
 /**
  Does necessary arrangement before scheduling next event.
  @return 1  if  error
@@ -942,22 +948,44 @@ Slave_worker *Mts_submode_logical_clock::get_least_occupied_worker(
       // Update thd info as waiting for workers to finish.
       thd->enter_stage(&stage_slave_waiting_for_workers_to_process_queue,
                        old_stage, __func__, __FILE__, __LINE__);
-      while (!worker && !thd->killed) {
+      for (uint spins = 0; !worker && !thd->killed; spins++) {
         /*
-          Busy wait with yielding thread control before to next attempt
-          to find a free worker. As of current, a worker
-          can't have more than one assigned group of events in its
-          queue.
+          As of current, a worker can't have more than one assigned
+          group of events in its queue. Small groups are done sooner
+          than a sleep would last, so the first attempts to find a free
+          worker yield thread control. After that the coordinator sleeps
+          until remove_item_from_jobs() empties a queue, so that
+          it does not take the CPU from the workers it waits for.
 
           todo: replace this At-Most-One assignment policy with
                 First Available Worker as
                 this method clearly can't be considered as optimal.
         */
+        if (spins < FREE_WORKER_SPINS) {
 #if !defined(_WIN32)
-        sched_yield();
+          sched_yield();
 #else
-        my_sleep(rli->mts_coordinator_basic_nap);
+          my_sleep(rli->mts_coordinator_basic_nap);
 #endif
+        } else {
+          mysql_mutex_lock(&rli->pending_jobs_lock);
+          rli->mts_wq_no_free_worker = true;
+          if (get_free_worker(rli) == nullptr) {
+            struct timespec abstime;
+            set_timespec(&abstime, 1);
+            thd->ENTER_COND(&rli->pending_jobs_cond, &rli->pending_jobs_lock,
+                            nullptr, nullptr);
+            if (!thd->killed)
+              mysql_cond_timedwait(&rli->pending_jobs_cond,
+                                   &rli->pending_jobs_lock, &abstime);
+            rli->mts_wq_no_free_worker = false;
+            mysql_mutex_unlock(&rli->pending_jobs_lock);
+            thd->EXIT_COND(nullptr);
+          } else {
+            rli->mts_wq_no_free_worker = false;
+            mysql_mutex_unlock(&rli->pending_jobs_lock);
+          }
+        }
         worker = get_free_worker(rli);
       }
       THD_STAGE_INFO(thd, *old_stage);
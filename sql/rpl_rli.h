@@ -1143,6 +1143,7 @@ class Relay_log_info : public Rpl_info {
   ulonglong mts_pending_jobs_size;      // actual mem usage by WQ:s
   ulonglong mts_pending_jobs_size_max;  // max of WQ:s size forcing C to wait
   bool mts_wq_oversize;  // C raises flag to wait some memory's released
+  bool mts_wq_no_free_worker;  // C raises flag to wait a Worker's queue empty
   Slave_worker
       *last_assigned_worker;  // is set to a Worker at assigning a group
   /*
@@ -2274,6 +2274,7 @@ static void remove_item_from_jobs(slave_job_item *job_item,
 
   mysql_mutex_lock(&worker->jobs_lock);
   de_queue(&worker->jobs, job_item);
+  const bool emptied = worker->jobs.len == 0;
   /* possible overfill */
   if (worker->jobs.len == worker->jobs.size - 1 &&
       worker->jobs.overfill == true) {
@@ -2347,6 +2348,12 @@ static void remove_item_from_jobs(slave_job_item *job_item,
     mysql_cond_signal(&rli->pending_jobs_cond);
   }
 
+  /* coordinator can be waiting for a free Worker */
+  if (emptied && rli->mts_wq_no_free_worker) {
+    rli->mts_wq_no_free_worker = false;
+    mysql_cond_signal(&rli->pending_jobs_cond);
+  }
+
   mysql_mutex_unlock(&rli->pending_jobs_lock);
 
   worker->events_done++;
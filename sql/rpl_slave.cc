@@ -6620,6 +6620,7 @@ static int slave_start_workers(Relay_log_info *rli, ulong n, bool *mts_inited) {
   rli->mts_wq_excess_cnt = 0;
   rli->mts_wq_overrun_cnt = 0;
   rli->mts_wq_oversize = false;
+  rli->mts_wq_no_free_worker = false;
   rli->mts_coordinator_basic_nap = mts_coordinator_basic_nap;
   rli->mts_worker_underrun_level = mts_worker_underrun_level;
   rli->curr_group_seen_begin = rli->curr_group_seen_gtid = false;
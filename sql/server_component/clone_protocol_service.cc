@@ -29,6 +29,7 @@
 #include "my_byteorder.h"
 #include "mysql.h"
 #include "sql/mysqld.h"
+#include "sql/mysqld_thd_manager.h"
 #include "sql/protocol_classic.h"
 #include "sql/set_var.h"
 #include "sql/sql_class.h"
@@ -350,7 +351,16 @@ DEFINE_METHOD(MYSQL *, mysql_clone_connect,
 
   /* Enable compression. */
   if (ssl_ctx->m_enable_compression) {
-    mysql_options(mysql, MYSQL_OPT_COMPRESS, nullptr);
+    if (ssl_ctx->m_compression_algorithm == nullptr) {
+      mysql_options(mysql, MYSQL_OPT_COMPRESS, nullptr);
+    } else {
+      /* Each clone task has its own connection and compresses its data
+      independently. */
+      mysql_options(mysql, MYSQL_OPT_COMPRESSION_ALGORITHMS,
+                    ssl_ctx->m_compression_algorithm);
+      mysql_options(mysql, MYSQL_OPT_ZSTD_COMPRESSION_LEVEL,
+                    &ssl_ctx->m_zstd_compression_level);
+    }
     mysql_extension_set_server_extn(mysql, ssl_ctx->m_server_extn);
   }
 
@@ -726,3 +736,11 @@ DEFINE_METHOD(int, mysql_clone_send_error,
   }
   return 0;
 }
+
+DEFINE_METHOD(void, mysql_clone_get_server_load,
+              (THD *, uint32_t *threads_running)) {
+  auto thd_manager = Global_THD_manager::get_instance();
+  auto running = thd_manager->get_num_thread_running();
+
+  *threads_running = (running < 0) ? 0 : static_cast<uint32_t>(running);
+}
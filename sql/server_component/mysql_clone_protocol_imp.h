@@ -192,4 +192,12 @@ DEFINE_METHOD(int, mysql_clone_send_response,
 DEFINE_METHOD(int, mysql_clone_send_error,
               (THD * thd, uchar err_cmd, bool is_fatal));
 
+/**
+  Get current load on server
+  @param[in,out] thd              server session THD
+  @param[out]    threads_running  number of threads executing statements
+*/
+DEFINE_METHOD(void, mysql_clone_get_server_load,
+              (THD * thd, uint32_t *threads_running));
+
 #endif /* MYSQL_CLONE_PROTOCOL_INCLUDED */
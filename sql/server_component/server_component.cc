@@ -71,6 +71,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
 #include "persistent_dynamic_loader_imp.h"
 #include "security_context_imp.h"
 #include "sql/auth/dynamic_privileges_impl.h"
+#include "sql/inception/inception_component.h"
 #include "sql/log.h"
 #include "sql/mysqld.h"  // srv_registry
 #include "sql/server_component/mysql_admin_session_imp.h"
@@ -265,8 +266,8 @@ mysql_clone_start_statement, mysql_clone_finish_statement,
     mysql_clone_get_configs, mysql_clone_validate_configs, mysql_clone_connect,
     mysql_clone_send_command, mysql_clone_get_response, mysql_clone_kill,
     mysql_clone_disconnect, mysql_clone_get_error, mysql_clone_get_command,
-    mysql_clone_send_response,
-    mysql_clone_send_error END_SERVICE_IMPLEMENTATION();
+    mysql_clone_send_response, mysql_clone_send_error,
+    mysql_clone_get_server_load END_SERVICE_IMPLEMENTATION();
 
 BEGIN_SERVICE_IMPLEMENTATION(mysql_server, mysql_thd_security_context)
 mysql_security_context_imp::get,
@@ -308,6 +309,20 @@ BEGIN_SERVICE_IMPLEMENTATION(mysql_server, mysql_current_thread_reader)
 mysql_component_mysql_current_thread_reader_imp::get
 END_SERVICE_IMPLEMENTATION();
 
+BEGIN_SERVICE_IMPLEMENTATION(mysql_server, inception_audit_rule)
+mysql_inception_audit_rule_imp::register_rule,
+    mysql_inception_audit_rule_imp::unregister_rule END_SERVICE_IMPLEMENTATION();
+
+BEGIN_SERVICE_IMPLEMENTATION(mysql_server, inception_rule_statement)
+mysql_inception_rule_statement_imp::get_command,
+    mysql_inception_rule_statement_imp::get_sql,
+    mysql_inception_rule_statement_imp::get_table,
+    mysql_inception_rule_statement_imp::get_lex,
+    mysql_inception_rule_statement_imp::table_exists,
+    mysql_inception_rule_statement_imp::get_table_rows,
+    mysql_inception_rule_statement_imp::get_column_type,
+    mysql_inception_rule_statement_imp::report END_SERVICE_IMPLEMENTATION();
+
 BEGIN_SERVICE_IMPLEMENTATION(mysql_server, mysql_keyring_iterator)
 mysql_keyring_iterator_imp::init, mysql_keyring_iterator_imp::deinit,
     mysql_keyring_iterator_imp::get END_SERVICE_IMPLEMENTATION();
@@ -420,6 +435,8 @@ PROVIDES_SERVICE(mysql_server_path_filter, dynamic_loader_scheme_file),
     PROVIDES_SERVICE(mysql_server, mysql_page_track),
     PROVIDES_SERVICE(mysql_server, mysql_runtime_error),
     PROVIDES_SERVICE(mysql_server, mysql_current_thread_reader),
+    PROVIDES_SERVICE(mysql_server, inception_audit_rule),
+    PROVIDES_SERVICE(mysql_server, inception_rule_statement),
     PROVIDES_SERVICE(mysql_server, mysql_keyring_iterator),
     PROVIDES_SERVICE(mysql_server, mysql_admin_session),
     PROVIDES_SERVICE(mysql_server, mysql_connection_attributes_iterator),
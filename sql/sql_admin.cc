@@ -388,6 +388,12 @@ bool Sql_cmd_analyze_table::send_histogram_results(
         message.append(pair.first);
         message.append("'.");
         break;
+      case histograms::Message::HISTOGRAM_UP_TO_DATE:
+        message_type.assign("status");
+        message.assign("Histogram statistics for column '");
+        message.append(pair.first);
+        message.append("' are newer than the last change of the table.");
+        break;
       // Errror messages
       case histograms::Message::FIELD_NOT_FOUND:
         message_type.assign("Error");
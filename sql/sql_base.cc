@@ -1307,6 +1307,7 @@ static void mark_temp_tables_as_free_for_reuse(THD *thd) {
       mark_tmp_table_for_reuse(table);
       table->cleanup_value_generator_items();
       table->cleanup_partial_update();
+      table->cleanup_json_projections();
     }
   }
 }
@@ -1569,6 +1570,7 @@ void close_thread_tables(THD *thd) {
       if (table->db_stat) table->file->ha_extra(HA_EXTRA_DETACH_CHILDREN);
       table->cleanup_value_generator_items();
       table->cleanup_partial_update();
+      table->cleanup_json_projections();
     }
   }
 
@@ -460,6 +460,7 @@ THD::THD(bool enable_plugins)
   init_sql_alloc(key_memory_thd_main_mem_root, &main_mem_root,
                  global_system_variables.query_alloc_block_size,
                  global_system_variables.query_prealloc_size);
+  main_mem_root.set_use_block_cache(true);
   stmt_arena = this;
   thread_stack = nullptr;
   m_catalog.str = "std";
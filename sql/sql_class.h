@@ -133,6 +133,9 @@ struct LEX_USER;
 struct TABLE;
 struct TABLE_LIST;
 struct timeval;
+namespace inception {
+struct InceptionContext;
+}
 struct User_level_lock;
 struct YYLTYPE;
 
@@ -4032,6 +4035,18 @@ class THD : public MDL_context_owner,
 
   void mark_transaction_to_rollback(bool all);
 
+  /**
+    Fold the memory main_mem_root held at the end of a statement into
+    main_mem_root_estimate.
+
+    @return the updated estimate
+  */
+  size_t update_main_mem_root_estimate(size_t stmt_mem) {
+    main_mem_root_estimate =
+        main_mem_root_estimate - main_mem_root_estimate / 8 + stmt_mem / 8;
+    return main_mem_root_estimate;
+  }
+
  private:
   /** The current internal error handler for this thread, or NULL. */
   Internal_error_handler *m_internal_handler;
@@ -4045,6 +4060,11 @@ class THD : public MDL_context_owner,
     tree itself is reused between executions and thus is stored elsewhere.
   */
   MEM_ROOT main_mem_root;
+  /**
+    Moving average of the memory main_mem_root held at the end of recent
+    statements; used to size its first block after it was cleared.
+  */
+  size_t main_mem_root_estimate{0};
   Diagnostics_area main_da;
   Diagnostics_area m_parser_da; /**< cf. get_parser_da() */
   Diagnostics_area m_query_rewrite_plugin_da;
@@ -4236,6 +4256,14 @@ class THD : public MDL_context_owner,
   bool is_plugin_fake_ddl() const { return m_is_plugin_fake_ddl; }
   void mark_plugin_fake_ddl(bool flag) { m_is_plugin_fake_ddl = flag; }
 
+  /**
+    Inception session state of this connection, or nullptr if the connection
+    never started an inception session. The object is owned by the registry
+    in sql/inception/inception_context.cc; the pointer is only read by the
+    thread owning this THD, so no lock is needed on the statement path.
+  */
+  inception::InceptionContext *inception_ctx{nullptr};
+
  private:
   /**
     Variable to mark if the object is part of a Srv_session object, which
@@ -357,7 +357,8 @@ static const ulong EVENT_DEF_CACHE_MIN = 256;
 #define OPTIMIZER_SWITCH_PREFER_ORDERING_INDEX (1ULL << 23)
 #define OPTIMIZER_SWITCH_HYPERGRAPH_OPTIMIZER (1ULL << 24)
 #define OPTIMIZER_SWITCH_DERIVED_CONDITION_PUSHDOWN (1ULL << 25)
-#define OPTIMIZER_SWITCH_LAST (1ULL << 26)
+#define OPTIMIZER_SWITCH_JSON_PROJECTION_PUSHDOWN (1ULL << 26)
+#define OPTIMIZER_SWITCH_LAST (1ULL << 27)
 
 // Including the switch in this set, makes its default 'on'
 #define OPTIMIZER_SWITCH_DEFAULT                                          \
@@ -374,7 +375,8 @@ static const ulong EVENT_DEF_CACHE_MIN = 256;
    OPTIMIZER_SWITCH_COND_FANOUT_FILTER | OPTIMIZER_SWITCH_DERIVED_MERGE | \
    OPTIMIZER_SKIP_SCAN | OPTIMIZER_SWITCH_HASH_JOIN |                     \
    OPTIMIZER_SWITCH_PREFER_ORDERING_INDEX |                               \
-   OPTIMIZER_SWITCH_DERIVED_CONDITION_PUSHDOWN)
+   OPTIMIZER_SWITCH_DERIVED_CONDITION_PUSHDOWN |                          \
+   OPTIMIZER_SWITCH_JSON_PROJECTION_PUSHDOWN)
 
 enum SHOW_COMP_OPTION { SHOW_OPTION_YES, SHOW_OPTION_NO, SHOW_OPTION_DISABLED };
 
@@ -6594,14 +6594,43 @@ bool QEP_TAB::pfs_batch_update(const JOIN *join) const {
   @} (end of group Query_Executor)
 */
 
+/**
+  Computes COUNT(), SUM() or AVG() of a column with
+  handler::column_aggregate(), see optimize_aggregated_query().
+
+  @retval true on error
+*/
+static bool make_column_aggregate_const(Item_sum *item_sum) {
+  const Field *field =
+      down_cast<Item_field *>(item_sum->get_arg(0)->real_item())->field;
+  handler *file = field->table->file;
+  const bool need_sum = item_sum->sum_func() != Item_sum::COUNT_FUNC;
+  ha_rows not_null = 0;
+  my_decimal sum;
+  const int error =
+      file->ha_column_aggregate(field, &not_null, need_sum ? &sum : nullptr);
+  if (error != 0) {
+    file->print_error(error, MYF(0));
+    return true;
+  }
+  if (need_sum)
+    down_cast<Item_sum_sum *>(item_sum)->make_const(&sum, not_null);
+  else
+    down_cast<Item_sum_count *>(item_sum)->make_const(
+        static_cast<longlong>(not_null));
+  return false;
+}
+
 int UnqualifiedCountIterator::Read() {
   if (!m_has_row) {
     return -1;
   }
 
   for (Item *item : *m_join->fields) {
-    if (item->type() == Item::SUM_FUNC_ITEM &&
-        down_cast<Item_sum *>(item)->sum_func() == Item_sum::COUNT_FUNC) {
+    if (item->type() != Item::SUM_FUNC_ITEM) continue;
+    Item_sum *item_sum = down_cast<Item_sum *>(item);
+    if (item_sum->sum_func() == Item_sum::COUNT_FUNC &&
+        !item_sum->get_arg(0)->is_nullable()) {
       int error;
       ulonglong count = get_exact_record_count(m_join->qep_tab,
                                                m_join->primary_tables, &error);
@@ -6609,6 +6638,11 @@ int UnqualifiedCountIterator::Read() {
 
       down_cast<Item_sum_count *>(item)->make_const(
           static_cast<longlong>(count));
+    } else if (item_sum->sum_func() == Item_sum::COUNT_FUNC ||
+               item_sum->sum_func() == Item_sum::SUM_FUNC ||
+               item_sum->sum_func() == Item_sum::AVG_FUNC) {
+      // Left to the storage engine by optimize_aggregated_query()
+      if (make_column_aggregate_const(item_sum)) return 1;
     }
   }
 
@@ -29,6 +29,9 @@
 #include <climits>
 #include <cstdlib>
 #include <initializer_list>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "field_types.h"
 #include "m_ctype.h"
@@ -1003,6 +1006,39 @@ static LEX_STRING get_quoted_token(Lex_input_stream *lip, uint skip,
   return tmp;
 }
 
+/**
+  Length of the run of bytes from str, short of end, that get_text() would
+  accept one at a time: none is sep, a backslash or a byte with its high
+  bit set. Such bytes are single-byte characters in every charset a client
+  can use, so the run needs no multi-byte check either; it leaves
+  text_string_is_7bit() as it was.
+
+  Long literals of an INSERT ... VALUES dump are mostly such runs; with
+  SSE2 they are scanned 16 bytes at a time.
+*/
+static size_t plain_text_run(const char *str, const char *end, char sep) {
+  const char *p = str;
+#if defined(__SSE2__)
+  const __m128i quote = _mm_set1_epi8(sep);
+  const __m128i backslash = _mm_set1_epi8('\\');
+  for (; end - p >= 16; p += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    /* The high bit of v itself marks the bytes >= 0x80 */
+    const __m128i hit = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+        v);
+    const int mask = _mm_movemask_epi8(hit);
+    if (mask != 0)
+      return static_cast<size_t>(p - str) +
+             static_cast<size_t>(__builtin_ctz(mask));
+  }
+#endif
+  while (p < end && *p != sep && *p != '\\' &&
+         !(static_cast<uchar>(*p) & 0x80))
+    p++;
+  return static_cast<size_t>(p - str);
+}
+
 /*
   Return an unescaped text literal without quotes
   Fix sometimes to do only one scan of the string
@@ -1016,6 +1052,12 @@ static char *get_text(Lex_input_stream *lip, int pre_skip, int post_skip) {
   lip->tok_bitmap = 0;
   sep = lip->yyGetLast();  // String should end with this
   while (!lip->eof()) {
+    const size_t run =
+        plain_text_run(lip->get_ptr(), lip->get_end_of_query(), sep);
+    if (run > 0) {
+      lip->skip_binary(static_cast<int>(run));
+      if (lip->eof()) break;
+    }
     c = lip->yyGet();
     lip->tok_bitmap |= c;
     {
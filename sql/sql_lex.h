@@ -105,6 +105,7 @@ class Item_rollup_group_item;
 class Item_rollup_sum_switcher;
 class Item_sum;
 class JOIN;
+class Join_order_cache;
 class Opt_hints_global;
 class Opt_hints_qb;
 class PT_subquery;
@@ -2033,6 +2034,13 @@ class Query_block {
   */
   uint with_wild{0};
 
+  /**
+    Join orders chosen for earlier executions of this query block in a
+    prepared statement, allocated on the statement mem_root.
+    @see Join_order_cache
+  */
+  Join_order_cache *join_order_cache{nullptr};
+
   /// Number of leaf tables in this query block.
   uint leaf_table_count{0};
   /// Number of derived tables and views in this query block.
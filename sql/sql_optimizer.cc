@@ -70,11 +70,14 @@
 #include "sql/item.h"
 #include "sql/item_cmpfunc.h"
 #include "sql/item_func.h"
+#include "sql/item_json_func.h"  // Item_func_json_extract
 #include "sql/item_row.h"
 #include "sql/item_subselect.h"
 #include "sql/item_sum.h"  // Item_sum
 #include "sql/join_optimizer/access_path.h"
 #include "sql/join_optimizer/join_optimizer.h"
+#include "sql/json_binary.h"  // json_binary::Projection
+#include "sql/json_path.h"    // Json_path
 #include "sql/key.h"
 #include "sql/key_spec.h"
 #include "sql/lock.h"    // mysql_unlock_some_tables
@@ -218,6 +221,156 @@ bool JOIN::alloc_indirection_slices() {
   return false;
 }
 
+/**
+  Let the storage engine read only the needed members of JSON columns that
+  a simple SELECT uses nowhere else than as the document of JSON_EXTRACT()
+  (or -> and ->>) with constant member paths. Large documents are stored
+  out of line, and reading all of a document to extract one member from it
+  dominates the cost of such queries.
+
+  @param join  the query block being optimized
+
+  @retval false  on success
+  @retval true   on out-of-memory
+*/
+static bool setup_json_projections(JOIN *join) {
+  THD *const thd = join->thd;
+  Query_block *const query_block = join->query_block;
+  Query_expression *const unit = thd->lex->unit;
+
+  if (!thd->optimizer_switch_flag(OPTIMIZER_SWITCH_JSON_PROJECTION_PUSHDOWN) ||
+      thd->lex->sql_command != SQLCOM_SELECT || thd->in_sub_stmt ||
+      unit->is_union() || unit->first_query_block() != query_block ||
+      query_block->first_inner_query_expression() != nullptr ||
+      join->m_windows.elements > 0)
+    return false;
+
+  // JSON columns of base tables without virtual generated columns, which
+  // may be computed from the whole document. Table functions such as
+  // JSON_TABLE() may read the columns too, so they disable the projection.
+  std::vector<Field *> candidates;
+  for (TABLE_LIST *tl = query_block->leaf_tables; tl; tl = tl->next_leaf) {
+    if (tl->is_table_function()) return false;
+    TABLE *const table = tl->table;
+    if (tl->is_view_or_derived() || table == nullptr ||
+        table->s->tmp_table != NO_TMP_TABLE || table->vfield != nullptr)
+      continue;
+    for (uint i = 0; i < table->s->fields; i++) {
+      Field *const field = table->field[i];
+      if (field->type() == MYSQL_TYPE_JSON &&
+          bitmap_is_set(table->read_set, i) &&
+          table->json_projection(i) == nullptr)
+        candidates.push_back(field);
+    }
+  }
+  if (candidates.empty()) return false;
+
+  // Find the uses of the columns. A column which is referenced other than
+  // as the document of a JSON_EXTRACT() with constant paths is rejected.
+  std::vector<Item_func_json_extract *> extracts;
+  std::vector<const Item_field *> covered;
+  std::vector<const Field *> rejected;
+  auto find_uses = [&](Item *item) {
+    if (item->type() == Item::FUNC_ITEM) {
+      auto extract = dynamic_cast<Item_func_json_extract *>(item);
+      if (extract == nullptr || extract->arg_count < 2 ||
+          extract->arguments()[0]->real_item()->type() != Item::FIELD_ITEM)
+        return false;
+      for (uint i = 1; i < extract->arg_count; i++) {
+        Item *path = extract->arguments()[i];
+        if (!path->const_for_execution() || path->is_expensive()) return false;
+      }
+      extracts.push_back(extract);
+      covered.push_back(
+          down_cast<Item_field *>(extract->arguments()[0]->real_item()));
+    } else if (item->type() == Item::FIELD_ITEM) {
+      // Each use as the document of a JSON_EXTRACT() covers one reference.
+      const Item_field *item_field = down_cast<Item_field *>(item);
+      const auto it = std::find(covered.begin(), covered.end(), item_field);
+      if (it == covered.end())
+        rejected.push_back(item_field->field);
+      else
+        covered.erase(it);
+    }
+    return false;
+  };
+
+  const auto walk_uses = [&](Item *root) {
+    if (root != nullptr)
+      WalkItem(root, enum_walk::PREFIX,
+               [&](Item *item) { return find_uses(item); });
+  };
+
+  for (Item *item : *join->fields) walk_uses(item);
+  walk_uses(join->where_cond);
+  walk_uses(join->having_cond);
+  for (ORDER *ord = join->order.order; ord != nullptr; ord = ord->next)
+    walk_uses(*ord->item);
+  for (ORDER *ord = join->group_list.order; ord != nullptr; ord = ord->next)
+    walk_uses(*ord->item);
+  for (TABLE_LIST *tl = query_block->leaf_tables; tl; tl = tl->next_leaf) {
+    for (TABLE_LIST *nest = tl; nest != nullptr; nest = nest->embedding) {
+      walk_uses(nest->join_cond());
+      walk_uses(nest->join_cond_optim());
+    }
+  }
+
+  Opt_trace_context *const trace = &thd->opt_trace;
+  Opt_trace_object trace_wrapper(trace);
+  Opt_trace_array trace_columns(trace, "json_projection_pushdown");
+
+  for (Field *field : candidates) {
+    if (std::find(rejected.begin(), rejected.end(), field) != rejected.end())
+      continue;
+
+    auto projection = new (thd->mem_root) json_binary::Projection;
+    if (projection == nullptr) return true; /* purecov: inspected */
+
+    bool used = false;
+    bool projectable = true;
+    for (Item_func_json_extract *extract : extracts) {
+      if (down_cast<Item_field *>(extract->arguments()[0]->real_item())
+              ->field != field)
+        continue;
+      used = true;
+      for (uint i = 1; i < extract->arg_count && projectable; i++) {
+        StringBuffer<STRING_BUFFER_USUAL_SIZE> buffer;
+        const String *value = extract->arguments()[i]->val_str(&buffer);
+        if (thd->is_error()) {
+          destroy(projection);
+          return true;
+        }
+        // Paths that are NULL, invalid or not in utf8mb4 are left to
+        // JSON_EXTRACT() to handle.
+        Json_path path;
+        size_t bad_index;
+        projectable = value != nullptr &&
+                      my_charset_same(value->charset(),
+                                      &my_charset_utf8mb4_bin) &&
+                      !parse_path(value->length(), value->ptr(), &path,
+                                  &bad_index) &&
+                      !projection->add_path(path);
+      }
+    }
+
+    if (!used || !projectable) {
+      destroy(projection);
+      continue;
+    }
+
+    if (field->table->set_json_projection(field, projection)) {
+      destroy(projection);
+      return true; /* purecov: inspected */
+    }
+
+    Opt_trace_object trace_column(trace);
+    trace_column.add_utf8_table(field->table->pos_in_table_list)
+        .add_utf8("column", field->field_name);
+  }
+
+  return false;
+}
+
 /**
   Optimizes one query block into a query execution plan (QEP.)
 
@@ -335,6 +488,8 @@ bool JOIN::optimize() {
 
   has_lateral = false;
 
+  if (setup_json_projections(this)) return true;
+
   /* dump_TABLE_LIST_graph(query_block, query_block->leaf_tables); */
 
   row_limit = ((select_distinct || !order.empty() || !group_list.empty())
@@ -9844,6 +9999,105 @@ ORDER *JOIN::remove_const(ORDER *first_order, Item *cond, bool change,
   return first_order;
 }
 
+/**
+  Check if an item is a column of a data dictionary table which is accessed
+  through an INFORMATION_SCHEMA system view.
+*/
+
+static bool is_system_view_field(const Item *item) {
+  if (item->type() != Item::FIELD_ITEM) return false;
+  for (const TABLE_LIST *tr = down_cast<const Item_field *>(item)->table_ref;
+       tr != nullptr; tr = tr->referencing_view) {
+    if (tr->is_system_view) return true;
+  }
+  return false;
+}
+
+/**
+  Push row IN predicates on INFORMATION_SCHEMA system views down to the
+  underlying data dictionary tables.
+
+  A predicate like
+
+    (TABLE_SCHEMA, TABLE_NAME) IN (('db', 't1'), ('db', 't2'))
+
+  refers to columns of different dictionary tables (mysql.schemata and
+  mysql.tables) after the view is merged, so neither the range optimizer
+  nor ref access can use it, and the dictionary tables are scanned. For
+  every system view column of such a predicate a single column predicate
+  implied by it is added, here
+
+    sch.name IN ('db', 'db') AND tbl.name IN ('t1', 't2')
+
+  so that the dictionary tables are read by key. The original predicate is
+  kept and the condition tree of the query block is not modified.
+
+  @param thd           Thread handler
+  @param[in,out] cond  WHERE condition, replaced with the extended condition
+
+  @returns false if success, true if error
+*/
+
+static bool push_down_system_view_row_in(THD *thd, Item **cond) {
+  List<Item> pushed;
+
+  auto derive = [thd, &pushed](Item *item) {
+    if (item->type() != Item::FUNC_ITEM ||
+        down_cast<Item_func *>(item)->functype() != Item_func::IN_FUNC)
+      return false;
+    Item_func_in *const in = down_cast<Item_func_in *>(item);
+    Item *const left = in->arguments()[0];
+    if (in->negated || left->type() != Item::ROW_ITEM ||
+        my_count_bits(left->used_tables() & ~PSEUDO_TABLE_BITS) < 2)
+      return false;
+    for (uint i = 1; i < in->arg_count; i++) {
+      if (in->arguments()[i]->type() != Item::ROW_ITEM ||
+          !in->arguments()[i]->const_item())
+        return false;
+    }
+
+    for (uint col = 0; col < left->cols(); col++) {
+      Item *const field = left->element_index(col)->real_item();
+      if (!is_system_view_field(field)) continue;
+
+      mem_root_deque<Item *> args(thd->mem_root);
+      args.push_back(
+          new (thd->mem_root) Item_field(thd, down_cast<Item_field *>(field)));
+      for (uint i = 1; i < in->arg_count; i++)
+        args.push_back(in->arguments()[i]->element_index(col));
+
+      Item *col_in = new (thd->mem_root) Item_func_in(&args, false);
+      if (col_in == nullptr || args.front() == nullptr ||
+          col_in->fix_fields(thd, &col_in) || pushed.push_back(col_in))
+        return true;
+    }
+    return false;
+  };
+
+  if ((*cond)->type() == Item::COND_ITEM &&
+      down_cast<Item_cond *>(*cond)->functype() == Item_func::COND_AND_FUNC) {
+    for (Item &item : *down_cast<Item_cond *>(*cond)->argument_list()) {
+      if (derive(&item)) return true;
+    }
+  } else if (derive(*cond)) {
+    return true;
+  }
+
+  if (pushed.is_empty()) return false;
+
+  pushed.push_front(*cond);
+  Item_cond_and *res = new (thd->mem_root) Item_cond_and(pushed);
+  if (res == nullptr) return true;
+  res->quick_fix_field();
+  res->update_used_tables();
+  *cond = res;
+
+  Opt_trace_object step_wrapper(&thd->opt_trace);
+  step_wrapper.add_alnum("transformation", "system_view_row_in_pushdown");
+  step_wrapper.add("resulting_condition", *cond);
+  return false;
+}
+
 /**
   Optimize conditions by
 
@@ -9887,6 +10141,10 @@ bool optimize_cond(THD *thd, Item **cond, COND_EQUAL **cond_equal,
   */
   assert(*cond || join_list);
 
+  if (join_list && *cond != nullptr &&
+      push_down_system_view_row_in(thd, cond))
+    return true;
+
   /*
     Build all multiple equality predicates and eliminate equality
     predicates that can be inferred from these multiple equalities.
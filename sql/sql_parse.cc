@@ -2283,11 +2283,22 @@ done:
 
     The factor 5 is pretty much arbitrary, but ends up allowing three
     allocations (1 + 1.5 + 1.5²) under the current allocation policy.
+
+    Freed blocks go to the MEM_ROOT block cache, and after a Clear() the
+    first block is sized after the recent statements, so that statements of
+    a steady workload take one cached block instead of growing from small
+    ones.
   */
-  if (thd->mem_root->allocated_size() < 5 * thd->variables.query_prealloc_size)
+  const size_t stmt_mem = thd->mem_root->allocated_size();
+  const size_t estimate = thd->update_main_mem_root_estimate(stmt_mem);
+  if (stmt_mem < 5 * thd->variables.query_prealloc_size)
     thd->mem_root->ClearForReuse();
-  else
+  else {
     thd->mem_root->Clear();
+    thd->mem_root->set_block_size(std::min<size_t>(
+        std::max<size_t>(estimate, thd->variables.query_alloc_block_size),
+        1024 * 1024));
+  }
 
     /* SHOW PROFILE instrumentation, end */
 #if defined(ENABLED_PROFILING)
@@ -4892,7 +4903,7 @@ void dispatch_sql_command(THD *thd, Parser_state *parser_state) {
   lex_start(thd);
 
   /* Inception hook: magic comments and special commands */
-  if (inception::before_parse(thd)) return;
+  if (inception::before_parse(thd, &parser_state->m_lip)) return;
 
   thd->m_parser_state = parser_state;
   invoke_pre_parse_rewrite_plugins(thd);
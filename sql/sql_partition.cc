@@ -3855,6 +3855,9 @@ void get_partition_set(const TABLE *table, uchar *buf, const uint index,
      default_db_type               What is the default engine of the table
      work_part_info_used           Flag is raised if we don't create new
                                    part_info, but used thd->work_part_info
+     share_part_info               If not NULL, part_buf only holds the
+                                   PARTITION BY clause and the partition
+                                   definitions are taken from this object
 
    RETURN VALUE
      true                          Error
@@ -3874,7 +3877,8 @@ void get_partition_set(const TABLE *table, uchar *buf, const uint index,
 bool mysql_unpack_partition(THD *thd, char *part_buf, uint part_info_len,
                             TABLE *table, bool is_create_table_ind,
                             handlerton *default_db_type,
-                            bool *work_part_info_used) {
+                            bool *work_part_info_used,
+                            const partition_info *share_part_info) {
   bool result = true;
   partition_info *part_info;
   const CHARSET_INFO *old_character_set_client =
@@ -3923,6 +3927,11 @@ bool mysql_unpack_partition(THD *thd, char *part_buf, uint part_info_len,
   part_info = parser_state.result;
   thd->m_digest = parent_digest;
   thd->m_statement_psi = parent_locker;
+  if (share_part_info != nullptr &&
+      part_info->set_partitions_from_share(thd, share_part_info)) {
+    thd->free_items();
+    goto end;
+  }
   /*
     The parsed syntax residing in the frm file can still contain defaults.
     The reason is that the frm file is sometimes saved outside of this
@@ -113,7 +113,8 @@ void get_full_part_id_from_key(const TABLE *table, uchar *buf, KEY *key_info,
 bool mysql_unpack_partition(THD *thd, char *part_buf, uint part_info_len,
                             TABLE *table, bool is_create_table_ind,
                             handlerton *default_db_type,
-                            bool *work_part_info_used);
+                            bool *work_part_info_used,
+                            const partition_info *share_part_info = nullptr);
 bool make_used_partitions_str(partition_info *part_info,
                               List<const char> *parts);
 bool check_part_func_fields(Field **ptr, bool ok_with_charsets);
@@ -1889,8 +1889,174 @@ class Join_tab_compare_embedded_first {
   }
 };
 
+/**
+  Whether the join order of join may be taken from or stored in the join
+  order cache of its query block.
+*/
+bool use_join_order_cache(const JOIN *join, const TABLE_LIST *emb_sjm_nest,
+                          bool straight_join) {
+  THD *const thd = join->thd;
+  return thd->variables.optimizer_plan_cache && emb_sjm_nest == nullptr &&
+         !straight_join && join->query_block->sj_nests.empty() &&
+         !thd->stmt_arena->is_regular() && thd->lex->sphead == nullptr;
+}
+
+/// Fold v into the parameter shape h.
+inline ulonglong shape_mix(ulonglong h, ulonglong v) {
+  return (h ^ v) * 0x100000001b3ULL;
+}
+
+/// The number of bits needed to hold v.
+inline ulonglong bit_length(ulonglong v) {
+  ulonglong bits = 0;
+  for (; v != 0; v >>= 1) bits++;
+  return bits;
+}
+
+/**
+  Put the non-const tables of join into best_ref in a join order cached for
+  the current execution.
+
+  @return true if an order was found
+*/
+bool use_cached_join_order(JOIN *join, ulonglong shape) {
+  const Join_order_cache *const cache = join->query_block->join_order_cache;
+  if (cache == nullptr) return false;
+  const uint first = join->const_tables;
+  const uint table_count = join->tables - first;
+
+  auto find_tab = [join, first](uint tableno) -> JOIN_TAB * {
+    for (uint j = first; j < join->tables; j++)
+      if (join->best_ref[j]->table_ref->tableno() == tableno)
+        return join->best_ref[j];
+    return nullptr;
+  };
+
+  /*
+    Check that the order is still a valid one and that the row counts of
+    its tables are still close.
+  */
+  auto usable = [join, table_count,
+                 &find_tab](const Join_order_cache::Entry &entry) {
+    table_map prefix = join->const_table_map;
+    for (uint i = 0; i < table_count; i++) {
+      const JOIN_TAB *const tab = find_tab(entry.order[i]);
+      if (tab == nullptr || (tab->dependent & ~prefix) ||
+          !Join_order_cache::similar_row_count(
+              entry.records[i], tab->table()->file->stats.records))
+        return false;
+      prefix |= tab->table_ref->map();
+    }
+    return true;
+  };
+
+  const Join_order_cache::Entry *const entry =
+      cache->find(shape, join->const_table_map, join->allow_outer_refs,
+                  table_count, usable);
+  if (entry == nullptr) return false;
+
+  for (uint i = 0; i < table_count; i++) {
+    JOIN_TAB **const pos = join->best_ref + first + i;
+    JOIN_TAB *const tab = find_tab(entry->order[i]);
+    *std::find(pos, join->best_ref + join->tables, tab) = *pos;
+    *pos = tab;
+  }
+  return true;
+}
+
+/// Store the join order just chosen for join in its join order cache.
+void cache_join_order(JOIN *join, ulonglong shape) {
+  THD *const thd = join->thd;
+  MEM_ROOT *const mem_root = thd->stmt_arena->mem_root;
+  Query_block *const query_block = join->query_block;
+  const uint first = join->const_tables;
+  const uint table_count = join->tables - first;
+
+  if (query_block->join_order_cache == nullptr) {
+    query_block->join_order_cache = new (mem_root) Join_order_cache;
+    if (query_block->join_order_cache == nullptr) return;
+  }
+  Join_order_cache::Entry *const entry =
+      query_block->join_order_cache->add(mem_root, table_count);
+  if (entry == nullptr) return;
+
+  entry->const_tables = join->const_table_map;
+  entry->allow_outer_refs = join->allow_outer_refs;
+  entry->shape = shape;
+  entry->table_count = table_count;
+  for (uint i = 0; i < table_count; i++) {
+    const JOIN_TAB *const tab = join->best_positions[first + i].table;
+    entry->order[i] = tab->table_ref->tableno();
+    entry->records[i] = tab->table()->file->stats.records;
+  }
+}
+
 }  // namespace
 
+ulonglong Join_order_cache::parameter_shape(THD *thd) {
+  ulonglong h = 0xcbf29ce484222325ULL;
+  h = shape_mix(h, thd->variables.optimizer_switch);
+  h = shape_mix(h, thd->variables.optimizer_search_depth);
+  h = shape_mix(h, thd->variables.optimizer_prune_level);
+
+  for (Item_param &param : thd->lex->param_list) {
+    ulonglong bucket = 0;
+    switch (param.param_state()) {
+      case Item_param::INT_VALUE: {
+        const longlong v = param.value.integer;
+        const bool negative = !param.unsigned_flag && v < 0;
+        const ulonglong magnitude =
+            negative ? 0 - static_cast<ulonglong>(v) : v;
+        bucket = (bit_length(magnitude) << 1) | negative;
+        break;
+      }
+      case Item_param::REAL_VALUE: {
+        int exponent;
+        frexp(param.value.real, &exponent);
+        bucket = (static_cast<ulonglong>(exponent) << 1) |
+                 (param.value.real < 0);
+        break;
+      }
+      case Item_param::DECIMAL_VALUE:
+        bucket = (static_cast<ulonglong>(param.decimal_value.intg) << 1) |
+                 param.decimal_value.sign();
+        break;
+      case Item_param::STRING_VALUE:
+      case Item_param::LONG_DATA_VALUE:
+        bucket = bit_length(param.str_value_ptr.length());
+        break;
+      default:
+        break;
+    }
+    h = shape_mix(h, (bucket << 4) | param.param_state());
+  }
+  return h;
+}
+
+Join_order_cache::Entry *Join_order_cache::add(MEM_ROOT *mem_root,
+                                               uint table_count) {
+  Entry *entry;
+  if (used < MAX_ENTRIES) {
+    entry = &entries[used++];
+  } else {
+    entry = &entries[next];
+    next = (next + 1) % MAX_ENTRIES;
+  }
+
+  if (entry->capacity < table_count) {
+    entry->order = mem_root->ArrayAlloc<uint>(table_count);
+    entry->records = mem_root->ArrayAlloc<ha_rows>(table_count);
+    if (entry->order == nullptr || entry->records == nullptr) {
+      /* Leave an entry that never matches */
+      entry->capacity = 0;
+      entry->table_count = UINT_MAX;
+      return nullptr;
+    }
+    entry->capacity = table_count;
+  }
+  return entry;
+}
+
 /**
   Selects and invokes a search strategy for an optimal query join order.
 
@@ -1982,10 +2148,19 @@ bool Optimize_table_order::choose_table_order() {
   Deps_of_remaining_lateral_derived_tables deps_lateral(join, ~excluded_tables);
   deps_lateral.init();
 
+  const bool use_cache =
+      use_join_order_cache(join, emb_sjm_nest, straight_join);
+  const ulonglong shape =
+      use_cache ? Join_order_cache::parameter_shape(thd) : 0;
+
   if (straight_join)
     optimize_straight_join(join_tables);
-  else {
+  else if (use_cache && use_cached_join_order(join, shape)) {
+    Opt_trace_object(&join->thd->opt_trace).add("cached_join_order", true);
+    optimize_straight_join(join_tables);
+  } else {
     if (greedy_search(join_tables)) return true;
+    if (use_cache) cache_join_order(join, shape);
   }
 
   deps_lateral.assert_unchanged();
@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 
+#include "my_base.h"  // ha_rows
 #include "my_inttypes.h"
 #include "my_table_map.h"
 
@@ -41,6 +42,7 @@ class Opt_trace_object;
 class THD;
 struct TABLE;
 struct TABLE_LIST;
+struct MEM_ROOT;
 struct POSITION;
 
 typedef ulonglong nested_join_map;
@@ -244,6 +246,83 @@ float calculate_condition_filter(const JOIN_TAB *const tab,
 double find_cost_for_ref(const THD *thd, TABLE *table, unsigned keyno,
                          double num_rows, double worst_seeks);
 
+/**
+  Join orders chosen by greedy_search() for earlier executions of a query
+  block of a prepared statement, used when optimizer_plan_cache is on.
+
+  An order is keyed by the const tables of the execution and by the shape
+  of the statement parameters: whether each is NULL, its type and the
+  magnitude of its value. Having found an order, choose_table_order() costs
+  it with optimize_straight_join() instead of searching again, so the access
+  method of each table is still chosen for the current values. An order is
+  not used any more once the row count of one of its tables has grown or
+  shrunk by more than a factor of two since it was chosen.
+
+  Allocated on the statement mem_root: the number of orders per query block
+  is bounded, a new one replaces the oldest.
+*/
+class Join_order_cache {
+ public:
+  struct Entry {
+    table_map const_tables{0};
+    bool allow_outer_refs{false};
+    ulonglong shape{0};
+    uint table_count{0};   ///< Non-const tables in the order
+    uint capacity{0};      ///< Size of order and records
+    uint *order{nullptr};  ///< Table numbers, first to last
+    ha_rows *records{nullptr};  ///< Row counts when the order was chosen
+  };
+
+  static constexpr uint MAX_ENTRIES = 4;
+
+  /**
+    The shape of the parameters of the statement and of the settings the
+    greedy search depends on. Two executions of the same shape are expected
+    to choose the same join order.
+  */
+  static ulonglong parameter_shape(THD *thd);
+
+  /// Whether a table holds about as many rows as it did.
+  static bool similar_row_count(ha_rows then, ha_rows now) {
+    return now <= 2 * then + 1 && then <= 2 * now + 1;
+  }
+
+  /**
+    Finds an order for a key.
+
+    @param usable  Called with each entry of the key, returns whether its
+                   order is still valid for the current tables.
+
+    @return the first entry of the key whose order is usable, or nullptr
+  */
+  template <class Usable>
+  const Entry *find(ulonglong shape, table_map const_tables,
+                    bool allow_outer_refs, uint table_count,
+                    Usable usable) const {
+    for (uint e = 0; e < used; e++) {
+      const Entry &entry = entries[e];
+      if (entry.shape == shape && entry.const_tables == const_tables &&
+          entry.allow_outer_refs == allow_outer_refs &&
+          entry.table_count == table_count && usable(entry))
+        return &entry;
+    }
+    return nullptr;
+  }
+
+  /**
+    Makes room for an order of table_count tables, replacing the oldest
+    order if all entries are used. The caller fills in the entry.
+
+    @return the entry, or nullptr if out of memory
+  */
+  Entry *add(MEM_ROOT *mem_root, uint table_count);
+
+ private:
+  Entry entries[MAX_ENTRIES];
+  uint used{0};
+  uint next{0};  ///< The entry replaced next when all are used
+};
+
 class Join_tab_compare_default {
  public:
   /**
@@ -11636,6 +11636,21 @@ static bool fill_alter_inplace_info(THD *thd, TABLE *table,
         ha_alter_info->handler_flags |=
             Alter_inplace_info::ALTER_COLUMN_COLUMN_FORMAT;
 
+      /*
+        Detect changes in engine attribute of column. The engine may use
+        it to choose how values are stored, e.g. InnoDB column compression,
+        so treat it as a change of the stored column type.
+      */
+      if (field->stored_in_db &&
+          (new_field->m_engine_attribute.length !=
+               field->m_engine_attribute.length ||
+           (field->m_engine_attribute.length > 0 &&
+            memcmp(new_field->m_engine_attribute.str,
+                   field->m_engine_attribute.str,
+                   field->m_engine_attribute.length) != 0)))
+        ha_alter_info->handler_flags |=
+            Alter_inplace_info::ALTER_STORED_COLUMN_TYPE;
+
       /*
         Columns which were mentioned in CHANGE/MODIFY COLUMN clause might
         have changed their default, add their name to corresponding array.
@@ -401,6 +401,16 @@ static Sys_var_bool Sys_pfs_processlist(
     NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(nullptr),
     nullptr, sys_var::PARSE_NORMAL);
 
+static Sys_var_ulong Sys_pfs_statement_sample_rate(
+    "performance_schema_statement_sample_rate",
+    "Record stages, waits and statement history for only one in so many "
+    "statements of a thread. Statement and digest summaries still count "
+    "every statement. 1 records all statements.",
+    GLOBAL_VAR(pfs_statement_sample_rate), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(1, 1000000), DEFAULT(1), BLOCK_SIZE(1), NO_MUTEX_GUARD,
+    NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(nullptr), nullptr,
+    sys_var::PARSE_NORMAL);
+
 static Sys_var_bool Sys_pfs_consumer_events_stages_current(
     "performance_schema_consumer_events_stages_current",
     "Default startup value for the events_stages_current consumer.",
@@ -1401,6 +1411,16 @@ static Sys_var_uint Sys_binlog_transaction_compression_level_zstd(
     BLOCK_SIZE(1), NO_MUTEX_GUARD, NOT_IN_BINLOG,
     ON_CHECK(check_binlog_trx_compression), ON_UPDATE(NULL));
 
+static Sys_var_uint Sys_binlog_transaction_compression_workers(
+    "binlog_transaction_compression_workers",
+    "The number of threads of a session that compress parts of a "
+    "transaction of 2MB or more in parallel, when transactions are "
+    "compressed. The compressed payload is read back as before. 0 "
+    "compresses every transaction in the session thread only.",
+    GLOBAL_VAR(opt_binlog_trx_compression_workers), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 64), DEFAULT(0), BLOCK_SIZE(1), NO_MUTEX_GUARD,
+    NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(nullptr));
+
 static bool on_session_track_gtids_update(sys_var *, THD *thd, enum_var_type) {
   thd->session_tracker.get_tracker(SESSION_GTIDS_TRACKER)->update(thd);
   return false;
@@ -1595,6 +1615,27 @@ static Sys_var_bool Sys_binlog_order_commits(
     " written to the binary log. Default is to order commits.",
     GLOBAL_VAR(opt_binlog_order_commits), CMD_LINE(OPT_ARG), DEFAULT(true));
 
+static Sys_var_ulong Sys_binlog_gtid_index_interval(
+    "binlog_gtid_index_interval",
+    "Every this many bytes of a binary log, note the position of a "
+    "transaction and the GTIDs before it in memory, so that dump threads "
+    "of replicas using AUTO_POSITION seek to the first transaction the "
+    "replica misses instead of reading the file up to it. Takes effect "
+    "from the next binary log on. 0 disables the index.",
+    GLOBAL_VAR(opt_binlog_gtid_index_interval), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 1024 * 1024L * 1024L), DEFAULT(0), BLOCK_SIZE(1),
+    NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(nullptr));
+
+static Sys_var_ulong Sys_binlog_dump_cache_size(
+    "binlog_dump_cache_size",
+    "Keep this many of the bytes last written to the binary log in memory, "
+    "for the dump threads that have caught up to copy the events from "
+    "instead of reading them from the file. Not used for encrypted binary "
+    "logs. Takes effect from the next binary log on. 0 disables the cache.",
+    GLOBAL_VAR(opt_binlog_dump_cache_size), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 1024 * 1024L * 1024L), DEFAULT(0), BLOCK_SIZE(IO_SIZE),
+    NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(nullptr));
+
 static Sys_var_ulong Sys_bulk_insert_buff_size(
     "bulk_insert_buffer_size",
     "Size of tree cache used in bulk "
@@ -3092,6 +3133,16 @@ static Sys_var_ulong Sys_optimizer_search_depth(
     HINT_UPDATEABLE SESSION_VAR(optimizer_search_depth), CMD_LINE(REQUIRED_ARG),
     VALID_RANGE(0, MAX_TABLES + 1), DEFAULT(MAX_TABLES + 1), BLOCK_SIZE(1));
 
+static Sys_var_bool Sys_optimizer_plan_cache(
+    "optimizer_plan_cache",
+    "Make the optimizer keep the join order it chose for a query block of a "
+    "prepared statement, and use it again when the statement is executed "
+    "with parameters of the same shape (NULL or not, type and magnitude) "
+    "while the row counts of its tables stay within a factor of two, "
+    "instead of searching for a join order again",
+    HINT_UPDATEABLE SESSION_VAR(optimizer_plan_cache), CMD_LINE(OPT_ARG),
+    DEFAULT(false));
+
 static Sys_var_ulong Sys_range_optimizer_max_mem_size(
     "range_optimizer_max_mem_size",
     "Maximum amount of memory used by the range optimizer "
@@ -3130,6 +3181,15 @@ static Sys_var_ulonglong Sys_histogram_generation_max_mem_size(
     NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_session_admin),
     ON_UPDATE(nullptr));
 
+static Sys_var_bool Sys_histogram_update_modified_only(
+    "histogram_update_modified_only",
+    "Make ANALYZE TABLE ... UPDATE HISTOGRAM keep the histogram of a column "
+    "when it was stored after the last change of the table the storage "
+    "engine knows of, instead of building it again",
+    SESSION_VAR(histogram_update_modified_only), CMD_LINE(OPT_ARG),
+    DEFAULT(false), NO_MUTEX_GUARD, NOT_IN_BINLOG,
+    ON_CHECK(check_session_admin), ON_UPDATE(nullptr));
+
 /*
   Need at least 400Kb to get through bootstrap.
   Need at least 8Mb to get through mtr check testcase, which does
@@ -3220,6 +3280,7 @@ static const char *optimizer_switch_names[] = {
     "prefer_ordering_index",
     "hypergraph_optimizer",  // Deliberately not documented below.
     "derived_condition_pushdown",
+    "json_projection_pushdown",
     "default",
     NullS};
 static Sys_var_flagset Sys_optimizer_switch(
@@ -3233,7 +3294,8 @@ static Sys_var_flagset Sys_optimizer_switch(
     " block_nested_loop, batched_key_access, use_index_extensions,"
     " condition_fanout_filter, derived_merge, hash_join,"
     " subquery_to_derived, prefer_ordering_index,"
-    " derived_condition_pushdown} and val is one of "
+    " derived_condition_pushdown, json_projection_pushdown}"
+    " and val is one of "
     "{on, off, default}",
     HINT_UPDATEABLE SESSION_VAR(optimizer_switch), CMD_LINE(REQUIRED_ARG),
     optimizer_switch_names, DEFAULT(OPTIMIZER_SWITCH_DEFAULT), NO_MUTEX_GUARD,
@@ -3592,6 +3654,14 @@ static Sys_var_ulong Sys_query_prealloc_size(
     DEFAULT(QUERY_ALLOC_PREALLOC_SIZE), BLOCK_SIZE(1024), NO_MUTEX_GUARD,
     NOT_IN_BINLOG, ON_CHECK(nullptr), ON_UPDATE(fix_thd_mem_root));
 
+static Sys_var_ulong Sys_mem_root_block_cache_size(
+    "mem_root_block_cache_size",
+    "Maximum memory held by the cache of freed statement memory blocks that "
+    "are reused by later statements instead of allocating new ones. "
+    "0 disables the cache",
+    GLOBAL_VAR(mem_root_block_cache_size), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, ULONG_MAX), DEFAULT(8 * 1024 * 1024), BLOCK_SIZE(4096));
+
 #if defined(_WIN32)
 static Sys_var_bool Sys_shared_memory(
     "shared_memory", "Enable the shared memory",
@@ -3679,14 +3749,61 @@ static Sys_var_ulong Sys_trans_prealloc_size(
     ON_UPDATE(fix_trans_mem_root));
 
 static const char *thread_handling_names[] = {
-    "one-thread-per-connection", "no-threads", "loaded-dynamically", nullptr};
+    "one-thread-per-connection", "no-threads", "pool-of-threads",
+    "loaded-dynamically", nullptr};
 static Sys_var_enum Sys_thread_handling(
     "thread_handling",
     "Define threads usage for handling queries, one of "
-    "one-thread-per-connection, no-threads, loaded-dynamically",
+    "one-thread-per-connection, no-threads, pool-of-threads, "
+    "loaded-dynamically",
     READ_ONLY GLOBAL_VAR(Connection_handler_manager::thread_handling),
     CMD_LINE(REQUIRED_ARG), thread_handling_names, DEFAULT(0));
 
+static Sys_var_uint Sys_thread_pool_size(
+    "thread_pool_size",
+    "Number of thread groups of thread_handling=pool-of-threads. Each "
+    "group serves its connections with at most 1 + thread_pool_oversubscribe "
+    "threads at a time. 0 uses one group per CPU",
+    READ_ONLY GLOBAL_VAR(Thread_pool_connection_handler::size),
+    CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_oversubscribe(
+    "thread_pool_oversubscribe",
+    "Number of threads of a thread group that may execute statements in "
+    "addition to the first one. Threads waiting for locks or I/O don't count",
+    GLOBAL_VAR(Thread_pool_connection_handler::oversubscribe),
+    CMD_LINE(REQUIRED_ARG), VALID_RANGE(0, 1000), DEFAULT(3), BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_stall_limit(
+    "thread_pool_stall_limit",
+    "Milliseconds after which a thread group that did not pick up queued "
+    "connections is considered stalled and gets another thread",
+    GLOBAL_VAR(Thread_pool_connection_handler::stall_limit),
+    CMD_LINE(REQUIRED_ARG), VALID_RANGE(10, 60000), DEFAULT(500),
+    BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_max_threads(
+    "thread_pool_max_threads",
+    "Maximum number of threads of all thread groups together",
+    GLOBAL_VAR(Thread_pool_connection_handler::max_threads),
+    CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, 100000), DEFAULT(1000),
+    BLOCK_SIZE(1));
+
+static Sys_var_uint Sys_thread_pool_idle_timeout(
+    "thread_pool_idle_timeout",
+    "Seconds after which an idle thread of a thread group exits",
+    GLOBAL_VAR(Thread_pool_connection_handler::idle_timeout),
+    CMD_LINE(REQUIRED_ARG), VALID_RANGE(1, UINT_MAX32), DEFAULT(60),
+    BLOCK_SIZE(1));
+
+static Sys_var_bool Sys_thread_pool_buffered_read(
+    "thread_pool_buffered_read",
+    "Read from the sockets of pool connections through a buffer, so that "
+    "short and pipelined packets need a single system call. Applies to new "
+    "connections, TCP/IP and Unix socket ones without TLS",
+    GLOBAL_VAR(Thread_pool_connection_handler::buffered_read),
+    CMD_LINE(OPT_ARG), DEFAULT(true));
+
 static Sys_var_charptr Sys_secure_file_priv(
     "secure_file_priv",
     "Limit LOAD DATA, SELECT ... OUTFILE, and LOAD_FILE() to files "
@@ -3732,6 +3849,14 @@ static Sys_var_int32 Sys_regexp_stack_limit(
     GLOBAL_VAR(opt_regexp_stack_limit), CMD_LINE(REQUIRED_ARG),
     VALID_RANGE(0, INT32_MAX), DEFAULT(8000000), BLOCK_SIZE(1));
 
+static Sys_var_uint Sys_regexp_cache_size(
+    "regexp_cache_size",
+    "Number of compiled regular expression patterns kept for all sessions, "
+    "so that a pattern used again, by a later statement or another session, "
+    "is copied instead of compiled again. 0 disables the cache.",
+    GLOBAL_VAR(opt_regexp_cache_size), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 65536), DEFAULT(256), BLOCK_SIZE(1));
+
 static Sys_var_bool Sys_slave_compressed_protocol(
     "slave_compressed_protocol", "Use compression on master/slave protocol",
     GLOBAL_VAR(opt_slave_compressed_protocol), CMD_LINE(OPT_ARG),
@@ -4961,6 +5086,15 @@ static Sys_var_bool Sys_temptable_use_mmap("temptable_use_mmap",
                                            GLOBAL_VAR(temptable_use_mmap),
                                            CMD_LINE(OPT_ARG), DEFAULT(true));
 
+static Sys_var_ulong Sys_temptable_compression_min_length(
+    "temptable_compression_min_length",
+    "Make the TempTable storage engine store VARCHAR values of at least this "
+    "many bytes LZ4 compressed in memory, when they are in a column that is "
+    "not part of an index and compressing makes them smaller. "
+    "0 disables compression.",
+    GLOBAL_VAR(temptable_compression_min_length), CMD_LINE(REQUIRED_ARG),
+    VALID_RANGE(0, 65535), DEFAULT(0), BLOCK_SIZE(1));
+
 static Sys_var_plugin Sys_default_tmp_storage_engine(
     "default_tmp_storage_engine",
     "The default storage engine for new explicit temporary tables",
@@ -5799,10 +5933,23 @@ static Sys_var_ulong Sys_rpl_read_size(
     VALID_RANGE(IO_SIZE * 2, ULONG_MAX), DEFAULT(IO_SIZE * 2),
     BLOCK_SIZE(IO_SIZE));
 
+static Sys_var_bool Sys_relay_log_mmap(
+    "relay_log_mmap",
+    "Read relay log files through a memory mapping instead of buffered "
+    "reads of rpl_read_size. Relay log files opened after it is "
+    "changed use the new setting",
+    GLOBAL_VAR(opt_relay_log_mmap), CMD_LINE(OPT_ARG), DEFAULT(false));
+
 static Sys_var_bool Sys_slave_allow_batching(
     "slave_allow_batching", "Allow slave to batch requests",
     GLOBAL_VAR(opt_slave_allow_batching), CMD_LINE(OPT_ARG), DEFAULT(false));
 
+static Sys_var_bool Sys_slave_prefetch_rows(
+    "slave_prefetch_rows",
+    "Make the storage engine start reading the index pages of all the rows "
+    "of a row event before the applier looks them up one by one",
+    GLOBAL_VAR(opt_slave_prefetch_rows), CMD_LINE(OPT_ARG), DEFAULT(false));
+
 static Sys_var_charptr Sys_slave_load_tmpdir(
     "slave_load_tmpdir",
     "The location where the slave should put "
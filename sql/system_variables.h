@@ -212,6 +212,7 @@ struct System_variables {
   uint eq_range_index_dive_limit;
   uint cte_max_recursion_depth;
   ulonglong histogram_generation_max_mem_size;
+  bool histogram_update_modified_only;
   ulong join_buff_size;
   ulong lock_wait_timeout;
   ulong max_allowed_packet;
@@ -229,6 +230,7 @@ struct System_variables {
   ulong net_write_timeout;
   ulong optimizer_prune_level;
   ulong optimizer_search_depth;
+  bool optimizer_plan_cache;
   ulonglong parser_max_mem_size;
   ulong range_optimizer_max_mem_size;
   ulong preload_buff_size;
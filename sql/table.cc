@@ -81,6 +81,7 @@
 #include "sql/item.h"
 #include "sql/item_cmpfunc.h"    // and_conds
 #include "sql/item_json_func.h"  // Item_func_array_cast
+#include "sql/json_binary.h"     // json_binary::Projection
 #include "sql/json_diff.h"       // Json_diff_vector
 #include "sql/json_dom.h"        // Json_wrapper
 #include "sql/json_path.h"
@@ -2751,9 +2752,20 @@ bool unpack_partition_info(THD *thd, TABLE *outparam, TABLE_SHARE *share,
   bool tmp;
   bool work_part_info_used;
 
-  tmp = mysql_unpack_partition(
-      thd, share->partition_info_str, share->partition_info_str_len, outparam,
-      is_create_table, engine_type, &work_part_info_used);
+  /*
+    Unless creating the table, parse only the partition expression when
+    the partition definitions can be taken from the TABLE_SHARE.
+  */
+  if (!is_create_table && share->partition_header_str != nullptr) {
+    tmp = mysql_unpack_partition(
+        thd, share->partition_header_str, share->partition_header_str_len,
+        outparam, is_create_table, engine_type, &work_part_info_used,
+        share->m_part_info);
+  } else {
+    tmp = mysql_unpack_partition(
+        thd, share->partition_info_str, share->partition_info_str_len,
+        outparam, is_create_table, engine_type, &work_part_info_used);
+  }
   if (tmp) {
     thd->stmt_arena = backup_stmt_arena_ptr;
     thd->swap_query_arena(backup_arena, &part_func_arena);
@@ -7514,6 +7526,29 @@ void TABLE::cleanup_partial_update() {
   m_partial_update_info = nullptr;
 }
 
+bool TABLE::set_json_projection(const Field *field,
+                                json_binary::Projection *projection) {
+  DBUG_TRACE;
+  assert(field->table == this && field->type() == MYSQL_TYPE_JSON);
+
+  if (m_json_projections == nullptr) {
+    m_json_projections = new (current_thd->mem_root)
+        json_binary::Projection *[s->fields] { nullptr };
+    if (m_json_projections == nullptr) return true; /* purecov: inspected */
+  }
+
+  assert(m_json_projections[field->field_index()] == nullptr);
+  m_json_projections[field->field_index()] = projection;
+  return false;
+}
+
+void TABLE::cleanup_json_projections() {
+  DBUG_TRACE;
+  if (m_json_projections == nullptr) return;
+  for (uint i = 0; i < s->fields; i++) destroy(m_json_projections[i]);
+  m_json_projections = nullptr;
+}
+
 String *TABLE::get_partial_update_buffer() {
   assert(m_partial_update_info != nullptr);
   return &m_partial_update_info->m_buffer;
@@ -67,6 +67,9 @@ class Field;
 namespace histograms {
 class Histogram;
 }
+namespace json_binary {
+class Projection;
+}
 
 class ACL_internal_schema_access;
 class ACL_internal_table_access;
@@ -968,6 +971,14 @@ struct TABLE_SHARE {
   */
   char *partition_info_str{nullptr};
   uint partition_info_str_len{0};
+  /**
+    The PARTITION BY clause alone, without partition definitions. Set when
+    m_part_info->has_shareable_partitions(): each TABLE instance then only
+    parses the partition expression and takes the partition definitions
+    from m_part_info, which matters for tables with many partitions.
+  */
+  char *partition_header_str{nullptr};
+  uint partition_header_str_len{0};
 
   /**
     Cache the checked structure of this table.
@@ -2094,6 +2105,15 @@ struct TABLE {
   */
   Partial_update_info *m_partial_update_info{nullptr};
 
+  /**
+    Member paths of JSON columns that the current statement reads only
+    through JSON_EXTRACT, indexed by field number, or nullptr if no
+    column is projected.
+
+    It is allocated in the execution mem_root by #set_json_projection().
+  */
+  json_binary::Projection **m_json_projections{nullptr};
+
   /**
     This flag decides whether or not we should log the drop temporary table
     command.
@@ -2219,6 +2239,42 @@ struct TABLE {
   */
   void cleanup_partial_update();
 
+  /**
+    Let the storage engine read only the given member paths of a JSON
+    column, as the statement uses the column nowhere else. The storage
+    engine may then return a document that contains just these members.
+
+    This function should be called once per statement execution, before
+    the table is read.
+
+    @param field       the JSON column
+    @param projection  the member paths, allocated in the execution mem_root
+
+    @retval false  on success
+    @retval true   on out-of-memory
+  */
+  bool set_json_projection(const Field *field,
+                           json_binary::Projection *projection);
+
+  /**
+    Get the member paths of a JSON column that the current statement reads.
+
+    @param field_index  the field number of the column
+    @return the projection, or nullptr if the whole column must be read
+  */
+  const json_binary::Projection *json_projection(uint field_index) const {
+    return m_json_projections == nullptr ? nullptr
+                                         : m_json_projections[field_index];
+  }
+
+  /**
+    Clean up the JSON projections of the current statement.
+
+    This function should be called at the end of each statement
+    execution.
+  */
+  void cleanup_json_projections();
+
   /**
     Temporarily disable collection of binary diffs for a column in the current
     row.
@@ -60,6 +60,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "btr0btr.h"
 #include "btr0sea.h"
 #include "buf0lru.h"
+#include "buf0rea.h"
 #ifdef UNIV_DEBUG
 #include "current_thd.h"
 #include "debug_sync.h"
@@ -93,6 +94,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #endif /* !UNIV_HOTBACKUP */
 
 #include <array>
+#include <vector>
 
 /** Buffered B-tree operation types, introduced as part of delete buffering. */
 enum btr_op_t {
@@ -5362,6 +5364,238 @@ int64_t btr_estimate_n_rows_in_range(dict_index_t *index,
   return (ret);
 }
 
+/** Descend from the root of an index to the level 1 page that tuple would
+be routed through. Only pages already in the buffer pool are searched; page
+latches are coupled parent to child, as in any descent.
+@param[in]	index	index
+@param[in]	tuple	search tuple
+@param[in,out]	mtr	mini-transaction holding the S-latches
+@return the S-latched level 1 page, or nullptr if a page on the way is not in
+the buffer pool or is no longer a node of index, or if the tree has a single
+level */
+static buf_block_t *btr_cur_get_level1_if_in_pool(dict_index_t *index,
+                                                  const dtuple_t *tuple,
+                                                  mtr_t *mtr) {
+  const space_id_t space = dict_index_get_space(index);
+  const page_size_t page_size(dict_table_page_size(index->table));
+  page_no_t page_no = dict_index_get_page(index);
+  mem_heap_t *heap = nullptr;
+  ulint offsets_[REC_OFFS_NORMAL_SIZE];
+  ulint *offsets = offsets_;
+  rec_offs_init(offsets_);
+
+  buf_block_t *level1 = nullptr;
+
+  for (;;) {
+    buf_block_t *block = buf_page_get_gen(
+        page_id_t(space, page_no), page_size, RW_S_LATCH, nullptr,
+        Page_fetch::IF_IN_POOL, __FILE__, __LINE__, mtr);
+    if (block == nullptr) break;
+
+    const page_t *page = buf_block_get_frame(block);
+    if (!fil_page_index_page_check(page) ||
+        btr_page_get_index_id(page) != index->id) {
+      break;
+    }
+    const ulint level = btr_page_get_level_low(page);
+    if (level == 0 || page_get_n_recs(page) == 0) break;
+
+    if (level == 1) {
+      level1 = block;
+      break;
+    }
+
+    page_cur_t cursor;
+    ulint up_match = 0;
+    ulint low_match = 0;
+    page_cur_search_with_match(block, index, tuple, PAGE_CUR_LE, &up_match,
+                               &low_match, &cursor, nullptr);
+    const rec_t *node_ptr = page_cur_get_rec(&cursor);
+    if (!page_rec_is_user_rec(node_ptr)) {
+      /* Before the first node pointer: the leftmost child */
+      node_ptr = page_rec_get_next_const(node_ptr);
+    }
+    offsets = rec_get_offsets(node_ptr, index, offsets, ULINT_UNDEFINED, &heap);
+    page_no = btr_node_ptr_get_child_page_no(node_ptr, offsets);
+  }
+
+  if (heap != nullptr) {
+    mem_heap_free(heap);
+  }
+
+  return level1;
+}
+
+/** Find the leaf page that tuple would be on, in a latched level 1 page.
+@param[in]	block	S-latched level 1 page
+@param[in]	index	index
+@param[in]	tuple	search tuple
+@param[out]	on_last	true if tuple is routed through the last node pointer
+of block, so that it may belong to a page to the right of it
+@param[in,out]	heap	memory heap for the offsets, or nullptr
+@return the leaf page number */
+static page_no_t btr_cur_level1_get_child(const buf_block_t *block,
+                                          dict_index_t *index,
+                                          const dtuple_t *tuple, bool *on_last,
+                                          mem_heap_t **heap) {
+  ulint offsets_[REC_OFFS_NORMAL_SIZE];
+  rec_offs_init(offsets_);
+
+  page_cur_t cursor;
+  ulint up_match = 0;
+  ulint low_match = 0;
+  page_cur_search_with_match(block, index, tuple, PAGE_CUR_LE, &up_match,
+                             &low_match, &cursor, nullptr);
+  const rec_t *node_ptr = page_cur_get_rec(&cursor);
+  if (!page_rec_is_user_rec(node_ptr)) {
+    node_ptr = page_rec_get_next_const(node_ptr);
+  }
+  *on_last = page_rec_is_supremum(page_rec_get_next_const(node_ptr));
+
+  const ulint *offsets =
+      rec_get_offsets(node_ptr, index, offsets_, ULINT_UNDEFINED, heap);
+  return btr_node_ptr_get_child_page_no(node_ptr, offsets);
+}
+
+void btr_cur_prefetch_leaf(dict_index_t *index, const dtuple_t *tuple) {
+  btr_cur_prefetch_leaves(index, &tuple, 1);
+}
+
+void btr_cur_prefetch_leaves(dict_index_t *index, const dtuple_t **tuples,
+                             ulint n_tuples) {
+  const space_id_t space = dict_index_get_space(index);
+  const page_size_t page_size(dict_table_page_size(index->table));
+  mem_heap_t *heap = nullptr;
+  std::vector<page_no_t> leaves;
+
+  for (ulint i = 0; i < n_tuples;) {
+    mtr_t mtr;
+    mtr_start(&mtr);
+
+    buf_block_t *block = btr_cur_get_level1_if_in_pool(index, tuples[i], &mtr);
+    if (block == nullptr) {
+      mtr_commit(&mtr);
+      ++i;
+      continue;
+    }
+
+    const bool has_next =
+        btr_page_get_next(buf_block_get_frame(block), &mtr) != FIL_NULL;
+
+    /* The tuples are sorted: route all of them that fall within the
+    node pointers of this page without another descent. The first one was
+    routed here from the root, so it always belongs to the page. */
+    ulint j = i;
+    do {
+      bool on_last;
+      const page_no_t leaf =
+          btr_cur_level1_get_child(block, index, tuples[j], &on_last, &heap);
+      if (on_last && has_next && j != i) {
+        break;
+      }
+      if (leaves.empty() || leaves.back() != leaf) {
+        leaves.push_back(leaf);
+      }
+    } while (++j < n_tuples);
+
+    mtr_commit(&mtr);
+    i = j;
+  }
+
+  if (heap != nullptr) {
+    mem_heap_free(heap);
+  }
+
+  bool read = false;
+  for (page_no_t leaf : leaves) {
+    const page_id_t page_id(space, leaf);
+    if (buf_page_peek(page_id)) {
+      continue;
+    }
+    buf_read_page_background(page_id, page_size, false);
+    read = true;
+  }
+
+  if (read) {
+    os_aio_simulated_wake_handler_threads();
+  }
+}
+
+ulint btr_cur_read_ahead_leaves(dict_index_t *index, const dtuple_t *tuple,
+                                ulint n_pages) {
+  const space_id_t space = dict_index_get_space(index);
+  const page_size_t page_size(dict_table_page_size(index->table));
+  mem_heap_t *heap = nullptr;
+  ulint offsets_[REC_OFFS_NORMAL_SIZE];
+  ulint *offsets = offsets_;
+  rec_offs_init(offsets_);
+
+  /* The first leaf found is the one tuple is on */
+  std::vector<page_no_t> leaves;
+  leaves.reserve(n_pages + 1);
+
+  mtr_t mtr;
+  mtr_start(&mtr);
+
+  buf_block_t *block = btr_cur_get_level1_if_in_pool(index, tuple, &mtr);
+
+  if (block != nullptr) {
+    page_cur_t cursor;
+    ulint up_match = 0;
+    ulint low_match = 0;
+    page_cur_search_with_match(block, index, tuple, PAGE_CUR_LE, &up_match,
+                               &low_match, &cursor, nullptr);
+    const rec_t *node_ptr = page_cur_get_rec(&cursor);
+    if (!page_rec_is_user_rec(node_ptr)) {
+      node_ptr = page_rec_get_next_const(node_ptr);
+    }
+
+    while (leaves.size() <= n_pages) {
+      if (page_rec_is_supremum(node_ptr)) {
+        /* Continue in the right sibling: latching it after its left
+        sibling follows the latching order */
+        const page_no_t next =
+            btr_page_get_next(buf_block_get_frame(block), &mtr);
+        if (next == FIL_NULL) break;
+
+        block = buf_page_get_gen(page_id_t(space, next), page_size,
+                                 RW_S_LATCH, nullptr, Page_fetch::IF_IN_POOL,
+                                 __FILE__, __LINE__, &mtr);
+        if (block == nullptr) break;
+
+        const page_t *page = buf_block_get_frame(block);
+        if (!fil_page_index_page_check(page) ||
+            btr_page_get_index_id(page) != index->id ||
+            btr_page_get_level_low(page) != 1) {
+          break;
+        }
+        node_ptr = page_rec_get_next_const(page_get_infimum_rec(page));
+        continue;
+      }
+
+      offsets =
+          rec_get_offsets(node_ptr, index, offsets, ULINT_UNDEFINED, &heap);
+      leaves.push_back(btr_node_ptr_get_child_page_no(node_ptr, offsets));
+      node_ptr = page_rec_get_next_const(node_ptr);
+    }
+  }
+
+  mtr_commit(&mtr);
+
+  if (heap != nullptr) {
+    mem_heap_free(heap);
+  }
+
+  if (leaves.size() < 2) {
+    return 0;
+  }
+
+  buf_read_ahead_logical(space, page_size, leaves.data() + 1,
+                         leaves.size() - 1);
+
+  return leaves.size() - 1;
+}
+
 /** Record the number of non_null key values in a given index for
  each n-column prefix of the index where 1 <= n <=
  dict_index_get_n_unique(index). The estimates are eventually stored in the
@@ -59,6 +59,14 @@ bool btr_search_enabled = true;
 /** Number of adaptive hash index partition. */
 ulong btr_ahi_parts = 8;
 
+/** Whether the adaptive hash index is switched off for the indexes on
+which it does not pay off. */
+bool btr_search_auto_tune = false;
+
+/** Minimum percentage of searches that the adaptive hash index must serve
+on an index when btr_search_auto_tune is set. */
+ulong btr_search_min_hit_pct = 20;
+
 #ifdef UNIV_SEARCH_PERF_STAT
 /** Number of successful adaptive hash index lookups */
 ulint btr_search_n_succ = 0;
@@ -377,6 +385,16 @@ btr_search_t *btr_search_info_create(mem_heap_t *heap) {
 
   info->last_hash_succ = FALSE;
 
+  info->n_ahi_searches = 0;
+  info->n_ahi_btree_searches = 0;
+  info->n_ahi_rows_added = 0;
+  info->n_ahi_rows_removed = 0;
+  info->n_ahi_disabled = 0;
+  info->ahi_disabled = false;
+  info->tune_searches = 0;
+  info->tune_hits = 0;
+  info->tune_rows_added = 0;
+
 #ifdef UNIV_SEARCH_PERF_STAT
   info->n_hash_succ = 0;
   info->n_hash_fail = 0;
@@ -643,10 +661,59 @@ static void btr_search_update_hash_ref(const btr_search_t *info,
 
     ha_insert_for_fold(btr_get_search_table(index), fold, block, rec);
 
+    index->search_info->n_ahi_rows_added++;
     MONITOR_INC(MONITOR_ADAPTIVE_HASH_ROW_ADDED);
   }
 }
 
+/** Decide whether the adaptive hash index pays off on an index. Every
+BTR_SEARCH_TUNE_WINDOW searches the share of searches that the hash index
+served is compared with innodb_adaptive_hash_index_min_hit_pct. If it is
+lower and more hash entries were added than searches served, building and
+searching the hash index is stopped on the index, which also takes its
+searches off the search latch. The index is retried after
+BTR_SEARCH_TUNE_RETRY windows, because the workload may have changed.
+Entries that exist already are removed as their pages are modified or
+evicted.
+@param[in,out]	info	search info of the index */
+static void btr_search_tune(btr_search_t *info) {
+  if (!btr_search_auto_tune) {
+    info->ahi_disabled = false;
+    return;
+  }
+
+  const ulint searches = info->n_ahi_searches + info->n_ahi_btree_searches;
+  const ulint window = searches - info->tune_searches;
+
+  if (window < BTR_SEARCH_TUNE_WINDOW) {
+    return;
+  }
+
+  if (info->ahi_disabled) {
+    if (window < BTR_SEARCH_TUNE_WINDOW * BTR_SEARCH_TUNE_RETRY) {
+      return;
+    }
+
+    info->ahi_disabled = false;
+    MONITOR_INC(MONITOR_ADAPTIVE_HASH_AUTO_ENABLED);
+  } else {
+    const ulint hits = info->n_ahi_searches - info->tune_hits;
+    const ulint added = info->n_ahi_rows_added - info->tune_rows_added;
+
+    if (hits * 100 < window * btr_search_min_hit_pct && added > hits) {
+      info->ahi_disabled = true;
+      info->last_hash_succ = FALSE;
+      info->n_hash_potential = 0;
+      info->n_ahi_disabled++;
+      MONITOR_INC(MONITOR_ADAPTIVE_HASH_AUTO_DISABLED);
+    }
+  }
+
+  info->tune_searches = searches;
+  info->tune_hits = info->n_ahi_searches;
+  info->tune_rows_added = info->n_ahi_rows_added;
+}
+
 /** Updates the search info.
 @param[in,out]	info	search info
 @param[in]	cursor	cursor which was just positioned */
@@ -657,6 +724,12 @@ void btr_search_info_update_slow(btr_search_t *info, btr_cur_t *cursor) {
   ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_S));
   ut_ad(!rw_lock_own(btr_get_search_latch(cursor->index), RW_LOCK_X));
 
+  btr_search_tune(info);
+
+  if (info->ahi_disabled) {
+    return;
+  }
+
   block = btr_cur_get_block(cursor);
 
   /* NOTE that the following two function calls do NOT protect
@@ -885,7 +958,7 @@ ibool btr_search_guess_on_hash(dict_index_t *index, btr_search_t *info,
   /* Note that, for efficiency, the struct info may not be protected by
   any latch here! */
 
-  if (info->n_hash_potential == 0) {
+  if (info->n_hash_potential == 0 || info->ahi_disabled) {
     return (FALSE);
   }
 
@@ -1023,6 +1096,7 @@ ibool btr_search_guess_on_hash(dict_index_t *index, btr_search_t *info,
   meanwhile! Thus it might not be a bug. */
 #endif
   info->last_hash_succ = TRUE;
+  info->n_ahi_searches++;
 
 #ifdef UNIV_SEARCH_PERF_STAT
   btr_search_n_succ++;
@@ -1221,6 +1295,7 @@ retry:
   info = btr_search_get_info(block->index);
   ut_a(info->ref_count > 0);
   info->ref_count--;
+  info->n_ahi_rows_removed += n_cached;
 
   block->index = nullptr;
 
@@ -1415,7 +1490,8 @@ static void btr_search_build_page_hash_index(dict_index_t *index,
   ulint offsets_[REC_OFFS_NORMAL_SIZE];
   ulint *offsets = offsets_;
 
-  if (index->disable_ahi || !btr_search_enabled) {
+  if (index->disable_ahi || !btr_search_enabled ||
+      index->search_info->ahi_disabled) {
     return;
   }
 
@@ -1560,6 +1636,8 @@ static void btr_search_build_page_hash_index(dict_index_t *index,
     ha_insert_for_fold(table, folds[i], block, recs[i]);
   }
 
+  index->search_info->n_ahi_rows_added += n_cached;
+
   MONITOR_INC(MONITOR_ADAPTIVE_HASH_PAGE_ADDED);
   MONITOR_INC_VALUE(MONITOR_ADAPTIVE_HASH_ROW_ADDED, n_cached);
 exit_func:
@@ -34,6 +34,9 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <stdarg.h>
 #include <stdio.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "buf0buf.h"
 #include "buf0dump.h"
@@ -64,6 +67,10 @@ static ibool buf_load_should_start = FALSE;
 
 static ibool buf_load_abort_flag = FALSE;
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t buf_load_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /* Used to temporary store dump info in order to avoid IO while holding
 buffer pool LRU list mutex during dump and also to sort the contents of the
 dump before reading the pages from disk during load.
@@ -359,26 +366,76 @@ static void buf_dump(ibool obey_shutdown) {
   buf_dump_status(STATUS_INFO, "Buffer pool(s) dump completed at %s", now);
 }
 
+/** Pages of the sorted dump a load thread reads at a time. A range never
+spans two tablespaces, so the threads spread over the tablespaces and the
+pages of one range are read in (space, page) order. */
+static const ulint BUF_LOAD_RANGE_PAGES = 4096;
+
+/** Most consecutive pages queued before the I/O handlers are woken. */
+static const ulint BUF_LOAD_MAX_RUN = 64;
+
+/** State shared by the threads of one buffer pool load. */
+struct buf_load_t {
+  /** The sorted dump */
+  const buf_dump_t *dump{nullptr};
+
+  /** Start of every range in dump[], followed by the number of entries */
+  std::vector<ulint> ranges;
+
+  /** Next range to read */
+  std::atomic<ulint> next{0};
+
+  /** Entries of dump[] done, read or skipped */
+  std::atomic<ulint> n_done{0};
+
+  /** Pages read, the count the throttling is based on */
+  std::atomic<ulint> n_io{0};
+
+  /** Threads that have finished */
+  std::atomic<ulint> n_finished{0};
+
+  /** Set on abort and on shutdown: the threads stop reading */
+  std::atomic<bool> stop{false};
+
+  /** Held by the thread that sleeps to throttle the load, protects
+  last_check_time and last_activity_count */
+  std::mutex throttle_mutex;
+
+  /** A thread sleeps holding throttle_mutex: the others wait for it */
+  std::atomic<bool> throttling{false};
+
+  ib_time_monotonic_ms_t last_check_time{0};
+  ulint last_activity_count{0};
+};
+
 /** Artificially delay the buffer pool loading if necessary. The idea of this
 function is to prevent hogging the server with IO and slowing down too much
-normal client queries.
-@param[in,out]	last_check_time		milliseconds since epoch of the last
-                                        time we did check if throttling is
-                                        needed, we do the check every
-                                        srv_io_capacity IO ops.
-@param[in]	last_activity_count	activity count
-@param[in]	n_io			number of IO ops done since buffer
-                                        pool load has started */
-UNIV_INLINE
-void buf_load_throttle_if_needed(ib_time_monotonic_ms_t *last_check_time,
-                                 ulint *last_activity_count, ulint n_io) {
+normal client queries. Nothing is delayed with
+innodb_buffer_pool_load_throttle=OFF.
+@param[in,out]	load	the load, its last_check_time is the time we did
+                        check if throttling is needed, we do the check every
+                        srv_io_capacity IO ops
+@param[in]	n_io	number of IO ops done since buffer pool load has
+                        started */
+static void buf_load_throttle_if_needed(buf_load_t *load, ulint n_io) {
+  if (!srv_buffer_pool_load_throttle) {
+    return;
+  }
+
+  if (load->throttling.load()) {
+    /* Another thread sleeps for all of them */
+    std::lock_guard<std::mutex> wait(load->throttle_mutex);
+  }
+
   if (n_io % srv_io_capacity < srv_io_capacity - 1) {
     return;
   }
 
-  if (*last_check_time == 0 || *last_activity_count == 0) {
-    *last_check_time = ut_time_monotonic_ms();
-    *last_activity_count = srv_get_activity_count();
+  std::lock_guard<std::mutex> guard(load->throttle_mutex);
+
+  if (load->last_check_time == 0 || load->last_activity_count == 0) {
+    load->last_check_time = ut_time_monotonic_ms();
+    load->last_activity_count = srv_get_activity_count();
     return;
   }
 
@@ -386,14 +443,14 @@ void buf_load_throttle_if_needed(ib_time_monotonic_ms_t *last_check_time,
   load since the last time we were here. */
 
   /* If no other activity, then keep going without any delay. */
-  if (srv_get_activity_count() == *last_activity_count) {
+  if (srv_get_activity_count() == load->last_activity_count) {
     return;
   }
 
   /* There has been other activity, throttle. */
 
   const auto now = ut_time_monotonic_ms();
-  const auto elapsed_time = now - *last_check_time;
+  const auto elapsed_time = now - load->last_check_time;
 
   /* Notice that elapsed_time is not the time for the last
   srv_io_capacity IO operations performed by BP load. It is the
@@ -415,11 +472,72 @@ void buf_load_throttle_if_needed(ib_time_monotonic_ms_t *last_check_time,
   ut_time_monotonic_ms() that often may turn out to be too expensive. */
 
   if (elapsed_time < 1000 /* 1 sec (1000 milli secs) */) {
+    load->throttling.store(true);
     std::this_thread::sleep_for(std::chrono::milliseconds(1000 - elapsed_time));
+    load->throttling.store(false);
+  }
+
+  load->last_check_time = ut_time_monotonic_ms();
+  load->last_activity_count = srv_get_activity_count();
+}
+
+/** Read the pages of the ranges of the dump, taking the next range until
+none is left or the load is stopped.
+@param[in,out]	load	the load */
+static void buf_load_worker(buf_load_t *load) {
+  for (;;) {
+    const ulint r = load->next.fetch_add(1);
+
+    if (r + 1 >= load->ranges.size() || load->stop.load()) {
+      break;
+    }
+
+    const ulint first = load->ranges[r];
+    const ulint last = load->ranges[r + 1];
+
+    /* Avoid calling the expensive fil_space_acquire_silent() for each
+    page: all pages of a range are of the same tablespace. */
+    const space_id_t space_id = BUF_DUMP_SPACE(load->dump[first]);
+    fil_space_t *space = fil_space_acquire_silent(space_id);
+
+    if (space == nullptr) {
+      load->n_done.fetch_add(last - first);
+      continue;
+    }
+
+    const page_size_t page_size(space->flags);
+    ulint run = 0;
+
+    for (ulint i = first; i < last; i++) {
+      if (load->stop.load() || SHUTTING_DOWN()) {
+        load->stop.store(true);
+        break;
+      }
+
+      const page_no_t page_no = BUF_DUMP_PAGE(load->dump[i]);
+
+      buf_read_page_background(page_id_t(space_id, page_no), page_size, true);
+
+      /* Queue a run of consecutive pages before waking the I/O
+      handlers, so that they can issue it as one sequential read. */
+      if (++run == BUF_LOAD_MAX_RUN || i + 1 == last ||
+          BUF_DUMP_PAGE(load->dump[i + 1]) != page_no + 1) {
+        os_aio_simulated_wake_handler_threads();
+        run = 0;
+      }
+
+      load->n_done.fetch_add(1);
+      buf_load_throttle_if_needed(load, load->n_io.fetch_add(1));
+    }
+
+    if (run > 0) {
+      os_aio_simulated_wake_handler_threads();
+    }
+
+    fil_space_release(space);
   }
 
-  *last_check_time = ut_time_monotonic_ms();
-  *last_activity_count = srv_get_activity_count();
+  load->n_finished.fetch_add(1);
 }
 
 /** Perform a buffer pool load from the file specified by
@@ -562,15 +680,23 @@ static void buf_load() {
     std::sort(dump, dump + dump_n);
   }
 
-  ib_time_monotonic_ms_t last_check_time = 0;
-  ulint last_activity_cnt = 0;
+  /* Cut dump[] into ranges of one tablespace each for the load
+  threads. */
+  buf_load_t load;
+  load.dump = dump;
+  load.ranges.push_back(0);
 
-  /* Avoid calling the expensive fil_space_acquire_silent() for each
-  page within the same tablespace. dump[] is sorted by (space, page),
-  so all pages from a given tablespace are consecutive. */
-  space_id_t cur_space_id = BUF_DUMP_SPACE(dump[0]);
-  fil_space_t *space = fil_space_acquire_silent(cur_space_id);
-  page_size_t page_size(space ? space->flags : 0);
+  for (i = 1; i < dump_n; i++) {
+    if (BUF_DUMP_SPACE(dump[i]) != BUF_DUMP_SPACE(dump[i - 1]) ||
+        i - load.ranges.back() >= BUF_LOAD_RANGE_PAGES) {
+      load.ranges.push_back(i);
+    }
+  }
+
+  load.ranges.push_back(dump_n);
+
+  const ulint n_threads =
+      std::min<ulint>(srv_buffer_pool_load_threads, load.ranges.size() - 1);
 
 #ifdef HAVE_PSI_STAGE_INTERFACE
   PSI_stage_progress *pfs_stage_progress =
@@ -580,73 +706,57 @@ static void buf_load() {
   mysql_stage_set_work_estimated(pfs_stage_progress, dump_n);
   mysql_stage_set_work_completed(pfs_stage_progress, 0);
 
-  for (i = 0; i < dump_n && !SHUTTING_DOWN(); i++) {
-    /* space_id for this iteration of the loop */
-    const space_id_t this_space_id = BUF_DUMP_SPACE(dump[i]);
+  std::vector<IB_thread> workers;
 
-    if (this_space_id != cur_space_id) {
-      if (space != nullptr) {
-        fil_space_release(space);
-      }
-
-      cur_space_id = this_space_id;
-      space = fil_space_acquire_silent(cur_space_id);
-
-      if (space != nullptr) {
-        const page_size_t cur_page_size(space->flags);
-        page_size.copy_from(cur_page_size);
-      }
-    }
+  for (ulint t = 0; t < n_threads; t++) {
+    workers.push_back(
+        os_thread_create(buf_load_thread_key, buf_load_worker, &load));
+    workers.back().start();
+  }
 
-    if (space == nullptr) {
-      continue;
-    }
+  /* This thread only reports the progress and passes an abort on. */
+  bool aborted = false;
 
-    buf_read_page_background(page_id_t(this_space_id, BUF_DUMP_PAGE(dump[i])),
-                             page_size, true);
+  while (load.n_finished.load() < n_threads) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
-    if (i % 64 == 63) {
-      os_aio_simulated_wake_handler_threads();
-    }
+    const ulint n_done = load.n_done.load();
 
-    /* Update the progress every 32 MiB, which is every Nth page,
-    where N = 32*1024^2 / page_size. */
-    static const ulint update_status_every_n_mb = 32;
-    static const ulint update_status_every_n_pages =
-        update_status_every_n_mb * 1024 * 1024 / page_size.physical();
+    buf_load_status(STATUS_VERBOSE, "Loaded " ULINTPF "/" ULINTPF " pages",
+                    n_done, dump_n);
+    mysql_stage_set_work_completed(pfs_stage_progress, n_done);
 
-    if (i % update_status_every_n_pages == 0) {
-      buf_load_status(STATUS_VERBOSE, "Loaded " ULINTPF "/" ULINTPF " pages",
-                      i + 1, dump_n);
-      mysql_stage_set_work_completed(pfs_stage_progress, i);
+    if (!aborted && buf_load_abort_flag) {
+      aborted = true;
+      load.stop.store(true);
     }
 
-    if (buf_load_abort_flag) {
-      if (space != nullptr) {
-        fil_space_release(space);
-      }
-      buf_load_abort_flag = FALSE;
-      ut_free(dump);
-      buf_load_status(STATUS_INFO, "Buffer pool(s) load aborted on request");
-      /* Premature end, set estimated = completed = i and
-      end the current stage event. */
-      mysql_stage_set_work_estimated(pfs_stage_progress, i);
-      mysql_stage_set_work_completed(pfs_stage_progress, i);
-#ifdef HAVE_PSI_STAGE_INTERFACE
-      mysql_end_stage();
-#endif /* HAVE_PSI_STAGE_INTERFACE */
-      return;
+    if (SHUTTING_DOWN()) {
+      load.stop.store(true);
     }
-
-    buf_load_throttle_if_needed(&last_check_time, &last_activity_cnt, i);
   }
 
-  if (space != nullptr) {
-    fil_space_release(space);
+  for (auto &worker : workers) {
+    worker.join();
   }
 
   ut_free(dump);
 
+  if (aborted) {
+    const ulint n_done = load.n_done.load();
+
+    buf_load_abort_flag = FALSE;
+    buf_load_status(STATUS_INFO, "Buffer pool(s) load aborted on request");
+    /* Premature end, set estimated = completed = n_done and
+    end the current stage event. */
+    mysql_stage_set_work_estimated(pfs_stage_progress, n_done);
+    mysql_stage_set_work_completed(pfs_stage_progress, n_done);
+#ifdef HAVE_PSI_STAGE_INTERFACE
+    mysql_end_stage();
+#endif /* HAVE_PSI_STAGE_INTERFACE */
+    return;
+  }
+
   ut_sprintf_timestamp(now);
 
   buf_load_status(STATUS_INFO, "Buffer pool(s) load completed at %s", now);
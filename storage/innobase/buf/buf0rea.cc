@@ -570,6 +570,51 @@ ulint buf_read_ahead_linear(const page_id_t &page_id,
   return (count);
 }
 
+ulint buf_read_ahead_logical(space_id_t space_id,
+                             const page_size_t &page_size,
+                             const page_no_t *page_nos, ulint n_pages) {
+  if (srv_startup_is_before_trx_rollback_phase || n_pages == 0) {
+    return (0);
+  }
+
+  ulint count = 0;
+
+  os_aio_simulated_put_read_threads_to_sleep();
+
+  for (ulint i = 0; i < n_pages; ++i) {
+    const page_id_t page_id(space_id, page_nos[i]);
+    buf_pool_t *buf_pool = buf_pool_get(page_id);
+
+    if (buf_pool->n_pend_reads >
+        buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT) {
+      break;
+    }
+
+    dberr_t err;
+    const ulint n = buf_read_page_low(
+        &err, false, IORequest::DO_NOT_WAKE | IORequest::IGNORE_MISSING,
+        BUF_READ_ANY_PAGE, page_id, page_size, false);
+
+    if (err == DB_TABLESPACE_DELETED) {
+      break;
+    }
+
+    buf_pool->stat.n_ra_pages_read += n;
+    count += n;
+  }
+
+  os_aio_simulated_wake_handler_threads();
+
+  if (count) {
+    DBUG_PRINT("ib_buf", ("logical read-ahead %lu pages, space " UINT32PF,
+                          count, space_id));
+
+    buf_LRU_stat_inc_io();
+  }
+
+  return (count);
+}
+
 void buf_read_ibuf_merge_pages(bool sync, const space_id_t *space_ids,
                                const page_no_t *page_nos, ulint n_stored) {
 #ifdef UNIV_IBUF_DEBUG
@@ -127,11 +127,24 @@ static void create_status_file(const Clone_Handle *clone) {
   file_name.append(CLONE_INNODB_IN_PROGRESS_FILE);
 
   create_file(file_name);
+
+  /* The base of incremental clone is no longer valid once we start
+  modifying the directory. */
+  if (clone->is_incremental()) {
+    file_name.assign(path);
+    if (file_name.back() != OS_PATH_SEPARATOR) {
+      file_name.append(OS_PATH_SEPARATOR_STR);
+    }
+    file_name.append(CLONE_INNODB_INCREMENTAL_FILE);
+    if (file_exists(file_name)) {
+      remove_file(file_name);
+    }
+  }
 }
 
 /** Drop clone in progress file and error file.
 @param[in]	clone	clone handle */
-static void drop_status_file(const Clone_Handle *clone) {
+static void drop_status_file(Clone_Handle *clone) {
   const char *path = clone->get_datadir();
   std::string file_name;
 
@@ -167,6 +180,9 @@ static void drop_status_file(const Clone_Handle *clone) {
   file_name.append(CLONE_INNODB_REPLACED_FILES);
   create_file(file_name);
 
+  /* Save base for later incremental clone into the same directory. */
+  clone->write_incremental_base();
+
   /* Mark successful clone operation. */
   file_name.assign(path_name);
   file_name.append(CLONE_INNODB_IN_PROGRESS_FILE);
@@ -1524,6 +1540,13 @@ dberr_t clone_init() {
     return (DB_ABORT_INCOMPLETE_CLONE);
   }
 
+  /* Server is starting on the cloned directory and would modify it. It can
+  no longer be the base for an incremental clone. */
+  std::string incremental_file(CLONE_INNODB_INCREMENTAL_FILE);
+  if (file_exists(incremental_file)) {
+    remove_file(incremental_file);
+  }
+
   /* Initialize clone files before starting recovery. */
   clone_files_recovery(false);
 
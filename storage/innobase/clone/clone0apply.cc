@@ -253,6 +253,13 @@ int Clone_Snapshot::handle_existing_file(bool replace,
   /* Nothing to do if file doesn't exist */
   if (type == OS_FILE_TYPE_MISSING) {
     int err = 0;
+    /* Incremental clone expects the unchanged file from earlier clone. */
+    if (!replace && file_desc->m_incremental) {
+      char errbuf[MYSYS_STRERROR_SIZE];
+      my_error(ER_CANT_OPEN_FILE, MYF(0), file_name.c_str(), ENOENT,
+               my_strerror(errbuf, sizeof(errbuf), ENOENT));
+      return (ER_CANT_OPEN_FILE);
+    }
     if (replace) {
       /* Add file to new file list to enable rollback. */
       err = clone_add_to_list_file(CLONE_INNODB_NEW_FILES,
@@ -272,6 +279,11 @@ int Clone_Snapshot::handle_existing_file(bool replace,
 
   ut_a(type == OS_FILE_TYPE_FILE);
 
+  /* Incremental clone updates the files of earlier clone in place. */
+  if (!replace && is_incremental()) {
+    return (0);
+  }
+
   /* For cloning to different data directory, we must ensure that the
   file is not present. This would always fail for local clone. */
   if (!replace) {
@@ -1216,6 +1228,11 @@ int Clone_Snapshot::extend_and_flush_files(bool flush_redo) {
     if (file_size < file_meta->m_file_size) {
       success = os_file_set_size(file_meta->m_file_name, file, file_size,
                                  file_meta->m_file_size, false, true);
+    } else if (!flush_redo && is_incremental() &&
+               file_size > file_meta->m_file_size) {
+      /* File from earlier clone could be larger than donor file now. */
+      success = os_file_truncate(file_meta->m_file_name, file,
+                                 file_meta->m_file_size);
     } else {
       success = os_file_flush(file);
     }
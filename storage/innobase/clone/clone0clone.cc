@@ -30,6 +30,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
  *******************************************************/
 
 #include "clone0clone.h"
+#include <fstream>
 #include <string>
 #ifdef UNIV_DEBUG
 #include "current_thd.h" /* current_thd */
@@ -1825,6 +1826,8 @@ Clone_Handle::Clone_Handle(Clone_Handle_Type handle_type, uint clone_version,
       m_ref_count(),
       m_allow_restart(false),
       m_clone_dir(),
+      m_incremental_lsn(),
+      m_incremental_space_id(),
       m_clone_task_manager() {
   mutex_create(LATCH_ID_CLONE_TASK, m_clone_task_manager.get_mutex());
 
@@ -1866,7 +1869,9 @@ int Clone_Handle::create_clone_directory() {
       file_name.append(OS_PATH_SEPARATOR_STR);
       if (status) {
         file_name.append("mysql");
-        status = os_file_create_directory(file_name.c_str(), true);
+        /* Schema directory is already there for incremental clone. */
+        status =
+            os_file_create_directory(file_name.c_str(), !is_incremental());
       }
       if (!status) {
         db_err = DB_ERROR;
@@ -1920,12 +1925,41 @@ int Clone_Handle::init(const byte *ref_loc, uint ref_len, Ha_clone_type type,
       my_error(ER_CLONE_TOO_MANY_CONCURRENT_CLONES, MYF(0), MAX_CLONES);
       return (ER_CLONE_TOO_MANY_CONCURRENT_CLONES);
     }
+    /* Existing data directory must be the base for incremental clone. */
+    if (data_dir != nullptr) {
+      auto err = read_incremental_base();
+      if (err != 0) {
+        return (err);
+      }
+    }
+
     /* Return keeping the clone in INIT state. The locator
-    would only have the version information. */
+    would only have the version information along with the
+    incremental clone base, if any. */
     if (ref_loc == nullptr) {
+      if (is_incremental()) {
+        Clone_Desc_Locator loc_desc;
+        loc_desc.init(0, 0, CLONE_SNAPSHOT_NONE, m_clone_desc_version,
+                      m_clone_arr_index);
+        loc_desc.m_incremental_lsn = m_incremental_lsn;
+        loc_desc.m_incremental_space_id = m_incremental_space_id;
+
+        auto loc = &m_version_locator[0];
+        uint len = CLONE_DESC_MAX_BASE_LEN;
+
+        loc_desc.serialize(loc, len, nullptr, nullptr);
+      }
       return (0);
     }
 
+    /* Donor must understand incremental clone base sent in locator. */
+    if (is_incremental() &&
+        m_clone_desc_version < CLONE_DESC_INCREMENTAL_VERSION) {
+      my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+               "incremental clone from donor of older version");
+      return (ER_NOT_SUPPORTED_YET);
+    }
+
     auto err = create_clone_directory();
     if (err != 0) {
       return (err);
@@ -1952,6 +1986,23 @@ int Clone_Handle::init(const byte *ref_loc, uint ref_len, Ha_clone_type type,
     return (err);
   }
 
+  /* Recipient sends the base of incremental clone in locator. */
+  if (is_copy_clone() && ref_loc != nullptr) {
+    Clone_Desc_Locator loc_desc;
+
+    loc_desc.deserialize(ref_loc, ref_len, nullptr);
+
+    m_incremental_lsn = loc_desc.m_incremental_lsn;
+    m_incremental_space_id = loc_desc.m_incremental_space_id;
+  }
+
+  if (is_incremental()) {
+    ib::info(ER_IB_CLONE_OPERATION)
+        << "Clone incremental from base LSN: " << m_incremental_lsn
+        << " tablespace ID: " << m_incremental_space_id;
+    snapshot->set_incremental_base(m_incremental_lsn, m_incremental_space_id);
+  }
+
   /* Initialize clone task manager. */
   m_clone_task_manager.init(snapshot);
 
@@ -1960,6 +2011,92 @@ int Clone_Handle::init(const byte *ref_loc, uint ref_len, Ha_clone_type type,
   return (0);
 }
 
+int Clone_Handle::read_incremental_base() {
+  ut_ad(!is_copy_clone());
+  ut_ad(m_clone_dir != nullptr);
+
+  bool exists = false;
+  os_file_type_t type;
+
+  auto status = os_file_status(m_clone_dir, &exists, &type);
+
+  /* Full clone into a new directory. */
+  if (!status || !exists) {
+    return (0);
+  }
+
+  std::string file_name(m_clone_dir);
+
+  if (file_name.back() != OS_PATH_SEPARATOR) {
+    file_name.append(OS_PATH_SEPARATOR_STR);
+  }
+  file_name.append(CLONE_INNODB_INCREMENTAL_FILE);
+
+  std::ifstream base_file;
+  base_file.open(file_name);
+
+  lsn_t base_lsn = 0;
+  space_id_t base_space_id = 0;
+
+  if (base_file.is_open()) {
+    base_file >> base_lsn >> base_space_id;
+
+    if (base_file.fail()) {
+      base_lsn = 0;
+    }
+    base_file.close();
+  }
+
+  /* The directory is not an unmodified output of an earlier clone. */
+  if (base_lsn == 0) {
+    my_error(ER_DB_CREATE_EXISTS, MYF(0), m_clone_dir);
+    return (ER_DB_CREATE_EXISTS);
+  }
+
+  m_incremental_lsn = base_lsn;
+  m_incremental_space_id = base_space_id;
+
+  return (0);
+}
+
+void Clone_Handle::write_incremental_base() {
+  ut_ad(!is_copy_clone());
+
+  if (replace_datadir()) {
+    return;
+  }
+
+  lsn_t track_lsn;
+  space_id_t track_space_id;
+
+  auto snapshot = m_clone_task_manager.get_snapshot();
+  snapshot->get_track_position(track_lsn, track_space_id);
+
+  /* Donor didn't track pages: no base for incremental clone. */
+  if (track_lsn == 0) {
+    return;
+  }
+
+  std::string file_name(m_clone_dir);
+
+  if (file_name.back() != OS_PATH_SEPARATOR) {
+    file_name.append(OS_PATH_SEPARATOR_STR);
+  }
+  file_name.append(CLONE_INNODB_INCREMENTAL_FILE);
+
+  std::ofstream base_file;
+  base_file.open(file_name, std::ofstream::out | std::ofstream::trunc);
+
+  if (!base_file.is_open()) {
+    ib::warn(ER_IB_CLONE_STATUS_FILE)
+        << "Could not create file : " << file_name.c_str();
+    return;
+  }
+
+  base_file << track_lsn << " " << track_space_id << std::endl;
+  base_file.close();
+}
+
 byte *Clone_Handle::get_locator(uint &loc_len) {
   Clone_Desc_Locator loc_desc;
 
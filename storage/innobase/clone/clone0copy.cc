@@ -86,6 +86,17 @@ static int add_page_callback(void *context, byte *buff, uint num_pages) {
   return (0);
 }
 
+/** Callback to add page IDs fetched from page archiver for a LSN range
+@param[in]	buff		buffer having page IDs
+@param[in]	num_pages	number of tracked pages
+@param[in]	context		snapshot
+@return	error code */
+static int add_tracked_page_callback(MYSQL_THD, const unsigned char *buff,
+                                     size_t, int num_pages, void *context) {
+  return (add_page_callback(context, const_cast<byte *>(buff),
+                            static_cast<uint>(num_pages)));
+}
+
 int Clone_Snapshot::add_buf_pool_file() {
   char path[OS_FILE_MAX_PATH];
   /* Generate the file name. */
@@ -151,8 +162,13 @@ int Clone_Snapshot::init_file_copy() {
 
   } else if (m_snapshot_type == HA_CLONE_HYBRID ||
              m_snapshot_type == HA_CLONE_PAGE) {
+    /* Note the tablespace ID before tracking starts. Any tablespace created
+    later gets a bigger ID and must be copied in full by incremental clone
+    based on this snapshot. */
+    m_track_space_id = fil_get_max_space_id();
+
     /* Start modified Page ID Archiving */
-    err = m_page_ctx.start(false, nullptr);
+    err = m_page_ctx.start(false, &m_track_lsn);
   } else {
     ut_ad(m_snapshot_type == HA_CLONE_BLOCKING);
   }
@@ -161,6 +177,32 @@ int Clone_Snapshot::init_file_copy() {
     return (err);
   }
 
+  /* Incremental clone needs the pages modified since the base clone. Check
+  early that the page tracking covers the range. */
+  if (is_incremental()) {
+    lsn_t start_lsn = m_incremental_lsn;
+    lsn_t stop_lsn = 0;
+    uint64_t num_pages = 0;
+
+    if (m_snapshot_type == HA_CLONE_HYBRID) {
+      err = arch_page_sys->get_num_pages(start_lsn, stop_lsn, &num_pages);
+    } else {
+      err = ER_PAGE_TRACKING_RANGE_NOT_TRACKED;
+    }
+
+    if (err != 0) {
+      ib::info(ER_IB_CLONE_OPERATION)
+          << "Clone incremental base LSN " << m_incremental_lsn
+          << " is not covered by page tracking";
+      my_error(ER_PAGE_TRACKING_RANGE_NOT_TRACKED, MYF(0));
+      return (ER_PAGE_TRACKING_RANGE_NOT_TRACKED);
+    }
+
+    ib::info(ER_IB_CLONE_OPERATION)
+        << "Clone State FILE COPY : incremental from LSN " << start_lsn
+        << ", approximately " << num_pages << " modified pages";
+  }
+
   /* Initialize estimation about on disk bytes. */
   init_disk_estimate();
 
@@ -237,6 +279,20 @@ int Clone_Snapshot::init_page_copy(byte *page_buffer, uint page_buffer_len) {
   err = m_page_ctx.get_pages(add_page_callback, context, page_buffer,
                              page_buffer_len);
 
+  /* For incremental clone, also add pages modified after the base clone
+  started tracking till this snapshot started tracking. */
+  if (err == 0 && is_incremental()) {
+    lsn_t start_lsn = m_incremental_lsn;
+    lsn_t stop_lsn = m_track_lsn;
+
+    err = arch_page_sys->get_pages(nullptr, add_tracked_page_callback, context,
+                                   start_lsn, stop_lsn, page_buffer,
+                                   page_buffer_len);
+    if (err != 0) {
+      my_error(ER_PAGE_TRACKING_RANGE_NOT_TRACKED, MYF(0));
+    }
+  }
+
   m_page_vector.assign(m_page_set.begin(), m_page_set.end());
 
   aligned_size = ut_calc_align(m_num_pages, chunk_size());
@@ -490,6 +546,8 @@ Clone_File_Meta *Clone_Snapshot::build_file(const char *file_name,
     return (file_meta);
   }
 
+  file_meta->m_incremental = false;
+
   /* For redo file with no data, add dummy entry. */
   if (file_name == nullptr) {
     num_chunks = 1;
@@ -606,6 +664,14 @@ int Clone_Snapshot::add_file(const char *name, uint64_t size_bytes,
     }
   }
 
+  /* Tablespace present in the base of incremental clone. The file data is
+  not transferred and the modified pages are sent during page copy. */
+  if (node != nullptr && keeps_file(node->space->id)) {
+    file_meta->m_incremental = true;
+    file_meta->m_end_chunk = file_meta->m_begin_chunk - 1;
+    num_chunks = 0;
+  }
+
   file_meta->m_file_index = m_num_data_files;
 
   m_data_file_vector.push_back(file_meta);
@@ -671,9 +737,12 @@ dberr_t Clone_Snapshot::add_node(fil_node_t *node) {
     return (DB_ERROR);
   }
 
-  /* Update estimation */
-  m_data_bytes_disk += alloc_size;
-  m_monitor.add_estimate(size_bytes);
+  /* Update estimation. File already present in the base of incremental
+  clone is not transferred. */
+  if (!keeps_file(space->id)) {
+    m_data_bytes_disk += alloc_size;
+    m_monitor.add_estimate(size_bytes);
+  }
 
   /* Add file to snapshot. */
   auto err = add_file(node->name, size_bytes, alloc_size, node, false);
@@ -691,26 +760,18 @@ dberr_t Clone_Snapshot::add_node(fil_node_t *node) {
 }
 
 int Clone_Snapshot::add_page(space_id_t space_id, ib_uint32_t page_num) {
-  /* Skip pages belonging to tablespace not included for clone. This could
-  be some left over pages from drop or truncate in buffer pool which
-  would eventually get removed. Or it may be a page for an undo tablespace
-  that was deleted with BUF_REMOVE_NONE. */
-  auto count = m_data_file_map.count(space_id);
-  if (count == 0) {
-    return (0);
-  }
-
-  Clone_Page cur_page;
-  cur_page.m_space_id = space_id;
-  cur_page.m_page_no = page_num;
+  switch (clone_add_page(m_data_file_map, m_page_set, space_id, page_num)) {
+    case CLONE_PAGE_ADDED:
+      m_num_pages++;
+      m_monitor.add_estimate(UNIV_PAGE_SIZE);
+      break;
 
-  auto result = m_page_set.insert(cur_page);
+    case CLONE_PAGE_DUPLICATE:
+      m_num_duplicate_pages++;
+      break;
 
-  if (result.second) {
-    m_num_pages++;
-    m_monitor.add_estimate(UNIV_PAGE_SIZE);
-  } else {
-    m_num_duplicate_pages++;
+    case CLONE_PAGE_SKIPPED:
+      break;
   }
 
   return (0);
@@ -34,7 +34,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 /** Maximum supported descriptor version. The version represents the current
 set of descriptors and its elements. */
-static const uint CLONE_DESC_MAX_VERSION = 100;
+static const uint CLONE_DESC_MAX_VERSION = CLONE_DESC_INCREMENTAL_VERSION;
 
 /** Header: Version is in first 4 bytes */
 static const uint CLONE_DESC_VER_OFFSET = 0;
@@ -163,6 +163,23 @@ static const uint CLONE_LOC_META_OFFSET = CLONE_LOC_STATE_OFFSET + 1;
 /** Locator: Total length */
 static const uint CLONE_DESC_LOC_BASE_LEN = CLONE_LOC_META_OFFSET + 1;
 
+/** Locator: Incremental clone base LSN in 8 bytes */
+static const uint CLONE_LOC_INCR_LSN_OFFSET = CLONE_DESC_LOC_BASE_LEN;
+
+/** Locator: Incremental clone base tablespace ID in 4 bytes */
+static const uint CLONE_LOC_INCR_SPACE_OFFSET = CLONE_LOC_INCR_LSN_OFFSET + 8;
+
+/** Locator: Total length with incremental clone information */
+static const uint CLONE_DESC_LOC_INCR_LEN = CLONE_LOC_INCR_SPACE_OFFSET + 4;
+
+/** Get fixed length of serialized locator for a descriptor version.
+@param[in]	version	descriptor version
+@return locator length excluding chunk information */
+static uint locator_base_length(uint version) {
+  return (version >= CLONE_DESC_INCREMENTAL_VERSION ? CLONE_DESC_LOC_INCR_LEN
+                                                     : CLONE_DESC_LOC_BASE_LEN);
+}
+
 uint32_t *Chnunk_Bitmap::reset(uint32_t max_bits, mem_heap_t *heap) {
   m_bits = max_bits;
 
@@ -473,7 +490,7 @@ void Clone_Desc_Locator::init(ib_uint64_t id, ib_uint64_t snap_id,
                               Snapshot_State state, uint version, uint index) {
   m_header.m_version = version;
 
-  m_header.m_length = CLONE_DESC_LOC_BASE_LEN;
+  m_header.m_length = locator_base_length(version);
 
   m_header.m_type = CLONE_DESC_LOCATOR;
 
@@ -483,6 +500,9 @@ void Clone_Desc_Locator::init(ib_uint64_t id, ib_uint64_t snap_id,
   m_clone_index = index;
   m_state = state;
   m_metadata_transferred = false;
+
+  m_incremental_lsn = 0;
+  m_incremental_space_id = 0;
 }
 
 bool Clone_Desc_Locator::match(Clone_Desc_Locator *other_desc) {
@@ -529,12 +549,20 @@ void Clone_Desc_Locator::serialize(byte *&desc_loc, uint &len,
 
   mach_write_to_1(desc_loc + CLONE_LOC_META_OFFSET, sub_state);
 
+  auto base_len = locator_base_length(m_header.m_version);
+
+  if (base_len > CLONE_DESC_LOC_BASE_LEN) {
+    mach_write_to_8(desc_loc + CLONE_LOC_INCR_LSN_OFFSET, m_incremental_lsn);
+    mach_write_to_4(desc_loc + CLONE_LOC_INCR_SPACE_OFFSET,
+                    m_incremental_space_id);
+  }
+
   if (chunk_info != nullptr) {
-    ut_ad(len > CLONE_DESC_LOC_BASE_LEN);
+    ut_ad(len > base_len);
 
-    auto len_left = len - CLONE_DESC_LOC_BASE_LEN;
+    auto len_left = len - base_len;
 
-    chunk_info->serialize(desc_loc + CLONE_DESC_LOC_BASE_LEN, len_left);
+    chunk_info->serialize(desc_loc + base_len, len_left);
   }
 }
 
@@ -545,9 +573,10 @@ bool clone_validate_locator(const byte *desc_loc, uint desc_len) {
     ut_ad(false);
     return (false);
   }
-  if (desc_len < CLONE_DESC_LOC_BASE_LEN ||
-      header.m_length < CLONE_DESC_LOC_BASE_LEN || header.m_length > desc_len ||
-      header.m_type != CLONE_DESC_LOCATOR) {
+  auto base_len = locator_base_length(header.m_version);
+
+  if (desc_len < base_len || header.m_length < base_len ||
+      header.m_length > desc_len || header.m_type != CLONE_DESC_LOCATOR) {
     ut_ad(false);
     return (false);
   }
@@ -577,12 +606,26 @@ void Clone_Desc_Locator::deserialize(const byte *desc_loc, uint desc_len,
   auto sub_state = mach_read_from_1(desc_loc + CLONE_LOC_META_OFFSET);
   m_metadata_transferred = (sub_state == 0) ? false : true;
 
-  ut_ad(m_header.m_length >= CLONE_DESC_LOC_BASE_LEN);
+  auto base_len = locator_base_length(m_header.m_version);
+
+  m_incremental_lsn = 0;
+  m_incremental_space_id = 0;
 
-  auto len_left = m_header.m_length - CLONE_DESC_LOC_BASE_LEN;
+  if (base_len > m_header.m_length) {
+    ut_ad(false);
+    return;
+  }
+
+  if (base_len > CLONE_DESC_LOC_BASE_LEN) {
+    m_incremental_lsn = mach_read_from_8(desc_loc + CLONE_LOC_INCR_LSN_OFFSET);
+    m_incremental_space_id =
+        mach_read_from_4(desc_loc + CLONE_LOC_INCR_SPACE_OFFSET);
+  }
+
+  auto len_left = m_header.m_length - base_len;
 
   if (chunk_info != nullptr && len_left != 0) {
-    chunk_info->deserialize(desc_loc + CLONE_DESC_LOC_BASE_LEN, len_left);
+    chunk_info->deserialize(desc_loc + base_len, len_left);
   }
 }
 
@@ -624,6 +667,8 @@ static const uint CLONE_DESC_FILE_FLAG_ZLIB = 1;
 static const uint CLONE_DESC_FILE_FLAG_LZ4 = 2;
 /** Clone File Flag: Encryption type AES */
 static const uint CLONE_DESC_FILE_FLAG_AES = 3;
+/** Clone File Flag: Data not transferred, kept from incremental base */
+static const uint CLONE_DESC_FILE_FLAG_INCREMENTAL = 4;
 
 /** File Metadata: Tablespace ID in 4 bytes */
 static const uint CLONE_FILE_SPACE_ID_OFFSET = CLONE_FILE_FLAGS_OFFSET + 2;
@@ -690,6 +735,9 @@ void Clone_Desc_File_MetaData::serialize(byte *&desc_file, uint &len,
   if (m_file_meta.m_encrypt_type == Encryption::AES) {
     DESC_SET_FLAG(file_flags, CLONE_DESC_FILE_FLAG_AES);
   }
+  if (m_file_meta.m_incremental) {
+    DESC_SET_FLAG(file_flags, CLONE_DESC_FILE_FLAG_INCREMENTAL);
+  }
   mach_write_to_2(desc_file + CLONE_FILE_FLAGS_OFFSET, file_flags);
 
   mach_write_to_4(desc_file + CLONE_FILE_SPACE_ID_OFFSET,
@@ -754,6 +802,9 @@ bool Clone_Desc_File_MetaData::deserialize(const byte *desc_file,
     m_file_meta.m_encrypt_type = Encryption::AES;
   }
 
+  m_file_meta.m_incremental =
+      DESC_CHECK_FLAG(file_flags, CLONE_DESC_FILE_FLAG_INCREMENTAL);
+
   m_file_meta.m_space_id =
       mach_read_from_4(desc_file + CLONE_FILE_SPACE_ID_OFFSET);
   m_file_meta.m_file_index =
@@ -814,6 +865,15 @@ static const uint CLONE_DESC_STATE_FLAGS = CLONE_DESC_STATE_EST_DISK + 8;
 /** Clone State: Total length */
 static const uint CLONE_DESC_STATE_LEN = CLONE_DESC_STATE_FLAGS + 2;
 
+/** Clone State: Page tracking start LSN in 8 bytes */
+static const uint CLONE_DESC_STATE_TRACK_LSN = CLONE_DESC_STATE_LEN;
+
+/** Clone State: Maximum tablespace ID at page tracking start in 4 bytes */
+static const uint CLONE_DESC_STATE_TRACK_SPACE = CLONE_DESC_STATE_TRACK_LSN + 8;
+
+/** Clone State: Total length with page tracking information */
+static const uint CLONE_DESC_STATE_INCR_LEN = CLONE_DESC_STATE_TRACK_SPACE + 4;
+
 /** Clone State Flag: Start processing state */
 static const uint CLONE_DESC_STATE_FLAG_START = 1;
 
@@ -823,7 +883,9 @@ static const uint CLONE_DESC_STATE_FLAG_ACK = 2;
 void Clone_Desc_State::init_header(uint version) {
   m_header.m_version = version;
 
-  m_header.m_length = CLONE_DESC_STATE_LEN;
+  m_header.m_length = (version >= CLONE_DESC_INCREMENTAL_VERSION)
+                         ? CLONE_DESC_STATE_INCR_LEN
+                         : CLONE_DESC_STATE_LEN;
 
   m_header.m_type = CLONE_DESC_STATE;
 }
@@ -860,6 +922,12 @@ void Clone_Desc_State::serialize(byte *&desc_state, uint &len,
   }
 
   mach_write_to_2(desc_state + CLONE_DESC_STATE_FLAGS, state_flags);
+
+  if (m_header.m_length >= CLONE_DESC_STATE_INCR_LEN) {
+    mach_write_to_8(desc_state + CLONE_DESC_STATE_TRACK_LSN, m_track_lsn);
+    mach_write_to_4(desc_state + CLONE_DESC_STATE_TRACK_SPACE,
+                    m_track_space_id);
+  }
 }
 
 bool Clone_Desc_State::deserialize(const byte *desc_state, uint desc_len) {
@@ -889,6 +957,17 @@ bool Clone_Desc_State::deserialize(const byte *desc_state, uint desc_len) {
 
   m_is_ack = DESC_CHECK_FLAG(state_flags, CLONE_DESC_STATE_FLAG_ACK);
 
+  m_track_lsn = 0;
+  m_track_space_id = 0;
+
+  if (m_header.m_version >= CLONE_DESC_INCREMENTAL_VERSION &&
+      m_header.m_length >= CLONE_DESC_STATE_INCR_LEN &&
+      desc_len >= CLONE_DESC_STATE_INCR_LEN) {
+    m_track_lsn = mach_read_from_8(desc_state + CLONE_DESC_STATE_TRACK_LSN);
+    m_track_space_id =
+        mach_read_from_4(desc_state + CLONE_DESC_STATE_TRACK_SPACE);
+  }
+
   return (true);
 }
 
@@ -60,6 +60,10 @@ Clone_Snapshot::Clone_Snapshot(Clone_Handle_Type hdl_type,
       m_page_ctx(false),
       m_num_pages(),
       m_num_duplicate_pages(),
+      m_track_lsn(),
+      m_track_space_id(),
+      m_incremental_lsn(),
+      m_incremental_space_id(),
       m_redo_ctx(),
       m_redo_start_offset(),
       m_redo_header(),
@@ -102,6 +106,9 @@ void Clone_Snapshot::get_state_info(bool do_estimate,
   state_desc->m_estimate = 0;
   state_desc->m_estimate_disk = 0;
 
+  state_desc->m_track_lsn = m_track_lsn;
+  state_desc->m_track_space_id = m_track_space_id;
+
   if (do_estimate) {
     state_desc->m_estimate = m_monitor.get_estimate();
     state_desc->m_estimate_disk = m_data_bytes_disk;
@@ -143,6 +150,13 @@ void Clone_Snapshot::set_state_info(Clone_Desc_State *state_desc) {
 
   m_num_current_chunks = state_desc->m_num_chunks;
 
+  /* Page tracking position from donor is the base for next incremental
+  clone into the same data directory. */
+  if (state_desc->m_track_lsn != 0) {
+    m_track_lsn = state_desc->m_track_lsn;
+    m_track_space_id = state_desc->m_track_space_id;
+  }
+
   if (m_snapshot_state == CLONE_SNAPSHOT_FILE_COPY) {
     m_num_data_files = state_desc->m_num_files;
     m_num_data_chunks = state_desc->m_num_chunks;
@@ -34,6 +34,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <mysql_com.h>
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -41,8 +42,11 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "dyn0buf.h"
 #include "ha_prototypes.h"
 #include "lob0lob.h"
+#include "os0thread-create.h"
 #include "pars0pars.h"
+#include "row0pread.h"
 #include "row0sel.h"
+#include "srv0mon.h"
 #include "trx0trx.h"
 #include "univ.i"
 #include "ut0new.h"
@@ -2003,6 +2007,61 @@ static void dict_stats_analyze_index(
   }
 }
 
+/** Analyze indexes of a table, taking them from a shared list until it is
+exhausted or the background statistics of the table are asked to stop.
+@param[in]	indexes	indexes to analyze
+@param[in,out]	next	next entry of indexes to analyze */
+static void dict_stats_analyze_index_worker(
+    const std::vector<dict_index_t *> *indexes, std::atomic<size_t> *next) {
+  for (size_t i = next->fetch_add(1); i < indexes->size();
+       i = next->fetch_add(1)) {
+    dict_index_t *index = (*indexes)[i];
+
+    if (i > 0 && (index->table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
+      continue;
+    }
+
+    dict_stats_analyze_index(index);
+  }
+}
+
+/** Analyze the indexes of a table on up to innodb_stats_sample_threads
+threads. Every index is sampled by one thread; the extra threads are taken
+from the budget of innodb_parallel_read_threads, shared with the
+Parallel_reader scans, and the caller analyzes on its own thread as well.
+The first index, the clustered one, is always analyzed.
+@param[in]	indexes	indexes to analyze, the clustered index first */
+static void dict_stats_analyze_indexes(
+    const std::vector<dict_index_t *> &indexes) {
+  std::atomic<size_t> next{0};
+  size_t n_extra = std::min<size_t>(srv_stats_sample_threads, indexes.size());
+
+  n_extra = n_extra > 1 ? Parallel_reader::available_threads(n_extra - 1) : 0;
+
+  std::vector<IB_thread> threads;
+
+  for (size_t i = 0; i < n_extra; ++i) {
+    try {
+      threads.emplace_back(os_thread_create(dict_stats_sample_thread_key,
+                                            dict_stats_analyze_index_worker,
+                                            &indexes, &next));
+      threads.back().start();
+    } catch (...) {
+      break;
+    }
+  }
+
+  dict_stats_analyze_index_worker(&indexes, &next);
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  if (n_extra > 0) {
+    Parallel_reader::release_threads(n_extra);
+  }
+}
+
 /** Calculates new estimates for table and index statistics. This function
  is relatively slow and is used to calculate persistent statistics that
  will be saved on disk.
@@ -2031,36 +2090,37 @@ static dberr_t dict_stats_update_persistent(
 
   ut_ad(!dict_index_is_ibuf(index));
 
-  dict_stats_analyze_index(index);
+  /* collect the clustered index and the other indexes to analyze */
 
-  ulint n_unique = dict_index_get_n_unique(index);
+  std::vector<dict_index_t *> indexes{index};
 
-  table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
+  for (dict_index_t *other = index->next(); other != nullptr;
+       other = other->next()) {
+    ut_ad(!dict_index_is_ibuf(other));
 
-  table->stat_clustered_index_size = index->stat_index_size;
+    if (other->type & DICT_FTS || dict_index_is_spatial(other)) {
+      continue;
+    }
 
-  /* analyze other indexes from the table, if any */
+    dict_stats_empty_index(other);
 
-  table->stat_sum_of_other_index_sizes = 0;
+    if (!dict_stats_should_ignore_index(other)) {
+      indexes.push_back(other);
+    }
+  }
 
-  for (index = index->next(); index != nullptr; index = index->next()) {
-    ut_ad(!dict_index_is_ibuf(index));
+  dict_stats_analyze_indexes(indexes);
 
-    if (index->type & DICT_FTS || dict_index_is_spatial(index)) {
-      continue;
-    }
+  ulint n_unique = dict_index_get_n_unique(index);
 
-    dict_stats_empty_index(index);
+  table->stat_n_rows = index->stat_n_diff_key_vals[n_unique - 1];
 
-    if (dict_stats_should_ignore_index(index)) {
-      continue;
-    }
+  table->stat_clustered_index_size = index->stat_index_size;
 
-    if (!(table->stats_bg_flag & BG_STAT_SHOULD_QUIT)) {
-      dict_stats_analyze_index(index);
-    }
+  table->stat_sum_of_other_index_sizes = 0;
 
-    table->stat_sum_of_other_index_sizes += index->stat_index_size;
+  for (size_t i = 1; i < indexes.size(); ++i) {
+    table->stat_sum_of_other_index_sizes += indexes[i]->stat_index_size;
   }
 
   table->stats_last_recalc = ut_time_monotonic();
@@ -2813,6 +2873,21 @@ void dict_stats_update_for_index(dict_index_t *index) /*!< in/out: index */
   dict_table_stats_unlock(index->table, RW_X_LATCH);
 }
 
+/** Count a statistics recalculation and the time it took. Recalculations of
+different tables run on several threads, so the time is added atomically.
+@param[in]	count		counter of recalculations
+@param[in]	time		counter of microseconds spent
+@param[in]	start_us	ut_time_monotonic_us() at the start */
+static void dict_stats_count_recalc(monitor_id_t count, monitor_id_t time,
+                                    ib_time_monotonic_us_t start_us) {
+  MONITOR_ATOMIC_INC(count);
+
+  if (MONITOR_IS_ON(time)) {
+    MONITOR_VALUE(time).fetch_add(ut_time_monotonic_us() - start_us,
+                                  std::memory_order_relaxed);
+  }
+}
+
 /** Calculates new estimates for table and index statistics. The statistics
  are used in query optimization.
  @return DB_SUCCESS or error code */
@@ -2864,13 +2939,21 @@ storage */
       persistent stats enabled */
       ut_a(strchr(table->name.m_name, '/') != nullptr);
 
-      err = dict_stats_update_persistent(table);
+      {
+        const auto start_us = ut_time_monotonic_us();
 
-      if (err != DB_SUCCESS) {
-        return (err);
+        err = dict_stats_update_persistent(table);
+
+        if (err == DB_SUCCESS) {
+          err = dict_stats_save(table, nullptr);
+        }
+
+        dict_stats_count_recalc(MONITOR_STATS_RECALC_PERSISTENT,
+                                MONITOR_STATS_RECALC_PERSISTENT_MICROSECOND,
+                                start_us);
       }
 
-      return (dict_stats_save(table, nullptr));
+      return (err);
 
     case DICT_STATS_RECALC_TRANSIENT:
       break;
@@ -2970,12 +3053,18 @@ storage */
       about unhandled enumeration value */
   }
 
+  const auto start_us = ut_time_monotonic_us();
+
   dict_table_stats_lock(table, RW_X_LATCH);
 
   dict_stats_update_transient(table);
 
   dict_table_stats_unlock(table, RW_X_LATCH);
 
+  dict_stats_count_recalc(MONITOR_STATS_RECALC_TRANSIENT,
+                          MONITOR_STATS_RECALC_TRANSIENT_MICROSECOND,
+                          start_us);
+
   return (DB_SUCCESS);
 }
 
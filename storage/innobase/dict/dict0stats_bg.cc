@@ -34,6 +34,8 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <stddef.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "dict0dd.h"
@@ -43,6 +45,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "os0thread-create.h"
 #include "row0mysql.h"
+#include "srv0mon.h"
 #include "srv0start.h"
 #include "ut0new.h"
 
@@ -69,12 +72,26 @@ static ib_mutex_t recalc_pool_mutex;
 it is enlarged */
 static const ulint RECALC_POOL_INITIAL_SLOTS = 128;
 
+/** A table whose stats are to be recalculated */
+struct recalc_entry_t {
+  /** Table id */
+  table_id_t id;
+
+  /** Order of recalculation, higher first, see
+  dict_stats_recalc_priority() */
+  double priority;
+
+  /** The table is not recalculated before this time, so that the stats of
+  a table are not recalculated more often than every MIN_RECALC_INTERVAL */
+  ib_time_monotonic_t not_before;
+};
+
 /** Allocator type, used by std::vector */
-typedef ut_allocator<table_id_t> recalc_pool_allocator_t;
+typedef ut_allocator<recalc_entry_t> recalc_pool_allocator_t;
 
 /** The multitude of tables whose stats are to be automatically
 recalculated - an STL vector */
-typedef std::vector<table_id_t, recalc_pool_allocator_t> recalc_pool_t;
+typedef std::vector<recalc_entry_t, recalc_pool_allocator_t> recalc_pool_t;
 
 /** Iterator type for iterating over the elements of objects of type
 recalc_pool_t. */
@@ -106,59 +123,121 @@ static void dict_stats_recalc_pool_deinit() {
   recalc_pool = nullptr;
 }
 
-/** Add a table to the recalc pool, which is processed by the
- background stats gathering thread. Only the table id is added to the
- list, so the table can be closed after being enqueued and it will be
- opened when needed. If the table does not exist later (has been DROPped),
- then it will be removed from the pool and skipped. */
-void dict_stats_recalc_pool_add(
-    const dict_table_t *table) /*!< in: table to add */
-{
+/** Order in which a table is recalculated: the share of its rows modified
+since the last recalculation, capped at 16 so that tables loaded from empty
+do not all sort alike, weighted by the log of the size of its clustered
+index. After a bulk load this refreshes the tables whose stats are the most
+wrong first, and among those the large ones, whose stale row estimates cost
+the most in query plans. The fields are read without the stats latch, which
+is good enough for ordering.
+@param[in]	table	table to add
+@return priority, higher first */
+static double dict_stats_recalc_priority(const dict_table_t *table) {
+  const double n_rows = static_cast<double>(table->stat_n_rows);
+  const double modified = static_cast<double>(table->stat_modified_counter);
+  const double size = static_cast<double>(table->stat_clustered_index_size);
+
+  return (std::min(modified / (n_rows + 1), 16.0) * std::log2(2 + size));
+}
+
+/** Add a table to the recalc pool, or raise its priority if it is there.
+@param[in]	table		table to add
+@param[in]	not_before	do not recalculate the table before this time */
+static void dict_stats_recalc_pool_add_low(const dict_table_t *table,
+                                           ib_time_monotonic_t not_before) {
   ut_ad(!srv_read_only_mode);
 
+  const double priority = dict_stats_recalc_priority(table);
+
   mutex_enter(&recalc_pool_mutex);
 
-  /* quit if already in the list */
+  /* only update the priority if already in the list */
   for (recalc_pool_iterator_t iter = recalc_pool->begin();
        iter != recalc_pool->end(); ++iter) {
-    if (*iter == table->id) {
+    if (iter->id == table->id) {
+      iter->priority = std::max(iter->priority, priority);
       mutex_exit(&recalc_pool_mutex);
       return;
     }
   }
 
-  recalc_pool->push_back(table->id);
+  recalc_pool->push_back(recalc_entry_t{table->id, priority, not_before});
+
+  MONITOR_SET(MONITOR_STATS_RECALC_POOL, recalc_pool->size());
 
   mutex_exit(&recalc_pool_mutex);
 
   os_event_set(dict_stats_event);
 }
 
-/** Get a table from the auto recalc pool. The returned table id is removed
- from the pool.
- @return true if the pool was non-empty and "id" was set, false otherwise */
+/** Add a table to the recalc pool, which is processed by the
+ background stats gathering threads. Only the table id is added to the
+ list, so the table can be closed after being enqueued and it will be
+ opened when needed. If the table does not exist later (has been DROPped),
+ then it will be removed from the pool and skipped. */
+void dict_stats_recalc_pool_add(
+    const dict_table_t *table) /*!< in: table to add */
+{
+  dict_stats_recalc_pool_add_low(
+      table, table->stats_last_recalc + MIN_RECALC_INTERVAL);
+}
+
+/** Get the table with the highest priority from the auto recalc pool,
+ skipping the tables whose stats were recalculated too recently. The
+ returned table id is removed from the pool.
+ @return true if a table was due and "id" was set, false otherwise */
 static bool dict_stats_recalc_pool_get(
-    table_id_t *id) /*!< out: table id, or unmodified if list is
-                    empty */
+    table_id_t *id) /*!< out: table id, or unmodified if no
+                    table is due */
 {
   ut_ad(!srv_read_only_mode);
 
+  const ib_time_monotonic_t now = ut_time_monotonic();
+
   mutex_enter(&recalc_pool_mutex);
 
-  if (recalc_pool->empty()) {
+  recalc_pool_iterator_t best = recalc_pool->end();
+
+  for (recalc_pool_iterator_t iter = recalc_pool->begin();
+       iter != recalc_pool->end(); ++iter) {
+    if (iter->not_before <= now &&
+        (best == recalc_pool->end() || iter->priority > best->priority)) {
+      best = iter;
+    }
+  }
+
+  if (best == recalc_pool->end()) {
     mutex_exit(&recalc_pool_mutex);
     return (false);
   }
 
-  *id = recalc_pool->at(0);
+  *id = best->id;
+
+  recalc_pool->erase(best);
 
-  recalc_pool->erase(recalc_pool->begin());
+  MONITOR_SET(MONITOR_STATS_RECALC_POOL, recalc_pool->size());
 
   mutex_exit(&recalc_pool_mutex);
 
   return (true);
 }
 
+/** Count the tables in the auto recalc pool whose stats are due.
+@return number of tables that dict_stats_recalc_pool_get() can return */
+static size_t dict_stats_recalc_pool_n_due() {
+  const ib_time_monotonic_t now = ut_time_monotonic();
+
+  mutex_enter(&recalc_pool_mutex);
+
+  const size_t n_due = std::count_if(
+      recalc_pool->begin(), recalc_pool->end(),
+      [now](const recalc_entry_t &entry) { return entry.not_before <= now; });
+
+  mutex_exit(&recalc_pool_mutex);
+
+  return (n_due);
+}
+
 /** Delete a given table from the auto recalc pool.
  dict_stats_recalc_pool_del() */
 void dict_stats_recalc_pool_del(
@@ -173,9 +252,10 @@ void dict_stats_recalc_pool_del(
 
   for (recalc_pool_iterator_t iter = recalc_pool->begin();
        iter != recalc_pool->end(); ++iter) {
-    if (*iter == table->id) {
+    if (iter->id == table->id) {
       /* erase() invalidates the iterator */
       recalc_pool->erase(iter);
+      MONITOR_SET(MONITOR_STATS_RECALC_POOL, recalc_pool->size());
       break;
     }
   }
@@ -252,20 +332,21 @@ void dict_stats_thread_deinit() {
   dict_stats_event = nullptr;
 }
 
-/** Get the first table that has been added for auto recalc and eventually
-update its stats.
-@param[in,out]	thd	current thread */
-static void dict_stats_process_entry_from_recalc_pool(THD *thd) {
+/** Get the table that is most due for auto recalc and eventually update its
+stats.
+@param[in,out]	thd	current thread
+@return false if no table was due */
+static bool dict_stats_process_entry_from_recalc_pool(THD *thd) {
   table_id_t table_id;
 
   ut_ad(!srv_read_only_mode);
 
-  DBUG_EXECUTE_IF("do_not_meta_lock_in_background", return;);
+  DBUG_EXECUTE_IF("do_not_meta_lock_in_background", return (false););
 
-  /* pop the first table from the auto recalc pool */
+  /* pop the highest priority table from the auto recalc pool */
   if (!dict_stats_recalc_pool_get(&table_id)) {
     /* no tables for auto recalc */
-    return;
+    return (false);
   }
 
   dict_table_t *table;
@@ -281,14 +362,14 @@ static void dict_stats_process_entry_from_recalc_pool(THD *thd) {
     /* table does not exist, must have been DROPped
     after its id was enqueued */
     mutex_exit(&dict_sys->mutex);
-    return;
+    return (true);
   }
 
   /* Check whether table is corrupted */
   if (table->is_corrupted()) {
     dd_table_close(table, thd, &mdl, true);
     mutex_exit(&dict_sys->mutex);
-    return;
+    return (true);
   }
 
   /* Set bg flag. */
@@ -304,14 +385,17 @@ static void dict_stats_process_entry_from_recalc_pool(THD *thd) {
   approach. */
 
   if (ut_time_monotonic() - table->stats_last_recalc < MIN_RECALC_INTERVAL) {
-    /* Stats were (re)calculated not long ago. To avoid
-    too frequent stats updates we put back the table on
-    the auto recalc list and do nothing. */
+    /* Stats were (re)calculated not long ago, e.g. by ANALYZE
+    TABLE after the table was enqueued. To avoid too frequent
+    stats updates we put back the table on the auto recalc
+    list and do nothing. */
 
     dict_stats_recalc_pool_add(table);
 
   } else {
     dict_stats_update(table, DICT_STATS_RECALC_PERSISTENT);
+
+    MONITOR_ATOMIC_INC(MONITOR_STATS_RECALC_BACKGROUND);
   }
 
   mutex_enter(&dict_sys->mutex);
@@ -324,6 +408,63 @@ static void dict_stats_process_entry_from_recalc_pool(THD *thd) {
   /* This call can't be moved into dict_sys->mutex protection,
   since it'll cause deadlock while release mdl lock. */
   dd_table_close(table, thd, &mdl, false);
+
+  return (true);
+}
+
+/** Whether the stats threads should stop taking tables from the pool.
+@return true if shutting down or disabled for debugging */
+static bool dict_stats_should_stop() {
+#ifdef UNIV_DEBUG
+  if (innodb_dict_stats_disabled_debug) {
+    return (true);
+  }
+#endif /* UNIV_DEBUG */
+
+  return (SHUTTING_DOWN());
+}
+
+/** Recalculate the stats of the tables in the recalc pool that are due until
+none is left, in the order of their priority.
+@param[in,out]	thd	current thread */
+static void dict_stats_recalc_worker(THD *thd) {
+  while (!dict_stats_should_stop() &&
+         dict_stats_process_entry_from_recalc_pool(thd)) {
+  }
+}
+
+/** Thread that helps the stats thread recalculate the due tables. */
+static void dict_stats_recalc_thread() {
+  THD *thd = create_thd(false, true, true, 0);
+
+  dict_stats_recalc_worker(thd);
+
+  destroy_thd(thd);
+}
+
+/** Recalculate the stats of all the tables in the recalc pool that are due,
+on up to innodb_stats_recalc_threads threads including the calling one.
+@param[in,out]	thd	current thread */
+static void dict_stats_process_recalc_pool(THD *thd) {
+  const size_t n_threads = std::min<size_t>(srv_stats_recalc_threads,
+                                            dict_stats_recalc_pool_n_due());
+  std::vector<IB_thread> threads;
+
+  for (size_t i = 1; i < n_threads; ++i) {
+    try {
+      threads.emplace_back(os_thread_create(dict_stats_recalc_thread_key,
+                                            dict_stats_recalc_thread));
+      threads.back().start();
+    } catch (...) {
+      break;
+    }
+  }
+
+  dict_stats_recalc_worker(thd);
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
 }
 
 #ifdef UNIV_DEBUG
@@ -353,17 +494,16 @@ void dict_stats_disabled_debug_update(THD *thd, SYS_VAR *var, void *var_ptr,
 
 /** This is the thread for background stats gathering. It pops tables, from
 the auto recalc list and proceeds them, eventually recalculating their
-statistics. */
+statistics, with the help of innodb_stats_recalc_threads - 1 more threads
+when several tables are due. */
 void dict_stats_thread() {
   ut_a(!srv_read_only_mode);
   THD *thd = create_thd(false, true, true, 0);
 
   while (!SHUTTING_DOWN()) {
-    /* Wake up periodically even if not signaled. This is
-    because we may lose an event - if the below call to
-    dict_stats_process_entry_from_recalc_pool() puts the entry back
-    in the list, the os_event_set() will be lost by the subsequent
-    os_event_reset(). */
+    /* Wake up periodically even if not signaled, for the
+    tables that were put back in the list because their stats
+    were recalculated not long ago. */
     os_event_wait_time(dict_stats_event, MIN_RECALC_INTERVAL * 1000000);
 
 #ifdef UNIV_DEBUG
@@ -380,9 +520,11 @@ void dict_stats_thread() {
       break;
     }
 
-    dict_stats_process_entry_from_recalc_pool(thd);
-
+    /* Reset before taking tables, so that a table added meanwhile
+    wakes up the next round at once */
     os_event_reset(dict_stats_event);
+
+    dict_stats_process_recalc_pool(thd);
   }
 
   destroy_thd(thd);
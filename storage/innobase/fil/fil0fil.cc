@@ -71,6 +71,7 @@ The tablespace memory cache */
 #else /* !UNIV_HOTBACKUP */
 #include <cstring>
 #include "srv0srv.h"
+#include "ut0crc32.h"
 #endif /* !UNIV_HOTBACKUP */
 
 #include "os0thread-create.h"
@@ -162,6 +163,23 @@ size_t fil_get_scan_threads(size_t num_files) {
 /* uint16_t is the index into Tablespace_dirs::m_dirs */
 using Scanned_files = std::vector<std::pair<uint16_t, std::string>>;
 
+/** Name of the tablespace ID map written at shutdown, in the datadir */
+static const char *const FIL_SCAN_MAP_FILE = "#ib_tablespace_ids";
+
+/** First line of the tablespace ID map */
+static const char *const FIL_SCAN_MAP_HEADER = "ib_tablespace_ids 1";
+
+/** A file of the tablespace ID map: its ID as long as the file has the
+modification time and size it had when the map was written. */
+struct Scan_map_entry {
+  space_id_t space_id;
+  time_t mtime;
+  os_offset_t size;
+};
+
+/** Absolute file path to its tablespace ID map entry */
+using Scan_map = std::unordered_map<std::string, Scan_map_entry>;
+
 #ifdef UNIV_PFS_IO
 mysql_pfs_key_t innodb_tablespace_open_file_key;
 #endif /* UNIV_PFS_IO */
@@ -656,10 +674,25 @@ class Tablespace_dirs {
                        size_t thread_id, std::mutex *mutex,
                        Space_id_set *unique, Space_id_set *duplicates);
 
+  /** Read the tablespace ID map of the last clean shutdown into
+  m_scan_map and remove it: after a crash the scan reads every header.
+  A map that is missing, damaged or of another format is ignored. */
+  void load_scan_map();
+
+  /** The tablespace ID of an .ibd file from m_scan_map, if the file is
+  unchanged since the map was written.
+  @param[in]	real_path	Absolute path of a file found by the scan
+  @return the tablespace ID or dict_sys_t::s_invalid_space_id */
+  space_id_t scan_map_lookup(const std::string &real_path) const
+      MY_ATTRIBUTE((warn_unused_result));
+
  private:
   /** Directories scanned and the files discovered under them. */
   Scanned m_dirs;
 
+  /** Tablespace IDs of the last clean shutdown, used by scan() only */
+  Scan_map m_scan_map;
+
   /** Number of files checked. */
   std::atomic_size_t m_checked;
 };
@@ -1710,6 +1743,11 @@ class Fil_system {
   mapping table. */
   dberr_t scan() { return m_dirs.scan(); }
 
+  /** Write the ID and file of every file-per-table and general
+  tablespace to the tablespace ID map, for the scan at the next
+  startup. */
+  void write_scan_map();
+
   /** Get the tablespace ID from an .ibd and/or an undo tablespace. If the ID is
   0 on the first page then try finding the ID with Datafile::find_space_id().
   @param[in]	filename	File name to check
@@ -4012,6 +4050,16 @@ void fil_set_max_space_id_if_bigger(space_id_t max_id) {
   fil_system->update_maximum_space_id(max_id);
 }
 
+space_id_t fil_get_max_space_id() {
+  fil_system->mutex_acquire_all();
+
+  auto max_id = fil_system->get_max_space_id();
+
+  fil_system->mutex_release_all();
+
+  return max_id;
+}
+
 /** Write the flushed LSN to the page header of the first page in the
 system tablespace.
 @param[in]	lsn		Flushed LSN
@@ -4533,6 +4581,164 @@ bool fil_system_get_file_by_space_num(space_id_t space_num,
 
 #endif /* !UNIV_HOTBACKUP */
 
+#ifndef UNIV_HOTBACKUP
+/** Directory in the data directory holding the files of dropped
+tablespaces until the master thread has removed them. */
+static const char FIL_TRASH_DIR[] = "#innodb_trash";
+
+/** Suffix of the files in FIL_TRASH_DIR. It must not be one of the
+tablespace file suffixes, so that the files are not discovered as
+tablespaces at startup. */
+static const char FIL_TRASH_SUFFIX[] = ".del";
+
+/** Files of dropped tablespaces waiting to be removed in the background,
+see innodb_background_drop_file. */
+struct Fil_trash {
+  /** Protects the members below */
+  std::mutex m_mutex;
+
+  /** Files in FIL_TRASH_DIR, oldest first */
+  std::list<std::string> m_files;
+
+  /** Used to make the names of the files unique */
+  uint64_t m_seq{};
+
+  /** Whether FIL_TRASH_DIR has been scanned for the files left behind
+  by a previous server instance */
+  bool m_scanned{};
+
+  /** @return path of FIL_TRASH_DIR, with a trailing separator */
+  static std::string dir() {
+    std::string dir{MySQL_datadir_path()};
+
+    if (!dir.empty() && !Fil_path::is_separator(dir.back())) {
+      dir.push_back(OS_PATH_SEPARATOR);
+    }
+
+    dir.append(FIL_TRASH_DIR);
+    dir.push_back(OS_PATH_SEPARATOR);
+
+    return dir;
+  }
+};
+
+static Fil_trash fil_trash;
+
+/** Move the file of a dropped tablespace into FIL_TRASH_DIR, so that
+fil_purge_trash() removes it in the background.
+@param[in]	space_id	Tablespace ID
+@param[in]	path		File of the tablespace
+@return true if the file was moved, false if it must be deleted now */
+static bool fil_move_to_trash(space_id_t space_id, const char *path) {
+  if (!srv_background_drop_file || srv_read_only_mode) {
+    return false;
+  }
+
+  const os_file_size_t size = os_file_get_size(path);
+
+  /* Small files are not worth it, and on error just delete the file. */
+  if (size.m_total_size == static_cast<os_offset_t>(~0) ||
+      size.m_total_size <= srv_background_drop_file_step) {
+    return false;
+  }
+
+  const std::string dir = Fil_trash::dir();
+
+  if (!os_file_create_directory(dir.c_str(), false)) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> guard(fil_trash.m_mutex);
+
+  const std::string trash = dir + std::to_string(space_id) + "_" +
+                            std::to_string(++fil_trash.m_seq) +
+                            FIL_TRASH_SUFFIX;
+
+  /* The rename fails if the file is on another file system than the
+  data directory, e.g. for tables created with DATA DIRECTORY. */
+  if (!os_file_rename(innodb_data_file_key, path, trash.c_str())) {
+    return false;
+  }
+
+  fil_trash.m_files.push_back(trash);
+
+  return true;
+}
+
+void fil_purge_trash() {
+  std::string path;
+
+  {
+    std::lock_guard<std::mutex> guard(fil_trash.m_mutex);
+
+    if (!fil_trash.m_scanned) {
+      fil_trash.m_scanned = true;
+
+      /* Pick up what a previous server instance left behind. */
+      const std::string dir = Fil_trash::dir();
+      const size_t suffix_len = sizeof(FIL_TRASH_SUFFIX) - 1;
+      bool exists = false;
+      os_file_type_t type;
+
+      os_file_status(dir.c_str(), &exists, &type);
+
+      if (exists && type == OS_FILE_TYPE_DIR) {
+        Dir_Walker::walk(dir, false, [&](const std::string &file) {
+          if (!Dir_Walker::is_directory(file) && file.size() > suffix_len &&
+              file.compare(file.size() - suffix_len, suffix_len,
+                           FIL_TRASH_SUFFIX) == 0 &&
+              std::find(fil_trash.m_files.begin(), fil_trash.m_files.end(),
+                        file) == fil_trash.m_files.end()) {
+            fil_trash.m_files.push_back(file);
+          }
+        });
+      }
+    }
+
+    if (fil_trash.m_files.empty()) {
+      return;
+    }
+
+    path = fil_trash.m_files.front();
+  }
+
+  bool success;
+
+  auto file = os_file_create_simple_no_error_handling(
+      innodb_data_file_key, path.c_str(), OS_FILE_OPEN, OS_FILE_READ_WRITE,
+      false, &success);
+
+  bool done = !success;
+
+  if (success) {
+    const os_offset_t size = os_file_get_size(file);
+
+    if (size == static_cast<os_offset_t>(-1) ||
+        size <= srv_background_drop_file_step) {
+      done = true;
+
+    } else if (!os_file_truncate(path.c_str(), file,
+                                 size - srv_background_drop_file_step)) {
+      ib::warn(ER_IB_MSG_380) << "Cannot truncate '" << path
+                              << "', deleting it at once";
+      done = true;
+    }
+
+    os_file_close(file);
+  }
+
+  if (!done) {
+    return;
+  }
+
+  os_file_delete_if_exists(innodb_data_file_key, path.c_str(), nullptr);
+
+  std::lock_guard<std::mutex> guard(fil_trash.m_mutex);
+
+  fil_trash.m_files.remove(path);
+}
+#endif /* !UNIV_HOTBACKUP */
+
 dberr_t Fil_shard::space_delete(space_id_t space_id, buf_remove_t buf_remove) {
   char *path = nullptr;
   fil_space_t *space = nullptr;
@@ -4551,6 +4757,11 @@ dberr_t Fil_shard::space_delete(space_id_t space_id, buf_remove_t buf_remove) {
   ut_a(space != nullptr);
 
 #ifndef UNIV_HOTBACKUP
+  /* Only the files of user tablespaces are removed in the background. */
+  const bool may_move_to_trash = space->purpose == FIL_TYPE_TABLESPACE &&
+                                 !fsp_is_undo_tablespace(space_id) &&
+                                 !fsp_is_dd_tablespace(space_id);
+
   /* IMPORTANT: Because we have set space::stop_new_ops there
   can't be any new ibuf merges, reads or flushes. We are here
   because file::n_pending was zero above. However, it is still
@@ -4664,7 +4875,15 @@ dberr_t Fil_shard::space_delete(space_id_t space_id, buf_remove_t buf_remove) {
     space_free_low(space);
 #endif /* UNIV_HOTBACKUP */
 
-    if (!os_file_delete(innodb_data_file_key, path) &&
+#ifndef UNIV_HOTBACKUP
+    /* Releasing the extents of a huge file can stall the file system
+    for seconds, do it in the background when configured to. */
+    const bool moved = may_move_to_trash && fil_move_to_trash(space_id, path);
+#else
+    const bool moved = false;
+#endif /* !UNIV_HOTBACKUP */
+
+    if (!moved && !os_file_delete(innodb_data_file_key, path) &&
         !os_file_delete_if_exists(innodb_data_file_key, path, nullptr)) {
       /* Note: This is because we have removed the
       tablespace instance from the cache. */
@@ -11416,9 +11635,11 @@ void Tablespace_dirs::duplicate_check(const Const_iter &start,
     auto &files = m_dirs[it->first];
     const std::string phy_filename = files.path() + filename;
 
-    space_id_t space_id;
+    space_id_t space_id = scan_map_lookup(files.root().abs_path() + filename);
 
-    space_id = Fil_system::get_tablespace_id(phy_filename);
+    if (space_id == dict_sys_t::s_invalid_space_id) {
+      space_id = Fil_system::get_tablespace_id(phy_filename);
+    }
 
     if (space_id != 0 && space_id != dict_sys_t::s_invalid_space_id) {
       std::lock_guard<std::mutex> guard(*mutex);
@@ -11613,6 +11834,173 @@ static void fil_rename_partition_file(const std::string &old_path,
 }
 #endif /* !UNIV_HOTBACKUP */
 
+/** @return the path of the tablespace ID map */
+static std::string fil_scan_map_path() {
+  return Fil_path::get_real_path(MySQL_datadir_path.path()) +
+         FIL_SCAN_MAP_FILE;
+}
+
+void Tablespace_dirs::load_scan_map() {
+  const std::string path = fil_scan_map_path();
+
+  std::ifstream in(path);
+
+  if (!in.is_open()) {
+    return;
+  }
+
+  std::string text;
+  std::string line;
+  Scan_map map;
+  bool valid = false;
+
+  if (std::getline(in, line) && line == FIL_SCAN_MAP_HEADER) {
+    text = line + '\n';
+
+    while (std::getline(in, line)) {
+      unsigned long checksum;
+      unsigned long space_id;
+      long long mtime;
+      unsigned long long size;
+      int pos = 0;
+
+      if (sscanf(line.c_str(), "crc32 %lx", &checksum) == 1) {
+        valid = checksum == ut_crc32(reinterpret_cast<const byte *>(text.data()),
+                                     text.size());
+        break;
+      }
+
+      if (sscanf(line.c_str(), "%lu %lld %llu %n", &space_id, &mtime, &size,
+                 &pos) != 3 ||
+          pos == 0 || static_cast<size_t>(pos) >= line.size()) {
+        break;
+      }
+
+      map[line.substr(pos)] = Scan_map_entry{static_cast<space_id_t>(space_id),
+                                             static_cast<time_t>(mtime),
+                                             static_cast<os_offset_t>(size)};
+
+      text += line + '\n';
+    }
+  }
+
+  in.close();
+
+  /* Only the next clean shutdown writes a map again. */
+  os_file_delete_if_exists(innodb_data_file_key, path.c_str(), nullptr);
+
+  if (!valid) {
+    ib::warn(ER_IB_MSG_380) << "Ignoring the damaged tablespace ID map '"
+                            << path << "'";
+    return;
+  }
+
+  m_scan_map.swap(map);
+
+  ib::info(ER_IB_MSG_380) << "Tablespace ID map of the last shutdown has "
+                          << m_scan_map.size() << " data files";
+}
+
+space_id_t Tablespace_dirs::scan_map_lookup(
+    const std::string &real_path) const {
+  if (m_scan_map.empty() || !Fil_path::has_suffix(IBD, real_path)) {
+    return dict_sys_t::s_invalid_space_id;
+  }
+
+  const auto it = m_scan_map.find(real_path);
+
+  if (it == m_scan_map.end()) {
+    return dict_sys_t::s_invalid_space_id;
+  }
+
+  os_file_stat_t stat_info;
+
+  if (os_file_get_status(real_path.c_str(), &stat_info, false, true) !=
+          DB_SUCCESS ||
+      stat_info.mtime != it->second.mtime ||
+      stat_info.size != it->second.size) {
+    return dict_sys_t::s_invalid_space_id;
+  }
+
+  return it->second.space_id;
+}
+
+void Fil_system::write_scan_map() {
+  using Entry = std::pair<space_id_t, std::string>;
+  std::vector<Entry> files;
+
+  for (auto shard : m_shards) {
+    shard->mutex_acquire();
+
+    for (const auto &e : shard->m_spaces) {
+      const fil_space_t *space = e.second;
+
+      if (space->purpose != FIL_TYPE_TABLESPACE ||
+          fsp_is_system_or_temp_tablespace(space->id) ||
+          fsp_is_undo_tablespace(space->id) || space->files.size() != 1 ||
+          !Fil_path::has_suffix(IBD, space->files.front().name)) {
+        continue;
+      }
+
+      files.push_back(Entry{space->id, space->files.front().name});
+    }
+
+    shard->mutex_release();
+  }
+
+  std::string text{FIL_SCAN_MAP_HEADER};
+  text.push_back('\n');
+
+  for (const auto &file : files) {
+    const std::string real_path = Fil_path::get_real_path(file.second);
+
+    os_file_stat_t stat_info;
+
+    if (os_file_get_status(real_path.c_str(), &stat_info, false, true) !=
+        DB_SUCCESS) {
+      continue;
+    }
+
+    char prefix[64];
+
+    snprintf(prefix, sizeof(prefix), "%lu %lld %llu ",
+             static_cast<unsigned long>(file.first),
+             static_cast<long long>(stat_info.mtime),
+             static_cast<unsigned long long>(stat_info.size));
+
+    text.append(prefix);
+    text.append(real_path);
+    text.push_back('\n');
+  }
+
+  const std::string path = fil_scan_map_path();
+  const std::string tmp_path = path + ".incomplete";
+
+  FILE *f = fopen(tmp_path.c_str(), "w");
+
+  if (f == nullptr) {
+    ib::warn(ER_IB_MSG_380) << "Cannot write the tablespace ID map '"
+                            << tmp_path << "': " << strerror(errno);
+    return;
+  }
+
+  const bool failed =
+      fwrite(text.data(), 1, text.size(), f) != text.size() ||
+      fprintf(f, "crc32 %lx\n",
+              static_cast<unsigned long>(ut_crc32(
+                  reinterpret_cast<const byte *>(text.data()), text.size()))) <
+          0;
+
+  if (fclose(f) != 0 || failed ||
+      rename(tmp_path.c_str(), path.c_str()) != 0) {
+    ib::warn(ER_IB_MSG_380) << "Cannot write the tablespace ID map '" << path
+                            << "': " << strerror(errno);
+    os_file_delete_if_exists(innodb_data_file_key, tmp_path.c_str(), nullptr);
+  }
+}
+
+void fil_write_scan_map() { fil_system->write_scan_map(); }
+
 void Tablespace_dirs::set_scan_dir(const std::string &in_directory,
                                    bool is_undo_dir) {
   std::string directory(in_directory);
@@ -11643,6 +12031,10 @@ dberr_t Tablespace_dirs::scan() {
   bool print_msg = false;
   auto start_time = ut_time_monotonic();
 
+  if (srv_tablespace_id_map) {
+    load_scan_map();
+  }
+
   /* Should be trivial to parallelize the scan and ID check. */
   for (const auto &dir : m_dirs) {
     const auto real_path_dir = dir.root().abs_path();
@@ -11747,6 +12139,8 @@ dberr_t Tablespace_dirs::scan() {
   ib::info(ER_IB_MSG_383) << "Completed space ID check of " << m_checked.load()
                           << " files.";
 
+  m_scan_map.clear();
+
   dberr_t err;
 
   if (!duplicates.empty()) {
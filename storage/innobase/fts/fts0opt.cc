@@ -37,6 +37,11 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <sys/types.h>
 #include <time.h>
 #include <zlib.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "current_thd.h"
 #include "dict0dd.h"
@@ -189,6 +194,22 @@ struct fts_optimize_t {
                      been optimized */
   ibool del_list_regenerated;
   /*!< BEING_DELETED list regenarated */
+
+  ulint selected; /*!< Auxiliary index table that a parallel
+                  worker optimizes, or ULINT_UNDEFINED
+                  for all of them */
+
+  std::string last_word_param; /*!< Config parameter holding the last
+                               word optimized */
+
+  ulint words_per_sec; /*!< Maximum number of words to optimize
+                       per second, or 0 for no limit */
+
+  ulint n_words_optimized; /*!< Words optimized since
+                           throttle_start */
+
+  ib_time_monotonic_ms_t throttle_start; /*!< When the word rate
+                                         started to be measured */
 };
 
 /** Used by the optimize, to keep state during compacting nodes. */
@@ -237,6 +258,13 @@ struct fts_msg_t {
 /** The number of words to read and optimize in a single pass. */
 ulong fts_num_word_optimize;
 
+/** The number of threads that optimize the auxiliary index tables of a
+FULLTEXT index in parallel. */
+ulong fts_optimize_threads;
+
+/** The maximum number of words that optimize rewrites per second, or 0. */
+ulong fts_optimize_words_per_sec;
+
 // FIXME
 bool fts_enable_diag_print;
 
@@ -763,8 +791,10 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_index_fetch_words(
     fts_zip_initialize(optim->zip);
   }
 
-  for (selected = fts_select_index(optim->fts_index_table.charset, word->f_str,
-                                   word->f_len);
+  for (selected = optim->selected != ULINT_UNDEFINED
+                      ? optim->selected
+                      : fts_select_index(optim->fts_index_table.charset,
+                                         word->f_str, word->f_len);
        selected < FTS_NUM_AUX_INDEX; selected++) {
     char table_name[MAX_FULL_NAME_LEN];
 
@@ -839,8 +869,9 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_index_fetch_words(
 
     fts_que_graph_free(graph);
 
-    /* Check if max word to fetch is exceeded */
-    if (optim->zip->n_words >= n_words) {
+    /* Check if max word to fetch is exceeded, or if a parallel worker
+    read all the words of its auxiliary table */
+    if (optim->zip->n_words >= n_words || optim->selected != ULINT_UNDEFINED) {
       break;
     }
   }
@@ -1410,6 +1441,48 @@ void fts_word_free(fts_word_t *word) /*!< in: instance to free.*/
   mem_heap_free(heap);
 }
 
+int64_t fts_optimize_throttle_delay(int64_t start_ms, ulint n_words,
+                                    ulint words_per_sec, int64_t now_ms) {
+  if (words_per_sec == 0) {
+    return 0;
+  }
+
+  const int64_t due =
+      start_ms + static_cast<int64_t>(n_words * 1000 / words_per_sec);
+
+  return due > now_ms ? due - now_ms : 0;
+}
+
+/** Sleep as long as needed to keep the rate of optimized words below
+optim->words_per_sec.
+@param[in,out]	optim	optimize state data */
+static void fts_optimize_throttle(fts_optimize_t *optim) {
+  if (optim->words_per_sec == 0) {
+    return;
+  }
+
+  const auto now = ut_time_monotonic_ms();
+
+  if (optim->n_words_optimized == 0) {
+    optim->throttle_start = now;
+  }
+
+  ++optim->n_words_optimized;
+
+  const int64_t delay = fts_optimize_throttle_delay(
+      optim->throttle_start, optim->n_words_optimized, optim->words_per_sec,
+      now);
+
+  if (delay > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+  }
+
+  /* Measure the rate over one second windows */
+  if (optim->n_words_optimized >= optim->words_per_sec) {
+    optim->n_words_optimized = 0;
+  }
+}
+
 /** Optimize the word ilist and rewrite data to the FTS index.
  @return status one of RESTART, EXIT, ERROR */
 static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_compact(
@@ -1441,12 +1514,15 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_compact(
       /* Write the last word optimized to the config table,
       we use this value for restarting optimize. */
       error = fts_config_set_index_value(optim->trx, index,
-                                         FTS_LAST_OPTIMIZED_WORD, &word->text);
+                                         optim->last_word_param.c_str(),
+                                         &word->text);
     }
 
     /* Free the word that was optimized. */
     fts_word_free(word);
 
+    fts_optimize_throttle(optim);
+
     if (fts_optimize_time_limit > 0 &&
         ut_time_monotonic() - start_time > fts_optimize_time_limit) {
       optim->done = TRUE;
@@ -1464,7 +1540,7 @@ static fts_optimize_t *fts_optimize_create(
   fts_optimize_t *optim;
   mem_heap_t *heap = mem_heap_create(128);
 
-  optim = (fts_optimize_t *)mem_heap_zalloc(heap, sizeof(*optim));
+  optim = new (mem_heap_zalloc(heap, sizeof(*optim))) fts_optimize_t();
 
   optim->self_heap = ib_heap_allocator_create(heap);
 
@@ -1489,6 +1565,10 @@ static fts_optimize_t *fts_optimize_create(
   /* The common prefix for all this parent table's aux tables. */
   optim->name_prefix = fts_get_table_name_prefix(&optim->fts_common_table);
 
+  optim->selected = ULINT_UNDEFINED;
+  optim->last_word_param = FTS_LAST_OPTIMIZED_WORD;
+  optim->words_per_sec = fts_optimize_words_per_sec;
+
   return (optim);
 }
 
@@ -1575,11 +1655,15 @@ static void fts_optimize_free(
 
   trx_free_for_background(optim->trx);
 
-  fts_doc_ids_free(optim->to_delete);
+  if (optim->to_delete != nullptr) {
+    fts_doc_ids_free(optim->to_delete);
+  }
   fts_optimize_graph_free(&optim->graph);
 
   ut_free(optim->name_prefix);
 
+  optim->~fts_optimize_t();
+
   /* This will free the heap from which optim itself was allocated. */
   mem_heap_free(heap);
 }
@@ -1611,10 +1695,6 @@ static void fts_optimize_words(
 
   ut_a(!optim->done);
 
-  /* Get the time limit from the config table. */
-  fts_optimize_time_limit =
-      fts_optimize_get_time_limit(optim->trx, &optim->fts_common_table);
-
   const auto start_time = ut_time_monotonic();
 
   /* Setup the callback to use for fetching the word ilist etc. */
@@ -1706,8 +1786,8 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_index_completed(
   word.f_str = buf;
   *word.f_str = '\0';
 
-  error = fts_config_set_index_value(optim->trx, index, FTS_LAST_OPTIMIZED_WORD,
-                                     &word);
+  error = fts_config_set_index_value(optim->trx, index,
+                                     optim->last_word_param.c_str(), &word);
 
   if (error != DB_SUCCESS) {
     ib::error(ER_IB_MSG_497) << "(" << ut_strerr(error)
@@ -1734,7 +1814,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_index_read_words(
     /* Get the last word that was optimized from
     the config table. */
     error = fts_config_get_index_value(optim->trx, index,
-                                       FTS_LAST_OPTIMIZED_WORD, word);
+                                       optim->last_word_param.c_str(), word);
   }
 
   /* If record not found then we start from the top. */
@@ -1743,8 +1823,14 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_index_read_words(
     error = DB_SUCCESS;
   }
 
+  /* Parallel workers share the number of words of a pass */
+  const ulint n_words =
+      optim->selected == ULINT_UNDEFINED
+          ? fts_num_word_optimize
+          : std::max<ulint>(fts_num_word_optimize / fts_optimize_threads, 1);
+
   while (error == DB_SUCCESS) {
-    error = fts_index_fetch_words(optim, word, fts_num_word_optimize);
+    error = fts_index_fetch_words(optim, word, n_words);
 
     if (error == DB_SUCCESS) {
       /* Reset the last optimized word to '' if no
@@ -1761,17 +1847,21 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t fts_optimize_index_read_words(
   return (error);
 }
 
-/** Run OPTIMIZE on the given FTS index. Note: this can take a very long
- time (hours).
- @return DB_SUCCESS if all OK */
+/** Run OPTIMIZE on the words of an FTS index that optim reads, which are
+the words of one auxiliary index table for a parallel worker.
+@param[in,out]	optim		optimize instance
+@param[in]	index		FTS index
+@param[out]	completed	true if no words were left to optimize
+@return DB_SUCCESS if all OK */
 static MY_ATTRIBUTE((warn_unused_result)) dberr_t
-    fts_optimize_index(fts_optimize_t *optim, /*!< in: optimize instance */
-                       dict_index_t *index) /*!< in: table with one FTS index */
-{
+    fts_optimize_index_words(fts_optimize_t *optim, dict_index_t *index,
+                             bool *completed) {
   fts_string_t word;
   dberr_t error;
   byte str[FTS_MAX_WORD_LEN + 1];
 
+  *completed = false;
+
   /* Set the current index that we have to optimize. */
   optim->fts_index_table.index_id = index->id;
   optim->fts_index_table.charset = fts_index_get_charset(index);
@@ -1812,16 +1902,176 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
     }
 
     /* If we couldn't read any records then optimize is
-    complete. Increment the number of indexes that have
-    been optimized and set FTS index optimize state to
-    completed. */
+    complete: set FTS index optimize state to completed. The last
+    word of an auxiliary table is kept until all the tables of the
+    index are complete, so that it stays complete meanwhile. */
     if (error == DB_SUCCESS && optim->zip->n_words == 0) {
-      error = fts_optimize_index_completed(optim, index);
-
-      if (error == DB_SUCCESS) {
-        ++optim->n_completed;
+      if (optim->selected == ULINT_UNDEFINED) {
+        error = fts_optimize_index_completed(optim, index);
       }
+
+      *completed = (error == DB_SUCCESS);
+    }
+  }
+
+  return (error);
+}
+
+/** One auxiliary index table optimized by a parallel worker. */
+struct fts_optimize_part_t {
+  /** Auxiliary index table number */
+  ulint selected;
+
+  /** Result of the optimize */
+  dberr_t error;
+
+  /** true if no words were left to optimize */
+  bool completed;
+};
+
+/** Optimize auxiliary index tables of an FTS index until there are none
+left, each in a transaction of its own.
+@param[in]	parent	optimize instance of the table
+@param[in]	index	FTS index
+@param[in,out]	parts	auxiliary index tables
+@param[in,out]	next	next entry of parts to optimize
+@param[in]	n_workers	number of parallel workers */
+static void fts_optimize_index_worker(fts_optimize_t *parent,
+                                      dict_index_t *index,
+                                      fts_optimize_part_t *parts,
+                                      std::atomic<ulint> *next,
+                                      ulint n_workers) {
+  THD *thd = create_thd(false, true, true, 0);
+
+  for (ulint i = next->fetch_add(1); i < FTS_NUM_AUX_INDEX;
+       i = next->fetch_add(1)) {
+    fts_optimize_part_t *part = &parts[i];
+    fts_optimize_t *optim = fts_optimize_create(parent->table);
+
+    /* The doc ids to purge are only read, and belong to parent */
+    fts_doc_ids_free(optim->to_delete);
+    optim->to_delete = parent->to_delete;
+
+    optim->del_list_regenerated = parent->del_list_regenerated;
+    optim->selected = part->selected;
+    optim->last_word_param =
+        std::string(FTS_LAST_OPTIMIZED_WORD) + "_" + std::to_string(i);
+    optim->words_per_sec =
+        parent->words_per_sec == 0
+            ? 0
+            : std::max<ulint>(parent->words_per_sec / n_workers, 1);
+
+    part->error = fts_optimize_index_words(optim, index, &part->completed);
+
+    if (part->error == DB_SUCCESS) {
+      fts_sql_commit(optim->trx);
+    } else {
+      fts_sql_rollback(optim->trx);
     }
+
+    optim->to_delete = nullptr;
+    fts_optimize_free(optim);
+  }
+
+  destroy_thd(thd);
+}
+
+/** Run OPTIMIZE on the auxiliary index tables of an FTS index in parallel,
+each of them resuming from its own last optimized word.
+@param[in,out]	optim	optimize instance
+@param[in]	index	FTS index
+@return DB_SUCCESS if all OK */
+static MY_ATTRIBUTE((warn_unused_result)) dberr_t
+    fts_optimize_index_parallel(fts_optimize_t *optim, dict_index_t *index) {
+  fts_optimize_part_t parts[FTS_NUM_AUX_INDEX];
+  std::atomic<ulint> next{0};
+  const ulint n_workers = std::min<ulint>(fts_optimize_threads,
+                                         FTS_NUM_AUX_INDEX);
+
+  for (ulint i = 0; i < FTS_NUM_AUX_INDEX; ++i) {
+    parts[i].selected = i;
+    parts[i].error = DB_SUCCESS;
+    parts[i].completed = false;
+  }
+
+  /* Commit before the workers update the config table */
+  fts_sql_commit(optim->trx);
+
+  std::vector<IB_thread> threads;
+
+  for (ulint i = 0; i < n_workers; ++i) {
+    try {
+      threads.emplace_back(os_thread_create(
+          fts_parallel_optimize_thread_key, fts_optimize_index_worker, optim,
+          index, parts, &next, n_workers));
+      threads.back().start();
+    } catch (...) {
+      break;
+    }
+  }
+
+  if (threads.empty()) {
+    /* Optimize in this thread if no worker could be started */
+    fts_optimize_index_worker(optim, index, parts, &next, 1);
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bool completed = true;
+
+  for (const auto &part : parts) {
+    if (part.error != DB_SUCCESS) {
+      return (part.error);
+    }
+
+    completed = completed && part.completed;
+  }
+
+  if (!completed) {
+    return (DB_SUCCESS);
+  }
+
+  /* Restart every auxiliary table from the first word next time */
+  dberr_t error = DB_SUCCESS;
+
+  for (ulint i = 0; i < FTS_NUM_AUX_INDEX && error == DB_SUCCESS; ++i) {
+    optim->last_word_param =
+        std::string(FTS_LAST_OPTIMIZED_WORD) + "_" + std::to_string(i);
+    error = fts_optimize_index_completed(optim, index);
+  }
+
+  optim->last_word_param = FTS_LAST_OPTIMIZED_WORD;
+
+  if (error == DB_SUCCESS) {
+    ++optim->n_completed;
+  }
+
+  return (error);
+}
+
+/** Run OPTIMIZE on the given FTS index. Note: this can take a very long
+ time (hours).
+ @return DB_SUCCESS if all OK */
+static MY_ATTRIBUTE((warn_unused_result)) dberr_t
+    fts_optimize_index(fts_optimize_t *optim, /*!< in: optimize instance */
+                       dict_index_t *index) /*!< in: table with one FTS index */
+{
+  /* Get the time limit from the config table. */
+  fts_optimize_time_limit =
+      fts_optimize_get_time_limit(optim->trx, &optim->fts_common_table);
+
+  if (fts_optimize_threads > 1) {
+    return (fts_optimize_index_parallel(optim, index));
+  }
+
+  bool completed;
+  const dberr_t error = fts_optimize_index_words(optim, index, &completed);
+
+  /* Increment the number of indexes that have been optimized. */
+  if (completed) {
+    ++optim->n_completed;
   }
 
   return (error);
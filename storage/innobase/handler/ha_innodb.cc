@@ -124,6 +124,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "i_s.h"
 #include "ibuf0ibuf.h"
 #include "lex_string.h"
+#include "lob0compress.h"
 #include "lob0lob.h"
 #include "lock0lock.h"
 #include "log0meb.h"
@@ -786,9 +787,12 @@ static PSI_thread_info all_innodb_threads[] = {
     PSI_KEY(log_archiver_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(page_archiver_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(buf_dump_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(buf_load_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(clone_ddl_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(clone_gtid_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(dict_stats_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(dict_stats_recalc_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(dict_stats_sample_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(io_handler_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(io_ibuf_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(io_log_thread, 0, 0, PSI_DOCUMENT_ME),
@@ -801,6 +805,8 @@ static PSI_thread_info all_innodb_threads[] = {
     PSI_KEY(log_write_notifier_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(log_flush_notifier_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(recv_writer_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(recv_apply_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(row_log_apply_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(srv_error_monitor_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(srv_lock_timeout_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(srv_master_thread, 0, 0, PSI_DOCUMENT_ME),
@@ -812,9 +818,11 @@ static PSI_thread_info all_innodb_threads[] = {
     PSI_KEY(page_flush_coordinator_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(fts_optimize_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(fts_parallel_merge_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(fts_parallel_optimize_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(fts_parallel_tokenization_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(srv_ts_alter_encrypt_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(parallel_read_thread, 0, 0, PSI_DOCUMENT_ME),
+    PSI_KEY(ddl_sort_thread, 0, 0, PSI_DOCUMENT_ME),
     PSI_KEY(meb::redo_log_archive_consumer_thread, 0, 0, PSI_DOCUMENT_ME)};
 #endif /* UNIV_PFS_THREAD */
 
@@ -976,6 +984,15 @@ static MYSQL_THDVAR_ULONG(parallel_read_threads, PLUGIN_VAR_RQCMDARG,
                           Parallel_reader::MAX_THREADS, /* Maxumum. */
                           0);
 
+static MYSQL_THDVAR_ULONG(ddl_threads, PLUGIN_VAR_RQCMDARG,
+                          "Number of threads to merge sort the entries of"
+                          " non-unique secondary indexes with when several"
+                          " are built in one ALTER TABLE.",
+                          nullptr, nullptr, 4, /* Default. */
+                          1,                   /* Minimum. */
+                          64,                  /* Maximum. */
+                          0);
+
 static SHOW_VAR innodb_status_variables[] = {
     {"buffer_pool_dump_status",
      (char *)&export_vars.innodb_buffer_pool_dump_status, SHOW_CHAR,
@@ -1847,6 +1864,8 @@ ulong thd_parallel_read_threads(THD *thd) {
   return (THDVAR(thd, parallel_read_threads));
 }
 
+ulong thd_ddl_threads(THD *thd) { return (THDVAR(thd, ddl_threads)); }
+
 /** Check if statement is of type INSERT .... SELECT that involves
 use of intrinsic tables.
 @param[in]	user_thd	thread handler
@@ -2778,7 +2797,7 @@ ha_innobase::ha_innobase(handlerton *hton, TABLE_SHARE *table_arg)
           HA_ATTACHABLE_TRX_COMPATIBLE | HA_CAN_INDEX_VIRTUAL_GENERATED_COLUMN |
           HA_DESCENDING_INDEX | HA_MULTI_VALUED_KEY_SUPPORT |
           HA_BLOB_PARTIAL_UPDATE | HA_SUPPORTS_GEOGRAPHIC_GEOMETRY_COLUMN |
-          HA_SUPPORTS_DEFAULT_EXPRESSION),
+          HA_SUPPORTS_DEFAULT_EXPRESSION | HA_AGGREGATE_COLUMN_INSTANT),
       m_start_of_scan(),
       m_stored_select_lock_type(LOCK_NONE_UNSET),
       m_mysql_has_locked() {}
@@ -2980,6 +2999,7 @@ void ha_innobase::reset_template(void) {
   m_prebuilt->read_just_key = 0;
   m_prebuilt->in_fts_query = false;
   m_prebuilt->m_end_range = false;
+  m_prebuilt->end_batch_lookup();
 
   /* Reset index condition pushdown state. */
   if (m_prebuilt->idx_cond) {
@@ -4875,10 +4895,11 @@ static int innodb_init(void *p) {
   innobase_hton->unlock_hton_log = innobase_unlock_hton_log;
   innobase_hton->collect_hton_log_info = innobase_collect_hton_log_info;
   innobase_hton->fill_is_table = innobase_fill_i_s_table;
-  innobase_hton->flags = HTON_SUPPORTS_EXTENDED_KEYS |
-                         HTON_SUPPORTS_FOREIGN_KEYS | HTON_SUPPORTS_ATOMIC_DDL |
-                         HTON_CAN_RECREATE | HTON_SUPPORTS_SECONDARY_ENGINE |
-                         HTON_SUPPORTS_TABLE_ENCRYPTION;
+  innobase_hton->flags =
+      HTON_SUPPORTS_EXTENDED_KEYS | HTON_SUPPORTS_FOREIGN_KEYS |
+      HTON_SUPPORTS_ATOMIC_DDL | HTON_CAN_RECREATE |
+      HTON_SUPPORTS_SECONDARY_ENGINE | HTON_SUPPORTS_TABLE_ENCRYPTION |
+      HTON_SUPPORTS_ENGINE_ATTRIBUTE;
 
   innobase_hton->replace_native_transaction_in_thd = innodb_replace_trx_in_thd;
   innobase_hton->file_extensions = ha_innobase_exts;
@@ -6402,6 +6423,154 @@ bool innobase_match_index_columns(const KEY *key_info,
   return TRUE;
 }
 
+/** Parse the column compression settings in the ENGINE_ATTRIBUTE of a
+column, e.g. {"compression": "zstd", "compression_level": 3}.
+@param[in]	field	MySQL field
+@param[out]	level	zstd compression level, or 0 if not compressed
+@return nullptr if the attribute is valid, the problem otherwise */
+static const char *innobase_parse_column_compress(const Field *field,
+                                                  ulint *level) {
+  *level = 0;
+
+  if (field->m_engine_attribute.length == 0) {
+    return nullptr;
+  }
+
+  const char *errmsg = nullptr;
+  size_t offset = 0;
+  Json_dom_ptr dom =
+      Json_dom::parse(field->m_engine_attribute.str,
+                      field->m_engine_attribute.length, &errmsg, &offset);
+
+  if (dom == nullptr || dom->json_type() != enum_json_type::J_OBJECT) {
+    return "it is not a JSON object";
+  }
+
+  bool compress = false;
+  ulint compress_level = lob::COMPRESS_DEFAULT_LEVEL;
+
+  for (const auto &member : *down_cast<const Json_object *>(dom.get())) {
+    const Json_dom *value = member.second.get();
+
+    if (member.first == "compression") {
+      if (value->json_type() != enum_json_type::J_STRING) {
+        return "\"compression\" must be \"zstd\" or \"none\"";
+      }
+
+      const std::string &name = down_cast<const Json_string *>(value)->value();
+
+      if (innobase_strcasecmp(name.c_str(), "zstd") == 0) {
+        compress = true;
+      } else if (innobase_strcasecmp(name.c_str(), "none") == 0) {
+        compress = false;
+      } else {
+        return "\"compression\" must be \"zstd\" or \"none\"";
+      }
+    } else if (member.first == "compression_level") {
+      longlong n = 0;
+
+      if (value->json_type() == enum_json_type::J_INT) {
+        n = down_cast<const Json_int *>(value)->value();
+      } else if (value->json_type() == enum_json_type::J_UINT) {
+        n = static_cast<longlong>(std::min<ulonglong>(
+            down_cast<const Json_uint *>(value)->value(), LLONG_MAX));
+      }
+
+      if (n < 1 || n > static_cast<longlong>(lob::COMPRESS_MAX_LEVEL)) {
+        return "\"compression_level\" must be an integer from 1 to 22";
+      }
+
+      compress_level = static_cast<ulint>(n);
+    } else {
+      return "only \"compression\" and \"compression_level\" are supported";
+    }
+  }
+
+  if (compress) {
+    *level = compress_level;
+  }
+
+  return nullptr;
+}
+
+ulint innobase_column_compress_level(const Field *field) {
+  ulint level;
+
+  if (innobase_parse_column_compress(field, &level) != nullptr) {
+    /* Rejected by innobase_column_compress_is_valid() when the
+    table was created. */
+    return 0;
+  }
+
+  return level;
+}
+
+bool innobase_column_compress_is_valid(THD *thd, const TABLE *table) {
+  const char *engine = innobase_hton_name;
+
+  if (table->s->engine_attribute.length > 0) {
+    if (thd != nullptr) {
+      push_warning_printf(thd, Sql_condition::SL_WARNING,
+                          ER_ILLEGAL_HA_CREATE_OPTION,
+                          "%s: ENGINE_ATTRIBUTE is only supported on"
+                          " columns.",
+                          engine);
+    }
+    return false;
+  }
+
+  for (uint k = 0; k < table->s->keys; k++) {
+    if (table->key_info[k].engine_attribute.length > 0) {
+      if (thd != nullptr) {
+        push_warning_printf(thd, Sql_condition::SL_WARNING,
+                            ER_ILLEGAL_HA_CREATE_OPTION,
+                            "%s: ENGINE_ATTRIBUTE is only supported on"
+                            " columns.",
+                            engine);
+      }
+      return false;
+    }
+  }
+
+  for (uint i = 0; i < table->s->fields; i++) {
+    const Field *field = table->field[i];
+    ulint level;
+    const char *problem = innobase_parse_column_compress(field, &level);
+
+    if (problem == nullptr && level > 0) {
+      if (innobase_is_v_fld(field)) {
+        problem = "a virtual column can not be compressed";
+      } else if (field->type() != MYSQL_TYPE_BLOB &&
+                 field->type() != MYSQL_TYPE_JSON) {
+        problem = "only BLOB, TEXT and JSON columns can be compressed";
+      } else {
+        for (uint k = 0; k < table->s->keys && problem == nullptr; k++) {
+          const KEY *key = &table->key_info[k];
+
+          for (uint p = 0; p < key->user_defined_key_parts; p++) {
+            if (key->key_part[p].fieldnr == field->field_index() + 1) {
+              problem = "an indexed column can not be compressed";
+              break;
+            }
+          }
+        }
+      }
+    }
+
+    if (problem != nullptr) {
+      if (thd != nullptr) {
+        push_warning_printf(thd, Sql_condition::SL_WARNING,
+                            ER_ILLEGAL_HA_CREATE_OPTION,
+                            "%s: invalid ENGINE_ATTRIBUTE of column '%s': %s.",
+                            engine, field->field_name, problem);
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
 /** Build a template for a base column for a virtual column
 @param[in]	table		MySQL TABLE
 @param[in]	clust_index	InnoDB clustered index
@@ -6450,6 +6619,10 @@ static void innobase_vcol_build_templ(const TABLE *table,
     templ->is_multi_val = false;
   }
 
+  templ->compress_level =
+      templ->is_virtual ? 0 : innobase_column_compress_level(field);
+  templ->json_projection = nullptr;
+
   templ->type = col->mtype;
   templ->mysql_type = static_cast<ulint>(field->type());
 
@@ -7999,6 +8172,11 @@ static mysql_row_templ_t *build_template_field(
     templ->mysql_mvidx_len = 0;
     templ->is_multi_val = false;
   }
+  templ->compress_level =
+      templ->is_virtual ? 0 : innobase_column_compress_level(field);
+  templ->json_projection =
+      templ->is_virtual ? nullptr
+                        : table->json_projection(field->field_index());
   templ->type = col->mtype;
   templ->mysql_type = (ulint)field->type();
 
@@ -9043,6 +9221,11 @@ static dberr_t calc_row_difference(
   /* We use upd_buff to convert changed fields */
   buf = (byte *)upd_buff;
 
+  /* Compressed values of the previous row are no longer referenced */
+  if (prebuilt->compress_heap != nullptr) {
+    mem_heap_empty(prebuilt->compress_heap);
+  }
+
   for (i = 0; i < n_fields; i++) {
     dfield.reset();
 
@@ -9199,6 +9382,8 @@ static dberr_t calc_row_difference(
       /* The field has changed */
       bool multi_value_calc_by_diff = false;
       dfield_t old_field, new_field;
+      ulint compress_level =
+          is_virtual ? 0 : innobase_column_compress_level(field);
 
       ufield = uvect->fields + n_changed;
 
@@ -9240,6 +9425,10 @@ static dberr_t calc_row_difference(
           buf = row_mysql_store_col_in_innobase_format(&dfield, (byte *)buf,
                                                        TRUE, new_mysql_row_col,
                                                        col_pack_len, comp);
+
+          if (compress_level > 0) {
+            row_mysql_compress_col(&dfield, compress_level, prebuilt);
+          }
         }
 
         if (multi_value_calc_by_diff) {
@@ -9254,7 +9443,9 @@ static dberr_t calc_row_difference(
 
       ufield->exp = nullptr;
       ufield->orig_len = 0;
-      ufield->mysql_field = field;
+      /* A compressed value can not be patched in place, so do not
+      let the binary diffs of a JSON column reach the LOB code. */
+      ufield->mysql_field = compress_level > 0 ? nullptr : field;
 
       if (is_virtual) {
         dfield_t *vfield = dtuple_get_nth_v_field(uvect->old_vrow, num_v);
@@ -9745,6 +9936,8 @@ int ha_innobase::index_end(void) {
 
   in_range_check_pushed_down = FALSE;
 
+  m_prebuilt->end_batch_lookup();
+
   m_ds_mrr.dsmrr_close();
 
   return 0;
@@ -10362,8 +10555,8 @@ int ha_innobase::sample_init(void *&scan_ctx, double sampling_percentage,
     return (err);
   }
 
-  /* Parallel read is not currently supported for sampling. */
-  size_t n_threads = Parallel_reader::available_threads(1);
+  size_t n_threads =
+      Parallel_reader::available_threads(srv_histogram_sampling_threads);
 
   if (n_threads == 0) {
     return HA_ERR_SAMPLING_INIT_FAILED;
@@ -13209,6 +13402,10 @@ int create_table_info_t::prepare_create_table(const char *name) {
     return HA_WRONG_CREATE_OPTION;
   }
 
+  if (!innobase_column_compress_is_valid(m_thd, m_form)) {
+    return HA_WRONG_CREATE_OPTION;
+  }
+
   /* Create the table flags and flags2 */
   if (flags() == 0 && flags2() == 0) {
     if (!innobase_table_flags()) {
@@ -16203,6 +16400,112 @@ int ha_innobase::records(ha_rows *num_rows) /*!< out: number of rows */
   return 0;
 }
 
+int ha_innobase::column_aggregate(const Field *field, ha_rows *num_not_null,
+                                  my_decimal *sum) {
+  DBUG_TRACE;
+
+  update_thd();
+
+  if (dict_table_is_discarded(m_prebuilt->table)) {
+    ib_senderrf(m_user_thd, IB_LOG_LEVEL_ERROR, ER_TABLESPACE_DISCARDED,
+                table->s->table_name.str);
+    return HA_ERR_NO_SUCH_TABLE;
+  } else if (m_prebuilt->table->ibd_file_missing) {
+    ib_senderrf(m_user_thd, IB_LOG_LEVEL_ERROR, ER_TABLESPACE_MISSING,
+                table->s->table_name.str);
+    return HA_ERR_TABLESPACE_MISSING;
+  } else if (m_prebuilt->table->is_corrupted()) {
+    ib_errf(m_user_thd, IB_LOG_LEVEL_WARN, ER_INNODB_INDEX_CORRUPT,
+            "Table '%s' is corrupt.", table->s->table_name.str);
+    return HA_ERR_INDEX_CORRUPT;
+  }
+
+  std::vector<dict_index_t *> indexes{m_prebuilt->table->first_index()};
+
+  return column_aggregate_low(indexes, field, num_not_null, sum);
+}
+
+int ha_innobase::column_aggregate_low(std::vector<dict_index_t *> &indexes,
+                                      const Field *field,
+                                      ha_rows *num_not_null, my_decimal *sum) {
+  auto trx = m_prebuilt->trx;
+
+  /* The parallel reader reads a consistent view, without locks. */
+  if (m_prebuilt->select_lock_type != LOCK_NONE || m_prebuilt->ins_sel_stmt ||
+      innobase_is_v_fld(field)) {
+    return HA_ERR_WRONG_COMMAND;
+  }
+
+  for (auto index : indexes) {
+    if (!index->is_usable(trx)) {
+      return HA_ERR_TABLE_DEF_CHANGED;
+    }
+  }
+
+  /* The column number in dict_table_t::cols, which has no virtual columns */
+  ulint col_no = 0;
+
+  for (uint i = 0; i < field->field_index(); ++i) {
+    if (!innobase_is_v_fld(table->field[i])) {
+      ++col_no;
+    }
+  }
+
+  size_t n_threads = thd_parallel_read_threads(m_user_thd);
+
+  n_threads = Parallel_reader::available_threads(n_threads);
+
+  if (n_threads == 0) {
+    n_threads = Parallel_reader::available_threads(1, true);
+
+    if (n_threads == 0) {
+      return HA_ERR_OUT_OF_MEM;
+    }
+  }
+
+  TrxInInnoDB trx_in_innodb(trx);
+
+  trx_start_if_not_started_xa(trx, false);
+
+  if (trx->isolation_level > TRX_ISO_READ_UNCOMMITTED) {
+    trx_assign_read_view(trx);
+  }
+
+  trx->op_info = "aggregating a column";
+
+  ulint n_not_null{};
+  int64_t sum_high{};
+  uint64_t sum_low{};
+
+  auto err = row_mysql_parallel_column_aggregate(
+      trx, indexes, col_no, sum != nullptr, n_threads, &n_not_null, &sum_high,
+      &sum_low);
+
+  trx->op_info = "";
+
+  if (thd_killed(m_user_thd) || err == DB_INTERRUPTED) {
+    return HA_ERR_QUERY_INTERRUPTED;
+  } else if (err != DB_SUCCESS) {
+    return convert_error_code_to_mysql(err, 0, m_user_thd);
+  }
+
+  *num_not_null = n_not_null;
+
+  if (sum != nullptr) {
+    /* sum_high * 2^64 + sum_low */
+    my_decimal high, low, two_32, product;
+
+    int2my_decimal(E_DEC_FATAL_ERROR, sum_high, false, &high);
+    int2my_decimal(E_DEC_FATAL_ERROR, sum_low, true, &low);
+    int2my_decimal(E_DEC_FATAL_ERROR, 1LL << 32, false, &two_32);
+    my_decimal_mul(E_DEC_FATAL_ERROR, &product, &high, &two_32);
+    my_decimal_mul(E_DEC_FATAL_ERROR, &high, &product, &two_32);
+    my_decimal_add(E_DEC_FATAL_ERROR, sum, &high, &low);
+  }
+
+  return 0;
+}
+
 /** Estimates the number of index records in a range.
  @return estimated number of rows */
 
@@ -16321,6 +16624,115 @@ func_exit:
   return (ha_rows)n_rows;
 }
 
+/** Start reading the leaf page of an index the key would be on.
+@param[in]	keynr	index number
+@param[in]	key	key in the MySQL format
+@param[in]	length	key length */
+void ha_innobase::prefetch_key(uint keynr, const uchar *key, uint length) {
+  DBUG_TRACE;
+
+  ut_a(m_prebuilt->trx == thd_to_trx(ha_thd()));
+
+  if (m_prebuilt->table->is_intrinsic() ||
+      dict_table_is_discarded(m_prebuilt->table)) {
+    return;
+  }
+
+  dict_index_t *index = innobase_get_index(keynr);
+
+  if (index == nullptr || index->is_corrupted() ||
+      dict_index_is_spatial(index) || !index->is_usable(m_prebuilt->trx)) {
+    return;
+  }
+
+  TrxInInnoDB trx_in_innodb(m_prebuilt->trx);
+
+  const KEY *key_info = table->key_info + keynr;
+
+  mem_heap_t *heap =
+      mem_heap_create(key_info->actual_key_parts * sizeof(dfield_t) +
+                      sizeof(dtuple_t) + m_prebuilt->srch_key_val_len);
+
+  dtuple_t *tuple = dtuple_create(heap, key_info->actual_key_parts);
+  dict_index_copy_types(tuple, index, key_info->actual_key_parts);
+
+  /* Not srch_key_val1: the search tuple of the cursor points into it */
+  byte *buf =
+      static_cast<byte *>(mem_heap_alloc(heap, m_prebuilt->srch_key_val_len));
+
+  row_sel_convert_mysql_key_to_innobase(tuple, buf,
+                                        m_prebuilt->srch_key_val_len, index,
+                                        key, length, m_prebuilt->trx);
+
+  if (dtuple_get_n_fields(tuple) > 0) {
+    btr_cur_prefetch_leaf(index, tuple);
+  }
+
+  mem_heap_free(heap);
+}
+
+/** Start reading the leaf pages of the clustered index that a sorted batch of
+row positions are on, and let the following rnd_pos() calls reuse the leaf
+page of the previous position.
+@param[in]	positions	first position, in the format of ref
+@param[in]	count		number of positions
+@param[in]	stride		distance in bytes between two positions */
+void ha_innobase::prefetch_positions(const uchar *positions, size_t count,
+                                     size_t stride) {
+  DBUG_TRACE;
+
+  ut_a(m_prebuilt->trx == thd_to_trx(ha_thd()));
+
+  m_prebuilt->end_batch_lookup();
+
+  /* With a generated clustered index the positions are DB_ROW_ID values,
+  which index_read() does not search for */
+  if (count < 2 || m_prebuilt->clust_index_was_generated ||
+      m_prebuilt->table->is_intrinsic() ||
+      dict_table_is_discarded(m_prebuilt->table)) {
+    return;
+  }
+
+  dict_index_t *index = m_prebuilt->table->first_index();
+
+  if (index->is_corrupted()) {
+    return;
+  }
+
+  TrxInInnoDB trx_in_innodb(m_prebuilt->trx);
+
+  const KEY *key_info = table->key_info + table->s->primary_key;
+  const ulint n_fields = key_info->actual_key_parts;
+
+  mem_heap_t *heap = mem_heap_create(
+      count * (sizeof(dtuple_t *) + DTUPLE_EST_ALLOC(n_fields) +
+               m_prebuilt->srch_key_val_len));
+
+  const dtuple_t **tuples = static_cast<const dtuple_t **>(
+      mem_heap_alloc(heap, count * sizeof(*tuples)));
+  ulint n_tuples = 0;
+
+  for (size_t i = 0; i < count; ++i) {
+    dtuple_t *tuple = dtuple_create(heap, n_fields);
+    dict_index_copy_types(tuple, index, n_fields);
+
+    byte *buf = static_cast<byte *>(
+        mem_heap_alloc(heap, m_prebuilt->srch_key_val_len));
+
+    row_sel_convert_mysql_key_to_innobase(
+        tuple, buf, m_prebuilt->srch_key_val_len, index,
+        positions + i * stride, ref_length, m_prebuilt->trx);
+
+    if (dtuple_get_n_fields(tuple) > 0) {
+      tuples[n_tuples++] = tuple;
+    }
+  }
+
+  row_sel_begin_clust_batch(m_prebuilt, tuples, n_tuples);
+
+  mem_heap_free(heap);
+}
+
 /** Gives an UPPER BOUND to the number of rows in a table. This is used in
  filesort.cc.
  @return upper bound of rows */
@@ -21486,6 +21898,13 @@ static MYSQL_SYSVAR_ULONG(
     1,                     /* Minimum value */
     5000, 0);              /* Maximum value */
 
+static MYSQL_SYSVAR_BOOL(
+    purge_adaptive, srv_purge_adaptive, PLUGIN_VAR_OPCMDARG,
+    "Use all the purge threads and grow the purge batch up to 5000 pages "
+    "while the history list grows or an undo tablespace is larger than "
+    "innodb_max_undo_log_size, and give them back as purge catches up.",
+    nullptr, nullptr, FALSE);
+
 static MYSQL_SYSVAR_ULONG(purge_threads, srv_n_purge_threads,
                           PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_READONLY,
                           "Purge threads can be from 1 to 32. Default is 4.",
@@ -21511,6 +21930,21 @@ static MYSQL_SYSVAR_BOOL(
     "Stores each InnoDB table to an .ibd file in the database dir.", nullptr,
     nullptr, TRUE);
 
+static MYSQL_SYSVAR_BOOL(
+    background_drop_file, srv_background_drop_file, PLUGIN_VAR_OPCMDARG,
+    "Move the files of dropped or truncated tablespaces that are larger than "
+    "innodb_background_drop_file_step into #innodb_trash in the data "
+    "directory, and remove them in the background one step per second "
+    "instead of deleting them during the statement.",
+    nullptr, nullptr, FALSE);
+
+static MYSQL_SYSVAR_ULONGLONG(
+    background_drop_file_step, srv_background_drop_file_step,
+    PLUGIN_VAR_RQCMDARG,
+    "Bytes truncated off a file in #innodb_trash per second before it is "
+    "finally deleted.",
+    nullptr, nullptr, 1ULL << 30, 1 << 20, ~0ULL, 1 << 20);
+
 static MYSQL_SYSVAR_STR(ft_server_stopword_table,
                         innobase_server_stopword_table,
                         PLUGIN_VAR_OPCMDARG | PLUGIN_VAR_MEMALLOC,
@@ -21641,6 +22075,19 @@ static MYSQL_SYSVAR_ULONGLONG(
     " statistics (by ANALYZE, default 20)",
     nullptr, nullptr, 20, 1, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    stats_recalc_threads, srv_stats_recalc_threads, PLUGIN_VAR_RQCMDARG,
+    "Number of threads that recalculate the persistent statistics of changed"
+    " tables in the background, most modified tables first (default 1)",
+    nullptr, nullptr, 1, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(
+    stats_sample_threads, srv_stats_sample_threads, PLUGIN_VAR_RQCMDARG,
+    "Number of threads that sample the indexes of a table in parallel when"
+    " calculating persistent statistics, taken from the parallel read thread"
+    " budget (default 1)",
+    nullptr, nullptr, 1, 1, 64, 0);
+
 static MYSQL_SYSVAR_BOOL(
     adaptive_hash_index, btr_search_enabled, PLUGIN_VAR_OPCMDARG,
     "Enable InnoDB adaptive hash index (enabled by default). "
@@ -21656,6 +22103,21 @@ static MYSQL_SYSVAR_ULONG(
     "Number of InnoDB Adapative Hash Index Partitions. (default = 8). ",
     nullptr, nullptr, 8, 1, 512, 0);
 
+static MYSQL_SYSVAR_BOOL(
+    adaptive_hash_index_auto_tune, btr_search_auto_tune, PLUGIN_VAR_OPCMDARG,
+    "Stop building and searching the InnoDB adaptive hash index on indexes"
+    " where it serves too few searches for what it costs to maintain, and"
+    " retry those indexes periodically (disabled by default).",
+    nullptr, nullptr, false);
+
+static MYSQL_SYSVAR_ULONG(
+    adaptive_hash_index_min_hit_pct, btr_search_min_hit_pct,
+    PLUGIN_VAR_RQCMDARG,
+    "Percentage of the searches on an index that the adaptive hash index"
+    " must serve to stay enabled on it when"
+    " innodb_adaptive_hash_index_auto_tune is ON (default 20).",
+    nullptr, nullptr, 20, 1, 100, 0);
+
 static MYSQL_SYSVAR_ULONG(
     replication_delay, srv_replication_delay, PLUGIN_VAR_RQCMDARG,
     "Replication thread delay (ms) on the slave server if"
@@ -21839,6 +22301,28 @@ static MYSQL_SYSVAR_BOOL(
     "Load the buffer pool from a file named @@innodb_buffer_pool_filename",
     nullptr, nullptr, TRUE);
 
+static MYSQL_SYSVAR_BOOL(
+    tablespace_id_map, srv_tablespace_id_map,
+    PLUGIN_VAR_NOCMDARG | PLUGIN_VAR_READONLY,
+    "Write the tablespace ID of every .ibd file at a clean shutdown, so that "
+    "the startup scan does not read the header of the unchanged ones",
+    nullptr, nullptr, TRUE);
+
+static MYSQL_SYSVAR_ULONG(
+    buffer_pool_load_threads, srv_buffer_pool_load_threads,
+    PLUGIN_VAR_RQCMDARG,
+    "Number of threads reading the pages of a buffer pool load, each one "
+    "tablespace range at a time",
+    nullptr, nullptr, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_BOOL(
+    buffer_pool_load_throttle, srv_buffer_pool_load_throttle,
+    PLUGIN_VAR_RQCMDARG,
+    "Slow a buffer pool load down to @@innodb_io_capacity reads per second "
+    "while there is other activity. OFF loads as fast as the disks allow, "
+    "for warming a server that does not serve user traffic yet",
+    nullptr, nullptr, TRUE);
+
 static MYSQL_SYSVAR_ULONG(lru_scan_depth, srv_LRU_scan_depth,
                           PLUGIN_VAR_RQCMDARG,
                           "How deep to scan LRU to keep it clean", nullptr,
@@ -21924,6 +22408,19 @@ static MYSQL_SYSVAR_ULONG(ft_num_word_optimize, fts_num_word_optimize,
                           "for each optimize table call ",
                           nullptr, nullptr, 2000, 1000, 10000, 0);
 
+static MYSQL_SYSVAR_ULONG(ft_optimize_threads, fts_optimize_threads,
+                          PLUGIN_VAR_RQCMDARG,
+                          "InnoDB Fulltext search number of threads that "
+                          "optimize the auxiliary index tables of an index "
+                          "in parallel",
+                          nullptr, nullptr, 1, 1, FTS_NUM_AUX_INDEX, 0);
+
+static MYSQL_SYSVAR_ULONG(ft_optimize_words_per_sec,
+                          fts_optimize_words_per_sec, PLUGIN_VAR_RQCMDARG,
+                          "InnoDB Fulltext search maximum number of words "
+                          "that optimize rewrites per second, 0 for no limit",
+                          nullptr, nullptr, 0, 0, 1000000, 0);
+
 static MYSQL_SYSVAR_ULONG(ft_sort_pll_degree, fts_sort_pll_degree,
                           PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
                           "InnoDB Fulltext search parallel sort degree, will "
@@ -21940,6 +22437,22 @@ static MYSQL_SYSVAR_ULONGLONG(
     "Maximum modification log file size for online index creation", nullptr,
     nullptr, 128 << 20, 65536, ~0ULL, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    online_alter_log_apply_threads, srv_online_alter_log_apply_threads,
+    PLUGIN_VAR_RQCMDARG,
+    "Number of threads applying the modification log of an online table "
+    "rebuild, each one to the rows of its own partition of the PRIMARY KEY",
+    nullptr, nullptr, 4, 1, 64, 0);
+
+static MYSQL_SYSVAR_ULONG(
+    histogram_sampling_threads, srv_histogram_sampling_threads,
+    PLUGIN_VAR_RQCMDARG,
+    "Number of threads reading the pages sampled for a histogram",
+    nullptr, nullptr, 1,          /* Default. */
+    1,                            /* Minimum. */
+    Parallel_reader::MAX_THREADS, /* Maximum. */
+    0);
+
 static MYSQL_SYSVAR_BOOL(optimize_fulltext_only, innodb_optimize_fulltext_only,
                          PLUGIN_VAR_NOCMDARG,
                          "Only optimize the Fulltext index of the table",
@@ -21961,6 +22474,13 @@ static MYSQL_SYSVAR_ULONG(force_recovery, srv_force_recovery,
                           "the database becomes corrupt.",
                           nullptr, nullptr, 0, 0, 6, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    recovery_apply_threads, srv_recovery_apply_threads,
+    PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
+    "Number of threads applying redo log records during crash recovery, "
+    "each one to its own partition of the pages",
+    nullptr, nullptr, 4, 1, 64, 0);
+
 #ifdef UNIV_DEBUG
 static MYSQL_SYSVAR_ULONG(force_recovery_crash, srv_force_recovery_crash,
                           PLUGIN_VAR_RQCMDARG | PLUGIN_VAR_READONLY,
@@ -22402,6 +22922,12 @@ static MYSQL_SYSVAR_ULONG(
     " trigger a readahead.",
     nullptr, nullptr, 56, 0, 64, 0);
 
+static MYSQL_SYSVAR_ULONG(
+    logical_read_ahead, srv_logical_read_ahead, PLUGIN_VAR_RQCMDARG,
+    "Number of leaf pages that range scans read ahead in key order, taking"
+    " the page numbers from the parent pages. 0 disables it.",
+    nullptr, nullptr, 0, 0, 256, 0);
+
 static MYSQL_SYSVAR_STR(monitor_enable, innobase_enable_monitor_counter,
                         PLUGIN_VAR_RQCMDARG, "Turn on a monitor counter",
                         innodb_monitor_validate, innodb_enable_monitor_update,
@@ -22608,6 +23134,9 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(buffer_pool_load_now),
     MYSQL_SYSVAR(buffer_pool_load_abort),
     MYSQL_SYSVAR(buffer_pool_load_at_startup),
+    MYSQL_SYSVAR(buffer_pool_load_threads),
+    MYSQL_SYSVAR(tablespace_id_map),
+    MYSQL_SYSVAR(buffer_pool_load_throttle),
     MYSQL_SYSVAR(lru_scan_depth),
     MYSQL_SYSVAR(flush_neighbors),
     MYSQL_SYSVAR(checksum_algorithm),
@@ -22632,10 +23161,13 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(read_io_threads),
     MYSQL_SYSVAR(write_io_threads),
     MYSQL_SYSVAR(file_per_table),
+    MYSQL_SYSVAR(background_drop_file),
+    MYSQL_SYSVAR(background_drop_file_step),
     MYSQL_SYSVAR(flush_log_at_timeout),
     MYSQL_SYSVAR(flush_log_at_trx_commit),
     MYSQL_SYSVAR(flush_method),
     MYSQL_SYSVAR(force_recovery),
+    MYSQL_SYSVAR(recovery_apply_threads),
 #ifdef UNIV_DEBUG
     MYSQL_SYSVAR(force_recovery_crash),
 #endif /* UNIV_DEBUG */
@@ -22647,6 +23179,8 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(ft_max_token_size),
     MYSQL_SYSVAR(ft_min_token_size),
     MYSQL_SYSVAR(ft_num_word_optimize),
+    MYSQL_SYSVAR(ft_optimize_threads),
+    MYSQL_SYSVAR(ft_optimize_words_per_sec),
     MYSQL_SYSVAR(ft_sort_pll_degree),
     MYSQL_SYSVAR(force_load_corrupted),
     MYSQL_SYSVAR(lock_wait_timeout),
@@ -22708,14 +23242,20 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(stats_persistent),
     MYSQL_SYSVAR(stats_persistent_sample_pages),
     MYSQL_SYSVAR(stats_auto_recalc),
+    MYSQL_SYSVAR(stats_recalc_threads),
+    MYSQL_SYSVAR(stats_sample_threads),
     MYSQL_SYSVAR(adaptive_hash_index),
     MYSQL_SYSVAR(adaptive_hash_index_parts),
+    MYSQL_SYSVAR(adaptive_hash_index_auto_tune),
+    MYSQL_SYSVAR(adaptive_hash_index_min_hit_pct),
     MYSQL_SYSVAR(stats_method),
     MYSQL_SYSVAR(replication_delay),
     MYSQL_SYSVAR(status_file),
     MYSQL_SYSVAR(strict_mode),
     MYSQL_SYSVAR(sort_buffer_size),
     MYSQL_SYSVAR(online_alter_log_max_size),
+    MYSQL_SYSVAR(online_alter_log_apply_threads),
+    MYSQL_SYSVAR(histogram_sampling_threads),
     MYSQL_SYSVAR(directories),
     MYSQL_SYSVAR(sync_spin_loops),
     MYSQL_SYSVAR(spin_wait_delay),
@@ -22740,6 +23280,7 @@ static SYS_VAR *innobase_system_variables[] = {
 #endif /* UNIV_DEBUG || UNIV_IBUF_DEBUG */
     MYSQL_SYSVAR(random_read_ahead),
     MYSQL_SYSVAR(read_ahead_threshold),
+    MYSQL_SYSVAR(logical_read_ahead),
     MYSQL_SYSVAR(read_only),
 
     MYSQL_SYSVAR(io_capacity),
@@ -22752,6 +23293,7 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(monitor_reset_all),
     MYSQL_SYSVAR(purge_threads),
     MYSQL_SYSVAR(purge_batch_size),
+    MYSQL_SYSVAR(purge_adaptive),
 #ifdef UNIV_DEBUG
     MYSQL_SYSVAR(background_drop_list_empty),
     MYSQL_SYSVAR(purge_run_now),
@@ -22804,6 +23346,7 @@ static SYS_VAR *innobase_system_variables[] = {
     MYSQL_SYSVAR(interpreter_output),
 #endif /* UNIV_DEBUG */
     MYSQL_SYSVAR(parallel_read_threads),
+    MYSQL_SYSVAR(ddl_threads),
     nullptr};
 
 mysql_declare_plugin(innobase){
@@ -22832,7 +23375,8 @@ mysql_declare_plugin(innobase){
     i_s_innodb_ft_index_cache, i_s_innodb_ft_index_table, i_s_innodb_tables,
     i_s_innodb_tablestats, i_s_innodb_indexes, i_s_innodb_tablespaces,
     i_s_innodb_columns, i_s_innodb_virtual, i_s_innodb_cached_indexes,
-    i_s_innodb_session_temp_tablespaces
+    i_s_innodb_session_temp_tablespaces, i_s_innodb_adaptive_hash_indexes,
+    i_s_innodb_redo_log_histograms
 
     mysql_declare_plugin_end;
 
@@ -23080,6 +23624,14 @@ dfield_t *innobase_get_computed_value(
           dfield_get_len(row_field), false, *local_heap);
     }
 
+    if (len != UNIV_SQL_NULL && templ->compress_level > 0) {
+      if (*local_heap == nullptr) {
+        *local_heap = mem_heap_create(UNIV_PAGE_SIZE);
+      }
+
+      data = lob::decompress_column(data, len, *local_heap, &len);
+    }
+
     if (len == UNIV_SQL_NULL) {
       mysql_rec[templ->mysql_null_byte_offset] |=
           (byte)templ->mysql_null_bit_mask;
@@ -254,9 +254,17 @@ class ha_innobase : public handler {
     return ha_innobase::records(num_rows);
   }
 
+  int column_aggregate(const Field *field, ha_rows *num_not_null,
+                       my_decimal *sum) override;
+
   ha_rows records_in_range(uint inx, key_range *min_key,
                            key_range *max_key) override;
 
+  void prefetch_key(uint inx, const uchar *key, uint length) override;
+
+  void prefetch_positions(const uchar *positions, size_t count,
+                          size_t stride) override;
+
   ha_rows estimate_rows_upper_bound() override;
 
   void update_create_info(HA_CREATE_INFO *create_info) override;
@@ -542,6 +550,17 @@ class ha_innobase : public handler {
   int truncate_impl(const char *name, TABLE *form, dd::Table *table_def);
 
  protected:
+  /** Count and sum a column in clustered indexes of the table, with the
+  parallel reader, for column_aggregate().
+  @param[in]  indexes       Clustered indexes of the table or its partitions.
+  @param[in]  field         Column to aggregate, not virtual.
+  @param[out] num_not_null  Number of rows where it is not NULL.
+  @param[out] sum           Sum of the column, or nullptr.
+  @return 0 or error code */
+  int column_aggregate_low(std::vector<dict_index_t *> &indexes,
+                           const Field *field, ha_rows *num_not_null,
+                           my_decimal *sum);
+
   /** Enter InnoDB engine after checking max allowed threads.
   @return mysql error code. */
   int srv_concurrency_enter();
@@ -1244,6 +1263,19 @@ void innodb_base_col_setup(dict_table_t *table, const Field *field,
 void innodb_base_col_setup_for_stored(const dict_table_t *table,
                                       const Field *field, dict_s_col_t *s_col);
 
+/** Get the zstd compression level of a column, see lob0compress.h.
+@param[in]	field	MySQL field
+@return compression level, or 0 if the column is not compressed */
+ulint innobase_column_compress_level(const Field *field);
+
+/** Check the column compression settings of a table. Only BLOB, TEXT and
+JSON columns that are neither virtual nor part of any index can be
+compressed, and ENGINE_ATTRIBUTE is not supported on tables and indexes.
+@param[in]	thd	connection to report the problem to, or nullptr
+@param[in]	table	MySQL table definition
+@return true if the settings are valid */
+bool innobase_column_compress_is_valid(THD *thd, const TABLE *table);
+
 /** whether this is a stored column */
 #define innobase_is_s_fld(field) ((field)->gcol_info && (field)->stored_in_db)
 
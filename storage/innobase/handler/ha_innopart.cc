@@ -606,7 +606,9 @@ ha_innopart::ha_innopart(handlerton *hton, TABLE_SHARE *table_arg)
       m_sql_stat_start_parts(),
       m_pcur(),
       m_clust_pcur(),
-      m_new_partitions() {
+      m_new_partitions(),
+      m_deferring_part_stats(false),
+      m_rec_per_key_stale(false) {
   m_int_table_flags &= ~(HA_INNOPART_DISABLED_TABLE_FLAGS);
 
   /* INNOBASE_SHARE is not used in ha_innopart.
@@ -894,13 +896,15 @@ int ha_innopart::open(const char *name, int, uint, const dd::Table *table_def) {
   }
 
   /* Currently we track statistics for all partitions, but for
-  the secondary indexes we only use the biggest partition. */
+  the secondary indexes we only use the biggest partition.
+  Only the first partition gets its statistics loaded here, the
+  others are loaded by init_part_stats() when first used. */
 
   for (uint part_id = 0; part_id < m_tot_parts; part_id++) {
     innobase_copy_frm_flags_from_table_share(
         m_part_share->get_table_part(part_id), table->s);
-    dict_stats_init(m_part_share->get_table_part(part_id));
   }
+  dict_stats_init(m_part_share->get_table_part(0));
 
   MONITOR_INC(MONITOR_TABLE_OPEN);
 
@@ -1151,7 +1155,10 @@ int ha_innopart::open(const char *name, int, uint, const dd::Table *table_def) {
 
   m_sql_stat_start_parts.init(m_bitset, UT_BITS_IN_BYTES(m_tot_parts));
 
+  m_deferring_part_stats = true;
+  m_rec_per_key_stale = false;
   info(HA_STATUS_NO_LOCK | HA_STATUS_VARIABLE | HA_STATUS_CONST);
+  m_deferring_part_stats = false;
 
   return 0;
 }
@@ -1311,6 +1318,10 @@ void ha_innopart::set_partition(uint part_id) {
   m_prebuilt->ins_node = m_ins_node_parts[part_id];
   m_prebuilt->upd_node = m_upd_node_parts[part_id];
 
+  /* The partition is about to be read or written, so its modification
+  counter must be maintained from now on. */
+  init_part_stats(part_id);
+
   /* For unordered scan and table scan, use blob_heap from first
   partition as we need exactly one blob. */
   m_prebuilt->blob_heap = m_blob_heap_parts[m_ordered ? part_id : 0];
@@ -1330,6 +1341,24 @@ void ha_innopart::set_partition(uint part_id) {
   m_prebuilt->index = innopart_get_index(part_id, active_index);
 }
 
+/** Load the statistics of a partition if that has not been done yet.
+@param[in]	part_id	Partition to load the statistics for.
+@return	true if the statistics are available. */
+bool ha_innopart::init_part_stats(uint part_id) {
+  dict_table_t *ib_table = m_part_share->get_table_part(part_id);
+
+  if (ib_table->stat_initialized) {
+    return true;
+  }
+  if (m_deferring_part_stats) {
+    return false;
+  }
+
+  dict_stats_init(ib_table);
+  m_rec_per_key_stale = true;
+  return true;
+}
+
 /** Update active partition.
 Copies needed info from m_prebuilt into the partition specific memory.
 @param[in]	part_id	Partition to set as active. */
@@ -3271,6 +3300,39 @@ int ha_innopart::records(ha_rows *num_rows) {
   return 0;
 }
 
+int ha_innopart::column_aggregate(const Field *field, ha_rows *num_not_null,
+                                  my_decimal *sum) {
+  DBUG_TRACE;
+
+  update_thd(ha_thd());
+
+  std::vector<dict_index_t *> indexes{};
+
+  for (auto i = m_part_info->get_first_used_partition(); i < m_tot_parts;
+       i = m_part_info->get_next_used_partition(i)) {
+    set_partition(i);
+
+    if (dict_table_is_discarded(m_prebuilt->table)) {
+      ib_senderrf(ha_thd(), IB_LOG_LEVEL_ERROR, ER_TABLESPACE_DISCARDED,
+                  m_prebuilt->table->name.m_name);
+      return HA_ERR_NO_SUCH_TABLE;
+    }
+
+    indexes.push_back(m_prebuilt->table->first_index());
+  }
+
+  if (indexes.empty()) {
+    *num_not_null = 0;
+
+    if (sum != nullptr) {
+      int2my_decimal(E_DEC_FATAL_ERROR, 0, false, sum);
+    }
+    return 0;
+  }
+
+  return column_aggregate_low(indexes, field, num_not_null, sum);
+}
+
 /** Estimates the number of index records in a range.
 @param[in]	keynr	Index number.
 @param[in]	min_key	Start key value (or NULL).
@@ -3412,6 +3474,7 @@ ha_rows ha_innopart::estimate_rows_upper_bound() {
 
   for (uint i = m_part_info->get_first_used_partition(); i < m_tot_parts;
        i = m_part_info->get_next_used_partition(i)) {
+    init_part_stats(i);
     m_prebuilt->table = m_part_share->get_table_part(i);
     index = m_prebuilt->table->first_index();
 
@@ -3446,6 +3509,7 @@ double ha_innopart::scan_time() {
 
   for (uint i = m_part_info->get_first_used_partition(); i < m_tot_parts;
        i = m_part_info->get_next_used_partition(i)) {
+    init_part_stats(i);
     m_prebuilt->table = m_part_share->get_table_part(i);
     scan_time += ha_innobase::scan_time();
   }
@@ -3563,6 +3627,9 @@ int ha_innopart::info_low(uint flag, bool is_analyze) {
 
     for (uint i = m_part_info->get_first_used_partition(); i < m_tot_parts;
          i = m_part_info->get_next_used_partition(i)) {
+      if (!init_part_stats(i)) {
+        continue;
+      }
       ib_table = m_part_share->get_table_part(i);
       if ((flag & HA_STATUS_NO_LOCK) == 0) {
         dict_table_stats_lock(ib_table, RW_S_LATCH);
@@ -3676,13 +3743,25 @@ int ha_innopart::info_low(uint flag, bool is_analyze) {
     }
   }
 
+  /* Partitions loaded their statistics lazily since rec_per_key was
+  computed, so the biggest partition may have changed. */
+  if ((flag & HA_STATUS_VARIABLE) != 0 && m_rec_per_key_stale &&
+      !m_deferring_part_stats) {
+    flag |= HA_STATUS_CONST;
+  }
+
   if ((flag & HA_STATUS_CONST) != 0) {
-    /* Find max rows and biggest partition. */
+    m_rec_per_key_stale = false;
+    /* Find max rows and biggest partition. Partitions whose statistics
+    are not loaded yet are not considered. */
     for (uint i = 0; i < m_tot_parts; i++) {
       /* Skip partitions from above. */
       if ((flag & HA_STATUS_VARIABLE) == 0 ||
           !bitmap_is_set(&(m_part_info->read_partitions), i)) {
         ib_table = m_part_share->get_table_part(i);
+        if (!ib_table->stat_initialized) {
+          continue;
+        }
         if (ib_table->stat_n_rows > max_rows) {
           max_rows = ib_table->stat_n_rows;
           biggest_partition = i;
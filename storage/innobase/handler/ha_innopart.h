@@ -416,6 +416,9 @@ class ha_innopart : public ha_innobase,
   ha_rows records_in_range(uint inx, key_range *min_key,
                            key_range *max_key) override;
 
+  /** The partition a key is in is not known: nothing is read. */
+  void prefetch_key(uint, const uchar *, uint) override {}
+
   ha_rows estimate_rows_upper_bound() override;
 
   uint alter_table_flags(uint flags);
@@ -645,6 +648,17 @@ class ha_innopart : public ha_innobase,
   /** New partitions during ADD/REORG/... PARTITION. */
   Altered_partitions *m_new_partitions;
 
+  /** True while ::open() collects the initial statistics. Partitions
+  whose statistics are not loaded yet are then skipped instead of
+  being loaded, so that opening a table with many partitions does not
+  read the persistent statistics of every partition up front. */
+  bool m_deferring_part_stats;
+
+  /** True if statistics of some partition were loaded after the
+  index cardinality (rec_per_key) was last computed, so the next
+  HA_STATUS_VARIABLE request also refreshes it. */
+  bool m_rec_per_key_stale;
+
   /** Clear used ins_nodes and upd_nodes. */
   void clear_ins_upd_nodes();
 
@@ -695,6 +709,13 @@ class ha_innopart : public ha_innobase,
   @param[in]	part_id	Partition to set as active. */
   void set_partition(uint part_id);
 
+  /** Load the statistics of a partition if that has not been done yet.
+  Statistics are loaded lazily, the first time a partition is used after
+  pruning, instead of for all partitions in ::open().
+  @param[in]	part_id	Partition to load the statistics for.
+  @return	true if the statistics are available. */
+  bool init_part_stats(uint part_id);
+
   /** Update active partition.
   Copies needed info from m_prebuilt into the partition specific memory.
   @param[in]	part_id	Partition to set as active. */
@@ -1099,6 +1120,9 @@ class ha_innopart : public ha_innobase,
     return ha_innopart::records(num_rows);
   }
 
+  int column_aggregate(const Field *field, ha_rows *num_not_null,
+                       my_decimal *sum) override;
+
   int index_next(uchar *record) override {
     return (Partition_helper::ph_index_next(record));
   }
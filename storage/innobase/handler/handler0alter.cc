@@ -666,6 +666,35 @@ static MY_ATTRIBUTE((warn_unused_result)) bool innobase_need_rebuild(
   return (!!(ha_alter_info->handler_flags & INNOBASE_ALTER_REBUILD));
 }
 
+/** Check whether ALTER TABLE adds a compressed column, see lob0compress.h.
+Changes of the compression of an existing column are flagged by the server
+as ALTER_STORED_COLUMN_TYPE.
+@param[in]	old_table	MySQL table before ALTER TABLE
+@param[in]	altered_table	MySQL table after ALTER TABLE
+@return true if a compressed column does not exist in old_table */
+static bool innobase_column_compress_added(const TABLE *old_table,
+                                           const TABLE *altered_table) {
+  for (uint i = 0; i < altered_table->s->fields; i++) {
+    const Field *field = altered_table->field[i];
+
+    if (innobase_column_compress_level(field) == 0) {
+      continue;
+    }
+
+    bool found = false;
+
+    for (uint j = 0; j < old_table->s->fields && !found; j++) {
+      found = strcmp(old_table->field[j]->field_name, field->field_name) == 0;
+    }
+
+    if (!found) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /** Check if InnoDB supports a particular alter table in-place
 @param altered_table TABLE object for new version of table.
 @param ha_alter_info Structure describing changes to be done
@@ -719,6 +748,20 @@ enum_alter_inplace_result ha_innobase::check_if_supported_inplace_alter(
     return HA_ALTER_INPLACE_NOT_SUPPORTED;
   }
 
+  if (!innobase_column_compress_is_valid(ha_thd(), altered_table)) {
+    my_error(ER_ILLEGAL_HA_CREATE_OPTION, MYF(0), table_type(),
+             "ENGINE_ATTRIBUTE");
+    return HA_ALTER_ERROR;
+  }
+
+  /* Column compression is applied when rows are written, so adding
+  a compressed column needs a table copy. */
+  if (innobase_column_compress_added(table, altered_table)) {
+    ha_alter_info->unsupported_reason =
+        "Adding a compressed column requires a table copy";
+    return HA_ALTER_INPLACE_NOT_SUPPORTED;
+  }
+
   update_thd();
 
   if (ha_alter_info->handler_flags &
@@ -42,6 +42,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "auth_acls.h"
 #include "btr0btr.h"
 #include "btr0pcur.h"
+#include "btr0sea.h"
 #include "btr0types.h"
 #include "buf0buddy.h"
 #include "buf0buf.h"
@@ -59,6 +60,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fut0fut.h"
 #include "ha_prototypes.h"
 #include "ibuf0ibuf.h"
+#include "log0stats.h"
 #include "mysql/plugin.h"
 #include "page0zip.h"
 #include "pars0pars.h"
@@ -7360,3 +7362,439 @@ struct st_mysql_plugin i_s_innodb_session_temp_tablespaces = {
     /* unsigned long */
     STRUCT_FLD(flags, 0UL),
 };
+
+/**  INNODB_ADAPTIVE_HASH_INDEXES  ***********************************/
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_ADAPTIVE_HASH_INDEXES
+Every time any column gets changed, added or removed, please remember
+to change i_s_innodb_plugin_version_postfix accordingly, so that
+the change can be propagated to server */
+static ST_FIELD_INFO innodb_ahi_fields_info[] = {
+#define INNODB_AHI_TABLE_ID 0
+    {STRUCT_FLD(field_name, "TABLE_ID"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_INDEX_ID 1
+    {STRUCT_FLD(field_name, "INDEX_ID"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_TABLE_NAME 2
+    {STRUCT_FLD(field_name, "TABLE_NAME"),
+     STRUCT_FLD(field_length, MAX_FULL_NAME_LEN + 1),
+     STRUCT_FLD(field_type, MYSQL_TYPE_STRING), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, 0), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_INDEX_NAME 3
+    {STRUCT_FLD(field_name, "INDEX_NAME"),
+     STRUCT_FLD(field_length, NAME_LEN + 1),
+     STRUCT_FLD(field_type, MYSQL_TYPE_STRING), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, 0), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_STATUS 4
+    {STRUCT_FLD(field_name, "STATUS"), STRUCT_FLD(field_length, 9),
+     STRUCT_FLD(field_type, MYSQL_TYPE_STRING), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, 0), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_HASHED_PAGES 5
+    {STRUCT_FLD(field_name, "HASHED_PAGES"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_HASH_SEARCHES 6
+    {STRUCT_FLD(field_name, "HASH_SEARCHES"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_BTREE_SEARCHES 7
+    {STRUCT_FLD(field_name, "BTREE_SEARCHES"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_ROWS_ADDED 8
+    {STRUCT_FLD(field_name, "ROWS_ADDED"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_ROWS_REMOVED 9
+    {STRUCT_FLD(field_name, "ROWS_REMOVED"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_AHI_TIMES_DISABLED 10
+    {STRUCT_FLD(field_name, "TIMES_DISABLED"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+    END_OF_ST_FIELD_INFO};
+
+/** Adaptive hash index statistics of one index, copied while holding
+dict_sys->mutex */
+struct ahi_index_info_t {
+  table_id_t m_table_id;
+  space_index_t m_index_id;
+  std::string m_table_name;
+  std::string m_index_name;
+  bool m_disabled;
+  ulint m_hashed_pages;
+  ulint m_hash_searches;
+  ulint m_btree_searches;
+  ulint m_rows_added;
+  ulint m_rows_removed;
+  ulint m_times_disabled;
+};
+
+/** Copy the adaptive hash index statistics of the indexes of a table
+which the adaptive hash index was used on.
+@param[in]	table	cached table
+@param[in,out]	cache	statistics are appended here */
+static void i_s_innodb_ahi_populate_cache(const dict_table_t *table,
+                                          std::vector<ahi_index_info_t> *cache) {
+  for (const dict_index_t *index = table->first_index(); index != nullptr;
+       index = index->next()) {
+    const btr_search_t *info = index->search_info;
+
+    if (info == nullptr || index->disable_ahi ||
+        dict_index_is_spatial(index) || dict_index_is_ibuf(index)) {
+      continue;
+    }
+
+    if (info->ref_count == 0 && info->n_ahi_searches == 0 &&
+        info->n_ahi_btree_searches == 0) {
+      continue;
+    }
+
+    ahi_index_info_t row;
+
+    row.m_table_id = table->id;
+    row.m_index_id = index->id;
+    row.m_table_name = table->name.m_name;
+    row.m_index_name = index->name();
+    row.m_disabled = info->ahi_disabled;
+    row.m_hashed_pages = info->ref_count;
+    row.m_hash_searches = info->n_ahi_searches;
+    row.m_btree_searches = info->n_ahi_btree_searches;
+    row.m_rows_added = info->n_ahi_rows_added;
+    row.m_rows_removed = info->n_ahi_rows_removed;
+    row.m_times_disabled = info->n_ahi_disabled;
+
+    cache->push_back(row);
+  }
+}
+
+/** Fill INFORMATION_SCHEMA.INNODB_ADAPTIVE_HASH_INDEXES from the indexes
+of the tables in the dictionary cache.
+@param[in]	thd	thread
+@param[in,out]	tables	tables to fill
+@return 0 on success */
+static int i_s_innodb_ahi_fill_table(THD *thd, TABLE_LIST *tables,
+                                     Item * /* not used */) {
+  DBUG_TRACE;
+
+  /* deny access to user without PROCESS_ACL privilege */
+  if (check_global_access(thd, PROCESS_ACL)) {
+    return 0;
+  }
+
+  std::vector<ahi_index_info_t> cache;
+
+  mutex_enter(&dict_sys->mutex);
+
+  for (const dict_table_t *table = UT_LIST_GET_FIRST(dict_sys->table_LRU);
+       table != nullptr; table = UT_LIST_GET_NEXT(table_LRU, table)) {
+    i_s_innodb_ahi_populate_cache(table, &cache);
+  }
+
+  for (const dict_table_t *table = UT_LIST_GET_FIRST(dict_sys->table_non_LRU);
+       table != nullptr; table = UT_LIST_GET_NEXT(table_LRU, table)) {
+    i_s_innodb_ahi_populate_cache(table, &cache);
+  }
+
+  mutex_exit(&dict_sys->mutex);
+
+  Field **fields = tables->table->field;
+
+  for (const ahi_index_info_t &row : cache) {
+    OK(fields[INNODB_AHI_TABLE_ID]->store(row.m_table_id, true));
+
+    OK(fields[INNODB_AHI_INDEX_ID]->store(row.m_index_id, true));
+
+    OK(field_store_string(fields[INNODB_AHI_TABLE_NAME],
+                          row.m_table_name.c_str()));
+
+    OK(field_store_string(fields[INNODB_AHI_INDEX_NAME],
+                          row.m_index_name.c_str()));
+
+    OK(field_store_string(fields[INNODB_AHI_STATUS],
+                          row.m_disabled ? "DISABLED" : "ENABLED"));
+
+    OK(fields[INNODB_AHI_HASHED_PAGES]->store(row.m_hashed_pages, true));
+
+    OK(fields[INNODB_AHI_HASH_SEARCHES]->store(row.m_hash_searches, true));
+
+    OK(fields[INNODB_AHI_BTREE_SEARCHES]->store(row.m_btree_searches, true));
+
+    OK(fields[INNODB_AHI_ROWS_ADDED]->store(row.m_rows_added, true));
+
+    OK(fields[INNODB_AHI_ROWS_REMOVED]->store(row.m_rows_removed, true));
+
+    OK(fields[INNODB_AHI_TIMES_DISABLED]->store(row.m_times_disabled, true));
+
+    OK(schema_table_store_record(thd, tables->table));
+  }
+
+  return 0;
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.INNODB_ADAPTIVE_HASH_INDEXES.
+@param[in,out]	p	table schema object
+@return 0 on success */
+static int innodb_ahi_init(void *p) {
+  ST_SCHEMA_TABLE *schema;
+
+  DBUG_TRACE;
+
+  schema = static_cast<ST_SCHEMA_TABLE *>(p);
+
+  schema->fields_info = innodb_ahi_fields_info;
+  schema->fill_table = i_s_innodb_ahi_fill_table;
+
+  return 0;
+}
+
+struct st_mysql_plugin i_s_innodb_adaptive_hash_indexes = {
+    /* the plugin type (a MYSQL_XXX_PLUGIN value) */
+    /* int */
+    STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+    /* pointer to type-specific plugin descriptor */
+    /* void* */
+    STRUCT_FLD(info, &i_s_info),
+
+    /* plugin name */
+    /* const char* */
+    STRUCT_FLD(name, "INNODB_ADAPTIVE_HASH_INDEXES"),
+
+    /* plugin author (for SHOW PLUGINS) */
+    /* const char* */
+    STRUCT_FLD(author, plugin_author),
+
+    /* general descriptive text (for SHOW PLUGINS) */
+    /* const char* */
+    STRUCT_FLD(descr, "InnoDB adaptive hash index usage per index"),
+
+    /* the plugin license (PLUGIN_LICENSE_XXX) */
+    /* int */
+    STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+    /* the function to invoke when plugin is loaded */
+    /* int (*)(void*); */
+    STRUCT_FLD(init, innodb_ahi_init),
+
+    /* the function to invoke when plugin is un installed */
+    /* int (*)(void*); */
+    nullptr,
+
+    /* the function to invoke when plugin is unloaded */
+    /* int (*)(void*); */
+    STRUCT_FLD(deinit, i_s_common_deinit),
+
+    /* plugin version (for SHOW PLUGINS) */
+    /* unsigned int */
+    STRUCT_FLD(version, i_s_innodb_plugin_version),
+
+    /* SHOW_VAR* */
+    STRUCT_FLD(status_vars, nullptr),
+
+    /* SYS_VAR** */
+    STRUCT_FLD(system_vars, nullptr),
+
+    /* reserved for dependency checking */
+    /* void* */
+    STRUCT_FLD(__reserved1, nullptr),
+
+    /* Plugin flags */
+    /* unsigned long */
+    STRUCT_FLD(flags, 0UL),
+};
+
+/**  INNODB_REDO_LOG_HISTOGRAMS  *************************************/
+/* Fields of the dynamic table INFORMATION_SCHEMA.INNODB_REDO_LOG_HISTOGRAMS
+Every time any column gets changed, added or removed, please remember
+to change i_s_innodb_plugin_version_postfix accordingly, so that
+the change can be propagated to server */
+static ST_FIELD_INFO innodb_redo_log_histograms_fields_info[] = {
+#define INNODB_REDO_LOG_HISTOGRAM_NAME 0
+    {STRUCT_FLD(field_name, "HISTOGRAM"), STRUCT_FLD(field_length, 64),
+     STRUCT_FLD(field_type, MYSQL_TYPE_STRING), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, 0), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_REDO_LOG_HISTOGRAM_UNIT 1
+    {STRUCT_FLD(field_name, "UNIT"), STRUCT_FLD(field_length, 16),
+     STRUCT_FLD(field_type, MYSQL_TYPE_STRING), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, 0), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_REDO_LOG_HISTOGRAM_UPPER_BOUND 2
+    {STRUCT_FLD(field_name, "BUCKET_UPPER_BOUND"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_REDO_LOG_HISTOGRAM_COUNT 3
+    {STRUCT_FLD(field_name, "COUNT"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+#define INNODB_REDO_LOG_HISTOGRAM_SUM 4
+    {STRUCT_FLD(field_name, "HISTOGRAM_SUM"),
+     STRUCT_FLD(field_length, MY_INT64_NUM_DECIMAL_DIGITS),
+     STRUCT_FLD(field_type, MYSQL_TYPE_LONGLONG), STRUCT_FLD(value, 0),
+     STRUCT_FLD(field_flags, MY_I_S_UNSIGNED), STRUCT_FLD(old_name, ""),
+     STRUCT_FLD(open_method, 0)},
+
+    END_OF_ST_FIELD_INFO};
+
+/** Fill INFORMATION_SCHEMA.INNODB_REDO_LOG_HISTOGRAMS with the non-empty
+buckets of the redo log histograms.
+@param[in]	thd	thread
+@param[in,out]	tables	tables to fill
+@return 0 on success */
+static int i_s_innodb_redo_log_histograms_fill_table(THD *thd,
+                                                     TABLE_LIST *tables,
+                                                     Item * /* not used */) {
+  DBUG_TRACE;
+
+  /* deny access to user without PROCESS_ACL privilege */
+  if (check_global_access(thd, PROCESS_ACL)) {
+    return 0;
+  }
+
+  Field **fields = tables->table->field;
+
+  for (size_t i = 0; i < LOG_HISTOGRAM_N; ++i) {
+    const auto histogram = static_cast<log_histogram_t>(i);
+    const Log_histogram &stats = log_histograms[i];
+    const uint64_t sum = stats.sum();
+
+    for (size_t bucket = 0; bucket < Log_histogram::N_BUCKETS; ++bucket) {
+      const uint64_t count = stats.count(bucket);
+
+      if (count == 0) {
+        continue;
+      }
+
+      OK(field_store_string(fields[INNODB_REDO_LOG_HISTOGRAM_NAME],
+                            log_histogram_name(histogram)));
+
+      OK(field_store_string(fields[INNODB_REDO_LOG_HISTOGRAM_UNIT],
+                            log_histogram_unit(histogram)));
+
+      OK(fields[INNODB_REDO_LOG_HISTOGRAM_UPPER_BOUND]->store(
+          Log_histogram::upper_bound(bucket), true));
+
+      OK(fields[INNODB_REDO_LOG_HISTOGRAM_COUNT]->store(count, true));
+
+      OK(fields[INNODB_REDO_LOG_HISTOGRAM_SUM]->store(sum, true));
+
+      OK(schema_table_store_record(thd, tables->table));
+    }
+  }
+
+  return 0;
+}
+
+/** Bind the dynamic table INFORMATION_SCHEMA.INNODB_REDO_LOG_HISTOGRAMS.
+@param[in,out]	p	table schema object
+@return 0 on success */
+static int innodb_redo_log_histograms_init(void *p) {
+  ST_SCHEMA_TABLE *schema;
+
+  DBUG_TRACE;
+
+  schema = static_cast<ST_SCHEMA_TABLE *>(p);
+
+  schema->fields_info = innodb_redo_log_histograms_fields_info;
+  schema->fill_table = i_s_innodb_redo_log_histograms_fill_table;
+
+  return 0;
+}
+
+struct st_mysql_plugin i_s_innodb_redo_log_histograms = {
+    /* the plugin type (a MYSQL_XXX_PLUGIN value) */
+    /* int */
+    STRUCT_FLD(type, MYSQL_INFORMATION_SCHEMA_PLUGIN),
+
+    /* pointer to type-specific plugin descriptor */
+    /* void* */
+    STRUCT_FLD(info, &i_s_info),
+
+    /* plugin name */
+    /* const char* */
+    STRUCT_FLD(name, "INNODB_REDO_LOG_HISTOGRAMS"),
+
+    /* plugin author (for SHOW PLUGINS) */
+    /* const char* */
+    STRUCT_FLD(author, plugin_author),
+
+    /* general descriptive text (for SHOW PLUGINS) */
+    /* const char* */
+    STRUCT_FLD(descr, "InnoDB redo log write, flush and wait histograms"),
+
+    /* the plugin license (PLUGIN_LICENSE_XXX) */
+    /* int */
+    STRUCT_FLD(license, PLUGIN_LICENSE_GPL),
+
+    /* the function to invoke when plugin is loaded */
+    /* int (*)(void*); */
+    STRUCT_FLD(init, innodb_redo_log_histograms_init),
+
+    /* the function to invoke when plugin is un installed */
+    /* int (*)(void*); */
+    nullptr,
+
+    /* the function to invoke when plugin is unloaded */
+    /* int (*)(void*); */
+    STRUCT_FLD(deinit, i_s_common_deinit),
+
+    /* plugin version (for SHOW PLUGINS) */
+    /* unsigned int */
+    STRUCT_FLD(version, i_s_innodb_plugin_version),
+
+    /* SHOW_VAR* */
+    STRUCT_FLD(status_vars, nullptr),
+
+    /* SYS_VAR** */
+    STRUCT_FLD(system_vars, nullptr),
+
+    /* reserved for dependency checking */
+    /* void* */
+    STRUCT_FLD(__reserved1, nullptr),
+
+    /* Plugin flags */
+    /* unsigned long */
+    STRUCT_FLD(flags, 0UL),
+};
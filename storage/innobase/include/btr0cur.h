@@ -566,6 +566,37 @@ int64_t btr_estimate_n_rows_in_range(dict_index_t *index,
                                      const dtuple_t *tuple2,
                                      page_cur_mode_t mode2);
 
+/** Start reading the leaf page where tuple would be into the buffer pool,
+without waiting for it. Only the non-leaf pages already in the buffer pool
+are searched; if one is not, nothing is read.
+@param[in]	index	index
+@param[in]	tuple	search tuple */
+void btr_cur_prefetch_leaf(dict_index_t *index, const dtuple_t *tuple);
+
+/** Start reading the leaf pages where a batch of tuples would be into the
+buffer pool, without waiting for them. The tuples must be sorted in index
+order; a level 1 page is then searched once for all the tuples that it routes,
+rather than descending from the root for each of them. Only the non-leaf
+pages already in the buffer pool are searched.
+@param[in]	index		index
+@param[in]	tuples		search tuples, in ascending order
+@param[in]	n_tuples	number of tuples */
+void btr_cur_prefetch_leaves(dict_index_t *index, const dtuple_t **tuples,
+                             ulint n_tuples);
+
+/** Logical read-ahead for a range scan: start reading the leaf pages that
+follow the one where tuple is, in key order, without waiting for them. The
+page numbers are taken from the node pointers on level 1, so the leaves need
+not be physically adjacent. Only the non-leaf pages already in the buffer pool
+are searched. The caller must not hold latches on the pages of index.
+@param[in]	index	index
+@param[in]	tuple	key on the leaf page being scanned
+@param[in]	n_pages	maximum number of leaf pages to read ahead
+@return number of leaf pages that follow the one of tuple and were
+requested, including the ones already in the buffer pool */
+ulint btr_cur_read_ahead_leaves(dict_index_t *index, const dtuple_t *tuple,
+                                ulint n_pages);
+
 /** Estimates the number of different key values in a given index, for
  each n-column prefix of the index where 1 <= n <=
  dict_index_get_n_unique(index). The estimates are stored in the array
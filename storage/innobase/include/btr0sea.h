@@ -269,6 +269,25 @@ struct btr_search_t {
                    the same prefix should be indexed in the
                    hash index */
                    /*---------------------- @} */
+  /** @{ Per index statistics used by btr_search_tune(). Like the fields
+  above they are not protected by any latch, so they are approximate. */
+  ulint n_ahi_searches;       /*!< searches served by the hash index */
+  ulint n_ahi_btree_searches; /*!< searches done in the B-tree */
+  ulint n_ahi_rows_added;     /*!< hash index entries added */
+  ulint n_ahi_rows_removed;   /*!< hash index entries removed */
+  ulint n_ahi_disabled;       /*!< number of times btr_search_tune()
+                              disabled the hash index on this index */
+  bool ahi_disabled;          /*!< true if btr_search_tune() found that
+                              the hash index does not pay off: it is
+                              then neither built nor searched until the
+                              next retry */
+  ulint tune_searches;        /*!< n_ahi_searches + n_ahi_btree_searches
+                              at the start of the current window */
+  ulint tune_hits;            /*!< n_ahi_searches at the start of the
+                              current window */
+  ulint tune_rows_added;      /*!< n_ahi_rows_added at the start of the
+                              current window */
+  /** @} */
 #ifdef UNIV_SEARCH_PERF_STAT
   ulint n_hash_succ; /*!< number of successful hash searches thus
                      far */
@@ -304,6 +323,14 @@ extern ulint btr_search_n_succ;
 extern ulint btr_search_n_hash_fail;
 #endif /* UNIV_SEARCH_PERF_STAT */
 
+/** Number of searches on an index after which btr_search_tune() checks
+whether the adaptive hash index pays off on it. */
+#define BTR_SEARCH_TUNE_WINDOW 65536
+
+/** An index on which the adaptive hash index was disabled by
+btr_search_tune() is tried again after this many windows. */
+#define BTR_SEARCH_TUNE_RETRY 16
+
 /** After change in n_fields or n_bytes in info, this many rounds are waited
 before starting the hash analysis again: this is to save CPU time when there
 is no hope in building a hash index. */
@@ -54,6 +54,14 @@ extern bool btr_search_enabled;
 /** Number of adaptive hash index partition. */
 extern ulong btr_ahi_parts;
 
+/** Whether the adaptive hash index is switched off for the indexes on
+which it does not pay off, see btr_search_t::ahi_disabled. */
+extern bool btr_search_auto_tune;
+
+/** Minimum percentage of searches on an index that the adaptive hash index
+must serve when btr_search_auto_tune is set. */
+extern ulong btr_search_min_hit_pct;
+
 /** The size of a reference to data stored on a different page.
 The reference is stored at the end of the prefix of the field
 in the index record. */
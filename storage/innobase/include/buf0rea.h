@@ -126,6 +126,20 @@ which could result in a deadlock if the OS does not support asynchronous io.
 ulint buf_read_ahead_linear(const page_id_t &page_id,
                             const page_size_t &page_size, bool inside_ibuf);
 
+/** Logical read-ahead: issues read requests for the given leaf pages of an
+index, which a range scan is expected to visit next, and which need not be
+physically adjacent. Pages already in the buffer pool are skipped. No more
+requests are issued once too many reads are pending in a buffer pool.
+NOTE: the calling thread may own latches on pages, and must not wait for
+the latches of the pages read.
+@param[in]	space_id	tablespace id
+@param[in]	page_size	page size
+@param[in]	page_nos	page numbers, in the order of the scan
+@param[in]	n_pages		number of page numbers
+@return number of page read requests issued */
+ulint buf_read_ahead_logical(space_id_t space_id, const page_size_t &page_size,
+                             const page_no_t *page_nos, ulint n_pages);
+
 /** Issues read requests for pages which the ibuf module wants to read in, in
 order to contract the insert buffer tree. Technically, this function is like
 a read-ahead function.
@@ -67,6 +67,11 @@ const char CLONE_INNODB_ERROR_FILE[] =
 const char CLONE_INNODB_FIXUP_FILE[] =
     CLONE_FILES_DIR OS_FILE_PREFIX "status_fix";
 
+/** Clone incremental base file name. Present in a cloned data directory
+till a server is started on it. */
+const char CLONE_INNODB_INCREMENTAL_FILE[] =
+    CLONE_FILES_DIR OS_FILE_PREFIX "incremental_base";
+
 /** Clone recovery status. */
 const char CLONE_INNODB_RECOVERY_FILE[] =
     CLONE_FILES_DIR OS_FILE_PREFIX "status_recovery";
@@ -591,6 +596,14 @@ class Clone_Handle {
     return (!is_copy_clone() && m_clone_dir == nullptr);
   }
 
+  /** @return true, if clone applies changes on top of an earlier clone
+  present in data directory. */
+  bool is_incremental() const { return (m_incremental_lsn != 0); }
+
+  /** Persist page tracking position of finished clone in data directory.
+  A later clone into the same directory uses it as incremental base. */
+  void write_incremental_base();
+
   /** Build locator descriptor for the clone handle
   @param[out]	loc_desc	locator descriptor */
   void build_descriptor(Clone_Desc_Locator *loc_desc);
@@ -720,6 +733,11 @@ class Clone_Handle {
   @return error code */
   int create_clone_directory();
 
+  /** Read incremental clone base from an existing clone data directory.
+  The directory must be the output of an earlier clone that is not started.
+  @return error code */
+  int read_incremental_base();
+
   /** Display clone progress
   @param[in]	cur_chunk	current chunk number
   @param[in]	max_chunk	total number of chunks
@@ -930,6 +948,12 @@ class Clone_Handle {
   /** Clone data directory */
   const char *m_clone_dir;
 
+  /** Incremental clone: base page tracking LSN, 0 for full clone */
+  lsn_t m_incremental_lsn;
+
+  /** Incremental clone: maximum tablespace ID in base */
+  space_id_t m_incremental_space_id;
+
   /** Clone task manager */
   Clone_Task_Manager m_clone_task_manager;
 };
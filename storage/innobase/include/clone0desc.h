@@ -39,6 +39,10 @@ this program; if not, write to the Free Software Foundation, Inc.,
 /** Invalid locator ID. */
 const ib_uint64_t CLONE_LOC_INVALID_ID = 0;
 
+/** First descriptor version carrying incremental clone information: base
+LSN and tablespace ID in locator and page tracking position in state. */
+const uint CLONE_DESC_INCREMENTAL_VERSION = 101;
+
 /** Maximum base length for any serialized descriptor. This is only used for
 optimal allocation and has no impact on version compatibility. */
 const uint32_t CLONE_DESC_MAX_BASE_LEN = 64;
@@ -374,6 +378,14 @@ struct Clone_Desc_Locator {
   /** Sub-state information: metadata transferred */
   bool m_metadata_transferred;
 
+  /** Incremental clone: page tracking LSN of the base clone present in
+  recipient data directory. Zero for full clone. */
+  uint64_t m_incremental_lsn;
+
+  /** Incremental clone: maximum tablespace ID when the base clone started
+  page tracking. Files of newer tablespaces are transferred in full. */
+  uint32_t m_incremental_space_id;
+
   /** Initialize clone locator.
   @param[in]	id	Clone identifier
   @param[in]	snap_id	Snapshot identifier
@@ -460,6 +472,12 @@ struct Clone_Desc_State {
   /** State transfer Acknowledgement */
   bool m_is_ack;
 
+  /** LSN at which donor started page tracking for the snapshot */
+  uint64_t m_track_lsn;
+
+  /** Maximum tablespace ID in donor when page tracking started */
+  uint32_t m_track_space_id;
+
   /** Initialize header
   @param[in]	version	descriptor version */
   void init_header(uint version);
@@ -499,6 +517,10 @@ struct Clone_File_Meta {
   and is not transferred. */
   bool m_punch_hole;
 
+  /** If file data is not transferred during file copy and the recipient
+  keeps its copy from the base clone. Set only for incremental clone. */
+  bool m_incremental;
+
   /** File system block size. */
   size_t m_fsblk_size;
 
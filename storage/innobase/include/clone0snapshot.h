@@ -85,6 +85,58 @@ using Clone_Page_Vec = std::vector<Clone_Page>;
 /** Set for storing unique page IDs. */
 using Clone_Page_Set = std::set<Clone_Page, Less_Clone_Page>;
 
+/** Result of adding a tracked page to the pages to copy */
+enum Clone_Page_Add {
+  /** Page of a tablespace not included in the clone */
+  CLONE_PAGE_SKIPPED,
+
+  /** Page added */
+  CLONE_PAGE_ADDED,
+
+  /** Page already added, e.g. tracked in more than one LSN range */
+  CLONE_PAGE_DUPLICATE
+};
+
+/** Add a tracked page to the pages to copy.
+@param[in]	file_map	tablespaces included in the clone
+@param[in,out]	page_set	pages to copy
+@param[in]	space_id	tablespace ID of the page
+@param[in]	page_no		page number
+@return whether the page was added */
+inline Clone_Page_Add clone_add_page(const Clone_File_Map &file_map,
+                                     Clone_Page_Set &page_set,
+                                     space_id_t space_id, page_no_t page_no) {
+  /* Skip pages belonging to tablespace not included for clone. This could
+  be some left over pages from drop or truncate in buffer pool which
+  would eventually get removed. Or it may be a page for an undo tablespace
+  that was deleted with BUF_REMOVE_NONE. */
+  if (file_map.count(space_id) == 0) {
+    return (CLONE_PAGE_SKIPPED);
+  }
+
+  Clone_Page cur_page;
+  cur_page.m_space_id = space_id;
+  cur_page.m_page_no = page_no;
+
+  auto result = page_set.insert(cur_page);
+
+  return (result.second ? CLONE_PAGE_ADDED : CLONE_PAGE_DUPLICATE);
+}
+
+/** Check if an incremental clone keeps the file of a tablespace present in
+the recipient. Tablespaces that existed when the base clone started page
+tracking are kept and only their pages modified since are sent. Newer ones,
+and all tablespaces of a full clone, are copied in full.
+@param[in]	base_lsn	page tracking LSN of base clone, 0 for full clone
+@param[in]	base_space_id	maximum tablespace ID in base clone
+@param[in]	space_id	tablespace ID
+@return true if the file data is not transferred */
+inline bool clone_incremental_keeps_file(lsn_t base_lsn,
+                                         space_id_t base_space_id,
+                                         space_id_t space_id) {
+  return (base_lsn != 0 && space_id <= base_space_id);
+}
+
 /** Clone handle type */
 enum Clone_Handle_Type {
   /** Clone Handle for COPY */
@@ -129,6 +181,34 @@ class Clone_Snapshot {
   /** @return estimated bytes on disk */
   uint64_t get_disk_estimate() const { return (m_data_bytes_disk); }
 
+  /** Set base of incremental clone. Files of tablespaces present in base are
+  not copied and only pages modified after base LSN are transferred.
+  @param[in]	base_lsn	page tracking LSN of base clone
+  @param[in]	base_space_id	maximum tablespace ID in base clone */
+  void set_incremental_base(lsn_t base_lsn, space_id_t base_space_id) {
+    m_incremental_lsn = base_lsn;
+    m_incremental_space_id = base_space_id;
+  }
+
+  /** @return true if snapshot transfers changes since an earlier clone */
+  bool is_incremental() const { return (m_incremental_lsn != 0); }
+
+  /** @return true if the file data of the tablespace is not transferred,
+  see clone_incremental_keeps_file() */
+  bool keeps_file(space_id_t space_id) const {
+    return (clone_incremental_keeps_file(m_incremental_lsn,
+                                         m_incremental_space_id, space_id));
+  }
+
+  /** Get page tracking position of the snapshot. For copy snapshot it is
+  the donor position, for apply snapshot the position received from donor.
+  @param[out]	track_lsn	page tracking start LSN, 0 if not tracked
+  @param[out]	track_space_id	maximum tablespace ID at tracking start */
+  void get_track_position(lsn_t &track_lsn, space_id_t &track_space_id) const {
+    track_lsn = m_track_lsn;
+    track_space_id = m_track_space_id;
+  }
+
   /** Get unique snapshot identifier
   @return snapshot ID */
   ib_uint64_t get_id() { return (m_snapshot_id); }
@@ -608,6 +688,18 @@ class Clone_Snapshot {
   /** Number of duplicate pages found */
   uint m_num_duplicate_pages;
 
+  /** LSN at which page tracking is started for the snapshot */
+  lsn_t m_track_lsn;
+
+  /** Maximum tablespace ID before page tracking is started */
+  space_id_t m_track_space_id;
+
+  /** Base LSN for incremental clone, 0 for full clone */
+  lsn_t m_incremental_lsn;
+
+  /** Maximum tablespace ID in the base of incremental clone */
+  space_id_t m_incremental_space_id;
+
   /** @name Snapshot redo data */
 
   /** redo log archiver client */
@@ -1525,6 +1525,10 @@ previous value.
 @param[in]	max_id		Maximum known tablespace ID */
 void fil_set_max_space_id_if_bigger(space_id_t max_id);
 
+/** @return the maximum tablespace ID assigned so far. Tablespaces created
+later get a bigger ID. Reserved IDs (undo, dictionary) are not counted. */
+space_id_t fil_get_max_space_id();
+
 #ifndef UNIV_HOTBACKUP
 
 /** Write the flushed LSN to the page header of the first page in the
@@ -1681,6 +1685,14 @@ for this table in the buffer pool.
 dberr_t fil_delete_tablespace(space_id_t space_id, buf_remove_t buf_remove)
     MY_ATTRIBUTE((warn_unused_result));
 
+#ifndef UNIV_HOTBACKUP
+/** Remove the files of dropped tablespaces that fil_delete_tablespace()
+moved into the trash directory, see innodb_background_drop_file. Each call
+truncates the oldest file by innodb_background_drop_file_step bytes, or
+deletes it once it is smaller than that. Called by the master thread. */
+void fil_purge_trash();
+#endif /* !UNIV_HOTBACKUP */
+
 /** Open a single-table tablespace and optionally check the space id is
 right in it. If not successful, print an error message to the error log. This
 function is used to open a tablespace when we start up mysqld, and also in
@@ -2242,6 +2254,12 @@ void fil_set_scan_dirs(const std::string &directories);
 @return DB_SUCCESS if all goes well */
 dberr_t fil_scan_for_tablespaces();
 
+/** Write the tablespace ID map read by the tablespace discovery at the
+next startup: the .ibd files it lists skip the header read while their
+modification time and size are unchanged. Written at a clean shutdown
+only, and removed when read. */
+void fil_write_scan_map();
+
 /** Open the tablespace and also get the tablespace filenames, space_id must
 already be known.
 @param[in]	space_id	Tablespace ID to lookup
@@ -157,6 +157,23 @@ extern ulong fts_sort_pll_degree;
 call */
 extern ulong fts_num_word_optimize;
 
+/** Variable specifying the number of threads that optimize the auxiliary
+index tables of a FULLTEXT index in parallel */
+extern ulong fts_optimize_threads;
+
+/** Variable specifying the maximum number of words optimized per second,
+0 for no limit */
+extern ulong fts_optimize_words_per_sec;
+
+/** How long FTS optimize must wait to keep below words_per_sec.
+@param[in]	start_ms	monotonic time the rate window started, in ms
+@param[in]	n_words		words optimized since start_ms
+@param[in]	words_per_sec	maximum rate, 0 for no limit
+@param[in]	now_ms		monotonic time now, in ms
+@return milliseconds to sleep, never negative */
+int64_t fts_optimize_throttle_delay(int64_t start_ms, ulint n_words,
+                                    ulint words_per_sec, int64_t now_ms);
+
 /** Variable specifying whether we do additional FTS diagnostic printout
 in the log */
 extern bool fts_enable_diag_print;
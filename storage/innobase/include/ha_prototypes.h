@@ -199,6 +199,12 @@ void thd_set_lock_wait_time(THD *thd,     /*!< in/out: thread handle */
 @retval NULL if innodb_tmpdir="" */
 const char *thd_innodb_tmpdir(THD *thd);
 
+/** Get the value of innodb_ddl_threads.
+@param[in]	thd	thread handle, or NULL to query
+                        the global innodb_ddl_threads.
+@return number of threads to sort index entries with in an index build */
+ulong thd_ddl_threads(THD *thd);
+
 #ifdef UNIV_DEBUG
 /** Obtain the value of the latest output from InnoDB Interpreter/Tester
 module (ib::Tester).
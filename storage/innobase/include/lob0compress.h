@@ -0,0 +1,94 @@
+/*****************************************************************************
+
+Copyright (c) 2021, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License, version 2.0, as published by the
+Free Software Foundation.
+
+This program is also distributed with certain software (including but not
+limited to OpenSSL) that is licensed under separate terms, as designated in a
+particular file or component or in included license documentation. The authors
+of MySQL hereby grant you an additional permission to link the program and
+your derivative works with the separately licensed software that they have
+included with MySQL.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License, version 2.0,
+for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+
+*****************************************************************************/
+
+/** @file include/lob0compress.h
+ Column level zstd compression of BLOB, TEXT and JSON values.
+
+ A column is compressed when its column ENGINE_ATTRIBUTE names the zstd
+ algorithm, e.g. ENGINE_ATTRIBUTE='{"compression":"zstd"}'.  The value is
+ compressed while the row is converted from the MySQL format to the InnoDB
+ format, so the record, the LOB pages, the undo log and the purge code only
+ ever see an opaque byte string.  Values are decompressed when a row is
+ converted back to the MySQL format, and only for the columns that the
+ statement reads.
+
+ Every value of a compressed column starts with a one byte header:
+
+ COMPRESS_NONE: the value follows unchanged. Used for short values and for
+ values that zstd cannot make smaller.
+
+ COMPRESS_ZSTD: a 4 byte big-endian original length follows, then a single
+ zstd frame. */
+
+#ifndef lob0compress_h
+#define lob0compress_h
+
+#include "mem0mem.h"
+#include "univ.i"
+
+namespace lob {
+
+/** Header byte of an uncompressed value. */
+const byte COMPRESS_NONE = 0;
+
+/** Header byte of a zstd compressed value. */
+const byte COMPRESS_ZSTD = 1;
+
+/** Size of the header of a zstd compressed value. */
+const ulint COMPRESS_ZSTD_HEADER_SIZE = 5;
+
+/** Values shorter than this are stored without compression. */
+const ulint COMPRESS_MIN_LEN = 128;
+
+/** Default zstd compression level. */
+const ulint COMPRESS_DEFAULT_LEVEL = 3;
+
+/** Highest accepted zstd compression level. */
+const ulint COMPRESS_MAX_LEVEL = 22;
+
+/** Compress a column value.
+@param[in]	data	value in the InnoDB format
+@param[in]	len	length of the value
+@param[in]	level	zstd compression level, 1 to COMPRESS_MAX_LEVEL
+@param[in,out]	heap	heap from which the result is allocated
+@param[out]	out_len	length of the stored value
+@return value to store in the record, allocated from heap */
+byte *compress_column(const byte *data, ulint len, ulint level,
+                      mem_heap_t *heap, ulint *out_len);
+
+/** Decompress a column value written by compress_column().
+A corrupted value is reported to the error log and read as an empty value.
+@param[in]	data	value as stored in the record
+@param[in]	len	length of the stored value
+@param[in,out]	heap	heap from which the result is allocated
+@param[out]	out_len	length of the original value
+@return the original value; points into data if it was not compressed */
+const byte *decompress_column(const byte *data, ulint len, mem_heap_t *heap,
+                              ulint *out_len);
+
+}  // namespace lob
+
+#endif /* lob0compress_h */
@@ -633,6 +633,25 @@ byte *btr_rec_copy_externally_stored_field_func(
                                             page_size, no, len, ver, heap)
 #endif /* UNIV_DEBUG */
 
+/** Reads a byte range of an externally stored field of a record. Only the
+LOB data pages that overlap the range are fetched. Ranged reads are not
+supported for compressed tables and LOBs in the pre-8.0 format, beyond
+their first bytes.
+@param[in]	index		the clustered index
+@param[in]	rec		record in a clustered index; must be
+                                protected by a lock or a page latch
+@param[in]	offsets		array returned by rec_get_offsets()
+@param[in]	page_size	BLOB page size
+@param[in]	no		field number
+@param[in]	offset		offset of the range in the field
+@param[in]	len		length of the range
+@param[out]	buf		buffer of at least len bytes
+@return true if the whole range was read */
+bool btr_rec_read_externally_stored_field_range(
+    const dict_index_t *index, const rec_t *rec, const ulint *offsets,
+    const page_size_t &page_size, ulint no, ulint offset, ulint len,
+    byte *buf);
+
 /** Gets the offset of the pointer to the externally stored part of a field.
 @param[in]	offsets		array returned by rec_get_offsets()
 @param[in]	n		index of the external field
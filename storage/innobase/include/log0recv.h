@@ -43,6 +43,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "ut0byte.h"
 #include "ut0new.h"
 
+#include <algorithm>
 #include <list>
 #include <set>
 #include <unordered_map>
@@ -252,6 +253,34 @@ pages.
                                 own the log mutex */
 void recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf);
 
+/** Read-ahead area in applying log records to file pages */
+constexpr size_t RECV_READ_AHEAD_AREA = 32;
+
+/** Least pages in a batch each redo apply thread is started for */
+constexpr size_t RECV_APPLY_MIN_PAGES = 1024;
+
+/** Number of threads applying a batch of hashed log records.
+@param[in]	batch_size	pages in the batch
+@param[in]	max_threads	innodb_recovery_apply_threads
+@return number of threads, at least one */
+inline ulint recv_apply_n_threads(size_t batch_size, ulint max_threads) {
+  return std::max<ulint>(
+      1, std::min<ulint>(max_threads, batch_size / RECV_APPLY_MIN_PAGES));
+}
+
+/** Partition of a page in a batch applied by several threads. All the
+records of a page are applied by the thread of its partition, in LSN
+order, and all the pages of a read-ahead area are in the same partition.
+@param[in]	space_id	tablespace of the page
+@param[in]	page_no		page number
+@param[in]	n_parts		number of partitions
+@return partition, less than n_parts */
+inline ulint recv_apply_partition(space_id_t space_id, page_no_t page_no,
+                                  ulint n_parts) {
+  return ut_fold_ulint_pair(space_id, page_no / RECV_READ_AHEAD_AREA) %
+         n_parts;
+}
+
 #if defined(UNIV_DEBUG) || defined(UNIV_HOTBACKUP)
 /** Return string name of the redo log record type.
 @param[in]	type	record log record enum
@@ -0,0 +1,162 @@
+/*****************************************************************************
+
+Copyright (c) 2021, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+
+*****************************************************************************/
+
+/**************************************************/ /**
+ @file include/log0stats.h
+
+ Redo log - latency and size histograms.
+
+ The histograms are updated by the log threads and by user threads which
+ wait for redo, without any latches. They are exposed through the
+ INFORMATION_SCHEMA.INNODB_REDO_LOG_HISTOGRAMS table.
+
+ *******************************************************/
+
+#ifndef log0stats_h
+#define log0stats_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "log0types.h"
+#include "srv0mon.h"
+
+/** Histogram with power-of-two buckets. Bucket 0 counts zero values and
+bucket i > 0 counts values in range [2^(i-1), 2^i). The last bucket also
+counts all values which are greater. */
+class Log_histogram {
+ public:
+  /** Number of buckets. */
+  static constexpr size_t N_BUCKETS = 32;
+
+  Log_histogram() { reset(); }
+
+  /** Registers a single value.
+  @param[in]	value	value to register */
+  void add(uint64_t value) {
+    m_buckets[bucket_for(value)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  /** Registers duration measured by Log_clock, in microseconds.
+  @param[in]	start	time point when the measured operation started
+  @param[in]	end	time point when the measured operation ended */
+  void add_time(Log_clock_point start, Log_clock_point end) {
+    /* Time could be moved backward in the middle. */
+    add(end < start ? 0
+                    : std::chrono::duration_cast<std::chrono::microseconds>(
+                          end - start)
+                          .count());
+  }
+
+  /** @return number of values registered in the given bucket */
+  uint64_t count(size_t bucket) const {
+    return (m_buckets[bucket].load(std::memory_order_relaxed));
+  }
+
+  /** @return sum of all registered values */
+  uint64_t sum() const { return (m_sum.load(std::memory_order_relaxed)); }
+
+  /** @return exclusive upper bound of values in the given bucket */
+  static uint64_t upper_bound(size_t bucket) {
+    return (bucket == 0 ? 1 : uint64_t{1} << bucket);
+  }
+
+  /** @return index of the bucket for the given value */
+  static size_t bucket_for(uint64_t value) {
+    size_t bucket = 0;
+    while (value != 0 && bucket < N_BUCKETS - 1) {
+      value >>= 1;
+      ++bucket;
+    }
+    return (bucket);
+  }
+
+  /** Resets all buckets. */
+  void reset() {
+    for (auto &bucket : m_buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  /** Counters of values per bucket. */
+  std::atomic<uint64_t> m_buckets[N_BUCKETS];
+
+  /** Sum of all registered values. */
+  std::atomic<uint64_t> m_sum;
+};
+
+/** Histograms maintained for the redo log. */
+enum log_histogram_t {
+  /** Size of a single write to redo log files (bytes). */
+  LOG_HISTOGRAM_WRITE_SIZE = 0,
+
+  /** Time of a single write to redo log files (microseconds). */
+  LOG_HISTOGRAM_WRITE_TIME,
+
+  /** Time of a single fsync of redo log files (microseconds). */
+  LOG_HISTOGRAM_FLUSH_TIME,
+
+  /** Time user threads waited in log_write_up_to() (microseconds). */
+  LOG_HISTOGRAM_USER_WAIT_TIME,
+
+  /** Time log_writer waited because checkpoint age reached the redo
+  capacity (microseconds). */
+  LOG_HISTOGRAM_CHECKPOINT_AGE_STALL,
+
+  /** Time user threads waited for free space in redo log files in
+  log_free_check() (microseconds). */
+  LOG_HISTOGRAM_FILE_SPACE_STALL,
+
+  /** Time user threads waited for free space in the log buffer
+  (microseconds). */
+  LOG_HISTOGRAM_BUFFER_SPACE_STALL,
+
+  /** Number of histograms. */
+  LOG_HISTOGRAM_N
+};
+
+/** Redo log histograms, indexed by log_histogram_t. */
+extern Log_histogram log_histograms[LOG_HISTOGRAM_N];
+
+/** @return name of the given histogram, as shown in I_S */
+const char *log_histogram_name(log_histogram_t histogram);
+
+/** Registers a stall which started at the given time and ends now, in the
+given histogram and in the given INNODB_METRICS time counter.
+@param[in]	histogram	histogram to update
+@param[in]	monitor		counter of total stall time (microseconds)
+@param[in]	stall_start	time when the stall started */
+void log_stall_register(log_histogram_t histogram, monitor_id_t monitor,
+                        Log_clock_point stall_start);
+
+/** @return unit of values registered in the given histogram */
+const char *log_histogram_unit(log_histogram_t histogram);
+
+#endif /* !log0stats_h */
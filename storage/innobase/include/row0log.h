@@ -44,6 +44,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "rem0types.h"
 #include "row0types.h"
 #include "trx0types.h"
+#include "ut0rnd.h"
 
 class ut_stage_alter_t;
 
@@ -213,6 +214,18 @@ of an ALTER TABLE for this index.
 ulint row_log_estimate_work(const dict_index_t *index);
 #endif /* HAVE_PSI_STAGE_INTERFACE */
 
+/** Fold one PRIMARY KEY field of a table rebuild log record into the hash
+that picks the row_log_table_apply_part() thread applying the record. Keys
+that compare equal must be stored alike, see row_log_table_n_parts().
+@param[in]	fold	hash of the preceding fields, 0 for the first one
+@param[in]	field	field data
+@param[in]	len	length of the field
+@return hash of the fields up to and including this one */
+inline ulint row_log_table_fold_field(ulint fold, const byte *field,
+                                      ulint len) {
+  return (ut_fold_ulint_pair(fold, ut_fold_binary(field, len)));
+}
+
 #include "row0log.ic"
 
 #endif /* row0log.h */
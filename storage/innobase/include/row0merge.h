@@ -133,6 +133,11 @@ struct row_merge_dup_t {
                         (index->table), or NULL if not
                         rebuilding table */
   ulint n_dup;          /*!< number of duplicates */
+  ulint error_key_num;  /*!< row_log_table_apply(): number of the
+                        index of a duplicate key error in the
+                        rebuilt table, see trx_t::error_key_num */
+  const dict_index_t *error_index; /*!< row_log_table_apply(): index
+                        of a duplicate key error, or NULL */
 };
 
 /** Report a duplicate key.
@@ -50,6 +50,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "gis0type.h"
 #include "lob0undo.h"
 #include "lock0types.h"
+#include "mach0data.h"
 #include "mem0mem.h"
 #include "my_compiler.h"
 #include "my_inttypes.h"
@@ -61,6 +62,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "trx0types.h"
 #include "univ.i"
 #include "ut0bool_scope_guard.h"
+#include "ut0cpu_cache.h"
 
 // Forward declarations
 class THD;
@@ -69,6 +71,9 @@ class innodb_session_t;
 namespace dd {
 class Table;
 }
+namespace json_binary {
+class Projection;
+}
 struct TABLE;
 struct btr_pcur_t;
 struct dfield_t;
@@ -184,6 +189,17 @@ byte *row_mysql_store_col_in_innobase_format(
                             payload data; if the column is a true
                             VARCHAR then this is irrelevant */
     ulint comp);            /*!< in: nonzero=compact format */
+
+/** Replace a BLOB, TEXT or JSON value in the InnoDB format with its
+compressed form, see lob0compress.h. The compressed value is allocated from
+prebuilt->compress_heap, which is emptied for every inserted or
+updated row.
+@param[in,out]	dfield		column value, not SQL NULL
+@param[in]	level		zstd compression level
+@param[in,out]	prebuilt	prebuilt struct of the table */
+void row_mysql_compress_col(dfield_t *dfield, ulint level,
+                            row_prebuilt_t *prebuilt);
+
 /** Handles user errors and lock waits detected by the database engine.
  @return true if it was a lock wait and we should continue running the
  query thread */
@@ -464,6 +480,63 @@ dberr_t row_mysql_parallel_select_count_star(
     trx_t *trx, std::vector<dict_index_t *> &indexes, size_t max_threads,
     ulint *n_rows);
 
+/** The number of non-NULL values of a column and their sum, which one
+row_mysql_parallel_column_aggregate() thread adds up. The sum is kept in
+128 bits, in two's complement, so that it cannot overflow. */
+struct alignas(ut::INNODB_CACHE_LINE_SIZE) Column_aggregate {
+  /** Number of values that are not NULL */
+  uint64_t m_n_not_null{};
+
+  /** Low 64 bits of the sum */
+  uint64_t m_low{};
+
+  /** High 64 bits of the sum */
+  int64_t m_high{};
+
+  /** Add a 128 bit value to the sum.
+  @param[in]	low	low 64 bits
+  @param[in]	high	high 64 bits */
+  void add(uint64_t low, int64_t high) {
+    m_low += low;
+    m_high += high + (m_low < low ? 1 : 0);
+  }
+
+  /** Add a value of a DATA_INT column, as stored in a record.
+  @param[in]	data		stored value
+  @param[in]	len		length of the value
+  @param[in]	is_unsigned	whether the column is UNSIGNED */
+  void add_value(const byte *data, ulint len, bool is_unsigned) {
+    const uint64_t value = mach_read_int_type(data, len, is_unsigned);
+    const bool negative = !is_unsigned && static_cast<int64_t>(value) < 0;
+
+    add(value, negative ? -1 : 0);
+  }
+
+  /** Add the values counted by another thread.
+  @param[in]	other	values of the other thread */
+  void merge(const Column_aggregate &other) {
+    m_n_not_null += other.m_n_not_null;
+    add(other.m_low, other.m_high);
+  }
+};
+
+/** Count the records where a column is not NULL in a consistent view, and
+sum the column if it is an integer. The sum is kept in 128 bits, so that it
+cannot overflow.
+@param[in,out]  trx             Covering transaction.
+@param[in]  indexes             Clustered indexes to scan.
+@param[in]  col_no              Column number in the tables, not virtual.
+@param[in]  sum                 Whether to sum the column, of DATA_INT.
+@param[in]  max_threads         Maximum number of threads to use.
+@param[out] n_not_null          Number of records where it is not NULL.
+@param[out] sum_high            High 64 bits of the sum.
+@param[out] sum_low             Low 64 bits of the sum.
+@return DB_SUCCESS or error code. */
+dberr_t row_mysql_parallel_column_aggregate(
+    trx_t *trx, std::vector<dict_index_t *> &indexes, ulint col_no, bool sum,
+    size_t max_threads, ulint *n_not_null, int64_t *sum_high,
+    uint64_t *sum_low);
+
 /** Scans an index for either COUNT(*) or CHECK TABLE.
 If CHECK TABLE; Checks that the index contains entries in an ascending order,
 unique constraint is not broken, and calculates the number of index entries
@@ -537,6 +610,13 @@ struct mysql_row_templ_t {
   ulint is_virtual;             /*!< if a column is a virtual column */
   ulint is_multi_val;           /*!< if a column is a Multi-Value Array virtual
                                 column */
+  ulint compress_level;         /*!< zstd level of a compressed column, see
+                                lob0compress.h, or zero if the column is
+                                not compressed */
+  const json_binary::Projection *json_projection;
+                                /*!< member paths of a JSON column that
+                                the statement reads, or NULL if the whole
+                                value is needed; see TABLE::json_projection() */
 };
 
 #define MYSQL_FETCH_CACHE_SIZE 8
@@ -800,6 +880,8 @@ struct row_prebuilt_t {
                                       to this heap */
   mem_heap_t *old_vers_heap;          /*!< memory heap where a previous
                                       version is built in consistent read */
+  mem_heap_t *compress_heap;          /*!< in INSERT and UPDATE compressed
+                                      column values are built in this heap */
   bool in_fts_query;                  /*!< Whether we are in a FTS query */
   bool fts_doc_id_in_read_set;        /*!< true if table has externally
                               defined FTS_DOC_ID coulmn. */
@@ -881,6 +963,28 @@ struct row_prebuilt_t {
   /** True if exceeded the end_range while filling the prefetch cache. */
   bool m_end_range;
 
+  /** True while the clustered index is read for a sorted batch of keys
+  announced by row_sel_begin_clust_batch(): unique searches then first try
+  the leaf page of the previous key. */
+  bool m_batch_lookup;
+
+  /** Leaf page of the clustered index on which the previous key of the
+  batch was found */
+  buf::Block_hint m_batch_leaf;
+
+  /** Modify clock of m_batch_leaf when it was stored */
+  uint64_t m_batch_leaf_modify_clock;
+
+  /** Stop reusing leaf pages between unique searches */
+  void end_batch_lookup() {
+    m_batch_lookup = false;
+    m_batch_leaf.clear();
+  }
+
+  /** Number of leaf pages an ascending scan enters before the next logical
+  read-ahead; 0 when the next leaf entered triggers one */
+  ulint m_read_ahead_countdown;
+
   /** Undo information for LOB mvcc */
   lob::undo_vers_t m_lob_undo;
 
@@ -32,6 +32,8 @@ Created 2019-04-20 by Darshan M N. */
 #ifndef row0pread_histogram_h
 #define row0pread_histogram_h
 
+#include <atomic>
+#include <mutex>
 #include <random>
 #include "row0pread.h"
 #include "ut0counter.h"
@@ -78,8 +80,11 @@ class Histogram_sampler {
   In case of record belonging to non-leaf page, we decide if the child page
   pertaining to the record needs to be skipped.
   In case of record belonging to leaf page, we read the page regardless.
+  With several threads the decision is made from the seed and the page
+  number, so that it does not depend on the order the threads get there.
+  @param[in]  page_no  child page the record points to
   @return true if it needs to be skipped, else false. */
-  bool skip();
+  bool skip(page_no_t page_no);
 
  private:
   /** Wait till there is a request to buffer the next row. */
@@ -158,7 +163,15 @@ class Histogram_sampler {
   os_event_t m_end_buffer_event;
 
   /** Error code when the row was buffered. */
-  dberr_t m_err{DB_SUCCESS};
+  std::atomic<dberr_t> m_err{DB_SUCCESS};
+
+  /** Serializes the threads handing a row over to the server: one of them
+  at a time waits for the request, fills m_buf and signals its end. */
+  std::mutex m_handoff_mutex;
+
+  /** Reader threads that have not finished yet. The last one to finish
+  tells the server that the index has been read. */
+  std::atomic_size_t m_n_running{0};
 
   /** The parallel reader. */
   Parallel_reader m_parallel_reader;
@@ -143,6 +143,18 @@ void row_sel_convert_mysql_key_to_innobase(
     ulint key_len,       /*!< in: MySQL key value length */
     trx_t *trx);         /*!< in: transaction */
 
+/** Announce that the clustered index is about to be searched for a sorted
+batch of unique keys, as when reading the rows of a multi-range read in
+primary key order. The leaf pages of the batch that are not in the buffer
+pool start to be read without waiting for them, searching each level 1 page
+once for all its keys, and until row_prebuilt_t::end_batch_lookup() each
+unique search first tries the leaf page where the previous key was found.
+@param[in,out]	prebuilt	prebuilt struct of the table
+@param[in]	tuples		search tuples, in ascending order
+@param[in]	n_tuples	number of tuples */
+void row_sel_begin_clust_batch(row_prebuilt_t *prebuilt,
+                               const dtuple_t **tuples, ulint n_tuples);
+
 /** Searches for rows in the database. This is used in the interface to
 MySQL. This function opens a cursor, and also implements fetch next
 and fetch prev. NOTE that if we do a search with a full key value
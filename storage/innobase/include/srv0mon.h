@@ -328,6 +328,9 @@ enum monitor_id_t {
   MONITOR_PURGE_RESUME_COUNT,
   MONITOR_PURGE_TRUNCATE_HISTORY_COUNT,
   MONITOR_PURGE_TRUNCATE_HISTORY_MICROSECOND,
+  MONITOR_PURGE_THREADS_USED,
+  MONITOR_PURGE_BATCH_SIZE_USED,
+  MONITOR_PURGE_PAGES_PER_SEC,
 
   /* Undo tablespace truncation */
   MONITOR_UNDO_TRUNCATE,
@@ -399,6 +402,9 @@ enum monitor_id_t {
   MONITOR_LOG_ON_FILE_SPACE_NO_WAITS,
   MONITOR_LOG_ON_FILE_SPACE_WAITS,
   MONITOR_LOG_ON_FILE_SPACE_WAIT_LOOPS,
+  MONITOR_LOG_WRITER_ON_CHECKPOINT_AGE_STALL_TIME,
+  MONITOR_LOG_ON_FILE_SPACE_STALL_TIME,
+  MONITOR_LOG_ON_BUFFER_SPACE_STALL_TIME,
 
   /* Page Manager related counters */
   MONITOR_MODULE_PAGE,
@@ -426,6 +432,8 @@ enum monitor_id_t {
   MONITOR_ADAPTIVE_HASH_ROW_REMOVED,
   MONITOR_ADAPTIVE_HASH_ROW_REMOVE_NOT_FOUND,
   MONITOR_ADAPTIVE_HASH_ROW_UPDATED,
+  MONITOR_ADAPTIVE_HASH_AUTO_DISABLED,
+  MONITOR_ADAPTIVE_HASH_AUTO_ENABLED,
 
   /* Tablespace related counters */
   MONITOR_MODULE_FIL_SYSTEM,
@@ -482,6 +490,12 @@ enum monitor_id_t {
   MONITOR_MODULE_SAMPLING_STATS,
   MONITOR_SAMPLED_PAGES_READ,
   MONITOR_SAMPLED_PAGES_SKIPPED,
+  MONITOR_STATS_RECALC_PERSISTENT,
+  MONITOR_STATS_RECALC_PERSISTENT_MICROSECOND,
+  MONITOR_STATS_RECALC_TRANSIENT,
+  MONITOR_STATS_RECALC_TRANSIENT_MICROSECOND,
+  MONITOR_STATS_RECALC_BACKGROUND,
+  MONITOR_STATS_RECALC_POOL,
 
   /* Data DDL related counters */
   MONITOR_MODULE_DDL_STATS,
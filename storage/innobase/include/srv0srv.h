@@ -323,6 +323,17 @@ and/or load it during startup. */
 extern bool srv_buffer_pool_dump_at_shutdown;
 extern bool srv_buffer_pool_load_at_startup;
 
+/** Whether a clean shutdown writes the tablespace ID map that the
+tablespace discovery at the next startup reads */
+extern bool srv_tablespace_id_map;
+
+/** Threads reading the pages of a buffer pool load */
+extern ulong srv_buffer_pool_load_threads;
+
+/** Whether a buffer pool load yields to user activity, see
+innodb_io_capacity */
+extern bool srv_buffer_pool_load_throttle;
+
 /* Whether to disable file system cache if it is defined */
 extern bool srv_disable_sort_file_cache;
 
@@ -368,6 +379,13 @@ extern bool high_level_read_only;
 /** store to its own file each table created by an user; data
 dictionary tables are in the system tablespace 0 */
 extern bool srv_file_per_table;
+
+/** Whether the files of dropped tablespaces are moved aside and removed
+by the master thread, see innodb_background_drop_file */
+extern bool srv_background_drop_file;
+
+/** Bytes cut off a file at a time when it is removed in the background */
+extern unsigned long long srv_background_drop_file_step;
 /** Sleep delay for threads waiting to enter InnoDB. In micro-seconds. */
 extern ulong srv_thread_sleep_delay;
 /** Maximum sleep delay (in micro-seconds), value of 0 disables it.*/
@@ -379,9 +397,15 @@ extern ulong srv_sort_buf_size;
 /** Maximum modification log file size for online index creation */
 extern unsigned long long srv_online_max_size;
 
+/** Threads applying the modification log of an online table rebuild */
+extern ulong srv_online_alter_log_apply_threads;
+
 /** Number of threads to use for parallel reads. */
 extern ulong srv_parallel_read_threads;
 
+/** Number of threads reading the sampled pages of a histogram */
+extern ulong srv_histogram_sampling_threads;
+
 /* If this flag is TRUE, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads.
@@ -607,6 +631,8 @@ extern ulint srv_lock_table_size;
 extern ulint srv_n_file_io_threads;
 extern bool srv_random_read_ahead;
 extern ulong srv_read_ahead_threshold;
+/** Number of leaf pages that range scans read ahead in key order, or 0 */
+extern ulong srv_logical_read_ahead;
 extern ulong srv_n_read_io_threads;
 extern ulong srv_n_write_io_threads;
 
@@ -649,6 +675,9 @@ extern ulong srv_adaptive_flushing_lwm;
 extern ulong srv_flushing_avg_loops;
 
 extern ulong srv_force_recovery;
+
+/** Threads applying a batch of redo log records during recovery */
+extern ulong srv_recovery_apply_threads;
 #ifdef UNIV_DEBUG
 extern ulong srv_force_recovery_crash;
 #endif /* UNIV_DEBUG */
@@ -672,6 +701,8 @@ extern unsigned long long srv_stats_transient_sample_pages;
 extern bool srv_stats_persistent;
 extern unsigned long long srv_stats_persistent_sample_pages;
 extern bool srv_stats_auto_recalc;
+extern ulong srv_stats_recalc_threads;
+extern ulong srv_stats_sample_threads;
 extern bool srv_stats_include_delete_marked;
 
 extern ulong srv_checksum_algorithm;
@@ -729,6 +760,9 @@ extern ulong srv_n_purge_threads;
 /* the number of pages to purge in one batch */
 extern ulong srv_purge_batch_size;
 
+/** Scale the purge threads and batch size to the purge lag */
+extern bool srv_purge_adaptive;
+
 /* the number of sync wait arrays */
 extern ulong srv_sync_array_size;
 
@@ -755,12 +789,16 @@ extern srv_stats_t srv_stats;
 extern mysql_pfs_key_t log_archiver_thread_key;
 extern mysql_pfs_key_t page_archiver_thread_key;
 extern mysql_pfs_key_t buf_dump_thread_key;
+extern mysql_pfs_key_t buf_load_thread_key;
 extern mysql_pfs_key_t buf_resize_thread_key;
 extern mysql_pfs_key_t clone_ddl_thread_key;
 extern mysql_pfs_key_t clone_gtid_thread_key;
 extern mysql_pfs_key_t dict_stats_thread_key;
+extern mysql_pfs_key_t dict_stats_recalc_thread_key;
+extern mysql_pfs_key_t dict_stats_sample_thread_key;
 extern mysql_pfs_key_t fts_optimize_thread_key;
 extern mysql_pfs_key_t fts_parallel_merge_thread_key;
+extern mysql_pfs_key_t fts_parallel_optimize_thread_key;
 extern mysql_pfs_key_t fts_parallel_tokenization_thread_key;
 extern mysql_pfs_key_t io_handler_thread_key;
 extern mysql_pfs_key_t io_ibuf_thread_key;
@@ -775,6 +813,8 @@ extern mysql_pfs_key_t log_flush_notifier_thread_key;
 extern mysql_pfs_key_t page_flush_coordinator_thread_key;
 extern mysql_pfs_key_t page_flush_thread_key;
 extern mysql_pfs_key_t recv_writer_thread_key;
+extern mysql_pfs_key_t recv_apply_thread_key;
+extern mysql_pfs_key_t row_log_apply_thread_key;
 extern mysql_pfs_key_t srv_error_monitor_thread_key;
 extern mysql_pfs_key_t srv_lock_timeout_thread_key;
 extern mysql_pfs_key_t srv_master_thread_key;
@@ -784,6 +824,7 @@ extern mysql_pfs_key_t srv_worker_thread_key;
 extern mysql_pfs_key_t trx_recovery_rollback_thread_key;
 extern mysql_pfs_key_t srv_ts_alter_encrypt_thread_key;
 extern mysql_pfs_key_t parallel_read_thread_key;
+extern mysql_pfs_key_t ddl_sort_thread_key;
 #endif /* UNIV_PFS_THREAD */
 #endif /* !UNIV_HOTBACKUP */
 
@@ -0,0 +1,93 @@
+/*****************************************************************************
+
+Copyright (c) 2021, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License, version 2.0, as published by the
+Free Software Foundation.
+
+This program is also distributed with certain software (including but not
+limited to OpenSSL) that is licensed under separate terms, as designated in a
+particular file or component or in included license documentation. The authors
+of MySQL hereby grant you an additional permission to link the program and
+your derivative works with the separately licensed software that they have
+included with MySQL.
+
+This program is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+FOR A PARTICULAR PURPOSE. See the GNU General Public License, version 2.0,
+for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+
+*****************************************************************************/
+
+/** @file lob/lob0compress.cc
+ Column level zstd compression of BLOB, TEXT and JSON values. */
+
+#include <zstd.h>
+
+#include "lob0compress.h"
+#include "mach0data.h"
+#include "ut0dbg.h"
+
+namespace lob {
+
+byte *compress_column(const byte *data, ulint len, ulint level,
+                      mem_heap_t *heap, ulint *out_len) {
+  ut_ad(level > 0 && level <= COMPRESS_MAX_LEVEL);
+
+  if (len >= COMPRESS_MIN_LEN && len <= UINT32_MAX) {
+    size_t bound = ZSTD_compressBound(len);
+    byte *buf = static_cast<byte *>(
+        mem_heap_alloc(heap, COMPRESS_ZSTD_HEADER_SIZE + bound));
+
+    size_t zlen =
+        ZSTD_compress(buf + COMPRESS_ZSTD_HEADER_SIZE, bound, data, len,
+                      static_cast<int>(level));
+
+    /* Keep the value as it is if it does not get smaller. */
+    if (!ZSTD_isError(zlen) && COMPRESS_ZSTD_HEADER_SIZE + zlen < len + 1) {
+      buf[0] = COMPRESS_ZSTD;
+      mach_write_to_4(buf + 1, len);
+      *out_len = COMPRESS_ZSTD_HEADER_SIZE + zlen;
+      return buf;
+    }
+  }
+
+  byte *buf = static_cast<byte *>(mem_heap_alloc(heap, len + 1));
+  buf[0] = COMPRESS_NONE;
+  memcpy(buf + 1, data, len);
+  *out_len = len + 1;
+  return buf;
+}
+
+const byte *decompress_column(const byte *data, ulint len, mem_heap_t *heap,
+                              ulint *out_len) {
+  if (len >= 1 && data[0] == COMPRESS_NONE) {
+    *out_len = len - 1;
+    return data + 1;
+  }
+
+  if (len > COMPRESS_ZSTD_HEADER_SIZE && data[0] == COMPRESS_ZSTD) {
+    ulint orig_len = mach_read_from_4(data + 1);
+    byte *buf = static_cast<byte *>(mem_heap_alloc(heap, orig_len + 1));
+
+    size_t n = ZSTD_decompress(buf, orig_len, data + COMPRESS_ZSTD_HEADER_SIZE,
+                               len - COMPRESS_ZSTD_HEADER_SIZE);
+
+    if (!ZSTD_isError(n) && n == orig_len) {
+      *out_len = orig_len;
+      return buf;
+    }
+  }
+
+  ib::error(ER_IB_MSG_630) << "Corrupted compressed column value of length "
+                            << len << " was read as an empty value";
+  *out_len = 0;
+  return data;
+}
+
+}  // namespace lob
@@ -1082,7 +1082,6 @@ dberr_t insert(InsertContext *ctx, trx_t *trx, ref_t &ref,
 @return the amount of data (in bytes) that was actually read. */
 ulint read(ReadContext *ctx, ref_t ref, ulint offset, ulint len, byte *buf) {
   DBUG_TRACE;
-  ut_ad(offset == 0);
   const uint32_t lob_version = ref.version();
 
   ref_mem_t ref_mem;
@@ -1129,6 +1128,12 @@ ulint read(ReadContext *ctx, ref_t ref, ulint offset, ulint len, byte *buf) {
 
   if (page_type == FIL_PAGE_TYPE_BLOB || page_type == FIL_PAGE_SDI_BLOB) {
     mtr_commit(&mtr);
+
+    if (offset > 0) {
+      /* The old BLOB format has no index to seek with. */
+      return 0;
+    }
+
     Reader reader(*ctx);
     ulint fetch_len = reader.fetch();
     return fetch_len;
@@ -1155,9 +1160,7 @@ ulint read(ReadContext *ctx, ref_t ref, ulint offset, ulint len, byte *buf) {
   index_entry_t old_version(&mtr, ctx->m_index);
   index_entry_mem_t entry_mem;
 
-  ut_ad(offset >= skipped);
-
-  ulint page_offset = offset - skipped;
+  ulint page_offset = 0;
   ulint want = len;
   byte *ptr = buf;
 
@@ -1203,11 +1206,27 @@ ulint read(ReadContext *ctx, ref_t ref, ulint offset, ulint len, byte *buf) {
     }
 
     page_no_t read_from_page_no = FIL_NULL;
+    ulint data_len = 0;
 
     if (old_version.is_null()) {
       read_from_page_no = cur_entry.get_page_no();
+      data_len = cur_entry.get_data_len();
     } else {
       read_from_page_no = old_version.get_page_no();
+      data_len = old_version.get_data_len();
+    }
+
+    if (skipped + data_len <= offset) {
+      /* The requested range starts after this entry. Only the index
+      entry is needed to skip over it, the data page is not fetched. */
+      skipped += data_len;
+      node_loc = cur_entry.get_next();
+      continue;
+    }
+
+    if (skipped < offset) {
+      page_offset = offset - skipped;
+      skipped = offset;
     }
 
     actual_read = 0;
@@ -1244,8 +1263,8 @@ ulint read(ReadContext *ctx, ref_t ref, ulint offset, ulint len, byte *buf) {
 
   /* Assert that we have read what has been requested or what is
   available. */
-  ut_ad(total_read == len || total_read == avail_lob);
-  ut_ad(total_read <= avail_lob);
+  ut_ad(total_read == len || offset + total_read == avail_lob);
+  ut_ad(offset + total_read <= avail_lob);
 
   mtr_commit(&mtr);
   mtr_commit(&data_mtr);
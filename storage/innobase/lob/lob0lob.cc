@@ -699,6 +699,58 @@ byte *btr_rec_copy_externally_stored_field_func(
                                            page_size, local_len, is_sdi, heap));
 }
 
+bool btr_rec_read_externally_stored_field_range(
+    const dict_index_t *index, const rec_t *rec, const ulint *offsets,
+    const page_size_t &page_size, ulint no, ulint offset, ulint len,
+    byte *buf) {
+  ulint local_len;
+
+  ut_a(rec_offs_nth_extern(offsets, no));
+  ut_ad(index->is_clustered());
+
+  if (page_size.is_compressed()) {
+    return (false);
+  }
+
+  const byte *data = rec_get_nth_field(rec, offsets, no, &local_len);
+
+  ut_a(local_len >= BTR_EXTERN_FIELD_REF_SIZE);
+  local_len -= BTR_EXTERN_FIELD_REF_SIZE;
+
+  lob::ref_t ref(const_cast<byte *>(data + local_len));
+
+  if (ref.is_null() || ref.is_being_modified() ||
+      offset + len > local_len + ref.length()) {
+    return (false);
+  }
+
+  /* Copy the part of the range that is stored in the record. */
+  if (offset < local_len) {
+    const ulint n = std::min(len, local_len - offset);
+    memcpy(buf, data + offset, n);
+    buf += n;
+    offset += n;
+    len -= n;
+  }
+
+  if (len == 0) {
+    return (true);
+  }
+
+  ReadContext rctx(page_size, data, local_len + BTR_EXTERN_FIELD_REF_SIZE,
+                   buf, len
+#ifdef UNIV_DEBUG
+                   ,
+                   false
+#endif /* UNIV_DEBUG */
+  );
+
+  rctx.m_index = const_cast<dict_index_t *>(index);
+
+  return (lob::read(&rctx, rctx.m_blobref, offset - local_len, len, buf) ==
+          len);
+}
+
 /** Returns the page number where the next BLOB part is stored.
 @param[in]	blob_header	the BLOB header.
 @return page number or FIL_NULL if no more pages */
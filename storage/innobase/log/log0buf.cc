@@ -44,6 +44,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
 #include "arch0arch.h"
 #include "log0log.h"
 #include "log0recv.h" /* recv_recovery_is_on() */
+#include "log0stats.h"
 #include "log0test.h"
 #include "srv0start.h" /* SRV_SHUTDOWN_FLUSH_PHASE */
 
@@ -804,10 +805,15 @@ void log_wait_for_space_in_log_buf(log_t &log, sn_t end_sn) {
 
   lsn = log_translate_sn_to_lsn(end_sn + OS_FILE_LOG_BLOCK_SIZE - buf_size_sn);
 
+  const auto stall_start = Log_clock::now();
+
   wait_stats = log_write_up_to(log, lsn, false);
 
   MONITOR_INC_WAIT_STATS(MONITOR_LOG_ON_BUFFER_SPACE_, wait_stats);
 
+  log_stall_register(LOG_HISTOGRAM_BUFFER_SPACE_STALL,
+                     MONITOR_LOG_ON_BUFFER_SPACE_STALL_TIME, stall_start);
+
   ut_a(end_sn + OS_FILE_LOG_BLOCK_SIZE <=
        log_translate_lsn_to_sn(log.write_lsn.load()) + buf_size_sn);
 }
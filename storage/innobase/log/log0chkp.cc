@@ -58,6 +58,7 @@ the file COPYING.Google.
 #include "fil0fil.h"
 #include "log0log.h"
 #include "log0recv.h"
+#include "log0stats.h"
 #include "mem0mem.h"
 #include "srv0mon.h"
 #include "srv0srv.h"
@@ -1326,9 +1327,16 @@ void log_free_check_wait(log_t &log) {
     return (current_lsn <= limit_lsn);
   };
 
+  const auto stall_start = Log_clock::now();
+
   const auto wait_stats = ut_wait_for(0, 100, stop_condition);
 
   MONITOR_INC_WAIT_STATS(MONITOR_LOG_ON_FILE_SPACE_, wait_stats);
+
+  if (wait_stats.any_waits()) {
+    log_stall_register(LOG_HISTOGRAM_FILE_SPACE_STALL,
+                       MONITOR_LOG_ON_FILE_SPACE_STALL_TIME, stall_start);
+  }
 }
 
 lsn_t log_get_max_modified_age_async(const log_t &log) {
@@ -37,8 +37,10 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include <sys/types.h>
 
 #include <array>
+#include <atomic>
 #include <iomanip>
 #include <map>
+#include <mutex>
 #include <new>
 #include <string>
 #include <vector>
@@ -84,9 +86,6 @@ std::list<space_id_t> recv_encr_ts_list;
 this must be less than UNIV_PAGE_SIZE as it is stored in the buffer pool */
 #define RECV_DATA_BLOCK_SIZE (MEM_MAX_ALLOC_IN_BUF - sizeof(recv_data_t))
 
-/** Read-ahead area in applying log records to file pages */
-static const size_t RECV_READ_AHEAD_AREA = 32;
-
 /** The recovery system */
 recv_sys_t *recv_sys = nullptr;
 
@@ -201,6 +200,7 @@ static lsn_t recv_max_page_lsn;
 #ifndef UNIV_HOTBACKUP
 #ifdef UNIV_PFS_THREAD
 mysql_pfs_key_t recv_writer_thread_key;
+mysql_pfs_key_t recv_apply_thread_key;
 #endif /* UNIV_PFS_THREAD */
 
 static bool recv_writer_is_active() {
@@ -1210,6 +1210,94 @@ static void recv_apply_log_rec(recv_addr_t *recv_addr) {
   }
 }
 
+/** Step, in percent, of the apply progress messages */
+static const size_t PCT = 10;
+
+/** A batch of hashed log records applied by several threads. Every page
+is in one partition: a thread applies the records of its partition,
+reading in the pages that are not in the buffer pool asynchronously,
+and the I/O handler threads apply the records of those as they arrive. */
+struct recv_apply_t {
+  /** Pages of each thread, partitioned by read-ahead area */
+  std::vector<std::vector<recv_addr_t *>> parts;
+
+  /** Number of threads applying the batch */
+  ulint n_threads{1};
+
+  /** Pages applied or read in so far */
+  std::atomic<size_t> applied{0};
+
+  /** Threads done with their partition */
+  std::atomic<ulint> n_finished{0};
+
+  /** Protects the progress reporting below */
+  std::mutex report_mutex;
+
+  size_t batch_size{0};
+  size_t pct{PCT};
+  size_t unit{0};
+  size_t next{0};
+  ib_time_monotonic_t start_time{0};
+};
+
+/** Report the progress of an apply batch every PCT percent, or after
+PRINT_INTERVAL_SECS without a report.
+@param[in,out]	apply	apply batch */
+static void recv_apply_report(recv_apply_t *apply) {
+  std::lock_guard<std::mutex> guard(apply->report_mutex);
+
+  const size_t applied = apply->applied.load();
+  bool reported = false;
+
+  while (apply->unit != 0 && applied >= apply->next && apply->pct <= 100) {
+    ib::info(ER_IB_MSG_708) << apply->pct << "%";
+
+    apply->pct += PCT;
+    apply->next += apply->unit;
+    reported = true;
+  }
+
+  if (reported) {
+    apply->start_time = ut_time_monotonic();
+
+  } else if (ut_time_monotonic() - apply->start_time >= PRINT_INTERVAL_SECS &&
+             applied < apply->batch_size) {
+    apply->start_time = ut_time_monotonic();
+
+    ib::info(ER_IB_MSG_709)
+        << std::setprecision(2)
+        << ((double)applied * 100) / (double)apply->batch_size << "%";
+  }
+}
+
+/** Apply the log records of the pages of one partition of a batch.
+@param[in,out]	apply	apply batch
+@param[in]	part	partition of the calling thread */
+static void recv_apply_worker(recv_apply_t *apply, ulint part) {
+  ulint n = 0;
+
+  mutex_enter(&recv_sys->mutex);
+
+  for (auto recv_addr : apply->parts[part]) {
+    recv_apply_log_rec(recv_addr);
+
+    apply->applied.fetch_add(1);
+
+    /* The calling thread reports as it goes */
+    if (part == 0 && ++n % 64 == 0) {
+      mutex_exit(&recv_sys->mutex);
+
+      recv_apply_report(apply);
+
+      mutex_enter(&recv_sys->mutex);
+    }
+  }
+
+  mutex_exit(&recv_sys->mutex);
+
+  apply->n_finished.fetch_add(1);
+}
+
 /** Empties the hash table of stored log records, applying them to appropriate
 pages.
 @param[in,out]	log		Redo log
@@ -1245,18 +1333,27 @@ void recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf) {
 
   ib::info(ER_IB_MSG_707, ulonglong{batch_size});
 
-  static const size_t PCT = 10;
+  recv_apply_t apply;
+
+  apply.batch_size = batch_size;
 
-  size_t pct = PCT;
-  size_t applied = 0;
-  auto unit = batch_size / PCT;
+  apply.unit = batch_size / PCT;
 
-  if (unit <= PCT) {
-    pct = 100;
-    unit = batch_size;
+  if (apply.unit <= PCT) {
+    apply.pct = 100;
+    apply.unit = batch_size;
   }
 
-  auto start_time = ut_time_monotonic();
+  apply.next = apply.unit;
+
+  apply.start_time = ut_time_monotonic();
+
+  /* Partition the pages by read-ahead area, so that each area is read
+  in by one of the threads. */
+  apply.n_threads =
+      recv_apply_n_threads(batch_size, srv_recovery_apply_threads);
+
+  apply.parts.resize(apply.n_threads);
 
   for (const auto &space : *recv_sys->spaces) {
     bool dropped;
@@ -1282,27 +1379,39 @@ void recv_apply_hashed_log_recs(log_t &log, bool allow_ibuf) {
         pages.second->state = RECV_DISCARDED;
       }
 
-      recv_apply_log_rec(pages.second);
+      const ulint part =
+          recv_apply_partition(space.first, pages.first, apply.n_threads);
 
-      ++applied;
+      apply.parts[part].push_back(pages.second);
+    }
+  }
 
-      if (unit == 0 || (applied % unit) == 0) {
-        ib::info(ER_IB_MSG_708) << pct << "%";
+  mutex_exit(&recv_sys->mutex);
 
-        pct += PCT;
+  std::vector<IB_thread> workers;
 
-        start_time = ut_time_monotonic();
+  for (ulint t = 1; t < apply.n_threads; t++) {
+    workers.push_back(
+        os_thread_create(recv_apply_thread_key, recv_apply_worker, &apply, t));
+    workers.back().start();
+  }
 
-      } else if (ut_time_monotonic() - start_time >= PRINT_INTERVAL_SECS) {
-        start_time = ut_time_monotonic();
+  recv_apply_worker(&apply, 0);
 
-        ib::info(ER_IB_MSG_709)
-            << std::setprecision(2)
-            << ((double)applied * 100) / (double)batch_size << "%";
-      }
-    }
+  while (apply.n_finished.load() < apply.n_threads) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    recv_apply_report(&apply);
+  }
+
+  for (auto &worker : workers) {
+    worker.join();
   }
 
+  recv_apply_report(&apply);
+
+  mutex_enter(&recv_sys->mutex);
+
   /* Wait until all the pages have been processed */
 
   while (recv_sys->n_addrs != 0) {
@@ -0,0 +1,76 @@
+/*****************************************************************************
+
+Copyright (c) 2021, Oracle and/or its affiliates.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License, version 2.0,
+as published by the Free Software Foundation.
+
+This program is also distributed with certain software (including
+but not limited to OpenSSL) that is licensed under separate terms,
+as designated in a particular file or component or in included license
+documentation.  The authors of MySQL hereby grant you an additional
+permission to link the program and your derivative works with the
+separately licensed software that they have included with MySQL.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License, version 2.0, for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+
+*****************************************************************************/
+
+/**************************************************/ /**
+ @file log/log0stats.cc
+
+ Redo log - latency and size histograms.
+
+ *******************************************************/
+
+#include "log0stats.h"
+
+Log_histogram log_histograms[LOG_HISTOGRAM_N];
+
+const char *log_histogram_name(log_histogram_t histogram) {
+  switch (histogram) {
+    case LOG_HISTOGRAM_WRITE_SIZE:
+      return ("write_size");
+    case LOG_HISTOGRAM_WRITE_TIME:
+      return ("write_time");
+    case LOG_HISTOGRAM_FLUSH_TIME:
+      return ("flush_time");
+    case LOG_HISTOGRAM_USER_WAIT_TIME:
+      return ("user_wait_time");
+    case LOG_HISTOGRAM_CHECKPOINT_AGE_STALL:
+      return ("checkpoint_age_stall");
+    case LOG_HISTOGRAM_FILE_SPACE_STALL:
+      return ("file_space_stall");
+    case LOG_HISTOGRAM_BUFFER_SPACE_STALL:
+      return ("buffer_space_stall");
+    case LOG_HISTOGRAM_N:
+      break;
+  }
+  ut_error;
+}
+
+const char *log_histogram_unit(log_histogram_t histogram) {
+  return (histogram == LOG_HISTOGRAM_WRITE_SIZE ? "bytes" : "microseconds");
+}
+
+void log_stall_register(log_histogram_t histogram, monitor_id_t monitor,
+                        Log_clock_point stall_start) {
+  const auto stall_end = Log_clock::now();
+
+  log_histograms[histogram].add_time(stall_start, stall_end);
+
+  if (stall_end > stall_start) {
+    MONITOR_INC_VALUE(monitor,
+                      std::chrono::duration_cast<std::chrono::microseconds>(
+                          stall_end - stall_start)
+                          .count());
+  }
+}
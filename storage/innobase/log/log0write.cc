@@ -60,6 +60,7 @@ the file COPYING.Google.
 #include "log0meb.h"
 #ifndef UNIV_HOTBACKUP
 #include "log0recv.h"
+#include "log0stats.h"
 #include "mem0mem.h"
 #include "mysqld.h" /* server_uuid */
 #include "srv0mon.h"
@@ -1038,7 +1039,17 @@ static Wait_stats log_self_write_up_to(log_t &log, lsn_t end_lsn,
   return (Wait_stats{waits});
 }
 
-Wait_stats log_write_up_to(log_t &log, lsn_t end_lsn, bool flush_to_disk) {
+/** Write and optionally flush the redo log up to a provided lsn, waiting
+for the log threads if necessary.
+@param[in]      log             redo log
+@param[in]      end_lsn         lsn to write for
+@param[in]      flush_to_disk   whether the redo log should also be flushed
+@param[out]     wait_start      time when the thread started to wait for
+                                the log threads, or unchanged if it did not
+@return         statistics related to waiting inside */
+static Wait_stats log_write_up_to_low(log_t &log, lsn_t end_lsn,
+                                      bool flush_to_disk,
+                                      Log_clock_point &wait_start) {
   ut_a(!srv_read_only_mode);
 
   /* If we were updating log.flushed_to_disk_lsn while parsing redo log
@@ -1109,6 +1120,10 @@ retry:
       return (wait_stats);
     }
 
+    if (wait_start == Log_clock_point{}) {
+      wait_start = Log_clock::now();
+    }
+
     if (srv_flush_log_at_trx_commit != 1) {
       /* We need redo flushed, but because trx != 1, we have
       disabled notifications sent from log_writer to log_flusher.
@@ -1141,6 +1156,10 @@ retry:
       return (wait_stats);
     }
 
+    if (wait_start == Log_clock_point{}) {
+      wait_start = Log_clock::now();
+    }
+
     /* Wait until log gets written up to end_lsn. */
     wait_stats += log_wait_for_write(log, end_lsn, &interrupted);
 
@@ -1153,6 +1172,20 @@ retry:
   return (wait_stats);
 }
 
+Wait_stats log_write_up_to(log_t &log, lsn_t end_lsn, bool flush_to_disk) {
+  Log_clock_point wait_start{};
+
+  const auto wait_stats =
+      log_write_up_to_low(log, end_lsn, flush_to_disk, wait_start);
+
+  if (wait_start != Log_clock_point{}) {
+    log_histograms[LOG_HISTOGRAM_USER_WAIT_TIME].add_time(wait_start,
+                                                          Log_clock::now());
+  }
+
+  return (wait_stats);
+}
+
 /** @} */
 
 /**************************************************/ /**
@@ -1651,10 +1684,16 @@ static inline void write_blocks(log_t &log, byte *write_buf, size_t write_size,
   ut_a(real_offset + write_size <= log.write_ahead_end_offset ||
        (real_offset + write_size) % srv_log_write_ahead_size == 0);
 
+  const auto write_start = Log_clock::now();
+
   auto err = fil_redo_io(
       IORequestLogWrite, page_id_t{log.files_space_id, page_no}, univ_page_size,
       static_cast<ulint>(real_offset % UNIV_PAGE_SIZE), write_size, write_buf);
 
+  log_histograms[LOG_HISTOGRAM_WRITE_TIME].add_time(write_start,
+                                                    Log_clock::now());
+  log_histograms[LOG_HISTOGRAM_WRITE_SIZE].add(write_size);
+
   meb::redo_log_archive_produce(write_buf, write_size);
 
   ut_a(err == DB_SUCCESS);
@@ -1916,6 +1955,7 @@ static lsn_t log_writer_wait_on_checkpoint(log_t &log, lsn_t last_write_lsn,
 
   int32_t count = 1;
   lsn_t checkpoint_limited_lsn = LSN_MAX;
+  const auto stall_start = Log_clock::now();
 
   while (true) {
     lsn_t checkpoint_lsn = log.last_checkpoint_lsn.load();
@@ -1981,6 +2021,12 @@ static lsn_t log_writer_wait_on_checkpoint(log_t &log, lsn_t last_write_lsn,
     log_writer_mutex_enter(log);
   }
 
+  if (count > 1) {
+    log_stall_register(LOG_HISTOGRAM_CHECKPOINT_AGE_STALL,
+                       MONITOR_LOG_WRITER_ON_CHECKPOINT_AGE_STALL_TIME,
+                       stall_start);
+  }
+
   return checkpoint_limited_lsn;
 }
 
@@ -2379,6 +2425,11 @@ static void log_flush_low(log_t &log) {
     log.last_flush_start_time = log.last_flush_end_time;
   }
 
+  if (do_flush) {
+    log_histograms[LOG_HISTOGRAM_FLUSH_TIME].add_time(
+        log.last_flush_start_time, log.last_flush_end_time);
+  }
+
   LOG_SYNC_POINT("log_flush_before_flushed_to_disk_lsn");
 
   log.flushed_to_disk_lsn.store(flush_up_to_lsn);
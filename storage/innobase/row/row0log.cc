@@ -36,11 +36,14 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include <fcntl.h>
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <vector>
 
 #include "data0data.h"
 #include "handler0alter.h"
 #include "lob0lob.h"
+#include "os0thread-create.h"
 #include "que0que.h"
 #include "row0ext.h"
 #include "row0ins.h"
@@ -54,6 +57,10 @@ this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "my_dbug.h"
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t row_log_apply_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /** Table row modification operations during online table rebuild.
 Delete-marked records are not copied to the rebuilt table. */
 enum row_tab_op {
@@ -1289,6 +1296,8 @@ static MY_ATTRIBUTE((warn_unused_result))
         dict_index_t *index,  /*!< in: index of mrec */
         const ulint *offsets, /*!< in: offsets of mrec */
         const row_log_t *log, /*!< in: rebuild context */
+        ulonglong total,      /*!< in: logical position
+                              past mrec in the log */
         mem_heap_t *heap,     /*!< in/out: memory heap */
         trx_id_t trx_id,      /*!< in: DB_TRX_ID of mrec */
         dberr_t *error)       /*!< out: DB_SUCCESS or
@@ -1351,7 +1360,7 @@ static MY_ATTRIBUTE((warn_unused_result))
         page_no_t page_no = mach_read_from_4(
             data + len - (BTR_EXTERN_FIELD_REF_SIZE - lob::BTR_EXTERN_PAGE_NO));
         page_no_map::const_iterator p = blobs->find(page_no);
-        if (p != blobs->end() && p->second.is_freed(log->head.total)) {
+        if (p != blobs->end() && p->second.is_freed(total)) {
           /* This BLOB has been freed.
           We must not access the row. */
           *error = DB_MISSING_HISTORY;
@@ -1509,6 +1518,10 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
     case DB_SUCCESS_LOCKED_REC:
       /* The row had already been copied to the table. */
       return (DB_SUCCESS);
+    case DB_DUPLICATE_KEY:
+      dup->error_key_num = 0;
+      dup->error_index = index;
+      return (error);
     default:
       return (error);
   }
@@ -1536,7 +1549,8 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
 
     /* Report correct index name for duplicate key error. */
     if (error == DB_DUPLICATE_KEY) {
-      thr_get_trx(thr)->error_key_num = n_index;
+      dup->error_key_num = n_index;
+      dup->error_index = index;
     }
 
   } while (error == DB_SUCCESS);
@@ -1544,6 +1558,22 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
   return (error);
 }
 
+/** Report the row of a failed operation in the MySQL table, using the new
+version of the table.
+@param[in,out]	dup	for reporting duplicate key errors
+@param[in]	row	row of the failed operation */
+static void row_log_table_report_row(row_merge_dup_t *dup,
+                                     const dtuple_t *row) {
+  row_log_t *log = dup->index->online_log;
+
+  dup->n_dup++;
+
+  /* The row_log_table_apply_part() threads may fail at the same time */
+  mutex_enter(&log->mutex);
+  innobase_row_to_mysql(dup->table, log->table, row);
+  mutex_exit(&log->mutex);
+}
+
 /** Replays an insert operation on a table that was rebuilt.
  @return DB_SUCCESS or error code */
 static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_insert(
@@ -1555,13 +1585,15 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_insert(
     mem_heap_t *heap,         /*!< in/out: memory heap */
     row_merge_dup_t *dup,     /*!< in/out: for reporting
                               duplicate key errors */
-    trx_id_t trx_id)          /*!< in: DB_TRX_ID of mrec */
+    trx_id_t trx_id,          /*!< in: DB_TRX_ID of mrec */
+    ulonglong total)          /*!< in: logical position
+                              past mrec in the log */
 {
   const row_log_t *log = dup->index->online_log;
   trx_t *trx = thr_get_trx(thr);
   dberr_t error;
   const dtuple_t *row = row_log_table_apply_convert_mrec(
-      trx, mrec, dup->index, offsets, log, heap, trx_id, &error);
+      trx, mrec, dup->index, offsets, log, total, heap, trx_id, &error);
 
   switch (error) {
     case DB_MISSING_HISTORY:
@@ -1588,7 +1620,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_insert(
   if (error != DB_SUCCESS) {
     /* Report the erroneous row using the new
     version of the table. */
-    innobase_row_to_mysql(dup->table, log->table, row);
+    row_log_table_report_row(dup, row);
   }
   return (error);
 }
@@ -1878,13 +1910,15 @@ flag_ok:
 @param[in]	thr		query graph
 @param[in,out]	offsets_heap	memory heap that can be emptied
 @param[in,out]	heap		memory heap
+@param[in,out]	dup		for reporting duplicate key errors
 @return DB_SUCCESS or error code */
 static MY_ATTRIBUTE((warn_unused_result)) dberr_t
     apply_update_multi_value(dict_index_t *index, uint32_t n_index,
                              const dtuple_t *old_row, row_ext_t *old_ext,
                              const dtuple_t *new_row, bool non_mv_upd,
                              trx_id_t trx_id, que_thr_t *thr,
-                             mem_heap_t *offsets_heap, mem_heap_t *heap) {
+                             mem_heap_t *offsets_heap, mem_heap_t *heap,
+                             row_merge_dup_t *dup) {
   btr_pcur_t pcur;
   mtr_t mtr;
   dberr_t error = DB_SUCCESS;
@@ -1931,7 +1965,8 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
           false);
 
       if (error == DB_DUPLICATE_KEY) {
-        thr_get_trx(thr)->error_key_num = n_index;
+        dup->error_key_num = n_index;
+        dup->error_index = index;
       }
 
       if (error != DB_SUCCESS) {
@@ -1958,10 +1993,12 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
     row_merge_dup_t *dup,     /*!< in/out: for reporting
                               duplicate key errors */
     trx_id_t trx_id,          /*!< in: DB_TRX_ID of mrec */
-    const dtuple_t *old_pk)   /*!< in: PRIMARY KEY and
+    const dtuple_t *old_pk,   /*!< in: PRIMARY KEY and
                               DB_TRX_ID,DB_ROLL_PTR
                               of the old value,
                               or PRIMARY KEY if same_pk */
+    ulonglong total)          /*!< in: logical position
+                              past mrec in the log */
 {
   const row_log_t *log = dup->index->online_log;
   const dtuple_t *row;
@@ -1978,7 +2015,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
         dict_index_get_n_unique(index) + (log->same_pk ? 0 : 2));
 
   row = row_log_table_apply_convert_mrec(trx, mrec, dup->index, offsets, log,
-                                         heap, trx_id, &error);
+                                         total, heap, trx_id, &error);
 
   switch (error) {
     case DB_MISSING_HISTORY:
@@ -2082,7 +2119,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
     if (error != DB_SUCCESS) {
       /* Report the erroneous row using the new
       version of the table. */
-      innobase_row_to_mysql(dup->table, log->table, row);
+      row_log_table_report_row(dup, row);
     }
 
     return (error);
@@ -2256,9 +2293,9 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
     mtr_commit(&mtr);
 
     if (index->is_multi_value()) {
-      error =
-          apply_update_multi_value(index, n_index, old_row, old_ext, row,
-                                   non_mv_upd, trx_id, thr, offsets_heap, heap);
+      error = apply_update_multi_value(index, n_index, old_row, old_ext, row,
+                                       non_mv_upd, trx_id, thr, offsets_heap,
+                                       heap, dup);
       mtr_start(&mtr);
       continue;
     }
@@ -2295,7 +2332,8 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
 
     /* Report correct index name for duplicate key error. */
     if (error == DB_DUPLICATE_KEY) {
-      thr_get_trx(thr)->error_key_num = n_index;
+      dup->error_key_num = n_index;
+      dup->error_index = index;
     }
 
     mtr_start(&mtr);
@@ -2304,6 +2342,27 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t row_log_table_apply_update(
   goto func_exit;
 }
 
+/** Determine the partition of a row_log_table_apply_part() thread that a
+log record belongs to, by its PRIMARY KEY.
+@param[in]	n_uniq		number of PRIMARY KEY fields
+@param[in]	mrec		log record
+@param[in]	offsets		offsets of mrec
+@param[in]	n_parts		number of partitions
+@return partition of mrec */
+static ulint row_log_table_part(ulint n_uniq, const mrec_t *mrec,
+                                const ulint *offsets, ulint n_parts) {
+  ulint fold = 0;
+
+  for (ulint i = 0; i < n_uniq; i++) {
+    ulint len;
+    const byte *field = rec_get_nth_field(mrec, offsets, i, &len);
+
+    fold = row_log_table_fold_field(fold, field, len);
+  }
+
+  return (fold % n_parts);
+}
+
 /** Applies an operation to a table that was rebuilt.
  @return NULL on failure (mrec corruption) or when out of data;
  pointer to next record on success */
@@ -2322,8 +2381,14 @@ static MY_ATTRIBUTE((warn_unused_result)) const mrec_t *row_log_table_apply_op(
     mem_heap_t *heap,         /*!< in/out: memory heap */
     const mrec_t *mrec,       /*!< in: merge record */
     const mrec_t *mrec_end,   /*!< in: end of buffer */
-    ulint *offsets)           /*!< in/out: work area
+    ulint *offsets,           /*!< in/out: work area
                               for parsing mrec */
+    ulonglong *total,         /*!< in/out: logical position
+                              in the log */
+    ulint n_parts,            /*!< in: number of partitions,
+                              1 to apply every record */
+    ulint part)               /*!< in: partition whose
+                              records to apply */
 {
   row_log_t *log = dup->index->online_log;
   dict_index_t *new_index = log->table->first_index();
@@ -2333,7 +2398,9 @@ static MY_ATTRIBUTE((warn_unused_result)) const mrec_t *row_log_table_apply_op(
 
   ut_ad(dup->index->is_clustered());
   ut_ad(dup->index->table != log->table);
-  ut_ad(log->head.total <= log->tail.total);
+  ut_ad(*total <= log->tail.total);
+  ut_ad(part < n_parts);
+  ut_ad(n_parts == 1 || log->same_pk);
 
   *error = DB_SUCCESS;
 
@@ -2380,15 +2447,20 @@ static MY_ATTRIBUTE((warn_unused_result)) const mrec_t *row_log_table_apply_op(
       if (next_mrec > mrec_end) {
         return (nullptr);
       } else {
-        log->head.total += next_mrec - mrec_start;
+        *total += next_mrec - mrec_start;
+
+        if (n_parts > 1 && row_log_table_part(new_index->n_uniq, mrec, offsets,
+                                              n_parts) != part) {
+          break;
+        }
 
         ulint len;
         const byte *db_trx_id =
             rec_get_nth_field(mrec, offsets, trx_id_col, &len);
         ut_ad(len == DATA_TRX_ID_LEN);
-        *error =
-            row_log_table_apply_insert(thr, mrec, offsets, offsets_heap, heap,
-                                       dup, trx_read_trx_id(db_trx_id));
+        *error = row_log_table_apply_insert(thr, mrec, offsets, offsets_heap,
+                                            heap, dup,
+                                            trx_read_trx_id(db_trx_id), *total);
       }
       break;
 
@@ -2420,7 +2492,12 @@ static MY_ATTRIBUTE((warn_unused_result)) const mrec_t *row_log_table_apply_op(
         return (nullptr);
       }
 
-      log->head.total += next_mrec - mrec_start;
+      *total += next_mrec - mrec_start;
+
+      if (n_parts > 1 && row_log_table_part(new_index->n_uniq, mrec, offsets,
+                                            n_parts) != part) {
+        break;
+      }
 
       *error = row_log_table_apply_delete(thr, new_trx_id_col, mrec, offsets,
                                           offsets_heap, heap, log);
@@ -2583,23 +2660,28 @@ static MY_ATTRIBUTE((warn_unused_result)) const mrec_t *row_log_table_apply_op(
       }
 
       ut_ad(next_mrec <= mrec_end);
-      log->head.total += next_mrec - mrec_start;
+      *total += next_mrec - mrec_start;
       dtuple_set_n_fields_cmp(old_pk, new_index->n_uniq);
 
+      if (n_parts > 1 && row_log_table_part(new_index->n_uniq, mrec, offsets,
+                                            n_parts) != part) {
+        break;
+      }
+
       {
         ulint len;
         const byte *db_trx_id =
             rec_get_nth_field(mrec, offsets, trx_id_col, &len);
         ut_ad(len == DATA_TRX_ID_LEN);
-        *error = row_log_table_apply_update(thr, new_trx_id_col, mrec, offsets,
-                                            offsets_heap, heap, dup,
-                                            trx_read_trx_id(db_trx_id), old_pk);
+        *error = row_log_table_apply_update(
+            thr, new_trx_id_col, mrec, offsets, offsets_heap, heap, dup,
+            trx_read_trx_id(db_trx_id), old_pk, *total);
       }
 
       break;
   }
 
-  ut_ad(log->head.total <= log->tail.total);
+  ut_ad(*total <= log->tail.total);
   mem_heap_empty(offsets_heap);
   mem_heap_empty(heap);
   return (next_mrec);
@@ -2647,6 +2729,314 @@ ulint row_log_estimate_work(const dict_index_t *index) {
 inline ulint row_log_progress_inc_per_block() { return (0); }
 #endif /* HAVE_PSI_STAGE_INTERFACE */
 
+/** Where a row_log_table_apply_part() thread stopped in the block. */
+struct row_log_table_part_t {
+  /** Start of the record at which it stopped: the end of the block,
+  or a record that continues in the next block */
+  const mrec_t *stop{nullptr};
+
+  /** Logical position in the log of stop */
+  ulonglong total{0};
+
+  /** DB_SUCCESS or error code */
+  dberr_t error{DB_SUCCESS};
+
+  /** Duplicate key errors of this thread, merged into the one of
+  row_log_table_apply() when the block is done */
+  row_merge_dup_t dup{};
+
+  /** Set when a block is ready for the thread, or when it must exit */
+  os_event_t block_ready{nullptr};
+
+  /** Set when the thread is done with the block */
+  os_event_t part_done{nullptr};
+};
+
+/** The log blocks that are applied by several threads. Each one parses all
+of the records of a block, but applies only those of its partition, by
+PRIMARY KEY (see row_log_table_part()), so the operations on a row are
+applied in order. The threads are started for the first block read from
+the file and wait for the next one in between, until the apply is over. */
+struct row_log_table_apply_t {
+  que_thr_t *thr{nullptr};
+  row_merge_dup_t *dup{nullptr};
+  ulint trx_id_col{0};
+  ulint new_trx_id_col{0};
+
+  /** Size of the offsets of a thread */
+  ulint n_offsets{0};
+
+  /** First record of the block and end of the block */
+  const mrec_t *start{nullptr};
+  const mrec_t *end{nullptr};
+
+  /** Logical position in the log of start */
+  ulonglong total{0};
+
+  /** Where each thread stopped, empty until the threads are started */
+  std::vector<row_log_table_part_t> parts;
+
+  /** Set when a thread failed, to stop the others */
+  std::atomic<bool> failed{false};
+
+  /** Set when the threads must exit */
+  bool quit{false};
+
+  /** Threads applying the parts other than the first one, which is
+  applied by the thread of row_log_table_apply_ops() */
+  std::vector<IB_thread> workers;
+};
+
+/** Determine the number of threads that can apply the log of a table
+rebuild.
+@param[in]	index	clustered index of the table being rebuilt
+@return innodb_online_alter_log_apply_threads, or 1 if the new table needs
+the operations on different rows in order */
+static ulint row_log_table_n_parts(const dict_index_t *index) {
+  const row_log_t *log = index->online_log;
+  const dict_index_t *new_index = log->table->first_index();
+
+  if (srv_online_alter_log_apply_threads <= 1 || !log->same_pk) {
+    return (1);
+  }
+
+  /* Keys that compare equal must hash alike. */
+  for (ulint i = 0; i < new_index->n_uniq; i++) {
+    const dict_field_t *field = new_index->get_field(i);
+
+    if (field->prefix_len != 0) {
+      return (1);
+    }
+
+    switch (field->col->mtype) {
+      case DATA_INT:
+      case DATA_FIXBINARY:
+      case DATA_BINARY:
+      case DATA_SYS:
+        break;
+      default:
+        return (1);
+    }
+  }
+
+  /* A UNIQUE key could be freed by one row and taken by another. */
+  for (const dict_index_t *sec = new_index->next(); sec != nullptr;
+       sec = sec->next()) {
+    if (dict_index_is_unique(sec)) {
+      return (1);
+    }
+  }
+
+  return (srv_online_alter_log_apply_threads);
+}
+
+/** Apply the records of one partition of a log block.
+@param[in,out]	apply	log block
+@param[in]	part	partition of the calling thread */
+static void row_log_table_apply_part(row_log_table_apply_t *apply,
+                                     ulint part) {
+  row_log_table_part_t &stop = apply->parts[part];
+  dict_index_t *index = apply->dup->index;
+  trx_t *trx = thr_get_trx(apply->thr);
+
+  ulint *offsets =
+      static_cast<ulint *>(ut_malloc_nokey(apply->n_offsets * sizeof *offsets));
+  offsets[0] = apply->n_offsets;
+  offsets[1] = dict_index_get_n_fields(index);
+
+  mem_heap_t *heap = mem_heap_create(UNIV_PAGE_SIZE);
+  mem_heap_t *offsets_heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+  const mrec_t *mrec = apply->start;
+
+  stop.total = apply->total;
+
+  while (mrec < apply->end && !apply->failed.load()) {
+    if (trx_is_interrupted(trx)) {
+      stop.error = DB_INTERRUPTED;
+      break;
+    }
+
+    log_free_check();
+
+    stop.error = index->online_log->error;
+
+    if (stop.error != DB_SUCCESS) {
+      break;
+    }
+
+    const mrec_t *next_mrec = row_log_table_apply_op(
+        apply->thr, apply->trx_id_col, apply->new_trx_id_col, &stop.dup,
+        &stop.error, offsets_heap, heap, mrec, apply->end, offsets,
+        &stop.total, apply->parts.size(), part);
+
+    if (stop.error != DB_SUCCESS || next_mrec == nullptr) {
+      /* Out of data: the record continues in the next block */
+      break;
+    }
+
+    mrec = next_mrec;
+  }
+
+  if (stop.error != DB_SUCCESS) {
+    apply->failed.store(true);
+  }
+
+  stop.stop = mrec;
+
+  mem_heap_free(offsets_heap);
+  mem_heap_free(heap);
+  ut_free(offsets);
+}
+
+/** Apply one partition of each log block until row_log_table_apply_stop().
+@param[in,out]	apply	log blocks
+@param[in]	part	partition of the calling thread */
+static void row_log_table_apply_worker(row_log_table_apply_t *apply,
+                                       ulint part) {
+  row_log_table_part_t &stop = apply->parts[part];
+
+  for (;;) {
+    os_event_wait(stop.block_ready);
+    os_event_reset(stop.block_ready);
+
+    if (apply->quit) {
+      break;
+    }
+
+    row_log_table_apply_part(apply, part);
+
+    os_event_set(stop.part_done);
+  }
+}
+
+/** Start the threads that apply the log blocks read from the file, for the
+rest of row_log_table_apply_ops(). Starting them once rather than for each
+block keeps the thread creation out of the apply of every block.
+@param[in,out]	apply		log blocks
+@param[in]	thr		query graph
+@param[in]	trx_id_col	position of DB_TRX_ID in old index
+@param[in]	new_trx_id_col	position of DB_TRX_ID in new index
+@param[in,out]	dup		for reporting duplicate key errors
+@param[in]	n_offsets	size of the offsets of a thread
+@param[in]	n_parts		number of threads */
+static void row_log_table_apply_start(row_log_table_apply_t *apply,
+                                      que_thr_t *thr, ulint trx_id_col,
+                                      ulint new_trx_id_col,
+                                      row_merge_dup_t *dup, ulint n_offsets,
+                                      ulint n_parts) {
+  apply->thr = thr;
+  apply->dup = dup;
+  apply->trx_id_col = trx_id_col;
+  apply->new_trx_id_col = new_trx_id_col;
+  apply->n_offsets = n_offsets;
+  apply->parts.resize(n_parts);
+
+  for (ulint t = 1; t < n_parts; t++) {
+    apply->parts[t].block_ready = os_event_create();
+    apply->parts[t].part_done = os_event_create();
+    apply->workers.push_back(os_thread_create(
+        row_log_apply_thread_key, row_log_table_apply_worker, apply, t));
+    apply->workers.back().start();
+  }
+}
+
+/** Stop the threads started by row_log_table_apply_start(), if any.
+@param[in,out]	apply	log blocks */
+static void row_log_table_apply_stop(row_log_table_apply_t *apply) {
+  apply->quit = true;
+
+  for (ulint t = 1; t < apply->parts.size(); t++) {
+    os_event_set(apply->parts[t].block_ready);
+  }
+
+  for (auto &worker : apply->workers) {
+    worker.join();
+  }
+
+  for (ulint t = 1; t < apply->parts.size(); t++) {
+    os_event_destroy(apply->parts[t].block_ready);
+    os_event_destroy(apply->parts[t].part_done);
+  }
+
+  apply->workers.clear();
+  apply->parts.clear();
+}
+
+/** Apply the records of a log block that was read from the file on the
+threads of row_log_table_apply_start() and the calling thread.
+@param[in,out]	apply		log blocks
+@param[in]	mrec		first record
+@param[in]	mrec_end	end of the block
+@param[out]	error		DB_SUCCESS or error code
+@return start of the record that continues in the next block, or mrec_end */
+static const mrec_t *row_log_table_apply_parts(row_log_table_apply_t *apply,
+                                               const mrec_t *mrec,
+                                               const mrec_t *mrec_end,
+                                               dberr_t *error) {
+  row_log_t *log = apply->dup->index->online_log;
+
+  apply->start = mrec;
+  apply->end = mrec_end;
+  apply->total = log->head.total;
+  apply->failed.store(false);
+
+  for (auto &stop : apply->parts) {
+    stop.stop = nullptr;
+    stop.total = 0;
+    stop.error = DB_SUCCESS;
+    stop.dup = *apply->dup;
+    stop.dup.n_dup = 0;
+    stop.dup.error_key_num = 0;
+    stop.dup.error_index = nullptr;
+  }
+
+  for (ulint t = 1; t < apply->parts.size(); t++) {
+    os_event_reset(apply->parts[t].part_done);
+    os_event_set(apply->parts[t].block_ready);
+  }
+
+  row_log_table_apply_part(apply, 0);
+
+  for (ulint t = 1; t < apply->parts.size(); t++) {
+    os_event_wait(apply->parts[t].part_done);
+  }
+
+  /* Each thread counted its own duplicates. The error of the first
+  partition that failed is reported. */
+  const row_log_table_part_t *failed = nullptr;
+
+  for (const auto &stop : apply->parts) {
+    apply->dup->n_dup += stop.dup.n_dup;
+
+    if (failed == nullptr && stop.error != DB_SUCCESS) {
+      failed = &stop;
+    }
+  }
+
+  if (failed != nullptr) {
+    if (failed->error == DB_DUPLICATE_KEY) {
+      apply->dup->error_key_num = failed->dup.error_key_num;
+      apply->dup->error_index = failed->dup.error_index;
+    }
+
+    *error = failed->error;
+    return (nullptr);
+  }
+
+  *error = DB_SUCCESS;
+
+  /* Every thread parsed the same records */
+  for (const auto &stop : apply->parts) {
+    ut_a(stop.stop == apply->parts[0].stop);
+    ut_a(stop.total == apply->parts[0].total);
+  }
+
+  log->head.total = apply->parts[0].total;
+
+  return (apply->parts[0].stop);
+}
+
 /** Applies operations to a table was rebuilt.
 @param[in]	thr	query graph
 @param[in,out]	dup	for reporting duplicate key errors
@@ -2677,6 +3067,8 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
   const ulint new_trx_id_col =
       dict_col_get_clust_pos(new_table->get_sys_col(DATA_TRX_ID), new_index);
   trx_t *trx = thr_get_trx(thr);
+  const ulint n_parts = row_log_table_n_parts(index);
+  row_log_table_apply_t apply;
   dberr_t err;
 
   ut_ad(index->is_clustered());
@@ -2823,10 +3215,10 @@ next_block:
 
     memcpy((mrec_t *)mrec_end, next_mrec,
            (&index->online_log->head.buf)[1] - mrec_end);
-    mrec =
-        row_log_table_apply_op(thr, trx_id_col, new_trx_id_col, dup, &error,
-                               offsets_heap, heap, index->online_log->head.buf,
-                               (&index->online_log->head.buf)[1], offsets);
+    mrec = row_log_table_apply_op(
+        thr, trx_id_col, new_trx_id_col, dup, &error, offsets_heap, heap,
+        index->online_log->head.buf, (&index->online_log->head.buf)[1],
+        offsets, &index->online_log->head.total, 1, 0);
     if (error != DB_SUCCESS) {
       goto func_exit;
     } else if (UNIV_UNLIKELY(mrec == nullptr)) {
@@ -2879,6 +3271,34 @@ next_block:
 
   mrec_end = next_mrec_end;
 
+  if (!has_index_lock && n_parts > 1 && next_mrec < next_mrec_end) {
+    /* A block read from the file is applied by several threads. The
+    last block is applied under index->lock, which the threads would
+    wait for in row_log_table_apply_convert_mrec(). */
+    if (apply.parts.empty()) {
+      row_log_table_apply_start(&apply, thr, trx_id_col, new_trx_id_col, dup,
+                                i, n_parts);
+    }
+
+    mrec = row_log_table_apply_parts(&apply, next_mrec, mrec_end, &error);
+
+    if (error == DB_INTERRUPTED) {
+      goto interrupted;
+    } else if (error != DB_SUCCESS) {
+      goto func_exit;
+    }
+
+    if (mrec == mrec_end) {
+      mrec = nullptr;
+    } else {
+      memcpy(index->online_log->head.buf, mrec, mrec_end - mrec);
+      mrec_end += index->online_log->head.buf - mrec;
+      mrec = index->online_log->head.buf;
+    }
+
+    goto process_next_block;
+  }
+
   while (!trx_is_interrupted(trx)) {
     if (next_mrec == next_mrec_end && has_index_lock) {
       goto all_done;
@@ -2921,9 +3341,9 @@ next_block:
       goto func_exit;
     }
 
-    next_mrec =
-        row_log_table_apply_op(thr, trx_id_col, new_trx_id_col, dup, &error,
-                               offsets_heap, heap, mrec, mrec_end, offsets);
+    next_mrec = row_log_table_apply_op(
+        thr, trx_id_col, new_trx_id_col, dup, &error, offsets_heap, heap, mrec,
+        mrec_end, offsets, &index->online_log->head.total, 1, 0);
 
     if (error != DB_SUCCESS) {
       goto func_exit;
@@ -2967,6 +3387,8 @@ next_block:
 interrupted:
   error = DB_INTERRUPTED;
 func_exit:
+  row_log_table_apply_stop(&apply);
+
   if (!has_index_lock) {
     rw_lock_x_lock(dict_index_get_lock(index));
   }
@@ -3009,11 +3431,18 @@ dberr_t row_log_table_apply(que_thr_t *thr, dict_table_t *old_table,
     ut_ad(0);
     error = DB_ERROR;
   } else {
-    row_merge_dup_t dup = {clust_index, table, clust_index->online_log->col_map,
-                           0};
+    row_merge_dup_t dup = {
+        clust_index, table, clust_index->online_log->col_map, 0, 0, nullptr};
 
     error = row_log_table_apply_ops(thr, &dup, stage);
 
+    if (error == DB_DUPLICATE_KEY) {
+      trx_t *trx = thr_get_trx(thr);
+
+      trx->error_key_num = dup.error_key_num;
+      trx->error_index = dup.error_index;
+    }
+
     ut_ad(error != DB_SUCCESS || clust_index->online_log->head.total ==
                                      clust_index->online_log->tail.total);
   }
@@ -3747,7 +4176,7 @@ dberr_t row_log_apply(const trx_t *trx, dict_index_t *index,
                       struct TABLE *table, ut_stage_alter_t *stage) {
   dberr_t error;
   row_log_t *log;
-  row_merge_dup_t dup = {index, table, nullptr, 0};
+  row_merge_dup_t dup = {index, table, nullptr, 0, 0, nullptr};
   DBUG_TRACE;
 
   ut_ad(dict_index_is_online_ddl(index));
@@ -45,6 +45,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "lob0lob.h"
 #include "lock0lock.h"
 #include "my_psi_config.h"
+#include "os0thread-create.h"
 #include "pars0pars.h"
 #include "row0ext.h"
 #include "row0ftsort.h"
@@ -69,6 +70,10 @@ this program; if not, write to the Free Software Foundation, Inc.,
 /* Whether to disable file system cache */
 bool srv_disable_sort_file_cache;
 
+#ifdef UNIV_PFS_THREAD
+mysql_pfs_key_t ddl_sort_thread_key;
+#endif /* UNIV_PFS_THREAD */
+
 /** Class that caches index row tuples made from a single cluster
 index page scan, and then insert into corresponding index tree */
 class index_tuple_info_t {
@@ -1647,7 +1652,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
   merge_buf = static_cast<row_merge_buf_t **>(
       ut_malloc_nokey(n_index * sizeof *merge_buf));
 
-  row_merge_dup_t clust_dup = {index[0], table, col_map, 0};
+  row_merge_dup_t clust_dup = {index[0], table, col_map, 0, 0, nullptr};
   dfield_t *prev_fields;
   const ulint n_uniq = dict_index_get_n_unique(index[0]);
 
@@ -2258,7 +2263,7 @@ static MY_ATTRIBUTE((warn_unused_result)) dberr_t
             break;
           }
         } else if (dict_index_is_unique(buf->index)) {
-          row_merge_dup_t dup = {buf->index, table, col_map, 0};
+          row_merge_dup_t dup = {buf->index, table, col_map, 0, 0, nullptr};
 
           row_merge_buf_sort(buf, &dup);
 
@@ -3606,6 +3611,158 @@ static void row_merge_write_redo(const dict_index_t *index) {
   mtr.commit();
 }
 
+/** Merge files of secondary indexes sorted by row_merge_sort_parallel(). */
+struct row_merge_psort_t {
+  /** Transaction of the index build */
+  trx_t *trx;
+
+  /** Indexes to sort, and their merge files */
+  std::vector<row_merge_dup_t, ut_allocator<row_merge_dup_t>> dups;
+  std::vector<merge_file_t *, ut_allocator<merge_file_t *>> files;
+
+  /** Outcome of each sort; DB_SUCCESS of one never started */
+  std::vector<dberr_t, ut_allocator<dberr_t>> errors;
+
+  /** Which of them were sorted (or failed); not vector<bool>, whose
+  elements share words */
+  std::vector<byte, ut_allocator<byte>> done;
+
+  /** Next index to take */
+  std::atomic<ulint> next{0};
+
+  /** Set on the first failure: the others are not started */
+  std::atomic<bool> failed{false};
+};
+
+/** Sort merge files of a row_merge_psort_t until none is left.
+@param[in,out]	psort	the sorts shared by the workers
+@param[in,out]	block	3 * srv_sort_buf_size buffers of this worker
+@param[in,out]	tmpfd	temporary file of this worker */
+static void row_merge_psort_worker(row_merge_psort_t *psort,
+                                   row_merge_block_t *block, int *tmpfd) {
+  for (;;) {
+    const ulint k = psort->next.fetch_add(1);
+
+    if (k >= psort->files.size() || psort->failed.load()) {
+      break;
+    }
+
+    /* Progress is not accounted here: ut_stage_alter_t is not
+    thread safe. */
+    psort->errors[k] = row_merge_sort(psort->trx, &psort->dups[k],
+                                      psort->files[k], block, tmpfd, nullptr);
+    psort->done[k] = 1;
+
+    if (psort->errors[k] != DB_SUCCESS) {
+      psort->failed.store(true);
+    }
+  }
+}
+
+/** Merge sort the files of the non-unique secondary indexes of a build on
+up to innodb_ddl_threads threads, each with its own 3 * srv_sort_buf_size
+buffers and temporary file. The sorted files are inserted afterwards, one
+index at a time, as before. Unique indexes are left to the caller: their
+sort reports a duplicate in the MySQL row buffer of the table, which the
+threads would share.
+@param[in]	trx		transaction
+@param[in]	indexes		indexes to be created
+@param[in,out]	merge_files	merge files of indexes
+@param[in]	n_indexes	size of indexes[]
+@param[out]	sorted		sorted[i] is set if the file of indexes[i]
+                                was sorted here
+@param[out]	errors		errors[i] is the outcome of that sort */
+static void row_merge_sort_parallel(trx_t *trx, dict_index_t **indexes,
+                                    merge_file_t *merge_files,
+                                    ulint n_indexes, bool *sorted,
+                                    dberr_t *errors) {
+  const char *path = thd_innodb_tmpdir(trx->mysql_thd);
+  row_merge_psort_t psort;
+  std::vector<ulint, ut_allocator<ulint>> positions;
+
+  psort.trx = trx;
+
+  for (ulint i = 0; i < n_indexes; i++) {
+    sorted[i] = false;
+    errors[i] = DB_SUCCESS;
+
+    dict_index_t *index = indexes[i];
+
+    /* Files of one block have nothing to merge. */
+    if (dict_index_is_spatial(index) || (index->type & DICT_FTS) ||
+        dict_index_is_unique(index) || merge_files[i].fd < 0 ||
+        merge_files[i].offset <= 1) {
+      continue;
+    }
+
+    psort.dups.push_back({index, nullptr, nullptr, 0, 0, nullptr});
+    psort.files.push_back(&merge_files[i]);
+    positions.push_back(i);
+  }
+
+  ulint n_threads = std::min<ulint>(thd_ddl_threads(trx->mysql_thd),
+                                    psort.files.size());
+
+  if (n_threads < 2) {
+    return;
+  }
+
+  psort.errors.assign(psort.files.size(), DB_SUCCESS);
+  psort.done.assign(psort.files.size(), 0);
+
+  ut_allocator<row_merge_block_t> alloc(mem_key_row_merge_sort);
+  std::vector<row_merge_block_t *, ut_allocator<row_merge_block_t *>> blocks;
+  std::vector<ut_new_pfx_t, ut_allocator<ut_new_pfx_t>> block_pfx(n_threads);
+  std::vector<int, ut_allocator<int>> tmpfds(n_threads, -1);
+
+  /* Buffers and temporary files are made here, by the session thread;
+  a thread that gets none is not started. */
+  for (ulint t = 0; t < n_threads; t++) {
+    row_merge_block_t *block =
+        alloc.allocate_large(3 * srv_sort_buf_size, &block_pfx[t]);
+
+    if (block == nullptr) {
+      break;
+    }
+
+    if (row_merge_tmpfile_if_needed(&tmpfds[t], path) < 0) {
+      alloc.deallocate_large(block, &block_pfx[t]);
+      break;
+    }
+
+    blocks.push_back(block);
+  }
+
+  n_threads = blocks.size();
+
+  if (n_threads >= 2) {
+    std::vector<IB_thread> workers;
+
+    for (ulint t = 1; t < n_threads; t++) {
+      workers.push_back(os_thread_create(ddl_sort_thread_key,
+                                         row_merge_psort_worker, &psort,
+                                         blocks[t], &tmpfds[t]));
+      workers.back().start();
+    }
+
+    row_merge_psort_worker(&psort, blocks[0], &tmpfds[0]);
+
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    for (ulint k = 0; k < positions.size(); k++) {
+      sorted[positions[k]] = psort.done[k] != 0;
+      errors[positions[k]] = psort.errors[k];
+    }
+  }
+
+  for (ulint t = 0; t < n_threads; t++) {
+    row_merge_file_destroy_low(tmpfds[t]);
+    alloc.deallocate_large(blocks[t], &block_pfx[t]);
+  }
+}
+
 /** Build indexes on a table by reading a clustered index, creating a temporary
 file containing index entries, merge sorting these index entries and inserting
 sorted index entries to indexes.
@@ -3653,6 +3810,8 @@ dberr_t row_merge_build_indexes(
   fts_psort_t *merge_info = nullptr;
   int64_t sig_count = 0;
   bool fts_psort_initiated = false;
+  bool *sorted = nullptr;
+  dberr_t *sort_errors = nullptr;
   DBUG_TRACE;
 
   ut_ad(!srv_read_only_mode);
@@ -3768,7 +3927,20 @@ dberr_t row_merge_build_indexes(
   DEBUG_SYNC_C("row_merge_after_scan");
 
   /* Now we have files containing index entries ready for
-  sorting and inserting. */
+  sorting and inserting. Sort those that allow it in parallel
+  first. */
+
+  sorted = static_cast<bool *>(ut_malloc_nokey(n_indexes * sizeof *sorted));
+  sort_errors =
+      static_cast<dberr_t *>(ut_malloc_nokey(n_indexes * sizeof *sort_errors));
+
+  if (sorted == nullptr || sort_errors == nullptr) {
+    error = DB_OUT_OF_MEMORY;
+    goto func_exit;
+  }
+
+  row_merge_sort_parallel(trx, indexes, merge_files, n_indexes, sorted,
+                          sort_errors);
 
   for (i = 0; i < n_indexes; i++) {
     dict_index_t *sort_idx = indexes[i];
@@ -3833,9 +4005,15 @@ dberr_t row_merge_build_indexes(
       DEBUG_FTS_SORT_PRINT("FTS_SORT: Complete Insert\n");
 #endif
     } else if (merge_files[i].fd >= 0) {
-      row_merge_dup_t dup = {sort_idx, table, col_map, 0};
+      row_merge_dup_t dup = {sort_idx, table, col_map, 0, 0, nullptr};
 
-      error = row_merge_sort(trx, &dup, &merge_files[i], block, &tmpfd, stage);
+      if (sorted[i]) {
+        stage->begin_phase_sort(1);
+        error = sort_errors[i];
+      } else {
+        error =
+            row_merge_sort(trx, &dup, &merge_files[i], block, &tmpfd, stage);
+      }
 
       if (error == DB_SUCCESS) {
         BtrBulk btr_bulk(sort_idx, trx->id, flush_observer);
@@ -3905,6 +4083,8 @@ func_exit:
   }
 
   ut_free(merge_files);
+  ut_free(sorted);
+  ut_free(sort_errors);
 
   alloc.deallocate_large(block, &block_pfx);
 
@@ -58,6 +58,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "fts0types.h"
 #include "ha_prototypes.h"
 #include "ibuf0ibuf.h"
+#include "lob0compress.h"
 #include "lock0lock.h"
 #include "log0log.h"
 #include "pars0pars.h"
@@ -541,6 +542,23 @@ byte *row_mysql_store_col_in_innobase_format(
   return (buf);
 }
 
+void row_mysql_compress_col(dfield_t *dfield, ulint level,
+                            row_prebuilt_t *prebuilt) {
+  ut_ad(!dfield_is_null(dfield));
+
+  if (prebuilt->compress_heap == nullptr) {
+    prebuilt->compress_heap = mem_heap_create(UNIV_PAGE_SIZE);
+  }
+
+  ulint len;
+  byte *data =
+      lob::compress_column(static_cast<const byte *>(dfield_get_data(dfield)),
+                           dfield_get_len(dfield), level,
+                           prebuilt->compress_heap, &len);
+
+  dfield_set_data(dfield, data, len);
+}
+
 /** Convert a row in the MySQL format to a row in the Innobase format. Note that
  the function to convert a MySQL format key value to an InnoDB dtuple is
  row_sel_convert_mysql_key_to_innobase() in row0sel.cc. */
@@ -567,6 +585,10 @@ static void row_mysql_convert_row_to_innobase(
   ut_ad(prebuilt->template_type == ROW_MYSQL_WHOLE_ROW);
   ut_ad(prebuilt->mysql_template);
 
+  if (prebuilt->compress_heap != nullptr) {
+    mem_heap_empty(prebuilt->compress_heap);
+  }
+
   for (i = 0; i < prebuilt->n_template; i++) {
     bool is_multi_val = false;
 
@@ -621,6 +643,10 @@ static void row_mysql_convert_row_to_innobase(
           mysql_rec + templ->mysql_col_offset, templ->mysql_col_len,
           dict_table_is_comp(prebuilt->table));
 
+      if (templ->compress_level > 0) {
+        row_mysql_compress_col(dfield, templ->compress_level, prebuilt);
+      }
+
       /* server has issue regarding handling BLOB virtual fields,
       and we need to duplicate it with our own memory here */
       if (templ->is_virtual &&
@@ -962,6 +988,10 @@ void row_prebuilt_free(row_prebuilt_t *prebuilt, ibool dict_locked) {
     mem_heap_free(prebuilt->old_vers_heap);
   }
 
+  if (prebuilt->compress_heap) {
+    mem_heap_free(prebuilt->compress_heap);
+  }
+
   if (prebuilt->fetch_cache[0] != nullptr) {
     byte *base = prebuilt->fetch_cache[0] - 4;
     byte *ptr = base;
@@ -4464,6 +4494,87 @@ dberr_t row_mysql_parallel_select_count_star(
   return (err);
 }
 
+dberr_t row_mysql_parallel_column_aggregate(
+    trx_t *trx, std::vector<dict_index_t *> &indexes, ulint col_no, bool sum,
+    size_t max_threads, ulint *n_not_null, int64_t *sum_high,
+    uint64_t *sum_low) {
+  ut_a(!indexes.empty());
+
+  Column_aggregate partials[Parallel_reader::MAX_THREADS] = {};
+
+  Parallel_reader reader(max_threads);
+
+  const Parallel_reader::Scan_range FULL_SCAN;
+
+  bool success{};
+
+  for (auto index : indexes) {
+    const dict_col_t *col = index->table->get_col(col_no);
+    const ulint pos = dict_col_get_clust_pos(col, index);
+    const bool is_unsigned = col->prtype & DATA_UNSIGNED;
+
+    ut_a(pos != ULINT_UNDEFINED);
+    ut_a(!sum || col->mtype == DATA_INT);
+
+    Parallel_reader::Config config(FULL_SCAN, index);
+
+    auto f = [&, index, pos, is_unsigned](const Parallel_reader::Ctx *ctx) {
+      ulint len;
+      const byte *data = rec_get_nth_field_instant(
+          ctx->m_rec, ctx->m_offsets, pos, index, &len);
+
+      if (len == UNIV_SQL_NULL) {
+        return (DB_SUCCESS);
+      }
+
+      auto &partial = partials[ctx->thread_id()];
+
+      ++partial.m_n_not_null;
+
+      if (sum) {
+        partial.add_value(data, len, is_unsigned);
+      }
+
+      return (DB_SUCCESS);
+    };
+
+    success = reader.add_scan(trx, config, f);
+
+    if (!success) {
+      break;
+    }
+  }
+
+  auto err = success ? reader.run() : DB_ERROR;
+
+  if (err == DB_OUT_OF_RESOURCES) {
+    ib::warn(ER_INNODB_OUT_OF_RESOURCES)
+        << "Resource not available to create threads for parallel scan."
+        << " Falling back to single thread mode.";
+
+    for (auto &partial : partials) {
+      partial = Column_aggregate{};
+    }
+
+    reader.fallback_to_single_threaded_mode();
+    err = reader.run();
+  }
+
+  if (err == DB_SUCCESS) {
+    Column_aggregate total{};
+
+    for (const auto &partial : partials) {
+      total.merge(partial);
+    }
+
+    *n_not_null = total.m_n_not_null;
+    *sum_high = total.m_high;
+    *sum_low = total.m_low;
+  }
+
+  return (err);
+}
+
 /** Scan the rows in parallel.
 @param[in,out] trx              Transaction covering the scan.
 @param[in] index                (Cluster) Index to scan.
@@ -45,8 +45,6 @@ Histogram_sampler::Histogram_sampler(size_t max_threads, int sampling_seed,
       m_sampling_method(sampling_method),
       m_sampling_percentage(sampling_percentage),
       m_sampling_seed(sampling_seed) {
-  ut_ad(max_threads == 1);
-
   m_start_buffer_event = os_event_create();
   m_end_buffer_event = os_event_create();
 
@@ -98,6 +96,15 @@ dberr_t Histogram_sampler::finish_callback(
            "Total number of rows sampled : "
                << m_n_sampled.load(std::memory_order_relaxed));
 
+  std::lock_guard<std::mutex> guard(m_handoff_mutex);
+
+  /* The others may still have rows to hand over, unless the read failed:
+  a thread that could not be spawned never gets here. */
+  if (m_n_running.fetch_sub(1) > 1 &&
+      m_parallel_reader.get_error_state() == DB_SUCCESS) {
+    return (DB_SUCCESS);
+  }
+
   if (is_error_set()) {
     signal_end_of_buffering();
     return (m_err);
@@ -164,7 +171,7 @@ void Histogram_sampler::signal_end_of_buffering() {
   os_event_set(m_end_buffer_event);
 }
 
-bool Histogram_sampler::skip() {
+bool Histogram_sampler::skip(page_no_t page_no) {
   if (m_sampling_percentage == 0.00) {
     return (true);
   } else if (m_sampling_percentage == 100.00) {
@@ -175,7 +182,16 @@ bool Histogram_sampler::skip() {
 
   switch (m_sampling_method) {
     case enum_sampling_method::SYSTEM: {
-      double rand = m_distribution(m_random_generator);
+      double rand;
+
+      if (m_parallel_reader.max_threads() > 1) {
+        const ulint fold =
+            ut_fold_ulint_pair(static_cast<ulint>(m_sampling_seed), page_no);
+
+        rand = (fold % 10000) / 100.0;
+      } else {
+        rand = m_distribution(m_random_generator);
+      }
 
       DBUG_PRINT("histogram_sampler_buffering_print",
                  ("-> New page. Random value generated - %lf", rand));
@@ -223,6 +239,8 @@ void Histogram_sampler::buffer_end() {
 }
 
 dberr_t Histogram_sampler::run() {
+  m_n_running = m_parallel_reader.max_threads();
+
   return m_parallel_reader.run(m_parallel_reader.max_threads());
 }
 
@@ -234,6 +252,13 @@ dberr_t Histogram_sampler::sample_rec(const Parallel_reader::Ctx *reader_ctx,
 
   auto reader_thread_ctx = reader_ctx->thread_ctx();
 
+  std::lock_guard<std::mutex> guard(m_handoff_mutex);
+
+  /* Another thread has already taken the request to end, or failed. */
+  if (is_error_set()) {
+    return (m_err);
+  }
+
   wait_for_start_of_buffering();
 
   /* Return as the sampler has been requested to end sampling. */
@@ -264,7 +289,8 @@ dberr_t Histogram_sampler::process_non_leaf_rec(
                   set_error_state(DB_ERROR);
                   return DB_ERROR;);
 
-  if (skip()) {
+  if (skip(btr_node_ptr_get_child_page_no(ctx_const->m_rec,
+                                          ctx_const->m_offsets))) {
     srv_stats.n_sampled_pages_skipped.inc();
 
     DBUG_PRINT("histogram_sampler_buffering_print", ("Skipping block."));
@@ -53,6 +53,8 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "ha_innodb.h"
 #include "ha_prototypes.h"
 #include "handler.h"
+#include "json_binary.h"
+#include "lob0compress.h"
 #include "lob0lob.h"
 #include "lob0undo.h"
 #include "lock0lock.h"
@@ -73,6 +75,7 @@ this program; if not, write to the Free Software Foundation, Inc.,
 #include "ut0new.h"
 
 #include "my_dbug.h"
+#include "sql_string.h"
 
 /** Maximum number of rows to prefetch; MySQL interface has another parameter */
 #define SEL_MAX_N_PREFETCH 16
@@ -2769,6 +2772,57 @@ void row_sel_field_store_in_mysql_format_func(byte *dest,
   }
 }
 
+/** Reads only the members of an externally stored JSON column that the
+statement needs, see TABLE::json_projection(). The LOB pages that hold
+neither the object headers on the member paths nor the member values
+are not fetched.
+@param[in]	trx		current transaction
+@param[in]	clust_index	clustered index
+@param[in]	rec		clustered index record
+@param[in]	offsets		rec_get_offsets(rec, clust_index)
+@param[in]	page_size	page size of the table
+@param[in]	field_no	field number of the column
+@param[in]	projection	member paths to read
+@param[in,out]	heap		heap for the projected value
+@param[out]	len		length of the projected value
+@return the projected value, or nullptr if the whole value must be read */
+static const byte *row_sel_project_json_field(
+    trx_t *trx, const dict_index_t *clust_index, const rec_t *rec,
+    const ulint *offsets, const page_size_t &page_size, ulint field_no,
+    const json_binary::Projection *projection, mem_heap_t *heap, ulint *len) {
+  ulint local_len;
+  const byte *field = rec_get_nth_field(rec, offsets, field_no, &local_len);
+
+  ut_a(local_len >= BTR_EXTERN_FIELD_REF_SIZE);
+  local_len -= BTR_EXTERN_FIELD_REF_SIZE;
+
+  lob::ref_t ref(const_cast<byte *>(field + local_len));
+
+  if (ref.is_null() || ref.is_being_modified()) {
+    return (nullptr);
+  }
+
+  const json_binary::Projection::Range_reader reader =
+      [&](size_t offset, size_t length, char *dest) {
+        return (!lob::btr_rec_read_externally_stored_field_range(
+            clust_index, rec, offsets, page_size, field_no, offset, length,
+            reinterpret_cast<byte *>(dest)));
+      };
+
+  String projected;
+
+  if (projection->project(trx->mysql_thd, reader, local_len + ref.length(),
+                          &projected)) {
+    return (nullptr);
+  }
+
+  byte *data = static_cast<byte *>(mem_heap_alloc(heap, projected.length()));
+  memcpy(data, projected.ptr(), projected.length());
+  *len = projected.length();
+
+  return (data);
+}
+
 /** Convert a field from Innobase format to MySQL format. */
 #define row_sel_store_mysql_field(m, p, r, ri, pi, o, f, t, s, l, bh) \
   row_sel_store_mysql_field_func(m, p, r, ri, pi, o, f, t, s, l, bh)
@@ -2852,9 +2906,20 @@ static MY_ATTRIBUTE((warn_unused_result)) bool row_sel_store_mysql_field_func(
 
     size_t lob_version = 0;
 
-    data = lob::btr_rec_copy_externally_stored_field(
-        prebuilt->trx, clust_index, rec, offsets, page_size, field_no, &len,
-        &lob_version, dict_index_is_sdi(rec_index), heap);
+    data = nullptr;
+
+    if (templ->json_projection != nullptr && lob_undo == nullptr &&
+        templ->compress_level == 0 && !clust_templ_for_sec) {
+      data = row_sel_project_json_field(prebuilt->trx, clust_index, rec,
+                                        offsets, page_size, field_no,
+                                        templ->json_projection, heap, &len);
+    }
+
+    if (data == nullptr) {
+      data = lob::btr_rec_copy_externally_stored_field(
+          prebuilt->trx, clust_index, rec, offsets, page_size, field_no, &len,
+          &lob_version, dict_index_is_sdi(rec_index), heap);
+    }
 
     if (data == nullptr) {
       /* The externally stored field was not written
@@ -2892,6 +2957,10 @@ static MY_ATTRIBUTE((warn_unused_result)) bool row_sel_store_mysql_field_func(
 
     ut_a(rec_field_not_null_not_add_col_def(len));
 
+    if (templ->compress_level > 0) {
+      data = lob::decompress_column(data, len, heap, &len);
+    }
+
     row_sel_field_store_in_mysql_format(mysql_rec + templ->mysql_col_offset,
                                         templ, rec_index, field_no, data, len,
                                         ULINT_UNDEFINED);
@@ -2940,7 +3009,19 @@ static MY_ATTRIBUTE((warn_unused_result)) bool row_sel_store_mysql_field_func(
       }
 
       heap = blob_heap;
-      data = static_cast<byte *>(mem_heap_dup(heap, data, len));
+
+      const byte *stored = data;
+      const ulint stored_len = len;
+
+      if (templ->compress_level > 0) {
+        data = lob::decompress_column(data, len, heap, &len);
+      }
+
+      /* A decompressed value already lives in the heap, a value
+      stored without compression still points into the page. */
+      if (data >= stored && data <= stored + stored_len) {
+        data = static_cast<byte *>(mem_heap_dup(heap, data, len));
+      }
     }
 
     /* Reassign the clustered index field no. */
@@ -4432,6 +4513,91 @@ static inline rec_t *row_search_debug_copy_rec_order_prefix(
 }
 #endif /* UNIV_DEBUG */
 
+void row_sel_begin_clust_batch(row_prebuilt_t *prebuilt,
+                               const dtuple_t **tuples, ulint n_tuples) {
+  prebuilt->end_batch_lookup();
+
+  if (n_tuples == 0) {
+    return;
+  }
+
+  btr_cur_prefetch_leaves(prebuilt->table->first_index(), tuples, n_tuples);
+
+  prebuilt->m_batch_lookup = true;
+}
+
+/** Position the cursor of a unique search of the clustered index on the leaf
+page where the previous key of a batch was found, if the key must be on that
+page too. This is the case when the page has a user record greater than or
+equal to the key, and either a user record before it or an equal key.
+@param[in,out]	prebuilt	prebuilt struct in a batch lookup
+@param[in]	index		clustered index
+@param[in]	tuple		search tuple
+@param[in,out]	pcur		cursor to position with PAGE_CUR_GE
+@param[in,out]	mtr		mini-transaction
+@return true if pcur was positioned; false if the page could not be used and
+nothing is latched */
+static bool row_sel_open_batch_leaf(row_prebuilt_t *prebuilt,
+                                    dict_index_t *index,
+                                    const dtuple_t *tuple, btr_pcur_t *pcur,
+                                    mtr_t *mtr) {
+  const ulint savepoint = mtr_set_savepoint(mtr);
+
+  buf_block_t *block =
+      prebuilt->m_batch_leaf.run_with_hint([&](buf_block_t *hint) {
+        if (hint == nullptr ||
+            !buf_page_optimistic_get(
+                RW_S_LATCH, hint, prebuilt->m_batch_leaf_modify_clock,
+                Page_fetch::NORMAL, __FILE__, __LINE__, mtr)) {
+          return static_cast<buf_block_t *>(nullptr);
+        }
+        return hint;
+      });
+
+  if (block == nullptr) {
+    prebuilt->m_batch_leaf.clear();
+    return false;
+  }
+
+  const page_t *page = buf_block_get_frame(block);
+  btr_cur_t *cursor = pcur->get_btr_cur();
+  ulint up_match = 0;
+  ulint low_match = 0;
+
+  if (fil_page_index_page_check(page) &&
+      btr_page_get_index_id(page) == index->id && page_is_leaf(page) &&
+      page_get_n_recs(page) > 0) {
+    page_cur_search_with_match(block, index, tuple, PAGE_CUR_GE, &up_match,
+                               &low_match, btr_cur_get_page_cur(cursor),
+                               nullptr);
+
+    const rec_t *rec = btr_cur_get_rec(cursor);
+
+    if (page_rec_is_user_rec(rec) &&
+        (up_match >= dtuple_get_n_fields_cmp(tuple) ||
+         page_rec_is_user_rec(page_rec_get_prev_const(rec)))) {
+      buf_block_dbg_add_level(block, SYNC_TREE_NODE);
+
+      cursor->index = index;
+      cursor->flag = BTR_CUR_BINARY;
+      cursor->up_match = up_match;
+      cursor->low_match = low_match;
+
+      pcur->m_latch_mode = BTR_SEARCH_LEAF;
+      pcur->m_search_mode = PAGE_CUR_GE;
+      pcur->m_pos_state = BTR_PCUR_IS_POSITIONED;
+      pcur->m_old_stored = false;
+      pcur->m_trx_if_known = nullptr;
+
+      return true;
+    }
+  }
+
+  mtr_release_block_at_savepoint(mtr, savepoint, block);
+
+  return false;
+}
+
 /** Searches for rows in the database using cursor.
 Function is mainly used for tables that are shared accorss connection and
 so it employs technique that can help re-construct the rows that
@@ -4495,6 +4661,9 @@ dberr_t row_search_mvcc(byte *buf, page_cur_mode_t mode,
   ibool same_user_rec = FALSE;
   mtr_t mtr;
   mem_heap_t *heap = nullptr;
+  /* Key on a leaf page entered by the scan, from which to read ahead once
+  the mini-transaction is committed */
+  const dtuple_t *read_ahead_tuple = nullptr;
   ulint offsets_[REC_OFFS_NORMAL_SIZE];
   ulint *offsets = offsets_;
   ulint sec_offsets_[REC_OFFS_NORMAL_SIZE];
@@ -4559,6 +4728,7 @@ dberr_t row_search_mvcc(byte *buf, page_cur_mode_t mode,
     trx->op_info = "starting index read";
 
     prebuilt->n_rows_fetched = 0;
+    prebuilt->m_read_ahead_countdown = 0;
     prebuilt->n_fetch_cached = 0;
     prebuilt->fetch_cache_first = 0;
     if (record_buffer != nullptr) {
@@ -4927,8 +5097,13 @@ dberr_t row_search_mvcc(byte *buf, page_cur_mode_t mode,
       }
     }
 
-    btr_pcur_open_with_no_init(index, search_tuple, mode, BTR_SEARCH_LEAF, pcur,
-                               0, &mtr);
+    if (!prebuilt->m_batch_lookup || !unique_search ||
+        !index->is_clustered() || mode != PAGE_CUR_GE ||
+        prebuilt->select_lock_type != LOCK_NONE ||
+        !row_sel_open_batch_leaf(prebuilt, index, search_tuple, pcur, &mtr)) {
+      btr_pcur_open_with_no_init(index, search_tuple, mode, BTR_SEARCH_LEAF,
+                                 pcur, 0, &mtr);
+    }
 
     pcur->m_trx_if_known = trx;
 
@@ -5802,6 +5977,12 @@ idx_cond_failed:
       prebuilt->innodb_api_rec =
           rec_copy(prebuilt->innodb_api_buf, result_rec, offsets);
     }
+  } else if (prebuilt->m_batch_lookup) {
+    /* The next key of the batch is likely on the same leaf page */
+    buf_block_t *block = btr_pcur_get_block(pcur);
+
+    prebuilt->m_batch_leaf.store(block);
+    prebuilt->m_batch_leaf_modify_clock = buf_block_get_modify_clock(block);
   }
 
   goto normal_return;
@@ -5913,7 +6094,33 @@ next_rec:
       move = rtr_pcur_move_to_next(search_tuple, mode, prebuilt->select_mode,
                                    pcur, 0, &mtr);
     } else {
+      const buf_block_t *prev_block = btr_pcur_get_block(pcur);
+
       move = btr_pcur_move_to_next(pcur, &mtr);
+
+      if (move && srv_logical_read_ahead > 0 && read_ahead_tuple == nullptr &&
+          btr_pcur_get_block(pcur) != prev_block &&
+          !index->table->is_intrinsic()) {
+        /* The scan entered another leaf page: the leaf pages after it
+        are read ahead in key order, which the linear read-ahead cannot
+        do for a fragmented index. The tree is searched for them only
+        after the mini-transaction, to keep the latching order. */
+        if (prebuilt->m_read_ahead_countdown > 0) {
+          --prebuilt->m_read_ahead_countdown;
+        } else {
+          const rec_t *first = page_rec_get_next_const(
+              page_get_infimum_rec(btr_pcur_get_page(pcur)));
+
+          if (page_rec_is_user_rec(first)) {
+            if (heap == nullptr) {
+              heap = mem_heap_create(100);
+            }
+            read_ahead_tuple = dict_index_build_data_tuple(
+                index, const_cast<rec_t *>(first),
+                dict_index_get_n_unique_in_tree(index), heap);
+          }
+        }
+      }
     }
 
     if (!move) {
@@ -6019,6 +6226,15 @@ normal_return:
 
   mtr_commit(&mtr);
 
+  if (read_ahead_tuple != nullptr) {
+    const ulint n_read_ahead = btr_cur_read_ahead_leaves(
+        index, read_ahead_tuple, srv_logical_read_ahead);
+
+    /* Read ahead again when half of the pages have been scanned */
+    prebuilt->m_read_ahead_countdown =
+        (n_read_ahead > 1 ? n_read_ahead : srv_logical_read_ahead) / 2;
+  }
+
   /* Rollback blocking transactions from hit list for high priority
   transaction, if any. We should not be holding latches here as
   we are going to rollback the blocking transactions. */
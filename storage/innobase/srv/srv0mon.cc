@@ -835,6 +835,22 @@ static monitor_info_t innodb_counter_info[] = {
      MONITOR_NONE, MONITOR_DEFAULT_START,
      MONITOR_PURGE_TRUNCATE_HISTORY_MICROSECOND},
 
+    {"purge_threads_used", "purge",
+     "Number of purge threads used by the last purge batch",
+     MONITOR_DISPLAY_CURRENT, MONITOR_DEFAULT_START,
+     MONITOR_PURGE_THREADS_USED},
+
+    {"purge_batch_size_used", "purge",
+     "Number of undo log pages requested by the last purge batch",
+     MONITOR_DISPLAY_CURRENT, MONITOR_DEFAULT_START,
+     MONITOR_PURGE_BATCH_SIZE_USED},
+
+    {"purge_undo_log_pages_per_sec", "purge",
+     "Undo log pages handled by the purge per second, over the last second"
+     " it ran",
+     MONITOR_DISPLAY_CURRENT, MONITOR_DEFAULT_START,
+     MONITOR_PURGE_PAGES_PER_SEC},
+
     /* ========== Counters for Undo Tablespace Truncation ========== */
     {"module_undo", "undo", "Undo Truncation", MONITOR_MODULE,
      MONITOR_DEFAULT_START, MONITOR_UNDO_TRUNCATE},
@@ -1028,6 +1044,25 @@ static monitor_info_t innodb_counter_info[] = {
                        "Waits in user threads on space in log files",
                        MONITOR_LOG_ON_FILE_SPACE_),
 
+    {"log_writer_on_checkpoint_age_stall_time", "log",
+     "Time (in microseconds) log_writer waited for checkpoint to reclaim"
+     " space in log files",
+     /* Non-zero values of the counter => checkpoint age reaches the redo
+     capacity. Then innodb_log_file_size should be increased. */
+     MONITOR_NONE, MONITOR_DEFAULT_START,
+     MONITOR_LOG_WRITER_ON_CHECKPOINT_AGE_STALL_TIME},
+
+    {"log_on_file_space_stall_time", "log",
+     "Time (in microseconds) user threads waited for space in log files",
+     MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_LOG_ON_FILE_SPACE_STALL_TIME},
+
+    {"log_on_buffer_space_stall_time", "log",
+     "Time (in microseconds) user threads waited for space in log buffer",
+     /* Non-zero values of the counter => innodb_log_buffer_size should
+     be increased. */
+     MONITOR_NONE, MONITOR_DEFAULT_START,
+     MONITOR_LOG_ON_BUFFER_SPACE_STALL_TIME},
+
     /* ========== Counters for Page Compression ========== */
     {"module_compress", "compression", "Page Compression Info", MONITOR_MODULE,
      MONITOR_DEFAULT_START, MONITOR_MODULE_PAGE},
@@ -1114,6 +1149,16 @@ static monitor_info_t innodb_counter_info[] = {
      "Number of Adaptive Hash Index rows updated", MONITOR_NONE,
      MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_ROW_UPDATED},
 
+    {"adaptive_hash_index_auto_disabled", "adaptive_hash_index",
+     "Number of times the Adaptive Hash Index was disabled on an index"
+     " because it did not pay off",
+     MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_AUTO_DISABLED},
+
+    {"adaptive_hash_index_auto_enabled", "adaptive_hash_index",
+     "Number of times the Adaptive Hash Index was enabled again on an index"
+     " to retry it",
+     MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_ADAPTIVE_HASH_AUTO_ENABLED},
+
     /* ========== Counters for tablespace ========== */
     {"module_file", "file_system", "Tablespace and File System Manager",
      MONITOR_MODULE, MONITOR_DEFAULT_START, MONITOR_MODULE_FIL_SYSTEM},
@@ -1314,6 +1359,36 @@ static monitor_info_t innodb_counter_info[] = {
      static_cast<monitor_type_t>(MONITOR_EXISTING), MONITOR_DEFAULT_START,
      MONITOR_SAMPLED_PAGES_SKIPPED},
 
+    {"stats_recalc_persistent", "sampling",
+     "Number of persistent statistics recalculations (ANALYZE TABLE and"
+     " background)",
+     MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_STATS_RECALC_PERSISTENT},
+
+    {"stats_recalc_persistent_usec", "sampling",
+     "Time (in microseconds) spent recalculating and saving persistent"
+     " statistics",
+     MONITOR_NONE, MONITOR_DEFAULT_START,
+     MONITOR_STATS_RECALC_PERSISTENT_MICROSECOND},
+
+    {"stats_recalc_transient", "sampling",
+     "Number of transient statistics recalculations", MONITOR_NONE,
+     MONITOR_DEFAULT_START, MONITOR_STATS_RECALC_TRANSIENT},
+
+    {"stats_recalc_transient_usec", "sampling",
+     "Time (in microseconds) spent recalculating transient statistics",
+     MONITOR_NONE, MONITOR_DEFAULT_START,
+     MONITOR_STATS_RECALC_TRANSIENT_MICROSECOND},
+
+    {"stats_recalc_background", "sampling",
+     "Number of tables whose persistent statistics the background threads"
+     " recalculated",
+     MONITOR_NONE, MONITOR_DEFAULT_START, MONITOR_STATS_RECALC_BACKGROUND},
+
+    {"stats_recalc_pool", "sampling",
+     "Number of tables waiting for background statistics recalculation",
+     MONITOR_DISPLAY_CURRENT, MONITOR_DEFAULT_START,
+     MONITOR_STATS_RECALC_POOL},
+
     /* ========== Counters for DDL operations ========== */
     {"module_ddl", "ddl", "Statistics for DDLs", MONITOR_MODULE,
      MONITOR_DEFAULT_START, MONITOR_MODULE_DDL_STATS},
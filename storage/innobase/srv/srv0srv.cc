@@ -187,10 +187,25 @@ bool srv_read_only_mode;
 dictionary tables are in the system tablespace 0 */
 bool srv_file_per_table;
 
+/** Whether DROP TABLE, TRUNCATE TABLE and the like move the file of a
+dropped tablespace into the trash directory instead of deleting it. The
+master thread then shrinks it by srv_background_drop_file_step bytes per
+second before deleting it, so that the file system does not stall while
+freeing all the extents of a huge file at once. */
+bool srv_background_drop_file = false;
+
+/** Bytes cut off a file at a time when it is removed in the background.
+Files smaller than this are deleted right away. */
+unsigned long long srv_background_drop_file_step = 1ULL << 30;
+
 /** Sort buffer size in index creation */
 ulong srv_sort_buf_size = 1048576;
 /** Maximum modification log file size for online index creation */
 unsigned long long srv_online_max_size;
+/** Threads applying a block of the modification log of an online table
+rebuild. Each one applies the operations of a partition of the rows, by
+PRIMARY KEY. */
+ulong srv_online_alter_log_apply_threads = 4;
 /** Set if InnoDB operates in read-only mode or innodb-force-recovery
 is greater than SRV_FORCE_NO_TRX_UNDO. */
 bool high_level_read_only;
@@ -198,6 +213,10 @@ bool high_level_read_only;
 /** Number of threads to use for parallel reads. */
 ulong srv_parallel_read_threads;
 
+/** Number of threads reading the leaf pages ANALYZE TABLE ... UPDATE
+HISTOGRAM samples. The rows are still handed to the server one at a time. */
+ulong srv_histogram_sampling_threads = 1;
+
 /** If this flag is true, then we will use the native aio of the
 OS (provided we compiled Innobase with it in), otherwise we will
 use simulated aio we build below with threads. */
@@ -435,6 +454,9 @@ bool srv_random_read_ahead = FALSE;
 in the buffer cache and accessed sequentially for InnoDB to trigger a
 readahead request. */
 ulong srv_read_ahead_threshold = 56;
+/* Number of leaf pages that a range scan reads ahead, taking their page
+numbers from the node pointers of the parent pages; 0 disables it. */
+ulong srv_logical_read_ahead = 0;
 
 /** Maximum on-disk size of change buffer in terms of percentage
 of the buffer pool. */
@@ -476,6 +498,10 @@ ulong srv_n_purge_threads = 4;
 /* the number of pages to purge in one batch */
 ulong srv_purge_batch_size = 20;
 
+/** Scale the purge threads and batch size from the growth of the history
+list and the size of the undo tablespaces (innodb_purge_adaptive) */
+bool srv_purge_adaptive = false;
+
 /* Internal setting for "innodb_stats_method". Decides how InnoDB treats
 NULL value when collecting statistics. By default, it is set to
 SRV_STATS_NULLS_EQUAL(0), ie. all NULL value are treated equal */
@@ -495,6 +521,10 @@ starting from SRV_FORCE_IGNORE_CORRUPT, so that data can be recovered
 by SELECT or mysqldump. When this is nonzero, we do not allow any user
 modifications to the data. */
 ulong srv_force_recovery;
+
+/** Threads applying a batch of redo log records during recovery. Each one
+applies the records of a partition of the pages, by read-ahead area. */
+ulong srv_recovery_apply_threads = 4;
 #ifdef UNIV_DEBUG
 /** Inject a crash at different steps of the recovery process.
 This is for testing and debugging only. */
@@ -542,6 +572,12 @@ bool srv_stats_include_delete_marked = FALSE;
 unsigned long long srv_stats_persistent_sample_pages = 20;
 bool srv_stats_auto_recalc = TRUE;
 
+/* Number of threads that recalculate persistent statistics of the tables
+in the background recalc pool, and of threads that sample the indexes of
+one table in parallel */
+ulong srv_stats_recalc_threads = 1;
+ulong srv_stats_sample_threads = 1;
+
 ulong srv_replication_delay = 0;
 
 /*-------------------------------------------*/
@@ -752,6 +788,17 @@ and/or load it during startup. */
 bool srv_buffer_pool_dump_at_shutdown = true;
 bool srv_buffer_pool_load_at_startup = true;
 
+/** Whether a clean shutdown writes the tablespace ID map that the
+tablespace discovery at the next startup reads */
+bool srv_tablespace_id_map = true;
+
+/** Threads reading the pages of a buffer pool load */
+ulong srv_buffer_pool_load_threads = 4;
+
+/** Whether a buffer pool load yields to user activity, see
+innodb_io_capacity */
+bool srv_buffer_pool_load_throttle = true;
+
 /** Slot index in the srv_sys->sys_threads array for the purge thread. */
 static const ulint SRV_PURGE_SLOT = 1;
 
@@ -2277,6 +2324,9 @@ static void srv_master_do_active_tasks(void) {
   MONITOR_INC_TIME_IN_MICRO_SECS(MONITOR_SRV_BACKGROUND_DROP_TABLE_MICROSECOND,
                                  counter_time);
 
+  srv_main_thread_op_info = "doing background file removal";
+  fil_purge_trash();
+
   ut_d(srv_master_do_disabled_loop());
 
   if (srv_shutdown_state.load() >=
@@ -2342,6 +2392,9 @@ static void srv_master_do_idle_tasks(void) {
   MONITOR_INC_TIME_IN_MICRO_SECS(MONITOR_SRV_BACKGROUND_DROP_TABLE_MICROSECOND,
                                  counter_time);
 
+  srv_main_thread_op_info = "doing background file removal";
+  fil_purge_trash();
+
   ut_d(srv_master_do_disabled_loop());
 
   if (srv_shutdown_state.load() >=
@@ -2963,6 +3016,32 @@ void srv_worker_thread() {
   destroy_thd(thd);
 }
 
+/** Largest batch of the adaptive purge, the maximum of
+innodb_purge_batch_size */
+static const ulint SRV_PURGE_ADAPTIVE_MAX_BATCH = 5000;
+
+/** Interval of the purge throughput measurement, in microseconds */
+static const ib_time_monotonic_us_t SRV_PURGE_RATE_INTERVAL = 1000000;
+
+/** Check whether an undo tablespace has grown past innodb_max_undo_log_size,
+so that it cannot be truncated before purge catches up.
+@return true if an undo tablespace is too large */
+static bool srv_purge_undo_oversized() {
+  const page_no_t max_size =
+      static_cast<page_no_t>(srv_max_undo_tablespace_size / srv_page_size);
+  bool oversized = false;
+
+  undo::spaces->s_lock();
+
+  for (ulint i = 0; i < undo::spaces->size() && !oversized; i++) {
+    oversized = fil_space_get_size(undo::spaces->at(i)->id()) > max_size;
+  }
+
+  undo::spaces->s_unlock();
+
+  return (oversized);
+}
+
 /** Do the actual purge operation.
 @param[in,out]  n_total_purged  Total pages purged in this call
 @return length of history list before the last purge batch. */
@@ -2971,7 +3050,11 @@ static ulint srv_do_purge(ulint *n_total_purged) {
 
   static ulint count = 0;
   static ulint n_use_threads = 0;
+  static ulint batch_size = 0;
   static uint64_t rseg_history_len = 0;
+  static bool undo_oversized = false;
+  static ulint rate_pages = 0;
+  static ib_time_monotonic_us_t rate_start = 0;
   ulint old_activity_count = srv_get_activity_count();
   bool need_explicit_truncate = false;
 
@@ -2990,9 +3073,46 @@ static ulint srv_do_purge(ulint *n_total_purged) {
     n_use_threads = n_threads;
   }
 
+  if (rate_start == 0) {
+    rate_start = ut_time_monotonic_us();
+  }
+
   do {
-    if (trx_sys->rseg_history_len.load() > rseg_history_len ||
-        (srv_max_purge_lag > 0 && rseg_history_len > srv_max_purge_lag)) {
+    if (srv_purge_adaptive) {
+      const uint64_t history_len = trx_sys->rseg_history_len.load();
+
+      if (batch_size < srv_purge_batch_size) {
+        batch_size = srv_purge_batch_size;
+      }
+
+      if (history_len > rseg_history_len || undo_oversized ||
+          (srv_max_purge_lag > 0 && history_len > srv_max_purge_lag)) {
+        /* The history list grew during the last batch, or it is
+        still too long: use all the threads at once, and double the
+        batch for as long as it keeps falling behind. */
+
+        n_use_threads = n_threads;
+
+        batch_size = std::min(batch_size * 2, SRV_PURGE_ADAPTIVE_MAX_BATCH);
+
+      } else if (history_len < rseg_history_len) {
+        /* Catching up. Give back the batch first, then the
+        threads while there is user activity. */
+
+        if (batch_size > srv_purge_batch_size) {
+          batch_size = std::max(batch_size / 2, srv_purge_batch_size);
+
+        } else if (srv_check_activity(old_activity_count) &&
+                   n_use_threads > 1) {
+          --n_use_threads;
+
+          old_activity_count = srv_get_activity_count();
+        }
+      }
+
+    } else if (trx_sys->rseg_history_len.load() > rseg_history_len ||
+               (srv_max_purge_lag > 0 &&
+                rseg_history_len > srv_max_purge_lag)) {
       /* History length is now longer than what it was
       when we took the last snapshot. Use more threads. */
 
@@ -3024,11 +3144,31 @@ static ulint srv_do_purge(ulint *n_total_purged) {
                        srv_shutdown_state.load() == SRV_SHUTDOWN_PURGE ||
                        (++count % srv_purge_rseg_truncate_frequency) == 0;
 
-    n_pages_purged =
-        trx_purge(n_use_threads, srv_purge_batch_size, do_truncate);
+    if (!srv_purge_adaptive) {
+      batch_size = srv_purge_batch_size;
+    }
+
+    MONITOR_SET(MONITOR_PURGE_THREADS_USED, n_use_threads);
+    MONITOR_SET(MONITOR_PURGE_BATCH_SIZE_USED, batch_size);
+
+    n_pages_purged = trx_purge(n_use_threads, batch_size, do_truncate);
 
     *n_total_purged += n_pages_purged;
 
+    rate_pages += n_pages_purged;
+
+    const auto now = ut_time_monotonic_us();
+
+    if (now - rate_start >= SRV_PURGE_RATE_INTERVAL) {
+      MONITOR_SET(MONITOR_PURGE_PAGES_PER_SEC,
+                  rate_pages * 1000000 / (now - rate_start));
+
+      rate_pages = 0;
+      rate_start = now;
+
+      undo_oversized = srv_purge_adaptive && srv_purge_undo_oversized();
+    }
+
     need_explicit_truncate = (n_pages_purged == 0);
     if (need_explicit_truncate) {
       undo::spaces->s_lock();
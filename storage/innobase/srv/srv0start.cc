@@ -183,8 +183,11 @@ mysql_pfs_key_t buf_resize_thread_key;
 mysql_pfs_key_t clone_ddl_thread_key;
 mysql_pfs_key_t clone_gtid_thread_key;
 mysql_pfs_key_t dict_stats_thread_key;
+mysql_pfs_key_t dict_stats_recalc_thread_key;
+mysql_pfs_key_t dict_stats_sample_thread_key;
 mysql_pfs_key_t fts_optimize_thread_key;
 mysql_pfs_key_t fts_parallel_merge_thread_key;
+mysql_pfs_key_t fts_parallel_optimize_thread_key;
 mysql_pfs_key_t fts_parallel_tokenization_thread_key;
 mysql_pfs_key_t io_handler_thread_key;
 mysql_pfs_key_t io_ibuf_thread_key;
@@ -3600,6 +3603,9 @@ void srv_shutdown() {
 
   /* 3. Close all opened files. */
   ibt::close_files();
+  if (srv_tablespace_id_map && srv_fast_shutdown < 2 && !srv_read_only_mode) {
+    fil_write_scan_map();
+  }
   fil_close_all_files();
   if (srv_monitor_file) {
     fclose(srv_monitor_file);
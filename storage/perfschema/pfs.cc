@@ -3545,7 +3545,7 @@ PSI_mutex_locker *pfs_start_mutex_wait_v1(PSI_mutex_locker_state *state,
     if (unlikely(pfs_thread == nullptr)) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
@@ -3652,7 +3652,7 @@ static PSI_rwlock_locker *pfs_start_rwlock_wait_v2(
     if (unlikely(pfs_thread == nullptr)) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
@@ -3781,7 +3781,7 @@ PSI_cond_locker *pfs_start_cond_wait_v1(PSI_cond_locker_state *state,
     if (unlikely(pfs_thread == nullptr)) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
@@ -3912,7 +3912,7 @@ PSI_table_locker *pfs_start_table_io_wait_v1(PSI_table_locker_state *state,
     if (pfs_thread == nullptr) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
@@ -4034,7 +4034,7 @@ PSI_table_locker *pfs_start_table_lock_wait_v1(PSI_table_locker_state *state,
     if (pfs_thread == nullptr) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
@@ -4472,7 +4472,7 @@ PSI_socket_locker *pfs_start_socket_wait_v1(PSI_socket_locker_state *state,
       return nullptr;
     }
 
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
 
@@ -5745,6 +5745,10 @@ PSI_stage_progress *pfs_start_stage_v1(PSI_stage_key key, const char *src_file,
     return nullptr;
   }
 
+  if (!pfs_thread->m_statement_sampled) {
+    return nullptr;
+  }
+
   pfs->m_class = new_klass;
   if (new_klass->m_timed) {
     /*
@@ -5884,11 +5888,25 @@ PSI_statement_locker *pfs_get_thread_statement_locker_v2(
       flags |= STATE_FLAG_TIMED;
     }
 
+    /*
+      Statements nested in a statement that was not sampled are not
+      sampled either; the outermost one restores the flag when it ends.
+    */
+    const ulong sample_rate = pfs_statement_sample_rate;
+    if (sample_rate > 1 && pfs_thread->m_statement_sampled &&
+        ++pfs_thread->m_statement_sample_count % sample_rate != 0) {
+      pfs_thread->m_statement_sampled = false;
+      flags |= STATE_FLAG_NOT_SAMPLED;
+    }
+
     if (flag_events_statements_current) {
       ulonglong event_id = pfs_thread->m_event_id++;
 
       if (pfs_thread->m_events_statements_count >= statement_stack_max) {
         nested_statement_lost++;
+        if (flags & STATE_FLAG_NOT_SAMPLED) {
+          pfs_thread->m_statement_sampled = true;
+        }
         return nullptr;
       }
 
@@ -6066,6 +6084,9 @@ PSI_statement_locker *pfs_refine_statement_v2(PSI_statement_locker *locker,
       if (pfs_thread->m_events_statements_count > 0) {
         pfs_thread->m_events_statements_count--;
       }
+      if (flags & STATE_FLAG_NOT_SAMPLED) {
+        pfs_thread->m_statement_sampled = true;
+      }
     }
 
     state->m_discarded = true;
@@ -6392,11 +6413,13 @@ void pfs_end_statement_v2(PSI_statement_locker *locker, void *stmt_da) {
       pfs_prepared_stmt =
           reinterpret_cast<PFS_prepared_stmt *>(state->m_parent_prepared_stmt);
 
-      if (thread->m_flag_events_statements_history) {
-        insert_events_statements_history(thread, pfs);
-      }
-      if (thread->m_flag_events_statements_history_long) {
-        insert_events_statements_history_long(pfs);
+      if (thread->m_statement_sampled) {
+        if (thread->m_flag_events_statements_history) {
+          insert_events_statements_history(thread, pfs);
+        }
+        if (thread->m_flag_events_statements_history_long) {
+          insert_events_statements_history_long(pfs);
+        }
       }
 
       assert(thread->m_events_statements_count > 0);
@@ -6674,6 +6697,11 @@ void pfs_end_statement_v2(PSI_statement_locker *locker, void *stmt_da) {
     case Diagnostics_area::DA_DISABLED:
       break;
   }
+
+  if (flags & STATE_FLAG_NOT_SAMPLED) {
+    PFS_thread *pfs_thread = reinterpret_cast<PFS_thread *>(state->m_thread);
+    pfs_thread->m_statement_sampled = true;
+  }
 }
 
 static inline enum_object_type sp_type_to_object_type(uint sp_type) {
@@ -7892,7 +7920,7 @@ PSI_metadata_locker *pfs_start_metadata_wait_vc(
     if (unlikely(pfs_thread == nullptr)) {
       return nullptr;
     }
-    if (!pfs_thread->m_enabled) {
+    if (!pfs_thread->m_enabled || !pfs_thread->m_statement_sampled) {
       return nullptr;
     }
     state->m_thread = reinterpret_cast<PSI_thread *>(pfs_thread);
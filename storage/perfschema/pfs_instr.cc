@@ -605,6 +605,8 @@ PFS_thread *create_thread(PFS_thread_class *klass,
     pfs->m_start_time = 0;
     pfs->m_stage = 0;
     pfs->m_stage_progress = nullptr;
+    pfs->m_statement_sampled = true;
+    pfs->m_statement_sample_count = 0;
     pfs->m_processlist_info[0] = '\0';
     pfs->m_processlist_info_length = 0;
     pfs->m_connection_type = NO_VIO_TYPE;
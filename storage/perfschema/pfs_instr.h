@@ -377,6 +377,14 @@ struct PFS_ALIGNED PFS_thread : PFS_connection_slice {
   bool m_enabled;
   /** Thread history instrumentation flag. */
   bool m_history;
+  /**
+    False while the thread executes a statement that was not sampled,
+    @sa pfs_statement_sample_rate. Stages and waits are then not
+    instrumented, and statements are not added to the history.
+  */
+  bool m_statement_sampled;
+  /** Statements started by this thread, for sampling. */
+  ulong m_statement_sample_count;
 
   /**
     Derived flag flag_events_waits_history, per thread.
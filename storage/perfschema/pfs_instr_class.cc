@@ -72,6 +72,14 @@ bool pfs_enabled = true;
 */
 bool pfs_processlist_enabled = false;
 
+/**
+  Global sampling rate of statement instrumentation: only one in so many
+  top level statements of a thread records stages, waits and history.
+  Statement and digest summaries count every statement.
+  @sa performance-schema-statement-sample-rate
+*/
+ulong pfs_statement_sample_rate = 1;
+
 /**
   Global performance schema reference count for plugin and component events.
   Incremented when a shared library is being unloaded, decremented when
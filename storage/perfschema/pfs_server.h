@@ -303,6 +303,12 @@ extern PFS_global_param pfs_param;
 */
 extern bool pfs_processlist_enabled;
 
+/**
+  Sampling rate of statement instrumentation.
+  @sa performance-schema-statement-sample-rate
+*/
+extern ulong pfs_statement_sample_rate;
+
 /**
   Null initialization.
   Disable all instrumentation, size all internal buffers to 0.
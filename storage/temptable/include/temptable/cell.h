@@ -50,7 +50,10 @@ class Cell {
       /** [in] Pointer to the user data. It is not copied inside this newly
        * created Cell object, so it must remain valid for the lifetime of this
        * object. */
-      const unsigned char *data);
+      const unsigned char *data,
+      /** [in] Designate whether `data` is compressed, see
+       * `Row::copy_to_own_memory()`. */
+      bool is_compressed = false);
 
   /** Check if this cell is NULL.
    * @return true if NULL */
@@ -64,10 +67,19 @@ class Cell {
    * @return a pointer */
   const unsigned char *data() const;
 
+  /** Check if the user data is stored compressed. Only cells of a row in
+   * its own memory can be, the data is then the original length in 4 bytes
+   * followed by the LZ4 compressed user data.
+   * @return true if compressed */
+  bool is_compressed() const;
+
  private:
   /** Designate whether the cell is NULL. */
   const bool m_is_null;
 
+  /** Designate whether `m_data` is compressed. */
+  const bool m_is_compressed;
+
   /** Length of the user data pointed by `m_data` in bytes. */
   const uint32_t m_data_length;
 
@@ -77,8 +89,12 @@ class Cell {
 
 /* Implementation of inlined methods. */
 
-inline Cell::Cell(bool is_null, uint32_t data_length, const unsigned char *data)
-    : m_is_null(is_null), m_data_length(data_length), m_data(data) {}
+inline Cell::Cell(bool is_null, uint32_t data_length, const unsigned char *data,
+                  bool is_compressed)
+    : m_is_null(is_null),
+      m_is_compressed(is_compressed),
+      m_data_length(data_length),
+      m_data(data) {}
 
 inline bool Cell::is_null() const { return m_is_null; }
 
@@ -86,6 +102,8 @@ inline uint32_t Cell::data_length() const { return m_data_length; }
 
 inline const unsigned char *Cell::data() const { return m_data; }
 
+inline bool Cell::is_compressed() const { return m_is_compressed; }
+
 } /* namespace temptable */
 
 #endif /* TEMPTABLE_CELL_H */
@@ -46,7 +46,15 @@ class Column {
       /** [in] MySQL table that contains the column. */
       const TABLE &mysql_table TEMPTABLE_UNUSED_NODBUG,
       /** [in] MySQL field (column/cell) that describes the columns. */
-      const Field &mysql_field);
+      const Field &mysql_field,
+      /** [in] True if no index of the table contains the column. */
+      bool is_unindexed);
+
+  /** Check if the cells of this column may be stored compressed: a VARCHAR
+   * column that is not part of any index, so that its cells are never
+   * compared or hashed.
+   * @return true if cells may be compressed */
+  bool is_compressible() const;
 
   /** Check if a particular cell is NULL. The cell is the intersection of this
    * column with the provided row (in MySQL write_row() format).
@@ -195,6 +203,9 @@ class Column {
   /** True if it is a blob. */
   bool m_is_blob;
 
+  /** True if cells may be stored compressed. */
+  bool m_is_compressible;
+
   /** Bitmask to extract is is-NULL bit from the is-NULL byte. */
   uint8_t m_null_bitmask;
 
@@ -231,6 +242,8 @@ inline bool Column::is_nullable() const { return m_nullable; }
 
 inline bool Column::is_blob() const { return m_is_blob; }
 
+inline bool Column::is_compressible() const { return m_is_compressible; }
+
 inline bool Column::read_is_null(const unsigned char *mysql_row) const {
   return m_nullable && (m_null_bitmask & *(mysql_row + m_null_byte_offset));
 }
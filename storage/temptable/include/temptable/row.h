@@ -427,6 +427,9 @@ class Row {
       size_t i) const;
 
   /** Copy the user data to an own buffer (convert from write_row() format).
+   * Cells of compressible columns (see `Column::is_compressible()`) holding
+   * at least temptable_compression_min_length bytes are stored LZ4
+   * compressed if that makes them smaller.
    * @return Result:OK or other Result::* error code */
   Result copy_to_own_memory(
       /** [in] Metadata for the columns that constitute this row. */
@@ -37,7 +37,7 @@ namespace temptable {
 
 Column::Column(const unsigned char *mysql_row,
                const TABLE &mysql_table TEMPTABLE_UNUSED_NODBUG,
-               const Field &mysql_field) {
+               const Field &mysql_field, bool is_unindexed) {
   /* NOTE: The contents of mysql_row could be bogus at this time,
    * we don't look at the data, we just use it to calculate offsets
    * later used to get the user data inside our own copy of a row in
@@ -87,6 +87,8 @@ Column::Column(const unsigned char *mysql_row,
          std::numeric_limits<decltype(m_user_data_offset)>::max());
   m_user_data_offset = static_cast<decltype(m_user_data_offset)>(data_offset);
 
+  m_is_compressible = is_unindexed && !m_is_blob && m_length_bytes_size > 0;
+
   m_nullable = mysql_field.is_nullable();
   m_null_bitmask = mysql_field.null_bit;
 
@@ -24,10 +24,13 @@ this program; if not, write to the Free Software Foundation, Inc.,
 TempTable Row implementation. */
 
 #include <assert.h>
+#include <lz4.h>
 #include <cstring>
 #include <utility>
+#include <vector>
 
 #include "sql/field.h"
+#include "sql/mysqld.h"  // temptable_compression_min_length
 #include "sql/table.h"
 #include "storage/temptable/include/temptable/allocator.h"
 #include "storage/temptable/include/temptable/cell.h"
@@ -39,13 +42,68 @@ TempTable Row implementation. */
 
 namespace temptable {
 
+/** Bytes in front of the LZ4 data of a compressed cell, holding the length
+ * of the user data. */
+static constexpr size_t COMPRESSED_HEADER_SIZE = sizeof(uint32_t);
+
+/** Get the length of the user data of a compressed cell.
+ * @return length in bytes */
+static uint32_t uncompressed_length(const Cell &cell) {
+  assert(cell.is_compressed());
+
+  uint32_t data_length;
+  memcpy(&data_length, cell.data(), COMPRESSED_HEADER_SIZE);
+  return data_length;
+}
+
+/** Decompress the user data of a compressed cell.
+ * @return true if the data was not what `copy_to_own_memory()` stored */
+static bool decompress_cell(
+    /** [in] Compressed cell. */
+    const Cell &cell,
+    /** [out] User data of the cell, `uncompressed_length()` bytes. */
+    unsigned char *data,
+    /** [in] Size of `data` in bytes. */
+    uint32_t data_capacity) {
+  const int length = LZ4_decompress_safe(
+      reinterpret_cast<const char *>(cell.data() + COMPRESSED_HEADER_SIZE),
+      reinterpret_cast<char *>(data),
+      static_cast<int>(cell.data_length() - COMPRESSED_HEADER_SIZE),
+      static_cast<int>(data_capacity));
+
+  return length < 0 ||
+         static_cast<uint32_t>(length) != uncompressed_length(cell);
+}
+
 #ifndef NDEBUG
+/** The cell a compressed cell was created from, its user data decompressed
+ * in `buf`. Other cells are returned as they are.
+ * @return cell with uncompressed user data */
+static Cell uncompressed_cell(const Cell &cell,
+                              std::vector<unsigned char> *buf) {
+  if (!cell.is_compressed()) {
+    return cell;
+  }
+
+  buf->resize(uncompressed_length(cell));
+
+  const bool corrupted =
+      decompress_cell(cell, buf->data(), static_cast<uint32_t>(buf->size()));
+  assert(!corrupted);
+  (void)corrupted;
+
+  return Cell{false, static_cast<uint32_t>(buf->size()), buf->data()};
+}
+
 int Row::compare(const Row &lhs, const Row &rhs, const Columns &columns,
                  Field **mysql_fields) {
+  std::vector<unsigned char> lhs_buf;
+  std::vector<unsigned char> rhs_buf;
+
   for (size_t i = 0; i < columns.size(); ++i) {
     const Field *mysql_field = mysql_fields[i];
-    const Cell &lhs_cell = lhs.cell(columns[i], i);
-    const Cell &rhs_cell = rhs.cell(columns[i], i);
+    const Cell &lhs_cell = uncompressed_cell(lhs.cell(columns[i], i), &lhs_buf);
+    const Cell &rhs_cell = uncompressed_cell(rhs.cell(columns[i], i), &rhs_buf);
     Cell_calculator calculator(mysql_field);
 
     const int cmp_result = calculator.compare(lhs_cell, rhs_cell);
@@ -64,10 +122,56 @@ Result Row::copy_to_own_memory(const Columns &columns,
 
   const unsigned char *mysql_row = m_ptr;
 
+  /* Cells of at least temptable_compression_min_length bytes of
+   * compressible columns are compressed into `compressed` first, so that
+   * the row buffer can be allocated at its final size. The lengths of the
+   * compressed cells are in `compressed_lengths`, 0 for the others, which
+   * are stored as they are. */
+  static thread_local std::vector<unsigned char> compressed;
+  static thread_local std::vector<uint32_t> compressed_lengths;
+
+  const size_t min_length = temptable_compression_min_length;
+  bool any_compressed = false;
+
   size_t buf_len = sizeof(size_t);
 
-  for (const auto &column : columns) {
-    buf_len += sizeof(Cell) + column.read_user_data_length(mysql_row);
+  if (min_length > 0) {
+    compressed.clear();
+    compressed_lengths.assign(columns.size(), 0);
+  }
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const Column &column = columns[i];
+    const uint32_t data_length = column.read_user_data_length(mysql_row);
+
+    if (min_length > 0 && column.is_compressible() &&
+        data_length >= min_length && !column.read_is_null(mysql_row)) {
+      const size_t offset = compressed.size();
+      const int bound = LZ4_compressBound(static_cast<int>(data_length));
+      compressed.resize(offset + COMPRESSED_HEADER_SIZE + bound);
+
+      unsigned char *dst = compressed.data() + offset;
+      memcpy(dst, &data_length, COMPRESSED_HEADER_SIZE);
+
+      const int length = LZ4_compress_default(
+          reinterpret_cast<const char *>(column.get_user_data_ptr(mysql_row)),
+          reinterpret_cast<char *>(dst + COMPRESSED_HEADER_SIZE),
+          static_cast<int>(data_length), bound);
+
+      if (length > 0 && COMPRESSED_HEADER_SIZE + length < data_length) {
+        compressed_lengths[i] =
+            static_cast<uint32_t>(COMPRESSED_HEADER_SIZE + length);
+        compressed.resize(offset + compressed_lengths[i]);
+        buf_len += sizeof(Cell) + compressed_lengths[i];
+        any_compressed = true;
+        continue;
+      }
+
+      /* Incompressible, store it as it is. */
+      compressed.resize(offset);
+    }
+
+    buf_len += sizeof(Cell) + data_length;
   }
 
   try {
@@ -87,7 +191,25 @@ Result Row::copy_to_own_memory(const Columns &columns,
   unsigned char *data_ptr =
       reinterpret_cast<unsigned char *>(cell + columns.size());
 
-  for (const auto &column : columns) {
+  const unsigned char *compressed_ptr = compressed.data();
+
+  for (size_t i = 0; i < columns.size(); ++i) {
+    const Column &column = columns[i];
+
+    if (any_compressed && compressed_lengths[i] > 0) {
+      const uint32_t data_length = compressed_lengths[i];
+
+      assert(buf_is_inside_another(data_ptr, data_length, m_ptr, buf_len));
+
+      memcpy(data_ptr, compressed_ptr, data_length);
+      new (cell) Cell{false, data_length, data_ptr, true};
+
+      ++cell;
+      data_ptr += data_length;
+      compressed_ptr += data_length;
+      continue;
+    }
+
     const bool is_null = column.read_is_null(mysql_row);
 
     const uint32_t data_length = column.read_user_data_length(mysql_row);
@@ -116,6 +238,25 @@ void Row::copy_to_mysql_row(const Columns &columns, unsigned char *mysql_row,
     const Column &column = columns[i];
     const Cell &cell = cells()[i];
 
+    if (cell.is_compressed()) {
+      /* Only VARCHAR cells are compressed: decompress right into the
+       * user data of the MySQL row. */
+      const uint32_t data_length = uncompressed_length(cell);
+      unsigned char *data =
+          const_cast<unsigned char *>(column.get_user_data_ptr(mysql_row));
+
+      assert(buf_is_inside_another(data, data_length, mysql_row,
+                                   mysql_row_length));
+
+      column.write_is_null(false, mysql_row, mysql_row_length);
+      column.write_user_data_length(data_length, mysql_row, mysql_row_length);
+
+      const bool corrupted = decompress_cell(cell, data, data_length);
+      assert(!corrupted);
+      (void)corrupted;
+      continue;
+    }
+
     /* No need to copy the BLOB memory as the row will remain valid
      * till next operation. */
 
@@ -81,9 +81,18 @@ Table::Table(TABLE *mysql_table, Block *shared_block,
     }
   }
 
+  std::vector<bool> is_indexed(number_of_columns, false);
+  for (size_t i = 0; i < number_of_indexes; ++i) {
+    const KEY &mysql_index = mysql_table->key_info[i];
+    for (size_t j = 0; j < mysql_index.user_defined_key_parts; ++j) {
+      is_indexed[mysql_index.key_part[j].field->field_index()] = true;
+    }
+  }
+
   m_columns.reserve(number_of_columns);
   for (size_t i = 0; i < number_of_columns; ++i) {
-    m_columns.emplace_back(mysql_row, *mysql_table, *mysql_table->field[i]);
+    m_columns.emplace_back(mysql_row, *mysql_table, *mysql_table->field[i],
+                           !is_indexed[i]);
   }
 
   if (m_all_columns_are_fixed_size) {
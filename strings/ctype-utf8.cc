@@ -7679,6 +7679,17 @@ static size_t my_well_formed_len_utf8mb4(const CHARSET_INFO *cs, const char *b,
   while (pos) {
     int mb_len;
 
+    // Fast path for runs of ASCII characters, eight at a time.
+    if (pos >= 8 && e - b >= 8) {
+      uint64_t data;
+      memcpy(&data, b, sizeof(data));
+      if (!(data & 0x8080808080808080ULL)) {
+        b += sizeof(data);
+        pos -= sizeof(data);
+        continue;
+      }
+    }
+
     if ((mb_len = my_valid_mbcharlen_utf8mb4(cs, pointer_cast<const uchar *>(b),
                                              pointer_cast<const uchar *>(e))) <=
         0) {
@@ -7726,6 +7737,27 @@ size_t my_charpos_mb4(const CHARSET_INFO *cs, const char *pos, const char *end,
   return (size_t)(length ? end + 2 - start : pos - start);
 }
 
+static size_t my_numchars_utf8mb4(const CHARSET_INFO *cs, const char *pos,
+                                  const char *end) {
+  size_t count = 0;
+  while (pos < end) {
+    // Fast path for runs of ASCII characters, eight at a time.
+    if (end - pos >= 8) {
+      uint64_t data;
+      memcpy(&data, pos, sizeof(data));
+      if (!(data & 0x8080808080808080ULL)) {
+        pos += sizeof(data);
+        count += sizeof(data);
+        continue;
+      }
+    }
+    uint mb_len;
+    pos += (mb_len = my_ismbchar_utf8mb4_inl(cs, pos, end)) ? mb_len : 1;
+    count++;
+  }
+  return count;
+}
+
 static uint my_mbcharlen_utf8mb4(const CHARSET_INFO *cs MY_ATTRIBUTE((unused)),
                                  uint c) {
   if (c < 0x80) return 1;
@@ -7769,7 +7801,7 @@ static MY_COLLATION_HANDLER my_collation_utf8mb4_bin_handler = {
 MY_CHARSET_HANDLER my_charset_utf8mb4_handler = {nullptr, /* init */
                                                  my_ismbchar_utf8mb4,
                                                  my_mbcharlen_utf8mb4,
-                                                 my_numchars_mb,
+                                                 my_numchars_utf8mb4,
                                                  my_charpos_mb4,
                                                  my_well_formed_len_utf8mb4,
                                                  my_lengthsp_8bit,
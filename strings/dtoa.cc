@@ -1878,6 +1878,278 @@ static int quorem(Bigint *b, Bigint *S) {
   return q;
 }
 
+/*
+  Grisu3, from "Printing Floating-Point Numbers Quickly and Accurately with
+  Integers" by Florian Loitsch [Proc. ACM SIGPLAN '10, pp. 233-243].
+
+  It finds the shortest digits of a double with 64-bit integer arithmetic,
+  and fails for the ~0.5% of the inputs where it cannot prove them to be
+  the shortest and the nearest ones. dtoa() tries it first in the modes
+  that want the shortest digits, and uses the Bigint algorithm below only
+  when it fails or its digits are longer than wanted, so the result is
+  always the same.
+*/
+
+/* The number f * 2^e */
+typedef struct Diy_fp {
+  ULLong f;
+  int e;
+} Diy_fp;
+
+/*
+  10^k for k = -348, -340, ..., 340, as a 64-bit significand with its top
+  bit set (rounded to nearest) and a binary exponent.
+*/
+static const struct {
+  ULLong f;
+  short e;
+  short k;
+} grisu_powers[] = {
+    {0xfa8fd5a0081c0288ULL, -1220, -348},
+    {0xbaaee17fa23ebf76ULL, -1193, -340},
+    {0x8b16fb203055ac76ULL, -1166, -332},
+    {0xcf42894a5dce35eaULL, -1140, -324},
+    {0x9a6bb0aa55653b2dULL, -1113, -316},
+    {0xe61acf033d1a45dfULL, -1087, -308},
+    {0xab70fe17c79ac6caULL, -1060, -300},
+    {0xff77b1fcbebcdc4fULL, -1034, -292},
+    {0xbe5691ef416bd60cULL, -1007, -284},
+    {0x8dd01fad907ffc3cULL, -980, -276},
+    {0xd3515c2831559a83ULL, -954, -268},
+    {0x9d71ac8fada6c9b5ULL, -927, -260},
+    {0xea9c227723ee8bcbULL, -901, -252},
+    {0xaecc49914078536dULL, -874, -244},
+    {0x823c12795db6ce57ULL, -847, -236},
+    {0xc21094364dfb5637ULL, -821, -228},
+    {0x9096ea6f3848984fULL, -794, -220},
+    {0xd77485cb25823ac7ULL, -768, -212},
+    {0xa086cfcd97bf97f4ULL, -741, -204},
+    {0xef340a98172aace5ULL, -715, -196},
+    {0xb23867fb2a35b28eULL, -688, -188},
+    {0x84c8d4dfd2c63f3bULL, -661, -180},
+    {0xc5dd44271ad3cdbaULL, -635, -172},
+    {0x936b9fcebb25c996ULL, -608, -164},
+    {0xdbac6c247d62a584ULL, -582, -156},
+    {0xa3ab66580d5fdaf6ULL, -555, -148},
+    {0xf3e2f893dec3f126ULL, -529, -140},
+    {0xb5b5ada8aaff80b8ULL, -502, -132},
+    {0x87625f056c7c4a8bULL, -475, -124},
+    {0xc9bcff6034c13053ULL, -449, -116},
+    {0x964e858c91ba2655ULL, -422, -108},
+    {0xdff9772470297ebdULL, -396, -100},
+    {0xa6dfbd9fb8e5b88fULL, -369, -92},
+    {0xf8a95fcf88747d94ULL, -343, -84},
+    {0xb94470938fa89bcfULL, -316, -76},
+    {0x8a08f0f8bf0f156bULL, -289, -68},
+    {0xcdb02555653131b6ULL, -263, -60},
+    {0x993fe2c6d07b7facULL, -236, -52},
+    {0xe45c10c42a2b3b06ULL, -210, -44},
+    {0xaa242499697392d3ULL, -183, -36},
+    {0xfd87b5f28300ca0eULL, -157, -28},
+    {0xbce5086492111aebULL, -130, -20},
+    {0x8cbccc096f5088ccULL, -103, -12},
+    {0xd1b71758e219652cULL, -77, -4},
+    {0x9c40000000000000ULL, -50, 4},
+    {0xe8d4a51000000000ULL, -24, 12},
+    {0xad78ebc5ac620000ULL, 3, 20},
+    {0x813f3978f8940984ULL, 30, 28},
+    {0xc097ce7bc90715b3ULL, 56, 36},
+    {0x8f7e32ce7bea5c70ULL, 83, 44},
+    {0xd5d238a4abe98068ULL, 109, 52},
+    {0x9f4f2726179a2245ULL, 136, 60},
+    {0xed63a231d4c4fb27ULL, 162, 68},
+    {0xb0de65388cc8ada8ULL, 189, 76},
+    {0x83c7088e1aab65dbULL, 216, 84},
+    {0xc45d1df942711d9aULL, 242, 92},
+    {0x924d692ca61be758ULL, 269, 100},
+    {0xda01ee641a708deaULL, 295, 108},
+    {0xa26da3999aef774aULL, 322, 116},
+    {0xf209787bb47d6b85ULL, 348, 124},
+    {0xb454e4a179dd1877ULL, 375, 132},
+    {0x865b86925b9bc5c2ULL, 402, 140},
+    {0xc83553c5c8965d3dULL, 428, 148},
+    {0x952ab45cfa97a0b3ULL, 455, 156},
+    {0xde469fbd99a05fe3ULL, 481, 164},
+    {0xa59bc234db398c25ULL, 508, 172},
+    {0xf6c69a72a3989f5cULL, 534, 180},
+    {0xb7dcbf5354e9beceULL, 561, 188},
+    {0x88fcf317f22241e2ULL, 588, 196},
+    {0xcc20ce9bd35c78a5ULL, 614, 204},
+    {0x98165af37b2153dfULL, 641, 212},
+    {0xe2a0b5dc971f303aULL, 667, 220},
+    {0xa8d9d1535ce3b396ULL, 694, 228},
+    {0xfb9b7cd9a4a7443cULL, 720, 236},
+    {0xbb764c4ca7a44410ULL, 747, 244},
+    {0x8bab8eefb6409c1aULL, 774, 252},
+    {0xd01fef10a657842cULL, 800, 260},
+    {0x9b10a4e5e9913129ULL, 827, 268},
+    {0xe7109bfba19c0c9dULL, 853, 276},
+    {0xac2820d9623bf429ULL, 880, 284},
+    {0x80444b5e7aa7cf85ULL, 907, 292},
+    {0xbf21e44003acdd2dULL, 933, 300},
+    {0x8e679c2f5e44ff8fULL, 960, 308},
+    {0xd433179d9c8cb841ULL, 986, 316},
+    {0x9e19db92b4e31ba9ULL, 1013, 324},
+    {0xeb96bf6ebadf77d9ULL, 1039, 332},
+    {0xaf87023b9bf0ee6bULL, 1066, 340},
+};
+
+#define Grisu_powers_first_k (-348)
+#define Grisu_powers_step 8
+
+/* The scaled number has its binary point in this range of exponents */
+#define Grisu_alpha (-60)
+#define Grisu_gamma (-32)
+
+/* x * y rounded to the upper 64 bits */
+static Diy_fp diy_fp_mult(Diy_fp x, Diy_fp y) {
+  const ULLong m32 = 0xffffffffULL;
+  ULLong a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+  ULLong ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  ULLong tmp = (bd >> 32) + (ad & m32) + (bc & m32) + (1ULL << 31);
+  Diy_fp r;
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+static Diy_fp diy_fp_normalize(Diy_fp x) {
+  while (!(x.f & (1ULL << 63))) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+/*
+  Move the last digit of buf towards w, which is distance_high below
+  too_high, while it stays in the unsafe interval, and check that the
+  result is nearer to w than any other and inside the safe interval.
+  All quantities but ten_kappa are off by up to unit.
+*/
+static bool grisu_round_weed(char *buf, int len, ULLong distance_high,
+                             ULLong unsafe_interval, ULLong rest,
+                             ULLong ten_kappa, ULLong unit) {
+  ULLong small_distance = distance_high - unit;
+  ULLong big_distance = distance_high + unit;
+
+  while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+         (rest + ten_kappa < small_distance ||
+          small_distance - rest >= rest + ten_kappa - small_distance)) {
+    buf[len - 1]--;
+    rest += ten_kappa;
+  }
+  /* Could the digit below be the nearer one? */
+  if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+      (rest + ten_kappa < big_distance ||
+       big_distance - rest > rest + ten_kappa - big_distance))
+    return false;
+  return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+/*
+  Generate the digits of the scaled w, and of the boundaries low and high
+  halfway to its neighbours, all with the same exponent in
+  [Grisu_alpha, Grisu_gamma]. The digits, read as an integer, times
+  10^*kappa are the result.
+*/
+static bool grisu_digit_gen(Diy_fp low, Diy_fp w, Diy_fp high, char *buf,
+                            int *len, int *kappa) {
+  ULLong unit = 1;
+  ULLong too_low = low.f - unit;
+  ULLong too_high = high.f + unit;
+  ULLong unsafe_interval = too_high - too_low;
+  int shift = -w.e;
+  ULLong one = 1ULL << shift;
+  ULong integrals = (ULong)(too_high >> shift);
+  ULLong fractionals = too_high & (one - 1);
+  ULong divisor = 1;
+
+  *kappa = 0;
+  while (*kappa < 10 && divisor <= integrals / 10) {
+    divisor *= 10;
+    (*kappa)++;
+  }
+  if (integrals) (*kappa)++;
+  *len = 0;
+  while (*kappa > 0) {
+    buf[(*len)++] = (char)('0' + integrals / divisor);
+    integrals %= divisor;
+    (*kappa)--;
+    ULLong rest = ((ULLong)integrals << shift) + fractionals;
+    if (rest < unsafe_interval)
+      return grisu_round_weed(buf, *len, too_high - w.f, unsafe_interval,
+                              rest, (ULLong)divisor << shift, unit);
+    divisor /= 10;
+  }
+  for (;;) {
+    fractionals *= 10;
+    unit *= 10;
+    unsafe_interval *= 10;
+    buf[(*len)++] = (char)('0' + (fractionals >> shift));
+    fractionals &= one - 1;
+    (*kappa)--;
+    if (fractionals < unsafe_interval)
+      return grisu_round_weed(buf, *len, (too_high - w.f) * unit,
+                              unsafe_interval, fractionals, one, unit);
+  }
+}
+
+/*
+  The shortest digits of the positive finite number d that read back as d,
+  nearest to it, in buf (at least 18 bytes, not terminated), their number
+  in *len, and *decpt as for dtoa().
+  Returns false if Grisu3 cannot prove its digits to be those.
+*/
+static bool grisu_shortest(double d, char *buf, int *len, int *decpt) {
+  ULLong bits;
+  memcpy(&bits, &d, sizeof(bits));
+  ULLong frac = bits & ((1ULL << (P - 1)) - 1);
+  int biased_e = (int)(bits >> (P - 1));
+  Diy_fp w, low, high, ten_mk;
+  int kappa;
+
+  if (biased_e) {
+    w.f = frac | (1ULL << (P - 1));
+    w.e = biased_e - Bias - (P - 1);
+  } else {
+    w.f = frac;
+    w.e = 1 - Bias - (P - 1);
+  }
+
+  /* The boundaries; the lower one is closer above a power of two */
+  high.f = (w.f << 1) + 1;
+  high.e = w.e - 1;
+  high = diy_fp_normalize(high);
+  if (!frac && biased_e > 1) {
+    low.f = (w.f << 2) - 1;
+    low.e = w.e - 2;
+  } else {
+    low.f = (w.f << 1) - 1;
+    low.e = w.e - 1;
+  }
+  low.f <<= low.e - high.e;
+  low.e = high.e;
+  w = diy_fp_normalize(w);
+
+  /* A cached 10^-k that brings the exponent of w into range */
+  int min_e = Grisu_alpha - (w.e + 64);
+  double dk = (min_e + 63) * 0.30102999566398114;
+  int k = (int)dk;
+  if (k < dk) k++;
+  int i = (k - Grisu_powers_first_k - 1) / Grisu_powers_step + 1;
+  assert(grisu_powers[i].e >= min_e &&
+         grisu_powers[i].e <= Grisu_gamma - (w.e + 64));
+  ten_mk.f = grisu_powers[i].f;
+  ten_mk.e = grisu_powers[i].e;
+
+  if (!grisu_digit_gen(diy_fp_mult(low, ten_mk), diy_fp_mult(w, ten_mk),
+                       diy_fp_mult(high, ten_mk), buf, len, &kappa))
+    return false;
+  *decpt = *len + kappa - grisu_powers[i].k;
+  return true;
+}
+
 /*
    dtoa for IEEE arithmetic (dmg): convert double to ASCII string.
 
@@ -1988,6 +2260,28 @@ static char *dtoa(double dd, int mode, int ndigits, int *decpt, int *sign,
     return res;
   }
 
+#ifndef Honor_FLT_ROUNDS
+  if (mode == 0 || mode == 4 || mode == 5) {
+    /*
+      Modes 4 and 5 return the shortest digits when they are not too many,
+      except for denormals, where they return more digits
+    */
+    char digits[18];
+    int len, point;
+    if (grisu_shortest(dval(&u), digits, &len, &point) &&
+        (mode == 0 || ((word0(&u) & Exp_mask) &&
+                       (mode == 4 ? len <= std::max(ndigits, 1)
+                                  : len - point <= ndigits)))) {
+      char *res = (char *)dtoa_alloc(len + 1, &alloc);
+      memcpy(res, digits, len);
+      res[len] = '\0';
+      *decpt = point;
+      if (rve) *rve = res + len;
+      return res;
+    }
+  }
+#endif
+
 #ifdef Honor_FLT_ROUNDS
   if ((rounding = Flt_Rounds) >= 2) {
     if (*sign)
@@ -22035,6 +22035,59 @@ static void test_bug31691060_2() {
   rc = mysql_stmt_close(stmt);
 }
 
+static void test_pipeline() {
+  myheader("test_pipeline");
+
+  int rc;
+  MYSQL_RES *result;
+  const char *insert = "INSERT INTO t_pipeline VALUES (1)";
+  const char *bad = "SELECT * FROM t_pipeline_missing";
+  const char *select = "SELECT COUNT(*) FROM t_pipeline";
+
+  rc = mysql_query(mysql, "DROP TABLE IF EXISTS t_pipeline");
+  myquery(rc);
+  rc = mysql_query(mysql, "CREATE TABLE t_pipeline (a INT)");
+  myquery(rc);
+
+  rc = mysql_pipeline_send_query(mysql, insert, (ulong)strlen(insert));
+  myquery(rc);
+  rc = mysql_pipeline_send_query(mysql, bad, (ulong)strlen(bad));
+  myquery(rc);
+  rc = mysql_pipeline_send_query(mysql, select, (ulong)strlen(select));
+  myquery(rc);
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == 3);
+
+  /* Other commands must wait for the pending results */
+  rc = mysql_query(mysql, "SELECT 1");
+  DIE_UNLESS(rc != 0);
+  DIE_UNLESS(mysql_errno(mysql) == CR_COMMANDS_OUT_OF_SYNC);
+
+  rc = mysql_pipeline_read_result(mysql);
+  myquery(rc);
+  DIE_UNLESS(mysql_affected_rows(mysql) == 1);
+
+  /* The failed query does not affect the one queued after it */
+  rc = mysql_pipeline_read_result(mysql);
+  DIE_UNLESS(rc != 0);
+  DIE_UNLESS(mysql_errno(mysql) == ER_NO_SUCH_TABLE);
+
+  rc = mysql_pipeline_read_result(mysql);
+  myquery(rc);
+  result = mysql_store_result(mysql);
+  mytest(result);
+  rc = my_process_result_set(result);
+  DIE_UNLESS(rc == 1);
+  mysql_free_result(result);
+  DIE_UNLESS(mysql_pipeline_pending(mysql) == 0);
+
+  rc = mysql_pipeline_read_result(mysql);
+  DIE_UNLESS(rc != 0);
+  DIE_UNLESS(mysql_errno(mysql) == CR_COMMANDS_OUT_OF_SYNC);
+
+  rc = mysql_query(mysql, "DROP TABLE t_pipeline");
+  myquery(rc);
+}
+
 static struct my_tests_st my_tests[] = {
     {"test_bug5194", test_bug5194},
     {"disable_query_logs", disable_query_logs},
@@ -22335,6 +22388,7 @@ static struct my_tests_st my_tests[] = {
     {"test_wl12542", test_wl12542},
     {"test_bug31691060_1", test_bug31691060_1},
     {"test_bug31691060_2", test_bug31691060_2},
+    {"test_pipeline", test_pipeline},
     {nullptr, nullptr}};
 
 static struct my_tests_st *get_my_tests() { return my_tests; }
@@ -0,0 +1,175 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <vector>
+
+#include "my_sys.h"
+#include "sql/basic_istream.h"
+
+namespace basic_istream_unittest {
+
+static const char *FILE_NAME = "./basic_istream-t.data";
+
+class MmapIstreamTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove(FILE_NAME);
+    FILE *file = fopen(FILE_NAME, "wb");
+    ASSERT_NE(nullptr, file);
+    fclose(file);
+  }
+  void TearDown() override { remove(FILE_NAME); }
+
+  /* Appends n bytes to the file and to m_data */
+  void append(size_t n) {
+    FILE *file = fopen(FILE_NAME, "ab");
+    ASSERT_NE(nullptr, file);
+    std::vector<unsigned char> bytes;
+    for (size_t i = 0; i < n; i++) {
+      bytes.push_back(static_cast<unsigned char>(m_data.size() * 31 + 7));
+      m_data.push_back(bytes.back());
+    }
+    ASSERT_EQ(n, fwrite(bytes.data(), 1, n, file));
+    fclose(file);
+  }
+
+  static bool open(Mmap_istream *stream) {
+    return stream->open(
+#ifdef HAVE_PSI_INTERFACE
+        PSI_NOT_INSTRUMENTED,
+#endif
+        FILE_NAME);
+  }
+
+  static bool open(IO_CACHE_istream *stream) {
+    return stream->open(
+#ifdef HAVE_PSI_INTERFACE
+        PSI_NOT_INSTRUMENTED, PSI_NOT_INSTRUMENTED,
+#endif
+        FILE_NAME, MYF(MY_WME | MY_DONT_CHECK_FILESIZE));
+  }
+
+  /*
+    Reads the rest of both streams in chunks of chunk bytes and checks that
+    they return the same bytes, which are m_data from offset on.
+  */
+  void expect_same(Mmap_istream *mmap, my_off_t offset, size_t chunk) {
+    IO_CACHE_istream io_cache;
+    ASSERT_FALSE(open(&io_cache));
+    ASSERT_FALSE(io_cache.seek(offset));
+    std::vector<unsigned char> buf1(chunk), buf2(chunk);
+    for (;;) {
+      ssize_t n1 = mmap->read(buf1.data(), chunk);
+      ssize_t n2 = io_cache.read(buf2.data(), chunk);
+      ASSERT_EQ(n2, n1) << "offset " << offset;
+      ASSERT_LE(0, n1);
+      for (ssize_t i = 0; i < n1; i++, offset++) {
+        ASSERT_EQ(m_data[offset], buf1[i]) << "offset " << offset;
+        ASSERT_EQ(buf2[i], buf1[i]) << "offset " << offset;
+      }
+      if (static_cast<size_t>(n1) < chunk) break;
+    }
+    EXPECT_EQ(m_data.size(), offset);
+  }
+
+  std::vector<unsigned char> m_data;
+};
+
+TEST_F(MmapIstreamTest, EmptyFile) {
+  Mmap_istream stream;
+  ASSERT_FALSE(open(&stream));
+  EXPECT_EQ(0U, stream.length());
+  unsigned char buf[16];
+  EXPECT_EQ(0, stream.read(buf, sizeof(buf)));
+  expect_same(&stream, 0, 16);
+
+  /* What is written later is mapped by the next read */
+  append(100);
+  expect_same(&stream, 0, 16);
+}
+
+TEST_F(MmapIstreamTest, SameAsIoCache) {
+  append(100000);
+  for (size_t chunk : {1, 19, 4096, 8192, 100000, 200000}) {
+    SCOPED_TRACE(chunk);
+    Mmap_istream stream;
+    ASSERT_FALSE(open(&stream));
+    expect_same(&stream, 0, chunk);
+    ASSERT_FALSE(stream.seek(12345));
+    expect_same(&stream, 12345, chunk);
+  }
+}
+
+TEST_F(MmapIstreamTest, FileGrows) {
+  append(1000);
+  Mmap_istream stream;
+  ASSERT_FALSE(open(&stream));
+  EXPECT_EQ(1000U, stream.length());
+
+  /* A read at the end of the mapping returns EOF until the file grows */
+  std::vector<unsigned char> buf(1000);
+  EXPECT_EQ(1000, stream.read(buf.data(), 1000));
+  EXPECT_EQ(0, stream.read(buf.data(), 10));
+
+  append(5000);
+  EXPECT_EQ(6000U, stream.length());
+  expect_same(&stream, 1000, 1000);
+}
+
+TEST_F(MmapIstreamTest, ReadSpansMappingEnd) {
+  append(1000);
+  Mmap_istream stream;
+  ASSERT_FALSE(open(&stream));
+  std::vector<unsigned char> buf(1000);
+  ASSERT_EQ(900, stream.read(buf.data(), 900));
+
+  /* Starts in the old mapping and ends in what was appended */
+  append(1000);
+  ASSERT_EQ(200, stream.read(buf.data(), 200));
+  for (size_t i = 0; i < 200; i++) ASSERT_EQ(m_data[900 + i], buf[i]);
+  expect_same(&stream, 1100, 64);
+}
+
+TEST_F(MmapIstreamTest, SeekPastEnd) {
+  append(1000);
+  Mmap_istream stream;
+  ASSERT_FALSE(open(&stream));
+  unsigned char buf[16];
+
+  ASSERT_FALSE(stream.seek(1000));
+  EXPECT_EQ(0, stream.read(buf, sizeof(buf)));
+  ASSERT_FALSE(stream.seek(5000));
+  EXPECT_EQ(0, stream.read(buf, sizeof(buf)));
+  IO_CACHE_istream io_cache;
+  ASSERT_FALSE(open(&io_cache));
+  ASSERT_FALSE(io_cache.seek(5000));
+  EXPECT_EQ(0, io_cache.read(buf, sizeof(buf)));
+
+  /* Seeking back into the mapping reads again */
+  ASSERT_FALSE(stream.seek(990));
+  EXPECT_EQ(10, stream.read(buf, sizeof(buf)));
+  for (size_t i = 0; i < 10; i++) EXPECT_EQ(m_data[990 + i], buf[i]);
+}
+
+}  // namespace basic_istream_unittest
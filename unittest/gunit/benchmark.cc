@@ -24,9 +24,12 @@
 #include <math.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <algorithm>
 #include <chrono>
+#include <string>
+#include <vector>
 
 using std::chrono::duration;
 using std::chrono::duration_cast;
@@ -54,6 +57,63 @@ void StopBenchmarkTiming() {
 
 void SetBytesProcessed(size_t bytes) { bytes_processed = bytes; }
 
+namespace {
+
+struct Benchmark_result {
+  std::string name;
+  size_t iterations;
+  double ns_per_iteration;
+  double bytes_per_second;  // 0 if not set
+};
+
+std::vector<Benchmark_result> results;
+
+}  // namespace
+
+// If MYSQL_BENCHMARK_JSON names a file, (re)write it with the results of
+// all the benchmarks run so far, in the layout of Google Benchmark's
+// --benchmark_format=json, so that runs can be compared by tools made for
+// that. The file is rewritten after every benchmark, so that it is complete
+// even if a later benchmark crashes. Only wall time is measured; it is
+// reported as both real_time and cpu_time.
+static void write_json_report() {
+  const char *path = getenv("MYSQL_BENCHMARK_JSON");
+  if (path == nullptr || *path == '\0') return;
+
+  FILE *file = fopen(path, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "WARNING: Cannot write benchmark results to %s\n", path);
+    return;
+  }
+
+#if !defined(NDEBUG)
+  const char *build_type = "debug";
+#else
+  const char *build_type = "release";
+#endif
+  fprintf(file, "{\n  \"context\": {\n    \"library_build_type\": \"%s\"\n"
+          "  },\n  \"benchmarks\": [", build_type);
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Benchmark_result &result = results[i];
+    fprintf(file,
+            "%s\n    {\n      \"name\": \"%s\",\n"
+            "      \"run_type\": \"iteration\",\n"
+            "      \"iterations\": %lu,\n"
+            "      \"real_time\": %.1f,\n"
+            "      \"cpu_time\": %.1f,\n"
+            "      \"time_unit\": \"ns\"",
+            i == 0 ? "" : ",", result.name.c_str(),
+            static_cast<unsigned long>(result.iterations),
+            result.ns_per_iteration, result.ns_per_iteration);
+    if (result.bytes_per_second > 0)
+      fprintf(file, ",\n      \"bytes_per_second\": %.0f",
+              result.bytes_per_second);
+    fprintf(file, "\n    }");
+  }
+  fprintf(file, "\n  ]\n}\n");
+  fclose(file);
+}
+
 void internal_do_microbenchmark(const char *name, void (*func)(size_t)) {
 #if !defined(NDEBUG)
   printf(
@@ -85,6 +145,10 @@ void internal_do_microbenchmark(const char *name, void (*func)(size_t)) {
          static_cast<long>(num_iterations),
          1e9 * seconds_used / double(num_iterations));
 
+  results.push_back({name, num_iterations,
+                     1e9 * seconds_used / double(num_iterations),
+                     bytes_processed > 0 ? bytes_processed / seconds_used : 0});
+
   if (bytes_processed > 0) {
     double bytes_per_second = bytes_processed / seconds_used;
     if (bytes_per_second > (512 << 20))  // 0.5 GB/sec.
@@ -95,4 +159,5 @@ void internal_do_microbenchmark(const char *name, void (*func)(size_t)) {
   }
 
   printf("\n");
+  write_json_report();
 }
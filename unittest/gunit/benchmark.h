@@ -26,6 +26,10 @@
   Rudimentary microbenchmark framework. The API is generally a minimal
   subset of Google's microbenchmark framework, in order to be compatible
   if we should ever import the full one.
+
+  Setting the environment variable MYSQL_BENCHMARK_JSON to a file name makes
+  the benchmarks also write their results there, as JSON in the layout of
+  Google Benchmark. See microbenchmarks-t.cc for the suite of hot paths.
 */
 
 #ifndef BENCHMARK_H_INCLUDED
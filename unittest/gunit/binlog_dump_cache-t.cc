@@ -0,0 +1,127 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "libbinlogevents/include/binlog_event.h"  // EVENT_LEN_OFFSET
+#include "my_byteorder.h"
+#include "sql/binlog_dump_cache.h"
+
+namespace binlog_dump_cache_unittest {
+
+static const char *FILE_1 = "./binlog.000001";
+static const char *FILE_2 = "./binlog.000002";
+
+class BinlogDumpCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override { m_cache.init(); }
+  void TearDown() override { m_cache.destroy(); }
+
+  /* Write an event of length bytes, each of them fill, at m_pos */
+  my_off_t write(uint32 length, uchar fill) {
+    std::vector<uchar> event(length, fill);
+    int4store(&event[EVENT_LEN_OFFSET], length);
+    m_cache.write(m_pos, event.data(), length);
+    my_off_t pos = m_pos;
+    m_pos += length;
+    return pos;
+  }
+
+  /* The event at pos is cached and has length bytes, each of them fill */
+  void expect_event(my_off_t pos, uint32 length, uchar fill) {
+    ASSERT_EQ(length, m_cache.event_length(FILE_1, pos));
+    std::vector<uchar> event(length);
+    ASSERT_FALSE(m_cache.copy(FILE_1, pos, length, event.data()));
+    EXPECT_EQ(length, uint4korr(&event[EVENT_LEN_OFFSET]));
+    EXPECT_EQ(fill, event[0]);
+    EXPECT_EQ(fill, event[length - 1]);
+  }
+
+  Binlog_dump_cache m_cache;
+  my_off_t m_pos = 0;
+};
+
+TEST_F(BinlogDumpCacheTest, Disabled) {
+  m_cache.start_file(FILE_1, 0);
+  my_off_t pos = write(100, 'a');
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, pos));
+}
+
+TEST_F(BinlogDumpCacheTest, Window) {
+  m_cache.start_file(FILE_1, 1000);
+  my_off_t first = write(300, 'a');
+  my_off_t second = write(300, 'b');
+  expect_event(first, 300, 'a');
+  expect_event(second, 300, 'b');
+
+  /* Wraps around the end of the buffer, pushing out the first event */
+  my_off_t third = write(600, 'c');
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, first));
+  expect_event(second, 300, 'b');
+  expect_event(third, 600, 'c');
+
+  /* Only the events of the cached file */
+  EXPECT_EQ(0U, m_cache.event_length(FILE_2, third));
+  /* Not all of an event longer than the buffer is kept */
+  my_off_t big = write(2000, 'd');
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, big));
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, third));
+}
+
+TEST_F(BinlogDumpCacheTest, Truncate) {
+  m_cache.start_file(FILE_1, 1000);
+  my_off_t first = write(100, 'a');
+  my_off_t second = write(100, 'b');
+  m_cache.truncate(second);
+  m_pos = second;
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, second));
+  expect_event(first, 100, 'a');
+
+  /* Written again after the truncation */
+  second = write(200, 'c');
+  expect_event(second, 200, 'c');
+
+  /* A write elsewhere restarts the window */
+  m_pos += 50;
+  my_off_t third = write(100, 'd');
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, first));
+  expect_event(third, 100, 'd');
+}
+
+TEST_F(BinlogDumpCacheTest, Rotate) {
+  m_cache.start_file(FILE_1, 1000);
+  my_off_t first = write(100, 'a');
+  m_cache.stop_file();
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, first));
+  uchar buffer[100];
+  EXPECT_TRUE(m_cache.copy(FILE_1, first, 100, buffer));
+
+  m_cache.start_file(FILE_2, 1000);
+  EXPECT_EQ(0U, m_cache.event_length(FILE_1, first));
+  m_pos = 0;
+  write(100, 'b');
+  EXPECT_EQ(100U, m_cache.event_length(FILE_2, 0));
+}
+
+}  // namespace binlog_dump_cache_unittest
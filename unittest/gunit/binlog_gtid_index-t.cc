@@ -0,0 +1,128 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+
+#include "libbinlogevents/include/binlog_event.h"  // BIN_LOG_HEADER_SIZE
+#include "mysql/psi/mysql_mutex.h"
+#include "sql/binlog_gtid_index.h"
+#include "sql/rpl_gtid.h"
+
+namespace binlog_gtid_index_unittest {
+
+static const char *FILE_1 = "./binlog.000001";
+static const char *FILE_2 = "./binlog.000002";
+
+class BinlogGtidIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mysql_mutex_init(PSI_NOT_INSTRUMENTED, &m_lock, MY_MUTEX_INIT_FAST);
+    m_sid[0].parse("11111111-1111-1111-1111-111111111111",
+                   binary_log::Uuid::TEXT_LENGTH);
+    m_sid[1].parse("22222222-2222-2222-2222-222222222222",
+                   binary_log::Uuid::TEXT_LENGTH);
+  }
+  void TearDown() override { mysql_mutex_destroy(&m_lock); }
+
+  /* Transactions 1..n of sid 0, 100 bytes each from position 200 on */
+  void write(Binlog_gtid_index *index, const char *file, int n) {
+    index->start_file(file, 200);
+    for (int i = 1; i <= n; i++)
+      index->add(file, 100 + i * 100, m_sid[0], i, 1000);
+  }
+
+  /* gtids holds transactions 1..n of sid */
+  void replica_has(Gtid_set *gtids, int sid, rpl_gno n) {
+    rpl_sidno sidno = gtids->get_sid_map()->add_sid(m_sid[sid]);
+    ASSERT_EQ(RETURN_STATUS_OK, gtids->ensure_sidno(sidno));
+    for (rpl_gno gno = 1; gno <= n; gno++) gtids->_add_gtid(sidno, gno);
+  }
+
+  mysql_mutex_t m_lock;
+  rpl_sid m_sid[2];
+};
+
+TEST_F(BinlogGtidIndexTest, SeekToFirstMissing) {
+  Binlog_gtid_index index(&m_lock);
+  write(&index, FILE_1, 100);
+  Sid_map sid_map(nullptr);
+  Gtid_set gtids(&sid_map);
+
+  /* Nothing is skipped for a replica without any of them */
+  EXPECT_EQ(BIN_LOG_HEADER_SIZE, index.find(FILE_1, &gtids, ~0ULL));
+
+  /* Entries at the transactions 11, 21, ... at 1200, 2200, ... */
+  replica_has(&gtids, 0, 25);
+  EXPECT_EQ(2200U, index.find(FILE_1, &gtids, ~0ULL));
+  EXPECT_EQ(1200U, index.find(FILE_1, &gtids, 2200));
+  EXPECT_EQ(BIN_LOG_HEADER_SIZE, index.find(FILE_2, &gtids, ~0ULL));
+}
+
+TEST_F(BinlogGtidIndexTest, Gaps) {
+  Binlog_gtid_index index(&m_lock);
+  index.start_file(FILE_1, 200);
+  for (int i = 1; i <= 30; i++)
+    index.add(FILE_1, 100 + i * 100, m_sid[i == 15 ? 1 : 0], i, 1000);
+  Sid_map sid_map(nullptr);
+  Gtid_set gtids(&sid_map);
+  replica_has(&gtids, 0, 30);
+
+  /* Transaction 15 is of the sid the replica has none of */
+  EXPECT_EQ(1200U, index.find(FILE_1, &gtids, ~0ULL));
+}
+
+TEST_F(BinlogGtidIndexTest, Barriers) {
+  Binlog_gtid_index index(&m_lock);
+  index.start_file(FILE_1, 200);
+  for (int i = 1; i <= 30; i++)
+    index.add(FILE_1, 100 + i * 100, m_sid[0], i == 5 ? 0 : i, 1000);
+  Sid_map sid_map(nullptr);
+  Gtid_set gtids(&sid_map);
+  replica_has(&gtids, 0, 30);
+
+  /* An anonymous transaction or incident is never skipped */
+  EXPECT_EQ(BIN_LOG_HEADER_SIZE, index.find(FILE_1, &gtids, ~0ULL));
+}
+
+TEST_F(BinlogGtidIndexTest, StopAndForget) {
+  Binlog_gtid_index index(&m_lock);
+  write(&index, FILE_1, 25);
+  Sid_map sid_map(nullptr);
+  Gtid_set gtids(&sid_map);
+  replica_has(&gtids, 0, 100);
+  EXPECT_EQ(2200U, index.find(FILE_1, &gtids, ~0ULL));
+
+  /* With the index disabled once, the file is not indexed any further */
+  index.add(FILE_1, 2600, m_sid[0], 26, 0);
+  for (int i = 27; i <= 50; i++)
+    index.add(FILE_1, 100 + i * 100, m_sid[0], i, 1000);
+  EXPECT_EQ(2200U, index.find(FILE_1, &gtids, ~0ULL));
+
+  write(&index, FILE_2, 25);
+  index.remove(FILE_1);
+  EXPECT_EQ(BIN_LOG_HEADER_SIZE, index.find(FILE_1, &gtids, ~0ULL));
+  EXPECT_EQ(2200U, index.find(FILE_2, &gtids, ~0ULL));
+  index.clear();
+  EXPECT_EQ(BIN_LOG_HEADER_SIZE, index.find(FILE_2, &gtids, ~0ULL));
+}
+
+}  // namespace binlog_gtid_index_unittest
@@ -0,0 +1,184 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "libbinlogevents/include/binlog_event.h"
+#include "my_byteorder.h"
+#include "my_checksum.h"
+#include "sql/binlog_ostream.h"
+#include "sql/mysqld.h"  // binlog_checksum_options
+
+namespace binlog_ostream_unittest {
+
+class BinlogEventChecksumsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    m_checksum_options = binlog_checksum_options;
+    binlog_checksum_options = binary_log::BINLOG_CHECKSUM_ALG_CRC32;
+    m_checksums.reset();
+  }
+  void TearDown() override { binlog_checksum_options = m_checksum_options; }
+
+  /* Appends an event with a body of body_len bytes to m_cache */
+  void add_event(uint32 body_len) {
+    uint32 event_len = LOG_EVENT_HEADER_LEN + body_len;
+    m_offsets.push_back(m_cache.size());
+    for (uint32 i = 0; i < event_len; i++)
+      m_cache.push_back(static_cast<unsigned char>(m_cache.size() * 7 + 3));
+    int4store(&m_cache[m_offsets.back()] + EVENT_LEN_OFFSET, event_len);
+  }
+
+  /* Writes m_cache[from, to) in chunks of chunk bytes */
+  void write(size_t from, size_t to, size_t chunk) {
+    for (size_t pos = from; pos < to; pos += chunk)
+      m_checksums.update(&m_cache[pos], std::min(chunk, to - pos));
+  }
+
+  /*
+    Checks event_checksum() of the first n events against my_checksum() over
+    the whole event, with end_log_pos patched as the flush does it.
+  */
+  void check(size_t n) {
+    ASSERT_LE(n, m_checksums.count());
+    for (size_t i = 0; i < n; i++) {
+      unsigned char *event = &m_cache[m_offsets[i]];
+      uint32 event_len = uint4korr(event + EVENT_LEN_OFFSET);
+      int4store(event + LOG_POS_OFFSET, 1000 + i);
+      uint32 header = my_checksum(0L, event, LOG_EVENT_HEADER_LEN);
+      EXPECT_EQ(my_checksum(0L, event, event_len),
+                m_checksums.event_checksum(i, header))
+          << "event " << i;
+    }
+  }
+
+  ulong m_checksum_options;
+  Binlog_event_checksums m_checksums;
+  std::vector<unsigned char> m_cache;
+  std::vector<size_t> m_offsets;
+};
+
+TEST_F(BinlogEventChecksumsTest, WholeEvents) {
+  for (uint32 body_len : {1, 2, 18, 19, 20, 255, 256, 4096, 100000})
+    add_event(body_len);
+  for (size_t i = 0; i < m_offsets.size(); i++)
+    write(m_offsets[i], i + 1 < m_offsets.size() ? m_offsets[i + 1]
+                                                 : m_cache.size(),
+          m_cache.size());
+  EXPECT_EQ(m_offsets.size(), m_checksums.count());
+  check(m_offsets.size());
+}
+
+TEST_F(BinlogEventChecksumsTest, EventsSpanChunks) {
+  for (uint32 body_len : {1, 30, 5000, 3, 65536, 10}) add_event(body_len);
+  /* Chunks that split headers, bodies and several events at once */
+  for (size_t chunk : {1, 7, 19, 20, 4096, 70000}) {
+    SCOPED_TRACE(chunk);
+    m_checksums.reset();
+    write(0, m_cache.size(), chunk);
+    EXPECT_EQ(m_offsets.size(), m_checksums.count());
+    check(m_offsets.size());
+  }
+}
+
+TEST_F(BinlogEventChecksumsTest, PartialEvent) {
+  add_event(100);
+  add_event(100);
+  write(0, m_offsets[1] + LOG_EVENT_HEADER_LEN + 50, 64);
+  /* The second event is not complete yet */
+  EXPECT_EQ(1U, m_checksums.count());
+  write(m_offsets[1] + LOG_EVENT_HEADER_LEN + 50, m_cache.size(), 64);
+  EXPECT_EQ(2U, m_checksums.count());
+  check(2);
+}
+
+TEST_F(BinlogEventChecksumsTest, Truncate) {
+  for (int i = 0; i < 3; i++) add_event(100);
+  write(0, m_cache.size(), 33);
+
+  /* Truncating to the end keeps the events */
+  m_checksums.truncate(m_cache.size());
+  EXPECT_EQ(3U, m_checksums.count());
+  check(3);
+
+  /* Truncating in the middle of the cache stops tracking */
+  m_checksums.truncate(m_offsets[2]);
+  EXPECT_EQ(0U, m_checksums.count());
+  m_cache.resize(m_offsets[2]);
+  m_offsets.resize(2);
+  add_event(50);
+  write(m_offsets[2], m_cache.size(), 33);
+  EXPECT_EQ(0U, m_checksums.count());
+
+  /* Truncating to 0 starts over */
+  m_checksums.truncate(0);
+  m_cache.clear();
+  m_offsets.clear();
+  add_event(10);
+  add_event(20);
+  write(0, m_cache.size(), 33);
+  EXPECT_EQ(2U, m_checksums.count());
+  check(2);
+}
+
+TEST_F(BinlogEventChecksumsTest, MaxEvents) {
+  const size_t max_events = Binlog_event_checksums::MAX_EVENTS;
+  for (size_t i = 0; i < max_events + 10; i++) add_event(1);
+  write(0, m_cache.size(), 4096);
+
+  /* The events after MAX_EVENTS are left to the copy */
+  EXPECT_EQ(max_events, m_checksums.count());
+  check(m_checksums.count());
+
+  m_checksums.reset();
+  write(0, m_offsets[10], 4096);
+  EXPECT_EQ(10U, m_checksums.count());
+  check(10);
+}
+
+TEST_F(BinlogEventChecksumsTest, ChecksumNone) {
+  add_event(100);
+  binlog_checksum_options = binary_log::BINLOG_CHECKSUM_ALG_OFF;
+  m_checksums.reset();
+  write(0, m_cache.size(), 64);
+  EXPECT_EQ(0U, m_checksums.count());
+
+  /* A cache started after binlog_checksum is set again is tracked */
+  binlog_checksum_options = binary_log::BINLOG_CHECKSUM_ALG_CRC32;
+  m_checksums.reset();
+  write(0, m_cache.size(), 64);
+  EXPECT_EQ(1U, m_checksums.count());
+  check(1);
+}
+
+TEST_F(BinlogEventChecksumsTest, InvalidLength) {
+  add_event(100);
+  write(0, m_cache.size(), 64);
+  /* An event length that does not cover the header stops tracking */
+  unsigned char header[LOG_EVENT_HEADER_LEN] = {0};
+  int4store(header + EVENT_LEN_OFFSET, LOG_EVENT_HEADER_LEN);
+  m_checksums.update(header, sizeof(header));
+  EXPECT_EQ(0U, m_checksums.count());
+}
+
+}  // namespace binlog_ostream_unittest
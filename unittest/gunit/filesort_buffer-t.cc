@@ -23,11 +23,17 @@
 #include <gtest/gtest.h>
 #include <stddef.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <random>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "my_byteorder.h"
 #include "my_inttypes.h"
 #include "my_pointer_arithmetic.h"
 #include "sql/filesort_utils.h"
+#include "sql/sort_param.h"
 #include "sql/table.h"
 
 namespace filesort_buffer_unittest {
@@ -162,4 +168,170 @@ TEST_F(FileSortBufferTest, PreallocateRecords) {
   }
 }
 
+/*
+  Sorting with Filesort_buffer::sort_buffer() as filesort() does, checked
+  against std::stable_sort of the same records.
+*/
+class FileSortBufferSortTest : public FileSortBufferTest {
+ protected:
+  static const uint ref_length = 8;
+
+  /**
+    Records of random fixed-length keys, each followed by a row ID that
+    tells the records apart. Keys are made of few distinct bytes, so there
+    are many duplicates, and have a constant prefix, so radix sort skips
+    some of the bytes.
+  */
+  static std::vector<std::string> make_fixed_records(size_t num_records,
+                                                     uint key_length) {
+    std::mt19937 generator(key_length);
+    std::vector<std::string> records;
+    for (size_t r = 0; r < num_records; ++r) {
+      std::string record(key_length + ref_length, '\0');
+      for (uint i = key_length / 2; i < key_length; ++i)
+        record[i] = "\x00\x01\x7f\x80\xff"[generator() % 5];
+      int8store(pointer_cast<uchar *>(&record[key_length]), r);
+      records.push_back(record);
+    }
+    return records;
+  }
+
+  /// Sort the records in fs_info, and return them in the sorted order.
+  std::vector<std::string> sort(const std::vector<std::string> &records,
+                                Sort_param *param, size_t key_length) {
+    fs_info.reset();
+    for (const std::string &record : records) {
+      Bounds_checked_array<uchar> to =
+          fs_info.get_next_record_pointer(record.size());
+      EXPECT_GE(to.size(), record.size());
+      memcpy(to.array(), record.data(), record.size());
+      fs_info.commit_used_memory(record.size());
+    }
+    const size_t num_rows =
+        fs_info.sort_buffer(param, records.size(), records.size());
+    std::vector<std::string> sorted;
+    for (size_t r = 0; r < num_rows; ++r) {
+      const char *record =
+          pointer_cast<const char *>(fs_info.get_sorted_record(r));
+      sorted.emplace_back(record, key_length + ref_length);
+    }
+    return sorted;
+  }
+
+  /// Sort fixed-length records, and check them against std::stable_sort.
+  void check_fixed(size_t num_records, uint key_length,
+                   bool remove_duplicates,
+                   Sort_param::enum_sort_algorithm expected_algorithm) {
+    SCOPED_TRACE(key_length);
+    const std::vector<std::string> records =
+        make_fixed_records(num_records, key_length);
+
+    Sort_param param;
+    param.set_max_compare_length(key_length + ref_length);
+    param.set_max_record_length(key_length + ref_length);
+    param.sum_ref_length = ref_length;
+    param.m_remove_duplicates = remove_duplicates;
+    fs_info.set_max_size(64 * 1024 * 1024, key_length + ref_length);
+
+    const std::vector<std::string> sorted =
+        sort(records, &param, key_length);
+    EXPECT_EQ(expected_algorithm, param.m_sort_algorithm);
+
+    // Equal keys keep their order, and the first one of them is kept.
+    std::vector<std::string> expected = records;
+    const auto key_less = [key_length](const std::string &a,
+                                       const std::string &b) {
+      return a.compare(0, key_length, b, 0, key_length) < 0;
+    };
+    std::stable_sort(expected.begin(), expected.end(), key_less);
+    if (remove_duplicates) {
+      expected.erase(std::unique(expected.begin(), expected.end(),
+                                 [&](const std::string &a,
+                                     const std::string &b) {
+                                   return !key_less(a, b) && !key_less(b, a);
+                                 }),
+                     expected.end());
+      EXPECT_GT(records.size(), expected.size());
+    }
+    EXPECT_EQ(expected, sorted);
+  }
+};
+
+TEST_F(FileSortBufferSortTest, RadixSort) {
+  for (uint key_length : {1, 2, 3, 4, 8, 13, 16}) {
+    check_fixed(20000, key_length, false, Sort_param::FILESORT_ALG_RADIX);
+  }
+}
+
+TEST_F(FileSortBufferSortTest, RadixSortRemoveDuplicates) {
+  for (uint key_length : {1, 4, 16}) {
+    check_fixed(20000, key_length, true, Sort_param::FILESORT_ALG_RADIX);
+  }
+}
+
+TEST_F(FileSortBufferSortTest, NoRadixSort) {
+  // Keys too long, and too few rows.
+  check_fixed(20000, 17, false, Sort_param::FILESORT_ALG_STD_STABLE);
+  check_fixed(20000, 17, true, Sort_param::FILESORT_ALG_STD_STABLE);
+  check_fixed(9999, 8, false, Sort_param::FILESORT_ALG_STD_STABLE);
+}
+
+TEST_F(FileSortBufferSortTest, VariableLengthKeys) {
+  // One VARCHAR key part: the record length, then the key part length,
+  // both including their own 4 bytes, then the key and the row ID.
+  st_sort_field sort_field{};
+  sort_field.length = 20;
+  sort_field.is_varlen = true;
+  Sort_param param;
+  param.init_for_unittest(make_array(&sort_field, 1));
+  param.set_max_compare_length(4 + 4 + 20 + ref_length);
+  param.set_max_record_length(4 + 4 + 20 + ref_length);
+  param.sum_ref_length = ref_length;
+  fs_info.set_max_size(64 * 1024 * 1024, 4 + 4 + 20 + ref_length);
+
+  // Short keys of a few letters; "ab" < "aba" < "abb" < "b".
+  std::mt19937 generator(42);
+  std::vector<std::string> keys;
+  for (size_t r = 0; r < 20000; ++r) {
+    std::string key(generator() % 5, 'a');
+    for (char &c : key) c = "ab"[generator() % 2];
+    keys.push_back(key);
+  }
+
+  for (bool remove_duplicates : {false, true}) {
+    param.m_remove_duplicates = remove_duplicates;
+    fs_info.reset();
+    for (size_t r = 0; r < keys.size(); ++r) {
+      const uint record_length = 4 + 4 + keys[r].size() + ref_length;
+      Bounds_checked_array<uchar> to =
+          fs_info.get_next_record_pointer(record_length);
+      ASSERT_GE(to.size(), record_length);
+      int4store(to.array(), record_length);
+      int4store(to.array() + 4, 4 + keys[r].size());
+      memcpy(to.array() + 8, keys[r].data(), keys[r].size());
+      int8store(to.array() + 8 + keys[r].size(), r);
+      fs_info.commit_used_memory(record_length);
+    }
+    const size_t num_rows =
+        fs_info.sort_buffer(&param, keys.size(), keys.size());
+    EXPECT_NE(Sort_param::FILESORT_ALG_RADIX, param.m_sort_algorithm);
+
+    std::vector<std::string> sorted;
+    for (size_t r = 0; r < num_rows; ++r) {
+      const uchar *record = fs_info.get_sorted_record(r);
+      sorted.emplace_back(pointer_cast<const char *>(record + 8),
+                          uint4korr(record + 4) - 4);
+    }
+
+    std::vector<std::string> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    if (remove_duplicates) {
+      expected.erase(std::unique(expected.begin(), expected.end()),
+                     expected.end());
+      EXPECT_EQ(31U, expected.size());
+    }
+    EXPECT_EQ(expected, sorted);
+  }
+}
+
 }  // namespace filesort_buffer_unittest
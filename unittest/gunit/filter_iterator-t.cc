@@ -0,0 +1,244 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <functional>
+#include <vector>
+
+#include "my_inttypes.h"
+#include "sql/composite_iterators.h"
+#include "sql/item_cmpfunc.h"
+#include "sql/row_iterator.h"
+#include "sql/sql_class.h"
+#include "unittest/gunit/fake_table.h"
+#include "unittest/gunit/mock_field_long.h"
+#include "unittest/gunit/test_utils.h"
+
+namespace filter_iterator_unittest {
+
+using my_testing::Server_initializer;
+
+/// A row of the test table: a signed and an unsigned INT, both nullable.
+struct Row {
+  bool a_is_null;
+  longlong a;
+  bool b_is_null;
+  longlong b;
+};
+
+/// Reads the rows into the fields of the table, and remembers which row it
+/// read last.
+class FakeRowsIterator final : public TableRowIterator {
+ public:
+  FakeRowsIterator(THD *thd, TABLE *table, const std::vector<Row> &rows,
+                   size_t *current_row)
+      : TableRowIterator(thd, table),
+        m_rows(rows),
+        m_current_row(current_row) {}
+
+  bool Init() override {
+    m_next_row = 0;
+    return false;
+  }
+
+  int Read() override {
+    if (m_next_row == m_rows.size()) return -1;
+    *m_current_row = m_next_row;
+    StoreRow(table(), m_rows[m_next_row++]);
+    return 0;
+  }
+
+  static void StoreRow(TABLE *table, const Row &row) {
+    Field *a = table->field[0];
+    Field *b = table->field[1];
+    if (row.a_is_null) {
+      a->set_null();
+    } else {
+      a->set_notnull();
+      a->store(row.a, /*unsigned_val=*/false);
+    }
+    if (row.b_is_null) {
+      b->set_null();
+    } else {
+      b->set_notnull();
+      b->store(row.b, /*unsigned_val=*/true);
+    }
+  }
+
+ private:
+  const std::vector<Row> &m_rows;
+  size_t *m_current_row;
+  size_t m_next_row{0};
+};
+
+class FilterIteratorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    m_initializer.SetUp();
+    m_a = new (thd()->mem_root) Mock_field_long("a", true, false);
+    m_b = new (thd()->mem_root) Mock_field_long("b", true, true);
+    m_table = new Fake_TABLE(m_a, m_b);
+    bitmap_set_all(m_table->write_set);
+    bitmap_set_all(m_table->read_set);
+
+    // Every combination of NULL, the limits and values around the literals.
+    const longlong a_values[] = {INT_MIN32, -10, -1, 0, 1, 5, 10, INT_MAX32};
+    const longlong b_values[] = {0, 1, 5, 10, INT_MAX32 + 1LL, UINT_MAX32};
+    for (int i = -1; i < static_cast<int>(array_elements(a_values)); i++) {
+      for (int j = -1; j < static_cast<int>(array_elements(b_values)); j++) {
+        m_rows.push_back({i < 0, i < 0 ? 0 : a_values[i], j < 0,
+                          j < 0 ? 0 : b_values[j]});
+      }
+    }
+  }
+
+  void TearDown() override {
+    delete m_table;
+    m_initializer.TearDown();
+  }
+
+  THD *thd() { return m_initializer.thd(); }
+
+  Item *a() { return new Item_field(m_a); }
+  Item *b() { return new Item_field(m_b); }
+
+  static Item *Int(longlong value) { return new Item_int(value); }
+  static Item *Uint(ulonglong value) { return new Item_uint(value); }
+
+  Item *Fix(Item *item) {
+    EXPECT_FALSE(item->fix_fields(thd(), &item));
+    return item;
+  }
+
+  /**
+    Filter the rows, and check that the same rows pass as on the slow path,
+    where the condition is evaluated through the Item tree; a NULL (UNKNOWN)
+    result rejects the row there.
+
+    @param condition       The filter condition, resolved.
+    @param expect_compiled Whether the condition takes the fast path.
+    @return The number of rows where the condition is UNKNOWN.
+  */
+  size_t CheckFilter(Item *condition, bool expect_compiled) {
+    std::vector<size_t> expected;
+    size_t unknown = 0;
+    for (size_t i = 0; i < m_rows.size(); i++) {
+      FakeRowsIterator::StoreRow(m_table, m_rows[i]);
+      const longlong value = condition->val_int();
+      if (condition->null_value) {
+        EXPECT_EQ(0, value);
+        unknown++;
+      }
+      if (value != 0 && !condition->null_value) expected.push_back(i);
+    }
+
+    size_t current_row = 0;
+    FilterIterator filter(
+        thd(),
+        unique_ptr_destroy_only<RowIterator>(new (thd()->mem_root)
+                                                 FakeRowsIterator(
+                                                     thd(), m_table, m_rows,
+                                                     &current_row)),
+        condition);
+    EXPECT_EQ(expect_compiled, filter.IsConditionCompiled());
+
+    std::vector<size_t> filtered;
+    EXPECT_FALSE(filter.Init());
+    while (filter.Read() == 0) filtered.push_back(current_row);
+
+    EXPECT_EQ(expected, filtered);
+    return unknown;
+  }
+
+  Server_initializer m_initializer;
+  Mock_field_long *m_a{nullptr};
+  Mock_field_long *m_b{nullptr};
+  Fake_TABLE *m_table{nullptr};
+  std::vector<Row> m_rows;
+};
+
+TEST_F(FilterIteratorTest, CompareSigned) {
+  const std::vector<std::function<Item *(Item *, Item *)>> ops = {
+      [](Item *x, Item *y) { return new Item_func_eq(x, y); },
+      [](Item *x, Item *y) { return new Item_func_ne(x, y); },
+      [](Item *x, Item *y) { return new Item_func_lt(x, y); },
+      [](Item *x, Item *y) { return new Item_func_le(x, y); },
+      [](Item *x, Item *y) { return new Item_func_gt(x, y); },
+      [](Item *x, Item *y) { return new Item_func_ge(x, y); }};
+
+  for (const auto &op : ops) {
+    for (longlong literal : {longlong{INT_MIN32}, -5LL, 0LL, 5LL,
+                             longlong{INT_MAX32}}) {
+      // The NULL rows of a are UNKNOWN.
+      EXPECT_EQ(7U, CheckFilter(Fix(op(a(), Int(literal))), true));
+      // The column on the right: 5 < a is a > 5.
+      EXPECT_EQ(7U, CheckFilter(Fix(op(Int(literal), a())), true));
+    }
+  }
+}
+
+TEST_F(FilterIteratorTest, CompareUnsigned) {
+  // Unsigned column, negative literal: always greater.
+  CheckFilter(Fix(new Item_func_gt(b(), Int(-1))), true);
+  CheckFilter(Fix(new Item_func_eq(b(), Int(-1))), true);
+  CheckFilter(Fix(new Item_func_le(b(), Int(INT_MAX32 + 1LL))), true);
+  CheckFilter(Fix(new Item_func_ge(Int(UINT_MAX32), b())), true);
+
+  // Signed column, literal above the signed range.
+  CheckFilter(Fix(new Item_func_lt(a(), Uint(ULLONG_MAX))), true);
+  CheckFilter(Fix(new Item_func_ne(a(), Uint(1ULL << 63))), true);
+  CheckFilter(Fix(new Item_func_gt(b(), Uint(10))), true);
+}
+
+TEST_F(FilterIteratorTest, CompareAnd) {
+  // UNKNOWN when either column is NULL and the other comparison is true.
+  const size_t unknown = CheckFilter(
+      Fix(new Item_cond_and(new Item_func_ne(a(), Int(5)),
+                            new Item_func_ne(b(), Int(5)))),
+      true);
+  EXPECT_LT(0U, unknown);
+
+  CheckFilter(Fix(new Item_cond_and(new Item_func_ge(a(), Int(-1)),
+                                    new Item_func_lt(b(), Uint(10)))),
+              true);
+  CheckFilter(Fix(new Item_cond_and(new Item_func_gt(a(), Int(0)),
+                                    new Item_func_lt(Int(0), a()))),
+              true);
+}
+
+TEST_F(FilterIteratorTest, SlowPath) {
+  // Conditions that are not compiled give the same rows as before.
+  CheckFilter(Fix(new Item_func_lt(a(), b())), false);
+  CheckFilter(Fix(new Item_cond_or(new Item_func_lt(a(), Int(0)),
+                                    new Item_func_eq(b(), Int(5)))),
+              false);
+  // One conjunct that cannot be compiled leaves the whole AND to the Items.
+  CheckFilter(Fix(new Item_cond_and(new Item_func_gt(a(), Int(0)),
+                                    new Item_func_isnull(b()))),
+              false);
+  CheckFilter(Fix(new Item_func_not(new Item_func_lt(a(), Int(5)))), false);
+}
+
+}  // namespace filter_iterator_unittest
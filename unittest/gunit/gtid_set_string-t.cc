@@ -0,0 +1,136 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <set>
+#include <string>
+
+#include "sql/rpl_gtid.h"
+
+namespace gtid_set_string_unittest {
+
+static const char *UUID = "11111111-1111-1111-1111-111111111111";
+
+class GtidSetStringTest : public ::testing::Test {
+ protected:
+  GtidSetStringTest() : m_set(&m_sid_map) {}
+
+  void SetUp() override {
+    rpl_sid sid;
+    sid.parse(UUID, binary_log::Uuid::TEXT_LENGTH);
+    m_sidno = m_sid_map.add_sid(sid);
+    ASSERT_EQ(RETURN_STATUS_OK, m_set.ensure_sidno(m_sidno));
+  }
+
+  void add(rpl_gno gno) {
+    m_set._add_gtid(m_sidno, gno);
+    m_gnos.insert(gno);
+  }
+
+  void remove(rpl_gno gno) {
+    m_set._remove_gtid(m_sidno, gno);
+    m_gnos.erase(gno);
+  }
+
+  void clear() {
+    m_set.clear();
+    m_gnos.clear();
+  }
+
+  /* The text of m_set, as to_string() returns it */
+  std::string text() {
+    char *buf = new char[m_set.get_string_length() + 1];
+    size_t len = m_set.to_string(buf);
+    std::string ret(buf, len);
+    delete[] buf;
+    return ret;
+  }
+
+  /* The text m_set should have, built from m_gnos */
+  std::string expected() const {
+    if (m_gnos.empty()) return "";
+    std::string ret(UUID);
+    for (auto it = m_gnos.begin(); it != m_gnos.end();) {
+      rpl_gno start = *it, end = *it;
+      while (++it != m_gnos.end() && *it == end + 1) end = *it;
+      ret += ":" + std::to_string(start);
+      if (end != start) ret += "-" + std::to_string(end);
+    }
+    return ret;
+  }
+
+  Sid_map m_sid_map{nullptr};
+  Gtid_set m_set;
+  rpl_sidno m_sidno{0};
+  std::set<rpl_gno> m_gnos;
+};
+
+TEST_F(GtidSetStringTest, CachedTextFollowsChanges) {
+  /* Every other transaction, so each one is an interval of its own */
+  for (rpl_gno gno = 1; gno < 600; gno += 2) add(gno);
+  ASSERT_GE(expected().size(), 1024U);
+  EXPECT_EQ(expected(), text());
+  /* The second call is served from the cache */
+  EXPECT_EQ(expected(), text());
+
+  /* add_gno_interval(): fill a gap, joining two intervals */
+  add(2);
+  EXPECT_EQ(expected(), text());
+  /* ... and extend the last interval */
+  add(600);
+  EXPECT_EQ(expected(), text());
+  EXPECT_EQ(expected(), text());
+
+  /* remove_gno_interval(): split an interval, drop a whole one */
+  remove(2);
+  EXPECT_EQ(expected(), text());
+  remove(301);
+  EXPECT_EQ(expected(), text());
+  EXPECT_EQ(expected(), text());
+
+  /* clear() */
+  clear();
+  EXPECT_EQ("", text());
+  for (rpl_gno gno = 1001; gno < 1600; gno += 2) add(gno);
+  ASSERT_GE(expected().size(), 1024U);
+  EXPECT_EQ(expected(), text());
+  EXPECT_EQ(expected(), text());
+}
+
+TEST_F(GtidSetStringTest, CachedTextMatchesFreshSet) {
+  for (rpl_gno gno = 1; gno < 600; gno += 2) add(gno);
+  text();
+  remove(99);
+  add(100);
+
+  /* A set built from scratch has no cached text */
+  Gtid_set fresh(&m_sid_map);
+  ASSERT_EQ(RETURN_STATUS_OK, fresh.ensure_sidno(m_sidno));
+  for (rpl_gno gno : m_gnos) fresh._add_gtid(m_sidno, gno);
+  char *buf = new char[fresh.get_string_length() + 1];
+  fresh.to_string(buf);
+  EXPECT_EQ(std::string(buf), text());
+  EXPECT_TRUE(fresh.is_subset(&m_set) && m_set.is_subset(&fresh));
+  delete[] buf;
+}
+
+}  // namespace gtid_set_string_unittest
@@ -0,0 +1,293 @@
+/**
+ * @file inception_audit-t.cc
+ * @brief Microbenchmarks of the inception audit engine (sql/inception).
+ *
+ * The statements are audited offline against an in-memory shadow catalog,
+ * as --schema-file does, so no target is needed and the numbers are those
+ * of the parser, the rule code and the formatting alone. Compare an
+ * optimized build before and after a change with
+ *
+ *   merge_large_tests-t --gtest_filter='Microbenchmarks.BM_Inception*'
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "sql/inception/inception_audit.h"
+#include "sql/inception/inception_context.h"
+#include "sql/inception/inception_log.h"
+#include "sql/inception/inception_parse.h"
+#include "sql/inception/inception_shadow.h"
+#include "sql/inception/inception_sysvars.h"
+#include "sql/inception/inception_tree.h"
+#include "sql/sql_class.h"
+#include "sql/sql_lex.h"
+#include "sql/sql_parse.h"
+#include "unittest/gunit/benchmark.h"
+#include "unittest/gunit/test_utils.h"
+
+namespace inception_audit_unittest {
+
+using inception::InceptionContext;
+using inception::ShadowCatalog;
+using inception::SqlCacheNode;
+using inception::TableMeta;
+
+/* Token array of the statement digest that compute_sqlsha1() hashes */
+static unsigned char digest_tokens[16 * 1024];
+
+/* Parse query on thd as mysql_parse() does, digest included. */
+static void parse_statement(THD *thd, const std::string &query) {
+  Parser_state state;
+  ASSERT_FALSE(state.init(thd, query.c_str(), query.length()));
+  state.m_input.m_compute_digest = true;
+  thd->m_digest = &thd->m_digest_state;
+  thd->m_digest->reset(digest_tokens, sizeof(digest_tokens));
+  lex_start(thd);
+  mysql_reset_thd_for_next_command(thd);
+  EXPECT_FALSE(parse_sql(thd, &state, nullptr)) << query;
+}
+
+/* Database bench with table bench.t (id, c0..c19, PRIMARY KEY) */
+static ShadowCatalog bench_catalog() {
+  ShadowCatalog catalog;
+  catalog.databases.insert("bench");
+  std::shared_ptr<TableMeta> t = std::make_shared<TableMeta>();
+  t->exists = true;
+  t->table_rows = 1000000;
+  t->columns["id"] = {"bigint", -1, 20, 0};
+  for (int i = 0; i < 20; i++)
+    t->columns["c" + std::to_string(i)] = {"varchar", 64, -1, -1};
+  t->indexes.insert("primary");
+  catalog.tables["bench.t"] = t;
+  return catalog;
+}
+
+/* A CHECK session auditing offline against catalog */
+static void setup_session(InceptionContext *ctx, const ShadowCatalog &catalog) {
+  ctx->active = true;
+  ctx->mode = inception::OpMode::CHECK;
+  inception::compile_rule_plan(&ctx->rules);
+  ctx->shadow = std::make_shared<ShadowCatalog>(catalog);
+}
+
+/*
+  Audit the statement parsed on thd num_iterations times, each time as the
+  first statement of a fresh batch. Only audit_statement() is timed.
+*/
+static void audit_loop(THD *thd, InceptionContext *ctx,
+                       const ShadowCatalog &catalog, const std::string &sql,
+                       size_t num_iterations) {
+  for (size_t i = 0; i < num_iterations; ++i) {
+    StopBenchmarkTiming();
+    ctx->shadow = std::make_shared<ShadowCatalog>(catalog);
+    ctx->batch_tables.clear();
+    ctx->batch_databases.clear();
+    ctx->altered_tables.clear();
+    ctx->alter_group = InceptionContext::AlterGroup();
+    ctx->audit_memo.clear();
+    ctx->audit_memo_index.clear();
+    SqlCacheNode node;
+    node.id = 1;
+    node.sql_text = sql;
+    node.sql_command = thd->lex->sql_command;
+    StartBenchmarkTiming();
+
+    inception::audit_statement(thd, &node, ctx);
+  }
+  StopBenchmarkTiming();
+}
+
+static void audit_benchmark(const std::string &sql, size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+  const ShadowCatalog catalog = bench_catalog();
+  InceptionContext ctx;
+  setup_session(&ctx, catalog);
+  parse_statement(initializer.thd(), sql);
+
+  audit_loop(initializer.thd(), &ctx, catalog, sql, num_iterations);
+
+  ctx.reset();
+  initializer.TearDown();
+}
+
+static std::string create_table_sql(int columns) {
+  std::string sql =
+      "CREATE TABLE bench.t_new (id BIGINT UNSIGNED NOT NULL "
+      "AUTO_INCREMENT COMMENT 'pk'";
+  for (int i = 0; i < columns - 1; i++) {
+    const std::string c = "c" + std::to_string(i);
+    sql += ", " + c + " VARCHAR(64) NOT NULL DEFAULT '' COMMENT '" + c + "'";
+  }
+  sql += ", PRIMARY KEY (id), KEY idx_c0 (c0)) COMMENT 'benchmark'";
+  return sql;
+}
+
+/**
+  Microbenchmark of parsing the inception_magic_start comment.
+*/
+static void BM_InceptionParseMagicStart(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  const std::string start =
+      "/*--user=inception;--password=secret;--host=10.0.0.1;--port=3306;"
+      "--enable-execute;--enable-force;--enable-ignore-warnings;--sleep=100;"
+      "--slave-hosts=10.0.0.2:3306,10.0.0.3:3306;inception_magic_start;*/";
+  InceptionContext ctx;
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    ctx.reset();
+    StartBenchmarkTiming();
+    EXPECT_FALSE(
+        inception::parse_inception_start(start.c_str(), start.length(), &ctx));
+    StopBenchmarkTiming();
+  }
+  ctx.reset();
+}
+BENCHMARK(BM_InceptionParseMagicStart)
+
+/**
+  Microbenchmarks of the CREATE TABLE rules on tables of 10, 100 and 1000
+  columns.
+*/
+static void BM_InceptionAuditCreateTable10(size_t num_iterations) {
+  audit_benchmark(create_table_sql(10), num_iterations);
+}
+BENCHMARK(BM_InceptionAuditCreateTable10)
+
+static void BM_InceptionAuditCreateTable100(size_t num_iterations) {
+  audit_benchmark(create_table_sql(100), num_iterations);
+}
+BENCHMARK(BM_InceptionAuditCreateTable100)
+
+static void BM_InceptionAuditCreateTable1000(size_t num_iterations) {
+  audit_benchmark(create_table_sql(1000), num_iterations);
+}
+BENCHMARK(BM_InceptionAuditCreateTable1000)
+
+/**
+  Microbenchmark of the ALTER TABLE rules: added, changed and dropped
+  columns and an added index, all checked against the catalog.
+*/
+static void BM_InceptionAuditAlterTable(size_t num_iterations) {
+  audit_benchmark(
+      "ALTER TABLE bench.t "
+      "ADD COLUMN n1 INT NOT NULL DEFAULT 0 COMMENT 'n1', "
+      "ADD COLUMN n2 VARCHAR(32) NOT NULL DEFAULT '' COMMENT 'n2', "
+      "MODIFY COLUMN c1 VARCHAR(128) NOT NULL DEFAULT '' COMMENT 'c1', "
+      "DROP COLUMN c2, "
+      "ADD INDEX idx_c3_c4 (c3, c4)",
+      num_iterations);
+}
+BENCHMARK(BM_InceptionAuditAlterTable)
+
+/**
+  Microbenchmark of the INSERT rules on a 1000-row multi-row INSERT, the
+  audit memo cleared each time.
+*/
+static void BM_InceptionAuditInsert1000Rows(size_t num_iterations) {
+  std::string sql = "INSERT INTO bench.t (id, c0, c1) VALUES ";
+  for (int i = 1; i <= 1000; i++) {
+    if (i > 1) sql += ", ";
+    sql += "(" + std::to_string(i) + ", 'name" + std::to_string(i) +
+           "', 'value')";
+  }
+  audit_benchmark(sql, num_iterations);
+}
+BENCHMARK(BM_InceptionAuditInsert1000Rows)
+
+/**
+  Microbenchmark of the QUERY_TREE JSON of a join with a subquery.
+*/
+static void BM_InceptionQueryTree(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+  InceptionContext ctx;
+  setup_session(&ctx, bench_catalog());
+  ctx.mode = inception::OpMode::QUERY_TREE;
+  /* Walk the AST each time, not the tree cache */
+  const ulong saved_cache_size = inception::opt_query_tree_cache_size;
+  inception::opt_query_tree_cache_size = 0;
+  parse_statement(
+      initializer.thd(),
+      "SELECT a.id, a.c0, b.c1, COUNT(b.c2) FROM bench.t a "
+      "JOIN bench.t b ON a.id = b.id "
+      "WHERE a.c3 IN (SELECT c3 FROM bench.t WHERE id > 10) AND b.c4 = 'x' "
+      "GROUP BY a.id, a.c0, b.c1 ORDER BY a.id LIMIT 10");
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    std::string json = inception::extract_query_tree(initializer.thd(), &ctx);
+    EXPECT_FALSE(json.empty());
+  }
+  StopBenchmarkTiming();
+  inception::opt_query_tree_cache_size = saved_cache_size;
+
+  ctx.reset();
+  initializer.TearDown();
+}
+BENCHMARK(BM_InceptionQueryTree)
+
+/**
+  Microbenchmark of the SQL fingerprint of a 1000-row INSERT.
+*/
+static void BM_InceptionSqlsha1(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+  std::string sql = "INSERT INTO bench.t (id, c0) VALUES ";
+  for (int i = 1; i <= 1000; i++) {
+    if (i > 1) sql += ", ";
+    sql += "(" + std::to_string(i) + ", 'name" + std::to_string(i) + "')";
+  }
+  parse_statement(initializer.thd(), sql);
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    SqlCacheNode node;
+    inception::compute_sqlsha1(initializer.thd(), &node);
+    EXPECT_EQ(40U, node.sqlsha1.size());
+  }
+  StopBenchmarkTiming();
+
+  initializer.TearDown();
+}
+BENCHMARK(BM_InceptionSqlsha1)
+
+/**
+  Microbenchmark of the JSON line of the statement audit log, for a
+  statement with quotes, newlines and tabs to escape.
+*/
+static void BM_InceptionAuditLogLine(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  InceptionContext ctx;
+  ctx.host = "10.0.0.1";
+  ctx.port = 3306;
+  SqlCacheNode node;
+  node.id = 42;
+  node.affected_rows = 1000;
+  node.execute_seconds = 0.125;
+  for (int i = 0; i < 50; i++)
+    node.sql_text += "UPDATE bench.t SET c0 = \"a\\b\"\n\tWHERE id = 1;";
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    std::string line = inception::audit_log_statement_line(
+        "admin", "10.0.0.9", &ctx, &node);
+    EXPECT_EQ('\n', line.back());
+  }
+  StopBenchmarkTiming();
+  SetBytesProcessed(num_iterations * node.sql_text.size());
+}
+BENCHMARK(BM_InceptionAuditLogLine)
+
+}  // namespace inception_audit_unittest
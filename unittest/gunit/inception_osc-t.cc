@@ -0,0 +1,91 @@
+/**
+ * @file inception_osc-t.cc
+ * @brief Tests of the ghost table DDL of the inception online schema
+ *        change (sql/inception/inception_osc.h).
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "sql/inception/inception_osc.h"
+
+namespace inception_osc_unittest {
+
+using inception::deferrable_indexes;
+using inception::deferred_index_spec;
+
+/* SHOW CREATE TABLE of a ghost with one key of each kind */
+static const char *ghost_ddl =
+    "CREATE TABLE `_t1_gho` (\n"
+    "  `id` bigint unsigned NOT NULL AUTO_INCREMENT COMMENT 'pk',\n"
+    "  `name` varchar(100) NOT NULL COMMENT 'longer',\n"
+    "  `code` int NOT NULL COMMENT 'code',\n"
+    "  `doc` text COMMENT 'doc',\n"
+    "  `pt` point NOT NULL /*!80003 SRID 0 */ COMMENT 'pt',\n"
+    "  PRIMARY KEY (`id`),\n"
+    "  UNIQUE KEY `uk_code` (`code`),\n"
+    "  KEY `idx_name` (`name`(20)),\n"
+    "  KEY `idx code``name` (`code`,`name`) COMMENT 'two',\n"
+    "  FULLTEXT KEY `ft_doc` (`doc`),\n"
+    "  SPATIAL KEY `sp_pt` (`pt`)\n"
+    ") ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='osc test'";
+
+TEST(InceptionOscTest, DefersPlainKeysOnly) {
+  std::string drop;
+  std::vector<std::string> keys;
+  deferrable_indexes(ghost_ddl, &drop, &keys);
+
+  EXPECT_EQ("DROP INDEX `idx_name`, DROP INDEX `idx code``name`", drop);
+  ASSERT_EQ(2U, keys.size());
+  EXPECT_EQ("KEY `idx_name` (`name`(20))", keys[0]);
+  EXPECT_EQ("KEY `idx code``name` (`code`,`name`) COMMENT 'two'", keys[1]);
+}
+
+TEST(InceptionOscTest, LastKeyWithoutComma) {
+  std::string drop;
+  std::vector<std::string> keys;
+  deferrable_indexes(
+      "CREATE TABLE `_t2_gho` (\n"
+      "  `id` int NOT NULL,\n"
+      "  `a` int DEFAULT NULL,\n"
+      "  PRIMARY KEY (`id`),\n"
+      "  KEY `idx_a` (`a`)\n"
+      ") ENGINE=InnoDB",
+      &drop, &keys);
+
+  EXPECT_EQ("DROP INDEX `idx_a`", drop);
+  ASSERT_EQ(1U, keys.size());
+  EXPECT_EQ("KEY `idx_a` (`a`)", keys[0]);
+}
+
+TEST(InceptionOscTest, NothingToDefer) {
+  std::string drop;
+  std::vector<std::string> keys;
+  deferrable_indexes(
+      "CREATE TABLE `_t3_gho` (\n"
+      "  `id` int NOT NULL,\n"
+      "  `key_col` int NOT NULL COMMENT '  KEY `x` (`y`)',\n"
+      "  PRIMARY KEY (`id`),\n"
+      "  UNIQUE KEY `uk` (`key_col`)\n"
+      ") ENGINE=InnoDB",
+      &drop, &keys);
+
+  EXPECT_TRUE(drop.empty());
+  EXPECT_TRUE(keys.empty());
+}
+
+TEST(InceptionOscTest, AddsKeysBackOnline) {
+  std::string drop;
+  std::vector<std::string> keys;
+  deferrable_indexes(ghost_ddl, &drop, &keys);
+
+  EXPECT_EQ(
+      "ADD KEY `idx_name` (`name`(20)), "
+      "ADD KEY `idx code``name` (`code`,`name`) COMMENT 'two', "
+      "ALGORITHM=INPLACE, LOCK=NONE",
+      deferred_index_spec(keys));
+}
+
+}  // namespace inception_osc_unittest
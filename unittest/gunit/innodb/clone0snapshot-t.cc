@@ -0,0 +1,147 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+#include "storage/innobase/include/clone0snapshot.h"
+
+namespace innodb_clone0snapshot_unittest {
+
+/* Tablespaces of the snapshot: system, two that existed when the base clone
+started page tracking, one created later and the data dictionary. */
+static const space_id_t SPACES[] = {0, 5, 7, 12, 0xFFFFFFFE};
+
+/* Maximum tablespace ID of the base clone */
+static const space_id_t BASE_SPACE_ID = 7;
+
+/* Page tracking LSN of the base clone */
+static const lsn_t BASE_LSN = 1000000;
+
+static Clone_File_Map make_file_map() {
+  Clone_File_Map file_map;
+  uint index = 0;
+  for (auto space_id : SPACES) {
+    file_map[space_id] = index++;
+  }
+  return (file_map);
+}
+
+/* test clone_incremental_keeps_file() for a full clone */
+TEST(clone0snapshot, full_copies_all_files) {
+  for (auto space_id : SPACES) {
+    EXPECT_FALSE(clone_incremental_keeps_file(0, BASE_SPACE_ID, space_id));
+  }
+}
+
+/* test clone_incremental_keeps_file() for an incremental clone */
+TEST(clone0snapshot, incremental_keeps_base_files) {
+  EXPECT_TRUE(clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID, 0));
+  EXPECT_TRUE(clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID, 5));
+  EXPECT_TRUE(
+      clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID, BASE_SPACE_ID));
+
+  /* Created after the base clone started tracking */
+  EXPECT_FALSE(clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID, 12));
+
+  /* Reserved IDs are not counted in the base and are copied in full */
+  EXPECT_FALSE(
+      clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID, 0xFFFFFFFE));
+}
+
+/* test clone_add_page() skips pages of tablespaces not in the clone */
+TEST(clone0snapshot, add_page_skips_unknown_space) {
+  auto file_map = make_file_map();
+  Clone_Page_Set page_set;
+
+  EXPECT_EQ(CLONE_PAGE_SKIPPED, clone_add_page(file_map, page_set, 6, 3));
+  EXPECT_EQ(CLONE_PAGE_SKIPPED, clone_add_page(file_map, page_set, 99, 0));
+  EXPECT_TRUE(page_set.empty());
+}
+
+/* test the pages an incremental clone selects: the pages modified since
+the base clone (tracked from the base LSN to the start of this clone's
+tracking) and the pages modified during this clone, each once */
+TEST(clone0snapshot, incremental_page_selection) {
+  auto file_map = make_file_map();
+  Clone_Page_Set page_set;
+
+  /* Pages tracked from the base LSN to the start of this clone */
+  const std::vector<std::pair<space_id_t, page_no_t>> base_range = {
+      {5, 10}, {5, 3}, {0, 7}, {8, 1}, {7, 0}};
+
+  /* Pages tracked during this clone */
+  const std::vector<std::pair<space_id_t, page_no_t>> clone_range = {
+      {5, 3}, {12, 2}, {0, 7}, {7, 4}, {5, 11}};
+
+  uint added = 0;
+  uint duplicate = 0;
+  uint skipped = 0;
+
+  for (const auto &range : {clone_range, base_range}) {
+    for (const auto &page : range) {
+      switch (clone_add_page(file_map, page_set, page.first, page.second)) {
+        case CLONE_PAGE_ADDED:
+          added++;
+          break;
+        case CLONE_PAGE_DUPLICATE:
+          duplicate++;
+          break;
+        case CLONE_PAGE_SKIPPED:
+          skipped++;
+          break;
+      }
+    }
+  }
+
+  EXPECT_EQ(7U, added);
+  EXPECT_EQ(2U, duplicate);
+  /* Tablespace 8 was dropped after the base clone */
+  EXPECT_EQ(1U, skipped);
+
+  /* Sorted by tablespace and page, as copied */
+  std::vector<std::pair<space_id_t, page_no_t>> selected;
+  for (const auto &page : page_set) {
+    selected.emplace_back(page.m_space_id, page.m_page_no);
+  }
+
+  const std::vector<std::pair<space_id_t, page_no_t>> expected = {
+      {0, 7}, {5, 3}, {5, 10}, {5, 11}, {7, 0}, {7, 4}, {12, 2}};
+  EXPECT_EQ(expected, selected);
+
+  /* The kept files get no file chunks: modified pages of tablespaces
+  0, 5 and 7 come from the page copy alone. Tablespace 12 is copied in
+  full, its tracked page is sent again during page copy. */
+  for (const auto &page : selected) {
+    EXPECT_EQ(page.first != 12,
+              clone_incremental_keeps_file(BASE_LSN, BASE_SPACE_ID,
+                                           page.first));
+  }
+}
+
+}  // namespace innodb_clone0snapshot_unittest
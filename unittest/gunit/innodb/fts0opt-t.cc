@@ -0,0 +1,59 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include "storage/innobase/include/fts0fts.h"
+
+namespace innodb_fts0opt_unittest {
+
+/* test fts_optimize_throttle_delay() without a limit */
+TEST(fts0opt, throttle_unlimited) {
+  EXPECT_EQ(0, fts_optimize_throttle_delay(1000, 500, 0, 1000));
+}
+
+/* test fts_optimize_throttle_delay() below and above the rate */
+TEST(fts0opt, throttle_rate) {
+  /* 10 words a second: the 5th word is due 500 ms into the window */
+  EXPECT_EQ(500, fts_optimize_throttle_delay(1000, 5, 10, 1000));
+  EXPECT_EQ(100, fts_optimize_throttle_delay(1000, 5, 10, 1400));
+  EXPECT_EQ(0, fts_optimize_throttle_delay(1000, 5, 10, 1500));
+  EXPECT_EQ(0, fts_optimize_throttle_delay(1000, 5, 10, 2000));
+
+  /* Faster than 1000 words a second: due within the same millisecond */
+  EXPECT_EQ(0, fts_optimize_throttle_delay(1000, 1, 5000, 1000));
+  EXPECT_EQ(1, fts_optimize_throttle_delay(1000, 5, 5000, 1000));
+}
+
+/* test fts_optimize_throttle_delay() with times that are not positive */
+TEST(fts0opt, throttle_signed) {
+  EXPECT_EQ(500, fts_optimize_throttle_delay(-1000, 5, 10, -1000));
+  EXPECT_EQ(0, fts_optimize_throttle_delay(-1000, 5, 10, 0));
+  EXPECT_EQ(1000, fts_optimize_throttle_delay(0, 10, 10, 0));
+}
+
+}  // namespace innodb_fts0opt_unittest
@@ -0,0 +1,192 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <zlib.h>
+#include <vector>
+
+#include "storage/innobase/include/lob0compress.h"
+#include "storage/innobase/include/mem0mem.h"
+#include "storage/innobase/include/os0event.h"
+#include "storage/innobase/include/srv0srv.h"
+#include "storage/innobase/include/univ.i"
+#include "storage/innobase/include/ut0rnd.h"
+
+namespace innodb_lob0compress_unittest {
+
+class lob0compress : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    srv_max_n_threads = srv_sync_array_size + 1;
+    os_event_global_init();
+    sync_check_init(srv_max_n_threads);
+  }
+  static void TearDownTestCase() {
+    sync_check_close();
+    os_event_global_destroy();
+  }
+  void SetUp() override { m_heap = mem_heap_create(1024); }
+  void TearDown() override { mem_heap_free(m_heap); }
+
+  /* Compress and decompress a value and check that it comes back
+  unchanged. Returns the header byte of the stored value. */
+  byte round_trip(const std::vector<byte> &value, ulint level) {
+    ulint stored_len;
+    const byte *stored = lob::compress_column(value.data(), value.size(),
+                                              level, m_heap, &stored_len);
+    EXPECT_GE(stored_len, 1U);
+    EXPECT_LE(stored_len, value.size() + 1);
+
+    ulint len;
+    const byte *data = lob::decompress_column(stored, stored_len, m_heap, &len);
+    EXPECT_EQ(value.size(), len);
+    EXPECT_EQ(0, memcmp(value.data(), data, len));
+    return stored[0];
+  }
+
+  mem_heap_t *m_heap;
+};
+
+/* Lengths around the compression threshold, the LOB page size and the
+zstd block size. */
+static const ulint lengths[] = {0,
+                                1,
+                                lob::COMPRESS_MIN_LEN - 1,
+                                lob::COMPRESS_MIN_LEN,
+                                lob::COMPRESS_MIN_LEN + 1,
+                                16383,
+                                16384,
+                                16385,
+                                131071,
+                                131072,
+                                131073,
+                                1048576 + 7};
+
+static std::vector<byte> text_value(ulint len) {
+  std::vector<byte> value(len);
+  for (ulint i = 0; i < len; ++i) {
+    value[i] = static_cast<byte>("abcdefgh"[i % 8] + (i / 4096) % 4);
+  }
+  return value;
+}
+
+static std::vector<byte> random_value(ulint len) {
+  std::vector<byte> value(len);
+  ulint rnd = 12345;
+  for (ulint i = 0; i < len; ++i) {
+    rnd = ut_rnd_gen_next_ulint(rnd);
+    value[i] = static_cast<byte>(rnd);
+  }
+  return value;
+}
+
+/* test compress_column() and decompress_column() on compressible values */
+TEST_F(lob0compress, round_trip_text) {
+  for (ulint len : lengths) {
+    SCOPED_TRACE(len);
+    byte header = round_trip(text_value(len), lob::COMPRESS_DEFAULT_LEVEL);
+    EXPECT_EQ(len < lob::COMPRESS_MIN_LEN ? lob::COMPRESS_NONE
+                                          : lob::COMPRESS_ZSTD,
+              header);
+  }
+}
+
+/* test that values which do not shrink are stored raw */
+TEST_F(lob0compress, round_trip_random) {
+  for (ulint len : lengths) {
+    SCOPED_TRACE(len);
+    EXPECT_EQ(lob::COMPRESS_NONE,
+              round_trip(random_value(len), lob::COMPRESS_DEFAULT_LEVEL));
+  }
+}
+
+/* test the lowest and the highest compression level */
+TEST_F(lob0compress, round_trip_levels) {
+  const std::vector<byte> value = text_value(65536);
+  EXPECT_EQ(lob::COMPRESS_ZSTD, round_trip(value, 1));
+  EXPECT_EQ(lob::COMPRESS_ZSTD, round_trip(value, lob::COMPRESS_MAX_LEVEL));
+}
+
+/* test that the header byte selects the format: a raw value that holds a
+zlib stream, as written by an application or an older column, is returned
+as it is, not inflated or passed to zstd */
+TEST_F(lob0compress, dispatch_raw_zlib) {
+  const std::vector<byte> value = text_value(16384);
+  uLongf zlen = compressBound(value.size());
+  std::vector<byte> stored(zlen + 1);
+  ASSERT_EQ(Z_OK, compress(stored.data() + 1, &zlen, value.data(),
+                           value.size()));
+  stored[0] = lob::COMPRESS_NONE;
+  stored.resize(zlen + 1);
+
+  ulint len;
+  const byte *data =
+      lob::decompress_column(stored.data(), stored.size(), m_heap, &len);
+  EXPECT_EQ(zlen, len);
+  EXPECT_EQ(stored.data() + 1, data);
+}
+
+/* test that a value compressed at one level is read back after the column
+level changed, since the level is not part of the stored format */
+TEST_F(lob0compress, dispatch_level_change) {
+  const std::vector<byte> value = text_value(131073);
+  ulint stored_len;
+  const byte *stored = lob::compress_column(value.data(), value.size(), 19,
+                                            m_heap, &stored_len);
+  ASSERT_EQ(lob::COMPRESS_ZSTD, stored[0]);
+
+  ulint len;
+  const byte *data = lob::decompress_column(stored, stored_len, m_heap, &len);
+  ASSERT_EQ(value.size(), len);
+  EXPECT_EQ(0, memcmp(value.data(), data, len));
+}
+
+/* test that an unknown header or a truncated frame reads as empty */
+TEST_F(lob0compress, dispatch_corrupted) {
+  const std::vector<byte> value = text_value(16384);
+  ulint stored_len;
+  byte *stored = lob::compress_column(value.data(), value.size(),
+                                      lob::COMPRESS_DEFAULT_LEVEL, m_heap,
+                                      &stored_len);
+  ASSERT_EQ(lob::COMPRESS_ZSTD, stored[0]);
+
+  ulint len = 1;
+  lob::decompress_column(stored, stored_len - 1, m_heap, &len);
+  EXPECT_EQ(0U, len);
+
+  stored[0] = 2;
+  len = 1;
+  lob::decompress_column(stored, stored_len, m_heap, &len);
+  EXPECT_EQ(0U, len);
+
+  len = 1;
+  lob::decompress_column(stored, 0, m_heap, &len);
+  EXPECT_EQ(0U, len);
+}
+
+}  // namespace innodb_lob0compress_unittest
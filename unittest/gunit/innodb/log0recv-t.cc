@@ -0,0 +1,125 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "storage/innobase/include/log0recv.h"
+
+namespace innodb_log0recv_unittest {
+
+using Page = std::pair<space_id_t, page_no_t>;
+using Batch = std::map<Page, std::vector<lsn_t>>;
+
+/** Log records of a batch, per page in LSN order like in recv_sys */
+static Batch make_batch() {
+  Batch batch;
+  std::mt19937 rnd(42);
+
+  for (lsn_t lsn = 8192; lsn < 8192 + 50000 * 16; lsn += 16) {
+    const space_id_t space_id = rnd() % 8;
+    const page_no_t page_no = rnd() % 4096;
+    batch[Page(space_id, page_no)].push_back(lsn);
+  }
+
+  return batch;
+}
+
+/* test recv_apply_n_threads() */
+TEST(log0recv, apply_n_threads) {
+  EXPECT_EQ(1U, recv_apply_n_threads(0, 4));
+  EXPECT_EQ(1U, recv_apply_n_threads(RECV_APPLY_MIN_PAGES * 2 - 1, 4));
+  EXPECT_EQ(2U, recv_apply_n_threads(RECV_APPLY_MIN_PAGES * 2, 4));
+  EXPECT_EQ(4U, recv_apply_n_threads(RECV_APPLY_MIN_PAGES * 100, 4));
+  EXPECT_EQ(1U, recv_apply_n_threads(RECV_APPLY_MIN_PAGES * 100, 1));
+}
+
+/* test that recv_apply_partition() keeps read-ahead areas together */
+TEST(log0recv, apply_partition_areas) {
+  for (ulint n_parts : {1, 2, 3, 4, 64}) {
+    for (space_id_t space_id = 0; space_id < 4; ++space_id) {
+      for (page_no_t page_no = 0; page_no < 1024; ++page_no) {
+        const ulint part = recv_apply_partition(space_id, page_no, n_parts);
+        EXPECT_LT(part, n_parts);
+
+        const page_no_t first = page_no - page_no % RECV_READ_AHEAD_AREA;
+        EXPECT_EQ(recv_apply_partition(space_id, first, n_parts), part);
+      }
+    }
+  }
+}
+
+/* test that the records of each page are applied in LSN order whatever
+the number of apply threads */
+TEST(log0recv, apply_partition_lsn_order) {
+  const auto batch = make_batch();
+
+  for (ulint n_threads : {1, 2, 4, 7, 64}) {
+    /* Pages of each thread, partitioned like recv_apply_hashed_log_recs()
+    does */
+    std::vector<std::vector<const Batch::value_type *>> parts(n_threads);
+
+    for (const auto &page : batch) {
+      const ulint part = recv_apply_partition(page.first.first,
+                                              page.first.second, n_threads);
+      parts[part].push_back(&page);
+    }
+
+    /* Records applied to each page, in the order they were applied. A
+    page is only ever touched by the thread of its partition. */
+    Batch applied;
+    for (const auto &page : batch) applied[page.first];
+
+    std::vector<std::thread> threads;
+    for (ulint t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&, t] {
+        for (auto page : parts[t]) {
+          auto &page_applied = applied.find(page->first)->second;
+          for (lsn_t lsn : page->second) page_applied.push_back(lsn);
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+
+    size_t n_pages = 0;
+    for (const auto &part : parts) n_pages += part.size();
+    EXPECT_EQ(batch.size(), n_pages);
+
+    for (const auto &page : batch) {
+      const auto &page_applied = applied[page.first];
+      EXPECT_EQ(page.second, page_applied);
+      EXPECT_TRUE(std::is_sorted(page_applied.begin(), page_applied.end()));
+    }
+  }
+}
+
+}  // namespace innodb_log0recv_unittest
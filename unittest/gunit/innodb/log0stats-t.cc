@@ -0,0 +1,76 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+
+#include "storage/innobase/include/log0stats.h"
+
+namespace innodb_log0stats_unittest {
+
+/* test Log_histogram::bucket_for() */
+TEST(log0stats, bucket_for) {
+  EXPECT_EQ(0U, Log_histogram::bucket_for(0));
+  EXPECT_EQ(1U, Log_histogram::bucket_for(1));
+  EXPECT_EQ(2U, Log_histogram::bucket_for(2));
+  EXPECT_EQ(2U, Log_histogram::bucket_for(3));
+  EXPECT_EQ(13U, Log_histogram::bucket_for(4096));
+  EXPECT_EQ(Log_histogram::N_BUCKETS - 1,
+            Log_histogram::bucket_for(UINT64_MAX));
+
+  for (size_t bucket = 1; bucket < Log_histogram::N_BUCKETS - 1; ++bucket) {
+    const uint64_t upper = Log_histogram::upper_bound(bucket);
+    EXPECT_EQ(bucket, Log_histogram::bucket_for(upper - 1));
+    EXPECT_EQ(bucket + 1, Log_histogram::bucket_for(upper));
+  }
+}
+
+/* test Log_histogram::add() and Log_histogram::add_time() */
+TEST(log0stats, add) {
+  Log_histogram histogram;
+
+  histogram.add(0);
+  histogram.add(512);
+  histogram.add(1000);
+
+  EXPECT_EQ(1U, histogram.count(0));
+  EXPECT_EQ(2U, histogram.count(10));
+  EXPECT_EQ(1512U, histogram.sum());
+
+  /* Time moved backward is registered as zero. */
+  const auto now = Log_clock::now();
+  histogram.add_time(now, now - std::chrono::seconds{1});
+  EXPECT_EQ(2U, histogram.count(0));
+
+  histogram.add_time(now, now + std::chrono::microseconds{100});
+  EXPECT_EQ(1U, histogram.count(7));
+
+  histogram.reset();
+  EXPECT_EQ(0U, histogram.count(0));
+  EXPECT_EQ(0U, histogram.sum());
+}
+
+}  // namespace innodb_log0stats_unittest
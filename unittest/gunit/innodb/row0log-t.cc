@@ -0,0 +1,201 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/innobase/include/mach0data.h"
+#include "storage/innobase/include/row0log.h"
+
+namespace innodb_row0log_unittest {
+
+/** Operations of the table rebuild log */
+enum Op { INSERT, UPDATE, DELETE };
+
+/** A log record: the PRIMARY KEY (INT, VARBINARY), stored like in the
+log, and the operation with its new value */
+struct Record {
+  byte id[4];
+  std::string name;
+  Op op;
+  int value;
+  ulint size;
+};
+
+using Key = std::string;
+
+/** State of a row, and the log records applied to it in order */
+struct Row {
+  bool exists{false};
+  int value{0};
+  std::vector<size_t> applied;
+};
+
+using Table = std::map<Key, Row>;
+
+static Key key_of(const Record &rec) {
+  return Key(reinterpret_cast<const char *>(rec.id), sizeof rec.id) + '/' +
+         rec.name;
+}
+
+/** Partition of a record, like row_log_table_part() */
+static ulint part_of(const Record &rec, ulint n_parts) {
+  ulint fold = row_log_table_fold_field(0, rec.id, sizeof rec.id);
+  fold = row_log_table_fold_field(
+      fold, reinterpret_cast<const byte *>(rec.name.data()), rec.name.size());
+  return (fold % n_parts);
+}
+
+/** A log of inserts, updates and deletes of a few hundred rows, each
+operation valid for the row state left by the preceding ones */
+static std::vector<Record> make_log() {
+  std::vector<Record> log;
+  std::map<Key, bool> exists;
+  std::mt19937 rnd(42);
+
+  for (int i = 0; i < 20000; i++) {
+    Record rec;
+    const uint32_t id = rnd() % 100;
+    /* Signed INT as stored: big-endian with the sign bit flipped */
+    mach_write_to_4(rec.id, id ^ 0x80000000);
+    rec.name = std::string(rnd() % 4, 'a' + id % 3);
+    rec.value = i;
+    rec.size = 16 + rec.name.size() + rnd() % 100;
+
+    bool &row_exists = exists[key_of(rec)];
+    rec.op = !row_exists ? INSERT : (rnd() % 4 == 0 ? DELETE : UPDATE);
+    row_exists = rec.op != DELETE;
+
+    log.push_back(rec);
+  }
+
+  return log;
+}
+
+/** Apply a log record; returns false if it does not fit the row */
+static bool apply(Row &row, const Record &rec, size_t pos) {
+  switch (rec.op) {
+    case INSERT:
+      if (row.exists) return (false);
+      row.exists = true;
+      break;
+    case UPDATE:
+      if (!row.exists) return (false);
+      break;
+    case DELETE:
+      if (!row.exists) return (false);
+      row.exists = false;
+      break;
+  }
+  row.value = rec.value;
+  row.applied.push_back(pos);
+  return (true);
+}
+
+/* test that keys stored alike pick the same partition, and that every
+partition is used */
+TEST(row0log, table_part) {
+  const auto log = make_log();
+
+  for (ulint n_parts : {1, 2, 4, 7}) {
+    std::map<Key, ulint> parts;
+    std::vector<ulint> n_rows(n_parts);
+
+    for (const auto &rec : log) {
+      const ulint part = part_of(rec, n_parts);
+      EXPECT_LT(part, n_parts);
+
+      auto it = parts.emplace(key_of(rec), part);
+      EXPECT_EQ(it.first->second, part);
+      if (it.second) n_rows[part]++;
+    }
+
+    for (ulint rows : n_rows) EXPECT_LT(0U, rows);
+  }
+}
+
+/* test that applying the log on several threads, each one parsing all of
+the records and applying those of its partition like
+row_log_table_apply_part() does, gives the result of the serial apply */
+TEST(row0log, table_apply_parts) {
+  const auto log = make_log();
+
+  Table serial;
+  ulonglong serial_total = 0;
+  for (size_t pos = 0; pos < log.size(); pos++) {
+    serial_total += log[pos].size;
+    ASSERT_TRUE(apply(serial[key_of(log[pos])], log[pos], pos));
+  }
+
+  for (ulint n_parts : {1, 2, 4, 7}) {
+    /* Every row is touched only by the thread of its partition */
+    Table table;
+    for (const auto &rec : log) table[key_of(rec)];
+
+    std::vector<ulonglong> totals(n_parts);
+    std::vector<int> failed(n_parts);
+
+    std::vector<std::thread> threads;
+    for (ulint part = 0; part < n_parts; part++) {
+      threads.emplace_back([&, part] {
+        for (size_t pos = 0; pos < log.size(); pos++) {
+          const Record &rec = log[pos];
+          totals[part] += rec.size;
+
+          if (n_parts > 1 && part_of(rec, n_parts) != part) {
+            continue;
+          }
+
+          if (!apply(table.find(key_of(rec))->second, rec, pos)) {
+            failed[part] = true;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) thread.join();
+
+    /* Every thread parsed the same records */
+    for (ulint part = 0; part < n_parts; part++) {
+      EXPECT_FALSE(failed[part]);
+      EXPECT_EQ(serial_total, totals[part]);
+    }
+
+    ASSERT_EQ(serial.size(), table.size());
+    for (const auto &row : serial) {
+      const Row &parallel = table[row.first];
+      EXPECT_EQ(row.second.exists, parallel.exists);
+      EXPECT_EQ(row.second.value, parallel.value);
+      EXPECT_EQ(row.second.applied, parallel.applied);
+    }
+  }
+}
+
+}  // namespace innodb_row0log_unittest
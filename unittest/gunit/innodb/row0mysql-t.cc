@@ -0,0 +1,234 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/* See http://code.google.com/p/googletest/wiki/Primer */
+
+// First include (the generated) my_config.h, to get correct platform defines.
+#include "my_config.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/innobase/include/row0mysql.h"
+
+namespace innodb_row0mysql_unittest {
+
+/** A column value as stored in a record, or SQL NULL */
+struct Value {
+  byte data[8];
+  ulint len;
+};
+
+/** Store an integer like row_mysql_store_col_in_innobase_format() does:
+big-endian, with the sign bit flipped if the column is signed */
+static Value store(uint64_t value, ulint len, bool is_unsigned) {
+  Value stored;
+  stored.len = len;
+  for (ulint i = len; i-- > 0; value >>= 8) {
+    stored.data[i] = static_cast<byte>(value);
+  }
+  if (!is_unsigned) {
+    stored.data[0] ^= 0x80;
+  }
+  return (stored);
+}
+
+/** The records of a clustered index, one column of them */
+static std::vector<Value> make_column(ulint len, bool is_unsigned,
+                                      uint64_t min, uint64_t max) {
+  std::vector<Value> column;
+  std::mt19937_64 rnd(len * 2 + is_unsigned);
+  std::uniform_int_distribution<uint64_t> dist(min, max);
+
+  for (int i = 0; i < 100000; i++) {
+    if (rnd() % 10 == 0) {
+      column.push_back(Value{{}, UNIV_SQL_NULL});
+    } else {
+      column.push_back(store(dist(rnd), len, is_unsigned));
+    }
+  }
+
+  /* The extremes */
+  column.push_back(store(min, len, is_unsigned));
+  column.push_back(store(max, len, is_unsigned));
+
+  return (column);
+}
+
+/** Add up a column on one thread, reading it in order */
+static Column_aggregate serial_aggregate(const std::vector<Value> &column,
+                                         bool is_unsigned) {
+  Column_aggregate total;
+  for (const auto &value : column) {
+    if (value.len != UNIV_SQL_NULL) {
+      ++total.m_n_not_null;
+      total.add_value(value.data, value.len, is_unsigned);
+    }
+  }
+  return (total);
+}
+
+/** Add up a column like row_mysql_parallel_column_aggregate() does: every
+thread adds the ranges it reads to its own partial, and the partials are
+merged at the end */
+static Column_aggregate parallel_aggregate(const std::vector<Value> &column,
+                                           bool is_unsigned,
+                                           size_t n_threads) {
+  std::vector<Column_aggregate> partials(n_threads);
+  std::vector<std::thread> threads;
+
+  /* Ranges of 1000 records are handed out round robin */
+  const size_t range = 1000;
+
+  for (size_t t = 0; t < n_threads; t++) {
+    threads.emplace_back([&, t] {
+      auto &partial = partials[t];
+      for (size_t start = t * range; start < column.size();
+           start += n_threads * range) {
+        for (size_t i = start; i < std::min(start + range, column.size());
+             i++) {
+          if (column[i].len != UNIV_SQL_NULL) {
+            ++partial.m_n_not_null;
+            partial.add_value(column[i].data, column[i].len, is_unsigned);
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  Column_aggregate total;
+  for (const auto &partial : partials) {
+    total.merge(partial);
+  }
+  return (total);
+}
+
+static void check_column(const std::vector<Value> &column, bool is_unsigned) {
+  const auto serial = serial_aggregate(column, is_unsigned);
+
+  for (size_t n_threads : {1, 2, 4, 7, 16}) {
+    const auto parallel = parallel_aggregate(column, is_unsigned, n_threads);
+    EXPECT_EQ(serial.m_n_not_null, parallel.m_n_not_null) << n_threads;
+    EXPECT_EQ(serial.m_low, parallel.m_low) << n_threads;
+    EXPECT_EQ(serial.m_high, parallel.m_high) << n_threads;
+  }
+}
+
+/* test the values of the integer types as stored */
+TEST(row0mysql, column_aggregate_value) {
+  const struct {
+    uint64_t value;
+    ulint len;
+    bool is_unsigned;
+    uint64_t low;
+    int64_t high;
+  } cases[] = {
+      {0, 1, false, 0, 0},
+      {static_cast<uint64_t>(-128), 1, false, static_cast<uint64_t>(-128), -1},
+      {255, 1, true, 255, 0},
+      {static_cast<uint64_t>(-1), 2, false, ~0ULL, -1},
+      {8388607, 3, false, 8388607, 0},
+      {static_cast<uint64_t>(INT32_MIN), 4, false,
+       static_cast<uint64_t>(INT32_MIN), -1},
+      {UINT32_MAX, 4, true, UINT32_MAX, 0},
+      {static_cast<uint64_t>(INT64_MIN), 8, false,
+       static_cast<uint64_t>(INT64_MIN), -1},
+      {UINT64_MAX, 8, true, UINT64_MAX, 0},
+  };
+
+  for (const auto &c : cases) {
+    const Value stored = store(c.value, c.len, c.is_unsigned);
+    Column_aggregate sum;
+    sum.add_value(stored.data, stored.len, c.is_unsigned);
+    EXPECT_EQ(c.low, sum.m_low);
+    EXPECT_EQ(c.high, sum.m_high);
+  }
+}
+
+/* test that the 128 bit sum carries and borrows */
+TEST(row0mysql, column_aggregate_carry) {
+  const Value max = store(UINT64_MAX, 8, true);
+  Column_aggregate sum;
+  for (int i = 0; i < 3; i++) {
+    sum.add_value(max.data, max.len, true);
+  }
+  /* 3 * (2^64 - 1) = 2 * 2^64 + (2^64 - 3) */
+  EXPECT_EQ(UINT64_MAX - 2, sum.m_low);
+  EXPECT_EQ(2, sum.m_high);
+
+  const Value min = store(static_cast<uint64_t>(INT64_MIN), 8, false);
+  sum = Column_aggregate{};
+  for (int i = 0; i < 4; i++) {
+    sum.add_value(min.data, min.len, false);
+  }
+  /* 4 * -2^63 = -2 * 2^64 */
+  EXPECT_EQ(0U, sum.m_low);
+  EXPECT_EQ(-2, sum.m_high);
+
+  /* Back to 0 */
+  const Value one = store(1, 8, false);
+  const Value minus_one = store(static_cast<uint64_t>(-1), 8, false);
+  sum = Column_aggregate{};
+  sum.add_value(minus_one.data, minus_one.len, false);
+  sum.add_value(one.data, one.len, false);
+  EXPECT_EQ(0U, sum.m_low);
+  EXPECT_EQ(0, sum.m_high);
+}
+
+/* test the parallel sums of columns against the serial sum */
+TEST(row0mysql, column_aggregate_parallel) {
+  check_column(make_column(1, false, static_cast<uint64_t>(-128), 127),
+               false);
+  check_column(make_column(2, true, 0, UINT16_MAX), true);
+  check_column(make_column(4, false, static_cast<uint64_t>(INT32_MIN),
+                           INT32_MAX),
+               false);
+  check_column(make_column(8, true, UINT64_MAX / 2, UINT64_MAX), true);
+}
+
+/* test signed BIGINT columns, whose sum passes 64 bits both ways */
+TEST(row0mysql, column_aggregate_parallel_bigint) {
+  auto column = make_column(8, false, static_cast<uint64_t>(INT64_MIN), 0);
+  check_column(column, false);
+
+  const auto serial = serial_aggregate(column, false);
+  EXPECT_GT(0, serial.m_high);
+
+#ifdef __SIZEOF_INT128__
+  /* The sum in 128 bits, with the values read back */
+  __int128 expected = 0;
+  for (const auto &value : column) {
+    if (value.len != UNIV_SQL_NULL) {
+      expected += static_cast<int64_t>(
+          mach_read_int_type(value.data, value.len, false));
+    }
+  }
+  const auto total = parallel_aggregate(column, false, 4);
+  EXPECT_EQ(static_cast<uint64_t>(expected), total.m_low);
+  EXPECT_EQ(static_cast<int64_t>(expected >> 64), total.m_high);
+#endif /* __SIZEOF_INT128__ */
+}
+
+}  // namespace innodb_row0mysql_unittest
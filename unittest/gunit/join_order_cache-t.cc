@@ -0,0 +1,188 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <map>
+
+#include "my_alloc.h"
+#include "sql/item.h"
+#include "sql/sql_class.h"
+#include "sql/sql_const.h"
+#include "sql/sql_lex.h"
+#include "sql/sql_planner.h"
+#include "unittest/gunit/test_utils.h"
+
+namespace join_order_cache_unittest {
+
+using my_testing::Server_initializer;
+
+class JoinOrderCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    m_initializer.SetUp();
+    m_rows = {{0, 100}, {1, 1000}, {2, 10}};
+  }
+  void TearDown() override { m_initializer.TearDown(); }
+
+  THD *thd() { return m_initializer.thd(); }
+
+  /* Adds a statement parameter, as owned by thd()->free_list */
+  Item_param *add_param() {
+    Item_param *param = new Item_param(POS(), thd()->mem_root, 0);
+    thd()->lex->param_list.push_back(param);
+    return param;
+  }
+
+  /* Caches the order 2, 0, 1 with the current row counts */
+  void add_order(ulonglong shape) {
+    Join_order_cache::Entry *entry = m_cache.add(&m_mem_root, 3);
+    ASSERT_NE(nullptr, entry);
+    entry->const_tables = 0;
+    entry->allow_outer_refs = false;
+    entry->shape = shape;
+    entry->table_count = 3;
+    uint order[] = {2, 0, 1};
+    for (uint i = 0; i < 3; i++) {
+      entry->order[i] = order[i];
+      entry->records[i] = m_rows[order[i]];
+    }
+  }
+
+  /* Looks the order up as use_cached_join_order() does */
+  const Join_order_cache::Entry *find(ulonglong shape) {
+    return m_cache.find(shape, 0, false, 3,
+                        [this](const Join_order_cache::Entry &entry) {
+                          for (uint i = 0; i < entry.table_count; i++)
+                            if (!Join_order_cache::similar_row_count(
+                                    entry.records[i], m_rows[entry.order[i]]))
+                              return false;
+                          return true;
+                        });
+  }
+
+  Server_initializer m_initializer;
+  MEM_ROOT m_mem_root{PSI_NOT_INSTRUMENTED, 1024};
+  Join_order_cache m_cache;
+  /* Current row count of each table */
+  std::map<uint, ha_rows> m_rows;
+};
+
+TEST_F(JoinOrderCacheTest, SameShape) {
+  Item_param *a = add_param();
+  Item_param *b = add_param();
+  a->set_int(longlong{5});
+  b->set_double(2.5);
+  const ulonglong shape = Join_order_cache::parameter_shape(thd());
+  add_order(shape);
+
+  /* Other values of the same magnitude */
+  a->set_int(longlong{6});
+  b->set_double(3.5);
+  EXPECT_EQ(shape, Join_order_cache::parameter_shape(thd()));
+  const Join_order_cache::Entry *entry = find(shape);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(2U, entry->order[0]);
+  EXPECT_EQ(0U, entry->order[1]);
+  EXPECT_EQ(1U, entry->order[2]);
+}
+
+TEST_F(JoinOrderCacheTest, DifferentShape) {
+  Item_param *a = add_param();
+  a->set_int(longlong{5});
+  const ulonglong shape = Join_order_cache::parameter_shape(thd());
+  add_order(shape);
+
+  a->set_int(longlong{5000});
+  EXPECT_NE(shape, Join_order_cache::parameter_shape(thd()));
+  EXPECT_EQ(nullptr, find(Join_order_cache::parameter_shape(thd())));
+  a->set_int(longlong{-5});
+  EXPECT_NE(shape, Join_order_cache::parameter_shape(thd()));
+  a->set_double(5.0);
+  EXPECT_NE(shape, Join_order_cache::parameter_shape(thd()));
+  a->set_null();
+  EXPECT_NE(shape, Join_order_cache::parameter_shape(thd()));
+
+  /* The same parameters find the order again */
+  a->set_int(longlong{7});
+  EXPECT_EQ(shape, Join_order_cache::parameter_shape(thd()));
+  EXPECT_NE(nullptr, find(shape));
+
+  /* The key also covers the const tables and the table count */
+  EXPECT_EQ(nullptr,
+            m_cache.find(shape, 8, false, 3,
+                         [](const Join_order_cache::Entry &) { return true; }));
+  EXPECT_EQ(nullptr,
+            m_cache.find(shape, 0, false, 4,
+                         [](const Join_order_cache::Entry &) { return true; }));
+}
+
+TEST_F(JoinOrderCacheTest, OptimizerSwitch) {
+  add_param()->set_int(longlong{5});
+  const ulonglong shape = Join_order_cache::parameter_shape(thd());
+  add_order(shape);
+
+  const ulonglong optimizer_switch = thd()->variables.optimizer_switch;
+  thd()->variables.optimizer_switch ^= OPTIMIZER_SWITCH_INDEX_MERGE;
+  EXPECT_NE(shape, Join_order_cache::parameter_shape(thd()));
+  EXPECT_EQ(nullptr, find(Join_order_cache::parameter_shape(thd())));
+
+  thd()->variables.optimizer_switch = optimizer_switch;
+  EXPECT_EQ(shape, Join_order_cache::parameter_shape(thd()));
+  EXPECT_NE(nullptr, find(shape));
+}
+
+TEST_F(JoinOrderCacheTest, TableGrows) {
+  add_order(42);
+
+  /* Up to twice the rows plus one */
+  m_rows[1] = 2001;
+  EXPECT_NE(nullptr, find(42));
+  m_rows[1] = 2002;
+  EXPECT_EQ(nullptr, find(42));
+
+  /* ... and the other way */
+  m_rows[1] = 1000;
+  m_rows[0] = 50;
+  EXPECT_NE(nullptr, find(42));
+  m_rows[0] = 49;
+  EXPECT_EQ(nullptr, find(42));
+
+  /* An order chosen for the new row counts is found instead */
+  add_order(42);
+  const Join_order_cache::Entry *entry = find(42);
+  ASSERT_NE(nullptr, entry);
+  EXPECT_EQ(49U, entry->records[1]);
+}
+
+TEST_F(JoinOrderCacheTest, ReplaceOldest) {
+  for (ulonglong shape = 1; shape <= Join_order_cache::MAX_ENTRIES; shape++)
+    add_order(shape);
+  for (ulonglong shape = 1; shape <= Join_order_cache::MAX_ENTRIES; shape++)
+    EXPECT_NE(nullptr, find(shape)) << shape;
+
+  add_order(100);
+  EXPECT_EQ(nullptr, find(1));
+  EXPECT_NE(nullptr, find(2));
+  EXPECT_NE(nullptr, find(100));
+}
+
+}  // namespace join_order_cache_unittest
@@ -30,6 +30,7 @@
 #include "sql/error_handler.h"
 #include "sql/json_binary.h"
 #include "sql/json_dom.h"
+#include "sql/json_path.h"
 #include "sql/sql_class.h"
 #include "sql/sql_time.h"
 #include "sql_string.h"
@@ -746,6 +747,102 @@ TEST_F(JsonBinaryTest, StringLengthTest) {
   serialize_deserialize_string(thd, 3000000);
 }
 
+static Json_path parse_member_path(const char *path_text) {
+  Json_path path;
+  size_t bad_index;
+  EXPECT_FALSE(parse_path(strlen(path_text), path_text, &path, &bad_index));
+  return path;
+}
+
+/**
+  Project a serialized document through a reader that records how many
+  bytes were read, and check that the result matches the expected document.
+*/
+static void check_projection(const THD *thd, const Projection &projection,
+                             const String &doc, const char *expected,
+                             size_t *bytes_read) {
+  *bytes_read = 0;
+  const Projection::Range_reader reader = [&](size_t offset, size_t length,
+                                              char *dest) {
+    EXPECT_LE(offset + length, doc.length());
+    memcpy(dest, doc.ptr() + offset, length);
+    *bytes_read += length;
+    return false;
+  };
+
+  String projected;
+  EXPECT_FALSE(projection.project(thd, reader, doc.length(), &projected));
+
+  String expected_binary;
+  EXPECT_FALSE(serialize(thd, parse_json(expected).get(), &expected_binary));
+  EXPECT_EQ(std::string(expected_binary.ptr(), expected_binary.length()),
+            std::string(projected.ptr(), projected.length()));
+}
+
+TEST_F(JsonBinaryTest, ProjectionTest) {
+  const THD *thd = this->thd();
+
+  Projection projection;
+  EXPECT_TRUE(projection.add_path(parse_member_path("$")));
+  EXPECT_TRUE(projection.add_path(parse_member_path("$[0]")));
+  EXPECT_TRUE(projection.add_path(parse_member_path("$.*")));
+  EXPECT_TRUE(projection.add_path(parse_member_path("$.a**.b")));
+  EXPECT_FALSE(projection.add_path(parse_member_path("$.nested.b")));
+  EXPECT_FALSE(projection.add_path(parse_member_path("$.status")));
+  EXPECT_FALSE(projection.add_path(parse_member_path("$.missing.x")));
+  EXPECT_FALSE(projection.add_path(parse_member_path("$.id.x")));
+
+  // Small and large storage formats.
+  for (size_t padding : {1000U, 100000U}) {
+    Json_object object;
+    object.add_alias("id", create_dom_ptr<Json_int>(1));
+    object.add_alias("status", create_dom_ptr<Json_string>("active"));
+    object.add_alias("padding",
+                     create_dom_ptr<Json_string>(std::string(padding, 'x')));
+    Json_object_ptr nested = create_dom_ptr<Json_object>();
+    nested->add_alias("a", parse_json("[1, 2, 3]"));
+    nested->add_alias("b", create_dom_ptr<Json_double>(2.5));
+    object.add_alias("nested", std::move(nested));
+
+    String doc;
+    EXPECT_FALSE(serialize(thd, &object, &doc));
+
+    size_t bytes_read;
+    check_projection(thd, projection, doc,
+                     "{\"status\": \"active\", \"nested\": {\"b\": 2.5}}",
+                     &bytes_read);
+    EXPECT_LT(bytes_read, 1000U);
+
+    // A shorter path covers the longer paths that extend it.
+    Projection covering;
+    EXPECT_FALSE(covering.add_path(parse_member_path("$.nested.a")));
+    EXPECT_FALSE(covering.add_path(parse_member_path("$.nested")));
+    EXPECT_FALSE(covering.add_path(parse_member_path("$.id")));
+    check_projection(thd, covering, doc,
+                     "{\"id\": 1, \"nested\": {\"a\": [1, 2, 3], \"b\": 2.5}}",
+                     &bytes_read);
+    EXPECT_LT(bytes_read, 1000U);
+  }
+
+  // Only objects can be projected.
+  String array;
+  EXPECT_FALSE(serialize(thd, parse_json("[1, 2]").get(), &array));
+  const Projection::Range_reader reader = [&](size_t offset, size_t length,
+                                              char *dest) {
+    memcpy(dest, array.ptr() + offset, length);
+    return false;
+  };
+  String projected;
+  EXPECT_TRUE(projection.project(thd, reader, array.length(), &projected));
+
+  // Read errors are reported.
+  const Projection::Range_reader failing_reader = [](size_t, size_t, char *) {
+    return true;
+  };
+  EXPECT_TRUE(
+      projection.project(thd, failing_reader, array.length(), &projected));
+}
+
 /**
   Error handler which registers if an error has been raised. If an error is
   raised, it asserts that the error is ER_INVALID_JSON_BINARY_DATA.
@@ -0,0 +1,458 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+/**
+  @file microbenchmarks-t.cc
+
+  Microbenchmarks of server hot paths. All inputs are synthetic and generated
+  from a fixed seed, so that every run measures the same work:
+
+  - the lexer, MYSQLlex() and so lex_one_token(), on bulk INSERT text
+  - utf8mb4 well-formed checks on ASCII and on mixed text
+  - filesort key sorting in Filesort_buffer::sort_buffer()
+  - binlog event CRC32 checks
+  - Gtid_set parsing, union, subset and difference
+  - MEM_ROOT allocation
+
+  The HashJoinIterator build and probe benchmarks of hash_join-t.cc are
+  linked into the same executable. Build and run them all, in an optimized
+  build, with
+
+    make run_microbenchmarks
+
+  which also writes the results as JSON to microbenchmarks.json in the build
+  directory (see benchmark.h), to compare a change against a baseline run.
+*/
+
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "libbinlogevents/include/binlog_event.h"
+#include "m_ctype.h"
+#include "my_alloc.h"
+#include "my_byteorder.h"
+#include "my_inttypes.h"
+#include "sql/filesort_utils.h"
+#include "sql/parse_location.h"
+#include "sql/parser_yystype.h"
+#include "sql/rpl_gtid.h"
+#include "sql/sort_param.h"
+#include "sql/sql_class.h"
+#include "sql/sql_lex.h"
+#include "unittest/gunit/benchmark.h"
+#include "unittest/gunit/test_utils.h"
+
+namespace microbenchmarks_unittest {
+
+// Seed of all the synthetic inputs.
+static const int seed = 8834245;
+
+/*
+  A multi-row INSERT of num_rows rows of an integer, a string, a decimal and
+  a datetime.
+*/
+static std::string bulk_insert_text(int num_rows) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<> distribution(0, 999999);
+  std::string text = "INSERT INTO t1 (id, name, price, created) VALUES ";
+  for (int i = 1; i <= num_rows; ++i) {
+    const int value = distribution(generator);
+    char row[128];
+    snprintf(row, sizeof(row),
+             "%s(%d, 'customer %d', %d.%02d, '2021-%02d-%02d 12:34:56')",
+             i > 1 ? ", " : "", i, value, value / 100, value % 100,
+             1 + value % 12, 1 + value % 28);
+    text += row;
+  }
+  return text;
+}
+
+/*
+  Microbenchmark of the lexer on a 1000-row INSERT. The strings and
+  identifiers it copies go to a MEM_ROOT cleared after each statement, as
+  the THD's is.
+*/
+static void BM_LexBulkInsert(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  my_testing::Server_initializer initializer;
+  initializer.SetUp();
+  THD *thd = initializer.thd();
+  const std::string text = bulk_insert_text(1000);
+
+  Parser_state state;
+  ASSERT_FALSE(state.init(thd, text.c_str(), text.length()));
+  MEM_ROOT *saved_mem_root = thd->mem_root;
+  MEM_ROOT lex_mem_root(PSI_NOT_INSTRUMENTED, 8192);
+  thd->mem_root = &lex_mem_root;
+  thd->m_parser_state = &state;
+  Lex_input_stream *lip = &state.m_lip;
+  YYSTYPE yylval;
+  YYLTYPE yylloc;
+  size_t num_tokens = 0;
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    lip->reset(text.c_str(), text.length());
+    StartBenchmarkTiming();
+    while (!lip->eof()) {
+      MYSQLlex(&yylval, &yylloc, thd);
+      ++num_tokens;
+    }
+    StopBenchmarkTiming();
+    lex_mem_root.ClearForReuse();
+  }
+
+  // ( id , 'name' , price , 'created' ) and a comma per row
+  EXPECT_GE(num_tokens, num_iterations * 1000 * 10);
+  EXPECT_FALSE(thd->is_error());
+  SetBytesProcessed(num_iterations * text.length());
+
+  thd->m_parser_state = nullptr;
+  thd->mem_root = saved_mem_root;
+  initializer.TearDown();
+}
+BENCHMARK(BM_LexBulkInsert)
+
+/*
+  num_bytes of text of words and spaces. Unless ascii_only, one character
+  in eight is a 2, 3 or 4 byte utf8mb4 sequence.
+*/
+static std::string utf8mb4_text(size_t num_bytes, bool ascii_only) {
+  static const char *const non_ascii[] = {"\xC3\xA9", "\xE4\xB8\xAD",
+                                          "\xF0\x9F\x98\x80"};
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<> distribution(0, 63);
+  std::string text;
+  while (text.length() < num_bytes) {
+    const int value = distribution(generator);
+    if (!ascii_only && value < 8)
+      text += non_ascii[value % 3];
+    else
+      text += value < 16 ? ' ' : static_cast<char>('a' + value % 26);
+  }
+  // Do not end within a multi-byte sequence
+  while (text.length() > num_bytes && (text.back() & 0xC0) == 0x80)
+    text.pop_back();
+  if ((text.back() & 0x80) != 0) text.pop_back();
+  return text;
+}
+
+static void utf8mb4_benchmark(size_t num_iterations, bool ascii_only) {
+  StopBenchmarkTiming();
+
+  const std::string text = utf8mb4_text(64 * 1024, ascii_only);
+  const CHARSET_INFO *cs = &my_charset_utf8mb4_0900_ai_ci;
+  const char *begin = text.data();
+  const char *end = begin + text.length();
+  size_t length = 0;
+  int error = 0;
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    length = cs->cset->well_formed_len(cs, begin, end, text.length(), &error);
+  }
+  StopBenchmarkTiming();
+
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(text.length(), length);
+  SetBytesProcessed(num_iterations * text.length());
+}
+
+/*
+  Microbenchmarks of checking that 64 kB of ASCII and of mixed text are
+  well-formed utf8mb4.
+*/
+static void BM_Utf8mb4WellFormedAscii(size_t num_iterations) {
+  utf8mb4_benchmark(num_iterations, /*ascii_only=*/true);
+}
+BENCHMARK(BM_Utf8mb4WellFormedAscii)
+
+static void BM_Utf8mb4WellFormedMixed(size_t num_iterations) {
+  utf8mb4_benchmark(num_iterations, /*ascii_only=*/false);
+}
+BENCHMARK(BM_Utf8mb4WellFormedMixed)
+
+/*
+  Sort 100000 records of random keys of key_length bytes, each followed by
+  an 8-byte row ID, with Filesort_buffer::sort_buffer() as filesort() does
+  when it sorts row IDs. The records are written again before each sort,
+  untimed.
+*/
+static void filesort_benchmark(size_t num_iterations, uint key_length) {
+  StopBenchmarkTiming();
+
+  const size_t num_records = 100000;
+  const uint ref_length = 8;
+  const uint record_length = key_length + ref_length;
+  std::mt19937 generator(seed);
+  std::vector<uchar> records(num_records * record_length);
+  for (uchar &byte : records) byte = static_cast<uchar>(generator());
+
+  Sort_param param;
+  param.set_max_compare_length(record_length);
+  param.set_max_record_length(record_length);
+  param.sum_ref_length = ref_length;
+  Filesort_buffer buffer;
+  buffer.set_max_size(64 * 1024 * 1024, record_length);
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    buffer.reset();
+    for (size_t r = 0; r < num_records; ++r) {
+      Bounds_checked_array<uchar> to =
+          buffer.get_next_record_pointer(record_length);
+      ASSERT_GE(to.size(), record_length);
+      memcpy(to.array(), &records[r * record_length], record_length);
+      buffer.commit_used_memory(record_length);
+    }
+    StartBenchmarkTiming();
+    EXPECT_EQ(num_records,
+              buffer.sort_buffer(&param, num_records, num_records));
+    StopBenchmarkTiming();
+  }
+
+  for (size_t r = 1; r < num_records; ++r) {
+    ASSERT_LE(memcmp(buffer.get_sorted_record(r - 1),
+                     buffer.get_sorted_record(r), key_length),
+              0);
+  }
+  buffer.free_sort_buffer();
+}
+
+/*
+  Microbenchmarks of sorting short keys, e.g. of an integer column, and
+  long keys, e.g. of a few string columns.
+*/
+static void BM_FilesortSortShortKeys(size_t num_iterations) {
+  filesort_benchmark(num_iterations, 8);
+}
+BENCHMARK(BM_FilesortSortShortKeys)
+
+static void BM_FilesortSortLongKeys(size_t num_iterations) {
+  filesort_benchmark(num_iterations, 32);
+}
+BENCHMARK(BM_FilesortSortLongKeys)
+
+/*
+  Microbenchmark of checking the CRC32 of an 8 kB rows event, as the binlog
+  reader and the replication receiver do for every event.
+*/
+static void BM_BinlogEventChecksum(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  const size_t event_length = 8192;
+  std::mt19937 generator(seed);
+  std::vector<unsigned char> event(event_length);
+  for (unsigned char &byte : event)
+    byte = static_cast<unsigned char>(generator());
+  event[EVENT_TYPE_OFFSET] = binary_log::WRITE_ROWS_EVENT;
+  int4store(&event[EVENT_LEN_OFFSET], event_length);
+  const uint32_t crc = binary_log::checksum_crc32(
+      binary_log::checksum_crc32(0L, nullptr, 0), event.data(),
+      event_length - BINLOG_CHECKSUM_LEN);
+  int4store(&event[event_length - BINLOG_CHECKSUM_LEN], crc);
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    ASSERT_FALSE(binary_log::Log_event_footer::event_checksum_test(
+        event.data(), event_length, binary_log::BINLOG_CHECKSUM_ALG_CRC32));
+  }
+  StopBenchmarkTiming();
+
+  SetBytesProcessed(num_iterations * event_length);
+}
+BENCHMARK(BM_BinlogEventChecksum)
+
+/*
+  GTID sets of 4 UUIDs with 1000 intervals each, of 1 to 100 transactions
+  with gaps of 1 to 10 between them, as left by multi-source replication and
+  purged or skipped transactions. subset holds every other interval of
+  full.
+*/
+class Gtid_set_inputs {
+ public:
+  Gtid_set_inputs() : full(&sid_map), subset(&sid_map) {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<> length(1, 100);
+    std::uniform_int_distribution<> gap(1, 10);
+    static const char *const uuids[] = {
+        "11111111-1111-1111-1111-111111111111",
+        "22222222-2222-2222-2222-222222222222",
+        "33333333-3333-3333-3333-333333333333",
+        "44444444-4444-4444-4444-444444444444"};
+    std::string subset_text;
+    for (const char *uuid : uuids) {
+      if (!full_text.empty()) {
+        full_text += ",";
+        subset_text += ",";
+      }
+      full_text += uuid;
+      subset_text += uuid;
+      rpl_gno start = 1;
+      for (int i = 0; i < 1000; ++i) {
+        const rpl_gno end = start + length(generator) - 1;
+        const std::string interval =
+            ":" + std::to_string(start) + "-" + std::to_string(end);
+        full_text += interval;
+        if (i % 2 == 0) subset_text += interval;
+        start = end + 1 + gap(generator);
+      }
+    }
+    EXPECT_EQ(RETURN_STATUS_OK, full.add_gtid_text(full_text.c_str()));
+    EXPECT_EQ(RETURN_STATUS_OK, subset.add_gtid_text(subset_text.c_str()));
+  }
+
+  Sid_map sid_map{nullptr};
+  std::string full_text;
+  Gtid_set full;
+  Gtid_set subset;
+};
+
+// Microbenchmark of parsing the text of a GTID set, as in SET gtid_purged.
+static void BM_GtidSetParse(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  Gtid_set_inputs inputs;
+  Gtid_set gtids(&inputs.sid_map);
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    gtids.clear();
+    StartBenchmarkTiming();
+    ASSERT_EQ(RETURN_STATUS_OK, gtids.add_gtid_text(inputs.full_text.c_str()));
+    StopBenchmarkTiming();
+  }
+
+  EXPECT_TRUE(gtids.is_subset(&inputs.full));
+  EXPECT_TRUE(inputs.full.is_subset(&gtids));
+}
+BENCHMARK(BM_GtidSetParse)
+
+// Microbenchmark of adding one GTID set to another.
+static void BM_GtidSetUnion(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  Gtid_set_inputs inputs;
+  Gtid_set gtids(&inputs.sid_map);
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    gtids.clear();
+    ASSERT_EQ(RETURN_STATUS_OK, gtids.add_gtid_set(&inputs.subset));
+    StartBenchmarkTiming();
+    ASSERT_EQ(RETURN_STATUS_OK, gtids.add_gtid_set(&inputs.full));
+    StopBenchmarkTiming();
+  }
+
+  EXPECT_TRUE(gtids.is_subset(&inputs.full));
+  EXPECT_TRUE(inputs.full.is_subset(&gtids));
+}
+BENCHMARK(BM_GtidSetUnion)
+
+/*
+  Microbenchmark of testing that one GTID set is a subset of another, as
+  when a replica connects with auto-positioning.
+*/
+static void BM_GtidSetIsSubset(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  Gtid_set_inputs inputs;
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    ASSERT_TRUE(inputs.subset.is_subset(&inputs.full));
+  }
+  StopBenchmarkTiming();
+}
+BENCHMARK(BM_GtidSetIsSubset)
+
+// Microbenchmark of removing one GTID set from another.
+static void BM_GtidSetRemove(size_t num_iterations) {
+  StopBenchmarkTiming();
+
+  Gtid_set_inputs inputs;
+  Gtid_set gtids(&inputs.sid_map);
+
+  for (size_t i = 0; i < num_iterations; ++i) {
+    gtids.clear();
+    ASSERT_EQ(RETURN_STATUS_OK, gtids.add_gtid_set(&inputs.full));
+    StartBenchmarkTiming();
+    gtids.remove_gtid_set(&inputs.subset);
+    StopBenchmarkTiming();
+  }
+
+  EXPECT_FALSE(gtids.is_intersection_nonempty(&inputs.subset));
+}
+BENCHMARK(BM_GtidSetRemove)
+
+/*
+  Sizes of 10000 allocations: mostly 8 to 128 bytes, like the items and
+  strings of a parse tree, and one in sixteen of up to 4 kB.
+*/
+static std::vector<size_t> allocation_sizes() {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<> small(8, 128);
+  std::uniform_int_distribution<> large(129, 4096);
+  std::vector<size_t> sizes;
+  for (int i = 0; i < 10000; ++i)
+    sizes.push_back(i % 16 == 15 ? large(generator) : small(generator));
+  return sizes;
+}
+
+static void mem_root_benchmark(size_t num_iterations, bool reuse) {
+  StopBenchmarkTiming();
+
+  const std::vector<size_t> sizes = allocation_sizes();
+  MEM_ROOT mem_root(PSI_NOT_INSTRUMENTED, 8192);
+
+  StartBenchmarkTiming();
+  for (size_t i = 0; i < num_iterations; ++i) {
+    for (size_t size : sizes) {
+      char *ptr = static_cast<char *>(mem_root.Alloc(size));
+      ptr[0] = 0;
+    }
+    if (reuse)
+      mem_root.ClearForReuse();
+    else
+      mem_root.Clear();
+  }
+  StopBenchmarkTiming();
+}
+
+/*
+  Microbenchmarks of 10000 allocations from a MEM_ROOT, which is then
+  cleared, as the THD's is after each statement, or freed, as a MEM_ROOT
+  of a single use is.
+*/
+static void BM_MemRootAllocClearForReuse(size_t num_iterations) {
+  mem_root_benchmark(num_iterations, /*reuse=*/true);
+}
+BENCHMARK(BM_MemRootAllocClearForReuse)
+
+static void BM_MemRootAllocClear(size_t num_iterations) {
+  mem_root_benchmark(num_iterations, /*reuse=*/false);
+}
+BENCHMARK(BM_MemRootAllocClear)
+
+}  // namespace microbenchmarks_unittest
@@ -170,6 +170,71 @@ TEST_F(MyAllocTest, ExceptionalBlocksAreNotReusedForLargerAllocations) {
   EXPECT_NE(ptr, ptr2);
 }
 
+TEST_F(MyAllocTest, ClearForReuseKeepsBiggestBlock) {
+  MEM_ROOT alloc(PSI_NOT_INSTRUMENTED, 512);
+  (void)alloc.Alloc(400);
+  // Larger than the block size, so it gets a block behind the current one.
+  (void)alloc.Alloc(4000);
+  alloc.ClearForReuse();
+
+  if (alloc.allocated_size() == 0) return;  // Valgrind/ASAN, see above.
+
+  EXPECT_EQ(4000U, alloc.allocated_size());
+  std::pair<char *, char *> block = alloc.Peek();
+  EXPECT_EQ(4000, block.second - block.first);
+}
+
+TEST_F(MyAllocTest, BlockCacheReusesFreedBlocks) {
+  MEM_ROOT alloc1(PSI_NOT_INSTRUMENTED, 8192);
+  alloc1.set_use_block_cache(true);
+  void *ptr = alloc1.Alloc(100);
+  const size_t allocated = alloc1.allocated_size();
+  alloc1.Clear();
+
+  if (mem_root_block_cache_bytes == 0) return;  // Valgrind/ASAN.
+
+  // Rounded up to the 16 kB size class.
+  EXPECT_LT(8192U, allocated);
+
+  const ulonglong hits = mem_root_block_cache_hits;
+  MEM_ROOT alloc2(PSI_NOT_INSTRUMENTED, 8192);
+  alloc2.set_use_block_cache(true);
+  EXPECT_EQ(ptr, alloc2.Alloc(100));
+  EXPECT_EQ(hits + 1, mem_root_block_cache_hits);
+  alloc2.Clear();
+
+  MEM_ROOT::FreeCachedBlocks();
+  EXPECT_EQ(0U, mem_root_block_cache_bytes);
+}
+
+TEST_F(MyAllocTest, BlockCacheSkipsSmallBlocks) {
+  MEM_ROOT alloc(PSI_NOT_INSTRUMENTED, 512);
+  alloc.set_use_block_cache(true);
+  alloc.Alloc(100);
+
+  // Not rounded up to the 4 kB size class, and not cached when freed.
+  EXPECT_GE(1024U, alloc.allocated_size());
+  alloc.Clear();
+  EXPECT_EQ(0U, mem_root_block_cache_bytes);
+}
+
+TEST_F(MyAllocTest, BlockCacheRespectsBound) {
+  const ulong saved_size = mem_root_block_cache_size;
+  mem_root_block_cache_size = 16 * 1024;
+
+  MEM_ROOT alloc(PSI_NOT_INSTRUMENTED, 8192);
+  alloc.set_use_block_cache(true);
+  for (int i = 0; i < 4; ++i) alloc.ForceNewBlock(8192);
+  alloc.Clear();
+
+  // Only the blocks that fit under the bound were kept.
+  EXPECT_GE(mem_root_block_cache_size, mem_root_block_cache_bytes);
+
+  MEM_ROOT::FreeCachedBlocks();
+  EXPECT_EQ(0U, mem_root_block_cache_bytes);
+  mem_root_block_cache_size = saved_size;
+}
+
 TEST_F(MyAllocTest, RawInterface) {
   MEM_ROOT alloc(PSI_NOT_INSTRUMENTED, 512);
 
@@ -0,0 +1,265 @@
+/*
+   Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA
+*/
+
+#include <gtest/gtest.h>
+#include "client/replay_capture.cc"
+
+namespace mysqlreplay_unittest {
+
+/** Capture_encoder that hands out the whole file. */
+class Test_encoder : public Capture_encoder {
+ public:
+  std::string file() const {
+    return std::string(REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) + m_buffer;
+  }
+};
+
+class MysqlreplayTest : public ::testing::Test {
+ protected:
+  bool parse(const std::string &data) {
+    events.clear();
+    digests.clear();
+    return parse_capture(data, &events, &digests, &error_offset);
+  }
+
+  std::vector<Replay_event> events;
+  std::vector<std::string> digests;
+  size_t error_offset{~size_t{0}};
+};
+
+TEST_F(MysqlreplayTest, Varint) {
+  for (ulonglong value : {0ULL, 1ULL, 127ULL, 128ULL, 300ULL, 1ULL << 35,
+                          ~0ULL}) {
+    std::string out;
+    put_varint(&out, value);
+    EXPECT_EQ(value < 128 ? 1U : out.size(), out.size());
+    const uchar *pos = pointer_cast<const uchar *>(out.data());
+    const uchar *end = pos + out.size();
+    ulonglong read;
+    EXPECT_FALSE(get_varint(&pos, end, &read));
+    EXPECT_EQ(value, read);
+    EXPECT_EQ(end, pos);
+
+    // Truncated.
+    pos = pointer_cast<const uchar *>(out.data());
+    if (out.size() > 1) {
+      EXPECT_TRUE(get_varint(&pos, end - 1, &read));
+    }
+  }
+}
+
+TEST_F(MysqlreplayTest, Zigzag) {
+  for (longlong value : {0LL, 1LL, -1LL, 63LL, -64LL, 1LL << 40,
+                         -(1LL << 40)}) {
+    EXPECT_EQ(value, unzigzag(zigzag(value)));
+  }
+  // Small deltas of either sign stay one byte.
+  EXPECT_GT(128U, zigzag(-64));
+  EXPECT_GT(128U, zigzag(63));
+}
+
+TEST_F(MysqlreplayTest, Fingerprint) {
+  EXPECT_EQ("SELECT * FROM t WHERE a = ? AND b = ?",
+            fingerprint("SELECT  *\n FROM t WHERE a = 'x''y' AND b = 42"));
+  EXPECT_EQ("SELECT ? FROM t1 WHERE c IN (?, ?)",
+            fingerprint(" SELECT \"a\\\"b\" FROM t1 WHERE c IN (1.5, 0x1F)"));
+  // Digits inside identifiers are kept.
+  EXPECT_EQ("SELECT col_1 FROM t2", fingerprint("SELECT col_1 FROM t2"));
+}
+
+TEST_F(MysqlreplayTest, RoundTrip) {
+  Test_encoder encoder;
+  encoder.set_schema(7, 1000, "test");
+  encoder.add_query(7, 1000, 250, "SELECT ?", "SELECT 1");
+  encoder.add_query(8, 1500, -1, "", "SELECT 'a' FROM dual");
+  // Captures from performance_schema may be slightly out of order.
+  encoder.add_query(7, 900, 0, "SELECT ?", "SELECT 2");
+  // Unchanged schema: no record.
+  encoder.set_schema(7, 2000, "test");
+  encoder.set_schema(8, 2000, "other");
+
+  EXPECT_EQ(3U, encoder.statements());
+  EXPECT_EQ(2U, encoder.digests());
+
+  ASSERT_FALSE(parse(encoder.file()));
+  ASSERT_EQ(2U, digests.size());
+  EXPECT_EQ("SELECT ?", digests[0]);
+  EXPECT_EQ("SELECT ? FROM dual", digests[1]);
+  ASSERT_EQ(5U, events.size());
+
+  // Sorted by start time, ties in capture order.
+  EXPECT_EQ(900, events[0].time_us);
+  EXPECT_EQ("SELECT 2", events[0].text);
+  EXPECT_EQ(0, events[0].latency_us);
+
+  EXPECT_TRUE(events[1].schema_change);
+  EXPECT_EQ("test", events[1].text);
+  EXPECT_EQ(7U, events[1].session);
+
+  EXPECT_EQ(1000, events[2].time_us);
+  EXPECT_EQ(250, events[2].latency_us);
+  EXPECT_EQ(0U, events[2].digest);
+
+  EXPECT_EQ(8U, events[3].session);
+  EXPECT_EQ(-1, events[3].latency_us);
+  EXPECT_EQ(1U, events[3].digest);
+  EXPECT_EQ("SELECT 'a' FROM dual", events[3].text);
+
+  EXPECT_TRUE(events[4].schema_change);
+  EXPECT_EQ("other", events[4].text);
+  EXPECT_EQ(2000, events[4].time_us);
+}
+
+TEST_F(MysqlreplayTest, Corrupt) {
+  EXPECT_TRUE(parse(""));
+  EXPECT_EQ(0U, error_offset);
+  EXPECT_TRUE(parse("MYRPL\x02\n"));
+  EXPECT_EQ(0U, error_offset);
+
+  Test_encoder encoder;
+  encoder.add_query(1, 10, -1, "", "SELECT 1");
+  const std::string file = encoder.file();
+  ASSERT_FALSE(parse(file));
+  EXPECT_EQ(1U, events.size());
+
+  // Every truncation of the statement record is detected.
+  const size_t record = file.rfind('Q');
+  for (size_t len = file.size() - 1; len > record; len--) {
+    const std::string truncated = file.substr(0, len);
+    EXPECT_TRUE(parse(truncated)) << len;
+    EXPECT_LT(record, error_offset);
+    EXPECT_GE(len, error_offset);
+  }
+
+  // Unknown tag.
+  EXPECT_TRUE(parse(file + "X"));
+  EXPECT_EQ(file.size() + 1, error_offset);
+
+  // Statement of a digest that was not defined.
+  std::string data(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+  data += "Q";
+  put_varint(&data, 1);
+  put_varint(&data, zigzag(10));
+  put_varint(&data, 0);
+  put_varint(&data, 0);
+  put_varint(&data, 0);
+  EXPECT_TRUE(parse(data));
+}
+
+TEST_F(MysqlreplayTest, LogTime) {
+  longlong us;
+  EXPECT_EQ(27U, parse_log_time("2021-05-01T10:00:00.123456Z\t5 Query", &us));
+  EXPECT_EQ(1619863200123456LL, us);
+
+  EXPECT_EQ(19U, parse_log_time("1970-01-01T00:00:00\t", &us));
+  EXPECT_EQ(0, us);
+
+  // Short fractions are scaled, offsets are skipped.
+  EXPECT_EQ(27U, parse_log_time("2000-03-01T00:00:01.5+08:00 ", &us));
+  EXPECT_EQ(951868801500000LL, us);
+
+  EXPECT_EQ(0U, parse_log_time("/usr/sbin/mysqld, Version: 8.0.25", &us));
+  EXPECT_EQ(0U, parse_log_time("2021-05-01 10:00:00", &us));
+}
+
+TEST_F(MysqlreplayTest, GeneralLog) {
+  Test_encoder encoder;
+  General_log_parser parser(&encoder);
+  parser.add_line("/usr/sbin/mysqld, Version: 8.0.25. started with:");
+  parser.add_line("Time                 Id Command    Argument");
+  parser.add_line(
+      "2021-05-01T10:00:00.000000Z\t   5 Connect\troot@localhost on db1 "
+      "using Socket");
+  parser.add_line("2021-05-01T10:00:00.000100Z\t   5 Query\tSELECT a");
+  parser.add_line("FROM t");
+  parser.add_line("WHERE b = 1");
+  parser.add_line("2021-05-01T10:00:00.000200Z\t   6 Init DB\tdb2");
+  parser.add_line("2021-05-01T10:00:00.000300Z\t   6 Execute\tSELECT 2");
+  parser.add_line("2021-05-01T10:00:00.000400Z\t   5 Quit\t");
+  parser.add_line("2021-05-01T10:00:00.000500Z\t   6 Query\tCOMMIT");
+  parser.finish();
+
+  ASSERT_FALSE(parse(encoder.file()));
+  ASSERT_EQ(5U, events.size());
+
+  EXPECT_TRUE(events[0].schema_change);
+  EXPECT_EQ("db1", events[0].text);
+  EXPECT_EQ(5U, events[0].session);
+
+  EXPECT_EQ("SELECT a\nFROM t\nWHERE b = 1", events[1].text);
+  EXPECT_EQ(-1, events[1].latency_us);
+  EXPECT_EQ(100, events[1].time_us - events[0].time_us);
+
+  EXPECT_TRUE(events[2].schema_change);
+  EXPECT_EQ("db2", events[2].text);
+  EXPECT_EQ("SELECT 2", events[3].text);
+  EXPECT_EQ("COMMIT", events[4].text);
+  EXPECT_EQ(6U, events[4].session);
+
+  ASSERT_EQ(3U, digests.size());
+  EXPECT_EQ("SELECT a FROM t WHERE b = ?", digests[events[1].digest]);
+}
+
+TEST_F(MysqlreplayTest, ThreadAssignment) {
+  Test_encoder encoder;
+  const ulonglong sessions[] = {30, 10, 30, 20, 40, 10, 50, 30};
+  for (size_t i = 0; i < array_elements(sessions); i++)
+    encoder.add_query(sessions[i], i * 10, -1, "",
+                      "SELECT " + std::to_string(i));
+  ASSERT_FALSE(parse(encoder.file()));
+
+  std::vector<std::vector<const Replay_event *>> threads;
+  EXPECT_EQ(5U, assign_replay_threads(events, 2, &threads));
+  ASSERT_EQ(2U, threads.size());
+
+  // Round robin in order of first appearance: 30, 20, 50 and 10, 40.
+  std::vector<ulonglong> thread_sessions[2];
+  for (size_t t = 0; t < 2; t++) {
+    longlong last = -1;
+    for (const Replay_event *event : threads[t]) {
+      thread_sessions[t].push_back(event->session);
+      EXPECT_LT(last, event->time_us);
+      last = event->time_us;
+    }
+  }
+  EXPECT_EQ(std::vector<ulonglong>({30, 30, 20, 50, 30}), thread_sessions[0]);
+  EXPECT_EQ(std::vector<ulonglong>({10, 40, 10}), thread_sessions[1]);
+
+  // No more threads than sessions.
+  EXPECT_EQ(5U, assign_replay_threads(events, 64, &threads));
+  EXPECT_EQ(5U, threads.size());
+  for (auto &thread_events : threads)
+    for (const Replay_event *event : thread_events)
+      EXPECT_EQ(thread_events.front()->session, event->session);
+}
+
+TEST_F(MysqlreplayTest, ReplayRate) {
+  EXPECT_EQ(0, replay_offset_us(5000, 5000, 1.0));
+  EXPECT_EQ(1000000, replay_offset_us(1005000, 5000, 1.0));
+  // --speed=2 runs twice as fast, --speed=0.5 half as fast.
+  EXPECT_EQ(500000, replay_offset_us(1005000, 5000, 2.0));
+  EXPECT_EQ(2000000, replay_offset_us(1005000, 5000, 0.5));
+}
+
+}  // namespace mysqlreplay_unittest
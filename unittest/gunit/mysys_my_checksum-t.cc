@@ -40,6 +40,10 @@ std::uint32_t VerifyChecksumFuncs(const unsigned char *buf,
 
   EXPECT_EQ(expected_crc, my_checksum(crc_seed, buf, length));
   EXPECT_EQ(expected_crc, PunnedCrc32<std::uint64_t>(crc_seed, buf, length));
+#ifdef HAVE_CLMUL_CRC32_INTRINSIC
+  if (length >= 64 && cpu_has_clmul)
+    EXPECT_EQ(expected_crc, ClmulCrc32(crc_seed, buf, length));
+#endif  // HAVE_CLMUL_CRC32_INTRINSIC
   return expected_crc;
 }
 
@@ -70,6 +74,17 @@ TEST(MysysMyChecksum, ThirtyOneBytes) {
   EXPECT_EQ(561217492U, VerifyChecksumFuncs(b + 7, sizeof(b) - 7));
 }
 
+// Every tail length after the 64 and 16 byte folds, at every alignment
+TEST(MysysMyChecksum, LongBuffers) {
+  unsigned char b[1100];
+  unsigned char v = 0x5a;
+  std::generate(b, b + sizeof(b), [&] { return v = v * 13 + 7; });
+  for (std::size_t offset = 0; offset < 16; offset++)
+    for (std::size_t length = 60; length < 300; length++)
+      VerifyChecksumFuncs(b + offset, length);
+  VerifyChecksumFuncs(b, sizeof(b));
+}
+
 TEST(MysysMyChecksum, IntegerCrc32_8bit) {
   unsigned char b = 0xba;
   std::uint32_t crc = 0xff;
@@ -30,6 +30,7 @@
 #include "unittest/gunit/mock_parse_tree.h"
 #include "unittest/gunit/test_utils.h"
 
+#include "sql/mysqld.h"
 #include "sql/parse_tree_items.h"
 #include "sql/regexp/regexp_engine.h"
 
@@ -152,4 +153,30 @@ TEST_F(RegexpEngineTest, AppendTail) {
   EXPECT_EQ(3, engine.replace_pos());
 }
 
+TEST_F(RegexpEngineTest, CachedPattern) {
+  const uint saved_cache_size = opt_regexp_cache_size;
+  opt_regexp_cache_size = 1;
+
+  // The second engine gets a clone of the pattern the first one compiled.
+  Regexp_engine first(m_pattern, 0, 0, 0);
+  Regexp_engine second(m_pattern, 0, 0, 0);
+  EXPECT_FALSE(first.IsError());
+  EXPECT_FALSE(second.IsError());
+
+  // The clones keep their own subjects.
+  first.Reset(m_subject);
+  second.Reset(m_replacement);
+  EXPECT_TRUE(first.Matches(0, 1));
+  EXPECT_EQ(1, first.StartOfMatch());
+  EXPECT_FALSE(second.Matches(0, 1));
+
+  // Another pattern replaces the first one in the cache.
+  Regexp_engine third(m_replacement, 0, 0, 0);
+  third.Reset(m_replacement);
+  EXPECT_TRUE(third.Matches(0, 1));
+
+  regexp::free_regexp_cache();
+  opt_regexp_cache_size = saved_cache_size;
+}
+
 }  // namespace regexp_engine_unittest
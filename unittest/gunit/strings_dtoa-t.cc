@@ -0,0 +1,91 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+
+#include <gtest/gtest.h>
+#include <float.h>
+#include <string.h>
+#include <string>
+
+#include "m_string.h"
+
+namespace strings_dtoa_unittest {
+
+static std::string gcvt(double x, int width,
+                        my_gcvt_arg_type type = MY_GCVT_ARG_DOUBLE) {
+  char buf[MY_GCVT_MAX_FIELD_WIDTH + 1];
+  bool error;
+  size_t len = my_gcvt(x, type, width, buf, &error);
+  EXPECT_FALSE(error);
+  return std::string(buf, len);
+}
+
+static std::string fcvt(double x, int precision) {
+  char buf[FLOATING_POINT_BUFFER];
+  bool error;
+  size_t len = my_fcvt(x, precision, buf, &error);
+  EXPECT_FALSE(error);
+  return std::string(buf, len);
+}
+
+/* The shortest digits that read back as the number */
+TEST(StringsDtoaTest, Shortest) {
+  EXPECT_EQ("0.1", gcvt(0.1, 22));
+  EXPECT_EQ("0.3", gcvt(0.3, 22));
+  EXPECT_EQ("1e23", gcvt(1e23, 22));
+  EXPECT_EQ("123.456", gcvt(123.456, 22));
+  EXPECT_EQ("0.3333333333333333", gcvt(1.0 / 3, 22));
+  EXPECT_EQ("9.007199254740992e15", gcvt(9007199254740993.0, 22));
+  EXPECT_EQ("-1.797693134862316e308", gcvt(-DBL_MAX, 22));
+  EXPECT_EQ("2.225073858507201e-308", gcvt(DBL_MIN, 22));
+  EXPECT_EQ("5e-324", gcvt(4.9406564584124654e-324, 22));
+  EXPECT_EQ("3.14159", gcvt(3.14159f, 12, MY_GCVT_ARG_FLOAT));
+}
+
+/* Rounded to the width when the shortest digits do not fit */
+TEST(StringsDtoaTest, Rounded) {
+  EXPECT_EQ("0.3333333333", gcvt(1.0 / 3, 12));
+  EXPECT_EQ("9.0071993e15", gcvt(9007199254740993.0, 12));
+  EXPECT_EQ("-1.79769e308", gcvt(-DBL_MAX, 12));
+  EXPECT_EQ("4.94066e-324", gcvt(4.9406564584124654e-324, 12));
+  EXPECT_EQ("0.10000", fcvt(0.1, 5));
+  EXPECT_EQ("0.33333", fcvt(1.0 / 3, 5));
+  EXPECT_EQ("123.45600", fcvt(123.456, 5));
+  EXPECT_EQ("0.00000", fcvt(DBL_MIN, 5));
+}
+
+/* Every double reads back as itself */
+TEST(StringsDtoaTest, RoundTrip) {
+  unsigned long long bits = 0x123456789abcdefULL;
+  for (int i = 0; i < 100000; i++) {
+    bits = bits * 6364136223846793005ULL + 1442695040888963407ULL;
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    if (x != x || x - x != 0) continue; /* NaN or infinity */
+    const std::string s = gcvt(x, MY_GCVT_MAX_FIELD_WIDTH);
+    const char *end = s.data() + s.size();
+    int error;
+    EXPECT_EQ(x, my_strtod(s.data(), &end, &error)) << s;
+  }
+}
+
+}  // namespace strings_dtoa_unittest
@@ -561,6 +561,35 @@ TEST_F(StringsUTF8mb4Test, MyIsmbcharUtf8mb4) {
   /* Not testing for illegal charaters as same is tested in above test case */
 }
 
+TEST_F(StringsUTF8mb4Test, AsciiRunsUtf8mb4) {
+  const CHARSET_INFO *cs = system_charset_info;
+  int error;
+
+  // 21 ASCII characters, one 4-byte and one 2-byte character, 11 ASCII.
+  std::string str = "abcdefghijklmnopqrstu\xf0\x9f\x98\x80\xc3\xa9vwxyz012345";
+  const char *b = str.data();
+  const char *e = b + str.size();
+
+  EXPECT_EQ(34U, cs->cset->numchars(cs, b, e));
+  EXPECT_EQ(str.size(), cs->cset->well_formed_len(cs, b, e, 100, &error));
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(25U, cs->cset->charpos(cs, b, e, 22));
+
+  // The character limit may fall inside an ASCII run.
+  EXPECT_EQ(10U, cs->cset->well_formed_len(cs, b, e, 10, &error));
+  EXPECT_EQ(0, error);
+  EXPECT_EQ(27U, cs->cset->well_formed_len(cs, b, e, 23, &error));
+  EXPECT_EQ(0, error);
+
+  // An invalid byte right after a run of eight.
+  str[8] = '\xff';
+  b = str.data();
+  e = b + str.size();
+  EXPECT_EQ(8U, cs->cset->well_formed_len(cs, b, e, 100, &error));
+  EXPECT_EQ(1, error);
+  EXPECT_EQ(34U, cs->cset->numchars(cs, b, e));
+}
+
 class StringsUTF8mb4_900Test : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -24,6 +24,7 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "mysql/plugin.h"
@@ -506,6 +507,90 @@ TEST_F(Handler_test, MultiIndexVarchar) {
   EXPECT_EQ(handler.delete_table(table_name, nullptr), 0);
 }
 
+TEST_F(Handler_test, CompressedVarchar) {
+  const char *table_name = "t1";
+
+  Table_helper table_helper(table_name, thd());
+  table_helper.add_field_varstring("col0", 20, false);
+  table_helper.add_field_varstring("col1", 300, true);
+  table_helper.add_index(HA_KEY_ALG_BTREE, true, {0});
+  table_helper.finalize();
+
+  temptable::Handler handler(hton(), table_helper.table_share());
+  table_helper.set_handler(&handler);
+
+  EXPECT_EQ(handler.create(table_name, table_helper.table(), nullptr, nullptr),
+            0);
+  EXPECT_EQ(handler.open(table_name, 0, 0, nullptr), 0);
+
+  temptable_compression_min_length = 32;
+
+  /* Values of col1: compressible, too short and incompressible. */
+  std::vector<std::string> values = {std::string(250, 'a'), "short",
+                                     std::string(40, 'b')};
+  for (size_t i = 0; i < values[2].size(); ++i) {
+    values[2][i] = static_cast<char>('0' + (i * 7) % 75);
+  }
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    table_helper.field<Field_varstring>(0)->store(i, false);
+    table_helper.field<Field_varstring>(1)->store(
+        values[i].data(), values[i].size(), &my_charset_latin1);
+    EXPECT_EQ(handler.write_row(table_helper.record_0()), 0);
+  }
+
+  /* A NULL value is not compressed. */
+  table_helper.field<Field_varstring>(0)->store(3, false);
+  table_helper.field<Field_varstring>(1)->set_null();
+  EXPECT_EQ(handler.write_row(table_helper.record_0()), 0);
+  table_helper.field<Field_varstring>(1)->set_notnull();
+
+  /* Read the rows back. */
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  for (size_t i = 0; i < values.size() + 1; ++i) {
+    EXPECT_EQ(handler.rnd_next(table_helper.record_0()), 0);
+    const auto key = table_helper.field<Field_varstring>(0)->val_int();
+    ASSERT_TRUE(key >= 0 && key <= 3);
+    if (key == 3) {
+      EXPECT_TRUE(table_helper.field<Field_varstring>(1)->is_null());
+      continue;
+    }
+    String value;
+    table_helper.field<Field_varstring>(1)->val_str(&value, &value);
+    EXPECT_EQ(std::string(value.ptr(), value.length()), values[key]);
+  }
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  /* Update and delete the row whose value is compressed. */
+  const std::string updated(300, 'c');
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  do {
+    EXPECT_EQ(handler.rnd_next(table_helper.record_1()), 0);
+    table_helper.copy_record_1_to_0();
+  } while (table_helper.field<Field_varstring>(0)->val_int() != 0);
+  table_helper.field<Field_varstring>(1)->store(
+      updated.data(), updated.size(), &my_charset_latin1);
+  EXPECT_EQ(
+      handler.update_row(table_helper.record_1(), table_helper.record_0()), 0);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  EXPECT_EQ(handler.rnd_init(false), 0);
+  do {
+    EXPECT_EQ(handler.rnd_next(table_helper.record_1()), 0);
+    table_helper.copy_record_1_to_0();
+  } while (table_helper.field<Field_varstring>(0)->val_int() != 0);
+  String value;
+  table_helper.field<Field_varstring>(1)->val_str(&value, &value);
+  EXPECT_EQ(std::string(value.ptr(), value.length()), updated);
+  EXPECT_EQ(handler.delete_row(table_helper.record_1()), 0);
+  EXPECT_EQ(handler.rnd_end(), 0);
+
+  temptable_compression_min_length = 0;
+
+  EXPECT_EQ(handler.close(), 0);
+  EXPECT_EQ(handler.delete_table(table_name, nullptr), 0);
+}
+
 TEST_F(Handler_test, IndexOnOff) {
   const char *table_name = "t1";
 
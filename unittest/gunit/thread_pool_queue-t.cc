@@ -0,0 +1,227 @@
+/* Copyright (c) 2021, Oracle and/or its affiliates.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License, version 2.0,
+   as published by the Free Software Foundation.
+
+   This program is also distributed with certain software (including
+   but not limited to OpenSSL) that is licensed under separate terms,
+   as designated in a particular file or component or in included license
+   documentation.  The authors of MySQL hereby grant you an additional
+   permission to link the program and your derivative works with the
+   separately licensed software that they have included with MySQL.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License, version 2.0, for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301  USA */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "sql/conn_handler/thread_pool_queue.h"
+
+namespace thread_pool_queue_unittest {
+
+struct Connection {
+  int id;
+};
+
+using Queue = Thread_pool_queue<Connection>;
+
+// At most 1 + oversubscribe active workers.
+const uint oversubscribe = 1;
+
+TEST(ThreadPoolQueueTest, GroupAssignmentRoundRobin) {
+  std::atomic<uint> next{0};
+  std::vector<int> count(3);
+  for (int i = 0; i < 9; ++i) count[thread_pool_next_group(&next, 3)]++;
+  EXPECT_EQ(std::vector<int>({3, 3, 3}), count);
+
+  // Keeps cycling over the groups when the counter wraps around.
+  next = ~0U;
+  EXPECT_EQ(~0U % 4, thread_pool_next_group(&next, 4));
+  EXPECT_EQ(0U, thread_pool_next_group(&next, 4));
+}
+
+TEST(ThreadPoolQueueTest, GroupAssignmentConcurrent) {
+  std::atomic<uint> next{0};
+  std::atomic<int> count[4] = {{0}, {0}, {0}, {0}};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([&] {
+      for (int i = 0; i < 1000; ++i) count[thread_pool_next_group(&next, 4)]++;
+    });
+  for (auto &thread : threads) thread.join();
+
+  for (auto &c : count) EXPECT_EQ(1000, c);
+}
+
+TEST(ThreadPoolQueueTest, ServesInOrder) {
+  Queue q;
+  Connection a{1}, b{2};
+  EXPECT_TRUE(q.queues_empty());
+  EXPECT_EQ(nullptr, q.dequeue(oversubscribe));
+
+  q.enqueue(&a, false);
+  q.enqueue(&b, false);
+  EXPECT_FALSE(q.queues_empty());
+  EXPECT_EQ(&a, q.dequeue(oversubscribe));
+  EXPECT_EQ(&b, q.dequeue(oversubscribe));
+  EXPECT_EQ(2U, q.active_thread_count);
+  EXPECT_EQ(2U, q.dequeue_count);
+  EXPECT_TRUE(q.queues_empty());
+}
+
+TEST(ThreadPoolQueueTest, HighPriorityFirst) {
+  Queue q;
+  Connection a{1}, b{2}, c{3};
+  q.enqueue(&a, false);
+  q.enqueue(&b, true);
+  q.enqueue(&c, true);
+
+  EXPECT_EQ(&b, q.dequeue(oversubscribe));
+  EXPECT_EQ(&c, q.dequeue(oversubscribe));
+  // The workers finish, the plain queue is served too.
+  q.active_thread_count = 0;
+  EXPECT_EQ(&a, q.dequeue(oversubscribe));
+}
+
+TEST(ThreadPoolQueueTest, ActiveLimit) {
+  Queue q;
+  Connection a{1}, b{2}, c{3}, d{4};
+  q.enqueue(&a, false);
+  q.enqueue(&b, false);
+  q.enqueue(&c, false);
+
+  EXPECT_EQ(&a, q.dequeue(oversubscribe));
+  EXPECT_EQ(&b, q.dequeue(oversubscribe));
+  EXPECT_TRUE(q.too_many_active_threads(oversubscribe));
+  EXPECT_EQ(nullptr, q.dequeue(oversubscribe));
+
+  // Connections with an open transaction get past the limit.
+  q.enqueue(&d, true);
+  EXPECT_EQ(&d, q.dequeue(oversubscribe));
+  EXPECT_EQ(3U, q.active_thread_count);
+
+  // A worker finishing its command lets the others through.
+  q.active_thread_count -= 2;
+  EXPECT_FALSE(q.too_many_active_threads(oversubscribe));
+  EXPECT_EQ(&c, q.dequeue(oversubscribe));
+}
+
+TEST(ThreadPoolQueueTest, StallDetection) {
+  Queue q;
+  Connection a{1}, b{2}, c{3};
+
+  // Nothing queued and somebody polls: idle, not stalled.
+  EXPECT_FALSE(q.check_stall(false));
+
+  // Nobody polls the connections of the group.
+  EXPECT_TRUE(q.check_stall(true));
+  q.stalled = false;
+
+  // Work was picked up since the last check.
+  q.enqueue(&a, false);
+  q.enqueue(&b, false);
+  q.enqueue(&c, false);
+  EXPECT_EQ(&a, q.dequeue(oversubscribe));
+  EXPECT_EQ(&b, q.dequeue(oversubscribe));
+  EXPECT_FALSE(q.check_stall(false));
+  EXPECT_FALSE(q.stalled);
+
+  // The active workers made no progress while c was queued.
+  EXPECT_EQ(nullptr, q.dequeue(oversubscribe));
+  EXPECT_TRUE(q.check_stall(false));
+  EXPECT_TRUE(q.stalled);
+
+  // The limit is lifted once, and serving c clears the stall.
+  EXPECT_FALSE(q.too_many_active_threads(oversubscribe));
+  EXPECT_EQ(&c, q.dequeue(oversubscribe));
+  EXPECT_FALSE(q.stalled);
+  EXPECT_TRUE(q.too_many_active_threads(oversubscribe));
+  EXPECT_FALSE(q.check_stall(false));
+}
+
+/** A poll set like epoll: adding a socket twice or modifying one that was
+never added fails. */
+struct Poll_set {
+  std::mutex mutex;
+  std::set<int> fds;
+  std::vector<bool> ops;  // add or modify, in order
+
+  int arm(int fd, bool add) {
+    std::lock_guard<std::mutex> guard(mutex);
+    ops.push_back(add);
+    if (add) return fds.insert(fd).second ? 0 : -1;
+    return fds.count(fd) ? 0 : -1;
+  }
+};
+
+/** A connection as start_io() sees it. */
+struct Polled_connection {
+  int fd;
+  std::mutex lock_thd_data;
+  bool in_poll_set{false};
+};
+
+/** start_io(): arm the connection under its lock. */
+static int start_io(Poll_set *poll_set, Polled_connection *conn,
+                    const std::function<void()> &after_arm = nullptr) {
+  std::lock_guard<std::mutex> guard(conn->lock_thd_data);
+  return thread_pool_arm(&conn->in_poll_set, [&](bool add) {
+    const int res = poll_set->arm(conn->fd, add);
+    if (after_arm) after_arm();
+    return res;
+  });
+}
+
+TEST(ThreadPoolQueueTest, RearmAfterFirstAdd) {
+  Poll_set poll_set;
+  Polled_connection conn;
+  conn.fd = 7;
+
+  // The first arm after login adds the socket. The client's next packet
+  // wakes another worker at once, which arms the connection again after
+  // serving it, while the first worker is still in start_io().
+  int second_res = -2;
+  std::thread second;
+  const int first_res = start_io(&poll_set, &conn, [&] {
+    second = std::thread([&] { second_res = start_io(&poll_set, &conn); });
+  });
+  second.join();
+
+  EXPECT_EQ(0, first_res);
+  EXPECT_EQ(0, second_res);
+  EXPECT_EQ(std::vector<bool>({true, false}), poll_set.ops);
+  EXPECT_TRUE(conn.in_poll_set);
+}
+
+TEST(ThreadPoolQueueTest, RearmAfterFailedAdd) {
+  Poll_set poll_set;
+  Polled_connection conn;
+  conn.fd = 7;
+
+  // Adding fails: the connection is not in the poll set.
+  poll_set.fds.insert(conn.fd);
+  EXPECT_NE(0, start_io(&poll_set, &conn));
+  EXPECT_FALSE(conn.in_poll_set);
+
+  // The next arm adds it again; later ones modify it.
+  poll_set.fds.clear();
+  EXPECT_EQ(0, start_io(&poll_set, &conn));
+  EXPECT_EQ(0, start_io(&poll_set, &conn));
+  EXPECT_EQ(std::vector<bool>({true, true, false}), poll_set.ops);
+  EXPECT_TRUE(conn.in_poll_set);
+}
+
+}  // namespace thread_pool_queue_unittest
@@ -406,6 +406,39 @@ bool vio_reset(Vio *vio, enum enum_vio_type type, my_socket sd,
   return ret;
 }
 
+/**
+  Switch a plain socket-based Vio to buffered reads, so that a single
+  recv() returns the header and the payload of short packets, and
+  pipelined packets are served from the buffer.
+
+  @remark Must only be called while nothing is in flight that a later
+          rebind to another transport (vio_reset) would need to read,
+          i.e. after the connection phase.
+
+  @param vio    A VIO object.
+
+  @return true if the Vio is not socket-based or the buffer could not
+          be allocated, the Vio is unchanged then.
+*/
+
+bool vio_set_buffered_read(Vio *vio) {
+  DBUG_TRACE;
+
+  if (vio->type != VIO_TYPE_TCPIP && vio->type != VIO_TYPE_SOCKET)
+    return true;
+
+  if (vio->read_buffer == nullptr) {
+    vio->read_buffer = (char *)my_malloc(key_memory_vio_read_buffer,
+                                         VIO_READ_BUFFER_SIZE, MYF(MY_WME));
+    if (vio->read_buffer == nullptr) return true;
+    vio->read_pos = vio->read_end = vio->read_buffer;
+  }
+
+  vio->read = vio_read_buff;
+  vio->has_data = vio_buff_has_data;
+  return false;
+}
+
 Vio *internal_vio_create(uint flags) {
   void *rawmem = my_malloc(key_memory_vio, sizeof(Vio), MYF(MY_WME));
   if (rawmem == nullptr) return nullptr;